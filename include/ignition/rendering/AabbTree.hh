@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_AABBTREE_HH_
+#define IGNITION_RENDERING_AABBTREE_HH_
+
+#include <memory>
+#include <vector>
+
+#include <ignition/common/SuppressWarning.hh>
+
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Frustum.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+      // forward declaration
+      class AabbTreePrivate;
+
+      /// \brief Dynamic bounding volume hierarchy over axis aligned boxes
+      /// identified by ids. The hierarchy is kept balanced as boxes are
+      /// inserted, moved and removed, so these operations and the queries
+      /// take time logarithmic in the number of boxes. Each box is stored
+      /// enlarged by a margin, so boxes that move by less than the margin
+      /// do not change the hierarchy.
+      class IGNITION_RENDERING_VISIBLE AabbTree
+      {
+        /// \brief Constructor
+        /// \param[in] _margin Distance boxes are enlarged by in the
+        /// hierarchy
+        public: explicit AabbTree(double _margin = 0.1);
+
+        /// \brief Destructor
+        public: ~AabbTree();
+
+        /// \brief Insert a box, or move the box of an id already in the
+        /// hierarchy
+        /// \param[in] _id Id of the box
+        /// \param[in] _box New box. Empty boxes are rejected.
+        /// \return True if the hierarchy changed, false if the box was
+        /// rejected or still fits in its enlarged box
+        public: bool Update(unsigned int _id,
+            const math::AxisAlignedBox &_box);
+
+        /// \brief Remove a box
+        /// \param[in] _id Id of the box
+        /// \return True if the box was in the hierarchy
+        public: bool Remove(unsigned int _id);
+
+        /// \brief Remove all boxes
+        public: void Clear();
+
+        /// \brief Check if a box is in the hierarchy
+        /// \param[in] _id Id of the box
+        /// \return True if the box is in the hierarchy
+        public: bool Contains(unsigned int _id) const;
+
+        /// \brief Get the box of an id, as last given to Update
+        /// \param[in] _id Id of the box
+        /// \return Box of the id, an empty box if the id is unknown
+        public: math::AxisAlignedBox Box(unsigned int _id) const;
+
+        /// \brief Get the number of boxes in the hierarchy
+        /// \return Number of boxes
+        public: unsigned int Size() const;
+
+        /// \brief Get the ids of all boxes in the hierarchy
+        /// \return Ids of the boxes, in no particular order
+        public: std::vector<unsigned int> Ids() const;
+
+        /// \brief Get the height of the hierarchy, 0 if it is empty and 1
+        /// if it only has one box
+        /// \return Height of the hierarchy
+        public: unsigned int Height() const;
+
+        /// \brief Find the boxes intersecting a box
+        /// \param[in] _box Box to test
+        /// \return Ids of the boxes intersecting the box
+        public: std::vector<unsigned int> QueryBox(
+            const math::AxisAlignedBox &_box) const;
+
+        /// \brief Find the boxes intersecting a sphere
+        /// \param[in] _center Center of the sphere
+        /// \param[in] _radius Radius of the sphere
+        /// \return Ids of the boxes intersecting the sphere
+        public: std::vector<unsigned int> QuerySphere(
+            const math::Vector3d &_center, double _radius) const;
+
+        /// \brief Find the boxes intersecting a frustum. As in
+        /// math::Frustum::Contains, boxes close to a corner of the frustum
+        /// may be reported even if they are just outside of it.
+        /// \param[in] _frustum Frustum to test
+        /// \return Ids of the boxes intersecting the frustum
+        public: std::vector<unsigned int> QueryFrustum(
+            const math::Frustum &_frustum) const;
+
+        IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+        private: std::unique_ptr<AabbTreePrivate> dataPtr;
+        IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+      };
+    }
+  }
+}
+#endif
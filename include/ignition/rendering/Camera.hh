@@ -18,11 +18,13 @@
 #define IGNITION_RENDERING_CAMERA_HH_
 
 #include <string>
+#include <vector>
 
 #include <ignition/common/Event.hh>
 #include <ignition/math/Matrix4.hh>
 
 #include "ignition/rendering/config.hh"
+#include "ignition/rendering/GpuFrameEncoder.hh"
 #include "ignition/rendering/Image.hh"
 #include "ignition/rendering/PixelFormat.hh"
 #include "ignition/rendering/Sensor.hh"
@@ -103,7 +105,8 @@ namespace ignition
       /// \brief Set the level of anti-aliasing used during rendering. If a
       /// value of 0 is given, no anti-aliasing will be performed. Higher values
       /// can significantly slow-down rendering times, depending on the
-      /// underlying render engine.
+      /// underlying render engine. A FxaaPass added to the camera is a
+      /// cheaper alternative.
       /// \param[in] _aa Level of anti-aliasing used during rendering
       public: virtual void SetAntiAliasing(const unsigned int _aa) = 0;
 
@@ -123,6 +126,128 @@ namespace ignition
       /// \param[in] _near Near clipping plane distance
       public: virtual void SetNearClipPlane(const double _near) = 0;
 
+      /// \brief Set the level of detail bias of the camera, used to select
+      /// the levels of detail of meshes, see MeshDescriptor::lodLevels.
+      /// Values smaller than 1 select coarser levels, which are cheaper to
+      /// render, values larger than 1 select more detailed levels. This lets
+      /// sensors such as depth cameras and lidars trade accuracy for speed.
+      /// \param[in] _bias Level of detail bias, 1 by default
+      public: virtual void SetLodBias(double _bias) = 0;
+
+      /// \brief Get the level of detail bias of the camera
+      /// \return Level of detail bias
+      /// \sa SetLodBias
+      public: virtual double LodBias() const = 0;
+
+      /// \brief Enable or disable the impostors of meshes for this camera,
+      /// see MeshDescriptor::impostorDistance. A camera with impostors
+      /// disabled draws meshes at full detail at any distance, ignoring
+      /// their levels of detail too, which suits sensors that need accurate
+      /// geometry such as depth cameras and lidars. Impostors are enabled
+      /// by default, except for cameras that replace the materials of the
+      /// scene, such as thermal and segmentation cameras.
+      /// \param[in] _enabled True to enable impostors
+      public: virtual void SetImpostorsEnabled(bool _enabled) = 0;
+
+      /// \brief Get whether the impostors of meshes are enabled for this
+      /// camera
+      /// \return True if impostors are enabled
+      /// \sa SetImpostorsEnabled
+      public: virtual bool ImpostorsEnabled() const = 0;
+
+      /// \brief Set whether the camera renders shadows. Sensors that do not
+      /// need shadows, e.g. depth cameras or cameras used for segmentation,
+      /// can disable them to skip rendering shadow maps altogether.
+      /// \param[in] _enabled True to render shadows, true by default
+      public: virtual void SetShadowsEnabled(bool _enabled) = 0;
+
+      /// \brief Get whether the camera renders shadows
+      /// \return True if shadows are rendered
+      /// \sa SetShadowsEnabled
+      public: virtual bool ShadowsEnabled() const = 0;
+
+      /// \brief Set the resolution of the shadow maps rendered for this
+      /// camera. Smaller shadow maps are faster to render at the cost of
+      /// blurrier shadows.
+      /// \param[in] _size Size of the shadow maps in pixels, a power of two
+      /// between 256 and 4096, or 0 to use the render engine default
+      public: virtual void SetShadowMapSize(unsigned int _size) = 0;
+
+      /// \brief Get the resolution of the shadow maps rendered for this
+      /// camera
+      /// \return Size of the shadow maps in pixels, 0 if the render engine
+      /// default is used
+      /// \sa SetShadowMapSize
+      public: virtual unsigned int ShadowMapSize() const = 0;
+
+      /// \brief Enable or disable dynamic resolution. The camera then
+      /// measures the GPU time of its frames and scales the resolution the
+      /// scene is rendered at so that the frames take the target GPU time,
+      /// within the range of scales. The frames are upscaled to the image
+      /// size, which does not change. Enabling dynamic resolution enables
+      /// the GPU timing of the render engine, see
+      /// RenderEngine::SetGpuTimingEnabled.
+      /// \param[in] _enabled True to enable, false by default
+      /// \return True if dynamic resolution is in the requested state,
+      /// false if the render engine does not support it
+      public: virtual bool SetDynamicResolutionEnabled(bool _enabled) = 0;
+
+      /// \brief Get whether dynamic resolution is enabled
+      /// \return True if enabled
+      /// \sa SetDynamicResolutionEnabled
+      public: virtual bool DynamicResolutionEnabled() const = 0;
+
+      /// \brief Set the GPU time of a frame dynamic resolution aims for,
+      /// e.g. slightly less than the period of the target frame rate
+      /// \param[in] _time GPU time in milliseconds, must be positive.
+      /// Defaults to 16 ms.
+      public: virtual void SetTargetGpuTime(double _time) = 0;
+
+      /// \brief Get the GPU time of a frame dynamic resolution aims for
+      /// \return GPU time in milliseconds
+      public: virtual double TargetGpuTime() const = 0;
+
+      /// \brief Set the range of the scale of the resolution the scene is
+      /// rendered at with dynamic resolution, relative to the image size
+      /// \param[in] _min Smallest scale, in (0, 1], 0.5 by default
+      /// \param[in] _max Largest scale, in [_min, 1], 1 by default
+      public: virtual void SetResolutionScaleRange(double _min,
+                  double _max) = 0;
+
+      /// \brief Get the smallest scale of the resolution with dynamic
+      /// resolution
+      /// \return Smallest scale
+      public: virtual double MinResolutionScale() const = 0;
+
+      /// \brief Get the largest scale of the resolution with dynamic
+      /// resolution
+      /// \return Largest scale
+      public: virtual double MaxResolutionScale() const = 0;
+
+      /// \brief Get the scale of the resolution the last frame was rendered
+      /// at, relative to the image size
+      /// \return Scale of the resolution, 1 unless dynamic resolution is
+      /// enabled
+      public: virtual double ResolutionScale() const = 0;
+
+      /// \brief Enable or disable weighted blended order independent
+      /// transparency. Transparent materials are then accumulated into
+      /// weighted sums that are composited over the opaque scene, so the
+      /// result does not depend on the order they are drawn in and
+      /// intersecting or interleaved transparent objects are blended
+      /// without artifacts. The blending is an approximation that favours
+      /// the transparent surfaces closest to the camera.
+      /// \param[in] _enabled True to enable, false by default
+      /// \return True if order independent transparency is in the
+      /// requested state, false if the render engine does not support it
+      public: virtual bool SetOrderIndependentTransparencyEnabled(
+                  bool _enabled) = 0;
+
+      /// \brief Get whether order independent transparency is enabled
+      /// \return True if enabled
+      /// \sa SetOrderIndependentTransparencyEnabled
+      public: virtual bool OrderIndependentTransparencyEnabled() const = 0;
+
       /// \brief Renders the current scene using this camera. This function
       /// assumes PreRender() has already been called on the parent Scene,
       /// allowing the camera and the scene itself to prepare for rendering.
@@ -140,6 +265,16 @@ namespace ignition
       public: virtual VisualPtr VisualAt(const ignition::math::Vector2i
                   &_mousePos) = 0;
 
+      /// \brief Get all visuals seen in a rectangular region of the image,
+      /// e.g. for rubber band selection
+      /// \param[in] _min Top left corner of the region in pixels
+      /// \param[in] _max Bottom right corner of the region in pixels. The
+      /// region excludes this row and column
+      /// \return Unique visuals in the region, empty if none was found
+      public: virtual std::vector<VisualPtr> VisualsInRegion(
+                  const ignition::math::Vector2i &_min,
+                  const ignition::math::Vector2i &_max) = 0;
+
       /// \brief Renders a new frame.
       /// This is a convenience function for single-camera scenes. It wraps the
       /// pre-render, render, and post-render into a single
@@ -147,6 +282,31 @@ namespace ignition
       /// or multiple consumers of a single camera's images.
       public: virtual void Update() = 0;
 
+      /// \brief Set whether Update only renders a new frame when it would
+      /// differ from the last one, e.g. for cameras of GUI render windows
+      /// that would otherwise re-render an unchanged scene every tick.
+      /// A frame is rendered when the pose, image size or projection of the
+      /// camera changed, when the scene changed, see Scene::ChangeVersion,
+      /// or when RequestRender was called. Otherwise the last frame is kept,
+      /// the render target still presents it, and the post render steps
+      /// such as the frame encoder or the frame recording are skipped.
+      /// \param[in] _enabled True to only render when needed. Defaults to
+      /// false.
+      /// \sa RequestRender
+      public: virtual void SetOnDemandRendering(bool _enabled) = 0;
+
+      /// \brief Get whether Update only renders a new frame when needed
+      /// \return True if on demand rendering is enabled
+      /// \sa SetOnDemandRendering
+      public: virtual bool OnDemandRendering() const = 0;
+
+      /// \brief Request the next Update to render a new frame with on
+      /// demand rendering, e.g. after the window was exposed or after
+      /// changes the scene does not track, such as changes to material
+      /// properties, lights, or engine specific objects.
+      /// \sa SetOnDemandRendering
+      public: virtual void RequestRender() = 0;
+
       /// \brief Created an empty image buffer for capturing images. The
       /// resulting image will have sufficient memory allocated for subsequent
       /// calls to this camera's Capture function. However, any changes to this
@@ -162,6 +322,17 @@ namespace ignition
       /// \param[out] _image Output image buffer
       public: virtual void Capture(Image &_image) = 0;
 
+      /// \brief Renders a new frame and writes the results to a buffer
+      /// owned by the caller, such as pinned or aligned memory, without
+      /// allocating an intermediate image. The buffer holds an image of the
+      /// size and format of this camera.
+      /// \param[out] _data Output buffer of at least ImageHeight() rows
+      /// \param[in] _rowStride Number of bytes between the start of two
+      /// rows, a multiple of the pixel size. Zero for tightly packed rows.
+      /// \sa ImagePool
+      public: virtual void Capture(void *_data,
+                  unsigned int _rowStride = 0u) = 0;
+
       /// \brief Writes the last rendered image to the given image buffer. This
       /// function can be called multiple times after PostRender has been
       /// called, without rendering the scene again. Calling this function
@@ -169,13 +340,48 @@ namespace ignition
       /// \param[out] _image Output image buffer
       public: virtual void Copy(Image &_image) const = 0;
 
+      /// \brief Writes a rectangular region of the last rendered image to
+      /// the given image buffer, e.g. the crops needed by a tracker. Engines
+      /// that support it only read the pixels of the region back from the
+      /// GPU, so several small regions cost less than one full frame. The
+      /// same restrictions as Copy apply.
+      /// \param[out] _image Output image buffer, of the size of the region
+      /// and of the camera image format
+      /// \param[in] _x Column of the top left pixel of the region
+      /// \param[in] _y Row of the top left pixel of the region
+      /// \return True if the region is inside the image and was copied
+      public: virtual bool CopyRegion(Image &_image, unsigned int _x,
+                  unsigned int _y) const = 0;
+
       /// \brief Writes the previously rendered frame to a file. This function
       /// can be called multiple times after PostRender has been called,
       /// without rendering the scene again. Calling this function before a
-      /// single image has been rendered will have undefined behavior.
+      /// single image has been rendered will have undefined behavior. The
+      /// frame is copied to a pooled image and written by the workers of
+      /// FrameWriter::Instance, call its Flush function to wait for the
+      /// file. The format is given by the file extension, see FrameWriter.
       /// \param[in] _name Name of the output file
+      /// \return True if the frame is queued to be written
       public: virtual bool SaveFrame(const std::string &_name) = 0;
 
+      /// \brief Start writing every frame rendered by this camera to files
+      /// in a directory, with SaveFrame. The frames are named frame_000000,
+      /// frame_000001 and so on, numbered from the start of the recording.
+      /// Frames are only written by cameras rendering color images.
+      /// \param[in] _directory Directory of the frames, created if needed
+      /// \param[in] _extension Extension of the files, giving the format
+      /// \return True if the recording started
+      public: virtual bool StartRecording(const std::string &_directory,
+                  const std::string &_extension = "png") = 0;
+
+      /// \brief Stop writing the frames rendered by this camera and wait for
+      /// the frames queued to be written
+      public: virtual void StopRecording() = 0;
+
+      /// \brief Get whether the frames are written to files
+      /// \return True between StartRecording and StopRecording
+      public: virtual bool Recording() const = 0;
+
       /// \brief Subscribes a new listener to this camera's new frame event
       /// \param[in] _listener New camera listener callback
       public: virtual common::ConnectionPtr ConnectNewImageFrame(
@@ -278,10 +484,29 @@ namespace ignition
 
       /// \brief Get the OpenGL texture id associated with the render texture
       /// used by this camera. A valid id is returned only if the underlying
-      /// render engine is OpenGL based.
+      /// render engine is OpenGL based. The texture can be shared with
+      /// other GPU APIs without copying it to host memory, e.g. registered
+      /// with cudaGraphicsGLRegisterImage as a GL_TEXTURE_2D from the thread
+      /// that renders, then mapped after each render. The id is only valid
+      /// until the image size, format or render passes change.
       /// \return Texture Id of type GLuint.
       public: virtual unsigned int RenderTextureGLId() const = 0;
 
+      /// \brief Set an encoder streaming the frames of the camera from its
+      /// render texture in GPU memory, see RenderTextureGLId. The encoder
+      /// is given every frame rendered, without reading it back to the CPU,
+      /// so a camera whose frames are only encoded never needs Capture or a
+      /// new frame listener. The encoder is removed if the render engine
+      /// does not expose the render texture. Frames are only encoded by
+      /// cameras rendering color images.
+      /// \param[in] _encoder Encoder of the frames, null to stop encoding
+      public: virtual void SetFrameEncoder(
+                  const GpuFrameEncoderPtr &_encoder) = 0;
+
+      /// \brief Get the encoder streaming the frames of the camera
+      /// \return Encoder of the frames, null if the frames are not encoded
+      public: virtual GpuFrameEncoderPtr FrameEncoder() const = 0;
+
       /// \brief Add a render pass to the camera
       /// \param[in] _pass New render pass to add
       public: virtual void AddRenderPass(const RenderPassPtr &_pass) = 0;
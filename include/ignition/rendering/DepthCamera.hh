@@ -75,6 +75,65 @@ namespace ignition
           std::function<void(const float *_pointCloud, unsigned int _width,
           unsigned int _height, unsigned int _depth,
           const std::string &_format)> _subscriber) = 0;
+
+      /// \brief Connect to the new rgb image signal. The image is the color
+      /// of the scene rendered for the depth data, so a depth camera can
+      /// replace an rgb camera placed at the same pose. Pixels outside the
+      /// depth range have the background color.
+      /// \param[in] _subscriber Subscriber callback function
+      /// The arguments of the callback function are:
+      ///  _image Image data, 3 unsigned 8 bit values [R, G, B] per pixel
+      ///  _width Image width
+      ///  _height Image height
+      ///  _depth Image depth, i.e. number of channels
+      ///  _format Image format
+      /// \return Pointer to the new Connection. This must be kept in scope.
+      /// Null if the render engine does not support it.
+      public: virtual ignition::common::ConnectionPtr ConnectNewRgbFrame(
+          std::function<void(const unsigned char *_image, unsigned int _width,
+          unsigned int _height, unsigned int _depth,
+          const std::string &_format)> _subscriber) = 0;
+
+      /// \brief Connect to the new surface normals signal. The normals are
+      /// computed from the point cloud of the same frame, in the frame of
+      /// the point cloud, and face the camera.
+      /// \param[in] _subscriber Subscriber callback function
+      /// The arguments of the callback function are:
+      ///  _normals Normals data, 3 float values [x, y, z] per pixel. They are
+      ///           zero for pixels outside the depth range.
+      ///  _width Image width
+      ///  _height Image height
+      ///  _depth Image depth, i.e. number of channels
+      ///  _format Image format
+      /// \return Pointer to the new Connection. This must be kept in scope.
+      /// Null if the render engine does not support it.
+      /// \sa computePointCloudNormals
+      public: virtual ignition::common::ConnectionPtr ConnectNewNormalFrame(
+          std::function<void(const float *_normals, unsigned int _width,
+          unsigned int _height, unsigned int _depth,
+          const std::string &_format)> _subscriber) = 0;
+
+      /// \brief Connect to the new depth image signal delivering the depth
+      /// in the image format of the camera, as read back. With PF_L16 the
+      /// depth is in millimeters, 0 for depths that are not finite or do
+      /// not fit in 16 bits. With PF_FLOAT16_R it is in meters, as half
+      /// floats. Both are converted on the GPU so that two bytes per pixel
+      /// are read back when no float depth, point cloud, color or normals
+      /// are needed. Other formats deliver PF_FLOAT32_R depth. The image
+      /// format must be set before the first render.
+      /// \param[in] _subscriber Subscriber callback function
+      /// The arguments of the callback function are:
+      ///  _image Depth data
+      ///  _width Image width
+      ///  _height Image height
+      ///  _depth Image depth, i.e. number of channels
+      ///  _format Image format, e.g. "L16"
+      /// \return Pointer to the new Connection. This must be kept in scope.
+      /// Null if the render engine does not support it.
+      public: virtual ignition::common::ConnectionPtr ConnectNewRawDepthFrame(
+          std::function<void(const unsigned char *_image, unsigned int _width,
+          unsigned int _height, unsigned int _depth,
+          const std::string &_format)> _subscriber) = 0;
     };
   }
   }
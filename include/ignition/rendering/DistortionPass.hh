@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_DISTORTIONPASS_HH_
+#define IGNITION_RENDERING_DISTORTIONPASS_HH_
+
+#include <ignition/math/Vector2.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+#include "ignition/rendering/RenderPass.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \enum DistortionModel
+    /// \brief Lens distortion models. Both use the coefficients of the
+    /// OpenCV camera models, applied to normalized image coordinates, i.e.
+    /// coordinates on the image plane at a distance of 1 from the camera.
+    enum DistortionModel
+    {
+      /// \brief Brown-Conrady model: radial coefficients k1, k2 and k3 and
+      /// tangential coefficients p1 and p2
+      DM_BROWN_CONRADY = 0,
+
+      /// \brief Equidistant fisheye model: the distorted radius is
+      /// theta * (1 + k1 theta^2 + k2 theta^4 + k3 theta^6), with theta the
+      /// angle between the ray and the optical axis. p1 and p2 are not used.
+      DM_EQUIDISTANT = 1
+    };
+
+    /* \class DistortionPass DistortionPass.hh \
+     * ignition/rendering/DistortionPass.hh
+     */
+    /// \brief A render pass that applies lens distortion to the render
+    /// target on the GPU. The distorted image is sampled from the rendered
+    /// pinhole image, so the field of view of the distorted image is the
+    /// one of the camera and parts of it may not be covered.
+    class IGNITION_RENDERING_VISIBLE DistortionPass
+      : public virtual RenderPass
+    {
+      /// \brief Constructor
+      public: DistortionPass();
+
+      /// \brief Destructor
+      public: virtual ~DistortionPass();
+
+      /// \brief Get the distortion model
+      /// \return Distortion model
+      public: virtual DistortionModel Model() const = 0;
+
+      /// \brief Set the distortion model, DM_BROWN_CONRADY by default
+      /// \param[in] _model Distortion model
+      public: virtual void SetModel(DistortionModel _model) = 0;
+
+      /// \brief Get the first radial distortion coefficient
+      /// \return k1
+      public: virtual double K1() const = 0;
+
+      /// \brief Get the second radial distortion coefficient
+      /// \return k2
+      public: virtual double K2() const = 0;
+
+      /// \brief Get the third radial distortion coefficient
+      /// \return k3
+      public: virtual double K3() const = 0;
+
+      /// \brief Get the first tangential distortion coefficient
+      /// \return p1
+      public: virtual double P1() const = 0;
+
+      /// \brief Get the second tangential distortion coefficient
+      /// \return p2
+      public: virtual double P2() const = 0;
+
+      /// \brief Get the distortion center
+      /// \return Distortion center in normalized texture coordinates
+      public: virtual math::Vector2d Center() const = 0;
+
+      /// \brief Set the first radial distortion coefficient
+      /// \param[in] _k1 k1
+      public: virtual void SetK1(double _k1) = 0;
+
+      /// \brief Set the second radial distortion coefficient
+      /// \param[in] _k2 k2
+      public: virtual void SetK2(double _k2) = 0;
+
+      /// \brief Set the third radial distortion coefficient
+      /// \param[in] _k3 k3
+      public: virtual void SetK3(double _k3) = 0;
+
+      /// \brief Set the first tangential distortion coefficient
+      /// \param[in] _p1 p1
+      public: virtual void SetP1(double _p1) = 0;
+
+      /// \brief Set the second tangential distortion coefficient
+      /// \param[in] _p2 p2
+      public: virtual void SetP2(double _p2) = 0;
+
+      /// \brief Set the distortion center, the principal point of the
+      /// distorted image. (0.5, 0.5), the image center, by default.
+      /// \param[in] _center Distortion center in normalized texture
+      /// coordinates
+      public: virtual void SetCenter(const math::Vector2d &_center) = 0;
+    };
+    }
+  }
+}
+#endif
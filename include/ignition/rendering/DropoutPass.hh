@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_DROPOUTPASS_HH_
+#define IGNITION_RENDERING_DROPOUTPASS_HH_
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+#include "ignition/rendering/RenderPass.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /* \class DropoutPass DropoutPass.hh \
+     * ignition/rendering/DropoutPass.hh
+     */
+    /// \brief A render pass that randomly drops pixels of the render target.
+    /// Dropped pixels of cameras are black. Dropped rays of gpu rays return
+    /// no hit, i.e. the max range of the sensor and an intensity of 0, which
+    /// models lidar returns lost on dark or specular surfaces.
+    class IGNITION_RENDERING_VISIBLE DropoutPass
+      : public virtual RenderPass
+    {
+      /// \brief Constructor
+      public: DropoutPass();
+
+      /// \brief Destructor
+      public: virtual ~DropoutPass();
+
+      /// \brief Get the probability of a pixel to be dropped
+      /// \return Probability in [0, 1]
+      public: virtual double Probability() const = 0;
+
+      /// \brief Set the probability of a pixel to be dropped, drawn
+      /// independently for each pixel and frame. The default is 0.
+      /// \param[in] _probability Probability, clamped to [0, 1]
+      public: virtual void SetProbability(double _probability) = 0;
+
+      /// \brief Get the seed of the dropout
+      /// \return Seed of the dropout, 0 if the dropout is not seeded
+      /// \sa SetSeed
+      public: virtual unsigned int Seed() const = 0;
+
+      /// \brief Seed the dropout of this pass, with the same counter based
+      /// generator as GaussianNoisePass::SetSeed. The default, 0, draws the
+      /// dropout from the global random generator.
+      /// \param[in] _seed Seed of the dropout, 0 to disable seeding
+      public: virtual void SetSeed(unsigned int _seed) = 0;
+    };
+    }
+  }
+}
+#endif
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_ENVIRONMENTMAPFILTER_HH_
+#define IGNITION_RENDERING_ENVIRONMENTMAPFILTER_HH_
+
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \class EnvironmentMapFilter EnvironmentMapFilter.hh
+    /// ignition/rendering/EnvironmentMapFilter.hh
+    /// \brief Prefilters cubemaps for image based lighting, so render engines
+    /// only need to do it once per environment map. Cubemaps hold 6 square
+    /// faces in +X, -X, +Y, -Y, +Z, -Z order, following the OpenGL
+    /// convention for the direction of each texel. Faces are stored row by
+    /// row, 4 linear floats per texel, in R, G, B, A order.
+    class IGNITION_RENDERING_VISIBLE EnvironmentMapFilter
+    {
+      /// \brief Get the number of mipmap levels of a cubemap, down to 1x1
+      /// \param[in] _size Width of the faces in texels
+      /// \return Number of levels, 0 if the size is 0
+      public: static unsigned int MipCount(unsigned int _size);
+
+      /// \brief Get the direction of a point of a cubemap face
+      /// \param[in] _face Face index
+      /// \param[in] _u Horizontal coordinate on the face, in [0, 1]
+      /// \param[in] _v Vertical coordinate on the face, in [0, 1]
+      /// \return Unit direction
+      public: static math::Vector3d Direction(unsigned int _face, double _u,
+          double _v);
+
+      /// \brief Prefilter a cubemap for specular reflections. Level 0 is a
+      /// copy of the cubemap and each following level, half as large, is
+      /// the cubemap convolved with a GGX lobe, with importance sampling of
+      /// box filtered mipmaps. The roughness of the lobe grows linearly with
+      /// the level, to match the level the shaders of the render engine
+      /// sample for a given roughness.
+      /// \param[in] _faces Cubemap data
+      /// \param[in] _size Width of the faces in texels
+      /// \param[in] _mipCount Number of levels, at most MipCount(_size)
+      /// \param[in] _roughnessStep Roughness added at each level, the
+      /// roughness being clamped to 1
+      /// \return Data of each level, empty if the cubemap is empty
+      public: static std::vector<std::vector<float>> PrefilterSpecular(
+          const float *_faces, unsigned int _size, unsigned int _mipCount,
+          double _roughnessStep);
+
+      /// \brief Project the diffuse lighting of a cubemap on the first 9
+      /// spherical harmonics
+      /// \param[in] _faces Cubemap data
+      /// \param[in] _size Width of the faces in texels
+      /// \return RGB coefficients of the irradiance, 9 of them, all zero if
+      /// the cubemap is empty
+      public: static std::vector<math::Vector3d> IrradianceSh(
+          const float *_faces, unsigned int _size);
+
+      /// \brief Evaluate spherical harmonics computed by IrradianceSh
+      /// \param[in] _sh Irradiance coefficients
+      /// \param[in] _normal Unit surface normal
+      /// \return Irradiance divided by pi, i.e. the RGB radiance reflected by
+      /// a white diffuse surface
+      public: static math::Vector3d Irradiance(
+          const std::vector<math::Vector3d> &_sh,
+          const math::Vector3d &_normal);
+    };
+    }
+  }
+}
+#endif
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_FRAMEDISPATCHER_HH_
+#define IGNITION_RENDERING_FRAMEDISPATCHER_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include <ignition/common/SuppressWarning.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+      /// \enum FrameDispatchPolicy
+      /// \brief How the new frame events of a sensor call their subscribers
+      enum IGNITION_RENDERING_VISIBLE FrameDispatchPolicy
+      {
+        /// \brief Subscribers are called on the render thread, in PostRender
+        FDP_SYNCHRONOUS = 0,
+
+        /// \brief Subscribers are called on a worker thread with a copy of
+        /// the frame. When the queue of the sensor is full, the oldest frame
+        /// not delivered yet is dropped.
+        FDP_DROP_OLDEST = 1,
+
+        /// \brief Subscribers are called on a worker thread with a copy of
+        /// the frame. When the queue of the sensor is full, the render
+        /// thread waits for a frame to be delivered.
+        FDP_BLOCK = 2
+      };
+
+      // forward declaration
+      class FrameChannelPrivate;
+      class FrameDispatcherPrivate;
+
+      /// \brief Queue of the frames of a sensor delivered by the
+      /// FrameDispatcher workers. Frames of a channel are delivered in
+      /// order, one at a time. Frames are posted by a single thread, the
+      /// render thread.
+      class IGNITION_RENDERING_VISIBLE FrameChannel
+      {
+        /// \brief Constructor
+        /// \param[in] _policy Policy when the queue is full, one of
+        /// FDP_DROP_OLDEST or FDP_BLOCK
+        /// \param[in] _capacity Number of frames waiting to be delivered
+        /// before the policy applies
+        public: FrameChannel(FrameDispatchPolicy _policy,
+                    unsigned int _capacity);
+
+        /// \brief Destructor. Waits for the frames posted to be delivered.
+        public: ~FrameChannel();
+
+        /// \brief Get the policy applied when the queue is full
+        /// \return Queue policy
+        public: FrameDispatchPolicy Policy() const;
+
+        /// \brief Queue a frame to be delivered by a worker
+        /// \param[in] _frame Function calling the subscribers. It must hold
+        /// the frames it reads, see SensorFramePool.
+        public: void Post(std::function<void()> _frame);
+
+        /// \brief Wait for all the frames posted to be delivered or dropped
+        public: void Flush();
+
+        /// \brief Get the number of frames dropped because the queue was full
+        /// \return Number of frames dropped
+        public: uint64_t DroppedCount() const;
+
+        /// \brief Deliver the frames of the channel until its queue is
+        /// empty. Called by the workers of the dispatcher.
+        private: void Deliver();
+
+        /// \brief The dispatcher workers deliver the frames
+        private: friend class FrameDispatcherPrivate;
+
+        IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+        private: std::unique_ptr<FrameChannelPrivate> dataPtr;
+        IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+      };
+
+      /// \brief Pool of worker threads delivering the frames of the sensors
+      /// that do not use FDP_SYNCHRONOUS, so subscribers never run on the
+      /// render thread and a slow subscriber only delays its own sensor.
+      /// Frames pass from the render thread to the workers through lock free
+      /// queues.
+      class IGNITION_RENDERING_VISIBLE FrameDispatcher
+      {
+        /// \brief Destructor. Stops the workers.
+        public: ~FrameDispatcher();
+
+        /// \brief Get the dispatcher
+        /// \return Dispatcher shared by all sensors
+        public: static FrameDispatcher *Instance();
+
+        /// \brief Set the number of worker threads. Only has an effect
+        /// before the first frame is dispatched.
+        /// \param[in] _count Number of workers, zero for half the hardware
+        /// threads. Defaults to zero.
+        public: void SetWorkerCount(unsigned int _count);
+
+        /// \brief Get the number of worker threads
+        /// \return Number of workers
+        public: unsigned int WorkerCount() const;
+
+        /// \brief Constructor
+        private: FrameDispatcher();
+
+        /// \brief Schedule a channel with frames to deliver
+        /// \param[in] _channel Channel to schedule
+        private: void Schedule(FrameChannel *_channel);
+
+        /// \brief Channels are scheduled when frames are posted
+        private: friend class FrameChannel;
+
+        IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+        private: std::unique_ptr<FrameDispatcherPrivate> dataPtr;
+        IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+      };
+    }
+  }
+}
+#endif
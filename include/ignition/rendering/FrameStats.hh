@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_FRAMESTATS_HH_
+#define IGNITION_RENDERING_FRAMESTATS_HH_
+
+#include <cstdint>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Rendering cost of a frame of a sensor. Counters the render
+    /// engine does not report are left at 0.
+    /// \sa Sensor::LastFrameStats
+    class IGNITION_RENDERING_VISIBLE FrameStats
+    {
+      /// \brief Number of draw calls
+      public: uint64_t drawCalls = 0u;
+
+      /// \brief Number of instances drawn by the draw calls
+      public: uint64_t instances = 0u;
+
+      /// \brief Number of batches, i.e. draws of a renderable or of a set
+      /// of instances sharing their state
+      public: uint64_t batches = 0u;
+
+      /// \brief Number of triangles drawn
+      public: uint64_t triangles = 0u;
+
+      /// \brief Number of vertices drawn
+      public: uint64_t vertices = 0u;
+
+      /// \brief Number of bytes of render targets read back to CPU memory
+      public: uint64_t readbackBytes = 0u;
+
+      /// \brief CPU time in milliseconds spent by the render engine issuing
+      /// the passes of the sensor
+      public: double cpuTime = 0.0;
+
+      /// \brief GPU time in milliseconds of the passes of the sensor, the
+      /// sum of Sensor::GpuTimes. 0 unless GPU timing is enabled, see
+      /// RenderEngine::SetGpuTimingEnabled.
+      public: double gpuTime = 0.0;
+    };
+
+    /// \brief Memory used by the resources loaded by a render engine
+    /// \sa Scene::ResourceMemoryStats
+    class IGNITION_RENDERING_VISIBLE MemoryStats
+    {
+      /// \brief Bytes of the vertex and index buffers of the meshes
+      public: uint64_t meshBytes = 0u;
+
+      /// \brief Bytes of the textures, other than render targets
+      public: uint64_t textureBytes = 0u;
+
+      /// \brief Bytes of the render targets, including those of the
+      /// sensors and of their compositor passes
+      public: uint64_t renderTargetBytes = 0u;
+    };
+    }
+  }
+}
+#endif
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_FRAMEWRITER_HH_
+#define IGNITION_RENDERING_FRAMEWRITER_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <ignition/common/SuppressWarning.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+#include "ignition/rendering/Image.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+      // forward declaration
+      class FrameWriterPrivate;
+
+      /// \brief Writes images to files on worker threads, so that frames
+      /// can be recorded at render speed. The file format is chosen from
+      /// the file extension: ".png" files are compressed PNG images, which
+      /// supports 8 bit images and PF_L16, and any other extension, e.g.
+      /// ".raw", gets the pixels of the image, tightly packed, without a
+      /// header, which supports every format. The queue of frames waiting
+      /// to be written is bounded: Write blocks while it is full, so that
+      /// frames are never dropped and memory does not grow when the disk
+      /// is slower than the renderer. Images written with Write share their
+      /// buffer, e.g. acquired from an ImagePool, until the frame is
+      /// written.
+      class IGNITION_RENDERING_VISIBLE FrameWriter
+      {
+        /// \brief Constructor
+        /// \param[in] _workerCount Number of worker threads, at least one
+        /// \param[in] _capacity Number of frames waiting to be written
+        /// before Write blocks, at least one
+        public: explicit FrameWriter(unsigned int _workerCount = 2u,
+                    unsigned int _capacity = 8u);
+
+        /// \brief Destructor. Writes the frames queued then stops the
+        /// workers.
+        public: ~FrameWriter();
+
+        /// \brief Get the writer used by Camera::SaveFrame
+        /// \return Writer shared by all cameras
+        public: static FrameWriter *Instance();
+
+        /// \brief Queue an image to be written to a file by a worker. Can be
+        /// called from any thread.
+        /// \param[in] _image Image to write. The image shares its buffer
+        /// until it is written, so the buffer must not be modified until
+        /// then.
+        /// \param[in] _path Path of the file to write
+        /// \return True if the image is queued, false if it or the path is
+        /// empty
+        public: bool Write(const Image &_image, const std::string &_path);
+
+        /// \brief Wait for the frames queued to be written
+        public: void Flush();
+
+        /// \brief Get the number of frames written since the creation of
+        /// the writer
+        /// \return Number of frames written
+        public: uint64_t WrittenCount() const;
+
+        /// \brief Get the number of frames that could not be written, e.g.
+        /// because the directory does not exist
+        /// \return Number of frames not written
+        public: uint64_t FailedCount() const;
+
+        /// \brief Write an image to a file on the calling thread, in the
+        /// format given by the file extension
+        /// \param[in] _image Image to write
+        /// \param[in] _path Path of the file to write
+        /// \return True if the file is written
+        public: static bool WriteFile(const Image &_image,
+                    const std::string &_path);
+
+        IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+        /// \brief Private data pointer
+        private: std::unique_ptr<FrameWriterPrivate> dataPtr;
+        IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+      };
+    }
+  }
+}
+#endif
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_FXAAPASS_HH_
+#define IGNITION_RENDERING_FXAAPASS_HH_
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+#include "ignition/rendering/RenderPass.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /* \class FxaaPass FxaaPass.hh \
+     * ignition/rendering/FxaaPass.hh
+     */
+    /// \brief A render pass that smooths the edges of the render target
+    /// with fast approximate anti-aliasing (FXAA). The edges are detected
+    /// from the luma of the pixels and blended along their direction, in a
+    /// single full screen pass. It is a cheaper alternative to
+    /// Camera::SetAntiAliasing, which multisamples the render target and
+    /// multiplies its memory and bandwidth.
+    class IGNITION_RENDERING_VISIBLE FxaaPass
+      : public virtual RenderPass
+    {
+      /// \brief Constructor
+      public: FxaaPass();
+
+      /// \brief Destructor
+      public: virtual ~FxaaPass();
+
+      /// \brief Get the amount of sub-pixel aliasing removed
+      /// \return Sub-pixel quality in [0, 1]
+      public: virtual double SubpixelQuality() const = 0;
+
+      /// \brief Set the amount of sub-pixel aliasing removed. Higher values
+      /// are smoother but blurrier. The default is 0.75.
+      /// \param[in] _quality Sub-pixel quality, clamped to [0, 1]. 0 only
+      /// smooths the edges.
+      public: virtual void SetSubpixelQuality(double _quality) = 0;
+
+      /// \brief Get the contrast an edge must have, relative to the
+      /// brightest pixel around it
+      /// \return Relative edge threshold in [0, 1]
+      public: virtual double EdgeThreshold() const = 0;
+
+      /// \brief Set the contrast an edge must have, relative to the
+      /// brightest pixel around it. Lower values smooth more edges at a
+      /// higher cost. The default is 0.166.
+      /// \param[in] _threshold Relative threshold, clamped to [0, 1]
+      public: virtual void SetEdgeThreshold(double _threshold) = 0;
+
+      /// \brief Get the smallest contrast an edge must have, so that the
+      /// noise of dark areas is not smoothed
+      /// \return Absolute edge threshold in [0, 1]
+      public: virtual double EdgeThresholdMin() const = 0;
+
+      /// \brief Set the smallest contrast an edge must have, so that the
+      /// noise of dark areas is not smoothed. The default is 0.0833.
+      /// \param[in] _threshold Absolute threshold, clamped to [0, 1]
+      public: virtual void SetEdgeThresholdMin(double _threshold) = 0;
+    };
+    }
+  }
+}
+#endif
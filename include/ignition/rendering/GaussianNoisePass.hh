@@ -70,6 +70,20 @@ namespace ignition
       /// based on the bias mean and bias standard deviation.
       /// \sa SetBiasMean
       public: virtual void SetBiasStdDev(double _biasStdDev) = 0;
+
+      /// \brief Get the seed of the noise
+      /// \return Seed of the noise, 0 if the noise is not seeded
+      /// \sa SetSeed
+      public: virtual unsigned int Seed() const = 0;
+
+      /// \brief Seed the noise of this pass. A seeded pass draws its noise
+      /// on the GPU from a counter based generator keyed by the seed, with
+      /// the frame number and the pixel as counter, so the noise of a sensor
+      /// is reproducible and does not depend on other passes or threads.
+      /// The default, 0, draws the noise from the global random generator.
+      /// Only supported by ogre2, other engines ignore the seed.
+      /// \param[in] _seed Seed of the noise, 0 to disable seeding
+      public: virtual void SetSeed(unsigned int _seed) = 0;
     };
     }
   }
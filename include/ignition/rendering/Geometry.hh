@@ -66,6 +66,32 @@ namespace ignition
       /// \brief Get the material of this geometry
       /// \return Material used by this geometry
       public: virtual MaterialPtr Material() const = 0;
+
+      /// \brief Render this geometry with the given material instead of
+      /// the material set with SetMaterial. The material is used as is,
+      /// without being cloned, and the material set with SetMaterial is
+      /// kept, so that the override can be cleared without cloning it
+      /// again.
+      /// \param[in] _material Material to render with, null to restore the
+      /// material set with SetMaterial
+      public: virtual void SetMaterialOverride(MaterialPtr _material) = 0;
+
+      /// \brief Get the material set with SetMaterialOverride
+      /// \return Override material, null if there is none
+      public: virtual MaterialPtr MaterialOverride() const = 0;
+
+      /// \brief Create a copy of this geometry in the same scene. Render
+      /// engines reuse the loaded data of the geometry where they can, e.g.
+      /// the engine mesh of a mesh geometry, so that copying a geometry is
+      /// cheaper than creating it again. The copy is not attached to a
+      /// visual.
+      /// \param[in] _shareMaterials True if the copy should use the
+      /// materials of this geometry, false if it should get its own copies
+      /// of them. Materials cloned for this geometry are still destroyed
+      /// with it, so copies sharing them must be destroyed first.
+      /// \return The copy, null if this type of geometry can not be copied
+      public: virtual GeometryPtr Clone(bool _shareMaterials = false)
+                  const = 0;
     };
     }
   }
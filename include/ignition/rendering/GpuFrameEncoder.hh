@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_GPUFRAMEENCODER_HH_
+#define IGNITION_RENDERING_GPUFRAMEENCODER_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include <ignition/common/SuppressWarning.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+#include "ignition/rendering/PixelFormat.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+      /// \brief Packet of an encoded video stream, e.g. a H.264 access unit
+      struct EncodedPacket
+      {
+        /// \brief Encoded bytes, only valid during the packet callback
+        const unsigned char *data = nullptr;
+
+        /// \brief Number of encoded bytes
+        size_t size = 0u;
+
+        /// \brief Index of the frame the packet belongs to
+        uint64_t frame = 0u;
+
+        /// \brief True if the packet can be decoded without the previous
+        /// ones
+        bool keyFrame = false;
+      };
+
+      /// \brief Encoder of camera frames reading the render texture of the
+      /// camera in GPU memory, e.g. NVENC with the texture registered with
+      /// CUDA, or VAAPI with the texture imported as an EGL image. Frames
+      /// are encoded without copying them to host memory, so a camera only
+      /// streamed to an encoder never reads its frames back to the CPU. The
+      /// library does not link any encoder: applications implement this
+      /// class with the API of their hardware and set it on cameras with
+      /// Camera::SetFrameEncoder. All the functions are called from the
+      /// thread rendering the camera, which owns the GL context.
+      class IGNITION_RENDERING_VISIBLE GpuFrameEncoder
+      {
+        /// \brief Callback receiving encoded packets
+        public: typedef std::function<void(const EncodedPacket &)>
+                    PacketCallback;
+
+        /// \brief Destructor
+        public: virtual ~GpuFrameEncoder();
+
+        /// \brief Register the render texture of the camera with the
+        /// encoder. Called before the first frame is encoded, and again
+        /// whenever the texture, its size or its format change.
+        /// \param[in] _textureId OpenGL id of the GL_TEXTURE_2D to encode
+        /// \param[in] _width Texture width in pixels
+        /// \param[in] _height Texture height in pixels
+        /// \param[in] _format Pixel format of the camera
+        /// \return True if the texture can be encoded
+        public: virtual bool RegisterTexture(unsigned int _textureId,
+                    unsigned int _width, unsigned int _height,
+                    PixelFormat _format) = 0;
+
+        /// \brief Encode the current content of the registered texture.
+        /// Called after each render of the camera. Packets are passed to
+        /// EmitPacket, possibly for previous frames.
+        /// \param[in] _frame Index of the frame, from zero
+        /// \return True if the frame is encoded
+        public: virtual bool EncodeFrame(uint64_t _frame) = 0;
+
+        /// \brief Release the registered texture and flush the pending
+        /// packets. Called when the encoder is removed from the camera.
+        public: virtual void UnregisterTexture() = 0;
+
+        /// \brief Set the function receiving the encoded packets
+        /// \param[in] _callback Callback, may be empty
+        public: void SetPacketCallback(PacketCallback _callback);
+
+        /// \brief Pass an encoded packet to the packet callback
+        /// \param[in] _packet Encoded packet
+        protected: void EmitPacket(const EncodedPacket &_packet) const;
+
+        IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+        /// \brief Function receiving the encoded packets
+        private: PacketCallback packetCallback;
+        IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+      };
+
+      /// \brief Shared pointer to a GpuFrameEncoder
+      typedef std::shared_ptr<GpuFrameEncoder> GpuFrameEncoderPtr;
+    }
+  }
+}
+#endif
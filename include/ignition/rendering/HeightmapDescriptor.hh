@@ -24,6 +24,7 @@
 
 #include "ignition/rendering/config.hh"
 #include "ignition/rendering/Export.hh"
+#include "ignition/rendering/HeightmapTileSource.hh"
 
 namespace ignition
 {
@@ -186,6 +187,19 @@ inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
     /// \param[in] _data New data.
     public: void SetData(const std::shared_ptr<common::HeightmapData> &_data);
 
+    /// \brief Get the source the heightfield samples are streamed from.
+    /// \return Tile source, null if the samples come from Data().
+    public: std::shared_ptr<HeightmapTileSource> TileSource() const;
+
+    /// \brief Set a source to stream the heightfield samples from, instead
+    /// of decoding all of them from Data(). Only the parts of the heightmap
+    /// that are drawn are read. The heights of the source are in meters and
+    /// Size() only gives the extent of the heightmap along x and y.
+    /// Sampling() is not used. Only supported by ogre2.
+    /// \param[in] _source Tile source, null to use Data().
+    public: void SetTileSource(
+        const std::shared_ptr<HeightmapTileSource> &_source);
+
     /// \brief Get the heightmap's scaling factor.
     /// \return The heightmap's size.
     public: ignition::math::Vector3d Size() const;
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_HEIGHTMAPTILESOURCE_HH_
+#define IGNITION_RENDERING_HEIGHTMAPTILESOURCE_HH_
+
+#include <vector>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+      /// \brief Source of heightmap samples read on demand, for heightmaps
+      /// too large to be decoded in memory. Render engines that support it
+      /// only read the samples of the parts of the heightmap they draw, at
+      /// the level of detail they draw them.
+      /// \sa HeightmapDescriptor::SetTileSource
+      class IGNITION_RENDERING_VISIBLE HeightmapTileSource
+      {
+        /// \brief Destructor
+        public: virtual ~HeightmapTileSource();
+
+        /// \brief Get the number of samples along a side of the heightmap.
+        /// Heightmaps are square and have 2^n+1 samples along a side.
+        /// \return Number of samples along a side
+        public: virtual unsigned int SampleCount() const = 0;
+
+        /// \brief Read the heights of a square grid of samples. The heights
+        /// are returned row by row along +y, starting at the minimum x and
+        /// y. Samples out of the heightmap are clamped to its edges. This
+        /// function is called from background threads and must be thread
+        /// safe.
+        /// \param[in] _x First sample along x
+        /// \param[in] _y First sample along y
+        /// \param[in] _stride Number of samples between two samples read
+        /// \param[in] _count Number of samples read along a side
+        /// \param[out] _heights _count * _count heights, in meters
+        /// \return True if the heights were read
+        public: virtual bool Heights(int _x, int _y, unsigned int _stride,
+            unsigned int _count, std::vector<float> &_heights) const = 0;
+      };
+    }
+  }
+}
+#endif
@@ -48,6 +48,19 @@ namespace ignition
       public: Image(unsigned int _width, unsigned int _height,
                   PixelFormat _format);
 
+      /// \brief Constructor wrapping a buffer owned by the caller, such as
+      /// pinned or aligned memory. The image does not allocate nor free
+      /// memory and the buffer must outlive the image and its copies.
+      /// \param[in] _width Image width in pixels
+      /// \param[in] _height Image height in pixels
+      /// \param[in] _format Image pixel format
+      /// \param[in] _data Buffer of at least _height * row stride bytes
+      /// \param[in] _rowStride Number of bytes between the start of two
+      /// rows, a multiple of the pixel size. Zero for tightly packed rows.
+      public: Image(unsigned int _width, unsigned int _height,
+                  PixelFormat _format, void *_data,
+                  unsigned int _rowStride = 0u);
+
       /// \brief Destructor
       public: ~Image();
 
@@ -67,10 +80,15 @@ namespace ignition
       /// \return The image channel depth
       public: unsigned int Depth() const;
 
-      /// \brief Get image channel depth
-      /// \return The image channel depth
+      /// \brief Get the size of the image buffer, including the padding at
+      /// the end of the rows
+      /// \return The size of the image buffer in bytes
       public: unsigned int MemorySize() const;
 
+      /// \brief Get the number of bytes between the start of two rows
+      /// \return The row stride in bytes
+      public: unsigned int RowStride() const;
+
       /// \brief Get a const pointer to image data
       /// \return The const pointer to image data
       public: const void *Data() const;
@@ -100,10 +118,16 @@ namespace ignition
       /// \brief Image pixel format
       private: PixelFormat format = PF_UNKNOWN;
 
+      /// \brief Number of bytes between the start of two rows
+      private: unsigned int rowStride = 0;
+
       IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
       /// \brief Pointer to the image data
       private: DataPtr data = nullptr;
       IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+
+      /// \brief The pool checks whether its buffers are still in use
+      private: friend class ImagePool;
     };
 
     //////////////////////////////////////////////////
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_IMAGEPOOL_HH_
+#define IGNITION_RENDERING_IMAGEPOOL_HH_
+
+#include <memory>
+
+#include <ignition/common/SuppressWarning.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+#include "ignition/rendering/Image.hh"
+#include "ignition/rendering/PixelFormat.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+      // forward declaration
+      class ImagePoolPrivate;
+
+      /// \brief Pool of image buffers of the same size and format, to
+      /// capture camera frames without allocating memory once the pool
+      /// holds as many buffers as there are frames in use. An image
+      /// acquired from the pool returns its buffer to the pool when it and
+      /// all its copies are destroyed. The pool is not thread safe.
+      class IGNITION_RENDERING_VISIBLE ImagePool
+      {
+        /// \brief Constructor
+        /// \param[in] _width Image width in pixels
+        /// \param[in] _height Image height in pixels
+        /// \param[in] _format Image pixel format
+        public: ImagePool(unsigned int _width, unsigned int _height,
+                    PixelFormat _format);
+
+        /// \brief Destructor. Images still in use keep their buffers.
+        public: ~ImagePool();
+
+        /// \brief Get an image whose buffer is not used by any other image
+        /// acquired from the pool. A buffer is allocated if all of them are
+        /// in use.
+        /// \return Image of the size and format of the pool
+        public: Image Acquire();
+
+        /// \brief Allocate buffers up front
+        /// \param[in] _count Minimum number of buffers held by the pool
+        public: void Reserve(unsigned int _count);
+
+        /// \brief Get the number of buffers allocated by the pool
+        /// \return Number of buffers, used or not
+        public: unsigned int Size() const;
+
+        /// \brief Get the number of buffers used by images acquired from
+        /// the pool
+        /// \return Number of buffers in use
+        public: unsigned int InUseCount() const;
+
+        IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+        private: std::unique_ptr<ImagePoolPrivate> dataPtr;
+        IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+      };
+    }
+  }
+}
+#endif
@@ -76,6 +76,16 @@ namespace ignition
       public: virtual void SetPoints(const std::vector<double> &_points,
                         const std::vector<ignition::math::Color> &_colors) = 0;
 
+      /// \brief Set lidar points to be visualised from single precision
+      /// data, e.g. the frames of GpuRays::ConnectNewGpuRaysFrame, without
+      /// converting them to double precision first.
+      /// \param[in] _data Data with the distance of each ray
+      /// \param[in] _count Number of rays
+      /// \param[in] _channels Number of floats per ray, the first of which
+      /// is the distance of the ray
+      public: virtual void SetPoints(const float *_data, unsigned int _count,
+                        unsigned int _channels = 1u) = 0;
+
       /// \brief Set minimum vertical angle
       /// \param[in] _minVerticalAngle Minimum vertical angle
       public: virtual void SetMinVerticalAngle(
@@ -107,6 +107,20 @@ namespace ignition
       /// \param[in] _castShadows True if this light cast shadows
       public: virtual void SetCastShadows(bool _castShadows) = 0;
 
+      /// \brief Specify if this light is static, i.e. it is not expected to
+      /// move. Render engines may render the shadow maps of static lights
+      /// once and reuse them until a static light or visual changes.
+      /// Shadows cast by visuals that are not static are only updated along
+      /// with those shadow maps.
+      /// \param[in] _static True if this light is static
+      /// \sa Visual::SetStatic
+      public: virtual void SetStatic(bool _static) = 0;
+
+      /// \brief Get whether this light is static
+      /// \return True if this light is static
+      /// \sa SetStatic
+      public: virtual bool Static() const = 0;
+
       /// \brief Get the light intensity
       /// \return The light intensity
       public: virtual double Intensity() const = 0;
@@ -17,6 +17,8 @@
 #ifndef IGNITION_RENDERING_MARKER_HH_
 #define IGNITION_RENDERING_MARKER_HH_
 
+#include <cstddef>
+
 #include <ignition/common/Time.hh>
 #include <ignition/math/Color.hh>
 #include <ignition/math/Vector3.hh>
@@ -131,6 +133,16 @@ namespace ignition
       /// \param[in] _value The new positional vector of the point
       public: virtual void SetPoint(unsigned int _index,
                   const ignition::math::Vector3d &_value) = 0;
+
+      /// \brief Replace all points of the marker. This is faster than
+      /// clearing the points and adding them one by one, e.g. for markers
+      /// with many points that change every frame.
+      /// \param[in] _xyz Point positions, 3 floats per point
+      /// \param[in] _count Number of points
+      /// \param[in] _rgba Point colors, 4 floats per point. Points are white
+      /// if null.
+      public: virtual void SetPoints(const float *_xyz, size_t _count,
+                  const float *_rgba = nullptr) = 0;
     };
     }
   }
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_MEMORYTRACKER_HH_
+#define IGNITION_RENDERING_MEMORYTRACKER_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \enum MemoryCategory MemoryTracker.hh
+    /// ignition/rendering/MemoryTracker.hh
+    /// \brief Categories of the allocations accounted by MemoryTracker
+    enum IGNITION_RENDERING_VISIBLE MemoryCategory
+    {
+      /// \brief Pixel buffers owned by images
+      MC_IMAGE            = 0,
+      /// \brief CPU buffers the sensors read their frames back to
+      MC_SENSOR_BUFFER    = 1,
+      /// \brief CPU vertex buffers of dynamic geometries, e.g. markers
+      MC_DYNAMIC_GEOMETRY = 2,
+      /// \brief Vertex and index buffers of the meshes uploaded to the GPU
+      MC_MESH             = 3,
+      /// \brief Textures uploaded to the GPU by materials
+      MC_TEXTURE          = 4,
+      /// \brief Number of categories
+      MC_COUNT            = 5
+    };
+
+    /// \brief Memory accounted to a category
+    struct IGNITION_RENDERING_VISIBLE MemoryUsage
+    {
+      /// \brief Bytes currently allocated
+      uint64_t bytes = 0u;
+
+      /// \brief Largest number of bytes allocated at once
+      uint64_t peakBytes = 0u;
+
+      /// \brief Number of allocations currently alive
+      uint64_t allocations = 0u;
+
+      /// \brief Number of allocations made since the start of the process
+      uint64_t totalAllocations = 0u;
+    };
+
+    /// \brief Accounts the memory allocated by the resource creation
+    /// points of the library and of the render engines, per category, so
+    /// that memory growth can be attributed in long running simulations.
+    /// Allocations are identified by their address. The tracker is thread
+    /// safe.
+    class IGNITION_RENDERING_VISIBLE MemoryTracker
+    {
+      /// \brief Account an allocation. Tracking an address already tracked
+      /// replaces its previous allocation.
+      /// \param[in] _category Category of the allocation
+      /// \param[in] _ptr Address of the allocation, ignored if null
+      /// \param[in] _bytes Size of the allocation in bytes
+      public: static void Track(MemoryCategory _category, const void *_ptr,
+                  size_t _bytes);
+
+      /// \brief Stop accounting an allocation, before it is released
+      /// \param[in] _ptr Address of the allocation, ignored if it is not
+      /// tracked
+      public: static void Untrack(const void *_ptr);
+
+      /// \brief Get the memory accounted to a category
+      /// \param[in] _category Category
+      /// \return Memory usage of the category
+      public: static MemoryUsage Usage(MemoryCategory _category);
+
+      /// \brief Get the bytes currently accounted to all categories
+      /// \return Total bytes allocated
+      public: static uint64_t TotalBytes();
+
+      /// \brief Get the name of a category, e.g. for reports
+      /// \param[in] _category Category
+      /// \return Name of the category, e.g. "sensor_buffer"
+      public: static std::string CategoryName(MemoryCategory _category);
+    };
+    }
+  }
+}
+#endif
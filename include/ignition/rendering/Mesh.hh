@@ -20,9 +20,11 @@
 #include <map>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <ignition/math/Matrix4.hh>
 #include "ignition/rendering/config.hh"
 #include "ignition/rendering/Geometry.hh"
+#include "ignition/rendering/MeshDescriptor.hh"
 #include "ignition/rendering/Object.hh"
 
 namespace ignition
@@ -59,6 +61,26 @@ namespace ignition
       public: virtual void SetSkeletonLocalTransforms(
             const std::map<std::string, math::Matrix4d> &_tfs) = 0;
 
+      /// \brief Get the names of the skeleton bones, in the order of their
+      /// indices. Resolve the bones once with it, then update them with
+      /// SetSkeletonBoneTransforms.
+      /// \return Names of the bones, empty if the mesh has no skeleton
+      public: virtual std::vector<std::string> SkeletonBoneNames() const = 0;
+
+      /// \brief Get the number of skeleton bones
+      /// \return Number of bones, 0 if the mesh has no skeleton
+      public: virtual unsigned int SkeletonBoneCount() const = 0;
+
+      /// \brief Set the local transforms of the skeleton bones by index.
+      /// Unlike SetSkeletonLocalTransforms, no bone is looked up by name.
+      /// \param[in] _tfs Contiguous local transformations, the i-th one is
+      /// set to the bone at index i
+      /// \param[in] _count Number of transformations. Bones past the last
+      /// transformation are left unchanged.
+      /// \sa SkeletonBoneNames
+      public: virtual void SetSkeletonBoneTransforms(
+            const math::Matrix4f *_tfs, unsigned int _count) = 0;
+
       /// \brief Get skeleton node weight
       /// \return Map of skeleton node name to its weight
       /// * Map holding:
@@ -119,6 +141,16 @@ namespace ignition
       /// \return The sub-mesh at the given index
       public: virtual SubMeshPtr SubMeshByIndex(
                   unsigned int _index) const = 0;
+
+      /// \brief Get the descriptor this mesh was created from
+      /// \return Mesh descriptor, empty if the mesh was not created from a
+      /// descriptor
+      public: virtual const MeshDescriptor &Descriptor() const = 0;
+
+      /// \brief Set the descriptor this mesh was created from. This is
+      /// called by the scene when it creates the mesh.
+      /// \param[in] _desc Mesh descriptor
+      public: virtual void SetDescriptor(const MeshDescriptor &_desc) = 0;
     };
 
     /// \class SubMesh Mesh.hh ignition/rendering/Mesh.hh
@@ -146,6 +178,17 @@ namespace ignition
       /// \param[in] _unique True if the given material should be cloned
       public: virtual void SetMaterial(MaterialPtr _material,
                   bool unique = true) = 0;
+
+      /// \brief Render this SubMesh with the given material instead of the
+      /// currently assigned material, without cloning it
+      /// \param[in] _material Material to render with, null to restore the
+      /// currently assigned material
+      /// \sa Geometry::SetMaterialOverride
+      public: virtual void SetMaterialOverride(MaterialPtr _material) = 0;
+
+      /// \brief Get the material set with SetMaterialOverride
+      /// \return Override material, null if there is none
+      public: virtual MaterialPtr MaterialOverride() const = 0;
     };
     }
   }
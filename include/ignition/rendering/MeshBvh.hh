@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_MESHBVH_HH_
+#define IGNITION_RENDERING_MESHBVH_HH_
+
+#include <memory>
+
+#include <ignition/common/Mesh.hh>
+#include <ignition/common/SuppressWarning.hh>
+
+#include <ignition/math/Vector3.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+      // forward declaration
+      class MeshBvhPrivate;
+
+      /// \brief Bounding volume hierarchy over the triangles of a mesh, used
+      /// to find ray intersections in time logarithmic in the number of
+      /// triangles. All computations are done in the mesh frame.
+      class IGNITION_RENDERING_VISIBLE MeshBvh
+      {
+        /// \brief Constructor. Builds the hierarchy from all the triangles
+        /// of all submeshes of the given mesh.
+        /// \param[in] _mesh Mesh to build the hierarchy for
+        public: explicit MeshBvh(const common::Mesh &_mesh);
+
+        /// \brief Destructor
+        public: ~MeshBvh();
+
+        /// \brief Get the number of triangles in the hierarchy
+        /// \return Number of triangles
+        public: unsigned int TriangleCount() const;
+
+        /// \brief Find the closest intersection of a ray with the mesh.
+        /// Only triangles facing the ray, i.e. with counter clockwise
+        /// winding when seen from the ray origin, are considered.
+        /// \param[in] _origin Ray origin in the mesh frame
+        /// \param[in] _direction Ray direction in the mesh frame. It does not
+        /// need to be normalized
+        /// \param[out] _distance Ray parameter of the closest intersection,
+        /// i.e. the intersection point is _origin + _direction * _distance
+        /// \return True if the ray hits the mesh
+        public: bool Intersect(const math::Vector3d &_origin,
+            const math::Vector3d &_direction, double &_distance) const;
+
+        IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+        private: std::unique_ptr<MeshBvhPrivate> dataPtr;
+        IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+      };
+    }
+  }
+}
+#endif
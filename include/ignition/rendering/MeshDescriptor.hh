@@ -77,6 +77,22 @@ namespace ignition
 
       /// \brief Denotes if the loaded sub-mesh vertices should be centered
       public: bool centerSubMesh = false;
+
+      /// \brief Number of levels of detail to generate in addition to the
+      /// full detail mesh. Each level keeps half of the triangles of the
+      /// previous one. Levels are selected per camera from the size of the
+      /// mesh on screen, see Camera::SetLodBias. Render engines that do not
+      /// support levels of detail ignore it.
+      public: unsigned int lodLevels = 0u;
+
+      /// \brief Distance from the camera beyond which the mesh is drawn as
+      /// an impostor, a billboard showing the mesh as seen from the closest
+      /// of a set of directions rendered once when the mesh is loaded. The
+      /// impostor is the level of detail after the levels of lodLevels, so
+      /// it is selected per camera with the same bias, see
+      /// Camera::SetImpostorsEnabled. 0 disables impostors. Render engines
+      /// that do not support impostors ignore it.
+      public: double impostorDistance = 0.0;
     };
     }
   }
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_MESHOPTIMIZER_HH_
+#define IGNITION_RENDERING_MESHOPTIMIZER_HH_
+
+#include <memory>
+#include <vector>
+
+#include <ignition/common/SubMesh.hh>
+#include <ignition/common/SuppressWarning.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+      // forward declaration
+      class MeshOptimizerPrivate;
+
+      /// \brief Optimizes the vertex and index buffers of a submesh for the
+      /// GPU without changing its shape. Vertices with the same attributes
+      /// are welded, triangles are reordered for the post transform vertex
+      /// cache and vertices are reordered in the order they are fetched.
+      /// Meshes exported from CAD tools often have one vertex per triangle
+      /// corner and triangles in a random order, so this reduces both the
+      /// memory and the vertex shader invocations of their draws.
+      class IGNITION_RENDERING_VISIBLE MeshOptimizer
+      {
+        /// \brief Constructor. Copies the geometry of the given submesh.
+        /// Only triangle lists without node assignments are optimized,
+        /// other submeshes are returned unchanged by Result. Normals and
+        /// texture coordinate sets that do not have one value per vertex
+        /// are dropped.
+        /// \param[in] _subMesh Submesh to optimize
+        public: explicit MeshOptimizer(const common::SubMesh &_subMesh);
+
+        /// \brief Destructor
+        public: ~MeshOptimizer();
+
+        /// \brief Merge the vertices whose position, normal and texture
+        /// coordinates all round to the same multiples of a tolerance.
+        /// Triangles that become degenerate are removed.
+        /// \param[in] _tolerance Quantization step of the attributes, must
+        /// be positive
+        /// \return Number of vertices removed
+        public: unsigned int Weld(double _tolerance = 1e-6);
+
+        /// \brief Reorder the triangles so that consecutive triangles share
+        /// vertices still in the post transform vertex cache, with the
+        /// linear speed algorithm of Tom Forsyth. The algorithm does not
+        /// depend much on the actual cache size of the GPU.
+        /// \param[in] _cacheSize Size of the simulated vertex cache
+        public: void OptimizeVertexCache(unsigned int _cacheSize = 32u);
+
+        /// \brief Reorder the vertices in the order they are first used by
+        /// the triangles, so that vertex fetches read memory sequentially.
+        /// Vertices not used by any triangle are removed. Call this after
+        /// OptimizeVertexCache.
+        public: void OptimizeVertexFetch();
+
+        /// \brief Get the optimized submesh
+        /// \return Copy of the original submesh with the optimized geometry
+        public: common::SubMesh Result() const;
+
+        /// \brief Get the average number of vertex cache misses per
+        /// triangle of a triangle list, for a FIFO vertex cache. This is 3 in
+        /// the worst case and approaches 0.5 for large regular grids.
+        /// \param[in] _indices Indices of the triangle list
+        /// \param[in] _cacheSize Size of the simulated vertex cache
+        /// \return Average cache miss ratio, 0 if there are no triangles
+        public: static double CacheMissRatio(
+                    const std::vector<unsigned int> &_indices,
+                    unsigned int _cacheSize = 32u);
+
+        IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+        private: std::unique_ptr<MeshOptimizerPrivate> dataPtr;
+        IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+      };
+    }
+  }
+}
+#endif
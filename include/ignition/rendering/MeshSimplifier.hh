@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_MESHSIMPLIFIER_HH_
+#define IGNITION_RENDERING_MESHSIMPLIFIER_HH_
+
+#include <memory>
+#include <vector>
+
+#include <ignition/common/SubMesh.hh>
+#include <ignition/common/SuppressWarning.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+      // forward declaration
+      class MeshSimplifierPrivate;
+
+      /// \brief Simplifies the triangles of a submesh with quadric error
+      /// metrics, used to generate levels of detail. Edges are collapsed
+      /// onto one of their end points so the simplified triangles reference
+      /// the vertices of the original submesh and can share its vertex
+      /// buffer. Vertices with the same position, e.g. on texture seams,
+      /// are collapsed together.
+      class IGNITION_RENDERING_VISIBLE MeshSimplifier
+      {
+        /// \brief Constructor. Computes the error quadrics of the triangles
+        /// of the given submesh. Only triangle lists are simplified.
+        /// \param[in] _subMesh Submesh to simplify
+        public: explicit MeshSimplifier(const common::SubMesh &_subMesh);
+
+        /// \brief Destructor
+        public: ~MeshSimplifier();
+
+        /// \brief Get the number of triangles of the original submesh
+        /// \return Number of triangles
+        public: unsigned int TriangleCount() const;
+
+        /// \brief Simplify the submesh. Collapses stop early if no edge can
+        /// be collapsed without flipping triangles.
+        /// \param[in] _ratio Target ratio of triangles to keep, in [0, 1]
+        /// \return Indices of the simplified triangle list, referencing the
+        /// vertices of the original submesh. Empty if the submesh is not a
+        /// triangle list.
+        public: std::vector<unsigned int> Simplify(double _ratio) const;
+
+        IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+        private: std::unique_ptr<MeshSimplifierPrivate> dataPtr;
+        IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+      };
+    }
+  }
+}
+#endif
@@ -17,6 +17,7 @@
 #ifndef IGNITION_RENDERING_NODE_HH_
 #define IGNITION_RENDERING_NODE_HH_
 
+#include <functional>
 #include <string>
 #include <ignition/math/Pose3.hh>
 #include <ignition/math/Quaternion.hh>
@@ -267,6 +268,14 @@ namespace ignition
       /// \return The specified node
       public: virtual NodePtr ChildByIndex(unsigned int _index) const = 0;
 
+      /// \brief Call a function on every child node, in index order. This
+      /// does not copy shared pointers, so it is cheaper than iterating with
+      /// ChildByIndex. The function must not add or remove children of this
+      /// node.
+      /// \param[in] _func Function called with each child node
+      public: virtual void ForEachChild(
+                  const std::function<void(Node &)> &_func) const = 0;
+
       /// \brief Add the given node to this node. If the given node is
       /// already a child, no work will be done.
       /// \param[in] _child Child node to be added
@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OBJECTPOOL_HH_
+#define IGNITION_RENDERING_OBJECTPOOL_HH_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+
+#include <ignition/common/SuppressWarning.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+      // forward declaration
+      class MemoryPoolPrivate;
+
+      /// \brief Thread safe pool of memory blocks of a fixed size. Blocks
+      /// are carved from chunks allocated on demand and recycled through a
+      /// free list, so that objects created and destroyed at a high rate,
+      /// e.g. visuals of spawned debris, do not fragment the heap.
+      class IGNITION_RENDERING_VISIBLE MemoryPool
+      {
+        /// \brief Constructor
+        /// \param[in] _blockSize Size of the blocks in bytes, rounded up to
+        /// a multiple of the alignment of std::max_align_t
+        /// \param[in] _blocksPerChunk Number of blocks allocated at once
+        public: explicit MemoryPool(size_t _blockSize,
+                    size_t _blocksPerChunk = 64u);
+
+        /// \brief Destructor. Releases the chunks, all the blocks must have
+        /// been returned.
+        public: ~MemoryPool();
+
+        /// \brief Get a block, aligned for any scalar type
+        /// \return Block of BlockSize() bytes
+        public: void *Allocate();
+
+        /// \brief Return a block to the pool
+        /// \param[in] _block Block obtained from Allocate, ignored if null
+        public: void Deallocate(void *_block);
+
+        /// \brief Get the size of the blocks
+        /// \return Size of the blocks in bytes
+        public: size_t BlockSize() const;
+
+        /// \brief Get the number of blocks in use
+        /// \return Number of blocks allocated and not returned
+        public: size_t UsedCount() const;
+
+        /// \brief Get the number of blocks of the chunks allocated
+        /// \return Number of blocks in use or free
+        public: size_t Capacity() const;
+
+        /// \brief Get the pool shared by all the objects of a size. Shared
+        /// pools are never destroyed, so objects can outlive the scene and
+        /// the render engine that created them.
+        /// \param[in] _size Size of the objects in bytes
+        /// \return Pool of the size
+        public: static MemoryPool &ForSize(size_t _size);
+
+        IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+        /// \brief Private data pointer
+        private: std::unique_ptr<MemoryPoolPrivate> dataPtr;
+        IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+      };
+
+      /// \brief Allocator drawing single objects from the shared memory
+      /// pool of their size, e.g. for the control blocks of shared pointers.
+      /// Arrays are allocated on the heap.
+      template <typename T>
+      class PoolAllocator
+      {
+        /// \brief Type allocated
+        public: using value_type = T;
+
+        /// \brief Default constructor
+        public: PoolAllocator() = default;
+
+        /// \brief Constructor from an allocator of another type
+        public: template <typename U>
+                PoolAllocator(const PoolAllocator<U> &) noexcept
+                {
+                }
+
+        /// \brief Allocate objects
+        /// \param[in] _n Number of objects
+        /// \return Memory of the objects
+        public: T *allocate(size_t _n)
+                {
+                  if (_n == 1u)
+                    return static_cast<T *>(Pool().Allocate());
+                  return static_cast<T *>(::operator new(_n * sizeof(T)));
+                }
+
+        /// \brief Release objects
+        /// \param[in] _ptr Memory of the objects
+        /// \param[in] _n Number of objects
+        public: void deallocate(T *_ptr, size_t _n) noexcept
+                {
+                  if (_n == 1u)
+                    Pool().Deallocate(_ptr);
+                  else
+                    ::operator delete(_ptr);
+                }
+
+        /// \brief Get the pool of the objects
+        /// \return Shared pool of the size of T
+        public: static MemoryPool &Pool()
+                {
+                  static_assert(alignof(T) <= alignof(std::max_align_t),
+                      "Over aligned types can not be pooled");
+                  static MemoryPool &pool = MemoryPool::ForSize(sizeof(T));
+                  return pool;
+                }
+      };
+
+      /// \brief Allocators of pooled memory are interchangeable
+      template <typename T, typename U>
+      bool operator==(const PoolAllocator<T> &, const PoolAllocator<U> &)
+      {
+        return true;
+      }
+
+      /// \brief Allocators of pooled memory are interchangeable
+      template <typename T, typename U>
+      bool operator!=(const PoolAllocator<T> &, const PoolAllocator<U> &)
+      {
+        return false;
+      }
+
+      /// \brief Get pooled memory for an object, to be constructed with
+      /// placement new then passed to SharePooled. Objects with protected
+      /// constructors can be pooled by their friends.
+      /// \return Memory of an object of type T
+      template <typename T>
+      void *AllocatePooled()
+      {
+        return PoolAllocator<T>::Pool().Allocate();
+      }
+
+      /// \brief Deleter destroying an object constructed in pooled memory
+      /// and returning the memory to its pool
+      template <typename T>
+      struct PoolDeleter
+      {
+        /// \brief Destroy the object
+        /// \param[in] _ptr Object to destroy
+        void operator()(T *_ptr) const
+        {
+          if (!_ptr)
+            return;
+          _ptr->~T();
+          PoolAllocator<T>::Pool().Deallocate(_ptr);
+        }
+      };
+
+      /// \brief Share an object constructed in the memory returned by
+      /// AllocatePooled<T>. The control block of the shared pointer is
+      /// pooled too, e.g.
+      /// SharePooled(new (AllocatePooled<Foo>()) Foo)
+      /// \param[in] _ptr Object constructed in pooled memory
+      /// \return Shared pointer returning the memory to the pool
+      template <typename T>
+      std::shared_ptr<T> SharePooled(T *_ptr)
+      {
+        return std::shared_ptr<T>(_ptr, PoolDeleter<T>(),
+            PoolAllocator<T>());
+      }
+    }
+  }
+}
+#endif
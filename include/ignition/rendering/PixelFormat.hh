@@ -55,8 +55,10 @@ namespace ignition
       PF_FLOAT32_RGB  = 10,
       // 16 bit single channel
       PF_L16          = 11,
+      // 16 bit floating point single channel
+      PF_FLOAT16_R    = 12,
       /// < Number of pixel format types
-      PF_COUNT        = 12
+      PF_COUNT        = 13
     };
 
     /// \class PixelUtil PixelFormat.hh ignition/rendering/PixelFormat.hh
@@ -67,6 +69,13 @@ namespace ignition
       /// \param[in] _format Enum value to be evaluated
       public: static bool IsValid(PixelFormat _format);
 
+      /// \brief Determine if given format is a Bayer format. Bayer images
+      /// store one 8-bit channel per pixel, the color of which depends on
+      /// the position of the pixel in the pattern.
+      /// \param[in] _format Image pixel format
+      /// \return True if the format is a Bayer format
+      public: static bool IsBayer(PixelFormat _format);
+
       /// \brief Sanitize given format. If the given value is invalid,
       /// PF_UNKNOWN will be returned, otherwise input will be returned
       /// unchanged.
@@ -115,6 +124,32 @@ namespace ignition
       /// \return The specified PixelFormat enum value
       public: static PixelFormat Enum(const std::string &_name);
 
+      /// \brief Convert consecutive pixels from one format to another. The
+      /// conversion uses the SIMD instructions the library is compiled for
+      /// (SSE2, SSSE3, AVX2 or NEON) and falls back to scalar code
+      /// otherwise. Supported conversions are:
+      /// - between identical formats, a copy
+      /// - between PF_R8G8B8 and PF_B8G8R8, which may be done in place
+      /// - PF_L8 to PF_L16
+      /// - PF_FLOAT32_RGBA to PF_FLOAT32_RGB, dropping alpha
+      /// - PF_FLOAT32_RGBA to PF_FLOAT32_R, keeping the first channel, e.g.
+      /// the depth of a point cloud
+      /// - PF_FLOAT32_RGB to PF_R8G8B8, clamping the channels to [0, 1]
+      /// - PF_FLOAT32_R to PF_L16, converting depths in meters to
+      /// millimeters. Depths that are not finite or do not fit in 16 bits
+      /// are set to 0, the invalid value of 16-bit depth images.
+      /// - between PF_FLOAT32_R and PF_FLOAT16_R, rounding to the nearest
+      /// half float
+      /// \param[in] _src Source pixels
+      /// \param[in] _srcFormat Format of the source pixels
+      /// \param[out] _dst Destination pixels, with room for _count pixels
+      /// of _dstFormat. It must not overlap _src unless noted above.
+      /// \param[in] _dstFormat Format of the destination pixels
+      /// \param[in] _count Number of pixels to convert
+      /// \return True if the conversion is supported
+      public: static bool Convert(const void *_src, PixelFormat _srcFormat,
+                  void *_dst, PixelFormat _dstFormat, unsigned int _count);
+
       /// \brief Array of human-readable names for each PixelFormat
       private: static const char *names[PF_COUNT];
 
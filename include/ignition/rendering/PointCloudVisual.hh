@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_POINTCLOUDVISUAL_HH_
+#define IGNITION_RENDERING_POINTCLOUDVISUAL_HH_
+
+#include <ignition/math/Vector3.hh>
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+#include "ignition/rendering/Visual.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \enum PointCloudFormat PointCloudVisual.hh
+    /// ignition/rendering/PointCloudVisual.hh
+    /// \brief Formats of the point data given to a PointCloudVisual
+    enum IGNITION_RENDERING_VISIBLE PointCloudFormat
+    {
+      /// \brief X, Y and Z as 32 bit floats
+      PCF_XYZ_FLOAT32 = 0,
+
+      /// \brief X, Y and Z as 16 bit half precision floats
+      PCF_XYZ_FLOAT16 = 1,
+    };
+
+    /// \class PointCloudVisual PointCloudVisual.hh
+    /// ignition/rendering/PointCloudVisual.hh
+    /// \brief A visual for large point clouds, e.g. the maps built by SLAM.
+    /// Points are split in chunks of consecutive points. Each chunk is
+    /// uploaded to the GPU on its own, so updating part of the cloud only
+    /// uploads the chunks that changed, and chunks outside of the view
+    /// frustum are culled. Render engines may also draw fewer points of the
+    /// chunks that are far from the camera, see SetPointSpacing.
+    class IGNITION_RENDERING_VISIBLE PointCloudVisual :
+      public virtual Visual
+    {
+      /// \brief Constructor
+      protected: PointCloudVisual();
+
+      /// \brief Destructor
+      public: virtual ~PointCloudVisual();
+
+      /// \brief Get the number of bytes of a point in the given format
+      /// \param[in] _format Format of the point data
+      /// \return Size of a point in bytes
+      public: static unsigned int PointSize(PointCloudFormat _format);
+
+      /// \brief Decode point data into 32 bit floats
+      /// \param[in] _data Point data
+      /// \param[in] _count Number of points
+      /// \param[in] _format Format of the point data
+      /// \param[in] _stride Number of bytes between the start of two
+      /// consecutive points, 0 if the points are tightly packed
+      /// \param[out] _xyz Decoded points, 3 floats per point
+      /// \return False if the data is null or the stride is smaller than a
+      /// point
+      public: static bool DecodePoints(const void *_data, unsigned int _count,
+                  PointCloudFormat _format, unsigned int _stride,
+                  float *_xyz);
+
+      /// \brief Replace all the points of the cloud
+      /// \param[in] _data Point data
+      /// \param[in] _count Number of points
+      /// \param[in] _format Format of the point data
+      /// \param[in] _stride Number of bytes between the start of two
+      /// consecutive points, 0 if the points are tightly packed. This allows
+      /// passing the positions of point clouds with more fields, e.g. colors.
+      public: virtual void SetPoints(const void *_data, unsigned int _count,
+                  PointCloudFormat _format = PCF_XYZ_FLOAT32,
+                  unsigned int _stride = 0u) = 0;
+
+      /// \brief Replace or append a range of points. Only the chunks
+      /// containing these points are uploaded again.
+      /// \param[in] _offset Index of the first point to update. Must not be
+      /// greater than the number of points.
+      /// \param[in] _data Point data
+      /// \param[in] _count Number of points
+      /// \param[in] _format Format of the point data
+      /// \param[in] _stride Number of bytes between the start of two
+      /// consecutive points, 0 if the points are tightly packed
+      public: virtual void UpdatePoints(unsigned int _offset,
+                  const void *_data, unsigned int _count,
+                  PointCloudFormat _format = PCF_XYZ_FLOAT32,
+                  unsigned int _stride = 0u) = 0;
+
+      /// \brief Remove all the points of the cloud
+      public: virtual void ClearPoints() = 0;
+
+      /// \brief Get the number of points of the cloud
+      /// \return Number of points
+      public: virtual unsigned int PointCount() const = 0;
+
+      /// \brief Get the position of a point
+      /// \param[in] _index Index of the point
+      /// \return Position of the point, or a vector of infinite values if
+      /// the index is out of bounds
+      public: virtual math::Vector3d Point(unsigned int _index) const = 0;
+
+      /// \brief Set the number of points per chunk. The value is rounded up
+      /// to a power of two, with a minimum of 256 points. All the chunks are
+      /// uploaded again.
+      /// \param[in] _size Number of points per chunk
+      public: virtual void SetChunkSize(unsigned int _size) = 0;
+
+      /// \brief Get the number of points per chunk
+      /// \return Number of points per chunk
+      public: virtual unsigned int ChunkSize() const = 0;
+
+      /// \brief Get the number of chunks of the cloud
+      /// \return Number of chunks
+      public: virtual unsigned int ChunkCount() const = 0;
+
+      /// \brief Get the number of chunks that changed and have not been
+      /// uploaded yet
+      /// \return Number of pending chunks
+      public: virtual unsigned int PendingChunkCount() const = 0;
+
+      /// \brief Set the number of points uploaded per frame. At least one
+      /// chunk is uploaded per frame, whatever its size.
+      /// \param[in] _points Upload budget in points
+      public: virtual void SetUploadBudget(unsigned int _points) = 0;
+
+      /// \brief Get the number of points uploaded per frame
+      /// \return Upload budget in points
+      public: virtual unsigned int UploadBudget() const = 0;
+
+      /// \brief Set the number of levels of detail of the chunks. Each level
+      /// draws half of the points of the previous one.
+      /// \param[in] _levels Number of levels in addition to the full
+      /// resolution, 0 to always draw all the points
+      public: virtual void SetLodLevels(unsigned int _levels) = 0;
+
+      /// \brief Get the number of levels of detail of the chunks
+      /// \return Number of levels in addition to the full resolution
+      public: virtual unsigned int LodLevels() const = 0;
+
+      /// \brief Set the smallest spacing between points on screen, as a
+      /// share of the screen height. Chunks switch to a lower level of
+      /// detail when the average spacing of their points gets smaller than
+      /// this on screen. The switch distances scale with
+      /// Camera::SetLodBias.
+      /// \param[in] _spacing Spacing as a share of the screen height
+      public: virtual void SetPointSpacing(double _spacing) = 0;
+
+      /// \brief Get the smallest spacing between points on screen
+      /// \return Spacing as a share of the screen height
+      public: virtual double PointSpacing() const = 0;
+
+      /// \brief Upload the chunks that changed, up to the upload budget.
+      /// Called once per frame before rendering.
+      public: virtual void Update() = 0;
+    };
+    }
+  }
+}
+#endif
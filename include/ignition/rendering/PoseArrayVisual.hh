@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_POSEARRAYVISUAL_HH_
+#define IGNITION_RENDERING_POSEARRAYVISUAL_HH_
+
+#include <vector>
+#include <ignition/math/Pose3.hh>
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+#include "ignition/rendering/Visual.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \class PoseArrayVisual PoseArrayVisual.hh
+    /// ignition/rendering/PoseArrayVisual.hh
+    /// \brief A visual drawing the axes of many poses, e.g. the frames of a
+    /// TF tree or a pose array. Unlike one AxisVisual per pose, the arrows
+    /// of all the poses are merged in one geometry per axis, so any number
+    /// of poses is drawn with three objects and three draw calls.
+    class IGNITION_RENDERING_VISIBLE PoseArrayVisual :
+      public virtual Visual
+    {
+      /// \brief Constructor
+      protected: PoseArrayVisual();
+
+      /// \brief Destructor
+      public: virtual ~PoseArrayVisual();
+
+      /// \brief Append the triangles of an arrow pointing along the z axis
+      /// of a pose, with the proportions of ArrowVisual
+      /// \param[in] _pose Pose of the arrow base
+      /// \param[in] _length Length of the arrow
+      /// \param[in,out] _xyz Vertices the triangles are appended to, 3
+      /// floats per vertex and 3 vertices per triangle
+      public: static void AppendArrow(const math::Pose3d &_pose,
+                  double _length, std::vector<float> &_xyz);
+
+      /// \brief Get the number of vertices appended by AppendArrow
+      /// \return Number of vertices of an arrow
+      public: static unsigned int ArrowVertexCount();
+
+      /// \brief Replace the poses drawn, in the frame of the visual
+      /// \param[in] _poses Poses to draw
+      public: virtual void SetPoses(const std::vector<math::Pose3d> &_poses)
+                  = 0;
+
+      /// \brief Get the poses drawn
+      /// \return Poses drawn, in the frame of the visual
+      public: virtual const std::vector<math::Pose3d> &Poses() const = 0;
+
+      /// \brief Set the length of the arrows drawn for each pose
+      /// \param[in] _length Length of the arrows
+      public: virtual void SetAxisLength(double _length) = 0;
+
+      /// \brief Get the length of the arrows drawn for each pose
+      /// \return Length of the arrows
+      public: virtual double AxisLength() const = 0;
+
+      /// \brief Set whether only an arrow along the x axis of each pose is
+      /// drawn, e.g. for pose arrays, instead of its three axes
+      /// \param[in] _arrowsOnly True to only draw the x axis
+      public: virtual void SetArrowsOnly(bool _arrowsOnly) = 0;
+
+      /// \brief Get whether only an arrow along the x axis of each pose is
+      /// drawn
+      /// \return True if only the x axis is drawn
+      public: virtual bool ArrowsOnly() const = 0;
+    };
+    }
+  }
+}
+#endif
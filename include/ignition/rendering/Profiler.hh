@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_PROFILER_HH_
+#define IGNITION_RENDERING_PROFILER_HH_
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Function called when a profiler zone begins
+    /// \param[in] _name Name of the zone, a string literal
+    /// \param[in] _userData User data given to setProfilerHooks
+    typedef void (*ProfilerBeginHook)(const char *_name, void *_userData);
+
+    /// \brief Function called when the last profiler zone begun on the
+    /// calling thread ends
+    /// \param[in] _userData User data given to setProfilerHooks
+    typedef void (*ProfilerEndHook)(void *_userData);
+
+    /// \brief Set the functions called by the profiler zones of the render
+    /// loop, e.g. to forward them to Remotery or Tracy:
+    ///
+    ///     rendering::setProfilerHooks(
+    ///         [](const char *_name, void *)
+    ///         { rmt_BeginCPUSampleDynamic(_name, 0); },
+    ///         [](void *) { rmt_EndCPUSample(); });
+    ///
+    /// Zones are nested and begin and end on the same thread, which may be
+    /// a frame dispatcher worker for frame events. The zones are only
+    /// compiled in when ignition-rendering is built with the
+    /// IGN_RENDERING_PROFILER_ENABLE option, otherwise they cost nothing
+    /// and the hooks are never called. The hooks must be set while no
+    /// scene is rendering.
+    /// \param[in] _begin Function called when a zone begins, null to
+    /// remove the hooks
+    /// \param[in] _end Function called when a zone ends, null to remove
+    /// the hooks
+    /// \param[in] _userData Data given to the hooks
+    IGNITION_RENDERING_VISIBLE
+    void setProfilerHooks(ProfilerBeginHook _begin, ProfilerEndHook _end,
+        void *_userData = nullptr);
+
+    /// \brief Check whether the profiler zones of the render loop were
+    /// compiled in
+    /// \return True if ignition-rendering was built with the
+    /// IGN_RENDERING_PROFILER_ENABLE option
+    IGNITION_RENDERING_VISIBLE
+    bool profilerZonesEnabled();
+
+    /// \brief Begin a profiler zone. Prefer the IGN_RENDERING_PROFILE
+    /// macro, which is compiled out with the zones.
+    /// \param[in] _name Name of the zone, a string literal
+    IGNITION_RENDERING_VISIBLE
+    void beginProfilerZone(const char *_name);
+
+    /// \brief End the last profiler zone begun on the calling thread
+    IGNITION_RENDERING_VISIBLE
+    void endProfilerZone();
+
+    /// \brief Profiler zone lasting as long as the object
+    class ProfilerZone
+    {
+      /// \brief Constructor, begins the zone
+      /// \param[in] _name Name of the zone, a string literal
+      public: explicit ProfilerZone(const char *_name)
+      {
+        beginProfilerZone(_name);
+      }
+
+      /// \brief Destructor, ends the zone
+      public: ~ProfilerZone()
+      {
+        endProfilerZone();
+      }
+
+      /// \brief Zones can not be copied
+      public: ProfilerZone(const ProfilerZone &) = delete;
+
+      /// \brief Zones can not be copied
+      public: ProfilerZone &operator=(const ProfilerZone &) = delete;
+    };
+    }
+  }
+}
+
+#define IGN_RENDERING_PROFILE_CONCAT_IMPL(_a, _b) _a ## _b
+#define IGN_RENDERING_PROFILE_CONCAT(_a, _b) \
+    IGN_RENDERING_PROFILE_CONCAT_IMPL(_a, _b)
+
+/// \brief Profile the rest of the enclosing scope as a zone with the given
+/// name. Compiled out unless IGN_RENDERING_PROFILER_ENABLE is defined.
+#ifdef IGN_RENDERING_PROFILER_ENABLE
+#define IGN_RENDERING_PROFILE(_name) \
+    ::ignition::rendering::ProfilerZone \
+    IGN_RENDERING_PROFILE_CONCAT(ignRenderingProfilerZone, __LINE__)(_name)
+#else
+#define IGN_RENDERING_PROFILE(_name) ((void) 0)
+#endif
+
+#endif
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_RAWHEIGHTMAPTILESOURCE_HH_
+#define IGNITION_RENDERING_RAWHEIGHTMAPTILESOURCE_HH_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/common/SuppressWarning.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+#include "ignition/rendering/HeightmapTileSource.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+      // forward declaration
+      class RawHeightmapTileSourcePrivate;
+
+      /// \brief Heightmap tile source reading a file of raw 32 bit floats,
+      /// in the native byte order, stored row by row along +y. The file is
+      /// never loaded in memory: samples are read from it when requested.
+      class IGNITION_RENDERING_VISIBLE RawHeightmapTileSource
+        : public HeightmapTileSource
+      {
+        /// \brief Constructor
+        public: RawHeightmapTileSource();
+
+        /// \brief Destructor
+        public: virtual ~RawHeightmapTileSource();
+
+        /// \brief Open a raw heightmap file
+        /// \param[in] _filename Path to the file
+        /// \param[in] _sampleCount Number of samples along a side, 2^n+1
+        /// \return True if the file was opened and has the size of
+        /// _sampleCount * _sampleCount floats
+        public: bool Load(const std::string &_filename,
+            unsigned int _sampleCount);
+
+        // Documentation inherited
+        public: virtual unsigned int SampleCount() const override;
+
+        // Documentation inherited
+        public: virtual bool Heights(int _x, int _y, unsigned int _stride,
+            unsigned int _count, std::vector<float> &_heights) const
+            override;
+
+        IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+        private: std::unique_ptr<RawHeightmapTileSourcePrivate> dataPtr;
+        IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+      };
+    }
+  }
+}
+#endif
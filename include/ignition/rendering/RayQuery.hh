@@ -17,6 +17,8 @@
 #ifndef IGNITION_RENDERING_RAYQUERY_HH_
 #define IGNITION_RENDERING_RAYQUERY_HH_
 
+#include <vector>
+
 #include <ignition/common/SuppressWarning.hh>
 #include <ignition/math/Vector3.hh>
 
@@ -86,6 +88,18 @@ namespace ignition
       /// \param[out] A vector of intersection results
       /// \return True if results are not empty
       public: virtual RayQueryResult ClosestPoint() = 0;
+
+      /// \brief Compute the closest intersection of each ray in a batch.
+      /// The data shared by all rays, such as the set of objects that can
+      /// be hit, is only computed once for the whole batch. The origin and
+      /// direction of this query are not modified.
+      /// \param[in] _origins Ray origins
+      /// \param[in] _directions Ray directions, one for each origin
+      /// \return Closest intersection of each ray, in the same order as the
+      /// rays. Empty if the number of origins and directions differ.
+      public: virtual std::vector<RayQueryResult> ClosestPoints(
+                const std::vector<math::Vector3d> &_origins,
+                const std::vector<math::Vector3d> &_directions) = 0;
     };
     }
   }
@@ -148,7 +148,10 @@ namespace ignition
       /// \brief Create a new scene with the given name. The given name should
       /// be unique across all scenes managed by this render-engine. If a
       /// duplicate name is given, NULL will be returned. An unique ID will
-      /// automatically be assigned to the created scene.
+      /// automatically be assigned to the created scene. Render engines are
+      /// process singletons: to render several isolated worlds in one
+      /// process, create one scene per world. Scenes share the meshes and
+      /// textures loaded by the engine.
       /// \param[in] _name Name of the new scene
       /// \return The created scene
       public: virtual ScenePtr CreateScene(const std::string &_name) = 0;
@@ -169,6 +172,36 @@ namespace ignition
 
       /// \brief Get the render pass system for this engine.
       public: virtual RenderPassSystemPtr RenderPassSystem() const = 0;
+
+      /// \brief Enable or disable the GPU timing of the passes rendered by
+      /// the sensors, reported by Sensor::GpuTimes. Timing adds a GPU query
+      /// per pass, so it is disabled by default.
+      /// \param[in] _enabled True to enable GPU timing
+      /// \return True if GPU timing is in the requested state, false if it
+      /// is not supported by the render engine
+      public: virtual bool SetGpuTimingEnabled(bool _enabled) = 0;
+
+      /// \brief Check if the GPU timing of the sensor passes is enabled
+      /// \return True if enabled
+      /// \sa SetGpuTimingEnabled
+      public: virtual bool GpuTimingEnabled() const = 0;
+
+      /// \brief Begin collecting a render batch. Until EndRenderBatch is
+      /// called, the sensors that are updated may defer their rendering so
+      /// that they are all rendered together. Engines that do not batch
+      /// renders render each sensor when it is updated.
+      public: virtual void BeginRenderBatch() = 0;
+
+      /// \brief Render the sensors updated since BeginRenderBatch and run
+      /// their deferred post-render steps, e.g. readback and new frame
+      /// events
+      public: virtual void EndRenderBatch() = 0;
+
+      /// \brief Get whether a render batch is being collected
+      /// \return True if BeginRenderBatch has been called without a
+      /// matching EndRenderBatch. Always false for engines that do not
+      /// batch renders.
+      public: virtual bool RenderBatchActive() const = 0;
     };
     }
   }
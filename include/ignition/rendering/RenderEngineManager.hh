@@ -17,6 +17,7 @@
 #ifndef IGNITION_RENDERING_RENDERENGINEMANAGER_HH_
 #define IGNITION_RENDERING_RENDERENGINEMANAGER_HH_
 
+#include <future>
 #include <list>
 #include <map>
 #include <memory>
@@ -83,6 +84,25 @@ namespace ignition
                   const std::map<std::string, std::string> &_params = {},
                   const std::string &_path = "");
 
+      /// \brief Load the plugin of the render-engine with the given name on
+      /// a worker thread, e.g. while the application parses its world
+      /// files, so that the first call to Engine does not wait for it. The
+      /// graphics context of the engine belongs to the thread that loads
+      /// the engine, so the engine itself is still loaded by the first call
+      /// to Engine, on the thread that renders, e.g. in
+      /// RenderThread::Execute. Engine waits for the preload to complete.
+      /// \param[in] _name Name of the desired render-engine
+      /// \param[in] _params Parameters to be passed to the render engine
+      /// when it is loaded by a call to Engine without parameters.
+      /// \param[in] _path Another search path for rendering engine plugin.
+      /// \return Future set to the render-engine once its plugin is loaded,
+      /// or to null if no render-engine is registered under the given name.
+      /// Preloading an engine again returns the same future.
+      public: std::shared_future<RenderEngine *> PreloadEngine(
+                  const std::string &_name,
+                  const std::map<std::string, std::string> &_params = {},
+                  const std::string &_path = "");
+
       /// \brief Get the render-engine at the given index. If no
       /// render-engine is exists at the given index, NULL will be returned.
       /// \param[in] _index Index of the desired render-engine
@@ -17,6 +17,7 @@
 #ifndef IGNITION_RENDERING_RENDERTARGET_HH_
 #define IGNITION_RENDERING_RENDERTARGET_HH_
 
+#include <chrono>
 #include <string>
 
 #include <ignition/math/Color.hh>
@@ -32,6 +33,23 @@ namespace ignition
   {
     inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
     //
+    /// \enum WindowPresentMode
+    /// \brief How a render window presents its frames
+    enum IGNITION_RENDERING_VISIBLE WindowPresentMode
+    {
+      /// \brief Frames are presented on the vertical blank, waiting for it
+      /// when the queue of the swap chain is full (vsync)
+      WPM_FIFO = 0,
+
+      /// \brief Frames are presented as soon as they are rendered, which
+      /// may tear
+      WPM_IMMEDIATE = 1,
+
+      /// \brief Frames are presented on the vertical blank, a new frame
+      /// replacing the one waiting for it instead of queueing behind it
+      WPM_MAILBOX = 2
+    };
+
     /// \class RenderTarget RenderTarget.hh ignition/rendering/RenderTarget.hh
     /// \brief Represents a render-target to which cameras can render images.
     class IGNITION_RENDERING_VISIBLE RenderTarget :
@@ -146,6 +164,55 @@ namespace ignition
 
       /// \brief Alert the window of a window move event
       public: virtual void OnMove() = 0;
+
+      /// \brief Set how the window presents its frames. Turning vsync off
+      /// with WPM_IMMEDIATE removes the wait for the vertical blank from
+      /// the latency of the frames. Render engines that do not support a
+      /// mode use the closest one they support, see PresentMode. Has no
+      /// effect when the frames are swapped by the GL context of the
+      /// application.
+      /// \param[in] _mode Present mode. Defaults to WPM_FIFO.
+      public: virtual void SetPresentMode(WindowPresentMode _mode) = 0;
+
+      /// \brief Get how the window presents its frames
+      /// \return Present mode used by the window
+      public: virtual WindowPresentMode PresentMode() const = 0;
+
+      /// \brief Set the maximum number of frames rendered to the window
+      /// whose GPU commands have not completed. Rendering a new frame waits
+      /// for the oldest one above the limit, so the CPU does not queue
+      /// frames ahead of the GPU, each of them adding a frame of latency.
+      /// \param[in] _count Maximum number of frames in flight, 0 to leave
+      /// it to the driver. Defaults to 0.
+      public: virtual void SetMaxFramesInFlight(unsigned int _count) = 0;
+
+      /// \brief Get the maximum number of frames in flight
+      /// \return Maximum number of frames in flight, 0 if left to the
+      /// driver
+      public: virtual unsigned int MaxFramesInFlight() const = 0;
+
+      /// \brief Set the time at which the data shown by the next frame was
+      /// captured, e.g. the time an image of a remote camera was received.
+      /// The latency from it to the present of the frame is then given by
+      /// LastPresentLatency, to tune the glass to glass latency.
+      /// \param[in] _time Capture time of the data of the next frame
+      public: virtual void SetFrameTimestamp(
+                  const std::chrono::steady_clock::time_point &_time) = 0;
+
+      /// \brief Get the time at which the last frame was presented, once
+      /// it was swapped and the frames in flight limit was waited for
+      /// \return Present time of the last frame, the epoch of the clock if
+      /// no frame was presented yet
+      public: virtual std::chrono::steady_clock::time_point
+                  LastPresentTime() const = 0;
+
+      /// \brief Get the latency from the time given by SetFrameTimestamp to
+      /// the present of the frame showing it
+      /// \return Latency of the last frame presented with a timestamp, zero
+      /// if none was presented
+      /// \sa SetFrameTimestamp
+      public: virtual std::chrono::steady_clock::duration
+                  LastPresentLatency() const = 0;
     };
     }
   }
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_RENDERTHREAD_HH_
+#define IGNITION_RENDERING_RENDERTHREAD_HH_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include <ignition/common/SuppressWarning.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+      // forward declaration
+      class RenderThreadPrivate;
+
+      /// \brief Thread owning a render engine, so that sensors render frame
+      /// N while the simulation computes frame N+1. The engine, its scenes
+      /// and sensors must be created, updated and destroyed on the render
+      /// thread, through Execute and the frame callback, since the graphics
+      /// context of the engine belongs to the thread that loaded it.
+      ///
+      /// Scene state is double buffered: the simulation records the
+      /// mutations of a frame, e.g. poses, visibility and material
+      /// parameters, then submits them. The render thread applies them
+      /// before calling the frame callback, while the mutations of the
+      /// next frame are recorded in the other buffer. Only one frame is
+      /// rendered at a time, SubmitFrame waits for the previous frame.
+      class IGNITION_RENDERING_VISIBLE RenderThread
+      {
+        /// \brief Constructor. Starts the render thread.
+        public: RenderThread();
+
+        /// \brief Destructor. Waits for the tasks and the frame submitted,
+        /// then stops the render thread. Mutations recorded but not
+        /// submitted are discarded.
+        public: ~RenderThread();
+
+        /// \brief Run a task on the render thread and wait for it to
+        /// complete, e.g. to load the render engine and create the scene
+        /// and sensors. Tasks and frames run in the order they are
+        /// submitted. Runs the task directly if called from the render
+        /// thread.
+        /// \param[in] _task Task to run
+        public: void Execute(const std::function<void()> &_task);
+
+        /// \brief Set the function called on the render thread for each
+        /// frame, after the mutations of the frame are applied, e.g. to
+        /// update the sensors.
+        /// \param[in] _callback Frame callback, none if empty
+        public: void SetFrameCallback(std::function<void()> _callback);
+
+        /// \brief Record a scene mutation for the next frame submitted. Can
+        /// be called from any thread.
+        /// \param[in] _command Mutation, applied on the render thread. It
+        /// must keep the objects it updates alive, e.g. by capturing their
+        /// shared pointers.
+        public: void Record(std::function<void()> _command);
+
+        /// \brief Submit the mutations recorded since the last frame and
+        /// render a new frame on the render thread. Waits for the previous
+        /// frame to complete, but not for this one. Must not be called from
+        /// the render thread.
+        /// \return Number of the frame submitted, starting at 1, or 0 if
+        /// called from the render thread
+        public: uint64_t SubmitFrame();
+
+        /// \brief Wait for the frames submitted to complete
+        public: void WaitForFrame();
+
+        /// \brief Get the number of frames completed
+        /// \return Number of frames rendered
+        public: uint64_t FrameCount() const;
+
+        /// \brief Check if this is called from the render thread
+        /// \return True on the render thread
+        public: bool IsRenderThread() const;
+
+        IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+        /// \brief Private data pointer
+        private: std::unique_ptr<RenderThreadPrivate> dataPtr;
+        IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+      };
+    }
+  }
+}
+#endif
@@ -52,6 +52,9 @@ namespace ignition
     class Capsule;
     class DepthCamera;
     class DirectionalLight;
+    class DistortionPass;
+    class DropoutPass;
+    class FxaaPass;
     class GaussianNoisePass;
     class Geometry;
     class GizmoVisual;
@@ -71,7 +74,9 @@ namespace ignition
     class Object;
     class ObjectFactory;
     class ParticleEmitter;
+    class PointCloudVisual;
     class PointLight;
+    class PoseArrayVisual;
     class RayQuery;
     class RenderEngine;
     class RenderPass;
@@ -80,13 +85,16 @@ namespace ignition
     class RenderTexture;
     class RenderWindow;
     class Scene;
+    class SegmentationCamera;
     class Sensor;
     class ShaderParams;
+    class ShaderPass;
     class SpotLight;
     class SubMesh;
     class Text;
     class ThermalCamera;
     class Visual;
+    class WideAngleCamera;
     class WireBox;
 
     /// \def ArrowVisualPtr
@@ -113,10 +121,30 @@ namespace ignition
     /// \brief Shared pointer to GpuRays
     typedef shared_ptr<GpuRays> GpuRaysPtr;
 
+    /// \def WideAngleCameraPtr
+    /// \brief Shared pointer to WideAngleCamera
+    typedef shared_ptr<WideAngleCamera> WideAngleCameraPtr;
+
+    /// \def SegmentationCameraPtr
+    /// \brief Shared pointer to SegmentationCamera
+    typedef shared_ptr<SegmentationCamera> SegmentationCameraPtr;
+
     /// \def DirectionalLightPtr
     /// \brief Shared pointer to DirectionalLight
     typedef shared_ptr<DirectionalLight> DirectionalLightPtr;
 
+    /// \def DistortionPassPtr
+    /// \brief Shared pointer to DistortionPass
+    typedef shared_ptr<DistortionPass> DistortionPassPtr;
+
+    /// \def DropoutPassPtr
+    /// \brief Shared pointer to DropoutPass
+    typedef shared_ptr<DropoutPass> DropoutPassPtr;
+
+    /// \def FxaaPassPtr
+    /// \brief Shared pointer to FxaaPass
+    typedef shared_ptr<FxaaPass> FxaaPassPtr;
+
     /// \def GaussianNoisePass
     /// \brief Shared pointer to GaussianNoisePass
     typedef shared_ptr<GaussianNoisePass> GaussianNoisePassPtr;
@@ -189,10 +217,18 @@ namespace ignition
     /// \brief Shared pointer to ParticleEmitter
     typedef shared_ptr<ParticleEmitter> ParticleEmitterPtr;
 
+    /// \def PointCloudVisualPtr
+    /// \brief Shared pointer to PointCloudVisual
+    typedef shared_ptr<PointCloudVisual> PointCloudVisualPtr;
+
     /// \def PointLightPtr
     /// \brief Shared pointer to PointLight
     typedef shared_ptr<PointLight> PointLightPtr;
 
+    /// \def PoseArrayVisualPtr
+    /// \brief Shared pointer to PoseArrayVisual
+    typedef shared_ptr<PoseArrayVisual> PoseArrayVisualPtr;
+
     /// \def RayQueryPtr
     /// \brief Shared pointer to RayQuery
     typedef shared_ptr<RayQuery> RayQueryPtr;
@@ -227,6 +263,10 @@ namespace ignition
     /// \brief Shared pointer to ShaderParams
     typedef shared_ptr<ShaderParams> ShaderParamsPtr;
 
+    /// \def ShaderPassPtr
+    /// \brief Shared pointer to ShaderPass
+    typedef shared_ptr<ShaderPass> ShaderPassPtr;
+
     /// \def SpotLightPtr
     /// \brief Shared pointer to SpotLight
     typedef shared_ptr<SpotLight> SpotLightPtr;
@@ -271,10 +311,30 @@ namespace ignition
     /// \brief Shared pointer to const GpuRays
     typedef shared_ptr<const GpuRays> ConstGpuRaysPtr;
 
+    /// \def const WideAngleCameraPtr
+    /// \brief Shared pointer to const WideAngleCamera
+    typedef shared_ptr<const WideAngleCamera> ConstWideAngleCameraPtr;
+
+    /// \def const SegmentationCameraPtr
+    /// \brief Shared pointer to const SegmentationCamera
+    typedef shared_ptr<const SegmentationCamera> ConstSegmentationCameraPtr;
+
     /// \def const DirectionalLightPtr
     /// \brief Shared pointer to const DirectionalLight
     typedef shared_ptr<const DirectionalLight> ConstDirectionalLightPtr;
 
+    /// \def const DistortionPassPtr
+    /// \brief Shared pointer to const DistortionPass
+    typedef shared_ptr<const DistortionPass> ConstDistortionPassPtr;
+
+    /// \def const DropoutPassPtr
+    /// \brief Shared pointer to const DropoutPass
+    typedef shared_ptr<const DropoutPass> ConstDropoutPassPtr;
+
+    /// \def const FxaaPassPtr
+    /// \brief Shared pointer to const FxaaPass
+    typedef shared_ptr<const FxaaPass> ConstFxaaPassPtr;
+
     /// \def const GaussianNoisePass
     /// \brief Shared pointer to const GaussianNoisePass
     typedef shared_ptr<const GaussianNoisePass> ConstGaussianNoisePass;
@@ -331,10 +391,18 @@ namespace ignition
     /// \brief Shared pointer to const ParticleEmitter
     typedef shared_ptr<const ParticleEmitter> ConstParticleEmitterPtr;
 
+    /// \def const PointCloudVisualPtr
+    /// \brief Shared pointer to const PointCloudVisual
+    typedef shared_ptr<const PointCloudVisual> ConstPointCloudVisualPtr;
+
     /// \def const PointLightPtr
     /// \brief Shared pointer to const PointLight
     typedef shared_ptr<const PointLight> ConstPointLightPtr;
 
+    /// \def const PoseArrayVisualPtr
+    /// \brief Shared pointer to const PoseArrayVisual
+    typedef shared_ptr<const PoseArrayVisual> ConstPoseArrayVisualPtr;
+
     /// \def RayQueryPtr
     /// \brief Shared pointer to RayQuery
     typedef shared_ptr<const RayQuery> ConstRayQueryPtr;
@@ -370,6 +438,10 @@ namespace ignition
     /// \brief Shared pointer to const ShaderParams
     typedef shared_ptr<const ShaderParams> ConstShaderParamsPtr;
 
+    /// \def const ShaderPassPtr
+    /// \brief Shared pointer to const ShaderPass
+    typedef shared_ptr<const ShaderPass> ConstShaderPassPtr;
+
     /// \def const SpotLightPtr
     /// \brief Shared pointer to const SpotLight
     typedef shared_ptr<const SpotLight> ConstSpotLightPtr;
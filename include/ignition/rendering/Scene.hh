@@ -18,16 +18,26 @@
 #define IGNITION_RENDERING_SCENE_HH_
 
 #include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
 #include <string>
 #include <limits>
+#include <vector>
 
 #include <ignition/common/Material.hh>
 #include <ignition/common/Mesh.hh>
 #include <ignition/common/Time.hh>
 
+#include <ignition/math/AxisAlignedBox.hh>
 #include <ignition/math/Color.hh>
+#include <ignition/math/Frustum.hh>
+#include <ignition/math/Matrix4.hh>
+#include <ignition/math/Pose3.hh>
 
 #include "ignition/rendering/config.hh"
+#include "ignition/rendering/FrameStats.hh"
 #include "ignition/rendering/HeightmapDescriptor.hh"
 #include "ignition/rendering/MeshDescriptor.hh"
 #include "ignition/rendering/RenderTypes.hh"
@@ -109,6 +119,33 @@ namespace ignition
       public: virtual VisualPtr VisualAt(const CameraPtr &_camera,
                   const math::Vector2i &_mousePos) = 0;
 
+      /// \brief Get the visuals whose bounding box intersects a box. The
+      /// root visual is never reported. The bounding boxes of the visuals
+      /// are kept in a dynamic bounding volume hierarchy, which is brought
+      /// up to date when queried, so the cost of a query grows with the
+      /// logarithm of the number of visuals and with the number of visuals
+      /// changed since the previous query.
+      /// \param[in] _box Box in world coordinates
+      /// \return Visuals whose bounding box intersects the box
+      public: virtual std::vector<VisualPtr> VisualsInBox(
+                  const math::AxisAlignedBox &_box) = 0;
+
+      /// \brief Get the visuals whose bounding box intersects a sphere
+      /// \param[in] _center Center of the sphere in world coordinates
+      /// \param[in] _radius Radius of the sphere
+      /// \return Visuals whose bounding box intersects the sphere
+      /// \sa VisualsInBox
+      public: virtual std::vector<VisualPtr> VisualsInSphere(
+                  const math::Vector3d &_center, double _radius) = 0;
+
+      /// \brief Get the visuals whose bounding box intersects a frustum,
+      /// e.g. the frustum of a camera
+      /// \param[in] _frustum Frustum in world coordinates
+      /// \return Visuals whose bounding box intersects the frustum
+      /// \sa VisualsInBox
+      public: virtual std::vector<VisualPtr> VisualsInFrustum(
+                  const math::Frustum &_frustum) = 0;
+
       /// \brief Get the scene ambient light color
       /// \return The scene ambient light color
       public: virtual math::Color AmbientLight() const = 0;
@@ -438,6 +475,14 @@ namespace ignition
       /// \return The desired node
       public: virtual VisualPtr VisualByIndex(unsigned int _index) const = 0;
 
+      /// \brief Call a function on every visual managed by this scene, in
+      /// index order. This does not copy shared pointers, so it is cheaper
+      /// than iterating with VisualByIndex. The function must not create or
+      /// destroy visuals.
+      /// \param[in] _func Function called with each visual
+      public: virtual void ForEachVisual(
+                  const std::function<void(Visual &)> &_func) const = 0;
+
       /// \brief Destroy given node. If the given node is not managed by this
       /// scene, no work will be done. Depending on the _recursive argument,
       /// this function will either detach all child nodes from the scene graph
@@ -470,6 +515,17 @@ namespace ignition
       /// \brief Destroy all nodes manages by this scene.
       public: virtual void DestroyVisuals() = 0;
 
+      /// \brief Destroy the given visuals. This is equivalent to calling
+      /// DestroyVisual on each visual, but is faster when unloading large
+      /// parts of a scene at once.
+      /// \param[in] _visuals Visuals to destroy
+      /// \param[in] _recursive True to recursively destroy the visuals and
+      /// their children, false to destroy only the given visuals and detach
+      /// their children
+      public: virtual void DestroyVisuals(
+          const std::vector<VisualPtr> &_visuals,
+          bool _recursive = false) = 0;
+
       /// \brief Determine if a material is registered under the given name
       /// \param[in] _name Name of the material in question
       /// \return True if a material is registered under the given name
@@ -505,6 +561,24 @@ namespace ignition
       /// \brief Unregister and destroys all registered materials
       public: virtual void DestroyMaterials() = 0;
 
+      /// \brief Unregister and destroy the given materials
+      /// \param[in] _materials Materials to be unregistered and destroyed
+      public: virtual void DestroyMaterials(
+                  const std::vector<MaterialPtr> &_materials) = 0;
+
+      /// \brief Get the shared material with the same parameters as the
+      /// given material. If there is none yet, the given material becomes
+      /// the shared material for its parameters. Visuals that use shared
+      /// materials with Visual::SetMaterial(_material, false) reference the
+      /// same engine material, which lets render engines batch their draws.
+      /// Shared materials must not be modified afterwards, as the change
+      /// would apply to every visual using them. Materials with shader
+      /// parameters are never shared.
+      /// \param[in] _material Material to look up
+      /// \return Shared material with the same parameters, the given
+      /// material itself if it can not be shared
+      public: virtual MaterialPtr SharedMaterial(MaterialPtr _material) = 0;
+
       /// \brief Create new directional light. A unique ID and name will
       /// automatically be assigned to the light.
       /// \return The created light
@@ -679,6 +753,65 @@ namespace ignition
       public: virtual ThermalCameraPtr CreateThermalCamera(
                   unsigned int _id, const std::string &_name) = 0;
 
+      /// \brief Create new wide angle camera. A unique ID and name will
+      /// automatically be assigned to the camera.
+      /// \return The created camera
+      public: virtual WideAngleCameraPtr CreateWideAngleCamera() = 0;
+
+      /// \brief Create new wide angle camera with the given ID. A unique name
+      /// will automatically be assigned to the camera. If the given ID is
+      /// already in use, NULL will be returned.
+      /// \param[in] _id ID of the new camera
+      /// \return The created camera
+      public: virtual WideAngleCameraPtr CreateWideAngleCamera(
+                  unsigned int _id) = 0;
+
+      /// \brief Create new wide angle camera with the given name. A unique
+      /// ID will automatically be assigned to the camera. If the given name
+      /// is already in use, NULL will be returned.
+      /// \param[in] _name Name of the new camera
+      /// \return The created camera
+      public: virtual WideAngleCameraPtr CreateWideAngleCamera(
+                  const std::string &_name) = 0;
+
+      /// \brief Create new wide angle camera with the given name. If either
+      /// the given ID or name is already in use, NULL will be returned.
+      /// \param[in] _id ID of the new camera
+      /// \param[in] _name Name of the new camera
+      /// \return The created camera
+      public: virtual WideAngleCameraPtr CreateWideAngleCamera(
+                  unsigned int _id, const std::string &_name) = 0;
+
+      /// \brief Create new segmentation camera. A unique ID and name will
+      /// automatically be assigned to the camera.
+      /// \return The created camera
+      public: virtual SegmentationCameraPtr CreateSegmentationCamera() = 0;
+
+      /// \brief Create new segmentation camera with the given ID. A unique
+      /// name will automatically be assigned to the camera. If the given ID
+      /// is already in use, NULL will be returned.
+      /// \param[in] _id ID of the new camera
+      /// \return The created camera
+      public: virtual SegmentationCameraPtr CreateSegmentationCamera(
+                  unsigned int _id) = 0;
+
+      /// \brief Create new segmentation camera with the given name. A unique
+      /// ID will automatically be assigned to the camera. If the given name
+      /// is already in use, NULL will be returned.
+      /// \param[in] _name Name of the new camera
+      /// \return The created camera
+      public: virtual SegmentationCameraPtr CreateSegmentationCamera(
+                  const std::string &_name) = 0;
+
+      /// \brief Create new segmentation camera with the given name. If
+      /// either the given ID or name is already in use, NULL will be
+      /// returned.
+      /// \param[in] _id ID of the new camera
+      /// \param[in] _name Name of the new camera
+      /// \return The created camera
+      public: virtual SegmentationCameraPtr CreateSegmentationCamera(
+                  unsigned int _id, const std::string &_name) = 0;
+
       /// \brief Create new gpu rays caster. A unique ID and name will
       /// automatically be assigned to the gpu rays caster.
       /// \return The created gpu rays caster
@@ -900,6 +1033,18 @@ namespace ignition
       /// \return The created mesh
       public: virtual MeshPtr CreateMesh(const MeshDescriptor &_desc) = 0;
 
+      /// \brief Start preparing a mesh in the background, e.g. converting
+      /// its geometry on a worker thread, so that a later CreateMesh call
+      /// for the same descriptor only uploads the prepared geometry. Calling
+      /// CreateMesh before the returned future is ready is allowed and
+      /// waits for the preparation.
+      /// \param[in] _desc Descriptor of the mesh to prepare
+      /// \return Future set to true once the mesh is prepared, false if the
+      /// descriptor is invalid. The future is already set if the render
+      /// engine does not prepare meshes in the background.
+      public: virtual std::shared_future<bool> PrepareMesh(
+                  const MeshDescriptor &_desc) = 0;
+
       /// \brief Create new grid geometry.
       /// \return The created grid
       public: virtual GridPtr CreateGrid() = 0;
@@ -940,6 +1085,66 @@ namespace ignition
       public: virtual LidarVisualPtr CreateLidarVisual(
                   unsigned int _id, const std::string &_name) = 0;
 
+      /// \brief Create new point cloud visual. A unique ID and name will
+      /// automatically be assigned to the point cloud visual.
+      /// \return The created point cloud visual
+      public: virtual PointCloudVisualPtr CreatePointCloudVisual() = 0;
+
+      /// \brief Create new point cloud visual with the given ID. A unique
+      /// name will automatically be assigned to the point cloud visual. If
+      /// the given ID is already in use, NULL will be returned.
+      /// \param[in] _id ID of the new point cloud visual
+      /// \return The created point cloud visual
+      public: virtual PointCloudVisualPtr CreatePointCloudVisual(
+                  unsigned int _id) = 0;
+
+      /// \brief Create new point cloud visual with the given name. A unique
+      /// ID will automatically be assigned to the point cloud visual. If
+      /// the given name is already in use, NULL will be returned.
+      /// \param[in] _name Name of the new point cloud visual
+      /// \return The created point cloud visual
+      public: virtual PointCloudVisualPtr CreatePointCloudVisual(
+                  const std::string &_name) = 0;
+
+      /// \brief Create new point cloud visual with the given name. If
+      /// either the given ID or name is already in use, NULL will be
+      /// returned.
+      /// \param[in] _id ID of the point cloud visual.
+      /// \param[in] _name Name of the new point cloud visual.
+      /// \return The created point cloud visual
+      public: virtual PointCloudVisualPtr CreatePointCloudVisual(
+                  unsigned int _id, const std::string &_name) = 0;
+
+      /// \brief Create new pose array visual. A unique ID and name will
+      /// automatically be assigned to the pose array visual.
+      /// \return The created pose array visual
+      public: virtual PoseArrayVisualPtr CreatePoseArrayVisual() = 0;
+
+      /// \brief Create new pose array visual with the given ID. A unique
+      /// name will automatically be assigned to the pose array visual. If
+      /// the given ID is already in use, NULL will be returned.
+      /// \param[in] _id ID of the new pose array visual
+      /// \return The created pose array visual
+      public: virtual PoseArrayVisualPtr CreatePoseArrayVisual(
+                  unsigned int _id) = 0;
+
+      /// \brief Create new pose array visual with the given name. A unique
+      /// ID will automatically be assigned to the pose array visual. If
+      /// the given name is already in use, NULL will be returned.
+      /// \param[in] _name Name of the new pose array visual
+      /// \return The created pose array visual
+      public: virtual PoseArrayVisualPtr CreatePoseArrayVisual(
+                  const std::string &_name) = 0;
+
+      /// \brief Create new pose array visual with the given name. If
+      /// either the given ID or name is already in use, NULL will be
+      /// returned.
+      /// \param[in] _id ID of the pose array visual.
+      /// \param[in] _name Name of the new pose array visual.
+      /// \return The created pose array visual
+      public: virtual PoseArrayVisualPtr CreatePoseArrayVisual(
+                  unsigned int _id, const std::string &_name) = 0;
+
       /// \brief Create new heightmap geomerty. The rendering::Heightmap will be
       /// created from the given HeightmapDescriptor.
       /// \param[in] _desc Data about the heightmap
@@ -1019,11 +1224,184 @@ namespace ignition
       /// changes by traversing scene-graph, calling PreRender on all objects
       public: virtual void PreRender() = 0;
 
+      /// \brief Set the number of threads traversing the scene graph in
+      /// PreRender. With more than one thread, large scenes are walked in
+      /// parallel over subtrees, updating the cached world poses of the
+      /// nodes, then the objects are prepared for rendering one after the
+      /// other on the calling thread, since render engine calls need to be
+      /// serialized. Small scenes are always traversed serially.
+      /// \param[in] _count Number of threads, 0 for the number of hardware
+      /// threads. Defaults to 1, a serial traversal.
+      public: virtual void SetPreRenderThreadCount(unsigned int _count) = 0;
+
+      /// \brief Get the number of threads traversing the scene graph in
+      /// PreRender
+      /// \return Number of threads
+      /// \sa SetPreRenderThreadCount
+      public: virtual unsigned int PreRenderThreadCount() const = 0;
+
+      /// \brief Set whether PreRender only prepares the objects that changed
+      /// since the previous PreRender, instead of traversing the whole
+      /// scene graph. Objects flag themselves when their poses, materials,
+      /// geometries or children change, and the sensors are prepared every
+      /// frame, so the cost of PreRender follows the number of changes
+      /// rather than the size of the scene. The first PreRender after
+      /// enabling it traverses the whole scene graph. Not supported by
+      /// render engines that rebuild their state in every traversal.
+      /// \param[in] _enabled True to only prepare the changed objects.
+      /// Defaults to false.
+      /// \sa MarkPreRenderDirty
+      public: virtual void SetIncrementalPreRender(bool _enabled) = 0;
+
+      /// \brief Get whether PreRender only prepares the changed objects
+      /// \return True if incremental PreRender is enabled
+      /// \sa SetIncrementalPreRender
+      public: virtual bool IncrementalPreRender() const = 0;
+
+      /// \brief Flag an object to be prepared by the next incremental
+      /// PreRender. Objects flag themselves when they change through this
+      /// API, call this after changing an object by other means, e.g.
+      /// through engine specific objects. The change is counted by
+      /// ChangeVersion, it is otherwise ignored if incremental PreRender is
+      /// disabled.
+      /// \param[in] _object Object that changed
+      /// \param[in] _subtree True to also prepare the child nodes and
+      /// geometries of the object, e.g. when it was added to the scene graph
+      public: virtual void MarkPreRenderDirty(ObjectPtr _object,
+                  bool _subtree = false) = 0;
+
+      /// \brief Get the version of the scene, incremented whenever an
+      /// object flags itself with MarkPreRenderDirty, i.e. when nodes move
+      /// or are added to or removed from the scene graph, or their materials
+      /// or geometries change, and when the background changes. Cameras
+      /// rendering on demand compare it to the version they last rendered.
+      /// \return Version of the scene
+      /// \sa Camera::SetOnDemandRendering
+      public: virtual uint64_t ChangeVersion() const = 0;
+
+      /// \brief Begin a new scene update. Until EndFrame is called, only
+      /// the first call to PreRender traverses the scene graph and
+      /// subsequent calls are no-ops. Call this once per simulation step
+      /// before updating multiple sensors of the same scene so the scene
+      /// changes are only flushed once.
+      /// \sa EndFrame
+      public: virtual void BeginFrame() = 0;
+
+      /// \brief End the scene update started by BeginFrame. Calls to
+      /// PreRender made outside of a frame always traverse the scene graph.
+      /// \sa BeginFrame
+      public: virtual void EndFrame() = 0;
+
+      /// \brief Get whether a scene update started by BeginFrame is in
+      /// progress
+      /// \return True if BeginFrame has been called without a matching
+      /// call to EndFrame
+      public: virtual bool FrameActive() const = 0;
+
+      /// \brief Set the world poses of many nodes at once. This is
+      /// equivalent to calling SetWorldPose on each node, but lets render
+      /// engines skip the per-node overhead when updating thousands of
+      /// nodes, e.g. when applying simulation state.
+      /// \param[in] _ids Ids of the nodes to update
+      /// \param[in] _poses New world poses, in the same order as _ids
+      public: virtual void SetWorldPoses(const std::vector<unsigned int> &_ids,
+                  const std::vector<math::Pose3d> &_poses) = 0;
+
+      /// \brief Set the local bone transforms of the skeletons of many
+      /// meshes at once, e.g. of a crowd of animated actors. This is
+      /// equivalent to calling Mesh::SetSkeletonBoneTransforms on each mesh
+      /// with its slice of the transforms.
+      /// \param[in] _meshes Skinned meshes to update
+      /// \param[in] _tfs Contiguous local bone transforms. The transforms of
+      /// each mesh follow those of the previous mesh, one per bone in the
+      /// order of Mesh::SkeletonBoneNames.
+      public: virtual void SetSkeletonBoneTransforms(
+                  const std::vector<MeshPtr> &_meshes,
+                  const std::vector<math::Matrix4f> &_tfs) = 0;
+
+      /// \brief Queue a scene mutation, e.g. a pose or material update,
+      /// to be applied by the render thread. Unlike the other functions of
+      /// the scene, this can be called from any thread without blocking,
+      /// so that a simulation thread can record its updates while the
+      /// render thread renders the previous ones. Queued commands are
+      /// applied in order at the start of the next PreRender that
+      /// traverses the scene graph, or by ApplyCommands.
+      /// \param[in] _command Command to apply. It must keep the objects it
+      /// updates alive, e.g. by capturing their shared pointers.
+      /// \sa ApplyCommands
+      public: virtual void EnqueueCommand(std::function<void()> _command) = 0;
+
+      /// \brief Apply the commands queued by EnqueueCommand. Must be
+      /// called from the render thread.
+      /// \return Number of commands applied
+      public: virtual size_t ApplyCommands() = 0;
+
+      /// \brief Compile the shaders needed to render the scene in its
+      /// current state, so that sensors do not stall on shader compilation
+      /// when they first render it. The scene is rendered in every
+      /// direction from the center of its visuals with the current lights,
+      /// then every registered material with a distinct set of shader
+      /// features is rendered once on a box. Call it after loading the
+      /// world and before the first sensor update. Render engines that do
+      /// not compile shaders on demand still render the scene.
+      public: virtual void PrecompileShaders() = 0;
+
+      /// \brief Merge the meshes of static visuals into a few large
+      /// batches, so that thousands of small meshes are drawn with a few
+      /// draw calls. The meshes sharing a material are merged together, in
+      /// cubic cells of the given size so that the batches can still be
+      /// culled. Only the subtrees of static visuals are merged, and
+      /// animated meshes are left out. The merged meshes are removed from
+      /// their visuals, which stay in the scene graph: changing the
+      /// visuals does not update the batches, call ClearStaticGeometry
+      /// and merge them again instead. Can be called several times.
+      /// \param[in] _visuals Static visuals to merge, with their children
+      /// \param[in] _cellSize Edge length of the cells in meters, e.g. the
+      /// size of a room. The batches are not split if 0.
+      /// \return Number of meshes merged, 0 if the render engine does not
+      /// support it
+      /// \sa Visual::SetStatic
+      public: virtual unsigned int BakeStaticGeometry(
+                  const std::vector<VisualPtr> &_visuals,
+                  double _cellSize = 50.0) = 0;
+
+      /// \brief Destroy the batches created by BakeStaticGeometry and put
+      /// the merged meshes back in their visuals
+      public: virtual void ClearStaticGeometry() = 0;
+
+      /// \brief Get the memory used by the meshes, textures and render
+      /// targets loaded by the render engine. Render engines that share
+      /// their resources between scenes report the memory of all scenes.
+      /// \return Resource memory, all 0 if not reported by the render
+      /// engine
+      public: virtual rendering::MemoryStats ResourceMemoryStats() const = 0;
+
       /// \brief Remove and destroy all objects from the scene graph. This does
       /// not completely destroy scene resources, so new objects can be created
       /// and added to the scene afterwards.
       public: virtual void Clear() = 0;
 
+      /// \brief Start removing and destroying all objects from the scene
+      /// graph over several frames, like Clear but without stalling the
+      /// render loop when the scene is large. The visuals and lights are
+      /// removed from the scene graph right away, and the objects are
+      /// destroyed by the following ClearStep calls. No objects should be
+      /// created in the scene until ClearStep returns true.
+      /// \sa ClearStep
+      public: virtual void BeginClear() = 0;
+
+      /// \brief Destroy the objects left by BeginClear until a time budget
+      /// is spent. At least one object is destroyed per call.
+      /// \param[in] _budget Time the call may spend
+      /// \return True once all the objects are destroyed, or if no teardown
+      /// is in progress
+      public: virtual bool ClearStep(
+                  const std::chrono::steady_clock::duration &_budget) = 0;
+
+      /// \brief Get whether a teardown started by BeginClear is in progress
+      /// \return True until ClearStep destroyed all the objects
+      public: virtual bool Clearing() const = 0;
+
       /// \brief Completely destroy the scene an all its resources. Continued
       /// use of this scene after its destruction will result in undefined
       /// behavior.
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_SCENECOMMANDQUEUE_HH_
+#define IGNITION_RENDERING_SCENECOMMANDQUEUE_HH_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+#include <ignition/common/SuppressWarning.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+      // forward declaration
+      class SceneCommandQueuePrivate;
+
+      /// \brief Unbounded lock free queue of commands with multiple
+      /// producers and a single consumer. Any thread can push commands,
+      /// which are executed in order by the thread owning the queue, e.g.
+      /// scene mutations recorded by a simulation thread and applied by the
+      /// render thread.
+      class IGNITION_RENDERING_VISIBLE SceneCommandQueue
+      {
+        /// \brief Constructor
+        public: SceneCommandQueue();
+
+        /// \brief Destructor. Commands still queued are discarded.
+        public: ~SceneCommandQueue();
+
+        /// \brief Queue a command. Can be called from any thread.
+        /// \param[in] _command Command to execute, ignored if empty
+        public: void Push(std::function<void()> _command);
+
+        /// \brief Execute the queued commands in the order they were
+        /// pushed. Commands pushed while executing, including by the
+        /// commands themselves, are left for the next call. Must only be
+        /// called by one thread at a time.
+        /// \return Number of commands executed
+        public: size_t Execute();
+
+        /// \brief Discard the queued commands without executing them. Must
+        /// only be called by the thread executing the commands.
+        public: void Clear();
+
+        /// \brief Get the number of commands queued. The count is only
+        /// exact when no other thread is pushing commands.
+        /// \return Number of commands queued
+        public: size_t Size() const;
+
+        IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+        /// \brief Private data pointer
+        private: std::unique_ptr<SceneCommandQueuePrivate> dataPtr;
+        IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+      };
+    }
+  }
+}
+#endif
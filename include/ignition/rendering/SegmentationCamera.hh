@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_SEGMENTATIONCAMERA_HH_
+#define IGNITION_RENDERING_SEGMENTATIONCAMERA_HH_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include <ignition/common/Event.hh>
+
+#include "ignition/rendering/Camera.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \enum SegmentationType
+    /// \brief What the labels of a segmentation camera identify
+    enum SegmentationType
+    {
+      /// \brief Class of the objects, given by the "label" user data of
+      /// their visuals
+      SEG_SEMANTIC = 0,
+
+      /// \brief Instance of the objects, the id of their top level visual
+      SEG_INSTANCE = 1
+    };
+
+    /* \class SegmentationCamera SegmentationCamera.hh \
+     * ignition/rendering/SegmentationCamera.hh
+     */
+    /// \brief Camera producing an image of labels, one per pixel, in a
+    /// single unlit pass. For semantic segmentation, the label of an object
+    /// is set through the Visual class using SetUserData with the key
+    /// "label" and a non negative int, on its visual or one of the visual's
+    /// ancestors. Pixels of objects without label, and pixels without
+    /// objects, have the background label.
+    class IGNITION_RENDERING_VISIBLE SegmentationCamera :
+      public virtual Camera
+    {
+      /// \brief Destructor
+      public: virtual ~SegmentationCamera() { }
+
+      /// \brief Set what the labels identify
+      /// \param[in] _type Segmentation type, SEG_SEMANTIC by default
+      public: virtual void SetSegmentationType(SegmentationType _type) = 0;
+
+      /// \brief Get what the labels identify
+      /// \return Segmentation type
+      public: virtual SegmentationType Type() const = 0;
+
+      /// \brief Set the number of bits of the labels. 16 bit labels halve
+      /// the size of the frames, larger labels saturate to 65535. This must
+      /// be set before the camera is first rendered.
+      /// \param[in] _bits 16 or 32, 32 by default
+      public: virtual void SetLabelBitDepth(unsigned int _bits) = 0;
+
+      /// \brief Get the number of bits of the labels
+      /// \return 16 or 32
+      public: virtual unsigned int LabelBitDepth() const = 0;
+
+      /// \brief Set the label of the pixels without labeled objects
+      /// \param[in] _label Background label, 0 by default
+      public: virtual void SetBackgroundLabel(uint32_t _label) = 0;
+
+      /// \brief Get the label of the pixels without labeled objects
+      /// \return Background label
+      public: virtual uint32_t BackgroundLabel() const = 0;
+
+      /// \brief Connect to the new segmentation frame event, delivering
+      /// one 32 bit label per pixel whatever the label bit depth.
+      /// \param[in] _subscriber Subscriber callback function. The callback
+      /// function arguments are: <labels, width, height, channels, format>
+      /// \return Pointer to the new Connection. This must be kept in scope
+      public: virtual common::ConnectionPtr ConnectNewSegmentationFrame(
+          std::function<void(const uint32_t *, unsigned int, unsigned int,
+          unsigned int, const std::string &)> _subscriber) = 0;
+
+      /// \brief Connect to the new segmentation frame event delivering the
+      /// labels at their bit depth: one uint16_t per pixel in "L16" format,
+      /// or one uint32_t per pixel in "L32" format. Unlike
+      /// ConnectNewSegmentationFrame, 16 bit labels are not widened.
+      /// \param[in] _subscriber Subscriber callback function. The callback
+      /// function arguments are: <labels, width, height, channels, format>
+      /// \return Pointer to the new Connection. This must be kept in scope
+      public: virtual common::ConnectionPtr ConnectNewRawSegmentationFrame(
+          std::function<void(const unsigned char *, unsigned int,
+          unsigned int, unsigned int, const std::string &)> _subscriber) = 0;
+    };
+    }
+  }
+}
+#endif
@@ -17,8 +17,18 @@
 #ifndef IGNITION_RENDERING_SENSOR_HH_
 #define IGNITION_RENDERING_SENSOR_HH_
 
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+
+#include <ignition/common/Event.hh>
+
 #include "ignition/rendering/config.hh"
+#include "ignition/rendering/FrameDispatcher.hh"
+#include "ignition/rendering/FrameStats.hh"
 #include "ignition/rendering/Node.hh"
+#include "ignition/rendering/SensorFrame.hh"
 
 namespace ignition
 {
@@ -35,13 +45,72 @@ namespace ignition
       /// \brief Sensor
       public: virtual ~Sensor() { }
 
-      /// \brief Set visibility mask
+      /// \brief Set visibility mask. The sensor only renders the visuals
+      /// whose visibility flags share a bit with the mask, see
+      /// Visual::SetVisibilityFlags. For example, decorative visuals can be
+      /// given a bit of their own that the masks of the depth cameras and
+      /// gpu rays leave out, so they are culled before being drawn by
+      /// these sensors.
       /// \param[in] _mask Visibility mask
       public: virtual void SetVisibilityMask(uint32_t _mask) = 0;
 
       /// \brief Get visibility mask
       /// \return visibility mask
       public: virtual uint32_t VisibilityMask() const = 0;
+
+      /// \brief Set how the new frame events of the sensor call their
+      /// subscribers. With FDP_DROP_OLDEST or FDP_BLOCK, frames are copied
+      /// to reference counted buffers and the subscribers are called in
+      /// order by the FrameDispatcher workers, so the render loop never runs
+      /// user code and a slow subscriber only delays this sensor.
+      /// Subscribers are then called from a worker thread and should be
+      /// connected before the first frame is rendered. Defaults to
+      /// FDP_SYNCHRONOUS.
+      /// \param[in] _policy Dispatch policy
+      /// \param[in] _queueSize Number of frames waiting to be delivered
+      /// before frames are dropped or the render thread blocks
+      public: virtual void SetDispatchPolicy(FrameDispatchPolicy _policy,
+                  unsigned int _queueSize = 4u) = 0;
+
+      /// \brief Get how the new frame events of the sensor call their
+      /// subscribers
+      /// \return Dispatch policy
+      /// \sa SetDispatchPolicy
+      public: virtual FrameDispatchPolicy DispatchPolicy() const = 0;
+
+      /// \brief Get the number of frames dropped by the FDP_DROP_OLDEST
+      /// policy since it was set
+      /// \return Number of frames dropped
+      public: virtual uint64_t DroppedFrameCount() const = 0;
+
+      /// \brief Get the GPU time spent rendering the last frame of the
+      /// sensor whose timings are known, broken down by pass, e.g. the
+      /// scene, its shadow maps and each post processing render pass.
+      /// GPU timing must be enabled on the render engine, see
+      /// RenderEngine::SetGpuTimingEnabled. The times lag a few frames
+      /// behind since the render loop does not wait on the GPU.
+      /// \return GPU time in milliseconds of each pass, empty if unknown
+      public: virtual std::map<std::string, double> GpuTimes() const = 0;
+
+      /// \brief Get the rendering cost of the last frame of the sensor:
+      /// its draw calls, triangles, readbacks and time, to set performance
+      /// budgets or catch regressions. A frame lasts from the beginning of
+      /// a Render call to the beginning of the next one, so it includes the
+      /// readbacks done after rendering.
+      /// \return Statistics of the last frame
+      public: virtual rendering::FrameStats LastFrameStats() const = 0;
+
+      /// \brief Connect to the new frame event delivering reference counted
+      /// frames. Subscribers may keep the frames they receive, for instance
+      /// to process them on another thread, without copying them: the
+      /// sensor only reuses a frame once every reference to it is released.
+      /// Sensors with several outputs deliver a frame per output, told apart
+      /// by their format.
+      /// \param[in] _subscriber Subscriber callback function
+      /// \return Pointer to the new Connection. This must be kept in scope
+      public: virtual common::ConnectionPtr ConnectNewSensorFrame(
+                  std::function<void(const ConstSensorFramePtr &)>
+                  _subscriber) = 0;
     };
     }
   }
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_SENSORFRAME_HH_
+#define IGNITION_RENDERING_SENSORFRAME_HH_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/common/SuppressWarning.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+      // forward declaration
+      class SensorFramePoolPrivate;
+
+      /// \brief Frame produced by a sensor, such as a depth image or a gpu
+      /// rays scan. Frames are reference counted: subscribers may keep a
+      /// frame as long as they need it, the sensor only reuses its buffer
+      /// once every reference is released.
+      class IGNITION_RENDERING_VISIBLE SensorFrame
+      {
+        /// \brief Get the frame data
+        /// \return Pointer to the frame data
+        public: const void *Data() const;
+
+        /// \brief Get the frame data
+        /// \return Pointer to the frame data
+        public: void *Data();
+
+        /// \brief Get the frame data, statically cast to the given type
+        /// \return Pointer to the frame data
+        public: template <typename T>
+                const T *Data() const
+                {
+                  return static_cast<const T *>(this->Data());
+                }
+
+        /// \brief Get the frame data, statically cast to the given type
+        /// \return Pointer to the frame data
+        public: template <typename T>
+                T *Data()
+                {
+                  return static_cast<T *>(this->Data());
+                }
+
+        /// \brief Get the size of the frame data
+        /// \return Size in bytes
+        public: size_t Size() const;
+
+        /// \brief Get the frame width
+        /// \return Width in pixels or rays
+        public: unsigned int Width() const;
+
+        /// \brief Get the frame height
+        /// \return Height in pixels or rays
+        public: unsigned int Height() const;
+
+        /// \brief Get the number of channels of the frame
+        /// \return Number of channels
+        public: unsigned int Channels() const;
+
+        /// \brief Get the frame format, as passed to the new frame events of
+        /// the sensor, e.g. "FLOAT32" for depth images and "PF_FLOAT32_RGBA"
+        /// for point clouds
+        /// \return Frame format
+        public: const std::string &Format() const;
+
+        /// \brief Set the description of the frame data
+        /// \param[in] _width Frame width
+        /// \param[in] _height Frame height
+        /// \param[in] _channels Number of channels
+        /// \param[in] _format Frame format
+        public: void SetDescription(unsigned int _width, unsigned int _height,
+                    unsigned int _channels, const std::string &_format);
+
+        /// \brief Resize the frame data. Memory is only allocated when the
+        /// frame grows beyond its largest size so far.
+        /// \param[in] _size Size in bytes
+        public: void Resize(size_t _size);
+
+        IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+        /// \brief Frame data
+        private: std::vector<unsigned char> data;
+
+        /// \brief Frame format
+        private: std::string format;
+        IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+
+        /// \brief Frame width
+        private: unsigned int width = 0u;
+
+        /// \brief Frame height
+        private: unsigned int height = 0u;
+
+        /// \brief Number of channels
+        private: unsigned int channels = 0u;
+      };
+
+      /// \brief Shared pointer to a sensor frame
+      typedef std::shared_ptr<SensorFrame> SensorFramePtr;
+
+      /// \brief Shared pointer to a sensor frame handed to subscribers
+      typedef std::shared_ptr<const SensorFrame> ConstSensorFramePtr;
+
+      /// \brief Pool of sensor frames. A frame is handed out again once the
+      /// pool holds the only reference to it. Frames are acquired by a
+      /// single thread, the render thread, but may be released from any
+      /// thread.
+      class IGNITION_RENDERING_VISIBLE SensorFramePool
+      {
+        /// \brief Constructor
+        public: SensorFramePool();
+
+        /// \brief Destructor. Frames still in use are kept alive by their
+        /// references.
+        public: ~SensorFramePool();
+
+        /// \brief Get a frame no one else holds
+        /// \param[in] _size Size of the frame data in bytes
+        /// \return Frame of _size bytes
+        public: SensorFramePtr Acquire(size_t _size);
+
+        /// \brief Get the number of frames allocated by the pool
+        /// \return Number of frames, used or not
+        public: unsigned int Size() const;
+
+        IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+        private: std::unique_ptr<SensorFramePoolPrivate> dataPtr;
+        IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+      };
+    }
+  }
+}
+#endif
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_SENSORSCHEDULER_HH_
+#define IGNITION_RENDERING_SENSORSCHEDULER_HH_
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include <ignition/common/SuppressWarning.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+#include "ignition/rendering/RenderTypes.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+      // forward declaration
+      class SensorSchedulerPrivate;
+
+      /// \brief Schedules the renders of sensors updated at different
+      /// rates, e.g. a 30 Hz camera and a 10 Hz gpu rays, so that the
+      /// rendering load is spread evenly over time.
+      ///
+      /// Time is divided in ticks of a fixed period. Each sensor is
+      /// rendered every N ticks, N being its update period rounded to
+      /// ticks, at a phase chosen when it is added so that it collides
+      /// with the fewest sensors already scheduled, weighed by their cost.
+      /// The sensors due on the same tick are rendered together in one
+      /// render batch of their engine, see RenderEngine::BeginRenderBatch.
+      /// If a tick is missed, the sensors due are rendered once on the next
+      /// update and keep their phase.
+      class IGNITION_RENDERING_VISIBLE SensorScheduler
+      {
+        /// \brief Constructor
+        public: SensorScheduler();
+
+        /// \brief Destructor
+        public: ~SensorScheduler();
+
+        /// \brief Set the period of the ticks. The phases of the sensors
+        /// already added are chosen again. Defaults to 1 ms.
+        /// \param[in] _period Tick period, must be positive
+        public: void SetTickPeriod(std::chrono::steady_clock::duration _period);
+
+        /// \brief Get the period of the ticks
+        /// \return Tick period
+        public: std::chrono::steady_clock::duration TickPeriod() const;
+
+        /// \brief Schedule a sensor. Adding a sensor already scheduled
+        /// updates its rate and cost and chooses its phase again. The
+        /// scheduler does not keep the sensor alive, sensors destroyed are
+        /// removed on the next update.
+        /// \param[in] _sensor Sensor to schedule
+        /// \param[in] _rate Update rate of the sensor in Hz, must be
+        /// positive
+        /// \param[in] _cost Relative cost of rendering the sensor, e.g.
+        /// its number of pixels, used to level the load of the ticks
+        /// \return True if the sensor is scheduled
+        public: bool AddSensor(const CameraPtr &_sensor, double _rate,
+                    double _cost = 1.0);
+
+        /// \brief Stop scheduling a sensor
+        /// \param[in] _sensor Sensor to remove
+        /// \return True if the sensor was scheduled
+        public: bool RemoveSensor(const CameraPtr &_sensor);
+
+        /// \brief Get the number of sensors scheduled
+        /// \return Number of sensors
+        public: unsigned int SensorCount() const;
+
+        /// \brief Get the tick, modulo its period, at which a sensor is
+        /// rendered
+        /// \param[in] _sensor Sensor scheduled
+        /// \return Phase of the sensor in ticks, 0 if it is not scheduled
+        public: unsigned int Phase(const CameraPtr &_sensor) const;
+
+        /// \brief Get the number of ticks between two renders of a sensor
+        /// \param[in] _sensor Sensor scheduled
+        /// \return Period of the sensor in ticks, 0 if it is not scheduled
+        public: unsigned int Period(const CameraPtr &_sensor) const;
+
+        /// \brief Get the sensors due at a time and advance their
+        /// schedule, without rendering them, e.g. to render them with
+        /// custom steps
+        /// \param[in] _time Current time, e.g. the simulation time
+        /// \return Sensors due, in the order they were added
+        public: std::vector<CameraPtr> DueSensors(
+                    std::chrono::steady_clock::duration _time);
+
+        /// \brief Render the sensors due at a time. The sensors of each
+        /// engine are rendered in one render batch, unless a batch is
+        /// already active, and the scenes are prepared once.
+        /// \param[in] _time Current time, e.g. the simulation time
+        /// \return Number of sensors rendered
+        public: unsigned int Update(std::chrono::steady_clock::duration _time);
+
+        IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+        /// \brief Private data pointer
+        private: std::unique_ptr<SensorSchedulerPrivate> dataPtr;
+        IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+      };
+    }
+  }
+}
+#endif
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_SHADERPASS_HH_
+#define IGNITION_RENDERING_SHADERPASS_HH_
+
+#include <string>
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+#include "ignition/rendering/RenderPass.hh"
+#include "ignition/rendering/RenderTypes.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /* \class ShaderPass ShaderPass.hh \
+     * ignition/rendering/ShaderPass.hh
+     */
+    /// \brief A render pass that applies a user provided GLSL kernel to the
+    /// render target on the GPU, before the image is read back. This is
+    /// meant for sensor post-processing such as distortion, vignetting or
+    /// blur, which would otherwise be applied on the CPU to the captured
+    /// image.
+    ///
+    /// The kernel is GLSL 3.30 code that defines the function
+    /// `vec4 kernel(vec2 uv)`, returning the output color at the texture
+    /// coordinates uv. The input image is the `uniform sampler2D RT`,
+    /// declared for the kernel, and can be sampled anywhere. Other uniforms
+    /// declared by the kernel are set with KernelParams().
+    class IGNITION_RENDERING_VISIBLE ShaderPass
+      : public virtual RenderPass
+    {
+      /// \brief Constructor
+      public: ShaderPass();
+
+      /// \brief Destructor
+      public: virtual ~ShaderPass();
+
+      /// \brief Get the GLSL code of the kernel
+      /// \return GLSL code of the kernel
+      public: virtual std::string Kernel() const = 0;
+
+      /// \brief Set the GLSL code of the kernel
+      /// \param[in] _code GLSL code defining `vec4 kernel(vec2 uv)`
+      public: virtual void SetKernel(const std::string &_code) = 0;
+
+      /// \brief Get the values of the uniforms of the kernel
+      /// \return Uniform values, by name
+      public: virtual ShaderParamsPtr KernelParams() = 0;
+    };
+    }
+  }
+}
+#endif
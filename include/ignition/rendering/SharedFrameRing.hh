@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_SHAREDFRAMERING_HH_
+#define IGNITION_RENDERING_SHAREDFRAMERING_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <ignition/common/SuppressWarning.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/Export.hh"
+#include "ignition/rendering/PixelFormat.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+      // forward declaration
+      class SharedFrameRingPrivate;
+
+      /// \brief Description of a frame in a SharedFrameRing
+      struct SharedFrameInfo
+      {
+        /// \brief Sequence number of the frame, from zero
+        uint64_t sequence = 0u;
+
+        /// \brief Frame width in pixels
+        unsigned int width = 0u;
+
+        /// \brief Frame height in pixels
+        unsigned int height = 0u;
+
+        /// \brief Number of channels per pixel, for float frames
+        unsigned int channels = 0u;
+
+        /// \brief Pixel format, PF_FLOAT32_R or PF_FLOAT32_RGB for depth
+        /// and gpu rays frames
+        PixelFormat format = PF_UNKNOWN;
+
+        /// \brief Number of bytes of the frame
+        size_t size = 0u;
+      };
+
+      /// \brief Ring buffer of frames in POSIX shared memory, to pass
+      /// sensor frames to other processes without serializing them. A
+      /// producer creates the ring and writes frames into its slots,
+      /// overwriting the oldest one; camera frames are read back from the
+      /// GPU straight into the slot. Consumers open the ring by name and
+      /// read the latest frames. Each slot has a sequence number which is
+      /// odd while the slot is written, so readers detect frames that are
+      /// overwritten while they read them and never block the producer.
+      /// There must be a single producer per ring. Not supported on
+      /// Windows.
+      class IGNITION_RENDERING_VISIBLE SharedFrameRing
+      {
+        /// \brief Constructor
+        public: SharedFrameRing();
+
+        /// \brief Destructor. Unmaps the ring, and removes its name if it
+        /// was created by this object.
+        public: ~SharedFrameRing();
+
+        /// \brief Create the shared memory of a ring, replacing a ring of
+        /// the same name left by a previous producer
+        /// \param[in] _name Name of the ring, e.g. "/camera_front"
+        /// \param[in] _slotCount Number of frames held, at least two
+        /// \param[in] _slotSize Maximum number of bytes of a frame
+        /// \return True if the ring is created
+        public: bool Create(const std::string &_name,
+                    unsigned int _slotCount, size_t _slotSize);
+
+        /// \brief Open the ring created by a producer
+        /// \param[in] _name Name of the ring
+        /// \return True if the ring is opened
+        public: bool Open(const std::string &_name);
+
+        /// \brief Get whether a ring is created or opened
+        /// \return True if the ring can be used
+        public: bool Valid() const;
+
+        /// \brief Get the number of frames held by the ring
+        /// \return Number of slots
+        public: unsigned int SlotCount() const;
+
+        /// \brief Get the maximum number of bytes of a frame
+        /// \return Size of a slot
+        public: size_t SlotSize() const;
+
+        /// \brief Write a frame to the next slot. Only valid for rings
+        /// created by this object.
+        /// \param[in] _data Frame data
+        /// \param[in] _info Description of the frame. Its sequence is
+        /// ignored, frames are numbered in the order they are written.
+        /// \return True if the frame is written
+        public: bool Write(const void *_data, const SharedFrameInfo &_info);
+
+        /// \brief Copy the last frame rendered by a camera to the next
+        /// slot, reading it back from the GPU directly into the shared
+        /// memory
+        /// \param[in] _camera Camera to read the frame from
+        /// \return True if the frame is written
+        public: bool WriteCameraFrame(const Camera &_camera);
+
+        /// \brief Write a float frame, e.g. from ConnectNewDepthFrame or
+        /// ConnectNewGpuRaysFrame
+        /// \param[in] _data Frame data
+        /// \param[in] _width Frame width in pixels
+        /// \param[in] _height Frame height in pixels
+        /// \param[in] _channels Number of floats per pixel
+        /// \return True if the frame is written
+        public: bool WriteFloatFrame(const float *_data, unsigned int _width,
+                    unsigned int _height, unsigned int _channels);
+
+        /// \brief Get the sequence number of the next frame written
+        /// \return Number of frames written since the ring was created
+        public: uint64_t WriteCount() const;
+
+        /// \brief Copy a frame out of the ring
+        /// \param[in] _sequence Sequence number of the frame, e.g.
+        /// WriteCount() - 1 for the latest one
+        /// \param[out] _info Description of the frame
+        /// \param[out] _data Buffer receiving the frame
+        /// \param[in] _size Size of the buffer
+        /// \return False if the frame is not written yet, is overwritten,
+        /// or does not fit in the buffer
+        public: bool Read(uint64_t _sequence, SharedFrameInfo &_info,
+                    void *_data, size_t _size) const;
+
+        /// \brief Get a frame in place, without copying it. The frame may
+        /// be overwritten while it is used: call FrameValid once done with
+        /// the data to check that it was not.
+        /// \param[in] _sequence Sequence number of the frame
+        /// \param[out] _info Description of the frame
+        /// \return Frame data, null if the frame is not available
+        public: const void *FrameData(uint64_t _sequence,
+                    SharedFrameInfo &_info) const;
+
+        /// \brief Get whether a frame is still held by its slot
+        /// \param[in] _sequence Sequence number of the frame
+        /// \return True if the frame is written and not overwritten
+        public: bool FrameValid(uint64_t _sequence) const;
+
+        IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+        /// \brief Private data pointer
+        private: std::unique_ptr<SharedFrameRingPrivate> dataPtr;
+        IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+      };
+    }
+  }
+}
+#endif
@@ -17,6 +17,7 @@
 #ifndef IGNITION_RENDERING_STORAGE_HH_
 #define IGNITION_RENDERING_STORAGE_HH_
 
+#include <functional>
 #include <memory>
 #include <string>
 #include "ignition/rendering/config.hh"
@@ -102,6 +103,9 @@ namespace ignition
 
       /// \brief Remove all elements from this map
       public: virtual void RemoveAll() = 0;
+
+      /// \brief Remove and destroy all elements of this map
+      public: virtual void DestroyAll() = 0;
     };
 
     /// \class Store Storage.hh ignition/rendering/Storage.hh
@@ -158,6 +162,14 @@ namespace ignition
       /// \return The specified element
       public: virtual TPtr GetByIndex(unsigned int _index) const = 0;
 
+      /// \brief Call a function on every element, in index order. Unlike
+      /// GetByIndex this does not copy shared pointers, so it is the
+      /// cheapest way to traverse the store. The function must not add
+      /// elements to or remove elements from the store.
+      /// \param[in] _func Function called with each element
+      public: virtual void ForEach(const std::function<void(T &)> &_func)
+                  const = 0;
+
       /// \brief Add given element. If the element has already been added
       /// or its name or ID conflict with other existing elements, then no
       /// work will be done.
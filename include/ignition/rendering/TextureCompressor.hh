@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_TEXTURECOMPRESSOR_HH_
+#define IGNITION_RENDERING_TEXTURECOMPRESSOR_HH_
+
+#include <cstddef>
+#include <vector>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \enum TextureCompression TextureCompressor.hh
+    /// ignition/rendering/TextureCompressor.hh
+    /// \brief Block compression formats supported by TextureCompressor
+    enum IGNITION_RENDERING_VISIBLE TextureCompression
+    {
+      /// \brief BC1 (DXT1), opaque RGB at 4 bits per pixel
+      TC_BC1 = 0,
+
+      /// \brief BC3 (DXT5), RGBA at 8 bits per pixel
+      TC_BC3 = 1,
+    };
+
+    /// \class TextureCompressor TextureCompressor.hh
+    /// ignition/rendering/TextureCompressor.hh
+    /// \brief Compresses 8 bit RGBA images into GPU block compression
+    /// formats, so render engines can keep textures compressed in video
+    /// memory. Images are stored row by row, 4 bytes per pixel, in R, G, B,
+    /// A order. Images that are not a multiple of 4 pixels wide or high are
+    /// padded by repeating their last row and column.
+    class IGNITION_RENDERING_VISIBLE TextureCompressor
+    {
+      /// \brief Get the number of bytes of a compressed image
+      /// \param[in] _width Width of image in pixels
+      /// \param[in] _height Height of image in pixels
+      /// \param[in] _format Compression format
+      /// \return Size of compressed image in bytes
+      public: static size_t CompressedSize(unsigned int _width,
+          unsigned int _height, TextureCompression _format);
+
+      /// \brief Compress an image
+      /// \param[in] _rgba Image data
+      /// \param[in] _width Width of image in pixels
+      /// \param[in] _height Height of image in pixels
+      /// \param[in] _format Compression format
+      /// \return Compressed blocks, empty if the image is empty
+      public: static std::vector<unsigned char> Compress(
+          const unsigned char *_rgba, unsigned int _width,
+          unsigned int _height, TextureCompression _format);
+
+      /// \brief Decompress an image compressed with Compress
+      /// \param[in] _data Compressed blocks
+      /// \param[in] _width Width of image in pixels
+      /// \param[in] _height Height of image in pixels
+      /// \param[in] _format Compression format
+      /// \return Image data, 4 bytes per pixel
+      public: static std::vector<unsigned char> Decompress(
+          const unsigned char *_data, unsigned int _width,
+          unsigned int _height, TextureCompression _format);
+
+      /// \brief Check if an image has pixels that are not fully opaque
+      /// \param[in] _rgba Image data
+      /// \param[in] _width Width of image in pixels
+      /// \param[in] _height Height of image in pixels
+      /// \return True if any pixel has an alpha below 255
+      public: static bool HasAlpha(const unsigned char *_rgba,
+          unsigned int _width, unsigned int _height);
+
+      /// \brief Compress an image and all of its mipmaps into the content
+      /// of a DDS file. Mipmaps are box filtered down to 1x1.
+      /// \param[in] _rgba Image data
+      /// \param[in] _width Width of image in pixels
+      /// \param[in] _height Height of image in pixels
+      /// \param[in] _format Compression format
+      /// \return Content of the DDS file, empty if the image is empty
+      public: static std::vector<unsigned char> CompressDds(
+          const unsigned char *_rgba, unsigned int _width,
+          unsigned int _height, TextureCompression _format);
+    };
+    }
+  }
+}
+#endif
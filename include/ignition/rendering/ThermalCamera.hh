@@ -118,6 +118,18 @@ namespace ignition
       public: virtual ignition::common::ConnectionPtr ConnectNewThermalFrame(
           std::function<void(const uint16_t *, unsigned int, unsigned int,
           unsigned int, const std::string &)>  _subscriber) = 0;
+
+      /// \brief Connect to the new thermal image event delivering the data
+      /// as read back, in the image format of the camera: one byte per pixel
+      /// for PF_L8 and two for PF_L16. Unlike ConnectNewThermalFrame, 8 bit
+      /// images are not widened to 16 bits.
+      /// \param[in] _subscriber Subscriber callback function. The callback
+      /// function arguments are: <thermal data, width, height, depth, format>
+      /// \return Pointer to the new Connection. This must be kept in scope
+      public: virtual ignition::common::ConnectionPtr
+          ConnectNewRawThermalFrame(
+          std::function<void(const unsigned char *, unsigned int,
+          unsigned int, unsigned int, const std::string &)>  _subscriber) = 0;
     };
   }
   }
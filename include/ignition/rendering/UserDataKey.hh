@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_USERDATAKEY_HH_
+#define IGNITION_RENDERING_USERDATAKEY_HH_
+
+#include <limits>
+#include <string>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \class UserDataKey UserDataKey.hh ignition/rendering/UserDataKey.hh
+    /// \brief Interned key of the custom data stored in visuals. Every
+    /// name is given a small integer id once per process, which visuals use
+    /// as the index of the slot holding the value. Code reading user data
+    /// on every frame, e.g. sensors, should create its keys once and use
+    /// them instead of strings, so that lookups do not hash the name.
+    class IGNITION_RENDERING_VISIBLE UserDataKey
+    {
+      /// \brief Id of keys that do not refer to any name
+      public: static constexpr unsigned int kInvalidId =
+          std::numeric_limits<unsigned int>::max();
+
+      /// \brief Default constructor. The key is invalid.
+      public: UserDataKey() = default;
+
+      /// \brief Constructor. Interns the name if it has not been interned
+      /// yet. Thread safe.
+      /// \param[in] _name Name of the key
+      public: explicit UserDataKey(const std::string &_name);
+
+      /// \brief Find the key of a name without interning it
+      /// \param[in] _name Name of the key
+      /// \return Key of the name, invalid if the name has never been
+      /// interned
+      public: static UserDataKey Find(const std::string &_name);
+
+      /// \brief Get the key of an id
+      /// \param[in] _id Id of the key
+      /// \return Key of the id, invalid if no name has this id
+      public: static UserDataKey FromId(unsigned int _id);
+
+      /// \brief Get the id of the key, which is the index of its slot
+      /// \return Id of the key
+      public: unsigned int Id() const;
+
+      /// \brief Get the name of the key
+      /// \return Name of the key, empty if the key is invalid
+      public: std::string Name() const;
+
+      /// \brief Get whether the key refers to a name
+      /// \return True if the key is valid
+      public: bool Valid() const;
+
+      /// \brief Equality operator
+      /// \param[in] _other Key to compare to
+      /// \return True if both keys have the same id
+      public: bool operator==(const UserDataKey &_other) const;
+
+      /// \brief Inequality operator
+      /// \param[in] _other Key to compare to
+      /// \return True if the keys have different ids
+      public: bool operator!=(const UserDataKey &_other) const;
+
+      /// \brief Id of the key
+      private: unsigned int id = kInvalidId;
+    };
+    }
+  }
+}
+#endif
@@ -49,6 +49,20 @@ namespace ignition
     ignition::math::AxisAlignedBox transformAxisAlignedBox(
         const ignition::math::AxisAlignedBox &_box,
         const ignition::math::Pose3d &_pose);
+
+    /// \brief Compute the surface normals of an organized point cloud, e.g.
+    /// the one of a depth camera, from the points next to each pixel. The
+    /// normals face the origin of the cloud.
+    /// \param[in] _points Points, _channels floats per pixel starting with
+    /// x, y, z
+    /// \param[in] _width Width of the cloud in pixels
+    /// \param[in] _height Height of the cloud in pixels
+    /// \param[in] _channels Number of floats per pixel, at least 3
+    /// \param[out] _normals Unit normals, 3 floats per pixel. They are zero
+    /// for pixels without a finite point or without finite neighbours.
+    IGNITION_RENDERING_VISIBLE
+    void computePointCloudNormals(const float *_points, unsigned int _width,
+        unsigned int _height, unsigned int _channels, float *_normals);
     }
   }
 }
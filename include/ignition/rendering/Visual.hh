@@ -17,11 +17,13 @@
 #ifndef IGNITION_RENDERING_VISUAL_HH_
 #define IGNITION_RENDERING_VISUAL_HH_
 
+#include <functional>
 #include <variant>
 #include <string>
 #include <ignition/math/AxisAlignedBox.hh>
 #include "ignition/rendering/config.hh"
 #include "ignition/rendering/Node.hh"
+#include "ignition/rendering/UserDataKey.hh"
 
 namespace ignition
 {
@@ -56,6 +58,14 @@ namespace ignition
       public: virtual GeometryPtr GeometryByIndex(
                   unsigned int _index) const = 0;
 
+      /// \brief Call a function on every geometry attached to this visual,
+      /// in index order. This does not copy shared pointers, so it is
+      /// cheaper than iterating with GeometryByIndex. The function must not
+      /// add or remove geometries of this visual.
+      /// \param[in] _func Function called with each geometry
+      public: virtual void ForEachGeometry(
+                  const std::function<void(Geometry &)> &_func) const = 0;
+
       /// \brief Add the given geometry to this visual. If the given node is
       /// already attached, no work will be done.
       /// \param[in] _geometry Geometry to be added
@@ -110,6 +120,41 @@ namespace ignition
       /// material will be returned.
       public: virtual MaterialPtr Material() = 0;
 
+      /// \brief Render the attached geometries and the geometries of all
+      /// attached visuals with the given material, e.g. to highlight a
+      /// model. The material is shared by the whole hierarchy instead of
+      /// being cloned, and the materials set with SetMaterial are kept, so
+      /// that clearing the override restores them without cloning them
+      /// again. Geometries added to this visual while the override is set
+      /// use it too.
+      /// \param[in] _material Material to render with, null to restore the
+      /// materials set with SetMaterial
+      /// \sa Geometry::SetMaterialOverride
+      public: virtual void SetMaterialOverride(MaterialPtr _material) = 0;
+
+      /// \brief Get the material set with SetMaterialOverride
+      /// \return Override material, null if there is none
+      public: virtual MaterialPtr MaterialOverride() const = 0;
+
+      /// \brief Create a deep copy of this visual, its geometries and its
+      /// child visuals. The geometries are copied with Geometry::Clone, so
+      /// the copies reuse the loaded data of the geometries, e.g. the engine
+      /// meshes, instead of loading them again. Geometries that can not be
+      /// copied are left out of the copy. The pose, scale, visibility flags,
+      /// user data and material override of the visuals are copied too.
+      /// \param[in] _name Name of the copy, a unique name is generated if
+      /// empty. The child visuals of the copy always get generated names.
+      /// \param[in] _newParent Node the copy is attached to, null to leave
+      /// it unattached
+      /// \param[in] _shareMaterials True if the copy should use the
+      /// materials of this visual, false if it should get its own copies
+      /// of them. Materials cloned for this visual are still destroyed with
+      /// its geometries, so copies sharing them must be destroyed first.
+      /// \return The copy, null if it could not be created, e.g. if a
+      /// visual with the given name already exists
+      public: virtual VisualPtr Clone(const std::string &_name,
+                  NodePtr _newParent, bool _shareMaterials = false) const = 0;
+
       /// \brief Specify if this visual is visible
       /// \param[in] _visible True if this visual should be made visible
       public: virtual void SetVisible(bool _visible) = 0;
@@ -130,6 +175,22 @@ namespace ignition
       /// \param[in] _visibility flags
       public: virtual void RemoveVisibilityFlags(uint32_t _flags) = 0;
 
+      /// \brief Specify if this visual is static, i.e. neither it nor its
+      /// children are expected to move or change. Render engines may cache
+      /// the shadows cast by static visuals, in which case moving, hiding
+      /// or destroying a static visual invalidates the cache. Render
+      /// engines may also leave static visuals out of the per frame
+      /// transform and bounds updates: a static visual can still be moved,
+      /// at a higher cost, but it does not follow a parent that moves.
+      /// \param[in] _static True if this visual is static
+      /// \sa Light::SetStatic
+      public: virtual void SetStatic(bool _static) = 0;
+
+      /// \brief Get whether this visual is static
+      /// \return True if this visual is static
+      /// \sa SetStatic
+      public: virtual bool Static() const = 0;
+
       /// \brief Store any custom data associated with this visual
       /// \param[in] _key Unique key
       /// \param[in] _value Value in any type
@@ -141,6 +202,22 @@ namespace ignition
       /// \param[in] _value Value in any type
       public: virtual Variant UserData(const std::string &_key) const = 0;
 
+      /// \brief Store any custom data associated with this visual. The
+      /// data is shared with the string key of the same name.
+      /// \param[in] _key Interned key, ignored if invalid
+      /// \param[in] _value Value in any type
+      public: virtual void SetUserData(const UserDataKey &_key,
+          Variant _value) = 0;
+
+      /// \brief Get custom data stored in this visual. The lookup is a
+      /// direct index into the slots of the visual, meant for code reading
+      /// the data every frame.
+      /// \param[in] _key Interned key
+      /// \return Value stored for the key, an empty variant if none was
+      /// stored. The reference is valid until user data is set again.
+      public: virtual const Variant &UserData(const UserDataKey &_key)
+          const = 0;
+
       /// \brief Get the bounding box in world frame coordinates.
       /// \return The axis aligned bounding box
       public: virtual ignition::math::AxisAlignedBox BoundingBox() const = 0;
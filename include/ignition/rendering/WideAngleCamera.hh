@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_WIDEANGLECAMERA_HH_
+#define IGNITION_RENDERING_WIDEANGLECAMERA_HH_
+
+#include <functional>
+#include <string>
+
+#include <ignition/common/Event.hh>
+
+#include "ignition/rendering/Camera.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \enum WideAngleProjection
+    /// \brief Mapping functions of wide angle lenses, giving the distance r
+    /// of a pixel to the image center as a function of the angle theta
+    /// between its ray and the optical axis, with f the focal length.
+    enum WideAngleProjection
+    {
+      /// \brief Equidistant: r = f theta
+      WAP_EQUIDISTANT = 0,
+
+      /// \brief Equisolid angle: r = 2 f sin(theta / 2)
+      WAP_EQUISOLID_ANGLE = 1,
+
+      /// \brief Stereographic: r = 2 f tan(theta / 2)
+      WAP_STEREOGRAPHIC = 2,
+
+      /// \brief Orthographic: r = f sin(theta)
+      WAP_ORTHOGRAPHIC = 3,
+
+      /// \brief Gnomonic, i.e. pinhole: r = f tan(theta)
+      WAP_GNOMONIC = 4
+    };
+
+    /* \class WideAngleCamera WideAngleCamera.hh \
+     * ignition/rendering/WideAngleCamera.hh
+     */
+    /// \brief Camera with a wide angle lens. The scene is rendered to the
+    /// faces of a cubemap, which are resampled with the mapping function of
+    /// the lens. The focal length is chosen so the left and right edges of
+    /// the image are at half the horizontal field of view from the optical
+    /// axis, which can be up to 360 degrees. Pixels out of the field of view
+    /// of the mapping function are black.
+    class IGNITION_RENDERING_VISIBLE WideAngleCamera :
+      public virtual Camera
+    {
+      /// \brief Destructor
+      public: virtual ~WideAngleCamera() { }
+
+      /// \brief Set the mapping function of the lens. This must be set
+      /// before the camera is first rendered.
+      /// \param[in] _projection Mapping function, WAP_EQUIDISTANT by default
+      public: virtual void SetProjection(WideAngleProjection _projection) = 0;
+
+      /// \brief Get the mapping function of the lens
+      /// \return Mapping function
+      public: virtual WideAngleProjection Projection() const = 0;
+
+      /// \brief Set the size of the cubemap faces the scene is rendered to.
+      /// This must be set before the camera is first rendered.
+      /// \param[in] _size Size of a face in pixels, 0 by default to pick it
+      /// from the resolution of the image at its center
+      public: virtual void SetCubeFaceSize(unsigned int _size) = 0;
+
+      /// \brief Get the size of the cubemap faces
+      /// \return Size of a face in pixels, 0 if it is picked from the image
+      /// resolution
+      public: virtual unsigned int CubeFaceSize() const = 0;
+
+      /// \brief Connect to the new wide angle image event
+      /// \param[in] _subscriber Subscriber callback function. The callback
+      /// function arguments are: <image data, width, height, channels,
+      /// format>
+      /// \return Pointer to the new Connection. This must be kept in scope
+      public: virtual common::ConnectionPtr ConnectNewWideAngleFrame(
+          std::function<void(const unsigned char *, unsigned int,
+          unsigned int, unsigned int, const std::string &)> _subscriber) = 0;
+    };
+    }
+  }
+}
+#endif
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_WORLDSTREAMER_HH_
+#define IGNITION_RENDERING_WORLDSTREAMER_HH_
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/common/SuppressWarning.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+#include "ignition/rendering/MeshDescriptor.hh"
+#include "ignition/rendering/RenderTypes.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+      // forward declaration
+      class WorldStreamerPrivate;
+
+      /// \enum SectorState WorldStreamer.hh
+      /// ignition/rendering/WorldStreamer.hh
+      /// \brief State of a sector of a WorldStreamer
+      enum IGNITION_RENDERING_VISIBLE SectorState
+      {
+        /// \brief The sector is not in the scene
+        SS_UNLOADED  = 0,
+        /// \brief Some visuals of the sector are not in the scene yet
+        SS_LOADING   = 1,
+        /// \brief All the visuals of the sector are in the scene
+        SS_LOADED    = 2,
+        /// \brief The visuals of the sector are being removed
+        SS_UNLOADING = 3
+      };
+
+      /// \brief Description of a visual of a sector
+      struct IGNITION_RENDERING_VISIBLE SectorVisualDescriptor
+      {
+        /// \brief Name of the visual, generated if empty
+        std::string name;
+
+        /// \brief Mesh of the visual, the visual has no geometry if the
+        /// descriptor has neither a mesh nor a mesh name
+        MeshDescriptor mesh;
+
+        /// \brief Pose of the visual relative to the sector
+        math::Pose3d pose = math::Pose3d::Zero;
+
+        /// \brief Scale of the visual
+        math::Vector3d scale = math::Vector3d::One;
+
+        /// \brief Material assigned to the visual, shared with the other
+        /// visuals using it. The materials of the mesh are used if null.
+        MaterialPtr material;
+
+        /// \brief True if the visual never moves
+        /// \sa Visual::SetStatic
+        bool isStatic = false;
+      };
+
+      /// \brief Loads and unloads sectors of a large world as the area of
+      /// interest moves, without stalling the render loop. The meshes of a
+      /// sector are prepared on worker threads when the sector is requested,
+      /// see Scene::PrepareMesh, and textures are decoded in the background
+      /// by render engines that stream them. Update then adds the prepared
+      /// visuals to the scene, and removes the visuals of sectors being
+      /// unloaded, until a time budget is spent. Each sector is a visual
+      /// attached to the root visual of the scene, with the visuals of the
+      /// sector as children. The streamer must be used from the thread
+      /// rendering the scene.
+      class IGNITION_RENDERING_VISIBLE WorldStreamer
+      {
+        /// \brief Constructor
+        /// \param[in] _scene Scene to stream the sectors into
+        public: explicit WorldStreamer(ScenePtr _scene);
+
+        /// \brief Destructor. The sectors in the scene stay in it.
+        public: ~WorldStreamer();
+
+        /// \brief Request a sector. Its meshes start being prepared, and its
+        /// visuals are added to the scene by the following Update calls, in
+        /// the given order.
+        /// \param[in] _name Name of the sector
+        /// \param[in] _visuals Visuals of the sector
+        /// \param[in] _pose Pose of the sector in the world
+        /// \return True if the sector is requested, false if a sector with
+        /// the same name is loaded or being unloaded
+        public: bool LoadSector(const std::string &_name,
+                    const std::vector<SectorVisualDescriptor> &_visuals,
+                    const math::Pose3d &_pose = math::Pose3d::Zero);
+
+        /// \brief Request the removal of a sector. Its visuals not in the
+        /// scene yet are discarded, and the others are removed by the
+        /// following Update calls.
+        /// \param[in] _name Name of the sector
+        /// \return True if the sector is being unloaded, false if there is
+        /// no sector with this name
+        public: bool UnloadSector(const std::string &_name);
+
+        /// \brief Get the state of a sector
+        /// \param[in] _name Name of the sector
+        /// \return State of the sector, SS_UNLOADED if unknown
+        public: SectorState State(const std::string &_name) const;
+
+        /// \brief Get the visual holding the visuals of a sector
+        /// \param[in] _name Name of the sector
+        /// \return Visual of the sector, null if the sector is unloaded
+        public: VisualPtr SectorVisual(const std::string &_name) const;
+
+        /// \brief Set the time Update may spend adding and removing visuals.
+        /// At least one visual is added or removed per call whatever the
+        /// budget, so that sectors are always streamed eventually.
+        /// \param[in] _budget Time budget per call
+        public: void SetFrameBudget(
+                    const std::chrono::steady_clock::duration &_budget);
+
+        /// \brief Get the time Update may spend adding and removing
+        /// visuals
+        /// \return Time budget per call, 2 ms by default
+        public: std::chrono::steady_clock::duration FrameBudget() const;
+
+        /// \brief Add the prepared visuals of the sectors being loaded to
+        /// the scene and remove the visuals of the sectors being unloaded,
+        /// until the frame budget is spent. Sectors being unloaded are
+        /// processed first, to release their memory. Call once per frame,
+        /// before rendering.
+        /// \return Number of visuals added or removed
+        public: unsigned int Update();
+
+        /// \brief Get whether there are visuals to add or remove
+        /// \return True if all the sectors are loaded or unloaded
+        public: bool Idle() const;
+
+        IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+        /// \brief Private data pointer
+        private: std::unique_ptr<WorldStreamerPrivate> dataPtr;
+        IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+      };
+    }
+  }
+}
+#endif
@@ -17,17 +17,27 @@
 #ifndef IGNITION_RENDERING_BASE_BASECAMERA_HH_
 #define IGNITION_RENDERING_BASE_BASECAMERA_HH_
 
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <ignition/math/Matrix3.hh>
+#include <ignition/math/Matrix4.hh>
 #include <ignition/math/Pose3.hh>
 
 #include <ignition/common/Event.hh>
 #include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
 #include <ignition/common/SuppressWarning.hh>
 
 #include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/FrameWriter.hh"
 #include "ignition/rendering/Image.hh"
+#include "ignition/rendering/ImagePool.hh"
+#include "ignition/rendering/Profiler.hh"
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/Scene.hh"
 #include "ignition/rendering/base/BaseRenderTarget.hh"
@@ -83,6 +93,70 @@ namespace ignition
 
       public: virtual void SetNearClipPlane(const double _near) override;
 
+      // Documentation inherited.
+      public: virtual void SetLodBias(double _bias) override;
+
+      // Documentation inherited.
+      public: virtual double LodBias() const override;
+
+      // Documentation inherited.
+      public: virtual void SetImpostorsEnabled(bool _enabled) override;
+
+      // Documentation inherited.
+      public: virtual bool ImpostorsEnabled() const override;
+
+      /// \brief Get the level of detail bias to render with: the bias set
+      /// with SetLodBias, or a bias selecting the full detail of meshes at
+      /// any distance if impostors are disabled
+      /// \return Level of detail bias
+      protected: double RenderLodBias() const;
+
+      // Documentation inherited.
+      public: virtual void SetShadowsEnabled(bool _enabled) override;
+
+      // Documentation inherited.
+      public: virtual bool ShadowsEnabled() const override;
+
+      // Documentation inherited.
+      public: virtual void SetShadowMapSize(unsigned int _size) override;
+
+      // Documentation inherited.
+      public: virtual unsigned int ShadowMapSize() const override;
+
+      // Documentation inherited.
+      public: virtual bool SetDynamicResolutionEnabled(bool _enabled)
+                  override;
+
+      // Documentation inherited.
+      public: virtual bool DynamicResolutionEnabled() const override;
+
+      // Documentation inherited.
+      public: virtual void SetTargetGpuTime(double _time) override;
+
+      // Documentation inherited.
+      public: virtual double TargetGpuTime() const override;
+
+      // Documentation inherited.
+      public: virtual void SetResolutionScaleRange(double _min, double _max)
+                  override;
+
+      // Documentation inherited.
+      public: virtual double MinResolutionScale() const override;
+
+      // Documentation inherited.
+      public: virtual double MaxResolutionScale() const override;
+
+      // Documentation inherited.
+      public: virtual double ResolutionScale() const override;
+
+      // Documentation inherited.
+      public: virtual bool SetOrderIndependentTransparencyEnabled(
+                  bool _enabled) override;
+
+      // Documentation inherited.
+      public: virtual bool OrderIndependentTransparencyEnabled() const
+                  override;
+
       // Documentation inherited.
       public: virtual void PreRender() override;
 
@@ -91,14 +165,41 @@ namespace ignition
 
       public: virtual void Update() override;
 
+      // Documentation inherited.
+      public: virtual void SetOnDemandRendering(bool _enabled) override;
+
+      // Documentation inherited.
+      public: virtual bool OnDemandRendering() const override;
+
+      // Documentation inherited.
+      public: virtual void RequestRender() override;
+
       public: virtual Image CreateImage() const override;
 
       public: virtual void Capture(Image &_image) override;
 
+      // Documentation inherited.
+      public: virtual void Capture(void *_data,
+                  unsigned int _rowStride = 0u) override;
+
       public: virtual void Copy(Image &_image) const override;
 
+      // Documentation inherited.
+      public: virtual bool CopyRegion(Image &_image, unsigned int _x,
+                  unsigned int _y) const override;
+
       public: virtual bool SaveFrame(const std::string &_name) override;
 
+      // Documentation inherited.
+      public: virtual bool StartRecording(const std::string &_directory,
+                  const std::string &_extension = "png") override;
+
+      // Documentation inherited.
+      public: virtual void StopRecording() override;
+
+      // Documentation inherited.
+      public: virtual bool Recording() const override;
+
       public: virtual common::ConnectionPtr ConnectNewImageFrame(
                   Camera::NewFrameListener _listener) override;
 
@@ -108,6 +209,11 @@ namespace ignition
       public: virtual VisualPtr VisualAt(const ignition::math::Vector2i
                   &_mousePos) override;
 
+      // Documentation inherited.
+      public: virtual std::vector<VisualPtr> VisualsInRegion(
+                  const ignition::math::Vector2i &_min,
+                  const ignition::math::Vector2i &_max) override;
+
       // Documentation inherited.
       public: virtual math::Matrix4d ProjectionMatrix() const override;
 
@@ -164,6 +270,23 @@ namespace ignition
       // Documentation inherited.
       public: virtual unsigned int RenderTextureGLId() const override;
 
+      // Documentation inherited.
+      public: virtual void SetFrameEncoder(
+                  const GpuFrameEncoderPtr &_encoder) override;
+
+      // Documentation inherited.
+      public: virtual GpuFrameEncoderPtr FrameEncoder() const override;
+
+      /// \brief Pass the frame just rendered to the frame encoder,
+      /// registering the render texture first if it changed
+      protected: void EncodeFrame();
+
+      /// \brief Check whether a frame rendered now would differ from the
+      /// last one rendered on demand, and if so record the state it is
+      /// rendered with
+      /// \return True if a new frame needs to be rendered
+      protected: bool RenderNeeded();
+
       // Documentation inherited.
       public: virtual void AddRenderPass(const RenderPassPtr &_pass) override;
 
@@ -186,6 +309,18 @@ namespace ignition
 
       protected: virtual RenderTargetPtr RenderTarget() const = 0;
 
+      /// \brief Update the scale of the resolution of dynamic resolution
+      /// from the GPU time of the last frame measured. The resolution is
+      /// reduced at once when the frames are too slow, and raised slowly
+      /// when they are fast enough. Since the measures lag a few frames
+      /// behind, the measures of the frames following a change are
+      /// ignored. Called by the render engines supporting dynamic
+      /// resolution before rendering a frame.
+      /// \param[in] _gpuTime GPU time in milliseconds of the last frame
+      /// measured, ignored if not positive
+      /// \return New scale of the resolution
+      protected: double UpdateResolutionScale(double _gpuTime);
+
       IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
       protected: common::EventT<void(const void *, unsigned int, unsigned int,
                      unsigned int, const std::string &)> newFrameEvent;
@@ -198,6 +333,88 @@ namespace ignition
       /// \brief Far clipping plane distance
       protected: double farClip = 1000.0;
 
+      /// \brief Level of detail bias
+      protected: double lodBias = 1.0;
+
+      /// \brief True if the camera draws the impostors of meshes
+      protected: bool impostorsEnabled = true;
+
+      /// \brief True if the camera renders shadows
+      protected: bool shadowsEnabled = true;
+
+      /// \brief Size of shadow maps in pixels, 0 for the default size
+      protected: unsigned int shadowMapSize = 0u;
+
+      /// \brief True if dynamic resolution is enabled
+      protected: bool dynamicResolution = false;
+
+      /// \brief GPU time in milliseconds dynamic resolution aims for
+      protected: double targetGpuTime = 16.0;
+
+      /// \brief Smallest scale of the resolution
+      protected: double minResolutionScale = 0.5;
+
+      /// \brief Largest scale of the resolution
+      protected: double maxResolutionScale = 1.0;
+
+      /// \brief Scale of the resolution of the last frame
+      protected: double resolutionScale = 1.0;
+
+      /// \brief Number of frames left before the GPU times measured
+      /// reflect the last change of the resolution scale
+      protected: unsigned int resolutionScaleHold = 0u;
+
+      /// \brief True if order independent transparency is enabled
+      protected: bool orderIndependentTransparency = false;
+
+      /// \brief Images the frames written by SaveFrame are copied to
+      protected: std::unique_ptr<ImagePool> savedFramePool;
+
+      /// \brief Directory of the frames recorded, empty when not recording
+      protected: std::string recordingDirectory;
+
+      /// \brief Extension of the files of the frames recorded
+      protected: std::string recordingExtension;
+
+      /// \brief Number of frames recorded since the recording started
+      protected: unsigned int recordedFrameCount = 0u;
+
+      /// \brief Encoder of the frames rendered
+      protected: GpuFrameEncoderPtr frameEncoder;
+
+      /// \brief Render texture registered with the frame encoder, 0 if none
+      protected: unsigned int encodedTextureId = 0u;
+
+      /// \brief Width of the texture registered with the frame encoder
+      protected: unsigned int encodedWidth = 0u;
+
+      /// \brief Height of the texture registered with the frame encoder
+      protected: unsigned int encodedHeight = 0u;
+
+      /// \brief Number of frames passed to the frame encoder
+      protected: uint64_t encodedFrameCount = 0u;
+
+      /// \brief True if Update only renders when needed
+      protected: bool onDemandRendering = false;
+
+      /// \brief True if the next frame is rendered even if nothing changed
+      protected: bool renderRequested = true;
+
+      /// \brief Scene version of the last frame rendered on demand
+      protected: uint64_t renderedSceneVersion = 0u;
+
+      /// \brief Camera pose of the last frame rendered on demand
+      protected: math::Pose3d renderedPose;
+
+      /// \brief Projection of the last frame rendered on demand
+      protected: math::Matrix4d renderedProjection;
+
+      /// \brief Image width of the last frame rendered on demand
+      protected: unsigned int renderedWidth = 0u;
+
+      /// \brief Image height of the last frame rendered on demand
+      protected: unsigned int renderedHeight = 0u;
+
       /// \brief Aspect ratio
       protected: double aspect = 1.3333333;
 
@@ -368,7 +585,78 @@ namespace ignition
     template <class T>
     void BaseCamera<T>::PostRender()
     {
+      IGN_RENDERING_PROFILE("BaseCamera::PostRender");
       this->RenderTarget()->PostRender();
+
+      if (!this->recordingDirectory.empty())
+      {
+        char file[32];
+        std::snprintf(file, sizeof(file), "frame_%06u.",
+            this->recordedFrameCount++);
+        this->SaveFrame(common::joinPaths(this->recordingDirectory,
+            file + this->recordingExtension));
+      }
+
+      if (this->frameEncoder)
+        this->EncodeFrame();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::EncodeFrame()
+    {
+      unsigned int textureId = this->RenderTextureGLId();
+      if (textureId == 0u)
+      {
+        ignerr << "Camera [" << this->Name() << "] does not expose its "
+               << "render texture, removing its frame encoder" << std::endl;
+        this->frameEncoder.reset();
+        return;
+      }
+
+      unsigned int width = this->ImageWidth();
+      unsigned int height = this->ImageHeight();
+      if (textureId != this->encodedTextureId ||
+          width != this->encodedWidth || height != this->encodedHeight)
+      {
+        if (this->encodedTextureId != 0u)
+          this->frameEncoder->UnregisterTexture();
+        this->encodedTextureId = 0u;
+        if (!this->frameEncoder->RegisterTexture(textureId, width, height,
+            this->ImageFormat()))
+        {
+          ignerr << "Unable to register the render texture of camera ["
+                 << this->Name() << "] with its frame encoder" << std::endl;
+          this->frameEncoder.reset();
+          return;
+        }
+        this->encodedTextureId = textureId;
+        this->encodedWidth = width;
+        this->encodedHeight = height;
+      }
+
+      this->frameEncoder->EncodeFrame(this->encodedFrameCount++);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetFrameEncoder(const GpuFrameEncoderPtr &_encoder)
+    {
+      if (_encoder == this->frameEncoder)
+        return;
+
+      if (this->frameEncoder && this->encodedTextureId != 0u)
+        this->frameEncoder->UnregisterTexture();
+      this->frameEncoder = _encoder;
+      this->encodedTextureId = 0u;
+      this->encodedFrameCount = 0u;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    GpuFrameEncoderPtr BaseCamera<T>::FrameEncoder() const
+    {
+      return this->frameEncoder;
     }
 
     //////////////////////////////////////////////////
@@ -386,10 +674,65 @@ namespace ignition
     void BaseCamera<T>::Update()
     {
       this->Scene()->PreRender();
+
+      // the render target keeps the last frame
+      if (this->onDemandRendering && !this->RenderNeeded())
+        return;
+
       this->Render();
       this->PostRender();
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetOnDemandRendering(bool _enabled)
+    {
+      if (_enabled && !this->onDemandRendering)
+        this->renderRequested = true;
+      this->onDemandRendering = _enabled;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::OnDemandRendering() const
+    {
+      return this->onDemandRendering;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::RequestRender()
+    {
+      this->renderRequested = true;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::RenderNeeded()
+    {
+      uint64_t sceneVersion = this->Scene()->ChangeVersion();
+      math::Pose3d pose = this->WorldPose();
+      math::Matrix4d projection = this->ProjectionMatrix();
+      unsigned int width = this->ImageWidth();
+      unsigned int height = this->ImageHeight();
+      if (!this->renderRequested &&
+          sceneVersion == this->renderedSceneVersion &&
+          pose == this->renderedPose &&
+          projection == this->renderedProjection &&
+          width == this->renderedWidth && height == this->renderedHeight)
+      {
+        return false;
+      }
+
+      this->renderRequested = false;
+      this->renderedSceneVersion = sceneVersion;
+      this->renderedPose = pose;
+      this->renderedProjection = projection;
+      this->renderedWidth = width;
+      this->renderedHeight = height;
+      return true;
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     void BaseCamera<T>::Capture(Image &_image)
@@ -398,18 +741,119 @@ namespace ignition
       this->Copy(_image);
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::Capture(void *_data, unsigned int _rowStride)
+    {
+      // the image only aliases the buffer, nothing is allocated
+      Image image(this->ImageWidth(), this->ImageHeight(),
+          this->ImageFormat(), _data, _rowStride);
+      this->Capture(image);
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     void BaseCamera<T>::Copy(Image &_image) const
     {
+      IGN_RENDERING_PROFILE("BaseCamera::Copy");
       this->RenderTarget()->Copy(_image);
     }
 
     //////////////////////////////////////////////////
     template <class T>
-    bool BaseCamera<T>::SaveFrame(const std::string &/*_name*/)
+    bool BaseCamera<T>::CopyRegion(Image &_image, unsigned int _x,
+        unsigned int _y) const
     {
-      return false;
+      IGN_RENDERING_PROFILE("BaseCamera::CopyRegion");
+      unsigned int width = this->ImageWidth();
+      unsigned int height = this->ImageHeight();
+      if (_image.Width() == 0u || _image.Height() == 0u ||
+          _x + _image.Width() > width || _y + _image.Height() > height)
+      {
+        ignerr << "Invalid image region" << std::endl;
+        return false;
+      }
+
+      // the full frame is read back and cropped
+      Image frame(width, height, _image.Format());
+      this->Copy(frame);
+      unsigned int pixelSize = PixelUtil::BytesPerPixel(_image.Format());
+      unsigned int rowSize = _image.Width() * pixelSize;
+      const unsigned char *src = frame.Data<unsigned char>();
+      unsigned char *dst = _image.Data<unsigned char>();
+      for (unsigned int y = 0u; y < _image.Height(); ++y)
+      {
+        std::memcpy(dst + static_cast<size_t>(y) * _image.RowStride(),
+            src + static_cast<size_t>(_y + y) * frame.RowStride() +
+            _x * pixelSize, rowSize);
+      }
+      return true;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::SaveFrame(const std::string &_name)
+    {
+      if (_name.empty())
+        return false;
+
+      // the image is returned to the pool once written
+      PixelFormat format = this->ImageFormat();
+      unsigned int width = this->ImageWidth();
+      unsigned int height = this->ImageHeight();
+      Image image;
+      if (this->savedFramePool)
+        image = this->savedFramePool->Acquire();
+      if (image.Width() != width || image.Height() != height ||
+          image.Format() != format)
+      {
+        this->savedFramePool =
+            std::make_unique<ImagePool>(width, height, format);
+        image = this->savedFramePool->Acquire();
+      }
+
+      this->Copy(image);
+      return FrameWriter::Instance()->Write(image, _name);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::StartRecording(const std::string &_directory,
+        const std::string &_extension)
+    {
+      if (_directory.empty() || _extension.empty())
+        return false;
+
+      if (!common::isDirectory(_directory) &&
+          !common::createDirectories(_directory))
+      {
+        ignerr << "Unable to create directory [" << _directory
+               << "] to record the frames of camera [" << this->Name() << "]"
+               << std::endl;
+        return false;
+      }
+
+      this->recordingDirectory = _directory;
+      this->recordingExtension = _extension;
+      this->recordedFrameCount = 0u;
+      return true;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::StopRecording()
+    {
+      if (this->recordingDirectory.empty())
+        return;
+      this->recordingDirectory.clear();
+      FrameWriter::Instance()->Flush();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::Recording() const
+    {
+      return !this->recordingDirectory.empty();
     }
 
     //////////////////////////////////////////////////
@@ -538,6 +982,17 @@ namespace ignition
       return VisualPtr();
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    std::vector<VisualPtr> BaseCamera<T>::VisualsInRegion(
+        const ignition::math::Vector2i &/*_min*/,
+        const ignition::math::Vector2i &/*_max*/)
+    {
+      ignerr << "VisualsInRegion not implemented for the render engine"
+             << std::endl;
+      return std::vector<VisualPtr>();
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     void BaseCamera<T>::SetHFOV(const math::Angle &_hfov)
@@ -601,6 +1056,216 @@ namespace ignition
       this->nearClip = _near;
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetLodBias(double _bias)
+    {
+      if (_bias <= 0.0)
+      {
+        ignerr << "Level of detail bias must be positive" << std::endl;
+        return;
+      }
+      this->lodBias = _bias;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseCamera<T>::LodBias() const
+    {
+      return this->lodBias;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetImpostorsEnabled(bool _enabled)
+    {
+      this->impostorsEnabled = _enabled;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::ImpostorsEnabled() const
+    {
+      return this->impostorsEnabled;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseCamera<T>::RenderLodBias() const
+    {
+      // the bias divides the distance the levels are selected with
+      return this->impostorsEnabled ? this->lodBias : 1.0e6;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetShadowsEnabled(bool _enabled)
+    {
+      this->shadowsEnabled = _enabled;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::ShadowsEnabled() const
+    {
+      return this->shadowsEnabled;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetShadowMapSize(unsigned int _size)
+    {
+      bool powerOfTwo = (_size & (_size - 1u)) == 0u;
+      if (_size != 0u && (!powerOfTwo || _size < 256u || _size > 4096u))
+      {
+        ignerr << "Shadow map size must be a power of two between 256 and "
+               << "4096, or 0 for the default size" << std::endl;
+        return;
+      }
+      this->shadowMapSize = _size;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    unsigned int BaseCamera<T>::ShadowMapSize() const
+    {
+      return this->shadowMapSize;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::SetDynamicResolutionEnabled(bool _enabled)
+    {
+      if (_enabled)
+      {
+        ignwarn << "Dynamic resolution is not supported by camera '"
+                << this->Name() << "'" << std::endl;
+        return false;
+      }
+      return true;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::DynamicResolutionEnabled() const
+    {
+      return this->dynamicResolution;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetTargetGpuTime(double _time)
+    {
+      if (!std::isfinite(_time) || _time <= 0.0)
+      {
+        ignerr << "Target GPU time must be positive" << std::endl;
+        return;
+      }
+      this->targetGpuTime = _time;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseCamera<T>::TargetGpuTime() const
+    {
+      return this->targetGpuTime;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetResolutionScaleRange(double _min, double _max)
+    {
+      if (!(_min > 0.0) || !(_max >= _min) || _max > 1.0)
+      {
+        ignerr << "Resolution scale range must satisfy "
+               << "0 < min <= max <= 1" << std::endl;
+        return;
+      }
+      this->minResolutionScale = _min;
+      this->maxResolutionScale = _max;
+      if (this->dynamicResolution)
+      {
+        this->resolutionScale = math::clamp(this->resolutionScale,
+            _min, _max);
+      }
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseCamera<T>::MinResolutionScale() const
+    {
+      return this->minResolutionScale;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseCamera<T>::MaxResolutionScale() const
+    {
+      return this->maxResolutionScale;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseCamera<T>::ResolutionScale() const
+    {
+      return this->resolutionScale;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::SetOrderIndependentTransparencyEnabled(
+        bool _enabled)
+    {
+      if (_enabled)
+      {
+        ignwarn << "Order independent transparency is not supported by "
+                << "camera '" << this->Name() << "'" << std::endl;
+        return false;
+      }
+      return true;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::OrderIndependentTransparencyEnabled() const
+    {
+      return this->orderIndependentTransparency;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseCamera<T>::UpdateResolutionScale(double _gpuTime)
+    {
+      // number of frames the GPU times lag behind
+      const unsigned int kHoldFrames = 3u;
+
+      double scale = this->resolutionScale;
+      if (this->resolutionScaleHold > 0u)
+      {
+        --this->resolutionScaleHold;
+      }
+      else if (std::isfinite(_gpuTime) && _gpuTime > 0.0)
+      {
+        // the cost of a frame is about proportional to its pixel count,
+        // aim a little below the target to absorb the noise of the
+        // measures
+        double ideal = this->resolutionScale *
+            std::sqrt(0.9 * this->targetGpuTime / _gpuTime);
+        if (ideal < this->resolutionScale * 0.98)
+          scale = ideal;
+        else if (ideal > this->resolutionScale * 1.05)
+          scale += 0.25 * (ideal - this->resolutionScale);
+      }
+      scale = math::clamp(scale, this->minResolutionScale,
+          this->maxResolutionScale);
+      if (!math::equal(scale, this->resolutionScale))
+      {
+        this->resolutionScale = scale;
+        this->resolutionScaleHold = kHoldFrames;
+      }
+      return this->resolutionScale;
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     void BaseCamera<T>::SetTrackTarget(const NodePtr &_target,
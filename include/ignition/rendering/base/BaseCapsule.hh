@@ -19,6 +19,7 @@
 #define IGNITION_RENDERING_BASECAPSULE_HH_
 
 #include "ignition/rendering/Capsule.hh"
+#include "ignition/rendering/Scene.hh"
 #include "ignition/rendering/base/BaseObject.hh"
 
 namespace ignition
@@ -50,6 +51,10 @@ namespace ignition
       // Documentation inherited
       public: virtual double Length() const override;
 
+      // Documentation inherited
+      public: virtual GeometryPtr Clone(bool _shareMaterials = false) const
+                  override;
+
       /// \brief Radius of the capsule
       protected: double radius = 0.5;
 
@@ -80,6 +85,7 @@ namespace ignition
     {
       this->radius = _radius;
       this->capsuleDirty = true;
+      this->MarkPreRenderDirty();
     }
 
     /////////////////////////////////////////////////
@@ -95,6 +101,7 @@ namespace ignition
     {
       this->length = _length;
       this->capsuleDirty = true;
+      this->MarkPreRenderDirty();
     }
 
     /////////////////////////////////////////////////
@@ -103,6 +110,22 @@ namespace ignition
     {
       return this->length;
     }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    GeometryPtr BaseCapsule<T>::Clone(bool _shareMaterials) const
+    {
+      // the mesh of a capsule is generated from its size
+      CapsulePtr result = this->Scene()->CreateCapsule();
+      if (!result)
+        return nullptr;
+
+      result->SetRadius(this->Radius());
+      result->SetLength(this->Length());
+      if (this->Material())
+        result->SetMaterial(this->Material(), !_shareMaterials);
+      return result;
+    }
     }
   }
 }
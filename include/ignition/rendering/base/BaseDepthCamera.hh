@@ -50,6 +50,20 @@ namespace ignition
       public: virtual ignition::common::ConnectionPtr ConnectNewRGBPointCloud(
           std::function<void(const float *, unsigned int, unsigned int,
           unsigned int, const std::string &)>  _subscriber);
+
+      public: virtual ignition::common::ConnectionPtr ConnectNewRgbFrame(
+          std::function<void(const unsigned char *, unsigned int,
+          unsigned int, unsigned int, const std::string &)>  _subscriber)
+          override;
+
+      public: virtual ignition::common::ConnectionPtr ConnectNewNormalFrame(
+          std::function<void(const float *, unsigned int, unsigned int,
+          unsigned int, const std::string &)>  _subscriber) override;
+
+      public: virtual ignition::common::ConnectionPtr ConnectNewRawDepthFrame(
+          std::function<void(const unsigned char *, unsigned int,
+          unsigned int, unsigned int, const std::string &)>  _subscriber)
+          override;
     };
 
     //////////////////////////////////////////////////
@@ -94,6 +108,34 @@ namespace ignition
     {
       return nullptr;
     }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    ignition::common::ConnectionPtr BaseDepthCamera<T>::ConnectNewRgbFrame(
+          std::function<void(const unsigned char *, unsigned int,
+          unsigned int, unsigned int, const std::string &)>)
+    {
+      return nullptr;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    ignition::common::ConnectionPtr BaseDepthCamera<T>::ConnectNewNormalFrame(
+          std::function<void(const float *, unsigned int, unsigned int,
+          unsigned int, const std::string &)>)
+    {
+      return nullptr;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    ignition::common::ConnectionPtr
+        BaseDepthCamera<T>::ConnectNewRawDepthFrame(
+          std::function<void(const unsigned char *, unsigned int,
+          unsigned int, unsigned int, const std::string &)>)
+    {
+      return nullptr;
+    }
   }
   }
 }
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_BASE_BASEDROPOUTPASS_HH_
+#define IGNITION_RENDERING_BASE_BASEDROPOUTPASS_HH_
+
+#include <algorithm>
+
+#include "ignition/rendering/DropoutPass.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /* \class BaseDropoutPass BaseDropoutPass.hh \
+     * ignition/rendering/base/BaseDropoutPass.hh
+     */
+    /// \brief Base dropout render pass.
+    template <class T>
+    class BaseDropoutPass :
+      public virtual DropoutPass,
+      public virtual T
+    {
+      /// \brief Constructor
+      protected: BaseDropoutPass();
+
+      /// \brief Destructor
+      public: virtual ~BaseDropoutPass();
+
+      // Documentation inherited.
+      public: double Probability() const override;
+
+      // Documentation inherited.
+      public: void SetProbability(double _probability) override;
+
+      // Documentation inherited.
+      public: unsigned int Seed() const override;
+
+      // Documentation inherited.
+      public: void SetSeed(unsigned int _seed) override;
+
+      /// \brief Probability of a pixel to be dropped
+      protected: double probability = 0.0;
+
+      /// \brief Seed of the dropout, 0 if the dropout is not seeded
+      protected: unsigned int seed = 0u;
+    };
+
+    //////////////////////////////////////////////////
+    // BaseDropoutPass
+    //////////////////////////////////////////////////
+    template <class T>
+    BaseDropoutPass<T>::BaseDropoutPass()
+    {
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    BaseDropoutPass<T>::~BaseDropoutPass()
+    {
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseDropoutPass<T>::Probability() const
+    {
+      return this->probability;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseDropoutPass<T>::SetProbability(double _probability)
+    {
+      // also maps NaN to 0
+      this->probability = (_probability > 0.0) ?
+          std::min(_probability, 1.0) : 0.0;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    unsigned int BaseDropoutPass<T>::Seed() const
+    {
+      return this->seed;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseDropoutPass<T>::SetSeed(unsigned int _seed)
+    {
+      this->seed = _seed;
+    }
+    }
+  }
+}
+#endif
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_BASE_BASEFXAAPASS_HH_
+#define IGNITION_RENDERING_BASE_BASEFXAAPASS_HH_
+
+#include <algorithm>
+
+#include "ignition/rendering/FxaaPass.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /* \class BaseFxaaPass BaseFxaaPass.hh \
+     * ignition/rendering/base/BaseFxaaPass.hh
+     */
+    /// \brief Base FXAA render pass.
+    template <class T>
+    class BaseFxaaPass :
+      public virtual FxaaPass,
+      public virtual T
+    {
+      /// \brief Constructor
+      protected: BaseFxaaPass();
+
+      /// \brief Destructor
+      public: virtual ~BaseFxaaPass();
+
+      // Documentation inherited.
+      public: double SubpixelQuality() const override;
+
+      // Documentation inherited.
+      public: void SetSubpixelQuality(double _quality) override;
+
+      // Documentation inherited.
+      public: double EdgeThreshold() const override;
+
+      // Documentation inherited.
+      public: void SetEdgeThreshold(double _threshold) override;
+
+      // Documentation inherited.
+      public: double EdgeThresholdMin() const override;
+
+      // Documentation inherited.
+      public: void SetEdgeThresholdMin(double _threshold) override;
+
+      /// \brief Clamp a value to [0, 1], mapping NaN to 0
+      /// \param[in] _value Value
+      /// \return Clamped value
+      private: static double Clamp(double _value);
+
+      /// \brief Amount of sub-pixel aliasing removed
+      protected: double subpixelQuality = 0.75;
+
+      /// \brief Contrast of an edge relative to the brightest pixel
+      protected: double edgeThreshold = 0.166;
+
+      /// \brief Smallest contrast of an edge
+      protected: double edgeThresholdMin = 0.0833;
+    };
+
+    //////////////////////////////////////////////////
+    // BaseFxaaPass
+    //////////////////////////////////////////////////
+    template <class T>
+    BaseFxaaPass<T>::BaseFxaaPass()
+    {
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    BaseFxaaPass<T>::~BaseFxaaPass()
+    {
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseFxaaPass<T>::Clamp(double _value)
+    {
+      return (_value > 0.0) ? std::min(_value, 1.0) : 0.0;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseFxaaPass<T>::SubpixelQuality() const
+    {
+      return this->subpixelQuality;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseFxaaPass<T>::SetSubpixelQuality(double _quality)
+    {
+      this->subpixelQuality = Clamp(_quality);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseFxaaPass<T>::EdgeThreshold() const
+    {
+      return this->edgeThreshold;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseFxaaPass<T>::SetEdgeThreshold(double _threshold)
+    {
+      this->edgeThreshold = Clamp(_threshold);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseFxaaPass<T>::EdgeThresholdMin() const
+    {
+      return this->edgeThresholdMin;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseFxaaPass<T>::SetEdgeThresholdMin(double _threshold)
+    {
+      this->edgeThresholdMin = Clamp(_threshold);
+    }
+    }
+  }
+}
+#endif
@@ -64,6 +64,12 @@ namespace ignition
       // Documentation inherited.
       public: void SetBiasStdDev(double _biasStdDev);
 
+      // Documentation inherited.
+      public: unsigned int Seed() const;
+
+      // Documentation inherited.
+      public: void SetSeed(unsigned int _seed);
+
       // Sample the bias from bias mean and bias standard deviation
       protected: void SampleBias();
 
@@ -83,6 +89,9 @@ namespace ignition
       /// \brief The standard deviation of the Gaussian distribution from
       /// which bias values are drawn.
       protected: double biasStdDev = 0;
+
+      /// \brief Seed of the noise, 0 if the noise is not seeded
+      protected: unsigned int seed = 0u;
     };
 
     //////////////////////////////////////////////////
@@ -150,6 +159,20 @@ namespace ignition
       this->SampleBias();
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    unsigned int BaseGaussianNoisePass<T>::Seed() const
+    {
+      return this->seed;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseGaussianNoisePass<T>::SetSeed(unsigned int _seed)
+    {
+      this->seed = _seed;
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     void BaseGaussianNoisePass<T>::SampleBias()
@@ -18,6 +18,8 @@
 #define IGNITION_RENDERING_BASE_BASEGEOMETRY_HH_
 
 #include <string>
+#include <ignition/common/Console.hh>
+
 #include "ignition/rendering/Geometry.hh"
 #include "ignition/rendering/Scene.hh"
 
@@ -46,8 +48,25 @@ namespace ignition
       public: virtual void SetMaterial(MaterialPtr _material,
                   bool unique = true) override = 0;
 
+      // Documentation inherited
+      public: virtual void SetMaterialOverride(MaterialPtr _material)
+          override;
+
+      // Documentation inherited
+      public: virtual MaterialPtr MaterialOverride() const override;
+
+      // Documentation inherited
+      public: virtual GeometryPtr Clone(bool _shareMaterials = false) const
+          override;
+
       // Documentation inherited
       public: virtual void Destroy() override;
+
+      /// \brief Material set with SetMaterialOverride
+      protected: MaterialPtr materialOverride;
+
+      /// \brief Material the geometry had before the override was set
+      protected: MaterialPtr overriddenMaterial;
     };
 
     //////////////////////////////////////////////////
@@ -87,12 +106,52 @@ namespace ignition
       if (material) this->SetMaterial(material, _unique);
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseGeometry<T>::SetMaterialOverride(MaterialPtr _material)
+    {
+      if (_material == this->materialOverride)
+        return;
+
+      // the material is swapped without passing ownership, geometries that
+      // destroy the materials they own when replaced override this function
+      if (!this->materialOverride)
+        this->overriddenMaterial = this->Material();
+
+      if (_material)
+        this->SetMaterial(_material, false);
+      else if (this->overriddenMaterial)
+        this->SetMaterial(this->overriddenMaterial, false);
+
+      this->materialOverride = _material;
+      if (!_material)
+        this->overriddenMaterial.reset();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    MaterialPtr BaseGeometry<T>::MaterialOverride() const
+    {
+      return this->materialOverride;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    GeometryPtr BaseGeometry<T>::Clone(bool /*_shareMaterials*/) const
+    {
+      ignwarn << "Geometry [" << this->Name() << "] can not be cloned"
+              << std::endl;
+      return nullptr;
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     void BaseGeometry<T>::Destroy()
     {
       T::Destroy();
       this->RemoveParent();
+      this->materialOverride.reset();
+      this->overriddenMaterial.reset();
     }
     }
   }
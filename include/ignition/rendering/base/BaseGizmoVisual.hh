@@ -77,9 +77,17 @@ namespace ignition
       /// \brief Reset the gizmo visual state
       public: virtual void Reset();
 
-      /// \brief Create materials used by the gizmo visual
+      /// \brief Create materials used by the gizmo visual. The materials
+      /// are shared by all gizmo visuals in the scene.
       protected: void CreateMaterials();
 
+      /// \brief Create the visuals of the transform modes that contain any
+      /// of the given axes, if they have not been created yet. The new
+      /// visuals are hidden.
+      /// \param[in] _axes Bitmask of TransformAxis values. The origin keys
+      /// TA_TRANSLATION_Z << 1 and TA_ROTATION_Z << 1 are also accepted.
+      protected: void CreateModeVisuals(unsigned int _axes);
+
       /// \brief Create gizmo visual for translation
       protected: void CreateTranslationVisual();
 
@@ -152,10 +160,44 @@ namespace ignition
     {
       T::Init();
 
-      this->CreateMaterials();
-      this->CreateTranslationVisual();
-      this->CreateRotationVisual();
-      this->CreateScaleVisual();
+      // visuals of each mode are created when they are first needed
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseGizmoVisual<T>::CreateModeVisuals(unsigned int _axes)
+    {
+      const unsigned int translation = TransformMode::TM_TRANSLATION |
+          (TransformAxis::TA_TRANSLATION_Z << 1);
+      const unsigned int rotation =
+          TransformMode::TM_ROTATION | (TransformAxis::TA_ROTATION_Z << 1);
+      const unsigned int scale = TransformAxis::TA_SCALE_X |
+          TransformAxis::TA_SCALE_Y | TransformAxis::TA_SCALE_Z;
+
+      bool created = false;
+      if ((_axes & translation) &&
+          !this->visuals.count(TransformAxis::TA_TRANSLATION_X))
+      {
+        this->CreateMaterials();
+        this->CreateTranslationVisual();
+        created = true;
+      }
+      if ((_axes & rotation) &&
+          !this->visuals.count(TransformAxis::TA_ROTATION_X))
+      {
+        this->CreateMaterials();
+        this->CreateRotationVisual();
+        created = true;
+      }
+      if ((_axes & scale) && !this->visuals.count(TransformAxis::TA_SCALE_X))
+      {
+        this->CreateMaterials();
+        this->CreateScaleVisual();
+        created = true;
+      }
+
+      if (!created)
+        return;
 
       for (auto v : this->visuals)
         v.second->SetVisible(false);
@@ -165,45 +207,26 @@ namespace ignition
     template <class T>
     void BaseGizmoVisual<T>::Reset()
     {
-      this->visuals[TransformAxis::TA_TRANSLATION_X]->SetMaterial(
-          this->materials[AM_X], false);
-      this->visuals[TransformAxis::TA_TRANSLATION_Y]->SetMaterial(
-          this->materials[AM_Y], false);
-      this->visuals[TransformAxis::TA_TRANSLATION_Z]->SetMaterial(
-          this->materials[AM_Z], false);
-      this->visuals[TransformAxis::TA_ROTATION_X]->SetMaterial(
-          this->materials[AM_X], false);
-      this->visuals[TransformAxis::TA_ROTATION_Y]->SetMaterial(
-          this->materials[AM_Y], false);
-      this->visuals[TransformAxis::TA_ROTATION_Z]->SetMaterial(
-          this->materials[AM_Z], false);
-      this->visuals[TransformAxis::TA_SCALE_X]->SetMaterial(
-          this->materials[AM_X], false);
-      this->visuals[TransformAxis::TA_SCALE_Y]->SetMaterial(
-          this->materials[AM_Y], false);
-      this->visuals[TransformAxis::TA_SCALE_Z]->SetMaterial(
-          this->materials[AM_Z], false);
-
-      this->handles[TransformAxis::TA_TRANSLATION_X]->SetMaterial(
-          this->materials[AM_HANDLE], false);
-      this->handles[TransformAxis::TA_TRANSLATION_Y]->SetMaterial(
-          this->materials[AM_HANDLE], false);
-      this->handles[TransformAxis::TA_TRANSLATION_Z]->SetMaterial(
-          this->materials[AM_HANDLE], false);
-
-      this->handles[TransformAxis::TA_ROTATION_X]->SetMaterial(
-          this->materials[AM_HANDLE], false);
-      this->handles[TransformAxis::TA_ROTATION_Y]->SetMaterial(
-          this->materials[AM_HANDLE], false);
-      this->handles[TransformAxis::TA_ROTATION_Z]->SetMaterial(
-          this->materials[AM_HANDLE], false);
-
-      this->handles[TransformAxis::TA_SCALE_X]->SetMaterial(
-          this->materials[AM_HANDLE], false);
-      this->handles[TransformAxis::TA_SCALE_Y]->SetMaterial(
-          this->materials[AM_HANDLE], false);
-      this->handles[TransformAxis::TA_SCALE_Z]->SetMaterial(
-          this->materials[AM_HANDLE], false);
+      // only the visuals of modes that have been shown exist
+      for (auto v : this->visuals)
+      {
+        AxisMaterial matId;
+        if (v.first & (TransformAxis::TA_TRANSLATION_X |
+            TransformAxis::TA_ROTATION_X | TransformAxis::TA_SCALE_X))
+          matId = AM_X;
+        else if (v.first & (TransformAxis::TA_TRANSLATION_Y |
+            TransformAxis::TA_ROTATION_Y | TransformAxis::TA_SCALE_Y))
+          matId = AM_Y;
+        else if (v.first & (TransformAxis::TA_TRANSLATION_Z |
+            TransformAxis::TA_ROTATION_Z | TransformAxis::TA_SCALE_Z))
+          matId = AM_Z;
+        else
+          continue;
+        v.second->SetMaterial(this->materials[matId], false);
+      }
+
+      for (auto h : this->handles)
+        h.second->SetMaterial(this->materials[AM_HANDLE], false);
 
       for (auto v : this->visuals)
         v.second->SetVisible(false);
@@ -216,6 +239,7 @@ namespace ignition
       if (!this->modeDirty)
         return;
 
+      this->CreateModeVisuals(this->mode);
       this->Reset();
 
       if (this->mode == TransformMode::TM_NONE)
@@ -322,6 +346,7 @@ namespace ignition
       // clear active axis when mode changes
       this->axis = math::Vector3d::Zero;
       this->modeDirty = true;
+      this->MarkPreRenderDirty();
     }
 
     //////////////////////////////////////////////////
@@ -340,6 +365,7 @@ namespace ignition
 
       this->axis = _axis;
       this->modeDirty = true;
+      this->MarkPreRenderDirty();
     }
 
     //////////////////////////////////////////////////
@@ -368,21 +394,30 @@ namespace ignition
     template <class T>
     void BaseGizmoVisual<T>::CreateMaterials()
     {
-      MaterialPtr xMat = this->Scene()->Material("Default/TransRed")->Clone();
-      MaterialPtr yMat = this->Scene()->Material("Default/TransGreen")->Clone();
-      MaterialPtr zMat = this->Scene()->Material("Default/TransBlue")->Clone();
+      if (!this->materials.empty())
+        return;
+
+      // axis materials are overlay copies of the default transparent
+      // materials, created once per scene
+      auto overlayMaterial = [this](const std::string &_name,
+          const std::string &_source)
+      {
+        MaterialPtr mat = this->Scene()->Material(_name);
+        if (!mat)
+        {
+          mat = this->Scene()->Material(_source)->Clone(_name);
+          // disable depth checking and writing, make them overlays
+          mat->SetDepthWriteEnabled(false);
+          mat->SetDepthCheckEnabled(false);
+        }
+        return mat;
+      };
+
+      MaterialPtr xMat = overlayMaterial("GizmoRed", "Default/TransRed");
+      MaterialPtr yMat = overlayMaterial("GizmoGreen", "Default/TransGreen");
+      MaterialPtr zMat = overlayMaterial("GizmoBlue", "Default/TransBlue");
       MaterialPtr activeMat =
-          this->Scene()->Material("Default/TransYellow")->Clone();
-
-      // disable depth checking and writing, make them overlays
-      xMat->SetDepthWriteEnabled(false);
-      xMat->SetDepthCheckEnabled(false);
-      yMat->SetDepthWriteEnabled(false);
-      yMat->SetDepthCheckEnabled(false);
-      zMat->SetDepthWriteEnabled(false);
-      zMat->SetDepthCheckEnabled(false);
-      activeMat->SetDepthWriteEnabled(false);
-      activeMat->SetDepthCheckEnabled(false);
+          overlayMaterial("GizmoActive", "Default/TransYellow");
 
       MaterialPtr oMat = this->Scene()->Material("GizmoGray");
       if (!oMat)
@@ -712,6 +747,10 @@ namespace ignition
     template <class T>
     VisualPtr BaseGizmoVisual<T>::ChildByAxis(unsigned int _axis) const
     {
+      // the visuals of a mode are created on first use, also when they are
+      // only queried
+      const_cast<BaseGizmoVisual<T> *>(this)->CreateModeVisuals(_axis);
+
       auto it = this->visuals.find(_axis);
       if (it != this->visuals.end())
         return it->second;
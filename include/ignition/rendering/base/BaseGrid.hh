@@ -106,6 +106,7 @@ namespace ignition
     {
       this->cellCount = _count;
       this->gridDirty = true;
+      this->MarkPreRenderDirty();
     }
 
     //////////////////////////////////////////////////
@@ -121,6 +122,7 @@ namespace ignition
     {
       this->cellLength = _len;
       this->gridDirty = true;
+      this->MarkPreRenderDirty();
     }
 
     //////////////////////////////////////////////////
@@ -136,6 +138,7 @@ namespace ignition
     {
       this->verticalCellCount = _count;
       this->gridDirty = true;
+      this->MarkPreRenderDirty();
     }
 
     //////////////////////////////////////////////////
@@ -59,6 +59,10 @@ namespace ignition
                             const std::vector<ignition::math::Color> &_colors)
                             override;
 
+      // Documentation inherited
+      public: virtual void SetPoints(const float *_data, unsigned int _count,
+                            unsigned int _channels = 1u) override;
+
       // Documentation inherited
       public: virtual void Update() override;
 
@@ -260,6 +264,17 @@ namespace ignition
       // no op
     }
 
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseLidarVisual<T>::SetPoints(const float *_data,
+                                unsigned int _count, unsigned int _channels)
+    {
+      std::vector<double> points(_count);
+      for (unsigned int i = 0; i < _count; ++i)
+        points[i] = _data[i * _channels];
+      this->SetPoints(points);
+    }
+
     /////////////////////////////////////////////////
     template <class T>
     void BaseLidarVisual<T>::Init()
@@ -54,7 +54,16 @@ namespace ignition
 
       public: virtual void SetCastShadows(bool _castShadows) = 0;
 
+      // Documentation inherited.
+      public: virtual void SetStatic(bool _static) override;
+
+      // Documentation inherited.
+      public: virtual bool Static() const override;
+
       protected: virtual void Reset();
+
+      /// \brief True if the light is static
+      protected: bool isStatic = false;
     };
 
     template <class T>
@@ -137,6 +146,20 @@ namespace ignition
       this->SetSpecularColor(math::Color(_r, _g, _b, _a));
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseLight<T>::SetStatic(bool _static)
+    {
+      this->isStatic = _static;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseLight<T>::Static() const
+    {
+      return this->isStatic;
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     void BaseLight<T>::Reset()
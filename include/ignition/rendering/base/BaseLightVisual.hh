@@ -114,6 +114,7 @@ namespace ignition
     {
       this->type = _type;
       this->dirtyLightVisual = true;
+      this->MarkPreRenderDirty();
     }
 
     //////////////////////////////////////////////////
@@ -129,6 +130,7 @@ namespace ignition
     {
       this->innerAngle = _innerAngle;
       this->dirtyLightVisual = true;
+      this->MarkPreRenderDirty();
     }
 
     //////////////////////////////////////////////////
@@ -144,6 +146,7 @@ namespace ignition
     {
       this->outerAngle = _outerAngle;
       this->dirtyLightVisual = true;
+      this->MarkPreRenderDirty();
     }
 
     //////////////////////////////////////////////////
@@ -82,6 +82,10 @@ namespace ignition
       public: virtual void SetPoint(unsigned int _index,
                   const ignition::math::Vector3d &_value) override;
 
+      // Documentation inherited
+      public: virtual void SetPoints(const float *_xyz, size_t _count,
+                  const float *_rgba = nullptr) override;
+
       /// \brief Life time of a marker
       IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
       protected: std::chrono::steady_clock::duration lifetime =
@@ -120,6 +124,7 @@ namespace ignition
     {
       this->lifetime = _lifetime;
       this->markerDirty = true;
+      this->MarkPreRenderDirty();
     }
 
     /////////////////////////////////////////////////
@@ -135,6 +140,7 @@ namespace ignition
     {
       this->layer = _layer;
       this->markerDirty = true;
+      this->MarkPreRenderDirty();
     }
 
     /////////////////////////////////////////////////
@@ -150,6 +156,7 @@ namespace ignition
     {
       this->markerType = _markerType;
       this->markerDirty = true;
+      this->MarkPreRenderDirty();
     }
 
     /////////////////////////////////////////////////
@@ -203,6 +210,24 @@ namespace ignition
     {
       // no op
     }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseMarker<T>::SetPoints(const float *_xyz, size_t _count,
+                  const float *_rgba)
+    {
+      this->ClearPoints();
+      for (size_t i = 0; i < _count; ++i)
+      {
+        ignition::math::Color color = ignition::math::Color::White;
+        if (_rgba)
+        {
+          color.Set(_rgba[i * 4], _rgba[i * 4 + 1], _rgba[i * 4 + 2],
+              _rgba[i * 4 + 3]);
+        }
+        this->AddPoint(_xyz[i * 3], _xyz[i * 3 + 1], _xyz[i * 3 + 2], color);
+      }
+    }
     }
   }
 }
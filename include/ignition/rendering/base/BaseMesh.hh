@@ -20,10 +20,12 @@
 #include <map>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include "ignition/rendering/Mesh.hh"
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/Storage.hh"
 #include "ignition/rendering/base/BaseObject.hh"
+#include "ignition/rendering/base/BaseScene.hh"
 
 namespace ignition
 {
@@ -52,6 +54,17 @@ namespace ignition
       public: virtual void SetSkeletonLocalTransforms(
                       const std::map<std::string, math::Matrix4d> &) override;
 
+      // Documentation inherited.
+      public: virtual std::vector<std::string> SkeletonBoneNames() const
+            override;
+
+      // Documentation inherited.
+      public: virtual unsigned int SkeletonBoneCount() const override;
+
+      // Documentation inherited.
+      public: virtual void SetSkeletonBoneTransforms(
+            const math::Matrix4f *_tfs, unsigned int _count) override;
+
       // Documentation inherited.
       public: virtual std::unordered_map<std::string, float> SkeletonWeights()
                       const override;
@@ -94,6 +107,21 @@ namespace ignition
       public: virtual void SetMaterial(MaterialPtr _material,
                   bool _unique = true) override;
 
+      // Documentation inherited.
+      public: virtual void SetMaterialOverride(MaterialPtr _material)
+                  override;
+
+      // Documentation inherited.
+      public: virtual const MeshDescriptor &Descriptor() const override;
+
+      // Documentation inherited.
+      public: virtual void SetDescriptor(const MeshDescriptor &_desc)
+                  override;
+
+      // Documentation inherited.
+      public: virtual GeometryPtr Clone(bool _shareMaterials = false) const
+                  override;
+
       public: virtual void PreRender() override;
 
       // Documentation inherited
@@ -107,6 +135,9 @@ namespace ignition
 
       /// \brief Pointer to currently assigned material
       protected: MaterialPtr material;
+
+      /// \brief Descriptor the mesh was created from
+      protected: MeshDescriptor meshDescriptor;
     };
 
     //////////////////////////////////////////////////
@@ -134,6 +165,13 @@ namespace ignition
       /// \param[in] _material New Material to be assigned
       public: virtual void SetMaterialImpl(MaterialPtr _material) = 0;
 
+      // Documentation inherited
+      public: virtual void SetMaterialOverride(MaterialPtr _material)
+                  override;
+
+      // Documentation inherited
+      public: virtual MaterialPtr MaterialOverride() const override;
+
       public: virtual void PreRender() override;
 
       // Documentation inherited
@@ -145,6 +183,9 @@ namespace ignition
 
       /// \brief Pointer to currently assigned material
       protected: MaterialPtr material;
+
+      /// \brief Material rendered instead of the assigned material
+      protected: MaterialPtr materialOverride;
     };
 
     //////////////////////////////////////////////////
@@ -184,6 +225,27 @@ namespace ignition
     {
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    std::vector<std::string> BaseMesh<T>::SkeletonBoneNames() const
+    {
+      return std::vector<std::string>();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    unsigned int BaseMesh<T>::SkeletonBoneCount() const
+    {
+      return 0u;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseMesh<T>::SetSkeletonBoneTransforms(const math::Matrix4f *,
+          unsigned int)
+    {
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     std::unordered_map<std::string, float> BaseMesh<T>::SkeletonWeights() const
@@ -294,6 +356,52 @@ namespace ignition
 
       this->ownsMaterial = _unique;
       this->material = _material;
+      this->MarkPreRenderDirty();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseMesh<T>::SetMaterialOverride(MaterialPtr _material)
+    {
+      if (_material == this->materialOverride)
+        return;
+
+      // the submeshes keep their materials, nothing is cloned or destroyed
+      unsigned int count = this->SubMeshCount();
+      for (unsigned int i = 0; i < count; ++i)
+      {
+        SubMeshPtr subMesh = this->SubMeshByIndex(i);
+        subMesh->SetMaterialOverride(_material);
+      }
+      this->materialOverride = _material;
+      this->MarkPreRenderDirty();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    const MeshDescriptor &BaseMesh<T>::Descriptor() const
+    {
+      return this->meshDescriptor;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseMesh<T>::SetDescriptor(const MeshDescriptor &_desc)
+    {
+      this->meshDescriptor = _desc;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    GeometryPtr BaseMesh<T>::Clone(bool _shareMaterials) const
+    {
+      auto baseScene = std::dynamic_pointer_cast<BaseScene>(this->Scene());
+      if (!baseScene)
+      {
+        ignerr << "Cast failed in BaseMesh::Clone" << std::endl;
+        return nullptr;
+      }
+      return baseScene->CloneMesh(*this, _shareMaterials);
     }
 
     //////////////////////////////////////////////////
@@ -344,6 +452,7 @@ namespace ignition
       if (this->material && this->ownsMaterial)
         this->Scene()->DestroyMaterial(this->material);
       this->material.reset();
+      this->materialOverride.reset();
     }
 
 
@@ -364,7 +473,9 @@ namespace ignition
       MaterialPtr origMaterial = this->material;
       bool origUnique = this->ownsMaterial;
 
-      this->SetMaterialImpl(_material);
+      // the override stays in effect until it is cleared
+      if (!this->materialOverride)
+        this->SetMaterialImpl(_material);
 
       if (origMaterial && origUnique)
         this->Scene()->DestroyMaterial(origMaterial);
@@ -380,12 +491,34 @@ namespace ignition
       return this->material;
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseSubMesh<T>::SetMaterialOverride(MaterialPtr _material)
+    {
+      if (_material == this->materialOverride)
+        return;
+
+      this->materialOverride = _material;
+      MaterialPtr mat = (_material) ? _material : this->material;
+      if (mat)
+        this->SetMaterialImpl(mat);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    MaterialPtr BaseSubMesh<T>::MaterialOverride() const
+    {
+      return this->materialOverride;
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     void BaseSubMesh<T>::PreRender()
     {
       T::PreRender();
-      if (this->Material())
+      if (this->materialOverride)
+        this->materialOverride->PreRender();
+      else if (this->Material())
         this->Material()->PreRender();
     }
     }
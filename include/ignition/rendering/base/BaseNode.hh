@@ -17,9 +17,11 @@
 #ifndef IGNITION_RENDERING_BASE_BASENODE_HH_
 #define IGNITION_RENDERING_BASE_BASENODE_HH_
 
+#include <functional>
 #include <string>
 #include "ignition/rendering/Node.hh"
 #include "ignition/rendering/Storage.hh"
+#include "ignition/rendering/base/BaseObject.hh"
 #include "ignition/rendering/base/BaseStorage.hh"
 
 namespace ignition
@@ -153,6 +155,9 @@ namespace ignition
 
       public: virtual NodePtr ChildByIndex(unsigned int _index) const override;
 
+      public: virtual void ForEachChild(
+                  const std::function<void(Node &)> &_func) const override;
+
       public: virtual void AddChild(NodePtr _child) override;
 
       public: virtual NodePtr RemoveChild(NodePtr _child) override;
@@ -168,6 +173,12 @@ namespace ignition
 
       public: virtual void PreRender() override;
 
+      /// \brief Mark the cached world pose of this node and of all its
+      /// descendants as out of date. This is done automatically when the
+      /// node is moved or reparented, and only needs to be called after
+      /// modifying the pose of the underlying render engine node directly.
+      public: void InvalidateWorldPose();
+
       protected: virtual void PreRenderChildren();
 
       protected: virtual math::Pose3d RawLocalPose() const = 0;
@@ -186,6 +197,13 @@ namespace ignition
                      const math::Vector3d &_scale) = 0;
 
       protected: math::Vector3d origin;
+
+      /// \brief Cached world pose, valid if worldPoseDirty is false
+      protected: mutable math::Pose3d worldPose;
+
+      /// \brief True if the cached world pose is out of date. If a node is
+      /// dirty then all of its descendants are dirty too.
+      protected: mutable bool worldPoseDirty = true;
     };
 
     //////////////////////////////////////////////////
@@ -228,6 +246,12 @@ namespace ignition
       if (this->AttachChild(_child))
       {
         this->Children()->Add(_child);
+        auto child = dynamic_cast<BaseNode<T> *>(_child.get());
+        if (child)
+        {
+          child->InvalidateWorldPose();
+          child->MarkPreRenderDirty(true);
+        }
       }
     }
 
@@ -237,6 +261,9 @@ namespace ignition
     {
       NodePtr child = this->Children()->Remove(_child);
       if (child) this->DetachChild(child);
+      auto baseChild = dynamic_cast<BaseNode<T> *>(child.get());
+      if (baseChild) baseChild->InvalidateWorldPose();
+      if (child) this->MarkPreRenderDirty();
       return child;
     }
 
@@ -246,6 +273,9 @@ namespace ignition
     {
       NodePtr child = this->Children()->RemoveById(_id);
       if (child) this->DetachChild(child);
+      auto baseChild = dynamic_cast<BaseNode<T> *>(child.get());
+      if (baseChild) baseChild->InvalidateWorldPose();
+      if (child) this->MarkPreRenderDirty();
       return child;
     }
 
@@ -255,6 +285,9 @@ namespace ignition
     {
       NodePtr child = this->Children()->RemoveByName(_name);
       if (child) this->DetachChild(child);
+      auto baseChild = dynamic_cast<BaseNode<T> *>(child.get());
+      if (baseChild) baseChild->InvalidateWorldPose();
+      if (child) this->MarkPreRenderDirty();
       return child;
     }
 
@@ -264,6 +297,9 @@ namespace ignition
     {
       NodePtr child = this->Children()->RemoveByIndex(_index);
       if (child) this->DetachChild(child);
+      auto baseChild = dynamic_cast<BaseNode<T> *>(child.get());
+      if (baseChild) baseChild->InvalidateWorldPose();
+      if (child) this->MarkPreRenderDirty();
       return child;
     }
 
@@ -285,10 +321,36 @@ namespace ignition
       this->PreRenderChildren();
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseNode<T>::InvalidateWorldPose()
+    {
+      // descendants of a dirty node are already dirty
+      if (this->worldPoseDirty)
+        return;
+
+      this->worldPoseDirty = true;
+
+      NodeStorePtr children = this->Children();
+      if (!children)
+        return;
+
+      for (unsigned int i = 0; i < children->Size(); ++i)
+      {
+        auto child = dynamic_cast<BaseNode<T> *>(children->GetByIndex(i).get());
+        if (child)
+          child->InvalidateWorldPose();
+      }
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     void BaseNode<T>::PreRenderChildren()
     {
+      // the scene traverses the children itself
+      if (BaseObject::ShallowPreRender())
+        return;
+
       unsigned int count = this->ChildCount();
 
       for (unsigned int i = 0; i < count; ++i)
@@ -321,6 +383,8 @@ namespace ignition
       }
 
       this->SetRawLocalPose(pose);
+      this->InvalidateWorldPose();
+      this->MarkPreRenderDirty();
     }
 
     //////////////////////////////////////////////////
@@ -381,15 +445,18 @@ namespace ignition
     template <class T>
     math::Pose3d BaseNode<T>::WorldPose() const
     {
+      if (!this->worldPoseDirty)
+        return this->worldPose;
+
       NodePtr parent = this->Parent();
       math::Pose3d pose = this->LocalPose();
 
-      if (!parent)
-      {
-        return pose;
-      }
+      if (parent)
+        pose = pose + parent->WorldPose();
 
-      return pose + parent->WorldPose();
+      this->worldPose = pose;
+      this->worldPoseDirty = false;
+      return pose;
     }
 
     //////////////////////////////////////////////////
@@ -487,6 +554,8 @@ namespace ignition
     void BaseNode<T>::SetOrigin(const math::Vector3d &_origin)
     {
       this->origin = _origin;
+      this->InvalidateWorldPose();
+      this->MarkPreRenderDirty();
     }
 
     //////////////////////////////////////////////////
@@ -630,6 +699,14 @@ namespace ignition
     {
       return this->Children()->GetByIndex(_index);
     }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseNode<T>::ForEachChild(
+        const std::function<void(Node &)> &_func) const
+    {
+      this->Children()->ForEach(_func);
+    }
     }
   }
 }
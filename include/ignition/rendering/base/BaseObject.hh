@@ -51,6 +51,26 @@ namespace ignition
       // Documentation inherited.
       public: virtual void Destroy() override;
 
+      /// \brief Check if the objects pre-rendered by this thread must only
+      /// prepare themselves, without their child nodes and geometries. This
+      /// is the case while a scene commits a parallel traversal, since the
+      /// scene has already collected them.
+      /// \return True to skip the child nodes and geometries in PreRender
+      /// \sa Scene::SetPreRenderThreadCount
+      public: static bool ShallowPreRender();
+
+      /// \brief Set whether the objects pre-rendered by this thread skip
+      /// their child nodes and geometries
+      /// \param[in] _shallow True to skip the child nodes and geometries
+      public: static void SetShallowPreRender(bool _shallow);
+
+      /// \brief Flag this object to be prepared by the next incremental
+      /// PreRender of its scene, after a change that PreRender must apply
+      /// \param[in] _subtree True to also prepare its child nodes and
+      /// geometries
+      /// \sa Scene::SetIncrementalPreRender
+      protected: void MarkPreRenderDirty(bool _subtree = false);
+
       // TODO(anyone): make pure virtual
       protected: virtual void Load();
 
@@ -0,0 +1,364 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_RENDERING_BASEPOINTCLOUDVISUAL_HH_
+#define IGNITION_RENDERING_BASEPOINTCLOUDVISUAL_HH_
+
+#include <algorithm>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/math/Helpers.hh>
+
+#include "ignition/rendering/PointCloudVisual.hh"
+#include "ignition/rendering/base/BaseObject.hh"
+#include "ignition/rendering/base/BaseRenderTypes.hh"
+#include "ignition/rendering/Scene.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    /// \brief Base implementation of a point cloud visual. Keeps the points
+    /// in single precision and tracks which chunks changed since they were
+    /// last uploaded.
+    template <class T>
+    class BasePointCloudVisual :
+      public virtual PointCloudVisual,
+      public virtual T
+    {
+      // Documentation inherited
+      protected: BasePointCloudVisual();
+
+      // Documentation inherited
+      public: virtual ~BasePointCloudVisual();
+
+      // Documentation inherited
+      public: virtual void PreRender() override;
+
+      // Documentation inherited
+      public: virtual void SetPoints(const void *_data, unsigned int _count,
+                  PointCloudFormat _format = PCF_XYZ_FLOAT32,
+                  unsigned int _stride = 0u) override;
+
+      // Documentation inherited
+      public: virtual void UpdatePoints(unsigned int _offset,
+                  const void *_data, unsigned int _count,
+                  PointCloudFormat _format = PCF_XYZ_FLOAT32,
+                  unsigned int _stride = 0u) override;
+
+      // Documentation inherited
+      public: virtual void ClearPoints() override;
+
+      // Documentation inherited
+      public: virtual unsigned int PointCount() const override;
+
+      // Documentation inherited
+      public: virtual math::Vector3d Point(unsigned int _index) const
+                  override;
+
+      // Documentation inherited
+      public: virtual void SetChunkSize(unsigned int _size) override;
+
+      // Documentation inherited
+      public: virtual unsigned int ChunkSize() const override;
+
+      // Documentation inherited
+      public: virtual unsigned int ChunkCount() const override;
+
+      // Documentation inherited
+      public: virtual unsigned int PendingChunkCount() const override;
+
+      // Documentation inherited
+      public: virtual void SetUploadBudget(unsigned int _points) override;
+
+      // Documentation inherited
+      public: virtual unsigned int UploadBudget() const override;
+
+      // Documentation inherited
+      public: virtual void SetLodLevels(unsigned int _levels) override;
+
+      // Documentation inherited
+      public: virtual unsigned int LodLevels() const override;
+
+      // Documentation inherited
+      public: virtual void SetPointSpacing(double _spacing) override;
+
+      // Documentation inherited
+      public: virtual double PointSpacing() const override;
+
+      // Documentation inherited
+      public: virtual void Update() override;
+
+      /// \brief Mark a range of chunks as changed
+      /// \param[in] _first Index of the first chunk
+      /// \param[in] _last Index of the last chunk
+      protected: void MarkChunksDirty(unsigned int _first,
+                     unsigned int _last);
+
+      /// \brief Mark all the chunks as changed
+      protected: void MarkAllChunksDirty();
+
+      /// \brief Points of the cloud, 3 floats per point
+      protected: std::vector<float> points;
+
+      /// \brief True for each chunk that changed since it was last uploaded
+      protected: std::vector<bool> dirtyChunks;
+
+      /// \brief Number of points per chunk, a power of two
+      protected: unsigned int chunkSize = 65536u;
+
+      /// \brief Number of points uploaded per frame
+      protected: unsigned int uploadBudget = 1048576u;
+
+      /// \brief Number of levels of detail in addition to the full
+      /// resolution
+      protected: unsigned int lodLevels = 4u;
+
+      /// \brief Smallest spacing between points on screen, as a share of
+      /// the screen height
+      protected: double pointSpacing = 0.002;
+    };
+
+    /////////////////////////////////////////////////
+    // BasePointCloudVisual
+    /////////////////////////////////////////////////
+    template <class T>
+    BasePointCloudVisual<T>::BasePointCloudVisual()
+    {
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    BasePointCloudVisual<T>::~BasePointCloudVisual()
+    {
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BasePointCloudVisual<T>::PreRender()
+    {
+      T::PreRender();
+      this->Update();
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BasePointCloudVisual<T>::SetPoints(const void *_data,
+        unsigned int _count, PointCloudFormat _format, unsigned int _stride)
+    {
+      std::vector<float> decoded(static_cast<size_t>(_count) * 3u);
+      if (!PointCloudVisual::DecodePoints(_data, _count, _format, _stride,
+          decoded.data()))
+      {
+        ignerr << "Invalid point cloud data" << std::endl;
+        return;
+      }
+
+      this->points.swap(decoded);
+      this->MarkAllChunksDirty();
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BasePointCloudVisual<T>::UpdatePoints(unsigned int _offset,
+        const void *_data, unsigned int _count, PointCloudFormat _format,
+        unsigned int _stride)
+    {
+      unsigned int pointCount = this->PointCount();
+      if (_offset > pointCount)
+      {
+        ignerr << "Point offset [" << _offset << "] is beyond the end of "
+               << "the cloud [" << pointCount << "]" << std::endl;
+        return;
+      }
+
+      if (_count == 0u)
+        return;
+
+      size_t end = static_cast<size_t>(_offset) + _count;
+      if (end > pointCount)
+        this->points.resize(end * 3u);
+
+      if (!PointCloudVisual::DecodePoints(_data, _count, _format, _stride,
+          this->points.data() + static_cast<size_t>(_offset) * 3u))
+      {
+        ignerr << "Invalid point cloud data" << std::endl;
+        this->points.resize(static_cast<size_t>(pointCount) * 3u);
+        return;
+      }
+
+      this->dirtyChunks.resize(this->ChunkCount(), false);
+      this->MarkChunksDirty(_offset / this->chunkSize,
+          static_cast<unsigned int>((end - 1u) / this->chunkSize));
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BasePointCloudVisual<T>::ClearPoints()
+    {
+      this->points.clear();
+      this->dirtyChunks.clear();
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    unsigned int BasePointCloudVisual<T>::PointCount() const
+    {
+      return static_cast<unsigned int>(this->points.size() / 3u);
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    math::Vector3d BasePointCloudVisual<T>::Point(unsigned int _index) const
+    {
+      if (_index >= this->PointCount())
+      {
+        ignerr << "Point index [" << _index << "] out of range ["
+               << this->PointCount() << "]" << std::endl;
+        return math::Vector3d(math::INF_D, math::INF_D, math::INF_D);
+      }
+
+      const float *p = this->points.data() + static_cast<size_t>(_index) * 3u;
+      return math::Vector3d(p[0], p[1], p[2]);
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BasePointCloudVisual<T>::SetChunkSize(unsigned int _size)
+    {
+      unsigned int size = 256u;
+      while (size < _size && size < (1u << 31))
+        size <<= 1;
+
+      if (size == this->chunkSize)
+        return;
+
+      this->chunkSize = size;
+      this->MarkAllChunksDirty();
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    unsigned int BasePointCloudVisual<T>::ChunkSize() const
+    {
+      return this->chunkSize;
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    unsigned int BasePointCloudVisual<T>::ChunkCount() const
+    {
+      return (this->PointCount() + this->chunkSize - 1u) / this->chunkSize;
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    unsigned int BasePointCloudVisual<T>::PendingChunkCount() const
+    {
+      return static_cast<unsigned int>(std::count(this->dirtyChunks.begin(),
+          this->dirtyChunks.end(), true));
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BasePointCloudVisual<T>::SetUploadBudget(unsigned int _points)
+    {
+      this->uploadBudget = _points;
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    unsigned int BasePointCloudVisual<T>::UploadBudget() const
+    {
+      return this->uploadBudget;
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BasePointCloudVisual<T>::SetLodLevels(unsigned int _levels)
+    {
+      if (_levels == this->lodLevels)
+        return;
+
+      this->lodLevels = _levels;
+      this->MarkAllChunksDirty();
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    unsigned int BasePointCloudVisual<T>::LodLevels() const
+    {
+      return this->lodLevels;
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BasePointCloudVisual<T>::SetPointSpacing(double _spacing)
+    {
+      if (_spacing <= 0.0)
+      {
+        ignerr << "Point spacing must be positive" << std::endl;
+        return;
+      }
+
+      if (math::equal(_spacing, this->pointSpacing))
+        return;
+
+      this->pointSpacing = _spacing;
+      this->MarkAllChunksDirty();
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    double BasePointCloudVisual<T>::PointSpacing() const
+    {
+      return this->pointSpacing;
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BasePointCloudVisual<T>::Update()
+    {
+      // render engines upload the chunks, nothing to upload to here
+      this->dirtyChunks.assign(this->dirtyChunks.size(), false);
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BasePointCloudVisual<T>::MarkChunksDirty(unsigned int _first,
+        unsigned int _last)
+    {
+      for (unsigned int i = _first; i <= _last && i < this->dirtyChunks.size();
+          ++i)
+      {
+        this->dirtyChunks[i] = true;
+      }
+      this->MarkPreRenderDirty();
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BasePointCloudVisual<T>::MarkAllChunksDirty()
+    {
+      this->dirtyChunks.assign(this->ChunkCount(), true);
+      this->MarkPreRenderDirty();
+    }
+    }
+  }
+}
+#endif
@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_BASE_BASEPOSEARRAYVISUAL_HH_
+#define IGNITION_RENDERING_BASE_BASEPOSEARRAYVISUAL_HH_
+
+#include <vector>
+
+#include <ignition/math/Helpers.hh>
+
+#include "ignition/rendering/Marker.hh"
+#include "ignition/rendering/PoseArrayVisual.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/base/BaseObject.hh"
+#include "ignition/rendering/base/BaseRenderTypes.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    /// \brief Base implementation of a pose array visual. The arrows of
+    /// each axis are merged into one triangle list marker, rebuilt in
+    /// PreRender when the poses change.
+    template <class T>
+    class BasePoseArrayVisual :
+      public virtual PoseArrayVisual,
+      public virtual T
+    {
+      /// \brief Constructor
+      protected: BasePoseArrayVisual();
+
+      /// \brief Destructor
+      public: virtual ~BasePoseArrayVisual();
+
+      // Documentation inherited.
+      protected: virtual void Init() override;
+
+      // Documentation inherited.
+      public: virtual void PreRender() override;
+
+      // Documentation inherited.
+      public: virtual void SetPoses(const std::vector<math::Pose3d> &_poses)
+                  override;
+
+      // Documentation inherited.
+      public: virtual const std::vector<math::Pose3d> &Poses() const
+                  override;
+
+      // Documentation inherited.
+      public: virtual void SetAxisLength(double _length) override;
+
+      // Documentation inherited.
+      public: virtual double AxisLength() const override;
+
+      // Documentation inherited.
+      public: virtual void SetArrowsOnly(bool _arrowsOnly) override;
+
+      // Documentation inherited.
+      public: virtual bool ArrowsOnly() const override;
+
+      /// \brief Flag the arrows to be rebuilt in the next PreRender
+      protected: void MarkArrowsDirty();
+
+      /// \brief Rebuild the markers from the poses
+      protected: void UpdateArrows();
+
+      /// \brief Poses drawn
+      protected: std::vector<math::Pose3d> poses;
+
+      /// \brief Length of the arrows
+      protected: double axisLength = 1.0;
+
+      /// \brief True to only draw the x axis
+      protected: bool arrowsOnly = false;
+
+      /// \brief True if the arrows have to be rebuilt
+      protected: bool arrowsDirty = false;
+
+      /// \brief One triangle list marker per axis: x, y and z
+      protected: MarkerPtr axes[3];
+
+      /// \brief Vertices of the arrows of an axis, reused between updates
+      protected: std::vector<float> vertices;
+    };
+
+    /////////////////////////////////////////////////
+    // BasePoseArrayVisual
+    /////////////////////////////////////////////////
+    template <class T>
+    BasePoseArrayVisual<T>::BasePoseArrayVisual()
+    {
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    BasePoseArrayVisual<T>::~BasePoseArrayVisual()
+    {
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BasePoseArrayVisual<T>::Init()
+    {
+      T::Init();
+
+      const char *materials[3] =
+          {"Default/TransRed", "Default/TransGreen", "Default/TransBlue"};
+      for (unsigned int i = 0; i < 3u; ++i)
+      {
+        MarkerPtr marker = this->Scene()->CreateMarker();
+        if (!marker)
+          continue;
+        marker->SetType(MT_TRIANGLE_LIST);
+        this->AddGeometry(marker);
+        marker->SetMaterial(materials[i]);
+        this->axes[i] = marker;
+      }
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BasePoseArrayVisual<T>::PreRender()
+    {
+      // the markers are rebuilt before they are prepared by the visual
+      if (this->arrowsDirty)
+        this->UpdateArrows();
+
+      T::PreRender();
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BasePoseArrayVisual<T>::UpdateArrows()
+    {
+      this->arrowsDirty = false;
+
+      // rotations of the arrows, which point along z, to each axis
+      const math::Quaterniond rotations[3] = {
+          math::Quaterniond(0, IGN_PI / 2, 0),
+          math::Quaterniond(-IGN_PI / 2, 0, 0),
+          math::Quaterniond::Identity};
+
+      for (unsigned int i = 0; i < 3u; ++i)
+      {
+        if (!this->axes[i])
+          continue;
+        if (i > 0u && this->arrowsOnly)
+        {
+          this->axes[i]->ClearPoints();
+          continue;
+        }
+
+        this->vertices.clear();
+        for (const auto &pose : this->poses)
+        {
+          math::Pose3d arrowPose(pose.Pos(), pose.Rot() * rotations[i]);
+          PoseArrayVisual::AppendArrow(arrowPose, this->axisLength,
+              this->vertices);
+        }
+        this->axes[i]->SetPoints(this->vertices.data(),
+            this->vertices.size() / 3u);
+      }
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BasePoseArrayVisual<T>::SetPoses(
+        const std::vector<math::Pose3d> &_poses)
+    {
+      this->poses = _poses;
+      this->MarkArrowsDirty();
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    const std::vector<math::Pose3d> &BasePoseArrayVisual<T>::Poses() const
+    {
+      return this->poses;
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BasePoseArrayVisual<T>::SetAxisLength(double _length)
+    {
+      if (math::equal(_length, this->axisLength))
+        return;
+      this->axisLength = _length;
+      this->MarkArrowsDirty();
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    double BasePoseArrayVisual<T>::AxisLength() const
+    {
+      return this->axisLength;
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BasePoseArrayVisual<T>::SetArrowsOnly(bool _arrowsOnly)
+    {
+      if (_arrowsOnly == this->arrowsOnly)
+        return;
+      this->arrowsOnly = _arrowsOnly;
+      this->MarkArrowsDirty();
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    bool BasePoseArrayVisual<T>::ArrowsOnly() const
+    {
+      return this->arrowsOnly;
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BasePoseArrayVisual<T>::MarkArrowsDirty()
+    {
+      this->arrowsDirty = true;
+      this->MarkPreRenderDirty();
+    }
+    }
+  }
+}
+#endif
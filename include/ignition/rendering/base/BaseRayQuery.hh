@@ -17,6 +17,9 @@
 #ifndef IGNITION_RENDERING_BASE_BASERAYQUERY_HH_
 #define IGNITION_RENDERING_BASE_BASERAYQUERY_HH_
 
+#include <vector>
+
+#include <ignition/common/Console.hh>
 #include <ignition/math/Matrix4.hh>
 #include <ignition/math/Vector3.hh>
 
@@ -62,6 +65,19 @@ namespace ignition
       // Documentation inherited
       public: virtual RayQueryResult ClosestPoint() override;
 
+      // Documentation inherited
+      public: virtual std::vector<RayQueryResult> ClosestPoints(
+                const std::vector<math::Vector3d> &_origins,
+                const std::vector<math::Vector3d> &_directions) override;
+
+      /// \brief Check that a batch of rays has one direction for each
+      /// origin, printing an error if not
+      /// \param[in] _origins Ray origins
+      /// \param[in] _directions Ray directions
+      /// \return True if the batch is valid
+      protected: bool ValidateRays(const std::vector<math::Vector3d> &_origins,
+                const std::vector<math::Vector3d> &_directions) const;
+
       /// \brief Ray origin
       protected: math::Vector3d origin;
 
@@ -149,6 +165,47 @@ namespace ignition
       result.distance = -1;
       return result;
     }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    std::vector<RayQueryResult> BaseRayQuery<T>::ClosestPoints(
+        const std::vector<math::Vector3d> &_origins,
+        const std::vector<math::Vector3d> &_directions)
+    {
+      std::vector<RayQueryResult> results;
+      if (!this->ValidateRays(_origins, _directions))
+        return results;
+
+      // generic implementation, one query per ray
+      math::Vector3d savedOrigin = this->origin;
+      math::Vector3d savedDirection = this->direction;
+      results.reserve(_origins.size());
+      for (unsigned int i = 0; i < _origins.size(); ++i)
+      {
+        this->origin = _origins[i];
+        this->direction = _directions[i];
+        results.push_back(this->ClosestPoint());
+      }
+      this->origin = savedOrigin;
+      this->direction = savedDirection;
+      return results;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseRayQuery<T>::ValidateRays(
+        const std::vector<math::Vector3d> &_origins,
+        const std::vector<math::Vector3d> &_directions) const
+    {
+      if (_origins.size() != _directions.size())
+      {
+        ignerr << "Number of ray origins [" << _origins.size()
+               << "] does not match number of ray directions ["
+               << _directions.size() << "]" << std::endl;
+        return false;
+      }
+      return true;
+    }
     }
   }
 }
@@ -91,6 +91,21 @@ namespace ignition
       // Documentation Inherited
       public: virtual RenderPassSystemPtr RenderPassSystem() const override;
 
+      // Documentation Inherited
+      public: virtual bool SetGpuTimingEnabled(bool _enabled) override;
+
+      // Documentation Inherited
+      public: virtual bool GpuTimingEnabled() const override;
+
+      // Documentation Inherited
+      public: virtual void BeginRenderBatch() override;
+
+      // Documentation Inherited
+      public: virtual void EndRenderBatch() override;
+
+      // Documentation Inherited
+      public: virtual bool RenderBatchActive() const override;
+
       protected: virtual void PrepareScene(ScenePtr _scene);
 
       protected: virtual unsigned int NextSceneId();
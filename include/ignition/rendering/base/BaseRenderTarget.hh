@@ -17,6 +17,7 @@
 #ifndef IGNITION_RENDERING_BASE_BASERENDERTARGET_HH_
 #define IGNITION_RENDERING_BASE_BASERENDERTARGET_HH_
 
+#include <chrono>
 #include <string>
 #include <vector>
 
@@ -129,9 +130,57 @@ namespace ignition
 
       public: virtual void OnMove();
 
+      // Documentation inherited.
+      public: virtual void PostRender() override;
+
+      // Documentation inherited.
+      public: virtual void SetPresentMode(WindowPresentMode _mode) override;
+
+      // Documentation inherited.
+      public: virtual WindowPresentMode PresentMode() const override;
+
+      // Documentation inherited.
+      public: virtual void SetMaxFramesInFlight(unsigned int _count)
+                  override;
+
+      // Documentation inherited.
+      public: virtual unsigned int MaxFramesInFlight() const override;
+
+      // Documentation inherited.
+      public: virtual void SetFrameTimestamp(
+                  const std::chrono::steady_clock::time_point &_time)
+                  override;
+
+      // Documentation inherited.
+      public: virtual std::chrono::steady_clock::time_point
+                  LastPresentTime() const override;
+
+      // Documentation inherited.
+      public: virtual std::chrono::steady_clock::duration
+                  LastPresentLatency() const override;
+
       protected: std::string handle;
 
       protected: double ratio = 1.0;
+
+      /// \brief How the window presents its frames
+      protected: WindowPresentMode presentMode = WPM_FIFO;
+
+      /// \brief Maximum number of frames in flight, 0 if left to the driver
+      protected: unsigned int maxFramesInFlight = 0u;
+
+      /// \brief True if a timestamp was given for the next frame
+      protected: bool frameTimestampSet = false;
+
+      /// \brief Capture time of the data of the next frame
+      protected: std::chrono::steady_clock::time_point frameTimestamp;
+
+      /// \brief Present time of the last frame
+      protected: std::chrono::steady_clock::time_point lastPresentTime;
+
+      /// \brief Latency of the last frame presented with a timestamp
+      protected: std::chrono::steady_clock::duration lastPresentLatency =
+          std::chrono::steady_clock::duration::zero();
     };
 
     //////////////////////////////////////////////////
@@ -351,6 +400,75 @@ namespace ignition
     {
       this->targetDirty = true;
     }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseRenderWindow<T>::PostRender()
+    {
+      T::PostRender();
+
+      // the frame has been swapped by the render
+      this->lastPresentTime = std::chrono::steady_clock::now();
+      if (this->frameTimestampSet)
+      {
+        this->lastPresentLatency = this->lastPresentTime -
+            this->frameTimestamp;
+        this->frameTimestampSet = false;
+      }
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseRenderWindow<T>::SetPresentMode(WindowPresentMode _mode)
+    {
+      this->presentMode = _mode;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    WindowPresentMode BaseRenderWindow<T>::PresentMode() const
+    {
+      return this->presentMode;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseRenderWindow<T>::SetMaxFramesInFlight(unsigned int _count)
+    {
+      this->maxFramesInFlight = _count;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    unsigned int BaseRenderWindow<T>::MaxFramesInFlight() const
+    {
+      return this->maxFramesInFlight;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseRenderWindow<T>::SetFrameTimestamp(
+        const std::chrono::steady_clock::time_point &_time)
+    {
+      this->frameTimestamp = _time;
+      this->frameTimestampSet = true;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    std::chrono::steady_clock::time_point
+        BaseRenderWindow<T>::LastPresentTime() const
+    {
+      return this->lastPresentTime;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    std::chrono::steady_clock::duration
+        BaseRenderWindow<T>::LastPresentLatency() const
+    {
+      return this->lastPresentLatency;
+    }
     }
   }
 }
@@ -18,14 +18,24 @@
 #define IGNITION_RENDERING_BASE_BASESCENE_HH_
 
 #include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <ignition/common/Console.hh>
 #include <ignition/common/SuppressWarning.hh>
 
+#include "ignition/rendering/AabbTree.hh"
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/SceneCommandQueue.hh"
 #include "ignition/rendering/base/BaseRenderTypes.hh"
 
 namespace ignition
@@ -207,10 +217,32 @@ namespace ignition
       public: virtual VisualPtr VisualByIndex(unsigned int _index) const
                       override;
 
+      // Documentation inherited
+      public: virtual void ForEachVisual(
+                  const std::function<void(Visual &)> &_func) const override;
+
       // Documentation inherited
       public: virtual VisualPtr VisualAt(const CameraPtr &_camera,
                           const ignition::math::Vector2i &_mousePos) override;
 
+      // Documentation inherited.
+      public: virtual std::vector<VisualPtr> VisualsInBox(
+                  const math::AxisAlignedBox &_box) override;
+
+      // Documentation inherited.
+      public: virtual std::vector<VisualPtr> VisualsInSphere(
+                  const math::Vector3d &_center, double _radius) override;
+
+      // Documentation inherited.
+      public: virtual std::vector<VisualPtr> VisualsInFrustum(
+                  const math::Frustum &_frustum) override;
+
+      /// \brief Notify the scene that the bounding box of a visual may have
+      /// changed, or that the visual was destroyed. Only needed by render
+      /// engines whose VisualBoundsTracked returns true.
+      /// \param[in] _id Id of the visual
+      public: void SetVisualBoundsDirty(unsigned int _id);
+
       // Documentation inherited.
       public: virtual void DestroyVisual(VisualPtr _visual,
           bool _recursive = false) override;
@@ -224,6 +256,11 @@ namespace ignition
 
       public: virtual void DestroyVisuals() override;
 
+      // Documentation inherited.
+      public: virtual void DestroyVisuals(
+                  const std::vector<VisualPtr> &_visuals,
+                  bool _recursive = false) override;
+
       public: virtual bool MaterialRegistered(const std::string &_name) const
                       override;
 
@@ -244,6 +281,14 @@ namespace ignition
       // Documentation inherited
       public: virtual void DestroyMaterials() override;
 
+      // Documentation inherited.
+      public: virtual void DestroyMaterials(
+                  const std::vector<MaterialPtr> &_materials) override;
+
+      // Documentation inherited.
+      public: virtual MaterialPtr SharedMaterial(
+                  MaterialPtr _material) override;
+
       public: virtual DirectionalLightPtr CreateDirectionalLight() override;
 
       public: virtual DirectionalLightPtr CreateDirectionalLight(
@@ -316,6 +361,37 @@ namespace ignition
       public: virtual ThermalCameraPtr CreateThermalCamera(
                   const unsigned int _id, const std::string &_name) override;
 
+      // Documentation inherited.
+      public: virtual WideAngleCameraPtr CreateWideAngleCamera() override;
+
+      // Documentation inherited.
+      public: virtual WideAngleCameraPtr CreateWideAngleCamera(
+                  const unsigned int _id) override;
+
+      // Documentation inherited.
+      public: virtual WideAngleCameraPtr CreateWideAngleCamera(
+                  const std::string &_name) override;
+
+      // Documentation inherited.
+      public: virtual WideAngleCameraPtr CreateWideAngleCamera(
+                  const unsigned int _id, const std::string &_name) override;
+
+      // Documentation inherited.
+      public: virtual SegmentationCameraPtr CreateSegmentationCamera()
+                  override;
+
+      // Documentation inherited.
+      public: virtual SegmentationCameraPtr CreateSegmentationCamera(
+                  const unsigned int _id) override;
+
+      // Documentation inherited.
+      public: virtual SegmentationCameraPtr CreateSegmentationCamera(
+                  const std::string &_name) override;
+
+      // Documentation inherited.
+      public: virtual SegmentationCameraPtr CreateSegmentationCamera(
+                  const unsigned int _id, const std::string &_name) override;
+
       // Documentation inherited.
       public: virtual GpuRaysPtr CreateGpuRays() override;
 
@@ -407,6 +483,17 @@ namespace ignition
 
       public: virtual MeshPtr CreateMesh(const MeshDescriptor &_desc) override;
 
+      public: virtual std::shared_future<bool> PrepareMesh(
+                  const MeshDescriptor &_desc) override;
+
+      /// \brief Create a copy of a mesh of this scene, used by Mesh::Clone
+      /// \param[in] _mesh Mesh to copy
+      /// \param[in] _shareMaterials True if the copy should use the
+      /// materials of the mesh, false if it should get its own copies of
+      /// them
+      /// \return The copy, null if it could not be created
+      public: MeshPtr CloneMesh(const Mesh &_mesh, bool _shareMaterials);
+
       // Documentation inherited.
       public: virtual CapsulePtr CreateCapsule() override;
 
@@ -431,6 +518,36 @@ namespace ignition
       public: virtual LidarVisualPtr CreateLidarVisual(unsigned int _id,
                                             const std::string &_name) override;
 
+      // Documentation inherited.
+      public: virtual PointCloudVisualPtr CreatePointCloudVisual() override;
+
+      // Documentation inherited.
+      public: virtual PointCloudVisualPtr CreatePointCloudVisual(
+                  unsigned int _id) override;
+
+      // Documentation inherited.
+      public: virtual PointCloudVisualPtr CreatePointCloudVisual(
+                  const std::string &_name) override;
+
+      // Documentation inherited.
+      public: virtual PointCloudVisualPtr CreatePointCloudVisual(
+                  unsigned int _id, const std::string &_name) override;
+
+      // Documentation inherited.
+      public: virtual PoseArrayVisualPtr CreatePoseArrayVisual() override;
+
+      // Documentation inherited.
+      public: virtual PoseArrayVisualPtr CreatePoseArrayVisual(
+                  unsigned int _id) override;
+
+      // Documentation inherited.
+      public: virtual PoseArrayVisualPtr CreatePoseArrayVisual(
+                  const std::string &_name) override;
+
+      // Documentation inherited.
+      public: virtual PoseArrayVisualPtr CreatePoseArrayVisual(
+                  unsigned int _id, const std::string &_name) override;
+
       // Documentation inherited.
       public: virtual HeightmapPtr CreateHeightmap(
           const HeightmapDescriptor &_desc) override;
@@ -477,12 +594,105 @@ namespace ignition
 
       public: virtual void PreRender() override;
 
+      // Documentation inherited.
+      public: virtual void SetPreRenderThreadCount(unsigned int _count)
+                  override;
+
+      // Documentation inherited.
+      public: virtual unsigned int PreRenderThreadCount() const override;
+
+      // Documentation inherited.
+      public: virtual void SetIncrementalPreRender(bool _enabled) override;
+
+      // Documentation inherited.
+      public: virtual bool IncrementalPreRender() const override;
+
+      // Documentation inherited.
+      public: virtual void MarkPreRenderDirty(ObjectPtr _object,
+                  bool _subtree = false) override;
+
+      // Documentation inherited.
+      public: virtual uint64_t ChangeVersion() const override;
+
+      // Documentation inherited.
+      public: virtual void BeginFrame() override;
+
+      // Documentation inherited.
+      public: virtual void EndFrame() override;
+
+      // Documentation inherited.
+      public: virtual bool FrameActive() const override;
+
+      // Documentation inherited.
+      public: virtual void SetWorldPoses(const std::vector<unsigned int> &_ids,
+                  const std::vector<math::Pose3d> &_poses) override;
+
+      // Documentation inherited.
+      public: virtual void SetSkeletonBoneTransforms(
+                  const std::vector<MeshPtr> &_meshes,
+                  const std::vector<math::Matrix4f> &_tfs) override;
+
+      // Documentation inherited.
+      public: virtual void EnqueueCommand(std::function<void()> _command)
+                  override;
+
+      // Documentation inherited.
+      public: virtual size_t ApplyCommands() override;
+
+      // Documentation inherited.
+      public: virtual void PrecompileShaders() override;
+
+      // Documentation inherited.
+      public: virtual rendering::MemoryStats ResourceMemoryStats() const
+                  override;
+
+      // Documentation inherited.
+      public: virtual unsigned int BakeStaticGeometry(
+                  const std::vector<VisualPtr> &_visuals,
+                  double _cellSize = 50.0) override;
+
+      // Documentation inherited.
+      public: virtual void ClearStaticGeometry() override;
+
+      /// \brief Check that the arguments of SetWorldPoses are consistent
+      /// \param[in] _ids Ids of the nodes to update
+      /// \param[in] _poses New world poses
+      /// \return True if there is one pose per id
+      protected: bool ValidateWorldPoses(const std::vector<unsigned int> &_ids,
+                     const std::vector<math::Pose3d> &_poses) const;
+
       public: virtual void Clear() override;
 
+      // Documentation inherited.
+      public: virtual void BeginClear() override;
+
+      // Documentation inherited.
+      public: virtual bool ClearStep(
+                  const std::chrono::steady_clock::duration &_budget) override;
+
+      // Documentation inherited.
+      public: virtual bool Clearing() const override;
+
       public: virtual void Destroy() override;
 
       protected: virtual unsigned int CreateObjectId();
 
+      /// \brief Prepare the objects flagged by MarkPreRenderDirty and the
+      /// sensors for rendering
+      private: void IncrementalPreRenderImpl();
+
+      /// \brief Prepare the scene graph for rendering, collecting the
+      /// objects of subtrees in parallel then calling their PreRender
+      /// serially
+      /// \param[in] _threadCount Number of threads traversing the subtrees
+      private: void ParallelPreRender(unsigned int _threadCount);
+
+      /// \brief Check if the scene graph has already been prepared for
+      /// rendering in the current frame. Derived classes use this to skip
+      /// their own pre-render work in PreRender.
+      /// \return True if PreRender has run since BeginFrame was called
+      protected: bool FramePreRendered() const;
+
       protected: virtual std::string CreateObjectName(unsigned int _id,
                   const std::string &_prefix);
 
@@ -492,6 +702,12 @@ namespace ignition
 
       protected: virtual bool RegisterVisual(VisualPtr _visual);
 
+      /// \brief Check if the visuals of this render engine call
+      /// SetVisualBoundsDirty whenever their bounding box changes. If not,
+      /// the bounding box of every visual is checked at each spatial query.
+      /// \return True if the changes of bounding boxes are reported
+      protected: virtual bool VisualBoundsTracked() const;
+
       protected: virtual DirectionalLightPtr CreateDirectionalLightImpl(
                   unsigned int _id, const std::string &_name) = 0;
 
@@ -518,6 +734,28 @@ namespace ignition
                    return ThermalCameraPtr();
                  }
 
+      /// \brief Implementation for creating a wide angle camera.
+      /// \param[in] _id Unique id
+      /// \param[in] _name Name of wide angle camera
+      protected: virtual WideAngleCameraPtr CreateWideAngleCameraImpl(
+                     unsigned int /*_id*/, const std::string &/*_name*/)
+                 {
+                   ignerr << "Wide angle camera not supported by: "
+                          << this->Engine()->Name() << std::endl;
+                   return WideAngleCameraPtr();
+                 }
+
+      /// \brief Implementation for creating a segmentation camera.
+      /// \param[in] _id Unique id
+      /// \param[in] _name Name of segmentation camera
+      protected: virtual SegmentationCameraPtr CreateSegmentationCameraImpl(
+                     unsigned int /*_id*/, const std::string &/*_name*/)
+                 {
+                   ignerr << "Segmentation camera not supported by: "
+                          << this->Engine()->Name() << std::endl;
+                   return SegmentationCameraPtr();
+                 }
+
       /// \brief Implementation for creating GpuRays sensor.
       /// \param[in] _id Unique id
       /// \param[in] _name Name of GpuRays sensor
@@ -568,6 +806,34 @@ namespace ignition
                      const std::string &_name,
                      const MeshDescriptor &_desc) = 0;
 
+      /// \brief Implementation for copying a mesh. The copy must use the
+      /// materials of the submeshes of the mesh, without owning them. The
+      /// default implementation creates the mesh again from its descriptor,
+      /// render engines override it to reuse their loaded mesh instead.
+      /// \param[in] _id unique object id.
+      /// \param[in] _name unique object name.
+      /// \param[in] _mesh Mesh to copy
+      /// \return Pointer to the copy
+      protected: virtual MeshPtr CloneMeshImpl(unsigned int _id,
+                     const std::string &_name, const Mesh &_mesh);
+
+      /// \brief Implementation of BakeStaticGeometry, merging meshes into
+      /// batches. The default implementation merges the triangles of the
+      /// meshes into new meshes, one per cell, with one submesh per
+      /// material. Render engines with their own static geometry batching
+      /// override it.
+      /// \param[in] _meshes Meshes to merge, with their world transform
+      /// \param[in] _cellSize Edge length of the cells in meters, 0 to
+      /// not split the batches
+      /// \return One flag per mesh, true if the mesh was merged
+      protected: virtual std::vector<bool> BakeStaticMeshesImpl(
+                     const std::vector<std::pair<MeshPtr, math::Matrix4d>>
+                     &_meshes, double _cellSize);
+
+      /// \brief Implementation of ClearStaticGeometry, destroying the
+      /// batches created by BakeStaticMeshesImpl
+      protected: virtual void ClearStaticMeshesImpl();
+
       /// \brief Implementation for creating a capsule geometry object
       /// \param[in] _id unique object id.
       /// \param[in] _name unique object name.
@@ -596,6 +862,30 @@ namespace ignition
       protected: virtual LidarVisualPtr CreateLidarVisualImpl(unsigned int _id,
                      const std::string &_name) = 0;
 
+      /// \brief Implementation for creating a point cloud visual
+      /// \param[in] _id unique object id.
+      /// \param[in] _name unique object name.
+      /// \return Pointer to a point cloud visual
+      protected: virtual PointCloudVisualPtr CreatePointCloudVisualImpl(
+                     unsigned int, const std::string &)
+                 {
+                   ignerr << "PointCloudVisual not supported by: "
+                          << this->Engine()->Name() << std::endl;
+                   return PointCloudVisualPtr();
+                 }
+
+      /// \brief Implementation for creating a pose array visual
+      /// \param[in] _id unique object id.
+      /// \param[in] _name unique object name.
+      /// \return Pointer to a pose array visual
+      protected: virtual PoseArrayVisualPtr CreatePoseArrayVisualImpl(
+                     unsigned int, const std::string &)
+                 {
+                   ignerr << "PoseArrayVisual not supported by: "
+                          << this->Engine()->Name() << std::endl;
+                   return PoseArrayVisualPtr();
+                 }
+
       /// \brief Implementation for creating a heightmap geometry
       /// \param[in] _id Unique object id.
       /// \param[in] _name Unique object name.
@@ -669,6 +959,17 @@ namespace ignition
       /// \param[in] _node Node to be destroyed
       /// \param[in] _nodeId Holds all node ids that have been visited in the
       /// tree during the destroy process. Used for loop detection.
+      /// \brief Bring the bounding volume hierarchy of the visuals up to
+      /// date
+      private: void UpdateVisualTree();
+
+      /// \brief Get the visuals of the given ids, skipping the ones that
+      /// were destroyed
+      /// \param[in] _ids Ids of the visuals
+      /// \return Visuals of the ids
+      private: std::vector<VisualPtr> VisualsById(
+                   const std::vector<unsigned int> &_ids);
+
       private: void DestroyNodeRecursive(NodePtr _node,
           std::set<unsigned int> &_nodeIds);
 
@@ -707,8 +1008,68 @@ namespace ignition
 
       private: unsigned int nextObjectId;
 
+      /// \brief True between calls to BeginFrame and EndFrame
+      private: bool frameActive = false;
+
+      /// \brief True if PreRender has run in the current frame
+      private: bool framePreRendered = false;
+
+      /// \brief Number of threads traversing the scene graph in PreRender
+      private: unsigned int preRenderThreadCount = 1u;
+
+      /// \brief True if PreRender only prepares the changed objects
+      private: bool incrementalPreRender = false;
+
+      /// \brief True once the scene graph has been traversed since
+      /// incremental PreRender was enabled
+      private: bool preRenderTraversed = false;
+
+      /// \brief Version of the scene, incremented on every change
+      private: uint64_t changeVersion = 0u;
+
       IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
       private: NodeStorePtr nodes;
+
+      /// \brief Shared materials, indexed by their parameters
+      private: std::unordered_map<std::string, MaterialPtr> sharedMaterials;
+
+      /// \brief Parameters of the shared materials, indexed by material name
+      private: std::unordered_map<std::string, std::string>
+          sharedMaterialKeys;
+
+      /// \brief Bounding volume hierarchy over the bounding boxes of the
+      /// visuals, indexed by visual id
+      private: AabbTree visualTree;
+
+      /// \brief Visuals whose bounding box changed since the last query
+      private: std::unordered_set<unsigned int> dirtyVisualBounds;
+
+      /// \brief True once every visual has been added to the hierarchy
+      private: bool visualTreeBuilt = false;
+
+      /// \brief True while the objects are destroyed by ClearStep
+      private: bool clearing = false;
+
+      /// \brief Scene mutations queued by any thread, applied by the render
+      /// thread in PreRender
+      private: SceneCommandQueue commands;
+
+      /// \brief Objects to prepare in the next incremental PreRender, and
+      /// whether their child nodes and geometries must be prepared too
+      private: std::unordered_map<const Object *,
+          std::pair<std::weak_ptr<Object>, bool>> dirtyObjects;
+
+      /// \brief Meshes merged by BakeStaticGeometry, with the visual they
+      /// were removed from
+      private: std::vector<std::pair<VisualPtr, GeometryPtr>> bakedMeshes;
+
+      /// \brief Visuals of the batches created by the default
+      /// BakeStaticMeshesImpl
+      private: std::vector<VisualPtr> staticBatches;
+
+      /// \brief Meshes of the batches created by the default
+      /// BakeStaticMeshesImpl, kept alive as long as the batches
+      private: std::vector<std::shared_ptr<common::Mesh>> staticBatchMeshes;
       IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
     };
     }
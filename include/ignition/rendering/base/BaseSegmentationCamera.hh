@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_BASE_BASESEGMENTATIONCAMERA_HH_
+#define IGNITION_RENDERING_BASE_BASESEGMENTATIONCAMERA_HH_
+
+#include <string>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/base/BaseCamera.hh"
+#include "ignition/rendering/SegmentationCamera.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Base implementation of the SegmentationCamera class
+    template <class T>
+    class BaseSegmentationCamera :
+      public virtual SegmentationCamera,
+      public virtual BaseCamera<T>,
+      public virtual T
+    {
+      /// \brief Constructor
+      protected: BaseSegmentationCamera();
+
+      /// \brief Destructor
+      public: virtual ~BaseSegmentationCamera();
+
+      // Documentation inherited.
+      public: virtual void SetSegmentationType(SegmentationType _type)
+          override;
+
+      // Documentation inherited.
+      public: virtual SegmentationType Type() const override;
+
+      // Documentation inherited.
+      public: virtual void SetLabelBitDepth(unsigned int _bits) override;
+
+      // Documentation inherited.
+      public: virtual unsigned int LabelBitDepth() const override;
+
+      // Documentation inherited.
+      public: virtual void SetBackgroundLabel(uint32_t _label) override;
+
+      // Documentation inherited.
+      public: virtual uint32_t BackgroundLabel() const override;
+
+      // Documentation inherited.
+      public: virtual common::ConnectionPtr ConnectNewSegmentationFrame(
+          std::function<void(const uint32_t *, unsigned int, unsigned int,
+          unsigned int, const std::string &)> _subscriber) override;
+
+      // Documentation inherited.
+      public: virtual common::ConnectionPtr ConnectNewRawSegmentationFrame(
+          std::function<void(const unsigned char *, unsigned int,
+          unsigned int, unsigned int, const std::string &)> _subscriber)
+          override;
+
+      /// \brief What the labels identify
+      protected: SegmentationType type = SEG_SEMANTIC;
+
+      /// \brief Number of bits of the labels
+      protected: unsigned int labelBitDepth = 32u;
+
+      /// \brief Label of the pixels without labeled objects
+      protected: uint32_t backgroundLabel = 0u;
+    };
+
+    //////////////////////////////////////////////////
+    template <class T>
+    BaseSegmentationCamera<T>::BaseSegmentationCamera()
+    {
+      // impostors do not have the materials that labels replace
+      this->impostorsEnabled = false;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    BaseSegmentationCamera<T>::~BaseSegmentationCamera()
+    {
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseSegmentationCamera<T>::SetSegmentationType(
+        SegmentationType _type)
+    {
+      this->type = _type;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    SegmentationType BaseSegmentationCamera<T>::Type() const
+    {
+      return this->type;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseSegmentationCamera<T>::SetLabelBitDepth(unsigned int _bits)
+    {
+      if (_bits != 16u && _bits != 32u)
+      {
+        ignerr << "Unsupported label bit depth [" << _bits << "] for "
+               << "segmentation camera [" << this->Name() << "]. Only 16 "
+               << "and 32 bits are supported" << std::endl;
+        return;
+      }
+      this->labelBitDepth = _bits;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    unsigned int BaseSegmentationCamera<T>::LabelBitDepth() const
+    {
+      return this->labelBitDepth;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseSegmentationCamera<T>::SetBackgroundLabel(uint32_t _label)
+    {
+      this->backgroundLabel = _label;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    uint32_t BaseSegmentationCamera<T>::BackgroundLabel() const
+    {
+      return this->backgroundLabel;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    common::ConnectionPtr
+        BaseSegmentationCamera<T>::ConnectNewSegmentationFrame(
+        std::function<void(const uint32_t *, unsigned int, unsigned int,
+        unsigned int, const std::string &)>)
+    {
+      return nullptr;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    common::ConnectionPtr
+        BaseSegmentationCamera<T>::ConnectNewRawSegmentationFrame(
+        std::function<void(const unsigned char *, unsigned int,
+        unsigned int, unsigned int, const std::string &)>)
+    {
+      return nullptr;
+    }
+    }
+  }
+}
+#endif
@@ -17,7 +17,18 @@
 #ifndef IGNITION_RENDERING_BASE_BASESENSOR_HH_
 #define IGNITION_RENDERING_BASE_BASESENSOR_HH_
 
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+
+#include <ignition/common/Event.hh>
+
+#include "ignition/rendering/FrameDispatcher.hh"
+#include "ignition/rendering/Profiler.hh"
 #include "ignition/rendering/Sensor.hh"
+#include "ignition/rendering/SensorFrame.hh"
 
 namespace ignition
 {
@@ -40,8 +51,67 @@ namespace ignition
       // Documentation inherited.
       public: virtual uint32_t VisibilityMask() const override;
 
+      // Documentation inherited.
+      public: virtual void SetDispatchPolicy(FrameDispatchPolicy _policy,
+                  unsigned int _queueSize = 4u) override;
+
+      // Documentation inherited.
+      public: virtual FrameDispatchPolicy DispatchPolicy() const override;
+
+      // Documentation inherited.
+      public: virtual uint64_t DroppedFrameCount() const override;
+
+      // Documentation inherited.
+      public: virtual std::map<std::string, double> GpuTimes() const
+                  override;
+
+      // Documentation inherited.
+      public: virtual rendering::FrameStats LastFrameStats() const
+                  override;
+
+      // Documentation inherited.
+      public: virtual common::ConnectionPtr ConnectNewSensorFrame(
+                  std::function<void(const ConstSensorFramePtr &)>
+                  _subscriber) override;
+
+      /// \brief Emit a new frame event following the dispatch policy of
+      /// the sensor: either call the subscribers or queue the frame for the
+      /// FrameDispatcher workers. The data is copied to a pooled frame only
+      /// if it is queued or there are sensor frame subscribers, who then
+      /// share that copy.
+      /// \param[in] _event Event to emit, which must outlive the frames
+      /// queued, see FlushFrames
+      /// \param[in] _data Frame data
+      /// \param[in] _count Number of elements of the frame data
+      /// \param[in] _width Frame width
+      /// \param[in] _height Frame height
+      /// \param[in] _channels Number of channels
+      /// \param[in] _format Frame format
+      /// \param[in] _share False for outputs duplicating another one, which
+      /// are not delivered to the sensor frame subscribers
+      protected: template <typename E, typename D>
+                 void DispatchFrame(E &_event, const D *_data, size_t _count,
+                     unsigned int _width, unsigned int _height,
+                     unsigned int _channels, const std::string &_format,
+                     bool _share = true);
+
+      /// \brief Wait for the frames queued by DispatchFrame to be
+      /// delivered. Sensors call it before destroying their events.
+      protected: void FlushFrames();
+
       /// \brief Camera's visibility mask
       protected: uint32_t visibilityMask = IGN_VISIBILITY_ALL;
+
+      /// \brief Queue of the frames delivered by the FrameDispatcher, null
+      /// with FDP_SYNCHRONOUS
+      protected: std::shared_ptr<FrameChannel> frameChannel;
+
+      /// \brief Frames handed to the subscribers, reused once released
+      protected: SensorFramePool framePool;
+
+      /// \brief Event delivering reference counted frames
+      protected: common::EventT<void(const ConstSensorFramePtr &)>
+                 newSensorFrame;
     };
 
     //////////////////////////////////////////////////
@@ -69,6 +139,112 @@ namespace ignition
     {
       return this->visibilityMask;
     }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseSensor<T>::SetDispatchPolicy(FrameDispatchPolicy _policy,
+        unsigned int _queueSize)
+    {
+      // frames queued with the previous policy are delivered first
+      this->frameChannel.reset();
+      if (_policy != FDP_SYNCHRONOUS)
+      {
+        this->frameChannel =
+            std::make_shared<FrameChannel>(_policy, _queueSize);
+      }
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    FrameDispatchPolicy BaseSensor<T>::DispatchPolicy() const
+    {
+      if (!this->frameChannel)
+        return FDP_SYNCHRONOUS;
+      return this->frameChannel->Policy();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    uint64_t BaseSensor<T>::DroppedFrameCount() const
+    {
+      if (!this->frameChannel)
+        return 0u;
+      return this->frameChannel->DroppedCount();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    std::map<std::string, double> BaseSensor<T>::GpuTimes() const
+    {
+      return std::map<std::string, double>();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    rendering::FrameStats BaseSensor<T>::LastFrameStats() const
+    {
+      rendering::FrameStats stats;
+      for (const auto &time : this->GpuTimes())
+        stats.gpuTime += time.second;
+      return stats;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    common::ConnectionPtr BaseSensor<T>::ConnectNewSensorFrame(
+        std::function<void(const ConstSensorFramePtr &)> _subscriber)
+    {
+      return this->newSensorFrame.Connect(_subscriber);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    template <typename E, typename D>
+    void BaseSensor<T>::DispatchFrame(E &_event, const D *_data,
+        size_t _count, unsigned int _width, unsigned int _height,
+        unsigned int _channels, const std::string &_format, bool _share)
+    {
+      IGN_RENDERING_PROFILE("BaseSensor::DispatchFrame");
+      bool share = _share && this->newSensorFrame.ConnectionCount() > 0u;
+      if (!this->frameChannel && !share)
+      {
+        _event(_data, _width, _height, _channels, _format);
+        return;
+      }
+
+      // the render thread overwrites _data on the next frame, subscribers
+      // get a frame that stays valid as long as they hold it
+      SensorFramePtr frame = this->framePool.Acquire(_count * sizeof(D));
+      std::memcpy(frame->Data(), _data, _count * sizeof(D));
+      frame->SetDescription(_width, _height, _channels, _format);
+
+      if (!this->frameChannel)
+      {
+        _event(frame->template Data<D>(), _width, _height, _channels,
+            _format);
+        this->newSensorFrame(frame);
+        return;
+      }
+
+      E *event = &_event;
+      auto *sensorEvent = share ? &this->newSensorFrame : nullptr;
+      this->frameChannel->Post([event, sensorEvent, frame]()
+          {
+            IGN_RENDERING_PROFILE("BaseSensor::DispatchFrame worker");
+            (*event)(frame->template Data<D>(), frame->Width(),
+                frame->Height(), frame->Channels(), frame->Format());
+            if (sensorEvent)
+              (*sensorEvent)(frame);
+          });
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseSensor<T>::FlushFrames()
+    {
+      if (this->frameChannel)
+        this->frameChannel->Flush();
+    }
     }
   }
 }
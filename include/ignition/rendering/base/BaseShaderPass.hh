@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_BASE_BASESHADERPASS_HH_
+#define IGNITION_RENDERING_BASE_BASESHADERPASS_HH_
+
+#include <memory>
+#include <string>
+
+#include "ignition/rendering/ShaderParams.hh"
+#include "ignition/rendering/ShaderPass.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /* \class BaseShaderPass BaseShaderPass.hh \
+     * ignition/rendering/base/BaseShaderPass.hh
+     */
+    /// \brief Base shader render pass.
+    template <class T>
+    class BaseShaderPass :
+      public virtual ShaderPass,
+      public virtual T
+    {
+      /// \brief Constructor
+      protected: BaseShaderPass();
+
+      /// \brief Destructor
+      public: virtual ~BaseShaderPass();
+
+      // Documentation inherited.
+      public: std::string Kernel() const;
+
+      // Documentation inherited.
+      public: void SetKernel(const std::string &_code);
+
+      // Documentation inherited.
+      public: ShaderParamsPtr KernelParams();
+
+      /// \brief GLSL code of the kernel
+      protected: std::string kernel;
+
+      /// \brief True if the kernel changed since it was last compiled
+      protected: bool kernelDirty = false;
+
+      /// \brief Values of the uniforms of the kernel
+      protected: ShaderParamsPtr kernelParams;
+    };
+
+    //////////////////////////////////////////////////
+    // BaseShaderPass
+    //////////////////////////////////////////////////
+    template <class T>
+    BaseShaderPass<T>::BaseShaderPass()
+      : kernelParams(std::make_shared<ShaderParams>())
+    {
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    BaseShaderPass<T>::~BaseShaderPass()
+    {
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    std::string BaseShaderPass<T>::Kernel() const
+    {
+      return this->kernel;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseShaderPass<T>::SetKernel(const std::string &_code)
+    {
+      if (_code == this->kernel)
+        return;
+
+      this->kernel = _code;
+      this->kernelDirty = true;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    ShaderParamsPtr BaseShaderPass<T>::KernelParams()
+    {
+      return this->kernelParams;
+    }
+    }
+  }
+}
+#endif
@@ -17,9 +17,13 @@
 #ifndef IGNITION_RENDERING_BASE_BASESTORAGE_HH_
 #define IGNITION_RENDERING_BASE_BASESTORAGE_HH_
 
+#include <functional>
+#include <iterator>
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <ignition/common/Console.hh>
@@ -74,13 +78,36 @@ namespace ignition
 
       public: virtual void RemoveAll();
 
-      public: virtual UPtr Derived(const std::string &_key) const;
+      public: virtual void DestroyAll();
+
+      public: UPtr Derived(const std::string &_key) const;
+
+      public: UPtr DerivedByIndex(unsigned int _index) const;
+
+      protected: bool IsValidIter(ConstUIter _iter) const;
 
-      public: virtual UPtr DerivedByIndex(unsigned int _index) const;
+      /// \brief Update the index after an item has been inserted
+      /// \param[in] _iter Iterator to the inserted item
+      private: void IndexInsert(ConstUIter _iter);
 
-      protected: virtual bool IsValidIter(ConstUIter _iter) const;
+      /// \brief Update the index before an item is erased
+      /// \param[in] _iter Iterator to the item about to be erased
+      private: void IndexErase(ConstUIter _iter);
+
+      /// \brief Rebuild the index if it is out of date
+      private: void UpdateIndex() const;
 
       protected: UMap map;
+
+      /// \brief Iterators to all items, in map order. Used for constant
+      /// time access by index. Kept in order when items are inserted, and
+      /// rebuilt lazily after an item other than the last is removed.
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      private: mutable std::vector<ConstUIter> index;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+
+      /// \brief True if the index needs to be rebuilt
+      private: mutable bool indexDirty = false;
     };
 
     //////////////////////////////////////////////////
@@ -100,6 +127,10 @@ namespace ignition
 
       typedef typename UStore::const_iterator ConstUIter;
 
+      typedef std::unordered_map<unsigned int, ConstUIter> IdIndex;
+
+      typedef std::unordered_map<std::string, ConstUIter> NameIndex;
+
       public: BaseStore();
 
       public: virtual ~BaseStore();
@@ -118,6 +149,9 @@ namespace ignition
 
       public: virtual TPtr GetByIndex(unsigned int _index) const;
 
+      public: virtual void ForEach(const std::function<void(T &)> &_func)
+                  const;
+
       public: virtual bool Add(TPtr _object);
 
       public: virtual TPtr Remove(TPtr _object);
@@ -140,58 +174,145 @@ namespace ignition
 
       public: virtual void DestroyAll();
 
-      public: virtual UPtr DerivedById(unsigned int _id) const;
+      public: UPtr DerivedById(unsigned int _id) const;
 
-      public: virtual UPtr DerivedByName(const std::string &_name) const;
+      public: UPtr DerivedByName(const std::string &_name) const;
 
-      public: virtual UPtr DerivedByIndex(unsigned int _index) const;
+      public: UPtr DerivedByIndex(unsigned int _index) const;
 
-      public: virtual bool AddDerived(UPtr _object);
+      public: bool AddDerived(UPtr _object);
 
-      public: virtual UPtr RemoveDerived(UPtr _object);
+      public: UPtr RemoveDerived(UPtr _object);
 
-      public: virtual UPtr RemoveDerivedById(unsigned int _id);
+      public: UPtr RemoveDerivedById(unsigned int _id);
 
-      public: virtual UPtr RemoveDerivedByName(const std::string &_name);
+      public: UPtr RemoveDerivedByName(const std::string &_name);
 
-      public: virtual UPtr RemoveDerivedByIndex(unsigned int _index);
+      public: UPtr RemoveDerivedByIndex(unsigned int _index);
 
       /// \brief Return an iterator to the beginning
       /// \returns Iterator to beginning
-      public: virtual UIter Begin();
+      public: UIter Begin();
 
       /// \brief Return an iterator to the end
       /// \returns Iterator to end
-      public: virtual UIter End();
+      public: UIter End();
+
+      /// \brief Constant iterator over the objects of the store. It
+      /// dereferences to the objects themselves rather than to shared
+      /// pointers, so that range-based for loops over the store do not
+      /// touch reference counts.
+      public: class ConstIterator
+      {
+        /// \brief Constructor
+        /// \param[in] _iter Iterator into the store
+        public: explicit ConstIterator(ConstUIter _iter) : iter(_iter) {}
+
+        /// \brief Get the object the iterator points to
+        /// \return The object
+        public: U &operator*() const { return *this->iter->second; }
+
+        /// \brief Access the object the iterator points to
+        /// \return Pointer to the object
+        public: U *operator->() const { return this->iter->second.get(); }
+
+        /// \brief Move to the next object
+        /// \return This iterator
+        public: ConstIterator &operator++()
+                {
+                  ++this->iter;
+                  return *this;
+                }
+
+        /// \brief Equality operator
+        /// \param[in] _other Iterator to compare to
+        /// \return True if both iterators point to the same object
+        public: bool operator==(const ConstIterator &_other) const
+                {
+                  return this->iter == _other.iter;
+                }
+
+        /// \brief Inequality operator
+        /// \param[in] _other Iterator to compare to
+        /// \return True if the iterators point to different objects
+        public: bool operator!=(const ConstIterator &_other) const
+                {
+                  return this->iter != _other.iter;
+                }
+
+        /// \brief Iterator into the store
+        private: ConstUIter iter;
+      };
+
+      /// \brief Return a constant iterator to the first object, for
+      /// range-based for loops. The store must not be modified during the
+      /// iteration.
+      /// \return Iterator to the first object
+      public: ConstIterator begin() const;
+
+      /// \brief Return a constant iterator past the last object
+      /// \return Iterator past the last object
+      public: ConstIterator end() const;
+
+      protected: ConstUIter ConstIter(ConstTPtr _object) const;
+
+      protected: ConstUIter ConstIterById(unsigned int _id) const;
+
+      protected: ConstUIter ConstIterByName(
+                     const std::string &_name) const;
 
-      protected: virtual ConstUIter ConstIter(ConstTPtr _object) const;
+      protected: ConstUIter ConstIterByIndex(unsigned int _index) const;
 
-      protected: virtual ConstUIter ConstIterById(unsigned int _id) const;
+      protected: UIter Iter(ConstTPtr _object);
 
-      protected: virtual ConstUIter ConstIterByName(
-                     const std::string &_name) const;
+      protected: UIter IterById(unsigned int _id);
 
-      protected: virtual ConstUIter ConstIterByIndex(unsigned int _index) const;
+      protected: UIter IterByName(const std::string &_name);
 
-      protected: virtual UIter Iter(ConstTPtr _object);
+      protected: UIter IterByIndex(unsigned int _index);
 
-      protected: virtual UIter IterById(unsigned int _id);
+      protected: bool AddImpl(UPtr _object);
 
-      protected: virtual UIter IterByName(const std::string &_name);
+      protected: UPtr RemoveImpl(UIter _iter);
 
-      protected: virtual UIter IterByIndex(unsigned int _index);
+      protected: void DestroyImpl(UIter _iter);
 
-      protected: virtual bool AddImpl(UPtr _object);
+      protected: bool IsValidIter(ConstUIter _iter) const;
 
-      protected: virtual UPtr RemoveImpl(UIter _iter);
+      protected: UIter RemoveConstness(ConstUIter _iter);
 
-      protected: virtual void DestroyImpl(UIter _iter);
+      /// \brief Update the index after an item has been inserted
+      /// \param[in] _iter Iterator to the inserted item
+      private: void IndexInsert(ConstUIter _iter);
 
-      protected: virtual bool IsValidIter(ConstUIter _iter) const;
+      /// \brief Update the index before an item is erased
+      /// \param[in] _iter Iterator to the item about to be erased
+      private: void IndexErase(ConstUIter _iter);
 
-      protected: virtual UIter RemoveConstness(ConstUIter _iter);
+      /// \brief Rebuild the index if it is out of date
+      private: void UpdateIndex() const;
 
       protected: UStore store;
+
+      /// \brief Iterators to all items, in store order. Used for constant
+      /// time access by index. Kept in order when items are inserted, and
+      /// rebuilt lazily after an item other than the last is removed.
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      private: mutable std::vector<ConstUIter> index;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+
+      /// \brief True if the index needs to be rebuilt
+      private: mutable bool indexDirty = false;
+
+      /// \brief Hashed lookup of items by id
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      private: IdIndex idIndex;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+
+      /// \brief Hashed lookup of items by name
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      private: NameIndex nameIndex;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
     };
 
     //////////////////////////////////////////////////
@@ -231,6 +352,9 @@ namespace ignition
 
       public: virtual TPtr GetByIndex(unsigned int _index) const;
 
+      public: virtual void ForEach(const std::function<void(T &)> &_func)
+                  const;
+
       public: virtual bool Add(TPtr _object);
 
       public: virtual TPtr Remove(TPtr _object);
@@ -265,7 +389,7 @@ namespace ignition
 
       public: virtual TStorePtr RemoveStore(unsigned int _index);
 
-      public: virtual TStorePtr RemoveStoreImpl(TStoreIter _iter);
+      public: TStorePtr RemoveStoreImpl(TStoreIter _iter);
 
       IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
       protected: TStoreList stores;
@@ -307,6 +431,9 @@ namespace ignition
 
       public: virtual TPtr GetByIndex(unsigned int _index) const;
 
+      public: virtual void ForEach(const std::function<void(T &)> &_func)
+                  const;
+
       public: virtual bool Add(TPtr _object);
 
       public: virtual TPtr Remove(TPtr _object);
@@ -333,55 +460,55 @@ namespace ignition
     };
 
     //////////////////////////////////////////////////
-    class  BaseNodeCompositeStore :
+    class BaseNodeCompositeStore final :
       public BaseCompositeStore<Node>
     {
     };
 
     template <class T>
-    class  BaseSceneStore :
+    class BaseSceneStore final :
       public BaseStore<Scene, T>
     {
     };
 
     template <class T>
-    class  BaseNodeStore :
+    class BaseNodeStore final :
       public BaseStore<Node, T>
     {
     };
 
     template <class T>
-    class  BaseLightStore :
+    class BaseLightStore final :
       public BaseStore<Light, T>
     {
     };
 
     template <class T>
-    class  BaseSensorStore :
+    class BaseSensorStore final :
       public BaseStore<Sensor, T>
     {
     };
 
     template <class T>
-    class  BaseVisualStore :
+    class BaseVisualStore final :
       public BaseStore<Visual, T>
     {
     };
 
     template <class T>
-    class  BaseGeometryStore :
+    class BaseGeometryStore final :
       public BaseStore<Geometry, T>
     {
     };
 
     template <class T>
-    class  BaseSubMeshStore :
+    class BaseSubMeshStore final :
       public BaseStore<SubMesh, T>
     {
     };
 
     template <class T>
-    class  BaseMaterialMap :
+    class BaseMaterialMap final :
       public BaseMap<Material, T>
     {
     };
@@ -456,7 +583,7 @@ namespace ignition
         return false;
       }
 
-      if (this->ContainsKey(_key))
+      if (this->map.count(_key) > 0)
       {
         ignerr << "Item already registered with key: " << _key << std::endl;
         return false;
@@ -472,7 +599,8 @@ namespace ignition
         return false;
       }
 
-      this->map[_key] = derived;
+      auto result = this->map.insert(std::make_pair(_key, derived));
+      this->IndexInsert(result.first);
       return true;
     }
 
@@ -484,6 +612,7 @@ namespace ignition
 
       if (this->IsValidIter(iter))
       {
+        this->IndexErase(iter);
         this->map.erase(iter);
       }
     }
@@ -498,7 +627,8 @@ namespace ignition
       {
         if (iter->second == _value)
         {
-          this->map.erase(iter);
+          this->IndexErase(iter);
+          iter = this->map.erase(iter);
           continue;
         }
 
@@ -511,6 +641,22 @@ namespace ignition
     void BaseMap<T, U>::RemoveAll()
     {
       this->map.clear();
+      this->index.clear();
+      this->indexDirty = false;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T, class U>
+    void BaseMap<T, U>::DestroyAll()
+    {
+      // take ownership of all items first so the map is left in a valid
+      // state if destroying an item modifies the map
+      UMap items;
+      items.swap(this->map);
+      this->RemoveAll();
+
+      for (auto &pair : items)
+        pair.second->Destroy();
     }
 
     //////////////////////////////////////////////////
@@ -527,15 +673,19 @@ namespace ignition
     typename BaseMap<T, U>::UPtr
     BaseMap<T, U>::DerivedByIndex(unsigned int _index) const
     {
-      if (_index >= this->Size())
+      if (_index >= this->map.size())
       {
         ignerr << "Invalid index: " << _index << std::endl;
         return nullptr;
       }
 
-      auto iter = this->map.begin();
-      std::advance(iter, _index);
-      return iter->second;
+      // the first item is often accessed while removing items one by one
+      // so avoid rebuilding the index for it
+      if (_index == 0u)
+        return this->map.begin()->second;
+
+      this->UpdateIndex();
+      return this->index[_index]->second;
     }
 
     //////////////////////////////////////////////////
@@ -545,6 +695,44 @@ namespace ignition
       return _iter != this->map.end();
     }
 
+    //////////////////////////////////////////////////
+    template <class T, class U>
+    void BaseMap<T, U>::IndexInsert(ConstUIter _iter)
+    {
+      if (this->indexDirty)
+        return;
+
+      // default names such as "Visual(10)" do not sort in creation order,
+      // so insert at the sorted position instead of rebuilding later
+      auto pos = std::distance(this->map.cbegin(), _iter);
+      this->index.insert(this->index.begin() + pos, _iter);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T, class U>
+    void BaseMap<T, U>::IndexErase(ConstUIter _iter)
+    {
+      if (!this->indexDirty && !this->index.empty() &&
+          this->index.back() == _iter)
+        this->index.pop_back();
+      else
+        this->indexDirty = true;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T, class U>
+    void BaseMap<T, U>::UpdateIndex() const
+    {
+      if (!this->indexDirty)
+        return;
+
+      this->index.clear();
+      this->index.reserve(this->map.size());
+      for (auto iter = this->map.cbegin(); iter != this->map.cend(); ++iter)
+        this->index.push_back(iter);
+      this->indexDirty = false;
+    }
+
     //////////////////////////////////////////////////
     template <class T, class U>
     BaseStore<T, U>::BaseStore()
@@ -580,6 +768,22 @@ namespace ignition
       return this->store.end();
     }
 
+    //////////////////////////////////////////////////
+    template <class T, class U>
+    typename BaseStore<T, U>::ConstIterator
+    BaseStore<T, U>::begin() const
+    {
+      return ConstIterator(this->store.begin());
+    }
+
+    //////////////////////////////////////////////////
+    template <class T, class U>
+    typename BaseStore<T, U>::ConstIterator
+    BaseStore<T, U>::end() const
+    {
+      return ConstIterator(this->store.end());
+    }
+
     //////////////////////////////////////////////////
     template <class T, class U>
     bool BaseStore<T, U>::Contains(ConstTPtr _object) const
@@ -628,6 +832,15 @@ namespace ignition
       return this->DerivedByIndex(_index);
     }
 
+    //////////////////////////////////////////////////
+    template <class T, class U>
+    void BaseStore<T, U>::ForEach(const std::function<void(T &)> &_func)
+        const
+    {
+      for (const auto &pair : this->store)
+        _func(*pair.second);
+    }
+
     //////////////////////////////////////////////////
     template <class T, class U>
     bool BaseStore<T, U>::Add(TPtr _object)
@@ -689,6 +902,10 @@ namespace ignition
     void BaseStore<T, U>::RemoveAll()
     {
       this->store.clear();
+      this->index.clear();
+      this->indexDirty = false;
+      this->idIndex.clear();
+      this->nameIndex.clear();
     }
 
     //////////////////////////////////////////////////
@@ -727,11 +944,11 @@ namespace ignition
     template <class T, class U>
     void BaseStore<T, U>::DestroyAll()
     {
-      unsigned int i = this->Size();
+      unsigned int i = this->store.size();
 
       while (i > 0)
       {
-        this->DestroyByIndex(--i);
+        this->DestroyImpl(this->IterByIndex(--i));
       }
     }
 
@@ -816,18 +1033,12 @@ namespace ignition
     typename BaseStore<T, U>::ConstUIter
     BaseStore<T, U>::ConstIter(ConstTPtr _object) const
     {
-      auto begin = this->store.begin();
-      auto end = this->store.end();
-
-      for (auto iter = begin; iter != end; ++iter)
-      {
-        if (iter->second == _object)
-        {
-          return iter;
-        }
-      }
+      if (!_object)
+        return this->store.end();
 
-      return end;
+      auto iter = this->ConstIterById(_object->Id());
+      return (this->IsValidIter(iter) && iter->second == _object) ?
+          iter : this->store.end();
     }
 
     //////////////////////////////////////////////////
@@ -835,18 +1046,8 @@ namespace ignition
     typename BaseStore<T, U>::ConstUIter
     BaseStore<T, U>::ConstIterById(unsigned int _id) const
     {
-      auto begin = this->store.begin();
-      auto end = this->store.end();
-
-      for (auto iter = begin; iter != end; ++iter)
-      {
-        if (iter->second->Id() == _id)
-        {
-          return iter;
-        }
-      }
-
-      return end;
+      auto iter = this->idIndex.find(_id);
+      return (iter != this->idIndex.end()) ? iter->second : this->store.end();
     }
 
     //////////////////////////////////////////////////
@@ -854,7 +1055,9 @@ namespace ignition
     typename BaseStore<T, U>::ConstUIter
     BaseStore<T, U>::ConstIterByName(const std::string &_name) const
     {
-      return this->store.find(_name);
+      auto iter = this->nameIndex.find(_name);
+      return (iter != this->nameIndex.end()) ?
+          iter->second : this->store.end();
     }
 
     //////////////////////////////////////////////////
@@ -862,15 +1065,20 @@ namespace ignition
     typename BaseStore<T, U>::ConstUIter
     BaseStore<T, U>::ConstIterByIndex(unsigned int _index) const
     {
-      if (_index >= this->Size())
+      if (_index >= this->store.size())
       {
         ignerr << "Invalid index: " << _index << std::endl;
         return this->store.end();
       }
 
-      auto iter = this->store.begin();
-      std::advance(iter, _index);
-      return iter;
+      // the first item is often accessed while removing items one by one,
+      // e.g. when recursively destroying nodes, so avoid rebuilding the
+      // index for it
+      if (_index == 0u)
+        return this->store.begin();
+
+      this->UpdateIndex();
+      return this->index[_index];
     }
 
     //////////////////////////////////////////////////
@@ -914,22 +1122,26 @@ namespace ignition
     bool BaseStore<T, U>::AddImpl(UPtr _object)
     {
       unsigned int id = _object->Id();
-      std::string name = _object->Name();
 
-      if (this->ContainsId(id))
+      if (this->idIndex.count(id) > 0)
       {
         ignerr << "Another item already exists with id: " << id << std::endl;
         return false;
       }
 
-      if (this->ContainsName(name))
+      // the insertion itself detects name collisions, so that bulk creation
+      // only looks the name up once
+      auto result = this->store.emplace(_object->Name(), _object);
+      if (!result.second)
       {
-        ignerr << "Another item already exists with name: " << name
-            << std::endl;
+        ignerr << "Another item already exists with name: "
+            << result.first->first << std::endl;
         return false;
       }
 
-      this->store[name] = _object;
+      this->IndexInsert(result.first);
+      this->idIndex.emplace(id, result.first);
+      this->nameIndex.emplace(result.first->first, result.first);
       return true;
     }
 
@@ -944,6 +1156,9 @@ namespace ignition
       }
 
       UPtr result = _iter->second;
+      this->IndexErase(_iter);
+      this->idIndex.erase(result->Id());
+      this->nameIndex.erase(_iter->first);
       this->store.erase(_iter);
       return result;
     }
@@ -972,6 +1187,45 @@ namespace ignition
           this->store.erase(_iter, _iter) : this->store.end();
     }
 
+    //////////////////////////////////////////////////
+    template <class T, class U>
+    void BaseStore<T, U>::IndexInsert(ConstUIter _iter)
+    {
+      if (this->indexDirty)
+        return;
+
+      // default names such as "Visual(10)" do not sort in creation order,
+      // so insert at the sorted position instead of rebuilding later
+      auto pos = std::distance(this->store.cbegin(), _iter);
+      this->index.insert(this->index.begin() + pos, _iter);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T, class U>
+    void BaseStore<T, U>::IndexErase(ConstUIter _iter)
+    {
+      // removing the last item, e.g. in DestroyAll, keeps the index valid
+      if (!this->indexDirty && !this->index.empty() &&
+          this->index.back() == _iter)
+        this->index.pop_back();
+      else
+        this->indexDirty = true;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T, class U>
+    void BaseStore<T, U>::UpdateIndex() const
+    {
+      if (!this->indexDirty)
+        return;
+
+      this->index.clear();
+      this->index.reserve(this->store.size());
+      for (auto iter = this->store.cbegin(); iter != this->store.cend(); ++iter)
+        this->index.push_back(iter);
+      this->indexDirty = false;
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     BaseCompositeStore<T>::BaseCompositeStore()
@@ -990,7 +1244,7 @@ namespace ignition
     {
       unsigned int size = 0;
 
-      for (auto store : this->stores)
+      for (const auto &store : this->stores)
       {
         size += store->Size();
       }
@@ -1002,7 +1256,7 @@ namespace ignition
     template <class T>
     bool BaseCompositeStore<T>::Contains(ConstTPtr _object) const
     {
-      for (auto store : this->stores)
+      for (const auto &store : this->stores)
       {
         if (store->Contains(_object)) return true;
       }
@@ -1014,7 +1268,7 @@ namespace ignition
     template <class T>
     bool BaseCompositeStore<T>::ContainsId(unsigned int _id) const
     {
-      for (auto store : this->stores)
+      for (const auto &store : this->stores)
       {
         if (store->ContainsId(_id)) return true;
       }
@@ -1026,7 +1280,7 @@ namespace ignition
     template <class T>
     bool BaseCompositeStore<T>::ContainsName(const std::string &_name) const
     {
-      for (auto store : this->stores)
+      for (const auto &store : this->stores)
       {
         if (store->ContainsName(_name)) return true;
       }
@@ -1039,7 +1293,7 @@ namespace ignition
     typename BaseCompositeStore<T>::TPtr
     BaseCompositeStore<T>::GetById(unsigned int _id) const
     {
-      for (auto store : this->stores)
+      for (const auto &store : this->stores)
       {
         TPtr object = store->GetById(_id);
         if (object) return object;
@@ -1053,7 +1307,7 @@ namespace ignition
     typename BaseCompositeStore<T>::TPtr
     BaseCompositeStore<T>::GetByName(const std::string &_name) const
     {
-      for (auto store : this->stores)
+      for (const auto &store : this->stores)
       {
         TPtr object = store->GetByName(_name);
         if (object) return object;
@@ -1069,7 +1323,7 @@ namespace ignition
     {
       unsigned int origIndex = _index;
 
-      for (auto store : this->stores)
+      for (const auto &store : this->stores)
       {
         unsigned int size = store->Size();
         if (_index < size)
@@ -1081,6 +1335,15 @@ namespace ignition
       return nullptr;
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCompositeStore<T>::ForEach(
+        const std::function<void(T &)> &_func) const
+    {
+      for (const auto &store : this->stores)
+        store->ForEach(_func);
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     bool BaseCompositeStore<T>::Add(TPtr)
@@ -1096,7 +1359,7 @@ namespace ignition
     {
       TPtr result = nullptr;
 
-      for (auto store : this->stores)
+      for (const auto &store : this->stores)
       {
         TPtr temp = store->Remove(_object);
         if (!result) result = temp;
@@ -1112,7 +1375,7 @@ namespace ignition
     {
       TPtr result = nullptr;
 
-      for (auto store : this->stores)
+      for (const auto &store : this->stores)
       {
         TPtr temp = store->RemoveById(_id);
         if (!result) result = temp;
@@ -1128,7 +1391,7 @@ namespace ignition
     {
       TPtr result = nullptr;
 
-      for (auto store : this->stores)
+      for (const auto &store : this->stores)
       {
         TPtr temp = store->RemoveByName(_name);
         if (!result) result = temp;
@@ -1144,7 +1407,7 @@ namespace ignition
     {
       TPtr result = nullptr;
 
-      for (auto store : this->stores)
+      for (const auto &store : this->stores)
       {
         TPtr temp = store->RemoveByIndex(_index);
         if (!result) result = temp;
@@ -1157,7 +1420,7 @@ namespace ignition
     template <class T>
     void BaseCompositeStore<T>::RemoveAll()
     {
-      for (auto store : this->stores)
+      for (const auto &store : this->stores)
       {
         store->RemoveAll();
       }
@@ -1167,7 +1430,7 @@ namespace ignition
     template <class T>
     void BaseCompositeStore<T>::Destroy(TPtr _object)
     {
-      for (auto store : this->stores)
+      for (const auto &store : this->stores)
       {
         if (store->Contains(_object))
         {
@@ -1181,7 +1444,7 @@ namespace ignition
     template <class T>
     void BaseCompositeStore<T>::DestroyById(unsigned int _id)
     {
-      for (auto store : this->stores)
+      for (const auto &store : this->stores)
       {
         store->DestroyById(_id);
       }
@@ -1191,7 +1454,7 @@ namespace ignition
     template <class T>
     void BaseCompositeStore<T>::DestroyByName(const std::string &_name)
     {
-      for (auto store : this->stores)
+      for (const auto &store : this->stores)
       {
         store->DestroyByName(_name);
       }
@@ -1201,7 +1464,7 @@ namespace ignition
     template <class T>
     void BaseCompositeStore<T>::DestroyByIndex(unsigned int _index)
     {
-      for (auto store : this->stores)
+      for (const auto &store : this->stores)
       {
         store->DestroyByIndex(_index);
       }
@@ -1211,7 +1474,7 @@ namespace ignition
     template <class T>
     void BaseCompositeStore<T>::DestroyAll()
     {
-      for (auto store : this->stores)
+      for (const auto &store : this->stores)
       {
         store->DestroyAll();
       }
@@ -1239,7 +1502,7 @@ namespace ignition
     typename BaseCompositeStore<T>::TStorePtr
     BaseCompositeStore<T>::GetStore(unsigned int _index) const
     {
-      if (_index >= this->GetStoreCount())
+      if (_index >= this->stores.size())
       {
         ignerr << "Invalid store index: " << _index << std::endl;
         return nullptr;
@@ -1284,7 +1547,7 @@ namespace ignition
     typename BaseCompositeStore<T>::TStorePtr
     BaseCompositeStore<T>::RemoveStore(unsigned int _index)
     {
-      if (_index >= this->GetStoreCount())
+      if (_index >= this->stores.size())
       {
         ignerr << "Invalid store index: " << _index << std::endl;
         return nullptr;
@@ -1376,6 +1639,17 @@ namespace ignition
       return this->store->GetByIndex(_index);
     }
 
+    //////////////////////////////////////////////////
+    template <class T, class U>
+    void BaseStoreWrapper<T, U>::ForEach(
+        const std::function<void(T &)> &_func) const
+    {
+      this->store->ForEach([&_func](U &_object)
+          {
+            _func(_object);
+          });
+    }
+
     //////////////////////////////////////////////////
     template <class T, class U>
     bool BaseStoreWrapper<T, U>::Add(TPtr _object)
@@ -160,6 +160,7 @@ namespace ignition
     {
       this->fontName = _font;
       this->textDirty = true;
+      this->MarkPreRenderDirty();
     }
 
     //////////////////////////////////////////////////
@@ -175,6 +176,7 @@ namespace ignition
     {
       this->text = _text;
       this->textDirty = true;
+      this->MarkPreRenderDirty();
     }
 
     //////////////////////////////////////////////////
@@ -190,6 +192,7 @@ namespace ignition
     {
       this->color = _color;
       this->textDirty = true;
+      this->MarkPreRenderDirty();
     }
 
     //////////////////////////////////////////////////
@@ -205,6 +208,7 @@ namespace ignition
     {
       this->charHeight = _height;
       this->textDirty = true;
+      this->MarkPreRenderDirty();
     }
 
     //////////////////////////////////////////////////
@@ -220,6 +224,7 @@ namespace ignition
     {
       this->spaceWidth = _width;
       this->textDirty = true;
+      this->MarkPreRenderDirty();
     }
 
     //////////////////////////////////////////////////
@@ -244,6 +249,7 @@ namespace ignition
       this->horizontalAlign = _horzAlign;
       this->verticalAlign = _vertAlign;
       this->textDirty = true;
+      this->MarkPreRenderDirty();
     }
 
     //////////////////////////////////////////////////
@@ -259,6 +265,7 @@ namespace ignition
     {
       this->baseline = _baseline;
       this->textDirty = true;
+      this->MarkPreRenderDirty();
     }
 
     //////////////////////////////////////////////////
@@ -274,6 +281,7 @@ namespace ignition
     {
       this->onTop = _onTop;
       this->textDirty = true;
+      this->MarkPreRenderDirty();
     }
 
     //////////////////////////////////////////////////
@@ -82,6 +82,13 @@ namespace ignition
           std::function<void(const uint16_t *, unsigned int, unsigned int,
           unsigned int, const std::string &)>  _subscriber) override;
 
+      // Documentation inherted.
+      public: virtual ignition::common::ConnectionPtr
+          ConnectNewRawThermalFrame(
+          std::function<void(const unsigned char *, unsigned int,
+          unsigned int, unsigned int, const std::string &)>  _subscriber)
+          override;
+
       /// \brief Ambient temperature of the environment
       protected: float ambient = 0.0f;
 
@@ -105,6 +112,8 @@ namespace ignition
     template <class T>
     BaseThermalCamera<T>::BaseThermalCamera()
     {
+      // impostors do not have the materials that heat sources replace
+      this->impostorsEnabled = false;
     }
 
     //////////////////////////////////////////////////
@@ -205,6 +214,15 @@ namespace ignition
     {
       return nullptr;
     }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    common::ConnectionPtr BaseThermalCamera<T>::ConnectNewRawThermalFrame(
+          std::function<void(const unsigned char *, unsigned int,
+          unsigned int, unsigned int, const std::string &)>)
+    {
+      return nullptr;
+    }
   }
   }
 }
@@ -17,13 +17,15 @@
 #ifndef IGNITION_RENDERING_BASE_BASEVISUAL_HH_
 #define IGNITION_RENDERING_BASE_BASEVISUAL_HH_
 
-#include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <ignition/math/AxisAlignedBox.hh>
 
 #include "ignition/rendering/Visual.hh"
 #include "ignition/rendering/Storage.hh"
+#include "ignition/rendering/base/BaseObject.hh"
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/base/BaseStorage.hh"
 
@@ -54,6 +56,10 @@ namespace ignition
       public: virtual GeometryPtr GeometryByIndex(unsigned int _index) const
                       override;
 
+      public: virtual void ForEachGeometry(
+                  const std::function<void(Geometry &)> &_func) const
+                      override;
+
       public: virtual void AddGeometry(GeometryPtr _geometry) override;
 
       public: virtual GeometryPtr RemoveGeometry(GeometryPtr _geometry)
@@ -79,6 +85,18 @@ namespace ignition
       // Documentation inherited.
       public: virtual MaterialPtr Material() override;
 
+      // Documentation inherited.
+      public: virtual void SetMaterialOverride(MaterialPtr _material)
+                  override;
+
+      // Documentation inherited.
+      public: virtual MaterialPtr MaterialOverride() const override;
+
+      // Documentation inherited.
+      public: virtual VisualPtr Clone(const std::string &_name,
+                  NodePtr _newParent, bool _shareMaterials = false) const
+                  override;
+
       // Documentation inherited.
       public: virtual void SetVisible(bool _visible) override;
 
@@ -94,6 +112,12 @@ namespace ignition
       // Documentation inherited.
       public: virtual void RemoveVisibilityFlags(uint32_t _flags) override;
 
+      // Documentation inherited.
+      public: virtual void SetStatic(bool _static) override;
+
+      // Documentation inherited.
+      public: virtual bool Static() const override;
+
       // Documentation inherited.
       public: virtual void PreRender() override;
 
@@ -107,6 +131,20 @@ namespace ignition
       // Documentation inherited.
       public: virtual Variant UserData(const std::string &_key) const override;
 
+      // Documentation inherited.
+      public: virtual void SetUserData(const UserDataKey &_key,
+          Variant _value) override;
+
+      // Documentation inherited.
+      public: virtual const Variant &UserData(const UserDataKey &_key)
+          const override;
+
+      /// \brief Get a counter that is incremented every time user data is
+      /// set on this visual. It can be compared against a previously
+      /// returned value to find out if the user data has changed.
+      /// \return User data version
+      public: unsigned int UserDataVersion() const;
+
       // Documentation inherited.
       public: virtual ignition::math::AxisAlignedBox BoundingBox()
               const override;
@@ -128,14 +166,24 @@ namespace ignition
       /// \brief Pointer to material assigned to this visual
       protected: MaterialPtr material;
 
-      /// \brief A map of custom key value data
-      protected: std::map<std::string, Variant> userData;
+      /// \brief Material rendered instead of the assigned materials
+      protected: MaterialPtr materialOverride;
+
+      /// \brief Custom data, indexed by the id of its UserDataKey. Slots
+      /// without data hold an empty variant.
+      protected: std::vector<Variant> userData;
+
+      /// \brief Number of times user data has been set on this visual
+      protected: unsigned int userDataVersion = 0u;
 
       /// \brief Visual's visibility flags
       protected: uint32_t visibilityFlags = IGN_VISIBILITY_ALL;
 
       /// \brief The bounding box of the visual
       protected: ignition::math::AxisAlignedBox boundingBox;
+
+      /// \brief True if the visual is static
+      protected: bool isStatic = false;
     };
 
     //////////////////////////////////////////////////
@@ -176,6 +224,7 @@ namespace ignition
       }
 
       this->SetRawLocalPose(rawPose);
+      this->InvalidateWorldPose();
     }
 
     //////////////////////////////////////////////////
@@ -199,6 +248,14 @@ namespace ignition
       return this->Geometries()->GetByIndex(_index);
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseVisual<T>::ForEachGeometry(
+        const std::function<void(Geometry &)> &_func) const
+    {
+      this->Geometries()->ForEach(_func);
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     void BaseVisual<T>::AddGeometry(GeometryPtr _geometry)
@@ -206,6 +263,12 @@ namespace ignition
       if (this->AttachGeometry(_geometry))
       {
         this->Geometries()->Add(_geometry);
+        if (this->materialOverride)
+          _geometry->SetMaterialOverride(this->materialOverride);
+
+        ScenePtr scene_ = this->Scene();
+        if (scene_)
+          scene_->MarkPreRenderDirty(_geometry);
       }
     }
 
@@ -216,6 +279,8 @@ namespace ignition
       if (this->DetachGeometry(_geometry))
       {
         this->Geometries()->Remove(_geometry);
+        if (this->materialOverride && _geometry)
+          _geometry->SetMaterialOverride(nullptr);
       }
       return _geometry;
     }
@@ -253,6 +318,7 @@ namespace ignition
       this->SetChildMaterial(_material, false);
       this->SetGeometryMaterial(_material, false);
       this->material = _material;
+      this->MarkPreRenderDirty(true);
     }
 
     //////////////////////////////////////////////////
@@ -285,11 +351,10 @@ namespace ignition
       unsigned int count = this->GeometryCount();
       _material = (_unique && count > 0) ? _material->Clone() : _material;
 
-      for (unsigned int i = 0; i < count; ++i)
-      {
-        GeometryPtr geometry = this->GeometryByIndex(i);
-        geometry->SetMaterial(_material, false);
-      }
+      this->ForEachGeometry([&_material](Geometry &_geometry)
+          {
+            _geometry.SetMaterial(_material, false);
+          });
     }
 
     //////////////////////////////////////////////////
@@ -299,6 +364,90 @@ namespace ignition
       return this->material;
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseVisual<T>::SetMaterialOverride(MaterialPtr _material)
+    {
+      this->ForEachChild([&_material](Node &_child)
+          {
+            auto visual = dynamic_cast<Visual *>(&_child);
+            if (visual)
+              visual->SetMaterialOverride(_material);
+          });
+
+      this->ForEachGeometry([&_material](Geometry &_geometry)
+          {
+            _geometry.SetMaterialOverride(_material);
+          });
+
+      this->materialOverride = _material;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    MaterialPtr BaseVisual<T>::MaterialOverride() const
+    {
+      return this->materialOverride;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    VisualPtr BaseVisual<T>::Clone(const std::string &_name,
+        NodePtr _newParent, bool _shareMaterials) const
+    {
+      ScenePtr scene_ = this->Scene();
+      VisualPtr result = (_name.empty()) ? scene_->CreateVisual() :
+          scene_->CreateVisual(_name);
+      if (!result)
+      {
+        ignerr << "Unable to clone visual [" << this->Name() << "]"
+               << std::endl;
+        return nullptr;
+      }
+
+      // the scale is set first as the local pose depends on it
+      result->SetInheritScale(this->InheritScale());
+      result->SetLocalScale(this->LocalScale());
+      result->SetOrigin(this->Origin());
+      result->SetLocalPose(this->LocalPose());
+      result->SetVisibilityFlags(this->VisibilityFlags());
+      result->SetStatic(this->Static());
+      for (unsigned int i = 0; i < this->userData.size(); ++i)
+      {
+        if (this->userData[i].index() != 0)
+          result->SetUserData(UserDataKey::FromId(i), this->userData[i]);
+      }
+
+      unsigned int count = this->GeometryCount();
+      for (unsigned int i = 0; i < count; ++i)
+      {
+        GeometryPtr geometry = this->GeometryByIndex(i)->Clone(
+            _shareMaterials);
+        if (geometry)
+          result->AddGeometry(geometry);
+      }
+
+      auto children_ =
+          std::dynamic_pointer_cast<BaseStore<ignition::rendering::Node, T>>(
+          this->Children());
+      if (children_)
+      {
+        for (auto it = children_->Begin(); it != children_->End(); ++it)
+        {
+          VisualPtr visual = std::dynamic_pointer_cast<Visual>(it->second);
+          if (visual)
+            visual->Clone("", result, _shareMaterials);
+        }
+      }
+
+      if (this->materialOverride)
+        result->SetMaterialOverride(this->materialOverride);
+
+      if (_newParent)
+        _newParent->AddChild(result);
+      return result;
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     void BaseVisual<T>::PreRender()
@@ -315,6 +464,7 @@ namespace ignition
       this->Geometries()->DestroyAll();
       this->Children()->RemoveAll();
       this->material.reset();
+      this->materialOverride.reset();
       T::Destroy();
     }
 
@@ -322,6 +472,10 @@ namespace ignition
     template <class T>
     void BaseVisual<T>::PreRenderChildren()
     {
+      // the scene traverses the children itself
+      if (BaseObject::ShallowPreRender())
+        return;
+
       auto children_ =
           std::dynamic_pointer_cast<BaseStore<ignition::rendering::Node, T>>(
           this->Children());
@@ -340,6 +494,9 @@ namespace ignition
     template <class T>
     void BaseVisual<T>::PreRenderGeometries()
     {
+      if (BaseObject::ShallowPreRender())
+        return;
+
       unsigned int count = this->GeometryCount();
 
       for (unsigned int i = 0; i < count; ++i)
@@ -426,6 +583,20 @@ namespace ignition
       this->SetVisibilityFlags(this->VisibilityFlags() & ~(_flags));
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseVisual<T>::SetStatic(bool _static)
+    {
+      this->isStatic = _static;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseVisual<T>::Static() const
+    {
+      return this->isStatic;
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     void BaseVisual<T>::SetVisibilityFlags(uint32_t _flags)
@@ -461,18 +632,44 @@ namespace ignition
     template <class T>
     void BaseVisual<T>::SetUserData(const std::string &_key, Variant _value)
     {
-      this->userData[_key] = _value;
+      this->SetUserData(UserDataKey(_key), std::move(_value));
     }
 
     //////////////////////////////////////////////////
     template <class T>
     Variant BaseVisual<T>::UserData(const std::string &_key) const
     {
-      Variant value;
-      auto it = this->userData.find(_key);
-      if (it != this->userData.end())
-        value = it->second;
-      return value;
+      return this->UserData(UserDataKey::Find(_key));
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseVisual<T>::SetUserData(const UserDataKey &_key, Variant _value)
+    {
+      if (!_key.Valid())
+        return;
+
+      if (_key.Id() >= this->userData.size())
+        this->userData.resize(_key.Id() + 1u);
+      this->userData[_key.Id()] = std::move(_value);
+      ++this->userDataVersion;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    const Variant &BaseVisual<T>::UserData(const UserDataKey &_key) const
+    {
+      static const Variant empty;
+      if (_key.Id() < this->userData.size())
+        return this->userData[_key.Id()];
+      return empty;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    unsigned int BaseVisual<T>::UserDataVersion() const
+    {
+      return this->userDataVersion;
     }
     }
   }
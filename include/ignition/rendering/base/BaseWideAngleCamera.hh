@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_BASE_BASEWIDEANGLECAMERA_HH_
+#define IGNITION_RENDERING_BASE_BASEWIDEANGLECAMERA_HH_
+
+#include <string>
+
+#include "ignition/rendering/base/BaseCamera.hh"
+#include "ignition/rendering/WideAngleCamera.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Base implementation of the WideAngleCamera class
+    template <class T>
+    class BaseWideAngleCamera :
+      public virtual WideAngleCamera,
+      public virtual BaseCamera<T>,
+      public virtual T
+    {
+      /// \brief Constructor
+      protected: BaseWideAngleCamera();
+
+      /// \brief Destructor
+      public: virtual ~BaseWideAngleCamera();
+
+      // Documentation inherited.
+      public: virtual void SetProjection(WideAngleProjection _projection)
+          override;
+
+      // Documentation inherited.
+      public: virtual WideAngleProjection Projection() const override;
+
+      // Documentation inherited.
+      public: virtual void SetCubeFaceSize(unsigned int _size) override;
+
+      // Documentation inherited.
+      public: virtual unsigned int CubeFaceSize() const override;
+
+      // Documentation inherited.
+      public: virtual common::ConnectionPtr ConnectNewWideAngleFrame(
+          std::function<void(const unsigned char *, unsigned int,
+          unsigned int, unsigned int, const std::string &)> _subscriber)
+          override;
+
+      /// \brief Mapping function of the lens
+      protected: WideAngleProjection projection = WAP_EQUIDISTANT;
+
+      /// \brief Size of the cubemap faces, 0 to pick it from the image
+      /// resolution
+      protected: unsigned int cubeFaceSize = 0u;
+    };
+
+    //////////////////////////////////////////////////
+    template <class T>
+    BaseWideAngleCamera<T>::BaseWideAngleCamera()
+    {
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    BaseWideAngleCamera<T>::~BaseWideAngleCamera()
+    {
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseWideAngleCamera<T>::SetProjection(
+        WideAngleProjection _projection)
+    {
+      this->projection = _projection;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    WideAngleProjection BaseWideAngleCamera<T>::Projection() const
+    {
+      return this->projection;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseWideAngleCamera<T>::SetCubeFaceSize(unsigned int _size)
+    {
+      this->cubeFaceSize = _size;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    unsigned int BaseWideAngleCamera<T>::CubeFaceSize() const
+    {
+      return this->cubeFaceSize;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    common::ConnectionPtr BaseWideAngleCamera<T>::ConnectNewWideAngleFrame(
+        std::function<void(const unsigned char *, unsigned int,
+        unsigned int, unsigned int, const std::string &)>)
+    {
+      return nullptr;
+    }
+    }
+  }
+}
+#endif
@@ -91,6 +91,7 @@ namespace ignition
     {
       this->box = _box;
       this->wireBoxDirty = true;
+      this->MarkPreRenderDirty();
     }
 
     //////////////////////////////////////////////////
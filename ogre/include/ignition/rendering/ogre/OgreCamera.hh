@@ -18,6 +18,7 @@
 #define IGNITION_RENDERING_OGRE_OGRECAMERA_HH_
 
 #include <string>
+#include <vector>
 
 #include "ignition/rendering/base/BaseCamera.hh"
 #include "ignition/rendering/ogre/OgreRenderTypes.hh"
@@ -85,6 +86,24 @@ namespace ignition
       public: virtual VisualPtr VisualAt(const ignition::math::Vector2i
                   &_mousePos) override;
 
+      // Documentation inherited
+      public: virtual std::vector<VisualPtr> VisualsInRegion(
+                  const ignition::math::Vector2i &_min,
+                  const ignition::math::Vector2i &_max) override;
+
+      /// \brief Set whether the selection buffer is also rendered for the
+      /// whole image each time the camera renders. The selection buffer is
+      /// only rendered again if the camera view or the scene changed. As
+      /// long as the camera has not moved since its last frame, VisualAt
+      /// then only reads the cached frame.
+      /// \param[in] _enabled True to render the selection buffer with
+      /// each frame
+      public: void SetSelectionFrameEnabled(bool _enabled);
+
+      /// \brief Get whether the selection buffer is rendered with each frame
+      /// \return True if enabled
+      public: bool SelectionFrameEnabled() const;
+
       // Documentation Inherited.
       // \sa Camera::SetMaterial(const MaterialPtr &)
       public: virtual void SetMaterial(
@@ -123,6 +142,9 @@ namespace ignition
 
       protected: math::Color backgroundColor;
 
+      /// \brief True to render the selection buffer with each frame
+      private: bool selectionFrameEnabled = false;
+
       private: friend class OgreScene;
       private: friend class OgreRayQuery;
     };
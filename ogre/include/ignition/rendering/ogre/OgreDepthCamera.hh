@@ -125,6 +125,18 @@ namespace ignition
       // Documentation inherited
       public: virtual void Destroy() override;
 
+      /// \brief Enable or disable asynchronous readback of the depth and
+      /// point cloud data. When enabled, the GPU to CPU copy of a frame
+      /// overlaps with the rendering of the next one and the new depth and
+      /// point cloud frame events are emitted one frame late. Blocking
+      /// readback is used if the render system does not support it.
+      /// \param[in] _enabled True to enable asynchronous readback
+      public: void SetAsyncReadback(bool _enabled);
+
+      /// \brief Get whether asynchronous readback is enabled
+      /// \return True if asynchronous readback is enabled
+      public: bool AsyncReadback() const;
+
       /// \brief Update a render target
       /// \param[in] _target Render target to update
       /// \param[in] _material Material to use
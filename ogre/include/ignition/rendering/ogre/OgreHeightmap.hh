@@ -80,12 +80,19 @@ namespace ignition
       private: void ConfigureTerrainDefaults();
 
       /// \brief Checks if the terrain was previously loaded by comparing its
-      /// hash against the one stored in the terrain directory
+      /// cache key, and then its hash, against the ones stored in the terrain
+      /// directory. If the cache key matches, the hash is verified in the
+      /// background and the terrain files are used right away.
       /// \param[in] _terrainDirPath Path to the directory containing the
       /// terrain files and hash.
       /// \return True if the terrain requires to regenerate the terrain files.
       private: bool PrepareTerrain(const std::string &_terrainDirPath);
 
+      /// \brief Get the cache key of the terrain: the path, modification time
+      /// and size of the heightmap file and the descriptor parameters.
+      /// \return The key or an empty string if the heightmap has no file.
+      private: std::string TerrainCacheKey() const;
+
       /// \brief Update the hash of a terrain file. The hash will be written in
       /// a file called gzterrain.SHA1 . This method will be used when the
       /// paging is enabled and the terrain is loaded for the first time or if
@@ -108,6 +115,12 @@ namespace ignition
       /// \param[in] _y Y coordinate of the terrain.
       private: void DefineTerrain(int _x, int _y);
 
+      /// \brief Save the terrain files to the cache without blocking the
+      /// render thread. Every call snapshots one terrain to memory and hands
+      /// it to a background job that writes it to disk. Called by PreRender
+      /// once the terrain is loaded, until all the jobs are done.
+      private: void UpdateTerrainSave();
+
       /// \brief Create terrain material generator. There are two types:
       /// custom material generator that support user material scripts,
       /// and a default material generator that uses our own glsl shader
@@ -36,6 +36,7 @@
 #include <OgreRenderWindow.h>
 #include <OgrePlugin.h>
 #include <OgreDataStream.h>
+#include <OgreStreamSerialiser.h>
 #include <OgreLogManager.h>
 #include <OgreSceneQuery.h>
 #include <OgreRoot.h>
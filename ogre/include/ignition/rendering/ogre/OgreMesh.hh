@@ -65,6 +65,17 @@ namespace ignition
       public: virtual void SetSkeletonLocalTransforms(
             const std::map<std::string, math::Matrix4d> &_tfs) override;
 
+      // Documentation inherited.
+      public: virtual std::vector<std::string> SkeletonBoneNames() const
+            override;
+
+      // Documentation inherited.
+      public: virtual unsigned int SkeletonBoneCount() const override;
+
+      // Documentation inherited.
+      public: virtual void SetSkeletonBoneTransforms(
+            const math::Matrix4f *_tfs, unsigned int _count) override;
+
       // Documentation inherited.
       public: virtual std::unordered_map<std::string, float> SkeletonWeights()
             const override;
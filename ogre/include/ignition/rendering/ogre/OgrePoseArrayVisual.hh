@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE_OGREPOSEARRAYVISUAL_HH_
+#define IGNITION_RENDERING_OGRE_OGREPOSEARRAYVISUAL_HH_
+
+#include "ignition/rendering/base/BasePoseArrayVisual.hh"
+#include "ignition/rendering/ogre/OgreVisual.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Ogre implementation of the pose array visual class
+    class IGNITION_RENDERING_OGRE_VISIBLE OgrePoseArrayVisual :
+      public BasePoseArrayVisual<OgreVisual>
+    {
+      /// \brief Constructor
+      protected: OgrePoseArrayVisual();
+
+      /// \brief Destructor
+      public: virtual ~OgrePoseArrayVisual();
+
+      /// \brief Only scene can instantiate a pose array visual
+      private: friend class OgreScene;
+    };
+    }
+  }
+}
+#endif
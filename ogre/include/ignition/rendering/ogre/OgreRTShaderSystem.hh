@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <ignition/common/SingletonT.hh>
 #include "ignition/rendering/ogre/OgreIncludes.hh"
@@ -125,6 +126,13 @@ namespace ignition
       /// \param[in] _subMesh The submesh to generate shaders for.
       public: void GenerateShaders(OgreSubMesh *_subMesh);
 
+      /// \brief Generate shaders for many submeshes, e.g. all the ones
+      /// added in a frame. The shaders of a material are generated once,
+      /// however many of the submeshes use it.
+      /// \param[in] _subMeshes The submeshes to generate shaders for.
+      public: void GenerateShaders(
+                  const std::vector<OgreSubMesh *> &_subMeshes);
+
       /// \brief Apply shadows to a scene.
       /// \param[in] _scene The scene to receive shadows.
       public: void ApplyShadows(OgreScenePtr _scene);
@@ -140,7 +148,10 @@ namespace ignition
       /// \brief Get paths for the shader system
       /// \param[out] _coreLibsPath Path to the core libraries.
       /// \param[out] _cachePath Path to where the generated shaders are
-      /// stored.
+      /// stored. The directory persists across runs and is keyed by a hash
+      /// of the ogre version, render system and shader lib path, so that
+      /// programs generated for another setup are not reused. The compiled
+      /// programs are also saved there when the render system supports it.
       private: bool Paths(std::string &_coreLibsPath,
                              std::string &_cachePath);
 
@@ -164,6 +175,8 @@ namespace ignition
       /// added. The function reapplies shadows if properties have changed,
       /// and iterates through all entities added to RTShaderSystem
       /// and regenerates shader programs for each entity if shaders are dirty.
+      /// Otherwise, shaders are only generated, in one batch, for the
+      /// entities attached since the last update.
       /// This function is currently called by OgreScene::PreRender
       /// \sa OgreScene::PreRender
       public: void Update();
@@ -18,6 +18,7 @@
 #define IGNITION_RENDERING_OGRE_OGRERAYQUERY_HH_
 
 #include <memory>
+#include <vector>
 
 #include "ignition/rendering/base/BaseRayQuery.hh"
 #include "ignition/rendering/ogre/OgreIncludes.hh"
@@ -52,6 +53,11 @@ namespace ignition
       // Documentation inherited
       public: virtual RayQueryResult ClosestPoint();
 
+      // Documentation inherited
+      public: virtual std::vector<RayQueryResult> ClosestPoints(
+                const std::vector<math::Vector3d> &_origins,
+                const std::vector<math::Vector3d> &_directions);
+
       /// \brief Get the mesh information for the given mesh.
       /// \param[in] _mesh Mesh to get info about.
       /// \param[out] _vertexCount Number of vertices in the mesh.
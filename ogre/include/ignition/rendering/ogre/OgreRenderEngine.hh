@@ -120,6 +120,17 @@ namespace ignition
       /// Current accepts the following parameters and values:
       /// "useCurrentGLContext" : "1" or "0". Use current OpenGL context for
       ///                                     rendering
+      /// "workQueueThreads" : Number of worker threads of the ogre work
+      ///                      queue, which load the terrain pages and
+      ///                      generate their derived data in the
+      ///                      background. Defaults to the number of
+      ///                      logical cores.
+      /// "workQueueResponseTimeLimit" : Milliseconds spent each frame
+      ///                                applying the results of the work
+      ///                                queue on the render thread, e.g.
+      ///                                uploading terrain data. 0 applies
+      ///                                all the pending results. Defaults
+      ///                                to 10 ms.
       protected: virtual bool LoadImpl(
           const std::map<std::string, std::string> &_params) override;
 
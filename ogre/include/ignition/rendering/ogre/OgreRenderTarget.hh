@@ -148,6 +148,10 @@ namespace ignition
 
       public: virtual void Buffer(float *buffer);
 
+      /// \brief Get the ogre texture rendered to
+      /// \return Ogre texture, null until the target is built
+      public: Ogre::Texture *OgreTexture() const;
+
       public: virtual Ogre::RenderTarget *RenderTarget() const override;
 
       protected: virtual void RebuildTarget() override;
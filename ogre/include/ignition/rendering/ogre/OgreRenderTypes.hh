@@ -50,6 +50,7 @@ namespace ignition
     class OgreObject;
     class OgreParticleEmitter;
     class OgrePointLight;
+    class OgrePoseArrayVisual;
     class OgreRayQuery;
     class OgreRenderEngine;
     class OgreRenderTarget;
@@ -102,6 +103,7 @@ namespace ignition
     typedef shared_ptr<OgreObject>               OgreObjectPtr;
     typedef shared_ptr<OgreParticleEmitter>      OgreParticleEmitterPtr;
     typedef shared_ptr<OgrePointLight>           OgrePointLightPtr;
+    typedef shared_ptr<OgrePoseArrayVisual>      OgrePoseArrayVisualPtr;
     typedef shared_ptr<OgreRayQuery>             OgreRayQueryPtr;
     typedef shared_ptr<OgreRenderEngine>         OgreRenderEnginePtr;
     typedef shared_ptr<OgreRenderTarget>         OgreRenderTargetPtr;
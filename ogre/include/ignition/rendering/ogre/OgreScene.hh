@@ -19,6 +19,8 @@
 
 #include <array>
 #include <string>
+#include <utility>
+#include <vector>
 #include "ignition/rendering/base/BaseScene.hh"
 #include "ignition/rendering/ogre/Export.hh"
 #include "ignition/rendering/ogre/OgreRenderTypes.hh"
@@ -28,6 +30,7 @@ namespace Ogre
 {
   class Root;
   class SceneManager;
+  class StaticGeometry;
 }
 
 namespace ignition
@@ -65,6 +68,10 @@ namespace ignition
 
       public: virtual void PreRender() override;
 
+      // Documentation inherited.
+      public: virtual void SetWorldPoses(const std::vector<unsigned int> &_ids,
+                  const std::vector<math::Pose3d> &_poses) override;
+
       public: virtual void Clear() override;
 
       public: virtual void Destroy() override;
@@ -114,6 +121,10 @@ namespace ignition
       protected: virtual AxisVisualPtr CreateAxisVisualImpl(unsigned int _id,
                      const std::string &_name) override;
 
+      // Documentation inherited
+      protected: virtual PoseArrayVisualPtr CreatePoseArrayVisualImpl(
+                     unsigned int _id, const std::string &_name) override;
+
       // Documentation inherited
       protected: virtual GizmoVisualPtr CreateGizmoVisualImpl(unsigned int _id,
                      const std::string &_name) override;
@@ -192,6 +203,19 @@ namespace ignition
       protected: virtual bool InitObject(OgreObjectPtr _object,
                      unsigned int _id, const std::string &_name);
 
+      /// \brief Merge the meshes into Ogre static geometry, one per set of
+      /// visibility flags, split in regions of the cell size
+      /// \param[in] _meshes Meshes to merge, with their world transform
+      /// \param[in] _cellSize Edge length of the regions in meters, 0 to
+      /// not split the static geometry
+      /// \return One flag per mesh, true if the mesh was merged
+      protected: virtual std::vector<bool> BakeStaticMeshesImpl(
+                     const std::vector<std::pair<MeshPtr, math::Matrix4d>>
+                     &_meshes, double _cellSize) override;
+
+      // Documentation inherited
+      protected: virtual void ClearStaticMeshesImpl() override;
+
       protected: virtual LightStorePtr Lights() const override;
 
       protected: virtual SensorStorePtr Sensors() const override;
@@ -226,6 +250,12 @@ namespace ignition
 
       protected: Ogre::SceneManager *ogreSceneManager;
 
+      /// \brief Static geometry built by BakeStaticMeshesImpl
+      private: std::vector<Ogre::StaticGeometry *> ogreStaticGeometries;
+
+      /// \brief Counter used to generate unique static geometry names
+      private: unsigned int staticGeometryCounter = 0u;
+
       private: friend class OgreRenderEngine;
     };
     }
@@ -85,6 +85,16 @@ namespace ignition
           std::function<void(const uint16_t *, unsigned int, unsigned int,
           unsigned int, const std::string &)>  _subscriber) override;
 
+      /// \brief Connect to the new thermal image signal delivering the 16
+      /// bit data as bytes
+      /// \param[in] _subscriber Subscriber callback function
+      /// \return Pointer to the new Connection. This must be kept in scope
+      public: virtual ignition::common::ConnectionPtr
+          ConnectNewRawThermalFrame(
+          std::function<void(const unsigned char *, unsigned int,
+          unsigned int, unsigned int, const std::string &)>  _subscriber)
+          override;
+
       // Documentation inherited.
       public: virtual void PreRender() override;
 
@@ -94,6 +104,18 @@ namespace ignition
       // Documentation inherited
       public: virtual void Destroy() override;
 
+      /// \brief Enable or disable asynchronous readback of the thermal
+      /// data. When enabled, the GPU to CPU copy of a frame overlaps with
+      /// the rendering of the next one and the new frame events are emitted
+      /// one frame late. Blocking readback is used if the render system
+      /// does not support it.
+      /// \param[in] _enabled True to enable asynchronous readback
+      public: void SetAsyncReadback(bool _enabled);
+
+      /// \brief Get whether asynchronous readback is enabled
+      /// \return True if asynchronous readback is enabled
+      public: bool AsyncReadback() const;
+
       /// \brief Get a pointer to the render target.
       /// \return Pointer to the render target
       protected: virtual RenderTargetPtr RenderTarget() const override;
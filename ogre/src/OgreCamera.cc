@@ -123,6 +123,13 @@ void OgreCamera::SetMaterial(const MaterialPtr &_material)
 void OgreCamera::Render()
 {
   this->renderTexture->Render();
+
+  if (this->selectionFrameEnabled)
+  {
+    if (!this->selectionBuffer)
+      this->SetSelectionBuffer();
+    this->selectionBuffer->UpdateFrame();
+  }
 }
 
 //////////////////////////////////////////////////
@@ -227,6 +234,17 @@ VisualPtr OgreCamera::VisualAt(const ignition::math::Vector2i
       static_cast<int>(std::rint(ratio * _mousePos.X())),
       static_cast<int>(std::rint(ratio * _mousePos.Y())));
 
+  // look up the frame rendered with the camera's last frame if it matches
+  // the current view
+  if (this->selectionFrameEnabled && this->selectionBuffer->FrameValid())
+  {
+    unsigned int id = this->selectionBuffer->FrameVisualIdAt(
+        mousePos.X(), mousePos.Y());
+    if (id != 0u)
+      result = this->scene->VisualById(id);
+    return result;
+  }
+
   Ogre::Entity *entity = this->selectionBuffer->OnSelectionClick(
       mousePos.X(), mousePos.Y());
 
@@ -251,6 +269,57 @@ VisualPtr OgreCamera::VisualAt(const ignition::math::Vector2i
   return result;
 }
 
+//////////////////////////////////////////////////
+std::vector<VisualPtr> OgreCamera::VisualsInRegion(
+    const ignition::math::Vector2i &_min, const ignition::math::Vector2i &_max)
+{
+  std::vector<VisualPtr> result;
+
+  if (!this->selectionBuffer)
+  {
+    this->SetSelectionBuffer();
+
+    if (!this->selectionBuffer)
+    {
+      return result;
+    }
+  }
+
+  float ratio = screenScalingFactor();
+  int x1 = static_cast<int>(std::rint(ratio * _min.X()));
+  int y1 = static_cast<int>(std::rint(ratio * _min.Y()));
+  int x2 = static_cast<int>(std::rint(ratio * _max.X()));
+  int y2 = static_cast<int>(std::rint(ratio * _max.Y()));
+  if (x2 <= x1 || y2 <= y1)
+    return result;
+
+  std::vector<unsigned int> ids = this->selectionBuffer->OnSelectionRegion(
+      x1, y1, static_cast<unsigned int>(x2 - x1),
+      static_cast<unsigned int>(y2 - y1));
+
+  result.reserve(ids.size());
+  for (auto id : ids)
+  {
+    VisualPtr visual = this->scene->VisualById(id);
+    if (visual)
+      result.push_back(visual);
+  }
+
+  return result;
+}
+
+//////////////////////////////////////////////////
+void OgreCamera::SetSelectionFrameEnabled(bool _enabled)
+{
+  this->selectionFrameEnabled = _enabled;
+}
+
+//////////////////////////////////////////////////
+bool OgreCamera::SelectionFrameEnabled() const
+{
+  return this->selectionFrameEnabled;
+}
+
 //////////////////////////////////////////////////
 RenderWindowPtr OgreCamera::CreateRenderWindow()
 {
@@ -45,7 +45,9 @@ const Ogre::PixelFormat OgreConversions::ogrePixelFormats[PF_COUNT] =
       // PF_FLOAT32_RGB
       Ogre::PF_FLOAT32_RGB,
       // PF_L16
-      Ogre::PF_L16
+      Ogre::PF_L16,
+      // PF_FLOAT16_R
+      Ogre::PF_FLOAT16_R
     };
 
 //////////////////////////////////////////////////
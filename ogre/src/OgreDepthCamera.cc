@@ -22,10 +22,55 @@
   #endif
   #include <windows.h>
 #endif
+#include <algorithm>
+#include <map>
+
 #include <ignition/math/Helpers.hh>
+#include "ignition/rendering/MemoryTracker.hh"
 #include "ignition/rendering/ogre/OgreDepthCamera.hh"
 #include "ignition/rendering/ogre/OgreMaterial.hh"
 
+#include "OgreReadbackManager.hh"
+
+namespace ignition
+{
+namespace rendering
+{
+inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+//
+/// \brief Helper class for switching the ogre item's material to a point
+/// cloud material that outputs the xyz position and the color of the
+/// original material in a single pass.
+class OgreDepthCameraMaterialSwitcher : public Ogre::MaterialManager::Listener
+{
+  /// \brief constructor
+  /// \param[in] _material Point cloud material cloned for each original
+  /// material
+  public: explicit OgreDepthCameraMaterialSwitcher(
+      Ogre::MaterialPtr _material);
+
+  /// \brief destructor. Removes the cloned materials
+  public: ~OgreDepthCameraMaterialSwitcher();
+
+  // Documentation inherited.
+  private: Ogre::Technique *handleSchemeNotFound(
+    uint16_t _schemeIndex, const Ogre::String &_schemeName,
+    Ogre::Material *_originalMaterial, uint16_t _lodIndex,
+    const Ogre::Renderable *_rend) override;
+
+  /// \brief Material scheme name
+  public: const std::string schemeName = "depth_points";
+
+  /// \brief Point cloud material
+  private: Ogre::MaterialPtr pcdMaterial;
+
+  /// \brief Clones of the point cloud material, by original material name
+  private: std::map<std::string, Ogre::MaterialPtr> materials;
+};
+}
+}
+}
+
 /// \internal
 /// \brief Private data for the OgreDepthCamera class
 class ignition::rendering::OgreDepthCameraPrivate
@@ -45,14 +90,12 @@ class ignition::rendering::OgreDepthCameraPrivate
   /// \brief Point cloud material
   public: MaterialPtr pcdMaterial = nullptr;
 
-  /// \brief Point cloud texture
+  /// \brief Point cloud texture, holding the xyz position and the packed
+  /// color of each point
   public: OgreRenderTexturePtr pcdTexture;
 
-  /// \brief Point cloud texture
-  public: OgreRenderTexturePtr colorTexture;
-
-  /// \brief Point cloud color data buffer
-  public: unsigned char *colorBuffer = nullptr;
+  /// \brief Switches the materials of the point cloud pass
+  public: std::unique_ptr<OgreDepthCameraMaterialSwitcher> materialSwitcher;
 
   /// \brief True to output point cloud xyz and rgb data
   public: bool outputPoints = false;
@@ -72,11 +115,81 @@ class ignition::rendering::OgreDepthCameraPrivate
   public: ignition::common::EventT<void(const float *,
               unsigned int, unsigned int, unsigned int,
               const std::string &)> newDepthFrame;
+
+  /// \brief Id of the readback client of the point cloud texture, 0 if
+  /// asynchronous readback is disabled
+  public: unsigned int pcdReadbackClient = 0u;
 };
 
 using namespace ignition;
 using namespace rendering;
 
+//////////////////////////////////////////////////
+OgreDepthCameraMaterialSwitcher::OgreDepthCameraMaterialSwitcher(
+    Ogre::MaterialPtr _material)
+  : pcdMaterial(_material)
+{
+}
+
+//////////////////////////////////////////////////
+OgreDepthCameraMaterialSwitcher::~OgreDepthCameraMaterialSwitcher()
+{
+  // the material manager is gone if the render engine was destroyed first
+  Ogre::MaterialManager *manager = Ogre::MaterialManager::getSingletonPtr();
+  if (!manager)
+    return;
+
+  for (auto &it : this->materials)
+    manager->remove(it.second->getName());
+}
+
+//////////////////////////////////////////////////
+/// \brief Ogre callback that assigns material to new renderables
+Ogre::Technique *OgreDepthCameraMaterialSwitcher::handleSchemeNotFound(
+    uint16_t /*_schemeIndex*/, const Ogre::String &_schemeName,
+    Ogre::Material *_originalMaterial, uint16_t /*_lodIndex*/,
+    const Ogre::Renderable * /*_rend*/)
+{
+  if (_schemeName != this->schemeName || !_originalMaterial)
+    return nullptr;
+
+  Ogre::MaterialPtr &material = this->materials[_originalMaterial->getName()];
+  if (!material)
+  {
+    static int pcdMatNameCount = 0;
+    material = this->pcdMaterial->clone(this->pcdMaterial->getName() + "_" +
+        std::to_string(pcdMatNameCount++));
+    material->load();
+  }
+
+  // refresh the color from the original material as it may have changed
+  // since the clone was made
+  Ogre::ColourValue diffuse = Ogre::ColourValue::White;
+  std::string textureName;
+  Ogre::Technique *technique = _originalMaterial->getNumTechniques() > 0u ?
+      _originalMaterial->getTechnique(0) : nullptr;
+  if (technique && technique->getNumPasses() > 0u)
+  {
+    Ogre::Pass *origPass = technique->getPass(0);
+    diffuse = origPass->getDiffuse();
+    if (origPass->getNumTextureUnitStates() > 0u)
+      textureName = origPass->getTextureUnitState(0)->getTextureName();
+  }
+
+  Ogre::Pass *pass = material->getTechnique(0)->getPass(0);
+  if (pass->getNumTextureUnitStates() == 0u)
+    pass->createTextureUnitState();
+  Ogre::TextureUnitState *texUnit = pass->getTextureUnitState(0);
+  if (!textureName.empty() && texUnit->getTextureName() != textureName)
+    texUnit->setTextureName(textureName);
+
+  auto params = pass->getFragmentProgramParameters();
+  params->setNamedConstant("diffuse", diffuse);
+  params->setNamedConstant("hasTexture", textureName.empty() ? 0.0f : 1.0f);
+
+  return material->getSupportedTechnique(0);
+}
+
 //////////////////////////////////////////////////
 OgreDepthCamera::OgreDepthCamera()
   : dataPtr(new OgreDepthCameraPrivate())
@@ -92,23 +205,26 @@ OgreDepthCamera::~OgreDepthCamera()
 //////////////////////////////////////////////////
 void OgreDepthCamera::Destroy()
 {
+  // the queued frames refer to the events of this sensor
+  this->FlushFrames();
+
+  this->SetAsyncReadback(false);
+
   if (this->dataPtr->depthBuffer)
   {
+    MemoryTracker::Untrack(this->dataPtr->depthBuffer);
     delete [] this->dataPtr->depthBuffer;
     this->dataPtr->depthBuffer = nullptr;
   }
 
   if (this->dataPtr->pcdBuffer)
   {
+    MemoryTracker::Untrack(this->dataPtr->pcdBuffer);
     delete [] this->dataPtr->pcdBuffer;
     this->dataPtr->pcdBuffer = nullptr;
   }
 
-  if (this->dataPtr->colorBuffer)
-  {
-    delete [] this->dataPtr->colorBuffer;
-    this->dataPtr->colorBuffer = nullptr;
-  }
+  this->dataPtr->materialSwitcher.reset();
 
   if (!this->ogreCamera || !this->scene->IsInitialized())
     return;
@@ -176,22 +292,10 @@ void OgreDepthCamera::CreateCamera()
 /////////////////////////////////////////////////
 void OgreDepthCamera::CreatePointCloudTexture()
 {
-  if (this->dataPtr->pcdTexture || this->dataPtr->colorTexture)
+  if (this->dataPtr->pcdTexture)
     return;
 
-  // color
-  RenderTexturePtr colorTextureBase = this->scene->CreateRenderTexture();
-  this->dataPtr->colorTexture = std::dynamic_pointer_cast<OgreRenderTexture>(
-      colorTextureBase);
-  this->dataPtr->colorTexture->SetCamera(this->ogreCamera);
-  this->dataPtr->colorTexture->SetFormat(PF_R8G8B8);
-  this->dataPtr->colorTexture->SetWidth(this->ImageWidth());
-  this->dataPtr->colorTexture->SetHeight(this->ImageHeight());
-  this->dataPtr->colorTexture->SetBackgroundColor(
-      this->scene->BackgroundColor());
-  this->dataPtr->colorTexture->PreRender();
-
-  // point cloud xyz
+  // point cloud xyz and color
   RenderTexturePtr pcdTextureBase = this->scene->CreateRenderTexture();
   this->dataPtr->pcdTexture = std::dynamic_pointer_cast<OgreRenderTexture>(
       pcdTextureBase);
@@ -219,7 +323,13 @@ void OgreDepthCamera::CreatePointCloudTexture()
   this->dataPtr->pcdMaterial->SetVertexShader(pcdVSPath);
   this->dataPtr->pcdMaterial->SetFragmentShader(pcdFSPath);
 
-  this->dataPtr->pcdTexture->SetMaterial(this->dataPtr->pcdMaterial);
+  // the color of each point is taken from the original material in the same
+  // pass as its position instead of rendering the scene a second time
+  OgreMaterialPtr ogreMat =
+      std::dynamic_pointer_cast<OgreMaterial>(this->dataPtr->pcdMaterial);
+  this->dataPtr->materialSwitcher.reset(
+      new OgreDepthCameraMaterialSwitcher(ogreMat->Material()));
+
   this->dataPtr->pcdTexture->PreRender();
 }
 
@@ -258,7 +368,7 @@ void OgreDepthCamera::PreRender()
 {
   if (!this->depthTexture)
     this->CreateDepthTexture();
-  if (!this->dataPtr->pcdTexture || !this->dataPtr->colorTexture)
+  if (!this->dataPtr->pcdTexture)
     this->CreatePointCloudTexture();
 }
 
@@ -268,29 +378,29 @@ void OgreDepthCamera::Render()
   Ogre::SceneManager *sceneMgr = this->scene->OgreSceneManager();
   Ogre::ShadowTechnique shadowTech = sceneMgr->getShadowTechnique();
 
-  // point cloud xyz and depth
+  // point cloud xyz, color and depth
   sceneMgr->setShadowTechnique(Ogre::SHADOWTYPE_NONE);
-  sceneMgr->_suppressRenderStateChanges(true);
 
   this->dataPtr->pcdTexture->SetAutoUpdated(false);
   OgreMaterialPtr ogreMat =
       std::dynamic_pointer_cast<OgreMaterial>(this->dataPtr->pcdMaterial);
   this->UpdateRenderTarget(this->dataPtr->pcdTexture,
       ogreMat->Material().get(), ogreMat->Material()->getName());
-  this->dataPtr->pcdTexture->RenderTarget()->update(false);
 
-  sceneMgr->_suppressRenderStateChanges(false);
+  Ogre::RenderTarget *rt = this->dataPtr->pcdTexture->RenderTarget();
+  rt->getViewport(0)->setMaterialScheme(
+      this->dataPtr->materialSwitcher->schemeName);
+  Ogre::MaterialManager::getSingleton().addListener(
+      this->dataPtr->materialSwitcher.get());
+  rt->update(false);
+  Ogre::MaterialManager::getSingleton().removeListener(
+      this->dataPtr->materialSwitcher.get());
+
   sceneMgr->setShadowTechnique(shadowTech);
 
-  // skip color pass if we do not need to output point clouds
+  // skip point cloud processing if there are no listeners
   this->dataPtr->outputPoints =
       (this->dataPtr->newRgbPointCloud.ConnectionCount() > 0);
-  if (!this->dataPtr->outputPoints)
-    return;
-
-  // color
-  this->dataPtr->colorTexture->SetAutoUpdated(false);
-  this->dataPtr->colorTexture->Render();
 }
 
 //////////////////////////////////////////////////
@@ -376,33 +486,53 @@ void OgreDepthCamera::PostRender()
 
   // get depth data
   if (!this->dataPtr->depthBuffer)
+  {
     this->dataPtr->depthBuffer = new float[len];
+    MemoryTracker::Track(MC_SENSOR_BUFFER, this->dataPtr->depthBuffer,
+        len * sizeof(float));
+  }
   PixelFormat format = this->dataPtr->pcdTexture->Format();
   unsigned int channelCount = PixelUtil::ChannelCount(format);
   if (!this->dataPtr->pcdBuffer)
+  {
     this->dataPtr->pcdBuffer = new float[len * channelCount];
-  this->dataPtr->pcdTexture->Buffer(this->dataPtr->pcdBuffer);
+    MemoryTracker::Track(MC_SENSOR_BUFFER, this->dataPtr->pcdBuffer,
+        len * channelCount * sizeof(float));
+  }
 
-  // color data
-  unsigned int colorChannelCount = 3;
+  // background color
   int bgColorR = static_cast<int>(this->scene->BackgroundColor().R() * 255);
   int bgColorG = static_cast<int>(this->scene->BackgroundColor().G() * 255);
   int bgColorB = static_cast<int>(this->scene->BackgroundColor().B() * 255);
   int bgColorA = static_cast<int>(this->scene->BackgroundColor().A() * 255);
-  if (this->dataPtr->outputPoints)
-  {
-    PixelFormat colorFormat = this->dataPtr->colorTexture->Format();
-    colorChannelCount = PixelUtil::ChannelCount(colorFormat);
-
-    if (!this->dataPtr->colorBuffer)
-      this->dataPtr->colorBuffer = new unsigned char[len * colorChannelCount];
+  bool outputPoints = this->dataPtr->outputPoints;
 
-    Ogre::PixelBox ogrePixelBox(width, height, 1,
-        OgreConversions::Convert(colorFormat), this->dataPtr->colorBuffer);
-    this->dataPtr->colorTexture->RenderTarget()->copyContentsToMemory(
-        ogrePixelBox);
+  if (this->dataPtr->pcdReadbackClient)
+  {
+    // queue a copy of the frame that has just been rendered and retrieve a
+    // previous one so the transfer overlaps with the next render
+    auto readback = OgreReadbackManager::Instance();
+    this->dataPtr->pcdTexture->RenderTarget()->swapBuffers();
+    if (!readback->Request(this->dataPtr->pcdReadbackClient,
+        this->dataPtr->pcdTexture->OgreTexture(),
+        OgreConversions::Convert(format)))
+    {
+      ignwarn << "Asynchronous readback failed for depth camera ["
+              << this->Name() << "], falling back to blocking readback"
+              << std::endl;
+      this->SetAsyncReadback(false);
+    }
+    else if (!readback->Retrieve(this->dataPtr->pcdReadbackClient,
+        this->dataPtr->pcdBuffer, len * channelCount * sizeof(float)))
+    {
+      // no frame available yet
+      return;
+    }
   }
 
+  if (!this->dataPtr->pcdReadbackClient)
+    this->dataPtr->pcdTexture->Buffer(this->dataPtr->pcdBuffer);
+
   // fill depthBuffer and clamp values
   // \todo(anyone) figure out how to do this in shaders?
   for (unsigned int i = 0; i < height; ++i)
@@ -424,7 +554,7 @@ void OgreDepthCamera::PostRender()
       {
         clamp = true;
         depth = this->dataPtr->dataMaxVal;
-        if (this->dataPtr->outputPoints)
+        if (outputPoints)
         {
           *x = this->dataPtr->dataMaxVal;
           *y = this->dataPtr->dataMaxVal;
@@ -437,7 +567,7 @@ void OgreDepthCamera::PostRender()
       {
         clamp = true;
         depth = this->dataPtr->dataMinVal;
-        if (this->dataPtr->outputPoints)
+        if (outputPoints)
         {
           *x = this->dataPtr->dataMinVal;
           *y = this->dataPtr->dataMinVal;
@@ -447,9 +577,8 @@ void OgreDepthCamera::PostRender()
       this->dataPtr->depthBuffer[step + j] = depth;
 
       // color
-      if (this->dataPtr->outputPoints)
+      if (outputPoints)
       {
-        unsigned int colorStep = step * colorChannelCount;
         int r = 0;
         int g = 0;
         int b = 0;
@@ -464,9 +593,13 @@ void OgreDepthCamera::PostRender()
         }
         else
         {
-          r = this->dataPtr->colorBuffer[colorStep + j*colorChannelCount];
-          g = this->dataPtr->colorBuffer[colorStep + j*colorChannelCount + 1];
-          b = this->dataPtr->colorBuffer[colorStep + j*colorChannelCount + 2];
+          // the shader packs the 8 bit color channels into an integer value
+          // that a 32 bit float holds exactly
+          uint32_t packed = static_cast<uint32_t>(
+              std::min(std::max(*color, 0.0f), 16777215.0f));
+          r = (packed >> 16) & 0xFF;
+          g = (packed >> 8) & 0xFF;
+          b = packed & 0xFF;
         }
         uint32_t rgba = (static_cast<uint8_t>(r) << 24) +
                         (static_cast<uint8_t>(g) << 16) +
@@ -479,15 +612,15 @@ void OgreDepthCamera::PostRender()
     }
   }
 
-  this->dataPtr->newDepthFrame(
-      this->dataPtr->depthBuffer, width, height, 1, "FLOAT32");
+  this->DispatchFrame(this->dataPtr->newDepthFrame,
+      this->dataPtr->depthBuffer, len, width, height, 1, "FLOAT32");
 
   // point cloud
-  if (this->dataPtr->outputPoints)
+  if (outputPoints)
   {
-    this->dataPtr->newRgbPointCloud(
-        this->dataPtr->pcdBuffer, width, height, channelCount,
-        "PF_FLOAT32_RGBA");
+    this->DispatchFrame(this->dataPtr->newRgbPointCloud,
+        this->dataPtr->pcdBuffer, len * channelCount, width, height,
+        channelCount, "PF_FLOAT32_RGBA");
 
     // Uncomment to debug xyz output
     // igndbg << "wxh: " << width << " x " << height << std::endl;
@@ -521,6 +654,35 @@ void OgreDepthCamera::PostRender()
   }
 }
 
+//////////////////////////////////////////////////
+void OgreDepthCamera::SetAsyncReadback(bool _enabled)
+{
+  auto readback = OgreReadbackManager::Instance();
+  if (!_enabled)
+  {
+    readback->DestroyClient(this->dataPtr->pcdReadbackClient);
+    this->dataPtr->pcdReadbackClient = 0u;
+    return;
+  }
+
+  if (this->dataPtr->pcdReadbackClient)
+    return;
+
+  this->dataPtr->pcdReadbackClient = readback->CreateClient();
+  if (!this->dataPtr->pcdReadbackClient)
+  {
+    ignwarn << "Asynchronous readback is not supported by the current "
+            << "render system. Depth camera [" << this->Name() << "] will "
+            << "use blocking readback" << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+bool OgreDepthCamera::AsyncReadback() const
+{
+  return this->dataPtr->pcdReadbackClient != 0u;
+}
+
 //////////////////////////////////////////////////
 const float *OgreDepthCamera::DepthData() const
 {
@@ -23,10 +23,13 @@
 #include <ignition/math/Helpers.hh>
 #include <ignition/math/Vector3.hh>
 
+#include "ignition/rendering/MemoryTracker.hh"
 #include "ignition/rendering/RenderTypes.hh"
 #include "ignition/rendering/ogre/OgreCamera.hh"
 #include "ignition/rendering/ogre/OgreGpuRays.hh"
 
+#include "OgreReadbackManager.hh"
+
 /// \internal
 /// \brief Private data for the OgreGpuRays class
 class ignition::rendering::OgreGpuRaysPrivate
@@ -124,6 +127,10 @@ class ignition::rendering::OgreGpuRaysPrivate
 
   /// \brief Number of cameras needed to generate the rays.
   public: unsigned int cameraCount = 1;
+
+  /// \brief Id of the readback client, 0 if asynchronous readback is
+  /// disabled
+  public: unsigned int readbackClient = 0u;
 };
 
 using namespace ignition;
@@ -158,14 +165,21 @@ void OgreGpuRays::Init()
 //////////////////////////////////////////////////
 void OgreGpuRays::Destroy()
 {
+  // the queued frames refer to the events of this sensor
+  this->FlushFrames();
+
+  this->SetAsyncReadback(false);
+
   if (this->dataPtr->gpuRaysBuffer)
   {
+    MemoryTracker::Untrack(this->dataPtr->gpuRaysBuffer);
     delete [] this->dataPtr->gpuRaysBuffer;
     this->dataPtr->gpuRaysBuffer = nullptr;
   }
 
   if (this->dataPtr->gpuRaysScan)
   {
+    MemoryTracker::Untrack(this->dataPtr->gpuRaysScan);
     delete [] this->dataPtr->gpuRaysScan;
     this->dataPtr->gpuRaysScan = nullptr;
   }
@@ -650,23 +664,81 @@ void OgreGpuRays::PostRender()
   if (!this->dataPtr->gpuRaysBuffer)
   {
     this->dataPtr->gpuRaysBuffer = new float[len];
+    MemoryTracker::Track(MC_SENSOR_BUFFER, this->dataPtr->gpuRaysBuffer,
+        len * sizeof(float));
   }
 
-  Ogre::PixelBox dstBox(width, height,
-        1, Ogre::PF_FLOAT32_RGB, this->dataPtr->gpuRaysBuffer);
+  if (this->dataPtr->readbackClient)
+  {
+    // queue a copy of the frame that has just been rendered and retrieve a
+    // previous one so the transfer overlaps with the next render
+    auto readback = OgreReadbackManager::Instance();
+    if (!readback->Request(this->dataPtr->readbackClient,
+        this->dataPtr->secondPassTexture, Ogre::PF_FLOAT32_RGB))
+    {
+      ignwarn << "Asynchronous readback failed for gpu rays ["
+              << this->Name() << "], falling back to blocking readback"
+              << std::endl;
+      this->SetAsyncReadback(false);
+    }
+    else if (!readback->Retrieve(this->dataPtr->readbackClient,
+        this->dataPtr->gpuRaysBuffer, size))
+    {
+      // no frame available yet
+      return;
+    }
+  }
 
-  auto pixelBuffer = this->dataPtr->secondPassTexture->getBuffer();
-  pixelBuffer->blitToMemory(dstBox);
+  if (!this->dataPtr->readbackClient)
+  {
+    Ogre::PixelBox dstBox(width, height,
+          1, Ogre::PF_FLOAT32_RGB, this->dataPtr->gpuRaysBuffer);
+
+    auto pixelBuffer = this->dataPtr->secondPassTexture->getBuffer();
+    pixelBuffer->blitToMemory(dstBox);
+  }
 
   if (!this->dataPtr->gpuRaysScan)
   {
     this->dataPtr->gpuRaysScan = new float[len];
+    MemoryTracker::Track(MC_SENSOR_BUFFER, this->dataPtr->gpuRaysScan,
+        len * sizeof(float));
   }
 
   memcpy(this->dataPtr->gpuRaysScan, this->dataPtr->gpuRaysBuffer, size);
 
-  this->dataPtr->newGpuRaysFrame(this->dataPtr->gpuRaysScan,
-      width, height, this->Channels(), "PF_FLOAT32_RGB");
+  this->DispatchFrame(this->dataPtr->newGpuRaysFrame,
+      this->dataPtr->gpuRaysScan, len, width, height, this->Channels(),
+      "PF_FLOAT32_RGB");
+}
+
+//////////////////////////////////////////////////
+void OgreGpuRays::SetAsyncReadback(bool _enabled)
+{
+  auto readback = OgreReadbackManager::Instance();
+  if (!_enabled)
+  {
+    readback->DestroyClient(this->dataPtr->readbackClient);
+    this->dataPtr->readbackClient = 0u;
+    return;
+  }
+
+  if (this->dataPtr->readbackClient)
+    return;
+
+  this->dataPtr->readbackClient = readback->CreateClient();
+  if (!this->dataPtr->readbackClient)
+  {
+    ignwarn << "Asynchronous readback is not supported by the current "
+            << "render system. Gpu rays [" << this->Name() << "] will use "
+            << "blocking readback" << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+bool OgreGpuRays::AsyncReadback() const
+{
+  return this->dataPtr->readbackClient != 0u;
 }
 
 //////////////////////////////////////////////////
@@ -15,7 +15,20 @@
  *
 */
 
+#include <sys/stat.h>
+
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <ignition/common/Console.hh>
 #include <ignition/common/Util.hh>
@@ -309,6 +322,74 @@ class DummyPageProvider : public Ogre::PageProvider
   }
 };
 
+/// \brief Ogre data stream writing to memory. It is used to snapshot a
+/// terrain on the render thread before writing it to disk in the
+/// background.
+class TerrainMemoryStream : public Ogre::DataStream
+{
+  /// \brief Constructor
+  public: TerrainMemoryStream()
+      : Ogre::DataStream(static_cast<Ogre::uint16>(Ogre::DataStream::WRITE))
+  {
+  }
+
+  // Documentation inherited
+  public: size_t read(void *_buf, size_t _count) override
+  {
+    size_t count = std::min(_count, this->data.size() - this->pos);
+    std::memcpy(_buf, this->data.data() + this->pos, count);
+    this->pos += count;
+    return count;
+  }
+
+  // Documentation inherited
+  public: size_t write(const void *_buf, size_t _count) override
+  {
+    if (this->pos + _count > this->data.size())
+      this->data.resize(this->pos + _count);
+    std::memcpy(this->data.data() + this->pos, _buf, _count);
+    this->pos += _count;
+    this->mSize = this->data.size();
+    return _count;
+  }
+
+  // Documentation inherited
+  public: void skip(long _count) override
+  {
+    long pos = static_cast<long>(this->pos) + _count;
+    this->seek(static_cast<size_t>(std::max(pos, 0l)));
+  }
+
+  // Documentation inherited
+  public: void seek(size_t _pos) override
+  {
+    this->pos = std::min(_pos, this->data.size());
+  }
+
+  // Documentation inherited
+  public: size_t tell() const override
+  {
+    return this->pos;
+  }
+
+  // Documentation inherited
+  public: bool eof() const override
+  {
+    return this->pos >= this->data.size();
+  }
+
+  // Documentation inherited
+  public: void close() override
+  {
+  }
+
+  /// \brief Bytes written to the stream
+  public: std::vector<char> data;
+
+  /// \brief Read and write position in the stream
+  public: size_t pos{0u};
+};
+
 //////////////////////////////////////////////////
 class ignition::rendering::OgreHeightmapPrivate
 {
@@ -350,6 +431,10 @@ class ignition::rendering::OgreHeightmapPrivate
   /// loaded using paging.
   public: const std::string kHashFilename{"ignterrain.SHA1"};
 
+  /// \brief Cache key file name. The key is cheap to compute and lets warm
+  /// starts use the terrain files without hashing the heights first.
+  public: const std::string kKeyFilename{"ignterrain.key"};
+
   /// \brief Collection of terrains. Every terrain might be paged.
   public: std::vector<std::vector<float>> subTerrains;
 
@@ -406,8 +491,44 @@ class ignition::rendering::OgreHeightmapPrivate
   /// \brief Pointer to the terrain material generator.
   public: IgnTerrainMatGen *ignMatGen{nullptr};
 #endif
+
+  /// \brief Background verification of the terrain hash, started when the
+  /// terrain files were validated by the cache key only.
+  public: std::future<void> hashCheck;
+
+  /// \brief True if saving the terrain to the cache started
+  public: bool saveStarted{false};
+
+  /// \brief Time saving the terrain to the cache started
+  public: std::chrono::steady_clock::time_point saveStartTime;
+
+  /// \brief Slots of the terrains that still have to be saved to the cache
+  public: std::vector<std::pair<long, long>> terrainsToSave;
+
+  /// \brief Background jobs writing terrains to the cache. Each returns
+  /// true if its terrain was written.
+  public: std::vector<std::future<bool>> saveJobs;
 };
 
+/// \brief Read the content of a terrain file
+/// \param[in] _path Path to the file
+/// \param[out] _content Content of the file
+/// \return True if the file was read
+static bool readTerrainFile(const std::string &_path, std::string &_content)
+{
+  if (!common::exists(_path))
+    return false;
+
+  std::ifstream in(_path.c_str());
+  if (!in.is_open())
+    return false;
+
+  std::stringstream buffer;
+  buffer << in.rdbuf();
+  _content = buffer.str();
+  return true;
+}
+
 Ogre::TerrainGlobalOptions
     *ignition::rendering::OgreHeightmapPrivate::terrainGlobals = nullptr;
 
@@ -429,6 +550,13 @@ OgreHeightmap::OgreHeightmap(const HeightmapDescriptor &_desc)
 //////////////////////////////////////////////////
 OgreHeightmap::~OgreHeightmap()
 {
+  // the hash check reads the heights
+  if (this->dataPtr->hashCheck.valid())
+    this->dataPtr->hashCheck.wait();
+
+  // finish writing the cache, a partial terrain file would not be valid
+  for (auto &job : this->dataPtr->saveJobs)
+    job.wait();
 }
 
 //////////////////////////////////////////////////
@@ -697,6 +825,9 @@ void OgreHeightmap::PreRender()
     return;
   }
 
+  // the terrain is loaded and saved over several frames
+  this->MarkPreRenderDirty();
+
   // Make sure the heightmap finishes loading by processing responses until all
   // derived data and terrains are loaded
   if (this->dataPtr->terrainGroup->isDerivedDataUpdateInProgress())
@@ -722,29 +853,99 @@ void OgreHeightmap::PreRender()
     return;
   }
 
+  this->UpdateTerrainSave();
+}
+
+//////////////////////////////////////////////////
+void OgreHeightmap::UpdateTerrainSave()
+{
   // saving an ogre terrain data file can take quite some time for large
-  // terrains.
-  ignmsg << "Saving heightmap cache data to "
-         << common::joinPaths(this->dataPtr->pagingDir, this->descriptor.Name())
-         << std::endl;
-  auto time = std::chrono::steady_clock::now();
+  // terrains, so the terrains are written in the background
+  if (!this->dataPtr->saveStarted)
+  {
+    ignmsg << "Saving heightmap cache data to "
+           << common::joinPaths(this->dataPtr->pagingDir,
+           this->descriptor.Name()) << std::endl;
+    this->dataPtr->saveStartTime = std::chrono::steady_clock::now();
+    this->dataPtr->saveStarted = true;
 
-  bool saved{false};
-  try
+    auto ti = this->dataPtr->terrainGroup->getTerrainIterator();
+    while (ti.hasMoreElements())
+    {
+      auto *slot = ti.getNext();
+      if (slot->instance && slot->instance->isModified())
+        this->dataPtr->terrainsToSave.push_back({slot->x, slot->y});
+    }
+  }
+
+  // Snapshot one terrain per frame. Reading back its derived data has to be
+  // done on the render thread, writing it to disk does not.
+  if (!this->dataPtr->terrainsToSave.empty())
   {
-    this->dataPtr->terrainGroup->saveAllTerrains(true);
-    saved = true;
+    auto slot = this->dataPtr->terrainsToSave.front();
+    this->dataPtr->terrainsToSave.erase(
+        this->dataPtr->terrainsToSave.begin());
+
+    Ogre::Terrain *terrain =
+        this->dataPtr->terrainGroup->getTerrain(slot.first, slot.second);
+    if (!terrain)
+      return;
+
+    std::string filename = this->dataPtr->terrainGroup->generateFilename(
+        slot.first, slot.second);
+    auto memoryStream = OGRE_NEW TerrainMemoryStream();
+    Ogre::DataStreamPtr stream(memoryStream);
+    try
+    {
+      Ogre::StreamSerialiser serialiser(stream);
+      terrain->save(serialiser);
+    }
+    catch(Ogre::Exception &_e)
+    {
+      ignerr << "Failed to save heightmap: " << _e.what() << std::endl;
+      return;
+    }
+
+    std::vector<char> data = std::move(memoryStream->data);
+    this->dataPtr->saveJobs.push_back(std::async(std::launch::async,
+        [data = std::move(data), filename]()
+        {
+          // write to a temporary file first so a terrain file is never
+          // loaded partially written
+          std::string tmpFile = filename + ".tmp";
+          std::ofstream file(tmpFile, std::ios::out | std::ios::binary);
+          file.write(data.data(), static_cast<std::streamsize>(data.size()));
+          file.close();
+          if (!file || std::rename(tmpFile.c_str(), filename.c_str()) != 0)
+          {
+            ignerr << "Failed to save heightmap: unable to write ["
+                   << filename << "]" << std::endl;
+            std::remove(tmpFile.c_str());
+            return false;
+          }
+          return true;
+        }));
+    return;
   }
-  catch(Ogre::Exception &_e)
+
+  // wait for the writes without blocking the frame
+  for (auto &job : this->dataPtr->saveJobs)
   {
-    ignerr << "Failed to save heightmap: " << _e.what() << std::endl;
+    if (job.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+      return;
   }
 
+  bool saved{true};
+  for (auto &job : this->dataPtr->saveJobs)
+    saved = job.get() && saved;
+  this->dataPtr->saveJobs.clear();
+
   if (saved)
   {
     ignmsg << "Heightmap cache data saved. Process took "
           <<  std::chrono::duration_cast<std::chrono::milliseconds>(
-              std::chrono::steady_clock::now() - time).count()
+              std::chrono::steady_clock::now() -
+              this->dataPtr->saveStartTime).count()
           << " ms." << std::endl;
   }
 
@@ -819,17 +1020,69 @@ void OgreHeightmap::ConfigureTerrainDefaults()
   }
 }
 
+//////////////////////////////////////////////////
+std::string OgreHeightmap::TerrainCacheKey() const
+{
+  std::string filename = this->descriptor.Data()->Filename();
+  struct stat fileStat;
+  if (filename.empty() || stat(filename.c_str(), &fileStat) != 0)
+    return std::string();
+
+  // anything the terrain files are generated from, except the heights
+  // which are only checked by the hash
+  std::stringstream key;
+  key << "version 1" << std::endl
+      << "file " << filename << std::endl
+      << "modified " << static_cast<int64_t>(fileStat.st_mtime) << std::endl
+      << "bytes " << static_cast<int64_t>(fileStat.st_size) << std::endl
+      << "width " << this->descriptor.Data()->Width() << std::endl
+      << "sampling " << this->descriptor.Sampling() << std::endl
+      << "size " << this->descriptor.Size() << std::endl
+      << "position " << this->descriptor.Position() << std::endl
+      << "data size " << this->dataPtr->dataSize << std::endl
+      << "paging " << this->descriptor.UseTerrainPaging() << std::endl
+      << "subdivisions " << this->dataPtr->numTerrainSubdivisions << std::endl;
+  return key.str();
+}
+
 //////////////////////////////////////////////////
 bool OgreHeightmap::PrepareTerrain(
     const std::string &_terrainDirPath)
 {
+  auto terrainHashFullPath = common::joinPaths(_terrainDirPath,
+      this->dataPtr->kHashFilename);
+  auto terrainKeyFullPath = common::joinPaths(_terrainDirPath,
+      this->dataPtr->kKeyFilename);
+
+  // Hashing the heights of a large terrain takes seconds. If the cache key
+  // matches, use the terrain files right away and only verify the hash in the
+  // background. A mismatch invalidates the key so the next load regenerates
+  // the terrain files.
+  std::string key = this->TerrainCacheKey();
+  std::string terrainKey;
+  std::string terrainHash;
+  if (!key.empty() && readTerrainFile(terrainKeyFullPath, terrainKey) &&
+      terrainKey == key && readTerrainFile(terrainHashFullPath, terrainHash))
+  {
+    const std::vector<float> *heights = &this->dataPtr->heights;
+    this->dataPtr->hashCheck = std::async(std::launch::async,
+        [heights, terrainHash, terrainKeyFullPath]()
+        {
+          if (common::sha1<std::vector<float>>(*heights) == terrainHash)
+            return;
+
+          ignwarn << "Heightmap cache data is out of date. It will be "
+                  << "regenerated the next time the heightmap is loaded."
+                  << std::endl;
+          common::removeFile(terrainKeyFullPath);
+        });
+    return false;
+  }
+
   // Compute the original heightmap's image.
   auto heightmapHash = common::sha1<std::vector<float>>(this->dataPtr->heights);
 
   // Check if the terrain hash exists
-  auto terrainHashFullPath = common::joinPaths(_terrainDirPath,
-      this->dataPtr->kHashFilename);
-
   bool updateHash = true;
   if (common::exists(terrainHashFullPath))
   {
@@ -839,7 +1092,7 @@ bool OgreHeightmap::PrepareTerrain(
       std::ifstream in(terrainHashFullPath.c_str());
       std::stringstream buffer;
       buffer << in.rdbuf();
-      std::string terrainHash(buffer.str());
+      terrainHash = buffer.str();
       updateHash = terrainHash != heightmapHash;
     }
     catch(std::ifstream::failure &_e)
@@ -855,6 +1108,18 @@ bool OgreHeightmap::PrepareTerrain(
     this->UpdateTerrainHash(heightmapHash, _terrainDirPath);
   }
 
+  // Store the key of the validated terrain files for the next load
+  if (!key.empty())
+  {
+    common::createDirectories(_terrainDirPath);
+    std::ofstream terrainKeyFile(terrainKeyFullPath.c_str());
+    if (terrainKeyFile.is_open())
+      terrainKeyFile << key;
+    else
+      ignerr << "Unable to open file for creating a terrain cache key: ["
+             << terrainKeyFullPath << "]" << std::endl;
+  }
+
   return updateHash;
 }
 
@@ -1092,25 +1357,64 @@ bool OgreHeightmap::InitBlendMaps(Ogre::Terrain *_terrain)
     pBlend.push_back(blendMaps[i]->getBlendPointer());
   }
 
-  // Set the blend values based on the height of the terrain
-  Ogre::Real val, height;
-  for (Ogre::uint16 y = 0; y < _terrain->getLayerBlendMapSize(); ++y)
+  std::vector<Ogre::Real> minHeights;
+  std::vector<Ogre::Real> fadeDistances;
+  for (i = 0; i < this->descriptor.BlendCount(); ++i)
   {
-    for (Ogre::uint16 x = 0; x < _terrain->getLayerBlendMapSize(); ++x)
-    {
-      Ogre::Real tx, ty;
-
-      blendMaps[0]->convertImageToTerrainSpace(x, y, &tx, &ty);
-      height = _terrain->getHeightAtTerrainPosition(tx, ty);
+    auto blend = this->descriptor.BlendByIndex(i);
+    minHeights.push_back(static_cast<Ogre::Real>(blend->MinHeight()));
+    fadeDistances.push_back(static_cast<Ogre::Real>(blend->FadeDistance()));
+  }
 
-      for (i = 0; i < this->descriptor.BlendCount(); ++i)
+  // Set the blend values based on the height of the terrain. Rows only read
+  // the terrain heights and write their own part of the blend maps, so they
+  // are computed in parallel.
+  Ogre::uint16 blendMapSize = _terrain->getLayerBlendMapSize();
+  Ogre::TerrainLayerBlendMap *blendMap = blendMaps[0];
+  auto computeRows = [&](Ogre::uint16 _start, Ogre::uint16 _end)
+  {
+    for (Ogre::uint16 y = _start; y < _end; ++y)
+    {
+      size_t offset = static_cast<size_t>(y) * blendMapSize;
+      for (Ogre::uint16 x = 0; x < blendMapSize; ++x, ++offset)
       {
-        auto blend = this->descriptor.BlendByIndex(i);
-        val = (height - blend->MinHeight()) / blend->FadeDistance();
-        val = Ogre::Math::Clamp(val, (Ogre::Real)0, (Ogre::Real)1);
-        *pBlend[i]++ = val;
+        Ogre::Real tx, ty;
+        blendMap->convertImageToTerrainSpace(x, y, &tx, &ty);
+        Ogre::Real height = _terrain->getHeightAtTerrainPosition(tx, ty);
+
+        for (size_t b = 0u; b < pBlend.size(); ++b)
+        {
+          Ogre::Real val = (height - minHeights[b]) / fadeDistances[b];
+          pBlend[b][offset] =
+              Ogre::Math::Clamp(val, (Ogre::Real)0, (Ogre::Real)1);
+        }
       }
     }
+  };
+
+  // only spread the work across threads when there is enough of it to
+  // make up for the cost of starting them
+  const size_t minRowsPerThread = 64u;
+  size_t threadCount = std::min<size_t>(
+      std::max(1u, std::thread::hardware_concurrency()),
+      blendMapSize / minRowsPerThread);
+  if (threadCount <= 1u)
+  {
+    computeRows(0u, blendMapSize);
+  }
+  else
+  {
+    size_t chunk = (blendMapSize + threadCount - 1u) / threadCount;
+    std::vector<std::thread> threads;
+    for (size_t t = 1u; t < threadCount; ++t)
+    {
+      size_t end = std::min<size_t>(blendMapSize, (t + 1u) * chunk);
+      threads.emplace_back(computeRows, static_cast<Ogre::uint16>(t * chunk),
+          static_cast<Ogre::uint16>(end));
+    }
+    computeRows(0u, static_cast<Ogre::uint16>(chunk));
+    for (auto &thread : threads)
+      thread.join();
   }
 
   // Make sure the blend maps are properly updated
@@ -203,6 +203,7 @@ void OgreMarker::SetPoint(unsigned int _index,
     const ignition::math::Vector3d &_value)
 {
   this->dataPtr->dynamicRenderable->SetPoint(_index, _value);
+  this->MarkPreRenderDirty();
 }
 
 //////////////////////////////////////////////////
@@ -210,12 +211,14 @@ void OgreMarker::AddPoint(const ignition::math::Vector3d &_pt,
     const ignition::math::Color &_color)
 {
   this->dataPtr->dynamicRenderable->AddPoint(_pt, _color);
+  this->MarkPreRenderDirty();
 }
 
 //////////////////////////////////////////////////
 void OgreMarker::ClearPoints()
 {
   this->dataPtr->dynamicRenderable->Clear();
+  this->MarkPreRenderDirty();
 }
 
 //////////////////////////////////////////////////
@@ -325,6 +325,11 @@ void OgreMaterial::SetShaderType(enum ShaderType _type)
 void OgreMaterial::PreRender()
 {
   this->UpdateShaderParams();
+
+  // shader params are changed without notifying the material, so it has to
+  // be checked again next frame
+  if (this->vertexShaderParams || this->fragmentShaderParams)
+    this->MarkPreRenderDirty();
 }
 
 //////////////////////////////////////////////////
@@ -15,6 +15,8 @@
  *
  */
 
+#include <algorithm>
+
 #include <ignition/common/Console.hh>
 
 #include "ignition/rendering/ogre/OgreConversions.hh"
@@ -118,6 +120,51 @@ void OgreMesh::SetSkeletonLocalTransforms(
   }
 }
 
+//////////////////////////////////////////////////
+std::vector<std::string> OgreMesh::SkeletonBoneNames() const
+{
+  std::vector<std::string> names;
+  if (!this->ogreEntity->hasSkeleton())
+    return names;
+
+  Ogre::SkeletonInstance *skel = this->ogreEntity->getSkeleton();
+  names.reserve(skel->getNumBones());
+  for (unsigned int i = 0; i < skel->getNumBones(); ++i)
+    names.push_back(skel->getBone(i)->getName());
+  return names;
+}
+
+//////////////////////////////////////////////////
+unsigned int OgreMesh::SkeletonBoneCount() const
+{
+  if (!this->ogreEntity->hasSkeleton())
+    return 0u;
+  return this->ogreEntity->getSkeleton()->getNumBones();
+}
+
+//////////////////////////////////////////////////
+void OgreMesh::SetSkeletonBoneTransforms(const math::Matrix4f *_tfs,
+    unsigned int _count)
+{
+  if (!_tfs || !this->ogreEntity->hasSkeleton())
+    return;
+
+  Ogre::SkeletonInstance *skel = this->ogreEntity->getSkeleton();
+  unsigned int count = std::min<unsigned int>(_count, skel->getNumBones());
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    Ogre::Bone *bone = skel->getBone(i);
+    if (!bone->isManuallyControlled())
+      bone->setManuallyControlled(true);
+
+    const math::Matrix4f &tf = _tfs[i];
+    math::Quaternionf rot = tf.Rotation();
+    bone->setPosition(Ogre::Vector3(tf(0, 3), tf(1, 3), tf(2, 3)));
+    bone->setOrientation(Ogre::Quaternion(rot.W(), rot.X(), rot.Y(),
+        rot.Z()));
+  }
+}
+
 //////////////////////////////////////////////////
 void OgreMesh::SetSkeletonAnimationEnabled(const std::string &_name,
     bool _enabled, bool _loop, float _weight)
@@ -230,19 +277,16 @@ void OgreMesh::UpdateSkeletonAnimation(
 {
   Ogre::AnimationStateSet *animationStateSet =
       this->ogreEntity->getAllAnimationStates();
+  if (!animationStateSet)
+    return;
 
-  auto it = animationStateSet->getAnimationStateIterator();
+  // only the enabled animations are visited
+  auto seconds =
+      std::chrono::duration_cast<std::chrono::milliseconds>(_time).count() /
+      1000.0;
+  auto it = animationStateSet->getEnabledAnimationStateIterator();
   while (it.hasMoreElements())
-  {
-    Ogre::AnimationState *anim = it.getNext();
-    if (anim->getEnabled())
-    {
-      auto seconds =
-          std::chrono::duration_cast<std::chrono::milliseconds>(_time).count() /
-          1000.0;
-      anim->setTimePosition(seconds);
-    }
-  }
+    it.getNext()->setTimePosition(seconds);
 
   // this workaround is needed for ogre 1.x because we are doing manual
   // render updates.
@@ -309,6 +353,9 @@ void OgreSubMesh::SetMaterialImpl(MaterialPtr _material)
 
   // set cast shadows
   this->ogreSubEntity->getParent()->setCastShadows(_material->CastShadows());
+
+  // generate the shaders of the new material in the next update
+  OgreRTShaderSystem::Instance()->AttachEntity(this);
 }
 
 //////////////////////////////////////////////////
@@ -20,8 +20,12 @@
   #include <Winsock2.h>
 #endif
 
+#include <fstream>
+#include <functional>
+#include <iomanip>
 #include <mutex>
 #include <set>
+#include <sstream>
 #include <vector>
 
 #include <ignition/common/Console.hh>
@@ -46,6 +50,14 @@ class ignition::rendering::OgreRTShaderSystemPrivate
   /// \brief All the entites being used.
   public: std::set<OgreSubMesh *> entities;
 
+  /// \brief Entities attached since the last update, which shaders have
+  /// not been generated yet.
+  public: std::set<OgreSubMesh *> pendingEntities;
+
+  /// \brief File the compiled shader programs are saved to, empty if the
+  /// render system can not give back compiled programs.
+  public: std::string microcodeCacheFile;
+
   /// \brief True if initialized.
   public: bool initialized;
 
@@ -126,6 +138,38 @@ bool OgreRTShaderSystem::Init()
     // Set shader cache path.
     this->dataPtr->shaderGenerator->setShaderCachePath(cachePath);
 
+    // Reuse the programs compiled by previous runs, if the render system
+    // can give them back
+    Ogre::GpuProgramManager &programManager =
+        Ogre::GpuProgramManager::getSingleton();
+    if (programManager.canGetCompiledShaderBuffer())
+    {
+      this->dataPtr->microcodeCacheFile =
+          common::joinPaths(cachePath, "microcode.cache");
+      programManager.setSaveMicrocodesToCache(true);
+      std::ifstream *stream = OGRE_NEW_T(std::ifstream,
+          Ogre::MEMCATEGORY_GENERAL)(this->dataPtr->microcodeCacheFile,
+          std::ios::in | std::ios::binary);
+      if (stream->is_open())
+      {
+        Ogre::DataStreamPtr cache(
+            OGRE_NEW Ogre::FileStreamDataStream(stream));
+        try
+        {
+          programManager.loadMicrocodeCache(cache);
+        }
+        catch(Ogre::Exception &e)
+        {
+          ignwarn << "Unable to load the shader program cache ["
+                  << this->dataPtr->microcodeCacheFile << "]" << std::endl;
+        }
+      }
+      else
+      {
+        OGRE_DELETE_T(stream, basic_ifstream, Ogre::MEMCATEGORY_GENERAL);
+      }
+    }
+
     this->dataPtr->shaderGenerator->setTargetLanguage("glsl");
   }
   else
@@ -146,6 +190,30 @@ void OgreRTShaderSystem::Fini()
   Ogre::MaterialManager::getSingleton().setActiveScheme(
       Ogre::MaterialManager::DEFAULT_SCHEME_NAME);
 
+  // Save the programs compiled by this run for the next ones
+  Ogre::GpuProgramManager *programManager =
+      Ogre::GpuProgramManager::getSingletonPtr();
+  if (programManager && !this->dataPtr->microcodeCacheFile.empty() &&
+      programManager->isCacheDirty())
+  {
+    std::fstream *stream = OGRE_NEW_T(std::fstream,
+        Ogre::MEMCATEGORY_GENERAL)(this->dataPtr->microcodeCacheFile,
+        std::ios::out | std::ios::binary);
+    if (stream->is_open())
+    {
+      Ogre::DataStreamPtr cache(
+          OGRE_NEW Ogre::FileStreamDataStream(stream));
+      programManager->saveMicrocodeCache(cache);
+    }
+    else
+    {
+      OGRE_DELETE_T(stream, basic_fstream, Ogre::MEMCATEGORY_GENERAL);
+      ignwarn << "Unable to save the shader program cache ["
+              << this->dataPtr->microcodeCacheFile << "]" << std::endl;
+    }
+  }
+  this->dataPtr->microcodeCacheFile.clear();
+
   // Finalize RTShader system.
   if (this->dataPtr->shaderGenerator != nullptr)
   {
@@ -163,6 +231,7 @@ void OgreRTShaderSystem::Fini()
   this->dataPtr->pssmSetup.reset();
 #endif
   this->dataPtr->entities.clear();
+  this->dataPtr->pendingEntities.clear();
   this->dataPtr->scenes.clear();
   this->dataPtr->shadowsApplied = false;
   this->dataPtr->initialized = false;
@@ -229,7 +298,7 @@ void OgreRTShaderSystem::AttachEntity(OgreSubMesh *_subMesh)
 
   std::lock_guard<std::mutex> lock(this->dataPtr->entityMutex);
   this->dataPtr->entities.insert(_subMesh);
-  this->dataPtr->updateShaders = true;
+  this->dataPtr->pendingEntities.insert(_subMesh);
 }
 
 //////////////////////////////////////////////////
@@ -246,6 +315,7 @@ void OgreRTShaderSystem::DetachEntity(OgreSubMesh *_subMesh)
     this->RemoveShaders(_subMesh);
     this->dataPtr->entities.erase(it);
   }
+  this->dataPtr->pendingEntities.erase(_subMesh);
 }
 
 //////////////////////////////////////////////////
@@ -253,6 +323,7 @@ void OgreRTShaderSystem::Clear()
 {
   std::lock_guard<std::mutex> lock(this->dataPtr->entityMutex);
   this->dataPtr->entities.clear();
+  this->dataPtr->pendingEntities.clear();
 }
 
 //////////////////////////////////////////////////
@@ -473,6 +544,29 @@ void OgreRTShaderSystem::GenerateShaders(OgreSubMesh *subMesh)
   }
 }
 
+//////////////////////////////////////////////////
+void OgreRTShaderSystem::GenerateShaders(
+    const std::vector<OgreSubMesh *> &_subMeshes)
+{
+  if (!this->dataPtr->initialized)
+    return;
+
+  // The shaders only depend on the material, generate them once for all the
+  // submeshes sharing a material
+  std::set<std::string> materials;
+  for (auto subMesh : _subMeshes)
+  {
+    OgreMaterialPtr material =
+        std::dynamic_pointer_cast<OgreMaterial>(subMesh->Material());
+    if (!material ||
+        !materials.insert(subMesh->OgreSubEntity()->getMaterialName()).second)
+    {
+      continue;
+    }
+    this->GenerateShaders(subMesh);
+  }
+}
+
 //////////////////////////////////////////////////
 bool OgreRTShaderSystem::Paths(std::string &coreLibsPath,
     std::string &cachePath)
@@ -510,7 +604,19 @@ bool OgreRTShaderSystem::Paths(std::string &coreLibsPath,
       const char* userEnv = std::getenv("USER");
       if (userEnv)
         user = std::string(userEnv);
-      cachePath = common::joinPaths(tmpDir, user + "-rtshaderlibcache");
+      // Key the cache by what the generated programs depend on, so runs
+      // with another version of ogre or of the shader lib do not reuse them
+      std::string key = std::string(OGRE_VERSION_NAME) +
+          std::to_string(OGRE_VERSION) + coreLibsPath;
+      Ogre::RenderSystem *renderSystem =
+          Ogre::Root::getSingleton().getRenderSystem();
+      if (renderSystem)
+        key += renderSystem->getName();
+      std::ostringstream hash;
+      hash << std::hex << std::setw(16) << std::setfill('0')
+           << std::hash<std::string>()(key);
+      cachePath = common::joinPaths(tmpDir, user + "-rtshaderlibcache",
+          hash.str());
       // Create the directory
       if (!common::createDirectories(cachePath))
       {
@@ -696,12 +802,18 @@ void OgreRTShaderSystem::Update()
   if (this->dataPtr->updateShaders)
   {
     // Update all the shaders
-    for (auto iter = this->dataPtr->entities.begin();
-        iter != this->dataPtr->entities.end(); ++iter)
-      this->GenerateShaders(*iter);
-
+    this->GenerateShaders(std::vector<OgreSubMesh *>(
+        this->dataPtr->entities.begin(), this->dataPtr->entities.end()));
     this->dataPtr->updateShaders = false;
   }
+  else if (!this->dataPtr->pendingEntities.empty())
+  {
+    // Only generate the shaders of the entities added since the last update
+    this->GenerateShaders(std::vector<OgreSubMesh *>(
+        this->dataPtr->pendingEntities.begin(),
+        this->dataPtr->pendingEntities.end()));
+  }
+  this->dataPtr->pendingEntities.clear();
 }
 
 /////////////////////////////////////////////////
@@ -15,10 +15,20 @@
  *
  */
 
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
 #include <typeinfo>
+#include <utility>
+#include <vector>
 
 #include <ignition/common/Console.hh>
+#include <ignition/common/Mesh.hh>
+#include <ignition/common/SubMesh.hh>
 
+#include "ignition/rendering/MeshBvh.hh"
 #include "ignition/rendering/ogre/OgreIncludes.hh"
 #include "ignition/rendering/ogre/OgreCamera.hh"
 #include "ignition/rendering/ogre/OgreConversions.hh"
@@ -29,6 +39,10 @@ class ignition::rendering::OgreRayQueryPrivate
 {
   /// \brief Ogre ray scene query object for computing intersection.
   public: Ogre::RaySceneQuery *rayQuery = nullptr;
+
+  /// \brief Bounding volume hierarchies of ogre meshes in the mesh frame,
+  /// used by batched queries. Indexed by ogre mesh name.
+  public: std::map<std::string, std::shared_ptr<const MeshBvh>> bvhs;
 };
 
 using namespace ignition;
@@ -149,6 +163,174 @@ RayQueryResult OgreRayQuery::ClosestPoint()
   return result;
 }
 
+//////////////////////////////////////////////////
+std::vector<RayQueryResult> OgreRayQuery::ClosestPoints(
+    const std::vector<math::Vector3d> &_origins,
+    const std::vector<math::Vector3d> &_directions)
+{
+  std::vector<RayQueryResult> results;
+  if (!this->ValidateRays(_origins, _directions))
+    return results;
+  results.resize(_origins.size());
+
+  OgreScenePtr ogreScene = std::dynamic_pointer_cast<OgreScene>(this->Scene());
+  if (!ogreScene)
+    return results;
+
+  /// \brief An entity that can be hit by the rays
+  struct Candidate
+  {
+    /// \brief World bounding box of the entity
+    Ogre::AxisAlignedBox box;
+
+    /// \brief Transform from the world frame to the mesh frame
+    Ogre::Matrix4 invTransform;
+
+    /// \brief Linear part of invTransform, used to transform directions
+    Ogre::Matrix3 invLinear;
+
+    /// \brief Bounding volume hierarchy of the mesh
+    std::shared_ptr<const MeshBvh> bvh;
+
+    /// \brief Id of the visual the entity belongs to
+    unsigned int objectId;
+  };
+
+  // collect the entities once for the whole batch. This also builds the
+  // bounding volume hierarchies of the meshes that have none yet, so the
+  // rays only read shared data and can be evaluated in parallel
+  std::vector<Candidate> candidates;
+  auto itor = ogreScene->OgreSceneManager()->getMovableObjectIterator(
+      Ogre::EntityFactory::FACTORY_TYPE_NAME);
+  while (itor.hasMoreElements())
+  {
+    Ogre::Entity *ogreEntity = static_cast<Ogre::Entity *>(itor.getNext());
+    if (!ogreEntity->isAttached() || !ogreEntity->getVisible())
+      continue;
+
+    auto userAny = ogreEntity->getUserObjectBindings().getUserAny();
+    if (userAny.isEmpty() || userAny.getType() != typeid(unsigned int))
+      continue;
+
+    const Ogre::Mesh *ogreMesh = ogreEntity->getMesh().get();
+    std::shared_ptr<const MeshBvh> &bvh =
+        this->dataPtr->bvhs[ogreMesh->getName()];
+    if (!bvh)
+    {
+      // mesh data to retrieve, in the mesh frame
+      size_t vertexCount;
+      size_t indexCount;
+      Ogre::Vector3 *vertices;
+      uint64_t *indices;
+      this->MeshInformation(ogreMesh, vertexCount, vertices, indexCount,
+          indices, math::Vector3d::Zero, math::Quaterniond::Identity,
+          math::Vector3d::One);
+
+      common::SubMesh subMesh;
+      for (size_t i = 0; i < vertexCount; ++i)
+        subMesh.AddVertex(OgreConversions::Convert(vertices[i]));
+      for (size_t i = 0; i < indexCount; ++i)
+        subMesh.AddIndex(static_cast<unsigned int>(indices[i]));
+      delete [] vertices;
+      delete [] indices;
+
+      common::Mesh mesh;
+      mesh.AddSubMesh(subMesh);
+      bvh = std::make_shared<const MeshBvh>(mesh);
+    }
+    if (bvh->TriangleCount() == 0u)
+      continue;
+
+    Candidate candidate;
+    candidate.box = ogreEntity->getWorldBoundingBox(true);
+    candidate.invTransform =
+        ogreEntity->getParentNode()->_getFullTransform().inverseAffine();
+    candidate.invTransform.extract3x3Matrix(candidate.invLinear);
+    candidate.bvh = bvh;
+    candidate.objectId = Ogre::any_cast<unsigned int>(userAny);
+    candidates.push_back(candidate);
+  }
+
+  if (candidates.empty())
+    return results;
+
+  // compute the closest intersection of the rays in [_start, _end)
+  auto intersect = [&](size_t _start, size_t _end)
+  {
+    std::vector<std::pair<Ogre::Real, const Candidate *>> boxHits;
+    for (size_t i = _start; i < _end; ++i)
+    {
+      Ogre::Ray ray(OgreConversions::Convert(_origins[i]),
+          OgreConversions::Convert(_directions[i]));
+
+      boxHits.clear();
+      for (const auto &candidate : candidates)
+      {
+        std::pair<bool, Ogre::Real> hit =
+            Ogre::Math::intersects(ray, candidate.box);
+        if (hit.first)
+          boxHits.emplace_back(hit.second, &candidate);
+      }
+      std::sort(boxHits.begin(), boxHits.end(),
+          [](const std::pair<Ogre::Real, const Candidate *> &_a,
+             const std::pair<Ogre::Real, const Candidate *> &_b)
+          {
+            return _a.first < _b.first;
+          });
+
+      double distance = -1.0;
+      for (const auto &boxHit : boxHits)
+      {
+        // no remaining entity can be hit before the closest hit so far
+        if (distance >= 0.0 && boxHit.first > distance)
+          break;
+
+        const Candidate *candidate = boxHit.second;
+        math::Vector3d localOrigin = OgreConversions::Convert(
+            candidate->invTransform * ray.getOrigin());
+        math::Vector3d localDir = OgreConversions::Convert(
+            candidate->invLinear * ray.getDirection());
+
+        double hitDistance;
+        if (candidate->bvh->Intersect(localOrigin, localDir, hitDistance) &&
+            (distance < 0.0 || hitDistance < distance))
+        {
+          distance = hitDistance;
+          results[i].distance = distance;
+          results[i].point = _origins[i] + _directions[i] * distance;
+          results[i].objectId = candidate->objectId;
+        }
+      }
+    }
+  };
+
+  // only spread the work across threads when there is enough of it to
+  // make up for the cost of starting them
+  const size_t minRaysPerThread = 256u;
+  size_t threadCount = std::min<size_t>(
+      std::max(1u, std::thread::hardware_concurrency()),
+      _origins.size() / minRaysPerThread);
+  if (threadCount <= 1u)
+  {
+    intersect(0u, _origins.size());
+  }
+  else
+  {
+    size_t chunk = (_origins.size() + threadCount - 1u) / threadCount;
+    std::vector<std::thread> threads;
+    for (size_t t = 1u; t < threadCount; ++t)
+    {
+      threads.emplace_back(intersect, t * chunk,
+          std::min(_origins.size(), (t + 1u) * chunk));
+    }
+    intersect(0u, chunk);
+    for (auto &thread : threads)
+      thread.join();
+  }
+
+  return results;
+}
+
 //////////////////////////////////////////////////
 void OgreRayQuery::MeshInformation(const Ogre::Mesh *_mesh,
                                    size_t &_vertex_count,
@@ -0,0 +1,389 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Not Apple or Windows
+#if !defined(__APPLE__) && !defined(_WIN32)
+# ifndef GL_GLEXT_PROTOTYPES
+#  define GL_GLEXT_PROTOTYPES
+# endif
+# include <GL/gl.h>
+# include <GL/glext.h>
+# define IGN_OGRE_ASYNC_READBACK 1
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/Profiler.hh"
+#include "ignition/rendering/ogre/OgreRenderEngine.hh"
+
+#include "OgreReadbackManager.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+OgreReadbackManager::~OgreReadbackManager()
+{
+  this->Reset();
+}
+
+//////////////////////////////////////////////////
+bool OgreReadbackManager::AsyncSupported()
+{
+#ifdef IGN_OGRE_ASYNC_READBACK
+  auto engine = OgreRenderEngine::Instance();
+  if (!engine->IsInitialized() || !engine->OgreRoot())
+    return false;
+  Ogre::RenderSystem *renderSys = engine->OgreRoot()->getRenderSystem();
+  if (!renderSys ||
+      renderSys->getName().find("OpenGL") == std::string::npos)
+  {
+    return false;
+  }
+
+  // fences need GL 3.2
+  Ogre::DriverVersion version = renderSys->getDriverVersion();
+  return version.major > 3 || (version.major == 3 && version.minor >= 2);
+#else
+  return false;
+#endif
+}
+
+//////////////////////////////////////////////////
+void OgreReadbackManager::Read(Ogre::RenderTarget *_target,
+    const Ogre::PixelBox &_dst)
+{
+  IGN_RENDERING_PROFILE("OgreReadbackManager::Read");
+  if (!_target)
+    return;
+
+  // blit data from gpu to cpu
+  _target->copyContentsToMemory(_dst, Ogre::RenderTarget::FB_AUTO);
+}
+
+//////////////////////////////////////////////////
+unsigned int OgreReadbackManager::CreateClient(unsigned int _maxInFlight)
+{
+  if (!AsyncSupported())
+    return 0u;
+
+  unsigned int id = ++this->clientCounter;
+  this->clients[id] = std::max(2u, _maxInFlight);
+  return id;
+}
+
+//////////////////////////////////////////////////
+void OgreReadbackManager::DestroyClient(unsigned int _client)
+{
+  this->clients.erase(_client);
+
+  for (auto it = this->tickets.begin(); it != this->tickets.end();)
+  {
+    if (it->client != _client)
+    {
+      ++it;
+      continue;
+    }
+#ifdef IGN_OGRE_ASYNC_READBACK
+    if (it->fence)
+      glDeleteSync(static_cast<GLsync>(it->fence));
+#endif
+    this->freeBuffers.emplace(it->size, it->buffer);
+    it = this->tickets.erase(it);
+  }
+}
+
+//////////////////////////////////////////////////
+bool OgreReadbackManager::GLFormat(Ogre::PixelFormat _format,
+    unsigned int &_glFormat, unsigned int &_glType)
+{
+#ifdef IGN_OGRE_ASYNC_READBACK
+  // Formats must match the memory layout produced by
+  // RenderTarget::copyContentsToMemory so the async and blocking code paths
+  // deliver identical data
+  switch (_format)
+  {
+    case Ogre::PF_FLOAT32_RGBA:
+      _glFormat = GL_RGBA;
+      _glType = GL_FLOAT;
+      return true;
+    case Ogre::PF_FLOAT32_RGB:
+      _glFormat = GL_RGB;
+      _glType = GL_FLOAT;
+      return true;
+    case Ogre::PF_FLOAT32_R:
+      _glFormat = GL_LUMINANCE;
+      _glType = GL_FLOAT;
+      return true;
+    case Ogre::PF_L8:
+      _glFormat = GL_LUMINANCE;
+      _glType = GL_UNSIGNED_BYTE;
+      return true;
+    case Ogre::PF_L16:
+      _glFormat = GL_LUMINANCE;
+      _glType = GL_UNSIGNED_SHORT;
+      return true;
+    case Ogre::PF_R8G8B8:
+      _glFormat = GL_BGR;
+      _glType = GL_UNSIGNED_BYTE;
+      return true;
+    case Ogre::PF_B8G8R8:
+      _glFormat = GL_RGB;
+      _glType = GL_UNSIGNED_BYTE;
+      return true;
+    default:
+      return false;
+  }
+#else
+  (void)_format;
+  (void)_glFormat;
+  (void)_glType;
+  return false;
+#endif
+}
+
+//////////////////////////////////////////////////
+unsigned int OgreReadbackManager::AcquireBuffer(size_t _size)
+{
+  auto it = this->freeBuffers.find(_size);
+  if (it != this->freeBuffers.end())
+  {
+    unsigned int buffer = it->second;
+    this->freeBuffers.erase(it);
+    return buffer;
+  }
+
+#ifdef IGN_OGRE_ASYNC_READBACK
+  GLuint buffer = 0u;
+  GLint prevPack = 0;
+  glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &prevPack);
+  glGenBuffers(1, &buffer);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+  glBufferData(GL_PIXEL_PACK_BUFFER, _size, nullptr, GL_STREAM_READ);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, prevPack);
+  return buffer;
+#else
+  return 0u;
+#endif
+}
+
+//////////////////////////////////////////////////
+bool OgreReadbackManager::Request(unsigned int _client,
+    Ogre::Texture *_texture, Ogre::PixelFormat _format)
+{
+  IGN_RENDERING_PROFILE("OgreReadbackManager::Request");
+#ifdef IGN_OGRE_ASYNC_READBACK
+  auto clientIt = this->clients.find(_client);
+  if (clientIt == this->clients.end())
+    return false;
+
+  if (!_texture || _texture->getTextureType() != Ogre::TEX_TYPE_2D)
+    return false;
+
+  GLenum glFormat;
+  GLenum glType;
+  if (!GLFormat(_format, glFormat, glType))
+    return false;
+
+  GLuint textureId = 0u;
+  _texture->getCustomAttribute("GLID", &textureId);
+  if (textureId == 0u)
+    return false;
+
+  // all requests of this client are in flight, it must retrieve data first
+  if (this->PendingCount(_client) >= clientIt->second)
+    return false;
+
+  Ticket ticket;
+  ticket.client = _client;
+  ticket.size = Ogre::PixelUtil::getMemorySize(_texture->getWidth(),
+      _texture->getHeight(), 1u, _format);
+  ticket.buffer = this->AcquireBuffer(ticket.size);
+
+  // save the GL states modified below so ogre's state cache remains valid
+  GLint prevPack = 0;
+  GLint prevTexture = 0;
+  GLint prevAlignment = 4;
+  glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &prevPack);
+  glGetIntegerv(GL_TEXTURE_BINDING_2D, &prevTexture);
+  glGetIntegerv(GL_PACK_ALIGNMENT, &prevAlignment);
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, ticket.buffer);
+  glBindTexture(GL_TEXTURE_2D, textureId);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  // with a pack buffer bound the last argument is an offset into the buffer
+  // and the call returns without waiting for the gpu
+  glGetTexImage(GL_TEXTURE_2D, 0, glFormat, glType, nullptr);
+  ticket.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+  glPixelStorei(GL_PACK_ALIGNMENT, prevAlignment);
+  glBindTexture(GL_TEXTURE_2D, prevTexture);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, prevPack);
+
+  this->tickets.push_back(ticket);
+  return true;
+#else
+  (void)_client;
+  (void)_texture;
+  (void)_format;
+  return false;
+#endif
+}
+
+//////////////////////////////////////////////////
+void OgreReadbackManager::Update()
+{
+#ifdef IGN_OGRE_ASYNC_READBACK
+  bool flush = true;
+  for (auto &ticket : this->tickets)
+  {
+    if (ticket.complete)
+      continue;
+
+    GLsync fence = static_cast<GLsync>(ticket.fence);
+    GLenum status = glClientWaitSync(fence,
+        flush ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, 0u);
+    flush = false;
+
+    // fences are signaled in order so the remaining ones are still pending
+    if (status == GL_TIMEOUT_EXPIRED)
+      break;
+
+    glDeleteSync(fence);
+    ticket.fence = nullptr;
+    ticket.complete = true;
+  }
+#endif
+}
+
+//////////////////////////////////////////////////
+bool OgreReadbackManager::Retrieve(unsigned int _client, void *_dst,
+    size_t _size, bool _wait)
+{
+  IGN_RENDERING_PROFILE("OgreReadbackManager::Retrieve");
+#ifdef IGN_OGRE_ASYNC_READBACK
+  auto clientIt = this->clients.find(_client);
+  if (clientIt == this->clients.end() || !_dst)
+    return false;
+
+  // never wait on the most recent request, unless asked to
+  unsigned int pendingCount = this->PendingCount(_client);
+  if (pendingCount == 0u || (pendingCount < 2u && !_wait))
+    return false;
+
+  this->Update();
+
+  auto it = std::find_if(this->tickets.begin(), this->tickets.end(),
+      [&](const Ticket &_ticket) { return _ticket.client == _client; });
+
+  // only block if all requests are in flight, otherwise try again next frame
+  if (!it->complete)
+  {
+    if (pendingCount < clientIt->second && !_wait)
+      return false;
+
+    GLsync fence = static_cast<GLsync>(it->fence);
+    GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+        1000000000u);
+    while (status == GL_TIMEOUT_EXPIRED)
+      status = glClientWaitSync(fence, 0, 1000000000u);
+    glDeleteSync(fence);
+    it->fence = nullptr;
+    it->complete = true;
+
+    if (status == GL_WAIT_FAILED)
+    {
+      ignerr << "Failed to wait for GPU readback" << std::endl;
+      this->freeBuffers.emplace(it->size, it->buffer);
+      this->tickets.erase(it);
+      return false;
+    }
+  }
+
+  Ticket ticket = *it;
+  this->tickets.erase(it);
+
+  if (_size < ticket.size)
+  {
+    ignerr << "Readback destination buffer is too small" << std::endl;
+    this->freeBuffers.emplace(ticket.size, ticket.buffer);
+    return false;
+  }
+
+  return this->CopyAndRelease(ticket.buffer, ticket.size, _dst);
+#else
+  (void)_client;
+  (void)_dst;
+  (void)_size;
+  (void)_wait;
+  return false;
+#endif
+}
+
+//////////////////////////////////////////////////
+bool OgreReadbackManager::CopyAndRelease(unsigned int _buffer,
+    size_t _size, void *_dst)
+{
+  bool result = false;
+#ifdef IGN_OGRE_ASYNC_READBACK
+  GLint prevPack = 0;
+  glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &prevPack);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, _buffer);
+  void *data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, _size,
+      GL_MAP_READ_BIT);
+  if (data)
+  {
+    memcpy(_dst, data, _size);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    result = true;
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, prevPack);
+#else
+  (void)_dst;
+#endif
+  this->freeBuffers.emplace(_size, _buffer);
+  return result;
+}
+
+//////////////////////////////////////////////////
+unsigned int OgreReadbackManager::PendingCount(unsigned int _client) const
+{
+  return static_cast<unsigned int>(std::count_if(this->tickets.begin(),
+      this->tickets.end(),
+      [&](const Ticket &_ticket) { return _ticket.client == _client; }));
+}
+
+//////////////////////////////////////////////////
+void OgreReadbackManager::Reset()
+{
+#ifdef IGN_OGRE_ASYNC_READBACK
+  for (auto &ticket : this->tickets)
+  {
+    if (ticket.fence)
+      glDeleteSync(static_cast<GLsync>(ticket.fence));
+    glDeleteBuffers(1, &ticket.buffer);
+  }
+  for (auto &buffer : this->freeBuffers)
+    glDeleteBuffers(1, &buffer.second);
+#endif
+  this->tickets.clear();
+  this->freeBuffers.clear();
+}
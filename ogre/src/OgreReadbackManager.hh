@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE_OGREREADBACKMANAGER_HH_
+#define IGNITION_RENDERING_OGRE_OGREREADBACKMANAGER_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <vector>
+
+#include <ignition/common/SingletonT.hh>
+
+#include "ignition/rendering/ogre/OgreIncludes.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Manages GPU to CPU readback of render results for all ogre
+    /// sensors. Blocking reads are routed through Read. Sensors that can
+    /// tolerate latency register as clients and use Request / Retrieve:
+    /// each request copies a texture into a pooled pixel pack buffer and
+    /// inserts a fence, so the transfer overlaps with the next render.
+    /// Completed requests are retrieved in submission order, at least one
+    /// frame late.
+    class OgreReadbackManager :
+      public common::SingletonT<OgreReadbackManager>
+    {
+      /// \brief Constructor
+      private: OgreReadbackManager() = default;
+
+      /// \brief Destructor
+      public: ~OgreReadbackManager();
+
+      /// \brief Check if asynchronous readback is supported by the current
+      /// platform and render system
+      /// \return True if supported
+      public: static bool AsyncSupported();
+
+      /// \brief Blocking read of the content of a render target
+      /// \param[in] _target Render target to read from
+      /// \param[in] _dst Pixel box describing the destination memory
+      public: void Read(Ogre::RenderTarget *_target,
+          const Ogre::PixelBox &_dst);
+
+      /// \brief Register a new asynchronous readback client
+      /// \param[in] _maxInFlight Maximum number of requests the client may
+      /// have in flight. Retrieve blocks once this number is reached
+      /// \return Id of the new client, 0 if async readback is unsupported
+      public: unsigned int CreateClient(unsigned int _maxInFlight = 3u);
+
+      /// \brief Unregister a client and discard its pending requests
+      /// \param[in] _client Id of client
+      public: void DestroyClient(unsigned int _client);
+
+      /// \brief Queue an asynchronous copy of the content of a texture
+      /// \param[in] _client Id of client making the request
+      /// \param[in] _texture Texture to read back
+      /// \param[in] _format Pixel format of the data to retrieve
+      /// \return True if the request was queued
+      public: bool Request(unsigned int _client, Ogre::Texture *_texture,
+          Ogre::PixelFormat _format);
+
+      /// \brief Copy the oldest completed request of a client into memory.
+      /// The most recent request of the client is never waited on. Older
+      /// requests are only waited on if the client has reached its maximum
+      /// number of requests in flight, or if _wait is true, e.g. for the
+      /// second texture requested for the same frame as the one just
+      /// retrieved.
+      /// \param[in] _client Id of client
+      /// \param[out] _dst Destination buffer, must hold at least _size bytes
+      /// \param[in] _size Size in bytes of the destination buffer
+      /// \param[in] _wait True to wait for the oldest request to complete
+      /// \return True if data was copied to _dst
+      public: bool Retrieve(unsigned int _client, void *_dst, size_t _size,
+          bool _wait = false);
+
+      /// \brief Poll the fences of all requests in flight and move the
+      /// signaled ones to the completion queue. Never blocks.
+      public: void Update();
+
+      /// \brief Get the number of requests of a client that have not been
+      /// retrieved yet
+      /// \param[in] _client Id of client
+      /// \return Number of pending requests
+      public: unsigned int PendingCount(unsigned int _client) const;
+
+      /// \brief Discard all requests and release all GPU buffers. Must be
+      /// called while the GL context is still valid.
+      public: void Reset();
+
+      /// \brief Map a pixel format to the GL pixel transfer format and type
+      /// \param[in] _format Ogre pixel format
+      /// \param[out] _glFormat GL pixel format
+      /// \param[out] _glType GL pixel data type
+      /// \return True if the format is supported
+      private: static bool GLFormat(Ogre::PixelFormat _format,
+          unsigned int &_glFormat, unsigned int &_glType);
+
+      /// \brief Get a staging buffer of the given size from the pool,
+      /// allocating a new one if none is available
+      /// \param[in] _size Size of buffer in bytes
+      /// \return GL id of buffer
+      private: unsigned int AcquireBuffer(size_t _size);
+
+      /// \brief Map a staging buffer, copy its content and return it to
+      /// the pool
+      /// \param[in] _buffer GL id of buffer
+      /// \param[in] _size Size of buffer in bytes
+      /// \param[out] _dst Destination of the copy
+      /// \return True if the copy succeeded
+      private: bool CopyAndRelease(unsigned int _buffer, size_t _size,
+          void *_dst);
+
+      /// \brief A readback request
+      private: struct Ticket
+      {
+        /// \brief Id of client that made the request
+        unsigned int client = 0u;
+
+        /// \brief GL id of the staging buffer
+        unsigned int buffer = 0u;
+
+        /// \brief Size of staging buffer in bytes
+        size_t size = 0u;
+
+        /// \brief GPU fence, null once signaled
+        void *fence = nullptr;
+
+        /// \brief True if the copy has completed on the GPU
+        bool complete = false;
+      };
+
+      /// \brief Requests that have not been retrieved, in submission order
+      private: std::list<Ticket> tickets;
+
+      /// \brief Pool of free staging buffers, key is the size in bytes
+      private: std::multimap<size_t, unsigned int> freeBuffers;
+
+      /// \brief Maximum requests in flight for each registered client
+      private: std::map<unsigned int, unsigned int> clients;
+
+      /// \brief Counter used to generate client ids
+      private: unsigned int clientCounter = 0u;
+
+      /// \brief Make the singleton class a friend
+      private: friend class common::SingletonT<OgreReadbackManager>;
+    };
+    }
+  }
+}
+
+#endif
@@ -44,6 +44,8 @@
 #include "ignition/rendering/ogre/OgreScene.hh"
 #include "ignition/rendering/ogre/OgreStorage.hh"
 
+#include "OgreReadbackManager.hh"
+
 class ignition::rendering::OgreRenderEnginePrivate
 {
 #if !defined(__APPLE__) && !defined(_WIN32)
@@ -52,6 +54,14 @@ class ignition::rendering::OgreRenderEnginePrivate
 
   /// \brief A list of supported fsaa levels
   public: std::vector<unsigned int> fsaaLevels;
+
+  /// \brief Number of worker threads of the ogre work queue, 0 to keep
+  /// the ogre default
+  public: unsigned int workQueueThreads = 0u;
+
+  /// \brief Milliseconds spent processing the responses of the work queue
+  /// each time it is pumped, negative to keep the ogre default
+  public: int workQueueResponseTimeLimit = -1;
 };
 
 using namespace ignition;
@@ -107,6 +117,10 @@ void OgreRenderEngine::Destroy()
 
   OgreRTShaderSystem::Instance()->Fini();
 
+  // release readback buffers while the GL context is still valid
+  if (this->ogreRoot)
+    OgreReadbackManager::Instance()->Reset();
+
   if (ogreRoot)
   {
     try
@@ -275,6 +289,27 @@ bool OgreRenderEngine::LoadImpl(
   if (it != _params.end())
     std::istringstream(it->second) >> this->useCurrentGLContext;
 
+  it = _params.find("workQueueThreads");
+  if (it != _params.end())
+  {
+    unsigned int threads = 0u;
+    if (std::istringstream(it->second) >> threads && threads > 0u)
+      this->dataPtr->workQueueThreads = threads;
+    else
+      ignerr << "Invalid work queue thread count: " << it->second << std::endl;
+  }
+
+  it = _params.find("workQueueResponseTimeLimit");
+  if (it != _params.end())
+  {
+    unsigned int limit = 0u;
+    if (std::istringstream(it->second) >> limit)
+      this->dataPtr->workQueueResponseTimeLimit = static_cast<int>(limit);
+    else
+      ignerr << "Invalid work queue response time limit: " << it->second
+             << std::endl;
+  }
+
   try
   {
     this->LoadAttempt();
@@ -397,6 +432,24 @@ void OgreRenderEngine::CreateRoot()
   catch (Ogre::Exception &ex)
   {
     ignerr << "Unable to create Ogre root" << std::endl;
+    return;
+  }
+
+  // the work queue loads terrain pages and generates their derived data,
+  // its worker threads are started when the root is initialised
+  Ogre::WorkQueue *workQueue = this->ogreRoot->getWorkQueue();
+  if (this->dataPtr->workQueueResponseTimeLimit >= 0)
+  {
+    workQueue->setResponseProcessingTimeLimit(
+        this->dataPtr->workQueueResponseTimeLimit);
+  }
+  if (this->dataPtr->workQueueThreads > 0u)
+  {
+    auto defaultQueue = dynamic_cast<Ogre::DefaultWorkQueueBase *>(workQueue);
+    if (defaultQueue)
+      defaultQueue->setWorkerThreadCount(this->dataPtr->workQueueThreads);
+    else
+      ignwarn << "Unable to set the work queue thread count" << std::endl;
   }
 }
 
@@ -45,9 +45,53 @@
 #include "ignition/rendering/ogre/OgreCamera.hh"
 #include "ignition/rendering/ogre/OgreIncludes.hh"
 
+#include "OgreReadbackManager.hh"
+
 using namespace ignition;
 using namespace rendering;
 
+//////////////////////////////////////////////////
+/// \brief Filter an RGB image through a Bayer pattern
+/// \param[in] _rgb RGB image
+/// \param[out] _bayer Bayer image of the same size, the format of which
+/// selects the pattern
+static void bayerMosaic(const Image &_rgb, Image &_bayer)
+{
+  // channel kept by each pixel of the 2x2 pattern, in row major order
+  unsigned int channels[4] = {0u, 1u, 1u, 2u};
+  switch (_bayer.Format())
+  {
+    case PF_BAYER_BGGR8:
+      channels[0] = 2u;
+      channels[3] = 0u;
+      break;
+    case PF_BAYER_GBGR8:
+      channels[0] = 1u;
+      channels[1] = 2u;
+      channels[2] = 0u;
+      channels[3] = 1u;
+      break;
+    case PF_BAYER_GRGB8:
+      channels[0] = 1u;
+      channels[1] = 0u;
+      channels[2] = 2u;
+      channels[3] = 1u;
+      break;
+    default:
+      break;
+  }
+
+  const unsigned char *src = _rgb.Data<unsigned char>();
+  unsigned char *dst = _bayer.Data<unsigned char>();
+  for (unsigned int y = 0; y < _bayer.Height(); ++y)
+  {
+    const unsigned char *srcRow = src + y * _rgb.RowStride();
+    unsigned char *dstRow = dst + y * _bayer.RowStride();
+    for (unsigned int x = 0; x < _bayer.Width(); ++x)
+      dstRow[x] = srcRow[x * 3u + channels[(y % 2u) * 2u + x % 2u]];
+  }
+}
+
 //////////////////////////////////////////////////
 // OgreRenderTarget
 //////////////////////////////////////////////////
@@ -71,7 +115,6 @@ void OgreRenderTarget::Copy(Image &_image) const
   if (nullptr == this->RenderTarget())
     return;
 
-  // TODO(anyone): handle Bayer conversions
   // TODO(anyone): handle ogre version differences
 
   if (_image.Width() != this->width || _image.Height() != this->height)
@@ -80,10 +123,23 @@ void OgreRenderTarget::Copy(Image &_image) const
     return;
   }
 
+  // Bayer images store one channel per pixel, they are filtered from the
+  // RGB image
+  if (PixelUtil::IsBayer(_image.Format()))
+  {
+    Image rgbImage(this->width, this->height, PF_R8G8B8);
+    this->Copy(rgbImage);
+    bayerMosaic(rgbImage, _image);
+    return;
+  }
+
   void* data = _image.Data();
   Ogre::PixelFormat imageFormat = OgreConversions::Convert(_image.Format());
   Ogre::PixelBox ogrePixelBox(this->width, this->height, 1, imageFormat, data);
-  this->RenderTarget()->copyContentsToMemory(ogrePixelBox);
+  // images wrapping user buffers may have padded rows
+  ogrePixelBox.rowPitch =
+      _image.RowStride() / PixelUtil::BytesPerPixel(_image.Format());
+  OgreReadbackManager::Instance()->Read(this->RenderTarget(), ogrePixelBox);
 }
 
 //////////////////////////////////////////////////
@@ -430,7 +486,13 @@ void OgreRenderTexture::Buffer(float *_buffer)
 
   Ogre::PixelBox ogrePixelBox(this->width, this->height, 1,
       imageFormat, _buffer);
-  this->RenderTarget()->copyContentsToMemory(ogrePixelBox);
+  OgreReadbackManager::Instance()->Read(this->RenderTarget(), ogrePixelBox);
+}
+
+//////////////////////////////////////////////////
+Ogre::Texture *OgreRenderTexture::OgreTexture() const
+{
+  return this->ogreTexture;
 }
 
 
@@ -15,6 +15,12 @@
  *
  */
 
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 
 #include "ignition/rendering/ogre/OgreArrowVisual.hh"
@@ -33,8 +39,11 @@
 #include "ignition/rendering/ogre/OgreLightVisual.hh"
 #include "ignition/rendering/ogre/OgreMarker.hh"
 #include "ignition/rendering/ogre/OgreMaterial.hh"
+#include "ignition/rendering/ogre/OgreMesh.hh"
 #include "ignition/rendering/ogre/OgreMeshFactory.hh"
+#include "ignition/rendering/ogre/OgreNode.hh"
 #include "ignition/rendering/ogre/OgreParticleEmitter.hh"
+#include "ignition/rendering/ogre/OgrePoseArrayVisual.hh"
 #include "ignition/rendering/ogre/OgreRTShaderSystem.hh"
 #include "ignition/rendering/ogre/OgreRayQuery.hh"
 #include "ignition/rendering/ogre/OgreRenderEngine.hh"
@@ -277,9 +286,55 @@ void OgreScene::RemoveGradientBackgroundColor()
   this->isGradientBackgroundColor = false;
 }
 
+//////////////////////////////////////////////////
+void OgreScene::SetWorldPoses(const std::vector<unsigned int> &_ids,
+    const std::vector<math::Pose3d> &_poses)
+{
+  if (!this->ValidateWorldPoses(_ids, _poses))
+    return;
+
+  // Nodes attached directly to the root visual, with no origin offset, only
+  // depend on the root pose so they are written straight to the ogre nodes.
+  // Other nodes go through the regular SetWorldPose. Unlike ogre2, ogre 1.x
+  // nodes notify their parent when moved so this is done on one thread.
+  Ogre::SceneNode *rootNode = this->rootVisual->Node();
+  const unsigned int rootId = this->rootVisual->Id();
+  const math::Pose3d rootPose = this->rootVisual->WorldPose();
+  const bool rootIdentity = rootPose == math::Pose3d::Zero;
+  const bool batch =
+      std::find(_ids.begin(), _ids.end(), rootId) == _ids.end();
+
+  for (unsigned int i = 0; i < _ids.size(); ++i)
+  {
+    NodePtr node = this->NodeById(_ids[i]);
+    if (!node)
+      continue;
+
+    OgreNode *ogreNode = dynamic_cast<OgreNode *>(node.get());
+    if (batch && ogreNode && ogreNode->Node()->getParentSceneNode() ==
+        rootNode && node->Origin() == math::Vector3d::Zero &&
+        _poses[i].IsFinite())
+    {
+      math::Pose3d pose = rootIdentity ? _poses[i] : _poses[i] - rootPose;
+      ogreNode->Node()->setPosition(OgreConversions::Convert(pose.Pos()));
+      ogreNode->Node()->setOrientation(OgreConversions::Convert(pose.Rot()));
+      ogreNode->InvalidateWorldPose();
+    }
+    else
+    {
+      node->SetWorldPose(_poses[i]);
+    }
+  }
+}
+
 //////////////////////////////////////////////////
 void OgreScene::PreRender()
 {
+  // scene changes have already been flushed in this frame
+  if (this->FramePreRendered())
+    return;
+
+  this->ApplyCommands();
   BaseScene::PreRender();
   OgreRTShaderSystem::Instance()->Update();
 }
@@ -301,6 +356,68 @@ void OgreScene::Destroy()
   this->ogreSceneManager = nullptr;
 }
 
+//////////////////////////////////////////////////
+std::vector<bool> OgreScene::BakeStaticMeshesImpl(
+    const std::vector<std::pair<MeshPtr, math::Matrix4d>> &_meshes,
+    double _cellSize)
+{
+  std::vector<bool> baked(_meshes.size(), false);
+  if (!this->ogreSceneManager)
+    return baked;
+
+  // the visibility flags apply to a whole static geometry
+  std::map<uint32_t, Ogre::StaticGeometry *> staticGeometries;
+  for (size_t i = 0u; i < _meshes.size(); ++i)
+  {
+    OgreMeshPtr mesh = std::dynamic_pointer_cast<OgreMesh>(_meshes[i].first);
+    Ogre::Entity *entity = mesh ?
+        dynamic_cast<Ogre::Entity *>(mesh->OgreObject()) : nullptr;
+    if (!entity)
+      continue;
+
+    VisualPtr parent = mesh->Parent();
+    uint32_t flags = parent ? parent->VisibilityFlags() : IGN_VISIBILITY_ALL;
+    Ogre::StaticGeometry *&staticGeometry = staticGeometries[flags];
+    if (!staticGeometry)
+    {
+      staticGeometry = this->ogreSceneManager->createStaticGeometry(
+          this->name + "::StaticGeometry(" +
+          std::to_string(this->staticGeometryCounter++) + ")");
+      // a single region holds everything if the geometry is not split
+      double regionSize = _cellSize > 0.0 ? _cellSize : 1e9;
+      staticGeometry->setRegionDimensions(
+          Ogre::Vector3::UNIT_SCALE * static_cast<Ogre::Real>(regionSize));
+      staticGeometry->setCastShadows(true);
+      staticGeometry->setVisibilityFlags(flags);
+    }
+
+    const math::Matrix4d &tf = _meshes[i].second;
+    math::Pose3d pose = tf.Pose();
+    staticGeometry->addEntity(entity, OgreConversions::Convert(pose.Pos()),
+        OgreConversions::Convert(pose.Rot()),
+        OgreConversions::Convert(tf.Scale()));
+    baked[i] = true;
+  }
+
+  for (auto &staticGeometry : staticGeometries)
+  {
+    staticGeometry.second->build();
+    this->ogreStaticGeometries.push_back(staticGeometry.second);
+  }
+  return baked;
+}
+
+//////////////////////////////////////////////////
+void OgreScene::ClearStaticMeshesImpl()
+{
+  if (this->ogreSceneManager)
+  {
+    for (auto staticGeometry : this->ogreStaticGeometries)
+      this->ogreSceneManager->destroyStaticGeometry(staticGeometry);
+  }
+  this->ogreStaticGeometries.clear();
+}
+
 //////////////////////////////////////////////////
 Ogre::SceneManager *OgreScene::OgreSceneManager() const
 {
@@ -451,6 +568,15 @@ AxisVisualPtr OgreScene::CreateAxisVisualImpl(unsigned int _id,
   return (result) ? visual : nullptr;
 }
 
+//////////////////////////////////////////////////
+PoseArrayVisualPtr OgreScene::CreatePoseArrayVisualImpl(unsigned int _id,
+    const std::string &_name)
+{
+  OgrePoseArrayVisualPtr visual(new OgrePoseArrayVisual);
+  bool result = this->InitObject(visual, _id, _name);
+  return (result) ? visual : nullptr;
+}
+
 //////////////////////////////////////////////////
 GizmoVisualPtr OgreScene::CreateGizmoVisualImpl(unsigned int _id,
     const std::string &_name)
@@ -15,7 +15,14 @@
  *
 */
 
+#include <algorithm>
+#include <list>
+#include <map>
 #include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
 #include <ignition/math/Color.hh>
 
 #include "ignition/common/Console.hh"
@@ -24,11 +31,95 @@
 #include "ignition/rendering/ogre/OgreMaterialSwitcher.hh"
 #include "ignition/rendering/ogre/OgreSelectionBuffer.hh"
 
+#include "OgreReadbackManager.hh"
+
 using namespace ignition;
 using namespace rendering;
 
+/// \brief Offscreen target the selection buffer can be rendered into
+struct OgreSelectionTarget
+{
+  /// \brief Ogre texture
+  Ogre::TexturePtr texture;
+
+  /// \brief Render target of the texture
+  Ogre::RenderTexture *renderTexture = nullptr;
+
+  /// \brief Content of the last render, in PF_R8G8B8 format
+  std::vector<uint8_t> buffer;
+
+  /// \brief Width in pixels
+  unsigned int width = 0u;
+
+  /// \brief Height in pixels
+  unsigned int height = 0u;
+};
+
+/// \brief Camera view and scene a selection frame was rendered for
+struct OgreSelectionFrameState
+{
+  /// \brief Camera position
+  Ogre::Vector3 position;
+
+  /// \brief Camera orientation
+  Ogre::Quaternion orientation;
+
+  /// \brief Camera projection matrix
+  Ogre::Matrix4 projection;
+
+  /// \brief Scene hash
+  size_t sceneHash = 0u;
+
+  /// \brief Visual ids of the colors assigned in the render
+  std::map<unsigned int, unsigned int> visualIds;
+};
+
 class ignition::rendering::OgreSelectionBufferPrivate
 {
+  /// \brief Create an offscreen target, replacing any existing one
+  /// \param[in, out] _target Target to create
+  /// \param[in] _name Unique name of the target texture
+  /// \param[in] _width Width in pixels
+  /// \param[in] _height Height in pixels
+  public: void CreateTarget(OgreSelectionTarget &_target,
+      const std::string &_name, unsigned int _width, unsigned int _height);
+
+  /// \brief Destroy an offscreen target
+  /// \param[in, out] _target Target to destroy
+  public: void DeleteTarget(OgreSelectionTarget &_target);
+
+  /// \brief Render the selection buffer into an offscreen target
+  /// \param[in] _target Target to render
+  /// \param[out] _visualIds Visual ids of the colors assigned in the render
+  public: void RenderTarget(OgreSelectionTarget &_target,
+      std::map<unsigned int, unsigned int> &_visualIds);
+
+  /// \brief Blocking read of the content of an offscreen target
+  /// \param[in, out] _target Target to read
+  public: void ReadTarget(OgreSelectionTarget &_target);
+
+  /// \brief Check if the camera view matches the one a frame was rendered
+  /// for
+  /// \param[in] _state State of the frame
+  /// \return True if the view matches
+  public: bool ViewMatches(const OgreSelectionFrameState &_state) const;
+
+  /// \brief Get the id of the visual seen at a pixel of an offscreen target
+  /// \param[in] _target Target to read from
+  /// \param[in] _visualIds Visual ids of the colors assigned in the render
+  /// \param[in] _x X coordinate in pixels
+  /// \param[in] _y Y coordinate in pixels
+  /// \return Id of the visual, 0 if there is none
+  public: static unsigned int VisualIdAt(const OgreSelectionTarget &_target,
+      const std::map<unsigned int, unsigned int> &_visualIds,
+      unsigned int _x, unsigned int _y);
+
+  /// \brief Compute a hash of everything in the scene that affects the
+  /// content of the selection buffer: the set of entities, their visibility
+  /// and their world transforms. Much cheaper than a selection render.
+  /// \return Hash of the scene
+  public: size_t SceneHash() const;
+
   /// \brief This is a material listener and a RenderTargetListener.
   /// The material switcher is applied to only the selection camera
   /// and not applied globally to all targets. The class associates a
@@ -60,8 +151,192 @@ class ignition::rendering::OgreSelectionBufferPrivate
   /// \brief A 2D overlay used for debugging the selection buffer. It
   /// is hidden by default.
   public: Ogre::Overlay *selectionDebugOverlay = nullptr;
+
+  /// \brief Viewport sized target rendered by UpdateFrame
+  public: OgreSelectionTarget frame;
+
+  /// \brief True if a frame has been rendered
+  public: bool frameRendered = false;
+
+  /// \brief State of the frame whose content is in frame.buffer
+  public: OgreSelectionFrameState frameState;
+
+  /// \brief States of the frames rendered but not read back yet, oldest
+  /// first
+  public: std::list<OgreSelectionFrameState> pendingFrames;
+
+  /// \brief Id of the asynchronous readback client of the frame, 0 if
+  /// frames are read back blocking
+  public: unsigned int frameReadbackClient = 0u;
+
+  /// \brief Target rendered by OnSelectionRegion, sized to the last
+  /// requested region
+  public: OgreSelectionTarget region;
 };
 
+/////////////////////////////////////////////////
+void OgreSelectionBufferPrivate::CreateTarget(OgreSelectionTarget &_target,
+    const std::string &_name, unsigned int _width, unsigned int _height)
+{
+  this->DeleteTarget(_target);
+
+  try
+  {
+    _target.texture = Ogre::TextureManager::getSingleton().createManual(
+        _name, Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
+        Ogre::TEX_TYPE_2D, _width, _height, 0, Ogre::PF_R8G8B8,
+        Ogre::TU_RENDERTARGET);
+  }
+  catch(...)
+  {
+    ignerr << "Unable to create selection buffer target.\n";
+    return;
+  }
+
+  // same setup as the 1x1 selection buffer
+  _target.renderTexture = _target.texture->getBuffer()->getRenderTarget();
+  _target.renderTexture->setAutoUpdated(false);
+  _target.renderTexture->setPriority(0);
+  Ogre::Viewport *vp =
+      _target.renderTexture->addViewport(this->selectionCamera);
+  vp->setOverlaysEnabled(false);
+  vp->setShadowsEnabled(false);
+  vp->setClearEveryFrame(true);
+  vp->setMaterialScheme("selection");
+  vp->setVisibilityMask(IGN_VISIBILITY_SELECTABLE);
+  _target.renderTexture->addListener(this->materialSwitcher.get());
+
+  _target.buffer.assign(
+      Ogre::PixelUtil::getMemorySize(_width, _height, 1, Ogre::PF_R8G8B8), 0u);
+  _target.width = _width;
+  _target.height = _height;
+}
+
+/////////////////////////////////////////////////
+void OgreSelectionBufferPrivate::DeleteTarget(OgreSelectionTarget &_target)
+{
+  if (!_target.texture.isNull())
+  {
+    auto &manager = Ogre::TextureManager::getSingleton();
+    manager.unload(_target.texture->getName());
+    manager.remove(_target.texture->getName());
+    _target.texture.setNull();
+  }
+
+  _target.renderTexture = nullptr;
+  _target.buffer.clear();
+  _target.width = 0u;
+  _target.height = 0u;
+}
+
+/////////////////////////////////////////////////
+void OgreSelectionBufferPrivate::RenderTarget(OgreSelectionTarget &_target,
+    std::map<unsigned int, unsigned int> &_visualIds)
+{
+  this->materialSwitcher->Reset();
+
+  // see OgreSelectionBuffer::Update
+  try
+  {
+    _target.renderTexture->update();
+  }
+  catch(...)
+  {
+  }
+
+  // colors are reassigned with every render, so resolve them to visual ids
+  // now
+  _visualIds.clear();
+  for (const auto &color : this->materialSwitcher->colorDict)
+  {
+    if (!this->sceneMgr->hasEntity(color.second))
+      continue;
+
+    Ogre::Entity *entity = this->sceneMgr->getEntity(color.second);
+    const Ogre::Any &any = entity->getUserObjectBindings().getUserAny();
+    if (any.isEmpty() || any.getType() != typeid(unsigned int))
+      continue;
+
+    try
+    {
+      _visualIds[color.first] = Ogre::any_cast<unsigned int>(any);
+    }
+    catch(Ogre::Exception &e)
+    {
+      ignerr << "Ogre Error:" << e.getFullDescription() << "\n";
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+void OgreSelectionBufferPrivate::ReadTarget(OgreSelectionTarget &_target)
+{
+  Ogre::PixelBox pixelBox(_target.width, _target.height, 1, Ogre::PF_R8G8B8,
+      _target.buffer.data());
+  OgreReadbackManager::Instance()->Read(_target.renderTexture, pixelBox);
+}
+
+/////////////////////////////////////////////////
+bool OgreSelectionBufferPrivate::ViewMatches(
+    const OgreSelectionFrameState &_state) const
+{
+  return this->camera->getDerivedPosition() == _state.position &&
+      this->camera->getDerivedOrientation() == _state.orientation &&
+      this->camera->getProjectionMatrix() == _state.projection;
+}
+
+/////////////////////////////////////////////////
+unsigned int OgreSelectionBufferPrivate::VisualIdAt(
+    const OgreSelectionTarget &_target,
+    const std::map<unsigned int, unsigned int> &_visualIds,
+    unsigned int _x, unsigned int _y)
+{
+  // decode the pixel the same way as OnSelectionClick
+  const uint8_t *pixel = _target.buffer.data() +
+      (static_cast<size_t>(_y) * _target.width + _x) * 3u;
+  ignition::math::Color::BGRA color = static_cast<uint32_t>(pixel[0]) |
+      (static_cast<uint32_t>(pixel[1]) << 8) |
+      (static_cast<uint32_t>(pixel[2]) << 16);
+  ignition::math::Color cv;
+  cv.SetFromARGB(color);
+  cv.A(1.0);
+
+  auto it = _visualIds.find(cv.AsRGBA());
+  if (it == _visualIds.end())
+    return 0u;
+  return it->second;
+}
+
+/////////////////////////////////////////////////
+size_t OgreSelectionBufferPrivate::SceneHash() const
+{
+  size_t seed = 0u;
+  auto combine = [&seed](size_t _hash)
+  {
+    seed ^= _hash + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  };
+
+  auto itor = this->sceneMgr->getMovableObjectIterator(
+      Ogre::EntityFactory::FACTORY_TYPE_NAME);
+  while (itor.hasMoreElements())
+  {
+    Ogre::MovableObject *object = itor.getNext();
+    combine(std::hash<const void *>()(object));
+    if (!object->isAttached() || !object->getVisible())
+      continue;
+
+    combine(std::hash<uint32_t>()(object->getVisibilityFlags()));
+    const Ogre::Matrix4 &transform =
+        object->getParentNode()->_getFullTransform();
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      for (unsigned int j = 0; j < 4; ++j)
+        combine(std::hash<Ogre::Real>()(transform[i][j]));
+    }
+  }
+  return seed;
+}
+
 /////////////////////////////////////////////////
 OgreSelectionBuffer::OgreSelectionBuffer(const std::string &_cameraName,
     Ogre::SceneManager *_mgr): dataPtr(new OgreSelectionBufferPrivate)
@@ -81,6 +356,10 @@ OgreSelectionBuffer::OgreSelectionBuffer(const std::string &_cameraName,
 /////////////////////////////////////////////////
 OgreSelectionBuffer::~OgreSelectionBuffer()
 {
+  this->dataPtr->DeleteTarget(this->dataPtr->region);
+  this->dataPtr->DeleteTarget(this->dataPtr->frame);
+  OgreReadbackManager::Instance()->DestroyClient(
+      this->dataPtr->frameReadbackClient);
   this->DeleteRTTBuffer();
 
   // remove selection buffer camera
@@ -111,6 +390,142 @@ void OgreSelectionBuffer::Update()
       Ogre::RenderTarget::FB_FRONT);
 }
 
+/////////////////////////////////////////////////
+void OgreSelectionBuffer::UpdateFrame()
+{
+  if (!this->dataPtr->camera || !this->dataPtr->selectionCamera)
+    return;
+
+  Ogre::Viewport *vp = this->dataPtr->camera->getViewport();
+  if (!vp || !vp->getTarget())
+    return;
+
+  const unsigned int width = vp->getTarget()->getWidth();
+  const unsigned int height = vp->getTarget()->getHeight();
+  if (width == 0u || height == 0u)
+    return;
+
+  auto readback = OgreReadbackManager::Instance();
+  OgreSelectionTarget &frame = this->dataPtr->frame;
+  if (!frame.renderTexture || width != frame.width || height != frame.height)
+  {
+    this->dataPtr->frameRendered = false;
+    this->dataPtr->CreateTarget(frame,
+        "SelectionFrameTex" + this->dataPtr->camera->getName(),
+        width, height);
+
+    // frames in flight were rendered at the old size
+    readback->DestroyClient(this->dataPtr->frameReadbackClient);
+    this->dataPtr->pendingFrames.clear();
+    this->dataPtr->frameReadbackClient =
+        frame.renderTexture ? readback->CreateClient() : 0u;
+    if (!frame.renderTexture)
+      return;
+  }
+
+  // skip the render if neither the view nor the scene changed since the
+  // most recent frame, even if it has not been read back yet
+  size_t sceneHash = this->dataPtr->SceneHash();
+  const OgreSelectionFrameState *latest = nullptr;
+  if (!this->dataPtr->pendingFrames.empty())
+    latest = &this->dataPtr->pendingFrames.back();
+  else if (this->dataPtr->frameRendered)
+    latest = &this->dataPtr->frameState;
+  bool changed = !latest || latest->sceneHash != sceneHash ||
+      !this->dataPtr->ViewMatches(*latest);
+
+  if (changed)
+  {
+    // render from the camera's current view
+    OgreSelectionFrameState state;
+    state.position = this->dataPtr->camera->getDerivedPosition();
+    state.orientation = this->dataPtr->camera->getDerivedOrientation();
+    state.projection = this->dataPtr->camera->getProjectionMatrix();
+    state.sceneHash = sceneHash;
+    this->dataPtr->selectionCamera->setCustomProjectionMatrix(true,
+        state.projection);
+    this->dataPtr->selectionCamera->setPosition(state.position);
+    this->dataPtr->selectionCamera->setOrientation(state.orientation);
+    this->dataPtr->RenderTarget(frame, state.visualIds);
+
+    if (this->dataPtr->frameReadbackClient &&
+        !readback->Request(this->dataPtr->frameReadbackClient,
+        frame.texture.get(), Ogre::PF_R8G8B8))
+    {
+      ignwarn << "Asynchronous readback failed for selection buffer, "
+              << "falling back to blocking readback" << std::endl;
+      readback->DestroyClient(this->dataPtr->frameReadbackClient);
+      this->dataPtr->frameReadbackClient = 0u;
+      this->dataPtr->pendingFrames.clear();
+    }
+
+    if (!this->dataPtr->frameReadbackClient)
+    {
+      this->dataPtr->ReadTarget(frame);
+      this->dataPtr->frameState = std::move(state);
+      this->dataPtr->frameRendered = true;
+      return;
+    }
+    this->dataPtr->pendingFrames.push_back(std::move(state));
+  }
+
+  // pick up a frame rendered earlier. The most recent one is only waited
+  // on if nothing was rendered now, as it was requested at least a frame
+  // ago
+  if (this->dataPtr->pendingFrames.empty() ||
+      !readback->Retrieve(this->dataPtr->frameReadbackClient,
+      frame.buffer.data(), frame.buffer.size(), !changed))
+  {
+    return;
+  }
+  this->dataPtr->frameState =
+      std::move(this->dataPtr->pendingFrames.front());
+  this->dataPtr->pendingFrames.pop_front();
+  this->dataPtr->frameRendered = true;
+}
+
+/////////////////////////////////////////////////
+bool OgreSelectionBuffer::FrameValid() const
+{
+  if (!this->dataPtr->frameRendered || !this->dataPtr->camera)
+    return false;
+
+  Ogre::Viewport *vp = this->dataPtr->camera->getViewport();
+  if (!vp || !vp->getTarget())
+    return false;
+
+  return vp->getTarget()->getWidth() == this->dataPtr->frame.width &&
+      vp->getTarget()->getHeight() == this->dataPtr->frame.height &&
+      this->dataPtr->ViewMatches(this->dataPtr->frameState);
+}
+
+/////////////////////////////////////////////////
+unsigned int OgreSelectionBuffer::FrameVisualIdAt(const int _x,
+    const int _y) const
+{
+  if (!this->dataPtr->frameRendered || _x < 0 || _y < 0 ||
+      _x >= static_cast<int>(this->dataPtr->frame.width) ||
+      _y >= static_cast<int>(this->dataPtr->frame.height))
+  {
+    return 0u;
+  }
+
+  return OgreSelectionBufferPrivate::VisualIdAt(this->dataPtr->frame,
+      this->dataPtr->frameState.visualIds, _x, _y);
+}
+
+/////////////////////////////////////////////////
+unsigned int OgreSelectionBuffer::FrameWidth() const
+{
+  return this->dataPtr->frame.width;
+}
+
+/////////////////////////////////////////////////
+unsigned int OgreSelectionBuffer::FrameHeight() const
+{
+  return this->dataPtr->frame.height;
+}
+
 /////////////////////////////////////////////////
 void OgreSelectionBuffer::DeleteRTTBuffer()
 {
@@ -252,6 +667,88 @@ Ogre::Entity *OgreSelectionBuffer::OnSelectionClick(const int _x, const int _y)
     return this->dataPtr->sceneMgr->getEntity(entName);
 }
 
+/////////////////////////////////////////////////
+std::vector<unsigned int> OgreSelectionBuffer::OnSelectionRegion(
+    const int _x, const int _y, const unsigned int _width,
+    const unsigned int _height)
+{
+  std::vector<unsigned int> ids;
+  if (!this->dataPtr->camera || !this->dataPtr->selectionCamera)
+    return ids;
+
+  Ogre::Viewport *vp = this->dataPtr->camera->getViewport();
+  if (!vp)
+    return ids;
+
+  Ogre::RenderTarget *rt = vp->getTarget();
+  if (!rt)
+    return ids;
+
+  // clip the region to the viewport
+  const int targetWidth = static_cast<int>(rt->getWidth());
+  const int targetHeight = static_cast<int>(rt->getHeight());
+  int x1 = std::max(_x, 0);
+  int y1 = std::max(_y, 0);
+  int x2 = std::min(_x + static_cast<int>(_width), targetWidth);
+  int y2 = std::min(_y + static_cast<int>(_height), targetHeight);
+  if (x1 >= x2 || y1 >= y2)
+    return ids;
+
+  const unsigned int width = static_cast<unsigned int>(x2 - x1);
+  const unsigned int height = static_cast<unsigned int>(y2 - y1);
+  OgreSelectionTarget &region = this->dataPtr->region;
+  if (!region.renderTexture || width != region.width ||
+      height != region.height)
+  {
+    this->dataPtr->CreateTarget(region,
+        "SelectionRegionTex" + this->dataPtr->camera->getName(),
+        width, height);
+    if (!region.renderTexture)
+      return ids;
+  }
+
+  // crop the camera projection to the region, as in OnSelectionClick
+  float left = static_cast<float>(x1) / targetWidth - 0.5f;
+  float top = static_cast<float>(y1) / targetHeight - 0.5f;
+  float right = static_cast<float>(x2) / targetWidth - 0.5f;
+  float bottom = static_cast<float>(y2) / targetHeight - 0.5f;
+  Ogre::Matrix4 scaleMatrix = Ogre::Matrix4::IDENTITY;
+  Ogre::Matrix4 transMatrix = Ogre::Matrix4::IDENTITY;
+  scaleMatrix[0][0] = 1.0 / (right - left);
+  scaleMatrix[1][1] = 1.0 / (bottom - top);
+  transMatrix[0][3] -= left + right;
+  transMatrix[1][3] += top + bottom;
+  this->dataPtr->selectionCamera->setCustomProjectionMatrix(true,
+      scaleMatrix * transMatrix * this->dataPtr->camera->getProjectionMatrix());
+  this->dataPtr->selectionCamera->setPosition(
+      this->dataPtr->camera->getDerivedPosition());
+  this->dataPtr->selectionCamera->setOrientation(
+      this->dataPtr->camera->getDerivedOrientation());
+
+  std::map<unsigned int, unsigned int> visualIds;
+  this->dataPtr->RenderTarget(region, visualIds);
+  this->dataPtr->ReadTarget(region);
+
+  // collect the unique visuals. Neighboring pixels usually share a visual
+  // so only insert changes
+  std::set<unsigned int> unique;
+  unsigned int lastId = 0u;
+  for (unsigned int j = 0; j < height; ++j)
+  {
+    for (unsigned int i = 0; i < width; ++i)
+    {
+      unsigned int id = OgreSelectionBufferPrivate::VisualIdAt(region,
+          visualIds, i, j);
+      if (id == 0u || id == lastId)
+        continue;
+      lastId = id;
+      if (unique.insert(id).second)
+        ids.push_back(id);
+    }
+  }
+  return ids;
+}
+
 /////////////////////////////////////////////////
 void OgreSelectionBuffer::CreateRTTOverlays()
 {
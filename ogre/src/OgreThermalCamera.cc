@@ -26,11 +26,14 @@
 #include <limits>
 
 #include <ignition/math/Helpers.hh>
+#include "ignition/rendering/MemoryTracker.hh"
 #include "ignition/rendering/ShaderParams.hh"
 #include "ignition/rendering/ogre/OgreThermalCamera.hh"
 #include "ignition/rendering/ogre/OgreMaterial.hh"
 #include "ignition/rendering/ogre/OgreVisual.hh"
 
+#include "OgreReadbackManager.hh"
+
 namespace ignition
 {
 namespace rendering
@@ -127,9 +130,18 @@ class ignition::rendering::OgreThermalCameraPrivate
               unsigned int, unsigned int, unsigned int,
               const std::string &)> newThermalFrame;
 
+  /// \brief Event used to signal thermal image data in the image format
+  public: ignition::common::EventT<void(const unsigned char *,
+              unsigned int, unsigned int, unsigned int,
+              const std::string &)> newRawThermalFrame;
+
   /// \brief Pointer to material switcher
   public: std::unique_ptr<OgreThermalCameraMaterialSwitcher>
       thermalMaterialSwitcher;
+
+  /// \brief Id of the readback client, 0 if asynchronous readback is
+  /// disabled
+  public: unsigned int readbackClient = 0u;
 };
 
 using namespace ignition;
@@ -217,34 +229,19 @@ Ogre::Technique *OgreThermalCameraMaterialSwitcher::handleSchemeNotFound(
     return nullptr;
 
   // get temperature
-  std::string tempKey = "temperature";
-  Variant tempAny = ogreVisual->UserData(tempKey);
+  static const UserDataKey tempKey("temperature");
+  const Variant &tempAny = ogreVisual->UserData(tempKey);
   if (tempAny.index() != 0)
   {
     float temp = -1;
-    try
-    {
-      temp = std::get<float>(tempAny);
-    }
-    catch(...)
-    {
-      try
-      {
-        temp = static_cast<float>(std::get<double>(tempAny));
-      }
-      catch(...)
-      {
-        try
-        {
-          temp = static_cast<float>(std::get<int>(tempAny));
-        }
-        catch(std::bad_variant_access &e)
-        {
-          ignerr << "Error casting user data: " << e.what() << "\n";
-          temp = -1.0;
-        }
-      }
-    }
+    if (auto value = std::get_if<float>(&tempAny))
+      temp = *value;
+    else if (auto value = std::get_if<double>(&tempAny))
+      temp = static_cast<float>(*value);
+    else if (auto value = std::get_if<int>(&tempAny))
+      temp = static_cast<float>(*value);
+    else
+      ignerr << "Error casting temperature user data" << std::endl;
 
     // only accept positive temperature (in kelvin)
     if (temp >= 0.0)
@@ -282,14 +279,21 @@ OgreThermalCamera::~OgreThermalCamera()
 //////////////////////////////////////////////////
 void OgreThermalCamera::Destroy()
 {
+  // the queued frames refer to the events of this sensor
+  this->FlushFrames();
+
+  this->SetAsyncReadback(false);
+
   if (this->dataPtr->thermalBuffer)
   {
+    MemoryTracker::Untrack(this->dataPtr->thermalBuffer);
     delete [] this->dataPtr->thermalBuffer;
     this->dataPtr->thermalBuffer = nullptr;
   }
 
   if (this->dataPtr->thermalImage)
   {
+    MemoryTracker::Untrack(this->dataPtr->thermalImage);
     delete [] this->dataPtr->thermalImage;
     this->dataPtr->thermalImage = nullptr;
   }
@@ -514,8 +518,12 @@ void OgreThermalCamera::Render()
 //////////////////////////////////////////////////
 void OgreThermalCamera::PostRender()
 {
-  if (this->dataPtr->newThermalFrame.ConnectionCount() <= 0u)
+  if (this->dataPtr->newThermalFrame.ConnectionCount() <= 0u &&
+      this->dataPtr->newRawThermalFrame.ConnectionCount() <= 0u &&
+      this->newSensorFrame.ConnectionCount() <= 0u)
+  {
     return;
+  }
 
   unsigned int width = this->ImageWidth();
   unsigned int height = this->ImageHeight();
@@ -526,23 +534,60 @@ void OgreThermalCamera::PostRender()
   unsigned int bytesPerChannel = PixelUtil::BytesPerChannel(format);
 
   if (!this->dataPtr->thermalImage)
+  {
     this->dataPtr->thermalImage = new uint16_t[len * channelCount];
+    MemoryTracker::Track(MC_SENSOR_BUFFER, this->dataPtr->thermalImage,
+        len * channelCount * sizeof(uint16_t));
+  }
   if (!this->dataPtr->thermalBuffer)
+  {
     this->dataPtr->thermalBuffer = new uint16_t[len * channelCount];
+    MemoryTracker::Track(MC_SENSOR_BUFFER, this->dataPtr->thermalBuffer,
+        len * channelCount * sizeof(uint16_t));
+  }
 
   // get thermal data
   Ogre::RenderTarget *rt =
       this->dataPtr->ogreThermalTexture->getBuffer()->getRenderTarget();
-  Ogre::PixelBox ogrePixelBox(width, height, 1,
-      OgreConversions::Convert(format), this->dataPtr->thermalBuffer);
-  rt->copyContentsToMemory(ogrePixelBox);
+  if (this->dataPtr->readbackClient)
+  {
+    // queue a copy of the frame that has just been rendered and retrieve a
+    // previous one so the transfer overlaps with the next render
+    auto readback = OgreReadbackManager::Instance();
+    if (!readback->Request(this->dataPtr->readbackClient,
+        this->dataPtr->ogreThermalTexture, OgreConversions::Convert(format)))
+    {
+      ignwarn << "Asynchronous readback failed for thermal camera ["
+              << this->Name() << "], falling back to blocking readback"
+              << std::endl;
+      this->SetAsyncReadback(false);
+    }
+    else if (!readback->Retrieve(this->dataPtr->readbackClient,
+        this->dataPtr->thermalBuffer, len * channelCount * bytesPerChannel))
+    {
+      // no frame available yet
+      return;
+    }
+  }
+
+  if (!this->dataPtr->readbackClient)
+  {
+    Ogre::PixelBox ogrePixelBox(width, height, 1,
+        OgreConversions::Convert(format), this->dataPtr->thermalBuffer);
+    rt->copyContentsToMemory(ogrePixelBox);
+  }
 
   // fill thermal data
   memcpy(this->dataPtr->thermalImage, this->dataPtr->thermalBuffer,
       height*width*channelCount*bytesPerChannel);
 
-  this->dataPtr->newThermalFrame(
-      this->dataPtr->thermalBuffer, width, height, 1, "L16");
+  // sensor frame subscribers get the raw frame
+  this->DispatchFrame(this->dataPtr->newThermalFrame,
+      this->dataPtr->thermalBuffer, len, width, height, 1, "L16", false);
+
+  this->DispatchFrame(this->dataPtr->newRawThermalFrame,
+      reinterpret_cast<const unsigned char *>(this->dataPtr->thermalBuffer),
+      len * channelCount * bytesPerChannel, width, height, 1, "L16");
 
   // Uncomment to debug thermal output
   // igndbg << "wxh: " << width << " x " << height << std::endl;
@@ -556,6 +601,35 @@ void OgreThermalCamera::PostRender()
   // }
 }
 
+//////////////////////////////////////////////////
+void OgreThermalCamera::SetAsyncReadback(bool _enabled)
+{
+  auto readback = OgreReadbackManager::Instance();
+  if (!_enabled)
+  {
+    readback->DestroyClient(this->dataPtr->readbackClient);
+    this->dataPtr->readbackClient = 0u;
+    return;
+  }
+
+  if (this->dataPtr->readbackClient)
+    return;
+
+  this->dataPtr->readbackClient = readback->CreateClient();
+  if (!this->dataPtr->readbackClient)
+  {
+    ignwarn << "Asynchronous readback is not supported by the current "
+            << "render system. Thermal camera [" << this->Name() << "] will "
+            << "use blocking readback" << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+bool OgreThermalCamera::AsyncReadback() const
+{
+  return this->dataPtr->readbackClient != 0u;
+}
+
 //////////////////////////////////////////////////
 common::ConnectionPtr OgreThermalCamera::ConnectNewThermalFrame(
     std::function<void(const uint16_t *, unsigned int, unsigned int,
@@ -564,6 +638,14 @@ common::ConnectionPtr OgreThermalCamera::ConnectNewThermalFrame(
   return this->dataPtr->newThermalFrame.Connect(_subscriber);
 }
 
+//////////////////////////////////////////////////
+common::ConnectionPtr OgreThermalCamera::ConnectNewRawThermalFrame(
+    std::function<void(const unsigned char *, unsigned int, unsigned int,
+      unsigned int, const std::string &)>  _subscriber)
+{
+  return this->dataPtr->newRawThermalFrame.Connect(_subscriber);
+}
+
 //////////////////////////////////////////////////
 RenderTargetPtr OgreThermalCamera::RenderTarget() const
 {
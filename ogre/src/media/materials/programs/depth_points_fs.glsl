@@ -17,8 +17,21 @@
 
 varying vec4 eyePos;
 
+uniform vec4 diffuse;
+uniform float hasTexture;
+uniform sampler2D tex;
+
 void main()
 {
+  vec4 color = diffuse;
+  if (hasTexture > 0.5)
+    color *= texture2D(tex, gl_TexCoord[0].xy);
+
+  // pack the 8 bit color channels into an integer value that the 32 bit
+  // float channel holds exactly
+  vec3 c = floor(clamp(color.rgb, 0.0, 1.0) * 255.0 + 0.5);
+
   // convert to z up
-  gl_FragColor = vec4(-eyePos.z, -eyePos.x, eyePos.y, 1.0);
+  gl_FragColor = vec4(-eyePos.z, -eyePos.x, eyePos.y,
+      c.r * 65536.0 + c.g * 256.0 + c.b);
 }
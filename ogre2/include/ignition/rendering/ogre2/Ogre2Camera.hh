@@ -18,6 +18,7 @@
 #define IGNITION_RENDERING_OGRE2_OGRE2CAMERA_HH_
 
 #include <memory>
+#include <vector>
 
 #include "ignition/rendering/base/BaseCamera.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderTypes.hh"
@@ -69,6 +70,26 @@ namespace ignition
       // Documentation inherited.
       public: virtual void SetNearClipPlane(const double _near) override;
 
+      // Documentation inherited.
+      public: virtual void SetLodBias(double _bias) override;
+
+      // Documentation inherited.
+      public: virtual void SetImpostorsEnabled(bool _enabled) override;
+
+      // Documentation inherited.
+      public: virtual void SetShadowsEnabled(bool _enabled) override;
+
+      // Documentation inherited.
+      public: virtual void SetShadowMapSize(unsigned int _size) override;
+
+      // Documentation inherited.
+      public: virtual bool SetDynamicResolutionEnabled(bool _enabled)
+                  override;
+
+      // Documentation inherited.
+      public: virtual bool SetOrderIndependentTransparencyEnabled(
+                  bool _enabled) override;
+
       public: virtual math::Color BackgroundColor() const;
 
       public: virtual void SetBackgroundColor(const math::Color &_color);
@@ -84,6 +105,9 @@ namespace ignition
       // Documentation inherited.
       public: virtual void Render() override;
 
+      // Documentation inherited.
+      public: virtual void PostRender() override;
+
       // Documentation inherited.
       public: virtual RenderWindowPtr CreateRenderWindow() override;
 
@@ -97,6 +121,11 @@ namespace ignition
       public: virtual VisualPtr VisualAt(const ignition::math::Vector2i
                   &_mousePos) override;
 
+      // Documentation inherited.
+      public: virtual std::vector<VisualPtr> VisualsInRegion(
+                  const ignition::math::Vector2i &_min,
+                  const ignition::math::Vector2i &_max) override;
+
       // Documentation Inherited.
       // \sa Camera::SetMaterial(const MaterialPtr &)
       public: virtual void SetMaterial(
@@ -105,6 +134,10 @@ namespace ignition
       // Documentation inherited.
       public: virtual unsigned int RenderTextureGLId() const override;
 
+      // Documentation inherited.
+      public: virtual bool CopyRegion(Image &_image, unsigned int _x,
+                  unsigned int _y) const override;
+
       // Documentation inherited.
       // TODO(anyone): this function should be virtual, declared in 'Camera'
       // and 'BaseCamera'. We didn't do it to preserve ABI.
@@ -117,6 +150,22 @@ namespace ignition
 
       public: Ogre::Camera *OgreCamera() const;
 
+      /// \brief Set whether the selection buffer is also rendered for the
+      /// whole image each time the camera renders. The selection buffer is
+      /// only rendered again if the camera view or the scene changed. As
+      /// long as the camera has not moved since its last frame, VisualAt
+      /// then only reads the cached frame, and ray queries created from
+      /// this camera can be answered from it instead of testing the scene
+      /// on the CPU.
+      /// \param[in] _enabled True to render the selection buffer with
+      /// each frame
+      /// \sa Ogre2RayQuery::SetUseSelectionBuffer
+      public: void SetSelectionFrameEnabled(bool _enabled);
+
+      /// \brief Get whether the selection buffer is rendered with each frame
+      /// \return True if enabled
+      public: bool SelectionFrameEnabled() const;
+
       // Documentation inherited.
       public: virtual void SetVisibilityMask(uint32_t _mask) override;
 
@@ -157,6 +206,14 @@ namespace ignition
       /// \brief Make ray query our friend so it can use the internal ogre
       /// camera to execute queries
       private: friend class Ogre2RayQuery;
+
+      /// \brief Make camera batch our friend so it can copy the render
+      /// texture on the GPU
+      private: friend class Ogre2CameraBatch;
+
+      /// \brief Make image pyramid our friend so it can downsample the
+      /// render texture on the GPU
+      private: friend class Ogre2ImagePyramid;
     };
     }
   }
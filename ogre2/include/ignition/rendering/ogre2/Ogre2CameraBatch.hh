@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2CAMERABATCH_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2CAMERABATCH_HH_
+
+#include <cstddef>
+#include <memory>
+
+#include "ignition/rendering/RenderTypes.hh"
+#include "ignition/rendering/ogre2/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // forward declaration
+    class Ogre2CameraBatchPrivate;
+
+    /* \class Ogre2CameraBatch Ogre2CameraBatch.hh \
+     * ignition/rendering/ogre2/Ogre2CameraBatch.hh
+     */
+    /// \brief Renders many ogre2 cameras, possibly from different scenes,
+    /// and reads their images back as one contiguous buffer. All cameras
+    /// are rendered in a single render batch. Their images are then copied
+    /// on the GPU into tiles stacked in a few large textures, which are read
+    /// back with one transfer each instead of one per camera. This is meant
+    /// for many small images, e.g. one camera per environment of a batch.
+    class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2CameraBatch
+    {
+      /// \brief Constructor
+      public: Ogre2CameraBatch();
+
+      /// \brief Destructor
+      public: virtual ~Ogre2CameraBatch();
+
+      /// \brief Add a camera to the batch. All cameras of a batch must have
+      /// the same image width, height and format.
+      /// \param[in] _camera Ogre2 camera to add
+      /// \return True if the camera was added
+      public: bool AddCamera(CameraPtr _camera);
+
+      /// \brief Get the number of cameras in the batch
+      /// \return Number of cameras
+      public: unsigned int CameraCount() const;
+
+      /// \brief Get a camera of the batch
+      /// \param[in] _index Index of the camera, in the order they were added
+      /// \return The camera, null if the index is out of range
+      public: CameraPtr CameraByIndex(unsigned int _index) const;
+
+      /// \brief Remove all cameras and release the GPU textures
+      public: void Clear();
+
+      /// \brief Get the size of the buffer Capture fills
+      /// \return Number of bytes of the images of all the cameras
+      public: size_t MemorySize() const;
+
+      /// \brief Render all cameras and copy their images into a buffer.
+      /// The images are stored one after the other, in the order the cameras
+      /// were added, with tightly packed rows, i.e. as a
+      /// [camera][row][column][channel] tensor.
+      /// \param[out] _data Buffer of at least MemorySize() bytes
+      /// \return True if the images were copied
+      public: bool Capture(void *_data);
+
+      /// \internal
+      /// \brief Pointer to private data
+      private: std::unique_ptr<Ogre2CameraBatchPrivate> dataPtr;
+    };
+    }
+  }
+}
+#endif
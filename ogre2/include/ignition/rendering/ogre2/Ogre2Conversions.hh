@@ -17,8 +17,11 @@
 #ifndef IGNITION_RENDERING_OGRE2_OGRE2CONVERSIONS_HH_
 #define IGNITION_RENDERING_OGRE2_OGRE2CONVERSIONS_HH_
 
+#include <cstddef>
+
 #include <ignition/math/Color.hh>
 #include <ignition/math/Matrix4.hh>
+#include <ignition/math/Pose3.hh>
 #include <ignition/math/Quaternion.hh>
 #include <ignition/math/Vector3.hh>
 
@@ -84,6 +87,23 @@ namespace ignition
       /// return ign-math quaternion
       public: static math::Quaterniond Convert(const Ogre::Quaternion &_quat);
 
+      /// \brief Ign-math poses to Ogre positions and orientations, several
+      /// values at a time with the widest instruction set the library is
+      /// compiled for
+      /// \param[in] _poses Poses to convert
+      /// \param[in] _count Number of poses
+      /// \param[out] _positions Positions of the poses, _count of them
+      /// \param[out] _orientations Orientations of the poses, _count of them
+      public: static void Convert(const math::Pose3d *_poses, size_t _count,
+                  Ogre::Vector3 *_positions, Ogre::Quaternion *_orientations);
+
+      /// \brief Packed single precision points to Ogre vectors
+      /// \param[in] _xyz Coordinates of the points, 3 per point
+      /// \param[in] _count Number of points
+      /// \param[out] _vectors Ogre vectors, _count of them
+      public: static void Convert(const float *_xyz, size_t _count,
+                  Ogre::Vector3 *_vectors);
+
       /// \brief Ign-math angle to Ogre angle
       /// \param[in] _angle ign-math angle
       /// \return Ogre angle
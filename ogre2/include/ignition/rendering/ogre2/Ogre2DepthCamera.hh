@@ -73,10 +73,22 @@ namespace ignition
       /// \brief Set up 1st pass material, texture, and compositor
       public: virtual void CreateDepthTexture() override;
 
+      /// \brief Destroy the depth textures and the workspace, and release
+      /// the compositor definitions and materials shared with other depth
+      /// cameras
+      private: void DestroyDepthTexture();
+
       /// \brief Creates an Ogre Workspace instance. Assumes the definition
       /// already and the depth texture have already been created
       private: void CreateWorkspaceInstance();
 
+      /// \brief Run the GPU reductions of the point cloud that have
+      /// subscribers and emit their outputs
+      private: void ReducePointCloud();
+
+      /// \brief Destroy the workspaces and textures of the GPU reductions
+      private: void DestroyReductions();
+
       // Documentation inherited
       public: virtual void PreRender() override;
 
@@ -101,9 +113,118 @@ namespace ignition
           std::function<void(const float *, unsigned int, unsigned int,
           unsigned int, const std::string &)>  _subscriber) override;
 
+      // Documentation inherited.
+      public: virtual ignition::common::ConnectionPtr ConnectNewRgbFrame(
+          std::function<void(const unsigned char *, unsigned int,
+          unsigned int, unsigned int, const std::string &)>  _subscriber)
+          override;
+
+      // Documentation inherited.
+      public: virtual ignition::common::ConnectionPtr ConnectNewNormalFrame(
+          std::function<void(const float *, unsigned int, unsigned int,
+          unsigned int, const std::string &)>  _subscriber) override;
+
+      // Documentation inherited.
+      public: virtual ignition::common::ConnectionPtr ConnectNewRawDepthFrame(
+          std::function<void(const unsigned char *, unsigned int,
+          unsigned int, unsigned int, const std::string &)>  _subscriber)
+          override;
+
       /// \brief Implementation of the render call
       public: virtual void Render() override;
 
+      /// \brief Enable or disable asynchronous readback of the depth data.
+      /// When enabled, the GPU to CPU copy of a frame overlaps with the
+      /// rendering of the next one and the new depth frame and rgb point
+      /// cloud events are emitted one frame late. Blocking readback is used
+      /// if the render system does not support it.
+      /// \param[in] _enabled True to enable asynchronous readback
+      public: void SetAsyncReadback(bool _enabled);
+
+      /// \brief Get whether asynchronous readback is enabled
+      /// \return True if asynchronous readback is enabled
+      public: bool AsyncReadback() const;
+
+      /// \brief Get the OpenGL texture id of the texture that holds the
+      /// depth data. Each texel stores 4 floats: the x, y, z position of the
+      /// point in the camera frame and its packed rgba color, as in the rgb
+      /// point cloud passed to ConnectNewRgbPointCloud. The depth is the x
+      /// channel. A valid id is returned only if the render system is
+      /// OpenGL based.
+      /// \return Texture Id of type GLuint.
+      public: virtual unsigned int RenderTextureGLId() const override;
+
+      /// \brief Enable or disable copying the depth data to CPU memory after
+      /// each render. Disable it when the depth data is only consumed on
+      /// the GPU through RenderTextureGLId. While disabled, DepthData() is
+      /// not updated and no new depth frame or rgb point cloud event is
+      /// emitted. CPU readback is enabled by default.
+      /// \param[in] _enabled True to enable CPU readback
+      public: void SetCpuReadback(bool _enabled);
+
+      /// \brief Get whether the depth data is copied to CPU memory
+      /// \return True if CPU readback is enabled
+      public: bool CpuReadback() const;
+
+      /// \brief Reduce the point cloud to a laser scan on the GPU after
+      /// each render: the range of each image column is the smallest
+      /// distance, in the horizontal plane of the camera, of the points of
+      /// a band of rows. Only the scan is read back for it, also when CPU
+      /// readback is disabled.
+      /// \param[in] _firstRow First row of the band
+      /// \param[in] _rowCount Number of rows of the band, 0 to disable
+      /// the laser scan
+      public: void SetLaserScanRows(unsigned int _firstRow,
+                  unsigned int _rowCount);
+
+      /// \brief Connect to the laser scans reduced on the GPU. The
+      /// subscriber receives one range per image column, from the left,
+      /// with a width of the image width, a height and a channel count of 1,
+      /// and the "PF_FLOAT32_R" format. Columns without a point in range are
+      /// +inf. The bearing of a column follows from the camera projection.
+      /// \param[in] _subscriber Subscriber callback function
+      /// \return Pointer to the new Connection. This must be kept in scope
+      /// \sa SetLaserScanRows
+      public: ignition::common::ConnectionPtr ConnectNewLaserScan(
+          std::function<void(const float *, unsigned int, unsigned int,
+          unsigned int, const std::string &)>  _subscriber);
+
+      /// \brief Downsample the point cloud to a voxel grid after each
+      /// render. The GPU reduces each tile of _tileSize x _tileSize pixels
+      /// to the centroid of its points, so that only one point per tile is
+      /// read back, and the centroids falling in the same voxel are then
+      /// merged on the CPU. Also done when CPU readback is disabled.
+      /// \param[in] _leafSize Size of the voxels in meters, 0 to disable the
+      /// voxel cloud
+      /// \param[in] _tileSize Size of the tiles reduced on the GPU, in
+      /// pixels, at least 1
+      public: void SetVoxelCloud(double _leafSize,
+                  unsigned int _tileSize = 4u);
+
+      /// \brief Connect to the voxel downsampled point clouds. The
+      /// subscriber receives one xyz + rgba point per occupied voxel, laid
+      /// out as the rgb point cloud, with a width of the number of points,
+      /// a height of 1, 4 channels and the "PF_FLOAT32_RGBA" format. The
+      /// color of a voxel is the color of one of its points.
+      /// \param[in] _subscriber Subscriber callback function
+      /// \return Pointer to the new Connection. This must be kept in scope
+      /// \sa SetVoxelCloud
+      public: ignition::common::ConnectionPtr ConnectNewVoxelCloud(
+          std::function<void(const float *, unsigned int, unsigned int,
+          unsigned int, const std::string &)>  _subscriber);
+
+      /// \brief Read a region of the last depth frame back from the GPU,
+      /// without reading the rest of the frame. Works whether CPU readback
+      /// is enabled or not.
+      /// \param[out] _image Output image, of the size of the region. A
+      /// PF_FLOAT32_R image receives the depth in meters, a PF_FLOAT32_RGBA
+      /// image the xyz + rgba points of RenderTextureGLId.
+      /// \param[in] _x Column of the top left pixel of the region
+      /// \param[in] _y Row of the top left pixel of the region
+      /// \return True if the region was copied
+      public: virtual bool CopyRegion(Image &_image, unsigned int _x,
+                  unsigned int _y) const override;
+
       /// \brief Set the far clip distance
       /// \param[in] _far far clip distance
       public: virtual void SetFarClipPlane(const double _far) override;
@@ -122,6 +243,12 @@ namespace ignition
       /// ogre camera has not been created.
       public: double FarClipPlane() const override;
 
+      // Documentation inherited.
+      public: virtual void SetShadowsEnabled(bool _enabled) override;
+
+      // Documentation inherited.
+      public: virtual void SetShadowMapSize(unsigned int _size) override;
+
       // Documentation inherited.
       // TODO(anyone): this function should be virtual, declared in 'Camera'
       // and 'BaseCamera'. We didn't do it to preserve ABI.
@@ -129,6 +256,11 @@ namespace ignition
       // see changes made and revert
       public: void SetShadowsNodeDefDirty();
 
+      /// \brief Destroy the depth textures if the compositor definitions
+      /// are shared with other depth cameras, so that they are created
+      /// again for the current configuration in PreRender
+      private: void UnshareDefinitions();
+
       // TODO(anyone): This fixes the pass quad material leaving dangling
       // pointers when we remove the workspace, so we have to cleanup the
       // material first.
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2DISTORTIONPASS_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2DISTORTIONPASS_HH_
+
+#include <memory>
+
+#include "ignition/rendering/base/BaseDistortionPass.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderPass.hh"
+#include "ignition/rendering/ogre2/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // forward declaration
+    class Ogre2DistortionPassPrivate;
+
+    /* \class Ogre2DistortionPass Ogre2DistortionPass.hh \
+     * ignition/rendering/ogre2/Ogre2DistortionPass.hh
+     */
+    /// \brief Ogre2 Implementation of a distortion render pass. The source
+    /// uv of each pixel of the distorted image is computed on the CPU in a
+    /// remap texture, shared by the passes with the same coefficients and
+    /// camera projection, and only recomputed when they change. The pass
+    /// then draws a full screen quad looking up the remap texture.
+    class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2DistortionPass :
+      public BaseDistortionPass<Ogre2RenderPass>
+    {
+      /// \brief Constructor
+      public: Ogre2DistortionPass();
+
+      /// \brief Destructor
+      public: virtual ~Ogre2DistortionPass();
+
+      // Documentation inherited
+      public: void PreRender() override;
+
+      // Documentation inherited
+      public: void CreateRenderPass() override;
+
+      /// \brief Sample the input without filtering, for inputs which
+      /// pixels can not be interpolated, like the packed colors of depth
+      /// cameras. This must be set before the render pass is created.
+      /// \param[in] _point True to sample the nearest input pixel
+      public: void SetPointSampling(bool _point);
+
+      /// \brief Pointer to private data class
+      private: std::unique_ptr<Ogre2DistortionPassPrivate> dataPtr;
+    };
+    }
+  }
+}
+#endif
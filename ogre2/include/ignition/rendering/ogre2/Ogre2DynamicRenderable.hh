@@ -17,6 +17,7 @@
 #ifndef IGNITION_RENDERING_OGRE2_OGRE2DYNAMICRENDERABLE_HH_
 #define IGNITION_RENDERING_OGRE2_OGRE2DYNAMICRENDERABLE_HH_
 
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <vector>
@@ -29,6 +30,7 @@
   #pragma warning(push, 0)
 #endif
 #include <OgreHlmsPso.h>
+#include <OgreVector3.h>
 #ifdef _MSC_VER
   #pragma warning(pop)
 #endif
@@ -89,6 +91,14 @@ namespace ignition
       public: void AddPoint(const double _x, const double _y, const double _z,
             const ignition::math::Color &_color = ignition::math::Color::White);
 
+      /// \brief Replace all points in the point list
+      /// \param[in] _xyz Point positions, 3 floats per point
+      /// \param[in] _count Number of points
+      /// \param[in] _rgba Point colors, 4 floats per point. Points are white
+      /// if null.
+      public: void SetPoints(const float *_xyz, size_t _count,
+            const float *_rgba = nullptr);
+
       /// \brief Change the location of an existing point in the point list
       /// \param[in] _index Index of the point to set
       /// \param[in] _value Position of the point
@@ -135,7 +145,7 @@ namespace ignition
       /// \param[in] _vertices a list of vertices
       /// \param[in,out] _vbuffer vertex buffer to be filled
       private: void GenerateNormals(Ogre::OperationType _opType,
-          const std::vector<math::Vector3d> &_vertices, float *_vbuffer);
+          const std::vector<Ogre::Vector3> &_vertices, float *_vbuffer);
 
       /// \brief Destroy the vertex buffer
       private: void DestroyBuffer();
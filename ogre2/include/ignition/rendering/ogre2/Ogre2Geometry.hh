@@ -17,6 +17,8 @@
 #ifndef IGNITION_RENDERING_OGRE2_OGRE2GEOMETRY_HH_
 #define IGNITION_RENDERING_OGRE2_OGRE2GEOMETRY_HH_
 
+#include <ignition/math/Vector3.hh>
+
 #include "ignition/rendering/base/BaseGeometry.hh"
 #include "ignition/rendering/ogre2/Ogre2Object.hh"
 
@@ -55,6 +57,12 @@ namespace ignition
       /// \param[in] _parent Parent visual
       protected: virtual void SetParent(Ogre2VisualPtr _parent);
 
+      /// \brief Get the translation of the ogre object from the node of
+      /// the parent visual. Visuals attach objects with a non zero offset
+      /// to a child node translated by the offset.
+      /// \return Offset in the frame of the parent visual, zero by default
+      protected: virtual math::Vector3d OgreObjectOffset() const;
+
       /// \brief Parent visual
       protected: Ogre2VisualPtr parent;
 
@@ -18,9 +18,14 @@
 #ifndef IGNITION_RENDERING_OGRE2_OGRE2GPURAYS_HH_
 #define IGNITION_RENDERING_OGRE2_OGRE2GPURAYS_HH_
 
+#include <cstdint>
 #include <string>
 #include <memory>
+#include <vector>
 
+#include <ignition/math/Vector2.hh>
+
+#include "ignition/rendering/PixelFormat.hh"
 #include "ignition/rendering/RenderTypes.hh"
 #include "ignition/rendering/base/BaseGpuRays.hh"
 #include "ignition/rendering/ogre2/Export.hh"
@@ -59,7 +64,8 @@ namespace ignition
     /// then convert them into ranges, i.e. length(pos.xyz).
     /// 2nd Pass: Samples range data from cubemap using predefined rays. The
     /// rays are generated based on the specified vertical and horizontal
-    /// min/max angles and no. of samples. Each ray is a direction vector that
+    /// min/max angles and no. of samples, or on an explicit angle table, see
+    /// SetRayAngles. Each ray is a direction vector that
     /// is used to sample/lookup the range data stored in the faces of the
     /// cubemap.
     class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2GpuRays :
@@ -101,6 +107,198 @@ namespace ignition
       // Documentation inherited.
       public: virtual RenderTargetPtr RenderTarget() const override;
 
+      /// \brief Enable or disable asynchronous readback of the range data.
+      /// When enabled, the GPU to CPU copy of a frame overlaps with the
+      /// rendering of the next one and the new gpu rays frame event is
+      /// emitted one frame late. Blocking readback is used if the render
+      /// system does not support it.
+      /// \param[in] _enabled True to enable asynchronous readback
+      public: void SetAsyncReadback(bool _enabled);
+
+      /// \brief Get whether asynchronous readback is enabled
+      /// \return True if asynchronous readback is enabled
+      public: bool AsyncReadback() const;
+
+      /// \brief Get the OpenGL texture id of the texture that holds the
+      /// range data. Each texel stores one gpu rays reading as 3 floats,
+      /// laid out as in the gpu rays frame passed to ConnectNewGpuRaysFrame,
+      /// or as 2 packed values if a packed format is set.
+      /// A valid id is returned only if the render system is OpenGL based.
+      /// \return Texture Id of type GLuint.
+      public: virtual unsigned int RenderTextureGLId() const override;
+
+      /// \brief Enable or disable copying the range data to CPU memory after
+      /// each render. Disable it when the range data is only consumed on
+      /// the GPU through RenderTextureGLId. While disabled, Data() is not
+      /// updated and no new gpu rays frame event is emitted.
+      /// CPU readback is enabled by default.
+      /// \param[in] _enabled True to enable CPU readback
+      public: void SetCpuReadback(bool _enabled);
+
+      /// \brief Get whether the range data is copied to CPU memory
+      /// \return True if CPU readback is enabled
+      public: bool CpuReadback() const;
+
+      /// \brief Sample the cubemap rendered by another sensor instead of
+      /// rendering one, e.g. for lidars mounted a few centimeters apart on
+      /// the same parent. Only the 2nd pass, which resamples the cubemap, is
+      /// rendered for this sensor, so co-located sensors rasterize the scene
+      /// once. Ranges are measured from the origin of the source and clamped
+      /// by its clip planes. The orientation of this sensor relative to the
+      /// source is read when it is first rendered and must not change
+      /// afterwards. The source should be rendered first, e.g. in the same
+      /// render batch. If some rays are not covered by the cubemap of the
+      /// source, this sensor renders its own cubemap.
+      /// Must be called before the sensor is first rendered.
+      /// \param[in] _source Sensor rendering the cubemap, null to render
+      /// a cubemap for this sensor
+      public: void SetCubemapSource(Ogre2GpuRaysPtr _source);
+
+      /// \brief Get the sensor whose cubemap is sampled
+      /// \return Cubemap source, null if this sensor renders its own cubemap
+      /// \sa SetCubemapSource
+      public: Ogre2GpuRaysPtr CubemapSource() const;
+
+      /// \brief Set the format the 2nd pass packs the range and intensity
+      /// of each ray to, so that 4 bytes per ray are read back instead of
+      /// 12. PF_FLOAT16_R packs them to half floats, PF_L16 to unsigned 16
+      /// bit fixed point values at the resolutions set with
+      /// SetPackedResolution, and PF_FLOAT32_R, the default, disables
+      /// packing. While packing, Data() and Copy() are only updated, by
+      /// unpacking on the CPU, if there are new gpu rays frame
+      /// subscribers. Must be called before the sensor is first rendered.
+      /// \param[in] _format Packed format of each value
+      public: void SetPackedFormat(PixelFormat _format);
+
+      /// \brief Get the format the range and intensity are packed to
+      /// \return PF_FLOAT16_R, PF_L16, or PF_FLOAT32_R if not packed
+      /// \sa SetPackedFormat
+      public: PixelFormat PackedFormat() const;
+
+      /// \brief Set the resolutions of the PF_L16 packed format. Ranges
+      /// and intensities are divided by their resolution and rounded.
+      /// Values that do not fit saturate to 0 and 65535, which unpack to
+      /// the minimum and maximum range of the sensor respectively.
+      /// \param[in] _range Range resolution in meters, 1 mm by default
+      /// \param[in] _intensity Intensity resolution, 1 by default
+      public: void SetPackedResolution(double _range, double _intensity);
+
+      /// \brief Get the range resolution of the PF_L16 packed format
+      /// \return Range resolution in meters
+      public: double PackedRangeResolution() const;
+
+      /// \brief Get the intensity resolution of the PF_L16 packed format
+      /// \return Intensity resolution
+      public: double PackedIntensityResolution() const;
+
+      /// \brief Connect to the packed gpu rays frame signal, emitted while
+      /// a packed format is set
+      /// \param[in] _subscriber Callback that is called when a new frame is
+      /// read back. The callback function parameters are:
+      ///   _frame:   Two 16 bit values per reading, the range and the
+      ///             intensity, in the packed format
+      ///   _width:   Width of the frame
+      ///   _height:  Height of the frame
+      ///   _channels: Number of values per reading, i.e. 2
+      ///   _format:  Packed format of each value, e.g. "L16"
+      /// \return A pointer to the connection. This must be kept in scope.
+      /// \sa SetPackedFormat
+      public: common::ConnectionPtr ConnectNewPackedGpuRaysFrame(
+                  std::function<void(const uint16_t *_frame,
+                  unsigned int _width, unsigned int _height,
+                  unsigned int _channels, const std::string &_format)>
+                  _subscriber);
+
+      /// \brief Copy the last packed frame read back, 2 values of 16 bits
+      /// per reading as in ConnectNewPackedGpuRaysFrame
+      /// \param[out] _data Destination, with room for RangeCount() *
+      /// VerticalRangeCount() * 2 values. Left unchanged if no packed
+      /// frame has been read back.
+      public: void CopyPacked(uint16_t *_data) const;
+
+      /// \brief Set an explicit angle for each reading, for lidars with
+      /// non-uniform or non-repetitive beam patterns, instead of the
+      /// readings evenly spaced between the min and max angles. The angles
+      /// are baked into the sample texture, so the whole pattern is covered
+      /// by one cubemap render. Readings keep their RangeCount() x
+      /// VerticalRangeCount() layout. Must be called before the sensor is
+      /// first rendered.
+      /// \param[in] _angles Horizontal and vertical angle of each reading in
+      /// radians, row major, RangeCount() * VerticalRangeCount() of them.
+      /// An empty table, the default, spaces the readings evenly.
+      public: void SetRayAngles(const std::vector<math::Vector2d> &_angles);
+
+      /// \brief Get the angle of each reading
+      /// \return Horizontal and vertical angles in radians, empty if the
+      /// readings are evenly spaced
+      /// \sa SetRayAngles
+      public: const std::vector<math::Vector2d> &RayAngles() const;
+
+      /// \brief Split the readings in azimuth sectors, for spinning lidars
+      /// which only sweep part of the scene per update. Each update then
+      /// only renders the cubemap faces sampled by the current sector, and
+      /// the sectors are rendered in turn. The readings of the other
+      /// sectors keep the values of the faces when they were last
+      /// rendered, so the per update cost is spread over the sweep like the
+      /// latency of a real lidar. Sensors sampling the cubemap of another
+      /// sensor are not split. Must be called before the sensor is first
+      /// rendered.
+      /// \param[in] _count Number of sectors, 1 by default to render all
+      /// faces every update. Clamped to RangeCount().
+      public: void SetSectorCount(unsigned int _count);
+
+      /// \brief Get the number of azimuth sectors
+      /// \return Number of sectors
+      /// \sa SetSectorCount
+      public: unsigned int SectorCount() const;
+
+      /// \brief Get the columns of the readings in a sector. Sectors are
+      /// consecutive ranges of columns, i.e. of horizontal readings.
+      /// \param[in] _sector Index of the sector
+      /// \param[out] _first First column of the sector
+      /// \param[out] _count Number of columns of the sector
+      public: void SectorColumns(unsigned int _sector, unsigned int &_first,
+          unsigned int &_count) const;
+
+      /// \brief Connect to the sector signal, emitted from PostRender with
+      /// the readings of the sector read back last while the readings are
+      /// split in sectors
+      /// \param[in] _subscriber Callback that is called when a new sector
+      /// is read back. The callback function parameters are:
+      ///   _frame:   Readings of the sector, row major, with the same
+      ///             channels as the gpu rays frame
+      ///   _sector:  Index of the sector
+      ///   _first:   First column of the sector
+      ///   _width:   Number of columns of the sector
+      ///   _height:  Number of rows, i.e. VerticalRangeCount()
+      ///   _channels: Number of channels of each reading
+      /// \return A pointer to the connection. This must be kept in scope.
+      /// \sa SetSectorCount
+      public: common::ConnectionPtr ConnectNewGpuRaysSector(
+                  std::function<void(const float *_frame,
+                  unsigned int _sector, unsigned int _first,
+                  unsigned int _width, unsigned int _height,
+                  unsigned int _channels)> _subscriber);
+
+      /// \brief Add a render pass applied to the readings on the GPU, in
+      /// the 2nd pass. Only one GaussianNoisePass, adding Gaussian noise to
+      /// the range of the hits, and one DropoutPass, dropping rays which
+      /// then return no hit, are supported. Noise is added before the
+      /// readings are packed, and noisy ranges stay within the clip planes.
+      /// The bias of the noise pass is added to its mean.
+      /// \param[in] _pass Gaussian noise or dropout pass
+      public: void AddRenderPass(const RenderPassPtr &_pass) override;
+
+      // Documentation inherited.
+      public: void RemoveRenderPass(const RenderPassPtr &_pass) override;
+
+      // Documentation inherited.
+      public: unsigned int RenderPassCount() const override;
+
+      // Documentation inherited.
+      public: RenderPassPtr RenderPassByIndex(unsigned int _index) const
+          override;
+
       /// \brief Set the number of samples in the width and height for the
       /// first pass texture.
       /// \param[in] _w Number of samples in the horizontal sweep
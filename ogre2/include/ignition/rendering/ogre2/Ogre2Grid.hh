@@ -19,6 +19,7 @@
 #define IGNITION_RENDERING_OGRE2_OGRE2GRID_HH_
 
 #include <memory>
+#include <string>
 #include "ignition/rendering/base/BaseGrid.hh"
 #include "ignition/rendering/ogre2/Ogre2Geometry.hh"
 
@@ -49,6 +50,9 @@ namespace ignition
       // Documentation inherited.
       public: virtual void Init();
 
+      // Documentation inherited.
+      public: virtual void Destroy();
+
       // Documentation inherited.
       public: virtual Ogre::MovableObject *OgreObject() const;
 
@@ -68,6 +72,12 @@ namespace ignition
       /// \brief Create the grid geometry in ogre
       private: void Create();
 
+      /// \brief Generate the line list of the grid and add it to the
+      /// common::MeshManager, so that grids with the same parameters share
+      /// the mesh
+      /// \param[in] _name Name of the mesh
+      private: void CreateMesh(const std::string &_name);
+
       /// \brief Grid should only be created by scene.
       private: friend class Ogre2Scene;
 
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2HEIGHTMAP_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2HEIGHTMAP_HH_
+
+#include <cstddef>
+#include <memory>
+
+#include "ignition/rendering/base/BaseHeightmap.hh"
+#include "ignition/rendering/ogre2/Ogre2Geometry.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderTypes.hh"
+#include "ignition/rendering/ogre2/Export.hh"
+
+namespace Ogre
+{
+  class MovableObject;
+}
+
+// Ignoring warning: "non dll-interface class
+// 'ignition::rendering::v5::Heightmap' used as base for dll-interface class"
+// because `Heightmap` and `BaseHeightmap` are header-only
+#ifdef _MSC_VER
+ #pragma warning(push)
+ #pragma warning(disable:4275)
+#endif
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // Forward declaration
+    class Ogre2HeightmapPrivate;
+
+    /// \brief Ogre2 implementation of a heightmap geometry. The heightmap is
+    /// split in a quadtree of tiles which all have the same number of
+    /// vertices, so tiles covering a larger area are less detailed. Every
+    /// frame, the tiles closest to the sensors of the scene are refined and
+    /// the ones further away are merged back, following the continuous
+    /// distance-dependent level of detail (CDLOD) scheme. The number of
+    /// tiles drawn and the number of tiles built per frame are bounded, so
+    /// the cost of a frame does not depend on the size of the heightmap.
+    /// Tiles are drawn with skirts to hide the cracks between levels.
+    /// With a HeightmapTileSource, the samples of a tile are read in the
+    /// background the first time it is needed, so heightmaps larger than
+    /// the memory can be drawn.
+    class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2Heightmap
+      : public BaseHeightmap<Ogre2Geometry>
+    {
+      /// \brief Constructor
+      /// \param[in] _desc Descriptor containing heightmap information.
+      protected: explicit Ogre2Heightmap(const HeightmapDescriptor &_desc);
+
+      /// \brief Destructor
+      public: virtual ~Ogre2Heightmap();
+
+      // Documentation inherited.
+      public: virtual void Init() override;
+
+      // Documentation inherited.
+      public: virtual void PreRender() override;
+
+      // Documentation inherited.
+      public: virtual void Destroy() override;
+
+      /// \brief Returns an empty ogre object giving the visibility and the
+      /// user data of the tiles. The tiles are attached to the parent
+      /// visual separately.
+      /// \return Ogre object of the heightmap
+      public: virtual Ogre::MovableObject *OgreObject() const override;
+
+      // Documentation inherited.
+      public: virtual MaterialPtr Material() const override;
+
+      // Documentation inherited.
+      public: virtual void SetMaterial(MaterialPtr _material, bool _unique)
+          override;
+
+      // Documentation inherited.
+      public: virtual void SetMaterialOverride(MaterialPtr _material)
+          override;
+
+      /// \brief Get the number of tiles drawn in the last frame
+      /// \return Number of tiles drawn
+      public: unsigned int VisibleTileCount() const;
+
+      /// \brief Get the number of tiles which geometry is built
+      /// \return Number of tiles built
+      public: unsigned int BuiltTileCount() const;
+
+      /// \brief Set the maximum memory used by the samples and the
+      /// geometry of the tiles. Over budget, the least recently used tiles
+      /// are destroyed, down to the tiles in use. Defaults to 256 MB.
+      /// \param[in] _bytes Memory budget in bytes
+      public: void SetMemoryBudget(size_t _bytes);
+
+      /// \brief Get the maximum memory used by the tiles
+      /// \return Memory budget in bytes
+      /// \sa SetMemoryBudget
+      public: size_t MemoryBudget() const;
+
+      /// \brief Get the memory used by the samples and the geometry of the
+      /// tiles
+      /// \return Memory used in bytes
+      public: size_t TileMemory() const;
+
+      // Documentation inherited.
+      protected: virtual void SetParent(Ogre2VisualPtr _parent) override;
+
+      /// \brief Heightmap should only be created by scene.
+      private: friend class Ogre2Scene;
+
+      /// \internal
+      /// \brief Pointer to private data
+      private: std::unique_ptr<Ogre2HeightmapPrivate> dataPtr;
+    };
+    }
+  }
+}
+
+#ifdef _MSC_VER
+ #pragma warning(pop)
+#endif
+
+#endif
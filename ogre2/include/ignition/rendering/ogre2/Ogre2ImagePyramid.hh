@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2IMAGEPYRAMID_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2IMAGEPYRAMID_HH_
+
+#include <cstddef>
+#include <memory>
+
+#include "ignition/rendering/RenderTypes.hh"
+#include "ignition/rendering/ogre2/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // forward declaration
+    class Ogre2ImagePyramidPrivate;
+
+    /// \brief Filter used to downsample the levels of an image pyramid
+    enum Ogre2PyramidFilter
+    {
+      /// \brief Average of the 2x2 pixels covered by each output pixel
+      OPF_BOX = 0,
+
+      /// \brief Separable [1 3 3 1] / 8 binomial kernel over the 4x4 pixels
+      /// around each output pixel
+      OPF_GAUSSIAN = 1
+    };
+
+    /* \class Ogre2ImagePyramid Ogre2ImagePyramid.hh \
+     * ignition/rendering/ogre2/Ogre2ImagePyramid.hh
+     */
+    /// \brief Downsamples the images rendered by an ogre2 camera into the
+    /// levels of an image pyramid on the GPU and reads all the levels back
+    /// as one buffer. Level 0 is half the size of the image and each level
+    /// is half the size of the previous one, rounded down. The levels are
+    /// drawn by quad passes from the previous level, then copied into one
+    /// texture on the GPU which is read back with a single transfer, so the
+    /// full resolution image is never read back.
+    class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2ImagePyramid
+    {
+      /// \brief Constructor
+      public: Ogre2ImagePyramid();
+
+      /// \brief Destructor
+      public: virtual ~Ogre2ImagePyramid();
+
+      /// \brief Set the camera whose images are downsampled
+      /// \param[in] _camera Ogre2 camera rendering to a texture
+      /// \param[in] _levelCount Number of levels, at least one. Levels that
+      /// would be smaller than one pixel are dropped.
+      /// \param[in] _filter Downsampling filter
+      /// \return True if the camera and the levels are valid
+      public: bool SetCamera(CameraPtr _camera, unsigned int _levelCount,
+                  Ogre2PyramidFilter _filter = OPF_BOX);
+
+      /// \brief Get the camera whose images are downsampled
+      /// \return The camera, null if none is set
+      public: CameraPtr Camera() const;
+
+      /// \brief Get the downsampling filter
+      /// \return The filter
+      public: Ogre2PyramidFilter Filter() const;
+
+      /// \brief Get the number of levels
+      /// \return Number of levels
+      public: unsigned int LevelCount() const;
+
+      /// \brief Get the width of a level
+      /// \param[in] _level Index of the level
+      /// \return Width in pixels, 0 if the level does not exist
+      public: unsigned int LevelWidth(unsigned int _level) const;
+
+      /// \brief Get the height of a level
+      /// \param[in] _level Index of the level
+      /// \return Height in pixels, 0 if the level does not exist
+      public: unsigned int LevelHeight(unsigned int _level) const;
+
+      /// \brief Get the offset of a level in the buffer Capture fills
+      /// \param[in] _level Index of the level
+      /// \return Offset in bytes, MemorySize() if the level does not exist
+      public: size_t LevelOffset(unsigned int _level) const;
+
+      /// \brief Get the size of the buffer Capture fills
+      /// \return Number of bytes of all the levels
+      public: size_t MemorySize() const;
+
+      /// \brief Downsample the last image rendered by the camera and copy
+      /// the levels into a buffer. The levels are stored one after the
+      /// other, from the largest one, with tightly packed rows in the
+      /// image format of the camera.
+      /// \param[out] _data Buffer of at least MemorySize() bytes
+      /// \return True if the levels were copied
+      public: bool Capture(void *_data);
+
+      /// \internal
+      /// \brief Pointer to private data
+      private: std::unique_ptr<Ogre2ImagePyramidPrivate> dataPtr;
+    };
+    }
+  }
+}
+#endif
@@ -59,6 +59,10 @@ namespace ignition
       public: virtual void SetPoints(
               const std::vector<double> &_points) override;
 
+      // Documentation inherited
+      public: virtual void SetPoints(const float *_data, unsigned int _count,
+              unsigned int _channels = 1u) override;
+
       // Documentation inherited
       public: virtual void ClearPoints() override;
 
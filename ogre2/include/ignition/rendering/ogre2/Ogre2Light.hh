@@ -102,6 +102,9 @@ namespace ignition
       // Documentation Inherited
       public: virtual void SetIntensity(double _intensity) override;
 
+      // Documentation Inherited
+      public: virtual void SetStatic(bool _static) override;
+
       /// \brief Get a pointer to ogre light
       public: virtual Ogre::Light *Light() const;
 
@@ -111,6 +114,19 @@ namespace ignition
       /// \brief Initialize the light
       protected: virtual void Init() override;
 
+      // Documentation inherited
+      protected: virtual void SetRawLocalPosition(
+                     const math::Vector3d &_position) override;
+
+      // Documentation inherited
+      protected: virtual void SetRawLocalRotation(
+                     const math::Quaterniond &_rotation) override;
+
+      /// \brief Mark the static shadow maps of the scene dirty if this light
+      /// is static and casts shadows. Called when the light changes in a way
+      /// that affects its shadow map.
+      protected: void SetStaticShadowsDirty();
+
       /// \brief Create the light
       private: void CreateLight();
 
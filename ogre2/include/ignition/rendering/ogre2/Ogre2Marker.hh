@@ -71,6 +71,10 @@ namespace ignition
       // Documentation inherited
       public: virtual void ClearPoints() override;
 
+      // Documentation inherited
+      public: virtual void SetPoints(const float *_xyz, size_t _count,
+                           const float *_rgba = nullptr) override;
+
       // Documentation inherited
       public: virtual void SetType(const MarkerType _markerType) override;
 
@@ -60,6 +60,14 @@ namespace ignition
       // Documentation inherited
       public: virtual void Destroy() override;
 
+      /// \brief Clone this material. The clone shares the datablock of this
+      /// material until either of them is modified, so that unique materials
+      /// assigned to many visuals do not each create a datablock.
+      /// \param[in] _name Name of the cloned material
+      /// \return The cloned material
+      public: virtual MaterialPtr Clone(const std::string &_name = "") const
+                  override;
+
       // Documentation inherited
       public: virtual math::Color Diffuse() const override;
 
@@ -204,10 +212,18 @@ namespace ignition
       /// \return Ogre material pointer
       public: virtual Ogre::MaterialPtr Material();
 
-      /// \brief Return ogre Hlms material pbs datablock
+      /// \brief Return ogre Hlms material pbs datablock. It may be shared
+      /// with the clones of this material, or with the material this one is
+      /// cloned from, and should be modified through the setters only.
       /// \return Ogre Hlms pbs datablock
       public: virtual Ogre::HlmsPbsDatablock *Datablock() const;
 
+      /// \brief Bind the datablock of this material to a renderable. The
+      /// renderable is rebound if this material stops sharing the datablock
+      /// of the material it was cloned from.
+      /// \param[in] _renderable Renderable to bind the datablock to
+      public: void BindDatablock(Ogre::Renderable *_renderable) const;
+
       /// \brief Return ogre Hlms material unlit datablock
       /// \return Ogre Hlms unlit datablock
       public: virtual Ogre::HlmsUnlitDatablock *UnlitDatablock();
@@ -255,6 +271,16 @@ namespace ignition
       // Documentation inherited.
       protected: virtual void Init() override;
 
+      /// \brief Share the datablock of the material this material is cloned
+      /// from and copy its properties
+      /// \param[in] _source Material this material is cloned from
+      private: void ShareDatablock(const Ogre2Material &_source);
+
+      /// \brief Give this material a datablock of its own if it shares one,
+      /// and the clones sharing its datablock theirs. Called before the
+      /// datablock is modified.
+      private: void MakeDatablockUnique();
+
       /// \brief  Ogre material. Mainly used for render targets.
       protected: Ogre::MaterialPtr ogreMaterial;
 
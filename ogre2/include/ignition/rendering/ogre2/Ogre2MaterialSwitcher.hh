@@ -18,8 +18,10 @@
 #ifndef IGNITION_RENDERING_OGRE2_OGRE2MATERIALSWITCHER_HH_
 #define IGNITION_RENDERING_OGRE2_OGRE2MATERIALSWITCHER_HH_
 
-#include <map>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <ignition/math/Color.hh>
 #include "ignition/rendering/config.hh"
@@ -59,7 +61,8 @@ namespace ignition
       public: std::string EntityName(
               const ignition::math::Color &_color) const;
 
-      /// \brief Reset the color value incrementor
+      /// \brief Reset the color value incrementor and forget all color
+      /// assignments. Colors are otherwise kept across renders.
       public: void Reset();
 
       /// \brief Ogre's pre render update callback
@@ -77,12 +80,41 @@ namespace ignition
       /// \brief Current unique color value
       private: ignition::math::Color currentColor;
 
-      /// \brief Color dictionary that maps the unique color value to
-      /// renderable name
-      private: std::map<unsigned int, std::string> colorDict;
-
-      /// \brief A map of ogre sub item pointer to their original hlms material
-      private: std::map<Ogre::SubItem *, Ogre::HlmsDatablock *> datablockMap;
+      /// \brief Item a unique color is assigned to
+      private: struct ColorEntry
+      {
+        /// \brief Name of the item
+        std::string name;
+
+        /// \brief Id of the visual the item belongs to, 0 if none
+        unsigned int visualId = 0u;
+      };
+
+      /// \brief Color assigned to an item
+      private: struct ItemColor
+      {
+        /// \brief Packed RGBA color value
+        unsigned int color = 0u;
+
+        /// \brief Last traversal of the scene the item was seen in
+        unsigned int traversal = 0u;
+      };
+
+      /// \brief Color dictionary that maps the unique packed RGBA color
+      /// value to the item it is assigned to
+      private: std::unordered_map<unsigned int, ColorEntry> colorDict;
+
+      /// \brief Color assigned to each item. Assignments are kept across
+      /// renders and updated as items are added and removed.
+      private: std::unordered_map<Ogre::Item *, ItemColor> itemColors;
+
+      /// \brief Number of scene traversals, used to find removed items
+      private: unsigned int traversal = 0u;
+
+      /// \brief Original hlms material of the sub items swapped for the
+      /// current render
+      private: std::vector<std::pair<Ogre::SubItem *, Ogre::HlmsDatablock *>>
+          datablocks;
 
       /// \brief Ogre v1 material consisting of a shader that changes the
       /// appearance of item to use a unique color for mouse picking
@@ -66,6 +66,17 @@ namespace ignition
       public: virtual void SetSkeletonLocalTransforms(
             const std::map<std::string, math::Matrix4d> &_tfs) override;
 
+      // Documentation inherited.
+      public: virtual std::vector<std::string> SkeletonBoneNames() const
+            override;
+
+      // Documentation inherited.
+      public: virtual unsigned int SkeletonBoneCount() const override;
+
+      // Documentation inherited.
+      public: virtual void SetSkeletonBoneTransforms(
+            const math::Matrix4f *_tfs, unsigned int _count) override;
+
       // Documentation inherited.
       public: virtual std::unordered_map<std::string, float>
                           SkeletonWeights() const override;
@@ -92,6 +103,17 @@ namespace ignition
       /// \brief Get a list of submeshes in this mesh
       protected: virtual SubMeshStorePtr SubMeshes() const override;
 
+      /// \brief Get the translation of the ogre item from the parent
+      /// visual. Centered submeshes share the geometry of the original
+      /// submesh and are centered by this offset instead.
+      /// \return Offset in the frame of the parent visual
+      protected: virtual math::Vector3d OgreObjectOffset() const override;
+
+      /// \brief Set the translation of the ogre item from the parent
+      /// visual. This must be set before the mesh is attached to a visual.
+      /// \param[in] _offset Offset in the frame of the parent visual
+      protected: void SetOgreObjectOffset(const math::Vector3d &_offset);
+
       /// \brief Store containing all the submeshes
       protected: Ogre2SubMeshStorePtr subMeshes;
 
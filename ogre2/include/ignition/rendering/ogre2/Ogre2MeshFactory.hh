@@ -17,11 +17,13 @@
 #ifndef IGNITION_RENDERING_OGRE2_OGRE2MESHFACTORY_HH_
 #define IGNITION_RENDERING_OGRE2_OGRE2MESHFACTORY_HH_
 
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "ignition/rendering/config.hh"
+#include "ignition/rendering/MeshBvh.hh"
 #include "ignition/rendering/MeshDescriptor.hh"
 #include "ignition/rendering/ogre2/Ogre2Mesh.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderTypes.hh"
@@ -57,10 +59,102 @@ namespace ignition
       /// mesh
       public: virtual Ogre2MeshPtr Create(const MeshDescriptor &_desc);
 
-      /// \brief Cleanup and clear all internal ogre v2 meshes created by this
-      /// factory
+      /// \brief Create a copy of a mesh of the scene. The copy is a new
+      /// item of the ogre mesh of the given mesh, so nothing is loaded
+      /// again, and its submeshes use the materials of the submeshes of the
+      /// given mesh without cloning them.
+      /// \param[in] _mesh Mesh to copy
+      /// \return The copy, null if the mesh has no ogre item
+      public: virtual Ogre2MeshPtr Clone(const Ogre2Mesh &_mesh);
+
+      /// \brief Start loading a mesh in the background. The CPU side
+      /// conversion of the mesh geometry runs in a worker thread. The next
+      /// Create call for the same descriptor, which must be made from the
+      /// render thread, then only needs to upload the prepared geometry to
+      /// ogre buffers. Calling Create before the returned future is ready
+      /// blocks until the geometry is prepared. Scenes loading the same
+      /// mesh share the preparation.
+      /// \param[in] _desc Mesh descriptor of the mesh to load
+      /// \return Future set to true once the geometry is prepared or if the
+      /// mesh is already loaded, false if the descriptor is invalid
+      public: std::shared_future<bool> LoadAsync(const MeshDescriptor &_desc);
+
+      /// \brief Release the ogre v2 meshes used by this factory. Meshes are
+      /// removed once no other scene uses them.
       public: virtual void Clear();
 
+      /// \brief Enable or disable the on-disk cache of converted meshes.
+      /// When enabled, meshes loaded from files are stored in the native
+      /// ogre mesh format under ~/.ignition/rendering/ogre2_mesh_cache, keyed
+      /// by a hash of the mesh file and the descriptor options, and are
+      /// loaded from there the next time the same mesh is created. Skinned
+      /// meshes are not cached. The cache is disabled by default.
+      /// \param[in] _enabled True to enable the cache
+      public: void SetCacheEnabled(bool _enabled);
+
+      /// \brief Get whether the on-disk cache of converted meshes is enabled
+      /// \return True if the cache is enabled
+      /// \sa SetCacheEnabled
+      public: bool CacheEnabled() const;
+
+      /// \brief Enable or disable sharing of mesh materials across copies
+      /// of the same mesh. By default each mesh created by this factory gets
+      /// its own copy of the submesh materials. When enabled, all copies of
+      /// a mesh use the same materials, and therefore the same Hlms
+      /// datablocks, so that ogre can merge the draws of identical mesh and
+      /// material pairs into instanced draws. Changing a submesh material
+      /// then affects all copies of the mesh. To keep materials assigned
+      /// later shared as well, set them with Visual::SetMaterial(_material,
+      /// false).
+      /// \param[in] _enabled True to share materials across mesh copies
+      public: void SetInstancingEnabled(bool _enabled);
+
+      /// \brief Get whether materials are shared across copies of a mesh
+      /// \return True if materials are shared
+      /// \sa SetInstancingEnabled
+      public: bool InstancingEnabled() const;
+
+      /// \brief Enable or disable the optimization of the geometry of
+      /// loaded meshes. When enabled, the vertices of meshes without a
+      /// skeleton or levels of detail are welded, their triangles are
+      /// reordered for the vertex cache, their vertices are reordered in
+      /// the order they are fetched and their normals are packed in 8 bit
+      /// instead of half floats before they are uploaded to the GPU. This
+      /// benefits meshes exported from CAD tools in particular. Optimized
+      /// meshes are cached separately from the others. Ogre meshes are
+      /// shared by scenes, so the setting of the first scene loading a mesh
+      /// applies. Optimization is disabled by default.
+      /// \param[in] _enabled True to optimize loaded meshes
+      /// \sa MeshOptimizer
+      public: void SetOptimizationEnabled(bool _enabled);
+
+      /// \brief Get whether the geometry of loaded meshes is optimized
+      /// \return True if meshes are optimized
+      /// \sa SetOptimizationEnabled
+      public: bool OptimizationEnabled() const;
+
+      /// \brief Enable or disable removing the ogre v1 meshes once they are
+      /// imported into v2 meshes. Skinned meshes and meshes with levels of
+      /// detail are loaded as v1 meshes first, which otherwise keep a second
+      /// copy of their geometry in system memory for as long as the v2 mesh
+      /// exists. The v1 meshes of skinned meshes are always kept for their
+      /// skeleton. Disabled by default.
+      /// \param[in] _enabled True to remove imported v1 meshes
+      public: void SetV1MeshReleaseEnabled(bool _enabled);
+
+      /// \brief Get whether imported v1 meshes are removed
+      /// \return True if imported v1 meshes are removed
+      /// \sa SetV1MeshReleaseEnabled
+      public: bool V1MeshReleaseEnabled() const;
+
+      /// \brief Get the bounding volume hierarchy of a common::Mesh, used for
+      /// ray intersection tests. The hierarchy is built the first time it is
+      /// requested by any scene, and shared by the scenes until they are all
+      /// cleared.
+      /// \param[in] _meshName Name of the mesh in the common::MeshManager
+      /// \return Bounding volume hierarchy, null if the mesh does not exist
+      public: std::shared_ptr<const MeshBvh> Bvh(const std::string &_meshName);
+
       /// \brief Get the ogre item based on the mesh descriptor
       /// \param[in] _desc Descriptor describing the target mesh
       protected: virtual Ogre::Item *OgreItem(
@@ -88,7 +182,22 @@ namespace ignition
       /// \param[in] _desc Mesh descriptor to be validated
       protected: virtual bool Validate(const MeshDescriptor &_desc);
 
-      /// \brief A list of ogre meshes created by this factory
+      /// \brief Record that the scene of this factory uses an ogre mesh.
+      /// Ogre meshes are shared by all the scenes of the engine, and are
+      /// only removed once every scene using them is cleared.
+      /// \param[in] _name Name of the ogre mesh
+      protected: void AddMeshUser(const std::string &_name);
+
+      /// \brief Get the materials of this scene for the submeshes of an
+      /// item. Submeshes of a mesh created by another scene get a copy of
+      /// their material created in this scene.
+      /// \param[in] _desc Loaded mesh descriptor of the item
+      /// \param[in] _item Ogre item of the mesh
+      /// \return Material names, one per subitem
+      protected: std::vector<std::string> SceneMaterialNames(
+          const MeshDescriptor &_desc, Ogre::Item *_item);
+
+      /// \brief A list of ogre meshes used by this factory
       protected: std::vector<std::string> ogreMeshes;
 
       /// \brief Pointer to the scene object
@@ -114,6 +223,16 @@ namespace ignition
       /// \return A store containing all the submeshes
       public: virtual Ogre2SubMeshStorePtr Create();
 
+      /// \brief Set whether the created submeshes use the materials of the
+      /// ogre submeshes directly instead of a copy of them
+      /// \param[in] _shared True to share materials
+      public: void SetMaterialsShared(bool _shared);
+
+      /// \brief Set the materials of the submeshes, used instead of the
+      /// materials of the ogre submeshes
+      /// \param[in] _names Material names, one per subitem
+      public: void SetMaterialNames(const std::vector<std::string> &_names);
+
       /// \brief Helper function to create submesh at the given index
       /// \param[in] _index Index of the ogre subitem. The subitem is then used
       /// to create the submesh.
@@ -22,6 +22,11 @@
 #include "ignition/rendering/base/BaseParticleEmitter.hh"
 #include "ignition/rendering/ogre2/Ogre2Visual.hh"
 
+namespace Ogre
+{
+  class AxisAlignedBox;
+}
+
 namespace ignition
 {
   namespace rendering
@@ -86,6 +91,70 @@ namespace ignition
       public: virtual void SetColorRangeImage(const std::string &_image)
           override;
 
+      /// \brief Get the bounding box of the particles in world frame. The
+      /// box is computed at most once per frame, so all the sensors that
+      /// render in the same frame share it.
+      /// \param[out] _box Axis aligned bounding box of the particles
+      /// \return True if there are particles and their bounding box is
+      /// finite
+      public: bool ParticleWorldBounds(Ogre::AxisAlignedBox &_box) const;
+
+      /// \brief Enable or disable sorting the particles by distance to the
+      /// camera. Sorting is needed for alpha blended particles to overlap
+      /// correctly, but it is done on the cpu every frame. It can be
+      /// disabled for particles that are additively blended or that look
+      /// the same in any order, e.g. thin smoke or fog. Enabled by default.
+      /// \param[in] _enabled True to sort the particles
+      public: void SetSortingEnabled(bool _enabled);
+
+      /// \brief Get whether the particles are sorted by distance to the
+      /// camera
+      /// \return True if the particles are sorted
+      public: bool SortingEnabled() const;
+
+      /// \brief Set the interval at which the particles are simulated. The
+      /// particle system is otherwise updated every time ogre renders a
+      /// frame, i.e. once per camera render, with cameras rendering at
+      /// different rates all adding to the cost. With an interval, the
+      /// particles are advanced in fixed steps of that length, so the cpu
+      /// cost of an emitter only depends on the interval.
+      /// \param[in] _interval Update interval in seconds, 0 to update the
+      /// particles every frame. Negative values are rejected.
+      public: void SetUpdateInterval(double _interval);
+
+      /// \brief Get the interval at which the particles are simulated
+      /// \return Update interval in seconds, 0 if the particles are updated
+      /// every frame
+      public: double UpdateInterval() const;
+
+      /// \internal
+      /// \brief Stop or resume simulating and drawing the particles. Called
+      /// by the scene when the emitter is outside the view of every sensor.
+      /// The particles of a culled emitter are frozen until it is resumed.
+      /// \param[in] _culled True to stop the particle system
+      public: void SetCulled(bool _culled);
+
+      /// \brief Get whether the emitter is culled
+      /// \return True if the particles are not simulated nor drawn
+      public: bool Culled() const;
+
+      /// \internal
+      /// \brief Scale the emission rate of the emitter. Called by the scene
+      /// to emit fewer particles from emitters far from every sensor. The
+      /// rate returned by Rate() is not affected.
+      /// \param[in] _scale Scale of the emission rate, between 0 and 1
+      public: void SetRateScale(double _scale);
+
+      /// \brief Get the scale of the emission rate
+      /// \return Scale of the emission rate, between 0 and 1
+      public: double RateScale() const;
+
+      /// \brief Get the radius of the sphere around the emitter that its
+      /// particles can reach, estimated from the emitter size, the particle
+      /// size and how far the particles travel during their lifetime.
+      /// \return Radius in meters
+      public: double ReachRadius() const;
+
       /// \brief Particle system visibility flags
       public: static const uint32_t kParticleVisibilityFlags;
 
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2POINTCLOUDVISUAL_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2POINTCLOUDVISUAL_HH_
+
+#include <memory>
+#include "ignition/rendering/base/BasePointCloudVisual.hh"
+#include "ignition/rendering/ogre2/Ogre2Visual.hh"
+#include "ignition/rendering/ogre2/Ogre2Scene.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // Forward declaration
+    class Ogre2PointCloudVisualPrivate;
+
+    /// \brief Ogre 2.x implementation of a point cloud visual. Each chunk
+    /// is an ogre item with its own vertex buffer and bounding box, so ogre
+    /// culls the chunks outside of the view frustum. The points of a chunk
+    /// are stored in bit reversed order, so that any prefix of the buffer
+    /// is spread over the whole chunk. The levels of detail of a chunk draw
+    /// shorter prefixes of the same buffer and are selected by the ogre LOD
+    /// strategy, per camera.
+    class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2PointCloudVisual
+      : public BasePointCloudVisual<Ogre2Visual>
+    {
+      /// \brief Constructor
+      protected: Ogre2PointCloudVisual();
+
+      /// \brief Destructor
+      public: virtual ~Ogre2PointCloudVisual();
+
+      // Documentation inherited.
+      public: virtual void Init() override;
+
+      // Documentation inherited.
+      public: virtual void Destroy() override;
+
+      // Documentation inherited
+      public: virtual void Update() override;
+
+      // Documentation inherited
+      public: virtual void SetVisible(bool _visible) override;
+
+      // Documentation inherited
+      public: virtual void SetMaterial(MaterialPtr _material,
+                  bool _unique = true) override;
+
+      /// \brief Upload a chunk, creating its ogre item if needed
+      /// \param[in] _index Index of the chunk
+      private: void UploadChunk(unsigned int _index);
+
+      /// \brief Destroy all the chunks
+      private: void DestroyChunks();
+
+      /// \brief Point cloud visuals should only be created by scene.
+      private: friend class Ogre2Scene;
+
+      /// \brief Private data class
+      private: std::unique_ptr<Ogre2PointCloudVisualPrivate> dataPtr;
+    };
+    }
+  }
+}
+#endif
@@ -18,6 +18,7 @@
 #define IGNITION_RENDERING_OGRE2_OGRE2RAYQUERY_HH_
 
 #include <memory>
+#include <vector>
 
 #include "ignition/rendering/base/BaseRayQuery.hh"
 #include "ignition/rendering/ogre2/Ogre2Object.hh"
@@ -51,6 +52,36 @@ namespace ignition
       // Documentation inherited
       public: virtual RayQueryResult ClosestPoint();
 
+      // Documentation inherited
+      public: virtual std::vector<RayQueryResult> ClosestPoints(
+                const std::vector<math::Vector3d> &_origins,
+                const std::vector<math::Vector3d> &_directions);
+
+      /// \brief Set whether rays set from a camera are answered from the
+      /// selection buffer of the camera's last frame. The visual is looked up
+      /// at the ray's pixel and only that visual is tested for the exact
+      /// intersection point. Queries fall back to testing the scene on the
+      /// CPU when the camera has moved since its last frame, when the ray was
+      /// changed after SetFromCamera, or when the ray misses the visual seen
+      /// at its pixel. Only selectable visuals are found through the
+      /// selection buffer. Enabling this makes the camera render its
+      /// selection buffer with each frame.
+      /// \param[in] _enabled True to use the selection buffer
+      /// \sa Ogre2Camera::SetSelectionFrameEnabled
+      public: void SetUseSelectionBuffer(bool _enabled);
+
+      /// \brief Get whether rays set from a camera are answered from the
+      /// camera's selection buffer
+      /// \return True if the selection buffer is used
+      public: bool UseSelectionBuffer() const;
+
+      /// \brief Compute the closest intersection of the ray from the
+      /// selection buffer of the camera it was set from
+      /// \param[out] _result Closest intersection
+      /// \return True if the result could be computed from the selection
+      /// buffer, false if the CPU path needs to be used
+      private: bool ClosestPointFromSelectionBuffer(RayQueryResult &_result);
+
       /// \brief Private data pointer
       private: std::unique_ptr<Ogre2RayQueryPrivate> dataPtr;
 
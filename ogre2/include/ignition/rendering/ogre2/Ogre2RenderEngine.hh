@@ -32,6 +32,7 @@
 
 namespace Ogre
 {
+  class CompositorWorkspace;
   class LogManager;
   class Root;
   namespace v1
@@ -90,10 +91,40 @@ namespace ignition
       // Documentation Inherited.
       public: virtual std::string Name() const override;
 
-      /// \brief Add path to resource in ogre2's resource manager
+      /// \brief Enable or disable the GPU timing of the sensor passes. The
+      /// passes are timed with GL timestamp queries, so timing is only
+      /// supported by the OpenGL 3+ render system.
+      /// \param[in] _enabled True to enable GPU timing
+      /// \return True if GPU timing is in the requested state
+      public: virtual bool SetGpuTimingEnabled(bool _enabled) override;
+
+      // Documentation inherited.
+      public: virtual bool GpuTimingEnabled() const override;
+
+      /// \brief Add path to resource in ogre2's resource manager. Paths that
+      /// have already been added are ignored. If a resource path batch is
+      /// active, the path is only registered with ogre when the batch ends.
       /// \param[in] _uri Resource path in the form of an uri
+      /// \sa BeginResourcePathBatch
       public: void AddResourcePath(const std::string &_uri) override;
 
+      /// \brief Begin collecting a batch of resource paths. Until
+      /// EndResourcePathBatch is called, AddResourcePath only queues the
+      /// paths, so the resource group is initialised once for the whole
+      /// batch instead of once per path. Resources in queued paths can not
+      /// be found by ogre before the batch ends.
+      public: void BeginResourcePathBatch();
+
+      /// \brief Register all resource paths queued since
+      /// BeginResourcePathBatch with ogre, initialise the resource group
+      /// once and parse the material scripts of the new locations.
+      public: void EndResourcePathBatch();
+
+      /// \brief Get whether a resource path batch is being collected
+      /// \return True if BeginResourcePathBatch has been called without a
+      /// matching EndResourcePathBatch
+      public: bool ResourcePathBatchActive() const;
+
       /// \brief Get the ogre2 root object
       /// \return ogre2 root object
       public: virtual Ogre::Root *OgreRoot() const;
@@ -121,7 +152,54 @@ namespace ignition
       /// \return list of scenes
       protected: virtual SceneStorePtr Scenes() const override;
 
-      // Documentation Inherited.
+      /// \brief Engine implementation of Load function.
+      /// \param[in] _params Parameters to be passed to the render engine.
+      /// Currently accepts the following parameters and values:
+      /// "useCurrentGLContext" : "1" or "0". Use current OpenGL context for
+      ///                                     rendering
+      /// "headless" : "1" or "0". Create the context on a GPU device with
+      ///              EGL instead of GLX, so no X server is needed. Falls
+      ///              back to GLX if it fails. EGL is also used when no X
+      ///              display can be opened. Requires EGL support at build
+      ///              time and an ogre GL3Plus render system able to use
+      ///              the current context.
+      /// "device" : Index of the GPU to render on, as enumerated by EGL.
+      ///            Implies "headless". Defaults to the first device that
+      ///            can be initialized. Used to pin each engine instance
+      ///            to its own GPU on multi-GPU nodes.
+      /// "shaderCachePath" : Directory of the shader microcode cache. The
+      ///                     shaders compiled by the Hlms are loaded from
+      ///                     it at startup and saved to it on shutdown.
+      ///                     The cache is disabled if empty or not set.
+      /// "textureStreaming" : "1" or "0". Decode texture files on worker
+      ///                      threads and bind placeholder textures until
+      ///                      they are uploaded. Disabled by default.
+      /// "textureUploadBudget" : Number of bytes of streamed textures
+      ///                         uploaded per frame. Defaults to 32 MiB.
+      /// "textureCompression" : "1" or "0". Compress diffuse textures to
+      ///                        BC1 or BC3 and cache the results in
+      ///                        ~/.ignition/rendering/ogre2_texture_cache.
+      ///                        DDS and KTX files are always loaded as is.
+      ///                        Disabled by default.
+      /// "environmentMapPrefiltering" : "1" or "0". Convolve cubemap
+      ///                                environment maps for reflections
+      ///                                of growing roughness and compute
+      ///                                their irradiance once, caching the
+      ///                                results in the same directory.
+      ///                                Compressed cubemaps are loaded as
+      ///                                is. Disabled by default.
+      /// "workerThreads" : Number of worker threads of the scene managers,
+      ///                   which update the scene graph and cull the
+      ///                   objects of each render pass, e.g. of each
+      ///                   cubemap face of a lidar. Defaults to the number
+      ///                   of logical cores.
+      /// "threadedCulling" : "1" or "0". Also cull instanced entities on
+      ///                     the worker threads. Disabled by default.
+      /// "minimalResources" : "1" or "0". Skip the plugins and media that
+      ///                      sensors do not use, i.e. the particle FX
+      ///                      plugin and the fonts, so that particle
+      ///                      emitters and text geometries can not be
+      ///                      created. Disabled by default.
       protected: virtual bool LoadImpl(
           const std::map<std::string, std::string> &_params) override;
 
@@ -156,6 +234,19 @@ namespace ignition
       /// \brief Create the resources needed by ogre
       private: void CreateResources();
 
+      /// \brief Add resource locations to ogre's "General" resource group,
+      /// initialise the group and parse the material scripts found in the
+      /// new locations
+      /// \param[in] _paths Absolute paths of the resource locations
+      private: void LoadResourcePaths(const std::vector<std::string> &_paths);
+
+      /// \brief Enable the shader microcode cache and load the shaders
+      /// cached by a previous run, if a cache path was given
+      private: void LoadShaderCache();
+
+      /// \brief Save the shader microcode cache if new shaders were compiled
+      private: void SaveShaderCache();
+
       /// \brief Attempt to initialize engine and catch exeption if they occur
       private: void InitAttempt();
 
@@ -163,11 +254,72 @@ namespace ignition
       /// \return a list of FSAA levels
       public: std::vector<unsigned int> FSAALevels() const;
 
+      /// \brief Get the number of worker threads the scene managers are
+      /// created with
+      /// \return Number of worker threads, at least 1
+      public: unsigned int WorkerThreadCount() const;
+
+      /// \brief Get whether instanced entities are culled on the worker
+      /// threads of the scene managers
+      /// \return True if threaded culling is enabled
+      public: bool ThreadedCulling() const;
+
+      /// \brief Get whether the engine was loaded with the minimal
+      /// resources, without particle emitters nor text geometries
+      /// \return True if the minimal resources are loaded
+      public: bool MinimalResources() const;
+
       /// \internal
       /// \brief Get a pointer to the Ogre overlay system.
       /// \return Pointer to the ogre overlay system.
       public: Ogre::v1::OverlaySystem *OverlaySystem() const;
 
+      /// \brief Begin collecting a render batch. Until EndRenderBatch is
+      /// called, ogre2 cameras and sensors that are updated only register
+      /// their compositor workspaces and defer their post-render step
+      /// instead of rendering a frame each. Camera images should be
+      /// copied after EndRenderBatch.
+      public: void BeginRenderBatch() override;
+
+      /// \brief Render all workspaces collected since BeginRenderBatch with
+      /// a single frame per stage, then run the deferred post-render steps
+      /// (e.g. readback and new frame events) in the order the objects were
+      /// updated.
+      public: void EndRenderBatch() override;
+
+      /// \brief Get whether a render batch is being collected
+      /// \return True if BeginRenderBatch has been called without a
+      /// matching EndRenderBatch
+      public: bool RenderBatchActive() const override;
+
+      /// \internal
+      /// \brief Add a compositor workspace to the current render batch.
+      /// Workspaces of a stage are rendered after all workspaces of the
+      /// previous stages, for sensors whose passes depend on each other.
+      /// \param[in] _owner Object owning the workspace. The workspace is
+      /// skipped if the owner is destroyed before the batch ends.
+      /// \param[in] _workspace Workspace to render
+      /// \param[in] _stage Stage to render the workspace in
+      public: void AddToRenderBatch(ObjectPtr _owner,
+          Ogre::CompositorWorkspace *_workspace, unsigned int _stage = 0u);
+
+      /// \internal
+      /// \brief Render compositor workspaces now. Unlike
+      /// Ogre::Root::renderOneFrame, only the scene graphs of the
+      /// workspaces and the workspaces themselves are updated: the frame
+      /// listeners still run, but the other enabled workspaces are not
+      /// rendered. Set the "manualWorkspaceUpdate" load parameter to false
+      /// to render a whole frame with the workspaces enabled instead.
+      /// \param[in] _workspaces Workspaces to render, in order
+      public: void RenderWorkspaces(
+          const std::vector<Ogre::CompositorWorkspace *> &_workspaces);
+
+      /// \internal
+      /// \brief Defer the PostRender call of an object to the end of the
+      /// current render batch
+      /// \param[in] _object Object to call PostRender on
+      public: void DeferPostRender(ObjectPtr _object);
+
       /// \brief Pointer to the ogre's overlay system
       private: Ogre::v1::OverlaySystem *ogreOverlaySystem = nullptr;
 
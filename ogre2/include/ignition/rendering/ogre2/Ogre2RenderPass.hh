@@ -24,6 +24,12 @@
 #include "ignition/rendering/ogre2/Export.hh"
 #include "ignition/rendering/ogre2/Ogre2Object.hh"
 
+namespace Ogre
+{
+  class Camera;
+  class Material;
+}
+
 namespace ignition
 {
   namespace rendering
@@ -49,6 +55,9 @@ namespace ignition
     /// the next RenderPass. Note that the Ogre2RenderPass class provides the
     /// node definition only and the actual node creation work is done in the
     /// Ogre2RenderTarget class when the whole workspace is constructed.
+    /// Consecutive passes that provide FusedShaderCode are drawn by a single
+    /// compositor node instead, which saves a full screen read and write of
+    /// the render texture per pass.
     class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2RenderPass :
       public BaseRenderPass<Ogre2Object>
     {
@@ -68,6 +77,58 @@ namespace ignition
       /// \brief Create the render pass using ogre compositor
       public: virtual void CreateRenderPass();
 
+      /// \brief Get the GLSL code applying this pass to a single pixel, for
+      /// passes which output pixels only depend on the same input pixel.
+      /// The code declares the uniforms of the pass and a function
+      /// `vec4 <_prefix>Apply(vec4 color, vec2 uv)` returning the color of
+      /// the pixel at uv after this pass. All of its global names must start
+      /// with _prefix so the code of several passes can be put in one
+      /// fragment shader.
+      /// \param[in] _prefix Prefix of the global names of the code
+      /// \return GLSL code, or an empty string if the pass must be drawn by
+      /// its own compositor node, the default.
+      public: virtual std::string FusedShaderCode(
+          const std::string &_prefix) const;
+
+      /// \internal
+      /// \brief Set the fused compositor node drawing this pass. This is
+      /// done by Ogre2RenderTarget when it builds the compositor chain.
+      /// \param[in] _nodeDefName Name of the fused node definition, empty if
+      /// the pass is drawn by its own node
+      /// \param[in] _material Material of the fused node
+      /// \param[in] _prefix Prefix given to FusedShaderCode
+      public: void SetFusedNode(const std::string &_nodeDefName,
+          Ogre::Material *_material, const std::string &_prefix);
+
+      /// \brief Get the name of the fused compositor node definition
+      /// drawing this pass
+      /// \return Name of the fused node definition, empty if the pass is
+      /// drawn by its own node
+      public: std::string FusedNodeDefinitionName() const;
+
+      /// \internal
+      /// \brief Set the camera rendering the images this pass is applied
+      /// to. This is done by the render target before it builds the
+      /// compositor chain.
+      /// \param[in] _camera Ogre camera
+      public: void SetOgreCamera(Ogre::Camera *_camera);
+
+      /// \brief Get the camera rendering the images this pass is applied to,
+      /// for passes that depend on its projection
+      /// \return Ogre camera, null if the pass is not used by a camera
+      protected: Ogre::Camera *OgreCamera() const;
+
+      /// \brief Get the material of the fused compositor node drawing this
+      /// pass. Passes set their uniforms on it, with the names prefixed by
+      /// FusedShaderPrefix(), instead of on their own material.
+      /// \return Fused material, null if the pass is drawn by its own node
+      protected: Ogre::Material *FusedMaterial() const;
+
+      /// \brief Get the prefix of the uniforms of this pass in the fused
+      /// material
+      /// \return Prefix given to FusedShaderCode
+      protected: std::string FusedShaderPrefix() const;
+
       /// \brief Name of the ogre compositor node definition
       protected: std::string ogreCompositorNodeDefName;
 
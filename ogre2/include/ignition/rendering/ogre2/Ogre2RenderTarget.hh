@@ -50,6 +50,7 @@ namespace ignition
     //
     // forward declaration
     class Ogre2RenderTargetPrivate;
+    class Ogre2FrameLimiter;
 
     /// \brief Ogre2.x implementation of the render target class
     class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2RenderTarget :
@@ -72,6 +73,16 @@ namespace ignition
       /// \param[in] _image Image to copy the data to
       public: virtual void Copy(Image &_image) const override;
 
+      /// \brief Copy a region of the render target buffer data to an
+      /// image. Only the pixels of the region are read back from the GPU.
+      /// \param[in] _image Image to copy the data to, of the size of the
+      /// region
+      /// \param[in] _x Column of the first pixel of the region
+      /// \param[in] _y Row of the first pixel of the region
+      /// \return True if the region was copied
+      public: bool CopyRegion(Image &_image, unsigned int _x,
+                  unsigned int _y) const;
+
       /// \brief Get a pointer to the internal ogre camera
       /// \return Pointer to ogre camera
       public: virtual Ogre::Camera *Camera() const;
@@ -115,6 +126,61 @@ namespace ignition
       /// \see Camera::SetShadowsNodeDefDirty
       public: void SetShadowsNodeDefDirty();
 
+      /// \brief Set whether the render target renders shadows
+      /// \param[in] _enabled True to render shadows
+      /// \sa Camera::SetShadowsEnabled
+      public: void SetShadowsEnabled(bool _enabled);
+
+      /// \brief Set the size of the shadow maps rendered for the render
+      /// target
+      /// \param[in] _size Size of shadow maps in pixels, 0 for the default
+      /// size
+      /// \sa Camera::SetShadowMapSize
+      public: void SetShadowMapSize(unsigned int _size);
+
+      /// \brief Set whether the scene is drawn at a scaled resolution,
+      /// then upscaled to the render target. The scene is drawn to a
+      /// region of an intermediate texture, upscaled before the render
+      /// passes. Rebuilds the compositor.
+      /// \param[in] _enabled True to enable the scaled resolution
+      /// \sa Camera::SetDynamicResolutionEnabled
+      public: void SetDynamicResolutionEnabled(bool _enabled);
+
+      /// \brief Get whether the scene is drawn at a scaled resolution
+      /// \return True if enabled
+      public: bool DynamicResolutionEnabled() const;
+
+      /// \brief Set the scale of the resolution the scene is drawn at, used
+      /// if dynamic resolution is enabled. Takes effect on the next render,
+      /// without rebuilding the compositor.
+      /// \param[in] _scale Scale relative to the size of the render target,
+      /// in (0, 1]
+      public: void SetResolutionScale(double _scale);
+
+      /// \brief Get the scale of the resolution the scene is drawn at
+      /// \return Scale relative to the size of the render target
+      public: double ResolutionScale() const;
+
+      /// \brief Set whether transparent materials are drawn with weighted
+      /// blended order independent transparency. The scene is drawn to an
+      /// intermediate texture with two more color attachments the
+      /// transparent materials accumulate into, then composited before the
+      /// render passes. Rebuilds the compositor.
+      /// \param[in] _enabled True to enable order independent transparency
+      /// \sa Camera::SetOrderIndependentTransparencyEnabled
+      public: void SetOrderIndependentTransparencyEnabled(bool _enabled);
+
+      /// \brief Get whether order independent transparency is enabled
+      /// \return True if enabled
+      public: bool OrderIndependentTransparencyEnabled() const;
+
+      /// \internal
+      /// \brief Set the GPU timer client the passes of the render target
+      /// are charged to, see Sensor::GpuTimes
+      /// \param[in] _client Id of the client of the sensor rendering to
+      /// the render target, 0 to not time the passes
+      public: void SetGpuTimerClient(unsigned int _client);
+
       /// \brief Get a pointer to the ogre render target containing
       /// the results of the render (implemented separately
       /// to avoid breaking ABI of the pure virtual function)
@@ -124,6 +190,11 @@ namespace ignition
       /// the results of the render
       public: virtual Ogre::RenderTarget *RenderTarget() const = 0;
 
+      /// \internal
+      /// \brief Get the texture containing the results of the render
+      /// \return Ogre texture, null for render windows
+      public: Ogre::Texture *OgreTexture() const;
+
       /// \brief Returns true if this is a render window
       /// TODO(anyone): this function should be virtual.
       /// We didn't do it to preserve ABI.
@@ -195,6 +266,21 @@ namespace ignition
       /// \brief Destroy the compositor
       protected: virtual void DestroyCompositor();
 
+      /// \brief Create the compositor workspace from its definition,
+      /// rendering to the current render textures
+      protected: void CreateWorkspace();
+
+      /// \brief Remove the compositor workspace, keeping its definition
+      protected: void RemoveWorkspace();
+
+      /// \brief Replace the render textures with textures of the current
+      /// size, format and anti-aliasing level, then recreate the compositor
+      /// workspace from the existing definitions. This is much cheaper than
+      /// rebuilding the target and its compositor.
+      /// \return False if the compositor definitions must be rebuilt, e.g.
+      /// they do not exist yet or the background changed
+      protected: bool ResizeTarget();
+
       /// \brief Re-initializes render target material to apply a material to
       /// everything in the scene. Does nothing if no material has been set
       /// \sa Ogre2RenderTarget::RebuildImpl()
@@ -325,15 +411,28 @@ namespace ignition
       // Documentation inherited.
       public: virtual Ogre::RenderTarget *RenderTarget() const override;
 
+      // Documentation inherited.
+      public: virtual void PostRender() override;
+
+      // Documentation inherited.
+      // OpenGL has no mailbox present mode, WPM_IMMEDIATE is used instead.
+      public: virtual void SetPresentMode(WindowPresentMode _mode) override;
+
       // Documentation inherited.
       protected: virtual void RebuildTarget() override;
 
       /// \brief Build the render window
       protected: virtual void BuildTarget();
 
+      /// \brief Turn vsync on or off according to the present mode
+      private: void ApplyPresentMode();
+
       /// \brief Pointer to the internal ogre render target object
       protected: Ogre::RenderTarget *ogreRenderWindow = nullptr;
 
+      /// \brief Limits the frames in flight
+      private: std::unique_ptr<Ogre2FrameLimiter> frameLimiter;
+
       /// \brief Make scene our friend so it can create a ogre2 render window
       private: friend class Ogre2Scene;
     };
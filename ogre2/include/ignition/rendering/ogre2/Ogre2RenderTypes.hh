@@ -38,6 +38,7 @@ namespace ignition
     class Ogre2GizmoVisual;
     class Ogre2GpuRays;
     class Ogre2Grid;
+    class Ogre2Heightmap;
     class Ogre2Light;
     class Ogre2LightVisual;
     class Ogre2LidarVisual;
@@ -48,7 +49,9 @@ namespace ignition
     class Ogre2Node;
     class Ogre2Object;
     class Ogre2ParticleEmitter;
+    class Ogre2PointCloudVisual;
     class Ogre2PointLight;
+    class Ogre2PoseArrayVisual;
     class Ogre2RayQuery;
     class Ogre2RenderEngine;
     class Ogre2RenderTarget;
@@ -56,11 +59,14 @@ namespace ignition
     class Ogre2RenderTexture;
     class Ogre2RenderWindow;
     class Ogre2Scene;
+    class Ogre2SegmentationCamera;
     class Ogre2Sensor;
     class Ogre2SpotLight;
     class Ogre2SubMesh;
+    class Ogre2Text;
     class Ogre2ThermalCamera;
     class Ogre2Visual;
+    class Ogre2WideAngleCamera;
     class Ogre2WireBox;
 
     typedef BaseGeometryStore<Ogre2Geometry>      Ogre2GeometryStore;
@@ -83,6 +89,7 @@ namespace ignition
     typedef shared_ptr<Ogre2GizmoVisual>          Ogre2GizmoVisualPtr;
     typedef shared_ptr<Ogre2GpuRays>              Ogre2GpuRaysPtr;
     typedef shared_ptr<Ogre2Grid>                 Ogre2GridPtr;
+    typedef shared_ptr<Ogre2Heightmap>            Ogre2HeightmapPtr;
     typedef shared_ptr<Ogre2Light>                Ogre2LightPtr;
     typedef shared_ptr<Ogre2LightVisual>          Ogre2LightVisualPtr;
     typedef shared_ptr<Ogre2LidarVisual>          Ogre2LidarVisualPtr;
@@ -93,18 +100,23 @@ namespace ignition
     typedef shared_ptr<Ogre2Node>                 Ogre2NodePtr;
     typedef shared_ptr<Ogre2Object>               Ogre2ObjectPtr;
     typedef shared_ptr<Ogre2ParticleEmitter>      Ogre2ParticleEmitterPtr;
+    typedef shared_ptr<Ogre2PointCloudVisual>     Ogre2PointCloudVisualPtr;
     typedef shared_ptr<Ogre2PointLight>           Ogre2PointLightPtr;
+    typedef shared_ptr<Ogre2PoseArrayVisual>      Ogre2PoseArrayVisualPtr;
     typedef shared_ptr<Ogre2RayQuery>             Ogre2RayQueryPtr;
     typedef shared_ptr<Ogre2RenderEngine>         Ogre2RenderEnginePtr;
     typedef shared_ptr<Ogre2RenderTarget>         Ogre2RenderTargetPtr;
     typedef shared_ptr<Ogre2RenderTexture>        Ogre2RenderTexturePtr;
     typedef shared_ptr<Ogre2RenderWindow>         Ogre2RenderWindowPtr;
     typedef shared_ptr<Ogre2Scene>                Ogre2ScenePtr;
+    typedef shared_ptr<Ogre2SegmentationCamera>   Ogre2SegmentationCameraPtr;
     typedef shared_ptr<Ogre2Sensor>               Ogre2SensorPtr;
     typedef shared_ptr<Ogre2SpotLight>            Ogre2SpotLightPtr;
     typedef shared_ptr<Ogre2SubMesh>              Ogre2SubMeshPtr;
+    typedef shared_ptr<Ogre2Text>                 Ogre2TextPtr;
     typedef shared_ptr<Ogre2ThermalCamera>        Ogre2ThermalCameraPtr;
     typedef shared_ptr<Ogre2Visual>               Ogre2VisualPtr;
+    typedef shared_ptr<Ogre2WideAngleCamera>      Ogre2WideAngleCameraPtr;
     typedef shared_ptr<Ogre2WireBox>              Ogre2WireBoxPtr;
 
     typedef shared_ptr<Ogre2GeometryStore>        Ogre2GeometryStorePtr;
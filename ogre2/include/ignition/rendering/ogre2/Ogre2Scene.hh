@@ -17,8 +17,11 @@
 #ifndef IGNITION_RENDERING_OGRE2_OGRE2SCENE_HH_
 #define IGNITION_RENDERING_OGRE2_OGRE2SCENE_HH_
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "ignition/rendering/Storage.hh"
 #include "ignition/rendering/base/BaseScene.hh"
@@ -39,6 +42,8 @@
 
 namespace Ogre
 {
+  class Camera;
+  class CompositorWorkspace;
   class Root;
   class SceneManager;
 }
@@ -82,9 +87,27 @@ namespace ignition
       // Documentation inherited
       public: virtual void PreRender() override;
 
+      // Documentation inherited
+      public: virtual void SetWorldPoses(const std::vector<unsigned int> &_ids,
+                  const std::vector<math::Pose3d> &_poses) override;
+
       // Documentation inherited
       public: virtual void Clear() override;
 
+      // Documentation inherited
+      public: virtual bool ClearStep(
+                  const std::chrono::steady_clock::duration &_budget) override;
+
+      /// \brief Get the memory used by the resources of the render engine.
+      /// The resource managers of ogre2 are shared by all scenes, so the
+      /// values are engine-wide.
+      /// \return Memory statistics
+      public: virtual MemoryStats ResourceMemoryStats() const override;
+
+      // Documentation inherited
+      public: virtual std::shared_future<bool> PrepareMesh(
+                  const MeshDescriptor &_desc) override;
+
       // Documentation inherited
       public: virtual void Destroy() override;
 
@@ -98,6 +121,166 @@ namespace ignition
       /// \return Pointer to the ogre scene manager
       public: virtual Ogre::SceneManager *OgreSceneManager() const;
 
+      /// \brief Get the mesh factory used to create meshes in this scene
+      /// \return Pointer to the mesh factory
+      public: Ogre2MeshFactoryPtr MeshFactory() const;
+
+      /// \brief Set the texture memory budget. Once the textures loaded by
+      /// materials exceed the budget, textures that are no longer used by
+      /// any material are released from video memory, least recently used
+      /// first. Textures are shared by all scenes of the render engine, so
+      /// the budget is too.
+      /// \param[in] _bytes Budget in bytes, 0 for no budget
+      public: void SetTextureMemoryBudget(size_t _bytes);
+
+      /// \brief Get the texture memory budget
+      /// \return Budget in bytes, 0 if there is no budget
+      /// \sa SetTextureMemoryBudget
+      public: size_t TextureMemoryBudget() const;
+
+      /// \brief Get the estimated video memory used by the textures loaded
+      /// by materials
+      /// \return Resident texture memory in bytes
+      public: size_t ResidentTextureMemory() const;
+
+      /// \brief Get the total size of the textures released from video
+      /// memory to stay within the texture memory budget
+      /// \return Evicted texture memory in bytes
+      public: size_t EvictedTextureMemory() const;
+
+      /// \brief Render a static reflection probe: the scene is rendered once
+      /// into a cubemap from the given position, which is then prefiltered
+      /// and loaded as an environment map that materials can use with
+      /// Material::SetEnvironmentMap. Unlike a dynamic cubemap, the probe is
+      /// only updated when this function is called again, after which the
+      /// materials using it need to set it again. The probe does not render
+      /// shadows or the sky.
+      /// \param[in] _name Name of the environment map
+      /// \param[in] _position Position of the probe in the world frame
+      /// \param[in] _size Width of the faces of the cubemap in pixels
+      /// \return True if the environment map was created
+      public: bool RenderReflectionProbe(const std::string &_name,
+          const math::Vector3d &_position, unsigned int _size = 256u);
+
+      /// \brief Set the ambient light from the irradiance of an environment
+      /// map, the upper and lower hemispheres getting the light reflected by
+      /// white surfaces facing up and down. Requires an environment map
+      /// prefiltered when it was loaded, see the
+      /// "environmentMapPrefiltering" render engine parameter, or rendered by
+      /// RenderReflectionProbe.
+      /// \param[in] _name Environment map texture or probe name
+      /// \return True if the ambient light was set
+      public: bool SetAmbientLightFromEnvironmentMap(const std::string &_name);
+
+      /// \brief Set the grid of clusters used to light the scene. The view
+      /// frustum of cameras is divided into _width x _height tiles in screen
+      /// space and into _slices depth slices, and each pixel is only shaded
+      /// by the lights that touch its cluster. Finer grids cost more memory
+      /// and culling time but reduce the number of lights per pixel.
+      /// The default grid is 16 x 8 x 24.
+      /// \param[in] _width Number of clusters along the screen width
+      /// \param[in] _height Number of clusters along the screen height
+      /// \param[in] _slices Number of clusters along the view depth
+      public: void SetLightClusterGrid(unsigned int _width,
+          unsigned int _height, unsigned int _slices);
+
+      /// \brief Get the grid of clusters used to light the scene
+      /// \param[out] _width Number of clusters along the screen width
+      /// \param[out] _height Number of clusters along the screen height
+      /// \param[out] _slices Number of clusters along the view depth
+      /// \sa SetLightClusterGrid
+      public: void LightClusterGrid(unsigned int &_width,
+          unsigned int &_height, unsigned int &_slices) const;
+
+      /// \brief Set the maximum number of lights affecting a cluster. Lights
+      /// beyond this number are ignored in the cluster. The default is 96.
+      /// \param[in] _lights Maximum number of lights per cluster
+      public: void SetLightsPerCluster(unsigned int _lights);
+
+      /// \brief Get the maximum number of lights affecting a cluster
+      /// \return Maximum number of lights per cluster
+      public: unsigned int LightsPerCluster() const;
+
+      /// \brief Set the range of view distances covered by the depth slices
+      /// of the cluster grid. Geometry beyond the maximum distance is lit
+      /// by the last slice. The default range is [1, 500] meters.
+      /// \param[in] _minDistance Distance of the first depth slice
+      /// \param[in] _maxDistance Distance of the last depth slice
+      public: void SetLightClusterRange(double _minDistance,
+          double _maxDistance);
+
+      /// \brief Get the distance of the first depth slice of the cluster
+      /// grid
+      /// \return Minimum distance in meters
+      /// \sa SetLightClusterRange
+      public: double LightClusterMinDistance() const;
+
+      /// \brief Get the distance of the last depth slice of the cluster grid
+      /// \return Maximum distance in meters
+      /// \sa SetLightClusterRange
+      public: double LightClusterMaxDistance() const;
+
+      /// \brief Set the distance beyond which particle emitters are culled.
+      /// A culled emitter is neither simulated nor drawn, and its particles
+      /// are frozen until it is resumed. Emitters are culled when they are
+      /// farther than this distance from every sensor rendered in the last
+      /// second of scene time, or outside the view of all of them. The
+      /// decision is made in PreRender, from the sensors rendered since the
+      /// previous frames. Emitters stay as they are until a sensor has been
+      /// rendered. The default is 0, which disables culling.
+      /// \param[in] _distance Cull distance in meters, 0 to disable culling
+      public: void SetParticleCullDistance(double _distance);
+
+      /// \brief Get the distance beyond which particle emitters are culled
+      /// \return Cull distance in meters, 0 if culling is disabled
+      /// \sa SetParticleCullDistance
+      public: double ParticleCullDistance() const;
+
+      /// \brief Set the distance beyond which particle emitters emit fewer
+      /// particles. Beyond this distance from the nearest sensor, the
+      /// emission rate drops with the square of the distance, i.e. it
+      /// follows the size of the emitter on screen. The default is 0, which
+      /// keeps the emission rate of all emitters.
+      /// \param[in] _distance Distance in meters, 0 to disable
+      public: void SetParticleLodDistance(double _distance);
+
+      /// \brief Get the distance beyond which particle emitters emit fewer
+      /// particles
+      /// \return Distance in meters, 0 if disabled
+      /// \sa SetParticleLodDistance
+      public: double ParticleLodDistance() const;
+
+      /// \brief Enable hierarchical-Z occlusion culling. Each depth camera
+      /// keeps a depth pyramid of its previous frame, built from the depth
+      /// data it reads back, and skips the items whose bounding box is
+      /// farther than the occluders covering it in that pyramid. Items are
+      /// only skipped for the camera that found them occluded, they are
+      /// drawn as usual by the other sensors. Since the previous frame is
+      /// used, an item uncovered by a moving occluder may appear one frame
+      /// late. Depth cameras that do not read their data back to the CPU
+      /// do not cull. The default is false.
+      /// \param[in] _enabled True to enable occlusion culling
+      /// \sa SetOcclusionCullingMargin
+      public: void SetOcclusionCulling(bool _enabled);
+
+      /// \brief Get whether hierarchical-Z occlusion culling is enabled
+      /// \return True if occlusion culling is enabled
+      /// \sa SetOcclusionCulling
+      public: bool OcclusionCulling() const;
+
+      /// \brief Set the conservative margin of occlusion culling. An item
+      /// is only culled if its nearest point is farther than the farthest
+      /// occluder covering it plus this margin, which accounts for the
+      /// motion of the camera and of the occluders since the previous
+      /// frame, and for the noise of the depth data. The default is 0.1.
+      /// \param[in] _margin Margin in meters, at least 0
+      public: void SetOcclusionCullingMargin(double _margin);
+
+      /// \brief Get the conservative margin of occlusion culling
+      /// \return Margin in meters
+      /// \sa SetOcclusionCullingMargin
+      public: double OcclusionCullingMargin() const;
+
       /// \cond PRIVATE
       /// \internal
       /// \brief Mark shadows dirty to rebuild compostior shadow node
@@ -111,6 +294,92 @@ namespace ignition
       /// \return True if the number of shadow casting lights changed
       /// \sa ShadowsDirty
       public: bool ShadowsDirty() const;
+
+      /// \internal
+      /// \brief Get the name of the compositor shadow node definition that
+      /// matches the shadow casting lights as of the last PreRender, creating
+      /// it if needed. Definitions are cached per number of directional and
+      /// spot / point lights casting shadows and per shadow map size.
+      /// \param[in] _shadowMapSize Size of shadow maps in pixels, 0 for the
+      /// default size
+      /// \return Name of shadow node definition
+      public: std::string ShadowNodeName(unsigned int _shadowMapSize = 0u);
+
+      /// \internal
+      /// \brief Set the shadow node of the scene passes of a compositor node
+      /// definition target. Workspaces instantiated from the node definition
+      /// need to recreate their nodes for the change to take effect.
+      /// \param[in] _nodeDefName Name of compositor node definition
+      /// \param[in] _targetName Name of the target whose scene passes
+      /// render shadows
+      /// \param[in] _shadowNodeName Name of the shadow node definition, empty
+      /// to render without shadows
+      /// \sa ShadowNodeName
+      public: void ApplyShadowNode(const std::string &_nodeDefName,
+          const std::string &_targetName, const std::string &_shadowNodeName);
+
+      /// \internal
+      /// \brief Mark the shadow maps of static lights dirty. Called when a
+      /// static light or visual changes, the shadow maps are then rendered
+      /// again on the next frame.
+      /// \sa Light::SetStatic, Visual::SetStatic
+      public: void SetStaticShadowsDirty();
+
+      /// \internal
+      /// \brief Fix the static lights to their shadow maps in the shadow
+      /// node of a compositor workspace and render them again if they are
+      /// out of date. Called before the workspace is rendered.
+      /// \param[in] _workspace Compositor workspace
+      /// \param[in] _shadowNodeName Name of the shadow node definition used
+      /// by the workspace, empty if it renders without shadows
+      /// \param[in,out] _version Version of the static shadow maps last
+      /// rendered by the workspace, 0 if the workspace has just been created
+      public: void UpdateStaticShadows(Ogre::CompositorWorkspace *_workspace,
+          const std::string &_shadowNodeName, uint64_t &_version);
+
+      /// \internal
+      /// \brief Register a particle emitter with the scene. Called by the
+      /// particle emitter when its particle system is created.
+      /// \param[in] _emitter Particle emitter to register
+      /// \sa ParticleEmitters
+      public: void AddParticleEmitter(Ogre2ParticleEmitter *_emitter);
+
+      /// \internal
+      /// \brief Unregister a particle emitter from the scene. Called by the
+      /// particle emitter when its particle system is destroyed.
+      /// \param[in] _emitter Particle emitter to unregister
+      public: void RemoveParticleEmitter(Ogre2ParticleEmitter *_emitter);
+
+      /// \internal
+      /// \brief Get all particle emitters that have a particle system. Used
+      /// by sensors to find the particles in their view without searching
+      /// the ogre scene.
+      /// \return Registered particle emitters
+      public: const std::vector<Ogre2ParticleEmitter *> &ParticleEmitters()
+          const;
+
+      /// \internal
+      /// \brief Record the view of a sensor camera about to be rendered. The
+      /// views recorded are used to cull particle emitters and scale their
+      /// emission rate.
+      /// \param[in] _camera Ogre camera of the sensor
+      /// \sa SetParticleCullDistance SetParticleLodDistance
+      public: void AddParticleViewer(const Ogre::Camera *_camera);
+
+      /// \internal
+      /// \brief Get a visual of this scene by id as an ogre2 visual. The
+      /// visual is looked up in the typed store of the scene, so per-frame
+      /// code does not need a dynamic cast.
+      /// \param[in] _id Id of the visual
+      /// \return The visual, null if no visual has the id
+      public: Ogre2VisualPtr OgreVisualById(unsigned int _id) const;
+
+      /// \internal
+      /// \brief Get a visual, light or sensor of this scene by id as an
+      /// ogre2 node, looked up in the typed stores of the scene
+      /// \param[in] _id Id of the node
+      /// \return The node, null if no node has the id
+      public: Ogre2NodePtr OgreNodeById(unsigned int _id) const;
       /// \endcond
 
       // Documentation inherited
@@ -119,6 +388,9 @@ namespace ignition
       // Documentation inherited
       protected: virtual bool InitImpl() override;
 
+      // Documentation inherited
+      protected: virtual bool VisualBoundsTracked() const override;
+
       // Documentation inherited
       protected: virtual LightVisualPtr CreateLightVisualImpl(unsigned int _id,
                      const std::string &_name) override;
@@ -151,6 +423,14 @@ namespace ignition
       protected: virtual GpuRaysPtr CreateGpuRaysImpl(unsigned int _id,
                      const std::string &_name) override;
 
+      // Documentation inherited
+      protected: virtual WideAngleCameraPtr CreateWideAngleCameraImpl(
+                     unsigned int _id, const std::string &_name) override;
+
+      // Documentation inherited
+      protected: virtual SegmentationCameraPtr CreateSegmentationCameraImpl(
+                     unsigned int _id, const std::string &_name) override;
+
       // Documentation inherited
       protected: virtual VisualPtr CreateVisualImpl(unsigned int _id,
                      const std::string &_name) override;
@@ -163,6 +443,10 @@ namespace ignition
       protected: virtual AxisVisualPtr CreateAxisVisualImpl(unsigned int _id,
                      const std::string &_name) override;
 
+      // Documentation inherited
+      protected: virtual PoseArrayVisualPtr CreatePoseArrayVisualImpl(
+                     unsigned int _id, const std::string &_name) override;
+
       // Documentation inherited
       protected: virtual GizmoVisualPtr CreateGizmoVisualImpl(unsigned int _id,
                      const std::string &_name) override;
@@ -199,6 +483,10 @@ namespace ignition
                      const std::string &_name, const MeshDescriptor &_desc)
                      override;
 
+      // Documentation inherited
+      protected: virtual MeshPtr CloneMeshImpl(unsigned int _id,
+                     const std::string &_name, const Mesh &_mesh) override;
+
       // Documentation inherited
       protected: virtual CapsulePtr CreateCapsuleImpl(unsigned int _id,
                      const std::string &_name) override;
@@ -219,6 +507,10 @@ namespace ignition
       protected: virtual LidarVisualPtr CreateLidarVisualImpl(unsigned int _id,
                      const std::string &_name) override;
 
+      // Documentation inherited
+      protected: virtual PointCloudVisualPtr CreatePointCloudVisualImpl(
+                     unsigned int _id, const std::string &_name) override;
+
       // Documentation inherited
       protected: virtual WireBoxPtr CreateWireBoxImpl(unsigned int _id,
                      const std::string &_name) override;
@@ -256,6 +548,13 @@ namespace ignition
       /// textures as the number of shadow casting lights
       protected: void UpdateShadowNode();
 
+      /// \brief Create the compositor shadow node definition of the current
+      /// shadow casting lights for a shadow map size, unless it already
+      /// exists
+      /// \param[in] _shadowMapSize Size of shadow maps in pixels
+      /// \return Name of shadow node definition
+      private: std::string CreateShadowNode(unsigned int _shadowMapSize);
+
       /// \brief Create ogre compositor shadow node definition. The function
       /// takes a vector of parameters that describe the type, number, and
       /// resolution of textures create. Note that it is not necessary to
@@ -292,6 +591,13 @@ namespace ignition
       /// \brief Create the root visual in the scene
       private: void CreateRootVisual();
 
+      /// \brief Apply the light cluster settings to the ogre scene manager
+      private: void UpdateLightClusters();
+
+      /// \brief Cull the particle emitters and scale their emission rate
+      /// based on the views recorded by AddParticleViewer
+      private: void UpdateParticleCulling();
+
       /// \brief Create the mesh factory used to generate ogre meshes
       private: void CreateMeshFactory();
 
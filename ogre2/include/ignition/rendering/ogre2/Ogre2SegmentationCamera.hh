@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2SEGMENTATIONCAMERA_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2SEGMENTATIONCAMERA_HH_
+
+#ifdef _WIN32
+  // Ensure that Winsock2.h is included before Windows.h, which can get
+  // pulled in by anybody (e.g., Boost).
+  #include <Winsock2.h>
+#endif
+
+#include <memory>
+#include <string>
+
+#include "ignition/rendering/base/BaseSegmentationCamera.hh"
+#include "ignition/rendering/ogre2/Export.hh"
+#include "ignition/rendering/ogre2/Ogre2Sensor.hh"
+
+#include "ignition/common/Event.hh"
+
+namespace Ogre
+{
+  class Camera;
+}
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // Forward declaration
+    class Ogre2SegmentationCameraPrivate;
+
+    /// \brief Ogre2 implementation of a segmentation camera. Like the
+    /// selection buffer, every item is switched to a flat color for the
+    /// render, here an unlit datablock encoding its label. The datablocks
+    /// are kept across renders, one per label, so a frame is a single
+    /// unlit scene pass without lights or shadows followed by one readback.
+    class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2SegmentationCamera :
+      public BaseSegmentationCamera<Ogre2Sensor>
+    {
+      /// \brief Constructor
+      protected: Ogre2SegmentationCamera();
+
+      /// \brief Destructor
+      public: virtual ~Ogre2SegmentationCamera();
+
+      // Documentation inherited
+      public: virtual void Init() override;
+
+      // Documentation inherited
+      public: virtual void Destroy() override;
+
+      // Documentation inherited
+      public: virtual void PreRender() override;
+
+      // Documentation inherited
+      public: virtual void PostRender() override;
+
+      // Documentation inherited
+      public: virtual void Render() override;
+
+      // Documentation inherited
+      public: virtual common::ConnectionPtr ConnectNewSegmentationFrame(
+          std::function<void(const uint32_t *, unsigned int, unsigned int,
+          unsigned int, const std::string &)> _subscriber) override;
+
+      // Documentation inherited
+      public: virtual common::ConnectionPtr ConnectNewRawSegmentationFrame(
+          std::function<void(const unsigned char *, unsigned int,
+          unsigned int, unsigned int, const std::string &)> _subscriber)
+          override;
+
+      /// \brief Enable or disable asynchronous readback of the labels.
+      /// When enabled, the GPU to CPU copy of a frame overlaps with the
+      /// rendering of the next one and the new segmentation frame events
+      /// are emitted one frame late. Blocking readback is used if the
+      /// render system does not support it.
+      /// \param[in] _enabled True to enable asynchronous readback
+      public: void SetAsyncReadback(bool _enabled);
+
+      /// \brief Get whether asynchronous readback is enabled
+      /// \return True if asynchronous readback is enabled
+      public: bool AsyncReadback() const;
+
+      /// \brief Get a pointer to the render target.
+      /// \return Pointer to the render target
+      protected: virtual RenderTargetPtr RenderTarget() const override;
+
+      /// \brief Create the camera.
+      protected: void CreateCamera();
+
+      /// \brief Create dummy render texture. Needed to satisfy inheritance
+      protected: virtual void CreateRenderTexture();
+
+      /// \brief Create the label texture and the compositor workspace
+      protected: virtual void CreateSegmentationTexture();
+
+      /// \brief Pointer to the ogre camera
+      protected: Ogre::Camera *ogreCamera = nullptr;
+
+      /// \internal
+      /// \brief Pointer to private data.
+      private: std::unique_ptr<Ogre2SegmentationCameraPrivate> dataPtr;
+
+      private: friend class Ogre2Scene;
+    };
+    }
+  }
+}
+#endif
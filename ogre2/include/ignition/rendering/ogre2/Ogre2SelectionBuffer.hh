@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "ignition/rendering/config.hh"
 #include "ignition/rendering/ogre2/Export.hh"
@@ -62,6 +63,19 @@ namespace ignition
       /// \return Returns the Ogre item at the coordinate.
       public: Ogre::Item *OnSelectionClick(const int _x, const int _y);
 
+      /// \brief Get all visuals seen in a rectangular region of the camera
+      /// image. The selection buffer is rendered once for the region, at one
+      /// pixel per image pixel.
+      /// \param[in] _x X coordinate of the top left corner in pixels.
+      /// \param[in] _y Y coordinate of the top left corner in pixels.
+      /// \param[in] _width Width of the region in pixels.
+      /// \param[in] _height Height of the region in pixels.
+      /// \return Ids of the unique visuals in the region, in no particular
+      /// order. Parts of the region outside the image are ignored.
+      public: std::vector<unsigned int> OnSelectionRegion(const int _x,
+          const int _y, const unsigned int _width,
+          const unsigned int _height);
+
       /// \brief Debug show overlay
       /// \param[in] _show True to show the selection buffer in an overlay.
       // public: void ShowOverlay(const bool _show);
@@ -69,6 +83,34 @@ namespace ignition
       /// \brief Call this to update the selection buffer contents
       public: void Update();
 
+      /// \brief Render the selection buffer for the whole viewport of the
+      /// camera and keep the result, so that pixels can be looked up with
+      /// FrameVisualIdAt without rendering again. Does nothing if the camera
+      /// has not been rendered yet, or if neither the camera view nor the
+      /// items of the scene changed since the last frame.
+      public: void UpdateFrame();
+
+      /// \brief Check if the frame rendered by the last call to UpdateFrame
+      /// still matches the pose, projection and viewport size of the camera
+      /// \return True if the frame can be used for lookups
+      public: bool FrameValid() const;
+
+      /// \brief Get the id of the visual seen at a pixel of the last frame
+      /// rendered by UpdateFrame
+      /// \param[in] _x X coordinate in pixels.
+      /// \param[in] _y Y coordinate in pixels.
+      /// \return Id of the visual, 0 if there is none or if no valid frame
+      /// exists
+      public: unsigned int FrameVisualIdAt(const int _x, const int _y) const;
+
+      /// \brief Get the width of the last frame rendered by UpdateFrame
+      /// \return Width in pixels, 0 if no frame was rendered
+      public: unsigned int FrameWidth() const;
+
+      /// \brief Get the height of the last frame rendered by UpdateFrame
+      /// \return Height in pixels, 0 if no frame was rendered
+      public: unsigned int FrameHeight() const;
+
       /// \brief Delete the render texture
       private: void DeleteRTTBuffer();
 
@@ -17,6 +17,10 @@
 #ifndef IGNITION_RENDERING_OGRE2_OGRE2SENSOR_HH_
 #define IGNITION_RENDERING_OGRE2_OGRE2SENSOR_HH_
 
+#include <cstdint>
+#include <map>
+#include <string>
+
 #include "ignition/rendering/base/BaseSensor.hh"
 #include "ignition/rendering/ogre2/Ogre2Node.hh"
 
@@ -35,6 +39,28 @@ namespace ignition
 
       /// \brief Destructor
       public: virtual ~Ogre2Sensor();
+
+      // Documentation inherited.
+      public: virtual std::map<std::string, double> GpuTimes() const
+                  override;
+
+      // Documentation inherited.
+      public: virtual rendering::FrameStats LastFrameStats() const
+                  override;
+
+      /// \brief End the frame whose statistics are reported by
+      /// LastFrameStats and begin a new one. Called by the sensors when
+      /// they begin rendering.
+      protected: void BeginFrameStats();
+
+      /// \brief Add bytes read back to CPU memory to the statistics of the
+      /// current frame
+      /// \param[in] _bytes Number of bytes read back
+      protected: void AddReadbackBytes(uint64_t _bytes) const;
+
+      /// \brief Id of the GPU timer client the passes of the sensor are
+      /// charged to, also identifying the sensor in Ogre2RenderStats
+      protected: unsigned int gpuTimerClient = 0u;
     };
     }
   }
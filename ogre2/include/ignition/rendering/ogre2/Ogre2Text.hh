@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2TEXT_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2TEXT_HH_
+
+#include <memory>
+
+#include <ignition/math/AxisAlignedBox.hh>
+
+#include "ignition/rendering/base/BaseText.hh"
+#include "ignition/rendering/ogre2/Ogre2Geometry.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderTypes.hh"
+#include "ignition/rendering/ogre2/Export.hh"
+
+namespace Ogre
+{
+  class MovableObject;
+}
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // Forward declaration
+    class Ogre2TextPrivate;
+
+    /// \brief Ogre2 implementation of text geometry. The glyphs of all the
+    /// texts of a scene that share a font are drawn together, from the
+    /// texture atlas of the font, with a single ogre item. The geometry
+    /// itself is an empty ogre object that only gives the position and the
+    /// visibility of the text. The glyphs of a text are laid out again only
+    /// when its properties change.
+    class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2Text
+        : public BaseText<Ogre2Geometry>
+    {
+      /// \brief Constructor
+      protected: Ogre2Text();
+
+      /// \brief Destructor
+      public: virtual ~Ogre2Text();
+
+      // Documentation inherited
+      public: virtual void Init() override;
+
+      // Documentation inherited
+      public: virtual void PreRender() override;
+
+      // Documentation inherited
+      public: virtual void Destroy() override;
+
+      // Documentation inherited
+      public: virtual Ogre::MovableObject *OgreObject() const override;
+
+      // Documentation inherited.
+      public: virtual MaterialPtr Material() const override;
+
+      // Documentation inherited.
+      public: virtual void SetMaterial(MaterialPtr _material, bool _unique)
+          override;
+
+      // Documentation inherited.
+      public: virtual ignition::math::AxisAlignedBox AABB() const override;
+
+      /// \brief Set material to text geometry.
+      /// \param[in] _material Ogre material.
+      protected: virtual void SetMaterialImpl(Ogre2MaterialPtr _material);
+
+      /// \brief Lay out the glyphs of the text and hand them to the batch of
+      /// its font
+      private: void UpdateGlyphs();
+
+      /// \brief Text should only be created by scene.
+      private: friend class Ogre2Scene;
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<Ogre2TextPrivate> dataPtr;
+    };
+    }
+  }
+}
+#endif
@@ -80,9 +80,28 @@ namespace ignition
           std::function<void(const uint16_t *, unsigned int, unsigned int,
           unsigned int, const std::string &)>  _subscriber) override;
 
+      // Documentation inherited
+      public: virtual ignition::common::ConnectionPtr
+          ConnectNewRawThermalFrame(
+          std::function<void(const unsigned char *, unsigned int,
+          unsigned int, unsigned int, const std::string &)>  _subscriber)
+          override;
+
       /// \brief Implementation of the render call
       public: virtual void Render() override;
 
+      /// \brief Enable or disable asynchronous readback of the thermal data.
+      /// When enabled, the GPU to CPU copy of a frame overlaps with the
+      /// rendering of the next one and the new thermal frame event is
+      /// emitted one frame late. Blocking readback is used if the render
+      /// system does not support it.
+      /// \param[in] _enabled True to enable asynchronous readback
+      public: void SetAsyncReadback(bool _enabled);
+
+      /// \brief Get whether asynchronous readback is enabled
+      /// \return True if asynchronous readback is enabled
+      public: bool AsyncReadback() const;
+
       /// \brief Get a pointer to the render target.
       /// \return Pointer to the render target
       protected: virtual RenderTargetPtr RenderTarget() const override;
@@ -49,6 +49,15 @@ namespace ignition
       // Documentation inherited.
       public: virtual void SetVisibilityFlags(uint32_t _flags) override;
 
+      // Documentation inherited.
+      public: virtual void SetStatic(bool _static) override;
+
+      // Documentation inherited.
+      public: virtual void Destroy() override;
+
+      // Documentation inherited.
+      public: virtual void SetInheritScale(bool _inherit) override;
+
       // Documentation inherited.
       public: virtual ignition::math::AxisAlignedBox BoundingBox()
                   const override;
@@ -57,6 +66,14 @@ namespace ignition
       public: virtual ignition::math::AxisAlignedBox LocalBoundingBox()
                   const override;
 
+      /// \brief Mark the cached bounding boxes of this visual, of its
+      /// descendants and of its ancestors dirty, so they are computed again
+      /// when queried. The bounding boxes are cached until the pose, the
+      /// scale, the visibility or the geometries of one of the visuals
+      /// involved change. Geometries whose bounds change on their own, e.g.
+      /// dynamic renderables, call this on the visual they are attached to.
+      public: void SetBoundsDirty();
+
       /// \brief Recursively loop through this visual's children
       /// to obtain the bounding box.
       /// \param[in,out] _box The bounding box.
@@ -87,6 +104,53 @@ namespace ignition
       /// \brief Initialize the visual
       protected: virtual void Init() override;
 
+      // Documentation inherited
+      protected: virtual void SetRawLocalPosition(
+                     const math::Vector3d &_position) override;
+
+      // Documentation inherited
+      protected: virtual void SetRawLocalRotation(
+                     const math::Quaterniond &_rotation) override;
+
+      // Documentation inherited
+      protected: virtual void SetLocalScaleImpl(
+                     const math::Vector3d &_scale) override;
+
+      // Documentation inherited
+      protected: virtual bool AttachChild(NodePtr _child) override;
+
+      // Documentation inherited
+      protected: virtual bool DetachChild(NodePtr _child) override;
+
+      /// \brief Mark the cached bounding boxes of this visual and of its
+      /// descendants dirty
+      /// \param[in] _local True to also mark the local bounding boxes
+      /// dirty, false if only the world frame of the subtree changed
+      private: void SetSubtreeBoundsDirty(bool _local);
+
+      /// \brief Mark the cached bounding boxes of the ancestors of this
+      /// visual dirty
+      private: void SetAncestorBoundsDirty();
+
+      /// \brief Mark the cached world bounding box of this visual dirty,
+      /// and report it to the spatial index of the scene
+      private: void SetWorldBoundsDirty();
+
+      /// \brief Mark the cached bounding boxes affected by a change of the
+      /// pose of this visual dirty
+      private: void SetPoseBoundsDirty();
+
+      /// \brief Mark the static shadow maps of the scene dirty if this
+      /// visual is static. Called when the visual changes in a way that
+      /// affects the shadows it casts.
+      private: void SetStaticShadowsDirty();
+
+      /// \brief Flag the ogre scene node of this visual dirty if the visual
+      /// is static, so that the scene manager updates its transform and the
+      /// bounds of its objects. Called when the visual moves or its objects
+      /// change.
+      private: void SetStaticNodeDirty();
+
       /// \brief Get a shared pointer to this.
       /// \return Shared pointer to this
       private: Ogre2VisualPtr SharedThis();
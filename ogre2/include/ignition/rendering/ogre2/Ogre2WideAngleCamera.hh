@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2WIDEANGLECAMERA_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2WIDEANGLECAMERA_HH_
+
+#ifdef _WIN32
+  // Ensure that Winsock2.h is included before Windows.h, which can get
+  // pulled in by anybody (e.g., Boost).
+  #include <Winsock2.h>
+#endif
+
+#include <memory>
+#include <string>
+
+#include "ignition/rendering/base/BaseWideAngleCamera.hh"
+#include "ignition/rendering/ogre2/Export.hh"
+#include "ignition/rendering/ogre2/Ogre2Sensor.hh"
+
+#include "ignition/common/Event.hh"
+
+namespace Ogre
+{
+  class Camera;
+}
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // Forward declaration
+    class Ogre2WideAngleCameraPrivate;
+
+    /// \brief Ogre2 implementation of a wide angle camera. The cubemap
+    /// faces seen by the image are rendered by the scene passes of a single
+    /// compositor workspace, each with its own camera, followed by a quad
+    /// pass resampling them with the mapping function of the lens, like
+    /// the 2nd pass of Ogre2GpuRays. A frame is rendered in one
+    /// renderOneFrame call and read back once.
+    class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2WideAngleCamera :
+      public BaseWideAngleCamera<Ogre2Sensor>
+    {
+      /// \brief Constructor
+      protected: Ogre2WideAngleCamera();
+
+      /// \brief Destructor
+      public: virtual ~Ogre2WideAngleCamera();
+
+      // Documentation inherited
+      public: virtual void Init() override;
+
+      // Documentation inherited
+      public: virtual void Destroy() override;
+
+      // Documentation inherited
+      public: virtual void PreRender() override;
+
+      // Documentation inherited
+      public: virtual void PostRender() override;
+
+      // Documentation inherited
+      public: virtual void Render() override;
+
+      // Documentation inherited
+      public: virtual void Copy(Image &_image) const override;
+
+      // Documentation inherited
+      public: virtual common::ConnectionPtr ConnectNewWideAngleFrame(
+          std::function<void(const unsigned char *, unsigned int,
+          unsigned int, unsigned int, const std::string &)> _subscriber)
+          override;
+
+      /// \brief Enable or disable asynchronous readback of the images.
+      /// When enabled, the GPU to CPU copy of a frame overlaps with the
+      /// rendering of the next one and the new wide angle frame event is
+      /// emitted one frame late. Blocking readback is used if the render
+      /// system does not support it.
+      /// \param[in] _enabled True to enable asynchronous readback
+      public: void SetAsyncReadback(bool _enabled);
+
+      /// \brief Get whether asynchronous readback is enabled
+      /// \return True if asynchronous readback is enabled
+      public: bool AsyncReadback() const;
+
+      /// \brief Get a pointer to the render target.
+      /// \return Pointer to the render target
+      protected: virtual RenderTargetPtr RenderTarget() const override;
+
+      /// \brief Create the camera.
+      protected: void CreateCamera();
+
+      /// \brief Create dummy render texture. Needed to satisfy inheritance
+      protected: virtual void CreateRenderTexture();
+
+      /// \brief Create the sample texture, the cubemap cameras and the
+      /// compositor workspace
+      protected: virtual void CreateWideAngleTexture();
+
+      /// \brief Pointer to the ogre camera
+      protected: Ogre::Camera *ogreCamera = nullptr;
+
+      /// \internal
+      /// \brief Pointer to private data.
+      private: std::unique_ptr<Ogre2WideAngleCameraPrivate> dataPtr;
+
+      private: friend class Ogre2Scene;
+    };
+    }
+  }
+}
+#endif
@@ -19,6 +19,7 @@
 #define IGNITION_RENDERING_OGRE2_OGRE2WIREBOX_HH_
 
 #include <memory>
+#include <string>
 #include "ignition/rendering/base/BaseWireBox.hh"
 #include "ignition/rendering/ogre2/Ogre2Geometry.hh"
 
@@ -49,6 +50,9 @@ namespace ignition
       // Documentation inherited.
       public: virtual void Init() override;
 
+      // Documentation inherited.
+      public: virtual void Destroy() override;
+
       // Documentation inherited.
       public: virtual Ogre::MovableObject *OgreObject() const override;
 
@@ -69,6 +73,12 @@ namespace ignition
       /// \brief Create the wire box geometry in ogre2
       private: void Create();
 
+      /// \brief Generate the line list of the wire box and add it to the
+      /// common::MeshManager, so that wire boxes with the same box share the
+      /// mesh
+      /// \param[in] _name Name of the mesh
+      private: void CreateMesh(const std::string &_name);
+
       /// \brief Wire Box should only be created by scene.
       private: friend class Ogre2Scene;
 
@@ -17,11 +17,15 @@
 
 #include "ignition/rendering/ogre2/Ogre2Camera.hh"
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderTarget.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
 #include "ignition/rendering/ogre2/Ogre2SelectionBuffer.hh"
+#include "ignition/rendering/Profiler.hh"
 #include "ignition/rendering/Utils.hh"
 
+#include "Ogre2TextBatch.hh"
+
 #ifdef _MSC_VER
   #pragma warning(push, 0)
 #endif
@@ -35,6 +39,8 @@
 /// \brief Private data for the Ogre2Camera class
 class ignition::rendering::Ogre2CameraPrivate
 {
+  /// \brief True to render the selection buffer with each frame
+  public: bool selectionFrameEnabled = false;
 };
 
 using namespace ignition;
@@ -139,7 +145,45 @@ void Ogre2Camera::SetMaterial(const MaterialPtr &_material)
 //////////////////////////////////////////////////
 void Ogre2Camera::Render()
 {
+  IGN_RENDERING_PROFILE("Ogre2Camera::Render");
+  this->BeginFrameStats();
+  // face the text labels towards the camera
+  Ogre2TextBatch::UpdateAll(this->scene->OgreSceneManager(),
+      this->ogreCamera);
+  this->scene->AddParticleViewer(this->ogreCamera);
+
+  if (this->dynamicResolution)
+  {
+    double gpuTime = 0.0;
+    for (const auto &time : this->GpuTimes())
+      gpuTime += time.second;
+    this->renderTexture->SetResolutionScale(
+        this->UpdateResolutionScale(gpuTime));
+  }
+
   this->renderTexture->Render();
+
+  if (this->dataPtr->selectionFrameEnabled)
+  {
+    if (!this->selectionBuffer)
+      this->SetSelectionBuffer();
+    this->selectionBuffer->UpdateFrame();
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2Camera::PostRender()
+{
+  // the frame is recorded and encoded once the render batch has been
+  // rendered, otherwise the previous frame would be captured
+  auto engine = Ogre2RenderEngine::Instance();
+  if (engine->RenderBatchActive())
+  {
+    engine->DeferPostRender(this->shared_from_this());
+    return;
+  }
+
+  BaseCamera::PostRender();
 }
 
 //////////////////////////////////////////////////
@@ -190,6 +234,12 @@ void Ogre2Camera::CreateRenderTexture()
   this->renderTexture->SetHeight(this->ImageHeight());
   this->renderTexture->SetBackgroundColor(this->scene->BackgroundColor());
   this->renderTexture->SetVisibilityMask(this->visibilityMask);
+  this->renderTexture->SetShadowsEnabled(this->shadowsEnabled);
+  this->renderTexture->SetShadowMapSize(this->shadowMapSize);
+  this->renderTexture->SetDynamicResolutionEnabled(this->dynamicResolution);
+  this->renderTexture->SetOrderIndependentTransparencyEnabled(
+      this->orderIndependentTransparency);
+  this->renderTexture->SetGpuTimerClient(this->gpuTimerClient);
 }
 
 //////////////////////////////////////////////////
@@ -207,6 +257,19 @@ unsigned int Ogre2Camera::RenderTextureGLId() const
   return rt->GLId();
 }
 
+//////////////////////////////////////////////////
+bool Ogre2Camera::CopyRegion(Image &_image, unsigned int _x,
+    unsigned int _y) const
+{
+  IGN_RENDERING_PROFILE("Ogre2Camera::CopyRegion");
+  Ogre2RenderTargetPtr rt =
+      std::dynamic_pointer_cast<Ogre2RenderTarget>(this->renderTexture);
+  if (!rt)
+    return BaseCamera::CopyRegion(_image, _x, _y);
+
+  return rt->CopyRegion(_image, _x, _y);
+}
+
 //////////////////////////////////////////////////
 void Ogre2Camera::SetShadowsNodeDefDirty()
 {
@@ -226,6 +289,18 @@ void Ogre2Camera::SetSelectionBuffer()
   this->selectionBuffer = new Ogre2SelectionBuffer(this->name, this->scene);
 }
 
+//////////////////////////////////////////////////
+void Ogre2Camera::SetSelectionFrameEnabled(bool _enabled)
+{
+  this->dataPtr->selectionFrameEnabled = _enabled;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Camera::SelectionFrameEnabled() const
+{
+  return this->dataPtr->selectionFrameEnabled;
+}
+
 //////////////////////////////////////////////////
 VisualPtr Ogre2Camera::VisualAt(const ignition::math::Vector2i &_mousePos)
 {
@@ -246,6 +321,18 @@ VisualPtr Ogre2Camera::VisualAt(const ignition::math::Vector2i &_mousePos)
       static_cast<int>(std::rint(ratio * _mousePos.X())),
       static_cast<int>(std::rint(ratio * _mousePos.Y())));
 
+  // look up the frame rendered with the camera's last frame if it matches
+  // the current view
+  if (this->dataPtr->selectionFrameEnabled &&
+      this->selectionBuffer->FrameValid())
+  {
+    unsigned int id = this->selectionBuffer->FrameVisualIdAt(
+        mousePos.X(), mousePos.Y());
+    if (id != 0u)
+      result = this->scene->VisualById(id);
+    return result;
+  }
+
   Ogre::Item *ogreItem = this->selectionBuffer->OnSelectionClick(
       mousePos.X(), mousePos.Y());
 
@@ -270,11 +357,65 @@ VisualPtr Ogre2Camera::VisualAt(const ignition::math::Vector2i &_mousePos)
   return result;
 }
 
+//////////////////////////////////////////////////
+std::vector<VisualPtr> Ogre2Camera::VisualsInRegion(
+    const ignition::math::Vector2i &_min, const ignition::math::Vector2i &_max)
+{
+  std::vector<VisualPtr> result;
+
+  if (!this->selectionBuffer)
+  {
+    this->SetSelectionBuffer();
+
+    if (!this->selectionBuffer)
+    {
+      return result;
+    }
+  }
+
+  float ratio = screenScalingFactor();
+  int x1 = static_cast<int>(std::rint(ratio * _min.X()));
+  int y1 = static_cast<int>(std::rint(ratio * _min.Y()));
+  int x2 = static_cast<int>(std::rint(ratio * _max.X()));
+  int y2 = static_cast<int>(std::rint(ratio * _max.Y()));
+  if (x2 <= x1 || y2 <= y1)
+    return result;
+
+  std::vector<unsigned int> ids = this->selectionBuffer->OnSelectionRegion(
+      x1, y1, static_cast<unsigned int>(x2 - x1),
+      static_cast<unsigned int>(y2 - y1));
+
+  result.reserve(ids.size());
+  for (auto id : ids)
+  {
+    VisualPtr visual = this->scene->VisualById(id);
+    if (visual)
+      result.push_back(visual);
+  }
+
+  return result;
+}
+
 //////////////////////////////////////////////////
 RenderWindowPtr Ogre2Camera::CreateRenderWindow()
 {
-  // TODO(anyone)
-  return RenderWindowPtr();
+  RenderWindowPtr base = this->scene->CreateRenderWindow();
+  Ogre2RenderWindowPtr renderWindow =
+      std::dynamic_pointer_cast<Ogre2RenderWindow>(base);
+  if (!renderWindow)
+    return RenderWindowPtr();
+  renderWindow->SetWidth(this->ImageWidth());
+  renderWindow->SetHeight(this->ImageHeight());
+  renderWindow->SetDevicePixelRatio(1);
+  renderWindow->SetCamera(this->ogreCamera);
+  renderWindow->SetBackgroundColor(this->scene->BackgroundColor());
+  renderWindow->SetVisibilityMask(this->visibilityMask);
+  renderWindow->SetShadowsEnabled(this->shadowsEnabled);
+  renderWindow->SetShadowMapSize(this->shadowMapSize);
+  renderWindow->SetGpuTimerClient(this->gpuTimerClient);
+
+  this->renderTexture = renderWindow;
+  return base;
 }
 
 //////////////////////////////////////////////////
@@ -296,6 +437,68 @@ void Ogre2Camera::SetNearClipPlane(const double _near)
   this->ogreCamera->setNearClipDistance(_near);
 }
 
+//////////////////////////////////////////////////
+void Ogre2Camera::SetLodBias(double _bias)
+{
+  BaseCamera::SetLodBias(_bias);
+  this->ogreCamera->setLodBias(this->RenderLodBias());
+}
+
+//////////////////////////////////////////////////
+void Ogre2Camera::SetImpostorsEnabled(bool _enabled)
+{
+  BaseCamera::SetImpostorsEnabled(_enabled);
+  this->ogreCamera->setLodBias(this->RenderLodBias());
+}
+
+//////////////////////////////////////////////////
+void Ogre2Camera::SetShadowsEnabled(bool _enabled)
+{
+  BaseCamera::SetShadowsEnabled(_enabled);
+  if (this->renderTexture)
+    this->renderTexture->SetShadowsEnabled(this->shadowsEnabled);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Camera::SetShadowMapSize(unsigned int _size)
+{
+  BaseCamera::SetShadowMapSize(_size);
+  if (this->renderTexture)
+    this->renderTexture->SetShadowMapSize(this->shadowMapSize);
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Camera::SetDynamicResolutionEnabled(bool _enabled)
+{
+  // the resolution follows the GPU time of the frames
+  if (_enabled && !this->scene->Engine()->GpuTimingEnabled() &&
+      !this->scene->Engine()->SetGpuTimingEnabled(true))
+  {
+    ignwarn << "Dynamic resolution of camera '" << this->Name()
+            << "' requires GPU timing" << std::endl;
+    return false;
+  }
+
+  this->dynamicResolution = _enabled;
+  this->resolutionScale = _enabled ? this->maxResolutionScale : 1.0;
+  this->resolutionScaleHold = 0u;
+  if (this->renderTexture)
+  {
+    this->renderTexture->SetDynamicResolutionEnabled(_enabled);
+    this->renderTexture->SetResolutionScale(this->resolutionScale);
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Camera::SetOrderIndependentTransparencyEnabled(bool _enabled)
+{
+  this->orderIndependentTransparency = _enabled;
+  if (this->renderTexture)
+    this->renderTexture->SetOrderIndependentTransparencyEnabled(_enabled);
+  return true;
+}
+
 //////////////////////////////////////////////////
 void Ogre2Camera::SetFarClipPlane(const double _far)
 {
@@ -0,0 +1,297 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/PixelFormat.hh"
+#include "ignition/rendering/ogre2/Ogre2Camera.hh"
+#include "ignition/rendering/ogre2/Ogre2CameraBatch.hh"
+#include "ignition/rendering/ogre2/Ogre2Conversions.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderTarget.hh"
+#include "ignition/rendering/ogre2/Ogre2Scene.hh"
+
+#include "Ogre2ReadbackManager.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreHardwarePixelBuffer.h>
+#include <OgreRenderSystem.h>
+#include <OgreRenderTexture.h>
+#include <OgreRoot.h>
+#include <OgreTextureManager.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+/// \brief Private data for the Ogre2CameraBatch class
+class ignition::rendering::Ogre2CameraBatchPrivate
+{
+  /// \brief Create the textures holding the tiles, once the format of the
+  /// render textures of the cameras is known
+  /// \param[in] _format Format of the render textures
+  public: void BuildPages(Ogre::PixelFormat _format);
+
+  /// \brief Destroy the textures holding the tiles
+  public: void DestroyPages();
+
+  /// \brief Cameras of the batch, in the order they were added
+  public: std::vector<Ogre2CameraPtr> cameras;
+
+  /// \brief Width of the images of the cameras
+  public: unsigned int width = 0u;
+
+  /// \brief Height of the images of the cameras
+  public: unsigned int height = 0u;
+
+  /// \brief Format of the images of the cameras
+  public: PixelFormat format = PF_UNKNOWN;
+
+  /// \brief Textures holding the tiles, each tile is the image of a camera
+  /// and the tiles of a texture are stacked vertically, so that reading a
+  /// texture back gives consecutive images
+  public: std::vector<Ogre::Texture *> pages;
+
+  /// \brief Number of tiles of each texture but the last one
+  public: unsigned int tilesPerPage = 0u;
+
+  /// \brief Format of the textures holding the tiles
+  public: Ogre::PixelFormat pageFormat = Ogre::PF_UNKNOWN;
+
+  /// \brief Number of cameras the textures holding the tiles were created
+  /// for
+  public: size_t pageCameraCount = 0u;
+
+  /// \brief Prefix of the names of the textures holding the tiles
+  public: std::string name;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+void Ogre2CameraBatchPrivate::BuildPages(Ogre::PixelFormat _format)
+{
+  if (!this->pages.empty() && this->pageCameraCount == this->cameras.size()
+      && this->pageFormat == _format)
+  {
+    return;
+  }
+  this->DestroyPages();
+
+  // stack as many tiles as the largest texture allows
+  unsigned int maxHeight = 4096u;
+  Ogre::RenderSystem *renderSystem =
+      Ogre2RenderEngine::Instance()->OgreRoot()->getRenderSystem();
+  if (renderSystem && renderSystem->getCapabilities())
+  {
+    maxHeight = std::max(maxHeight, static_cast<unsigned int>(
+        renderSystem->getCapabilities()->getMaximumResolution2D()));
+  }
+  this->tilesPerPage = std::max(1u, maxHeight / this->height);
+  unsigned int pageCount = (static_cast<unsigned int>(this->cameras.size()) +
+      this->tilesPerPage - 1u) / this->tilesPerPage;
+
+  Ogre::TextureManager &manager = Ogre::TextureManager::getSingleton();
+  unsigned int remaining = static_cast<unsigned int>(this->cameras.size());
+  for (unsigned int i = 0u; i < pageCount; ++i)
+  {
+    unsigned int tiles = std::min(remaining, this->tilesPerPage);
+    remaining -= tiles;
+    this->pages.push_back(manager.createManual(
+        this->name + "_page(" + std::to_string(i) + ")", "General",
+        Ogre::TEX_TYPE_2D, this->width, tiles * this->height, 0, _format,
+        Ogre::TU_RENDERTARGET).get());
+  }
+  this->pageFormat = _format;
+  this->pageCameraCount = this->cameras.size();
+}
+
+//////////////////////////////////////////////////
+void Ogre2CameraBatchPrivate::DestroyPages()
+{
+  // the engine may already be shut down
+  Ogre::TextureManager *manager = Ogre::TextureManager::getSingletonPtr();
+  for (auto page : this->pages)
+  {
+    if (manager)
+      manager->remove(page->getName());
+  }
+  this->pages.clear();
+}
+
+//////////////////////////////////////////////////
+Ogre2CameraBatch::Ogre2CameraBatch()
+  : dataPtr(new Ogre2CameraBatchPrivate)
+{
+  static unsigned int batchId = 0u;
+  this->dataPtr->name = "Ogre2CameraBatch(" + std::to_string(batchId++) + ")";
+}
+
+//////////////////////////////////////////////////
+Ogre2CameraBatch::~Ogre2CameraBatch()
+{
+  this->dataPtr->DestroyPages();
+}
+
+//////////////////////////////////////////////////
+bool Ogre2CameraBatch::AddCamera(CameraPtr _camera)
+{
+  Ogre2CameraPtr camera = std::dynamic_pointer_cast<Ogre2Camera>(_camera);
+  if (!camera)
+  {
+    ignerr << "Only ogre2 cameras can be added to the batch" << std::endl;
+    return false;
+  }
+
+  if (this->dataPtr->cameras.empty())
+  {
+    this->dataPtr->width = camera->ImageWidth();
+    this->dataPtr->height = camera->ImageHeight();
+    this->dataPtr->format = camera->ImageFormat();
+    if (this->dataPtr->width == 0u || this->dataPtr->height == 0u ||
+        PixelUtil::BytesPerPixel(this->dataPtr->format) == 0u)
+    {
+      ignerr << "Invalid image size or format of camera ["
+             << camera->Name() << "]" << std::endl;
+      return false;
+    }
+  }
+  else if (camera->ImageWidth() != this->dataPtr->width ||
+      camera->ImageHeight() != this->dataPtr->height ||
+      camera->ImageFormat() != this->dataPtr->format)
+  {
+    ignerr << "Camera [" << camera->Name() << "] does not have the image "
+           << "size and format of the batch" << std::endl;
+    return false;
+  }
+
+  this->dataPtr->cameras.push_back(camera);
+  return true;
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2CameraBatch::CameraCount() const
+{
+  return static_cast<unsigned int>(this->dataPtr->cameras.size());
+}
+
+//////////////////////////////////////////////////
+CameraPtr Ogre2CameraBatch::CameraByIndex(unsigned int _index) const
+{
+  if (_index >= this->dataPtr->cameras.size())
+    return CameraPtr();
+  return this->dataPtr->cameras[_index];
+}
+
+//////////////////////////////////////////////////
+void Ogre2CameraBatch::Clear()
+{
+  this->dataPtr->cameras.clear();
+  this->dataPtr->DestroyPages();
+}
+
+//////////////////////////////////////////////////
+size_t Ogre2CameraBatch::MemorySize() const
+{
+  return this->dataPtr->cameras.size() * PixelUtil::MemorySize(
+      this->dataPtr->format, this->dataPtr->width, this->dataPtr->height);
+}
+
+//////////////////////////////////////////////////
+bool Ogre2CameraBatch::Capture(void *_data)
+{
+  if (!_data || this->dataPtr->cameras.empty())
+    return false;
+
+  auto engine = Ogre2RenderEngine::Instance();
+  if (engine->RenderBatchActive())
+  {
+    ignerr << "Cannot capture a camera batch inside a render batch"
+           << std::endl;
+    return false;
+  }
+
+  // update each scene once, however many cameras it has
+  std::set<ScenePtr> scenes;
+  for (auto &camera : this->dataPtr->cameras)
+  {
+    if (scenes.insert(camera->Scene()).second)
+      camera->Scene()->PreRender();
+  }
+
+  engine->BeginRenderBatch();
+  for (auto &camera : this->dataPtr->cameras)
+    camera->Render();
+  engine->EndRenderBatch();
+
+  for (auto &camera : this->dataPtr->cameras)
+    camera->PostRender();
+
+  Ogre::Texture *first =
+      this->dataPtr->cameras.front()->renderTexture->OgreTexture();
+  if (!first)
+  {
+    ignerr << "Camera batch only supports cameras rendering to textures"
+           << std::endl;
+    return false;
+  }
+  this->dataPtr->BuildPages(first->getFormat());
+
+  // copy each image into its tile on the GPU
+  unsigned int width = this->dataPtr->width;
+  unsigned int height = this->dataPtr->height;
+  Ogre::Box srcBox(0, 0, width, height);
+  for (size_t i = 0u; i < this->dataPtr->cameras.size(); ++i)
+  {
+    Ogre::Texture *texture =
+        this->dataPtr->cameras[i]->renderTexture->OgreTexture();
+    if (!texture)
+      return false;
+
+    size_t tilesPerPage = this->dataPtr->tilesPerPage;
+    Ogre::Texture *page = this->dataPtr->pages[i / tilesPerPage];
+    unsigned int top = static_cast<unsigned int>(i % tilesPerPage) * height;
+    Ogre::Box dstBox(0, top, width, top + height);
+    page->getBuffer()->blit(texture->getBuffer(), srcBox, dstBox);
+  }
+
+  // one readback per texture, the tiles of consecutive textures are
+  // consecutive images
+  Ogre::PixelFormat imageFormat =
+      Ogre2Conversions::Convert(this->dataPtr->format);
+  size_t imageSize = PixelUtil::MemorySize(this->dataPtr->format, width,
+      height);
+  unsigned char *dst = static_cast<unsigned char *>(_data);
+  for (auto page : this->dataPtr->pages)
+  {
+    unsigned int tiles = static_cast<unsigned int>(page->getHeight()) /
+        height;
+    Ogre::PixelBox box(width, tiles * height, 1, imageFormat, dst);
+    Ogre2ReadbackManager::Instance()->Read(
+        page->getBuffer()->getRenderTarget(), box);
+    dst += tiles * imageSize;
+  }
+
+  return true;
+}
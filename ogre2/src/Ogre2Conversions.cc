@@ -14,12 +14,24 @@
  * limitations under the License.
  *
  */
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define IGN_RENDERING_OGRE2_SSE2
+#endif
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define IGN_RENDERING_OGRE2_NEON
+#endif
+
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
 
 #ifdef _MSC_VER
   #pragma warning(push, 0)
 #endif
 #include <OgreMatrix4.h>
+#include <OgreQuaternion.h>
 #ifdef _MSC_VER
   #pragma warning(pop)
 #endif
@@ -53,7 +65,9 @@ const Ogre::PixelFormat Ogre2Conversions::ogrePixelFormats[PF_COUNT] =
       // PF_FLOAT32_RGB
       Ogre::PF_FLOAT32_RGB,
       // PF_L16
-      Ogre::PF_L16
+      Ogre::PF_L16,
+      // PF_FLOAT16_R
+      Ogre::PF_FLOAT16_R
     };
 
 //////////////////////////////////////////////////
@@ -92,6 +106,64 @@ math::Quaterniond Ogre2Conversions::Convert(const Ogre::Quaternion &_quat)
   return math::Quaterniond(_quat.w, _quat.x, _quat.y, _quat.z);
 }
 
+//////////////////////////////////////////////////
+void Ogre2Conversions::Convert(const math::Pose3d *_poses, size_t _count,
+    Ogre::Vector3 *_positions, Ogre::Quaternion *_orientations)
+{
+  static_assert(sizeof(Ogre::Vector3) == 3u * sizeof(float),
+      "Ogre vectors are expected to hold 3 packed floats");
+  static_assert(sizeof(Ogre::Quaternion) == 4u * sizeof(float),
+      "Ogre quaternions are expected to hold 4 packed floats");
+
+  size_t i = 0u;
+#if defined(IGN_RENDERING_OGRE2_SSE2) || defined(IGN_RENDERING_OGRE2_NEON)
+  // both halves of a pose are narrowed as 4 doubles. The 4th float written
+  // past each position is overwritten by the next position, so the last
+  // pose is left to the scalar loop.
+  for (; i + 1u < _count; ++i)
+  {
+    const math::Vector3d &pos = _poses[i].Pos();
+    const math::Quaterniond &rot = _poses[i].Rot();
+    float *p = &_positions[i].x;
+    float *q = &_orientations[i].w;
+#if defined(__AVX__)
+    _mm_storeu_ps(p, _mm256_cvtpd_ps(
+        _mm256_set_pd(0.0, pos.Z(), pos.Y(), pos.X())));
+    _mm_storeu_ps(q, _mm256_cvtpd_ps(
+        _mm256_set_pd(rot.Z(), rot.Y(), rot.X(), rot.W())));
+#elif defined(IGN_RENDERING_OGRE2_SSE2)
+    _mm_storeu_ps(p, _mm_movelh_ps(
+        _mm_cvtpd_ps(_mm_set_pd(pos.Y(), pos.X())),
+        _mm_cvtpd_ps(_mm_set_pd(0.0, pos.Z()))));
+    _mm_storeu_ps(q, _mm_movelh_ps(
+        _mm_cvtpd_ps(_mm_set_pd(rot.X(), rot.W())),
+        _mm_cvtpd_ps(_mm_set_pd(rot.Z(), rot.Y()))));
+#else
+    const double pd[4] = {pos.X(), pos.Y(), pos.Z(), 0.0};
+    const double qd[4] = {rot.W(), rot.X(), rot.Y(), rot.Z()};
+    vst1q_f32(p, vcombine_f32(vcvt_f32_f64(vld1q_f64(pd)),
+        vcvt_f32_f64(vld1q_f64(pd + 2))));
+    vst1q_f32(q, vcombine_f32(vcvt_f32_f64(vld1q_f64(qd)),
+        vcvt_f32_f64(vld1q_f64(qd + 2))));
+#endif
+  }
+#endif
+  for (; i < _count; ++i)
+  {
+    _positions[i] = Ogre2Conversions::Convert(_poses[i].Pos());
+    _orientations[i] = Ogre2Conversions::Convert(_poses[i].Rot());
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2Conversions::Convert(const float *_xyz, size_t _count,
+    Ogre::Vector3 *_vectors)
+{
+  // ogre vectors are packed floats, so the points are copied as is
+  if (_count > 0u)
+    std::memcpy(&_vectors[0].x, _xyz, _count * 3u * sizeof(float));
+}
+
 //////////////////////////////////////////////////
 Ogre::Radian Ogre2Conversions::Convert(const math::Angle &_angle)
 {
@@ -24,11 +24,25 @@
 #endif
 
 #include <math.h>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include <ignition/math/Helpers.hh>
 
+#include "ignition/rendering/MemoryTracker.hh"
+#include "ignition/rendering/Profiler.hh"
 #include "ignition/rendering/RenderTypes.hh"
+#include "ignition/rendering/Utils.hh"
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
 #include "ignition/rendering/ogre2/Ogre2DepthCamera.hh"
+#include "ignition/rendering/ogre2/Ogre2DistortionPass.hh"
 #include "ignition/rendering/ogre2/Ogre2GaussianNoisePass.hh"
 #include "ignition/rendering/ogre2/Ogre2Includes.hh"
 #include "ignition/rendering/ogre2/Ogre2ParticleEmitter.hh"
@@ -38,7 +52,12 @@
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
 #include "ignition/rendering/ogre2/Ogre2Sensor.hh"
 
+#include "Ogre2OcclusionCuller.hh"
 #include "Ogre2ParticleNoiseListener.hh"
+#include "Ogre2ReadbackManager.hh"
+#include "Ogre2GpuTimer.hh"
+#include "Ogre2SensorVisibilityListener.hh"
+#include "Ogre2SharedDefinitions.hh"
 
 namespace ignition
 {
@@ -65,8 +84,15 @@ class Ogre2DepthGaussianNoisePass : public Ogre2GaussianNoisePass
   // Documentation inherited.
   public: void CreateRenderPass() override;
 
+  // Documentation inherited.
+  public: std::string FusedShaderCode(const std::string &_prefix) const
+      override;
+
   /// brief Pointer to the Gaussian noise ogre material
   private: Ogre::Material *gaussianNoiseMat = nullptr;
+
+  /// \brief Number of frames rendered, counter of the seeded noise
+  private: unsigned int frame = 0u;
 };
 }
 }
@@ -74,23 +100,65 @@ class Ogre2DepthGaussianNoisePass : public Ogre2GaussianNoisePass
 
 /// \internal
 /// \brief Private data for the Ogre2DepthCamera class
-class ignition::rendering::Ogre2DepthCameraPrivate
+/// \brief GPU reduction of the point cloud of a depth camera to a smaller
+/// texture, drawn by a quad pass of its own on demand workspace
+struct Ogre2DepthReduction
 {
-  /// \brief The depth buffer
-  public: float *depthBuffer = nullptr;
+  /// \brief Texture the point cloud is reduced to
+  Ogre::TexturePtr texture;
+
+  /// \brief Material of the quad pass, cloned for the camera
+  Ogre::MaterialPtr material;
+
+  /// \brief Workspace drawing the reduction
+  Ogre::CompositorWorkspace *workspace = nullptr;
+
+  /// \brief Name of the node and workspace definitions
+  std::string defName;
 
+  /// \brief Width of the texture
+  unsigned int width = 0u;
+
+  /// \brief Height of the texture
+  unsigned int height = 0u;
+
+  /// \brief Memory the texture is read back to
+  std::vector<float> data;
+};
+
+class ignition::rendering::Ogre2DepthCameraPrivate
+{
   /// \brief Outgoing depth data, used by newDepthFrame event.
   public: float *depthImage = nullptr;
 
   /// \brief Outgoing point cloud data, used by newRgbPointCloud event.
   public: float *pointCloudImage = nullptr;
 
+  /// \brief Outgoing color data, used by newRgbFrame event.
+  public: unsigned char *colorImage = nullptr;
+
+  /// \brief Outgoing surface normals, used by newNormalFrame event.
+  public: float *normalImage = nullptr;
+
+  /// \brief Outgoing depth data in the compact image format of the
+  /// camera, used by newRawDepthFrame event.
+  public: unsigned char *packedImage = nullptr;
+
+  /// \brief Compact image format the final node packs the depth to,
+  /// PF_L16 or PF_FLOAT16_R. PF_UNKNOWN if the depth is not packed.
+  public: PixelFormat packedFormat = PF_UNKNOWN;
+
   /// \brief maximum value used for data outside sensor range
   public: float dataMaxVal = ignition::math::INF_D;
 
   /// \brief minimum value used for data outside sensor range
   public: float dataMinVal = -ignition::math::INF_D;
 
+  /// \brief Name of the compositor definitions and materials shared with
+  /// the depth cameras of the same configuration, empty if they are not
+  /// created yet
+  public: std::string sharedDefinitions;
+
   /// \brief 1st pass compositor workspace definition
   public: std::string ogreCompositorWorkspaceDef;
 
@@ -100,12 +168,24 @@ class ignition::rendering::Ogre2DepthCameraPrivate
   /// \brief Final pass compositor node definition
   public: std::string ogreCompositorFinalNodeDef;
 
+  /// \brief Version of the static shadow maps last rendered by the
+  /// compositor workspace, 0 if the workspace nodes were just created
+  public: uint64_t staticShadowsVersion = 0u;
+
+  /// \brief Name of the shadow node definition used by the color pass,
+  /// empty if it renders without shadows
+  public: std::string shadowNodeName;
+
   /// \brief Compositor workspace.
   public: Ogre::CompositorWorkspace *ogreCompositorWorkspace = nullptr;
 
   /// \brief Output texture with depth and color data
   public: Ogre::TexturePtr ogreDepthTexture[2];
 
+  /// \brief Output texture with the depth packed in packedFormat, null if
+  /// the depth is not packed
+  public: Ogre::TexturePtr ogrePackedTexture;
+
   /// \brief Dummy render texture for the depth data
   public: RenderTexturePtr depthTexture;
 
@@ -131,6 +211,22 @@ class ignition::rendering::Ogre2DepthCameraPrivate
               unsigned int, unsigned int, unsigned int,
               const std::string &)> newDepthFrame;
 
+  /// \brief Event used to signal color data
+  public: ignition::common::EventT<void(const unsigned char *,
+              unsigned int, unsigned int, unsigned int,
+              const std::string &)> newRgbFrame;
+
+  /// \brief Event used to signal surface normals
+  public: ignition::common::EventT<void(const float *,
+              unsigned int, unsigned int, unsigned int,
+              const std::string &)> newNormalFrame;
+
+  /// \brief Event used to signal depth data in the image format of the
+  /// camera
+  public: ignition::common::EventT<void(const unsigned char *,
+              unsigned int, unsigned int, unsigned int,
+              const std::string &)> newRawDepthFrame;
+
   /// \brief standard deviation of particle noise
   public: double particleStddev = 0.01;
 
@@ -138,17 +234,101 @@ class ignition::rendering::Ogre2DepthCameraPrivate
   /// emitter region
   public: std::unique_ptr<Ogre2ParticleNoiseListener> particleNoiseListener;
 
+  /// \brief Listener applying the visibility mask of the camera to its
+  /// scene passes
+  public: std::unique_ptr<Ogre2SensorVisibilityListener> visibilityListener;
+
+  /// \brief Listener timing the compositor passes of the camera,
+  /// forwarding the events to visibilityListener
+  public: std::unique_ptr<Ogre2GpuTimerListener> gpuTimerListener;
+
   /// \brief Particle scatter ratio. This is used to determine the ratio of
   /// particles that will detected by the depth camera
   public: double particleScatterRatio = 0.1;
 
   /// \brief Name of sky box material
   public: const std::string kSkyboxMaterialName = "SkyBox";
+
+  /// \brief Id of this camera in the readback manager. Zero if
+  /// asynchronous readback is disabled
+  public: unsigned int readbackClient = 0u;
+
+  /// \brief Format of the frames in flight: PF_FLOAT32_RGBA point cloud
+  /// data, PF_FLOAT32_R depth data or the packed depth format
+  public: Ogre::PixelFormat readbackFormat = Ogre::PF_UNKNOWN;
+
+  /// \brief True to copy the depth data to CPU memory after each render
+  public: bool cpuReadback = true;
+
+  /// \brief Occlusion culler built from the depth data of the previous
+  /// frame
+  public: Ogre2OcclusionCuller occlusionCuller;
+
+  /// \brief View matrix of the frame being rendered
+  public: Ogre::Matrix4 frameView;
+
+  /// \brief Projection matrix of the frame being rendered
+  public: Ogre::Matrix4 frameProj;
+
+  /// \brief View and projection matrices of the frames in flight, in the
+  /// order of the readback requests
+  public: std::deque<std::pair<Ogre::Matrix4, Ogre::Matrix4>>
+      readbackMatrices;
+
+  /// \brief First row of the band reduced to a laser scan
+  public: unsigned int scanFirstRow = 0u;
+
+  /// \brief Number of rows of the band reduced to a laser scan, 0 if the
+  /// laser scan is disabled
+  public: unsigned int scanRowCount = 0u;
+
+  /// \brief Size of the voxels of the voxel cloud, 0 if it is disabled
+  public: double voxelLeafSize = 0.0;
+
+  /// \brief Size of the tiles reduced on the GPU for the voxel cloud
+  public: unsigned int voxelTileSize = 4u;
+
+  /// \brief Reduction of the point cloud to a laser scan
+  public: Ogre2DepthReduction scan;
+
+  /// \brief Reduction of the point cloud to one point per tile
+  public: Ogre2DepthReduction tiles;
+
+  /// \brief Outgoing voxel cloud data, used by newVoxelCloud event.
+  public: std::vector<float> voxelCloud;
+
+  /// \brief Event used to emit the laser scans
+  public: ignition::common::EventT<void(const float *,
+              unsigned int, unsigned int, unsigned int,
+              const std::string &)> newLaserScan;
+
+  /// \brief Event used to emit the voxel clouds
+  public: ignition::common::EventT<void(const float *,
+              unsigned int, unsigned int, unsigned int,
+              const std::string &)> newVoxelCloud;
 };
 
 using namespace ignition;
 using namespace rendering;
 
+//////////////////////////////////////////////////
+/// \brief Get the material packing the depth to a compact image format
+/// \param[in] _format Image pixel format of the camera
+/// \return Name of the material, empty if the depth is not packed for the
+/// format
+static std::string depthPackMaterialName(PixelFormat _format)
+{
+  switch (_format)
+  {
+    case PF_L16:
+      return "DepthCameraPackL16";
+    case PF_FLOAT16_R:
+      return "DepthCameraPackFloat16";
+    default:
+      return std::string();
+  }
+}
+
 //////////////////////////////////////////////////
 void Ogre2DepthGaussianNoisePass::PreRender()
 {
@@ -161,9 +341,13 @@ void Ogre2DepthGaussianNoisePass::PreRender()
   if (!this->enabled)
     return;
 
-  Ogre::Vector3 offsets(ignition::math::Rand::DblUniform(0.0, 1.0),
-                        ignition::math::Rand::DblUniform(0.0, 1.0),
-                        ignition::math::Rand::DblUniform(0.0, 1.0));
+  Ogre::Vector3 offsets(Ogre::Vector3::ZERO);
+  if (this->seed == 0u)
+  {
+    offsets = Ogre::Vector3(ignition::math::Rand::DblUniform(0.0, 1.0),
+                            ignition::math::Rand::DblUniform(0.0, 1.0),
+                            ignition::math::Rand::DblUniform(0.0, 1.0));
+  }
 
   Ogre::Pass *pass = this->gaussianNoiseMat->getTechnique(0)->getPass(0);
   Ogre::GpuProgramParametersSharedPtr psParams =
@@ -172,6 +356,16 @@ void Ogre2DepthGaussianNoisePass::PreRender()
   psParams->setNamedConstant("mean", static_cast<Ogre::Real>(this->mean));
   psParams->setNamedConstant("stddev",
       static_cast<Ogre::Real>(this->stdDev));
+  psParams->setNamedConstant("seed", static_cast<int>(this->seed));
+  psParams->setNamedConstant("frame", static_cast<int>(this->frame++));
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2DepthGaussianNoisePass::FusedShaderCode(
+    const std::string &/*_prefix*/) const
+{
+  // the depth noise is applied to depths, not colors, it needs its own node
+  return std::string();
 }
 
 //////////////////////////////////////////////////
@@ -271,63 +465,51 @@ void Ogre2DepthCamera::Init()
 //////////////////////////////////////////////////
 void Ogre2DepthCamera::Destroy()
 {
-  if (this->dataPtr->depthBuffer)
-  {
-    delete [] this->dataPtr->depthBuffer;
-    this->dataPtr->depthBuffer = nullptr;
-  }
+  // the queued frames refer to the events of this sensor
+  this->FlushFrames();
+
+  this->SetAsyncReadback(false);
 
   if (this->dataPtr->depthImage)
   {
+    MemoryTracker::Untrack(this->dataPtr->depthImage);
     delete [] this->dataPtr->depthImage;
     this->dataPtr->depthImage = nullptr;
   }
 
   if (this->dataPtr->pointCloudImage)
   {
+    MemoryTracker::Untrack(this->dataPtr->pointCloudImage);
     delete [] this->dataPtr->pointCloudImage;
     this->dataPtr->pointCloudImage = nullptr;
   }
 
-  if (!this->ogreCamera)
-    return;
-
-  auto engine = Ogre2RenderEngine::Instance();
-  auto ogreRoot = engine->OgreRoot();
-  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
-
-  // remove depth texture, material, compositor
-  for( size_t i = 0u; i < 2u; ++i )
-  {
-    if (this->dataPtr->ogreDepthTexture[i])
-    {
-      Ogre::TextureManager::getSingleton().remove(
-            this->dataPtr->ogreDepthTexture[i]->getName());
-    }
-  }
-  if (this->dataPtr->ogreCompositorWorkspace)
+  if (this->dataPtr->colorImage)
   {
-    this->RemoveWorkspaceCrashWorkaround();
-    ogreCompMgr->removeWorkspace(
-        this->dataPtr->ogreCompositorWorkspace);
+    MemoryTracker::Untrack(this->dataPtr->colorImage);
+    delete [] this->dataPtr->colorImage;
+    this->dataPtr->colorImage = nullptr;
   }
 
-  if (this->dataPtr->depthMaterial)
+  if (this->dataPtr->normalImage)
   {
-    Ogre::MaterialManager::getSingleton().remove(
-        this->dataPtr->depthMaterial->getName());
+    MemoryTracker::Untrack(this->dataPtr->normalImage);
+    delete [] this->dataPtr->normalImage;
+    this->dataPtr->normalImage = nullptr;
   }
 
-  if (!this->dataPtr->ogreCompositorWorkspaceDef.empty())
+  if (this->dataPtr->packedImage)
   {
-    ogreCompMgr->removeWorkspaceDefinition(
-        this->dataPtr->ogreCompositorWorkspaceDef);
-    ogreCompMgr->removeNodeDefinition(
-        this->dataPtr->ogreCompositorBaseNodeDef);
-    ogreCompMgr->removeNodeDefinition(
-        this->dataPtr->ogreCompositorFinalNodeDef);
+    MemoryTracker::Untrack(this->dataPtr->packedImage);
+    delete [] this->dataPtr->packedImage;
+    this->dataPtr->packedImage = nullptr;
   }
 
+  if (!this->ogreCamera)
+    return;
+
+  this->DestroyDepthTexture();
+
   Ogre::SceneManager *ogreSceneManager;
   ogreSceneManager = this->scene->OgreSceneManager();
   if (ogreSceneManager == nullptr)
@@ -389,6 +571,70 @@ void Ogre2DepthCamera::CreateRenderTexture()
   this->dataPtr->depthTexture->SetHeight(1);
 }
 
+/////////////////////////////////////////////////////////
+void Ogre2DepthCamera::DestroyDepthTexture()
+{
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
+
+  // remove depth texture, material, compositor
+  for( size_t i = 0u; i < 2u; ++i )
+  {
+    if (this->dataPtr->ogreDepthTexture[i])
+    {
+      Ogre::TextureManager::getSingleton().remove(
+            this->dataPtr->ogreDepthTexture[i]->getName());
+      this->dataPtr->ogreDepthTexture[i].setNull();
+    }
+  }
+  if (this->dataPtr->ogrePackedTexture)
+  {
+    Ogre::TextureManager::getSingleton().remove(
+        this->dataPtr->ogrePackedTexture->getName());
+    this->dataPtr->ogrePackedTexture.setNull();
+  }
+  if (this->dataPtr->ogreCompositorWorkspace)
+  {
+    this->RemoveWorkspaceCrashWorkaround();
+    ogreCompMgr->removeWorkspace(
+        this->dataPtr->ogreCompositorWorkspace);
+    this->dataPtr->ogreCompositorWorkspace = nullptr;
+  }
+
+  this->DestroyReductions();
+
+  // the definitions and materials are removed with the last depth camera
+  // sharing them
+  if (!this->dataPtr->sharedDefinitions.empty() &&
+      Ogre2SharedDefinitions::Instance()->Release(
+      this->dataPtr->sharedDefinitions))
+  {
+    Ogre::MaterialManager &matManager = Ogre::MaterialManager::getSingleton();
+    if (this->dataPtr->depthMaterial)
+      matManager.remove(this->dataPtr->depthMaterial->getName());
+    if (this->dataPtr->depthFinalMaterial)
+      matManager.remove(this->dataPtr->depthFinalMaterial->getName());
+    std::string skyMatName = this->dataPtr->kSkyboxMaterialName + "_"
+        + this->dataPtr->sharedDefinitions;
+    if (matManager.resourceExists(skyMatName))
+      matManager.remove(skyMatName);
+
+    ogreCompMgr->removeWorkspaceDefinition(
+        this->dataPtr->ogreCompositorWorkspaceDef);
+    ogreCompMgr->removeNodeDefinition(
+        this->dataPtr->ogreCompositorBaseNodeDef);
+    ogreCompMgr->removeNodeDefinition(
+        this->dataPtr->ogreCompositorFinalNodeDef);
+  }
+  this->dataPtr->depthMaterial.setNull();
+  this->dataPtr->depthFinalMaterial.setNull();
+  this->dataPtr->sharedDefinitions.clear();
+  this->dataPtr->ogreCompositorWorkspaceDef.clear();
+  this->dataPtr->ogreCompositorBaseNodeDef.clear();
+  this->dataPtr->ogreCompositorFinalNodeDef.clear();
+}
+
 /////////////////////////////////////////////////////////
 void Ogre2DepthCamera::CreateDepthTexture()
 {
@@ -397,14 +643,50 @@ void Ogre2DepthCamera::CreateDepthTexture()
   this->ogreCamera->setAspectRatio(this->aspect);
   this->ogreCamera->setFOVy(Ogre::Radian(this->LimitFOV(vfov)));
 
+  // the final node packs the depth for compact image formats
+  this->dataPtr->packedFormat =
+      depthPackMaterialName(this->ImageFormat()).empty() ?
+      PF_UNKNOWN : this->ImageFormat();
+
+  MaterialPtr backgroundMaterial = this->Scene()->BackgroundMaterial();
+  bool validBackground = backgroundMaterial &&
+      !backgroundMaterial->EnvironmentMap().empty();
+
+  // Depth cameras with the same configuration share the compositor
+  // definitions and materials, only the textures and the workspace are
+  // created per camera. Render passes rewire the workspace definition, so
+  // cameras with render passes get their own definitions.
+  std::ostringstream config;
+  config << std::setprecision(17) << this->NearClipPlane() << " "
+         << this->FarClipPlane() << " " << this->dataPtr->dataMinVal << " "
+         << this->dataPtr->dataMaxVal << " "
+         << this->Scene()->BackgroundColor() << " "
+         << this->dataPtr->particleStddev << " "
+         << this->dataPtr->packedFormat << " " << this->shadowsEnabled << " "
+         << this->shadowMapSize << " "
+         << (validBackground ? backgroundMaterial->EnvironmentMap() : "");
+  if (!this->dataPtr->renderPasses.empty())
+    config << " " << this->Name();
+  bool created = false;
+  this->dataPtr->sharedDefinitions = Ogre2SharedDefinitions::Instance()->
+      Acquire("DepthCameraWorkspace", config.str(), created);
+
   // Load depth material
   // The DepthCamera material is defined in script (depth_camera.material).
   // We need to clone it since we are going to modify its uniform variables
   std::string matDepthName = "DepthCamera";
-  Ogre::MaterialPtr matDepth =
-      Ogre::MaterialManager::getSingleton().getByName(matDepthName);
-  this->dataPtr->depthMaterial = matDepth->clone(
-      this->Name() + "_" + matDepthName);
+  Ogre::MaterialManager &matManager = Ogre::MaterialManager::getSingleton();
+  if (created)
+  {
+    Ogre::MaterialPtr matDepth = matManager.getByName(matDepthName);
+    this->dataPtr->depthMaterial = matDepth->clone(
+        this->dataPtr->sharedDefinitions + "_" + matDepthName);
+  }
+  else
+  {
+    this->dataPtr->depthMaterial = matManager.getByName(
+        this->dataPtr->sharedDefinitions + "_" + matDepthName);
+  }
   this->dataPtr->depthMaterial->load();
   Ogre::Pass *pass = this->dataPtr->depthMaterial->getTechnique(0)->getPass(0);
   Ogre::GpuProgramParametersSharedPtr psParams =
@@ -445,10 +727,17 @@ void Ogre2DepthCamera::CreateDepthTexture()
     static_cast<float>(this->dataPtr->particleStddev));
 
   std::string matDepthFinalName = "DepthCameraFinal";
-  Ogre::MaterialPtr matDepthFinal =
-      Ogre::MaterialManager::getSingleton().getByName(matDepthFinalName);
-  this->dataPtr->depthFinalMaterial = matDepthFinal->clone(
-      this->Name() + "_" + matDepthFinalName);
+  if (created)
+  {
+    Ogre::MaterialPtr matDepthFinal = matManager.getByName(matDepthFinalName);
+    this->dataPtr->depthFinalMaterial = matDepthFinal->clone(
+        this->dataPtr->sharedDefinitions + "_" + matDepthFinalName);
+  }
+  else
+  {
+    this->dataPtr->depthFinalMaterial = matManager.getByName(
+        this->dataPtr->sharedDefinitions + "_" + matDepthFinalName);
+  }
   this->dataPtr->depthFinalMaterial->load();
   Ogre::Pass *passFinal =
       this->dataPtr->depthFinalMaterial->getTechnique(0)->getPass(0);
@@ -464,15 +753,10 @@ void Ogre2DepthCamera::CreateDepthTexture()
       static_cast<float>(this->dataPtr->dataMinVal));
 
   // create background material is specified
-  MaterialPtr backgroundMaterial = this->Scene()->BackgroundMaterial();
-  bool validBackground = backgroundMaterial &&
-      !backgroundMaterial->EnvironmentMap().empty();
-
   if (validBackground)
   {
-    Ogre::MaterialManager &matManager = Ogre::MaterialManager::getSingleton();
     std::string skyMatName = this->dataPtr->kSkyboxMaterialName + "_"
-        + this->Name();
+        + this->dataPtr->sharedDefinitions;
     auto mat = matManager.getByName(skyMatName);
     if (!mat)
     {
@@ -495,8 +779,26 @@ void Ogre2DepthCamera::CreateDepthTexture()
   auto ogreRoot = engine->OgreRoot();
   Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
 
-  std::string wsDefName = "DepthCameraWorkspace_" + this->Name();
+  std::string wsDefName = this->dataPtr->sharedDefinitions;
+  std::string baseNodeDefName = wsDefName + "/BaseNode";
+  std::string finalNodeDefName = wsDefName + "/FinalNode";
   this->dataPtr->ogreCompositorWorkspaceDef = wsDefName;
+  this->dataPtr->ogreCompositorBaseNodeDef = baseNodeDefName;
+  this->dataPtr->ogreCompositorFinalNodeDef = finalNodeDefName;
+
+  this->dataPtr->shadowNodeName.clear();
+  if (this->shadowsEnabled)
+  {
+    this->dataPtr->shadowNodeName =
+        this->scene->ShadowNodeName(this->shadowMapSize);
+  }
+  // the shadow node of shared definitions follows the lights of the scene
+  if (!created)
+  {
+    this->scene->ApplyShadowNode(baseNodeDefName, "colorTexture",
+        this->dataPtr->shadowNodeName);
+  }
+
   if (!ogreCompMgr->hasWorkspaceDefinition(wsDefName))
   {
     // The depth camera compositor does a few passes in order to simulate
@@ -587,8 +889,6 @@ void Ogre2DepthCamera::CreateDepthTexture()
     //   out 1 rt1
     // }
 
-    std::string baseNodeDefName = wsDefName + "/BaseNode";
-    this->dataPtr->ogreCompositorBaseNodeDef = baseNodeDefName;
     Ogre::CompositorNodeDef *baseNodeDef =
         ogreCompMgr->addNodeDefinition(baseNodeDefName);
 
@@ -698,7 +998,7 @@ void Ogre2DepthCamera::CreateDepthTexture()
             static_cast<Ogre::CompositorPassQuadDef *>(
             colorTargetDef->addPass(Ogre::PASS_QUAD));
         passQuad->mMaterialName = this->dataPtr->kSkyboxMaterialName + "_"
-            + this->Name();
+            + this->dataPtr->sharedDefinitions;
         passQuad->mFrustumCorners =
             Ogre::CompositorPassQuadDef::CAMERA_DIRECTION;
       }
@@ -709,9 +1009,8 @@ void Ogre2DepthCamera::CreateDepthTexture()
           colorTargetDef->addPass(Ogre::PASS_SCENE));
       passScene->mVisibilityMask = IGN_VISIBILITY_ALL;
 
-      // todo(anyone) PbsMaterialsShadowNode is hardcoded.
-      // Although this may be just fine
-      passScene->mShadowNode = "PbsMaterialsShadowNode";
+      if (!this->dataPtr->shadowNodeName.empty())
+        passScene->mShadowNode = this->dataPtr->shadowNodeName;
     }
 
     Ogre::CompositorTargetDef *depthTargetDef =
@@ -819,10 +1118,18 @@ void Ogre2DepthCamera::CreateDepthTexture()
     //       input 0 rt_input
     //     }
     //   }
+    //   // only if the image format of the camera is PF_L16 or PF_FLOAT16_R
+    //   in 2 rt_packed
+    //   target rt_packed
+    //   {
+    //     pass render_quad
+    //     {
+    //       material DepthCameraPackL16 // or DepthCameraPackFloat16
+    //       input 0 rt_output
+    //     }
+    //   }
     // }
 
-    std::string finalNodeDefName = wsDefName + "/FinalNode";
-    this->dataPtr->ogreCompositorFinalNodeDef = finalNodeDefName;
     Ogre::CompositorNodeDef *finalNodeDef =
         ogreCompMgr->addNodeDefinition(finalNodeDefName);
 
@@ -832,7 +1139,15 @@ void Ogre2DepthCamera::CreateDepthTexture()
     finalNodeDef->addTextureSourceName("rt_output", 1,
         Ogre::TextureDefinitionBase::TEXTURE_INPUT);
 
-    finalNodeDef->setNumTargetPass(1);
+    std::string packMaterialName = depthPackMaterialName(
+        this->dataPtr->packedFormat);
+    if (!packMaterialName.empty())
+    {
+      finalNodeDef->addTextureSourceName("rt_packed", 2,
+          Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+    }
+
+    finalNodeDef->setNumTargetPass(packMaterialName.empty() ? 1 : 2);
     // rt_output target - converts depth to xyz
     Ogre::CompositorTargetDef *outputTargetDef =
         finalNodeDef->addTargetPass("rt_output");
@@ -852,6 +1167,18 @@ void Ogre2DepthCamera::CreateDepthTexture()
       passQuad->mMaterialName = this->dataPtr->depthFinalMaterial->getName();
       passQuad->addQuadTextureSource(0, "rt_input", 0);
     }
+    if (!packMaterialName.empty())
+    {
+      // pack the depth so that only two bytes per pixel are read back
+      Ogre::CompositorTargetDef *packedTargetDef =
+          finalNodeDef->addTargetPass("rt_packed");
+      packedTargetDef->setNumPasses(1);
+      Ogre::CompositorPassQuadDef *passQuad =
+          static_cast<Ogre::CompositorPassQuadDef *>(
+          packedTargetDef->addPass(Ogre::PASS_QUAD));
+      passQuad->mMaterialName = packMaterialName;
+      passQuad->addQuadTextureSource(0, "rt_output", 0);
+    }
     finalNodeDef->mapOutputChannel(0, "rt_output");
 
     // Finally create the workspace.
@@ -868,6 +1195,8 @@ void Ogre2DepthCamera::CreateDepthTexture()
     workDef->connectExternal(0, baseNodeDefName, 0);
     workDef->connectExternal(1, baseNodeDefName, 1);
     workDef->connect(baseNodeDefName, finalNodeDefName);
+    if (!packMaterialName.empty())
+      workDef->connectExternal(2, finalNodeDefName, 2);
   }
   Ogre::CompositorWorkspaceDef *wsDef =
       ogreCompMgr->getWorkspaceDefinition(wsDefName);
@@ -893,6 +1222,20 @@ void Ogre2DepthCamera::CreateDepthTexture()
     rt->setDepthBufferPool(Ogre::DepthBuffer::POOL_INVALID);
   }
 
+  if (this->dataPtr->packedFormat != PF_UNKNOWN)
+  {
+    this->dataPtr->ogrePackedTexture =
+      Ogre::TextureManager::getSingleton().createManual(
+      this->Name() + "_depthPacked", "General",
+      Ogre::TEX_TYPE_2D, this->ImageWidth(), this->ImageHeight(), 1, 0,
+      Ogre2Conversions::Convert(this->dataPtr->packedFormat),
+      Ogre::TU_RENDERTARGET, 0, false, 0, Ogre::BLANKSTRING, false, true);
+
+    Ogre::RenderTarget *rt =
+        this->dataPtr->ogrePackedTexture->getBuffer()->getRenderTarget();
+    rt->setDepthBufferPool(Ogre::DepthBuffer::POOL_INVALID);
+  }
+
   CreateWorkspaceInstance();
 }
 
@@ -910,12 +1253,40 @@ void Ogre2DepthCamera::CreateWorkspaceInstance()
         this->dataPtr->ogreDepthTexture[i]->getBuffer()->getRenderTarget();
     externalTargets[i].textures.push_back(this->dataPtr->ogreDepthTexture[i]);
   }
+  if (this->dataPtr->ogrePackedTexture)
+  {
+    Ogre::CompositorChannel packedTarget;
+    packedTarget.target =
+        this->dataPtr->ogrePackedTexture->getBuffer()->getRenderTarget();
+    packedTarget.textures.push_back(this->dataPtr->ogrePackedTexture);
+    externalTargets.push_back(packedTarget);
+  }
 
   // create compositor worksspace
   this->dataPtr->ogreCompositorWorkspace =
       ogreCompMgr->addWorkspace(this->scene->OgreSceneManager(),
       externalTargets, this->ogreCamera,
       this->dataPtr->ogreCompositorWorkspaceDef, false);
+  this->dataPtr->staticShadowsVersion = 0u;
+
+  // cull the visuals outside of the visibility mask of the camera
+  if (!this->dataPtr->visibilityListener)
+  {
+    this->dataPtr->visibilityListener.reset(
+        new Ogre2SensorVisibilityListener(this));
+    this->dataPtr->visibilityListener->SetOcclusionCuller(
+        &this->dataPtr->occlusionCuller, this->scene.get());
+  }
+  if (!this->dataPtr->gpuTimerListener)
+  {
+    this->dataPtr->gpuTimerListener.reset(new Ogre2GpuTimerListener(
+        this->gpuTimerClient, "depth",
+        this->dataPtr->visibilityListener.get()));
+  }
+  this->dataPtr->gpuTimerListener->SetNodeLabel(
+      this->dataPtr->ogreCompositorFinalNodeDef, "final");
+  this->dataPtr->ogreCompositorWorkspace->setListener(
+      this->dataPtr->gpuTimerListener.get());
 
   // add the listener
   Ogre::CompositorNode *node =
@@ -940,29 +1311,67 @@ void Ogre2DepthCamera::CreateWorkspaceInstance()
 //////////////////////////////////////////////////
 void Ogre2DepthCamera::Render()
 {
-  // update the compositors
-  this->dataPtr->ogreCompositorWorkspace->setEnabled(true);
+  IGN_RENDERING_PROFILE("Ogre2DepthCamera::Render");
+  this->BeginFrameStats();
+  this->scene->AddParticleViewer(this->ogreCamera);
+
+  // the occlusion culler needs the matrices the depth data is rendered with
+  this->dataPtr->frameView = this->ogreCamera->getViewMatrix(true);
+  this->dataPtr->frameProj = this->ogreCamera->getProjectionMatrix();
+
+  this->scene->UpdateStaticShadows(this->dataPtr->ogreCompositorWorkspace,
+      this->dataPtr->shadowNodeName, this->dataPtr->staticShadowsVersion);
+
   auto engine = Ogre2RenderEngine::Instance();
-  engine->OgreRoot()->renderOneFrame();
-  this->dataPtr->ogreCompositorWorkspace->setEnabled(false);
+  if (engine->RenderBatchActive())
+  {
+    engine->AddToRenderBatch(this->shared_from_this(),
+        this->dataPtr->ogreCompositorWorkspace);
+    return;
+  }
+
+  // update the compositors
+  engine->RenderWorkspaces({this->dataPtr->ogreCompositorWorkspace});
 }
 
 //////////////////////////////////////////////////
 void Ogre2DepthCamera::PreRender()
 {
+  IGN_RENDERING_PROFILE("Ogre2DepthCamera::PreRender");
+  // render passes rewire the workspace definition, a camera sharing its
+  // definitions with other cameras is rebuilt with definitions of its own
+  if (this->dataPtr->renderPassDirty &&
+      Ogre2SharedDefinitions::Instance()->Count(
+      this->dataPtr->sharedDefinitions) > 1u)
+  {
+    this->DestroyDepthTexture();
+  }
+
   if (!this->dataPtr->ogreDepthTexture[0])
     this->CreateDepthTexture();
 
   if (!this->dataPtr->ogreCompositorWorkspace)
     this->CreateWorkspaceInstance();
 
+  this->ogreCamera->setLodBias(this->RenderLodBias());
+
   Ogre::Texture *rawDepthTextures[2] =
   {
     this->dataPtr->ogreDepthTexture[0].get(),
     this->dataPtr->ogreDepthTexture[1].get()
   };
 
-  // update depth camera render passes
+  // update depth camera render passes. The workspace nodes, including the
+  // shadow node, may be recreated
+  if (this->dataPtr->renderPassDirty)
+    this->dataPtr->staticShadowsVersion = 0u;
+  for (const auto &pass : this->dataPtr->renderPasses)
+  {
+    Ogre2RenderPass *ogre2RenderPass =
+        dynamic_cast<Ogre2RenderPass *>(pass.get());
+    if (ogre2RenderPass)
+      ogre2RenderPass->SetOgreCamera(this->ogreCamera);
+  }
   Ogre2RenderTarget::UpdateRenderPassChain(
       this->dataPtr->ogreCompositorWorkspace,
       this->dataPtr->ogreCompositorWorkspaceDef,
@@ -987,6 +1396,11 @@ void Ogre2DepthCamera::PreRender()
   // dirty render pass
   if (this->dataPtr->renderPassDirty)
   {
+    this->dataPtr->gpuTimerListener->SetRenderPassLabels(
+        this->dataPtr->renderPasses);
+    this->dataPtr->ogreCompositorWorkspace->setListener(
+        this->dataPtr->gpuTimerListener.get());
+
     Ogre::CompositorNode *node =
         this->dataPtr->ogreCompositorWorkspace->getNodeSequence()[0];
     auto channelsTex = node->getLocalTextures();
@@ -1012,56 +1426,242 @@ void Ogre2DepthCamera::PreRender()
 //////////////////////////////////////////////////
 void Ogre2DepthCamera::PostRender()
 {
+  IGN_RENDERING_PROFILE("Ogre2DepthCamera::PostRender");
+  bool reduce = (this->dataPtr->scanRowCount > 0u &&
+      this->dataPtr->newLaserScan.ConnectionCount() > 0u) ||
+      (this->dataPtr->voxelLeafSize > 0.0 &&
+      this->dataPtr->newVoxelCloud.ConnectionCount() > 0u);
+
+  // the depth data stays on the GPU, there is nothing to cull with
+  if (!this->dataPtr->cpuReadback && !reduce)
+  {
+    this->dataPtr->occlusionCuller.Clear();
+    return;
+  }
+
+  // data is read back once the render batch has been rendered
+  auto engine = Ogre2RenderEngine::Instance();
+  if (engine->RenderBatchActive())
+  {
+    engine->DeferPostRender(this->shared_from_this());
+    return;
+  }
+
+  // only the reduced outputs are read back without CPU readback
+  if (reduce)
+    this->ReducePointCloud();
+  if (!this->dataPtr->cpuReadback)
+  {
+    this->dataPtr->occlusionCuller.Clear();
+    return;
+  }
+
   unsigned int width = this->ImageWidth();
   unsigned int height = this->ImageHeight();
 
   PixelFormat format = PF_FLOAT32_RGBA;
-  Ogre::PixelFormat imageFormat = Ogre2Conversions::Convert(format);
-
-  size_t size = Ogre::PixelUtil::getMemorySize(width, height, 1, imageFormat);
   int len = width * height;
   unsigned int channelCount = PixelUtil::ChannelCount(format);
 
-  if (!this->dataPtr->depthBuffer)
+  if (!this->dataPtr->depthImage)
   {
-    this->dataPtr->depthBuffer = new float[len * channelCount];
+    this->dataPtr->depthImage = new float[len];
+    MemoryTracker::Track(MC_SENSOR_BUFFER, this->dataPtr->depthImage,
+        len * sizeof(float));
   }
-  Ogre::PixelBox dstBox(width, height,
-        1, imageFormat, this->dataPtr->depthBuffer);
 
-  // blit data from gpu to cpu
-  auto rt = this->dataPtr->ogreDepthTexture[1]->getBuffer()->getRenderTarget();
-  rt->copyContentsToMemory(dstBox, Ogre::RenderTarget::FB_AUTO);
+  // The xyz + rgba data is only read back if there are point cloud, color
+  // or normals subscribers. Otherwise the depth channel is extracted by the
+  // GPU during the readback and written directly to the outgoing depth
+  // buffer. If only the raw depth is needed and the image format is
+  // compact, the depth packed by the final node is read back instead.
+  bool rgb = this->dataPtr->newRgbFrame.ConnectionCount() > 0u;
+  bool normals = this->dataPtr->newNormalFrame.ConnectionCount() > 0u;
+  bool pointCloud = rgb || normals ||
+      this->dataPtr->newRgbPointCloud.ConnectionCount() > 0u;
+  PixelFormat packedFormat = this->dataPtr->packedFormat;
+  bool raw = this->dataPtr->newRawDepthFrame.ConnectionCount() > 0u;
+  bool packedOnly = packedFormat != PF_UNKNOWN && raw && !pointCloud &&
+      this->dataPtr->newDepthFrame.ConnectionCount() == 0u &&
+      !this->scene->OcclusionCulling();
+  if (packedFormat != PF_UNKNOWN && raw && !this->dataPtr->packedImage)
+  {
+    unsigned int packedSize = PixelUtil::MemorySize(packedFormat,
+        width, height);
+    this->dataPtr->packedImage = new unsigned char[packedSize];
+    MemoryTracker::Track(MC_SENSOR_BUFFER, this->dataPtr->packedImage,
+        packedSize);
+  }
 
-  if (!this->dataPtr->depthImage)
+  void *readBuffer = this->dataPtr->depthImage;
+  Ogre::PixelFormat readFormat = Ogre::PF_FLOAT32_R;
+  Ogre::Texture *readTexture = this->dataPtr->ogreDepthTexture[1].get();
+  if (pointCloud)
   {
-    this->dataPtr->depthImage = new float[len];
+    if (!this->dataPtr->pointCloudImage)
+    {
+      this->dataPtr->pointCloudImage = new float[len * channelCount];
+      MemoryTracker::Track(MC_SENSOR_BUFFER,
+          this->dataPtr->pointCloudImage, len * channelCount * sizeof(float));
+    }
+    readBuffer = this->dataPtr->pointCloudImage;
+    readFormat = Ogre2Conversions::Convert(format);
+  }
+  else if (packedOnly)
+  {
+    readBuffer = this->dataPtr->packedImage;
+    readFormat = Ogre2Conversions::Convert(packedFormat);
+    readTexture = this->dataPtr->ogrePackedTexture.get();
   }
-  if (!this->dataPtr->pointCloudImage)
+  size_t size = Ogre::PixelUtil::getMemorySize(width, height, 1, readFormat);
+  Ogre::PixelBox dstBox(width, height, 1, readFormat, readBuffer);
+
+  auto readback = Ogre2ReadbackManager::Instance();
+  if (this->dataPtr->readbackClient &&
+      readFormat != this->dataPtr->readbackFormat)
   {
-    this->dataPtr->pointCloudImage = new float[len * channelCount];
+    // frames in flight have the wrong format, discard them
+    this->SetAsyncReadback(false);
+    this->SetAsyncReadback(true);
   }
+  this->dataPtr->readbackFormat = readFormat;
 
-  // fill depth data
-  for (unsigned int i = 0; i < height; ++i)
+  Ogre::Matrix4 view = this->dataPtr->frameView;
+  Ogre::Matrix4 proj = this->dataPtr->frameProj;
+  if (this->dataPtr->readbackClient)
   {
-    unsigned int step = i*width*channelCount;
-    for (unsigned int j = 0; j < width; ++j)
+    // queue a copy of the frame that has just been rendered and retrieve a
+    // previous one so the transfer overlaps with the next render
+    if (!readback->Request(this->dataPtr->readbackClient, readTexture,
+        readFormat))
     {
-      float x = this->dataPtr->depthBuffer[step + j*channelCount];
-      this->dataPtr->depthImage[i*width + j] = x;
+      ignwarn << "Asynchronous readback failed for depth camera ["
+              << this->Name() << "], falling back to blocking readback"
+              << std::endl;
+      this->SetAsyncReadback(false);
     }
+    else
+    {
+      this->dataPtr->readbackMatrices.emplace_back(view, proj);
+      if (!readback->Retrieve(this->dataPtr->readbackClient,
+          readBuffer, size))
+      {
+        // no frame available yet
+        return;
+      }
+
+      // the retrieved frame is the oldest one in flight
+      view = this->dataPtr->readbackMatrices.front().first;
+      proj = this->dataPtr->readbackMatrices.front().second;
+      this->dataPtr->readbackMatrices.pop_front();
+    }
+  }
+
+  if (!this->dataPtr->readbackClient)
+  {
+    readback->Read(readTexture->getBuffer()->getRenderTarget(), dstBox);
+  }
+  this->AddReadbackBytes(dstBox.getConsecutiveSize());
+
+  // the packed depth skips the float depth, it has no other subscriber
+  if (packedOnly)
+  {
+    this->dataPtr->occlusionCuller.Clear();
+    this->DispatchFrame(this->dataPtr->newRawDepthFrame,
+        this->dataPtr->packedImage, PixelUtil::MemorySize(packedFormat,
+        width, height), width, height, 1, PixelUtil::Name(packedFormat));
+    return;
+  }
+
+  // fill depth data from the x channel of the point cloud
+  if (pointCloud)
+  {
+    PixelUtil::Convert(this->dataPtr->pointCloudImage, PF_FLOAT32_RGBA,
+        this->dataPtr->depthImage, PF_FLOAT32_R, len);
+  }
+
+  // the next frame skips the items hidden behind this one
+  if (this->scene->OcclusionCulling())
+  {
+    this->dataPtr->occlusionCuller.SetDepth(this->dataPtr->depthImage,
+        width, height, view, proj, this->NearClipPlane(),
+        this->FarClipPlane());
+  }
+  else
+  {
+    this->dataPtr->occlusionCuller.Clear();
+  }
+
+  this->DispatchFrame(this->dataPtr->newDepthFrame,
+      this->dataPtr->depthImage, len, width, height, 1, "FLOAT32");
+
+  // raw depth, packed on the CPU the way the final node does it since the
+  // float depth has been read back already
+  if (raw)
+  {
+    if (packedFormat != PF_UNKNOWN)
+    {
+      PixelUtil::Convert(this->dataPtr->depthImage, PF_FLOAT32_R,
+          this->dataPtr->packedImage, packedFormat, len);
+      this->DispatchFrame(this->dataPtr->newRawDepthFrame,
+          this->dataPtr->packedImage, PixelUtil::MemorySize(packedFormat,
+          width, height), width, height, 1, PixelUtil::Name(packedFormat),
+          false);
+    }
+    else
+    {
+      this->DispatchFrame(this->dataPtr->newRawDepthFrame,
+          reinterpret_cast<const unsigned char *>(this->dataPtr->depthImage),
+          len * sizeof(float), width, height, 1, PixelUtil::Name(PF_FLOAT32_R),
+          false);
+    }
+  }
+
+  // color data, unpacked from the 4th channel of the point cloud
+  if (rgb)
+  {
+    if (!this->dataPtr->colorImage)
+    {
+      this->dataPtr->colorImage = new unsigned char[len * 3];
+      MemoryTracker::Track(MC_SENSOR_BUFFER, this->dataPtr->colorImage,
+          len * 3);
+    }
+    for (int i = 0; i < len; ++i)
+    {
+      uint32_t rgba;
+      std::memcpy(&rgba, &this->dataPtr->pointCloudImage[i * channelCount + 3],
+          sizeof(rgba));
+      unsigned char *pixel = &this->dataPtr->colorImage[i * 3];
+      pixel[0] = static_cast<unsigned char>(rgba >> 24 & 0xFF);
+      pixel[1] = static_cast<unsigned char>(rgba >> 16 & 0xFF);
+      pixel[2] = static_cast<unsigned char>(rgba >> 8 & 0xFF);
+    }
+    this->DispatchFrame(this->dataPtr->newRgbFrame,
+        this->dataPtr->colorImage, len * 3, width, height, 3, "PF_R8G8B8");
+  }
+
+  // surface normals, computed from the xyz channels of the point cloud
+  if (normals)
+  {
+    if (!this->dataPtr->normalImage)
+    {
+      this->dataPtr->normalImage = new float[len * 3];
+      MemoryTracker::Track(MC_SENSOR_BUFFER, this->dataPtr->normalImage,
+          len * 3 * sizeof(float));
+    }
+    computePointCloudNormals(this->dataPtr->pointCloudImage, width, height,
+        channelCount, this->dataPtr->normalImage);
+    this->DispatchFrame(this->dataPtr->newNormalFrame,
+        this->dataPtr->normalImage, len * 3, width, height, 3,
+        "PF_FLOAT32_RGB");
   }
-  this->dataPtr->newDepthFrame(
-        this->dataPtr->depthImage, width, height, 1, "FLOAT32");
 
   // point cloud data
   if (this->dataPtr->newRgbPointCloud.ConnectionCount() > 0u)
   {
-    memcpy(this->dataPtr->pointCloudImage, this->dataPtr->depthBuffer, size);
-    this->dataPtr->newRgbPointCloud(
-        this->dataPtr->pointCloudImage, width, height, channelCount,
-        "PF_FLOAT32_RGBA");
+    this->DispatchFrame(this->dataPtr->newRgbPointCloud,
+        this->dataPtr->pointCloudImage, len * channelCount, width, height,
+        channelCount, "PF_FLOAT32_RGBA");
 
     // Uncomment to debug color output
     // for (unsigned int i = 0; i < height; ++i)
@@ -1110,7 +1710,7 @@ void Ogre2DepthCamera::PostRender()
 //////////////////////////////////////////////////
 const float *Ogre2DepthCamera::DepthData() const
 {
-  return this->dataPtr->depthBuffer;
+  return this->dataPtr->depthImage;
 }
 
 //////////////////////////////////////////////////
@@ -1129,6 +1729,421 @@ ignition::common::ConnectionPtr Ogre2DepthCamera::ConnectNewRgbPointCloud(
   return this->dataPtr->newRgbPointCloud.Connect(_subscriber);
 }
 
+//////////////////////////////////////////////////
+ignition::common::ConnectionPtr Ogre2DepthCamera::ConnectNewRgbFrame(
+    std::function<void(const unsigned char *, unsigned int, unsigned int,
+      unsigned int, const std::string &)>  _subscriber)
+{
+  return this->dataPtr->newRgbFrame.Connect(_subscriber);
+}
+
+//////////////////////////////////////////////////
+ignition::common::ConnectionPtr Ogre2DepthCamera::ConnectNewNormalFrame(
+    std::function<void(const float *, unsigned int, unsigned int,
+      unsigned int, const std::string &)>  _subscriber)
+{
+  return this->dataPtr->newNormalFrame.Connect(_subscriber);
+}
+
+//////////////////////////////////////////////////
+ignition::common::ConnectionPtr Ogre2DepthCamera::ConnectNewRawDepthFrame(
+    std::function<void(const unsigned char *, unsigned int, unsigned int,
+      unsigned int, const std::string &)>  _subscriber)
+{
+  return this->dataPtr->newRawDepthFrame.Connect(_subscriber);
+}
+
+//////////////////////////////////////////////////
+void Ogre2DepthCamera::SetAsyncReadback(bool _enabled)
+{
+  auto readback = Ogre2ReadbackManager::Instance();
+  if (!_enabled)
+  {
+    readback->DestroyClient(this->dataPtr->readbackClient);
+    this->dataPtr->readbackClient = 0u;
+    this->dataPtr->readbackMatrices.clear();
+    return;
+  }
+
+  if (this->dataPtr->readbackClient)
+    return;
+
+  this->dataPtr->readbackClient = readback->CreateClient();
+  if (!this->dataPtr->readbackClient)
+  {
+    ignwarn << "Asynchronous readback is not supported by the current "
+            << "render system. Depth camera [" << this->Name() << "] will "
+            << "use blocking readback" << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+bool Ogre2DepthCamera::AsyncReadback() const
+{
+  return this->dataPtr->readbackClient != 0u;
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2DepthCamera::RenderTextureGLId() const
+{
+  if (!this->dataPtr->ogreDepthTexture[1])
+    return 0u;
+
+  unsigned int texId = 0u;
+  this->dataPtr->ogreDepthTexture[1]->getCustomAttribute("GLID", &texId);
+
+  return texId;
+}
+
+//////////////////////////////////////////////////
+void Ogre2DepthCamera::SetCpuReadback(bool _enabled)
+{
+  this->dataPtr->cpuReadback = _enabled;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2DepthCamera::CpuReadback() const
+{
+  return this->dataPtr->cpuReadback;
+}
+
+//////////////////////////////////////////////////
+/// \brief Destroy the texture and workspace of a reduction of the point
+/// cloud of a depth camera, its material is kept
+/// \param[in] _reduction Reduction to destroy
+static void destroyReduction(Ogre2DepthReduction &_reduction)
+{
+  if (_reduction.workspace)
+  {
+    Ogre::CompositorManager2 *compMgr =
+        Ogre2RenderEngine::Instance()->OgreRoot()->getCompositorManager2();
+    compMgr->removeWorkspace(_reduction.workspace);
+    compMgr->removeWorkspaceDefinition(_reduction.defName + "/Workspace");
+    compMgr->removeNodeDefinition(_reduction.defName + "/Node");
+    _reduction.workspace = nullptr;
+  }
+  if (_reduction.texture)
+  {
+    Ogre::TextureManager::getSingleton().remove(
+        _reduction.texture->getName());
+    _reduction.texture.setNull();
+  }
+  _reduction.width = 0u;
+  _reduction.height = 0u;
+}
+
+//////////////////////////////////////////////////
+/// \brief Build the texture, material and workspace of a reduction of the
+/// point cloud of a depth camera if its size has changed
+/// \param[in] _reduction Reduction to build
+/// \param[in] _name Name of the reduction, unique to the camera
+/// \param[in] _materialName Name of the material to clone
+/// \param[in] _width Width of the reduced texture
+/// \param[in] _height Height of the reduced texture
+/// \param[in] _format Format of the reduced texture
+/// \param[in] _input Point cloud texture of the camera
+/// \param[in] _sceneManager Scene manager of the camera
+/// \param[in] _camera Ogre camera of the depth camera
+static void buildReduction(Ogre2DepthReduction &_reduction,
+    const std::string &_name, const std::string &_materialName,
+    unsigned int _width, unsigned int _height, Ogre::PixelFormat _format,
+    const Ogre::TexturePtr &_input, Ogre::SceneManager *_sceneManager,
+    Ogre::Camera *_camera)
+{
+  if (_reduction.workspace && _reduction.width == _width &&
+      _reduction.height == _height)
+  {
+    return;
+  }
+  destroyReduction(_reduction);
+
+  if (!_reduction.material)
+  {
+    Ogre::MaterialPtr material =
+        Ogre::MaterialManager::getSingleton().getByName(_materialName);
+    if (!material)
+    {
+      ignerr << "Material [" << _materialName << "] not found" << std::endl;
+      return;
+    }
+    _reduction.material = material->clone(_name);
+    _reduction.material->load();
+  }
+
+  _reduction.texture = Ogre::TextureManager::getSingleton().createManual(
+      _name, "General", Ogre::TEX_TYPE_2D, _width, _height, 1, 0, _format,
+      Ogre::TU_RENDERTARGET);
+  _reduction.texture->getBuffer()->getRenderTarget()->setDepthBufferPool(
+      Ogre::DepthBuffer::POOL_NO_DEPTH);
+  _reduction.width = _width;
+  _reduction.height = _height;
+
+  // one quad pass drawing the reduced texture from the point cloud
+  Ogre::CompositorManager2 *compMgr =
+      Ogre2RenderEngine::Instance()->OgreRoot()->getCompositorManager2();
+  _reduction.defName = _name;
+  std::string nodeDefName = _reduction.defName + "/Node";
+  std::string wsDefName = _reduction.defName + "/Workspace";
+  Ogre::CompositorNodeDef *nodeDef = compMgr->addNodeDefinition(nodeDefName);
+  nodeDef->addTextureSourceName("rt_input", 0,
+      Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+  nodeDef->addTextureSourceName("rt_output", 1,
+      Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+  nodeDef->setNumTargetPass(1);
+  Ogre::CompositorTargetDef *targetDef = nodeDef->addTargetPass("rt_output");
+  targetDef->setNumPasses(1);
+  Ogre::CompositorPassQuadDef *passQuad =
+      static_cast<Ogre::CompositorPassQuadDef *>(
+      targetDef->addPass(Ogre::PASS_QUAD));
+  passQuad->mMaterialName = _reduction.material->getName();
+  passQuad->addQuadTextureSource(0, "rt_input", 0);
+
+  Ogre::CompositorWorkspaceDef *workDef =
+      compMgr->addWorkspaceDefinition(wsDefName);
+  workDef->connectExternal(0, nodeDefName, 0);
+  workDef->connectExternal(1, nodeDefName, 1);
+  Ogre::CompositorChannelVec externalTargets(2u);
+  externalTargets[0].target = _input->getBuffer()->getRenderTarget();
+  externalTargets[0].textures.push_back(_input);
+  externalTargets[1].target =
+      _reduction.texture->getBuffer()->getRenderTarget();
+  externalTargets[1].textures.push_back(_reduction.texture);
+  _reduction.workspace = compMgr->addWorkspace(_sceneManager,
+      externalTargets, _camera, wsDefName, false);
+}
+
+//////////////////////////////////////////////////
+void Ogre2DepthCamera::SetLaserScanRows(unsigned int _firstRow,
+    unsigned int _rowCount)
+{
+  this->dataPtr->scanFirstRow = _firstRow;
+  this->dataPtr->scanRowCount = _rowCount;
+}
+
+//////////////////////////////////////////////////
+ignition::common::ConnectionPtr Ogre2DepthCamera::ConnectNewLaserScan(
+    std::function<void(const float *, unsigned int, unsigned int,
+      unsigned int, const std::string &)>  _subscriber)
+{
+  return this->dataPtr->newLaserScan.Connect(_subscriber);
+}
+
+//////////////////////////////////////////////////
+void Ogre2DepthCamera::SetVoxelCloud(double _leafSize,
+    unsigned int _tileSize)
+{
+  if (_leafSize < 0.0 || _tileSize == 0u)
+  {
+    ignerr << "Invalid voxel cloud leaf size [" << _leafSize
+           << "] or tile size [" << _tileSize << "] of depth camera ["
+           << this->Name() << "]" << std::endl;
+    return;
+  }
+  this->dataPtr->voxelLeafSize = _leafSize;
+  this->dataPtr->voxelTileSize = _tileSize;
+}
+
+//////////////////////////////////////////////////
+ignition::common::ConnectionPtr Ogre2DepthCamera::ConnectNewVoxelCloud(
+    std::function<void(const float *, unsigned int, unsigned int,
+      unsigned int, const std::string &)>  _subscriber)
+{
+  return this->dataPtr->newVoxelCloud.Connect(_subscriber);
+}
+
+//////////////////////////////////////////////////
+void Ogre2DepthCamera::ReducePointCloud()
+{
+  IGN_RENDERING_PROFILE("Ogre2DepthCamera::ReducePointCloud");
+  if (!this->dataPtr->ogreDepthTexture[1])
+    return;
+
+  unsigned int width = this->ImageWidth();
+  unsigned int height = this->ImageHeight();
+  bool scan = this->dataPtr->scanRowCount > 0u &&
+      this->dataPtr->scanFirstRow < height &&
+      this->dataPtr->newLaserScan.ConnectionCount() > 0u;
+  bool voxels = this->dataPtr->voxelLeafSize > 0.0 &&
+      this->dataPtr->newVoxelCloud.ConnectionCount() > 0u;
+
+  Ogre::Vector4 resolution(static_cast<Ogre::Real>(width),
+      static_cast<Ogre::Real>(height), 1, 1);
+  Ogre::Real nearPlane = static_cast<Ogre::Real>(this->NearClipPlane());
+  Ogre::Real farPlane = static_cast<Ogre::Real>(this->FarClipPlane());
+  std::vector<Ogre::CompositorWorkspace *> workspaces;
+  if (scan)
+  {
+    buildReduction(this->dataPtr->scan, this->Name() + "_laserScan",
+        "DepthCameraScan", width, 1u, Ogre::PF_FLOAT32_R,
+        this->dataPtr->ogreDepthTexture[1],
+        this->scene->OgreSceneManager(), this->ogreCamera);
+    if (this->dataPtr->scan.workspace)
+    {
+      Ogre::GpuProgramParametersSharedPtr psParams =
+          this->dataPtr->scan.material->getTechnique(0)->getPass(0)->
+          getFragmentProgramParameters();
+      psParams->setNamedConstant("texResolution", resolution);
+      psParams->setNamedConstant("firstRow",
+          static_cast<Ogre::Real>(this->dataPtr->scanFirstRow));
+      psParams->setNamedConstant("rowCount",
+          static_cast<Ogre::Real>(this->dataPtr->scanRowCount));
+      psParams->setNamedConstant("near", nearPlane);
+      psParams->setNamedConstant("far", farPlane);
+      workspaces.push_back(this->dataPtr->scan.workspace);
+    }
+  }
+  if (voxels)
+  {
+    unsigned int tileSize = this->dataPtr->voxelTileSize;
+    unsigned int tilesX = (width + tileSize - 1u) / tileSize;
+    unsigned int tilesY = (height + tileSize - 1u) / tileSize;
+    buildReduction(this->dataPtr->tiles, this->Name() + "_voxelTiles",
+        "DepthCameraTiles", tilesX, tilesY, Ogre::PF_FLOAT32_RGBA,
+        this->dataPtr->ogreDepthTexture[1],
+        this->scene->OgreSceneManager(), this->ogreCamera);
+    if (this->dataPtr->tiles.workspace)
+    {
+      Ogre::GpuProgramParametersSharedPtr psParams =
+          this->dataPtr->tiles.material->getTechnique(0)->getPass(0)->
+          getFragmentProgramParameters();
+      psParams->setNamedConstant("texResolution", Ogre::Vector4(
+          resolution.x, resolution.y, static_cast<Ogre::Real>(tilesX),
+          static_cast<Ogre::Real>(tilesY)));
+      psParams->setNamedConstant("tileSize",
+          static_cast<Ogre::Real>(tileSize));
+      psParams->setNamedConstant("near", nearPlane);
+      psParams->setNamedConstant("far", farPlane);
+      workspaces.push_back(this->dataPtr->tiles.workspace);
+    }
+  }
+  if (workspaces.empty())
+    return;
+  Ogre2RenderEngine::Instance()->RenderWorkspaces(workspaces);
+
+  auto readback = Ogre2ReadbackManager::Instance();
+  if (scan && this->dataPtr->scan.workspace)
+  {
+    Ogre2DepthReduction &reduction = this->dataPtr->scan;
+    reduction.data.resize(reduction.width);
+    Ogre::PixelBox box(reduction.width, 1, 1, Ogre::PF_FLOAT32_R,
+        reduction.data.data());
+    readback->Read(reduction.texture->getBuffer()->getRenderTarget(), box);
+    this->AddReadbackBytes(box.getConsecutiveSize());
+    this->DispatchFrame(this->dataPtr->newLaserScan, reduction.data.data(),
+        reduction.data.size(), reduction.width, 1, 1, "PF_FLOAT32_R");
+  }
+
+  if (voxels && this->dataPtr->tiles.workspace)
+  {
+    Ogre2DepthReduction &reduction = this->dataPtr->tiles;
+    size_t count = static_cast<size_t>(reduction.width) * reduction.height;
+    reduction.data.resize(count * 4u);
+    Ogre::PixelBox box(reduction.width, reduction.height, 1,
+        Ogre::PF_FLOAT32_RGBA, reduction.data.data());
+    readback->Read(reduction.texture->getBuffer()->getRenderTarget(), box);
+    this->AddReadbackBytes(box.getConsecutiveSize());
+
+    // merge the tile centroids falling in the same voxel, the voxel
+    // indices are packed in 21 bits per axis
+    double leafSize = this->dataPtr->voxelLeafSize;
+    struct Voxel
+    {
+      float sum[3];
+      float color;
+      unsigned int count;
+    };
+    std::unordered_map<uint64_t, size_t> voxelIndices;
+    std::vector<Voxel> voxelList;
+    for (size_t i = 0u; i < count; ++i)
+    {
+      const float *p = &reduction.data[i * 4u];
+      if (!std::isfinite(p[0]) || !std::isfinite(p[1]) ||
+          !std::isfinite(p[2]))
+      {
+        continue;
+      }
+      uint64_t key = 0u;
+      for (unsigned int a = 0u; a < 3u; ++a)
+      {
+        int64_t index = static_cast<int64_t>(std::floor(p[a] / leafSize));
+        key = key << 21 | (static_cast<uint64_t>(index) & 0x1FFFFFu);
+      }
+      auto it = voxelIndices.emplace(key, voxelList.size());
+      if (it.second)
+      {
+        voxelList.push_back({{p[0], p[1], p[2]}, p[3], 1u});
+        continue;
+      }
+      Voxel &voxel = voxelList[it.first->second];
+      for (unsigned int a = 0u; a < 3u; ++a)
+        voxel.sum[a] += p[a];
+      ++voxel.count;
+    }
+
+    this->dataPtr->voxelCloud.resize(voxelList.size() * 4u);
+    for (size_t i = 0u; i < voxelList.size(); ++i)
+    {
+      float *point = &this->dataPtr->voxelCloud[i * 4u];
+      for (unsigned int a = 0u; a < 3u; ++a)
+        point[a] = voxelList[i].sum[a] / voxelList[i].count;
+      point[3] = voxelList[i].color;
+    }
+    this->DispatchFrame(this->dataPtr->newVoxelCloud,
+        this->dataPtr->voxelCloud.data(), this->dataPtr->voxelCloud.size(),
+        static_cast<unsigned int>(voxelList.size()), 1, 4,
+        "PF_FLOAT32_RGBA");
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2DepthCamera::DestroyReductions()
+{
+  Ogre::MaterialManager &matManager = Ogre::MaterialManager::getSingleton();
+  for (Ogre2DepthReduction *reduction :
+      {&this->dataPtr->scan, &this->dataPtr->tiles})
+  {
+    destroyReduction(*reduction);
+    if (reduction->material)
+    {
+      matManager.remove(reduction->material->getName());
+      reduction->material.setNull();
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+bool Ogre2DepthCamera::CopyRegion(Image &_image, unsigned int _x,
+    unsigned int _y) const
+{
+  IGN_RENDERING_PROFILE("Ogre2DepthCamera::CopyRegion");
+  Ogre::Texture *texture = this->dataPtr->ogreDepthTexture[1].get();
+  if (!texture)
+    return false;
+
+  if (_image.Format() != PF_FLOAT32_R && _image.Format() != PF_FLOAT32_RGBA)
+  {
+    ignerr << "Depth camera regions can only be copied to "
+           << "PF_FLOAT32_R or PF_FLOAT32_RGBA images" << std::endl;
+    return false;
+  }
+  if (_image.Width() == 0u || _image.Height() == 0u ||
+      _x + _image.Width() > this->ImageWidth() ||
+      _y + _image.Height() > this->ImageHeight())
+  {
+    ignerr << "Invalid image region" << std::endl;
+    return false;
+  }
+
+  // reading the red channel of the xyz + rgba texture yields the depth
+  Ogre::PixelBox dstBox(_image.Width(), _image.Height(), 1,
+      Ogre2Conversions::Convert(_image.Format()), _image.Data());
+  dstBox.rowPitch =
+      _image.RowStride() / PixelUtil::BytesPerPixel(_image.Format());
+  Ogre::Box srcBox(_x, _y, _x + _image.Width(), _y + _image.Height());
+  return Ogre2ReadbackManager::Instance()->ReadRegion(texture, srcBox,
+      dstBox);
+}
+
 //////////////////////////////////////////////////
 RenderTargetPtr Ogre2DepthCamera::RenderTarget() const
 {
@@ -1170,6 +2185,25 @@ double Ogre2DepthCamera::FarClipPlane() const
 //////////////////////////////////////////////////
 void Ogre2DepthCamera::SetShadowsNodeDefDirty()
 {
+  // a compositor built later on picks up the current shadow node
+  if (this->dataPtr->ogreCompositorBaseNodeDef.empty())
+    return;
+
+  std::string shadowNodeName;
+  if (this->shadowsEnabled)
+    shadowNodeName = this->scene->ShadowNodeName(this->shadowMapSize);
+
+  // nothing to do if shadows are disabled or the shadow node did not change
+  if (shadowNodeName == this->dataPtr->shadowNodeName)
+    return;
+
+  // switch the color pass to the new shadow node definition. Only the
+  // workspace instance is removed, it is created again from the same
+  // definitions and depth textures in PreRender.
+  this->dataPtr->shadowNodeName = shadowNodeName;
+  this->scene->ApplyShadowNode(this->dataPtr->ogreCompositorBaseNodeDef,
+      "colorTexture", this->dataPtr->shadowNodeName);
+
   if (!this->dataPtr->ogreCompositorWorkspace)
     return;
 
@@ -1182,6 +2216,39 @@ void Ogre2DepthCamera::SetShadowsNodeDefDirty()
   this->dataPtr->ogreCompositorWorkspace = nullptr;
 }
 
+//////////////////////////////////////////////////
+void Ogre2DepthCamera::SetShadowsEnabled(bool _enabled)
+{
+  bool changed = _enabled != this->shadowsEnabled;
+  BaseDepthCamera::SetShadowsEnabled(_enabled);
+  if (changed)
+    this->UnshareDefinitions();
+  this->SetShadowsNodeDefDirty();
+}
+
+//////////////////////////////////////////////////
+void Ogre2DepthCamera::SetShadowMapSize(unsigned int _size)
+{
+  unsigned int size = this->shadowMapSize;
+  BaseDepthCamera::SetShadowMapSize(_size);
+  if (size != this->shadowMapSize)
+    this->UnshareDefinitions();
+  this->SetShadowsNodeDefDirty();
+}
+
+//////////////////////////////////////////////////
+void Ogre2DepthCamera::UnshareDefinitions()
+{
+  // the shadow node of shared definitions is the one of all the cameras
+  // sharing them. The definitions are created again in PreRender, shared
+  // with the cameras of the new configuration.
+  if (Ogre2SharedDefinitions::Instance()->Count(
+      this->dataPtr->sharedDefinitions) > 1u)
+  {
+    this->DestroyDepthTexture();
+  }
+}
+
 //////////////////////////////////////////////////
 void Ogre2DepthCamera::RemoveWorkspaceCrashWorkaround()
 {
@@ -1202,7 +2269,19 @@ void Ogre2DepthCamera::RemoveWorkspaceCrashWorkaround()
 //////////////////////////////////////////////////
 void Ogre2DepthCamera::AddRenderPass(const RenderPassPtr &_pass)
 {
-  // hack: check and only allow gaussian noise for depth cameras
+  // distortion passes sample the packed depth colors without filtering
+  std::shared_ptr<Ogre2DistortionPass> distortionPass =
+      std::dynamic_pointer_cast<Ogre2DistortionPass>(_pass);
+  if (distortionPass)
+  {
+    distortionPass->SetPointSampling(true);
+    this->dataPtr->renderPasses.push_back(distortionPass);
+    this->dataPtr->renderPassDirty = true;
+    return;
+  }
+
+  // hack: check and only allow gaussian noise and distortion for depth
+  // cameras.
   // We create a new depth gaussion noise render pass object
   // (class declared in this src file) so that we can change the shader material
   // to use for applying noise to depth data.
@@ -1213,8 +2292,8 @@ void Ogre2DepthCamera::AddRenderPass(const RenderPassPtr &_pass)
       std::dynamic_pointer_cast<Ogre2GaussianNoisePass>(_pass);
   if (!pass)
   {
-    ignerr << "Depth camera currently only supports a gaussian noise pass"
-           << std::endl;
+    ignerr << "Depth camera currently only supports gaussian noise and "
+           << "distortion passes" << std::endl;
     return;
   }
 
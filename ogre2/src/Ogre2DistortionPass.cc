@@ -0,0 +1,372 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/math/Helpers.hh>
+
+#include "ignition/rendering/RenderPassSystem.hh"
+#include "ignition/rendering/ogre2/Ogre2DistortionPass.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <Compositor/OgreCompositorManager2.h>
+#include <Compositor/OgreCompositorNodeDef.h>
+#include <Compositor/Pass/PassQuad/OgreCompositorPassQuadDef.h>
+#include <OgreCamera.h>
+#include <OgreHardwarePixelBuffer.h>
+#include <OgreMaterial.h>
+#include <OgreMaterialManager.h>
+#include <OgrePass.h>
+#include <OgreRoot.h>
+#include <OgreTechnique.h>
+#include <OgreTextureManager.h>
+#include <OgreTextureUnitState.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+namespace ignition
+{
+namespace rendering
+{
+inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+//
+/// \brief Texture giving the source uv of each pixel of a distorted image.
+/// Passes with the same coefficients and camera projection share the same
+/// texture.
+class Ogre2DistortionMap
+{
+  /// \brief Distortion model, k1, k2, k3, p1, p2, center u and v, and
+  /// tangents of the half horizontal and vertical fields of view
+  public: using Key = std::tuple<int, double, double, double, double, double,
+      double, double, double, double>;
+
+  /// \brief destructor, releases the texture
+  public: ~Ogre2DistortionMap();
+
+  /// \brief Get the remap texture of a distortion, shared by all its
+  /// callers. The texture is null until the first caller fills it.
+  /// \param[in] _key Distortion parameters
+  /// \return Remap texture of the distortion
+  public: static std::shared_ptr<Ogre2DistortionMap> Instance(
+      const Key &_key);
+
+  /// \brief Compute the remap texture
+  /// \param[in] _key Distortion parameters
+  public: void Fill(const Key &_key);
+
+  /// \brief Remap texture, with the source uv of each pixel in its red and
+  /// green channels, or negative values for pixels out of the field of
+  /// view of the camera
+  public: Ogre::TexturePtr texture;
+
+  /// \brief Size of the remap texture. The uvs are interpolated between
+  /// its pixels.
+  public: static const unsigned int kSize = 512u;
+};
+}
+}
+}
+
+/// \brief Private data for the Ogre2DistortionPass class
+class ignition::rendering::Ogre2DistortionPassPrivate
+{
+  /// \brief Material of the full screen quad remapping the input
+  public: Ogre::Material *distortionMat = nullptr;
+
+  /// \brief Remap texture of the current parameters
+  public: std::shared_ptr<Ogre2DistortionMap> map;
+
+  /// \brief Parameters of the remap texture
+  public: Ogre2DistortionMap::Key mapKey;
+
+  /// \brief True to sample the nearest input pixel
+  public: bool pointSampling = false;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Find the undistorted normalized coordinates of a point of the
+/// distorted image
+/// \param[in] _key Distortion parameters
+/// \param[in] _xd Distorted normalized x
+/// \param[in] _yd Distorted normalized y
+/// \param[out] _x Undistorted normalized x
+/// \param[out] _y Undistorted normalized y
+/// \return False if the point is not in front of the camera
+static bool undistort(const Ogre2DistortionMap::Key &_key, double _xd,
+    double _yd, double &_x, double &_y)
+{
+  double k1 = std::get<1>(_key);
+  double k2 = std::get<2>(_key);
+  double k3 = std::get<3>(_key);
+
+  if (std::get<0>(_key) == DM_EQUIDISTANT)
+  {
+    // solve theta_d = theta * (1 + k1 theta^2 + k2 theta^4 + k3 theta^6)
+    // with Newton's method, starting from the undistorted angle
+    double thetaD = std::sqrt(_xd * _xd + _yd * _yd);
+    if (thetaD < 1e-9)
+    {
+      _x = _xd;
+      _y = _yd;
+      return true;
+    }
+    double theta = thetaD;
+    for (int i = 0; i < 20; ++i)
+    {
+      double t2 = theta * theta;
+      double f = theta * (1.0 + t2 * (k1 + t2 * (k2 + t2 * k3))) - thetaD;
+      double df = 1.0 + t2 * (3.0 * k1 + t2 * (5.0 * k2 + t2 * 7.0 * k3));
+      if (std::abs(df) < 1e-9)
+        return false;
+      theta -= f / df;
+    }
+    if (theta <= 0.0 || theta >= IGN_PI * 0.5)
+      return false;
+    double scale = std::tan(theta) / thetaD;
+    _x = _xd * scale;
+    _y = _yd * scale;
+    return true;
+  }
+
+  // Brown-Conrady: fixed point iteration, as done by OpenCV
+  double p1 = std::get<4>(_key);
+  double p2 = std::get<5>(_key);
+  _x = _xd;
+  _y = _yd;
+  for (int i = 0; i < 20; ++i)
+  {
+    double r2 = _x * _x + _y * _y;
+    double radial = 1.0 + r2 * (k1 + r2 * (k2 + r2 * k3));
+    if (radial <= 0.0)
+      return false;
+    double dx = 2.0 * p1 * _x * _y + p2 * (r2 + 2.0 * _x * _x);
+    double dy = p1 * (r2 + 2.0 * _y * _y) + 2.0 * p2 * _x * _y;
+    _x = (_xd - dx) / radial;
+    _y = (_yd - dy) / radial;
+  }
+  return std::isfinite(_x) && std::isfinite(_y);
+}
+
+//////////////////////////////////////////////////
+Ogre2DistortionMap::~Ogre2DistortionMap()
+{
+  if (this->texture && Ogre::TextureManager::getSingletonPtr())
+    Ogre::TextureManager::getSingleton().remove(this->texture->getName());
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<Ogre2DistortionMap> Ogre2DistortionMap::Instance(
+    const Key &_key)
+{
+  static std::map<Key, std::weak_ptr<Ogre2DistortionMap>> instances;
+
+  std::shared_ptr<Ogre2DistortionMap> instance = instances[_key].lock();
+  if (!instance)
+  {
+    instance = std::make_shared<Ogre2DistortionMap>();
+    instances[_key] = instance;
+  }
+  return instance;
+}
+
+//////////////////////////////////////////////////
+void Ogre2DistortionMap::Fill(const Key &_key)
+{
+  double cx = std::get<6>(_key);
+  double cy = std::get<7>(_key);
+  double tanH = std::get<8>(_key);
+  double tanV = std::get<9>(_key);
+
+  // The uvs of the distorted image are converted to normalized coordinates
+  // with the pinhole projection of the camera, undistorted, and projected
+  // back to the uvs of the rendered image. v goes down the image, like y in
+  // the OpenCV convention.
+  std::vector<float> data(kSize * kSize * 2u);
+  for (unsigned int i = 0u; i < kSize; ++i)
+  {
+    double v = (i + 0.5) / kSize;
+    for (unsigned int j = 0u; j < kSize; ++j)
+    {
+      double u = (j + 0.5) / kSize;
+      double x = 0.0;
+      double y = 0.0;
+      float su = -1.0f;
+      float sv = -1.0f;
+      if (undistort(_key, (u - cx) * 2.0 * tanH, (v - cy) * 2.0 * tanV,
+          x, y))
+      {
+        double uu = x / (2.0 * tanH) + 0.5;
+        double vv = y / (2.0 * tanV) + 0.5;
+        if (uu >= 0.0 && uu <= 1.0 && vv >= 0.0 && vv <= 1.0)
+        {
+          su = static_cast<float>(uu);
+          sv = static_cast<float>(vv);
+        }
+      }
+      data[(i * kSize + j) * 2u] = su;
+      data[(i * kSize + j) * 2u + 1u] = sv;
+    }
+  }
+
+  static unsigned int textureCount = 0u;
+  std::string texName = "DistortionMapTex_" + std::to_string(textureCount++);
+  this->texture = Ogre::TextureManager::getSingleton().createManual(
+      texName, "General", Ogre::TEX_TYPE_2D, kSize, kSize, 0,
+      Ogre::PF_FLOAT32_GR);
+  Ogre::v1::HardwarePixelBufferSharedPtr pixelBuffer =
+      this->texture->getBuffer();
+  pixelBuffer->lock(Ogre::v1::HardwareBuffer::HBL_NORMAL);
+  const Ogre::PixelBox &pixelBox = pixelBuffer->getCurrentLock();
+  float *pDest = static_cast<float *>(pixelBox.data);
+  for (unsigned int i = 0u; i < kSize; ++i)
+  {
+    std::copy(data.begin() + i * kSize * 2u,
+        data.begin() + (i + 1u) * kSize * 2u,
+        pDest + i * pixelBox.rowPitch * 2u);
+  }
+  pixelBuffer->unlock();
+}
+
+//////////////////////////////////////////////////
+Ogre2DistortionPass::Ogre2DistortionPass()
+  : dataPtr(std::make_unique<Ogre2DistortionPassPrivate>())
+{
+}
+
+//////////////////////////////////////////////////
+Ogre2DistortionPass::~Ogre2DistortionPass()
+{
+}
+
+//////////////////////////////////////////////////
+void Ogre2DistortionPass::SetPointSampling(bool _point)
+{
+  this->dataPtr->pointSampling = _point;
+}
+
+//////////////////////////////////////////////////
+void Ogre2DistortionPass::PreRender()
+{
+  if (!this->dataPtr->distortionMat)
+    return;
+
+  if (!this->enabled)
+    return;
+
+  Ogre::Camera *camera = this->OgreCamera();
+  if (!camera)
+    return;
+
+  double tanV = std::tan(camera->getFOVy().valueRadians() * 0.5);
+  double tanH = tanV * camera->getAspectRatio();
+  Ogre2DistortionMap::Key key(static_cast<int>(this->model),
+      this->k1, this->k2, this->k3, this->p1, this->p2,
+      this->center.X(), this->center.Y(), tanH, tanV);
+  if (this->dataPtr->map && key == this->dataPtr->mapKey)
+    return;
+
+  std::shared_ptr<Ogre2DistortionMap> map = Ogre2DistortionMap::Instance(key);
+  if (!map->texture)
+    map->Fill(key);
+
+  Ogre::Pass *pass = this->dataPtr->distortionMat->getTechnique(0)->getPass(0);
+  pass->getTextureUnitState(1)->setTexture(map->texture);
+  this->dataPtr->map = map;
+  this->dataPtr->mapKey = key;
+}
+
+//////////////////////////////////////////////////
+void Ogre2DistortionPass::CreateRenderPass()
+{
+  static int distortionNodeCounter = 0;
+
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
+
+  if (!this->ogreCompositorNodeDefName.empty() &&
+      ogreCompMgr->hasNodeDefinition(this->ogreCompositorNodeDefName))
+    return;
+
+  std::string nodeDefName = "DistortionNode_" +
+      std::to_string(distortionNodeCounter++);
+
+  // The Distortion materials are defined in script (distortion.material).
+  // clone the material
+  std::string matName = this->dataPtr->pointSampling ?
+      "DistortionPoint" : "Distortion";
+  Ogre::MaterialPtr ogreMat =
+      Ogre::MaterialManager::getSingleton().getByName(matName);
+  if (!ogreMat)
+  {
+    ignerr << "Distortion material not found: '" << matName << "'"
+           << std::endl;
+    return;
+  }
+  if (!ogreMat->isLoaded())
+    ogreMat->load();
+  this->dataPtr->distortionMat = ogreMat->clone(nodeDefName).get();
+
+  // We need to programmatically create the compositor because we need to
+  // configure it to use the cloned material created above. The node is the
+  // same as the one of Ogre2GaussianNoisePass: the result is drawn to
+  // rt_output and the render textures are swapped for the next pass.
+  this->ogreCompositorNodeDefName = nodeDefName;
+
+  Ogre::CompositorNodeDef *nodeDef =
+      ogreCompMgr->addNodeDefinition(nodeDefName);
+
+  // Input texture
+  nodeDef->addTextureSourceName("rt_input", 0,
+      Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+  nodeDef->addTextureSourceName("rt_output", 1,
+      Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+
+  // rt_input target
+  nodeDef->setNumTargetPass(1);
+  Ogre::CompositorTargetDef *inputTargetDef =
+      nodeDef->addTargetPass("rt_output");
+  inputTargetDef->setNumPasses(1);
+  {
+    // quad pass
+    Ogre::CompositorPassQuadDef *passQuad =
+        static_cast<Ogre::CompositorPassQuadDef *>(
+        inputTargetDef->addPass(Ogre::PASS_QUAD));
+    passQuad->mMaterialName = nodeDefName;
+    passQuad->addQuadTextureSource(0, "rt_input", 0);
+  }
+  nodeDef->mapOutputChannel(0, "rt_output");
+  nodeDef->mapOutputChannel(1, "rt_input");
+
+  // compute the remap texture before the first frame is drawn
+  this->PreRender();
+}
+
+IGN_RENDERING_REGISTER_RENDER_PASS(Ogre2DistortionPass, DistortionPass)
@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <sstream>
+#include <string>
+
+#include <ignition/common/Console.hh>
+#include <ignition/math/Rand.hh>
+
+#include "ignition/rendering/RenderPassSystem.hh"
+#include "ignition/rendering/ogre2/Ogre2DropoutPass.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <Compositor/OgreCompositorManager2.h>
+#include <Compositor/OgreCompositorNodeDef.h>
+#include <Compositor/Pass/PassQuad/OgreCompositorPassQuadDef.h>
+#include <OgreMaterial.h>
+#include <OgreMaterialManager.h>
+#include <OgrePass.h>
+#include <OgreRoot.h>
+#include <OgreTechnique.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+/// \brief Private data for the Ogre2DropoutPass class
+class ignition::rendering::Ogre2DropoutPassPrivate
+{
+  /// brief Pointer to the dropout ogre material
+  public: Ogre::Material *dropoutMat = nullptr;
+
+  /// \brief Number of frames rendered, counter of the seeded dropout
+  public: unsigned int frame = 0u;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+Ogre2DropoutPass::Ogre2DropoutPass()
+  : dataPtr(std::make_unique<Ogre2DropoutPassPrivate>())
+{
+}
+
+//////////////////////////////////////////////////
+Ogre2DropoutPass::~Ogre2DropoutPass()
+{
+}
+
+//////////////////////////////////////////////////
+void Ogre2DropoutPass::PreRender()
+{
+  if (!this->dataPtr->dropoutMat)
+    return;
+
+  if (!this->enabled)
+    return;
+
+  // These parameters are declared in media/materials/scripts/
+  // dropout.material and media/materials/programs/dropout_fs.glsl, or
+  // prefixed in the shader generated from FusedShaderCode when fused with
+  // other passes
+  Ogre::Material *material = this->dataPtr->dropoutMat;
+  std::string prefix;
+  if (this->FusedMaterial())
+  {
+    material = this->FusedMaterial();
+    prefix = this->FusedShaderPrefix();
+  }
+  float offset = (this->seed == 0u) ?
+      static_cast<float>(ignition::math::Rand::DblUniform(0.0, 1.0)) : 0.0f;
+  Ogre::Pass *pass = material->getTechnique(0)->getPass(0);
+  Ogre::GpuProgramParametersSharedPtr psParams =
+      pass->getFragmentProgramParameters();
+  psParams->setNamedConstant(prefix + "probability",
+      static_cast<Ogre::Real>(this->probability));
+  psParams->setNamedConstant(prefix + "offset", offset);
+  psParams->setNamedConstant(prefix + "seed", static_cast<int>(this->seed));
+  psParams->setNamedConstant(prefix + "frame",
+      static_cast<int>(this->dataPtr->frame++));
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2DropoutPass::FusedShaderCode(
+    const std::string &_prefix) const
+{
+  // Same dropout as media/materials/programs/dropout_fs.glsl, see there for
+  // the details
+  const std::string &p = _prefix;
+  std::stringstream code;
+  code << "uniform float " << p << "probability;\n"
+       << "uniform float " << p << "offset;\n"
+       << "uniform int " << p << "seed;\n"
+       << "uniform int " << p << "frame;\n"
+       << "uvec2 " << p << "mulhilo(uint a, uint b)\n"
+       << "{\n"
+       << "  uint a0 = a & 0xFFFFu;\n"
+       << "  uint a1 = a >> 16u;\n"
+       << "  uint b0 = b & 0xFFFFu;\n"
+       << "  uint b1 = b >> 16u;\n"
+       << "  uint t = a1 * b0 + ((a0 * b0) >> 16u);\n"
+       << "  uint w = (t & 0xFFFFu) + a0 * b1;\n"
+       << "  return uvec2(a1 * b1 + (t >> 16u) + (w >> 16u), a * b);\n"
+       << "}\n"
+       << "uvec2 " << p << "philox(uvec2 ctr, uint key)\n"
+       << "{\n"
+       << "  for (int i = 0; i < 10; ++i)\n"
+       << "  {\n"
+       << "    uvec2 hilo = " << p << "mulhilo(0xD256D193u, ctr.x);\n"
+       << "    ctr = uvec2(hilo.x ^ key ^ ctr.y, hilo.y);\n"
+       << "    key += 0x9E3779B9u;\n"
+       << "  }\n"
+       << "  return ctr;\n"
+       << "}\n"
+       << "vec4 " << p << "Apply(vec4 color, vec2 uv)\n"
+       << "{\n"
+       << "  float u;\n"
+       << "  if (" << p << "seed != 0)\n"
+       << "  {\n"
+       << "    uvec2 pixel = uvec2(gl_FragCoord.xy);\n"
+       << "    uvec2 r = " << p << "philox(uvec2(pixel.x | (pixel.y << 16u),"
+       << " uint(" << p << "frame)), uint(" << p << "seed) + 0x68E31DA4u);\n"
+       << "    u = float(r.x >> 8u) / 16777216.0;\n"
+       << "  }\n"
+       << "  else\n"
+       << "  {\n"
+       << "    vec2 co = uv + vec2(" << p << "offset);\n"
+       << "    u = fract(sin(dot(co, vec2(12.9898,78.233))) * 43758.5453);\n"
+       << "  }\n"
+       << "  return (u < " << p << "probability) ? vec4(0.0, 0.0, 0.0, 1.0) :"
+       << " color;\n"
+       << "}\n";
+  return code.str();
+}
+
+//////////////////////////////////////////////////
+void Ogre2DropoutPass::CreateRenderPass()
+{
+  static int dropoutNodeCounter = 0;
+
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
+
+  if (!this->ogreCompositorNodeDefName.empty() &&
+      ogreCompMgr->hasNodeDefinition(this->ogreCompositorNodeDefName))
+    return;
+
+  std::string nodeDefName = "DropoutNode_" +
+      std::to_string(dropoutNodeCounter++);
+
+  // The Dropout material is defined in script (dropout.material).
+  // clone the material
+  std::string matName = "Dropout";
+  Ogre::MaterialPtr ogreMat =
+      Ogre::MaterialManager::getSingleton().getByName(matName);
+  if (!ogreMat)
+  {
+    ignerr << "Dropout material not found: '" << matName << "'"
+           << std::endl;
+    return;
+  }
+  if (!ogreMat->isLoaded())
+    ogreMat->load();
+  this->dataPtr->dropoutMat = ogreMat->clone(nodeDefName).get();
+
+  // The node is the same as the one of Ogre2GaussianNoisePass: the result
+  // is drawn to rt_output and the render textures are swapped for the next
+  // pass.
+  this->ogreCompositorNodeDefName = nodeDefName;
+
+  Ogre::CompositorNodeDef *nodeDef =
+      ogreCompMgr->addNodeDefinition(nodeDefName);
+
+  // Input texture
+  nodeDef->addTextureSourceName("rt_input", 0,
+      Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+  nodeDef->addTextureSourceName("rt_output", 1,
+      Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+
+  // rt_input target
+  nodeDef->setNumTargetPass(1);
+  Ogre::CompositorTargetDef *inputTargetDef =
+      nodeDef->addTargetPass("rt_output");
+  inputTargetDef->setNumPasses(1);
+  {
+    // quad pass
+    Ogre::CompositorPassQuadDef *passQuad =
+        static_cast<Ogre::CompositorPassQuadDef *>(
+        inputTargetDef->addPass(Ogre::PASS_QUAD));
+    passQuad->mMaterialName = nodeDefName;
+    passQuad->addQuadTextureSource(0, "rt_input", 0);
+  }
+  nodeDef->mapOutputChannel(0, "rt_output");
+  nodeDef->mapOutputChannel(1, "rt_input");
+}
+
+IGN_RENDERING_REGISTER_RENDER_PASS(Ogre2DropoutPass, DropoutPass)
@@ -25,12 +25,22 @@
 #pragma warning(pop)
 #endif
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
 #include "ignition/common/Console.hh"
+#include "ignition/rendering/MemoryTracker.hh"
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
 #include "ignition/rendering/ogre2/Ogre2DynamicRenderable.hh"
 #include "ignition/rendering/ogre2/Ogre2Material.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
+#include "ignition/rendering/ogre2/Ogre2Visual.hh"
 
 #ifdef _MSC_VER
   #pragma warning(push, 0)
@@ -50,8 +60,9 @@ class ignition::rendering::Ogre2DynamicRenderablePrivate
   /// \brief list of colors at each point
   public: std::vector<ignition::math::Color> colors;
 
-  /// \brief List of vertices for the mesh
-  public: std::vector<ignition::math::Vector3d> vertices;
+  /// \brief List of vertices for the mesh, in single precision like the
+  /// vertex buffer
+  public: std::vector<Ogre::Vector3> vertices;
 
   /// \brief Used to indicate if the lines require an update
   public: bool dirty = false;
@@ -85,7 +96,7 @@ class ignition::rendering::Ogre2DynamicRenderablePrivate
   public: bool ownsMaterial = false;
 
   /// \brief Pointer to scene
-  public: ScenePtr scene;
+  public: Ogre2ScenePtr scene;
 
   /// \brief Pointer to the ogre scene manager
   public: Ogre::SceneManager *sceneManager = nullptr;
@@ -100,10 +111,9 @@ Ogre2DynamicRenderable::Ogre2DynamicRenderable(
     ScenePtr _scene)
     : dataPtr(new Ogre2DynamicRenderablePrivate)
 {
-  this->dataPtr->scene = _scene;
+  this->dataPtr->scene = std::dynamic_pointer_cast<Ogre2Scene>(_scene);
 
-  Ogre2ScenePtr s = std::dynamic_pointer_cast<Ogre2Scene>(this->dataPtr->scene);
-  this->dataPtr->sceneManager = s->OgreSceneManager();
+  this->dataPtr->sceneManager = this->dataPtr->scene->OgreSceneManager();
 
   this->SetOperationType(MT_LINE_STRIP);
   this->CreateDynamicMesh();
@@ -141,7 +151,10 @@ void Ogre2DynamicRenderable::Destroy()
 void Ogre2DynamicRenderable::DestroyBuffer()
 {
   if (this->dataPtr->vbuffer)
+  {
+    MemoryTracker::Untrack(this->dataPtr->vbuffer);
     delete [] this->dataPtr->vbuffer;
+  }
 
   Ogre::RenderSystem *renderSystem =
       this->dataPtr->sceneManager->getDestinationRenderSystem();
@@ -193,6 +206,62 @@ void Ogre2DynamicRenderable::CreateDynamicMesh()
       this->dataPtr->sceneManager->createItem(mesh, Ogre::SCENE_DYNAMIC);
 }
 
+//////////////////////////////////////////////////
+/// \brief Write positions to an interleaved vertex buffer with zero
+/// normals and compute their bounds, 4 floats at a time when SSE is
+/// available
+/// \param[in] _vertices Vertex positions
+/// \param[in] _count Number of vertices
+/// \param[out] _vbuffer Vertex buffer, 6 floats per vertex
+/// \return Bounds of the vertices, null if there are none
+static Ogre::Aabb fillVertices(const Ogre::Vector3 *_vertices,
+    unsigned int _count, float *_vbuffer)
+{
+  Ogre::Aabb bbox;
+  unsigned int i = 0u;
+#if defined(__SSE2__) || defined(_M_X64)
+  if (_count > 1u)
+  {
+    // the 4th float loaded from each position is the first float of the
+    // next one, so the last vertex is left to the scalar loop
+    const __m128 mask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+    __m128 minimum = _mm_set1_ps(std::numeric_limits<float>::max());
+    __m128 maximum = _mm_set1_ps(-std::numeric_limits<float>::max());
+    for (; i + 1u < _count; ++i)
+    {
+      __m128 v = _mm_and_ps(_mm_loadu_ps(&_vertices[i].x), mask);
+      minimum = _mm_min_ps(minimum, v);
+      maximum = _mm_max_ps(maximum, v);
+      // position and the first normal component, then the rest of the
+      // normal
+      _mm_storeu_ps(_vbuffer + i * 6u, v);
+      _mm_storel_pi(reinterpret_cast<__m64 *>(_vbuffer + i * 6u + 4u),
+          _mm_setzero_ps());
+    }
+    float lo[4];
+    float hi[4];
+    _mm_storeu_ps(lo, minimum);
+    _mm_storeu_ps(hi, maximum);
+    bbox.merge(Ogre::Vector3(lo[0], lo[1], lo[2]));
+    bbox.merge(Ogre::Vector3(hi[0], hi[1], hi[2]));
+  }
+#endif
+  for (; i < _count; ++i)
+  {
+    unsigned int idx = i * 6u;
+    const Ogre::Vector3 &v = _vertices[i];
+    _vbuffer[idx] = v.x;
+    _vbuffer[idx+1] = v.y;
+    _vbuffer[idx+2] = v.z;
+    _vbuffer[idx+3] = 0;
+    _vbuffer[idx+4] = 0;
+    _vbuffer[idx+5] = 0;
+
+    bbox.merge(v);
+  }
+  return bbox;
+}
+
 //////////////////////////////////////////////////
 void Ogre2DynamicRenderable::UpdateBuffer()
 {
@@ -236,7 +305,8 @@ void Ogre2DynamicRenderable::UpdateBuffer()
   }
 
   // recreate vao if needed
-  if (newVertCapacity != this->dataPtr->vertexBufferCapacity)
+  bool vaoChanged = newVertCapacity != this->dataPtr->vertexBufferCapacity;
+  if (vaoChanged)
   {
     this->dataPtr->vertexBufferCapacity = newVertCapacity;
 
@@ -245,6 +315,8 @@ void Ogre2DynamicRenderable::UpdateBuffer()
     unsigned int size = this->dataPtr->vertexBufferCapacity * 6;
     this->dataPtr->vbuffer = new float[size];
     memset(this->dataPtr->vbuffer, 0, size * sizeof(float));
+    MemoryTracker::Track(MC_DYNAMIC_GEOMETRY, this->dataPtr->vbuffer,
+        size * sizeof(float));
 
     this->dataPtr->subMesh->mVao[Ogre::VpNormal].clear();
     this->dataPtr->subMesh->mVao[Ogre::VpShadow].clear();
@@ -275,56 +347,41 @@ void Ogre2DynamicRenderable::UpdateBuffer()
     this->dataPtr->subMesh->mVao[Ogre::VpShadow].push_back(this->dataPtr->vao);
   }
 
-  // map buffer and update the geometry
-  Ogre::Aabb bbox;
-  float * RESTRICT_ALIAS vertices = reinterpret_cast<float * RESTRICT_ALIAS>(
-      this->dataPtr->vertexBuffer->map(
-      0, this->dataPtr->vertexBuffer->getNumElements()));
-
-  // fill vertices
-  for (unsigned int i = 0; i < vertexCount; ++i)
-  {
-    unsigned int idx = i*6;
-    Ogre::Vector3 v = Ogre2Conversions::Convert(this->dataPtr->vertices[i]);
-    vertices[idx] = v.x;
-    vertices[idx+1] = v.y;
-    vertices[idx+2] = v.z;
-
-    bbox.merge(v);
-  }
-
-  // fill the rest of the buffer with the position of the last vertex to avoid
-  // the geometry connecting back to 0, 0, 0
-  if (vertexCount > 0 && vertexCount < this->dataPtr->vertexBufferCapacity)
-  {
-    math::Vector3d lastVertex = this->dataPtr->vertices[vertexCount-1];
-    for (unsigned int i = vertexCount; i < this->dataPtr->vertexBufferCapacity;
-        ++i)
-    {
-      unsigned int idx = i * 6;
-      vertices[idx] = lastVertex.X();
-      vertices[idx+1] = lastVertex.Y();
-      vertices[idx+2] = lastVertex.Z();
-
-      vertices[idx+3] = 0;
-      vertices[idx+4] = 0;
-      vertices[idx+5] = 1;
-    }
-  }
+  // fill the vertices in cpu memory first. The vertex buffer is
+  // persistently mapped and ogre cycles through one region of it per frame
+  // in flight, so writing to it does not wait for the gpu. Its memory is
+  // not meant to be read back though, so normals are generated here and the
+  // result is copied to the buffer in one go.
+  float *vbuffer = this->dataPtr->vbuffer;
+  Ogre::Aabb bbox = fillVertices(this->dataPtr->vertices.data(), vertexCount,
+      vbuffer);
 
   // fill normals
   this->GenerateNormals(this->dataPtr->operationType, this->dataPtr->vertices,
-      vertices);
+      vbuffer);
+
+  // map the part of the buffer in use and update the geometry
+  float * RESTRICT_ALIAS vertices = reinterpret_cast<float * RESTRICT_ALIAS>(
+      this->dataPtr->vertexBuffer->map(0, std::max(vertexCount, 1u)));
+  memcpy(vertices, vbuffer, vertexCount * 6 * sizeof(float));
 
   // unmap buffer
   this->dataPtr->vertexBuffer->unmap(Ogre::UO_KEEP_PERSISTENT);
 
+  // only draw the vertices in use rather than the whole capacity of the
+  // buffer, so the unused tail does not need to be filled
+  this->dataPtr->vao->setPrimitiveRange(0, vertexCount);
+
   // Set the bounds to get frustum culling and LOD to work correctly.
   Ogre::Mesh *mesh = this->dataPtr->subMesh->mParent;
   mesh->_setBounds(bbox, true);
 
   // update item aabb
-  if (this->dataPtr->ogreItem)
+  if (this->dataPtr->ogreItem && !vaoChanged)
+  {
+    this->dataPtr->ogreItem->setLocalAabb(bbox);
+  }
+  else if (this->dataPtr->ogreItem)
   {
     // need to rebuild ogre [sub]item because the vao was destroyed
     // this updates the item's bounding box and fixes occasional crashes
@@ -334,14 +391,27 @@ void Ogre2DynamicRenderable::UpdateBuffer()
     // set material
     if (this->dataPtr->material)
     {
-      this->dataPtr->ogreItem->getSubItem(0)->setDatablock(
-          static_cast<Ogre::HlmsPbsDatablock *>(
-          this->dataPtr->material->Datablock()));
+      this->dataPtr->material->BindDatablock(
+          this->dataPtr->ogreItem->getSubItem(0));
       this->dataPtr->ogreItem->setCastShadows(
           this->dataPtr->material->CastShadows());
     }
   }
 
+  // the cached bounding boxes of the visual holding the geometry are stale
+  if (this->dataPtr->ogreItem)
+  {
+    Ogre::Any userAny =
+        this->dataPtr->ogreItem->getUserObjectBindings().getUserAny();
+    if (!userAny.isEmpty() && userAny.getType() == typeid(unsigned int))
+    {
+      Ogre2VisualPtr visual = this->dataPtr->scene->OgreVisualById(
+          Ogre::any_cast<unsigned int>(userAny));
+      if (visual)
+        visual->SetBoundsDirty();
+    }
+  }
+
   this->dataPtr->dirty = false;
 }
 
@@ -419,7 +489,7 @@ MarkerType Ogre2DynamicRenderable::OperationType() const
 void Ogre2DynamicRenderable::AddPoint(const ignition::math::Vector3d &_pt,
                                       const ignition::math::Color &_color)
 {
-  this->dataPtr->vertices.push_back(_pt);
+  this->dataPtr->vertices.push_back(Ogre2Conversions::Convert(_pt));
 
   // todo(anyone)
   // setting material works but vertex coloring does not work yet.
@@ -437,6 +507,39 @@ void Ogre2DynamicRenderable::AddPoint(double _x, double _y, double _z,
   this->AddPoint(ignition::math::Vector3d(_x, _y, _z), _color);
 }
 
+/////////////////////////////////////////////////
+void Ogre2DynamicRenderable::SetPoints(const float *_xyz, size_t _count,
+                                       const float *_rgba)
+{
+  if (!_xyz && _count > 0u)
+  {
+    ignerr << "Null point positions" << std::endl;
+    return;
+  }
+
+  this->dataPtr->vertices.resize(_count);
+  Ogre2Conversions::Convert(_xyz, _count, this->dataPtr->vertices.data());
+
+  // todo(anyone)
+  // vertex coloring does not work yet. It requires using an unlit datablock:
+  // https://forums.ogre3d.org/viewtopic.php?t=93627#p539276
+  this->dataPtr->colors.resize(_count);
+  for (size_t i = 0; i < _count; ++i)
+  {
+    if (_rgba)
+    {
+      this->dataPtr->colors[i].Set(_rgba[i * 4u], _rgba[i * 4u + 1u],
+          _rgba[i * 4u + 2u], _rgba[i * 4u + 3u]);
+    }
+    else
+    {
+      this->dataPtr->colors[i] = ignition::math::Color::White;
+    }
+  }
+
+  this->dataPtr->dirty = true;
+}
+
 /////////////////////////////////////////////////
 void Ogre2DynamicRenderable::SetPoint(unsigned int _index,
                                       const ignition::math::Vector3d &_value)
@@ -448,7 +551,7 @@ void Ogre2DynamicRenderable::SetPoint(unsigned int _index,
     return;
   }
 
-  this->dataPtr->vertices[_index] = _value;
+  this->dataPtr->vertices[_index] = Ogre2Conversions::Convert(_value);
 
   this->dataPtr->dirty = true;
 }
@@ -488,7 +591,7 @@ ignition::math::Vector3d Ogre2DynamicRenderable::Point(
                                     ignition::math::INF_D);
   }
 
-  return this->dataPtr->vertices[_index];
+  return Ogre2Conversions::Convert(this->dataPtr->vertices[_index]);
 }
 
 /////////////////////////////////////////////////
@@ -531,8 +634,7 @@ void Ogre2DynamicRenderable::SetMaterial(MaterialPtr _material, bool _unique)
 
   this->dataPtr->material = derived;
 
-  this->dataPtr->ogreItem->getSubItem(0)->setDatablock(
-      static_cast<Ogre::HlmsPbsDatablock *>(derived->Datablock()));
+  derived->BindDatablock(this->dataPtr->ogreItem->getSubItem(0));
 
   // set cast shadows
   this->dataPtr->ogreItem->setCastShadows(_material->CastShadows());
@@ -540,7 +642,7 @@ void Ogre2DynamicRenderable::SetMaterial(MaterialPtr _material, bool _unique)
 
 //////////////////////////////////////////////////
 void Ogre2DynamicRenderable::GenerateNormals(Ogre::OperationType _opType,
-  const std::vector<math::Vector3d> &_vertices, float *_vbuffer)
+  const std::vector<Ogre::Vector3> &_vertices, float *_vbuffer)
 {
   unsigned int vertexCount = _vertices.size();
   // Each vertex occupies 6 elements in the vbuffer float array:
@@ -567,20 +669,20 @@ void Ogre2DynamicRenderable::GenerateNormals(Ogre::OperationType _opType,
         unsigned int idx1 = idx * 6;
         unsigned int idx2 = idx1 + 6;
         unsigned int idx3 = idx2 + 6;
-        math::Vector3d v1 = _vertices[idx];
-        math::Vector3d v2 = _vertices[idx+1];
-        math::Vector3d v3 = _vertices[idx+2];
-        math::Vector3d n = (v1 - v2).Cross((v1 - v3));
-
-        _vbuffer[idx1+3] = n.X();
-        _vbuffer[idx1+4] = n.Y();
-        _vbuffer[idx1+5] = n.Z();
-        _vbuffer[idx2+3] = n.X();
-        _vbuffer[idx2+4] = n.Y();
-        _vbuffer[idx2+5] = n.Z();
-        _vbuffer[idx3+3] = n.X();
-        _vbuffer[idx3+4] = n.Y();
-        _vbuffer[idx3+5] = n.Z();
+        Ogre::Vector3 v1 = _vertices[idx];
+        Ogre::Vector3 v2 = _vertices[idx+1];
+        Ogre::Vector3 v3 = _vertices[idx+2];
+        Ogre::Vector3 n = (v1 - v2).crossProduct((v1 - v3));
+
+        _vbuffer[idx1+3] = n.x;
+        _vbuffer[idx1+4] = n.y;
+        _vbuffer[idx1+5] = n.z;
+        _vbuffer[idx2+3] = n.x;
+        _vbuffer[idx2+4] = n.y;
+        _vbuffer[idx2+5] = n.z;
+        _vbuffer[idx3+3] = n.x;
+        _vbuffer[idx3+4] = n.y;
+        _vbuffer[idx3+5] = n.z;
       }
 
       break;
@@ -593,9 +695,9 @@ void Ogre2DynamicRenderable::GenerateNormals(Ogre::OperationType _opType,
       bool even = false;
       for (unsigned int i = 0; i < vertexCount - 2; ++i)
       {
-        math::Vector3d v1;
-        math::Vector3d v2;
-        math::Vector3d v3 = _vertices[i+2];
+        Ogre::Vector3 v1;
+        Ogre::Vector3 v2;
+        Ogre::Vector3 v3 = _vertices[i+2];
 
         // For odd n, vertices n, n+1, and n+2 define triangle n.
         // For even n, vertices n+1, n, and n+2 define triangle n.
@@ -618,27 +720,27 @@ void Ogre2DynamicRenderable::GenerateNormals(Ogre::OperationType _opType,
         }
         even = !even;
 
-        math::Vector3d n = (v1 - v2).Cross((v1 - v3));
-        math::Vector3d n1(_vbuffer[idx1+3], _vbuffer[idx1+4], _vbuffer[idx1+5]);
-        math::Vector3d n2(_vbuffer[idx2+3], _vbuffer[idx2+4], _vbuffer[idx2+5]);
-        math::Vector3d n3(_vbuffer[idx3+3], _vbuffer[idx3+4], _vbuffer[idx3+5]);
-
-        math::Vector3d n1a = ((n1 + n)/2);
-        n1a.Normalize();
-        math::Vector3d n2a = ((n2 + n)/2);
-        n2a.Normalize();
-        math::Vector3d n3a = ((n3 + n)/2);
-        n3a.Normalize();
-
-        _vbuffer[idx1+3] = n1a.X();
-        _vbuffer[idx1+4] = n1a.Y();
-        _vbuffer[idx1+5] = n1a.Z();
-        _vbuffer[idx2+3] = n2a.X();
-        _vbuffer[idx2+4] = n2a.Y();
-        _vbuffer[idx2+5] = n2a.Z();
-        _vbuffer[idx3+3] = n3a.X();
-        _vbuffer[idx3+4] = n3a.Y();
-        _vbuffer[idx3+5] = n3a.Z();
+        Ogre::Vector3 n = (v1 - v2).crossProduct((v1 - v3));
+        Ogre::Vector3 n1(_vbuffer[idx1+3], _vbuffer[idx1+4], _vbuffer[idx1+5]);
+        Ogre::Vector3 n2(_vbuffer[idx2+3], _vbuffer[idx2+4], _vbuffer[idx2+5]);
+        Ogre::Vector3 n3(_vbuffer[idx3+3], _vbuffer[idx3+4], _vbuffer[idx3+5]);
+
+        Ogre::Vector3 n1a = ((n1 + n)/2);
+        n1a.normalise();
+        Ogre::Vector3 n2a = ((n2 + n)/2);
+        n2a.normalise();
+        Ogre::Vector3 n3a = ((n3 + n)/2);
+        n3a.normalise();
+
+        _vbuffer[idx1+3] = n1a.x;
+        _vbuffer[idx1+4] = n1a.y;
+        _vbuffer[idx1+5] = n1a.z;
+        _vbuffer[idx2+3] = n2a.x;
+        _vbuffer[idx2+4] = n2a.y;
+        _vbuffer[idx2+5] = n2a.z;
+        _vbuffer[idx3+3] = n3a.x;
+        _vbuffer[idx3+4] = n3a.y;
+        _vbuffer[idx3+5] = n3a.z;
       }
 
       break;
@@ -649,36 +751,36 @@ void Ogre2DynamicRenderable::GenerateNormals(Ogre::OperationType _opType,
         return;
 
       unsigned int idx1 = 0;
-      math::Vector3d v1 = _vertices[0];
+      Ogre::Vector3 v1 = _vertices[0];
 
       for (unsigned int i = 0; i < vertexCount - 2; ++i)
       {
         unsigned int idx2 = (i+1) * 6;
         unsigned int idx3 = idx2 + 6;
-        math::Vector3d v2 = _vertices[i+1];
-        math::Vector3d v3 = _vertices[i+2];
-        math::Vector3d n = (v1 - v2).Cross((v1 - v3));
-
-        math::Vector3d n1(_vbuffer[idx1+3], _vbuffer[idx1+4], _vbuffer[idx1+5]);
-        math::Vector3d n2(_vbuffer[idx2+3], _vbuffer[idx2+4], _vbuffer[idx2+5]);
-        math::Vector3d n3(_vbuffer[idx3+3], _vbuffer[idx3+4], _vbuffer[idx3+5]);
-
-        math::Vector3d n1a = ((n1 + n)/2);
-        n1a.Normalize();
-        math::Vector3d n2a = ((n2 + n)/2);
-        n2a.Normalize();
-        math::Vector3d n3a = ((n3 + n)/2);
-        n3a.Normalize();
-
-        _vbuffer[idx1+3] = n1a.X();
-        _vbuffer[idx1+4] = n1a.Y();
-        _vbuffer[idx1+5] = n1a.Z();
-        _vbuffer[idx2+3] = n2a.X();
-        _vbuffer[idx2+4] = n2a.Y();
-        _vbuffer[idx2+5] = n2a.Z();
-        _vbuffer[idx3+3] = n3a.X();
-        _vbuffer[idx3+4] = n3a.Y();
-        _vbuffer[idx3+5] = n3a.Z();
+        Ogre::Vector3 v2 = _vertices[i+1];
+        Ogre::Vector3 v3 = _vertices[i+2];
+        Ogre::Vector3 n = (v1 - v2).crossProduct((v1 - v3));
+
+        Ogre::Vector3 n1(_vbuffer[idx1+3], _vbuffer[idx1+4], _vbuffer[idx1+5]);
+        Ogre::Vector3 n2(_vbuffer[idx2+3], _vbuffer[idx2+4], _vbuffer[idx2+5]);
+        Ogre::Vector3 n3(_vbuffer[idx3+3], _vbuffer[idx3+4], _vbuffer[idx3+5]);
+
+        Ogre::Vector3 n1a = ((n1 + n)/2);
+        n1a.normalise();
+        Ogre::Vector3 n2a = ((n2 + n)/2);
+        n2a.normalise();
+        Ogre::Vector3 n3a = ((n3 + n)/2);
+        n3a.normalise();
+
+        _vbuffer[idx1+3] = n1a.x;
+        _vbuffer[idx1+4] = n1a.y;
+        _vbuffer[idx1+5] = n1a.z;
+        _vbuffer[idx2+3] = n2a.x;
+        _vbuffer[idx2+4] = n2a.y;
+        _vbuffer[idx2+5] = n2a.z;
+        _vbuffer[idx3+3] = n3a.x;
+        _vbuffer[idx3+4] = n3a.y;
+        _vbuffer[idx3+5] = n3a.z;
       }
 
       break;
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Not Apple or Windows
+#if !defined(__APPLE__) && !defined(_WIN32)
+# ifndef GL_GLEXT_PROTOTYPES
+#  define GL_GLEXT_PROTOTYPES
+# endif
+# include <GL/gl.h>
+# include <GL/glext.h>
+# define IGN_OGRE2_FRAME_FENCES 1
+#endif
+
+#include <cstdint>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/Profiler.hh"
+
+#include "Ogre2FrameLimiter.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Time to wait for a frame to complete before giving up on it, in
+/// nanoseconds
+static const uint64_t kFenceTimeout = 1000000000u;
+
+//////////////////////////////////////////////////
+Ogre2FrameLimiter::~Ogre2FrameLimiter()
+{
+  this->Reset();
+}
+
+//////////////////////////////////////////////////
+bool Ogre2FrameLimiter::Supported()
+{
+#ifdef IGN_OGRE2_FRAME_FENCES
+  return true;
+#else
+  return false;
+#endif
+}
+
+//////////////////////////////////////////////////
+void Ogre2FrameLimiter::FrameSwapped(unsigned int _maxFrames)
+{
+#ifdef IGN_OGRE2_FRAME_FENCES
+  if (_maxFrames == 0u)
+  {
+    this->Reset();
+    return;
+  }
+
+  IGN_RENDERING_PROFILE("Ogre2FrameLimiter::FrameSwapped");
+  this->fences.push_back(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+  while (this->fences.size() > _maxFrames)
+  {
+    GLsync fence = static_cast<GLsync>(this->fences.front());
+    this->fences.pop_front();
+    GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+        kFenceTimeout);
+    if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED)
+    {
+      ignwarn << "Timed out waiting for a frame of a render window to "
+              << "complete" << std::endl;
+    }
+    glDeleteSync(fence);
+  }
+#else
+  (void) _maxFrames;
+#endif
+}
+
+//////////////////////////////////////////////////
+void Ogre2FrameLimiter::Reset()
+{
+#ifdef IGN_OGRE2_FRAME_FENCES
+  for (void *fence : this->fences)
+    glDeleteSync(static_cast<GLsync>(fence));
+#endif
+  this->fences.clear();
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2FRAMELIMITER_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2FRAMELIMITER_HH_
+
+#include <deque>
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Limits the number of frames of a render window whose GPU
+    /// commands have not completed with GL fences. A fence is inserted
+    /// after each frame is swapped, and the CPU waits on the oldest one
+    /// above the limit, so it never queues more frames than the limit ahead
+    /// of the GPU.
+    class Ogre2FrameLimiter
+    {
+      /// \brief Constructor
+      public: Ogre2FrameLimiter() = default;
+
+      /// \brief Destructor, deletes the fences left
+      public: ~Ogre2FrameLimiter();
+
+      /// \brief Check if fences are supported by the current platform
+      /// \return True if supported
+      public: static bool Supported();
+
+      /// \brief Mark the end of the frame just swapped and wait for the
+      /// frames above the limit to complete
+      /// \param[in] _maxFrames Maximum number of frames in flight, 0 to not
+      /// limit them
+      public: void FrameSwapped(unsigned int _maxFrames);
+
+      /// \brief Delete the fences without waiting for them
+      public: void Reset();
+
+      /// \brief Fences of the frames in flight, oldest first
+      private: std::deque<void *> fences;
+    };
+    }
+  }
+}
+#endif
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <string>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/RenderPassSystem.hh"
+#include "ignition/rendering/ogre2/Ogre2FxaaPass.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <Compositor/OgreCompositorManager2.h>
+#include <Compositor/OgreCompositorNodeDef.h>
+#include <Compositor/Pass/PassQuad/OgreCompositorPassQuadDef.h>
+#include <OgreMaterial.h>
+#include <OgreMaterialManager.h>
+#include <OgrePass.h>
+#include <OgreRoot.h>
+#include <OgreTechnique.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+/// \brief Private data for the Ogre2FxaaPass class
+class ignition::rendering::Ogre2FxaaPassPrivate
+{
+  /// brief Pointer to the FXAA ogre material
+  public: Ogre::Material *fxaaMat = nullptr;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+Ogre2FxaaPass::Ogre2FxaaPass()
+  : dataPtr(std::make_unique<Ogre2FxaaPassPrivate>())
+{
+}
+
+//////////////////////////////////////////////////
+Ogre2FxaaPass::~Ogre2FxaaPass()
+{
+}
+
+//////////////////////////////////////////////////
+void Ogre2FxaaPass::PreRender()
+{
+  if (!this->dataPtr->fxaaMat)
+    return;
+
+  if (!this->enabled)
+    return;
+
+  // These parameters are declared in media/materials/scripts/fxaa.material
+  // and media/materials/programs/fxaa_fs.glsl
+  Ogre::Pass *pass = this->dataPtr->fxaaMat->getTechnique(0)->getPass(0);
+  Ogre::GpuProgramParametersSharedPtr psParams =
+      pass->getFragmentProgramParameters();
+  psParams->setNamedConstant("subpixelQuality",
+      static_cast<Ogre::Real>(this->subpixelQuality));
+  psParams->setNamedConstant("edgeThreshold",
+      static_cast<Ogre::Real>(this->edgeThreshold));
+  psParams->setNamedConstant("edgeThresholdMin",
+      static_cast<Ogre::Real>(this->edgeThresholdMin));
+}
+
+//////////////////////////////////////////////////
+void Ogre2FxaaPass::CreateRenderPass()
+{
+  static int fxaaNodeCounter = 0;
+
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
+
+  if (!this->ogreCompositorNodeDefName.empty() &&
+      ogreCompMgr->hasNodeDefinition(this->ogreCompositorNodeDefName))
+    return;
+
+  std::string nodeDefName = "FxaaNode_" + std::to_string(fxaaNodeCounter++);
+
+  // The Fxaa material is defined in script (fxaa.material).
+  // clone the material
+  std::string matName = "Fxaa";
+  Ogre::MaterialPtr ogreMat =
+      Ogre::MaterialManager::getSingleton().getByName(matName);
+  if (!ogreMat)
+  {
+    ignerr << "FXAA material not found: '" << matName << "'" << std::endl;
+    return;
+  }
+  if (!ogreMat->isLoaded())
+    ogreMat->load();
+  this->dataPtr->fxaaMat = ogreMat->clone(nodeDefName).get();
+
+  // The node is the same as the one of Ogre2GaussianNoisePass: the result
+  // is drawn to rt_output and the render textures are swapped for the next
+  // pass.
+  this->ogreCompositorNodeDefName = nodeDefName;
+
+  Ogre::CompositorNodeDef *nodeDef =
+      ogreCompMgr->addNodeDefinition(nodeDefName);
+
+  // Input texture
+  nodeDef->addTextureSourceName("rt_input", 0,
+      Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+  nodeDef->addTextureSourceName("rt_output", 1,
+      Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+
+  // rt_input target
+  nodeDef->setNumTargetPass(1);
+  Ogre::CompositorTargetDef *inputTargetDef =
+      nodeDef->addTargetPass("rt_output");
+  inputTargetDef->setNumPasses(1);
+  {
+    // quad pass
+    Ogre::CompositorPassQuadDef *passQuad =
+        static_cast<Ogre::CompositorPassQuadDef *>(
+        inputTargetDef->addPass(Ogre::PASS_QUAD));
+    passQuad->mMaterialName = nodeDefName;
+    passQuad->addQuadTextureSource(0, "rt_input", 0);
+  }
+  nodeDef->mapOutputChannel(0, "rt_output");
+  nodeDef->mapOutputChannel(1, "rt_input");
+}
+
+IGN_RENDERING_REGISTER_RENDER_PASS(Ogre2FxaaPass, FxaaPass)
@@ -16,6 +16,9 @@
  */
 
 
+#include <sstream>
+#include <string>
+
 #include <ignition/common/Console.hh>
 
 #include "ignition/rendering/RenderPassSystem.hh"
@@ -43,6 +46,9 @@ class ignition::rendering::Ogre2GaussianNoisePassPrivate
 {
   /// brief Pointer to the Gaussian noise ogre material
   public: Ogre::Material *gaussianNoiseMat = nullptr;
+
+  /// \brief Number of frames rendered, counter of the seeded noise
+  public: unsigned int frame = 0u;
 };
 
 using namespace ignition;
@@ -73,22 +79,108 @@ void Ogre2GaussianNoisePass::PreRender()
 
   // Sample three values within the range [0,1.0] and set them for use in
   // the fragment shader, which will interpret them as offsets from (0,0)
-  // to use when computing pseudo-random values.
-  Ogre::Vector3 offsets(ignition::math::Rand::DblUniform(0.0, 1.0),
-                        ignition::math::Rand::DblUniform(0.0, 1.0),
-                        ignition::math::Rand::DblUniform(0.0, 1.0));
+  // to use when computing pseudo-random values. Seeded passes generate
+  // their noise on the GPU from the frame number instead.
+  Ogre::Vector3 offsets(Ogre::Vector3::ZERO);
+  if (this->seed == 0u)
+  {
+    offsets = Ogre::Vector3(ignition::math::Rand::DblUniform(0.0, 1.0),
+                            ignition::math::Rand::DblUniform(0.0, 1.0),
+                            ignition::math::Rand::DblUniform(0.0, 1.0));
+  }
   // These calls are setting parameters that are declared in two places:
   // 1. media/materials/scripts/gaussian_noise.material, in
   //    fragment_program GaussianNoiseFS
   // 2. media/materials/scripts/gaussian_noise_fs.glsl
-  Ogre::Pass *pass =
-      this->dataPtr->gaussianNoiseMat->getTechnique(0)->getPass(0);
+  // When fused with other passes, the same parameters are prefixed in the
+  // shader generated from FusedShaderCode
+  Ogre::Material *material = this->dataPtr->gaussianNoiseMat;
+  std::string prefix;
+  if (this->FusedMaterial())
+  {
+    material = this->FusedMaterial();
+    prefix = this->FusedShaderPrefix();
+  }
+  Ogre::Pass *pass = material->getTechnique(0)->getPass(0);
   Ogre::GpuProgramParametersSharedPtr psParams =
       pass->getFragmentProgramParameters();
-  psParams->setNamedConstant("offsets", offsets);
-  psParams->setNamedConstant("mean", static_cast<Ogre::Real>(this->mean));
-  psParams->setNamedConstant("stddev",
+  psParams->setNamedConstant(prefix + "offsets", offsets);
+  psParams->setNamedConstant(prefix + "mean",
+      static_cast<Ogre::Real>(this->mean));
+  psParams->setNamedConstant(prefix + "stddev",
       static_cast<Ogre::Real>(this->stdDev));
+  psParams->setNamedConstant(prefix + "seed", static_cast<int>(this->seed));
+  psParams->setNamedConstant(prefix + "frame",
+      static_cast<int>(this->dataPtr->frame++));
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2GaussianNoisePass::FusedShaderCode(
+    const std::string &_prefix) const
+{
+  // Same noise as media/materials/programs/gaussian_noise_fs.glsl, see
+  // there for the details
+  const std::string &p = _prefix;
+  std::stringstream code;
+  code << "uniform vec3 " << p << "offsets;\n"
+       << "uniform float " << p << "mean;\n"
+       << "uniform float " << p << "stddev;\n"
+       << "uniform int " << p << "seed;\n"
+       << "uniform int " << p << "frame;\n"
+       << "float " << p << "rand(vec2 co)\n"
+       << "{\n"
+       << "  float r = fract(sin(dot(co.xy, vec2(12.9898,78.233))) * "
+       << "43758.5453);\n"
+       << "  return (r == 0.0) ? 0.000000000001 : r;\n"
+       << "}\n"
+       << "uvec2 " << p << "mulhilo(uint a, uint b)\n"
+       << "{\n"
+       << "  uint a0 = a & 0xFFFFu;\n"
+       << "  uint a1 = a >> 16u;\n"
+       << "  uint b0 = b & 0xFFFFu;\n"
+       << "  uint b1 = b >> 16u;\n"
+       << "  uint t = a1 * b0 + ((a0 * b0) >> 16u);\n"
+       << "  uint w = (t & 0xFFFFu) + a0 * b1;\n"
+       << "  return uvec2(a1 * b1 + (t >> 16u) + (w >> 16u), a * b);\n"
+       << "}\n"
+       << "uvec2 " << p << "philox(uvec2 ctr, uint key)\n"
+       << "{\n"
+       << "  for (int i = 0; i < 10; ++i)\n"
+       << "  {\n"
+       << "    uvec2 hilo = " << p << "mulhilo(0xD256D193u, ctr.x);\n"
+       << "    ctr = uvec2(hilo.x ^ key ^ ctr.y, hilo.y);\n"
+       << "    key += 0x9E3779B9u;\n"
+       << "  }\n"
+       << "  return ctr;\n"
+       << "}\n"
+       << "vec4 " << p << "Apply(vec4 color, vec2 uv)\n"
+       << "{\n"
+       << "  float U, V, R;\n"
+       << "  if (" << p << "seed != 0)\n"
+       << "  {\n"
+       << "    uvec2 pixel = uvec2(gl_FragCoord.xy);\n"
+       << "    uvec2 r = " << p << "philox(uvec2(pixel.x | (pixel.y << 16u),"
+       << " uint(" << p << "frame)), uint(" << p << "seed));\n"
+       << "    U = (float(r.x >> 8u) + 1.0) / 16777216.0;\n"
+       << "    V = float(r.y >> 8u) / 16777216.0;\n"
+       << "    R = 1.0;\n"
+       << "  }\n"
+       << "  else\n"
+       << "  {\n"
+       << "    U = " << p << "rand(uv + vec2(" << p << "offsets.x));\n"
+       << "    V = " << p << "rand(uv + vec2(" << p << "offsets.y));\n"
+       << "    R = " << p << "rand(uv + vec2(" << p << "offsets.z));\n"
+       << "  }\n"
+       << "  float z = sqrt(-2.0 * log(U)) * ((R < 0.5) ?\n"
+       << "      sin(6.28318530717958647692 * V) :\n"
+       << "      cos(6.28318530717958647692 * V));\n"
+       << "  z = z * " << p << "stddev + " << p << "mean;\n"
+       << "  float n = pow(abs(z), 2.1);\n"
+       << "  if (z < 0.0)\n"
+       << "    n = -n;\n"
+       << "  return clamp(color + vec4(n, n, n, 0.0), 0.0, 1.0);\n"
+       << "}\n";
+  return code.str();
 }
 
 //////////////////////////////////////////////////
@@ -49,3 +49,9 @@ void Ogre2Geometry::SetParent(Ogre2VisualPtr _parent)
 {
   this->parent = _parent;
 }
+
+//////////////////////////////////////////////////
+math::Vector3d Ogre2Geometry::OgreObjectOffset() const
+{
+  return math::Vector3d::Zero;
+}
@@ -15,15 +15,37 @@
  *
 */
 
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include <ignition/math/Vector2.hh>
 #include <ignition/math/Vector3.hh>
 
 #include <ignition/common/Console.hh>
 #include <ignition/math/Helpers.hh>
+#include <ignition/math/Rand.hh>
 
 #include "ignition/rendering/ogre2/Ogre2Camera.hh"
 #include "ignition/rendering/ogre2/Ogre2GpuRays.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+#include "ignition/rendering/DropoutPass.hh"
+#include "ignition/rendering/GaussianNoisePass.hh"
+#include "ignition/rendering/MemoryTracker.hh"
+#include "ignition/rendering/Profiler.hh"
 #include "ignition/rendering/RenderTypes.hh"
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
 #include "ignition/rendering/ogre2/Ogre2ParticleEmitter.hh"
@@ -34,6 +56,10 @@
 #include "ignition/rendering/ogre2/Ogre2Visual.hh"
 
 #include "Ogre2ParticleNoiseListener.hh"
+#include "Ogre2ReadbackManager.hh"
+#include "Ogre2GpuTimer.hh"
+#include "Ogre2SensorVisibilityListener.hh"
+#include "Ogre2SharedDefinitions.hh"
 
 #ifdef _MSC_VER
   #pragma warning(push, 0)
@@ -61,6 +87,136 @@ namespace rendering
 {
 inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
 //
+/// \brief Laser retro values of the items in a scene. The values are
+/// decoded from the user data of the visuals at most once per frame and
+/// shared by all the laser retro material switchers of the scene.
+class Ogre2LaserRetroItems
+{
+  /// \brief constructor
+  /// \param[in] _scene the scene manager responsible for rendering
+  public: explicit Ogre2LaserRetroItems(Ogre2ScenePtr _scene);
+
+  /// \brief Get the laser retro items of a scene, shared by all its callers
+  /// \param[in] _scene the scene manager responsible for rendering
+  /// \return Laser retro items of the scene
+  public: static std::shared_ptr<Ogre2LaserRetroItems> Instance(
+      Ogre2ScenePtr _scene);
+
+  /// \brief Update the laser retro items if this has not been done yet
+  /// in the current frame
+  public: void Update();
+
+  /// \brief Get all items that have a laser retro value. Only valid
+  /// until the end of the current frame.
+  /// \return Items with a laser retro value
+  public: const std::vector<Ogre::Item *> &Items() const;
+
+  /// \brief Laser retro value of an item derived from the user data of its
+  /// visual
+  private: struct ItemState
+  {
+    /// \brief Visual the item belongs to
+    std::weak_ptr<Ogre2Visual> visual;
+
+    /// \brief Id of the visual the item belongs to
+    unsigned int visualId = 0u;
+
+    /// \brief User data version of the visual when the state was updated
+    unsigned int userDataVersion = 0u;
+
+    /// \brief Normalized laser retro value. Negative if the item has none
+    float color = -1.0f;
+
+    /// \brief Value of traversal the last time the item was updated
+    unsigned int traversal = 0u;
+  };
+
+  /// \brief Update the laser retro value of an item from the user data of
+  /// its visual
+  /// \param[in] _item Item to update
+  /// \param[in] _visualId Id of the visual the item belongs to
+  /// \param[in,out] _state State to update
+  private: void UpdateItemState(Ogre::Item *_item, unsigned int _visualId,
+      ItemState &_state);
+
+  /// \brief Scene manager
+  private: Ogre2ScenePtr scene = nullptr;
+
+  /// \brief Custom parameter index of laser retro value in an ogre subitem.
+  /// This has to match the custom index specifed in LaserRetroSource material
+  /// script in media/materials/scripts/gpu_rays.material
+  private: const unsigned int customParamIdx = 10u;
+
+  /// \brief Visibility flag of items rendered in the laser retro pass
+  private: const uint32_t visibilityFlags = 0x01000000;
+
+  /// \brief Cached laser retro values of all items seen so far.
+  /// The key is the item's ID.
+  private: std::unordered_map<Ogre::IdType, ItemState> itemStates;
+
+  /// \brief Items with a laser retro value in the current frame
+  private: std::vector<Ogre::Item *> items;
+
+  /// \brief Ogre frame number of the last update
+  private: unsigned long frame = std::numeric_limits<unsigned long>::max();
+
+  /// \brief Number of updates. Used to find items that no longer exist
+  private: unsigned int traversal = 0u;
+};
+
+/// \brief Texture packed with the cubemap face and uv coordinates sampled by
+/// each ray of a gpu rays sensor. Sensors with the same angle ranges and ray
+/// counts share the same texture.
+class Ogre2GpuRaysSampleTexture
+{
+  /// \brief Angle ranges in radians and ray counts of a texture:
+  /// min and max horizontal angle, min and max vertical angle, horizontal
+  /// and vertical ray count, and the horizontal and vertical angle of each
+  /// ray if they are set explicitly
+  public: using Key = std::tuple<double, double, double, double,
+      unsigned int, unsigned int, std::vector<double>>;
+
+  /// \brief destructor, releases the texture
+  public: ~Ogre2GpuRaysSampleTexture();
+
+  /// \brief Get the sample texture of a ray configuration, shared by all
+  /// its callers. The texture is null until the first caller fills it.
+  /// \param[in] _key Angle ranges and ray counts
+  /// \return Sample texture of the ray configuration
+  public: static std::shared_ptr<Ogre2GpuRaysSampleTexture> Instance(
+      const Key &_key);
+
+  /// \brief Texture packed with cubemap face and uv data
+  public: Ogre::TexturePtr texture;
+
+  /// \brief Set of cubemap faces sampled by the rays
+  public: std::set<unsigned int> faces;
+
+  /// \brief Region of a cubemap face sampled by the rays, in pixels of the
+  /// 1st pass textures. Right and bottom are exclusive.
+  public: struct Region
+  {
+    /// \brief Left pixel
+    unsigned int left = 0u;
+
+    /// \brief Top pixel
+    unsigned int top = 0u;
+
+    /// \brief Right pixel
+    unsigned int right = 0u;
+
+    /// \brief Bottom pixel
+    unsigned int bottom = 0u;
+  };
+
+  /// \brief Region of each cubemap face sampled by the rays. The u and v
+  /// coordinates packed in the texture are relative to these regions.
+  public: Region regions[6];
+
+  /// \brief Cubemap faces sampled by each column of rays, one bit per face
+  public: std::vector<uint8_t> columnFaces;
+};
+
 /// \brief Helper class for switching the ogre item's material to laser retro
 /// source material when a thermal camera is being rendered.
 class Ogre2LaserRetroMaterialSwitcher : public Ogre::RenderTargetListener
@@ -84,19 +240,15 @@ class Ogre2LaserRetroMaterialSwitcher : public Ogre::RenderTargetListener
   private: virtual void postRenderTargetUpdate(
       const Ogre::RenderTargetEvent &_evt) override;
 
-  /// \brief Scene manager
-  private: Ogre2ScenePtr scene = nullptr;
+  /// \brief Laser retro items of the scene
+  private: std::shared_ptr<Ogre2LaserRetroItems> laserRetroItems;
 
   /// \brief Pointer to the laser retro source material
   private: Ogre::MaterialPtr laserRetroSourceMaterial;
 
-  /// \brief Custom parameter index of laser retro value in an ogre subitem.
-  /// This has to match the custom index specifed in LaserRetroSource material
-  /// script in media/materials/scripts/gpu_rays.material
-  private: const unsigned int customParamIdx = 10u;
-
-  /// \brief A map of ogre sub item pointer to their original hlms material
-  private: std::map<Ogre::SubItem *, Ogre::HlmsDatablock *> datablockMap;
+  /// \brief Ogre sub item pointers and their original hlms material
+  private: std::vector<std::pair<Ogre::SubItem *, Ogre::HlmsDatablock *>>
+      datablocks;
 };
 }
 }
@@ -117,9 +269,27 @@ class ignition::rendering::Ogre2GpuRaysPrivate
                unsigned int, unsigned int, unsigned int,
                const std::string &)> newGpuRaysFrame;
 
+  /// \brief Event triggered when new packed gpu rays data are available.
+  public: ignition::common::EventT<void(const uint16_t *,
+               unsigned int, unsigned int, unsigned int,
+               const std::string &)> newPackedGpuRaysFrame;
+
   /// \brief Raw buffer of gpu rays data.
   public: float *gpuRaysBuffer = nullptr;
 
+  /// \brief Raw buffer of packed gpu rays data, 2 values per reading
+  public: uint16_t *packedBuffer = nullptr;
+
+  /// \brief Format the 2nd pass packs each value to, PF_FLOAT32_R if the
+  /// data is not packed
+  public: PixelFormat packedFormat = PF_FLOAT32_R;
+
+  /// \brief Range resolution of the PF_L16 packed format, in meters
+  public: double packedRangeResolution = 0.001;
+
+  /// \brief Intensity resolution of the PF_L16 packed format
+  public: double packedIntensityResolution = 1.0;
+
   /// \brief Outgoing gpu rays data, used by newGpuRaysFrame event.
   public: float *gpuRaysScan = nullptr;
 
@@ -133,12 +303,20 @@ class ignition::rendering::Ogre2GpuRaysPrivate
   public: Ogre::Camera *cubeCam[6];
 
   /// \brief Texture packed with cubemap face and uv data
-  public: Ogre::TexturePtr cubeUVTexture;
+  public: std::shared_ptr<Ogre2GpuRaysSampleTexture> sampleTexture;
+
+  /// \brief Sensor whose cubemap is sampled instead of rendering one
+  public: std::weak_ptr<Ogre2GpuRays> cubemapSource;
 
   /// \brief Set of cubemap faces that are needed to generate the final
   /// range data
   public: std::set<unsigned int> cubeFaceIdx;
 
+  /// \brief Name of the 1st pass compositor definitions and material
+  /// shared with the gpu rays of the same configuration, empty if they are
+  /// not created yet
+  public: std::string sharedDefinitions1st;
+
   /// \brief 1st pass compositor workspace definition
   public: std::string ogreCompositorWorkspaceDef1st;
 
@@ -191,17 +369,378 @@ class ignition::rendering::Ogre2GpuRaysPrivate
   /// \brief Listener for setting particle noise value based on particle
   /// emitter region
   public: std::unique_ptr<Ogre2ParticleNoiseListener> particleNoiseListener[6];
+
+  /// \brief Listener applying the visibility mask of the sensor to the
+  /// scene passes of the cubemap faces
+  public: std::unique_ptr<Ogre2SensorVisibilityListener> visibilityListener;
+
+  /// \brief Listener timing the first pass, forwarding the events to
+  /// visibilityListener
+  public: std::unique_ptr<Ogre2GpuTimerListener> firstPassTimerListener;
+
+  /// \brief Listener timing the second pass
+  public: std::unique_ptr<Ogre2GpuTimerListener> secondPassTimerListener;
+
+  /// \brief Id of this sensor in the readback manager. Zero if
+  /// asynchronous readback is disabled
+  public: unsigned int readbackClient = 0u;
+
+  /// \brief True to copy the range data to CPU memory after each render
+  public: bool cpuReadback = true;
+
+  /// \brief Gaussian noise and dropout passes applied in the 2nd pass
+  public: std::vector<RenderPassPtr> renderPasses;
+
+  /// \brief Number of frames rendered with noise, counter of the seeded
+  /// noise and dropout
+  public: unsigned int noiseFrame = 0u;
+
+  /// \brief Horizontal and vertical angle of each reading, empty if the
+  /// readings are evenly spaced
+  public: std::vector<math::Vector2d> rayAngles;
+
+  /// \brief Event triggered when the readings of a sector are read back
+  public: ignition::common::EventT<void(const float *, unsigned int,
+               unsigned int, unsigned int, unsigned int, unsigned int)>
+               newGpuRaysSector;
+
+  /// \brief Number of azimuth sectors the readings are split in
+  public: unsigned int sectorCount = 1u;
+
+  /// \brief Cubemap faces rendered for each sector
+  public: std::vector<std::vector<unsigned int>> sectorFaces;
+
+  /// \brief Sector rendered by the next update
+  public: unsigned int nextSector = 0u;
+
+  /// \brief True once all the faces of the cubemap have been rendered,
+  /// which is done on the first update of sensors split in sectors
+  public: bool cubemapRendered = false;
+
+  /// \brief Sectors of the frames rendered and not read back yet, oldest
+  /// first
+  public: std::deque<unsigned int> renderedSectors;
+
+  /// \brief Readings of the last sector read back, for newGpuRaysSector
+  public: float *sectorScan = nullptr;
 };
 
 using namespace ignition;
 using namespace rendering;
 
+//////////////////////////////////////////////////
+/// \brief Get the format of the 2nd pass texture
+/// \param[in] _packedFormat Format each value is packed to
+/// \return Ogre pixel format holding the range and intensity
+static Ogre::PixelFormat secondPassFormat(PixelFormat _packedFormat)
+{
+  switch (_packedFormat)
+  {
+    case PF_L16:
+      return Ogre::PF_SHORT_GR;
+    case PF_FLOAT16_R:
+      return Ogre::PF_FLOAT16_GR;
+    default:
+      return Ogre::PF_FLOAT32_RGB;
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Set the scale the 2nd pass material applies to the range and
+/// intensity, mapping the PF_L16 fixed point values to the normalized range
+/// of the texture. Other formats are not scaled.
+/// \param[in] _material 2nd pass material
+/// \param[in] _format Format each value is packed to
+/// \param[in] _rangeResolution Range resolution of PF_L16 values
+/// \param[in] _intensityResolution Intensity resolution of PF_L16 values
+static void setPackScale(const Ogre::MaterialPtr &_material,
+    PixelFormat _format, double _rangeResolution,
+    double _intensityResolution)
+{
+  if (!_material)
+    return;
+
+  Ogre::Vector2 scale(0.0f, 0.0f);
+  if (_format == PF_L16)
+  {
+    scale = Ogre::Vector2(
+        static_cast<float>(1.0 / (_rangeResolution * 65535.0)),
+        static_cast<float>(1.0 / (_intensityResolution * 65535.0)));
+  }
+  Ogre::Pass *pass = _material->getTechnique(0)->getPass(0);
+  pass->getFragmentProgramParameters()->setNamedConstant("packScale", scale);
+}
+
+//////////////////////////////////////////////////
+/// \brief Set the Gaussian range noise and dropout uniforms of the 2nd pass
+/// material from the enabled passes of the sensor
+/// \param[in] _material 2nd pass material
+/// \param[in] _passes Gaussian noise and dropout passes
+/// \param[in] _frame Frame number, counter of the seeded noise
+/// \return True if noise or dropout is applied
+static bool setRangeNoise(const Ogre::MaterialPtr &_material,
+    const std::vector<RenderPassPtr> &_passes, unsigned int _frame)
+{
+  if (!_material)
+    return false;
+
+  float mean = 0.0f;
+  float stddev = 0.0f;
+  Ogre::Vector3 offsets(Ogre::Vector3::ZERO);
+  int noiseSeed = 0;
+  float dropout = 0.0f;
+  float dropoutOffset = 0.0f;
+  int dropoutSeed = 0;
+  for (const auto &pass : _passes)
+  {
+    if (!pass->IsEnabled())
+      continue;
+
+    auto noisePass = std::dynamic_pointer_cast<GaussianNoisePass>(pass);
+    if (noisePass)
+    {
+      mean = static_cast<float>(noisePass->Mean() + noisePass->Bias());
+      stddev = static_cast<float>(noisePass->StdDev());
+      noiseSeed = static_cast<int>(noisePass->Seed());
+      if (noiseSeed == 0)
+      {
+        offsets = Ogre::Vector3(ignition::math::Rand::DblUniform(0.0, 1.0),
+                                ignition::math::Rand::DblUniform(0.0, 1.0),
+                                ignition::math::Rand::DblUniform(0.0, 1.0));
+      }
+      continue;
+    }
+
+    auto dropoutPass = std::dynamic_pointer_cast<DropoutPass>(pass);
+    if (dropoutPass)
+    {
+      dropout = static_cast<float>(dropoutPass->Probability());
+      dropoutSeed = static_cast<int>(dropoutPass->Seed());
+      if (dropoutSeed == 0)
+      {
+        dropoutOffset =
+            static_cast<float>(ignition::math::Rand::DblUniform(0.0, 1.0));
+      }
+    }
+  }
+
+  // These parameters are declared in media/materials/scripts/
+  // gpu_rays.material and media/materials/programs/gpu_rays_2nd_pass_fs.glsl
+  Ogre::Pass *pass = _material->getTechnique(0)->getPass(0);
+  Ogre::GpuProgramParametersSharedPtr psParams =
+      pass->getFragmentProgramParameters();
+  psParams->setNamedConstant("noiseMean", mean);
+  psParams->setNamedConstant("noiseStddev", stddev);
+  psParams->setNamedConstant("noiseOffsets", offsets);
+  psParams->setNamedConstant("noiseSeed", noiseSeed);
+  psParams->setNamedConstant("dropout", dropout);
+  psParams->setNamedConstant("dropoutOffset", dropoutOffset);
+  psParams->setNamedConstant("dropoutSeed", dropoutSeed);
+  psParams->setNamedConstant("frame", static_cast<int>(_frame));
+  return mean != 0.0f || stddev > 0.0f || dropout > 0.0f;
+}
+
+//////////////////////////////////////////////////
+/// \brief Unpack gpu rays readings to 3 floats per reading
+/// \param[in] _src Packed readings, 2 values each
+/// \param[in] _format Format each value is packed to
+/// \param[in] _rangeResolution Range resolution of PF_L16 values
+/// \param[in] _intensityResolution Intensity resolution of PF_L16 values
+/// \param[in] _min Range saturated PF_L16 values below the range unpack to
+/// \param[in] _max Range saturated PF_L16 values above the range unpack to
+/// \param[out] _dst Unpacked readings: range, intensity, 0
+/// \param[in] _count Number of readings
+static void unpackGpuRays(const uint16_t *_src, PixelFormat _format,
+    double _rangeResolution, double _intensityResolution, float _min,
+    float _max, float *_dst, unsigned int _count)
+{
+  for (unsigned int i = 0u; i < _count; ++i)
+  {
+    const uint16_t *reading = _src + i * 2u;
+    float *out = _dst + i * 3u;
+    if (_format == PF_FLOAT16_R)
+    {
+      PixelUtil::Convert(reading, PF_FLOAT16_R, out, PF_FLOAT32_R, 2u);
+    }
+    else
+    {
+      if (reading[0] == 0u)
+        out[0] = _min;
+      else if (reading[0] == 0xFFFFu)
+        out[0] = _max;
+      else
+        out[0] = static_cast<float>(reading[0] * _rangeResolution);
+      out[1] = static_cast<float>(reading[1] * _intensityResolution);
+    }
+    out[2] = 0.0f;
+  }
+}
+
+
+//////////////////////////////////////////////////
+Ogre2LaserRetroItems::Ogre2LaserRetroItems(Ogre2ScenePtr _scene)
+  : scene(_scene)
+{
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<Ogre2LaserRetroItems> Ogre2LaserRetroItems::Instance(
+    Ogre2ScenePtr _scene)
+{
+  static std::map<Ogre2Scene *, std::weak_ptr<Ogre2LaserRetroItems>>
+      instances;
+
+  std::shared_ptr<Ogre2LaserRetroItems> instance =
+      instances[_scene.get()].lock();
+  if (!instance)
+  {
+    instance = std::make_shared<Ogre2LaserRetroItems>(_scene);
+    instances[_scene.get()] = instance;
+  }
+  return instance;
+}
+
+//////////////////////////////////////////////////
+void Ogre2LaserRetroItems::Update()
+{
+  // all lidar cubemap faces, and all lidars in a render batch, are rendered
+  // in the same frame so the items only need to be collected once
+  auto engine = Ogre2RenderEngine::Instance();
+  unsigned long nextFrame = engine->OgreRoot()->getNextFrameNumber();
+  if (nextFrame == this->frame)
+    return;
+  this->frame = nextFrame;
+
+  ++this->traversal;
+  this->items.clear();
+  size_t itemCount = 0u;
+  auto itor = this->scene->OgreSceneManager()->getMovableObjectIterator(
+      Ogre::ItemFactory::FACTORY_TYPE_NAME);
+  while (itor.hasMoreElements())
+  {
+    Ogre::MovableObject *object = itor.peekNext();
+    Ogre::Item *item = static_cast<Ogre::Item *>(object);
+    itor.moveNext();
+    ++itemCount;
+
+    // get visual
+    Ogre::Any userAny = item->getUserObjectBindings().getUserAny();
+    if (userAny.isEmpty() || userAny.getType() != typeid(unsigned int))
+      continue;
+    unsigned int visualId = Ogre::any_cast<unsigned int>(userAny);
+
+    // only decode the visual's user data if the item is new, the item
+    // moved to another visual or the user data changed since last time
+    auto inserted = this->itemStates.emplace(item->getId(), ItemState());
+    ItemState &state = inserted.first->second;
+    state.traversal = this->traversal;
+    Ogre2VisualPtr ogreVisual = state.visual.lock();
+    if (inserted.second || !ogreVisual || state.visualId != visualId ||
+        state.userDataVersion != ogreVisual->UserDataVersion())
+    {
+      this->UpdateItemState(item, visualId, state);
+    }
+
+    // only accept positive laser retro value
+    if (state.color >= 0.0f)
+    {
+      // set visibility flag so the camera can see it. This is done on every
+      // update since the visual may have reset the item's flags
+      item->addVisibilityFlags(this->visibilityFlags);
+      this->items.push_back(item);
+    }
+  }
+
+  // drop the state of items that have been destroyed
+  if (itemCount < this->itemStates.size())
+  {
+    for (auto it = this->itemStates.begin(); it != this->itemStates.end();)
+    {
+      if (it->second.traversal != this->traversal)
+        it = this->itemStates.erase(it);
+      else
+        ++it;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2LaserRetroItems::UpdateItemState(Ogre::Item *_item,
+    unsigned int _visualId, ItemState &_state)
+{
+  Ogre2VisualPtr ogreVisual = this->scene->OgreVisualById(_visualId);
+  _state.visual = ogreVisual;
+  _state.visualId = _visualId;
+  _state.color = -1.0f;
+  if (!ogreVisual)
+    return;
+  _state.userDataVersion = ogreVisual->UserDataVersion();
+
+  // get laser_retro
+  static const UserDataKey laserRetroKey("laser_retro");
+  const Variant &tempLaserRetro = ogreVisual->UserData(laserRetroKey);
+  float retroValue = -1.0;
+  if (auto value = std::get_if<float>(&tempLaserRetro))
+    retroValue = *value;
+  else if (auto value = std::get_if<double>(&tempLaserRetro))
+    retroValue = static_cast<float>(*value);
+  else if (auto value = std::get_if<int>(&tempLaserRetro))
+    retroValue = static_cast<float>(*value);
+  else
+    ignerr << "Error casting laser_retro user data of visual: "
+           << ogreVisual->Name() << std::endl;
+
+  if (retroValue < 0)
+    return;
+
+  // limit laser retro value to 2000 (as in gazebo)
+  retroValue = std::min(retroValue, 2000.0f);
+  _state.color = retroValue / 2000.0f;
+
+  // the custom parameter is only read by the laser retro source material so
+  // it can stay on the sub items and only needs to be set when it changes
+  for (unsigned int i = 0; i < _item->getNumSubItems(); ++i)
+  {
+    Ogre::SubItem *subItem = _item->getSubItem(i);
+    subItem->setCustomParameter(this->customParamIdx,
+        Ogre::Vector4(_state.color, _state.color, _state.color, 1.0));
+  }
+}
+
+//////////////////////////////////////////////////
+const std::vector<Ogre::Item *> &Ogre2LaserRetroItems::Items() const
+{
+  return this->items;
+}
+
+//////////////////////////////////////////////////
+Ogre2GpuRaysSampleTexture::~Ogre2GpuRaysSampleTexture()
+{
+  if (this->texture && Ogre::TextureManager::getSingletonPtr())
+    Ogre::TextureManager::getSingleton().remove(this->texture->getName());
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<Ogre2GpuRaysSampleTexture>
+    Ogre2GpuRaysSampleTexture::Instance(const Key &_key)
+{
+  static std::map<Key, std::weak_ptr<Ogre2GpuRaysSampleTexture>> instances;
+
+  std::shared_ptr<Ogre2GpuRaysSampleTexture> instance =
+      instances[_key].lock();
+  if (!instance)
+  {
+    instance = std::make_shared<Ogre2GpuRaysSampleTexture>();
+    instances[_key] = instance;
+  }
+  return instance;
+}
 
 //////////////////////////////////////////////////
 Ogre2LaserRetroMaterialSwitcher::Ogre2LaserRetroMaterialSwitcher(
     Ogre2ScenePtr _scene)
 {
-  this->scene = _scene;
+  this->laserRetroItems = Ogre2LaserRetroItems::Instance(_scene);
   // plain opaque material
   Ogre::ResourcePtr res =
     Ogre::MaterialManager::getSingleton().load("LaserRetroSource",
@@ -218,95 +757,28 @@ void Ogre2LaserRetroMaterialSwitcher::preRenderTargetUpdate(
   // swap item to use v1 shader material
   // Note: keep an eye out for performance impact on switching materials
   // on the fly. We are not doing this often so should be ok.
-  this->datablockMap.clear();
-  auto itor = this->scene->OgreSceneManager()->getMovableObjectIterator(
-      Ogre::ItemFactory::FACTORY_TYPE_NAME);
-  while (itor.hasMoreElements())
+  // Only items with a laser retro value have the visibility flag of the
+  // laser retro pass so the other items do not need to be switched.
+  this->datablocks.clear();
+  this->laserRetroItems->Update();
+  for (Ogre::Item *item : this->laserRetroItems->Items())
   {
-    Ogre::MovableObject *object = itor.peekNext();
-    Ogre::Item *item = static_cast<Ogre::Item *>(object);
-
-    std::string laserRetroKey = "laser_retro";
-    // get visual
-    Ogre::Any userAny = item->getUserObjectBindings().getUserAny();
-    if (!userAny.isEmpty() && userAny.getType() == typeid(unsigned int))
+    for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
     {
-      VisualPtr result;
-      try
-      {
-        result = this->scene->VisualById(Ogre::any_cast<unsigned int>(userAny));
-      }
-      catch(Ogre::Exception &e)
-      {
-        ignerr << "Ogre Error:" << e.getFullDescription() << "\n";
-      }
-      Ogre2VisualPtr ogreVisual =
-          std::dynamic_pointer_cast<Ogre2Visual>(result);
-
-      // get laser_retro
-      Variant tempLaserRetro = ogreVisual->UserData(laserRetroKey);
-
-        float retroValue = -1.0;
-        try
-        {
-          retroValue = std::get<float>(tempLaserRetro);
-        }
-        catch(...)
-        {
-          try
-          {
-            retroValue = std::get<double>(tempLaserRetro);
-          }
-          catch(...)
-          {
-            try
-            {
-              retroValue = std::get<int>(tempLaserRetro);
-            }
-            catch(std::bad_variant_access &e)
-            {
-              ignerr << "Error casting user data: " << e.what() << "\n";
-              retroValue = -1.0;
-            }
-          }
-        }
-
-        // only accept positive laser retro value
-        if (retroValue >= 0)
-        {
-          // set visibility flag so the camera can see it
-          item->addVisibilityFlags(0x01000000);
-          for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
-          {
-            Ogre::SubItem *subItem = item->getSubItem(i);
-            if (!subItem->hasCustomParameter(this->customParamIdx))
-            {
-              // limit laser retro value to 2000 (as in gazebo)
-              if (retroValue > 2000.0)
-              {
-                retroValue = 2000.0;
-              }
-              float color = retroValue / 2000.0;
-              subItem->setCustomParameter(this->customParamIdx,
-                  Ogre::Vector4(color, color, color, 1.0));
-            }
-            Ogre::HlmsDatablock *datablock = subItem->getDatablock();
-            this->datablockMap[subItem] = datablock;
-
-            subItem->setMaterial(this->laserRetroSourceMaterial);
-          }
-        }
-      }
-      itor.moveNext();
+      Ogre::SubItem *subItem = item->getSubItem(i);
+      this->datablocks.push_back(
+          std::make_pair(subItem, subItem->getDatablock()));
+      subItem->setMaterial(this->laserRetroSourceMaterial);
     }
   }
+}
 
 //////////////////////////////////////////////////
 void Ogre2LaserRetroMaterialSwitcher::postRenderTargetUpdate(
     const Ogre::RenderTargetEvent & /*_evt*/)
 {
   // restore item to use hlms material
-  for (auto it : this->datablockMap)
+  for (auto it : this->datablocks)
   {
     Ogre::SubItem *subItem = it.first;
     subItem->setDatablock(it.second);
@@ -350,25 +822,44 @@ void Ogre2GpuRays::Init()
 //////////////////////////////////////////////////
 void Ogre2GpuRays::Destroy()
 {
+  // the queued frames refer to the events of this sensor
+  this->FlushFrames();
+
+  this->SetAsyncReadback(false);
+
+  this->dataPtr->renderPasses.clear();
+
   if (this->dataPtr->gpuRaysBuffer)
   {
+    MemoryTracker::Untrack(this->dataPtr->gpuRaysBuffer);
     delete [] this->dataPtr->gpuRaysBuffer;
     this->dataPtr->gpuRaysBuffer = nullptr;
   }
 
+  if (this->dataPtr->sectorScan)
+  {
+    MemoryTracker::Untrack(this->dataPtr->sectorScan);
+    delete [] this->dataPtr->sectorScan;
+    this->dataPtr->sectorScan = nullptr;
+  }
+
   if (this->dataPtr->gpuRaysScan)
   {
+    MemoryTracker::Untrack(this->dataPtr->gpuRaysScan);
     delete [] this->dataPtr->gpuRaysScan;
     this->dataPtr->gpuRaysScan = nullptr;
   }
 
-  if (this->dataPtr->cubeUVTexture)
+  if (this->dataPtr->packedBuffer)
   {
-    Ogre::TextureManager::getSingleton().remove(
-        this->dataPtr->cubeUVTexture->getName());
-    this->dataPtr->cubeUVTexture.reset();
+    MemoryTracker::Untrack(this->dataPtr->packedBuffer);
+    delete [] this->dataPtr->packedBuffer;
+    this->dataPtr->packedBuffer = nullptr;
   }
 
+  // the sample texture is released with its last user
+  this->dataPtr->sampleTexture.reset();
+
   auto engine = Ogre2RenderEngine::Instance();
   auto ogreRoot = engine->OgreRoot();
   Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
@@ -389,21 +880,25 @@ void Ogre2GpuRays::Destroy()
       this->dataPtr->ogreCompositorWorkspace1st[i] = nullptr;
     }
   }
-  if (this->dataPtr->matFirstPass)
-  {
-    Ogre::MaterialManager::getSingleton().remove(
-        this->dataPtr->matFirstPass->getName());
-    this->dataPtr->matFirstPass.reset();
-  }
-
-  if (!this->dataPtr->ogreCompositorWorkspaceDef1st.empty())
+  // the 1st pass definitions and material are removed with the last gpu
+  // rays sharing them
+  if (!this->dataPtr->sharedDefinitions1st.empty() &&
+      Ogre2SharedDefinitions::Instance()->Release(
+      this->dataPtr->sharedDefinitions1st))
   {
+    if (this->dataPtr->matFirstPass)
+    {
+      Ogre::MaterialManager::getSingleton().remove(
+          this->dataPtr->matFirstPass->getName());
+    }
     ogreCompMgr->removeWorkspaceDefinition(
         this->dataPtr->ogreCompositorWorkspaceDef1st);
     ogreCompMgr->removeNodeDefinition(
         this->dataPtr->ogreCompositorNodeDef1st);
-    this->dataPtr->ogreCompositorWorkspaceDef1st.clear();
   }
+  this->dataPtr->matFirstPass.reset();
+  this->dataPtr->sharedDefinitions1st.clear();
+  this->dataPtr->ogreCompositorWorkspaceDef1st.clear();
 
   // remove 2nd pass texture, material, compositor
   if (this->dataPtr->secondPassTexture)
@@ -499,10 +994,52 @@ void Ogre2GpuRays::ConfigureCamera()
   // Configure first pass texture size
   // Each cubemap texture covers 90 deg FOV so determine number of samples
   // within the view for both horizontal and vertical FOV
-  unsigned int hs = static_cast<unsigned int>(
-      IGN_PI * 0.5 / hfovAngle.Radian() * this->RangeCount());
-  unsigned int vs = static_cast<unsigned int>(
-      IGN_PI * 0.5 / vfovAngle * this->VerticalRangeCount());
+  unsigned int hs = 0u;
+  unsigned int vs = 0u;
+  auto &angles = this->dataPtr->rayAngles;
+  if (!angles.empty() && angles.size() != static_cast<size_t>(
+      this->RangeCount()) * this->VerticalRangeCount())
+  {
+    ignerr << "The ray angles of [" << this->Name() << "] have "
+           << angles.size() << " readings instead of "
+           << this->RangeCount() * this->VerticalRangeCount()
+           << ". Spacing the readings evenly instead." << std::endl;
+    angles.clear();
+  }
+  if (angles.empty())
+  {
+    if (hfovAngle.Radian() > 0.0)
+    {
+      hs = static_cast<unsigned int>(
+          IGN_PI * 0.5 / hfovAngle.Radian() * this->RangeCount());
+    }
+    if (vfovAngle > 0.0)
+    {
+      vs = static_cast<unsigned int>(
+          IGN_PI * 0.5 / vfovAngle * this->VerticalRangeCount());
+    }
+  }
+  else
+  {
+    // explicit angles may not be laid out on a grid, e.g. non-repetitive
+    // patterns, so their density is estimated from the number of readings
+    // over the field of view they span
+    math::Vector2d angleMin = angles[0];
+    math::Vector2d angleMax = angles[0];
+    for (const auto &angle : angles)
+    {
+      angleMin.Min(angle);
+      angleMax.Max(angle);
+    }
+    math::Vector2d fov = angleMax - angleMin;
+    double count = static_cast<double>(angles.size());
+    double density = 0.0;
+    if (fov.X() > 0.0 && fov.Y() > 0.0)
+      density = std::sqrt(count / (fov.X() * fov.Y()));
+    else if (fov.X() > 0.0 || fov.Y() > 0.0)
+      density = count / std::max(fov.X(), fov.Y());
+    hs = static_cast<unsigned int>(IGN_PI * 0.5 * density);
+  }
 
   // get the max number from the two
   unsigned int v = std::max(hs, vs);
@@ -566,78 +1103,305 @@ void Ogre2GpuRays::CreateSampleTexture()
   double max = this->AngleMax().Radian();
   double vmin = this->VerticalAngleMin().Radian();
   double vmax = this->VerticalAngleMax().Radian();
-  double hStep = (max-min) / static_cast<double>(this->dataPtr->w2nd-1);
-  double vStep = 1.0;
+  const unsigned int width = this->dataPtr->w2nd;
+  const unsigned int height = this->dataPtr->h2nd;
+
+  // sensors with the same rays share the same texture, so it is only
+  // computed by the first of them. Sensors sampling the cubemap of another
+  // sensor depend on its pose and have a texture of their own.
+  Ogre2GpuRaysPtr source = this->dataPtr->cubemapSource.lock();
+  if (source)
+  {
+    this->dataPtr->sampleTexture =
+        std::make_shared<Ogre2GpuRaysSampleTexture>();
+  }
+  else
+  {
+    std::vector<double> angles;
+    angles.reserve(this->dataPtr->rayAngles.size() * 2u);
+    for (const auto &angle : this->dataPtr->rayAngles)
+    {
+      angles.push_back(angle.X());
+      angles.push_back(angle.Y());
+    }
+    this->dataPtr->sampleTexture = Ogre2GpuRaysSampleTexture::Instance(
+        Ogre2GpuRaysSampleTexture::Key(min, max, vmin, vmax, width, height,
+        angles));
+    if (this->dataPtr->sampleTexture->texture)
+    {
+      this->dataPtr->cubeFaceIdx = this->dataPtr->sampleTexture->faces;
+      return;
+    }
+  }
+
+  double hStep = 0.0;
+  if (width > 1)
+    hStep = (max-min) / static_cast<double>(width-1);
+  double vStep = 0.0;
   // non-planar case
-  if (this->dataPtr->h2nd > 1)
-    vStep = (vmax-vmin) / static_cast<double>(this->dataPtr->h2nd-1);
+  if (height > 1)
+    vStep = (vmax-vmin) / static_cast<double>(height-1);
+
+  // the direction of a ray in the sensor frame is
+  // (cos(v)cos(h), cos(v)sin(h), sin(v)), so the sines and cosines are
+  // computed once per column and row
+  std::vector<double> sinH(width);
+  std::vector<double> cosH(width);
+  for (unsigned int j = 0; j < width; ++j)
+  {
+    double h = min + j * hStep;
+    sinH[j] = std::sin(h);
+    cosH[j] = std::cos(h);
+  }
+  std::vector<double> sinV(height);
+  std::vector<double> cosV(height);
+  for (unsigned int i = 0; i < height; ++i)
+  {
+    double v = vmin + i * vStep;
+    sinV[i] = std::sin(v);
+    cosV[i] = std::cos(v);
+  }
 
-  // create an RGB texture (cubeUVTex) to pack info that tells the shaders how
-  // to sample from the cubemap textures.
-  // Each pixel packs the follow data:
+  // pack info that tells the shaders how to sample from the cubemap
+  // textures. Each pixel packs the follow data:
   //   R: u coordinate on the cubemap face
   //   G: v coordinate on the cubemap face
   //   B: cubemap face index
-  // this texture is passed to the 2nd pass fragment shader
-  std::string texName = this->Name() + "_samplerTex";
-  this->dataPtr->cubeUVTexture =
-      Ogre::TextureManager::getSingleton().createManual(
-          texName,
-          "General",
-          Ogre::TEX_TYPE_2D,
-          this->dataPtr->w2nd,
-          this->dataPtr->h2nd,
-          0,
-          Ogre::PF_FLOAT32_RGB);
-  Ogre::v1::HardwarePixelBufferSharedPtr pixelBuffer =
-      this->dataPtr->cubeUVTexture->getBuffer();
-  // fill the texture
-  pixelBuffer->lock(Ogre::v1::HardwareBuffer::HBL_NORMAL);
-  const Ogre::PixelBox &pixelBox = pixelBuffer->getCurrentLock();
-  float *pDest = static_cast<float *>(pixelBox.data);
+  const size_t rayCount = static_cast<size_t>(width) * height;
+  std::vector<float> data(rayCount * 3u);
 
-  double v = vmin;
-  for (unsigned int i = 0; i < this->dataPtr->h2nd; ++i)
+  // faces and uv bounds on each face sampled by a range of rays
+  struct Bounds
   {
-    double h = min;
-    for (unsigned int j = 0; j < this->dataPtr->w2nd; ++j)
+    std::set<unsigned int> faces;
+    math::Vector2d uvMin[6];
+    math::Vector2d uvMax[6];
+  };
+  auto sample = [&](const math::Quaterniond &_rot, size_t _start,
+      size_t _end, Bounds &_bounds)
+  {
+    const auto &angles = this->dataPtr->rayAngles;
+    for (size_t r = _start; r < _end; ++r)
     {
-      // set up dir vector to sample from a standard Y up cubemap
-      math::Vector3d ray(0, 0, 1);
-      ray.Normalize();
-      math::Quaterniond pitch(math::Vector3d(1, 0, 0), -v);
-      math::Quaterniond yaw(math::Vector3d(0, 1, 0), -h);
-      math::Vector3d dir = yaw * pitch * ray;
-      unsigned int faceIdx;
+      math::Vector3d ray;
+      if (angles.empty())
+      {
+        size_t i = r / width;
+        size_t j = r % width;
+        ray.Set(cosV[i] * cosH[j], cosV[i] * sinH[j], sinV[i]);
+      }
+      else
+      {
+        double cosA = std::cos(angles[r].Y());
+        ray.Set(cosA * std::cos(angles[r].X()),
+            cosA * std::sin(angles[r].X()), std::sin(angles[r].Y()));
+      }
+      ray = _rot * ray;
+      // sample from a standard Y up cubemap
+      math::Vector3d dir(-ray.Y(), ray.Z(), ray.X());
+      unsigned int faceIdx;
       math::Vector2d uv = this->SampleCubemap(dir, faceIdx);
-      this->dataPtr->cubeFaceIdx.insert(faceIdx);
-      // igndbg << "p(" << pitch << ") y(" << yaw << "): " << dir << " | "
-      //       << uv << " | " << faceIdx << std::endl;
-      // u
-      *pDest++ = uv.X();
-      // v
-      *pDest++ = uv.Y();
-      // face
-      *pDest++ = faceIdx;
-
-       h += hStep;
+      if (_bounds.faces.insert(faceIdx).second)
+      {
+        _bounds.uvMin[faceIdx] = uv;
+        _bounds.uvMax[faceIdx] = uv;
+      }
+      else
+      {
+        _bounds.uvMin[faceIdx].Min(uv);
+        _bounds.uvMax[faceIdx].Max(uv);
+      }
+      data[r * 3u] = uv.X();
+      data[r * 3u + 1u] = uv.Y();
+      data[r * 3u + 2u] = faceIdx;
+    }
+  };
+
+  // faces that are sampled and their uv bounds
+  std::set<unsigned int> &cubeFaces = this->dataPtr->sampleTexture->faces;
+  math::Vector2d uvMin[6];
+  math::Vector2d uvMax[6];
+  auto sampleAll = [&](const math::Quaterniond &_rot)
+  {
+    // only spread the work across threads when there is enough of it to
+    // make up for the cost of starting them
+    const size_t minRaysPerThread = 16384u;
+    size_t threadCount = std::min<size_t>(
+        std::max(1u, std::thread::hardware_concurrency()),
+        rayCount / minRaysPerThread);
+    threadCount = std::max<size_t>(threadCount, 1u);
+    std::vector<Bounds> bounds(threadCount);
+    size_t chunk = (rayCount + threadCount - 1u) / threadCount;
+    std::vector<std::thread> threads;
+    for (size_t t = 1u; t < threadCount; ++t)
+    {
+      threads.emplace_back(sample, std::cref(_rot), t * chunk,
+          std::min(rayCount, (t + 1u) * chunk), std::ref(bounds[t]));
+    }
+    sample(_rot, 0u, std::min(rayCount, chunk), bounds[0]);
+    for (auto &thread : threads)
+      thread.join();
+
+    cubeFaces.clear();
+    for (const auto &b : bounds)
+    {
+      for (auto i : b.faces)
+      {
+        if (cubeFaces.insert(i).second)
+        {
+          uvMin[i] = b.uvMin[i];
+          uvMax[i] = b.uvMax[i];
+        }
+        else
+        {
+          uvMin[i].Min(b.uvMin[i]);
+          uvMax[i].Max(b.uvMax[i]);
+        }
+      }
+    }
+  };
+
+  double w1st = this->dataPtr->w1st;
+  double h1st = this->dataPtr->h1st;
+  auto &regions = this->dataPtr->sampleTexture->regions;
+  if (source)
+  {
+    // sample the cubemap of the source, which is oriented like the source.
+    // All samples have to be in the regions of the faces it renders.
+    if (!source->dataPtr->sampleTexture)
+      source->CreateGpuRaysTextures();
+    const Ogre2GpuRaysSampleTexture &sourceTexture =
+        *source->dataPtr->sampleTexture;
+    w1st = source->dataPtr->w1st;
+    h1st = source->dataPtr->h1st;
+    sampleAll(source->WorldRotation().Inverse() * this->WorldRotation());
+    for (auto i : cubeFaces)
+    {
+      const auto &region = sourceTexture.regions[i];
+      if (sourceTexture.faces.find(i) == sourceTexture.faces.end() ||
+          std::floor(uvMin[i].X() * w1st) < region.left ||
+          std::floor(uvMin[i].Y() * h1st) < region.top ||
+          std::ceil(uvMax[i].X() * w1st) > region.right ||
+          std::ceil(uvMax[i].Y() * h1st) > region.bottom)
+      {
+        ignwarn << "The rays of [" << this->Name() << "] are not covered "
+                << "by the cubemap of [" << source->Name() << "]. "
+                << "Rendering a cubemap for [" << this->Name() << "] instead."
+                << std::endl;
+        source.reset();
+        this->dataPtr->cubemapSource.reset();
+        break;
+      }
+      regions[i] = region;
+    }
+  }
+
+  if (!source)
+  {
+    w1st = this->dataPtr->w1st;
+    h1st = this->dataPtr->h1st;
+    sampleAll(math::Quaterniond::Identity);
+    this->dataPtr->cubeFaceIdx = cubeFaces;
+
+    // faces that are not sampled are not rendered. The other faces are only
+    // rendered in the smallest region of the 1st pass textures that holds
+    // all of their samples, plus a pixel of margin, which cuts the fill
+    // cost of lidars with a narrow vertical field of view.
+    for (auto i : cubeFaces)
+    {
+      regions[i].left = static_cast<unsigned int>(
+          std::max(0.0, std::floor(uvMin[i].X() * w1st) - 1.0));
+      regions[i].top = static_cast<unsigned int>(
+          std::max(0.0, std::floor(uvMin[i].Y() * h1st) - 1.0));
+      regions[i].right = static_cast<unsigned int>(
+          std::min(w1st, std::ceil(uvMax[i].X() * w1st) + 1.0));
+      regions[i].bottom = static_cast<unsigned int>(
+          std::min(h1st, std::ceil(uvMax[i].Y() * h1st) + 1.0));
+    }
+
+    // faces sampled by each column, from which the faces of azimuth
+    // sectors are derived
+    auto &columnFaces = this->dataPtr->sampleTexture->columnFaces;
+    columnFaces.assign(width, 0u);
+    for (size_t r = 0u; r < rayCount; ++r)
+    {
+      columnFaces[r % width] |= static_cast<uint8_t>(
+          1u << static_cast<unsigned int>(data[r * 3u + 2u]));
     }
-    v += vStep;
   }
 
+  // make the uv coordinates relative to the region of their face. Regions
+  // are aligned on pixels so the same pixels are sampled.
+  for (size_t r = 0u; r < rayCount; ++r)
+  {
+    const auto &region = regions[static_cast<unsigned int>(data[r * 3u + 2u])];
+    data[r * 3u] = static_cast<float>(
+        (data[r * 3u] * w1st - region.left) / (region.right - region.left));
+    data[r * 3u + 1u] = static_cast<float>(
+        (data[r * 3u + 1u] * h1st - region.top) /
+        (region.bottom - region.top));
+  }
+
+  // create an RGB texture (cubeUVTex) from the packed data.
+  // this texture is passed to the 2nd pass fragment shader
+  static unsigned int textureCount = 0u;
+  std::string texName = "GpuRaysSampleTex_" + std::to_string(textureCount++);
+  Ogre::TexturePtr texture =
+      Ogre::TextureManager::getSingleton().createManual(
+          texName,
+          "General",
+          Ogre::TEX_TYPE_2D,
+          width,
+          height,
+          0,
+          Ogre::PF_FLOAT32_RGB);
+  Ogre::v1::HardwarePixelBufferSharedPtr pixelBuffer = texture->getBuffer();
+  // fill the texture
+  pixelBuffer->lock(Ogre::v1::HardwareBuffer::HBL_NORMAL);
+  const Ogre::PixelBox &pixelBox = pixelBuffer->getCurrentLock();
+  float *pDest = static_cast<float *>(pixelBox.data);
+  for (unsigned int i = 0; i < height; ++i)
+  {
+    std::copy(data.begin() + i * width * 3u,
+        data.begin() + (i + 1u) * width * 3u,
+        pDest + i * pixelBox.rowPitch * 3u);
+  }
   pixelBuffer->unlock();
+
+  this->dataPtr->sampleTexture->texture = texture;
 }
 
 /////////////////////////////////////////////////////////
 void Ogre2GpuRays::Setup1stPass()
 {
+  // Gpu rays with the same configuration share the 1st pass compositor
+  // definitions and material, only the cubemap textures and workspaces are
+  // created per sensor. The 2nd pass material binds the textures of the
+  // sensor and is not shared.
+  std::ostringstream config;
+  config << std::setprecision(17) << this->NearClipPlane() << " "
+         << this->FarClipPlane() << " " << this->dataMinVal << " "
+         << this->dataMaxVal << " " << this->dataPtr->particleStddev;
+  bool created = false;
+  this->dataPtr->sharedDefinitions1st = Ogre2SharedDefinitions::Instance()->
+      Acquire("GpuRays1stPassWorkspace", config.str(), created);
+
   // Load 1st pass material
   // The GpuRaysScan1st material is defined in script (gpu_rays.material).
   // We need to clone it since we are going to modify its uniform variables
   std::string mat1stName = "GpuRaysScan1st";
-  Ogre::MaterialPtr mat1st =
-      Ogre::MaterialManager::getSingleton().getByName(mat1stName);
-  this->dataPtr->matFirstPass = mat1st->clone(this->Name() + "_" + mat1stName);
+  std::string matFirstPassName =
+      this->dataPtr->sharedDefinitions1st + "_" + mat1stName;
+  Ogre::MaterialManager &matManager = Ogre::MaterialManager::getSingleton();
+  if (created)
+  {
+    Ogre::MaterialPtr mat1st = matManager.getByName(mat1stName);
+    this->dataPtr->matFirstPass = mat1st->clone(matFirstPassName);
+  }
+  else
+  {
+    this->dataPtr->matFirstPass = matManager.getByName(matFirstPassName);
+  }
   this->dataPtr->matFirstPass->load();
   Ogre::Pass *pass = this->dataPtr->matFirstPass->getTechnique(0)->getPass(0);
   Ogre::GpuProgramParametersSharedPtr psParams =
@@ -718,12 +1482,12 @@ void Ogre2GpuRays::Setup1stPass()
   //   }
   //   out 0 rt_input
   // }
-  std::string wsDefName = "GpuRays1stPassWorkspace_" + this->Name();
+  std::string wsDefName = this->dataPtr->sharedDefinitions1st;
+  std::string nodeDefName = wsDefName + "/Node";
   this->dataPtr->ogreCompositorWorkspaceDef1st = wsDefName;
+  this->dataPtr->ogreCompositorNodeDef1st = nodeDefName;
   if (!ogreCompMgr->hasWorkspaceDefinition(wsDefName))
   {
-    std::string nodeDefName = wsDefName + "/Node";
-    this->dataPtr->ogreCompositorNodeDef1st = nodeDefName;
     Ogre::CompositorNodeDef *nodeDef =
         ogreCompMgr->addNodeDefinition(nodeDefName);
     // Input texture
@@ -887,6 +1651,19 @@ void Ogre2GpuRays::Setup1stPass()
     this->dataPtr->cubeCam[i]->setFOVy(Ogre::Degree(90));
     this->dataPtr->cubeCam[i]->setAspectRatio(1);
     this->dataPtr->cubeCam[i]->setNearClipDistance(this->NearClipPlane());
+
+    // only render the region of the face that is sampled. The extents of
+    // the 90 degree frustum at the near plane are [-near, near], with the
+    // top of the image at v = 0.
+    const auto &region = this->dataPtr->sampleTexture->regions[i];
+    double w1st = this->dataPtr->w1st;
+    double h1st = this->dataPtr->h1st;
+    double nearClip = this->NearClipPlane();
+    this->dataPtr->cubeCam[i]->setFrustumExtents(
+        nearClip * (2.0 * region.left / w1st - 1.0),
+        nearClip * (2.0 * region.right / w1st - 1.0),
+        nearClip * (1.0 - 2.0 * region.top / h1st),
+        nearClip * (1.0 - 2.0 * region.bottom / h1st));
     this->dataPtr->cubeCam[i]->setFarClipDistance(this->FarClipPlane());
     this->dataPtr->cubeCam[i]->setFixedYawAxis(false);
     this->dataPtr->cubeCam[i]->yaw(Ogre::Degree(-90));
@@ -911,7 +1688,7 @@ void Ogre2GpuRays::Setup1stPass()
     this->dataPtr->firstPassTextures[i] =
       Ogre::TextureManager::getSingleton().createManual(
       texName.str(), "General", Ogre::TEX_TYPE_2D,
-      this->dataPtr->w1st, this->dataPtr->h1st, 1, 0,
+      region.right - region.left, region.bottom - region.top, 1, 0,
       Ogre::PF_FLOAT32_RGB, Ogre::TU_RENDERTARGET,
       0, false, 0, Ogre::BLANKSTRING, false, true);
 
@@ -922,6 +1699,21 @@ void Ogre2GpuRays::Setup1stPass()
         ogreCompMgr->addWorkspace(this->scene->OgreSceneManager(),
         rt, this->dataPtr->cubeCam[i], wsDefName, false);
 
+    // cull the visuals outside of the visibility mask of the sensor
+    if (!this->dataPtr->visibilityListener)
+    {
+      this->dataPtr->visibilityListener.reset(
+          new Ogre2SensorVisibilityListener(this));
+    }
+    if (!this->dataPtr->firstPassTimerListener)
+    {
+      this->dataPtr->firstPassTimerListener.reset(new Ogre2GpuTimerListener(
+          this->gpuTimerClient, "first pass",
+          this->dataPtr->visibilityListener.get()));
+    }
+    this->dataPtr->ogreCompositorWorkspace1st[i]->setListener(
+        this->dataPtr->firstPassTimerListener.get());
+
     Ogre::CompositorNode *node =
         this->dataPtr->ogreCompositorWorkspace1st[i]->getNodeSequence()[0];
     auto channelsTex = node->getLocalTextures();
@@ -961,7 +1753,7 @@ void Ogre2GpuRays::Setup2ndPass()
       "General",
       Ogre::TEX_TYPE_2D,
       this->dataPtr->w2nd, this->dataPtr->h2nd, 0,
-      Ogre::PF_FLOAT32_RGB,
+      secondPassFormat(this->dataPtr->packedFormat),
       Ogre::TU_RENDERTARGET);
 
   // Create second pass material
@@ -975,21 +1767,43 @@ void Ogre2GpuRays::Setup2ndPass()
   this->dataPtr->matSecondPass->load();
   Ogre::Pass *pass = this->dataPtr->matSecondPass->getTechnique(0)->getPass(0);
 
-  // Connect cubeUVTexture to the GpuRaysScan2nd material's texture unit state
+  // Connect the sample texture to the GpuRaysScan2nd material's texture unit
+  // state
   // The texture unit index (0) must match the one specified in the script
   // See GpuRaysScan2nd definition
-  pass->getTextureUnitState(0)->setTexture(this->dataPtr->cubeUVTexture);
+  pass->getTextureUnitState(0)->setTexture(
+      this->dataPtr->sampleTexture->texture);
+
+  setPackScale(this->dataPtr->matSecondPass, this->dataPtr->packedFormat,
+      this->dataPtr->packedRangeResolution,
+      this->dataPtr->packedIntensityResolution);
+
+  // clip planes and ranges of the readings beyond them, used to apply the
+  // range noise to hits only
+  Ogre::GpuProgramParametersSharedPtr psParams =
+      pass->getFragmentProgramParameters();
+  psParams->setNamedConstant("near",
+      static_cast<float>(this->NearClipPlane()));
+  psParams->setNamedConstant("far",
+      static_cast<float>(this->FarClipPlane()));
+  psParams->setNamedConstant("rangeMin",
+      static_cast<float>(this->dataMinVal));
+  psParams->setNamedConstant("rangeMax",
+      static_cast<float>(this->dataMaxVal));
 
   // connect all cubemap textures to the corresponding texture unit states
   // defined in the GpuRaysScan2nd material
+  Ogre2GpuRaysPtr source = this->dataPtr->cubemapSource.lock();
+  Ogre2GpuRaysPrivate *firstPass =
+      source ? source->dataPtr.get() : this->dataPtr.get();
   Ogre::TextureUnitState *texUnit = nullptr;
-  for (auto i : this->dataPtr->cubeFaceIdx)
+  for (auto i : this->dataPtr->sampleTexture->faces)
   {
     // texIndex need to match how the texture units are defined in the
     // gpu_rays.material script
     unsigned int texIndex = 1 + i;
     texUnit = pass->getTextureUnitState(texIndex);
-    texUnit->setTexture(this->dataPtr->firstPassTextures[i]);
+    texUnit->setTexture(firstPass->firstPassTextures[i]);
   }
 
   // create 2nd pass compositor
@@ -1065,6 +1879,14 @@ void Ogre2GpuRays::Setup2ndPass()
   this->dataPtr->ogreCompositorWorkspace2nd =
       ogreCompMgr->addWorkspace(this->scene->OgreSceneManager(),
       rt, this->dataPtr->ogreCamera, wsDefName, false);
+
+  if (!this->dataPtr->secondPassTimerListener)
+  {
+    this->dataPtr->secondPassTimerListener.reset(new Ogre2GpuTimerListener(
+        this->gpuTimerClient, "second pass"));
+  }
+  this->dataPtr->ogreCompositorWorkspace2nd->setListener(
+      this->dataPtr->secondPassTimerListener.get());
 }
 
 /////////////////////////////////////////////////////////
@@ -1072,34 +1894,114 @@ void Ogre2GpuRays::CreateGpuRaysTextures()
 {
   this->ConfigureCamera();
   this->CreateSampleTexture();
-  this->Setup1stPass();
+  // sensors sampling the cubemap of another sensor have no 1st pass
+  if (!this->dataPtr->cubemapSource.lock())
+    this->Setup1stPass();
   this->Setup2ndPass();
+
+  // faces rendered for each azimuth sector
+  auto &sectorFaces = this->dataPtr->sectorFaces;
+  sectorFaces.clear();
+  const auto &columnFaces = this->dataPtr->sampleTexture->columnFaces;
+  if (this->dataPtr->cubemapSource.lock() || columnFaces.empty())
+  {
+    if (this->dataPtr->sectorCount > 1u)
+    {
+      ignwarn << "Gpu rays [" << this->Name() << "] sample the cubemap of "
+              << "another sensor and are not split in sectors" << std::endl;
+    }
+    this->dataPtr->sectorCount = 1u;
+  }
+  this->dataPtr->sectorCount = std::min(this->dataPtr->sectorCount,
+      this->dataPtr->w2nd);
+  for (unsigned int i = 0u; i < this->dataPtr->sectorCount; ++i)
+  {
+    unsigned int first = 0u;
+    unsigned int count = 0u;
+    this->SectorColumns(i, first, count);
+    uint8_t faces = 0u;
+    for (unsigned int j = first; j < first + count && j < columnFaces.size();
+        ++j)
+    {
+      faces |= columnFaces[j];
+    }
+    sectorFaces.emplace_back();
+    for (auto f : this->dataPtr->cubeFaceIdx)
+    {
+      if (this->dataPtr->sectorCount == 1u || (faces & (1u << f)))
+        sectorFaces.back().push_back(f);
+    }
+  }
+  this->dataPtr->nextSector = 0u;
+  this->dataPtr->cubemapRendered = false;
+  this->dataPtr->renderedSectors.clear();
 }
 
 /////////////////////////////////////////////////
 void Ogre2GpuRays::UpdateRenderTarget1stPass()
 {
-  // update the compositors
-  for (auto i : this->dataPtr->cubeFaceIdx)
-    this->dataPtr->ogreCompositorWorkspace1st[i]->setEnabled(true);
+  // the 2nd pass samples the faces of the current sector, and the last
+  // render of the other faces
+  unsigned int sector = this->dataPtr->nextSector;
+  this->dataPtr->nextSector = (sector + 1u) % this->dataPtr->sectorCount;
+  this->dataPtr->renderedSectors.push_back(sector);
+
+  // nothing to render if the cubemap of another sensor is sampled
+  if (this->dataPtr->cubeFaceIdx.empty() ||
+      sector >= this->dataPtr->sectorFaces.size())
+    return;
+
+  // all faces are rendered first so the other sectors have readings
+  std::vector<unsigned int> faces = this->dataPtr->sectorFaces[sector];
+  if (!this->dataPtr->cubemapRendered)
+  {
+    faces.assign(this->dataPtr->cubeFaceIdx.begin(),
+        this->dataPtr->cubeFaceIdx.end());
+    this->dataPtr->cubemapRendered = true;
+  }
+
   auto engine = Ogre2RenderEngine::Instance();
-  engine->OgreRoot()->renderOneFrame();
-  for (auto i : this->dataPtr->cubeFaceIdx)
-    this->dataPtr->ogreCompositorWorkspace1st[i]->setEnabled(false);
+  if (engine->RenderBatchActive())
+  {
+    for (auto i : faces)
+    {
+      engine->AddToRenderBatch(this->shared_from_this(),
+          this->dataPtr->ogreCompositorWorkspace1st[i], 0u);
+    }
+    return;
+  }
+
+  // update the compositors
+  std::vector<Ogre::CompositorWorkspace *> workspaces;
+  for (auto i : faces)
+    workspaces.push_back(this->dataPtr->ogreCompositorWorkspace1st[i]);
+  engine->RenderWorkspaces(workspaces);
 }
 
 /////////////////////////////////////////////////
 void Ogre2GpuRays::UpdateRenderTarget2ndPass()
 {
-  this->dataPtr->ogreCompositorWorkspace2nd->setEnabled(true);
+  // the 2nd pass samples the 1st pass textures so it is rendered in a
+  // later stage of the batch
   auto engine = Ogre2RenderEngine::Instance();
-  engine->OgreRoot()->renderOneFrame();
-  this->dataPtr->ogreCompositorWorkspace2nd->setEnabled(false);
+  if (engine->RenderBatchActive())
+  {
+    engine->AddToRenderBatch(this->shared_from_this(),
+        this->dataPtr->ogreCompositorWorkspace2nd, 1u);
+    return;
+  }
+
+  engine->RenderWorkspaces({this->dataPtr->ogreCompositorWorkspace2nd});
 }
 
 //////////////////////////////////////////////////
 void Ogre2GpuRays::Render()
 {
+  IGN_RENDERING_PROFILE("Ogre2GpuRays::Render");
+  this->BeginFrameStats();
+  for (auto cam : this->dataPtr->cubeCam)
+    this->scene->AddParticleViewer(cam);
+
   this->UpdateRenderTarget1stPass();
   this->UpdateRenderTarget2ndPass();
 }
@@ -1107,40 +2009,178 @@ void Ogre2GpuRays::Render()
 //////////////////////////////////////////////////
 void Ogre2GpuRays::PreRender()
 {
-  if (!this->dataPtr->cubeUVTexture)
+  IGN_RENDERING_PROFILE("Ogre2GpuRays::PreRender");
+  if (!this->dataPtr->sampleTexture)
     this->CreateGpuRaysTextures();
+
+  for (auto cam : this->dataPtr->cubeCam)
+  {
+    if (cam)
+      cam->setLodBias(this->RenderLodBias());
+  }
+
+  if (setRangeNoise(this->dataPtr->matSecondPass,
+      this->dataPtr->renderPasses, this->dataPtr->noiseFrame))
+  {
+    ++this->dataPtr->noiseFrame;
+  }
 }
 
 //////////////////////////////////////////////////
 void Ogre2GpuRays::PostRender()
 {
+  IGN_RENDERING_PROFILE("Ogre2GpuRays::PostRender");
+  // the range data stays on the GPU
+  if (!this->dataPtr->cpuReadback)
+  {
+    this->dataPtr->renderedSectors.clear();
+    return;
+  }
+
+  // data is read back once the render batch has been rendered
+  auto engine = Ogre2RenderEngine::Instance();
+  if (engine->RenderBatchActive())
+  {
+    engine->DeferPostRender(this->shared_from_this());
+    return;
+  }
+
   unsigned int width = this->dataPtr->w2nd;
   unsigned int height = this->dataPtr->h2nd;
 
+  Ogre::PixelFormat readFormat = secondPassFormat(this->dataPtr->packedFormat);
+  bool packed = readFormat != Ogre::PF_FLOAT32_RGB;
   size_t size = Ogre::PixelUtil::getMemorySize(
-    width, height, 1, Ogre::PF_FLOAT32_RGB);
+    width, height, 1, readFormat);
   int len = width * height * this->Channels();
 
-  if (!this->dataPtr->gpuRaysBuffer)
+  void *readBuffer = nullptr;
+  if (packed)
+  {
+    if (!this->dataPtr->packedBuffer)
+    {
+      this->dataPtr->packedBuffer = new uint16_t[width * height * 2u];
+      MemoryTracker::Track(MC_SENSOR_BUFFER, this->dataPtr->packedBuffer,
+          size);
+    }
+    readBuffer = this->dataPtr->packedBuffer;
+  }
+  else
+  {
+    if (!this->dataPtr->gpuRaysBuffer)
+    {
+      this->dataPtr->gpuRaysBuffer = new float[len];
+      MemoryTracker::Track(MC_SENSOR_BUFFER, this->dataPtr->gpuRaysBuffer,
+          len * sizeof(float));
+    }
+    readBuffer = this->dataPtr->gpuRaysBuffer;
+  }
+  Ogre::PixelBox dstBox(width, height, 1, readFormat, readBuffer);
+
+  // sector of the frame that has just been rendered
+  unsigned int sector = this->dataPtr->renderedSectors.empty() ? 0u :
+      this->dataPtr->renderedSectors.back();
+
+  auto readback = Ogre2ReadbackManager::Instance();
+  if (this->dataPtr->readbackClient)
+  {
+    // queue a copy of the frame that has just been rendered and retrieve a
+    // previous one so the transfer overlaps with the next render
+    if (!readback->Request(this->dataPtr->readbackClient,
+        this->dataPtr->secondPassTexture.get(), readFormat))
+    {
+      ignwarn << "Asynchronous readback failed for gpu rays ["
+              << this->Name() << "], falling back to blocking readback"
+              << std::endl;
+      this->SetAsyncReadback(false);
+    }
+    else if (!readback->Retrieve(this->dataPtr->readbackClient,
+        readBuffer, size))
+    {
+      // no frame available yet
+      return;
+    }
+  }
+
+  if (this->dataPtr->readbackClient)
+  {
+    // the frame retrieved is the oldest in flight
+    if (!this->dataPtr->renderedSectors.empty())
+    {
+      sector = this->dataPtr->renderedSectors.front();
+      this->dataPtr->renderedSectors.pop_front();
+    }
+  }
+  else
   {
-    this->dataPtr->gpuRaysBuffer = new float[len];
+    this->dataPtr->renderedSectors.clear();
+    readback->Read(
+        this->dataPtr->secondPassTexture->getBuffer()->getRenderTarget(),
+        dstBox);
   }
-  Ogre::PixelBox dstBox(width, height,
-        1, Ogre::PF_FLOAT32_RGB, this->dataPtr->gpuRaysBuffer);
+  this->AddReadbackBytes(dstBox.getConsecutiveSize());
 
-  // blit data from gpu to cpu
-  auto rt = this->dataPtr->secondPassTexture->getBuffer()->getRenderTarget();
-  rt->copyContentsToMemory(dstBox, Ogre::RenderTarget::FB_FRONT);
+  if (packed)
+  {
+    this->DispatchFrame(this->dataPtr->newPackedGpuRaysFrame,
+        this->dataPtr->packedBuffer, width * height * 2u, width, height, 2u,
+        PixelUtil::Name(this->dataPtr->packedFormat));
+
+    // the float data is only unpacked for its subscribers
+    if (this->dataPtr->newGpuRaysFrame.ConnectionCount() == 0u &&
+        this->dataPtr->newGpuRaysSector.ConnectionCount() == 0u)
+      return;
+  }
 
   if (!this->dataPtr->gpuRaysScan)
   {
     this->dataPtr->gpuRaysScan = new float[len];
+    MemoryTracker::Track(MC_SENSOR_BUFFER, this->dataPtr->gpuRaysScan,
+        len * sizeof(float));
   }
 
-  memcpy(this->dataPtr->gpuRaysScan, this->dataPtr->gpuRaysBuffer, size);
+  if (packed)
+  {
+    unpackGpuRays(this->dataPtr->packedBuffer, this->dataPtr->packedFormat,
+        this->dataPtr->packedRangeResolution,
+        this->dataPtr->packedIntensityResolution, this->dataMinVal,
+        this->dataMaxVal, this->dataPtr->gpuRaysScan, width * height);
+  }
+  else
+  {
+    memcpy(this->dataPtr->gpuRaysScan, this->dataPtr->gpuRaysBuffer, size);
+  }
 
-  this->dataPtr->newGpuRaysFrame(this->dataPtr->gpuRaysScan,
-      width, height, this->Channels(), "PF_FLOAT32_RGB");
+  this->DispatchFrame(this->dataPtr->newGpuRaysFrame,
+      this->dataPtr->gpuRaysScan, len, width, height, this->Channels(),
+      "PF_FLOAT32_RGB", !packed);
+
+  // readings of the sector rendered by this frame
+  if (this->dataPtr->sectorCount > 1u &&
+      this->dataPtr->newGpuRaysSector.ConnectionCount() > 0u)
+  {
+    unsigned int first = 0u;
+    unsigned int count = 0u;
+    this->SectorColumns(sector, first, count);
+    unsigned int channels = this->Channels();
+    if (!this->dataPtr->sectorScan)
+    {
+      // sectors have at most one more column than the smallest of them
+      size_t sectorLen = (width / this->dataPtr->sectorCount + 1u) * height *
+          channels;
+      this->dataPtr->sectorScan = new float[sectorLen];
+      MemoryTracker::Track(MC_SENSOR_BUFFER, this->dataPtr->sectorScan,
+          sectorLen * sizeof(float));
+    }
+    for (unsigned int i = 0u; i < height; ++i)
+    {
+      memcpy(this->dataPtr->sectorScan + i * count * channels,
+          this->dataPtr->gpuRaysScan + (i * width + first) * channels,
+          count * channels * sizeof(float));
+    }
+    this->dataPtr->newGpuRaysSector(this->dataPtr->sectorScan, sector,
+        first, count, height, channels);
+  }
 
   // Uncomment to debug output
   // igndbg << "wxh: " << width << " x " << height << std::endl;
@@ -1171,9 +2211,288 @@ void Ogre2GpuRays::Copy(float *_dataDest)
   size_t size = Ogre::PixelUtil::getMemorySize(
     width, height, 1, Ogre::PF_FLOAT32_RGB);
 
+  // packed data that has not been unpacked yet
+  if (!this->dataPtr->gpuRaysScan)
+    return;
+
   memcpy(_dataDest, this->dataPtr->gpuRaysScan, size);
 }
 
+//////////////////////////////////////////////////
+void Ogre2GpuRays::CopyPacked(uint16_t *_dataDest) const
+{
+  if (!this->dataPtr->packedBuffer)
+    return;
+
+  memcpy(_dataDest, this->dataPtr->packedBuffer,
+      this->dataPtr->w2nd * this->dataPtr->h2nd * 2u * sizeof(uint16_t));
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuRays::SetRayAngles(const std::vector<math::Vector2d> &_angles)
+{
+  if (this->dataPtr->sampleTexture)
+  {
+    ignerr << "The ray angles of [" << this->Name() << "] must be set "
+           << "before it is first rendered" << std::endl;
+    return;
+  }
+  this->dataPtr->rayAngles = _angles;
+}
+
+//////////////////////////////////////////////////
+const std::vector<math::Vector2d> &Ogre2GpuRays::RayAngles() const
+{
+  return this->dataPtr->rayAngles;
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuRays::SetSectorCount(unsigned int _count)
+{
+  if (this->dataPtr->sampleTexture)
+  {
+    ignerr << "The sector count of [" << this->Name() << "] must be set "
+           << "before it is first rendered" << std::endl;
+    return;
+  }
+  if (_count == 0u)
+  {
+    ignerr << "The sector count of [" << this->Name() << "] must be "
+           << "greater than 0" << std::endl;
+    return;
+  }
+  this->dataPtr->sectorCount = _count;
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2GpuRays::SectorCount() const
+{
+  return this->dataPtr->sectorCount;
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuRays::SectorColumns(unsigned int _sector, unsigned int &_first,
+    unsigned int &_count) const
+{
+  unsigned int width = this->dataPtr->w2nd ?
+      this->dataPtr->w2nd : this->RangeCount();
+  unsigned int sectorCount = std::min(this->dataPtr->sectorCount, width);
+  if (_sector >= sectorCount)
+  {
+    _first = width;
+    _count = 0u;
+    return;
+  }
+  _first = static_cast<unsigned int>(
+      static_cast<uint64_t>(_sector) * width / sectorCount);
+  unsigned int last = static_cast<unsigned int>(
+      static_cast<uint64_t>(_sector + 1u) * width / sectorCount);
+  _count = last - _first;
+}
+
+//////////////////////////////////////////////////
+ignition::common::ConnectionPtr Ogre2GpuRays::ConnectNewGpuRaysSector(
+    std::function<void(const float *_frame, unsigned int _sector,
+    unsigned int _first, unsigned int _width, unsigned int _height,
+    unsigned int _channels)> _subscriber)
+{
+  return this->dataPtr->newGpuRaysSector.Connect(_subscriber);
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuRays::AddRenderPass(const RenderPassPtr &_pass)
+{
+  if (!_pass)
+    return;
+
+  // the passes are applied by the 2nd pass material, see setRangeNoise
+  bool noise = std::dynamic_pointer_cast<GaussianNoisePass>(_pass) != nullptr;
+  bool dropout = std::dynamic_pointer_cast<DropoutPass>(_pass) != nullptr;
+  if (!noise && !dropout)
+  {
+    ignerr << "Gpu rays currently only support gaussian noise and dropout "
+           << "passes" << std::endl;
+    return;
+  }
+
+  for (const auto &pass : this->dataPtr->renderPasses)
+  {
+    bool sameType = noise ?
+        std::dynamic_pointer_cast<GaussianNoisePass>(pass) != nullptr :
+        std::dynamic_pointer_cast<DropoutPass>(pass) != nullptr;
+    if (sameType)
+    {
+      ignerr << "Gpu rays [" << this->Name() << "] already have a "
+             << (noise ? "gaussian noise" : "dropout") << " pass"
+             << std::endl;
+      return;
+    }
+  }
+  this->dataPtr->renderPasses.push_back(_pass);
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuRays::RemoveRenderPass(const RenderPassPtr &_pass)
+{
+  auto &passes = this->dataPtr->renderPasses;
+  passes.erase(std::remove(passes.begin(), passes.end(), _pass),
+      passes.end());
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2GpuRays::RenderPassCount() const
+{
+  return static_cast<unsigned int>(this->dataPtr->renderPasses.size());
+}
+
+//////////////////////////////////////////////////
+RenderPassPtr Ogre2GpuRays::RenderPassByIndex(unsigned int _index) const
+{
+  if (_index >= this->dataPtr->renderPasses.size())
+  {
+    ignerr << "RenderPass index out of range: " << _index << std::endl;
+    return RenderPassPtr();
+  }
+  return this->dataPtr->renderPasses[_index];
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuRays::SetPackedFormat(PixelFormat _format)
+{
+  if (this->dataPtr->sampleTexture)
+  {
+    ignerr << "The packed format of [" << this->Name() << "] must be set "
+           << "before it is first rendered" << std::endl;
+    return;
+  }
+
+  if (_format != PF_FLOAT32_R && _format != PF_FLOAT16_R &&
+      _format != PF_L16)
+  {
+    ignerr << "Unsupported packed format [" << PixelUtil::Name(_format)
+           << "] for gpu rays [" << this->Name() << "]. Supported formats "
+           << "are FLOAT16_R, L16 and FLOAT32_R" << std::endl;
+    return;
+  }
+
+  this->dataPtr->packedFormat = _format;
+}
+
+//////////////////////////////////////////////////
+PixelFormat Ogre2GpuRays::PackedFormat() const
+{
+  return this->dataPtr->packedFormat;
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuRays::SetPackedResolution(double _range, double _intensity)
+{
+  if (!(_range > 0.0) || !(_intensity > 0.0))
+  {
+    ignerr << "Packed resolutions of gpu rays [" << this->Name() << "] "
+           << "must be positive" << std::endl;
+    return;
+  }
+
+  this->dataPtr->packedRangeResolution = _range;
+  this->dataPtr->packedIntensityResolution = _intensity;
+  setPackScale(this->dataPtr->matSecondPass, this->dataPtr->packedFormat,
+      _range, _intensity);
+}
+
+//////////////////////////////////////////////////
+double Ogre2GpuRays::PackedRangeResolution() const
+{
+  return this->dataPtr->packedRangeResolution;
+}
+
+//////////////////////////////////////////////////
+double Ogre2GpuRays::PackedIntensityResolution() const
+{
+  return this->dataPtr->packedIntensityResolution;
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuRays::SetAsyncReadback(bool _enabled)
+{
+  auto readback = Ogre2ReadbackManager::Instance();
+  if (!_enabled)
+  {
+    readback->DestroyClient(this->dataPtr->readbackClient);
+    this->dataPtr->readbackClient = 0u;
+    this->dataPtr->renderedSectors.clear();
+    return;
+  }
+
+  if (this->dataPtr->readbackClient)
+    return;
+
+  this->dataPtr->readbackClient = readback->CreateClient();
+  if (!this->dataPtr->readbackClient)
+  {
+    ignwarn << "Asynchronous readback is not supported by the current "
+            << "render system. Gpu rays [" << this->Name() << "] will "
+            << "use blocking readback" << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+bool Ogre2GpuRays::AsyncReadback() const
+{
+  return this->dataPtr->readbackClient != 0u;
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2GpuRays::RenderTextureGLId() const
+{
+  if (!this->dataPtr->secondPassTexture)
+    return 0u;
+
+  unsigned int texId = 0u;
+  this->dataPtr->secondPassTexture->getCustomAttribute("GLID", &texId);
+
+  return texId;
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuRays::SetCpuReadback(bool _enabled)
+{
+  this->dataPtr->cpuReadback = _enabled;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2GpuRays::CpuReadback() const
+{
+  return this->dataPtr->cpuReadback;
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuRays::SetCubemapSource(Ogre2GpuRaysPtr _source)
+{
+  if (this->dataPtr->sampleTexture)
+  {
+    ignerr << "The cubemap source of [" << this->Name() << "] must be set "
+           << "before it is first rendered" << std::endl;
+    return;
+  }
+
+  if (_source && (_source.get() == this || _source->CubemapSource()))
+  {
+    ignerr << "[" << _source->Name() << "] can not be the cubemap source of ["
+           << this->Name() << "] since it does not render its own cubemap"
+           << std::endl;
+    return;
+  }
+
+  this->dataPtr->cubemapSource = _source;
+}
+
+//////////////////////////////////////////////////
+Ogre2GpuRaysPtr Ogre2GpuRays::CubemapSource() const
+{
+  return this->dataPtr->cubemapSource.lock();
+}
+
 /////////////////////////////////////////////////
 void Ogre2GpuRays::Set1stTextureSize(
     const unsigned int _w, const unsigned int _h)
@@ -1199,6 +2518,15 @@ ignition::common::ConnectionPtr Ogre2GpuRays::ConnectNewGpuRaysFrame(
   return this->dataPtr->newGpuRaysFrame.Connect(_subscriber);
 }
 
+//////////////////////////////////////////////////
+ignition::common::ConnectionPtr Ogre2GpuRays::ConnectNewPackedGpuRaysFrame(
+    std::function<void(const uint16_t *_frame, unsigned int _width,
+    unsigned int _height, unsigned int _channels,
+    const std::string &_format)> _subscriber)
+{
+  return this->dataPtr->newPackedGpuRaysFrame.Connect(_subscriber);
+}
+
 //////////////////////////////////////////////////
 RenderTargetPtr Ogre2GpuRays::RenderTarget() const
 {
@@ -0,0 +1,362 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Not Apple or Windows
+#if !defined(__APPLE__) && !defined(_WIN32)
+# ifndef GL_GLEXT_PROTOTYPES
+#  define GL_GLEXT_PROTOTYPES
+# endif
+# include <GL/gl.h>
+# include <GL/glext.h>
+# define IGN_OGRE2_GPU_TIMER 1
+#endif
+
+#include <string>
+#include <utility>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderPass.hh"
+
+#include "Ogre2GpuTimer.hh"
+#include "Ogre2RenderStats.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Maximum number of frames whose timestamps are not collected.
+/// The oldest frame is waited on once it is exceeded.
+static const size_t kMaxFramesInFlight = 4u;
+
+/// \brief Label of the passes of the shadow nodes
+static const std::string kShadowsLabel = "shadows";
+
+//////////////////////////////////////////////////
+Ogre2GpuTimer::~Ogre2GpuTimer()
+{
+  this->Reset();
+}
+
+//////////////////////////////////////////////////
+bool Ogre2GpuTimer::Supported()
+{
+#ifdef IGN_OGRE2_GPU_TIMER
+  auto engine = Ogre2RenderEngine::Instance();
+  if (!engine->IsInitialized() || !engine->OgreRoot())
+    return false;
+  Ogre::RenderSystem *renderSys = engine->OgreRoot()->getRenderSystem();
+  return renderSys &&
+      renderSys->getName().find("OpenGL 3+") != std::string::npos;
+#else
+  return false;
+#endif
+}
+
+//////////////////////////////////////////////////
+bool Ogre2GpuTimer::SetEnabled(bool _enabled)
+{
+  if (_enabled == this->enabled)
+    return true;
+
+  if (!_enabled)
+  {
+    this->Reset();
+    return true;
+  }
+
+  if (!Supported())
+    return false;
+
+  Ogre2RenderEngine::Instance()->OgreRoot()->addFrameListener(this);
+  this->listening = true;
+  this->enabled = true;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2GpuTimer::Enabled() const
+{
+  return this->enabled;
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2GpuTimer::CreateClient()
+{
+  unsigned int id = ++this->clientCounter;
+  this->times[id];
+  return id;
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuTimer::DestroyClient(unsigned int _client)
+{
+  this->times.erase(_client);
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuTimer::Mark(unsigned int _client, const std::string &_label)
+{
+#ifdef IGN_OGRE2_GPU_TIMER
+  if (!this->enabled)
+    return;
+
+  // consecutive timestamps charged to the same label are merged
+  if (!this->frame.empty() && this->frame.back().client == _client &&
+      this->frame.back().label == _label)
+  {
+    return;
+  }
+
+  Timestamp stamp;
+  stamp.query = this->AcquireQuery();
+  stamp.client = _client;
+  stamp.label = _label;
+  glQueryCounter(stamp.query, GL_TIMESTAMP);
+  this->frame.push_back(std::move(stamp));
+#else
+  (void) _client;
+  (void) _label;
+#endif
+}
+
+//////////////////////////////////////////////////
+std::map<std::string, double> Ogre2GpuTimer::Times(
+    unsigned int _client) const
+{
+  auto it = this->times.find(_client);
+  if (it == this->times.end())
+    return std::map<std::string, double>();
+  return it->second;
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuTimer::Reset()
+{
+#ifdef IGN_OGRE2_GPU_TIMER
+  std::vector<unsigned int> queries;
+  queries.swap(this->freeQueries);
+  for (const auto &stamp : this->frame)
+    queries.push_back(stamp.query);
+  for (const auto &stamps : this->frames)
+  {
+    for (const auto &stamp : stamps)
+      queries.push_back(stamp.query);
+  }
+  if (!queries.empty())
+    glDeleteQueries(static_cast<GLsizei>(queries.size()), queries.data());
+#endif
+  this->frame.clear();
+  this->frames.clear();
+
+  for (auto &clientTimes : this->times)
+    clientTimes.second.clear();
+
+  if (this->listening)
+  {
+    auto engine = Ogre2RenderEngine::Instance();
+    if (engine->OgreRoot())
+      engine->OgreRoot()->removeFrameListener(this);
+    this->listening = false;
+  }
+  this->enabled = false;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2GpuTimer::frameRenderingQueued(const Ogre::FrameEvent &/*_evt*/)
+{
+  if (!this->frame.empty())
+  {
+    // the last pass lasts until the end of the frame
+    this->Mark(0u, std::string());
+    this->frames.push_back(std::move(this->frame));
+    this->frame.clear();
+  }
+  this->Collect();
+  return true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuTimer::Collect()
+{
+#ifdef IGN_OGRE2_GPU_TIMER
+  while (!this->frames.empty())
+  {
+    std::vector<Timestamp> &stamps = this->frames.front();
+
+    if (this->frames.size() <= kMaxFramesInFlight)
+    {
+      bool available = true;
+      for (const auto &stamp : stamps)
+      {
+        GLint result = 0;
+        glGetQueryObjectiv(stamp.query, GL_QUERY_RESULT_AVAILABLE, &result);
+        if (!result)
+        {
+          available = false;
+          break;
+        }
+      }
+      if (!available)
+        return;
+    }
+
+    // waits for the timestamps not written yet
+    std::vector<GLuint64> values(stamps.size(), 0u);
+    for (size_t i = 0u; i < stamps.size(); ++i)
+      glGetQueryObjectui64v(stamps[i].query, GL_QUERY_RESULT, &values[i]);
+
+    std::map<unsigned int, std::map<std::string, double>> frameTimes;
+    for (size_t i = 0u; i + 1u < stamps.size(); ++i)
+    {
+      const Timestamp &stamp = stamps[i];
+      if (stamp.client == 0u || values[i + 1u] < values[i] ||
+          this->times.find(stamp.client) == this->times.end())
+      {
+        continue;
+      }
+      // nanoseconds to milliseconds
+      frameTimes[stamp.client][stamp.label] +=
+          static_cast<double>(values[i + 1u] - values[i]) * 1e-6;
+    }
+    for (auto &clientTimes : frameTimes)
+      this->times[clientTimes.first] = std::move(clientTimes.second);
+
+    for (const auto &stamp : stamps)
+      this->freeQueries.push_back(stamp.query);
+    this->frames.pop_front();
+  }
+#endif
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2GpuTimer::AcquireQuery()
+{
+#ifdef IGN_OGRE2_GPU_TIMER
+  if (!this->freeQueries.empty())
+  {
+    unsigned int query = this->freeQueries.back();
+    this->freeQueries.pop_back();
+    return query;
+  }
+
+  GLuint query = 0u;
+  glGenQueries(1, &query);
+  return query;
+#else
+  return 0u;
+#endif
+}
+
+//////////////////////////////////////////////////
+Ogre2GpuTimerListener::Ogre2GpuTimerListener(unsigned int _client,
+    const std::string &_label, Ogre::CompositorWorkspaceListener *_next)
+  : client(_client), label(_label), next(_next)
+{
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuTimerListener::SetClient(unsigned int _client)
+{
+  this->client = _client;
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuTimerListener::SetNodeLabel(const std::string &_nodeDefName,
+    const std::string &_label)
+{
+  this->nodeLabels[Ogre::IdString(_nodeDefName)] = _label;
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuTimerListener::SetRenderPassLabels(
+    const std::vector<RenderPassPtr> &_renderPasses)
+{
+  std::map<std::string, std::string> fusedLabels;
+  for (const auto &pass : _renderPasses)
+  {
+    Ogre2RenderPass *ogre2RenderPass =
+        dynamic_cast<Ogre2RenderPass *>(pass.get());
+    if (!ogre2RenderPass)
+      continue;
+
+    std::string nodeDefName =
+        ogre2RenderPass->OgreCompositorNodeDefinitionName();
+    if (nodeDefName.empty())
+      continue;
+    this->SetNodeLabel(nodeDefName, nodeDefName);
+
+    std::string fusedNodeDefName = ogre2RenderPass->FusedNodeDefinitionName();
+    if (fusedNodeDefName.empty())
+      continue;
+    std::string &fusedLabel = fusedLabels[fusedNodeDefName];
+    if (!fusedLabel.empty())
+      fusedLabel += "+";
+    fusedLabel += nodeDefName;
+  }
+
+  for (const auto &fusedLabel : fusedLabels)
+    this->SetNodeLabel(fusedLabel.first, fusedLabel.second);
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuTimerListener::workspacePreUpdate(
+    Ogre::CompositorWorkspace *_workspace)
+{
+  if (this->next)
+    this->next->workspacePreUpdate(_workspace);
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuTimerListener::passPreExecute(Ogre::CompositorPass *_pass)
+{
+  Ogre2RenderStats::Instance()->Mark(this->client);
+  Ogre2GpuTimer::Instance()->Mark(this->client,
+      this->Label(_pass->getParentNode()));
+
+  if (this->next)
+    this->next->passPreExecute(_pass);
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuTimerListener::passSceneAfterShadowMaps(
+    Ogre::CompositorPassScene *_pass)
+{
+  // the scene pass draws the scene once its shadow maps are rendered
+  Ogre2GpuTimer::Instance()->Mark(this->client,
+      this->Label(_pass->getParentNode()));
+
+  if (this->next)
+    this->next->passSceneAfterShadowMaps(_pass);
+}
+
+//////////////////////////////////////////////////
+const std::string &Ogre2GpuTimerListener::Label(
+    Ogre::CompositorNode *_node) const
+{
+  if (!_node)
+    return this->label;
+
+  if (dynamic_cast<Ogre::CompositorShadowNode *>(_node))
+    return kShadowsLabel;
+
+  auto it = this->nodeLabels.find(_node->getName());
+  if (it != this->nodeLabels.end())
+    return it->second;
+
+  return this->label;
+}
@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2GPUTIMER_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2GPUTIMER_HH_
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <ignition/common/SingletonT.hh>
+
+#include "ignition/rendering/RenderPass.hh"
+#include "ignition/rendering/ogre2/Ogre2Includes.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Measures the GPU time of the compositor passes of the ogre2
+    /// workspaces with GL timestamp queries. A timestamp is written each
+    /// time a pass begins, and the GPU time until the next timestamp is
+    /// charged to a label of a client, usually a sensor. The timestamps of
+    /// a frame are collected once all of them are available, so the times
+    /// reported lag a few frames behind and the render loop never waits on
+    /// the GPU.
+    class Ogre2GpuTimer :
+      public common::SingletonT<Ogre2GpuTimer>,
+      public Ogre::FrameListener
+    {
+      /// \brief Constructor
+      private: Ogre2GpuTimer() = default;
+
+      /// \brief Destructor
+      public: ~Ogre2GpuTimer();
+
+      /// \brief Check if GPU timing is supported by the current platform
+      /// and render system
+      /// \return True if supported
+      public: static bool Supported();
+
+      /// \brief Enable or disable the timestamps. Disabling discards the
+      /// frames in flight and the times of all clients.
+      /// \param[in] _enabled True to enable
+      /// \return True if the timer is in the requested state
+      public: bool SetEnabled(bool _enabled);
+
+      /// \brief Check if the timestamps are enabled
+      /// \return True if enabled
+      public: bool Enabled() const;
+
+      /// \brief Register a new client
+      /// \return Id of the new client
+      public: unsigned int CreateClient();
+
+      /// \brief Unregister a client and discard its times
+      /// \param[in] _client Id of client
+      public: void DestroyClient(unsigned int _client);
+
+      /// \brief Write a timestamp. The GPU time until the next timestamp
+      /// of the frame is charged to the given label. Does nothing unless
+      /// the timer is enabled.
+      /// \param[in] _client Id of client, 0 for time charged to nobody
+      /// \param[in] _label Label of the client the time is charged to
+      public: void Mark(unsigned int _client, const std::string &_label);
+
+      /// \brief Get the GPU times of the last frame collected in which a
+      /// client rendered
+      /// \param[in] _client Id of client
+      /// \return GPU time in milliseconds of each label of the client
+      public: std::map<std::string, double> Times(unsigned int _client) const;
+
+      /// \brief Discard all frames and release all queries. Must be called
+      /// while the GL context is still valid.
+      public: void Reset();
+
+      /// \brief Close the frame rendered by Ogre::Root::renderOneFrame and
+      /// collect the frames whose timestamps are available
+      /// \param[in] _evt Frame event
+      /// \return True to continue rendering
+      public: virtual bool frameRenderingQueued(const Ogre::FrameEvent &_evt)
+          override;
+
+      /// \brief Collect the oldest frames whose timestamps are available.
+      /// The oldest frame is waited on if there are too many frames in
+      /// flight.
+      private: void Collect();
+
+      /// \brief Get a query from the pool, generating a new one if none is
+      /// available
+      /// \return GL id of query
+      private: unsigned int AcquireQuery();
+
+      /// \brief A timestamp
+      private: struct Timestamp
+      {
+        /// \brief GL id of the query
+        unsigned int query = 0u;
+
+        /// \brief Id of the client the time until the next timestamp is
+        /// charged to
+        unsigned int client = 0u;
+
+        /// \brief Label the time until the next timestamp is charged to
+        std::string label;
+      };
+
+      /// \brief Timestamps of the frame being rendered
+      private: std::vector<Timestamp> frame;
+
+      /// \brief Frames whose timestamps are not collected yet, in
+      /// submission order
+      private: std::list<std::vector<Timestamp>> frames;
+
+      /// \brief Pool of free queries
+      private: std::vector<unsigned int> freeQueries;
+
+      /// \brief Times of the last frame collected of each registered client
+      private: std::map<unsigned int, std::map<std::string, double>> times;
+
+      /// \brief Counter used to generate client ids
+      private: unsigned int clientCounter = 0u;
+
+      /// \brief True if the timestamps are enabled
+      private: bool enabled = false;
+
+      /// \brief True if the timer is a frame listener of the ogre root
+      private: bool listening = false;
+
+      /// \brief Make the singleton class a friend
+      private: friend class common::SingletonT<Ogre2GpuTimer>;
+    };
+
+    /// \brief Workspace listener writing the timestamps of the passes of
+    /// a workspace to the GPU timer. The passes of the shadow nodes are
+    /// charged to the "shadows" label, the passes of the nodes given a
+    /// label to that label, and the other passes to the label of the
+    /// workspace. The rendering metrics recorded during the passes are
+    /// charged to the client by Ogre2RenderStats. The listener forwards the
+    /// events to another listener, since a workspace only has one.
+    class Ogre2GpuTimerListener :
+      public Ogre::CompositorWorkspaceListener
+    {
+      /// \brief Constructor
+      /// \param[in] _client Id of the GPU timer client
+      /// \param[in] _label Label of the passes of the workspace
+      /// \param[in] _next Listener the events are forwarded to, null for
+      /// none. It must outlive this listener.
+      public: Ogre2GpuTimerListener(unsigned int _client,
+          const std::string &_label,
+          Ogre::CompositorWorkspaceListener *_next = nullptr);
+
+      /// \brief Destructor
+      public: virtual ~Ogre2GpuTimerListener() = default;
+
+      /// \brief Set the GPU timer client the passes are charged to
+      /// \param[in] _client Id of the GPU timer client
+      public: void SetClient(unsigned int _client);
+
+      /// \brief Set the label of the passes of a node
+      /// \param[in] _nodeDefName Name of the node definition
+      /// \param[in] _label Label of the passes of the node
+      public: void SetNodeLabel(const std::string &_nodeDefName,
+          const std::string &_label);
+
+      /// \brief Label the nodes of the ogre2 render passes, by the name of
+      /// their node definition. Fused passes are labelled by the names of
+      /// the passes they draw joined by '+'.
+      /// \param[in] _renderPasses Render passes
+      public: void SetRenderPassLabels(
+          const std::vector<RenderPassPtr> &_renderPasses);
+
+      // Documentation inherited.
+      public: virtual void workspacePreUpdate(
+          Ogre::CompositorWorkspace *_workspace) override;
+
+      // Documentation inherited.
+      public: virtual void passPreExecute(Ogre::CompositorPass *_pass)
+          override;
+
+      // Documentation inherited.
+      public: virtual void passSceneAfterShadowMaps(
+          Ogre::CompositorPassScene *_pass) override;
+
+      /// \brief Get the label of the passes of a node
+      /// \param[in] _node Compositor node
+      /// \return Label of the passes
+      private: const std::string &Label(Ogre::CompositorNode *_node) const;
+
+      /// \brief Id of the GPU timer client
+      private: unsigned int client = 0u;
+
+      /// \brief Label of the passes of the workspace
+      private: std::string label;
+
+      /// \brief Label of the passes of each labelled node
+      private: std::map<Ogre::IdString, std::string> nodeLabels;
+
+      /// \brief Listener the events are forwarded to
+      private: Ogre::CompositorWorkspaceListener *next = nullptr;
+    };
+    }
+  }
+}
+
+#endif
@@ -15,12 +15,19 @@
  *
 */
 
+#include <string>
+#include <vector>
+
 #include <ignition/common/Console.hh>
+#include <ignition/common/Mesh.hh>
+#include <ignition/common/MeshManager.hh>
+#include <ignition/common/SubMesh.hh>
 
 #include "ignition/rendering/ogre2/Ogre2Grid.hh"
 #include "ignition/rendering/ogre2/Ogre2Material.hh"
+#include "ignition/rendering/ogre2/Ogre2Mesh.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
-#include "ignition/rendering/ogre2/Ogre2DynamicRenderable.hh"
+#include "ignition/rendering/ogre2/Ogre2Visual.hh"
 
 using namespace ignition;
 using namespace rendering;
@@ -30,8 +37,9 @@ class ignition::rendering::Ogre2GridPrivate
   /// \brief Grid materal
   public: Ogre2MaterialPtr material;
 
-  /// \brief Ogre renderable used to render the grid.
-  public: std::shared_ptr<Ogre2DynamicRenderable> grid = nullptr;
+  /// \brief Mesh used to render the grid. Its line list is shared by all
+  /// the grids with the same parameters
+  public: Ogre2MeshPtr grid = nullptr;
 };
 
 //////////////////////////////////////////////////
@@ -58,7 +66,10 @@ void Ogre2Grid::PreRender()
 //////////////////////////////////////////////////
 Ogre::MovableObject *Ogre2Grid::OgreObject() const
 {
-  return this->dataPtr->grid->OgreObject();
+  if (this->dataPtr->grid)
+    return this->dataPtr->grid->OgreObject();
+  else
+    return nullptr;
 }
 
 //////////////////////////////////////////////////
@@ -67,19 +78,68 @@ void Ogre2Grid::Init()
   this->Create();
 }
 
+//////////////////////////////////////////////////
+void Ogre2Grid::Destroy()
+{
+  BaseGrid::Destroy();
+
+  if (this->dataPtr->grid)
+  {
+    this->dataPtr->grid->Destroy();
+    this->dataPtr->grid.reset();
+  }
+  this->dataPtr->material.reset();
+}
+
 //////////////////////////////////////////////////
 void Ogre2Grid::Create()
 {
-  if (!this->dataPtr->grid)
+  common::MeshManager *meshMgr = common::MeshManager::Instance();
+  std::string gridMeshName = "grid_mesh";
+  gridMeshName += "_" + std::to_string(this->cellCount)
+      + "_" + std::to_string(this->verticalCellCount)
+      + "_" + std::to_string(this->cellLength)
+      + "_" + std::to_string(this->heightOffset);
+
+  // Create new mesh if needed
+  if (!meshMgr->HasMesh(gridMeshName))
+    this->CreateMesh(gridMeshName);
+
+  MeshDescriptor meshDescriptor;
+  meshDescriptor.mesh = meshMgr->MeshByName(gridMeshName);
+  if (meshDescriptor.mesh == nullptr)
   {
-    this->dataPtr->grid.reset(new Ogre2DynamicRenderable(this->scene));
+    ignerr << "Grid mesh is unavailable in the Mesh Manager" << std::endl;
+    return;
   }
 
-  // Clear any previous data from the grid and update
-  this->dataPtr->grid->Clear();
-  this->dataPtr->grid->Update();
+  auto visual = std::dynamic_pointer_cast<Ogre2Visual>(this->Parent());
 
-  this->dataPtr->grid->SetOperationType(MarkerType::MT_LINE_LIST);
+  // clear geom if needed
+  if (this->dataPtr->grid)
+  {
+    if (visual)
+    {
+      visual->RemoveGeometry(
+          std::dynamic_pointer_cast<Geometry>(shared_from_this()));
+    }
+    this->dataPtr->grid->Destroy();
+  }
+  this->dataPtr->grid = std::dynamic_pointer_cast<Ogre2Mesh>(
+      this->Scene()->CreateMesh(meshDescriptor));
+  if (this->dataPtr->grid && this->dataPtr->material)
+    this->dataPtr->grid->SetMaterial(this->dataPtr->material, false);
+  if (visual)
+  {
+    visual->AddGeometry(
+        std::dynamic_pointer_cast<Geometry>(shared_from_this()));
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2Grid::CreateMesh(const std::string &_name)
+{
+  std::vector<math::Vector3d> points;
   double baseExtent = (this->cellLength *
      static_cast<double>(this->cellCount - this->cellCount % 2))/2;
   for (unsigned int h = 0; h <= this->verticalCellCount; ++h)
@@ -107,10 +167,10 @@ void Ogre2Grid::Create()
       math::Vector3d p3{-baseExtent, inc, hReal};
       math::Vector3d p4{extent, inc, hReal};
 
-      this->dataPtr->grid->AddPoint(p1);
-      this->dataPtr->grid->AddPoint(p2);
-      this->dataPtr->grid->AddPoint(p3);
-      this->dataPtr->grid->AddPoint(p4);
+      points.push_back(p1);
+      points.push_back(p2);
+      points.push_back(p3);
+      points.push_back(p4);
     }
   }
   if (this->verticalCellCount > 0)
@@ -141,12 +201,25 @@ void Ogre2Grid::Create()
           yReal += this->cellLength;
         }
 
-        this->dataPtr->grid->AddPoint(xReal, yReal, zBottom);
-        this->dataPtr->grid->AddPoint(xReal, yReal, zTop);
+        points.push_back({xReal, yReal, zBottom});
+        points.push_back({xReal, yReal, zTop});
       }
     }
   }
-  this->dataPtr->grid->Update();
+
+  common::SubMesh subMesh;
+  subMesh.SetPrimitiveType(common::SubMesh::LINES);
+  for (const auto &p : points)
+  {
+    subMesh.AddIndex(subMesh.VertexCount());
+    subMesh.AddVertex(p);
+    subMesh.AddNormal(math::Vector3d::UnitZ);
+  }
+
+  common::Mesh *mesh = new common::Mesh();
+  mesh->SetName(_name);
+  mesh->AddSubMesh(subMesh);
+  common::MeshManager::Instance()->AddMesh(mesh);
 }
 
 //////////////////////////////////////////////////
@@ -165,8 +238,9 @@ void Ogre2Grid::SetMaterial(MaterialPtr _material, bool _unique)
     return;
   }
 
-  // Set material for the underlying dynamic renderable
-  this->dataPtr->grid->SetMaterial(_material, false);
+  // Set material for the underlying mesh
+  if (this->dataPtr->grid)
+    this->dataPtr->grid->SetMaterial(_material, false);
   this->SetMaterialImpl(derived);
 }
 
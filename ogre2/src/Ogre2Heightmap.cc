@@ -0,0 +1,1165 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/math/Helpers.hh>
+
+#include "ignition/rendering/ogre2/Ogre2Conversions.hh"
+#include "ignition/rendering/ogre2/Ogre2Heightmap.hh"
+#include "ignition/rendering/ogre2/Ogre2Material.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+#include "ignition/rendering/ogre2/Ogre2Scene.hh"
+#include "ignition/rendering/ogre2/Ogre2Visual.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreItem.h>
+#include <OgreMesh2.h>
+#include <OgreMeshManager2.h>
+#include <OgreSceneManager.h>
+#include <OgreSceneNode.h>
+#include <OgreSubMesh2.h>
+#include <Vao/OgreVaoManager.h>
+#include <Vao/OgreVertexArrayObject.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+/// \brief Name of the empty mesh shared by the ogre objects of all the
+/// heightmaps
+static const char kHeightmapAnchorMeshName[] = "ign_heightmap_anchor";
+
+/// \brief Number of cells along the side of a tile
+static const unsigned int kTileCells = 32u;
+
+/// \brief A tile is split when a viewer is closer to it than its size
+/// times this factor
+static const double kLodDistanceFactor = 2.0;
+
+/// \brief Maximum number of tiles drawn in a frame
+static const unsigned int kMaxVisibleTiles = 256u;
+
+/// \brief Maximum number of tiles built in a frame. Tiles that are not
+/// built yet are replaced by their parent until they are.
+static const unsigned int kMaxTileBuildsPerFrame = 16u;
+
+/// \brief Maximum number of tiles which samples are read from a tile
+/// source at the same time
+static const unsigned int kMaxPendingLoads = 4u;
+
+/// \brief Number of floats per vertex: position, normal and texture
+/// coordinates
+static const unsigned int kTileVertexSize = 8u;
+
+/// \brief A tile of the heightmap quadtree. A tile covers a square of the
+/// heightmap samples and draws it with kTileCells cells per side, skipping
+/// samples further away from the leaves.
+struct Ogre2HeightmapTile
+{
+  /// \brief First heightmap sample covered by the tile
+  unsigned int x = 0u;
+
+  /// \brief First heightmap sample covered by the tile
+  unsigned int y = 0u;
+
+  /// \brief Number of heightmap samples between two vertices of the tile
+  unsigned int stride = 1u;
+
+  /// \brief Bounding box of the tile in the frame of the heightmap. Until
+  /// the samples are loaded, the height range is the one of the parent.
+  Ogre::Aabb bounds;
+
+  /// \brief Heights of the samples of the tile, with a ring of samples
+  /// around them for the normals. Empty until loaded.
+  std::vector<float> samples;
+
+  /// \brief Samples being read from the tile source in the background
+  std::future<std::vector<float>> loading;
+
+  /// \brief Frame the tile was last drawn or refined in
+  unsigned int lastUsed = 0u;
+
+  /// \brief Memory used by the samples and the geometry of the tile, in
+  /// bytes
+  size_t memory = 0u;
+
+  /// \brief Ogre mesh of the tile
+  Ogre::MeshPtr mesh;
+
+  /// \brief Ogre item drawing the mesh, null until the tile is built
+  Ogre::Item *item = nullptr;
+
+  /// \brief Vertex buffer of the tile
+  Ogre::VertexBufferPacked *vertexBuffer = nullptr;
+
+  /// \brief Index buffer of the tile
+  Ogre::IndexBufferPacked *indexBuffer = nullptr;
+
+  /// \brief Vertex array object of the tile
+  Ogre::VertexArrayObject *vao = nullptr;
+
+  /// \brief Children of the tile, created when the tile is first split
+  std::unique_ptr<Ogre2HeightmapTile> children[4];
+};
+
+/// \brief Private data for the Ogre2Heightmap class
+class ignition::rendering::Ogre2HeightmapPrivate
+{
+  /// \brief Get the position of a sample of a loaded tile in the frame of
+  /// the heightmap
+  /// \param[in] _tile Tile
+  /// \param[in] _i Vertex of the tile along the x axis, -1 to
+  /// tileCells + 1 included
+  /// \param[in] _j Vertex of the tile along the y axis, -1 to
+  /// tileCells + 1 included
+  /// \return Position of the sample
+  public: Ogre::Vector3 SamplePosition(const Ogre2HeightmapTile &_tile,
+      int _i, int _j) const;
+
+  /// \brief Create a tile. The samples of the tile are read right away
+  /// from the heightmap data, or later from the tile source.
+  /// \param[in] _x First heightmap sample covered by the tile
+  /// \param[in] _y First heightmap sample covered by the tile
+  /// \param[in] _stride Number of samples between two vertices
+  /// \param[in] _parent Parent of the tile, null for the root
+  /// \return The new tile
+  public: std::unique_ptr<Ogre2HeightmapTile> CreateTile(unsigned int _x,
+      unsigned int _y, unsigned int _stride,
+      const Ogre2HeightmapTile *_parent);
+
+  /// \brief Check if the samples of a tile are loaded, starting to read
+  /// them from the tile source if needed
+  /// \param[in] _tile Tile
+  /// \return True if the samples are loaded
+  public: bool LoadTile(Ogre2HeightmapTile &_tile);
+
+  /// \brief Store the samples of a tile and compute its bounds from them
+  /// \param[in] _tile Tile
+  /// \param[in] _samples Samples of the tile
+  public: void SetSamples(Ogre2HeightmapTile &_tile,
+      std::vector<float> &&_samples);
+
+  /// \brief Read the samples of a tile, with a ring of samples around it,
+  /// from the heightmap data
+  /// \param[in] _tile Tile
+  /// \return Samples of the tile
+  public: std::vector<float> ReadSamples(const Ogre2HeightmapTile &_tile)
+      const;
+
+  /// \brief Destroy the least recently used tiles until the memory used
+  /// by the tiles is within the budget. Tiles in use in the current frame
+  /// are kept.
+  /// \param[in] _sceneManager Ogre scene manager
+  public: void EvictTiles(Ogre::SceneManager *_sceneManager);
+
+  /// \brief Create the mesh and the item of a tile
+  /// \param[in] _tile Tile to build
+  /// \param[in] _sceneManager Ogre scene manager
+  public: void BuildTile(Ogre2HeightmapTile &_tile,
+      Ogre::SceneManager *_sceneManager);
+
+  /// \brief Destroy the ogre objects of a tile and of its children
+  /// \param[in] _tile Tile to destroy
+  /// \param[in] _sceneManager Ogre scene manager
+  public: void DestroyTile(Ogre2HeightmapTile &_tile,
+      Ogre::SceneManager *_sceneManager);
+
+  /// \brief Call a function on a tile and on all its descendants
+  /// \param[in] _tile First tile
+  /// \param[in] _func Function to call
+  public: static void VisitTiles(Ogre2HeightmapTile &_tile,
+      const std::function<void(Ogre2HeightmapTile &)> &_func);
+
+  /// \brief Distance from a point to the bounds of a tile
+  /// \param[in] _tile Tile
+  /// \param[in] _point Point in the frame of the heightmap
+  /// \return Distance, zero if the point is inside the bounds
+  public: static Ogre::Real Distance(const Ogre2HeightmapTile &_tile,
+      const Ogre::Vector3 &_point);
+
+  /// \brief Get the material the tiles are rendered with
+  /// \return The override material if there is one, the material of the
+  /// tiles otherwise
+  public: Ogre2MaterialPtr TileMaterial() const;
+
+  /// \brief Set the datablock of the tile material to the built tiles
+  public: void ApplyTileMaterial();
+
+  /// \brief Heights of the samples, row by row along the y axis. Empty if
+  /// the samples are streamed from a tile source.
+  public: std::vector<float> heights;
+
+  /// \brief Source the samples are streamed from, null if they are in
+  /// heights
+  public: std::shared_ptr<HeightmapTileSource> source;
+
+  /// \brief Number of tiles which samples are being read from the source
+  public: unsigned int pendingLoads = 0u;
+
+  /// \brief Memory used by the tiles, in bytes
+  public: size_t memory = 0u;
+
+  /// \brief Maximum memory used by the tiles, in bytes
+  public: size_t memoryBudget = 256u * 1024u * 1024u;
+
+  /// \brief Frame counter, incremented by every PreRender
+  public: unsigned int frame = 0u;
+
+  /// \brief Number of samples along a side of the heightmap
+  public: unsigned int dataSize = 0u;
+
+  /// \brief Number of cells along the side of a tile
+  public: unsigned int tileCells = kTileCells;
+
+  /// \brief Position of the first sample, at the minimum x and y
+  public: Ogre::Vector3 origin = Ogre::Vector3::ZERO;
+
+  /// \brief Distance between two samples along x and y
+  public: Ogre::Vector2 cellSize = Ogre::Vector2::UNIT_SCALE;
+
+  /// \brief Size of the texture of the heightmap, in meters
+  public: double textureSize = 1.0;
+
+  /// \brief Root of the tile quadtree
+  public: std::unique_ptr<Ogre2HeightmapTile> root;
+
+  /// \brief Tiles drawn in the last frame
+  public: std::vector<Ogre2HeightmapTile *> visibleTiles;
+
+  /// \brief Number of tiles built
+  public: unsigned int builtTileCount = 0u;
+
+  /// \brief Empty ogre item attached to the parent visual
+  public: Ogre::Item *anchor = nullptr;
+
+  /// \brief Scene node the tiles are attached to
+  public: Ogre::SceneNode *parentNode = nullptr;
+
+  /// \brief Material of the tiles
+  public: Ogre2MaterialPtr material;
+
+  /// \brief True if the material was created by the heightmap
+  public: bool ownsMaterial = false;
+
+  /// \brief Material rendered instead of the material of the tiles
+  public: Ogre2MaterialPtr materialOverride;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+Ogre::Vector3 Ogre2HeightmapPrivate::SamplePosition(
+    const Ogre2HeightmapTile &_tile, int _i, int _j) const
+{
+  int last = static_cast<int>(this->dataSize) - 1;
+  int stride = static_cast<int>(_tile.stride);
+  int x = std::max(0, std::min(static_cast<int>(_tile.x) + _i * stride, last));
+  int y = std::max(0, std::min(static_cast<int>(_tile.y) + _j * stride, last));
+  unsigned int side = this->tileCells + 3u;
+  return Ogre::Vector3(
+      this->origin.x + static_cast<Ogre::Real>(x) * this->cellSize.x,
+      this->origin.y + static_cast<Ogre::Real>(y) * this->cellSize.y,
+      this->origin.z + _tile.samples[(_j + 1) * side + (_i + 1)]);
+}
+
+//////////////////////////////////////////////////
+std::unique_ptr<Ogre2HeightmapTile> Ogre2HeightmapPrivate::CreateTile(
+    unsigned int _x, unsigned int _y, unsigned int _stride,
+    const Ogre2HeightmapTile *_parent)
+{
+  std::unique_ptr<Ogre2HeightmapTile> tile(new Ogre2HeightmapTile);
+  tile->x = _x;
+  tile->y = _y;
+  tile->stride = _stride;
+
+  Ogre::Real length = static_cast<Ogre::Real>(this->tileCells * _stride);
+  Ogre::Vector3 min(
+      this->origin.x + static_cast<Ogre::Real>(_x) * this->cellSize.x,
+      this->origin.y + static_cast<Ogre::Real>(_y) * this->cellSize.y,
+      this->origin.z);
+  Ogre::Vector3 max = min + Ogre::Vector3(length * this->cellSize.x,
+      length * this->cellSize.y, 0.0f);
+  if (_parent)
+  {
+    min.z = _parent->bounds.getMinimum().z;
+    max.z = _parent->bounds.getMaximum().z;
+  }
+  tile->bounds = Ogre::Aabb::newFromExtents(min, max);
+
+  if (!this->source)
+    this->SetSamples(*tile, this->ReadSamples(*tile));
+  return tile;
+}
+
+//////////////////////////////////////////////////
+std::vector<float> Ogre2HeightmapPrivate::ReadSamples(
+    const Ogre2HeightmapTile &_tile) const
+{
+  int last = static_cast<int>(this->dataSize) - 1;
+  int stride = static_cast<int>(_tile.stride);
+  int side = static_cast<int>(this->tileCells) + 3;
+  std::vector<float> samples(static_cast<size_t>(side * side));
+  for (int j = 0; j < side; ++j)
+  {
+    int y = std::max(0, std::min(
+        static_cast<int>(_tile.y) + (j - 1) * stride, last));
+    for (int i = 0; i < side; ++i)
+    {
+      int x = std::max(0, std::min(
+          static_cast<int>(_tile.x) + (i - 1) * stride, last));
+      samples[j * side + i] = this->heights[y * (last + 1) + x];
+    }
+  }
+  return samples;
+}
+
+//////////////////////////////////////////////////
+void Ogre2HeightmapPrivate::SetSamples(Ogre2HeightmapTile &_tile,
+    std::vector<float> &&_samples)
+{
+  unsigned int side = this->tileCells + 3u;
+  if (_samples.size() != side * side)
+    return;
+
+  _tile.samples = std::move(_samples);
+  size_t bytes = _tile.samples.size() * sizeof(float);
+  _tile.memory += bytes;
+  this->memory += bytes;
+
+  // the bounds only need the samples drawn by the tile
+  Ogre::Vector3 min = this->SamplePosition(_tile, 0, 0);
+  Ogre::Vector3 max = min;
+  int n = static_cast<int>(this->tileCells);
+  for (int j = 0; j <= n; ++j)
+  {
+    for (int i = 0; i <= n; ++i)
+    {
+      Ogre::Vector3 p = this->SamplePosition(_tile, i, j);
+      min.makeFloor(p);
+      max.makeCeil(p);
+    }
+  }
+  _tile.bounds = Ogre::Aabb::newFromExtents(min, max);
+}
+
+//////////////////////////////////////////////////
+bool Ogre2HeightmapPrivate::LoadTile(Ogre2HeightmapTile &_tile)
+{
+  if (!_tile.samples.empty())
+    return true;
+
+  if (!_tile.loading.valid())
+  {
+    if (!this->source || this->pendingLoads >= kMaxPendingLoads)
+      return false;
+
+    int stride = static_cast<int>(_tile.stride);
+    int x = static_cast<int>(_tile.x) - stride;
+    int y = static_cast<int>(_tile.y) - stride;
+    unsigned int count = this->tileCells + 3u;
+    std::shared_ptr<HeightmapTileSource> tileSource = this->source;
+    _tile.loading = std::async(std::launch::async,
+        [tileSource, x, y, stride, count]()
+        {
+          std::vector<float> samples;
+          if (!tileSource->Heights(x, y, static_cast<unsigned int>(stride),
+              count, samples))
+          {
+            samples.clear();
+          }
+          return samples;
+        });
+    ++this->pendingLoads;
+    return false;
+  }
+
+  if (_tile.loading.wait_for(std::chrono::seconds(0)) !=
+      std::future_status::ready)
+  {
+    return false;
+  }
+
+  --this->pendingLoads;
+  this->SetSamples(_tile, _tile.loading.get());
+  return !_tile.samples.empty();
+}
+
+//////////////////////////////////////////////////
+void Ogre2HeightmapPrivate::EvictTiles(Ogre::SceneManager *_sceneManager)
+{
+  if (this->memory <= this->memoryBudget || !this->root)
+    return;
+
+  // Subtrees not used in this frame, under tiles in use. Subtrees with
+  // samples still being read are kept, destroying them would wait for the
+  // read.
+  std::vector<std::unique_ptr<Ogre2HeightmapTile> *> candidates;
+  std::function<void(Ogre2HeightmapTile &)> collect =
+      [&](Ogre2HeightmapTile &_tile)
+      {
+        for (auto &child : _tile.children)
+        {
+          if (!child)
+            continue;
+          if (child->lastUsed == this->frame)
+          {
+            collect(*child);
+            continue;
+          }
+
+          bool loading = false;
+          VisitTiles(*child, [&loading](Ogre2HeightmapTile &_t)
+              {
+                loading = loading || _t.loading.valid();
+              });
+          if (!loading)
+            candidates.push_back(&child);
+        }
+      };
+  collect(*this->root);
+
+  std::sort(candidates.begin(), candidates.end(),
+      [](const std::unique_ptr<Ogre2HeightmapTile> *_a,
+         const std::unique_ptr<Ogre2HeightmapTile> *_b)
+      {
+        return (*_a)->lastUsed < (*_b)->lastUsed;
+      });
+
+  for (auto candidate : candidates)
+  {
+    if (this->memory <= this->memoryBudget)
+      break;
+    this->DestroyTile(**candidate, _sceneManager);
+    candidate->reset();
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2HeightmapPrivate::BuildTile(Ogre2HeightmapTile &_tile,
+    Ogre::SceneManager *_sceneManager)
+{
+  Ogre::VaoManager *vaoManager =
+      _sceneManager->getDestinationRenderSystem()->getVaoManager();
+  if (!vaoManager)
+    return;
+
+  if (_tile.samples.empty())
+    return;
+
+  unsigned int n = this->tileCells;
+  unsigned int side = n + 1u;
+
+  // skirts hang below the edges of the tile, deep enough to cover the
+  // difference with a neighbour at another level
+  Ogre::Real skirt = std::max(
+      _tile.bounds.mHalfSize.z * 2.0f,
+      static_cast<Ogre::Real>(_tile.stride) *
+      std::max(this->cellSize.x, this->cellSize.y));
+
+  std::vector<float> vertices;
+  vertices.reserve(static_cast<size_t>(side * side + 4u * side) *
+      kTileVertexSize);
+  auto addVertex = [&](unsigned int _i, unsigned int _j, Ogre::Real _drop)
+  {
+    int i = static_cast<int>(_i);
+    int j = static_cast<int>(_j);
+    Ogre::Vector3 p = this->SamplePosition(_tile, i, j);
+
+    // normal from the slopes between the neighbouring samples
+    Ogre::Vector3 dx = this->SamplePosition(_tile, i + 1, j) -
+        this->SamplePosition(_tile, i - 1, j);
+    Ogre::Vector3 dy = this->SamplePosition(_tile, i, j + 1) -
+        this->SamplePosition(_tile, i, j - 1);
+    Ogre::Vector3 normal = dx.crossProduct(dy);
+    normal.normalise();
+
+    vertices.push_back(p.x);
+    vertices.push_back(p.y);
+    vertices.push_back(p.z - _drop);
+    vertices.push_back(normal.x);
+    vertices.push_back(normal.y);
+    vertices.push_back(normal.z);
+    vertices.push_back(static_cast<float>((p.x - this->origin.x) /
+        this->textureSize));
+    vertices.push_back(static_cast<float>((p.y - this->origin.y) /
+        this->textureSize));
+  };
+
+  for (unsigned int j = 0u; j < side; ++j)
+  {
+    for (unsigned int i = 0u; i < side; ++i)
+      addVertex(i, j, 0.0f);
+  }
+
+  // skirt vertices of the bottom, top, left and right edges
+  for (unsigned int k = 0u; k < side; ++k)
+    addVertex(k, 0u, skirt);
+  for (unsigned int k = 0u; k < side; ++k)
+    addVertex(k, n, skirt);
+  for (unsigned int k = 0u; k < side; ++k)
+    addVertex(0u, k, skirt);
+  for (unsigned int k = 0u; k < side; ++k)
+    addVertex(n, k, skirt);
+
+  std::vector<uint16_t> indices;
+  indices.reserve(static_cast<size_t>(n * n + 4u * n) * 6u);
+  for (unsigned int j = 0u; j < n; ++j)
+  {
+    for (unsigned int i = 0u; i < n; ++i)
+    {
+      uint16_t a = static_cast<uint16_t>(j * side + i);
+      uint16_t b = static_cast<uint16_t>(a + 1u);
+      uint16_t c = static_cast<uint16_t>(a + side);
+      uint16_t d = static_cast<uint16_t>(c + 1u);
+      indices.insert(indices.end(), {a, b, d, a, d, c});
+    }
+  }
+
+  // skirt quads, wound to face outwards
+  for (unsigned int edge = 0u; edge < 4u; ++edge)
+  {
+    unsigned int skirtStart = side * side + edge * side;
+    bool flip = edge == 1u || edge == 2u;
+    for (unsigned int k = 0u; k < n; ++k)
+    {
+      unsigned int e0 = 0u;
+      unsigned int e1 = 0u;
+      if (edge == 0u)
+        e0 = k;
+      else if (edge == 1u)
+        e0 = n * side + k;
+      else if (edge == 2u)
+        e0 = k * side;
+      else
+        e0 = k * side + n;
+      e1 = (edge < 2u) ? e0 + 1u : e0 + side;
+
+      uint16_t v0 = static_cast<uint16_t>(e0);
+      uint16_t v1 = static_cast<uint16_t>(e1);
+      uint16_t s0 = static_cast<uint16_t>(skirtStart + k);
+      uint16_t s1 = static_cast<uint16_t>(skirtStart + k + 1u);
+      if (flip)
+        indices.insert(indices.end(), {v0, v1, s0, v1, s1, s0});
+      else
+        indices.insert(indices.end(), {v0, s0, v1, v1, s0, s1});
+    }
+  }
+
+  static unsigned int heightmapTileId = 0u;
+  _tile.mesh = Ogre::MeshManager::getSingleton().createManual(
+      "heightmap_tile_" + std::to_string(heightmapTileId++),
+      Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+  Ogre::SubMesh *subMesh = _tile.mesh->createSubMesh();
+
+  Ogre::VertexElement2Vec vertexElements;
+  vertexElements.push_back(
+      Ogre::VertexElement2(Ogre::VET_FLOAT3, Ogre::VES_POSITION));
+  vertexElements.push_back(
+      Ogre::VertexElement2(Ogre::VET_FLOAT3, Ogre::VES_NORMAL));
+  vertexElements.push_back(
+      Ogre::VertexElement2(Ogre::VET_FLOAT2, Ogre::VES_TEXTURE_COORDINATES));
+
+  // tiles never change once built
+  _tile.vertexBuffer = vaoManager->createVertexBuffer(vertexElements,
+      vertices.size() / kTileVertexSize, Ogre::BT_IMMUTABLE,
+      vertices.data(), false);
+  _tile.indexBuffer = vaoManager->createIndexBuffer(
+      Ogre::IndexBufferPacked::IT_16BIT, indices.size(), Ogre::BT_IMMUTABLE,
+      indices.data(), false);
+
+  Ogre::VertexBufferPackedVec vertexBuffers;
+  vertexBuffers.push_back(_tile.vertexBuffer);
+  _tile.vao = vaoManager->createVertexArrayObject(vertexBuffers,
+      _tile.indexBuffer, Ogre::OT_TRIANGLE_LIST);
+  subMesh->mVao[Ogre::VpNormal].push_back(_tile.vao);
+  subMesh->mVao[Ogre::VpShadow].push_back(_tile.vao);
+
+  Ogre::Aabb bounds = _tile.bounds;
+  bounds.merge(bounds.getMinimum() - Ogre::Vector3(0.0f, 0.0f, skirt));
+  _tile.mesh->_setBounds(bounds, false);
+  _tile.mesh->_setBoundingSphereRadius(bounds.getRadius());
+
+  _tile.item = _sceneManager->createItem(_tile.mesh, Ogre::SCENE_DYNAMIC);
+  _tile.item->setCastShadows(false);
+  _tile.item->setVisible(false);
+  Ogre2MaterialPtr tileMaterial = this->TileMaterial();
+  if (tileMaterial)
+    _tile.item->setDatablock(tileMaterial->Datablock());
+  if (this->anchor)
+  {
+    _tile.item->setVisibilityFlags(this->anchor->getVisibilityFlags());
+    _tile.item->getUserObjectBindings().setUserAny(
+        this->anchor->getUserObjectBindings().getUserAny());
+  }
+  if (this->parentNode)
+    this->parentNode->attachObject(_tile.item);
+
+  size_t bytes = vertices.size() * sizeof(float) +
+      indices.size() * sizeof(uint16_t);
+  _tile.memory += bytes;
+  this->memory += bytes;
+  ++this->builtTileCount;
+}
+
+//////////////////////////////////////////////////
+void Ogre2HeightmapPrivate::DestroyTile(Ogre2HeightmapTile &_tile,
+    Ogre::SceneManager *_sceneManager)
+{
+  for (auto &child : _tile.children)
+  {
+    if (child)
+      this->DestroyTile(*child, _sceneManager);
+  }
+
+  if (_tile.loading.valid())
+  {
+    _tile.loading.wait();
+    _tile.loading = std::future<std::vector<float>>();
+    --this->pendingLoads;
+  }
+
+  this->memory -= _tile.memory;
+  _tile.memory = 0u;
+  _tile.samples.clear();
+  _tile.samples.shrink_to_fit();
+
+  if (!_tile.item)
+    return;
+
+  _sceneManager->destroyItem(_tile.item);
+  _tile.item = nullptr;
+
+  Ogre::VaoManager *vaoManager =
+      _sceneManager->getDestinationRenderSystem()->getVaoManager();
+  if (vaoManager)
+  {
+    if (_tile.vao)
+      vaoManager->destroyVertexArrayObject(_tile.vao);
+    if (_tile.vertexBuffer)
+      vaoManager->destroyVertexBuffer(_tile.vertexBuffer);
+    if (_tile.indexBuffer)
+      vaoManager->destroyIndexBuffer(_tile.indexBuffer);
+  }
+  _tile.vao = nullptr;
+  _tile.vertexBuffer = nullptr;
+  _tile.indexBuffer = nullptr;
+
+  if (!_tile.mesh.isNull())
+  {
+    // the vertex array object is destroyed above, do not let the submesh
+    // destroy it again
+    Ogre::SubMesh *subMesh = _tile.mesh->getSubMesh(0);
+    subMesh->mVao[Ogre::VpNormal].clear();
+    subMesh->mVao[Ogre::VpShadow].clear();
+    Ogre::MeshManager::getSingleton().remove(_tile.mesh->getHandle());
+    _tile.mesh.setNull();
+  }
+
+  --this->builtTileCount;
+}
+
+//////////////////////////////////////////////////
+void Ogre2HeightmapPrivate::VisitTiles(Ogre2HeightmapTile &_tile,
+    const std::function<void(Ogre2HeightmapTile &)> &_func)
+{
+  _func(_tile);
+  for (auto &child : _tile.children)
+  {
+    if (child)
+      VisitTiles(*child, _func);
+  }
+}
+
+//////////////////////////////////////////////////
+Ogre2MaterialPtr Ogre2HeightmapPrivate::TileMaterial() const
+{
+  return this->materialOverride ? this->materialOverride : this->material;
+}
+
+//////////////////////////////////////////////////
+void Ogre2HeightmapPrivate::ApplyTileMaterial()
+{
+  Ogre2MaterialPtr tileMaterial = this->TileMaterial();
+  if (!this->root || !tileMaterial)
+    return;
+
+  VisitTiles(*this->root, [&tileMaterial](Ogre2HeightmapTile &_tile)
+      {
+        if (_tile.item)
+          _tile.item->setDatablock(tileMaterial->Datablock());
+      });
+}
+
+//////////////////////////////////////////////////
+Ogre::Real Ogre2HeightmapPrivate::Distance(const Ogre2HeightmapTile &_tile,
+    const Ogre::Vector3 &_point)
+{
+  Ogre::Vector3 d = _point - _tile.bounds.mCenter;
+  d.x = std::max(std::abs(d.x) - _tile.bounds.mHalfSize.x, 0.0f);
+  d.y = std::max(std::abs(d.y) - _tile.bounds.mHalfSize.y, 0.0f);
+  d.z = std::max(std::abs(d.z) - _tile.bounds.mHalfSize.z, 0.0f);
+  return d.length();
+}
+
+//////////////////////////////////////////////////
+Ogre2Heightmap::Ogre2Heightmap(const HeightmapDescriptor &_desc)
+    : BaseHeightmap(_desc), dataPtr(std::make_unique<Ogre2HeightmapPrivate>())
+{
+}
+
+//////////////////////////////////////////////////
+Ogre2Heightmap::~Ogre2Heightmap()
+{
+}
+
+//////////////////////////////////////////////////
+void Ogre2Heightmap::Init()
+{
+  this->dataPtr->source = this->descriptor.TileSource();
+  if (this->descriptor.Data() == nullptr && !this->dataPtr->source)
+  {
+    ignerr << "Failed to initialize: null heightmap data." << std::endl;
+    return;
+  }
+
+  if (this->descriptor.Name().empty())
+    this->descriptor.SetName(this->Name());
+
+  // Add paths
+  for (auto i = 0u; i < this->descriptor.TextureCount(); ++i)
+  {
+    auto texture = this->descriptor.TextureByIndex(i);
+    Ogre2RenderEngine::Instance()->AddResourcePath(texture->Diffuse());
+    Ogre2RenderEngine::Instance()->AddResourcePath(texture->Normal());
+  }
+
+  unsigned int vertSize = 0u;
+  if (this->dataPtr->source)
+  {
+    // the samples are read on demand, tile by tile
+    vertSize = this->dataPtr->source->SampleCount();
+    if (vertSize < 2u || !math::isPowerOfTwo(vertSize - 1))
+    {
+      ignerr << "Heightmap tile source must have 2^n+1 samples along a "
+             << "side, got [" << vertSize << "]" << std::endl;
+      return;
+    }
+    this->dataPtr->dataSize = vertSize;
+  }
+  else
+  {
+    // Same sampling and scale as the ogre heightmap, so both render engines
+    // agree on the shape of the terrain
+    double heightmapSizeZ = this->descriptor.Data()->MaxElevation();
+    bool flipY = false;
+    vertSize = (this->descriptor.Data()->Width() *
+        this->descriptor.Sampling()) - this->descriptor.Sampling() + 1;
+    math::Vector3d scale;
+    scale.X(this->descriptor.Size().X() / vertSize);
+    scale.Y(this->descriptor.Size().Y() / vertSize);
+
+    if (math::equal(heightmapSizeZ, 0.0))
+      scale.Z(1.0);
+    else
+      scale.Z(fabs(this->descriptor.Size().Z()) / heightmapSizeZ);
+
+    // Construct the heightmap lookup table
+    std::vector<float> lookup;
+    this->descriptor.Data()->FillHeightMap(this->descriptor.Sampling(),
+        vertSize, this->descriptor.Size(), scale, flipY, lookup);
+
+    this->dataPtr->dataSize = vertSize;
+
+    if (lookup.size() != static_cast<size_t>(vertSize) * vertSize ||
+        vertSize < 2u)
+    {
+      ignerr << "Failed to load terrain. Heightmap data is empty"
+             << std::endl;
+      return;
+    }
+
+    // rows of the lookup table go down the image, store them along +y
+    this->dataPtr->heights.resize(lookup.size());
+    for (unsigned int y = 0; y < vertSize; ++y)
+    {
+      std::copy(lookup.begin() + (vertSize - y - 1) * vertSize,
+          lookup.begin() + (vertSize - y) * vertSize,
+          this->dataPtr->heights.begin() + y * vertSize);
+    }
+
+    if (!math::isPowerOfTwo(this->dataPtr->dataSize - 1))
+    {
+      ignerr << "Heightmap final sampling must satisfy 2^n+1."
+             << std::endl << "size = (width * sampling) = sampling + 1"
+             << std::endl << "[" << this->dataPtr->dataSize << "] = (["
+             << this->descriptor.Data()->Width() << "] * ["
+             << this->descriptor.Sampling() << "]) = ["
+             << this->descriptor.Sampling() << "] + 1: "
+          << std::endl;
+      return;
+    }
+  }
+
+  const math::Vector3d &size = this->descriptor.Size();
+  const math::Vector3d &position = this->descriptor.Position();
+  this->dataPtr->origin = Ogre::Vector3(
+      static_cast<Ogre::Real>(position.X() - size.X() * 0.5),
+      static_cast<Ogre::Real>(position.Y() - size.Y() * 0.5),
+      static_cast<Ogre::Real>(position.Z()));
+  this->dataPtr->cellSize = Ogre::Vector2(
+      static_cast<Ogre::Real>(size.X() / (vertSize - 1)),
+      static_cast<Ogre::Real>(size.Y() / (vertSize - 1)));
+  this->dataPtr->tileCells = std::min(kTileCells, vertSize - 1);
+
+  // the tiles are drawn with the first texture of the descriptor. Blending
+  // the other layers by height is not supported yet.
+  MaterialPtr material = this->scene->CreateMaterial();
+  material->SetCastShadows(false);
+  if (this->descriptor.TextureCount() > 0u)
+  {
+    auto texture = this->descriptor.TextureByIndex(0u);
+    if (texture->Size() > 0.0)
+      this->dataPtr->textureSize = texture->Size();
+    if (!texture->Diffuse().empty())
+      material->SetTexture(texture->Diffuse());
+    if (!texture->Normal().empty())
+      material->SetNormalMap(texture->Normal());
+  }
+  this->dataPtr->material =
+      std::dynamic_pointer_cast<Ogre2Material>(material);
+  this->dataPtr->ownsMaterial = true;
+
+  Ogre::MeshPtr mesh = Ogre::MeshManager::getSingleton().getByName(
+      kHeightmapAnchorMeshName);
+  if (mesh.isNull())
+  {
+    mesh = Ogre::MeshManager::getSingleton().createManual(
+        kHeightmapAnchorMeshName,
+        Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    mesh->_setBounds(Ogre::Aabb::BOX_ZERO, false);
+  }
+
+  Ogre::SceneManager *sceneManager = this->scene->OgreSceneManager();
+  this->dataPtr->anchor = sceneManager->createItem(mesh, Ogre::SCENE_DYNAMIC);
+  this->dataPtr->anchor->setCastShadows(false);
+
+  // the root tile is always built, so there is always something to draw
+  this->dataPtr->root = this->dataPtr->CreateTile(0u, 0u,
+      (vertSize - 1) / this->dataPtr->tileCells, nullptr);
+  if (this->dataPtr->source)
+  {
+    Ogre2HeightmapTile &root = *this->dataPtr->root;
+    int stride = static_cast<int>(root.stride);
+    std::vector<float> samples;
+    if (this->dataPtr->source->Heights(-stride, -stride, root.stride,
+        this->dataPtr->tileCells + 3u, samples))
+    {
+      this->dataPtr->SetSamples(root, std::move(samples));
+    }
+  }
+  this->dataPtr->BuildTile(*this->dataPtr->root, sceneManager);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Heightmap::PreRender()
+{
+  BaseHeightmap::PreRender();
+
+  if (!this->dataPtr->root || !this->dataPtr->root->item ||
+      !this->dataPtr->parentNode)
+  {
+    return;
+  }
+
+  ++this->dataPtr->frame;
+
+  // the tiles follow the sensors, so they are refined again next frame
+  this->MarkPreRenderDirty();
+
+  // the tiles are refined around the sensors of the scene, in the frame of
+  // the heightmap
+  std::vector<Ogre::Vector3> viewers;
+  math::Pose3d parentPose = this->parent->WorldPose();
+  math::Vector3d parentScale = this->parent->WorldScale();
+  for (unsigned int i = 0u; i < this->scene->SensorCount(); ++i)
+  {
+    SensorPtr sensor = this->scene->SensorByIndex(i);
+    if (!sensor)
+      continue;
+    math::Vector3d local = parentPose.Rot().RotateVectorReverse(
+        sensor->WorldPosition() - parentPose.Pos());
+    local.X(math::equal(parentScale.X(), 0.0) ? 0.0 :
+        local.X() / parentScale.X());
+    local.Y(math::equal(parentScale.Y(), 0.0) ? 0.0 :
+        local.Y() / parentScale.Y());
+    local.Z(math::equal(parentScale.Z(), 0.0) ? 0.0 :
+        local.Z() / parentScale.Z());
+    viewers.push_back(Ogre2Conversions::Convert(local));
+  }
+
+  // Refine the tiles closest to the viewers first, so the tile budget is
+  // spent where it matters the most. A tile is only replaced by its
+  // children once they are all built.
+  using Candidate = std::pair<Ogre::Real, Ogre2HeightmapTile *>;
+  auto further = [](const Candidate &_a, const Candidate &_b)
+  {
+    return _a.first > _b.first;
+  };
+  std::priority_queue<Candidate, std::vector<Candidate>, decltype(further)>
+      candidates(further);
+
+  auto nearest = [&viewers](const Ogre2HeightmapTile &_tile)
+  {
+    Ogre::Real distance = std::numeric_limits<Ogre::Real>::max();
+    for (const auto &viewer : viewers)
+    {
+      distance = std::min(distance,
+          Ogre2HeightmapPrivate::Distance(_tile, viewer));
+    }
+    return distance;
+  };
+
+  Ogre::SceneManager *sceneManager = this->scene->OgreSceneManager();
+  Ogre::Real cellLength = std::max(this->dataPtr->cellSize.x,
+      this->dataPtr->cellSize.y);
+  unsigned int buildBudget = kMaxTileBuildsPerFrame;
+  unsigned int tileCount = 1u;
+  std::vector<Ogre2HeightmapTile *> selected;
+
+  candidates.push({nearest(*this->dataPtr->root),
+      this->dataPtr->root.get()});
+  while (!candidates.empty())
+  {
+    Ogre::Real distance = candidates.top().first;
+    Ogre2HeightmapTile *tile = candidates.top().second;
+    candidates.pop();
+    tile->lastUsed = this->dataPtr->frame;
+
+    Ogre::Real tileLength = static_cast<Ogre::Real>(
+        this->dataPtr->tileCells * tile->stride) * cellLength;
+    bool split = tile->stride > 1u && tileCount + 3u <= kMaxVisibleTiles &&
+        distance < tileLength * kLodDistanceFactor;
+    if (!split)
+    {
+      selected.push_back(tile);
+      continue;
+    }
+
+    bool ready = true;
+    unsigned int stride = tile->stride / 2u;
+    unsigned int offset = this->dataPtr->tileCells * stride;
+    for (unsigned int c = 0u; c < 4u; ++c)
+    {
+      auto &child = tile->children[c];
+      if (!child)
+      {
+        child = this->dataPtr->CreateTile(tile->x + (c % 2u) * offset,
+            tile->y + (c / 2u) * offset, stride, tile);
+      }
+      child->lastUsed = this->dataPtr->frame;
+      if (!child->item && this->dataPtr->LoadTile(*child) &&
+          buildBudget > 0u)
+      {
+        --buildBudget;
+        this->dataPtr->BuildTile(*child, sceneManager);
+      }
+      ready = ready && child->item;
+    }
+
+    if (!ready)
+    {
+      selected.push_back(tile);
+      continue;
+    }
+
+    tileCount += 3u;
+    for (auto &child : tile->children)
+      candidates.push({nearest(*child), child.get()});
+  }
+
+  for (auto tile : this->dataPtr->visibleTiles)
+    tile->item->setVisible(false);
+
+  // the anchor follows the visibility of the parent visual
+  bool visible = this->dataPtr->anchor->getVisible();
+  Ogre::uint32 flags = this->dataPtr->anchor->getVisibilityFlags();
+  for (auto tile : selected)
+  {
+    tile->item->setVisible(visible);
+    tile->item->setVisibilityFlags(flags);
+  }
+  this->dataPtr->visibleTiles = std::move(selected);
+
+  this->dataPtr->EvictTiles(sceneManager);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Heightmap::Destroy()
+{
+  if (!this->dataPtr->anchor)
+    return;
+
+  // Remove this object from parent
+  BaseHeightmap::Destroy();
+
+  Ogre::SceneManager *sceneManager = this->scene->OgreSceneManager();
+  this->dataPtr->visibleTiles.clear();
+  if (this->dataPtr->root)
+  {
+    this->dataPtr->DestroyTile(*this->dataPtr->root, sceneManager);
+    this->dataPtr->root.reset();
+  }
+
+  sceneManager->destroyItem(this->dataPtr->anchor);
+  this->dataPtr->anchor = nullptr;
+
+  // destroy material (ogre hlms datablock) - this needs to be done last!
+  if (this->dataPtr->material && this->dataPtr->ownsMaterial)
+    this->scene->DestroyMaterial(this->dataPtr->material);
+  this->dataPtr->material.reset();
+  this->dataPtr->materialOverride.reset();
+}
+
+//////////////////////////////////////////////////
+Ogre::MovableObject *Ogre2Heightmap::OgreObject() const
+{
+  return this->dataPtr->anchor;
+}
+
+//////////////////////////////////////////////////
+MaterialPtr Ogre2Heightmap::Material() const
+{
+  return this->dataPtr->material;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Heightmap::SetMaterial(MaterialPtr _material, bool _unique)
+{
+  _material = (_unique) ? _material->Clone() : _material;
+
+  Ogre2MaterialPtr derived =
+      std::dynamic_pointer_cast<Ogre2Material>(_material);
+
+  if (!derived)
+  {
+    ignerr << "Cannot assign material created by another render-engine"
+        << std::endl;
+
+    return;
+  }
+
+  Ogre2MaterialPtr previous = this->dataPtr->material;
+  bool ownsPrevious = this->dataPtr->ownsMaterial;
+  this->dataPtr->material = derived;
+  this->dataPtr->ownsMaterial = _unique;
+  this->dataPtr->ApplyTileMaterial();
+
+  // the previous datablock is no longer used by the tiles
+  if (previous && ownsPrevious)
+    this->scene->DestroyMaterial(previous);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Heightmap::SetMaterialOverride(MaterialPtr _material)
+{
+  Ogre2MaterialPtr derived =
+      std::dynamic_pointer_cast<Ogre2Material>(_material);
+  if (_material && !derived)
+  {
+    ignerr << "Cannot assign material created by another render-engine"
+        << std::endl;
+    return;
+  }
+
+  // the owned material is kept, only the datablock of the tiles changes
+  this->dataPtr->materialOverride = derived;
+  this->materialOverride = _material;
+  this->dataPtr->ApplyTileMaterial();
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2Heightmap::VisibleTileCount() const
+{
+  return static_cast<unsigned int>(this->dataPtr->visibleTiles.size());
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2Heightmap::BuiltTileCount() const
+{
+  return this->dataPtr->builtTileCount;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Heightmap::SetMemoryBudget(size_t _bytes)
+{
+  this->dataPtr->memoryBudget = _bytes;
+}
+
+//////////////////////////////////////////////////
+size_t Ogre2Heightmap::MemoryBudget() const
+{
+  return this->dataPtr->memoryBudget;
+}
+
+//////////////////////////////////////////////////
+size_t Ogre2Heightmap::TileMemory() const
+{
+  return this->dataPtr->memory;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Heightmap::SetParent(Ogre2VisualPtr _parent)
+{
+  Ogre2Geometry::SetParent(_parent);
+
+  // the tiles are drawn with the parent visual, like the ogre object
+  this->dataPtr->parentNode = _parent ? _parent->Node() : nullptr;
+  if (!this->dataPtr->root)
+    return;
+
+  Ogre2HeightmapPrivate::VisitTiles(*this->dataPtr->root,
+      [this](Ogre2HeightmapTile &_tile)
+      {
+        if (!_tile.item)
+          return;
+        if (_tile.item->isAttached())
+          _tile.item->detachFromParent();
+        if (this->dataPtr->parentNode)
+        {
+          _tile.item->setVisibilityFlags(
+              this->dataPtr->anchor->getVisibilityFlags());
+          _tile.item->getUserObjectBindings().setUserAny(
+              this->dataPtr->anchor->getUserObjectBindings().getUserAny());
+          this->dataPtr->parentNode->attachObject(_tile.item);
+        }
+      });
+}
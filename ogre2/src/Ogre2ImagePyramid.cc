@@ -0,0 +1,418 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/PixelFormat.hh"
+#include "ignition/rendering/Profiler.hh"
+#include "ignition/rendering/ogre2/Ogre2Camera.hh"
+#include "ignition/rendering/ogre2/Ogre2Conversions.hh"
+#include "ignition/rendering/ogre2/Ogre2ImagePyramid.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderTarget.hh"
+#include "ignition/rendering/ogre2/Ogre2Scene.hh"
+
+#include "Ogre2ReadbackManager.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <Compositor/OgreCompositorManager2.h>
+#include <Compositor/OgreCompositorNodeDef.h>
+#include <Compositor/OgreCompositorWorkspace.h>
+#include <Compositor/OgreCompositorWorkspaceDef.h>
+#include <Compositor/Pass/PassQuad/OgreCompositorPassQuadDef.h>
+#include <OgreHardwarePixelBuffer.h>
+#include <OgreRenderTexture.h>
+#include <OgreRoot.h>
+#include <OgreTextureManager.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+/// \brief Private data for the Ogre2ImagePyramid class
+class ignition::rendering::Ogre2ImagePyramidPrivate
+{
+  /// \brief Compute the size of the levels from the image of the camera
+  public: void UpdateLevelSizes();
+
+  /// \brief Create the textures of the levels and the workspace drawing
+  /// them from a render texture
+  /// \param[in] _input Render texture of the camera
+  public: void Build(Ogre::Texture *_input);
+
+  /// \brief Destroy the textures and the workspace
+  public: void Destroy();
+
+  /// \brief Camera whose images are downsampled
+  public: Ogre2CameraPtr camera;
+
+  /// \brief Requested number of levels
+  public: unsigned int requestedLevelCount = 0u;
+
+  /// \brief Downsampling filter
+  public: Ogre2PyramidFilter filter = OPF_BOX;
+
+  /// \brief Width of the image the levels were computed for
+  public: unsigned int width = 0u;
+
+  /// \brief Height of the image the levels were computed for
+  public: unsigned int height = 0u;
+
+  /// \brief Format of the image the levels were computed for
+  public: PixelFormat format = PF_UNKNOWN;
+
+  /// \brief Width of each level
+  public: std::vector<unsigned int> levelWidths;
+
+  /// \brief Height of each level
+  public: std::vector<unsigned int> levelHeights;
+
+  /// \brief Render texture the workspace reads from
+  public: Ogre::Texture *input = nullptr;
+
+  /// \brief Textures of the levels
+  public: std::vector<Ogre::Texture *> levels;
+
+  /// \brief Texture the levels are stacked in for the readback, as wide as
+  /// the first level
+  public: Ogre::Texture *atlas = nullptr;
+
+  /// \brief Workspace drawing the levels, rendered on demand
+  public: Ogre::CompositorWorkspace *workspace = nullptr;
+
+  /// \brief Memory the atlas is read back to
+  public: std::vector<unsigned char> staging;
+
+  /// \brief Prefix of the names of the textures and definitions
+  public: std::string name;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+void Ogre2ImagePyramidPrivate::UpdateLevelSizes()
+{
+  this->width = this->camera->ImageWidth();
+  this->height = this->camera->ImageHeight();
+  this->format = this->camera->ImageFormat();
+  this->levelWidths.clear();
+  this->levelHeights.clear();
+
+  unsigned int w = this->width / 2u;
+  unsigned int h = this->height / 2u;
+  while (this->levelWidths.size() < this->requestedLevelCount &&
+      w > 0u && h > 0u)
+  {
+    this->levelWidths.push_back(w);
+    this->levelHeights.push_back(h);
+    w /= 2u;
+    h /= 2u;
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2ImagePyramidPrivate::Build(Ogre::Texture *_input)
+{
+  this->Destroy();
+
+  Ogre::TextureManager &manager = Ogre::TextureManager::getSingleton();
+  Ogre::PixelFormat textureFormat = _input->getFormat();
+  bool gamma = _input->isHardwareGammaEnabled();
+  unsigned int atlasHeight = 0u;
+  for (size_t i = 0u; i < this->levelWidths.size(); ++i)
+  {
+    this->levels.push_back(manager.createManual(
+        this->name + "_level(" + std::to_string(i) + ")", "General",
+        Ogre::TEX_TYPE_2D, this->levelWidths[i], this->levelHeights[i], 1, 0,
+        textureFormat, Ogre::TU_RENDERTARGET, 0, gamma).get());
+    this->levels.back()->getBuffer()->getRenderTarget()->setDepthBufferPool(
+        Ogre::DepthBuffer::POOL_NO_DEPTH);
+    atlasHeight += this->levelHeights[i];
+  }
+  this->atlas = manager.createManual(this->name + "_atlas", "General",
+      Ogre::TEX_TYPE_2D, this->levelWidths[0], atlasHeight, 1, 0,
+      textureFormat, Ogre::TU_RENDERTARGET, 0, gamma).get();
+
+  // one quad pass per level, drawn from the previous level
+  Ogre::CompositorManager2 *compMgr =
+      Ogre2RenderEngine::Instance()->OgreRoot()->getCompositorManager2();
+  std::string nodeDefName = this->name + "/Node";
+  std::string wsDefName = this->name + "/Workspace";
+  Ogre::CompositorNodeDef *nodeDef =
+      compMgr->addNodeDefinition(nodeDefName);
+  nodeDef->addTextureSourceName("rt_input", 0,
+      Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+  for (size_t i = 0u; i < this->levels.size(); ++i)
+  {
+    nodeDef->addTextureSourceName("rt_level" + std::to_string(i), i + 1u,
+        Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+  }
+  nodeDef->setNumTargetPass(this->levels.size());
+  std::string materialName = this->filter == OPF_GAUSSIAN ?
+      "ImagePyramidGaussian" : "ImagePyramidBox";
+  for (size_t i = 0u; i < this->levels.size(); ++i)
+  {
+    Ogre::CompositorTargetDef *targetDef =
+        nodeDef->addTargetPass("rt_level" + std::to_string(i));
+    targetDef->setNumPasses(1);
+    Ogre::CompositorPassQuadDef *passQuad =
+        static_cast<Ogre::CompositorPassQuadDef *>(
+        targetDef->addPass(Ogre::PASS_QUAD));
+    passQuad->mMaterialName = materialName;
+    passQuad->addQuadTextureSource(0, i == 0u ? "rt_input" :
+        "rt_level" + std::to_string(i - 1u), 0);
+  }
+
+  Ogre::CompositorWorkspaceDef *workDef =
+      compMgr->addWorkspaceDefinition(wsDefName);
+  Ogre::CompositorChannelVec externalTargets;
+  Ogre::CompositorChannel inputChannel;
+  inputChannel.target = _input->getBuffer()->getRenderTarget();
+  inputChannel.textures.push_back(manager.getByName(_input->getName()));
+  externalTargets.push_back(inputChannel);
+  workDef->connectExternal(0, nodeDefName, 0);
+  for (size_t i = 0u; i < this->levels.size(); ++i)
+  {
+    Ogre::CompositorChannel channel;
+    channel.target = this->levels[i]->getBuffer()->getRenderTarget();
+    channel.textures.push_back(manager.getByName(this->levels[i]->getName()));
+    externalTargets.push_back(channel);
+    workDef->connectExternal(i + 1u, nodeDefName, i + 1u);
+  }
+
+  Ogre2ScenePtr scene =
+      std::dynamic_pointer_cast<Ogre2Scene>(this->camera->Scene());
+  this->workspace = compMgr->addWorkspace(scene->OgreSceneManager(),
+      externalTargets, this->camera->OgreCamera(), wsDefName, false);
+  this->input = _input;
+}
+
+//////////////////////////////////////////////////
+void Ogre2ImagePyramidPrivate::Destroy()
+{
+  // the engine may already be shut down
+  auto engine = Ogre2RenderEngine::Instance();
+  Ogre::Root *root = engine->IsInitialized() ? engine->OgreRoot() : nullptr;
+  if (root && this->workspace)
+  {
+    Ogre::CompositorManager2 *compMgr = root->getCompositorManager2();
+    compMgr->removeWorkspace(this->workspace);
+    compMgr->removeWorkspaceDefinition(this->name + "/Workspace");
+    compMgr->removeNodeDefinition(this->name + "/Node");
+  }
+  this->workspace = nullptr;
+
+  Ogre::TextureManager *manager = Ogre::TextureManager::getSingletonPtr();
+  if (manager)
+  {
+    for (auto level : this->levels)
+      manager->remove(level->getName());
+    if (this->atlas)
+      manager->remove(this->atlas->getName());
+  }
+  this->levels.clear();
+  this->atlas = nullptr;
+  this->input = nullptr;
+}
+
+//////////////////////////////////////////////////
+Ogre2ImagePyramid::Ogre2ImagePyramid()
+  : dataPtr(new Ogre2ImagePyramidPrivate)
+{
+  static unsigned int pyramidId = 0u;
+  this->dataPtr->name = "Ogre2ImagePyramid(" +
+      std::to_string(pyramidId++) + ")";
+}
+
+//////////////////////////////////////////////////
+Ogre2ImagePyramid::~Ogre2ImagePyramid()
+{
+  this->dataPtr->Destroy();
+}
+
+//////////////////////////////////////////////////
+bool Ogre2ImagePyramid::SetCamera(CameraPtr _camera,
+    unsigned int _levelCount, Ogre2PyramidFilter _filter)
+{
+  Ogre2CameraPtr camera = std::dynamic_pointer_cast<Ogre2Camera>(_camera);
+  if (!camera)
+  {
+    ignerr << "Image pyramids only support ogre2 cameras" << std::endl;
+    return false;
+  }
+  if (_levelCount == 0u)
+  {
+    ignerr << "Image pyramids need at least one level" << std::endl;
+    return false;
+  }
+  PixelFormat format = camera->ImageFormat();
+  if (PixelUtil::BytesPerPixel(format) == 0u || PixelUtil::IsBayer(format))
+  {
+    ignerr << "Unsupported image format of camera [" << camera->Name()
+           << "] for an image pyramid" << std::endl;
+    return false;
+  }
+
+  this->dataPtr->Destroy();
+  this->dataPtr->camera = camera;
+  this->dataPtr->requestedLevelCount = _levelCount;
+  this->dataPtr->filter = _filter;
+  this->dataPtr->UpdateLevelSizes();
+  if (this->dataPtr->levelWidths.empty())
+  {
+    ignerr << "Image of camera [" << camera->Name() << "] is too small "
+           << "for an image pyramid" << std::endl;
+    this->dataPtr->camera.reset();
+    return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+CameraPtr Ogre2ImagePyramid::Camera() const
+{
+  return this->dataPtr->camera;
+}
+
+//////////////////////////////////////////////////
+Ogre2PyramidFilter Ogre2ImagePyramid::Filter() const
+{
+  return this->dataPtr->filter;
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2ImagePyramid::LevelCount() const
+{
+  return static_cast<unsigned int>(this->dataPtr->levelWidths.size());
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2ImagePyramid::LevelWidth(unsigned int _level) const
+{
+  if (_level >= this->dataPtr->levelWidths.size())
+    return 0u;
+  return this->dataPtr->levelWidths[_level];
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2ImagePyramid::LevelHeight(unsigned int _level) const
+{
+  if (_level >= this->dataPtr->levelHeights.size())
+    return 0u;
+  return this->dataPtr->levelHeights[_level];
+}
+
+//////////////////////////////////////////////////
+size_t Ogre2ImagePyramid::LevelOffset(unsigned int _level) const
+{
+  size_t offset = 0u;
+  unsigned int count = std::min(_level, this->LevelCount());
+  for (unsigned int i = 0u; i < count; ++i)
+  {
+    offset += PixelUtil::MemorySize(this->dataPtr->format,
+        this->dataPtr->levelWidths[i], this->dataPtr->levelHeights[i]);
+  }
+  return offset;
+}
+
+//////////////////////////////////////////////////
+size_t Ogre2ImagePyramid::MemorySize() const
+{
+  return this->LevelOffset(this->LevelCount());
+}
+
+//////////////////////////////////////////////////
+bool Ogre2ImagePyramid::Capture(void *_data)
+{
+  IGN_RENDERING_PROFILE("Ogre2ImagePyramid::Capture");
+  if (!_data || !this->dataPtr->camera)
+    return false;
+
+  Ogre2CameraPtr camera = this->dataPtr->camera;
+  Ogre::Texture *input = camera->renderTexture ?
+      camera->renderTexture->OgreTexture() : nullptr;
+  if (!input)
+  {
+    ignerr << "Image pyramids only support cameras rendering to textures"
+           << std::endl;
+    return false;
+  }
+
+  // the camera may have been resized, or its render texture swapped by
+  // render passes
+  if (camera->ImageWidth() != this->dataPtr->width ||
+      camera->ImageHeight() != this->dataPtr->height ||
+      camera->ImageFormat() != this->dataPtr->format)
+  {
+    if (!this->SetCamera(camera, this->dataPtr->requestedLevelCount,
+        this->dataPtr->filter))
+    {
+      return false;
+    }
+  }
+  if (input != this->dataPtr->input)
+    this->dataPtr->Build(input);
+
+  Ogre2RenderEngine::Instance()->RenderWorkspaces({this->dataPtr->workspace});
+
+  // stack the levels in one texture on the GPU
+  unsigned int top = 0u;
+  for (size_t i = 0u; i < this->dataPtr->levels.size(); ++i)
+  {
+    unsigned int w = this->dataPtr->levelWidths[i];
+    unsigned int h = this->dataPtr->levelHeights[i];
+    Ogre::Box srcBox(0, 0, w, h);
+    Ogre::Box dstBox(0, top, w, top + h);
+    this->dataPtr->atlas->getBuffer()->blit(
+        this->dataPtr->levels[i]->getBuffer(), srcBox, dstBox);
+    top += h;
+  }
+
+  // one readback, then each level is packed after the previous one
+  PixelFormat format = this->dataPtr->format;
+  unsigned int atlasWidth = this->dataPtr->levelWidths[0];
+  this->dataPtr->staging.resize(PixelUtil::MemorySize(format, atlasWidth,
+      top));
+  Ogre::PixelBox box(atlasWidth, top, 1, Ogre2Conversions::Convert(format),
+      this->dataPtr->staging.data());
+  Ogre2ReadbackManager::Instance()->Read(
+      this->dataPtr->atlas->getBuffer()->getRenderTarget(), box);
+
+  unsigned int pixelSize = PixelUtil::BytesPerPixel(format);
+  size_t atlasRowSize = static_cast<size_t>(atlasWidth) * pixelSize;
+  const unsigned char *src = this->dataPtr->staging.data();
+  unsigned char *dst = static_cast<unsigned char *>(_data);
+  for (size_t i = 0u; i < this->dataPtr->levels.size(); ++i)
+  {
+    size_t rowSize =
+        static_cast<size_t>(this->dataPtr->levelWidths[i]) * pixelSize;
+    for (unsigned int y = 0u; y < this->dataPtr->levelHeights[i]; ++y)
+    {
+      std::memcpy(dst, src, rowSize);
+      dst += rowSize;
+      src += atlasRowSize;
+    }
+  }
+  return true;
+}
@@ -16,6 +16,12 @@
  */
 
 
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 #include "ignition/rendering/ogre2/Ogre2DynamicRenderable.hh"
 #include "ignition/rendering/ogre2/Ogre2LidarVisual.hh"
@@ -33,20 +39,31 @@
 
 class ignition::rendering::Ogre2LidarVisualPrivate
 {
+  /// \brief Create a dynamic renderable attached to the visual if it does
+  /// not exist yet
+  /// \param[in,out] _renderable Renderable to create
+  /// \param[in] _type Render operation type of the renderable
+  /// \param[in] _material Name of the material of the renderable
+  /// \param[in] _visual Lidar visual the renderable is attached to
+  public: void CreateRenderable(
+      std::shared_ptr<Ogre2DynamicRenderable> &_renderable,
+      MarkerType _type, const std::string &_material,
+      Ogre2LidarVisual *_visual);
+
   /// \brief Non Hitting DynamicLines Object to display
-  public: std::vector<std::shared_ptr<Ogre2DynamicRenderable>> noHitRayStrips;
+  public: std::shared_ptr<Ogre2DynamicRenderable> noHitRayStrips;
 
   /// \brief Hitting DynamicLines Object to display
-  public: std::vector<std::shared_ptr<Ogre2DynamicRenderable>> rayStrips;
+  public: std::shared_ptr<Ogre2DynamicRenderable> rayStrips;
 
   /// \brief Dead Zone Geometry DynamicLines Object to display
-  public: std::vector<std::shared_ptr<Ogre2DynamicRenderable>> deadZoneRayFans;
+  public: std::shared_ptr<Ogre2DynamicRenderable> deadZoneRayFans;
 
   /// \brief Lidar Ray DynamicLines Object to display
-  public: std::vector<std::shared_ptr<Ogre2DynamicRenderable>> rayLines;
+  public: std::shared_ptr<Ogre2DynamicRenderable> rayLines;
 
   /// \brief Lidar Points DynamicLines Object to display
-  public: std::vector<std::shared_ptr<Ogre2DynamicRenderable>> points;
+  public: std::shared_ptr<Ogre2DynamicRenderable> points;
 
   /// \brief Lidar visual type
   public: LidarVisualType lidarVisType =
@@ -55,19 +72,58 @@ class ignition::rendering::Ogre2LidarVisualPrivate
   /// \brief Current value of DisplayNonHitting parameter
   public: bool currentDisplayNonHitting = true;
 
-  /// \brief The current lidar points data
-  public: std::vector<double> lidarPoints;
+  /// \brief The current lidar points data. Kept in single precision like
+  /// the data of gpu rays sensors and the vertices of the renderables.
+  public: std::vector<float> lidarPoints;
 
   /// \brief True if new points data is received
   public: bool receivedData = false;
 
   /// \brief The visibility of the visual
   public: bool visible = true;
+
+  /// \brief Direction of each ray in the visual frame, 3 values per ray
+  public: std::vector<double> rayAxes;
+
+  /// \brief Ray angles, counts and offset rotation the ray directions were
+  /// computed for
+  public: std::vector<double> rayAxesKey;
+
+  /// \brief Vertices of the renderables, 3 floats per vertex. Kept between
+  /// updates to avoid reallocating them.
+  public: std::vector<float> lineVertices;
+
+  /// \brief Vertices of the hitting ray strips
+  public: std::vector<float> stripVertices;
+
+  /// \brief Vertices of the non hitting ray strips
+  public: std::vector<float> noHitStripVertices;
+
+  /// \brief Vertices of the dead zone fans
+  public: std::vector<float> deadZoneVertices;
 };
 
 using namespace ignition;
 using namespace rendering;
 
+//////////////////////////////////////////////////
+void Ogre2LidarVisualPrivate::CreateRenderable(
+    std::shared_ptr<Ogre2DynamicRenderable> &_renderable,
+    MarkerType _type, const std::string &_material,
+    Ogre2LidarVisual *_visual)
+{
+  if (_renderable)
+    return;
+
+  _renderable = std::make_shared<Ogre2DynamicRenderable>(_visual->Scene());
+  _renderable->SetOperationType(_type);
+  MaterialPtr mat = _visual->Scene()->Material(_material);
+  _renderable->SetMaterial(mat, false);
+
+  Ogre::SceneNode *node = _visual->Node();
+  node->attachObject(_renderable->OgreObject());
+}
+
 //////////////////////////////////////////////////
 Ogre2LidarVisual::Ogre2LidarVisual()
   : dataPtr(new Ogre2LidarVisualPrivate)
@@ -90,35 +146,14 @@ void Ogre2LidarVisual::PreRender()
 void Ogre2LidarVisual::Destroy()
 {
   BaseLidarVisual::Destroy();
-  for (auto ray : this->dataPtr->noHitRayStrips)
-  {
-    ray->Clear();
-    ray.reset();
-  }
-
-  for (auto ray : this->dataPtr->rayStrips)
-  {
-    ray->Clear();
-    ray.reset();
-  }
-
-  for (auto ray : this->dataPtr->rayLines)
-  {
-    ray->Clear();
-    ray.reset();
-  }
-
-  for (auto ray : this->dataPtr->deadZoneRayFans)
+  for (auto ray : {this->dataPtr->noHitRayStrips, this->dataPtr->rayStrips,
+      this->dataPtr->rayLines, this->dataPtr->deadZoneRayFans,
+      this->dataPtr->points})
   {
-    ray->Clear();
-    ray.reset();
-  }
-
-  for (auto ray : this->dataPtr->points)
-  {
-    ray->Clear();
-    ray.reset();
+    if (ray)
+      ray->Clear();
   }
+  this->ClearVisualData();
 
   this->dataPtr->lidarPoints.clear();
 }
@@ -148,17 +183,40 @@ void Ogre2LidarVisual::ClearPoints()
 //////////////////////////////////////////////////
 void Ogre2LidarVisual::ClearVisualData()
 {
-  this->dataPtr->noHitRayStrips.clear();
-  this->dataPtr->deadZoneRayFans.clear();
-  this->dataPtr->rayLines.clear();
-  this->dataPtr->rayStrips.clear();
-  this->dataPtr->points.clear();
+  this->dataPtr->noHitRayStrips.reset();
+  this->dataPtr->deadZoneRayFans.reset();
+  this->dataPtr->rayLines.reset();
+  this->dataPtr->rayStrips.reset();
+  this->dataPtr->points.reset();
 }
 
 //////////////////////////////////////////////////
 void Ogre2LidarVisual::SetPoints(const std::vector<double> &_points)
 {
-  this->dataPtr->lidarPoints = _points;
+  this->dataPtr->lidarPoints.assign(_points.begin(), _points.end());
+  this->dataPtr->receivedData = true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2LidarVisual::SetPoints(const float *_data, unsigned int _count,
+    unsigned int _channels)
+{
+  if (!_data && _count > 0u)
+  {
+    ignerr << "Null lidar data" << std::endl;
+    return;
+  }
+
+  this->dataPtr->lidarPoints.resize(_count);
+  if (_channels == 1u)
+  {
+    std::copy(_data, _data + _count, this->dataPtr->lidarPoints.begin());
+  }
+  else
+  {
+    for (unsigned int i = 0; i < _count; ++i)
+      this->dataPtr->lidarPoints[i] = _data[i * _channels];
+  }
   this->dataPtr->receivedData = true;
 }
 
@@ -178,30 +236,16 @@ void Ogre2LidarVisual::Update()
     return;
   }
 
-  bool clearVisuals = false;
-
-  if (this->lidarVisualType != this->dataPtr->lidarVisType
-        || !this->displayNonHitting)
-  {
-    clearVisuals = true;
-  }
-
-  if (this->displayNonHitting != this->dataPtr->currentDisplayNonHitting)
-  {
-    clearVisuals = true;
-    this->dataPtr->currentDisplayNonHitting = this->displayNonHitting;
-  }
-
   // if visual type is changed, clear all DynamicLines
-  if (clearVisuals)
+  if (this->lidarVisualType != this->dataPtr->lidarVisType ||
+      this->displayNonHitting != this->dataPtr->currentDisplayNonHitting)
   {
     this->ClearVisualData();
+    this->dataPtr->currentDisplayNonHitting = this->displayNonHitting;
   }
   this->dataPtr->lidarVisType = this->lidarVisualType;
 
   this->dataPtr->receivedData = false;
-  double horizontalAngle = this->minHorizontalAngle;
-  double verticalAngle = this->minVerticalAngle;
 
   if (this->horizontalCount > 1)
   {
@@ -226,219 +270,179 @@ void Ogre2LidarVisual::Update()
     return;
   }
 
-  // Process each point from received data
-  // Every line segment, and every triangle is saved separately,
-  // as a pointer to a DynamicLine
-  // This initializes and updates only the selected DynamicLine variables
-  for (unsigned int j = 0; j < this->verticalCount; ++j)
+  // the ray directions only depend on the ray angles and the offset
+  // rotation, so they are only computed when these change
+  const ignition::math::Quaterniond &offsetRot = this->offset.Rot();
+  std::vector<double> key = {this->minHorizontalAngle,
+      this->horizontalAngleStep, static_cast<double>(this->horizontalCount),
+      this->minVerticalAngle, this->verticalAngleStep,
+      static_cast<double>(this->verticalCount),
+      offsetRot.W(), offsetRot.X(), offsetRot.Y(), offsetRot.Z()};
+  if (key != this->dataPtr->rayAxesKey)
   {
-    horizontalAngle = this->minHorizontalAngle;
-
-    if (this->dataPtr->lidarVisType == LidarVisualType::LVT_RAY_LINES ||
-        this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS)
+    this->dataPtr->rayAxesKey = key;
+    this->dataPtr->rayAxes.resize(
+        this->verticalCount * this->horizontalCount * 3u);
+    double verticalAngle = this->minVerticalAngle;
+    for (unsigned int j = 0; j < this->verticalCount; ++j)
     {
-      if (j+1 > this->dataPtr->rayLines.size())
+      double horizontalAngle = this->minHorizontalAngle;
+      for (unsigned int i = 0; i < this->horizontalCount; ++i)
       {
-        std::shared_ptr<Ogre2DynamicRenderable> renderable =
-                        std::shared_ptr<Ogre2DynamicRenderable>(
-                                    new Ogre2DynamicRenderable(this->Scene()));
-
-        renderable->SetOperationType(MT_LINE_LIST);
-        MaterialPtr mat = this->Scene()->Material("Lidar/BlueRay");
-        renderable->SetMaterial(mat, false);
-
-        this->ogreNode->attachObject(renderable->OgreObject());
-        this->dataPtr->rayLines.push_back(renderable);
-
-        if (this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS)
-        {
-          renderable = std::shared_ptr<Ogre2DynamicRenderable>(
-                                  new Ogre2DynamicRenderable(this->Scene()));
-
-          renderable->SetOperationType(MT_TRIANGLE_STRIP);
-          mat = this->Scene()->Material("Lidar/LightBlueStrips");
-
-          renderable->SetMaterial(mat, false);
-
-          this->ogreNode->attachObject(renderable->OgreObject());
-          this->dataPtr->noHitRayStrips.push_back(renderable);
-
-          renderable = std::shared_ptr<Ogre2DynamicRenderable>(
-                                  new Ogre2DynamicRenderable(this->Scene()));
-
-          renderable->SetOperationType(MT_TRIANGLE_FAN);
-          mat = this->Scene()->Material("Lidar/TransBlack");
-
-          renderable->SetMaterial(mat, false);
-
-          this->ogreNode->attachObject(renderable->OgreObject());
-          this->dataPtr->deadZoneRayFans.push_back(renderable);
-          this->dataPtr->deadZoneRayFans[j]->AddPoint(
-                      ignition::math::Vector3d::Zero);
-
-          renderable = std::shared_ptr<Ogre2DynamicRenderable>(
-                                  new Ogre2DynamicRenderable(this->Scene()));
-
-          renderable->SetOperationType(MT_TRIANGLE_STRIP);
-          mat = this->Scene()->Material("Lidar/BlueStrips");
-
-          renderable->SetMaterial(mat, false);
-
-          this->ogreNode->attachObject(renderable->OgreObject());
-          this->dataPtr->rayStrips.push_back(renderable);
-        }
-      }
-    }
-
-    else if (this->dataPtr->lidarVisType ==
-                  LidarVisualType::LVT_POINTS)
-    {
-      if (j+1 > this->dataPtr->points.size())
-      {
-        std::shared_ptr<Ogre2DynamicRenderable> renderable =
-                        std::shared_ptr<Ogre2DynamicRenderable>(
-                                    new Ogre2DynamicRenderable(this->Scene()));
-
-        renderable->SetOperationType(MT_POINTS);
-        MaterialPtr mat = this->Scene()->Material("Lidar/BlueRay");
-        renderable->SetMaterial(mat, false);
-
-        this->ogreNode->attachObject(renderable->OgreObject());
-        this->dataPtr->points.push_back(renderable);
+        ignition::math::Quaterniond ray(
+          ignition::math::Vector3d(0.0, -verticalAngle, horizontalAngle));
+        ignition::math::Vector3d axis = offsetRot * ray *
+          ignition::math::Vector3d(1.0, 0.0, 0.0);
+        double *a = &this->dataPtr->rayAxes[
+            (j * this->horizontalCount + i) * 3u];
+        a[0] = axis.X();
+        a[1] = axis.Y();
+        a[2] = axis.Z();
+        horizontalAngle += this->horizontalAngleStep;
       }
+      verticalAngle += this->verticalAngleStep;
     }
+  }
 
-    if (this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS)
-    {
-      this->dataPtr->deadZoneRayFans[j]->SetPoint(0, this->offset.Pos());
-    }
+  const bool strips =
+      this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS;
+  const bool lines = strips ||
+      this->dataPtr->lidarVisType == LidarVisualType::LVT_RAY_LINES;
+  const bool points =
+      this->dataPtr->lidarVisType == LidarVisualType::LVT_POINTS;
+
+  // All the rays of the scan are drawn by a single renderable per kind of
+  // geometry. The strips and fans of each vertical ring are unrolled into
+  // triangle lists so the rings can share the same renderable.
+  auto &lineVertices = this->dataPtr->lineVertices;
+  auto &stripVertices = this->dataPtr->stripVertices;
+  auto &noHitStripVertices = this->dataPtr->noHitStripVertices;
+  auto &deadZoneVertices = this->dataPtr->deadZoneVertices;
+  lineVertices.clear();
+  stripVertices.clear();
+  noHitStripVertices.clear();
+  deadZoneVertices.clear();
+  auto add = [](std::vector<float> &_vertices,
+      const ignition::math::Vector3d &_pt)
+  {
+    _vertices.push_back(static_cast<float>(_pt.X()));
+    _vertices.push_back(static_cast<float>(_pt.Y()));
+    _vertices.push_back(static_cast<float>(_pt.Z()));
+  };
 
-    unsigned count = this->horizontalCount;
-    // Process each ray in current scan
-    for (unsigned int i = 0; i < count; ++i)
+  const ignition::math::Vector3d &origin = this->offset.Pos();
+  for (unsigned int j = 0; j < this->verticalCount; ++j)
+  {
+    ignition::math::Vector3d prevStartPt;
+    ignition::math::Vector3d prevStripPt;
+    ignition::math::Vector3d prevNoHitStripPt;
+    for (unsigned int i = 0; i < this->horizontalCount; ++i)
     {
+      unsigned int index = j * this->horizontalCount + i;
       // calculate range of the ray
-      double r = this->dataPtr->lidarPoints[ j * this->horizontalCount + i];
+      double r = this->dataPtr->lidarPoints[index];
 
       bool inf = (std::isinf(r) || r >= this->maxRange);
-      ignition::math::Quaterniond ray(
-        ignition::math::Vector3d(0.0, -verticalAngle, horizontalAngle));
-
-      ignition::math::Vector3d axis = this->offset.Rot() * ray *
-        ignition::math::Vector3d(1.0, 0.0, 0.0);
+      const double *a = &this->dataPtr->rayAxes[index * 3u];
+      ignition::math::Vector3d axis(a[0], a[1], a[2]);
 
       // Check for infinite range, which indicates the ray did not
       // intersect an object.
       double hitRange = inf ? 0 : r;
 
       // Compute the start point of the ray
-      ignition::math::Vector3d startPt =
-                  (axis * this->minRange) + this->offset.Pos();
+      ignition::math::Vector3d startPt = (axis * this->minRange) + origin;
 
       // Compute the end point of the ray
-      ignition::math::Vector3d pt =
-                  (axis * hitRange) + this->offset.Pos();
+      ignition::math::Vector3d pt = (axis * hitRange) + origin;
 
       double noHitRange = inf ? this->maxRange : hitRange;
 
       // Compute the end point of the no-hit ray
-      ignition::math::Vector3d noHitPt =
-                  (axis * noHitRange) + this->offset.Pos();
-
-      // Update the lines and strips that represent each simulated ray.
+      ignition::math::Vector3d noHitPt = (axis * noHitRange) + origin;
 
-      // For TRIANGLE_STRIPS Lidar Visual to be displayed
-      if (this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS
-        || this->dataPtr->lidarVisType == LidarVisualType::LVT_RAY_LINES)
+      if (lines && (this->displayNonHitting || !inf))
       {
-        if (i >= this->dataPtr->rayLines[j]->PointCount()/2)
-        {
-          if (this->displayNonHitting || !inf)
-          {
-            this->dataPtr->rayLines[j]->AddPoint(startPt);
-            this->dataPtr->rayLines[j]->AddPoint(inf ? noHitPt: pt);
-          }
-
-          if (this->dataPtr->lidarVisType ==
-                LidarVisualType::LVT_TRIANGLE_STRIPS)
-          {
-            this->dataPtr->rayStrips[j]->AddPoint(startPt);
-            this->dataPtr->rayStrips[j]->AddPoint(inf ? startPt : pt);
-
-            this->dataPtr->noHitRayStrips[j]->AddPoint(startPt);
-            this->dataPtr->noHitRayStrips[j]->AddPoint(
-                inf ? (this->displayNonHitting? noHitPt: startPt) : pt);
-          }
-        }
-        else
-        {
-          if (this->displayNonHitting || !inf)
-          {
-            this->dataPtr->rayLines[j]->SetPoint(i*2, startPt);
-            this->dataPtr->rayLines[j]->SetPoint(i*2+1, inf ? noHitPt: pt);
-          }
-
-          if (this->dataPtr->lidarVisType ==
-                LidarVisualType::LVT_TRIANGLE_STRIPS)
-          {
-            this->dataPtr->rayStrips[j]->SetPoint(i*2, startPt);
-            this->dataPtr->rayStrips[j]->SetPoint(i*2+1, inf? startPt : pt);
-
-            this->dataPtr->noHitRayStrips[j]->SetPoint(i*2, startPt);
-            this->dataPtr->noHitRayStrips[j]->SetPoint(i*2+1,
-                inf ? (this->displayNonHitting? noHitPt: startPt) : pt);
-          }
-        }
-        if (this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS)
-        {
-          // Draw the triangle fan that indicates the dead zone.
-          if (i+1 >= this->dataPtr->deadZoneRayFans[j]->PointCount())
-            this->dataPtr->deadZoneRayFans[j]->AddPoint(startPt);
-          else
-            this->dataPtr->deadZoneRayFans[j]->SetPoint(i+1, startPt);
-        }
+        add(lineVertices, startPt);
+        add(lineVertices, inf ? noHitPt : pt);
       }
-
-      // For POINTS Lidar Visual to be displayed
-      else if (this->dataPtr->lidarVisType ==
-                LidarVisualType::LVT_POINTS)
+      else if (points && (this->displayNonHitting || !inf))
       {
-        if (i >= this->dataPtr->points[j]->PointCount())
-        {
-          if (this->displayNonHitting || !inf)
-          {
-            this->dataPtr->points[j]->AddPoint(inf ? noHitPt: pt);
-          }
-        }
-        else
-        {
-          if (this->displayNonHitting || !inf)
-          {
-            this->dataPtr->points[j]->SetPoint(i, inf ? noHitPt: pt);
-          }
-        }
+        add(lineVertices, inf ? noHitPt : pt);
       }
-      horizontalAngle += this->horizontalAngleStep;
-    }
 
-    // Update the DynamicLines pointers after adding points based on type
-    if (this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS
-      || this->dataPtr->lidarVisType == LidarVisualType::LVT_RAY_LINES)
-    {
-      this->dataPtr->rayLines[j]->Update();
-      if (this->dataPtr->lidarVisType ==
-                      LidarVisualType::LVT_TRIANGLE_STRIPS)
+      if (!strips)
+        continue;
+
+      ignition::math::Vector3d stripPt = inf ? startPt : pt;
+      ignition::math::Vector3d noHitStripPt =
+          inf ? (this->displayNonHitting ? noHitPt : startPt) : pt;
+      if (i > 0)
       {
-        this->dataPtr->rayStrips[j]->Update();
-        this->dataPtr->noHitRayStrips[j]->Update();
-        this->dataPtr->deadZoneRayFans[j]->Update();
+        // the two triangles of the strip between this ray and the
+        // previous one, with the winding of the original strip
+        add(stripVertices, prevStartPt);
+        add(stripVertices, prevStripPt);
+        add(stripVertices, startPt);
+        add(stripVertices, startPt);
+        add(stripVertices, prevStripPt);
+        add(stripVertices, stripPt);
+
+        add(noHitStripVertices, prevStartPt);
+        add(noHitStripVertices, prevNoHitStripPt);
+        add(noHitStripVertices, startPt);
+        add(noHitStripVertices, startPt);
+        add(noHitStripVertices, prevNoHitStripPt);
+        add(noHitStripVertices, noHitStripPt);
+
+        // the triangle of the dead zone fan between this ray and the
+        // previous one
+        add(deadZoneVertices, origin);
+        add(deadZoneVertices, prevStartPt);
+        add(deadZoneVertices, startPt);
       }
+      prevStartPt = startPt;
+      prevStripPt = stripPt;
+      prevNoHitStripPt = noHitStripPt;
     }
-    else if (this->dataPtr->lidarVisType == LidarVisualType::LVT_POINTS)
-    {
-      this->dataPtr->points[j]->Update();
-    }
-    verticalAngle += this->verticalAngleStep;
+  }
+
+  if (lines)
+  {
+    this->dataPtr->CreateRenderable(this->dataPtr->rayLines, MT_LINE_LIST,
+        "Lidar/BlueRay", this);
+    this->dataPtr->rayLines->SetPoints(lineVertices.data(),
+        lineVertices.size() / 3u);
+    this->dataPtr->rayLines->Update();
+  }
+  else if (points)
+  {
+    this->dataPtr->CreateRenderable(this->dataPtr->points, MT_POINTS,
+        "Lidar/BlueRay", this);
+    this->dataPtr->points->SetPoints(lineVertices.data(),
+        lineVertices.size() / 3u);
+    this->dataPtr->points->Update();
+  }
+
+  if (strips)
+  {
+    this->dataPtr->CreateRenderable(this->dataPtr->noHitRayStrips,
+        MT_TRIANGLE_LIST, "Lidar/LightBlueStrips", this);
+    this->dataPtr->noHitRayStrips->SetPoints(noHitStripVertices.data(),
+        noHitStripVertices.size() / 3u);
+    this->dataPtr->noHitRayStrips->Update();
+
+    this->dataPtr->CreateRenderable(this->dataPtr->deadZoneRayFans,
+        MT_TRIANGLE_LIST, "Lidar/TransBlack", this);
+    this->dataPtr->deadZoneRayFans->SetPoints(deadZoneVertices.data(),
+        deadZoneVertices.size() / 3u);
+    this->dataPtr->deadZoneRayFans->Update();
+
+    this->dataPtr->CreateRenderable(this->dataPtr->rayStrips,
+        MT_TRIANGLE_LIST, "Lidar/BlueStrips", this);
+    this->dataPtr->rayStrips->SetPoints(stripVertices.data(),
+        stripVertices.size() / 3u);
+    this->dataPtr->rayStrips->Update();
   }
 
   // The newly created dynamic lines are having default visibility as true.
@@ -456,7 +460,8 @@ unsigned int Ogre2LidarVisual::PointCount() const
 //////////////////////////////////////////////////
 std::vector<double> Ogre2LidarVisual::Points() const
 {
-  return this->dataPtr->lidarPoints;
+  return std::vector<double>(this->dataPtr->lidarPoints.begin(),
+      this->dataPtr->lidarPoints.end());
 }
 
 //////////////////////////////////////////////////
@@ -464,4 +469,5 @@ void Ogre2LidarVisual::SetVisible(bool _visible)
 {
   this->dataPtr->visible = _visible;
   this->ogreNode->setVisible(this->dataPtr->visible);
+  this->SetBoundsDirty();
 }
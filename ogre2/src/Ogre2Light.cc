@@ -155,6 +155,19 @@ void Ogre2Light::SetCastShadows(bool _castShadows)
   this->scene->SetShadowsDirty(true);
 }
 
+//////////////////////////////////////////////////
+void Ogre2Light::SetStatic(bool _static)
+{
+  if (_static == this->isStatic)
+    return;
+
+  BaseLight::SetStatic(_static);
+
+  // static lights have shadow maps of their own
+  if (this->CastShadows())
+    this->scene->SetShadowsDirty(true);
+}
+
 //////////////////////////////////////////////////
 Ogre::Light *Ogre2Light::Light() const
 {
@@ -165,6 +178,11 @@ Ogre::Light *Ogre2Light::Light() const
 void Ogre2Light::Destroy()
 {
   BaseLight::Destroy();
+
+  // the shadow node has one shadow map less to render
+  if (this->ogreLight->getCastShadows())
+    this->scene->SetShadowsDirty(true);
+
   Ogre::SceneManager *ogreSceneManager = this->scene->OgreSceneManager();
   ogreSceneManager->destroySceneNode(this->ogreLight->getParentSceneNode());
   ogreSceneManager->destroyLight(this->ogreLight);
@@ -178,6 +196,27 @@ void Ogre2Light::Init()
   this->Reset();
 }
 
+//////////////////////////////////////////////////
+void Ogre2Light::SetRawLocalPosition(const math::Vector3d &_position)
+{
+  Ogre2Node::SetRawLocalPosition(_position);
+  this->SetStaticShadowsDirty();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Light::SetRawLocalRotation(const math::Quaterniond &_rotation)
+{
+  Ogre2Node::SetRawLocalRotation(_rotation);
+  this->SetStaticShadowsDirty();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Light::SetStaticShadowsDirty()
+{
+  if (this->isStatic && this->CastShadows())
+    this->scene->SetStaticShadowsDirty();
+}
+
 //////////////////////////////////////////////////
 void Ogre2Light::CreateLight()
 {
@@ -261,6 +300,7 @@ math::Vector3d Ogre2SpotLight::Direction() const
 void Ogre2SpotLight::SetDirection(const math::Vector3d &_dir)
 {
   this->ogreLight->setDirection(Ogre2Conversions::Convert(_dir));
+  this->SetStaticShadowsDirty();
 }
 
 //////////////////////////////////////////////////
@@ -285,6 +325,7 @@ math::Angle Ogre2SpotLight::OuterAngle() const
 void Ogre2SpotLight::SetOuterAngle(const math::Angle &_angle)
 {
   this->ogreLight->setSpotlightOuterAngle(Ogre2Conversions::Convert(_angle));
+  this->SetStaticShadowsDirty();
 }
 
 //////////////////////////////////////////////////
@@ -101,6 +101,7 @@ void Ogre2LightVisual::CreateVisual()
   }
 
   this->dataPtr->lightVisual->Update();
+  this->SetBoundsDirty();
 }
 
 //////////////////////////////////////////////////
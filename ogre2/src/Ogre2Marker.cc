@@ -232,6 +232,7 @@ void Ogre2Marker::SetPoint(unsigned int _index,
     const ignition::math::Vector3d &_value)
 {
   this->dataPtr->dynamicRenderable->SetPoint(_index, _value);
+  this->MarkPreRenderDirty();
 }
 
 //////////////////////////////////////////////////
@@ -239,12 +240,22 @@ void Ogre2Marker::AddPoint(const ignition::math::Vector3d &_pt,
     const ignition::math::Color &_color)
 {
   this->dataPtr->dynamicRenderable->AddPoint(_pt, _color);
+  this->MarkPreRenderDirty();
 }
 
 //////////////////////////////////////////////////
 void Ogre2Marker::ClearPoints()
 {
   this->dataPtr->dynamicRenderable->Clear();
+  this->MarkPreRenderDirty();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Marker::SetPoints(const float *_xyz, size_t _count,
+    const float *_rgba)
+{
+  this->dataPtr->dynamicRenderable->SetPoints(_xyz, _count, _rgba);
+  this->MarkPreRenderDirty();
 }
 
 //////////////////////////////////////////////////
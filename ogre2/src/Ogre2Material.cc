@@ -30,6 +30,12 @@
 #pragma warning(pop)
 #endif
 
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
 #include <ignition/common/Console.hh>
 #include <ignition/common/Filesystem.hh>
 
@@ -40,15 +46,51 @@
 #include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
 
+#include "Ogre2TextureStreamer.hh"
+
 
 /// \brief Private data for the Ogre2Material class
 class ignition::rendering::Ogre2MaterialPrivate
 {
+  /// \brief Stop tracking the texture bound to a type of texture map
+  /// \param[in] _type Type of texture map
+  public: void Release(Ogre::PbsTextureTypes _type)
+  {
+    this->streamedTextures.erase(_type);
+    this->textureUsages.erase(_type);
+  }
+
+  /// \brief Names of the textures being streamed, indexed by the type of
+  /// texture map they are bound to
+  public: std::map<Ogre::PbsTextureTypes, std::string> streamedTextures;
+
+  /// \brief Usage of the bound textures, indexed by the type of texture map
+  /// they are bound to
+  public: std::map<Ogre::PbsTextureTypes,
+      std::shared_ptr<Ogre2TextureStreamer::Usage>> textureUsages;
+
+  /// \brief Material owning the datablock this material shares, null if
+  /// the datablock is its own
+  public: const Ogre2Material *datablockOwner = nullptr;
+
+  /// \brief Clones sharing the datablock of this material
+  public: std::set<Ogre2Material *> datablockSharers;
+
+  /// \brief Material being cloned by the material created next, which
+  /// shares its datablock instead of creating one
+  public: static const Ogre2Material *cloneSource;
+
+  /// \brief Key of the id of the material bound to a renderable in the user
+  /// object bindings of the renderable
+  public: static const char *kMaterialIdKey;
 };
 
 using namespace ignition;
 using namespace rendering;
 
+const Ogre2Material *Ogre2MaterialPrivate::cloneSource = nullptr;
+const char *Ogre2MaterialPrivate::kMaterialIdKey = "ignition::material_id";
+
 //////////////////////////////////////////////////
 Ogre2Material::Ogre2Material()
   : dataPtr(std::make_unique<Ogre2MaterialPrivate>())
@@ -65,14 +107,39 @@ Ogre2Material::~Ogre2Material()
 void Ogre2Material::Destroy()
 {
   if (!this->Scene()->IsInitialized())
+  {
+    // nothing to copy from, only forget the shared datablock
+    for (auto sharer : this->dataPtr->datablockSharers)
+      sharer->dataPtr->datablockOwner = nullptr;
+    this->dataPtr->datablockSharers.clear();
+    if (this->dataPtr->datablockOwner)
+      this->dataPtr->datablockOwner->dataPtr->datablockSharers.erase(this);
+    this->dataPtr->datablockOwner = nullptr;
     return;
+  }
 
   if (!this->ogreDatablock)
     return;
 
-  this->ogreHlmsPbs->destroyDatablock(this->ogreDatablockId);
+  // the clones sharing the datablock need a copy before it is destroyed
+  while (!this->dataPtr->datablockSharers.empty())
+    (*this->dataPtr->datablockSharers.begin())->MakeDatablockUnique();
+
+  if (this->dataPtr->datablockOwner)
+  {
+    this->dataPtr->datablockOwner->dataPtr->datablockSharers.erase(this);
+    this->dataPtr->datablockOwner = nullptr;
+  }
+  else
+  {
+    this->ogreHlmsPbs->destroyDatablock(this->ogreDatablockId);
+  }
   this->ogreDatablock = nullptr;
 
+  // the textures can be evicted now that no datablock references them
+  this->dataPtr->streamedTextures.clear();
+  this->dataPtr->textureUsages.clear();
+
   if (this->ogreUnlitDatablock)
   {
     this->ogreUnlitDatablock->getCreator()->destroyDatablock(
@@ -89,6 +156,19 @@ void Ogre2Material::Destroy()
   }
 }
 
+//////////////////////////////////////////////////
+MaterialPtr Ogre2Material::Clone(const std::string &_name) const
+{
+  if (!this->ogreDatablock)
+    return BaseMaterial::Clone(_name);
+
+  // the clone is initialized with the datablock of this material
+  Ogre2MaterialPrivate::cloneSource = this;
+  MaterialPtr material = this->Scene()->CreateMaterial(_name);
+  Ogre2MaterialPrivate::cloneSource = nullptr;
+  return material;
+}
+
 //////////////////////////////////////////////////
 math::Color Ogre2Material::Diffuse() const
 {
@@ -100,6 +180,7 @@ math::Color Ogre2Material::Diffuse() const
 //////////////////////////////////////////////////
 void Ogre2Material::SetDiffuse(const math::Color &_color)
 {
+  this->MakeDatablockUnique();
   BaseMaterial::SetDiffuse(_color);
   this->ogreDatablock->setDiffuse(
       Ogre::Vector3(_color.R(), _color.G(), _color.B()));
@@ -117,6 +198,7 @@ math::Color Ogre2Material::Specular() const
 //////////////////////////////////////////////////
 void Ogre2Material::SetSpecular(const math::Color &_color)
 {
+  this->MakeDatablockUnique();
   this->ogreDatablock->setSpecular(
       Ogre::Vector3(_color.R(), _color.G(), _color.B()));
 }
@@ -132,6 +214,7 @@ math::Color Ogre2Material::Emissive() const
 //////////////////////////////////////////////////
 void Ogre2Material::SetEmissive(const math::Color &_color)
 {
+  this->MakeDatablockUnique();
   this->ogreDatablock->setEmissive(
       Ogre::Vector3(_color.R(), _color.G(), _color.B()));
 }
@@ -139,6 +222,7 @@ void Ogre2Material::SetEmissive(const math::Color &_color)
 //////////////////////////////////////////////////
 void Ogre2Material::SetTransparency(const double _transparency)
 {
+  this->MakeDatablockUnique();
   this->transparency = std::min(std::max(_transparency, 0.0), 1.0);
   this->UpdateTransparency();
 }
@@ -161,6 +245,7 @@ void Ogre2Material::UpdateTransparency()
 void Ogre2Material::SetAlphaFromTexture(bool _enabled,
     double _alpha, bool _twoSided)
 {
+  this->MakeDatablockUnique();
   BaseMaterial::SetAlphaFromTexture(_enabled, _alpha, _twoSided);
   if (_enabled)
   {
@@ -186,6 +271,7 @@ float Ogre2Material::RenderOrder() const
 //////////////////////////////////////////////////
 void Ogre2Material::SetRenderOrder(const float _renderOrder)
 {
+  this->MakeDatablockUnique();
   this->renderOrder = _renderOrder;
   Ogre::HlmsMacroblock macroblock(
       *this->ogreDatablock->getMacroblock());
@@ -202,6 +288,7 @@ bool Ogre2Material::ReceiveShadows() const
 //////////////////////////////////////////////////
 void Ogre2Material::SetReceiveShadows(const bool _receiveShadows)
 {
+  this->MakeDatablockUnique();
   this->ogreDatablock->setReceiveShadows(_receiveShadows);
 }
 
@@ -233,7 +320,9 @@ void Ogre2Material::SetTexture(const std::string &_name)
 //////////////////////////////////////////////////
 void Ogre2Material::ClearTexture()
 {
+  this->MakeDatablockUnique();
   this->textureName = "";
+  this->dataPtr->Release(Ogre::PBSM_DIFFUSE);
   this->ogreDatablock->setTexture(Ogre::PBSM_DIFFUSE, 0, Ogre::TexturePtr());
 }
 
@@ -265,7 +354,9 @@ void Ogre2Material::SetNormalMap(const std::string &_name)
 //////////////////////////////////////////////////
 void Ogre2Material::ClearNormalMap()
 {
+  this->MakeDatablockUnique();
   this->normalMapName = "";
+  this->dataPtr->Release(Ogre::PBSM_NORMAL);
   this->ogreDatablock->setTexture(Ogre::PBSM_NORMAL, 0, Ogre::TexturePtr());
 }
 
@@ -297,7 +388,9 @@ void Ogre2Material::SetRoughnessMap(const std::string &_name)
 //////////////////////////////////////////////////
 void Ogre2Material::ClearRoughnessMap()
 {
+  this->MakeDatablockUnique();
   this->roughnessMapName = "";
+  this->dataPtr->Release(Ogre::PBSM_ROUGHNESS);
   this->ogreDatablock->setTexture(Ogre::PBSM_ROUGHNESS, 0, Ogre::TexturePtr());
 }
 
@@ -329,7 +422,9 @@ void Ogre2Material::SetMetalnessMap(const std::string &_name)
 //////////////////////////////////////////////////
 void Ogre2Material::ClearMetalnessMap()
 {
+  this->MakeDatablockUnique();
   this->metalnessMapName = "";
+  this->dataPtr->Release(Ogre::PBSM_METALLIC);
   this->ogreDatablock->setTexture(Ogre::PBSM_METALLIC, 0, Ogre::TexturePtr());
 }
 
@@ -361,7 +456,9 @@ void Ogre2Material::SetEnvironmentMap(const std::string &_name)
 //////////////////////////////////////////////////
 void Ogre2Material::ClearEnvironmentMap()
 {
+  this->MakeDatablockUnique();
   this->environmentMapName = "";
+  this->dataPtr->Release(Ogre::PBSM_REFLECTION);
   this->ogreDatablock->setTexture(Ogre::PBSM_REFLECTION, 0, Ogre::TexturePtr());
 }
 
@@ -393,7 +490,9 @@ void Ogre2Material::SetEmissiveMap(const std::string &_name)
 //////////////////////////////////////////////////
 void Ogre2Material::ClearEmissiveMap()
 {
+  this->MakeDatablockUnique();
   this->emissiveMapName = "";
+  this->dataPtr->Release(Ogre::PBSM_EMISSIVE);
   this->ogreDatablock->setTexture(Ogre::PBSM_EMISSIVE, 0, Ogre::TexturePtr());
 }
 
@@ -418,6 +517,7 @@ unsigned int Ogre2Material::LightMapTexCoordSet() const
 //////////////////////////////////////////////////
 void Ogre2Material::SetLightMap(const std::string &_name, unsigned int _uvSet)
 {
+  this->MakeDatablockUnique();
   if (_name.empty())
   {
     this->ClearLightMap();
@@ -442,14 +542,17 @@ void Ogre2Material::SetLightMap(const std::string &_name, unsigned int _uvSet)
 //////////////////////////////////////////////////
 void Ogre2Material::ClearLightMap()
 {
+  this->MakeDatablockUnique();
   this->lightMapName = "";
   this->lightMapUvSet = 0u;
+  this->dataPtr->Release(Ogre::PBSM_DETAIL0);
   this->ogreDatablock->setTexture(Ogre::PBSM_DETAIL0, 0, Ogre::TexturePtr());
 }
 
 //////////////////////////////////////////////////
 void Ogre2Material::SetRoughness(const float _roughness)
 {
+  this->MakeDatablockUnique();
   this->ogreDatablock->setRoughness(_roughness);
 }
 
@@ -462,6 +565,7 @@ float Ogre2Material::Roughness() const
 //////////////////////////////////////////////////
 void Ogre2Material::SetMetalness(const float _metalness)
 {
+  this->MakeDatablockUnique();
   this->ogreDatablock->setMetalness(_metalness);
 }
 
@@ -474,6 +578,16 @@ float Ogre2Material::Metalness() const
 //////////////////////////////////////////////////
 void Ogre2Material::PreRender()
 {
+  // stamp the textures as recently used
+  if (!this->dataPtr->textureUsages.empty())
+  {
+    uint64_t frame = Ogre2TextureStreamer::Instance()->Frame();
+    for (auto &usage : this->dataPtr->textureUsages)
+      usage.second->lastFrame = frame;
+
+    // keep stamping the textures in incremental PreRender
+    this->MarkPreRenderDirty();
+  }
 }
 
 //////////////////////////////////////////////////
@@ -496,67 +610,93 @@ Ogre::HlmsPbsDatablock *Ogre2Material::Datablock() const
   return this->ogreDatablock;
 }
 
+//////////////////////////////////////////////////
+void Ogre2Material::BindDatablock(Ogre::Renderable *_renderable) const
+{
+  _renderable->setDatablock(this->ogreDatablock);
+  _renderable->getUserObjectBindings().setUserAny(
+      Ogre2MaterialPrivate::kMaterialIdKey, Ogre::Any(this->Id()));
+}
+
 //////////////////////////////////////////////////
 void Ogre2Material::SetTextureMapImpl(const std::string &_texture,
   Ogre::PbsTextureTypes _type)
 {
-  // FIXME(anyone) need to keep baseName = _texture for all meshes. Refer to
-  // https://github.com/ignitionrobotics/ign-rendering/issues/139
-  // for more details
-  std::string baseName = _texture;
-  if (common::isFile(_texture))
-  {
-    baseName = common::basename(_texture);
-    size_t idx = _texture.rfind(baseName);
-    if (idx != std::string::npos)
-    {
-      std::string dirPath = _texture.substr(0, idx);
-      if (!dirPath.empty() &&
-          !Ogre::ResourceGroupManager::getSingleton().resourceLocationExists(
-          dirPath))
-      {
-        Ogre::ResourceGroupManager::getSingleton().addResourceLocation(
-            dirPath, "FileSystem", "General");
-      }
-    }
-  }
+  this->MakeDatablockUnique();
+  auto streamer = Ogre2TextureStreamer::Instance();
+  std::string baseName = streamer->ResourceName(_texture);
+  Ogre::HlmsTextureManager::TextureMapType mapType =
+      this->ogreDatablock->suggestMapTypeBasedOnTextureType(_type);
 
-  // temp workaround check if the model is a OBJ file
+  auto bind = [this, _type, baseName](
+      const Ogre::HlmsTextureManager::TextureLocation &_location,
+      bool _resident)
   {
-    size_t idx = _texture.rfind("meshes");
-    if (idx != std::string::npos)
+    // placeholders are never evicted so they are not tracked
+    if (_resident)
     {
-      std::string objFile =
-        common::joinPaths(_texture.substr(0, idx), "meshes", "model.obj");
-      if (common::isFile(objFile))
-        baseName = _texture;
-    }
-  }
+      this->dataPtr->textureUsages[_type] =
+          Ogre2TextureStreamer::Instance()->Track(baseName, _location);
 
-  Ogre::HlmsTextureManager *hlmsTextureManager =
-      this->ogreHlmsPbs->getHlmsManager()->getTextureManager();
-  Ogre::HlmsTextureManager::TextureLocation texLocation =
-      hlmsTextureManager->createOrRetrieveTexture(baseName,
-      this->ogreDatablock->suggestMapTypeBasedOnTextureType(_type));
+      // the usage is stamped in every PreRender
+      this->MarkPreRenderDirty();
+    }
 
-  Ogre::HlmsSamplerblock samplerBlockRef;
-  samplerBlockRef.mU = Ogre::TAM_WRAP;
-  samplerBlockRef.mV = Ogre::TAM_WRAP;
-  samplerBlockRef.mW = Ogre::TAM_WRAP;
+    Ogre::HlmsSamplerblock samplerBlockRef;
+    samplerBlockRef.mU = Ogre::TAM_WRAP;
+    samplerBlockRef.mV = Ogre::TAM_WRAP;
+    samplerBlockRef.mW = Ogre::TAM_WRAP;
 
-  this->ogreDatablock->setTexture(_type, texLocation.xIdx, texLocation.texture,
-      &samplerBlockRef);
+    this->ogreDatablock->setTexture(_type, _location.xIdx, _location.texture,
+        &samplerBlockRef);
 
-  // disable alpha from texture if texture does not have an alpha channel
-  // otherwise this becomes a transparent material
-  if (_type == Ogre::PBSM_DIFFUSE)
-  {
-    if (this->TextureAlphaEnabled() && !texLocation.texture->hasAlpha())
+    // disable alpha from texture if texture does not have an alpha channel
+    // otherwise this becomes a transparent material
+    if (_resident && _type == Ogre::PBSM_DIFFUSE)
     {
-      this->SetAlphaFromTexture(false, this->AlphaThreshold(),
-          this->TwoSidedEnabled());
+      if (this->TextureAlphaEnabled() && !_location.texture->hasAlpha())
+      {
+        this->SetAlphaFromTexture(false, this->AlphaThreshold(),
+            this->TwoSidedEnabled());
+      }
     }
+  };
+
+  // bind a placeholder and the streamed texture once it is uploaded, unless
+  // the map has been changed or the material destroyed by then
+  this->dataPtr->Release(_type);
+  std::weak_ptr<BaseObject> self = this->shared_from_this();
+  auto uploaded = [this, self, bind, baseName, _type](
+      const Ogre::HlmsTextureManager::TextureLocation &_location)
+  {
+    auto object = self.lock();
+    if (!object || !this->ogreDatablock)
+      return;
+    auto it = this->dataPtr->streamedTextures.find(_type);
+    if (it == this->dataPtr->streamedTextures.end() || it->second != baseName)
+      return;
+    this->dataPtr->streamedTextures.erase(it);
+    bind(_location, true);
+  };
+
+  Ogre::HlmsTextureManager::TextureLocation texLocation;
+  if (streamer->Stream(_texture, mapType, uploaded, texLocation))
+  {
+    this->dataPtr->streamedTextures[_type] = baseName;
+    bind(texLocation, false);
+    return;
+  }
+
+  // textures that need to be compressed are decoded by the streamer,
+  // everything else, including DDS and KTX files, is loaded by ogre
+  if (!streamer->Load(_texture, mapType, texLocation))
+  {
+    Ogre::HlmsTextureManager *hlmsTextureManager =
+        this->ogreHlmsPbs->getHlmsManager()->getTextureManager();
+    texLocation = hlmsTextureManager->createOrRetrieveTexture(baseName,
+        mapType);
   }
+  bind(texLocation, true);
 }
 
 //////////////////////////////////////////////////
@@ -588,6 +728,15 @@ void Ogre2Material::Init()
     return;
   }
   this->ogreDatablockId = this->Scene()->Name() + "::" + this->name;
+
+  const Ogre2Material *source = Ogre2MaterialPrivate::cloneSource;
+  if (source)
+  {
+    Ogre2MaterialPrivate::cloneSource = nullptr;
+    this->ShareDatablock(*source);
+    return;
+  }
+
   this->ogreDatablock = static_cast<Ogre::HlmsPbsDatablock *>(
       this->ogreHlmsPbs->createDatablock(
       this->ogreDatablockId, this->name,
@@ -599,6 +748,96 @@ void Ogre2Material::Init()
   this->Reset();
 }
 
+//////////////////////////////////////////////////
+void Ogre2Material::ShareDatablock(const Ogre2Material &_source)
+{
+  const Ogre2Material *owner = _source.dataPtr->datablockOwner ?
+      _source.dataPtr->datablockOwner : &_source;
+  owner->dataPtr->datablockSharers.insert(this);
+  this->dataPtr->datablockOwner = owner;
+  this->ogreDatablock = owner->ogreDatablock;
+
+  // the properties stored in the datablock are shared, copy the others
+  this->ambient = _source.ambient;
+  this->diffuse = _source.diffuse;
+  this->specular = _source.specular;
+  this->emissive = _source.emissive;
+  this->transparency = _source.transparency;
+  this->textureAlphaEnabled = _source.textureAlphaEnabled;
+  this->alphaThreshold = _source.alphaThreshold;
+  this->twoSidedEnabled = _source.twoSidedEnabled;
+  this->renderOrder = _source.renderOrder;
+  this->shininess = _source.shininess;
+  this->reflectivity = _source.reflectivity;
+  this->lightingEnabled = _source.lightingEnabled;
+  this->depthCheckEnabled = _source.depthCheckEnabled;
+  this->depthWriteEnabled = _source.depthWriteEnabled;
+  this->reflectionEnabled = _source.reflectionEnabled;
+  this->receiveShadows = _source.receiveShadows;
+  this->castShadows = _source.castShadows;
+  this->textureName = _source.textureName;
+  this->normalMapName = _source.normalMapName;
+  this->roughnessMapName = _source.roughnessMapName;
+  this->metalnessMapName = _source.metalnessMapName;
+  this->environmentMapName = _source.environmentMapName;
+  this->emissiveMapName = _source.emissiveMapName;
+  this->lightMapName = _source.lightMapName;
+  this->lightMapUvSet = _source.lightMapUvSet;
+
+  // the clone keeps the shared textures from being evicted too
+  this->dataPtr->streamedTextures = _source.dataPtr->streamedTextures;
+  this->dataPtr->textureUsages = _source.dataPtr->textureUsages;
+  if (!this->dataPtr->textureUsages.empty())
+    this->MarkPreRenderDirty();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Material::MakeDatablockUnique()
+{
+  // the clones keep the datablock as it is before it is modified
+  while (!this->dataPtr->datablockSharers.empty())
+    (*this->dataPtr->datablockSharers.begin())->MakeDatablockUnique();
+
+  const Ogre2Material *owner = this->dataPtr->datablockOwner;
+  if (!owner || !this->ogreDatablock)
+    return;
+  owner->dataPtr->datablockSharers.erase(this);
+  this->dataPtr->datablockOwner = nullptr;
+
+  Ogre::HlmsPbsDatablock *shared = this->ogreDatablock;
+  this->ogreDatablock = static_cast<Ogre::HlmsPbsDatablock *>(
+      shared->clone(this->ogreDatablockId));
+
+  // move the renderables bound to this material to the new datablock. The
+  // list is copied since rebinding a renderable removes it from the list.
+  auto renderables = shared->getLinkedRenderables();
+  for (auto renderable : renderables)
+  {
+    const Ogre::Any &id = renderable->getUserObjectBindings().getUserAny(
+        Ogre2MaterialPrivate::kMaterialIdKey);
+    if (!id.isEmpty() && Ogre::any_cast<unsigned int>(id) == this->Id())
+      renderable->setDatablock(this->ogreDatablock);
+  }
+
+  // the textures still streaming are bound to the shared datablock once
+  // uploaded, request them again for the new one
+  const std::map<Ogre::PbsTextureTypes, std::string> maps = {
+      {Ogre::PBSM_DIFFUSE, this->textureName},
+      {Ogre::PBSM_NORMAL, this->normalMapName},
+      {Ogre::PBSM_ROUGHNESS, this->roughnessMapName},
+      {Ogre::PBSM_METALLIC, this->metalnessMapName},
+      {Ogre::PBSM_REFLECTION, this->environmentMapName},
+      {Ogre::PBSM_EMISSIVE, this->emissiveMapName},
+      {Ogre::PBSM_DETAIL0, this->lightMapName}};
+  auto streamed = this->dataPtr->streamedTextures;
+  for (const auto &texture : streamed)
+  {
+    auto it = maps.find(texture.first);
+    if (it != maps.end() && !it->second.empty())
+      this->SetTextureMapImpl(it->second, texture.first);
+  }
+}
+
 //////////////////////////////////////////////////
 enum MaterialType Ogre2Material::Type() const
 {
@@ -615,6 +854,7 @@ bool Ogre2Material::DepthCheckEnabled() const
 //////////////////////////////////////////////////
 void Ogre2Material::SetDepthCheckEnabled(bool _enabled)
 {
+  this->MakeDatablockUnique();
   Ogre::HlmsMacroblock macroblock(
       *this->ogreDatablock->getMacroblock());
   macroblock.mDepthCheck = _enabled;
@@ -631,6 +871,7 @@ bool Ogre2Material::DepthWriteEnabled() const
 //////////////////////////////////////////////////
 void Ogre2Material::SetDepthWriteEnabled(bool _enabled)
 {
+  this->MakeDatablockUnique();
   Ogre::HlmsMacroblock macroblock(
       *this->ogreDatablock->getMacroblock());
   macroblock.mDepthWrite = _enabled;
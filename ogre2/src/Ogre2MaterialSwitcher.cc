@@ -80,27 +80,53 @@ void Ogre2MaterialSwitcher::preRenderTargetUpdate(
   // swap item to use v1 shader material
   // Note: keep an eye out for performance impact on switching materials
   // on the fly. We are not doing this often so should be ok.
-  this->datablockMap.clear();
+  this->datablocks.clear();
+  ++this->traversal;
+  size_t itemCount = 0u;
   auto itor = this->scene->OgreSceneManager()->getMovableObjectIterator(
       Ogre::ItemFactory::FACTORY_TYPE_NAME);
   while (itor.hasMoreElements())
   {
-    this->NextColor();
-
     Ogre::MovableObject *object = itor.peekNext();
     Ogre::Item *item = static_cast<Ogre::Item *>(object);
 
-    this->colorDict[this->currentColor.AsRGBA()] = item->getName();
+    // only items that are new, or that reuse the address of a destroyed
+    // item, get a new color
+    ItemColor &itemColor = this->itemColors[item];
+    auto entry = this->colorDict.find(itemColor.color);
+    if (entry == this->colorDict.end() ||
+        entry->second.name != item->getName())
+    {
+      if (entry != this->colorDict.end())
+        this->colorDict.erase(entry);
+      do
+      {
+        this->NextColor();
+      } while (this->colorDict.count(this->currentColor.AsRGBA()) > 0u);
+      itemColor.color = this->currentColor.AsRGBA();
+      entry = this->colorDict.emplace(itemColor.color, ColorEntry()).first;
+      entry->second.name = item->getName();
+    }
+    itemColor.traversal = this->traversal;
+    ++itemCount;
+
+    // the visual id is set when the item is attached to a visual
+    Ogre::Any userAny = item->getUserObjectBindings().getUserAny();
+    if (!userAny.isEmpty() && userAny.getType() == typeid(unsigned int))
+      entry->second.visualId = Ogre::any_cast<unsigned int>(userAny);
 
+    ignition::math::Color color;
+    color.SetFromRGBA(itemColor.color);
     for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
     {
       Ogre::SubItem *subItem = item->getSubItem(i);
       Ogre::HlmsDatablock *datablock = subItem->getDatablock();
-      this->datablockMap[subItem] = datablock;
+      this->datablocks.emplace_back(subItem, datablock);
 
+      // the custom parameter is shared with the switchers of other
+      // selection buffers so it is set on every render
       subItem->setCustomParameter(1,
-          Ogre::Vector4(this->currentColor.R(), this->currentColor.G(),
-                        this->currentColor.B(), 1.0));
+          Ogre::Vector4(color.R(), color.G(), color.B(), 1.0));
 
       // check if it's an overlay material by assuming the
       // depth check and depth write properties are off.
@@ -112,6 +138,22 @@ void Ogre2MaterialSwitcher::preRenderTargetUpdate(
     }
     itor.moveNext();
   }
+
+  // forget the items that were destroyed since the last render
+  if (itemCount == this->itemColors.size())
+    return;
+  for (auto it = this->itemColors.begin(); it != this->itemColors.end();)
+  {
+    if (it->second.traversal != this->traversal)
+    {
+      this->colorDict.erase(it->second.color);
+      it = this->itemColors.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
 }
 
 /////////////////////////////////////////////////
@@ -119,21 +161,9 @@ void Ogre2MaterialSwitcher::postRenderTargetUpdate(
     const Ogre::RenderTargetEvent &/*_evt*/)
 {
   // restore item to use hlms material
-  auto itor = this->scene->OgreSceneManager()->getMovableObjectIterator(
-      Ogre::ItemFactory::FACTORY_TYPE_NAME);
-  while (itor.hasMoreElements())
-  {
-    Ogre::MovableObject *object = itor.peekNext();
-    Ogre::Item *item = static_cast<Ogre::Item *>(object);
-    for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
-    {
-      Ogre::SubItem *subItem = item->getSubItem(i);
-      auto it = this->datablockMap.find(subItem);
-      if (it != this->datablockMap.end())
-        subItem->setDatablock(it->second);
-    }
-    itor.moveNext();
-  }
+  for (auto &subItemDatablock : this->datablocks)
+    subItemDatablock.first->setDatablock(subItemDatablock.second);
+  this->datablocks.clear();
 }
 
 /////////////////////////////////////////////////
@@ -143,7 +173,7 @@ std::string Ogre2MaterialSwitcher::EntityName(
   auto iter = this->colorDict.find(_color.AsRGBA());
 
   if (iter != this->colorDict.end())
-    return (*iter).second;
+    return iter->second.name;
   else
     return std::string();
 }
@@ -162,4 +192,5 @@ void Ogre2MaterialSwitcher::Reset()
   this->currentColor = ignition::math::Color(
       0.0, 0.0, 0.0);
   this->colorDict.clear();
+  this->itemColors.clear();
 }
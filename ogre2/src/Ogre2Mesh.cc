@@ -15,6 +15,8 @@
  *
  */
 
+#include <algorithm>
+
 // Note this include is placed in the src file because
 // otherwise ogre produces compile errors
 #ifdef _MSC_VER
@@ -38,6 +40,8 @@
 /// brief Private implementation of the Ogre2Mesh class
 class ignition::rendering::Ogre2MeshPrivate
 {
+  /// \brief Translation of the item from the parent visual
+  public: math::Vector3d offset = math::Vector3d::Zero;
 };
 
 using namespace ignition;
@@ -131,6 +135,53 @@ void Ogre2Mesh::SetSkeletonLocalTransforms(
   }
 }
 
+//////////////////////////////////////////////////
+std::vector<std::string> Ogre2Mesh::SkeletonBoneNames() const
+{
+  std::vector<std::string> names;
+  if (!this->ogreItem->hasSkeleton())
+    return names;
+
+  auto skel = this->ogreItem->getSkeletonInstance();
+  names.reserve(skel->getNumBones());
+  for (unsigned int i = 0; i < skel->getNumBones(); ++i)
+    names.push_back(skel->getBone(i)->getName());
+  return names;
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2Mesh::SkeletonBoneCount() const
+{
+  if (!this->ogreItem->hasSkeleton())
+    return 0u;
+  return static_cast<unsigned int>(
+      this->ogreItem->getSkeletonInstance()->getNumBones());
+}
+
+//////////////////////////////////////////////////
+void Ogre2Mesh::SetSkeletonBoneTransforms(const math::Matrix4f *_tfs,
+    unsigned int _count)
+{
+  if (!_tfs || !this->ogreItem->hasSkeleton())
+    return;
+
+  auto skel = this->ogreItem->getSkeletonInstance();
+  unsigned int count = std::min(_count,
+      static_cast<unsigned int>(skel->getNumBones()));
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    auto bone = skel->getBone(i);
+    if (!skel->isManualBone(bone))
+      skel->setManualBone(bone, true);
+
+    const math::Matrix4f &tf = _tfs[i];
+    math::Quaternionf rot = tf.Rotation();
+    bone->setPosition(Ogre::Vector3(tf(0, 3), tf(1, 3), tf(2, 3)));
+    bone->setOrientation(Ogre::Quaternion(rot.W(), rot.X(), rot.Y(),
+        rot.Z()));
+  }
+}
+
 //////////////////////////////////////////////////
 std::unordered_map<std::string, float> Ogre2Mesh::SkeletonWeights() const
 {
@@ -140,17 +191,18 @@ std::unordered_map<std::string, float> Ogre2Mesh::SkeletonWeights() const
 
   auto skel = this->ogreItem->getSkeletonInstance();
 
-  auto animations = skel->getAnimations();
+  const auto &animations = skel->getAnimations();
   if (animations.empty())
     return mapWeights;
 
   // todo(anyone) support different bone weight per animation?
   // currently assume all skeletal animations have same bone weights
-  Ogre::SkeletonAnimation &anim = *animations.begin();
+  Ogre::SkeletonAnimation *anim =
+      skel->getAnimation(animations.begin()->getName());
   for (unsigned int i = 0; i < skel->getNumBones(); ++i)
   {
     auto bone = skel->getBone(i);
-    float weight = anim.getBoneWeight(bone->getName());
+    float weight = anim->getBoneWeight(bone->getName());
     mapWeights[bone->getName()] = weight;
   }
 
@@ -223,18 +275,23 @@ void Ogre2Mesh::UpdateSkeletonAnimation(
     return;
   }
 
+  // iterate over the animations without copying them, this runs every frame
+  // for every actor
   Ogre::SkeletonInstance *skel = this->ogreItem->getSkeletonInstance();
-  auto animations = skel->getAnimations();
-  for (auto &anim : animations)
+  const auto &animations = skel->getAnimations();
+  if (animations.empty())
+    return;
+
+  auto seconds =
+      std::chrono::duration_cast<std::chrono::milliseconds>(_time).count() /
+      1000.0;
+  for (const auto &anim : animations)
   {
+    if (!anim.getEnabled())
+      continue;
     Ogre::SkeletonAnimation *sa = skel->getAnimation(anim.getName());
-    if (sa->getEnabled())
-    {
-      auto seconds =
-          std::chrono::duration_cast<std::chrono::milliseconds>(_time).count() /
-          1000.0;
+    if (sa)
       sa->setTime(seconds);
-    }
   }
 }
 
@@ -263,6 +320,18 @@ Ogre::MovableObject *Ogre2Mesh::OgreObject() const
   return this->ogreItem;
 }
 
+//////////////////////////////////////////////////
+math::Vector3d Ogre2Mesh::OgreObjectOffset() const
+{
+  return this->dataPtr->offset;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Mesh::SetOgreObjectOffset(const math::Vector3d &_offset)
+{
+  this->dataPtr->offset = _offset;
+}
+
 //////////////////////////////////////////////////
 SubMeshStorePtr Ogre2Mesh::SubMeshes() const
 {
@@ -300,8 +369,7 @@ void Ogre2SubMesh::SetMaterialImpl(MaterialPtr _material)
     return;
   }
 
-  this->ogreSubItem->setDatablock(
-      static_cast<Ogre::HlmsPbsDatablock *>(derived->Datablock()));
+  derived->BindDatablock(this->ogreSubItem);
 
   // set cast shadows
   this->ogreSubItem->getParent()->setCastShadows(_material->CastShadows());
@@ -15,8 +15,21 @@
  *
  */
 
-
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <ignition/common/Console.hh>
 #include <ignition/common/Material.hh>
@@ -24,10 +37,19 @@
 #include <ignition/common/Skeleton.hh>
 #include <ignition/common/SkeletonAnimation.hh>
 #include <ignition/common/SubMesh.hh>
+#include <ignition/common/Util.hh>
 
+#include <ignition/math/Helpers.hh>
 #include <ignition/math/Matrix4.hh>
+#include <ignition/math/Vector2.hh>
+#include <ignition/math/Vector3.hh>
 
+#include "ignition/rendering/MemoryTracker.hh"
+#include "ignition/rendering/MeshOptimizer.hh"
+#include "ignition/rendering/MeshSimplifier.hh"
+#include "ignition/rendering/ObjectPool.hh"
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
+#include "ignition/rendering/ogre2/Ogre2Material.hh"
 #include "ignition/rendering/ogre2/Ogre2Mesh.hh"
 #include "ignition/rendering/ogre2/Ogre2MeshFactory.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
@@ -38,36 +60,382 @@
 #ifdef _MSC_VER
   #pragma warning(push, 0)
 #endif
+#include <Compositor/OgreCompositorManager2.h>
+#include <Compositor/OgreCompositorNodeDef.h>
+#include <Compositor/OgreCompositorWorkspace.h>
+#include <Compositor/OgreCompositorWorkspaceDef.h>
+#include <Compositor/OgreCompositorWorkspaceListener.h>
+#include <Compositor/Pass/PassClear/OgreCompositorPassClearDef.h>
+#include <Compositor/Pass/PassScene/OgreCompositorPassScene.h>
+#include <Compositor/Pass/PassScene/OgreCompositorPassSceneDef.h>
+#include <OgreBitwise.h>
+#include <OgreCamera.h>
 #include <OgreHardwareBufferManager.h>
+#include <OgreHardwarePixelBuffer.h>
 #include <OgreItem.h>
 #include <OgreKeyFrame.h>
+#include <OgreLodStrategy.h>
+#include <OgreLodStrategyManager.h>
 #include <OgreMesh2.h>
+#include <OgreMesh2Serializer.h>
 #include <OgreMeshManager.h>
 #include <OgreMeshManager2.h>
+#include <OgreMaterialManager.h>
 #include <OgreOldBone.h>
 #include <OgreOldSkeletonManager.h>
+#include <OgrePass.h>
+#include <OgreRenderSystem.h>
+#include <OgreRenderTexture.h>
 #include <OgreSceneManager.h>
 #include <OgreSkeleton.h>
 #include <OgreSubItem.h>
 #include <OgreSubMesh.h>
 #include <OgreSubMesh2.h>
+#include <OgreTechnique.h>
+#include <OgreTextureManager.h>
+#include <OgreTextureUnitState.h>
+#include <Vao/OgreIndexBufferPacked.h>
+#include <Vao/OgreVaoManager.h>
+#include <Vao/OgreVertexArrayObject.h>
 #ifdef _MSC_VER
   #pragma warning(pop)
 #endif
 
+/// \brief Geometry of a submesh converted to the layout of the ogre vertex
+/// and index buffers
+struct Ogre2SubMeshData
+{
+  /// \brief Constructor
+  /// \param[in] _subMesh Submesh to copy
+  explicit Ogre2SubMeshData(const ignition::common::SubMesh &_subMesh)
+    : subMesh(_subMesh) {}
+
+  /// \brief Copy of the original submesh, recentered if requested
+  ignition::common::SubMesh subMesh;
+
+  /// \brief Interleaved positions, normals and texture coordinates, for
+  /// the v1 vertex buffer
+  std::vector<float> vertices;
+
+  /// \brief Interleaved float positions and half float normals and texture
+  /// coordinates, for the v2 vertex buffer
+  std::vector<uint8_t> packedVertices;
+
+  /// \brief Number of texture coordinate sets in the packed vertices
+  unsigned int packedTexCoordSets = 0u;
+
+  /// \brief True if the packed normals are 8 bit signed normalized
+  /// integers instead of half floats
+  bool packedByteNormals = false;
+
+  /// \brief 32 bit indices
+  std::vector<uint32_t> indices;
+
+  /// \brief 16 bit indices, used instead of the 32 bit ones by the v2
+  /// index buffer when all vertices can be addressed with them
+  std::vector<uint16_t> indices16;
+
+  /// \brief 32 bit indices of each level of detail after the full detail
+  /// one, referencing the same vertices
+  std::vector<std::vector<uint32_t>> lodIndices;
+};
+
+/// \brief Geometry of a mesh prepared for upload to ogre buffers
+struct Ogre2MeshData
+{
+  /// \brief True if the geometry is packed for v2 buffers, false if it
+  /// is laid out for v1 buffers that are imported into a v2 mesh
+  bool direct = false;
+
+  /// \brief Geometry of the submeshes to load
+  std::vector<std::unique_ptr<Ogre2SubMeshData>> subMeshes;
+
+  /// \brief Minimum corner of the mesh bounding box
+  ignition::math::Vector3d min;
+
+  /// \brief Maximum corner of the mesh bounding box
+  ignition::math::Vector3d max;
+};
+
+/// \brief A mesh whose geometry is being prepared in a worker thread
+struct Ogre2MeshLoadTask
+{
+  /// \brief Future set once the geometry is prepared
+  std::shared_future<bool> future;
+
+  /// \brief Geometry, only valid once the future is ready
+  std::shared_ptr<Ogre2MeshData> data;
+};
+
 /// \brief Private data for the Ogre2MeshFactory class
 class ignition::rendering::Ogre2MeshFactoryPrivate
 {
+  /// \brief Copy the submeshes of a mesh and convert their geometry to the
+  /// layout of the ogre buffers. This does not use ogre so it can run in
+  /// a worker thread.
+  /// \param[in] _desc Validated mesh descriptor
+  /// \param[in] _optimize True to optimize the geometry of meshes loaded
+  /// directly into v2 buffers
+  /// \param[out] _data Prepared geometry
+  public: static void PrepareMeshData(const MeshDescriptor &_desc,
+      bool _optimize, Ogre2MeshData &_data);
+
+  /// \brief Pack the geometry of a submesh for v2 vertex and index buffers
+  /// \param[in] _texCoordSets Texture coordinate sets to pack
+  /// \param[in] _byteNormals True to pack normals as 8 bit signed
+  /// normalized integers instead of half floats
+  /// \param[in,out] _subMeshData Submesh to pack
+  public: static void PackSubMesh(
+      const std::vector<unsigned int> &_texCoordSets, bool _byteNormals,
+      Ogre2SubMeshData &_subMeshData);
+
+  /// \brief Create a v2 mesh directly from geometry packed by
+  /// PrepareMeshData, without creating a v1 mesh first
+  /// \param[in] _name Name of the mesh
+  /// \param[in] _desc Mesh descriptor
+  /// \param[in] _data Packed geometry
+  /// \param[in] _scene Scene to create the materials in
+  /// \return True if the mesh was created
+  public: static bool CreateMesh(const std::string &_name,
+      const MeshDescriptor &_desc, const Ogre2MeshData &_data,
+      Ogre2ScenePtr _scene);
+
+  /// \brief Add the levels of detail prepared by PrepareMeshData to a v1
+  /// mesh. Levels are switched when the bounding sphere of the mesh covers
+  /// half as much of the screen height as for the previous level, for a
+  /// camera with a 60 degree vertical field of view and a level of detail
+  /// bias of 1.
+  /// \param[in] _ogreMesh Mesh with one submesh per prepared submesh
+  /// \param[in] _data Prepared geometry
+  public: static void CreateLodLevels(Ogre::v1::Mesh *_ogreMesh,
+      const Ogre2MeshData &_data);
+
+  /// \brief Add an impostor to a v1 mesh as the level of detail after the
+  /// levels added by CreateLodLevels. A submesh holding a camera facing quad
+  /// is only drawn at that level, while the other submeshes draw nothing.
+  /// The quad samples an atlas of views of the mesh rendered by
+  /// BakeImpostor.
+  /// \param[in] _ogreMesh Mesh with one submesh per prepared submesh and
+  /// its levels of detail
+  /// \param[in] _data Prepared geometry
+  /// \param[in] _distance Distance beyond which the impostor is drawn
+  /// \param[in] _name Name of the mesh
+  public: static void CreateImpostor(Ogre::v1::Mesh *_ogreMesh,
+      const Ogre2MeshData &_data, double _distance, const std::string &_name);
+
+  /// \brief Render the views of the impostor atlas of a mesh, once per
+  /// mesh. The views only show the mesh under a white ambient light.
+  /// \param[in] _item Item of the mesh, with the materials of its submeshes
+  /// \param[in] _scene Scene to render the views in
+  public: static void BakeImpostor(Ogre::Item *_item, Ogre2ScenePtr _scene);
+
+  /// \brief Check whether a sub item draws the impostor of its mesh
+  /// \param[in] _subItem Sub item
+  /// \return True if the sub item is an impostor
+  public: static bool IsImpostor(const Ogre::SubItem *_subItem);
+
+  /// \brief Check whether a descriptor that centers its submesh shares
+  /// the geometry of the original submesh, the item being centered with
+  /// an offset instead. A single offset can only center a mesh with one
+  /// submesh, and skinned meshes are deformed in the frame of their
+  /// skeleton so they keep their own centered geometry.
+  /// \param[in] _desc Loaded mesh descriptor
+  /// \return True if the submesh is centered with an offset
+  public: static bool CenterByOffset(const MeshDescriptor &_desc);
+
+  /// \brief Get the translation that centers the submesh of a descriptor
+  /// \param[in] _desc Loaded mesh descriptor
+  /// \return Offset moving the center of the submesh to the origin
+  public: static math::Vector3d CenterOffset(const MeshDescriptor &_desc);
+
+  /// \brief Get the ogre operation type of a submesh
+  /// \param[in] _subMesh Submesh
+  /// \return Ogre operation type
+  public: static Ogre::OperationType OperationType(
+      const common::SubMesh &_subMesh);
+
+  /// \brief Create the material of a submesh
+  /// \param[in] _desc Mesh descriptor
+  /// \param[in] _subMesh Submesh
+  /// \param[in] _scene Scene to create the material in
+  /// \return Name of the created material
+  public: static std::string MaterialName(const MeshDescriptor &_desc,
+      const common::SubMesh &_subMesh, Ogre2ScenePtr _scene);
+
+  /// \brief Get the path of the cache file of a mesh. The file name is a
+  /// hash of the mesh file content and of the descriptor options that
+  /// change the converted geometry.
+  /// \param[in] _desc Validated mesh descriptor
+  /// \return Path of the cache file, empty if the mesh was not loaded from
+  /// a file
+  public: std::string CacheFile(const MeshDescriptor &_desc) const;
+
+  /// \brief Load a converted mesh from the cache
+  /// \param[in] _name Name of the mesh
+  /// \param[in] _file Path of the cache file
+  /// \param[in] _desc Mesh descriptor
+  /// \param[in] _scene Scene to create the materials in
+  /// \return True if the mesh was loaded
+  public: static bool LoadCachedMesh(const std::string &_name,
+      const std::string &_file, const MeshDescriptor &_desc,
+      Ogre2ScenePtr _scene);
+
+  /// \brief Store a converted mesh in the cache
+  /// \param[in] _name Name of the mesh
+  /// \param[in] _file Path of the cache file
+  /// \param[in] _scene Scene the mesh was created in
+  public: static void SaveCachedMesh(const std::string &_name,
+      const std::string &_file, Ogre2ScenePtr _scene);
+
+  /// \brief True to store converted meshes on disk
+  public: bool cacheEnabled = false;
+
+  /// \brief True to share materials across copies of a mesh
+  public: bool instancing = false;
+
+  /// \brief True to optimize the geometry of loaded meshes
+  public: bool optimize = false;
+
+  /// \brief True to remove v1 meshes once they are imported into v2
+  public: bool releaseV1Meshes = false;
+
+  /// \brief Directory of the mesh cache
+  public: std::string cacheDir;
+
+  /// \brief Bounding volume hierarchies of meshes, indexed by mesh name
+  public: std::map<std::string, std::shared_ptr<const MeshBvh>> bvhs;
+
+  /// \brief Meshes being prepared in worker threads, indexed by mesh name
+  public: std::map<std::string, Ogre2MeshLoadTask> loadTasks;
+
+  /// \brief Materials of this scene replacing the materials of the meshes
+  /// created by other scenes, indexed by the name of the replaced material
+  public: std::map<std::string, std::string> sceneMaterials;
+
+  /// \brief Number of mesh factories using each ogre mesh, indexed by mesh
+  /// name. Ogre meshes are shared by the scenes of the engine and removed
+  /// when the last scene using them is cleared.
+  public: static std::map<std::string, unsigned int> meshUsers;
+
+  /// \brief Bounding volume hierarchies built by all the scenes, indexed
+  /// by mesh name. They are immutable and kept alive by the factories
+  /// using them.
+  public: static std::map<std::string, std::weak_ptr<const MeshBvh>>
+      sharedBvhs;
+
+  /// \brief Mutex protecting sharedBvhs
+  public: static std::mutex sharedBvhsMutex;
+
+  /// \brief Meshes being prepared in worker threads for any scene, indexed
+  /// by mesh name, so that scenes loading the same mesh prepare it once
+  public: static std::map<std::string, Ogre2MeshLoadTask> sharedLoadTasks;
+
+  /// \brief Names of the meshes whose impostor atlas has been rendered
+  public: static std::set<std::string> bakedImpostors;
 };
 
+std::map<std::string, unsigned int> Ogre2MeshFactoryPrivate::meshUsers;
+std::map<std::string, std::weak_ptr<const MeshBvh>>
+    Ogre2MeshFactoryPrivate::sharedBvhs;
+std::mutex Ogre2MeshFactoryPrivate::sharedBvhsMutex;
+std::map<std::string, Ogre2MeshLoadTask>
+    Ogre2MeshFactoryPrivate::sharedLoadTasks;
+std::set<std::string> Ogre2MeshFactoryPrivate::bakedImpostors;
+
+/// \brief Number of views along each side of an impostor atlas
+static const unsigned int kImpostorGridSize = 8u;
+
+/// \brief Size in pixels of a view of an impostor atlas
+static const unsigned int kImpostorViewSize = 64u;
+
+/// \brief Visibility flags of the items rendered into impostor atlases,
+/// outside of IGN_VISIBILITY_ALL so that no other item is rendered
+static const uint32_t kImpostorBakeVisibilityFlags = 0x20000000u;
+
+/// \brief Suffix of the names of the impostor material of a mesh
+static const char kImpostorMaterialSuffix[] = "::Impostor";
+
+/// \brief Suffix of the names of the impostor atlas of a mesh
+static const char kImpostorAtlasSuffix[] = "::ImpostorAtlas";
+
 /// \brief Private data for the Ogre2SubMeshStoreFactory class
 class ignition::rendering::Ogre2SubMeshStoreFactoryPrivate
 {
+  /// \brief True to share the materials of the ogre submeshes
+  public: bool materialsShared = false;
+
+  /// \brief Materials of the submeshes, used instead of the materials of
+  /// the ogre submeshes when not empty
+  public: std::vector<std::string> materialNames;
 };
 
 using namespace ignition;
 using namespace rendering;
 
+//////////////////////////////////////////////////
+/// \brief Account the vertex and index buffers of a mesh uploaded to the
+/// GPU to the memory tracker. Buffers shared by several vaos, e.g. the
+/// normal and shadow vaos, are counted once.
+/// \param[in] _mesh Ogre mesh
+static void trackMeshMemory(const Ogre::Mesh *_mesh)
+{
+  std::set<const void *> buffers;
+  size_t bytes = 0u;
+  auto addBuffer = [&buffers, &bytes](const Ogre::BufferPacked *_buffer)
+  {
+    if (_buffer && buffers.insert(_buffer).second)
+      bytes += _buffer->getTotalSizeBytes();
+  };
+
+  for (unsigned int i = 0; i < _mesh->getNumSubMeshes(); ++i)
+  {
+    const Ogre::SubMesh *subMesh = _mesh->getSubMesh(i);
+    for (auto vaos : {&subMesh->mVao[Ogre::VpNormal],
+        &subMesh->mVao[Ogre::VpShadow]})
+    {
+      for (const Ogre::VertexArrayObject *vao : *vaos)
+      {
+        for (const Ogre::VertexBufferPacked *buffer : vao->getVertexBuffers())
+          addBuffer(buffer);
+        addBuffer(vao->getIndexBuffer());
+      }
+    }
+  }
+  MemoryTracker::Track(MC_MESH, _mesh, bytes);
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the number of sub items of an item that draw submeshes of
+/// the loaded mesh. The impostor, if any, is the last sub item.
+/// \param[in] _item Ogre item
+/// \return Number of sub items without the impostor
+static unsigned int meshSubItemCount(const Ogre::Item *_item)
+{
+  unsigned int count = static_cast<unsigned int>(_item->getNumSubItems());
+  if (count > 0u && Ogre2MeshFactoryPrivate::IsImpostor(
+      _item->getSubItem(count - 1u)))
+  {
+    --count;
+  }
+  return count;
+}
+
+//////////////////////////////////////////////////
+/// \brief Workspace listener turning off the lights in the scene passes
+/// rendering impostor atlases, the views only showing the ambient light
+class Ogre2ImpostorBakeListener : public Ogre::CompositorWorkspaceListener
+{
+  // Documentation inherited
+  public: virtual void passPreExecute(Ogre::CompositorPass *_pass) override
+  {
+    if (_pass->getType() != Ogre::PASS_SCENE)
+      return;
+    Ogre::Viewport *vp =
+        static_cast<Ogre::CompositorPassScene *>(_pass)->getViewport();
+    vp->_setVisibilityMask(vp->getVisibilityMask(), 0u);
+  }
+};
+
 //////////////////////////////////////////////////
 Ogre2MeshFactory::Ogre2MeshFactory(Ogre2ScenePtr _scene) :
   scene(_scene), dataPtr(std::make_unique<Ogre2MeshFactoryPrivate>())
@@ -82,17 +450,185 @@ Ogre2MeshFactory::~Ogre2MeshFactory()
 //////////////////////////////////////////////////
 void Ogre2MeshFactory::Clear()
 {
+  // other scenes may still use the meshes
   for (auto &m : this->ogreMeshes)
+  {
+    auto it = Ogre2MeshFactoryPrivate::meshUsers.find(m);
+    if (it != Ogre2MeshFactoryPrivate::meshUsers.end() && --it->second > 0u)
+      continue;
+    if (it != Ogre2MeshFactoryPrivate::meshUsers.end())
+      Ogre2MeshFactoryPrivate::meshUsers.erase(it);
+    Ogre::MeshPtr ogreMesh = Ogre::MeshManager::getSingleton().getByName(m);
+    if (!ogreMesh.isNull())
+      MemoryTracker::Untrack(ogreMesh.get());
     Ogre::MeshManager::getSingleton().remove(m);
 
+    // the v1 mesh, if still registered, would prevent loading the mesh
+    // again under the same name
+    Ogre::v1::MeshManager::getSingleton().remove(m);
+
+    // impostor atlas and material, if any
+    Ogre2MeshFactoryPrivate::bakedImpostors.erase(m);
+    if (Ogre::TextureManager::getSingleton().resourceExists(
+        m + kImpostorAtlasSuffix))
+    {
+      Ogre::MaterialManager::getSingleton().remove(
+          m + kImpostorMaterialSuffix);
+      Ogre::TextureManager::getSingleton().remove(m + kImpostorAtlasSuffix);
+    }
+  }
+
   this->ogreMeshes.clear();
+  this->dataPtr->sceneMaterials.clear();
+  this->dataPtr->bvhs.clear();
+
+  // wait for the worker threads before dropping their results
+  for (auto &task : this->dataPtr->loadTasks)
+  {
+    task.second.future.wait();
+    Ogre2MeshFactoryPrivate::sharedLoadTasks.erase(task.first);
+  }
+  this->dataPtr->loadTasks.clear();
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshFactory::SetCacheEnabled(bool _enabled)
+{
+  this->dataPtr->cacheEnabled = _enabled;
+  if (_enabled && this->dataPtr->cacheDir.empty())
+  {
+    std::string home;
+    ignition::common::env(IGN_HOMEDIR, home);
+    this->dataPtr->cacheDir = common::joinPaths(home, ".ignition",
+        "rendering", "ogre2_mesh_cache");
+  }
+}
+
+//////////////////////////////////////////////////
+bool Ogre2MeshFactory::CacheEnabled() const
+{
+  return this->dataPtr->cacheEnabled;
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshFactory::SetInstancingEnabled(bool _enabled)
+{
+  this->dataPtr->instancing = _enabled;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2MeshFactory::InstancingEnabled() const
+{
+  return this->dataPtr->instancing;
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshFactory::SetOptimizationEnabled(bool _enabled)
+{
+  this->dataPtr->optimize = _enabled;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2MeshFactory::OptimizationEnabled() const
+{
+  return this->dataPtr->optimize;
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshFactory::SetV1MeshReleaseEnabled(bool _enabled)
+{
+  this->dataPtr->releaseV1Meshes = _enabled;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2MeshFactory::V1MeshReleaseEnabled() const
+{
+  return this->dataPtr->releaseV1Meshes;
+}
+
+//////////////////////////////////////////////////
+std::shared_future<bool> Ogre2MeshFactory::LoadAsync(
+    const MeshDescriptor &_desc)
+{
+  MeshDescriptor normDesc = _desc;
+  normDesc.Load();
+
+  std::promise<bool> done;
+  if (!this->Validate(normDesc))
+  {
+    done.set_value(false);
+    return done.get_future().share();
+  }
+
+  if (this->IsLoaded(normDesc))
+  {
+    done.set_value(true);
+    return done.get_future().share();
+  }
+
+  std::string name = this->MeshName(normDesc);
+  auto it = this->dataPtr->loadTasks.find(name);
+  if (it != this->dataPtr->loadTasks.end())
+    return it->second.future;
+
+  // another scene may already be preparing the same mesh
+  auto shared = Ogre2MeshFactoryPrivate::sharedLoadTasks.find(name);
+  if (shared != Ogre2MeshFactoryPrivate::sharedLoadTasks.end())
+  {
+    this->dataPtr->loadTasks[name] = shared->second;
+    return shared->second.future;
+  }
+
+  Ogre2MeshLoadTask task;
+  task.data = std::make_shared<Ogre2MeshData>();
+  auto data = task.data;
+  bool optimize = this->dataPtr->optimize;
+  task.future = std::async(std::launch::async, [normDesc, optimize, data]()
+  {
+    Ogre2MeshFactoryPrivate::PrepareMeshData(normDesc, optimize, *data);
+    return true;
+  }).share();
+  this->dataPtr->loadTasks[name] = task;
+  Ogre2MeshFactoryPrivate::sharedLoadTasks[name] = task;
+  return task.future;
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<const MeshBvh> Ogre2MeshFactory::Bvh(
+    const std::string &_meshName)
+{
+  auto it = this->dataPtr->bvhs.find(_meshName);
+  if (it != this->dataPtr->bvhs.end())
+    return it->second;
+
+  // reuse the hierarchy built by another scene
+  std::lock_guard<std::mutex> lock(Ogre2MeshFactoryPrivate::sharedBvhsMutex);
+  std::shared_ptr<const MeshBvh> bvh =
+      Ogre2MeshFactoryPrivate::sharedBvhs[_meshName].lock();
+  if (!bvh)
+  {
+    const common::Mesh *mesh =
+        common::MeshManager::Instance()->MeshByName(_meshName);
+    if (!mesh)
+    {
+      Ogre2MeshFactoryPrivate::sharedBvhs.erase(_meshName);
+      return nullptr;
+    }
+
+    bvh = std::make_shared<const MeshBvh>(*mesh);
+    Ogre2MeshFactoryPrivate::sharedBvhs[_meshName] = bvh;
+  }
+
+  this->dataPtr->bvhs[_meshName] = bvh;
+  return bvh;
 }
 
 //////////////////////////////////////////////////
 Ogre2MeshPtr Ogre2MeshFactory::Create(const MeshDescriptor &_desc)
 {
   // create ogre entity
-  Ogre2MeshPtr mesh(new Ogre2Mesh);
+  Ogre2MeshPtr mesh = SharePooled(
+      new (AllocatePooled<Ogre2Mesh>()) Ogre2Mesh);
   MeshDescriptor normDesc = _desc;
   normDesc.Load();
   mesh->ogreItem = this->OgreItem(normDesc);
@@ -107,10 +643,104 @@ Ogre2MeshPtr Ogre2MeshFactory::Create(const MeshDescriptor &_desc)
 
   // create sub-mesh store
   Ogre2SubMeshStoreFactory subMeshFactory(this->scene, mesh->ogreItem);
+  subMeshFactory.SetMaterialsShared(this->dataPtr->instancing);
+  subMeshFactory.SetMaterialNames(this->SceneMaterialNames(normDesc,
+      mesh->ogreItem));
+  mesh->subMeshes = subMeshFactory.Create();
+
+  // the impostor shows the materials the mesh is first created with
+  if (meshSubItemCount(mesh->ogreItem) < mesh->ogreItem->getNumSubItems())
+    Ogre2MeshFactoryPrivate::BakeImpostor(mesh->ogreItem, this->scene);
+
+  // the ogre mesh holds the original geometry of centered submeshes
+  if (Ogre2MeshFactoryPrivate::CenterByOffset(normDesc))
+    mesh->SetOgreObjectOffset(Ogre2MeshFactoryPrivate::CenterOffset(normDesc));
+  return mesh;
+}
+
+//////////////////////////////////////////////////
+Ogre2MeshPtr Ogre2MeshFactory::Clone(const Ogre2Mesh &_mesh)
+{
+  if (!_mesh.ogreItem)
+  {
+    ignerr << "Failed to clone mesh [" << _mesh.Name() << "], it has no "
+           << "Ogre item" << std::endl;
+    return nullptr;
+  }
+
+  // the ogre mesh is already loaded and used by this scene
+  Ogre::SceneManager *sceneManager = this->scene->OgreSceneManager();
+  Ogre2MeshPtr mesh = SharePooled(
+      new (AllocatePooled<Ogre2Mesh>()) Ogre2Mesh);
+  mesh->ogreItem = sceneManager->createItem(_mesh.ogreItem->getMesh(),
+      Ogre::SCENE_DYNAMIC);
+  mesh->SetOgreObjectOffset(_mesh.OgreObjectOffset());
+
+  std::vector<std::string> names;
+  for (unsigned int i = 0; i < _mesh.SubMeshCount(); ++i)
+  {
+    MaterialPtr material = _mesh.SubMeshByIndex(i)->Material();
+    names.push_back(material ? material->Name() : std::string());
+  }
+
+  Ogre2SubMeshStoreFactory subMeshFactory(this->scene, mesh->ogreItem);
+  subMeshFactory.SetMaterialsShared(true);
+  subMeshFactory.SetMaterialNames(names);
   mesh->subMeshes = subMeshFactory.Create();
   return mesh;
 }
 
+//////////////////////////////////////////////////
+std::vector<std::string> Ogre2MeshFactory::SceneMaterialNames(
+    const MeshDescriptor &_desc, Ogre::Item *_item)
+{
+  // a mesh created by another scene references the materials of that scene,
+  // give its submeshes materials of this scene instead. The ogre submeshes
+  // follow the order of the submeshes loaded from the descriptor.
+  std::vector<std::shared_ptr<common::SubMesh>> subMeshes;
+  for (unsigned int i = 0; i < _desc.mesh->SubMeshCount(); ++i)
+  {
+    auto s = _desc.mesh->SubMeshByIndex(i).lock();
+    if (s && (_desc.subMeshName.empty() || s->Name() == _desc.subMeshName))
+      subMeshes.push_back(s);
+  }
+
+  std::vector<std::string> names;
+  size_t count = meshSubItemCount(_item);
+  for (size_t i = 0; i < count; ++i)
+  {
+    std::string matName = _item->getSubItem(i)->getSubMesh()->getMaterialName();
+    if (this->scene->MaterialRegistered(matName))
+    {
+      names.push_back(matName);
+      continue;
+    }
+
+    auto it = this->dataPtr->sceneMaterials.find(matName);
+    if (it == this->dataPtr->sceneMaterials.end() ||
+        !this->scene->MaterialRegistered(it->second))
+    {
+      std::string name;
+      if (i < subMeshes.size())
+      {
+        name = Ogre2MeshFactoryPrivate::MaterialName(_desc, *subMeshes[i],
+            this->scene);
+      }
+      it = this->dataPtr->sceneMaterials.emplace(matName, name).first;
+      it->second = name;
+    }
+    names.push_back(it->second);
+
+    // do not leave the submesh bound to a datablock of another scene
+    Ogre2MaterialPtr mat = std::dynamic_pointer_cast<Ogre2Material>(
+        this->scene->Material(it->second));
+    if (mat)
+      _item->getSubItem(i)->setDatablock(mat->Datablock());
+  }
+
+  return names;
+}
+
 //////////////////////////////////////////////////
 Ogre::Item *Ogre2MeshFactory::OgreItem(const MeshDescriptor &_desc)
 {
@@ -138,12 +768,33 @@ Ogre::Item *Ogre2MeshFactory::OgreItem(const MeshDescriptor &_desc)
     mesh = Ogre::MeshManager::getSingleton().createManual(
         name, Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
     mesh->importV1(v1Mesh.get(), false, true, true);
-    this->ogreMeshes.push_back(name);
+    trackMeshMemory(mesh.get());
+
+    // the v2 mesh holds its own copy of the geometry and levels of detail.
+    // Skinned meshes keep the v1 mesh their skeleton was created with.
+    if (this->dataPtr->releaseV1Meshes && !v1Mesh->hasSkeleton())
+    {
+      v1Mesh.setNull();
+      Ogre::v1::MeshManager::getSingleton().remove(name);
+    }
   }
+  this->AddMeshUser(name);
 
   return sceneManager->createItem(mesh, Ogre::SCENE_DYNAMIC);
 }
 
+//////////////////////////////////////////////////
+void Ogre2MeshFactory::AddMeshUser(const std::string &_name)
+{
+  if (std::find(this->ogreMeshes.begin(), this->ogreMeshes.end(), _name) !=
+      this->ogreMeshes.end())
+  {
+    return;
+  }
+  this->ogreMeshes.push_back(_name);
+  ++Ogre2MeshFactoryPrivate::meshUsers[_name];
+}
+
 //////////////////////////////////////////////////
 bool Ogre2MeshFactory::Load(const MeshDescriptor &_desc)
 {
@@ -154,6 +805,11 @@ bool Ogre2MeshFactory::Load(const MeshDescriptor &_desc)
 
   if (this->IsLoaded(_desc))
   {
+    // the mesh may have been loaded by another scene, which used the
+    // geometry prepared for this one
+    std::string name = this->MeshName(_desc);
+    this->AddMeshUser(name);
+    this->dataPtr->loadTasks.erase(name);
     return true;
   }
 
@@ -176,9 +832,73 @@ bool Ogre2MeshFactory::LoadImpl(const MeshDescriptor &_desc)
 
   Ogre2RenderEngine::Instance()->AddResourcePath(_desc.mesh->Path());
 
+  name = this->MeshName(_desc);
+
+  // skinned meshes need a v1 skeleton and levels of detail and impostors
+  // are created through the v1 mesh, only other meshes are cached
+  std::string cacheFile;
+  if (this->dataPtr->cacheEnabled && !_desc.mesh->HasSkeleton() &&
+      _desc.lodLevels == 0u && _desc.impostorDistance <= 0.0)
+  {
+    cacheFile = this->dataPtr->CacheFile(_desc);
+    if (!cacheFile.empty() && Ogre2MeshFactoryPrivate::LoadCachedMesh(
+        name, cacheFile, _desc, this->scene))
+    {
+      // the geometry prepared by LoadAsync is not needed
+      auto task = this->dataPtr->loadTasks.find(name);
+      if (task != this->dataPtr->loadTasks.end())
+      {
+        task->second.future.wait();
+        this->dataPtr->loadTasks.erase(task);
+      }
+      Ogre2MeshFactoryPrivate::sharedLoadTasks.erase(name);
+      this->AddMeshUser(name);
+      return true;
+    }
+  }
+
+  // use the geometry prepared by LoadAsync if there is one, for this scene
+  // or another one
+  std::shared_ptr<Ogre2MeshData> meshData;
+  auto task = this->dataPtr->loadTasks.find(name);
+  auto shared = Ogre2MeshFactoryPrivate::sharedLoadTasks.find(name);
+  if (task != this->dataPtr->loadTasks.end())
+  {
+    if (task->second.future.get())
+      meshData = task->second.data;
+    this->dataPtr->loadTasks.erase(task);
+  }
+  else if (shared != Ogre2MeshFactoryPrivate::sharedLoadTasks.end())
+  {
+    if (shared->second.future.get())
+      meshData = shared->second.data;
+  }
+  if (shared != Ogre2MeshFactoryPrivate::sharedLoadTasks.end())
+    Ogre2MeshFactoryPrivate::sharedLoadTasks.erase(shared);
+  if (!meshData)
+  {
+    meshData = std::make_shared<Ogre2MeshData>();
+    Ogre2MeshFactoryPrivate::PrepareMeshData(_desc, this->dataPtr->optimize,
+        *meshData);
+  }
+
+  if (meshData->direct)
+  {
+    if (!Ogre2MeshFactoryPrivate::CreateMesh(name, _desc, *meshData,
+        this->scene))
+    {
+      return false;
+    }
+    if (!cacheFile.empty())
+    {
+      Ogre2MeshFactoryPrivate::SaveCachedMesh(name, cacheFile, this->scene);
+    }
+    this->AddMeshUser(name);
+    return true;
+  }
+
   try
   {
-    name = this->MeshName(_desc);
     group = Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME;
     ogreMesh = Ogre::v1::MeshManager::getSingleton().createManual(name, group);
 
@@ -265,15 +985,9 @@ bool Ogre2MeshFactory::LoadImpl(const MeshDescriptor &_desc)
       ogreMesh->setSkeletonName(_desc.mesh->Name() + "_skeleton");
     }
 
-    for (unsigned int i = 0; i < _desc.mesh->SubMeshCount(); i++)
+    for (const auto &subMeshData : meshData->subMeshes)
     {
-      // if submesh is specified then load only that particular submesh
-      auto s = _desc.mesh->SubMeshByIndex(i).lock();
-      if (!_desc.subMeshName.empty() && s &&
-          s->Name() != _desc.subMeshName)
-      {
-        continue;
-      }
+      const common::SubMesh &subMesh = subMeshData->subMesh;
 
       Ogre::v1::SubMesh *ogreSubMesh;
       Ogre::v1::VertexData *vertexData;
@@ -285,47 +999,10 @@ bool Ogre2MeshFactory::LoadImpl(const MeshDescriptor &_desc)
 
       size_t currOffset = 0;
 
-      // Copy the original submesh. We may need to modify the vertices, and
-      // we don't want to change the original.
-      common::SubMesh subMesh(*s.get());
-
-      // Recenter the vertices if requested.
-      if (_desc.centerSubMesh)
-        subMesh.Center(math::Vector3d::Zero);
-
       ogreSubMesh = ogreMesh->createSubMesh(subMesh.Name());
       ogreSubMesh->useSharedVertices = false;
-      if (subMesh.SubMeshPrimitiveType() == common::SubMesh::TRIANGLES)
-      {
-        ogreSubMesh->operationType =
-            Ogre::OT_TRIANGLE_LIST;
-      }
-      else if (subMesh.SubMeshPrimitiveType() == common::SubMesh::LINES)
-      {
-        ogreSubMesh->operationType = Ogre::OT_LINE_LIST;
-      }
-      else if (subMesh.SubMeshPrimitiveType() == common::SubMesh::LINESTRIPS)
-      {
-        ogreSubMesh->operationType = Ogre::OT_LINE_STRIP;
-      }
-      else if (subMesh.SubMeshPrimitiveType() == common::SubMesh::TRIFANS)
-      {
-        ogreSubMesh->operationType = Ogre::OT_TRIANGLE_FAN;
-      }
-      else if (subMesh.SubMeshPrimitiveType() == common::SubMesh::TRISTRIPS)
-      {
-        ogreSubMesh->operationType =
-            Ogre::OT_TRIANGLE_STRIP;
-      }
-      else if (subMesh.SubMeshPrimitiveType() == common::SubMesh::POINTS)
-      {
-        ogreSubMesh->operationType = Ogre::OT_POINT_LIST;
-      }
-      else
-      {
-        ignerr << "Unknown primitive type["
-              << subMesh.SubMeshPrimitiveType() << "]\n";
-      }
+      ogreSubMesh->operationType =
+          Ogre2MeshFactoryPrivate::OperationType(subMesh);
 
       ogreSubMesh->vertexData[Ogre::VpNormal] = new Ogre::v1::VertexData();
       vertexData = ogreSubMesh->vertexData[Ogre::VpNormal];
@@ -391,31 +1068,10 @@ bool Ogre2MeshFactory::LoadImpl(const MeshDescriptor &_desc)
         }
       }
 
-      // Add all the vertices
-      for (unsigned int j = 0; j < subMesh.VertexCount(); ++j)
-      {
-        *vertices++ = subMesh.Vertex(j).X();
-        *vertices++ = subMesh.Vertex(j).Y();
-        *vertices++ = subMesh.Vertex(j).Z();
-
-        // Add all normals
-        if (subMesh.NormalCount() > 0)
-        {
-          *vertices++ = subMesh.Normal(j).X();
-          *vertices++ = subMesh.Normal(j).Y();
-          *vertices++ = subMesh.Normal(j).Z();
-        }
-
-        // Add all texture coordinate sets
-        for (unsigned int k = 0u; k < subMesh.TexCoordSetCount(); ++k)
-        {
-          if (subMesh.TexCoordCountBySet(k) > 0u)
-          {
-            *vertices++ = subMesh.TexCoordBySet(j, k).X();
-            *vertices++ = subMesh.TexCoordBySet(j, k).Y();
-          }
-        }
-      }
+      // Add all the vertices, already interleaved in the layout of the
+      // vertex declaration
+      std::memcpy(vertices, subMeshData->vertices.data(),
+          subMeshData->vertices.size() * sizeof(float));
 
       vBuf->unlock();
 
@@ -434,31 +1090,17 @@ bool Ogre2MeshFactory::LoadImpl(const MeshDescriptor &_desc)
       indices = static_cast<uint32_t*>(
           iBuf->lock(Ogre::v1::HardwareBuffer::HBL_DISCARD));
 
-
-      for (unsigned int j = 0; j < subMesh.IndexCount(); ++j)
-        *indices++ = static_cast<uint32_t>(subMesh.Index(j));
+      std::memcpy(indices, subMeshData->indices.data(),
+          subMeshData->indices.size() * sizeof(uint32_t));
 
       iBuf->unlock();
 
-      common::MaterialPtr material;
-      material = _desc.mesh->MaterialByIndex(subMesh.MaterialIndex());
-
-      MaterialPtr mat = this->scene->CreateMaterial();
-      if (material)
-      {
-        mat->CopyFrom(*material);
-      }
-      else
-      {
-        MaterialPtr defaultMat = this->scene->Material("Default/White");
-        if (defaultMat != nullptr)
-          mat->CopyFrom(defaultMat);
-      }
-      ogreSubMesh->setMaterialName(mat->Name());
+      ogreSubMesh->setMaterialName(Ogre2MeshFactoryPrivate::MaterialName(
+          _desc, subMesh, this->scene));
     }
 
-    math::Vector3d max = _desc.mesh->Max();
-    math::Vector3d min = _desc.mesh->Min();
+    math::Vector3d max = meshData->max;
+    math::Vector3d min = meshData->min;
 
     if (_desc.mesh->HasSkeleton())
     {
@@ -478,6 +1120,24 @@ bool Ogre2MeshFactory::LoadImpl(const MeshDescriptor &_desc)
       return false;
     }
 
+    if (_desc.lodLevels > 0u)
+      Ogre2MeshFactoryPrivate::CreateLodLevels(ogreMesh.get(), *meshData);
+
+    // skinned meshes change shape, a view rendered once would not match
+    if (_desc.impostorDistance > 0.0)
+    {
+      if (_desc.mesh->HasSkeleton())
+      {
+        ignwarn << "Impostors of skinned mesh [" << _desc.meshName
+                << "] are not supported" << std::endl;
+      }
+      else
+      {
+        Ogre2MeshFactoryPrivate::CreateImpostor(ogreMesh.get(), *meshData,
+            _desc.impostorDistance, name);
+      }
+    }
+
     if (!ogreMesh->hasValidShadowMappingBuffers())
       ogreMesh->prepareForShadowMapping(false);
 
@@ -500,13 +1160,874 @@ bool Ogre2MeshFactory::LoadImpl(const MeshDescriptor &_desc)
   return true;
 }
 
+//////////////////////////////////////////////////
+void Ogre2MeshFactoryPrivate::CreateLodLevels(Ogre::v1::Mesh *_ogreMesh,
+    const Ogre2MeshData &_data)
+{
+  if (_data.subMeshes.empty())
+    return;
+
+  size_t levels = _data.subMeshes.front()->lodIndices.size();
+  if (levels == 0u)
+    return;
+
+  _ogreMesh->_setLodInfo(static_cast<unsigned short>(levels + 1u));
+
+  // distance at which the bounding sphere covers the given share of the
+  // screen height
+  Ogre::LodStrategy *strategy =
+      Ogre::LodStrategyManager::getSingleton().getDefaultStrategy();
+  double radius = (_data.max - _data.min).Length() * 0.5;
+  double tanHalfFov = std::tan(IGN_PI / 6.0);
+  double screenRatio = 1.0;
+  for (size_t level = 1u; level <= levels; ++level)
+  {
+    screenRatio *= 0.5;
+    Ogre::v1::MeshLodUsage usage;
+    usage.userValue = static_cast<Ogre::Real>(
+        radius / (screenRatio * tanHalfFov));
+    usage.value = strategy->transformUserValue(usage.userValue);
+    usage.edgeData = nullptr;
+    _ogreMesh->_setLodUsage(static_cast<unsigned short>(level), usage);
+  }
+
+  for (size_t i = 0u; i < _data.subMeshes.size(); ++i)
+  {
+    Ogre::v1::SubMesh *ogreSubMesh =
+        _ogreMesh->getSubMesh(static_cast<unsigned short>(i));
+    const auto &lodIndices = _data.subMeshes[i]->lodIndices;
+    for (size_t level = 0u; level < levels && level < lodIndices.size();
+        ++level)
+    {
+      const std::vector<uint32_t> &indices = lodIndices[level];
+      Ogre::v1::IndexData *indexData = OGRE_NEW Ogre::v1::IndexData();
+      indexData->indexStart = 0u;
+      indexData->indexCount = indices.size();
+      if (!indices.empty())
+      {
+        indexData->indexBuffer =
+            Ogre::v1::HardwareBufferManager::getSingleton().createIndexBuffer(
+                Ogre::v1::HardwareIndexBuffer::IT_32BIT, indices.size(),
+                Ogre::v1::HardwareBuffer::HBU_STATIC, true);
+        indexData->indexBuffer->writeData(0u,
+            indices.size() * sizeof(uint32_t), indices.data(), true);
+      }
+      ogreSubMesh->mLodFaceList[Ogre::VpNormal][level] = indexData;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the direction from the center of a mesh to the camera that
+/// rendered a view of its impostor atlas. The views are laid out with an
+/// octahedral mapping of the directions, as in impostor_vs.glsl.
+/// \param[in] _x Column of the view
+/// \param[in] _y Row of the view
+/// \return Unit direction
+static Ogre::Vector3 impostorDirection(unsigned int _x, unsigned int _y)
+{
+  Ogre::Real u = (_x + 0.5f) / kImpostorGridSize * 2.0f - 1.0f;
+  Ogre::Real v = (_y + 0.5f) / kImpostorGridSize * 2.0f - 1.0f;
+  Ogre::Vector3 dir(u, v, 1.0f - std::abs(u) - std::abs(v));
+  if (dir.z < 0.0f)
+  {
+    dir.x = (1.0f - std::abs(v)) * (u < 0.0f ? -1.0f : 1.0f);
+    dir.y = (1.0f - std::abs(u)) * (v < 0.0f ? -1.0f : 1.0f);
+  }
+  return dir.normalisedCopy();
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshFactoryPrivate::CreateImpostor(Ogre::v1::Mesh *_ogreMesh,
+    const Ogre2MeshData &_data, double _distance, const std::string &_name)
+{
+  double radius = (_data.max - _data.min).Length() * 0.5;
+  if (_ogreMesh->getNumSubMeshes() == 0u || radius <= 0.0)
+    return;
+
+  Ogre::MaterialPtr baseMaterial =
+      Ogre::MaterialManager::getSingleton().getByName("Impostor");
+  if (baseMaterial.isNull())
+  {
+    ignerr << "Impostor material not found, mesh [" << _name
+           << "] has no impostor" << std::endl;
+    return;
+  }
+
+  // atlas of the views around the mesh, rendered by BakeImpostor
+  std::string atlasName = _name + kImpostorAtlasSuffix;
+  unsigned int atlasSize = kImpostorGridSize * kImpostorViewSize;
+  Ogre::TextureManager &textureManager = Ogre::TextureManager::getSingleton();
+  if (!textureManager.resourceExists(atlasName))
+  {
+    textureManager.createManual(atlasName, "General", Ogre::TEX_TYPE_2D,
+        atlasSize, atlasSize, 1, 0, Ogre::PF_A8R8G8B8,
+        Ogre::TU_RENDERTARGET, 0, true);
+  }
+
+  math::Vector3d center = (_data.min + _data.max) * 0.5;
+  std::string materialName = _name + kImpostorMaterialSuffix;
+  Ogre::MaterialManager::getSingleton().remove(materialName);
+  baseMaterial->load();
+  Ogre::MaterialPtr material = baseMaterial->clone(materialName);
+  material->load();
+  Ogre::Pass *pass = material->getTechnique(0)->getPass(0);
+  pass->getTextureUnitState(0)->setTextureName(atlasName);
+  Ogre::GpuProgramParametersSharedPtr params =
+      pass->getVertexProgramParameters();
+  params->setNamedConstant("center", Ogre::Vector3(center.X(), center.Y(),
+      center.Z()));
+  params->setNamedConstant("radius", static_cast<Ogre::Real>(radius));
+  params->setNamedConstant("gridSize",
+      static_cast<Ogre::Real>(kImpostorGridSize));
+
+  // the corners of the quad are at the center of the mesh, the vertex
+  // shader spreads them to face the camera
+  Ogre::v1::SubMesh *subMesh = _ogreMesh->createSubMesh(materialName);
+  subMesh->useSharedVertices = false;
+  subMesh->operationType = Ogre::OT_TRIANGLE_LIST;
+  subMesh->vertexData[Ogre::VpNormal] = new Ogre::v1::VertexData();
+  Ogre::v1::VertexData *vertexData = subMesh->vertexData[Ogre::VpNormal];
+  Ogre::v1::VertexDeclaration *vertexDecl = vertexData->vertexDeclaration;
+  vertexDecl->addElement(0, 0, Ogre::VET_FLOAT3, Ogre::VES_POSITION);
+  vertexDecl->addElement(0,
+      Ogre::v1::VertexElement::getTypeSize(Ogre::VET_FLOAT3),
+      Ogre::VET_FLOAT2, Ogre::VES_TEXTURE_COORDINATES, 0);
+  vertexData->vertexCount = 4u;
+  Ogre::v1::HardwareVertexBufferSharedPtr vBuf =
+      Ogre::v1::HardwareBufferManager::getSingleton().createVertexBuffer(
+          vertexDecl->getVertexSize(0), vertexData->vertexCount,
+          Ogre::v1::HardwareBuffer::HBU_STATIC, true);
+  vertexData->vertexBufferBinding->setBinding(0, vBuf);
+  const float corners[4][2] = {{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f},
+      {0.0f, 1.0f}};
+  float vertices[20];
+  for (unsigned int i = 0u; i < 4u; ++i)
+  {
+    float *vertex = vertices + i * 5u;
+    vertex[0] = static_cast<float>(center.X());
+    vertex[1] = static_cast<float>(center.Y());
+    vertex[2] = static_cast<float>(center.Z());
+    vertex[3] = corners[i][0];
+    vertex[4] = corners[i][1];
+  }
+  vBuf->writeData(0u, sizeof(vertices), vertices, true);
+
+  auto writeIndices = [](Ogre::v1::IndexData *_indexData,
+      const std::vector<uint32_t> &_indices)
+  {
+    _indexData->indexStart = 0u;
+    _indexData->indexCount = _indices.size();
+    if (_indices.empty())
+      return;
+    _indexData->indexBuffer =
+        Ogre::v1::HardwareBufferManager::getSingleton().createIndexBuffer(
+            Ogre::v1::HardwareIndexBuffer::IT_32BIT, _indices.size(),
+            Ogre::v1::HardwareBuffer::HBU_STATIC, true);
+    _indexData->indexBuffer->writeData(0u,
+        _indices.size() * sizeof(uint32_t), _indices.data(), true);
+  };
+
+  // the full detail level draws a degenerate triangle instead of the quad
+  writeIndices(subMesh->indexData[Ogre::VpNormal], {0u, 0u, 0u});
+  subMesh->setMaterialName(materialName);
+
+  // the impostor is the level after the last one, at least at the given
+  // distance
+  unsigned short levels = _ogreMesh->getNumLodLevels();
+  _ogreMesh->_setLodInfo(static_cast<unsigned short>(levels + 1u));
+  Ogre::LodStrategy *strategy =
+      Ogre::LodStrategyManager::getSingleton().getDefaultStrategy();
+  double distance = _distance;
+  if (levels > 1u)
+  {
+    distance = std::max(distance, 1.01 *
+        _ogreMesh->getLodLevel(static_cast<unsigned short>(levels - 1u))
+        .userValue);
+  }
+  Ogre::v1::MeshLodUsage usage;
+  usage.userValue = static_cast<Ogre::Real>(distance);
+  usage.value = strategy->transformUserValue(usage.userValue);
+  usage.edgeData = nullptr;
+  _ogreMesh->_setLodUsage(levels, usage);
+
+  // only the impostor is drawn at its level, and only at that level
+  for (unsigned short i = 0u; i < _ogreMesh->getNumSubMeshes(); ++i)
+  {
+    Ogre::v1::SubMesh *ogreSubMesh = _ogreMesh->getSubMesh(i);
+    auto &lodFaces = ogreSubMesh->mLodFaceList[Ogre::VpNormal];
+    for (size_t level = 0u; level < lodFaces.size(); ++level)
+    {
+      bool impostorLevel = level + 1u == lodFaces.size();
+      if (ogreSubMesh != subMesh && !impostorLevel)
+        continue;
+      Ogre::v1::IndexData *indexData = OGRE_NEW Ogre::v1::IndexData();
+      if (ogreSubMesh == subMesh && impostorLevel)
+        writeIndices(indexData, {0u, 3u, 2u, 0u, 2u, 1u});
+      else
+        writeIndices(indexData, {});
+      lodFaces[level] = indexData;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshFactoryPrivate::BakeImpostor(Ogre::Item *_item,
+    Ogre2ScenePtr _scene)
+{
+  std::string name = _item->getMesh()->getName();
+  if (!bakedImpostors.insert(name).second)
+    return;
+
+  Ogre::TextureManager &textureManager = Ogre::TextureManager::getSingleton();
+  Ogre::TexturePtr atlas =
+      textureManager.getByName(name + kImpostorAtlasSuffix);
+  const Ogre::Aabb &aabb = _item->getMesh()->getAabb();
+  Ogre::Real radius = aabb.mHalfSize.length();
+  if (atlas.isNull() || radius <= 0.0f)
+    return;
+
+  // each view is rendered into a texture copied into its cell of the atlas
+  std::string viewName = name + "::ImpostorView";
+  Ogre::TexturePtr view = textureManager.createManual(viewName, "General",
+      Ogre::TEX_TYPE_2D, kImpostorViewSize, kImpostorViewSize, 1, 0,
+      atlas->getFormat(), Ogre::TU_RENDERTARGET, 0,
+      atlas->isHardwareGammaEnabled());
+
+  Ogre::CompositorManager2 *compMgr =
+      Ogre2RenderEngine::Instance()->OgreRoot()->getCompositorManager2();
+  std::string wsDefName = "Ogre2ImpostorBake/Workspace";
+  std::string nodeDefName = "Ogre2ImpostorBake/Node";
+  if (!compMgr->hasWorkspaceDefinition(wsDefName))
+  {
+    Ogre::CompositorNodeDef *nodeDef =
+        compMgr->addNodeDefinition(nodeDefName);
+    nodeDef->addTextureSourceName("rt_view", 0,
+        Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+    nodeDef->setNumTargetPass(1);
+    Ogre::CompositorTargetDef *targetDef = nodeDef->addTargetPass("rt_view");
+    targetDef->setNumPasses(2);
+    Ogre::CompositorPassClearDef *passClear =
+        static_cast<Ogre::CompositorPassClearDef *>(
+        targetDef->addPass(Ogre::PASS_CLEAR));
+    passClear->mColourValue = Ogre::ColourValue(0.0f, 0.0f, 0.0f, 0.0f);
+    Ogre::CompositorPassSceneDef *passScene =
+        static_cast<Ogre::CompositorPassSceneDef *>(
+        targetDef->addPass(Ogre::PASS_SCENE));
+    passScene->mVisibilityMask = kImpostorBakeVisibilityFlags;
+    Ogre::CompositorWorkspaceDef *wsDef =
+        compMgr->addWorkspaceDefinition(wsDefName);
+    wsDef->connectExternal(0, nodeDefName, 0);
+  }
+
+  // orthographic camera framing the bounding sphere, at full detail
+  Ogre::SceneManager *sceneManager = _scene->OgreSceneManager();
+  Ogre::Camera *camera = sceneManager->createCamera(name + "::ImpostorCamera");
+  camera->setProjectionType(Ogre::PT_ORTHOGRAPHIC);
+  camera->setAspectRatio(1.0f);
+  camera->setOrthoWindow(2.0f * radius, 2.0f * radius);
+  camera->setNearClipDistance(0.01f * radius);
+  camera->setFarClipDistance(4.0f * radius);
+  camera->setLodBias(1.0e6f);
+
+  Ogre::CompositorWorkspace *workspace = compMgr->addWorkspace(sceneManager,
+      view->getBuffer()->getRenderTarget(), camera, wsDefName, false);
+  Ogre2ImpostorBakeListener listener;
+  workspace->setListener(&listener);
+
+  // only the mesh is rendered, under a white ambient light
+  Ogre::SceneNode *node =
+      sceneManager->getRootSceneNode()->createChildSceneNode();
+  node->attachObject(_item);
+  Ogre::uint32 flags = _item->getVisibilityFlags();
+  _item->setVisibilityFlags(kImpostorBakeVisibilityFlags);
+  Ogre::ColourValue upper = sceneManager->getAmbientLightUpperHemisphere();
+  Ogre::ColourValue lower = sceneManager->getAmbientLightLowerHemisphere();
+  Ogre::Vector3 hemisphereDir = sceneManager->getAmbientLightHemisphereDir();
+  sceneManager->setAmbientLight(Ogre::ColourValue::White,
+      Ogre::ColourValue::White, Ogre::Vector3::UNIT_Z);
+
+  for (unsigned int y = 0u; y < kImpostorGridSize; ++y)
+  {
+    for (unsigned int x = 0u; x < kImpostorGridSize; ++x)
+    {
+      // same up axis as impostor_vs.glsl
+      Ogre::Vector3 dir = impostorDirection(x, y);
+      camera->setFixedYawAxis(true, std::abs(dir.z) > 0.99f ?
+          Ogre::Vector3::UNIT_X : Ogre::Vector3::UNIT_Z);
+      camera->setPosition(aabb.mCenter + dir * 2.0f * radius);
+      camera->lookAt(aabb.mCenter);
+      Ogre2RenderEngine::Instance()->RenderWorkspaces({workspace});
+
+      Ogre::Box srcBox(0, 0, kImpostorViewSize, kImpostorViewSize);
+      Ogre::Box dstBox(x * kImpostorViewSize, y * kImpostorViewSize,
+          (x + 1u) * kImpostorViewSize, (y + 1u) * kImpostorViewSize);
+      atlas->getBuffer()->blit(view->getBuffer(), srcBox, dstBox);
+    }
+  }
+
+  sceneManager->setAmbientLight(upper, lower, hemisphereDir);
+  _item->setVisibilityFlags(flags);
+  node->detachObject(_item);
+  sceneManager->destroySceneNode(node);
+  compMgr->removeWorkspace(workspace);
+  sceneManager->destroyCamera(camera);
+  textureManager.remove(viewName);
+}
+
+//////////////////////////////////////////////////
+bool Ogre2MeshFactoryPrivate::IsImpostor(const Ogre::SubItem *_subItem)
+{
+  const Ogre::SubMesh *subMesh = _subItem->getSubMesh();
+  return subMesh->mParent &&
+      subMesh->getMaterialName() ==
+      subMesh->mParent->getName() + kImpostorMaterialSuffix;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2MeshFactoryPrivate::CenterByOffset(const MeshDescriptor &_desc)
+{
+  if (!_desc.centerSubMesh || !_desc.mesh || _desc.mesh->HasSkeleton())
+    return false;
+  return !_desc.subMeshName.empty() || _desc.mesh->SubMeshCount() == 1u;
+}
+
+//////////////////////////////////////////////////
+math::Vector3d Ogre2MeshFactoryPrivate::CenterOffset(
+    const MeshDescriptor &_desc)
+{
+  std::shared_ptr<common::SubMesh> subMesh = _desc.subMeshName.empty() ?
+      _desc.mesh->SubMeshByIndex(0u).lock() :
+      _desc.mesh->SubMeshByName(_desc.subMeshName).lock();
+  if (!subMesh)
+    return math::Vector3d::Zero;
+
+  // the translation applied by common::SubMesh::Center
+  return -(subMesh->Min() + subMesh->Max()) * 0.5;
+}
+
+//////////////////////////////////////////////////
+Ogre::OperationType Ogre2MeshFactoryPrivate::OperationType(
+    const common::SubMesh &_subMesh)
+{
+  switch (_subMesh.SubMeshPrimitiveType())
+  {
+    case common::SubMesh::TRIANGLES:
+      return Ogre::OT_TRIANGLE_LIST;
+    case common::SubMesh::LINES:
+      return Ogre::OT_LINE_LIST;
+    case common::SubMesh::LINESTRIPS:
+      return Ogre::OT_LINE_STRIP;
+    case common::SubMesh::TRIFANS:
+      return Ogre::OT_TRIANGLE_FAN;
+    case common::SubMesh::TRISTRIPS:
+      return Ogre::OT_TRIANGLE_STRIP;
+    case common::SubMesh::POINTS:
+      return Ogre::OT_POINT_LIST;
+    default:
+      ignerr << "Unknown primitive type["
+            << _subMesh.SubMeshPrimitiveType() << "]\n";
+      return Ogre::OT_TRIANGLE_LIST;
+  }
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2MeshFactoryPrivate::MaterialName(const MeshDescriptor &_desc,
+    const common::SubMesh &_subMesh, Ogre2ScenePtr _scene)
+{
+  common::MaterialPtr material;
+  material = _desc.mesh->MaterialByIndex(_subMesh.MaterialIndex());
+
+  MaterialPtr mat = _scene->CreateMaterial();
+  if (material)
+  {
+    mat->CopyFrom(*material);
+  }
+  else
+  {
+    MaterialPtr defaultMat = _scene->Material("Default/White");
+    if (defaultMat != nullptr)
+      mat->CopyFrom(defaultMat);
+  }
+  return mat->Name();
+}
+
+//////////////////////////////////////////////////
+bool Ogre2MeshFactoryPrivate::CreateMesh(const std::string &_name,
+    const MeshDescriptor &_desc, const Ogre2MeshData &_data,
+    Ogre2ScenePtr _scene)
+{
+  if (!_data.max.IsFinite())
+  {
+    ignerr << "Max bounding box is not finite[" << _data.max << "]"
+           << std::endl;
+    return false;
+  }
+
+  if (!_data.min.IsFinite())
+  {
+    ignerr << "Min bounding box is not finite[" << _data.min << "]"
+           << std::endl;
+    return false;
+  }
+
+  Ogre::RenderSystem *renderSystem =
+      _scene->OgreSceneManager()->getDestinationRenderSystem();
+  Ogre::VaoManager *vaoManager = renderSystem->getVaoManager();
+  if (!vaoManager)
+    return false;
+
+  try
+  {
+    Ogre::MeshPtr ogreMesh = Ogre::MeshManager::getSingleton().createManual(
+        _name, Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
+    for (const auto &subMeshData : _data.subMeshes)
+    {
+      const common::SubMesh &subMesh = subMeshData->subMesh;
+      if (subMesh.VertexCount() == 0u)
+        continue;
+
+      // float positions, half float normals and texture coordinates, in
+      // the order they are packed by PrepareMeshData
+      Ogre::VertexElement2Vec vertexElements;
+      vertexElements.push_back(
+          Ogre::VertexElement2(Ogre::VET_FLOAT3, Ogre::VES_POSITION));
+      if (subMesh.NormalCount() > 0)
+      {
+        vertexElements.push_back(Ogre::VertexElement2(
+            subMeshData->packedByteNormals ? Ogre::VET_BYTE4_SNORM :
+            Ogre::VET_HALF4, Ogre::VES_NORMAL));
+      }
+      for (unsigned int k = 0u; k < subMeshData->packedTexCoordSets; ++k)
+      {
+        vertexElements.push_back(Ogre::VertexElement2(Ogre::VET_HALF2,
+            Ogre::VES_TEXTURE_COORDINATES));
+      }
+
+      // the data is copied to the buffers, no shadow copy is kept
+      Ogre::VertexBufferPacked *vertexBuffer = vaoManager->createVertexBuffer(
+          vertexElements, subMesh.VertexCount(), Ogre::BT_IMMUTABLE,
+          const_cast<uint8_t *>(subMeshData->packedVertices.data()), false);
+      Ogre::VertexBufferPackedVec vertexBuffers;
+      vertexBuffers.push_back(vertexBuffer);
+
+      Ogre::IndexBufferPacked *indexBuffer = nullptr;
+      if (!subMeshData->indices16.empty())
+      {
+        indexBuffer = vaoManager->createIndexBuffer(
+            Ogre::IndexBufferPacked::IT_16BIT, subMeshData->indices16.size(),
+            Ogre::BT_IMMUTABLE,
+            const_cast<uint16_t *>(subMeshData->indices16.data()), false);
+      }
+      else if (!subMeshData->indices.empty())
+      {
+        indexBuffer = vaoManager->createIndexBuffer(
+            Ogre::IndexBufferPacked::IT_32BIT, subMeshData->indices.size(),
+            Ogre::BT_IMMUTABLE,
+            const_cast<uint32_t *>(subMeshData->indices.data()), false);
+      }
+
+      Ogre::VertexArrayObject *vao = vaoManager->createVertexArrayObject(
+          vertexBuffers, indexBuffer,
+          Ogre2MeshFactoryPrivate::OperationType(subMesh));
+
+      Ogre::SubMesh *ogreSubMesh = ogreMesh->createSubMesh();
+      ogreSubMesh->mVao[Ogre::VpNormal].push_back(vao);
+      // Use the same geometry for shadow casting.
+      ogreSubMesh->mVao[Ogre::VpShadow].push_back(vao);
+      ogreMesh->nameSubMesh(subMesh.Name(), ogreMesh->getNumSubMeshes() - 1);
+
+      ogreSubMesh->setMaterialName(
+          Ogre2MeshFactoryPrivate::MaterialName(_desc, subMesh, _scene));
+    }
+
+    Ogre::Vector3 min = Ogre2Conversions::Convert(_data.min);
+    Ogre::Vector3 max = Ogre2Conversions::Convert(_data.max);
+    ogreMesh->_setBounds(Ogre::Aabb::newFromExtents(min, max), false);
+    ogreMesh->_setBoundingSphereRadius((_data.max - _data.min).Length());
+    trackMeshMemory(ogreMesh.get());
+  }
+  catch(Ogre::Exception &e)
+  {
+    ignerr << "Unable to insert mesh[" << e.getDescription() << "]"
+        << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2MeshFactoryPrivate::CacheFile(
+    const MeshDescriptor &_desc) const
+{
+  // meshes created in memory have no file to hash
+  const std::string &meshFile = _desc.mesh->Name();
+  if (this->cacheDir.empty() || !common::isFile(meshFile))
+    return std::string();
+
+  std::ifstream in(meshFile, std::ios::binary);
+  if (!in)
+    return std::string();
+  std::stringstream content;
+  content << in.rdbuf();
+
+  // bump the version whenever the layout of the converted geometry changes
+  std::stringstream key;
+  key << "v2::" << common::sha1<std::string>(content.str())
+      << "::" << _desc.subMeshName
+      << "::" << (_desc.centerSubMesh &&
+          !Ogre2MeshFactoryPrivate::CenterByOffset(_desc) ?
+          "CENTERED" : "ORIGINAL");
+  if (this->optimize)
+    key << "::OPTIMIZED";
+
+  return common::joinPaths(this->cacheDir,
+      common::sha1<std::string>(key.str()) + ".mesh");
+}
+
+//////////////////////////////////////////////////
+bool Ogre2MeshFactoryPrivate::LoadCachedMesh(const std::string &_name,
+    const std::string &_file, const MeshDescriptor &_desc,
+    Ogre2ScenePtr _scene)
+{
+  if (!common::isFile(_file))
+    return false;
+
+  Ogre::RenderSystem *renderSystem =
+      _scene->OgreSceneManager()->getDestinationRenderSystem();
+  Ogre::VaoManager *vaoManager = renderSystem->getVaoManager();
+  if (!vaoManager)
+    return false;
+
+  // read the whole file at once, the serializer then parses it from memory
+  std::ifstream in(_file, std::ios::binary | std::ios::ate);
+  if (!in)
+    return false;
+  std::streamsize size = in.tellg();
+  in.seekg(0, std::ios::beg);
+  std::vector<char> buffer(static_cast<size_t>(size));
+  if (size <= 0 || !in.read(buffer.data(), size))
+    return false;
+
+  // submeshes in the order they were created by CreateMesh
+  std::vector<common::SubMeshPtr> subMeshes;
+  for (unsigned int i = 0; i < _desc.mesh->SubMeshCount(); i++)
+  {
+    auto s = _desc.mesh->SubMeshByIndex(i).lock();
+    if (!s || (!_desc.subMeshName.empty() && s->Name() != _desc.subMeshName)
+        || s->VertexCount() == 0u)
+    {
+      continue;
+    }
+    subMeshes.push_back(s);
+  }
+
+  Ogre::MeshPtr ogreMesh;
+  try
+  {
+    ogreMesh = Ogre::MeshManager::getSingleton().createManual(
+        _name, Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
+    Ogre::DataStreamPtr stream(OGRE_NEW Ogre::MemoryDataStream(
+        buffer.data(), buffer.size(), false, true));
+    Ogre::MeshSerializer serializer(vaoManager);
+    serializer.importMesh(stream, ogreMesh.get());
+  }
+  catch(Ogre::Exception &e)
+  {
+    ignwarn << "Unable to load cached mesh [" << _file << "]: "
+            << e.getDescription() << std::endl;
+    if (!ogreMesh.isNull())
+      Ogre::MeshManager::getSingleton().remove(_name);
+    return false;
+  }
+
+  // a stale cache file, e.g. from a hash collision, is regenerated
+  if (ogreMesh->getNumSubMeshes() != subMeshes.size())
+  {
+    Ogre::MeshManager::getSingleton().remove(_name);
+    return false;
+  }
+
+  // material names are generated by the scene so they are not cached
+  for (unsigned int i = 0; i < subMeshes.size(); ++i)
+  {
+    ogreMesh->getSubMesh(i)->setMaterialName(
+        Ogre2MeshFactoryPrivate::MaterialName(_desc, *subMeshes[i], _scene));
+  }
+  trackMeshMemory(ogreMesh.get());
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshFactoryPrivate::SaveCachedMesh(const std::string &_name,
+    const std::string &_file, Ogre2ScenePtr _scene)
+{
+  Ogre::MeshPtr ogreMesh = Ogre::MeshManager::getSingleton().getByName(_name);
+  if (ogreMesh.isNull())
+    return;
+
+  std::string dir = common::parentPath(_file);
+  if (!common::isDirectory(dir) && !common::createDirectories(dir))
+  {
+    ignerr << "Unable to create mesh cache directory [" << dir << "]"
+           << std::endl;
+    return;
+  }
+
+  Ogre::RenderSystem *renderSystem =
+      _scene->OgreSceneManager()->getDestinationRenderSystem();
+
+  // write to a temporary file first so that other processes never see a
+  // partially written mesh
+  std::string tmpFile = _file + "." + std::to_string(
+      std::chrono::system_clock::now().time_since_epoch().count()) + ".tmp";
+  try
+  {
+    Ogre::MeshSerializer serializer(renderSystem->getVaoManager());
+    serializer.exportMesh(ogreMesh.get(), tmpFile);
+  }
+  catch(Ogre::Exception &e)
+  {
+    ignerr << "Unable to write cached mesh [" << _file << "]: "
+           << e.getDescription() << std::endl;
+    std::remove(tmpFile.c_str());
+    return;
+  }
+
+  if (std::rename(tmpFile.c_str(), _file.c_str()) != 0)
+  {
+    ignerr << "Unable to write cached mesh [" << _file << "]" << std::endl;
+    std::remove(tmpFile.c_str());
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshFactoryPrivate::PrepareMeshData(const MeshDescriptor &_desc,
+    bool _optimize, Ogre2MeshData &_data)
+{
+  // skinned meshes need a v1 skeleton and levels of detail and impostors
+  // are added to the v1 mesh, so they go through the v1 importer
+  _data.direct = !_desc.mesh->HasSkeleton() && _desc.lodLevels == 0u &&
+      _desc.impostorDistance <= 0.0;
+
+  for (unsigned int i = 0; i < _desc.mesh->SubMeshCount(); i++)
+  {
+    // if submesh is specified then load only that particular submesh
+    auto s = _desc.mesh->SubMeshByIndex(i).lock();
+    if (!s || (!_desc.subMeshName.empty() && s->Name() != _desc.subMeshName))
+    {
+      continue;
+    }
+
+    // Copy the original submesh. We may need to modify the vertices, and
+    // we don't want to change the original.
+    _data.subMeshes.push_back(std::make_unique<Ogre2SubMeshData>(*s.get()));
+
+    // Recenter the vertices if requested and the item is not centered
+    // with an offset
+    if (_desc.centerSubMesh && !CenterByOffset(_desc))
+      _data.subMeshes.back()->subMesh.Center(math::Vector3d::Zero);
+
+    // weld the vertices and reorder them and the triangles for the vertex
+    // cache. Only the GPU buffers use the optimized geometry, bounds and
+    // ray queries still use the common::Mesh.
+    if (_optimize && _data.direct)
+    {
+      MeshOptimizer optimizer(_data.subMeshes.back()->subMesh);
+      optimizer.Weld();
+      optimizer.OptimizeVertexCache();
+      optimizer.OptimizeVertexFetch();
+      _data.subMeshes.back() =
+          std::make_unique<Ogre2SubMeshData>(optimizer.Result());
+    }
+
+    Ogre2SubMeshData &subMeshData = *_data.subMeshes.back();
+    common::SubMesh &subMesh = subMeshData.subMesh;
+
+    // positions, normals and all texture coordinate sets, in the order
+    // they are added to the vertex declaration in LoadImpl
+    std::vector<unsigned int> texCoordSets;
+    for (unsigned int k = 0u; k < subMesh.TexCoordSetCount(); ++k)
+    {
+      if (subMesh.TexCoordCountBySet(k) > 0u)
+        texCoordSets.push_back(k);
+    }
+    bool hasNormals = subMesh.NormalCount() > 0;
+
+    if (_data.direct)
+    {
+      Ogre2MeshFactoryPrivate::PackSubMesh(texCoordSets, _optimize,
+          subMeshData);
+      continue;
+    }
+
+    size_t vertexSize = 3u + (hasNormals ? 3u : 0u) + 2u * texCoordSets.size();
+
+    subMeshData.vertices.reserve(vertexSize * subMesh.VertexCount());
+    for (unsigned int j = 0; j < subMesh.VertexCount(); ++j)
+    {
+      const math::Vector3d &vertex = subMesh.Vertex(j);
+      subMeshData.vertices.push_back(vertex.X());
+      subMeshData.vertices.push_back(vertex.Y());
+      subMeshData.vertices.push_back(vertex.Z());
+
+      if (hasNormals)
+      {
+        const math::Vector3d &normal = subMesh.Normal(j);
+        subMeshData.vertices.push_back(normal.X());
+        subMeshData.vertices.push_back(normal.Y());
+        subMeshData.vertices.push_back(normal.Z());
+      }
+
+      for (auto k : texCoordSets)
+      {
+        const math::Vector2d &texCoord = subMesh.TexCoordBySet(j, k);
+        subMeshData.vertices.push_back(texCoord.X());
+        subMeshData.vertices.push_back(texCoord.Y());
+      }
+    }
+
+    subMeshData.indices.reserve(subMesh.IndexCount());
+    for (unsigned int j = 0; j < subMesh.IndexCount(); ++j)
+      subMeshData.indices.push_back(static_cast<uint32_t>(subMesh.Index(j)));
+
+    // each level of detail keeps half of the triangles of the previous one.
+    // Submeshes that can not be simplified keep all their triangles.
+    if (_desc.lodLevels > 0u)
+    {
+      MeshSimplifier simplifier(subMesh);
+      double ratio = 1.0;
+      for (unsigned int level = 0u; level < _desc.lodLevels; ++level)
+      {
+        ratio *= 0.5;
+        std::vector<unsigned int> lod = simplifier.Simplify(ratio);
+        if (lod.empty())
+          subMeshData.lodIndices.push_back(subMeshData.indices);
+        else
+          subMeshData.lodIndices.emplace_back(lod.begin(), lod.end());
+      }
+    }
+  }
+
+  _data.max = _desc.mesh->Max();
+  _data.min = _desc.mesh->Min();
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshFactoryPrivate::PackSubMesh(
+    const std::vector<unsigned int> &_texCoordSets, bool _byteNormals,
+    Ogre2SubMeshData &_subMeshData)
+{
+  const common::SubMesh &subMesh = _subMeshData.subMesh;
+  bool hasNormals = subMesh.NormalCount() > 0;
+
+  // Lit submeshes without texture coordinates get a zero set so that they
+  // have the same vertex layout as textured ones. The vao manager then
+  // places them in the same vertex buffer pools and vertex array objects,
+  // and the render queue can draw them without rebinding vertex state.
+  bool padTexCoords = hasNormals && _texCoordSets.empty();
+  _subMeshData.packedTexCoordSets = padTexCoords ? 1u :
+      static_cast<unsigned int>(_texCoordSets.size());
+
+  // float3 position, half4 or byte4 normal and half2 per texture
+  // coordinate set
+  _subMeshData.packedByteNormals = hasNormals && _byteNormals;
+  size_t normalSize = _subMeshData.packedByteNormals ?
+      4u * sizeof(int8_t) : 4u * sizeof(uint16_t);
+  size_t vertexSize = 3u * sizeof(float) +
+      (hasNormals ? normalSize : 0u) +
+      _subMeshData.packedTexCoordSets * 2u * sizeof(uint16_t);
+  _subMeshData.packedVertices.resize(vertexSize * subMesh.VertexCount());
+
+  uint8_t *dst = _subMeshData.packedVertices.data();
+  for (unsigned int j = 0; j < subMesh.VertexCount(); ++j)
+  {
+    math::Vector3d vertex = subMesh.Vertex(j);
+    float position[3] = {static_cast<float>(vertex.X()),
+        static_cast<float>(vertex.Y()), static_cast<float>(vertex.Z())};
+    std::memcpy(dst, position, sizeof(position));
+    dst += sizeof(position);
+
+    if (_subMeshData.packedByteNormals)
+    {
+      // unit normals lose less than half a degree in 8 bits
+      math::Vector3d normal = subMesh.Normal(j);
+      auto snorm = [](double _value)
+      {
+        return static_cast<int8_t>(std::lround(
+            math::clamp(_value, -1.0, 1.0) * 127.0));
+      };
+      int8_t packed[4] = {snorm(normal.X()), snorm(normal.Y()),
+          snorm(normal.Z()), 0};
+      std::memcpy(dst, packed, sizeof(packed));
+      dst += sizeof(packed);
+    }
+    else if (hasNormals)
+    {
+      math::Vector3d normal = subMesh.Normal(j);
+      uint16_t packed[4] = {
+          Ogre::Bitwise::floatToHalf(static_cast<float>(normal.X())),
+          Ogre::Bitwise::floatToHalf(static_cast<float>(normal.Y())),
+          Ogre::Bitwise::floatToHalf(static_cast<float>(normal.Z())),
+          Ogre::Bitwise::floatToHalf(0.0f)};
+      std::memcpy(dst, packed, sizeof(packed));
+      dst += sizeof(packed);
+    }
+
+    for (auto k : _texCoordSets)
+    {
+      math::Vector2d texCoord = subMesh.TexCoordBySet(j, k);
+      uint16_t packed[2] = {
+          Ogre::Bitwise::floatToHalf(static_cast<float>(texCoord.X())),
+          Ogre::Bitwise::floatToHalf(static_cast<float>(texCoord.Y()))};
+      std::memcpy(dst, packed, sizeof(packed));
+      dst += sizeof(packed);
+    }
+
+    if (padTexCoords)
+    {
+      std::memset(dst, 0, 2u * sizeof(uint16_t));
+      dst += 2u * sizeof(uint16_t);
+    }
+  }
+
+  // use 16 bit indices whenever all vertices can be addressed with them.
+  // 0xFFFF is left out as it is the primitive restart index
+  if (subMesh.VertexCount() < 0xFFFFu)
+  {
+    _subMeshData.indices16.reserve(subMesh.IndexCount());
+    for (unsigned int j = 0; j < subMesh.IndexCount(); ++j)
+    {
+      _subMeshData.indices16.push_back(
+          static_cast<uint16_t>(subMesh.Index(j)));
+    }
+  }
+  else
+  {
+    _subMeshData.indices.reserve(subMesh.IndexCount());
+    for (unsigned int j = 0; j < subMesh.IndexCount(); ++j)
+      _subMeshData.indices.push_back(static_cast<uint32_t>(subMesh.Index(j)));
+  }
+}
+
 //////////////////////////////////////////////////
 std::string Ogre2MeshFactory::MeshName(const MeshDescriptor &_desc)
 {
   std::stringstream ss;
   ss << _desc.meshName << "::";
   ss << _desc.subMeshName << "::";
-  ss << ((_desc.centerSubMesh) ? "CENTERED" : "ORIGINAL");
+  // submeshes centered with an offset share the original geometry
+  bool centered = _desc.centerSubMesh &&
+      !Ogre2MeshFactoryPrivate::CenterByOffset(_desc);
+  ss << (centered ? "CENTERED" : "ORIGINAL");
+  if (_desc.lodLevels > 0u)
+    ss << "::LOD" << _desc.lodLevels;
+  if (_desc.impostorDistance > 0.0)
+    ss << "::IMP" << _desc.impostorDistance;
   return ss.str();
 }
 
@@ -553,7 +2074,7 @@ Ogre2SubMeshStoreFactory::~Ogre2SubMeshStoreFactory()
 Ogre2SubMeshStorePtr Ogre2SubMeshStoreFactory::Create()
 {
   Ogre2SubMeshStorePtr subMeshes(new Ogre2SubMeshStore);
-  unsigned int count = this->ogreItem->getNumSubItems();
+  unsigned int count = meshSubItemCount(this->ogreItem);
 
   for (unsigned int i = 0; i < count; ++i)
   {
@@ -564,10 +2085,24 @@ Ogre2SubMeshStorePtr Ogre2SubMeshStoreFactory::Create()
   return subMeshes;
 }
 
+//////////////////////////////////////////////////
+void Ogre2SubMeshStoreFactory::SetMaterialsShared(bool _shared)
+{
+  this->dataPtr->materialsShared = _shared;
+}
+
+//////////////////////////////////////////////////
+void Ogre2SubMeshStoreFactory::SetMaterialNames(
+    const std::vector<std::string> &_names)
+{
+  this->dataPtr->materialNames = _names;
+}
+
 //////////////////////////////////////////////////
 Ogre2SubMeshPtr Ogre2SubMeshStoreFactory::CreateSubMesh(unsigned int _index)
 {
-  Ogre2SubMeshPtr subMesh(new Ogre2SubMesh);
+  Ogre2SubMeshPtr subMesh = SharePooled(
+      new (AllocatePooled<Ogre2SubMesh>()) Ogre2SubMesh);
 
   subMesh->id = _index;
   subMesh->name = this->names[_index];
@@ -576,7 +2111,11 @@ Ogre2SubMeshPtr Ogre2SubMeshStoreFactory::CreateSubMesh(unsigned int _index)
 
   MaterialPtr mat;
   Ogre::HlmsDatablock *ogreDatablock = subMesh->ogreSubItem->getDatablock();
-  if (ogreDatablock)
+  if (_index < this->dataPtr->materialNames.size())
+  {
+    mat = this->scene->Material(this->dataPtr->materialNames[_index]);
+  }
+  else if (ogreDatablock)
   {
     std::string matName = subMesh->ogreSubItem->getSubMesh()->getMaterialName();
     mat = this->scene->Material(matName);
@@ -584,8 +2123,9 @@ Ogre2SubMeshPtr Ogre2SubMeshStoreFactory::CreateSubMesh(unsigned int _index)
 
   if (mat)
   {
-    // assign material to submesh who will make a copy of this material
-    subMesh->SetMaterial(mat);
+    // assign material to submesh who will make a copy of this material,
+    // unless copies of the mesh share it so their draws can be instanced
+    subMesh->SetMaterial(mat, !this->dataPtr->materialsShared);
   }
 
   subMesh->Load();
@@ -604,7 +2144,7 @@ void Ogre2SubMeshStoreFactory::CreateNameList()
 //////////////////////////////////////////////////
 void Ogre2SubMeshStoreFactory::PopulateDefaultNames()
 {
-  unsigned int count = this->ogreItem->getNumSubItems();
+  unsigned int count = meshSubItemCount(this->ogreItem);
   this->names.reserve(count);
 
   for (unsigned int i = 0; i < count; ++i)
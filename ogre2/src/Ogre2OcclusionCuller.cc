@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Ogre2OcclusionCuller.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+Ogre2OcclusionCuller::~Ogre2OcclusionCuller()
+{
+  this->Restore();
+}
+
+//////////////////////////////////////////////////
+void Ogre2OcclusionCuller::SetDepth(const float *_depth, unsigned int _width,
+    unsigned int _height, const Ogre::Matrix4 &_view,
+    const Ogre::Matrix4 &_proj, double _near, double _far)
+{
+  this->Clear();
+  if (!_depth || _width == 0u || _height == 0u)
+    return;
+
+  this->view = _view;
+  this->proj = _proj;
+  this->nearClip = _near;
+
+  // invalid depths are out of range or clamped, they are pushed to
+  // infinity so they never occlude
+  const float inf = std::numeric_limits<float>::infinity();
+  std::vector<float> base(static_cast<size_t>(_width) * _height);
+  for (size_t i = 0u; i < base.size(); ++i)
+  {
+    float d = _depth[i];
+    base[i] = (std::isfinite(d) && d > _near && d < _far) ? d : inf;
+  }
+  this->levels.push_back(std::move(base));
+  this->widths.push_back(_width);
+  this->heights.push_back(_height);
+
+  // each texel keeps the farthest depth of the texels below it
+  while (this->widths.back() > 1u || this->heights.back() > 1u)
+  {
+    const std::vector<float> &below = this->levels.back();
+    unsigned int bw = this->widths.back();
+    unsigned int bh = this->heights.back();
+    unsigned int w = (bw + 1u) / 2u;
+    unsigned int h = (bh + 1u) / 2u;
+    std::vector<float> level(static_cast<size_t>(w) * h);
+    for (unsigned int y = 0u; y < h; ++y)
+    {
+      unsigned int y0 = y * 2u;
+      unsigned int y1 = std::min(y0 + 1u, bh - 1u);
+      for (unsigned int x = 0u; x < w; ++x)
+      {
+        unsigned int x0 = x * 2u;
+        unsigned int x1 = std::min(x0 + 1u, bw - 1u);
+        level[y * w + x] = std::max(
+            std::max(below[y0 * bw + x0], below[y0 * bw + x1]),
+            std::max(below[y1 * bw + x0], below[y1 * bw + x1]));
+      }
+    }
+    this->levels.push_back(std::move(level));
+    this->widths.push_back(w);
+    this->heights.push_back(h);
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2OcclusionCuller::Clear()
+{
+  this->levels.clear();
+  this->widths.clear();
+  this->heights.clear();
+}
+
+//////////////////////////////////////////////////
+bool Ogre2OcclusionCuller::Occluded(const Ogre::Aabb &_box,
+    double _margin) const
+{
+  if (this->levels.empty())
+    return false;
+
+  // project the corners of the box, keeping its nearest depth
+  double minDepth = std::numeric_limits<double>::max();
+  double minX = 1.0;
+  double maxX = -1.0;
+  double minY = 1.0;
+  double maxY = -1.0;
+  for (unsigned int i = 0u; i < 8u; ++i)
+  {
+    Ogre::Vector3 corner = _box.mCenter + _box.mHalfSize * Ogre::Vector3(
+        (i & 1u) ? 1.0 : -1.0, (i & 2u) ? 1.0 : -1.0, (i & 4u) ? 1.0 : -1.0);
+    Ogre::Vector4 eye = this->view * Ogre::Vector4(corner.x, corner.y,
+        corner.z, 1.0);
+
+    // the box crosses the near plane, it covers the whole view
+    double depth = -eye.z;
+    if (depth <= this->nearClip)
+      return false;
+    minDepth = std::min(minDepth, depth);
+
+    Ogre::Vector4 clip = this->proj * eye;
+    double x = clip.x / clip.w;
+    double y = clip.y / clip.w;
+    minX = std::min(minX, x);
+    maxX = std::max(maxX, x);
+    minY = std::min(minY, y);
+    maxY = std::max(maxY, y);
+  }
+
+  // boxes outside of the view are left to frustum culling
+  if (maxX < -1.0 || minX > 1.0 || maxY < -1.0 || minY > 1.0)
+    return false;
+
+  // pixels covered by the box, the rows start from the top of the image
+  const int w = static_cast<int>(this->widths[0]);
+  const int h = static_cast<int>(this->heights[0]);
+  int x0 = static_cast<int>(std::floor((minX * 0.5 + 0.5) * w));
+  int x1 = static_cast<int>(std::ceil((maxX * 0.5 + 0.5) * w)) - 1;
+  int y0 = static_cast<int>(std::floor((0.5 - maxY * 0.5) * h));
+  int y1 = static_cast<int>(std::ceil((0.5 - minY * 0.5) * h)) - 1;
+  x0 = std::max(0, std::min(x0, w - 1));
+  x1 = std::max(x0, std::min(x1, w - 1));
+  y0 = std::max(0, std::min(y0, h - 1));
+  y1 = std::max(y0, std::min(y1, h - 1));
+
+  // coarsest level where the box covers at most 4x4 texels
+  size_t l = 0u;
+  while (l + 1u < this->levels.size() &&
+      ((x1 >> l) - (x0 >> l) > 3 || (y1 >> l) - (y0 >> l) > 3))
+  {
+    ++l;
+  }
+
+  const std::vector<float> &level = this->levels[l];
+  const int lw = static_cast<int>(this->widths[l]);
+  for (int y = y0 >> l; y <= (y1 >> l); ++y)
+  {
+    for (int x = x0 >> l; x <= (x1 >> l); ++x)
+    {
+      if (minDepth <= level[y * lw + x] + _margin)
+        return false;
+    }
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2OcclusionCuller::Hide(Ogre::SceneManager *_sceneManager,
+    double _margin)
+{
+  if (this->hiding)
+    return;
+  this->hiding = true;
+
+  if (this->levels.empty())
+    return;
+
+  auto itor = _sceneManager->getMovableObjectIterator(
+      Ogre::ItemFactory::FACTORY_TYPE_NAME);
+  while (itor.hasMoreElements())
+  {
+    Ogre::Item *item = static_cast<Ogre::Item *>(itor.peekNext());
+    itor.moveNext();
+
+    if (!item->isVisible() || !item->isAttached())
+      continue;
+
+    Ogre::Aabb box = item->getWorldAabbUpdated();
+    if (!std::isfinite(box.getRadius()))
+      continue;
+
+    if (this->Occluded(box, _margin))
+    {
+      item->setVisible(false);
+      this->hidden.push_back(item);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2OcclusionCuller::Restore()
+{
+  for (auto item : this->hidden)
+    item->setVisible(true);
+  this->hidden.clear();
+  this->hiding = false;
+}
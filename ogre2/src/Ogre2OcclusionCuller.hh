@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2OCCLUSIONCULLER_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2OCCLUSIONCULLER_HH_
+
+#include <vector>
+
+#include "ignition/rendering/ogre2/Ogre2Includes.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Hierarchical-Z occlusion culling from the depth data of the
+    /// previous frame of a camera. Each level of the pyramid stores the
+    /// farthest depth of the 2x2 texels below it, so a box is occluded if
+    /// its nearest point is behind the farthest depth of the texels its
+    /// projection covers. Texels without a valid depth, e.g. out of range,
+    /// never occlude anything.
+    class Ogre2OcclusionCuller
+    {
+      /// \brief Constructor
+      public: Ogre2OcclusionCuller() = default;
+
+      /// \brief Destructor, restores the hidden items
+      public: ~Ogre2OcclusionCuller();
+
+      /// \brief Build the depth pyramid from a frame of a camera
+      /// \param[in] _depth Depth along the view direction of each pixel,
+      /// row by row from the top of the image
+      /// \param[in] _width Width of the depth image
+      /// \param[in] _height Height of the depth image
+      /// \param[in] _view View matrix the frame was rendered with
+      /// \param[in] _proj Projection matrix the frame was rendered with
+      /// \param[in] _near Depths up to this distance are not valid
+      /// \param[in] _far Depths from this distance are not valid
+      public: void SetDepth(const float *_depth, unsigned int _width,
+          unsigned int _height, const Ogre::Matrix4 &_view,
+          const Ogre::Matrix4 &_proj, double _near, double _far);
+
+      /// \brief Drop the depth pyramid, nothing is occluded until the next
+      /// call to SetDepth
+      public: void Clear();
+
+      /// \brief Check if a box is hidden by the depth of the last frame
+      /// \param[in] _box Box in world coordinates
+      /// \param[in] _margin Distance the box must be behind the occluders
+      /// \return True if the box is occluded
+      public: bool Occluded(const Ogre::Aabb &_box, double _margin) const;
+
+      /// \brief Hide the visible items of a scene manager that are
+      /// occluded. Does nothing if items are already hidden.
+      /// \param[in] _sceneManager Scene manager of the items
+      /// \param[in] _margin Distance the items must be behind the occluders
+      public: void Hide(Ogre::SceneManager *_sceneManager, double _margin);
+
+      /// \brief Show the items hidden by Hide again
+      public: void Restore();
+
+      /// \brief Depth pyramid, level 0 has the size of the depth image
+      private: std::vector<std::vector<float>> levels;
+
+      /// \brief Width of each level of the pyramid
+      private: std::vector<unsigned int> widths;
+
+      /// \brief Height of each level of the pyramid
+      private: std::vector<unsigned int> heights;
+
+      /// \brief View matrix of the depth data
+      private: Ogre::Matrix4 view;
+
+      /// \brief Projection matrix of the depth data
+      private: Ogre::Matrix4 proj;
+
+      /// \brief Near clip distance of the depth data
+      private: double nearClip = 0.0;
+
+      /// \brief Items hidden by the last call to Hide
+      private: std::vector<Ogre::Item *> hidden;
+
+      /// \brief True between the calls to Hide and Restore
+      private: bool hiding = false;
+    };
+    }
+  }
+}
+
+#endif
@@ -26,6 +26,12 @@
 #pragma warning(pop)
 #endif
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <ignition/math/Helpers.hh>
+
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
 #include "ignition/rendering/ogre2/Ogre2Includes.hh"
 #include "ignition/rendering/ogre2/Ogre2Material.hh"
@@ -67,6 +73,30 @@ class ignition::rendering::Ogre2ParticleEmitterPrivate
   /// \brief Flag to indicate that the emitter is dirty and needs to be
   /// recreated
   public: bool emitterDirty = false;
+
+  /// \brief World bounding box of the particles
+  public: Ogre::AxisAlignedBox worldBounds;
+
+  /// \brief True if the world bounding box of the particles is finite
+  public: bool worldBoundsValid = false;
+
+  /// \brief Ogre frame number when the world bounding box was computed
+  public: unsigned long worldBoundsFrame =
+      std::numeric_limits<unsigned long>::max();
+
+  /// \brief True to sort the particles by distance to the camera
+  public: bool sortingEnabled = true;
+
+  /// \brief Interval at which the particles are simulated, in seconds. 0 to
+  /// simulate the particles every frame.
+  public: double updateInterval = 0.0;
+
+  /// \brief True if the particle system is detached from the emitter node
+  /// because no sensor can see it
+  public: bool culled = false;
+
+  /// \brief Scale of the emission rate
+  public: double rateScale = 1.0;
 };
 
 // Names used in Ogre for the supported emitters.
@@ -96,6 +126,8 @@ void Ogre2ParticleEmitter::Destroy()
 {
   if (this->dataPtr->ps)
   {
+    this->scene->RemoveParticleEmitter(this);
+
     this->dataPtr->ps->removeAllAffectors();
     this->dataPtr->colorInterpolatorAffector = nullptr;
     this->dataPtr->colorImageAffector = nullptr;
@@ -206,7 +238,7 @@ void Ogre2ParticleEmitter::SetRate(double _rate)
     return;
   }
 
-  this->dataPtr->emitter->setEmissionRate(_rate);
+  this->dataPtr->emitter->setEmissionRate(_rate * this->dataPtr->rateScale);
 
   this->rate = _rate;
 }
@@ -484,7 +516,9 @@ void Ogre2ParticleEmitter::CreateParticleSystem()
 
   this->dataPtr->ps->setCullIndividually(true);
   this->dataPtr->ps->setParticleQuota(500);
-  this->dataPtr->ps->setSortingEnabled(true);
+  this->dataPtr->ps->setSortingEnabled(this->dataPtr->sortingEnabled);
+  this->dataPtr->ps->setIterationInterval(
+      static_cast<Ogre::Real>(this->dataPtr->updateInterval));
 
   this->dataPtr->ps->setVisibilityFlags(kParticleVisibilityFlags);
 
@@ -510,6 +544,132 @@ void Ogre2ParticleEmitter::CreateParticleSystem()
 
   this->dataPtr->ps->setDefaultDimensions(1, 1);
 
-  this->ogreNode->attachObject(this->dataPtr->ps);
+  // a detached particle system is neither updated nor drawn by ogre
+  if (!this->dataPtr->culled)
+    this->ogreNode->attachObject(this->dataPtr->ps);
+  this->dataPtr->worldBoundsFrame = std::numeric_limits<unsigned long>::max();
+  this->scene->AddParticleEmitter(this);
   igndbg << "Particle emitter initialized" << std::endl;
 }
+
+//////////////////////////////////////////////////
+bool Ogre2ParticleEmitter::ParticleWorldBounds(
+    Ogre::AxisAlignedBox &_box) const
+{
+  if (!this->dataPtr->ps || this->dataPtr->culled)
+    return false;
+
+  auto engine = Ogre2RenderEngine::Instance();
+  unsigned long frame = engine->OgreRoot()->getNextFrameNumber();
+  if (frame != this->dataPtr->worldBoundsFrame)
+  {
+    this->dataPtr->worldBoundsFrame = frame;
+    this->dataPtr->worldBoundsValid = false;
+    if (this->dataPtr->ps->getNumParticles() > 0u)
+    {
+      Ogre::Aabb aabb = this->dataPtr->ps->getWorldAabbUpdated();
+      if (!std::isinf(aabb.getMinimum().length()) &&
+          !std::isinf(aabb.getMaximum().length()))
+      {
+        this->dataPtr->worldBounds = Ogre::AxisAlignedBox(aabb.getMinimum(),
+            aabb.getMaximum());
+        this->dataPtr->worldBoundsValid = true;
+      }
+    }
+  }
+
+  _box = this->dataPtr->worldBounds;
+  return this->dataPtr->worldBoundsValid;
+}
+
+//////////////////////////////////////////////////
+void Ogre2ParticleEmitter::SetSortingEnabled(bool _enabled)
+{
+  this->dataPtr->sortingEnabled = _enabled;
+  if (this->dataPtr->ps)
+    this->dataPtr->ps->setSortingEnabled(_enabled);
+}
+
+//////////////////////////////////////////////////
+bool Ogre2ParticleEmitter::SortingEnabled() const
+{
+  return this->dataPtr->sortingEnabled;
+}
+
+//////////////////////////////////////////////////
+void Ogre2ParticleEmitter::SetUpdateInterval(double _interval)
+{
+  // Sanity check: The interval should be non-negative.
+  if (_interval < 0)
+  {
+    ignerr << "SetUpdateInterval() error: Invalid interval [" << _interval
+           << "]. The interval should be non-negative." << std::endl;
+    return;
+  }
+
+  this->dataPtr->updateInterval = _interval;
+  if (this->dataPtr->ps)
+  {
+    this->dataPtr->ps->setIterationInterval(
+        static_cast<Ogre::Real>(_interval));
+  }
+}
+
+//////////////////////////////////////////////////
+double Ogre2ParticleEmitter::UpdateInterval() const
+{
+  return this->dataPtr->updateInterval;
+}
+
+//////////////////////////////////////////////////
+void Ogre2ParticleEmitter::SetCulled(bool _culled)
+{
+  if (this->dataPtr->culled == _culled)
+    return;
+
+  this->dataPtr->culled = _culled;
+  if (!this->dataPtr->ps)
+    return;
+
+  if (_culled)
+    this->ogreNode->detachObject(this->dataPtr->ps);
+  else
+    this->ogreNode->attachObject(this->dataPtr->ps);
+}
+
+//////////////////////////////////////////////////
+bool Ogre2ParticleEmitter::Culled() const
+{
+  return this->dataPtr->culled;
+}
+
+//////////////////////////////////////////////////
+void Ogre2ParticleEmitter::SetRateScale(double _scale)
+{
+  _scale = ignition::math::clamp(_scale, 0.0, 1.0);
+  if (ignition::math::equal(_scale, this->dataPtr->rateScale))
+    return;
+
+  this->dataPtr->rateScale = _scale;
+  if (this->dataPtr->emitter)
+    this->dataPtr->emitter->setEmissionRate(this->rate * _scale);
+}
+
+//////////////////////////////////////////////////
+double Ogre2ParticleEmitter::RateScale() const
+{
+  return this->dataPtr->rateScale;
+}
+
+//////////////////////////////////////////////////
+double Ogre2ParticleEmitter::ReachRadius() const
+{
+  // particles start inside the emitter, travel at most at the max velocity
+  // and both their width and height grow by the scale rate every second
+  double speed = std::max(std::abs(this->minVelocity),
+      std::abs(this->maxVelocity));
+  double particleRadius = (this->particleSize.Length() +
+      IGN_SQRT2 * this->scaleRate * this->lifetime) * 0.5;
+  return this->emitterSize.Length() * 0.5 + speed * this->lifetime +
+      particleRadius;
+}
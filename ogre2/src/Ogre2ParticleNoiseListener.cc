@@ -50,68 +50,30 @@ void Ogre2ParticleNoiseListener::preRenderTargetUpdate(
   // bounding box
   // \todo(anyone) noise std dev is set based on the first particle emitter the
   // sensor sees. Make this scale to multiple particle emitters!
-  auto itor = this->scene->OgreSceneManager()->getMovableObjectIterator(
-      Ogre::ParticleSystemFactory::FACTORY_TYPE_NAME);
-  while (itor.hasMoreElements())
+  // Only the particle emitters registered with the scene are checked, their
+  // bounds are computed once per frame and shared by all sensors.
+  for (Ogre2ParticleEmitter *emitter : this->scene->ParticleEmitters())
   {
-    Ogre::MovableObject *object = itor.peekNext();
-    Ogre::ParticleSystem *ps = dynamic_cast<Ogre::ParticleSystem *>(object);
-
-    if (!ps)
-    {
-      itor.moveNext();
-      continue;
-    }
-
-    Ogre::Aabb aabb = ps->getWorldAabbUpdated();
-    if (std::isinf(aabb.getMinimum().length()) ||
-        std::isinf(aabb.getMaximum().length()))
+    Ogre::AxisAlignedBox box;
+    if (!emitter->ParticleWorldBounds(box) ||
+        !this->ogreCamera->isVisible(box))
     {
-      itor.moveNext();
       continue;
     }
 
-    Ogre::AxisAlignedBox box = Ogre::AxisAlignedBox(aabb.getMinimum(),
-        aabb.getMaximum());
+    // set stddev to half of size of particle emitter aabb
+    auto hs = box.getHalfSize() * 0.5;
+    double particleStddev = hs.x;
 
+    Ogre::Pass *pass = this->ogreMaterial->getTechnique(0)->getPass(0);
+    Ogre::GpuProgramParametersSharedPtr psParams =
+        pass->getFragmentProgramParameters();
+    psParams->setNamedConstant("particleStddev",
+        static_cast<float>(particleStddev));
 
-    if (this->ogreCamera->isVisible(box))
-    {
-      // set stddev to half of size of particle emitter aabb
-      auto hs = box.getHalfSize() * 0.5;
-      double particleStddev = hs.x;
-
-      Ogre::Pass *pass = this->ogreMaterial->getTechnique(0)->getPass(0);
-      Ogre::GpuProgramParametersSharedPtr psParams =
-          pass->getFragmentProgramParameters();
-      psParams->setNamedConstant("particleStddev",
-          static_cast<float>(particleStddev));
-
-      // get particle scatter ratio value from particle emitter user data
-      // and pass that to the shaders
-      float scatterRatio = 0.65f;
-      Ogre::Any userAny = ps->getUserObjectBindings().getUserAny();
-      if (!userAny.isEmpty() && userAny.getType() == typeid(unsigned int))
-      {
-        VisualPtr result;
-        try
-        {
-          result = this->scene->VisualById(
-              Ogre::any_cast<unsigned int>(userAny));
-        }
-        catch(Ogre::Exception &e)
-        {
-          ignerr << "Ogre Error:" << e.getFullDescription() << "\n";
-        }
-        Ogre2ParticleEmitterPtr emitterPtr =
-          std::dynamic_pointer_cast<Ogre2ParticleEmitter>(result);
-        if (emitterPtr)
-          scatterRatio = emitterPtr->ParticleScatterRatio();
-      }
-      psParams->setNamedConstant("particleScatterRatio", scatterRatio);
-
-      return;
-    }
-    itor.moveNext();
+    // pass the particle scatter ratio of the emitter to the shaders
+    psParams->setNamedConstant("particleScatterRatio",
+        emitter->ParticleScatterRatio());
+    return;
   }
 }
@@ -0,0 +1,417 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/math/Helpers.hh>
+
+#include "ignition/rendering/ogre2/Ogre2Material.hh"
+#include "ignition/rendering/ogre2/Ogre2ParticleEmitter.hh"
+#include "ignition/rendering/ogre2/Ogre2PointCloudVisual.hh"
+#include "ignition/rendering/ogre2/Ogre2Scene.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <Hlms/Unlit/OgreHlmsUnlitDatablock.h>
+#include <OgreItem.h>
+#include <OgreLodStrategy.h>
+#include <OgreLodStrategyManager.h>
+#include <OgreMesh2.h>
+#include <OgreMeshManager2.h>
+#include <OgreSceneManager.h>
+#include <OgreSceneNode.h>
+#include <OgreSubMesh2.h>
+#include <Vao/OgreVaoManager.h>
+#include <Vao/OgreVertexArrayObject.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+/// \brief A chunk of points uploaded to the GPU
+struct Ogre2PointCloudChunk
+{
+  /// \brief Ogre mesh of the chunk
+  Ogre::MeshPtr mesh;
+
+  /// \brief Ogre item drawing the mesh
+  Ogre::Item *item = nullptr;
+
+  /// \brief Vertex buffer holding the points, shared by all the levels of
+  /// detail
+  Ogre::VertexBufferPacked *vertexBuffer = nullptr;
+
+  /// \brief One vertex array object per level of detail
+  std::vector<Ogre::VertexArrayObject *> vaos;
+
+  /// \brief LOD values of the item, in the space of the LOD strategy.
+  /// The item points to them, so they must outlive it.
+  Ogre::FastArray<Ogre::Real> lodValues;
+
+  /// \brief Number of points the vertex buffer can hold
+  unsigned int capacity = 0u;
+};
+
+class ignition::rendering::Ogre2PointCloudVisualPrivate
+{
+  /// \brief Destroy the ogre objects of a chunk
+  /// \param[in] _chunk Chunk to destroy
+  /// \param[in] _sceneManager Ogre scene manager
+  public: static void DestroyChunk(Ogre2PointCloudChunk &_chunk,
+      Ogre::SceneManager *_sceneManager);
+
+  /// \brief Chunks of the cloud
+  public: std::vector<std::unique_ptr<Ogre2PointCloudChunk>> chunks;
+
+  /// \brief Bit reversed indices of a chunk, indexed by position in the
+  /// vertex buffer
+  public: std::vector<unsigned int> bitReversed;
+
+  /// \brief Vertices of the chunk being uploaded, kept between uploads to
+  /// avoid reallocating them
+  public: std::vector<float> vertices;
+
+  /// \brief Datablock of the chunk items
+  public: Ogre::HlmsDatablock *datablock = nullptr;
+
+  /// \brief The visibility of the visual
+  public: bool visible = true;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+void Ogre2PointCloudVisualPrivate::DestroyChunk(Ogre2PointCloudChunk &_chunk,
+    Ogre::SceneManager *_sceneManager)
+{
+  if (_chunk.item)
+  {
+    _sceneManager->destroyItem(_chunk.item);
+    _chunk.item = nullptr;
+  }
+
+  Ogre::VaoManager *vaoManager =
+      _sceneManager->getDestinationRenderSystem()->getVaoManager();
+  if (vaoManager)
+  {
+    for (auto vao : _chunk.vaos)
+      vaoManager->destroyVertexArrayObject(vao);
+    if (_chunk.vertexBuffer)
+      vaoManager->destroyVertexBuffer(_chunk.vertexBuffer);
+  }
+  _chunk.vaos.clear();
+  _chunk.vertexBuffer = nullptr;
+  _chunk.capacity = 0u;
+
+  if (!_chunk.mesh.isNull())
+  {
+    // the vertex array objects are destroyed above, do not let the submesh
+    // destroy them again
+    Ogre::SubMesh *subMesh = _chunk.mesh->getSubMesh(0);
+    subMesh->mVao[Ogre::VpNormal].clear();
+    subMesh->mVao[Ogre::VpShadow].clear();
+    Ogre::MeshManager::getSingleton().remove(_chunk.mesh->getHandle());
+    _chunk.mesh.setNull();
+  }
+}
+
+//////////////////////////////////////////////////
+Ogre2PointCloudVisual::Ogre2PointCloudVisual()
+  : dataPtr(new Ogre2PointCloudVisualPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+Ogre2PointCloudVisual::~Ogre2PointCloudVisual()
+{
+  // no ops
+}
+
+//////////////////////////////////////////////////
+void Ogre2PointCloudVisual::Init()
+{
+  BasePointCloudVisual::Init();
+
+  MaterialPtr mat = this->Scene()->Material("Default/White");
+  if (mat)
+    this->SetMaterial(mat, false);
+}
+
+//////////////////////////////////////////////////
+void Ogre2PointCloudVisual::Destroy()
+{
+  this->DestroyChunks();
+  this->points.clear();
+  this->dirtyChunks.clear();
+  BasePointCloudVisual::Destroy();
+}
+
+//////////////////////////////////////////////////
+void Ogre2PointCloudVisual::DestroyChunks()
+{
+  if (!this->scene->IsInitialized())
+    return;
+
+  Ogre::SceneManager *sceneManager = this->scene->OgreSceneManager();
+  for (auto &chunk : this->dataPtr->chunks)
+  {
+    if (chunk)
+      Ogre2PointCloudVisualPrivate::DestroyChunk(*chunk, sceneManager);
+  }
+  this->dataPtr->chunks.clear();
+}
+
+//////////////////////////////////////////////////
+void Ogre2PointCloudVisual::Update()
+{
+  unsigned int chunkCount = this->ChunkCount();
+  Ogre::SceneManager *sceneManager = this->scene->OgreSceneManager();
+
+  // drop the chunks past the end of the cloud
+  while (this->dataPtr->chunks.size() > chunkCount)
+  {
+    if (this->dataPtr->chunks.back())
+    {
+      Ogre2PointCloudVisualPrivate::DestroyChunk(
+          *this->dataPtr->chunks.back(), sceneManager);
+    }
+    this->dataPtr->chunks.pop_back();
+  }
+  this->dataPtr->chunks.resize(chunkCount);
+
+  if (this->dataPtr->bitReversed.size() != this->chunkSize)
+  {
+    unsigned int bits = 0u;
+    while ((1u << bits) < this->chunkSize)
+      ++bits;
+
+    this->dataPtr->bitReversed.resize(this->chunkSize);
+    for (unsigned int i = 0u; i < this->chunkSize; ++i)
+    {
+      unsigned int reversed = 0u;
+      for (unsigned int b = 0u; b < bits; ++b)
+        reversed |= ((i >> b) & 1u) << (bits - 1u - b);
+      this->dataPtr->bitReversed[i] = reversed;
+    }
+  }
+
+  // upload the chunks that changed, at least one per frame
+  unsigned int uploaded = 0u;
+  for (unsigned int i = 0u; i < chunkCount && i < this->dirtyChunks.size();
+      ++i)
+  {
+    if (!this->dirtyChunks[i])
+      continue;
+
+    unsigned int count = std::min(this->chunkSize,
+        this->PointCount() - i * this->chunkSize);
+    if (uploaded > 0u && uploaded + count > this->uploadBudget)
+      break;
+
+    this->UploadChunk(i);
+    this->dirtyChunks[i] = false;
+    uploaded += count;
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2PointCloudVisual::UploadChunk(unsigned int _index)
+{
+  Ogre::SceneManager *sceneManager = this->scene->OgreSceneManager();
+  Ogre::VaoManager *vaoManager =
+      sceneManager->getDestinationRenderSystem()->getVaoManager();
+  if (!vaoManager)
+    return;
+
+  std::unique_ptr<Ogre2PointCloudChunk> &chunk =
+      this->dataPtr->chunks[_index];
+  if (!chunk)
+    chunk.reset(new Ogre2PointCloudChunk);
+
+  unsigned int first = _index * this->chunkSize;
+  unsigned int count = std::min(this->chunkSize, this->PointCount() - first);
+
+  // store the points in bit reversed order, so that the first n points of
+  // the buffer are spread over the whole chunk
+  std::vector<float> &vertices = this->dataPtr->vertices;
+  vertices.resize(static_cast<size_t>(count) * 3u);
+  const float *src = this->points.data() + static_cast<size_t>(first) * 3u;
+  Ogre::Aabb bbox;
+  unsigned int n = 0u;
+  for (unsigned int i = 0u; i < this->chunkSize && n < count; ++i)
+  {
+    unsigned int idx = this->dataPtr->bitReversed[i];
+    if (idx >= count)
+      continue;
+
+    const float *p = src + static_cast<size_t>(idx) * 3u;
+    float *dst = vertices.data() + static_cast<size_t>(n) * 3u;
+    dst[0] = p[0];
+    dst[1] = p[1];
+    dst[2] = p[2];
+    Ogre::Vector3 v(p[0], p[1], p[2]);
+    if (n == 0u)
+      bbox = Ogre::Aabb(v, Ogre::Vector3::ZERO);
+    else
+      bbox.merge(v);
+    ++n;
+  }
+
+  // capacity is a power of two, so points can be added to a chunk without
+  // recreating its buffer every time
+  unsigned int capacity = 256u;
+  while (capacity < count)
+    capacity <<= 1;
+
+  unsigned int levels = 1u;
+  while (levels <= this->lodLevels && (count >> levels) > 0u)
+    ++levels;
+
+  bool recreate = capacity != chunk->capacity ||
+      levels != chunk->vaos.size();
+  if (recreate)
+  {
+    Ogre2PointCloudVisualPrivate::DestroyChunk(*chunk, sceneManager);
+
+    static unsigned int pointCloudChunkId = 0u;
+    chunk->mesh = Ogre::MeshManager::getSingleton().createManual(
+        "point_cloud_chunk_" + std::to_string(pointCloudChunkId++),
+        Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    Ogre::SubMesh *subMesh = chunk->mesh->createSubMesh();
+
+    Ogre::VertexElement2Vec vertexElements;
+    vertexElements.push_back(
+        Ogre::VertexElement2(Ogre::VET_FLOAT3, Ogre::VES_POSITION));
+
+    // the buffer is only written when the chunk changes, keep it in video
+    // memory rather than in a persistently mapped buffer
+    std::vector<float> initialData(static_cast<size_t>(capacity) * 3u, 0.0f);
+    std::copy(vertices.begin(), vertices.end(), initialData.begin());
+    chunk->vertexBuffer = vaoManager->createVertexBuffer(vertexElements,
+        capacity, Ogre::BT_DEFAULT, initialData.data(), false);
+    chunk->capacity = capacity;
+
+    Ogre::VertexBufferPackedVec vertexBuffers;
+    vertexBuffers.push_back(chunk->vertexBuffer);
+    for (unsigned int level = 0u; level < levels; ++level)
+    {
+      Ogre::VertexArrayObject *vao = vaoManager->createVertexArrayObject(
+          vertexBuffers, nullptr, Ogre::OT_POINT_LIST);
+      chunk->vaos.push_back(vao);
+      subMesh->mVao[Ogre::VpNormal].push_back(vao);
+      subMesh->mVao[Ogre::VpShadow].push_back(vao);
+    }
+  }
+  else if (count > 0u)
+  {
+    chunk->vertexBuffer->upload(vertices.data(), 0u, count);
+  }
+
+  // each level draws half of the points of the previous one
+  for (unsigned int level = 0u; level < chunk->vaos.size(); ++level)
+    chunk->vaos[level]->setPrimitiveRange(0u, count >> level);
+
+  // switch to a level when the average spacing of the points of the
+  // previous level on screen gets below the point spacing. The spacing is
+  // estimated as if the points were spread over a disc of the size of the
+  // chunk, seen by a camera with a 60 degree vertical field of view.
+  Ogre::LodStrategy *strategy =
+      Ogre::LodStrategyManager::getSingleton().getDefaultStrategy();
+  double radius = bbox.getRadius();
+  double tanHalfFov = std::tan(IGN_PI / 6.0);
+  double spacing = radius * std::sqrt(IGN_PI / std::max(count, 1u));
+  chunk->lodValues.clear();
+  chunk->lodValues.push_back(strategy->getBaseValue());
+  for (unsigned int level = 1u; level < chunk->vaos.size(); ++level)
+  {
+    double distance = spacing / (2.0 * tanHalfFov * this->pointSpacing);
+    chunk->lodValues.push_back(strategy->transformUserValue(
+        static_cast<Ogre::Real>(distance)));
+    spacing *= IGN_SQRT2;
+  }
+
+  // set the bounds to get frustum culling and LOD to work correctly
+  chunk->mesh->_setBounds(bbox, false);
+
+  if (!chunk->item)
+  {
+    chunk->item = sceneManager->createItem(chunk->mesh, Ogre::SCENE_DYNAMIC);
+    chunk->item->getUserObjectBindings().setUserAny(Ogre::Any(this->Id()));
+    chunk->item->setName(this->Name() + "_chunk_" + std::to_string(_index));
+    chunk->item->setVisibilityFlags(this->visibilityFlags
+        & ~Ogre2ParticleEmitter::kParticleVisibilityFlags);
+    chunk->item->setCastShadows(false);
+    chunk->item->setVisible(this->dataPtr->visible);
+    if (this->dataPtr->datablock)
+      chunk->item->setDatablock(this->dataPtr->datablock);
+    this->ogreNode->attachObject(chunk->item);
+  }
+  else
+  {
+    chunk->item->setLocalAabb(bbox);
+  }
+
+  // point the item to the LOD values of the chunk rather than to the ones
+  // of the mesh, which only has a single level
+  chunk->item->mLodMesh = &chunk->lodValues;
+
+  this->SetBoundsDirty();
+}
+
+//////////////////////////////////////////////////
+void Ogre2PointCloudVisual::SetVisible(bool _visible)
+{
+  this->dataPtr->visible = _visible;
+  BasePointCloudVisual::SetVisible(_visible);
+}
+
+//////////////////////////////////////////////////
+void Ogre2PointCloudVisual::SetMaterial(MaterialPtr _material, bool _unique)
+{
+  if (!_material)
+  {
+    ignerr << "Cannot assign null material" << std::endl;
+    return;
+  }
+
+  _material = (_unique) ? _material->Clone() : _material;
+  Ogre2MaterialPtr derived =
+      std::dynamic_pointer_cast<Ogre2Material>(_material);
+  if (!derived)
+  {
+    ignerr << "Cannot assign material created by another render-engine"
+        << std::endl;
+    return;
+  }
+
+  BasePointCloudVisual::SetMaterial(_material, false);
+
+  // points have no normals, draw them unlit in the diffuse color of the
+  // material
+  this->dataPtr->datablock = derived->UnlitDatablock();
+  for (auto &chunk : this->dataPtr->chunks)
+  {
+    if (chunk && chunk->item)
+      chunk->item->setDatablock(this->dataPtr->datablock);
+  }
+}
@@ -15,21 +15,30 @@
  *
  */
 
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
 #include <ignition/common/Console.hh>
-#include <ignition/common/Mesh.hh>
-#include <ignition/common/MeshManager.hh>
-#include <ignition/common/SubMesh.hh>
 
+#include "ignition/rendering/MeshBvh.hh"
 #include "ignition/rendering/ogre2/Ogre2Camera.hh"
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
+#include "ignition/rendering/ogre2/Ogre2Geometry.hh"
+#include "ignition/rendering/ogre2/Ogre2MeshFactory.hh"
 #include "ignition/rendering/ogre2/Ogre2RayQuery.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
+#include "ignition/rendering/ogre2/Ogre2SelectionBuffer.hh"
 
 #ifdef _MSC_VER
   #pragma warning(push, 0)
 #endif
 #include <OgreCamera.h>
 #include <OgreItem.h>
+#include <OgreMath.h>
 #include <OgreMesh2.h>
 #include <OgreRay.h>
 #include <OgreSceneManager.h>
@@ -42,11 +51,70 @@ class ignition::rendering::Ogre2RayQueryPrivate
 {
   /// \brief Ogre ray scene query object for computing intersection.
   public: Ogre::RaySceneQuery *rayQuery = nullptr;
+
+  /// \brief True to answer rays set from a camera from its selection buffer
+  public: bool useSelectionBuffer = false;
+
+  /// \brief Camera the ray was last set from
+  public: std::weak_ptr<Ogre2Camera> camera;
+
+  /// \brief Normalized device coordinates the ray was last set from
+  public: math::Vector2d coord;
+
+  /// \brief Ray origin computed by the last call to SetFromCamera
+  public: math::Vector3d cameraOrigin;
+
+  /// \brief Ray direction computed by the last call to SetFromCamera
+  public: math::Vector3d cameraDirection;
 };
 
 using namespace ignition;
 using namespace rendering;
 
+//////////////////////////////////////////////////
+/// \brief Get the name of the common::Mesh an ogre item was created from
+/// \param[in] _item Ogre item
+/// \return Mesh name
+static std::string CommonMeshName(const Ogre::Item *_item)
+{
+  // mesh factory creates name with ::CENTER or ::ORIGINAL depending on
+  // the params passed in the MeshDescriptor when loading the mesh
+  // so strip off the suffix
+  std::string meshName = _item->getMesh()->getName();
+  size_t idx = meshName.find("::");
+  if (idx != std::string::npos)
+    meshName = meshName.substr(0, idx);
+  return meshName;
+}
+
+//////////////////////////////////////////////////
+/// \brief Find the closest intersection of a ray with the mesh of an item
+/// \param[in] _scene Scene the item belongs to
+/// \param[in] _item Ogre item
+/// \param[in] _ray Ray in the world frame
+/// \param[out] _distance Ray parameter of the intersection
+/// \return True if the ray hits the item
+static bool IntersectItem(const Ogre2ScenePtr &_scene, Ogre::Item *_item,
+    const Ogre::Ray &_ray, double &_distance)
+{
+  std::shared_ptr<const MeshBvh> bvh =
+      _scene->MeshFactory()->Bvh(CommonMeshName(_item));
+  if (!bvh)
+    return false;
+
+  // transform the ray to the mesh frame. The direction is not
+  // normalized so that distances along the ray are the same in both
+  // frames.
+  Ogre::Matrix4 invTransform =
+      _item->_getParentNodeFullTransform().inverseAffine();
+  math::Vector3d localOrigin = Ogre2Conversions::Convert(
+      invTransform * _ray.getOrigin());
+  math::Vector3d localDir = Ogre2Conversions::Convert(
+      invTransform.transformDirectionAffine(_ray.getDirection()));
+
+  return bvh->Intersect(localOrigin, localDir, _distance);
+}
+
 //////////////////////////////////////////////////
 Ogre2RayQuery::Ogre2RayQuery()
     : dataPtr(new Ogre2RayQueryPrivate)
@@ -70,17 +138,116 @@ void Ogre2RayQuery::SetFromCamera(const CameraPtr &_camera,
 
   this->origin = Ogre2Conversions::Convert(ray.getOrigin());
   this->direction = Ogre2Conversions::Convert(ray.getDirection());
+
+  this->dataPtr->camera = camera;
+  this->dataPtr->coord = _coord;
+  this->dataPtr->cameraOrigin = this->origin;
+  this->dataPtr->cameraDirection = this->direction;
+  if (this->dataPtr->useSelectionBuffer)
+    camera->SetSelectionFrameEnabled(true);
+}
+
+//////////////////////////////////////////////////
+void Ogre2RayQuery::SetUseSelectionBuffer(bool _enabled)
+{
+  this->dataPtr->useSelectionBuffer = _enabled;
+
+  Ogre2CameraPtr camera = this->dataPtr->camera.lock();
+  if (_enabled && camera)
+    camera->SetSelectionFrameEnabled(true);
+}
+
+//////////////////////////////////////////////////
+bool Ogre2RayQuery::UseSelectionBuffer() const
+{
+  return this->dataPtr->useSelectionBuffer;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2RayQuery::ClosestPointFromSelectionBuffer(RayQueryResult &_result)
+{
+  if (!this->dataPtr->useSelectionBuffer)
+    return false;
+
+  // only rays that have not changed since SetFromCamera match a pixel
+  if (this->origin != this->dataPtr->cameraOrigin ||
+      this->direction != this->dataPtr->cameraDirection)
+    return false;
+
+  Ogre2CameraPtr camera = this->dataPtr->camera.lock();
+  if (!camera || !camera->selectionBuffer ||
+      !camera->selectionBuffer->FrameValid())
+    return false;
+
+  const Ogre2ScenePtr &ogreScene = this->scene;
+  if (!ogreScene)
+    return false;
+
+  // pixel the ray goes through
+  Ogre2SelectionBuffer *buffer = camera->selectionBuffer;
+  int x = static_cast<int>((this->dataPtr->coord.X() + 1.0) / 2.0 *
+      buffer->FrameWidth());
+  int y = static_cast<int>((1.0 - this->dataPtr->coord.Y()) / 2.0 *
+      buffer->FrameHeight());
+  x = std::max(0, std::min(x, static_cast<int>(buffer->FrameWidth()) - 1));
+  y = std::max(0, std::min(y, static_cast<int>(buffer->FrameHeight()) - 1));
+
+  unsigned int id = buffer->FrameVisualIdAt(x, y);
+  if (id == 0u)
+  {
+    // nothing selectable is seen through this pixel
+    _result = RayQueryResult();
+    return true;
+  }
+
+  VisualPtr visual = ogreScene->VisualById(id);
+  if (!visual)
+    return false;
+
+  Ogre::Ray ray(Ogre2Conversions::Convert(this->origin),
+      Ogre2Conversions::Convert(this->direction));
+  double distance = -1.0;
+  visual->ForEachGeometry([&](Geometry &_geometry)
+  {
+    auto geometry = dynamic_cast<Ogre2Geometry *>(&_geometry);
+    if (!geometry)
+      return;
+
+    Ogre::MovableObject *ogreObj = geometry->OgreObject();
+    if (!ogreObj || ogreObj->getMovableType() != "Item")
+      return;
+
+    double hitDistance;
+    if (IntersectItem(ogreScene, static_cast<Ogre::Item *>(ogreObj), ray,
+        hitDistance) && (distance < 0.0 || hitDistance < distance))
+    {
+      distance = hitDistance;
+    }
+  });
+
+  // the ray can miss the visual near its silhouette since pixels are
+  // coarser than rays
+  if (distance < 0.0)
+    return false;
+
+  _result.distance = distance;
+  _result.point = Ogre2Conversions::Convert(
+      ray.getPoint(static_cast<Ogre::Real>(distance)));
+  _result.objectId = id;
+  return true;
 }
 
 //////////////////////////////////////////////////
 RayQueryResult Ogre2RayQuery::ClosestPoint()
 {
   RayQueryResult result;
-  Ogre2ScenePtr ogreScene =
-      std::dynamic_pointer_cast<Ogre2Scene>(this->Scene());
+  const Ogre2ScenePtr &ogreScene = this->scene;
   if (!ogreScene)
     return result;
 
+  if (this->ClosestPointFromSelectionBuffer(result))
+    return result;
+
   Ogre::Ray mouseRay(Ogre2Conversions::Convert(this->origin),
       Ogre2Conversions::Convert(this->direction));
 
@@ -103,6 +270,11 @@ RayQueryResult Ogre2RayQuery::ClosestPoint()
     if (iter->distance <= 0.0)
       continue;
 
+    // results are sorted by distance to the bounding boxes, so no object
+    // further down the list can be hit before the closest hit so far
+    if (distance >= 0.0 && iter->distance > distance)
+      break;
+
     if (!iter->movable || !iter->movable->getVisible())
       continue;
 
@@ -112,69 +284,162 @@ RayQueryResult Ogre2RayQuery::ClosestPoint()
     {
       Ogre::Item *ogreItem = static_cast<Ogre::Item *>(iter->movable);
 
-      // mesh factory creates name with ::CENTER or ::ORIGINAL depending on
-      // the params passed in the MeshDescriptor when loading the mesh
-      // so strip off the suffix
-      std::string meshName = ogreItem->getMesh()->getName();
-      size_t idx = meshName.find("::");
-      if (idx != std::string::npos)
-        meshName = meshName.substr(0, idx);
+      double hitDistance;
+      if (IntersectItem(ogreScene, ogreItem, mouseRay, hitDistance) &&
+          (distance < 0.0 || hitDistance < distance))
+      {
+        // this is the closest so far, save it off
+        distance = hitDistance;
+        result.distance = distance;
+        result.point = Ogre2Conversions::Convert(
+            mouseRay.getPoint(static_cast<Ogre::Real>(distance)));
+        result.objectId = Ogre::any_cast<unsigned int>(userAny);
+      }
+    }
+  }
+
+  return result;
+}
+
+//////////////////////////////////////////////////
+std::vector<RayQueryResult> Ogre2RayQuery::ClosestPoints(
+    const std::vector<math::Vector3d> &_origins,
+    const std::vector<math::Vector3d> &_directions)
+{
+  std::vector<RayQueryResult> results;
+  if (!this->ValidateRays(_origins, _directions))
+    return results;
+  results.resize(_origins.size());
+
+  const Ogre2ScenePtr &ogreScene = this->scene;
+  if (!ogreScene)
+    return results;
+
+  /// \brief An item that can be hit by the rays
+  struct Candidate
+  {
+    /// \brief World bounding box of the item
+    Ogre::AxisAlignedBox box;
+
+    /// \brief Transform from the world frame to the mesh frame
+    Ogre::Matrix4 invTransform;
+
+    /// \brief Bounding volume hierarchy of the mesh
+    std::shared_ptr<const MeshBvh> bvh;
+
+    /// \brief Id of the visual the item belongs to
+    unsigned int objectId;
+  };
+
+  // collect the items once for the whole batch. This also builds the
+  // bounding volume hierarchies of the meshes that have none yet, so the
+  // rays only read shared data and can be evaluated in parallel
+  std::vector<Candidate> candidates;
+  auto itor = ogreScene->OgreSceneManager()->getMovableObjectIterator(
+      Ogre::ItemFactory::FACTORY_TYPE_NAME);
+  while (itor.hasMoreElements())
+  {
+    Ogre::Item *ogreItem = static_cast<Ogre::Item *>(itor.getNext());
+    if (!ogreItem->isAttached() || !ogreItem->getVisible())
+      continue;
+
+    auto userAny = ogreItem->getUserObjectBindings().getUserAny();
+    if (userAny.isEmpty() || userAny.getType() != typeid(unsigned int))
+      continue;
+
+    std::shared_ptr<const MeshBvh> bvh =
+        ogreScene->MeshFactory()->Bvh(CommonMeshName(ogreItem));
+    if (!bvh || bvh->TriangleCount() == 0u)
+      continue;
 
-      const common::Mesh *mesh =
-           common::MeshManager::Instance()->MeshByName(meshName);
+    Ogre::Aabb aabb = ogreItem->getWorldAabbUpdated();
+    Candidate candidate;
+    candidate.box = Ogre::AxisAlignedBox(aabb.getMinimum(),
+        aabb.getMaximum());
+    candidate.invTransform =
+        ogreItem->getParentNode()->_getFullTransformUpdated().inverseAffine();
+    candidate.bvh = bvh;
+    candidate.objectId = Ogre::any_cast<unsigned int>(userAny);
+    candidates.push_back(candidate);
+  }
 
-      if (!mesh)
-        continue;
+  if (candidates.empty())
+    return results;
 
-      Ogre::Matrix4 transform = ogreItem->_getParentNodeFullTransform();
+  // compute the closest intersection of the rays in [_start, _end)
+  auto intersect = [&](size_t _start, size_t _end)
+  {
+    std::vector<std::pair<Ogre::Real, const Candidate *>> boxHits;
+    for (size_t i = _start; i < _end; ++i)
+    {
+      Ogre::Ray ray(Ogre2Conversions::Convert(_origins[i]),
+          Ogre2Conversions::Convert(_directions[i]));
 
-      // test for hitting individual triangles on the mesh
-      for (unsigned int j = 0; j < mesh->SubMeshCount(); ++j)
+      boxHits.clear();
+      for (const auto &candidate : candidates)
       {
-        auto s = mesh->SubMeshByIndex(j);
-        auto submesh = s.lock();
-        if (!submesh || submesh->VertexCount() < 3u)
-          continue;
-        unsigned int indexCount = submesh->IndexCount();
-        for (unsigned int k = 0; k < indexCount; k += 3)
-        {
-          if (indexCount <= k+2)
-            continue;
-
-          ignition::math::Vector3d vertexA =
-            submesh->Vertex(submesh->Index(k));
-          ignition::math::Vector3d vertexB =
-            submesh->Vertex(submesh->Index(k+1));
-          ignition::math::Vector3d vertexC =
-            submesh->Vertex(submesh->Index(k+2));
-
-          Ogre::Vector3 worldVertexA =
-              transform * Ogre2Conversions::Convert(vertexA);
-          Ogre::Vector3 worldVertexB =
-              transform * Ogre2Conversions::Convert(vertexB);
-          Ogre::Vector3 worldVertexC =
-              transform * Ogre2Conversions::Convert(vertexC);
-
-          // check for a hit against this triangle
-          std::pair<bool, Ogre::Real> hit = Ogre::Math::intersects(mouseRay,
-              worldVertexA, worldVertexB, worldVertexC,
-              true, false);
-
-          // if it was a hit check if its the closest
-          if (hit.first &&
-              (distance < 0.0f || hit.second < distance))
+        std::pair<bool, Ogre::Real> hit =
+            Ogre::Math::intersects(ray, candidate.box);
+        if (hit.first)
+          boxHits.emplace_back(hit.second, &candidate);
+      }
+      std::sort(boxHits.begin(), boxHits.end(),
+          [](const std::pair<Ogre::Real, const Candidate *> &_a,
+             const std::pair<Ogre::Real, const Candidate *> &_b)
           {
-            // this is the closest so far, save it off
-            distance = hit.second;
-            result.distance = distance;
-            result.point =
-                Ogre2Conversions::Convert(mouseRay.getPoint(distance));
-            result.objectId = Ogre::any_cast<unsigned int>(userAny);
-          }
+            return _a.first < _b.first;
+          });
+
+      double distance = -1.0;
+      for (const auto &boxHit : boxHits)
+      {
+        // no remaining item can be hit before the closest hit so far
+        if (distance >= 0.0 && boxHit.first > distance)
+          break;
+
+        const Candidate *candidate = boxHit.second;
+        math::Vector3d localOrigin = Ogre2Conversions::Convert(
+            candidate->invTransform * ray.getOrigin());
+        math::Vector3d localDir = Ogre2Conversions::Convert(
+            candidate->invTransform.transformDirectionAffine(
+            ray.getDirection()));
+
+        double hitDistance;
+        if (candidate->bvh->Intersect(localOrigin, localDir, hitDistance) &&
+            (distance < 0.0 || hitDistance < distance))
+        {
+          distance = hitDistance;
+          results[i].distance = distance;
+          results[i].point = _origins[i] + _directions[i] * distance;
+          results[i].objectId = candidate->objectId;
         }
       }
     }
+  };
+
+  // only spread the work across threads when there is enough of it to
+  // make up for the cost of starting them
+  const size_t minRaysPerThread = 256u;
+  size_t threadCount = std::min<size_t>(
+      std::max(1u, std::thread::hardware_concurrency()),
+      _origins.size() / minRaysPerThread);
+  if (threadCount <= 1u)
+  {
+    intersect(0u, _origins.size());
+  }
+  else
+  {
+    size_t chunk = (_origins.size() + threadCount - 1u) / threadCount;
+    std::vector<std::thread> threads;
+    for (size_t t = 1u; t < threadCount; ++t)
+    {
+      threads.emplace_back(intersect, t * chunk,
+          std::min(_origins.size(), (t + 1u) * chunk));
+    }
+    intersect(0u, chunk);
+    for (auto &thread : threads)
+      thread.join();
   }
 
-  return result;
+  return results;
 }
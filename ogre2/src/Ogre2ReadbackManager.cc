@@ -0,0 +1,471 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Not Apple or Windows
+#if !defined(__APPLE__) && !defined(_WIN32)
+# ifndef GL_GLEXT_PROTOTYPES
+#  define GL_GLEXT_PROTOTYPES
+# endif
+# include <GL/gl.h>
+# include <GL/glext.h>
+# define IGN_OGRE2_ASYNC_READBACK 1
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/Profiler.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+
+#include "Ogre2ReadbackManager.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+Ogre2ReadbackManager::~Ogre2ReadbackManager()
+{
+  this->Reset();
+}
+
+//////////////////////////////////////////////////
+bool Ogre2ReadbackManager::AsyncSupported()
+{
+#ifdef IGN_OGRE2_ASYNC_READBACK
+  auto engine = Ogre2RenderEngine::Instance();
+  if (!engine->IsInitialized() || !engine->OgreRoot())
+    return false;
+  Ogre::RenderSystem *renderSys = engine->OgreRoot()->getRenderSystem();
+  return renderSys &&
+      renderSys->getName().find("OpenGL 3+") != std::string::npos;
+#else
+  return false;
+#endif
+}
+
+//////////////////////////////////////////////////
+void Ogre2ReadbackManager::Read(Ogre::RenderTarget *_target,
+    const Ogre::PixelBox &_dst)
+{
+  IGN_RENDERING_PROFILE("Ogre2ReadbackManager::Read");
+  if (!_target)
+    return;
+
+  // blit data from gpu to cpu
+  _target->copyContentsToMemory(_dst, Ogre::RenderTarget::FB_AUTO);
+}
+
+//////////////////////////////////////////////////
+bool Ogre2ReadbackManager::ReadRegion(Ogre::Texture *_texture,
+    const Ogre::Box &_src, const Ogre::PixelBox &_dst)
+{
+  IGN_RENDERING_PROFILE("Ogre2ReadbackManager::ReadRegion");
+  if (!_texture || _src.getWidth() != _dst.getWidth() ||
+      _src.getHeight() != _dst.getHeight() ||
+      _src.right > _texture->getWidth() ||
+      _src.bottom > _texture->getHeight())
+  {
+    return false;
+  }
+
+#ifdef IGN_OGRE2_ASYNC_READBACK
+  GLenum glFormat;
+  GLenum glType;
+  GLuint textureId = 0u;
+  if (AsyncSupported() && _texture->getTextureType() == Ogre::TEX_TYPE_2D &&
+      GLFormat(_dst.format, glFormat, glType))
+  {
+    _texture->getCustomAttribute("GLID", &textureId);
+  }
+
+  if (textureId != 0u)
+  {
+    if (this->readFramebuffer == 0u)
+    {
+      GLuint framebuffer = 0u;
+      glGenFramebuffers(1, &framebuffer);
+      this->readFramebuffer = framebuffer;
+    }
+
+    // save the GL states modified below so ogre's state cache remains valid
+    GLint prevFramebuffer = 0;
+    GLint prevPack = 0;
+    GLint prevAlignment = 4;
+    GLint prevRowLength = 0;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &prevFramebuffer);
+    glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &prevPack);
+    glGetIntegerv(GL_PACK_ALIGNMENT, &prevAlignment);
+    glGetIntegerv(GL_PACK_ROW_LENGTH, &prevRowLength);
+
+    // texel rows are in the same order as the rows returned by Read, so
+    // the region needs no flip
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, this->readFramebuffer);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+        GL_TEXTURE_2D, textureId, 0);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0u);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glPixelStorei(GL_PACK_ROW_LENGTH, static_cast<GLint>(_dst.rowPitch));
+    glReadPixels(static_cast<GLint>(_src.left),
+        static_cast<GLint>(_src.top),
+        static_cast<GLsizei>(_src.getWidth()),
+        static_cast<GLsizei>(_src.getHeight()), glFormat, glType,
+        _dst.data);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+        GL_TEXTURE_2D, 0u, 0);
+
+    glPixelStorei(GL_PACK_ROW_LENGTH, prevRowLength);
+    glPixelStorei(GL_PACK_ALIGNMENT, prevAlignment);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, prevPack);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, prevFramebuffer);
+    return true;
+  }
+#endif
+
+  // the pixel buffer downloads the whole texture and crops it
+  _texture->getBuffer()->blitToMemory(_src, _dst);
+  return true;
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2ReadbackManager::CreateClient(unsigned int _maxInFlight)
+{
+  if (!AsyncSupported())
+    return 0u;
+
+  unsigned int id = ++this->clientCounter;
+  this->clients[id] = std::max(2u, _maxInFlight);
+  return id;
+}
+
+//////////////////////////////////////////////////
+void Ogre2ReadbackManager::DestroyClient(unsigned int _client)
+{
+  this->clients.erase(_client);
+
+  for (auto it = this->tickets.begin(); it != this->tickets.end();)
+  {
+    if (it->client != _client)
+    {
+      ++it;
+      continue;
+    }
+#ifdef IGN_OGRE2_ASYNC_READBACK
+    if (it->fence)
+      glDeleteSync(static_cast<GLsync>(it->fence));
+#endif
+    this->freeBuffers.emplace(it->size, it->buffer);
+    it = this->tickets.erase(it);
+  }
+}
+
+//////////////////////////////////////////////////
+bool Ogre2ReadbackManager::GLFormat(Ogre::PixelFormat _format,
+    unsigned int &_glFormat, unsigned int &_glType)
+{
+#ifdef IGN_OGRE2_ASYNC_READBACK
+  // Formats must match the memory layout produced by
+  // RenderTarget::copyContentsToMemory so the async and blocking code paths
+  // deliver identical data
+  switch (_format)
+  {
+    case Ogre::PF_FLOAT32_RGBA:
+      _glFormat = GL_RGBA;
+      _glType = GL_FLOAT;
+      return true;
+    case Ogre::PF_FLOAT32_RGB:
+      _glFormat = GL_RGB;
+      _glType = GL_FLOAT;
+      return true;
+    case Ogre::PF_FLOAT32_R:
+      _glFormat = GL_RED;
+      _glType = GL_FLOAT;
+      return true;
+    case Ogre::PF_L8:
+      _glFormat = GL_RED;
+      _glType = GL_UNSIGNED_BYTE;
+      return true;
+    case Ogre::PF_L16:
+      _glFormat = GL_RED;
+      _glType = GL_UNSIGNED_SHORT;
+      return true;
+    case Ogre::PF_FLOAT16_R:
+      _glFormat = GL_RED;
+      _glType = GL_HALF_FLOAT;
+      return true;
+    case Ogre::PF_FLOAT16_GR:
+      _glFormat = GL_RG;
+      _glType = GL_HALF_FLOAT;
+      return true;
+    case Ogre::PF_SHORT_GR:
+      _glFormat = GL_RG;
+      _glType = GL_UNSIGNED_SHORT;
+      return true;
+    case Ogre::PF_R8G8B8:
+      _glFormat = GL_BGR;
+      _glType = GL_UNSIGNED_BYTE;
+      return true;
+    case Ogre::PF_B8G8R8:
+      _glFormat = GL_RGB;
+      _glType = GL_UNSIGNED_BYTE;
+      return true;
+    default:
+      return false;
+  }
+#else
+  (void)_format;
+  (void)_glFormat;
+  (void)_glType;
+  return false;
+#endif
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2ReadbackManager::AcquireBuffer(size_t _size)
+{
+  auto it = this->freeBuffers.find(_size);
+  if (it != this->freeBuffers.end())
+  {
+    unsigned int buffer = it->second;
+    this->freeBuffers.erase(it);
+    return buffer;
+  }
+
+#ifdef IGN_OGRE2_ASYNC_READBACK
+  GLuint buffer = 0u;
+  GLint prevPack = 0;
+  glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &prevPack);
+  glGenBuffers(1, &buffer);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+  glBufferData(GL_PIXEL_PACK_BUFFER, _size, nullptr, GL_STREAM_READ);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, prevPack);
+  return buffer;
+#else
+  return 0u;
+#endif
+}
+
+//////////////////////////////////////////////////
+bool Ogre2ReadbackManager::Request(unsigned int _client,
+    Ogre::Texture *_texture, Ogre::PixelFormat _format)
+{
+  IGN_RENDERING_PROFILE("Ogre2ReadbackManager::Request");
+#ifdef IGN_OGRE2_ASYNC_READBACK
+  auto clientIt = this->clients.find(_client);
+  if (clientIt == this->clients.end())
+    return false;
+
+  if (!_texture || _texture->getTextureType() != Ogre::TEX_TYPE_2D)
+    return false;
+
+  GLenum glFormat;
+  GLenum glType;
+  if (!GLFormat(_format, glFormat, glType))
+    return false;
+
+  GLuint textureId = 0u;
+  _texture->getCustomAttribute("GLID", &textureId);
+  if (textureId == 0u)
+    return false;
+
+  // all requests of this client are in flight, it must retrieve data first
+  if (this->PendingCount(_client) >= clientIt->second)
+    return false;
+
+  Ticket ticket;
+  ticket.client = _client;
+  ticket.size = Ogre::PixelUtil::getMemorySize(_texture->getWidth(),
+      _texture->getHeight(), 1u, _format);
+  ticket.buffer = this->AcquireBuffer(ticket.size);
+
+  // save the GL states modified below so ogre's state cache remains valid
+  GLint prevPack = 0;
+  GLint prevTexture = 0;
+  GLint prevAlignment = 4;
+  glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &prevPack);
+  glGetIntegerv(GL_TEXTURE_BINDING_2D, &prevTexture);
+  glGetIntegerv(GL_PACK_ALIGNMENT, &prevAlignment);
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, ticket.buffer);
+  glBindTexture(GL_TEXTURE_2D, textureId);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  // with a pack buffer bound the last argument is an offset into the buffer
+  // and the call returns without waiting for the gpu
+  glGetTexImage(GL_TEXTURE_2D, 0, glFormat, glType, nullptr);
+  ticket.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+  glPixelStorei(GL_PACK_ALIGNMENT, prevAlignment);
+  glBindTexture(GL_TEXTURE_2D, prevTexture);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, prevPack);
+
+  this->tickets.push_back(ticket);
+  return true;
+#else
+  (void)_client;
+  (void)_texture;
+  (void)_format;
+  return false;
+#endif
+}
+
+//////////////////////////////////////////////////
+void Ogre2ReadbackManager::Update()
+{
+#ifdef IGN_OGRE2_ASYNC_READBACK
+  bool flush = true;
+  for (auto &ticket : this->tickets)
+  {
+    if (ticket.complete)
+      continue;
+
+    GLsync fence = static_cast<GLsync>(ticket.fence);
+    GLenum status = glClientWaitSync(fence,
+        flush ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, 0u);
+    flush = false;
+
+    // fences are signaled in order so the remaining ones are still pending
+    if (status == GL_TIMEOUT_EXPIRED)
+      break;
+
+    glDeleteSync(fence);
+    ticket.fence = nullptr;
+    ticket.complete = true;
+  }
+#endif
+}
+
+//////////////////////////////////////////////////
+bool Ogre2ReadbackManager::Retrieve(unsigned int _client, void *_dst,
+    size_t _size)
+{
+  IGN_RENDERING_PROFILE("Ogre2ReadbackManager::Retrieve");
+#ifdef IGN_OGRE2_ASYNC_READBACK
+  auto clientIt = this->clients.find(_client);
+  if (clientIt == this->clients.end() || !_dst)
+    return false;
+
+  // never wait on the most recent request
+  unsigned int pendingCount = this->PendingCount(_client);
+  if (pendingCount < 2u)
+    return false;
+
+  this->Update();
+
+  auto it = std::find_if(this->tickets.begin(), this->tickets.end(),
+      [&](const Ticket &_ticket) { return _ticket.client == _client; });
+
+  // only block if all requests are in flight, otherwise try again next frame
+  if (!it->complete)
+  {
+    if (pendingCount < clientIt->second)
+      return false;
+
+    GLsync fence = static_cast<GLsync>(it->fence);
+    GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+        1000000000u);
+    while (status == GL_TIMEOUT_EXPIRED)
+      status = glClientWaitSync(fence, 0, 1000000000u);
+    glDeleteSync(fence);
+    it->fence = nullptr;
+    it->complete = true;
+
+    if (status == GL_WAIT_FAILED)
+    {
+      ignerr << "Failed to wait for GPU readback" << std::endl;
+      this->freeBuffers.emplace(it->size, it->buffer);
+      this->tickets.erase(it);
+      return false;
+    }
+  }
+
+  Ticket ticket = *it;
+  this->tickets.erase(it);
+
+  if (_size < ticket.size)
+  {
+    ignerr << "Readback destination buffer is too small" << std::endl;
+    this->freeBuffers.emplace(ticket.size, ticket.buffer);
+    return false;
+  }
+
+  return this->CopyAndRelease(ticket.buffer, ticket.size, _dst);
+#else
+  (void)_client;
+  (void)_dst;
+  (void)_size;
+  return false;
+#endif
+}
+
+//////////////////////////////////////////////////
+bool Ogre2ReadbackManager::CopyAndRelease(unsigned int _buffer,
+    size_t _size, void *_dst)
+{
+  bool result = false;
+#ifdef IGN_OGRE2_ASYNC_READBACK
+  GLint prevPack = 0;
+  glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &prevPack);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, _buffer);
+  void *data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, _size,
+      GL_MAP_READ_BIT);
+  if (data)
+  {
+    memcpy(_dst, data, _size);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    result = true;
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, prevPack);
+#else
+  (void)_dst;
+#endif
+  this->freeBuffers.emplace(_size, _buffer);
+  return result;
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2ReadbackManager::PendingCount(unsigned int _client) const
+{
+  return static_cast<unsigned int>(std::count_if(this->tickets.begin(),
+      this->tickets.end(),
+      [&](const Ticket &_ticket) { return _ticket.client == _client; }));
+}
+
+//////////////////////////////////////////////////
+void Ogre2ReadbackManager::Reset()
+{
+#ifdef IGN_OGRE2_ASYNC_READBACK
+  for (auto &ticket : this->tickets)
+  {
+    if (ticket.fence)
+      glDeleteSync(static_cast<GLsync>(ticket.fence));
+    glDeleteBuffers(1, &ticket.buffer);
+  }
+  for (auto &buffer : this->freeBuffers)
+    glDeleteBuffers(1, &buffer.second);
+  if (this->readFramebuffer != 0u)
+  {
+    GLuint framebuffer = this->readFramebuffer;
+    glDeleteFramebuffers(1, &framebuffer);
+  }
+#endif
+  this->readFramebuffer = 0u;
+  this->tickets.clear();
+  this->freeBuffers.clear();
+}
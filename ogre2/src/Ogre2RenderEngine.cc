@@ -21,6 +21,10 @@
 # include <X11/Xutil.h>
 # include <GL/glx.h>
 # include <GL/glxext.h>
+# ifdef HAVE_EGL
+#  include <EGL/egl.h>
+#  include <EGL/eglext.h>
+# endif
 #endif
 
 #ifdef _WIN32
@@ -28,12 +32,24 @@
   // pulled in by anybody (e.g., Boost).
   #include <Winsock2.h>
 #endif
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 #include <ignition/common/Filesystem.hh>
 #include <ignition/common/Util.hh>
 
 #include <ignition/plugin/Register.hh>
 
+#include "ignition/rendering/Profiler.hh"
 #include "ignition/rendering/RenderEngineManager.hh"
 #include "ignition/rendering/ogre2/Ogre2Includes.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
@@ -41,6 +57,13 @@
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
 #include "ignition/rendering/ogre2/Ogre2Storage.hh"
 
+#include "Ogre2GpuTimer.hh"
+#include "Ogre2ReadbackManager.hh"
+#include "Ogre2RenderStats.hh"
+#include "Ogre2RenderTexturePool.hh"
+#include "Ogre2TextureStreamer.hh"
+#include "Ogre2WeightedOitListener.hh"
+
 
 class ignition::rendering::Ogre2RenderEnginePrivate
 {
@@ -48,10 +71,158 @@ class ignition::rendering::Ogre2RenderEnginePrivate
   public: GLXFBConfig* dummyFBConfigs = nullptr;
 #endif
 
+#ifdef HAVE_EGL
+  /// \brief Create an EGL context on a GPU device, with a 1x1 pbuffer
+  /// surface, and make it current. No X server is needed.
+  /// \return True if the context was created
+  public: bool CreateEglContext();
+
+  /// \brief Release the EGL context, surface and display
+  public: void DestroyEglContext();
+
+  /// \brief EGL display of the device the context was created on
+  public: EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+
+  /// \brief EGL context current on the render thread
+  public: EGLContext eglContext = EGL_NO_CONTEXT;
+
+  /// \brief 1x1 pbuffer the EGL context is made current with
+  public: EGLSurface eglSurface = EGL_NO_SURFACE;
+#endif
+
+  /// \brief True to create the context with EGL instead of GLX
+  public: bool headless = false;
+
+  /// \brief Index of the EGL device to create the context on, -1 to use
+  /// the first device that can be initialized
+  public: int device = -1;
+
+  /// \brief True if the main context was created with EGL. Ogre then
+  /// renders with the context current on the thread.
+  public: bool eglActive = false;
+
   /// \brief A list of supported fsaa levels
   public: std::vector<unsigned int> fsaaLevels;
+
+  /// \brief True while a render batch is being collected
+  public: bool renderBatchActive = false;
+
+  /// \brief True to render workspaces without rendering a whole frame
+  public: bool manualWorkspaceUpdate = true;
+
+  /// \brief Number of worker threads of the scene managers, 0 to use the
+  /// number of logical cores
+  public: unsigned int workerThreads = 0u;
+
+  /// \brief True to cull instanced entities on the worker threads
+  public: bool threadedCulling = false;
+
+  /// \brief A compositor workspace queued in a render batch along with
+  /// its owner
+  public: using BatchItem =
+      std::pair<std::weak_ptr<Object>, Ogre::CompositorWorkspace *>;
+
+  /// \brief Workspaces of the current render batch, one list per stage
+  public: std::vector<std::vector<BatchItem>> renderBatch;
+
+  /// \brief Objects whose post render step is deferred to the end of the
+  /// current render batch
+  public: std::vector<std::weak_ptr<Object>> renderBatchPostRender;
+
+  /// \brief All resource paths added so far, used to skip duplicates
+  public: std::unordered_set<std::string> resourcePathSet;
+
+  /// \brief True while a resource path batch is being collected
+  public: bool resourcePathBatchActive = false;
+
+  /// \brief Resource paths queued in the current batch
+  public: std::vector<std::string> resourcePathBatch;
+
+  /// \brief Directory of the shader microcode cache, empty if disabled
+  public: std::string shaderCachePath;
+
+  /// \brief True to skip the plugins and media that sensors do not use
+  public: bool minimalResources = false;
+
+  /// \brief Contents of the shader microcode cache file, read on a worker
+  /// thread while the context and the render system are created
+  public: std::future<std::string> shaderCacheData;
+
+  /// \brief Reads the media files on a worker thread while the context and
+  /// the render system are created, so that parsing them does not wait on
+  /// the disk
+  public: std::future<void> mediaPrefetch;
 };
 
+/// \brief Get the path to the ogre2 media
+/// \return Path to the installed media, or to the source media if it is
+/// not installed
+static std::string ogre2MediaPath()
+{
+  const char *env = std::getenv("IGN_RENDERING_RESOURCE_PATH");
+  std::string resourcePath = (env) ? std::string(env) :
+      IGN_RENDERING_RESOURCE_PATH;
+  // install path
+  std::string path = ignition::common::joinPaths(
+      resourcePath, "ogre2", "media");
+  if (!ignition::common::exists(path))
+  {
+    // src path
+    path = ignition::common::joinPaths(resourcePath, "ogre2", "src", "media");
+  }
+  return path;
+}
+
+/// \brief Get the media directories registered in the General group
+/// \param[in] _mediaPath Path to the ogre2 media
+/// \param[in] _minimal True to leave out the media sensors do not use
+/// \return Directories containing the low level materials, programs,
+/// textures and fonts
+static std::vector<std::string> mediaDirectories(
+    const std::string &_mediaPath, bool _minimal)
+{
+  std::vector<std::string> dirs;
+  dirs.push_back(_mediaPath);
+  dirs.push_back(_mediaPath + "/materials/programs");
+  dirs.push_back(_mediaPath + "/materials/scripts");
+  dirs.push_back(_mediaPath + "/materials/textures");
+  // fonts are only needed by text geometries
+  if (!_minimal)
+    dirs.push_back(_mediaPath + "/fonts");
+  return dirs;
+}
+
+/// \brief Read the files of a directory, discarding their contents, so
+/// that they are in the page cache when ogre parses them
+/// \param[in] _dir Directory to read
+/// \param[in] _recursive True to also read the subdirectories, except
+/// the ones of the shader languages the GL3+ render system does not use
+static void prefetchDirectory(const std::string &_dir, bool _recursive)
+{
+  if (!ignition::common::isDirectory(_dir))
+    return;
+
+  std::vector<char> buffer(1u << 16u);
+  ignition::common::DirIter endIter;
+  for (ignition::common::DirIter dirIter(_dir); dirIter != endIter;
+      ++dirIter)
+  {
+    std::string path = *dirIter;
+    if (ignition::common::isDirectory(path))
+    {
+      std::string name = ignition::common::basename(path);
+      if (_recursive && name != "Metal" && name != "HLSL")
+        prefetchDirectory(path, true);
+      continue;
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    while (in.read(buffer.data(), buffer.size()))
+    {
+    }
+  }
+}
+
 using namespace ignition;
 using namespace rendering;
 
@@ -112,6 +283,17 @@ void Ogre2RenderEngine::Destroy()
   delete this->ogreOverlaySystem;
   this->ogreOverlaySystem = nullptr;
 
+  // release readback buffers while the GL context is still valid
+  if (this->ogreRoot)
+  {
+    Ogre2ReadbackManager::Instance()->Reset();
+    Ogre2GpuTimer::Instance()->Reset();
+    Ogre2RenderStats::Instance()->Reset();
+    Ogre2TextureStreamer::Instance()->Reset();
+    Ogre2RenderTexturePool::Instance()->Reset();
+    this->SaveShaderCache();
+  }
+
   if (ogreRoot)
   {
     try
@@ -141,6 +323,10 @@ void Ogre2RenderEngine::Destroy()
     this->dataPtr->dummyFBConfigs = nullptr;
   }
 #endif
+
+#ifdef HAVE_EGL
+  this->dataPtr->DestroyEglContext();
+#endif
 }
 
 //////////////////////////////////////////////////
@@ -155,6 +341,24 @@ std::string Ogre2RenderEngine::Name() const
   return "ogre2";
 }
 
+//////////////////////////////////////////////////
+bool Ogre2RenderEngine::SetGpuTimingEnabled(bool _enabled)
+{
+  if (!Ogre2GpuTimer::Instance()->SetEnabled(_enabled))
+  {
+    ignwarn << "GPU timing requires an initialized ogre2 render engine "
+            << "using the OpenGL 3+ render system" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2RenderEngine::GpuTimingEnabled() const
+{
+  return Ogre2GpuTimer::Instance()->Enabled();
+}
+
 //////////////////////////////////////////////////
 void Ogre2RenderEngine::AddResourcePath(const std::string &_uri)
 {
@@ -169,63 +373,125 @@ void Ogre2RenderEngine::AddResourcePath(const std::string &_uri)
     return;
   }
 
+  // each location only needs to be registered once
+  if (!this->dataPtr->resourcePathSet.insert(path).second)
+    return;
+
   this->resourcePaths.push_back(path);
 
+  if (this->dataPtr->resourcePathBatchActive)
+  {
+    this->dataPtr->resourcePathBatch.push_back(path);
+    return;
+  }
+
+  this->LoadResourcePaths({path});
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderEngine::BeginResourcePathBatch()
+{
+  if (this->dataPtr->resourcePathBatchActive)
+  {
+    ignwarn << "Resource path batch already active" << std::endl;
+    return;
+  }
+  this->dataPtr->resourcePathBatchActive = true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderEngine::EndResourcePathBatch()
+{
+  if (!this->dataPtr->resourcePathBatchActive)
+  {
+    ignwarn << "EndResourcePathBatch called without BeginResourcePathBatch"
+            << std::endl;
+    return;
+  }
+  this->dataPtr->resourcePathBatchActive = false;
+
+  auto paths = std::move(this->dataPtr->resourcePathBatch);
+  this->dataPtr->resourcePathBatch.clear();
+  if (!paths.empty())
+    this->LoadResourcePaths(paths);
+}
+
+//////////////////////////////////////////////////
+bool Ogre2RenderEngine::ResourcePathBatchActive() const
+{
+  return this->dataPtr->resourcePathBatchActive;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderEngine::LoadResourcePaths(
+    const std::vector<std::string> &_paths)
+{
   try
   {
-    if (!Ogre::ResourceGroupManager::getSingleton().resourceLocationExists(
-          path, "General"))
+    std::vector<std::string> newPaths;
+    for (const auto &path : _paths)
     {
-      Ogre::ResourceGroupManager::getSingleton().addResourceLocation(
-          path, "FileSystem", "General", true);
+      if (!Ogre::ResourceGroupManager::getSingleton().resourceLocationExists(
+            path, "General"))
+      {
+        Ogre::ResourceGroupManager::getSingleton().addResourceLocation(
+            path, "FileSystem", "General", true);
+        newPaths.push_back(path);
+      }
+    }
+    if (newPaths.empty())
+      return;
+
+    Ogre::ResourceGroupManager::getSingleton().initialiseResourceGroup(
+        "General", false);
 
-      Ogre::ResourceGroupManager::getSingleton().initialiseResourceGroup(
-          "General", false);
+    for (const auto &path : newPaths)
+    {
       // Parse all material files in the path if any exist
-      if (common::isDirectory(path))
+      if (!common::isDirectory(path))
+        continue;
+
+      std::vector<std::string> paths;
+
+      common::DirIter endIter;
+      for (common::DirIter dirIter(path); dirIter != endIter; ++dirIter)
       {
-        std::vector<std::string> paths;
+        paths.push_back(*dirIter);
+      }
+      std::sort(paths.begin(), paths.end());
 
-        common::DirIter endIter;
-        for (common::DirIter dirIter(path); dirIter != endIter; ++dirIter)
+      // Iterate over all the models in the current ign-rendering path
+      for (auto dIter = paths.begin(); dIter != paths.end(); ++dIter)
+      {
+        std::string fullPath = *dIter;
+        std::string matExtension = fullPath.substr(fullPath.size()-9);
+        if (matExtension == ".material")
         {
-          paths.push_back(*dirIter);
-        }
-        std::sort(paths.begin(), paths.end());
+          Ogre::DataStreamPtr stream =
+            Ogre::ResourceGroupManager::getSingleton().openResource(
+                fullPath, "General");
 
-        // Iterate over all the models in the current ign-rendering path
-        for (auto dIter = paths.begin(); dIter != paths.end(); ++dIter)
-        {
-          std::string fullPath = *dIter;
-          std::string matExtension = fullPath.substr(fullPath.size()-9);
-          if (matExtension == ".material")
+          // There is a material file under there somewhere, read the thing in
+          try
           {
-            Ogre::DataStreamPtr stream =
-              Ogre::ResourceGroupManager::getSingleton().openResource(
-                  fullPath, "General");
+            Ogre::MaterialManager::getSingleton().parseScript(
+                stream, "General");
+            Ogre::MaterialPtr matPtr =
+              Ogre::MaterialManager::getSingleton().getByName(
+                  fullPath);
 
-            // There is a material file under there somewhere, read the thing in
-            try
+            if (!matPtr.isNull())
             {
-              Ogre::MaterialManager::getSingleton().parseScript(
-                  stream, "General");
-              Ogre::MaterialPtr matPtr =
-                Ogre::MaterialManager::getSingleton().getByName(
-                    fullPath);
-
-              if (!matPtr.isNull())
-              {
-                // is this necessary to do here? Someday try it without
-                matPtr->compile();
-                matPtr->load();
-              }
+              // is this necessary to do here? Someday try it without
+              matPtr->compile();
+              matPtr->load();
             }
-            catch(Ogre::Exception& e)
-            {
-              ignerr << "Unable to parse material file[" << fullPath << "]\n";
-            }
-            stream->close();
           }
+          catch(Ogre::Exception& e)
+          {
+            ignerr << "Unable to parse material file[" << fullPath << "]\n";
+          }
+          stream->close();
         }
       }
     }
@@ -267,6 +533,74 @@ bool Ogre2RenderEngine::LoadImpl(
   if (it != _params.end())
     std::istringstream(it->second) >> this->useCurrentGLContext;
 
+  it = _params.find("headless");
+  if (it != _params.end())
+    std::istringstream(it->second) >> this->dataPtr->headless;
+
+  // a device can only be selected with EGL, GLX renders on the GPU of
+  // the X screen
+  it = _params.find("device");
+  if (it != _params.end() &&
+      std::istringstream(it->second) >> this->dataPtr->device)
+  {
+    this->dataPtr->headless = true;
+  }
+
+  it = _params.find("shaderCachePath");
+  if (it != _params.end())
+    this->dataPtr->shaderCachePath = it->second;
+
+  bool textureStreaming = false;
+  it = _params.find("textureStreaming");
+  if (it != _params.end())
+    std::istringstream(it->second) >> textureStreaming;
+  Ogre2TextureStreamer::Instance()->SetEnabled(textureStreaming);
+
+  bool textureCompression = false;
+  it = _params.find("textureCompression");
+  if (it != _params.end())
+    std::istringstream(it->second) >> textureCompression;
+  Ogre2TextureStreamer::Instance()->SetCompressionEnabled(textureCompression);
+
+  bool prefiltering = false;
+  it = _params.find("environmentMapPrefiltering");
+  if (it != _params.end())
+    std::istringstream(it->second) >> prefiltering;
+  Ogre2TextureStreamer::Instance()->SetEnvironmentMapPrefilteringEnabled(
+      prefiltering);
+
+  it = _params.find("manualWorkspaceUpdate");
+  if (it != _params.end())
+    std::istringstream(it->second) >> this->dataPtr->manualWorkspaceUpdate;
+
+  it = _params.find("textureUploadBudget");
+  if (it != _params.end())
+  {
+    size_t budget = 0u;
+    if (std::istringstream(it->second) >> budget)
+      Ogre2TextureStreamer::Instance()->SetUploadBudget(budget);
+    else
+      ignerr << "Invalid texture upload budget: " << it->second << std::endl;
+  }
+
+  it = _params.find("workerThreads");
+  if (it != _params.end())
+  {
+    unsigned int threads = 0u;
+    if (std::istringstream(it->second) >> threads && threads > 0u)
+      this->dataPtr->workerThreads = threads;
+    else
+      ignerr << "Invalid worker thread count: " << it->second << std::endl;
+  }
+
+  it = _params.find("threadedCulling");
+  if (it != _params.end())
+    std::istringstream(it->second) >> this->dataPtr->threadedCulling;
+
+  it = _params.find("minimalResources");
+  if (it != _params.end())
+    std::istringstream(it->second) >> this->dataPtr->minimalResources;
+
   try
   {
     this->LoadAttempt();
@@ -303,6 +637,37 @@ bool Ogre2RenderEngine::InitImpl()
 //////////////////////////////////////////////////
 void Ogre2RenderEngine::LoadAttempt()
 {
+  // the files read at startup do not depend on the context nor on the
+  // render system, read them while these are created. Ogre itself is not
+  // thread safe, so the resources are still registered on this thread.
+  std::string cacheFile;
+  if (!this->dataPtr->shaderCachePath.empty())
+  {
+    cacheFile = common::joinPaths(this->dataPtr->shaderCachePath,
+        "ogre2_microcode.cache");
+  }
+  this->dataPtr->shaderCacheData = std::async(std::launch::async,
+      [cacheFile]()
+  {
+    std::string data;
+    if (cacheFile.empty() || !common::isFile(cacheFile))
+      return data;
+    std::ifstream in(cacheFile, std::ios::binary);
+    std::ostringstream out;
+    out << in.rdbuf();
+    data = out.str();
+    return data;
+  });
+  bool minimal = this->dataPtr->minimalResources;
+  this->dataPtr->mediaPrefetch = std::async(std::launch::async, [minimal]()
+  {
+    std::string path = ogre2MediaPath();
+    for (const auto &dir : mediaDirectories(path, minimal))
+      prefetchDirectory(dir, false);
+    prefetchDirectory(common::joinPaths(path, "2.0"), true);
+    prefetchDirectory(common::joinPaths(path, "Hlms"), true);
+  });
+
   this->CreateLogger();
   if (!this->useCurrentGLContext)
     this->CreateContext();
@@ -313,6 +678,7 @@ void Ogre2RenderEngine::LoadAttempt()
   this->ogreRoot->initialise(false);
   this->CreateRenderWindow();
   this->CreateResources();
+  this->LoadShaderCache();
 }
 
 //////////////////////////////////////////////////
@@ -334,12 +700,42 @@ void Ogre2RenderEngine::CreateLogger()
 void Ogre2RenderEngine::CreateContext()
 {
 #if not (__APPLE__ || _WIN32)
+#ifdef HAVE_EGL
+  if (this->dataPtr->headless)
+  {
+    this->dataPtr->eglActive = this->dataPtr->CreateEglContext();
+    if (this->dataPtr->eglActive)
+      return;
+    ignwarn << "Unable to create a headless EGL context, "
+            << "falling back to GLX" << std::endl;
+  }
+#else
+  if (this->dataPtr->headless)
+  {
+    ignwarn << "Built without EGL support, the headless and device "
+            << "params are ignored" << std::endl;
+  }
+#endif
+
   // create X11 display
   this->dummyDisplay = XOpenDisplay(0);
   Display *x11Display = static_cast<Display*>(this->dummyDisplay);
 
   if (!this->dummyDisplay)
   {
+#ifdef HAVE_EGL
+    // no X server, render directly on a GPU device if there is one
+    if (!this->dataPtr->headless)
+    {
+      this->dataPtr->eglActive = this->dataPtr->CreateEglContext();
+      if (this->dataPtr->eglActive)
+      {
+        ignmsg << "Unable to open display: " << XDisplayName(0)
+               << ", using a headless EGL context" << std::endl;
+        return;
+      }
+    }
+#endif
     ignerr << "Unable to open display: " << XDisplayName(0) << std::endl;
     return;
   }
@@ -409,6 +805,151 @@ void Ogre2RenderEngine::CreateContext()
 #endif
 }
 
+#ifdef HAVE_EGL
+//////////////////////////////////////////////////
+bool Ogre2RenderEnginePrivate::CreateEglContext()
+{
+  auto eglQueryDevices = reinterpret_cast<PFNEGLQUERYDEVICESEXTPROC>(
+      eglGetProcAddress("eglQueryDevicesEXT"));
+  auto eglGetPlatformDisplay =
+      reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+      eglGetProcAddress("eglGetPlatformDisplayEXT"));
+  if (!eglQueryDevices || !eglGetPlatformDisplay)
+  {
+    ignerr << "EGL_EXT_device_enumeration is not supported" << std::endl;
+    return false;
+  }
+
+  EGLint deviceCount = 0;
+  if (!eglQueryDevices(0, nullptr, &deviceCount) || deviceCount <= 0)
+  {
+    ignerr << "No EGL device found" << std::endl;
+    return false;
+  }
+  std::vector<EGLDeviceEXT> devices(deviceCount);
+  eglQueryDevices(deviceCount, devices.data(), &deviceCount);
+
+  if (this->device >= deviceCount)
+  {
+    ignerr << "EGL device [" << this->device << "] not found, there are ["
+           << deviceCount << "] devices" << std::endl;
+    return false;
+  }
+
+  // use the requested device, or the first one that can be initialized
+  int first = (this->device < 0) ? 0 : this->device;
+  int last = (this->device < 0) ? deviceCount : this->device + 1;
+  for (int i = first; i < last && this->eglDisplay == EGL_NO_DISPLAY; ++i)
+  {
+    EGLDisplay display = eglGetPlatformDisplay(EGL_PLATFORM_DEVICE_EXT,
+        devices[i], nullptr);
+    EGLint major = 0;
+    EGLint minor = 0;
+    if (display != EGL_NO_DISPLAY && eglInitialize(display, &major, &minor))
+    {
+      this->eglDisplay = display;
+      igndbg << "Using EGL " << major << "." << minor << " device [" << i
+             << "]" << std::endl;
+    }
+  }
+
+  if (this->eglDisplay == EGL_NO_DISPLAY)
+  {
+    ignerr << "Unable to initialize an EGL display" << std::endl;
+    return false;
+  }
+
+  EGLint configAttribs[] = {
+    EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+    EGL_RED_SIZE, 8,
+    EGL_GREEN_SIZE, 8,
+    EGL_BLUE_SIZE, 8,
+    EGL_DEPTH_SIZE, 16,
+    EGL_STENCIL_SIZE, 8,
+    EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+    EGL_NONE
+  };
+
+  EGLConfig config = nullptr;
+  EGLint configCount = 0;
+  if (!eglChooseConfig(this->eglDisplay, configAttribs, &config, 1,
+      &configCount) || configCount <= 0)
+  {
+    ignerr << "Unable to choose an EGL config" << std::endl;
+    this->DestroyEglContext();
+    return false;
+  }
+
+  EGLint pbufferAttribs[] = {
+    EGL_WIDTH, 1,
+    EGL_HEIGHT, 1,
+    EGL_NONE
+  };
+  this->eglSurface = eglCreatePbufferSurface(this->eglDisplay, config,
+      pbufferAttribs);
+  if (this->eglSurface == EGL_NO_SURFACE)
+  {
+    ignerr << "Unable to create an EGL pbuffer surface" << std::endl;
+    this->DestroyEglContext();
+    return false;
+  }
+
+  if (!eglBindAPI(EGL_OPENGL_API))
+  {
+    ignerr << "Unable to bind the OpenGL API to EGL" << std::endl;
+    this->DestroyEglContext();
+    return false;
+  }
+
+  // same 3.3 core profile as the GLX context
+  EGLint contextAttribs[] = {
+    EGL_CONTEXT_MAJOR_VERSION_KHR, 3,
+    EGL_CONTEXT_MINOR_VERSION_KHR, 3,
+    EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR,
+    EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR,
+    EGL_NONE
+  };
+  this->eglContext = eglCreateContext(this->eglDisplay, config,
+      EGL_NO_CONTEXT, contextAttribs);
+  if (this->eglContext == EGL_NO_CONTEXT)
+  {
+    ignerr << "Unable to create an EGL context" << std::endl;
+    this->DestroyEglContext();
+    return false;
+  }
+
+  if (!eglMakeCurrent(this->eglDisplay, this->eglSurface, this->eglSurface,
+      this->eglContext))
+  {
+    ignerr << "Unable to make the EGL context current" << std::endl;
+    this->DestroyEglContext();
+    return false;
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderEnginePrivate::DestroyEglContext()
+{
+  if (this->eglDisplay == EGL_NO_DISPLAY)
+    return;
+
+  eglMakeCurrent(this->eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE,
+      EGL_NO_CONTEXT);
+  if (this->eglContext != EGL_NO_CONTEXT)
+    eglDestroyContext(this->eglDisplay, this->eglContext);
+  if (this->eglSurface != EGL_NO_SURFACE)
+    eglDestroySurface(this->eglDisplay, this->eglSurface);
+  eglTerminate(this->eglDisplay);
+
+  this->eglContext = EGL_NO_CONTEXT;
+  this->eglSurface = EGL_NO_SURFACE;
+  this->eglDisplay = EGL_NO_DISPLAY;
+  this->eglActive = false;
+}
+#endif
+
 //////////////////////////////////////////////////
 void Ogre2RenderEngine::CreateRoot()
 {
@@ -450,8 +991,12 @@ void Ogre2RenderEngine::LoadPlugins()
 #endif
     std::string p = common::joinPaths(path, "RenderSystem_GL3Plus");
     plugins.push_back(p);
-    p = common::joinPaths(path, "Plugin_ParticleFX");
-    plugins.push_back(p);
+    // particle emitters are not available with the minimal resources
+    if (!this->dataPtr->minimalResources)
+    {
+      p = common::joinPaths(path, "Plugin_ParticleFX");
+      plugins.push_back(p);
+    }
 
     for (piter = plugins.begin(); piter != plugins.end(); ++piter)
     {
@@ -573,37 +1118,23 @@ void Ogre2RenderEngine::CreateRenderSystem()
 //////////////////////////////////////////////////
 void Ogre2RenderEngine::CreateResources()
 {
-  const char *env = std::getenv("IGN_RENDERING_RESOURCE_PATH");
-  std::string resourcePath = (env) ? std::string(env) :
-      IGN_RENDERING_RESOURCE_PATH;
-  // install path
-  std::string mediaPath = common::joinPaths(resourcePath, "ogre2", "media");
-  if (!common::exists(mediaPath))
-  {
-    // src path
-    mediaPath = common::joinPaths(resourcePath, "ogre2", "src", "media");
-  }
+  std::string mediaPath = ogre2MediaPath();
+
+  // wait for the media files to be read, so that the disk is not read
+  // from two threads at once
+  if (this->dataPtr->mediaPrefetch.valid())
+    this->dataPtr->mediaPrefetch.wait();
 
   // register low level materials (ogre v1 materials)
-  std::vector< std::pair<std::string, std::string> > archNames;
-  std::string p = mediaPath;
-  if (common::isDirectory(p))
-  {
-    archNames.push_back(
-        std::make_pair(p, "General"));
-    archNames.push_back(
-        std::make_pair(p + "/materials/programs", "General"));
-    archNames.push_back(
-        std::make_pair(p + "/materials/scripts", "General"));
-    archNames.push_back(
-        std::make_pair(p + "/materials/textures", "General"));
-
-    for (auto aiter = archNames.begin(); aiter != archNames.end(); ++aiter)
+  if (common::isDirectory(mediaPath))
+  {
+    for (const auto &dir :
+        mediaDirectories(mediaPath, this->dataPtr->minimalResources))
     {
       try
       {
         Ogre::ResourceGroupManager::getSingleton().addResourceLocation(
-            aiter->first, "FileSystem", aiter->second);
+            dir, "FileSystem", "General");
       }
       catch(Ogre::Exception &/*_e*/)
       {
@@ -700,6 +1231,106 @@ void Ogre2RenderEngine::CreateResources()
 
     // disable writting debug output to disk
     hlmsPbs->setDebugOutputPath(false, false);
+
+    // selects the shaders of weighted blended order independent
+    // transparency in the scene passes of the cameras using it
+    hlmsPbs->setListener(Ogre2WeightedOitListener::Instance());
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderEngine::LoadShaderCache()
+{
+  if (this->dataPtr->shaderCachePath.empty())
+    return;
+
+  Ogre::GpuProgramManager &gpuProgramManager =
+      Ogre::GpuProgramManager::getSingleton();
+  if (!gpuProgramManager.canGetCompiledShaderBuffer())
+  {
+    ignwarn << "Render system can not retrieve compiled shaders, "
+            << "the shader cache is disabled" << std::endl;
+    this->dataPtr->shaderCachePath.clear();
+    return;
+  }
+  gpuProgramManager.setSaveMicrocodesToCache(true);
+
+  std::string cacheFile = common::joinPaths(this->dataPtr->shaderCachePath,
+      "ogre2_microcode.cache");
+  if (!this->dataPtr->shaderCacheData.valid())
+    return;
+  std::string data = this->dataPtr->shaderCacheData.get();
+  if (data.empty())
+    return;
+
+  try
+  {
+    Ogre::DataStreamPtr stream(OGRE_NEW Ogre::MemoryDataStream(
+        &data[0], data.size(), false, true));
+    gpuProgramManager.loadMicrocodeCache(stream);
+  }
+  catch (Ogre::Exception &e)
+  {
+    // shaders that fail to load from the cache are compiled again
+    ignwarn << "Unable to load shader cache [" << cacheFile << "]: "
+            << e.getDescription() << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderEngine::SaveShaderCache()
+{
+  if (this->dataPtr->shaderCachePath.empty())
+    return;
+
+  Ogre::GpuProgramManager &gpuProgramManager =
+      Ogre::GpuProgramManager::getSingleton();
+  if (!gpuProgramManager.isCacheDirty())
+    return;
+
+  const std::string &dir = this->dataPtr->shaderCachePath;
+  if (!common::isDirectory(dir) && !common::createDirectories(dir))
+  {
+    ignerr << "Unable to create shader cache directory [" << dir << "]"
+           << std::endl;
+    return;
+  }
+
+  // write to a temporary file first so that other processes never load a
+  // partially written cache
+  std::string cacheFile = common::joinPaths(dir, "ogre2_microcode.cache");
+  std::string tmpFile = cacheFile + "." + std::to_string(
+      std::chrono::system_clock::now().time_since_epoch().count()) + ".tmp";
+  {
+    std::fstream out(tmpFile,
+        std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+      ignerr << "Unable to write shader cache [" << cacheFile << "]"
+             << std::endl;
+      return;
+    }
+    try
+    {
+      Ogre::DataStreamPtr stream(
+          OGRE_NEW Ogre::FileStreamDataStream(&out, false));
+      gpuProgramManager.saveMicrocodeCache(stream);
+    }
+    catch (Ogre::Exception &e)
+    {
+      ignerr << "Unable to write shader cache [" << cacheFile << "]: "
+             << e.getDescription() << std::endl;
+      out.close();
+      std::remove(tmpFile.c_str());
+      return;
+    }
+  }
+
+  if (std::rename(tmpFile.c_str(), cacheFile.c_str()) != 0)
+  {
+    ignerr << "Unable to write shader cache [" << cacheFile << "]"
+           << std::endl;
+    std::remove(tmpFile.c_str());
   }
 }
 
@@ -724,8 +1355,13 @@ std::string Ogre2RenderEngine::CreateRenderWindow(const std::string &_handle,
   Ogre::NameValuePairList params;
   Ogre::RenderWindow *window = nullptr;
 
+  // render with the current context when it was created by the caller or
+  // with EGL, which has no window to parent ogre's window to
+  bool currentGLContext =
+      this->useCurrentGLContext || this->dataPtr->eglActive;
+
   // if use current gl then don't include window handle params
-  if (!this->useCurrentGLContext)
+  if (!currentGLContext)
   {
     // Mac and Windows *must* use externalWindow handle.
 #if defined(__APPLE__) || defined(_MSC_VER)
@@ -758,7 +1394,7 @@ std::string Ogre2RenderEngine::CreateRenderWindow(const std::string &_handle,
   // Ogre 2 PBS expects gamma correction
   params["gamma"] = "true";
 
-  if (this->useCurrentGLContext)
+  if (currentGLContext)
   {
     params["externalGLControl"] = "true";
     params["currentGLContext"] = "true";
@@ -821,6 +1457,180 @@ Ogre::v1::OverlaySystem *Ogre2RenderEngine::OverlaySystem() const
   return this->ogreOverlaySystem;
 }
 
+/////////////////////////////////////////////////
+void Ogre2RenderEngine::BeginRenderBatch()
+{
+  if (this->dataPtr->renderBatchActive)
+  {
+    ignwarn << "Render batch already active" << std::endl;
+    return;
+  }
+  this->dataPtr->renderBatchActive = true;
+}
+
+/////////////////////////////////////////////////
+void Ogre2RenderEngine::EndRenderBatch()
+{
+  IGN_RENDERING_PROFILE("Ogre2RenderEngine::EndRenderBatch");
+  if (!this->dataPtr->renderBatchActive)
+  {
+    ignwarn << "EndRenderBatch called without BeginRenderBatch" << std::endl;
+    return;
+  }
+  this->dataPtr->renderBatchActive = false;
+
+  // move the batch out so objects can start a new one in their post render
+  auto batch = std::move(this->dataPtr->renderBatch);
+  auto postRender = std::move(this->dataPtr->renderBatchPostRender);
+  this->dataPtr->renderBatch.clear();
+  this->dataPtr->renderBatchPostRender.clear();
+
+  for (auto &stage : batch)
+  {
+    std::vector<Ogre::CompositorWorkspace *> workspaces;
+    for (auto &item : stage)
+    {
+      if (!item.first.expired() && item.second)
+        workspaces.push_back(item.second);
+    }
+    this->RenderWorkspaces(workspaces);
+  }
+
+  for (auto &weakObject : postRender)
+  {
+    ObjectPtr object = weakObject.lock();
+    if (object)
+      object->PostRender();
+  }
+}
+
+/////////////////////////////////////////////////
+unsigned int Ogre2RenderEngine::WorkerThreadCount() const
+{
+  if (this->dataPtr->workerThreads > 0u)
+    return this->dataPtr->workerThreads;
+
+  // getNumLogicalCores() may return 0 if couldn't detect
+  return std::max<unsigned int>(
+      1u, Ogre::PlatformInformation::getNumLogicalCores());
+}
+
+/////////////////////////////////////////////////
+bool Ogre2RenderEngine::MinimalResources() const
+{
+  return this->dataPtr->minimalResources;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2RenderEngine::ThreadedCulling() const
+{
+  return this->dataPtr->threadedCulling;
+}
+
+/////////////////////////////////////////////////
+void Ogre2RenderEngine::RenderWorkspaces(
+    const std::vector<Ogre::CompositorWorkspace *> &_workspaces)
+{
+  IGN_RENDERING_PROFILE("Ogre2RenderEngine::RenderWorkspaces");
+  if (_workspaces.empty())
+    return;
+
+  if (!this->dataPtr->manualWorkspaceUpdate)
+  {
+    for (auto ws : _workspaces)
+      ws->setEnabled(true);
+    this->ogreRoot->renderOneFrame();
+    for (auto ws : _workspaces)
+      ws->setEnabled(false);
+    return;
+  }
+
+  // same sequence as Ogre::CompositorManager2::_update, limited to the
+  // scenes and the workspaces given
+  std::vector<Ogre::SceneManager *> sceneManagers;
+  for (auto ws : _workspaces)
+  {
+    Ogre::SceneManager *sceneManager = ws->getSceneManager();
+    if (std::find(sceneManagers.begin(), sceneManagers.end(),
+        sceneManager) == sceneManagers.end())
+    {
+      sceneManagers.push_back(sceneManager);
+    }
+  }
+  // frame listeners advance the frame time that drives the controllers,
+  // e.g. of particle systems, which the scene graph update runs
+  this->ogreRoot->_fireFrameStarted();
+  for (auto sceneManager : sceneManagers)
+    sceneManager->updateSceneGraph();
+
+  Ogre::RenderSystem *renderSystem = this->ogreRoot->getRenderSystem();
+  renderSystem->_beginFrameOnce();
+  for (auto ws : _workspaces)
+  {
+    ws->_validateFinalTarget();
+    ws->_beginUpdate(false);
+    ws->_update();
+    ws->_endUpdate(false);
+  }
+  // render windows present the frame
+  for (auto ws : _workspaces)
+    ws->_swapFinalTarget();
+
+  for (auto sceneManager : sceneManagers)
+    sceneManager->_frameEnded();
+  Ogre::HlmsManager *hlmsManager = this->ogreRoot->getHlmsManager();
+  for (size_t i = 0u; i < Ogre::HLMS_MAX; ++i)
+  {
+    Ogre::Hlms *hlms = hlmsManager->getHlms(static_cast<Ogre::HlmsTypes>(i));
+    if (hlms)
+      hlms->frameEnded();
+  }
+  renderSystem->_update();
+
+  // the GPU timer and the render statistics close the frame once its
+  // commands are queued, and the frame number advances so the controllers
+  // update again next frame
+  this->ogreRoot->_fireFrameRenderingQueued();
+  this->ogreRoot->_fireFrameEnded();
+}
+
+/////////////////////////////////////////////////
+bool Ogre2RenderEngine::RenderBatchActive() const
+{
+  return this->dataPtr->renderBatchActive;
+}
+
+/////////////////////////////////////////////////
+void Ogre2RenderEngine::AddToRenderBatch(ObjectPtr _owner,
+    Ogre::CompositorWorkspace *_workspace, unsigned int _stage)
+{
+  if (!_workspace)
+    return;
+
+  auto &batch = this->dataPtr->renderBatch;
+  if (batch.size() <= _stage)
+    batch.resize(_stage + 1u);
+
+  for (auto &item : batch[_stage])
+  {
+    if (item.second == _workspace)
+      return;
+  }
+  batch[_stage].emplace_back(_owner, _workspace);
+}
+
+/////////////////////////////////////////////////
+void Ogre2RenderEngine::DeferPostRender(ObjectPtr _object)
+{
+  auto &postRender = this->dataPtr->renderBatchPostRender;
+  for (auto &item : postRender)
+  {
+    if (item.lock() == _object)
+      return;
+  }
+  postRender.push_back(_object);
+}
+
 // Register this plugin
 IGNITION_ADD_PLUGIN(ignition::rendering::Ogre2RenderEnginePlugin,
                     ignition::rendering::RenderEnginePlugin)
@@ -19,6 +19,17 @@
 /// \brief Private data for the Ogre2RenderPass class
 class ignition::rendering::Ogre2RenderPassPrivate
 {
+  /// \brief Name of the fused compositor node definition drawing the pass
+  public: std::string fusedNodeDefName;
+
+  /// \brief Material of the fused compositor node
+  public: Ogre::Material *fusedMaterial = nullptr;
+
+  /// \brief Prefix of the uniforms of the pass in the fused material
+  public: std::string fusedPrefix;
+
+  /// \brief Camera rendering the images the pass is applied to
+  public: Ogre::Camera *ogreCamera = nullptr;
 };
 
 using namespace ignition;
@@ -51,3 +62,49 @@ std::string Ogre2RenderPass::OgreCompositorNodeDefinitionName() const
 {
   return this->ogreCompositorNodeDefName;
 }
+
+//////////////////////////////////////////////////
+std::string Ogre2RenderPass::FusedShaderCode(
+    const std::string &/*_prefix*/) const
+{
+  return std::string();
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderPass::SetFusedNode(const std::string &_nodeDefName,
+    Ogre::Material *_material, const std::string &_prefix)
+{
+  this->dataPtr->fusedNodeDefName = _nodeDefName;
+  this->dataPtr->fusedMaterial = _material;
+  this->dataPtr->fusedPrefix = _prefix;
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2RenderPass::FusedNodeDefinitionName() const
+{
+  return this->dataPtr->fusedNodeDefName;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderPass::SetOgreCamera(Ogre::Camera *_camera)
+{
+  this->dataPtr->ogreCamera = _camera;
+}
+
+//////////////////////////////////////////////////
+Ogre::Camera *Ogre2RenderPass::OgreCamera() const
+{
+  return this->dataPtr->ogreCamera;
+}
+
+//////////////////////////////////////////////////
+Ogre::Material *Ogre2RenderPass::FusedMaterial() const
+{
+  return this->dataPtr->fusedMaterial;
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2RenderPass::FusedShaderPrefix() const
+{
+  return this->dataPtr->fusedPrefix;
+}
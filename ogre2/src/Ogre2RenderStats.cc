@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+
+#include "Ogre2RenderStats.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Get the increase of a counter of the render system
+/// \param[in] _now Current value of the counter
+/// \param[in] _then Value of the counter when the client was marked
+/// \return Increase of the counter, the current value if the counter was
+/// reset in between
+static uint64_t counterDelta(size_t _now, size_t _then)
+{
+  return _now >= _then ? _now - _then : _now;
+}
+
+//////////////////////////////////////////////////
+Ogre2RenderStats::~Ogre2RenderStats()
+{
+  this->Reset();
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderStats::Mark(unsigned int _client)
+{
+  if (_client == this->client)
+    return;
+
+  this->Close();
+
+  if (!this->recording)
+  {
+    auto engine = Ogre2RenderEngine::Instance();
+    if (!engine->OgreRoot() || !engine->OgreRoot()->getRenderSystem())
+      return;
+    engine->OgreRoot()->getRenderSystem()->setMetricsRecordingEnabled(true);
+    engine->OgreRoot()->addFrameListener(this);
+    this->recording = true;
+  }
+
+  if (_client == 0u)
+    return;
+
+  this->client = _client;
+  this->metrics = Ogre2RenderEngine::Instance()->OgreRoot()->
+      getRenderSystem()->getMetrics();
+  this->markTime = std::chrono::steady_clock::now();
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderStats::AddReadback(unsigned int _client, uint64_t _bytes)
+{
+  if (_client == 0u)
+    return;
+  this->current[_client].readbackBytes += _bytes;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderStats::BeginFrame(unsigned int _client)
+{
+  if (_client == 0u)
+    return;
+
+  auto it = this->current.find(_client);
+  if (it == this->current.end())
+  {
+    this->last[_client] = FrameStats();
+    return;
+  }
+  this->last[_client] = it->second;
+  this->current.erase(it);
+}
+
+//////////////////////////////////////////////////
+FrameStats Ogre2RenderStats::Stats(unsigned int _client) const
+{
+  auto it = this->last.find(_client);
+  if (it == this->last.end())
+    return FrameStats();
+  return it->second;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderStats::DestroyClient(unsigned int _client)
+{
+  if (_client == this->client)
+    this->client = 0u;
+  this->current.erase(_client);
+  this->last.erase(_client);
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderStats::Reset()
+{
+  this->client = 0u;
+  this->current.clear();
+  this->last.clear();
+
+  if (this->recording)
+  {
+    auto engine = Ogre2RenderEngine::Instance();
+    if (engine->OgreRoot())
+      engine->OgreRoot()->removeFrameListener(this);
+    this->recording = false;
+  }
+}
+
+//////////////////////////////////////////////////
+bool Ogre2RenderStats::frameRenderingQueued(
+    const Ogre::FrameEvent &/*_evt*/)
+{
+  this->Close();
+  return true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderStats::Close()
+{
+  if (this->client == 0u)
+    return;
+
+  const Ogre::RenderingMetrics &now = Ogre2RenderEngine::Instance()->
+      OgreRoot()->getRenderSystem()->getMetrics();
+  FrameStats &stats = this->current[this->client];
+  stats.drawCalls += counterDelta(now.mDrawCount, this->metrics.mDrawCount);
+  stats.instances +=
+      counterDelta(now.mInstanceCount, this->metrics.mInstanceCount);
+  stats.batches += counterDelta(now.mBatchCount, this->metrics.mBatchCount);
+  stats.triangles += counterDelta(now.mFaceCount, this->metrics.mFaceCount);
+  stats.vertices +=
+      counterDelta(now.mVertexCount, this->metrics.mVertexCount);
+  stats.cpuTime += std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - this->markTime).count();
+
+  this->client = 0u;
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2RENDERSTATS_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2RENDERSTATS_HH_
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+
+#include <ignition/common/SingletonT.hh>
+
+#include "ignition/rendering/FrameStats.hh"
+#include "ignition/rendering/ogre2/Ogre2Includes.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Accumulates the rendering metrics of the ogre2 render system
+    /// for the sensors, identified by their GPU timer client. The metrics
+    /// recorded while a client's compositor passes execute, between the
+    /// timestamps written by Ogre2GpuTimerListener, are charged to that
+    /// client. A client's frame ends when BeginFrame is called.
+    class Ogre2RenderStats :
+      public common::SingletonT<Ogre2RenderStats>,
+      public Ogre::FrameListener
+    {
+      /// \brief Constructor
+      private: Ogre2RenderStats() = default;
+
+      /// \brief Destructor
+      public: ~Ogre2RenderStats();
+
+      /// \brief Charge the metrics recorded from now on to a client
+      /// \param[in] _client Id of client, 0 to charge nobody
+      public: void Mark(unsigned int _client);
+
+      /// \brief Add the bytes read back to CPU memory by a client
+      /// \param[in] _client Id of client
+      /// \param[in] _bytes Number of bytes read back
+      public: void AddReadback(unsigned int _client, uint64_t _bytes);
+
+      /// \brief End the current frame of a client and begin a new one
+      /// \param[in] _client Id of client
+      public: void BeginFrame(unsigned int _client);
+
+      /// \brief Get the statistics of the last frame of a client
+      /// \param[in] _client Id of client
+      /// \return Statistics, without the GPU time
+      public: FrameStats Stats(unsigned int _client) const;
+
+      /// \brief Discard the statistics of a client
+      /// \param[in] _client Id of client
+      public: void DestroyClient(unsigned int _client);
+
+      /// \brief Discard all statistics and stop recording
+      public: void Reset();
+
+      /// \brief Charge the end of the frame rendered by
+      /// Ogre::Root::renderOneFrame to the current client
+      /// \param[in] _evt Frame event
+      /// \return True to continue rendering
+      public: virtual bool frameRenderingQueued(const Ogre::FrameEvent &_evt)
+          override;
+
+      /// \brief Charge the metrics recorded since the last mark to the
+      /// current client
+      private: void Close();
+
+      /// \brief Counters of the render system when the current client was
+      /// marked
+      private: Ogre::RenderingMetrics metrics;
+
+      /// \brief Time when the current client was marked
+      private: std::chrono::steady_clock::time_point markTime;
+
+      /// \brief Id of the client the metrics are currently charged to
+      private: unsigned int client = 0u;
+
+      /// \brief Statistics of the current frame of each client
+      private: std::map<unsigned int, FrameStats> current;
+
+      /// \brief Statistics of the last frame of each client
+      private: std::map<unsigned int, FrameStats> last;
+
+      /// \brief True if the metrics are recorded and the class is a frame
+      /// listener of the ogre root
+      private: bool recording = false;
+
+      /// \brief Make the singleton class a friend
+      private: friend class common::SingletonT<Ogre2RenderStats>;
+    };
+    }
+  }
+}
+
+#endif
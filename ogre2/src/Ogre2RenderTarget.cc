@@ -15,6 +15,14 @@
  *
  */
 
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
 // leave this out of OgreIncludes as it conflicts with other files requiring
 // gl.h
 #ifdef _MSC_VER
@@ -28,6 +36,7 @@
 #include <ignition/common/Console.hh>
 
 #include "ignition/rendering/Material.hh"
+#include "ignition/rendering/Profiler.hh"
 
 #include "ignition/rendering/ogre2/Ogre2Includes.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
@@ -37,6 +46,12 @@
 #include "ignition/rendering/ogre2/Ogre2RenderTarget.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
 
+#include "Ogre2FrameLimiter.hh"
+#include "Ogre2GpuTimer.hh"
+#include "Ogre2ReadbackManager.hh"
+#include "Ogre2RenderStats.hh"
+#include "Ogre2RenderTexturePool.hh"
+
 namespace ignition
 {
 namespace rendering
@@ -86,9 +101,27 @@ class Ogre2RenderTargetCompositorListener :
 /// \brief Private data class for Ogre2RenderTarget
 class ignition::rendering::Ogre2RenderTargetPrivate
 {
+  /// \brief Scale the viewports the scene is drawn to with dynamic
+  /// resolution and the region the upscale material samples
+  /// \param[in] _workspace Compositor workspace
+  /// \param[in] _baseNodeName Name of the base node definition
+  /// \param[in] _materialName Name of the upscale material
+  /// \param[in] _width Width of the render target
+  /// \param[in] _height Height of the render target
+  public: void ApplyResolutionScale(Ogre::CompositorWorkspace *_workspace,
+      const std::string &_baseNodeName, const std::string &_materialName,
+      unsigned int _width, unsigned int _height);
+
   /// \brief Listener for chaning compositor pass properties
   public: Ogre2RenderTargetCompositorListener *rtListener = nullptr;
 
+  /// \brief Listener timing the compositor passes, forwarding the events
+  /// to rtListener
+  public: std::unique_ptr<Ogre2GpuTimerListener> gpuTimerListener;
+
+  /// \brief Id of the GPU timer client the passes are charged to
+  public: unsigned int gpuTimerClient = 0u;
+
   /// \brief Name of sky box material
   public: const std::string kSkyboxMaterialName = "SkyBox";
 
@@ -98,8 +131,19 @@ class ignition::rendering::Ogre2RenderTargetPrivate
   /// \brief Name of final rendering compositor node
   public: const std::string kFinalNodeName = "FinalComposition";
 
-  /// \brief Name of shadow compositor node
-  public: const std::string kShadowNodeName = "PbsMaterialsShadowNode";
+  /// \brief Version of the static shadow maps last rendered by the
+  /// compositor workspace, 0 if the workspace nodes were just created
+  public: uint64_t staticShadowsVersion = 0u;
+
+  /// \brief True if the render target renders shadows
+  public: bool shadowsEnabled = true;
+
+  /// \brief Size of shadow maps in pixels, 0 for the default size
+  public: unsigned int shadowMapSize = 0u;
+
+  /// \brief Name of the shadow node definition used by the compositor
+  /// workspace, empty if it renders without shadows
+  public: std::string shadowNodeName;
 
   /// \brief Helper class that applies the material to the render target
   Ogre2RenderTargetMaterialPtr materialApplicator[2];
@@ -111,11 +155,257 @@ class ignition::rendering::Ogre2RenderTargetPrivate
   /// actual window
   ///
   Ogre::Texture *ogreTexture[2] = {nullptr, nullptr};
+
+  /// \brief Single channel texture the final compositor node draws the
+  /// Bayer mosaic of the output to, null if the format is not a Bayer
+  /// format
+  Ogre::Texture *bayerTexture = nullptr;
+
+  /// \brief Pixel format the compositor definitions were built for
+  public: PixelFormat compositorFormat = PF_UNKNOWN;
+
+  /// \brief Name of the material upscaling the scene drawn with dynamic
+  /// resolution, cloned for each render target
+  public: const std::string kUpscaleMaterialName = "DynamicResolutionUpscale";
+
+  /// \brief Name of the texture of the base node the scene is drawn to
+  /// with dynamic resolution
+  public: const std::string kSceneTextureName = "rt_scene";
+
+  /// \brief True if the scene is drawn at a scaled resolution
+  public: bool dynamicResolution = false;
+
+  /// \brief True if the compositor definitions were built with dynamic
+  /// resolution
+  public: bool compositorDynamicResolution = false;
+
+  /// \brief Scale of the resolution the scene is drawn at
+  public: double resolutionScale = 1.0;
 };
 
 using namespace ignition;
 using namespace rendering;
 
+//////////////////////////////////////////////////
+void Ogre2RenderTargetPrivate::ApplyResolutionScale(
+    Ogre::CompositorWorkspace *_workspace, const std::string &_baseNodeName,
+    const std::string &_materialName, unsigned int _width,
+    unsigned int _height)
+{
+  if (!_workspace || _width == 0u || _height == 0u)
+    return;
+
+  Ogre::CompositorNode *node = _workspace->findNodeNoThrow(_baseNodeName);
+  if (!node)
+    return;
+
+  unsigned int width = std::max(1u, static_cast<unsigned int>(
+      std::lround(this->resolutionScale * _width)));
+  unsigned int height = std::max(1u, static_cast<unsigned int>(
+      std::lround(this->resolutionScale * _height)));
+  width = std::min(width, _width);
+  height = std::min(height, _height);
+
+  // ogre truncates the size of viewports in pixels, aim at the middle of
+  // the last pixel
+  Ogre::Real vpWidth = width == _width ? 1.0f :
+      (width + 0.5f) / static_cast<Ogre::Real>(_width);
+  Ogre::Real vpHeight = height == _height ? 1.0f :
+      (height + 0.5f) / static_cast<Ogre::Real>(_height);
+  for (const auto &channel : node->getLocalTextures())
+  {
+    for (unsigned short i = 0u; i < channel.target->getNumViewports(); ++i)
+    {
+      Ogre::Viewport *vp = channel.target->getViewport(i);
+      if (!Ogre::Math::RealEqual(vp->getWidth(), vpWidth) ||
+          !Ogre::Math::RealEqual(vp->getHeight(), vpHeight))
+      {
+        vp->setDimensions(0.0f, 0.0f, vpWidth, vpHeight);
+      }
+    }
+  }
+
+  Ogre::MaterialPtr mat =
+      Ogre::MaterialManager::getSingleton().getByName(_materialName);
+  if (!mat)
+    return;
+  Ogre::Real w = static_cast<Ogre::Real>(_width);
+  Ogre::Real h = static_cast<Ogre::Real>(_height);
+  mat->getTechnique(0u)->getPass(0u)->getFragmentProgramParameters()->
+      setNamedConstant("uvScale", Ogre::Vector4(width / w, height / h,
+      (width - 0.5f) / w, (height - 0.5f) / h));
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the material drawing the Bayer mosaic of a pixel format
+/// \param[in] _format Pixel format
+/// \return Name of the material, empty if the format is not a Bayer format
+static std::string bayerMaterialName(PixelFormat _format)
+{
+  switch (_format)
+  {
+    case PF_BAYER_RGGB8:
+      return "BayerRGGB";
+    case PF_BAYER_BGGR8:
+      return "BayerBGGR";
+    case PF_BAYER_GBGR8:
+      return "BayerGBGR";
+    case PF_BAYER_GRGB8:
+      return "BayerGRGB";
+    default:
+      return std::string();
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Connect the base and final nodes of a render target workspace,
+/// without render passes in between
+/// \param[in] _workDef Workspace definition
+/// \param[in] _baseNode Name of the base scene pass node definition
+/// \param[in] _finalNode Name of the final compositor node definition
+/// \param[in] _isRenderWindow True if the workspace renders to a window
+/// \param[in] _bayer True if the final node draws a Bayer mosaic
+static void connectWorkspaceNodes(Ogre::CompositorWorkspaceDef *_workDef,
+    const std::string &_baseNode, const std::string &_finalNode,
+    bool _isRenderWindow, bool _bayer)
+{
+  _workDef->connectExternal(0, _baseNode, 0);
+  _workDef->connectExternal(1, _baseNode, 1);
+
+  if (!_isRenderWindow)
+  {
+    _workDef->connect(_baseNode, _finalNode);
+    if (_bayer)
+      _workDef->connectExternal(2, _finalNode, 2);
+  }
+  else
+  {
+    // connect the last render pass to the final compositor node
+    // but only input, since output goes to the render window
+    _workDef->connect(_baseNode, 0, _finalNode, 0);
+    _workDef->connectExternal(2, _finalNode, 1);
+  }
+}
+
+/// \brief Compositor node drawing consecutive per pixel render passes with
+/// one fragment shader
+struct FusedRenderPassNode
+{
+  /// \brief Name of the compositor node definition
+  std::string nodeDefName;
+
+  /// \brief Material drawing the passes, null if the shader failed to
+  /// compile
+  Ogre::Material *material = nullptr;
+};
+
+//////////////////////////////////////////////////
+/// \brief Get the compositor node drawing render passes with a fragment
+/// shader generated from their FusedShaderCode. Nodes are created once per
+/// sequence of passes and reused when the compositor chain is rebuilt.
+/// \param[in] _passes Passes drawn by the node, in order
+/// \param[in] _prefixes Prefixes given to FusedShaderCode
+/// \param[in] _codes Shader code of the passes
+/// \return Fused node, with a null material on failure
+static FusedRenderPassNode fusedRenderPassNode(
+    const std::vector<Ogre2RenderPass *> &_passes,
+    const std::vector<std::string> &_prefixes,
+    const std::vector<std::string> &_codes)
+{
+  static std::map<std::string, FusedRenderPassNode> fusedNodes;
+
+  std::string key;
+  for (size_t i = 0u; i < _passes.size(); ++i)
+  {
+    key += _passes[i]->OgreCompositorNodeDefinitionName() + ":" +
+        _prefixes[i] + ";";
+  }
+  auto it = fusedNodes.find(key);
+  if (it != fusedNodes.end())
+    return it->second;
+
+  FusedRenderPassNode &fusedNode = fusedNodes[key];
+  fusedNode.nodeDefName = "FusedRenderPassNode_" +
+      std::to_string(fusedNodes.size());
+
+  // the passes are applied one after the other to the input pixel
+  std::stringstream source;
+  source << "#version 330\n"
+         << "uniform sampler2D RT;\n"
+         << "in block\n"
+         << "{\n"
+         << "  vec2 uv0;\n"
+         << "} inPs;\n"
+         << "out vec4 fragColor;\n";
+  for (const auto &code : _codes)
+    source << code;
+  source << "void main()\n"
+         << "{\n"
+         << "  vec2 uv = inPs.uv0.xy;\n"
+         << "  vec4 color = texture(RT, uv);\n";
+  for (const auto &prefix : _prefixes)
+    source << "  color = " << prefix << "Apply(color, uv);\n";
+  source << "  fragColor = color;\n"
+         << "}\n";
+
+  Ogre::HighLevelGpuProgramPtr fragmentProgram =
+      Ogre::HighLevelGpuProgramManager::getSingleton().createProgram(
+      fusedNode.nodeDefName + "_FS",
+      Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
+      "glsl", Ogre::GPT_FRAGMENT_PROGRAM);
+  fragmentProgram->setSource(source.str());
+  fragmentProgram->load();
+  if (fragmentProgram->hasCompileError() || !fragmentProgram->isSupported())
+  {
+    ignerr << "Unable to compile the fused shader of render passes ["
+           << key << "], drawing them separately" << std::endl;
+    return fusedNode;
+  }
+
+  // full screen quad material, set up like the render pass materials
+  // defined in scripts. The vertex program only forwards the uvs.
+  Ogre::MaterialPtr ogreMat = Ogre::MaterialManager::getSingleton().create(
+      fusedNode.nodeDefName,
+      Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+  Ogre::Pass *pass = ogreMat->getTechnique(0)->getPass(0);
+  pass->setDepthCheckEnabled(false);
+  pass->setDepthWriteEnabled(false);
+  pass->setCullingMode(Ogre::CULL_NONE);
+  pass->setVertexProgram("GaussianNoiseVS");
+  pass->setFragmentProgram(fragmentProgram->getName());
+  pass->getFragmentProgramParameters()->setNamedConstant("RT", 0);
+  Ogre::TextureUnitState *texUnit = pass->createTextureUnitState();
+  texUnit->setTextureAddressingMode(Ogre::TextureUnitState::TAM_CLAMP);
+  texUnit->setTextureFiltering(Ogre::TFO_TRILINEAR);
+  ogreMat->load();
+  fusedNode.material = ogreMat.get();
+
+  // same layout as the nodes of the render passes: the result is drawn to
+  // rt_output and the render textures are swapped for the next pass
+  Ogre::CompositorManager2 *ogreCompMgr =
+      Ogre2RenderEngine::Instance()->OgreRoot()->getCompositorManager2();
+  Ogre::CompositorNodeDef *nodeDef =
+      ogreCompMgr->addNodeDefinition(fusedNode.nodeDefName);
+  nodeDef->addTextureSourceName("rt_input", 0,
+      Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+  nodeDef->addTextureSourceName("rt_output", 1,
+      Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+  nodeDef->setNumTargetPass(1);
+  Ogre::CompositorTargetDef *targetDef = nodeDef->addTargetPass("rt_output");
+  targetDef->setNumPasses(1);
+  {
+    Ogre::CompositorPassQuadDef *passQuad =
+        static_cast<Ogre::CompositorPassQuadDef *>(
+        targetDef->addPass(Ogre::PASS_QUAD));
+    passQuad->mMaterialName = fusedNode.nodeDefName;
+    passQuad->addQuadTextureSource(0, "rt_input", 0);
+  }
+  nodeDef->mapOutputChannel(0, "rt_output");
+  nodeDef->mapOutputChannel(1, "rt_input");
+
+  return fusedNode;
+}
+
 //////////////////////////////////////////////////
 // Ogre2RenderTarget
 //////////////////////////////////////////////////
@@ -157,6 +447,56 @@ void Ogre2RenderTarget::BuildCompositor()
   // PbsMaterials.compositor file
   std::string wsDefName = "PbsMaterialWorkspace_" + this->Name();
   this->ogreCompositorWorkspaceDefName = wsDefName;
+  bool bayer = this->dataPtr->bayerTexture != nullptr;
+
+  // material upscaling the scene drawn with dynamic resolution
+  if (this->dataPtr->dynamicResolution)
+  {
+    Ogre::MaterialManager &matManager = Ogre::MaterialManager::getSingleton();
+    std::string upscaleMatName = this->dataPtr->kUpscaleMaterialName + "_" +
+        this->Name();
+    if (!matManager.getByName(upscaleMatName))
+    {
+      auto upscaleMat =
+          matManager.getByName(this->dataPtr->kUpscaleMaterialName);
+      if (!upscaleMat)
+      {
+        ignerr << "Unable to find dynamic resolution material, drawing "
+               << "the scene at full resolution" << std::endl;
+        this->dataPtr->dynamicResolution = false;
+      }
+      else
+      {
+        upscaleMat->clone(upscaleMatName);
+      }
+    }
+  }
+  bool dynamicResolution = this->dataPtr->dynamicResolution;
+
+  // material compositing order independent transparency
+  if (this->dataPtr->orderIndependentTransparency)
+  {
+    Ogre::MaterialManager &matManager = Ogre::MaterialManager::getSingleton();
+    std::string oitMatName = this->dataPtr->kOitMaterialName + "_" +
+        this->Name();
+    if (!matManager.getByName(oitMatName))
+    {
+      auto oitMat = matManager.getByName(this->dataPtr->kOitMaterialName);
+      if (!oitMat)
+      {
+        ignerr << "Unable to find order independent transparency "
+               << "material, drawing transparent materials sorted"
+               << std::endl;
+        this->dataPtr->orderIndependentTransparency = false;
+      }
+      else
+      {
+        oitMat->clone(oitMatName);
+      }
+    }
+  }
+  bool oit = this->dataPtr->orderIndependentTransparency;
+
   if (!ogreCompMgr->hasWorkspaceDefinition(wsDefName))
   {
     // PbsMaterialsRenderingNode
@@ -169,9 +509,47 @@ void Ogre2RenderTarget::BuildCompositor()
     nodeDef->addTextureSourceName(
           "rt1", 1u, Ogre::TextureDefinitionBase::TEXTURE_INPUT);
 
-    nodeDef->setNumTargetPass(2);
+    // with dynamic resolution the scene is drawn to a region of a texture
+    // of the node, whose viewports are scaled before each render, then
+    // upscaled to rt0. The render passes and the ping pong of rt0 and rt1
+    // are unchanged.
+    std::string sceneTargetName = "rt0";
+    if (dynamicResolution)
+    {
+      sceneTargetName = this->dataPtr->kSceneTextureName;
+      Ogre::TextureDefinitionBase::TextureDefinition *texDef =
+          nodeDef->addTextureDefinition(sceneTargetName);
+      texDef->width = 0;
+      texDef->height = 0;
+      texDef->widthFactor = 1.0f;
+      texDef->heightFactor = 1.0f;
+      texDef->formatList.push_back(Ogre2Conversions::Convert(this->format));
+      texDef->fsaa = true;
+    }
+
+    // with order independent transparency the scene is drawn to a texture
+    // of the node with two more attachments the transparent materials
+    // accumulate into, then composited to the texture above
+    std::string oitTargetName = sceneTargetName;
+    if (oit)
+    {
+      oitTargetName = this->dataPtr->kOitTextureName;
+      Ogre::TextureDefinitionBase::TextureDefinition *texDef =
+          nodeDef->addTextureDefinition(oitTargetName);
+      texDef->width = 0;
+      texDef->height = 0;
+      texDef->widthFactor = 1.0f;
+      texDef->heightFactor = 1.0f;
+      texDef->formatList.push_back(Ogre2Conversions::Convert(this->format));
+      texDef->formatList.push_back(Ogre::PF_FLOAT16_RGBA);
+      texDef->formatList.push_back(Ogre::PF_FLOAT16_GR);
+      texDef->fsaa = true;
+    }
+
+    nodeDef->setNumTargetPass(1u + (oit ? 1u : 0u) +
+        (dynamicResolution ? 1u : 0u));
     Ogre::CompositorTargetDef *rt0TargetDef =
-        nodeDef->addTargetPass("rt0");
+        nodeDef->addTargetPass(oitTargetName);
 
     if (validBackground)
       rt0TargetDef->setNumPasses(3);
@@ -182,7 +560,9 @@ void Ogre2RenderTarget::BuildCompositor()
       Ogre::CompositorPassClearDef *passClear =
           static_cast<Ogre::CompositorPassClearDef *>(
           rt0TargetDef->addPass(Ogre::PASS_CLEAR));
-      passClear->mColourValue = this->ogreBackgroundColor;
+      // the background is composited with order independent transparency
+      passClear->mColourValue = oit ? Ogre::ColourValue(0.0f, 0.0f, 0.0f,
+          0.0f) : this->ogreBackgroundColor;
 
       if (validBackground)
       {
@@ -200,8 +580,46 @@ void Ogre2RenderTarget::BuildCompositor()
       Ogre::CompositorPassSceneDef *passScene =
           static_cast<Ogre::CompositorPassSceneDef *>(
           rt0TargetDef->addPass(Ogre::PASS_SCENE));
-      passScene->mShadowNode = this->dataPtr->kShadowNodeName;
+      this->dataPtr->shadowNodeName.clear();
+      if (this->dataPtr->shadowsEnabled)
+      {
+        this->dataPtr->shadowNodeName =
+            this->scene->ShadowNodeName(this->dataPtr->shadowMapSize);
+        passScene->mShadowNode = this->dataPtr->shadowNodeName;
+      }
       passScene->mIncludeOverlays = true;
+      if (oit)
+      {
+        passScene->mIdentifier =
+            Ogre2RenderTargetCompositorListener::kWeightedOitPassId;
+      }
+    }
+
+    if (oit)
+    {
+      Ogre::CompositorTargetDef *compositeTargetDef =
+          nodeDef->addTargetPass(sceneTargetName);
+      compositeTargetDef->setNumPasses(1);
+      Ogre::CompositorPassQuadDef *passQuad =
+          static_cast<Ogre::CompositorPassQuadDef *>(
+          compositeTargetDef->addPass(Ogre::PASS_QUAD));
+      passQuad->mMaterialName = this->dataPtr->kOitMaterialName + "_" +
+          this->Name();
+      for (unsigned int i = 0u; i < 3u; ++i)
+        passQuad->addQuadTextureSource(i, oitTargetName, i);
+    }
+
+    if (dynamicResolution)
+    {
+      Ogre::CompositorTargetDef *upscaleTargetDef =
+          nodeDef->addTargetPass("rt0");
+      upscaleTargetDef->setNumPasses(1);
+      Ogre::CompositorPassQuadDef *passQuad =
+          static_cast<Ogre::CompositorPassQuadDef *>(
+          upscaleTargetDef->addPass(Ogre::PASS_QUAD));
+      passQuad->mMaterialName = this->dataPtr->kUpscaleMaterialName + "_" +
+          this->Name();
+      passQuad->addQuadTextureSource(0, sceneTargetName, 0);
     }
 
     nodeDef->mapOutputChannel(0, "rt0");
@@ -216,6 +634,11 @@ void Ogre2RenderTarget::BuildCompositor()
         Ogre::TextureDefinitionBase::TEXTURE_INPUT);
     finalNodeDef->addTextureSourceName("rt_output", 1,
         Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+    if (bayer)
+    {
+      finalNodeDef->addTextureSourceName("rt_bayer", 2,
+          Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+    }
 
     finalNodeDef->setNumTargetPass(2);
     Ogre::CompositorTargetDef *outTargetDef =
@@ -239,24 +662,38 @@ void Ogre2RenderTarget::BuildCompositor()
       passScene->mLastRQ = 255;
 
     }
+    if (bayer)
+    {
+      // draw the Bayer mosaic of the output so that only one byte per
+      // pixel is read back
+      Ogre::CompositorTargetDef *bayerTargetDef =
+          finalNodeDef->addTargetPass("rt_bayer");
+      bayerTargetDef->setNumPasses(1);
+      Ogre::CompositorPassQuadDef *passQuad =
+          static_cast<Ogre::CompositorPassQuadDef *>(
+          bayerTargetDef->addPass(Ogre::PASS_QUAD));
+      passQuad->mMaterialName = bayerMaterialName(this->format);
+      passQuad->addQuadTextureSource(0, "rt_output", 0);
+    }
     Ogre::CompositorWorkspaceDef *workDef =
         ogreCompMgr->addWorkspaceDefinition(wsDefName);
+    connectWorkspaceNodes(workDef, nodeDefName, finalNodeDefName,
+        this->IsRenderWindow(), bayer);
+  }
+  this->dataPtr->compositorFormat = this->format;
+  this->dataPtr->compositorDynamicResolution = dynamicResolution;
+  this->dataPtr->compositorOit = oit;
+  this->colorDirty = true;
 
-    workDef->connectExternal(0, nodeDefName, 0);
-    workDef->connectExternal(1, nodeDefName, 1);
+  this->CreateWorkspace();
+}
 
-    if (!this->IsRenderWindow())
-    {
-      workDef->connect(nodeDefName, finalNodeDefName);
-    }
-    else
-    {
-      // connect the last render pass to the final compositor node
-      // but only input, since output goes to the render window
-      workDef->connect(nodeDefName, 0, finalNodeDefName, 0);
-      workDef->connectExternal(2,  finalNodeDefName, 1);
-    }
-  }
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::CreateWorkspace()
+{
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
 
   auto &manager = Ogre::TextureManager::getSingleton();
   Ogre::CompositorChannelVec externalTargets(2u);
@@ -269,6 +706,15 @@ void Ogre2RenderTarget::BuildCompositor()
     externalTargets[i].textures.push_back(
           manager.getByName(this->dataPtr->ogreTexture[srcIdx]->getName()));
   }
+  if (this->dataPtr->bayerTexture)
+  {
+    Ogre::CompositorChannel bayerTarget;
+    bayerTarget.target =
+        this->dataPtr->bayerTexture->getBuffer()->getRenderTarget();
+    bayerTarget.textures.push_back(
+        manager.getByName(this->dataPtr->bayerTexture->getName()));
+    externalTargets.push_back(bayerTarget);
+  }
 
   this->SyncOgreTextureVars();
 
@@ -278,11 +724,55 @@ void Ogre2RenderTarget::BuildCompositor()
       this->ogreCompositorWorkspaceDefName, false);
 
   this->dataPtr->rtListener = new Ogre2RenderTargetCompositorListener(this);
-  this->ogreCompositorWorkspace->setListener(this->dataPtr->rtListener);
+  this->dataPtr->gpuTimerListener.reset(new Ogre2GpuTimerListener(
+      this->dataPtr->gpuTimerClient, "scene", this->dataPtr->rtListener));
+  this->dataPtr->gpuTimerListener->SetNodeLabel(
+      this->ogreCompositorWorkspaceDefName + "/" +
+      this->dataPtr->kFinalNodeName, "final");
+  this->dataPtr->gpuTimerListener->SetRenderPassLabels(this->renderPasses);
+  this->ogreCompositorWorkspace->setListener(
+      this->dataPtr->gpuTimerListener.get());
+  this->dataPtr->staticShadowsVersion = 0u;
 }
 
 //////////////////////////////////////////////////
 void Ogre2RenderTarget::DestroyCompositor()
+{
+  if (!this->ogreCompositorWorkspace)
+    return;
+
+  this->RemoveWorkspace();
+
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
+  ogreCompMgr->removeWorkspaceDefinition(this->ogreCompositorWorkspaceDefName);
+  ogreCompMgr->removeNodeDefinition(this->ogreCompositorWorkspaceDefName +
+      "/" + this->dataPtr->kBaseNodeName);
+  ogreCompMgr->removeNodeDefinition(this->ogreCompositorWorkspaceDefName +
+      "/" + this->dataPtr->kFinalNodeName);
+
+  Ogre::MaterialManager &matManager = Ogre::MaterialManager::getSingleton();
+  std::string upscaleMatName = this->dataPtr->kUpscaleMaterialName + "_" +
+      this->Name();
+  if (matManager.resourceExists(upscaleMatName))
+    matManager.remove(upscaleMatName);
+  this->dataPtr->compositorDynamicResolution = false;
+
+  std::string oitMatName = this->dataPtr->kOitMaterialName + "_" +
+      this->Name();
+  if (matManager.resourceExists(oitMatName))
+    matManager.remove(oitMatName);
+  if (Ogre2WeightedOitListener::Instance()->ActiveCamera() ==
+      this->ogreCamera)
+  {
+    Ogre2WeightedOitListener::Instance()->SetActiveCamera(nullptr);
+  }
+  this->dataPtr->compositorOit = false;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::RemoveWorkspace()
 {
   if (!this->ogreCompositorWorkspace)
     return;
@@ -313,13 +803,9 @@ void Ogre2RenderTarget::DestroyCompositor()
   Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
   this->ogreCompositorWorkspace->setListener(nullptr);
   ogreCompMgr->removeWorkspace(this->ogreCompositorWorkspace);
-  ogreCompMgr->removeWorkspaceDefinition(this->ogreCompositorWorkspaceDefName);
-  ogreCompMgr->removeNodeDefinition(this->ogreCompositorWorkspaceDefName +
-      "/" + this->dataPtr->kBaseNodeName);
-  ogreCompMgr->removeNodeDefinition(this->ogreCompositorWorkspaceDefName +
-      "/" + this->dataPtr->kFinalNodeName);
 
   this->ogreCompositorWorkspace = nullptr;
+  this->dataPtr->gpuTimerListener.reset();
   delete this->dataPtr->rtListener;
   this->dataPtr->rtListener = nullptr;
 }
@@ -334,7 +820,6 @@ void Ogre2RenderTarget::RebuildCompositor()
 //////////////////////////////////////////////////
 void Ogre2RenderTarget::Copy(Image &_image) const
 {
-  // TODO(anyone) handle Bayer conversions
   // TODO(anyone) handle ogre version differences
 
   if (_image.Width() != this->width || _image.Height() != this->height)
@@ -346,7 +831,73 @@ void Ogre2RenderTarget::Copy(Image &_image) const
   void *data = _image.Data();
   Ogre::PixelFormat imageFormat = Ogre2Conversions::Convert(_image.Format());
   Ogre::PixelBox ogrePixelBox(this->width, this->height, 1, imageFormat, data);
-  this->RenderTarget()->copyContentsToMemory(ogrePixelBox);
+  // images wrapping user buffers may have padded rows
+  ogrePixelBox.rowPitch =
+      _image.RowStride() / PixelUtil::BytesPerPixel(_image.Format());
+
+  // Bayer images are read from the mosaic drawn by the final compositor node
+  Ogre::RenderTarget *target = this->RenderTarget();
+  if (PixelUtil::IsBayer(_image.Format()))
+  {
+    if (!this->dataPtr->bayerTexture)
+    {
+      ignerr << "Render target has no Bayer output, unable to copy to a "
+             << PixelUtil::Name(_image.Format()) << " image" << std::endl;
+      return;
+    }
+    ogrePixelBox.format = Ogre::PF_L8;
+    target = this->dataPtr->bayerTexture->getBuffer()->getRenderTarget();
+  }
+  Ogre2ReadbackManager::Instance()->Read(target, ogrePixelBox);
+  Ogre2RenderStats::Instance()->AddReadback(this->dataPtr->gpuTimerClient,
+      _image.MemorySize());
+}
+
+//////////////////////////////////////////////////
+bool Ogre2RenderTarget::CopyRegion(Image &_image, unsigned int _x,
+    unsigned int _y) const
+{
+  if (_image.Width() == 0u || _image.Height() == 0u ||
+      _x + _image.Width() > this->width ||
+      _y + _image.Height() > this->height)
+  {
+    ignerr << "Invalid image region" << std::endl;
+    return false;
+  }
+
+  Ogre::Texture *texture = this->OgreTexture();
+  Ogre::PixelFormat imageFormat = Ogre2Conversions::Convert(_image.Format());
+  if (PixelUtil::IsBayer(_image.Format()))
+  {
+    if (!this->dataPtr->bayerTexture)
+    {
+      ignerr << "Render target has no Bayer output, unable to copy to a "
+             << PixelUtil::Name(_image.Format()) << " image" << std::endl;
+      return false;
+    }
+    imageFormat = Ogre::PF_L8;
+    texture = this->dataPtr->bayerTexture;
+  }
+  if (!texture)
+  {
+    ignerr << "Copying a region of a render window is not supported"
+           << std::endl;
+    return false;
+  }
+
+  Ogre::PixelBox ogrePixelBox(_image.Width(), _image.Height(), 1,
+      imageFormat, _image.Data());
+  ogrePixelBox.rowPitch =
+      _image.RowStride() / PixelUtil::BytesPerPixel(_image.Format());
+  Ogre::Box srcBox(_x, _y, _x + _image.Width(), _y + _image.Height());
+  if (!Ogre2ReadbackManager::Instance()->ReadRegion(texture, srcBox,
+      ogrePixelBox))
+  {
+    return false;
+  }
+  Ogre2RenderStats::Instance()->AddReadback(this->dataPtr->gpuTimerClient,
+      _image.MemorySize());
+  return true;
 }
 
 //////////////////////////////////////////////////
@@ -405,6 +956,7 @@ void Ogre2RenderTarget::SetAntiAliasing(unsigned int _aa)
 //////////////////////////////////////////////////
 void Ogre2RenderTarget::PreRender()
 {
+  IGN_RENDERING_PROFILE("Ogre2RenderTarget::PreRender");
   BaseRenderTarget::PreRender();
   this->UpdateBackgroundColor();
 
@@ -425,33 +977,28 @@ void Ogre2RenderTarget::PostRender()
 //////////////////////////////////////////////////
 void Ogre2RenderTarget::Render()
 {
-  // TODO(anyone)
-  // There is current not an easy solution to manually updating
-  // render textures:
-  // https://forums.ogre3d.org/viewtopic.php?t=84687
-  this->ogreCompositorWorkspace->setEnabled(true);
+  IGN_RENDERING_PROFILE("Ogre2RenderTarget::Render");
+  this->scene->UpdateStaticShadows(this->ogreCompositorWorkspace,
+      this->dataPtr->shadowNodeName, this->dataPtr->staticShadowsVersion);
+
+  if (this->dataPtr->compositorDynamicResolution)
+  {
+    this->dataPtr->ApplyResolutionScale(this->ogreCompositorWorkspace,
+        this->ogreCompositorWorkspaceDefName + "/" +
+        this->dataPtr->kBaseNodeName,
+        this->dataPtr->kUpscaleMaterialName + "_" + this->Name(),
+        this->width, this->height);
+  }
+
   auto engine = Ogre2RenderEngine::Instance();
-  engine->OgreRoot()->renderOneFrame();
-  this->ogreCompositorWorkspace->setEnabled(false);
-
-  // The code below for manual updating render textures was suggested in ogre
-  // forum but it does not seem to work
-  // this->scene->OgreSceneManager()->updateSceneGraph();
-  // this->ogreCompositorWorkspace->_validateFinalTarget();
-  // engine->OgreRoot()->getRenderSystem()->_beginFrameOnce();
-  // this->ogreCompositorWorkspace->_beginUpdate(false);
-  // this->ogreCompositorWorkspace->_update();
-  // this->ogreCompositorWorkspace->_endUpdate(false);
-
-  // this->scene->OgreSceneManager()->_frameEnded();
-  // for (size_t i=0; i < Ogre::HLMS_MAX; ++i)
-  // {
-  //   Ogre::Hlms *hlms = engine->OgreRoot()->getHlmsManager()->getHlms(
-  //       static_cast<Ogre::HlmsTypes>(i));
-  //   if(hlms)
-  //     hlms->frameEnded();
-  // }
-  // engine->OgreRoot()->getRenderSystem()->_update();
+  if (engine->RenderBatchActive())
+  {
+    engine->AddToRenderBatch(this->shared_from_this(),
+        this->ogreCompositorWorkspace);
+    return;
+  }
+
+  engine->RenderWorkspaces({this->ogreCompositorWorkspace});
 }
 
 //////////////////////////////////////////////////
@@ -473,30 +1020,26 @@ void Ogre2RenderTarget::DestroyTargetImpl()
 
   this->DestroyCompositor();
 
-  auto &manager = Ogre::TextureManager::getSingleton();
-
   this->materialApplicator.reset();
 
+  // the textures are kept by the pool for targets of the same size
+  auto pool = Ogre2RenderTexturePool::Instance();
   for( size_t i = 0u; i < 2u; ++i )
   {
-    manager.unload(this->dataPtr->ogreTexture[i]->getName());
-    manager.remove(this->dataPtr->ogreTexture[i]->getName());
-
-    // TODO(anyone) there is memory leak when a render texture is destroyed.
-    // The RenderSystem::_cleanupDepthBuffers method used in ogre1 does not
-    // seem to work in ogre2
-
     this->dataPtr->materialApplicator[i].reset();
+    pool->Release(this->dataPtr->ogreTexture[i]);
     this->dataPtr->ogreTexture[i] = nullptr;
   }
 
+  pool->Release(this->dataPtr->bayerTexture);
+  this->dataPtr->bayerTexture = nullptr;
+
   this->SyncOgreTextureVars();
 }
 
 //////////////////////////////////////////////////
 void Ogre2RenderTarget::BuildTargetImpl()
 {
-  Ogre::TextureManager &manager = Ogre::TextureManager::getSingleton();
   Ogre::PixelFormat ogreFormat = Ogre2Conversions::Convert(this->format);
 
   // check if target fsaa is supported
@@ -521,16 +1064,23 @@ void Ogre2RenderTarget::BuildTargetImpl()
     }
   }
 
+  auto pool = Ogre2RenderTexturePool::Instance();
   for( size_t i = 0u; i < 2u; ++i )
   {
     // Ogre 2 PBS expects gamma correction to be enabled
     // Only the second target uses FSAA.
     // Note: It's not guaranteed the 2nd target will remain
     // the one using FSAA
-    this->dataPtr->ogreTexture[i] = (manager.createManual(
-        this->name + std::to_string(i), "General",
-        Ogre::TEX_TYPE_2D, this->width, this->height, 0, ogreFormat,
-        Ogre::TU_RENDERTARGET, 0, true, i == 1u ? fsaa : 0)).get();
+    this->dataPtr->ogreTexture[i] = pool->Acquire(this->width, this->height,
+        ogreFormat, i == 1u ? fsaa : 0, true);
+  }
+
+  // single channel target of the Bayer mosaic. It stores gamma corrected
+  // values itself, see bayer_fs.glsl
+  if (PixelUtil::IsBayer(this->format) && !this->IsRenderWindow())
+  {
+    this->dataPtr->bayerTexture = pool->Acquire(this->width, this->height,
+        Ogre::PF_L8, 0, false);
   }
 
   this->SyncOgreTextureVars();
@@ -548,6 +1098,12 @@ unsigned int Ogre2RenderTarget::GLIdImpl() const
   return static_cast<unsigned int>(texId);
 }
 
+//////////////////////////////////////////////////
+Ogre::Texture *Ogre2RenderTarget::OgreTexture() const
+{
+  return this->dataPtr->ogreTexture[1];
+}
+
 //////////////////////////////////////////////////
 Ogre::RenderTarget *Ogre2RenderTarget::RenderTargetImpl() const
 {
@@ -569,7 +1125,24 @@ void Ogre2RenderTarget::SetVisibilityMask(uint32_t _mask)
 //////////////////////////////////////////////////
 void Ogre2RenderTarget::UpdateBackgroundColor()
 {
-  if (this->colorDirty)
+  if (this->colorDirty && this->dataPtr->compositorOit)
+  {
+    // the target is cleared to transparent black and the background is
+    // composited, the sky covers it
+    Ogre::MaterialPtr mat = Ogre::MaterialManager::getSingleton().getByName(
+        this->dataPtr->kOitMaterialName + "_" + this->Name());
+    bool sky = this->backgroundMaterial &&
+        !this->backgroundMaterial->EnvironmentMap().empty();
+    if (mat)
+    {
+      Ogre::ColourValue color = sky ? Ogre::ColourValue(0.0f, 0.0f, 0.0f,
+          1.0f) : this->ogreBackgroundColor;
+      mat->getTechnique(0u)->getPass(0u)->getFragmentProgramParameters()->
+          setNamedConstant("backgroundColor", color);
+    }
+    this->colorDirty = false;
+  }
+  else if (this->colorDirty)
   {
     // set background color in compositor clear pass def
     auto nodeSeq = this->ogreCompositorWorkspace->getNodeSequence();
@@ -619,6 +1192,19 @@ void Ogre2RenderTarget::UpdateBackgroundMaterial()
 //////////////////////////////////////////////////
 void Ogre2RenderTarget::UpdateRenderPassChain()
 {
+  // the workspace nodes, including the shadow node, may be recreated
+  if (this->renderPassDirty)
+    this->dataPtr->staticShadowsVersion = 0u;
+
+  // passes may depend on the projection of the camera
+  for (const auto &pass : this->renderPasses)
+  {
+    Ogre2RenderPass *ogre2RenderPass =
+        dynamic_cast<Ogre2RenderPass *>(pass.get());
+    if (ogre2RenderPass)
+      ogre2RenderPass->SetOgreCamera(this->ogreCamera);
+  }
+
   UpdateRenderPassChain(this->ogreCompositorWorkspace,
       this->ogreCompositorWorkspaceDefName,
       this->ogreCompositorWorkspaceDefName + "/" +
@@ -642,6 +1228,10 @@ void Ogre2RenderTarget::UpdateRenderPassChain()
 
   this->SyncOgreTextureVars();
 
+  // fused nodes may have been created or regrouped
+  if (this->dataPtr->gpuTimerListener)
+    this->dataPtr->gpuTimerListener->SetRenderPassLabels(this->renderPasses);
+
   this->renderPassDirty = false;
 }
 
@@ -682,6 +1272,15 @@ void Ogre2RenderTarget::UpdateRenderPassChain(
     {
       Ogre2RenderPass *ogre2RenderPass =
           dynamic_cast<Ogre2RenderPass *>(pass.get());
+      // the node of a fused pass is not in the workspace, passes are
+      // regrouped when one of them gets disabled
+      if (!ogre2RenderPass->FusedNodeDefinitionName().empty())
+      {
+        if (!ogre2RenderPass->IsEnabled())
+          updateConnection = true;
+        continue;
+      }
+
       Ogre::CompositorNode *node =
           _workspace->findNodeNoThrow(
           ogre2RenderPass->OgreCompositorNodeDefinitionName());
@@ -720,33 +1319,88 @@ void Ogre2RenderTarget::UpdateRenderPassChain(
   std::string outNodeDefName = _baseNode;
   // the final compositor node
   const std::string finalNodeDefName = _finalNode;
-  std::string inNodeDefName;
-
-  // if new nodes need to be added then clear everything,
-  // otherwise clear only the node connections
-  if (_recreateNodes)
-    workspaceDef->clearAll();
-  else
-    workspaceDef->clearAllInterNodeConnections();
-
-  int numActiveNodes = 0;
 
   // chain the render passes by connecting all the ogre compositor nodes
-  // in between the base scene pass node and the final compositor node
+  // in between the base scene pass node and the final compositor node.
+  // Consecutive enabled passes providing per pixel shader code are drawn by
+  // a single fused node.
+  std::vector<Ogre2RenderPass *> enabledPasses;
   for (const auto &pass : _renderPasses)
   {
     Ogre2RenderPass *ogre2RenderPass =
         dynamic_cast<Ogre2RenderPass *>(pass.get());
     ogre2RenderPass->CreateRenderPass();
-    inNodeDefName = ogre2RenderPass->OgreCompositorNodeDefinitionName();
+    ogre2RenderPass->SetFusedNode(std::string(), nullptr, std::string());
     // only connect passes that are enabled
-    if (!inNodeDefName.empty() && ogre2RenderPass->IsEnabled())
+    if (!ogre2RenderPass->OgreCompositorNodeDefinitionName().empty() &&
+        ogre2RenderPass->IsEnabled())
+    {
+      enabledPasses.push_back(ogre2RenderPass);
+    }
+  }
+
+  std::vector<std::string> nodeDefNames;
+  for (size_t i = 0u; i < enabledPasses.size();)
+  {
+    std::vector<Ogre2RenderPass *> fusedPasses;
+    std::vector<std::string> prefixes;
+    std::vector<std::string> codes;
+    for (size_t j = i; j < enabledPasses.size(); ++j)
     {
-      workspaceDef->connect(outNodeDefName, inNodeDefName);
-      outNodeDefName = inNodeDefName;
-      ++numActiveNodes;
+      std::string prefix = "pass" + std::to_string(j) + "_";
+      std::string code = enabledPasses[j]->FusedShaderCode(prefix);
+      if (code.empty())
+        break;
+      fusedPasses.push_back(enabledPasses[j]);
+      prefixes.push_back(prefix);
+      codes.push_back(code);
     }
+
+    FusedRenderPassNode fusedNode;
+    if (fusedPasses.size() > 1u)
+      fusedNode = fusedRenderPassNode(fusedPasses, prefixes, codes);
+
+    if (fusedNode.material)
+    {
+      for (size_t j = 0u; j < fusedPasses.size(); ++j)
+      {
+        fusedPasses[j]->SetFusedNode(fusedNode.nodeDefName,
+            fusedNode.material, prefixes[j]);
+        // set the uniforms of the fused material before its first use
+        fusedPasses[j]->PreRender();
+      }
+      nodeDefNames.push_back(fusedNode.nodeDefName);
+      i += fusedPasses.size();
+    }
+    else
+    {
+      nodeDefNames.push_back(
+          enabledPasses[i]->OgreCompositorNodeDefinitionName());
+      ++i;
+    }
+  }
+
+  // nodes not in the workspace yet, such as new fused nodes, require
+  // recreating all the nodes
+  for (const auto &nodeDefName : nodeDefNames)
+  {
+    if (!_recreateNodes && !_workspace->findNodeNoThrow(nodeDefName))
+      _recreateNodes = true;
+  }
+
+  // if new nodes need to be added then clear everything,
+  // otherwise clear only the node connections
+  if (_recreateNodes)
+    workspaceDef->clearAll();
+  else
+    workspaceDef->clearAllInterNodeConnections();
+
+  for (const auto &nodeDefName : nodeDefNames)
+  {
+    workspaceDef->connect(outNodeDefName, nodeDefName);
+    outNodeDefName = nodeDefName;
   }
+  size_t numActiveNodes = nodeDefNames.size();
 
   workspaceDef->connectExternal(0, _baseNode, 0);
   workspaceDef->connectExternal(1, _baseNode, 1);
@@ -756,6 +1410,10 @@ void Ogre2RenderTarget::UpdateRenderPassChain(
     // connect the last render pass to the final compositor node
     workspaceDef->connect(outNodeDefName, finalNodeDefName);
 
+    // external Bayer mosaic or packed depth target
+    if (_workspace->getExternalRenderTargets().size() > 2u)
+      workspaceDef->connectExternal(2, _finalNode, 2);
+
     // We must ensure the output is always in ogreTextures[1]
     const bool bMustSwapRts = (numActiveNodes & 0x01) == 0u;
 
@@ -800,9 +1458,67 @@ void Ogre2RenderTarget::UpdateShadowNode()
 //////////////////////////////////////////////////
 void Ogre2RenderTarget::RebuildImpl()
 {
-  this->RebuildTarget();
+  if (!this->ResizeTarget())
+  {
+    this->RebuildTarget();
+    this->RebuildMaterial();
+    this->RebuildCompositor();
+  }
+
+  // chain the render passes in the new workspace. Passes drawn by fused
+  // nodes are not looked up in the workspace, so the chain is always
+  // rebuilt.
+  if (!this->renderPasses.empty())
+    this->renderPassDirty = true;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2RenderTarget::ResizeTarget()
+{
+  // the compositor definitions depend on the background, on the Bayer
+  // pattern of the format and on dynamic resolution. The intermediate
+  // textures of dynamic resolution and order independent transparency
+  // also have the format of the target. Windows resize their own render
+  // target.
+  if (!this->ogreCompositorWorkspace || !this->dataPtr->ogreTexture[0] ||
+      this->IsRenderWindow() || this->backgroundMaterialDirty ||
+      bayerMaterialName(this->format) !=
+      bayerMaterialName(this->dataPtr->compositorFormat) ||
+      this->dataPtr->dynamicResolution !=
+      this->dataPtr->compositorDynamicResolution ||
+      this->dataPtr->orderIndependentTransparency !=
+      this->dataPtr->compositorOit ||
+      ((this->dataPtr->compositorDynamicResolution ||
+      this->dataPtr->compositorOit) &&
+      this->format != this->dataPtr->compositorFormat))
+  {
+    return false;
+  }
+
+  IGN_RENDERING_PROFILE("Ogre2RenderTarget::ResizeTarget");
+
+  // swap the textures, the compositor definitions are kept since there is
+  // no workspace any more when the target is destroyed
+  this->RemoveWorkspace();
+  this->DestroyTargetImpl();
+  this->BuildTargetImpl();
   this->RebuildMaterial();
-  this->RebuildCompositor();
+
+  // remove the render passes from the definition so that they are not
+  // instantiated before being chained again
+  Ogre::CompositorManager2 *ogreCompMgr =
+      Ogre2RenderEngine::Instance()->OgreRoot()->getCompositorManager2();
+  Ogre::CompositorWorkspaceDef *workDef =
+      ogreCompMgr->getWorkspaceDefinition(this->ogreCompositorWorkspaceDefName);
+  workDef->clearAll();
+  connectWorkspaceNodes(workDef,
+      this->ogreCompositorWorkspaceDefName + "/" + this->dataPtr->kBaseNodeName,
+      this->ogreCompositorWorkspaceDefName + "/" +
+      this->dataPtr->kFinalNodeName, false,
+      this->dataPtr->bayerTexture != nullptr);
+
+  this->CreateWorkspace();
+  return true;
 }
 
 //////////////////////////////////////////////////
@@ -817,12 +1533,99 @@ void Ogre2RenderTarget::SetMaterial(MaterialPtr _material)
 //////////////////////////////////////////////////
 void Ogre2RenderTarget::SetShadowsNodeDefDirty()
 {
-  this->DestroyCompositor();
+  // a compositor built later on picks up the current shadow node
+  if (!this->ogreCompositorWorkspace)
+    return;
 
-  // Have to rebuild the target so there is something to apply the applicator to
+  // switch the scene pass to the shadow node definition of the new light
+  // configuration and only recreate the nodes of the workspace. The render
+  // textures, workspace and material applicators are kept.
+  std::string shadowNodeName;
+  if (this->dataPtr->shadowsEnabled)
+  {
+    shadowNodeName =
+        this->scene->ShadowNodeName(this->dataPtr->shadowMapSize);
+  }
+  if (shadowNodeName == this->dataPtr->shadowNodeName)
+    return;
+
+  this->dataPtr->shadowNodeName = shadowNodeName;
+  this->scene->ApplyShadowNode(this->ogreCompositorWorkspaceDefName + "/" +
+      this->dataPtr->kBaseNodeName,
+      this->dataPtr->SceneTargetName(), this->dataPtr->shadowNodeName);
+  this->ogreCompositorWorkspace->recreateAllNodes();
+  this->dataPtr->staticShadowsVersion = 0u;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::SetShadowsEnabled(bool _enabled)
+{
+  this->dataPtr->shadowsEnabled = _enabled;
+  this->SetShadowsNodeDefDirty();
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::SetShadowMapSize(unsigned int _size)
+{
+  this->dataPtr->shadowMapSize = _size;
+  this->SetShadowsNodeDefDirty();
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::SetDynamicResolutionEnabled(bool _enabled)
+{
+  if (this->dataPtr->dynamicResolution == _enabled)
+    return;
+  this->dataPtr->dynamicResolution = _enabled;
   this->targetDirty = true;
 }
 
+//////////////////////////////////////////////////
+bool Ogre2RenderTarget::DynamicResolutionEnabled() const
+{
+  return this->dataPtr->dynamicResolution;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::SetOrderIndependentTransparencyEnabled(bool _enabled)
+{
+  if (this->dataPtr->orderIndependentTransparency == _enabled)
+    return;
+  this->dataPtr->orderIndependentTransparency = _enabled;
+  this->targetDirty = true;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2RenderTarget::OrderIndependentTransparencyEnabled() const
+{
+  return this->dataPtr->orderIndependentTransparency;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::SetResolutionScale(double _scale)
+{
+  if (!(_scale > 0.0) || _scale > 1.0)
+  {
+    ignerr << "Resolution scale must be in (0, 1]: " << _scale << std::endl;
+    return;
+  }
+  this->dataPtr->resolutionScale = _scale;
+}
+
+//////////////////////////////////////////////////
+double Ogre2RenderTarget::ResolutionScale() const
+{
+  return this->dataPtr->resolutionScale;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::SetGpuTimerClient(unsigned int _client)
+{
+  this->dataPtr->gpuTimerClient = _client;
+  if (this->dataPtr->gpuTimerListener)
+    this->dataPtr->gpuTimerListener->SetClient(_client);
+}
+
 //////////////////////////////////////////////////
 void Ogre2RenderTarget::RebuildMaterial()
 {
@@ -931,6 +1734,7 @@ void Ogre2RenderTexture::SetOgreTexture(Ogre::Texture *_ogreTexture)
 // Ogre2RenderWindow
 //////////////////////////////////////////////////
 Ogre2RenderWindow::Ogre2RenderWindow()
+  : frameLimiter(new Ogre2FrameLimiter)
 {
 }
 
@@ -951,10 +1755,41 @@ Ogre::RenderTarget *Ogre2RenderWindow::RenderTarget() const
   return this->ogreRenderWindow;
 }
 
+//////////////////////////////////////////////////
+void Ogre2RenderWindow::PostRender()
+{
+  // the frame was swapped by the render, the present time is taken once
+  // the frames above the limit completed
+  this->frameLimiter->FrameSwapped(this->maxFramesInFlight);
+  BaseRenderWindow::PostRender();
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderWindow::SetPresentMode(WindowPresentMode _mode)
+{
+  if (_mode == WPM_MAILBOX)
+  {
+    ignwarn << "Mailbox present mode is not supported by ogre2 render "
+            << "windows, using immediate present mode" << std::endl;
+    _mode = WPM_IMMEDIATE;
+  }
+  BaseRenderWindow::SetPresentMode(_mode);
+  this->ApplyPresentMode();
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderWindow::ApplyPresentMode()
+{
+  Ogre::RenderWindow *window =
+      dynamic_cast<Ogre::RenderWindow *>(this->ogreRenderWindow);
+  if (window)
+    window->setVSyncEnabled(this->presentMode == WPM_FIFO);
+}
+
 //////////////////////////////////////////////////
 void Ogre2RenderWindow::Destroy()
 {
-  // TODO(anyone)
+  this->frameLimiter->Reset();
 }
 
 //////////////////////////////////////////////////
@@ -984,4 +1819,5 @@ void Ogre2RenderWindow::BuildTarget()
           this->antiAliasing);
   this->ogreRenderWindow =
       engine->OgreRoot()->getRenderTarget(renderTargetName);
+  this->ApplyPresentMode();
 }
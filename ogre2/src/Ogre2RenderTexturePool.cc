@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <iterator>
+#include <string>
+
+#include "Ogre2RenderTexturePool.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreTextureManager.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+Ogre::Texture *Ogre2RenderTexturePool::Acquire(unsigned int _width,
+    unsigned int _height, Ogre::PixelFormat _format, unsigned int _fsaa,
+    bool _hwGamma)
+{
+  Key key(_width, _height, _format, _fsaa, _hwGamma);
+
+  // most recently released textures first, they are more likely to still
+  // be resident
+  for (auto it = this->freeTextures.rbegin();
+      it != this->freeTextures.rend(); ++it)
+  {
+    if (it->key != key)
+      continue;
+    Ogre::Texture *texture = it->texture;
+    this->freeTextures.erase(std::next(it).base());
+    this->acquiredTextures[texture] = key;
+    return texture;
+  }
+
+  Ogre::Texture *texture = Ogre::TextureManager::getSingleton().createManual(
+      "Ogre2RenderTexturePool_" + std::to_string(this->textureCounter++),
+      "General", Ogre::TEX_TYPE_2D, _width, _height, 0, _format,
+      Ogre::TU_RENDERTARGET, 0, _hwGamma, _fsaa).get();
+  this->acquiredTextures[texture] = key;
+  return texture;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTexturePool::Release(Ogre::Texture *_texture)
+{
+  auto it = this->acquiredTextures.find(_texture);
+  if (it == this->acquiredTextures.end())
+    return;
+
+  FreeTexture freeTexture;
+  freeTexture.key = it->second;
+  freeTexture.texture = _texture;
+  this->freeTextures.push_back(freeTexture);
+  this->acquiredTextures.erase(it);
+  this->Trim(this->maxFreeCount);
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTexturePool::Reset()
+{
+  this->Trim(0u);
+  this->acquiredTextures.clear();
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTexturePool::Trim(unsigned int _count)
+{
+  auto &manager = Ogre::TextureManager::getSingleton();
+  while (this->freeTextures.size() > _count)
+  {
+    // TODO(anyone) there is memory leak when a render texture is destroyed.
+    // See Ogre2RenderTarget::DestroyTargetImpl
+    const std::string name = this->freeTextures.front().texture->getName();
+    manager.unload(name);
+    manager.remove(name);
+    this->freeTextures.pop_front();
+  }
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2RENDERTEXTUREPOOL_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2RENDERTEXTUREPOOL_HH_
+
+#include <list>
+#include <map>
+#include <tuple>
+
+#include <ignition/common/SingletonT.hh>
+
+#include "ignition/rendering/ogre2/Ogre2Includes.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Pool of the render textures of ogre2 render targets. Textures
+    /// released by a render target, e.g. when it is resized, are kept and
+    /// handed out again to targets asking for the same size and format, so
+    /// that sensors switching between resolutions do not allocate video
+    /// memory every time. The least recently released textures are
+    /// destroyed once the pool holds more than a few free textures.
+    class Ogre2RenderTexturePool :
+      public common::SingletonT<Ogre2RenderTexturePool>
+    {
+      /// \brief Constructor
+      private: Ogre2RenderTexturePool() = default;
+
+      /// \brief Get a render texture, reusing a free texture of the pool
+      /// if there is one matching the arguments
+      /// \param[in] _width Width of the texture in pixels
+      /// \param[in] _height Height of the texture in pixels
+      /// \param[in] _format Pixel format of the texture
+      /// \param[in] _fsaa Anti-aliasing level of the texture
+      /// \param[in] _hwGamma True if the texture stores gamma corrected
+      /// values
+      /// \return The render texture
+      public: Ogre::Texture *Acquire(unsigned int _width,
+          unsigned int _height, Ogre::PixelFormat _format,
+          unsigned int _fsaa, bool _hwGamma);
+
+      /// \brief Return a texture obtained with Acquire to the pool
+      /// \param[in] _texture Texture to release, ignored if null or not
+      /// obtained with Acquire
+      public: void Release(Ogre::Texture *_texture);
+
+      /// \brief Destroy all free textures. Must be called while the render
+      /// system is still valid.
+      public: void Reset();
+
+      /// \brief Destroy free textures until at most _count are left
+      /// \param[in] _count Number of free textures to keep
+      private: void Trim(unsigned int _count);
+
+      /// \brief Properties that must match for a texture to be reused:
+      /// width, height, format, anti-aliasing level and gamma correction
+      private: using Key = std::tuple<unsigned int, unsigned int,
+          Ogre::PixelFormat, unsigned int, bool>;
+
+      /// \brief A free texture
+      private: struct FreeTexture
+      {
+        /// \brief Properties of the texture
+        Key key;
+
+        /// \brief The texture
+        Ogre::Texture *texture = nullptr;
+      };
+
+      /// \brief Free textures, least recently released first
+      private: std::list<FreeTexture> freeTextures;
+
+      /// \brief Properties of the textures handed out by Acquire
+      private: std::map<Ogre::Texture *, Key> acquiredTextures;
+
+      /// \brief Maximum number of free textures
+      private: const unsigned int maxFreeCount = 8u;
+
+      /// \brief Counter used to generate unique texture names
+      private: unsigned int textureCounter = 0u;
+
+      /// \brief Make the singleton class a friend
+      private: friend class common::SingletonT<Ogre2RenderTexturePool>;
+    };
+    }
+  }
+}
+
+#endif
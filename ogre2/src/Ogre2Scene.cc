@@ -15,8 +15,22 @@
  *
  */
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 
+#include "ignition/rendering/EnvironmentMapFilter.hh"
+#include "ignition/rendering/ObjectPool.hh"
+#include "ignition/rendering/Profiler.hh"
 #include "ignition/rendering/RenderTypes.hh"
 #include "ignition/rendering/ogre2/Ogre2ArrowVisual.hh"
 #include "ignition/rendering/ogre2/Ogre2AxisVisual.hh"
@@ -27,6 +41,7 @@
 #include "ignition/rendering/ogre2/Ogre2GizmoVisual.hh"
 #include "ignition/rendering/ogre2/Ogre2GpuRays.hh"
 #include "ignition/rendering/ogre2/Ogre2Grid.hh"
+#include "ignition/rendering/ogre2/Ogre2Heightmap.hh"
 #include "ignition/rendering/ogre2/Ogre2Light.hh"
 #include "ignition/rendering/ogre2/Ogre2LightVisual.hh"
 #include "ignition/rendering/ogre2/Ogre2LidarVisual.hh"
@@ -35,32 +50,66 @@
 #include "ignition/rendering/ogre2/Ogre2MeshFactory.hh"
 #include "ignition/rendering/ogre2/Ogre2Node.hh"
 #include "ignition/rendering/ogre2/Ogre2ParticleEmitter.hh"
+#include "ignition/rendering/ogre2/Ogre2PointCloudVisual.hh"
+#include "ignition/rendering/ogre2/Ogre2PoseArrayVisual.hh"
 #include "ignition/rendering/ogre2/Ogre2RayQuery.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderTarget.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderTypes.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
+#include "ignition/rendering/ogre2/Ogre2SegmentationCamera.hh"
+#include "ignition/rendering/ogre2/Ogre2Text.hh"
 #include "ignition/rendering/ogre2/Ogre2ThermalCamera.hh"
 #include "ignition/rendering/ogre2/Ogre2Visual.hh"
+#include "ignition/rendering/ogre2/Ogre2WideAngleCamera.hh"
 #include "ignition/rendering/ogre2/Ogre2WireBox.hh"
 
+#include "Ogre2TextureStreamer.hh"
+
 #ifdef _MSC_VER
   #pragma warning(push, 0)
 #endif
 #include <OgreMatrix4.h>
+#include <OgreCamera.h>
 #include <Compositor/OgreCompositorManager2.h>
+#include <Compositor/OgreCompositorNodeDef.h>
+#include <Compositor/OgreCompositorWorkspace.h>
+#include <Compositor/OgreCompositorWorkspaceDef.h>
 #include <Compositor/Pass/PassClear/OgreCompositorPassClearDef.h>
 #include <Compositor/Pass/PassQuad/OgreCompositorPassQuadDef.h>
 #include <Compositor/Pass/PassScene/OgreCompositorPassSceneDef.h>
 #include <OgreDepthBuffer.h>
+#include <OgreHardwarePixelBuffer.h>
+#include <OgreImage.h>
+#include <OgreMeshManager.h>
 #include <OgreRoot.h>
 #include <OgreSceneManager.h>
+#include <OgreTextureManager.h>
 #include <Overlay/OgreOverlayManager.h>
 #include <Overlay/OgreOverlaySystem.h>
 #ifdef _MSC_VER
   #pragma warning(pop)
 #endif
 
+/// \brief View of a sensor, used to cull particle emitters
+struct Ogre2ParticleViewer
+{
+  /// \brief World position of the sensor camera
+  Ogre::Vector3 position;
+
+  /// \brief Frustum planes of the sensor camera, pointing inwards
+  Ogre::Plane planes[6];
+
+  /// \brief Scene time when the sensor was last rendered
+  std::chrono::steady_clock::duration time;
+};
+
+/// \brief How long the view of a sensor is kept after it was rendered.
+/// Sensors that update less often than this may see the particles they
+/// resume frozen for a frame.
+static const std::chrono::steady_clock::duration kParticleViewerTimeout =
+    std::chrono::seconds(1);
+
 /// \brief Private data for the Ogre2Scene class
 class ignition::rendering::Ogre2ScenePrivate
 {
@@ -72,6 +121,75 @@ class ignition::rendering::Ogre2ScenePrivate
 
   /// \brief Name of shadow compositor node
   public: const std::string kShadowNodeName = "PbsMaterialsShadowNode";
+
+  /// \brief Name of the shadow node definition matching the current shadow
+  /// casting lights. Definitions are named after the number of directional
+  /// and spot / point lights they have shadow maps for, and kept once
+  /// created so that switching between light configurations does not
+  /// rebuild them.
+  public: std::string shadowNodeName;
+
+  /// \brief Default size of shadow maps in pixels
+  public: const unsigned int kShadowMapSize = 2048u;
+
+  /// \brief Number of directional lights with a shadow map
+  public: unsigned int dirLightCount = 0u;
+
+  /// \brief Number of spot and point lights that are not static and have a
+  /// shadow map
+  public: unsigned int spotPointLightCount = 0u;
+
+  /// \brief Shadow maps of static lights in the current shadow node
+  /// definition, as pairs of shadow map index and light
+  public: std::vector<std::pair<size_t, Ogre::Light *>> staticShadowMaps;
+
+  /// \brief Version of the static shadow maps, incremented every time they
+  /// need to be rendered again
+  public: uint64_t staticShadowsVersion = 1u;
+
+  /// \brief True if a static light or visual changed since the static
+  /// shadow maps were last invalidated
+  public: bool staticShadowsDirty = false;
+
+  /// \brief Number of light clusters along the screen width
+  public: unsigned int lightClusterWidth = 16u;
+
+  /// \brief Number of light clusters along the screen height
+  public: unsigned int lightClusterHeight = 8u;
+
+  /// \brief Number of light clusters along the view depth
+  public: unsigned int lightClusterSlices = 24u;
+
+  /// \brief Maximum number of lights per cluster
+  public: unsigned int lightsPerCluster = 96u;
+
+  /// \brief Distance of the first depth slice of light clusters
+  public: double lightClusterMinDistance = 1.0;
+
+  /// \brief Distance of the last depth slice of light clusters
+  public: double lightClusterMaxDistance = 500.0;
+
+  /// \brief Particle emitters that have a particle system
+  public: std::vector<Ogre2ParticleEmitter *> particleEmitters;
+
+  /// \brief Distance beyond which particle emitters are culled, 0 to
+  /// disable culling
+  public: double particleCullDistance = 0.0;
+
+  /// \brief Distance beyond which particle emitters emit fewer particles,
+  /// 0 to disable
+  public: double particleLodDistance = 0.0;
+
+  /// \brief True if depth cameras skip the items occluded in their
+  /// previous frame
+  public: bool occlusionCulling = false;
+
+  /// \brief Conservative margin of occlusion culling, in meters
+  public: double occlusionCullingMargin = 0.1;
+
+  /// \brief Views of the sensors rendered recently, by ogre camera. The
+  /// cameras are only used as keys and never dereferenced.
+  public: std::map<const Ogre::Camera *, Ogre2ParticleViewer> particleViewers;
 };
 
 using namespace ignition;
@@ -134,40 +252,208 @@ void Ogre2Scene::SetAmbientLight(const math::Color &_color)
 //////////////////////////////////////////////////
 void Ogre2Scene::PreRender()
 {
+  IGN_RENDERING_PROFILE("Ogre2Scene::PreRender");
+  // scene changes have already been flushed in this frame
+  if (this->FramePreRendered())
+    return;
+
+  // apply the scene mutations queued by other threads first, they may
+  // change lights and materials
+  this->ApplyCommands();
+
+  // bind the streamed textures decoded since the last frame and release
+  // unused textures over the memory budget
+  Ogre2TextureStreamer::Instance()->Update();
+
+  if (this->dataPtr->staticShadowsDirty)
+  {
+    this->dataPtr->staticShadowsVersion++;
+    this->dataPtr->staticShadowsDirty = false;
+  }
+
   if (this->ShadowsDirty())
   {
-    // notify all render targets
-    for (unsigned int i  = 0; i < this->SensorCount(); ++i)
+    std::string prevShadowNodeName = this->dataPtr->shadowNodeName;
+    this->UpdateShadowNode();
+
+    // only notify render targets if the number of shadow casting lights
+    // actually changed. They then switch to the cached shadow node
+    // definition of the new light configuration.
+    if (this->dataPtr->shadowNodeName != prevShadowNodeName)
     {
-      auto camera = std::dynamic_pointer_cast<Camera>(
-          this->SensorByIndex(i));
-      if (camera)
+      // notify all render targets
+      for (unsigned int i  = 0; i < this->SensorCount(); ++i)
       {
-        // TODO(anyone): this function should rely on virtual functions instead
-        // of dynamic casts
-        // Looks in commit history for '#SetShadowsNodeDefDirtyABI' to
-        // see changes made and revert
-        {
-          auto cameraDerived = std::dynamic_pointer_cast<Ogre2DepthCamera>(
-                                 this->SensorByIndex(i));
-          if (cameraDerived)
-            cameraDerived->SetShadowsNodeDefDirty();
-        }
+        auto camera = std::dynamic_pointer_cast<Camera>(
+            this->SensorByIndex(i));
+        if (camera)
         {
-          auto cameraDerived = std::dynamic_pointer_cast<Ogre2Camera>(
-                                 this->SensorByIndex(i));
-          if (cameraDerived)
-            cameraDerived->SetShadowsNodeDefDirty();
+          // TODO(anyone): this function should rely on virtual functions
+          // instead of dynamic casts
+          // Looks in commit history for '#SetShadowsNodeDefDirtyABI' to
+          // see changes made and revert
+          {
+            auto cameraDerived = std::dynamic_pointer_cast<Ogre2DepthCamera>(
+                                   this->SensorByIndex(i));
+            if (cameraDerived)
+              cameraDerived->SetShadowsNodeDefDirty();
+          }
+          {
+            auto cameraDerived = std::dynamic_pointer_cast<Ogre2Camera>(
+                                   this->SensorByIndex(i));
+            if (cameraDerived)
+              cameraDerived->SetShadowsNodeDefDirty();
+          }
         }
       }
     }
-
-    UpdateShadowNode();
   }
 
+  this->UpdateParticleCulling();
+
   BaseScene::PreRender();
 }
 
+//////////////////////////////////////////////////
+void Ogre2Scene::SetWorldPoses(const std::vector<unsigned int> &_ids,
+    const std::vector<math::Pose3d> &_poses)
+{
+  if (!this->ValidateWorldPoses(_ids, _poses))
+    return;
+
+  // Nodes attached directly to the root visual, with no origin offset, are
+  // the common case (e.g. models in a simulation). Their local pose only
+  // depends on the root pose so they can be written straight to the ogre
+  // nodes, in parallel when each write touches a different node.
+  // Other nodes, and static visuals and lights whose ogre nodes need extra
+  // bookkeeping, go through the regular SetWorldPose in the order given.
+  // Nothing can be batched if the root itself is being moved.
+  Ogre::SceneNode *rootNode = this->rootVisual->Node();
+  bool batch = std::find(_ids.begin(), _ids.end(), this->rootVisual->Id()) ==
+      _ids.end();
+
+  std::vector<std::pair<Ogre2NodePtr, unsigned int>> direct;
+  std::vector<std::pair<Ogre2Visual *, unsigned int>> directVisuals;
+  std::vector<std::pair<NodePtr, unsigned int>> nested;
+  direct.reserve(_ids.size());
+
+  for (unsigned int i = 0; i < _ids.size(); ++i)
+  {
+    // the typed stores give the ogre2 nodes without a dynamic cast
+    Ogre2VisualPtr visual = this->visuals->DerivedById(_ids[i]);
+    Ogre2LightPtr light;
+    Ogre2NodePtr ogreNode = visual;
+    if (!ogreNode)
+      ogreNode = light = this->lights->DerivedById(_ids[i]);
+    if (!ogreNode)
+      ogreNode = this->sensors->DerivedById(_ids[i]);
+    if (!ogreNode)
+      continue;
+
+    bool isStatic = (visual && visual->Static()) ||
+        (light && light->Static());
+    if (batch && !isStatic &&
+        ogreNode->Node()->getParentSceneNode() == rootNode &&
+        ogreNode->Origin() == math::Vector3d::Zero && _poses[i].IsFinite())
+    {
+      direct.emplace_back(ogreNode, i);
+      if (visual)
+        directVisuals.emplace_back(visual.get(), i);
+    }
+    else
+    {
+      nested.emplace_back(ogreNode, i);
+    }
+  }
+
+  const math::Pose3d rootPose = this->rootVisual->WorldPose();
+  const bool rootIdentity = rootPose == math::Pose3d::Zero;
+  auto update = [&](size_t _start, size_t _end)
+  {
+    // the poses are converted to single precision in blocks, small enough
+    // to stay in cache until they are written to the nodes
+    const size_t blockSize = 256u;
+    math::Pose3d poses[blockSize];
+    Ogre::Vector3 positions[blockSize];
+    Ogre::Quaternion orientations[blockSize];
+    for (size_t start = _start; start < _end; start += blockSize)
+    {
+      size_t count = std::min(blockSize, _end - start);
+      for (size_t i = 0u; i < count; ++i)
+      {
+        poses[i] = _poses[direct[start + i].second];
+        if (!rootIdentity)
+          poses[i] = poses[i] - rootPose;
+      }
+      Ogre2Conversions::Convert(poses, count, positions, orientations);
+      for (size_t i = 0u; i < count; ++i)
+      {
+        Ogre::SceneNode *sceneNode = direct[start + i].first->Node();
+        sceneNode->setPosition(positions[i]);
+        sceneNode->setOrientation(orientations[i]);
+      }
+    }
+  };
+
+  // only spread the work across threads when there is enough of it to
+  // make up for the cost of starting them
+  const size_t minNodesPerThread = 4096u;
+  size_t threadCount = std::min<size_t>(
+      std::max(1u, std::thread::hardware_concurrency()),
+      direct.size() / minNodesPerThread);
+
+  // the threads must not write to the same node, so ids given more than
+  // once are written on this thread, in order
+  if (threadCount > 1u)
+  {
+    std::vector<Ogre::SceneNode *> sceneNodes;
+    sceneNodes.reserve(direct.size());
+    for (auto &item : direct)
+      sceneNodes.push_back(item.first->Node());
+    std::sort(sceneNodes.begin(), sceneNodes.end());
+    if (std::adjacent_find(sceneNodes.begin(), sceneNodes.end()) !=
+        sceneNodes.end())
+    {
+      threadCount = 1u;
+    }
+  }
+
+  if (threadCount <= 1u)
+  {
+    update(0u, direct.size());
+  }
+  else
+  {
+    size_t chunk = (direct.size() + threadCount - 1u) / threadCount;
+    std::vector<std::thread> threads;
+    for (size_t t = 1u; t < threadCount; ++t)
+    {
+      threads.emplace_back(update, t * chunk,
+          std::min(direct.size(), (t + 1u) * chunk));
+    }
+    update(0u, chunk);
+    for (auto &thread : threads)
+      thread.join();
+  }
+
+  // the ogre nodes were modified directly so the cached world poses need to
+  // be updated, and the nodes flagged for the next PreRender as
+  // BaseNode::SetLocalPose does. This walks the children and touches the
+  // scene so it is done on this thread.
+  for (auto &item : direct)
+  {
+    item.first->InvalidateWorldPose();
+    this->MarkPreRenderDirty(item.first);
+  }
+
+  // same as Ogre2Visual::SetRawLocalPosition
+  for (auto &item : directVisuals)
+    item.first->SetPoseBoundsDirty();
+
+  for (auto &item : nested)
+    item.first->SetWorldPose(_poses[item.second]);
+}
+
 //////////////////////////////////////////////////
 void Ogre2Scene::Clear()
 {
@@ -176,9 +462,25 @@ void Ogre2Scene::Clear()
   BaseScene::Clear();
 }
 
+//////////////////////////////////////////////////
+bool Ogre2Scene::ClearStep(const std::chrono::steady_clock::duration &_budget)
+{
+  bool cleared = !this->Clearing();
+  if (!BaseScene::ClearStep(_budget))
+    return false;
+
+  // the meshes are released once no object of the scene uses them
+  if (!cleared)
+    this->meshFactory->Clear();
+  return true;
+}
+
 //////////////////////////////////////////////////
 void Ogre2Scene::Destroy()
 {
+  if (!this->ogreSceneManager)
+    return;
+
   this->DestroyNodes();
 
   // cleanup any items that were not attached to nodes
@@ -193,6 +495,13 @@ void Ogre2Scene::Destroy()
   {
     this->ogreSceneManager->removeRenderQueueListener(
         Ogre2RenderEngine::Instance()->OverlaySystem());
+
+    // scenes may be created and destroyed many times in a process, e.g. one
+    // per episode, do not keep their scene managers until shutdown
+    Ogre::Root *root = Ogre2RenderEngine::Instance()->OgreRoot();
+    if (root)
+      root->destroySceneManager(this->ogreSceneManager);
+    this->ogreSceneManager = nullptr;
   }
 }
 
@@ -202,6 +511,274 @@ Ogre::SceneManager *Ogre2Scene::OgreSceneManager() const
   return this->ogreSceneManager;
 }
 
+//////////////////////////////////////////////////
+Ogre2MeshFactoryPtr Ogre2Scene::MeshFactory() const
+{
+  return this->meshFactory;
+}
+
+//////////////////////////////////////////////////
+MemoryStats Ogre2Scene::ResourceMemoryStats() const
+{
+  MemoryStats stats;
+  stats.meshBytes = Ogre::MeshManager::getSingleton().getMemoryUsage() +
+      Ogre::v1::MeshManager::getSingleton().getMemoryUsage();
+
+  auto it = Ogre::TextureManager::getSingleton().getResourceIterator();
+  while (it.hasMoreElements())
+  {
+    Ogre::ResourcePtr resource = it.getNext();
+    Ogre::Texture *texture = static_cast<Ogre::Texture *>(resource.get());
+    if (!texture)
+      continue;
+    if (texture->getUsage() & Ogre::TU_RENDERTARGET)
+      stats.renderTargetBytes += texture->getSize();
+    else
+      stats.textureBytes += texture->getSize();
+  }
+  return stats;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::SetTextureMemoryBudget(size_t _bytes)
+{
+  Ogre2TextureStreamer::Instance()->SetMemoryBudget(_bytes);
+}
+
+//////////////////////////////////////////////////
+size_t Ogre2Scene::TextureMemoryBudget() const
+{
+  return Ogre2TextureStreamer::Instance()->MemoryBudget();
+}
+
+//////////////////////////////////////////////////
+size_t Ogre2Scene::ResidentTextureMemory() const
+{
+  return Ogre2TextureStreamer::Instance()->ResidentMemory();
+}
+
+//////////////////////////////////////////////////
+size_t Ogre2Scene::EvictedTextureMemory() const
+{
+  return Ogre2TextureStreamer::Instance()->EvictedMemory();
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Scene::RenderReflectionProbe(const std::string &_name,
+    const math::Vector3d &_position, unsigned int _size)
+{
+  IGN_RENDERING_PROFILE("Ogre2Scene::RenderReflectionProbe");
+  if (_name.empty() || _size == 0u)
+  {
+    ignerr << "Invalid reflection probe [" << _name << "] of size "
+           << _size << std::endl;
+    return false;
+  }
+
+  Ogre::TextureManager &textureManager = Ogre::TextureManager::getSingleton();
+  std::string probeName = this->Name() + "::" + _name + "::ReflectionProbe";
+  Ogre::TexturePtr cubemap = textureManager.createManual(probeName, "General",
+      Ogre::TEX_TYPE_CUBE_MAP, _size, _size, 1, 0, Ogre::PF_BYTE_RGBA,
+      Ogre::TU_RENDERTARGET);
+
+  // each face is cleared to the background color and renders the scene,
+  // the camera being turned towards the face
+  Ogre::CompositorManager2 *compMgr =
+      Ogre2RenderEngine::Instance()->OgreRoot()->getCompositorManager2();
+  std::string nodeDefName = probeName + "/Node";
+  std::string wsDefName = probeName + "/Workspace";
+  Ogre::CompositorNodeDef *nodeDef = compMgr->addNodeDefinition(nodeDefName);
+  nodeDef->addTextureSourceName("rt_probe", 0,
+      Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+  nodeDef->setNumTargetPass(6u);
+  for (Ogre::uint32 i = 0; i < 6u; ++i)
+  {
+    Ogre::CompositorTargetDef *targetDef =
+        nodeDef->addTargetPass("rt_probe", i);
+    targetDef->setNumPasses(2u);
+    Ogre::CompositorPassClearDef *passClear =
+        static_cast<Ogre::CompositorPassClearDef *>(
+        targetDef->addPass(Ogre::PASS_CLEAR));
+    passClear->mColourValue =
+        Ogre2Conversions::Convert(this->BackgroundColor());
+    Ogre::CompositorPassSceneDef *passScene =
+        static_cast<Ogre::CompositorPassSceneDef *>(
+        targetDef->addPass(Ogre::PASS_SCENE));
+    passScene->mCameraCubemapReorient = true;
+    passScene->mVisibilityMask = IGN_VISIBILITY_ALL;
+    passScene->mIncludeOverlays = false;
+  }
+  Ogre::CompositorWorkspaceDef *wsDef =
+      compMgr->addWorkspaceDefinition(wsDefName);
+  wsDef->connectExternal(0, nodeDefName, 0);
+
+  Ogre::Camera *camera = this->ogreSceneManager->createCamera(probeName,
+      true, true);
+  camera->setFOVy(Ogre::Degree(90));
+  camera->setAspectRatio(1.0f);
+  camera->setFixedYawAxis(false);
+  camera->setNearClipDistance(0.01f);
+  camera->setFarClipDistance(1000.0f);
+  camera->setPosition(Ogre2Conversions::Convert(_position));
+
+  Ogre::CompositorChannel channel;
+  channel.target = cubemap->getBuffer(0)->getRenderTarget();
+  channel.textures.push_back(cubemap);
+  Ogre::CompositorWorkspace *workspace = compMgr->addWorkspace(
+      this->ogreSceneManager, channel, camera, wsDefName, false);
+  Ogre2RenderEngine::Instance()->RenderWorkspaces({workspace});
+
+  // faces in the order of ogre cubemap images
+  std::vector<unsigned char> faces(6u * _size * _size * 4u);
+  for (unsigned int i = 0u; i < 6u; ++i)
+  {
+    Ogre::PixelBox dst(_size, _size, 1u, Ogre::PF_BYTE_RGBA,
+        faces.data() + i * _size * _size * 4u);
+    cubemap->getBuffer(i)->blitToMemory(dst);
+  }
+
+  compMgr->removeWorkspace(workspace);
+  compMgr->removeWorkspaceDefinition(wsDefName);
+  compMgr->removeNodeDefinition(nodeDefName);
+  this->ogreSceneManager->destroyCamera(camera);
+  textureManager.remove(probeName);
+
+  Ogre::Image image;
+  image.loadDynamicImage(faces.data(), _size, _size, 1u, Ogre::PF_BYTE_RGBA,
+      false, 6u, 0u);
+  Ogre::HlmsTextureManager::TextureLocation location;
+  if (!Ogre2TextureStreamer::Instance()->CreateEnvironmentMap(_name, image,
+      location))
+  {
+    ignerr << "Unable to create environment map of reflection probe ["
+           << _name << "]" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Scene::SetAmbientLightFromEnvironmentMap(const std::string &_name)
+{
+  // load the environment map if no material did yet
+  auto streamer = Ogre2TextureStreamer::Instance();
+  std::vector<math::Vector3d> sh;
+  if (!streamer->EnvironmentIrradiance(_name, sh))
+  {
+    Ogre::HlmsTextureManager::TextureLocation location;
+    streamer->Load(_name, Ogre::HlmsTextureManager::TEXTURE_TYPE_ENV_MAP,
+        location);
+  }
+  if (!streamer->EnvironmentIrradiance(_name, sh))
+  {
+    ignerr << "Environment map [" << _name << "] has not been prefiltered"
+           << std::endl;
+    return false;
+  }
+
+  // cubemaps are left-handed, see skybox_fs.glsl
+  math::Vector3d upper = EnvironmentMapFilter::Irradiance(sh,
+      -math::Vector3d::UnitZ);
+  math::Vector3d lower = EnvironmentMapFilter::Irradiance(sh,
+      math::Vector3d::UnitZ);
+  this->ogreSceneManager->setAmbientLight(
+      Ogre::ColourValue(upper.X(), upper.Y(), upper.Z()),
+      Ogre::ColourValue(lower.X(), lower.Y(), lower.Z()),
+      Ogre::Vector3::UNIT_Z);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::SetLightClusterGrid(unsigned int _width,
+    unsigned int _height, unsigned int _slices)
+{
+  if (_width == 0u || _height == 0u || _slices == 0u)
+  {
+    ignerr << "Invalid light cluster grid: " << _width << " x " << _height
+           << " x " << _slices << std::endl;
+    return;
+  }
+
+  this->dataPtr->lightClusterWidth = _width;
+  this->dataPtr->lightClusterHeight = _height;
+  this->dataPtr->lightClusterSlices = _slices;
+  this->UpdateLightClusters();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::LightClusterGrid(unsigned int &_width,
+    unsigned int &_height, unsigned int &_slices) const
+{
+  _width = this->dataPtr->lightClusterWidth;
+  _height = this->dataPtr->lightClusterHeight;
+  _slices = this->dataPtr->lightClusterSlices;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::SetLightsPerCluster(unsigned int _lights)
+{
+  if (_lights == 0u)
+  {
+    ignerr << "Number of lights per cluster must be greater than zero"
+           << std::endl;
+    return;
+  }
+
+  this->dataPtr->lightsPerCluster = _lights;
+  this->UpdateLightClusters();
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2Scene::LightsPerCluster() const
+{
+  return this->dataPtr->lightsPerCluster;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::SetLightClusterRange(double _minDistance,
+    double _maxDistance)
+{
+  if (_minDistance <= 0.0 || _maxDistance <= _minDistance)
+  {
+    ignerr << "Invalid light cluster range: [" << _minDistance << ", "
+           << _maxDistance << "]" << std::endl;
+    return;
+  }
+
+  this->dataPtr->lightClusterMinDistance = _minDistance;
+  this->dataPtr->lightClusterMaxDistance = _maxDistance;
+  this->UpdateLightClusters();
+}
+
+//////////////////////////////////////////////////
+double Ogre2Scene::LightClusterMinDistance() const
+{
+  return this->dataPtr->lightClusterMinDistance;
+}
+
+//////////////////////////////////////////////////
+double Ogre2Scene::LightClusterMaxDistance() const
+{
+  return this->dataPtr->lightClusterMaxDistance;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::UpdateLightClusters()
+{
+  if (!this->ogreSceneManager)
+    return;
+
+  // forward clustered lighting is required for non-shadow-casting point
+  // lights and spot lights to work
+  this->ogreSceneManager->setForwardClustered(true,
+      this->dataPtr->lightClusterWidth,
+      this->dataPtr->lightClusterHeight,
+      this->dataPtr->lightClusterSlices,
+      this->dataPtr->lightsPerCluster,
+      static_cast<float>(this->dataPtr->lightClusterMinDistance),
+      static_cast<float>(this->dataPtr->lightClusterMaxDistance));
+}
+
 //////////////////////////////////////////////////
 bool Ogre2Scene::LoadImpl()
 {
@@ -222,21 +799,35 @@ bool Ogre2Scene::InitImpl()
 //////////////////////////////////////////////////
 void Ogre2Scene::UpdateShadowNode()
 {
-  if (!this->ShadowsDirty())
+  IGN_RENDERING_PROFILE("Ogre2Scene::UpdateShadowNode");
+  if (!this->ShadowsDirty() && !this->dataPtr->shadowNodeName.empty())
     return;
 
   unsigned int spotPointLightCount = 0;
   unsigned int dirLightCount = 0;
 
-  for (unsigned int i = 0; i < this->LightCount(); ++i)
+  // static spot / point lights get shadow maps of their own that are only
+  // rendered when static shadows are dirty. Directional lights use PSSM,
+  // whose splits follow the camera, so they are always dynamic.
+  std::vector<Ogre::Light *> staticLights;
+
+  for (unsigned int i = 0; i < this->lights->Size(); ++i)
   {
-    LightPtr light = this->LightByIndex(i);
+    Ogre2LightPtr light = this->lights->DerivedByIndex(i);
     if (light->CastShadows())
     {
-      if (std::dynamic_pointer_cast<DirectionalLight>(light))
+      if (light->Light()->getType() == Ogre::Light::LT_DIRECTIONAL)
+      {
         dirLightCount++;
+      }
+      else if (light->Static())
+      {
+        staticLights.push_back(light->Light());
+      }
       else
+      {
         spotPointLightCount++;
+      }
     }
   }
 
@@ -258,16 +849,78 @@ void Ogre2Scene::UpdateShadowNode()
             << spotPointLightCount << " point / spot lights" << std::endl;
   }
 
+  // static lights share one atlas, at most 4 x 4 shadow maps
+  unsigned int maxStaticShadowMaps = 16u;
+  unsigned int staticLightCount = std::min(
+      static_cast<unsigned int>(staticLights.size()),
+      std::min(maxShadowMaps - dirLightCount * 3 - spotPointLightCount,
+      maxStaticShadowMaps));
+  if (staticLightCount < staticLights.size())
+  {
+    ignwarn << "Number of static shadow-casting lights exceeds the limit "
+            << "supported by the underlying rendering engine ogre2. Limiting "
+            << "to " << staticLightCount << " static point / spot lights"
+            << std::endl;
+  }
+  staticLights.resize(staticLightCount);
+
+  // shadow map sizes other than the default one only need the light
+  // configuration to create their shadow node definition on demand
+  this->dataPtr->dirLightCount = dirLightCount;
+  this->dataPtr->spotPointLightCount = spotPointLightCount;
+  this->dataPtr->staticShadowMaps.clear();
+  size_t staticShadowMapIdx = dirLightCount * 3u + spotPointLightCount;
+  for (unsigned int i = 0; i < staticLightCount; ++i)
+  {
+    this->dataPtr->staticShadowMaps.emplace_back(staticShadowMapIdx + i,
+        staticLights[i]);
+  }
+  this->dataPtr->staticShadowsVersion++;
+
+  this->dataPtr->shadowNodeName =
+      this->CreateShadowNode(this->dataPtr->kShadowMapSize);
+
+  this->SetShadowsDirty(false);
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2Scene::CreateShadowNode(unsigned int _shadowMapSize)
+{
+  unsigned int dirLightCount = this->dataPtr->dirLightCount;
+  unsigned int spotPointLightCount = this->dataPtr->spotPointLightCount;
+  unsigned int staticLightCount =
+      static_cast<unsigned int>(this->dataPtr->staticShadowMaps.size());
+
+  // shadow node definitions are cached per light configuration and shadow
+  // map size, and never removed, so workspaces using a previous
+  // configuration stay valid and switching back to it is free
+  std::string shadowNodeDefName = this->dataPtr->kShadowNodeName + "_" +
+      std::to_string(dirLightCount) + "_" +
+      std::to_string(spotPointLightCount);
+  if (staticLightCount > 0u)
+  {
+    shadowNodeDefName += "_static";
+    for (const auto &staticShadowMap : this->dataPtr->staticShadowMaps)
+    {
+      shadowNodeDefName += "_" +
+          std::to_string(staticShadowMap.second->getType());
+    }
+  }
+  if (_shadowMapSize != this->dataPtr->kShadowMapSize)
+    shadowNodeDefName += "_" + std::to_string(_shadowMapSize);
+
   auto engine = Ogre2RenderEngine::Instance();
   Ogre::CompositorManager2 *compositorManager =
       engine->OgreRoot()->getCompositorManager2();
+  if (compositorManager->hasShadowNodeDefinition(shadowNodeDefName))
+    return shadowNodeDefName;
 
   Ogre::ShadowNodeHelper::ShadowParamVec shadowParams;
   Ogre::ShadowNodeHelper::ShadowParam shadowParam;
 
   // directional lights
   unsigned int atlasId = 0u;
-  unsigned int texSize = 2048u;
+  unsigned int texSize = _shadowMapSize;
   unsigned int halfTexSize = texSize * 0.5;
   for (unsigned int i = 0; i < dirLightCount; ++i)
   {
@@ -329,14 +982,102 @@ void Ogre2Scene::UpdateShadowNode()
     }
   }
 
-  std::string shadowNodeDefName = this->dataPtr->kShadowNodeName;
-  if (compositorManager->hasShadowNodeDefinition(shadowNodeDefName))
-    compositorManager->removeShadowNodeDefinition(shadowNodeDefName);
+  // static lights share one atlas, separate from the dynamic ones, so that
+  // clearing it can be skipped along with rendering its shadow maps
+  unsigned int staticAtlasId =
+      (colIdx > 0u || rowIdx > 0u) ? atlasId + 1u : atlasId;
+  unsigned int staticCols = std::max(1u, static_cast<unsigned int>(
+      std::ceil(std::sqrt(static_cast<double>(staticLightCount)))));
+  for (unsigned int i = 0; i < staticLightCount; ++i)
+  {
+    // uniform shadow maps of spot lights only depend on the light, unlike
+    // focused ones, so they stay valid for every camera
+    shadowParam.technique = Ogre::SHADOWMAP_UNIFORM;
+    shadowParam.atlasId = staticAtlasId;
+    shadowParam.resolution[0].x = texSize;
+    shadowParam.resolution[0].y = texSize;
+    shadowParam.atlasStart[0].x = (i % staticCols) * texSize;
+    shadowParam.atlasStart[0].y = (i / staticCols) * texSize;
+
+    shadowParam.supportedLightTypes = 0u;
+    shadowParam.addLightType(
+        this->dataPtr->staticShadowMaps[i].second->getType());
+    shadowParams.push_back(shadowParam);
+  }
 
   this->CreateShadowNodeWithSettings(compositorManager, shadowNodeDefName,
       shadowParams);
 
-  this->SetShadowsDirty(false);
+  // only clear the static atlas when its shadow maps are rendered
+  if (staticLightCount > 0u)
+  {
+    Ogre::CompositorShadowNodeDef *shadowNodeDef =
+        compositorManager->getShadowNodeDefinitionNonConst(
+        shadowNodeDefName);
+    Ogre::IdString staticAtlasName(
+        "atlas" + Ogre::StringConverter::toString(staticAtlasId));
+    for (size_t i = 0; i < shadowNodeDef->getNumTargetPasses(); ++i)
+    {
+      Ogre::CompositorTargetDef *targetDef = shadowNodeDef->getTargetPass(i);
+      if (targetDef->getRenderTargetName() != staticAtlasName)
+        continue;
+      for (Ogre::CompositorPassDef *pass :
+          targetDef->getCompositorPassesNonConst())
+      {
+        if (pass->getType() == Ogre::PASS_CLEAR)
+        {
+          pass->mShadowMapIdx =
+              this->dataPtr->staticShadowMaps.front().first;
+        }
+      }
+    }
+  }
+
+  return shadowNodeDefName;
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2Scene::ShadowNodeName(unsigned int _shadowMapSize)
+{
+  // pending light changes are left to PreRender so that all render targets
+  // are notified of them
+  if (this->dataPtr->shadowNodeName.empty())
+    this->UpdateShadowNode();
+
+  if (_shadowMapSize == 0u || _shadowMapSize == this->dataPtr->kShadowMapSize)
+    return this->dataPtr->shadowNodeName;
+  return this->CreateShadowNode(_shadowMapSize);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::ApplyShadowNode(const std::string &_nodeDefName,
+    const std::string &_targetName, const std::string &_shadowNodeName)
+{
+  auto engine = Ogre2RenderEngine::Instance();
+  Ogre::CompositorManager2 *compositorManager =
+      engine->OgreRoot()->getCompositorManager2();
+  if (!compositorManager->hasNodeDefinition(_nodeDefName))
+    return;
+
+  Ogre::IdString targetName(_targetName);
+  Ogre::CompositorNodeDef *nodeDef =
+      compositorManager->getNodeDefinitionNonConst(_nodeDefName);
+  for (size_t i = 0; i < nodeDef->getNumTargetPasses(); ++i)
+  {
+    Ogre::CompositorTargetDef *targetDef = nodeDef->getTargetPass(i);
+    if (targetDef->getRenderTargetName() != targetName)
+      continue;
+    for (Ogre::CompositorPassDef *pass :
+        targetDef->getCompositorPassesNonConst())
+    {
+      if (pass->getType() != Ogre::PASS_SCENE)
+        continue;
+      Ogre::CompositorPassSceneDef *passScene =
+          static_cast<Ogre::CompositorPassSceneDef *>(pass);
+      passScene->mShadowNode = _shadowNodeName.empty() ?
+          Ogre::IdString() : Ogre::IdString(_shadowNodeName);
+    }
+  }
 }
 
 ////////////////////////////////////////////////////
@@ -706,11 +1447,30 @@ GpuRaysPtr Ogre2Scene::CreateGpuRaysImpl(unsigned int _id,
   return (result) ? gpuRays : nullptr;
 }
 
+//////////////////////////////////////////////////
+WideAngleCameraPtr Ogre2Scene::CreateWideAngleCameraImpl(unsigned int _id,
+    const std::string &_name)
+{
+  Ogre2WideAngleCameraPtr camera(new Ogre2WideAngleCamera);
+  bool result = this->InitObject(camera, _id, _name);
+  return (result) ? camera : nullptr;
+}
+
+//////////////////////////////////////////////////
+SegmentationCameraPtr Ogre2Scene::CreateSegmentationCameraImpl(
+    unsigned int _id, const std::string &_name)
+{
+  Ogre2SegmentationCameraPtr camera(new Ogre2SegmentationCamera);
+  bool result = this->InitObject(camera, _id, _name);
+  return (result) ? camera : nullptr;
+}
+
 //////////////////////////////////////////////////
 VisualPtr Ogre2Scene::CreateVisualImpl(unsigned int _id,
     const std::string &_name)
 {
-  Ogre2VisualPtr visual(new Ogre2Visual);
+  Ogre2VisualPtr visual = SharePooled(
+      new (AllocatePooled<Ogre2Visual>()) Ogre2Visual);
   bool result = this->InitObject(visual, _id, _name);
   return (result) ? visual : nullptr;
 }
@@ -733,6 +1493,15 @@ AxisVisualPtr Ogre2Scene::CreateAxisVisualImpl(unsigned int _id,
   return (result) ? visual : nullptr;
 }
 
+//////////////////////////////////////////////////
+PoseArrayVisualPtr Ogre2Scene::CreatePoseArrayVisualImpl(unsigned int _id,
+    const std::string &_name)
+{
+  Ogre2PoseArrayVisualPtr visual(new Ogre2PoseArrayVisual);
+  bool result = this->InitObject(visual, _id, _name);
+  return (result) ? visual : nullptr;
+}
+
 //////////////////////////////////////////////////
 LightVisualPtr Ogre2Scene::CreateLightVisualImpl(unsigned int _id,
     const std::string &_name)
@@ -806,30 +1575,57 @@ MeshPtr Ogre2Scene::CreateMeshImpl(unsigned int _id,
   return (result) ? mesh : nullptr;
 }
 
+//////////////////////////////////////////////////
+std::shared_future<bool> Ogre2Scene::PrepareMesh(const MeshDescriptor &_desc)
+{
+  return this->meshFactory->LoadAsync(_desc);
+}
+
+//////////////////////////////////////////////////
+MeshPtr Ogre2Scene::CloneMeshImpl(unsigned int _id,
+    const std::string &_name, const Mesh &_mesh)
+{
+  const Ogre2Mesh *derived = dynamic_cast<const Ogre2Mesh *>(&_mesh);
+  if (!derived)
+  {
+    ignerr << "Cannot clone mesh created by another render-engine"
+        << std::endl;
+    return nullptr;
+  }
+
+  Ogre2MeshPtr mesh = this->meshFactory->Clone(*derived);
+  if (nullptr == mesh)
+    return nullptr;
+
+  bool result = this->InitObject(mesh, _id, _name);
+  return (result) ? mesh : nullptr;
+}
+
 //////////////////////////////////////////////////
 CapsulePtr Ogre2Scene::CreateCapsuleImpl(unsigned int _id,
     const std::string &_name)
 {
-  Ogre2CapsulePtr capsule(new Ogre2Capsule);
+  Ogre2CapsulePtr capsule = SharePooled(
+      new (AllocatePooled<Ogre2Capsule>()) Ogre2Capsule);
   bool result = this->InitObject(capsule, _id, _name);
   return (result) ? capsule : nullptr;
 }
 
 //////////////////////////////////////////////////
-HeightmapPtr Ogre2Scene::CreateHeightmapImpl(unsigned int,
-    const std::string &, const HeightmapDescriptor &)
+HeightmapPtr Ogre2Scene::CreateHeightmapImpl(unsigned int _id,
+    const std::string &_name, const HeightmapDescriptor &_desc)
 {
-  ignerr << "Ogre 2 doesn't support heightmaps yet, see " <<
-      "https://github.com/ignitionrobotics/ign-rendering/issues/187"
-      << std::endl;
-  return nullptr;
+  Ogre2HeightmapPtr heightmap(new Ogre2Heightmap(_desc));
+  bool result = this->InitObject(heightmap, _id, _name);
+  return (result) ? heightmap : nullptr;
 }
 
 //////////////////////////////////////////////////
 GridPtr Ogre2Scene::CreateGridImpl(unsigned int _id,
     const std::string &_name)
 {
-  Ogre2GridPtr grid(new Ogre2Grid);
+  Ogre2GridPtr grid = SharePooled(
+      new (AllocatePooled<Ogre2Grid>()) Ogre2Grid);
   bool result = this->InitObject(grid, _id, _name);
   return (result) ? grid : nullptr;
 }
@@ -838,7 +1634,8 @@ GridPtr Ogre2Scene::CreateGridImpl(unsigned int _id,
 WireBoxPtr Ogre2Scene::CreateWireBoxImpl(unsigned int _id,
     const std::string &_name)
 {
-  Ogre2WireBoxPtr wireBox(new Ogre2WireBox);
+  Ogre2WireBoxPtr wireBox = SharePooled(
+      new (AllocatePooled<Ogre2WireBox>()) Ogre2WireBox);
   bool result = this->InitObject(wireBox, _id, _name);
   return (result) ? wireBox: nullptr;
 }
@@ -847,7 +1644,8 @@ WireBoxPtr Ogre2Scene::CreateWireBoxImpl(unsigned int _id,
 MarkerPtr Ogre2Scene::CreateMarkerImpl(unsigned int _id,
     const std::string &_name)
 {
-  Ogre2MarkerPtr marker(new Ogre2Marker);
+  Ogre2MarkerPtr marker = SharePooled(
+      new (AllocatePooled<Ogre2Marker>()) Ogre2Marker);
   bool result = this->InitObject(marker, _id, _name);
   return (result) ? marker: nullptr;
 }
@@ -856,24 +1654,45 @@ MarkerPtr Ogre2Scene::CreateMarkerImpl(unsigned int _id,
 LidarVisualPtr Ogre2Scene::CreateLidarVisualImpl(unsigned int _id,
     const std::string &_name)
 {
-  Ogre2LidarVisualPtr lidar(new Ogre2LidarVisual);
+  Ogre2LidarVisualPtr lidar = SharePooled(
+      new (AllocatePooled<Ogre2LidarVisual>()) Ogre2LidarVisual);
   bool result = this->InitObject(lidar, _id, _name);
   return (result) ? lidar: nullptr;
 }
 
 //////////////////////////////////////////////////
-TextPtr Ogre2Scene::CreateTextImpl(unsigned int /*_id*/,
-    const std::string &/*_name*/)
+PointCloudVisualPtr Ogre2Scene::CreatePointCloudVisualImpl(unsigned int _id,
+    const std::string &_name)
 {
-  // TODO(anyone)
-  return TextPtr();
+  Ogre2PointCloudVisualPtr cloud = SharePooled(
+      new (AllocatePooled<Ogre2PointCloudVisual>()) Ogre2PointCloudVisual);
+  bool result = this->InitObject(cloud, _id, _name);
+  return (result) ? cloud: nullptr;
+}
+
+//////////////////////////////////////////////////
+TextPtr Ogre2Scene::CreateTextImpl(unsigned int _id,
+    const std::string &_name)
+{
+  if (Ogre2RenderEngine::Instance()->MinimalResources())
+  {
+    ignerr << "Text geometries are not available with the minimal "
+           << "resources" << std::endl;
+    return nullptr;
+  }
+
+  Ogre2TextPtr text = SharePooled(
+      new (AllocatePooled<Ogre2Text>()) Ogre2Text);
+  bool result = this->InitObject(text, _id, _name);
+  return (result) ? text : nullptr;
 }
 
 //////////////////////////////////////////////////
 MaterialPtr Ogre2Scene::CreateMaterialImpl(unsigned int _id,
     const std::string &_name)
 {
-  Ogre2MaterialPtr material(new Ogre2Material);
+  Ogre2MaterialPtr material = SharePooled(
+      new (AllocatePooled<Ogre2Material>()) Ogre2Material);
   bool result = this->InitObject(material, _id, _name);
   return (result) ? material : nullptr;
 }
@@ -888,11 +1707,12 @@ RenderTexturePtr Ogre2Scene::CreateRenderTextureImpl(unsigned int _id,
 }
 
 //////////////////////////////////////////////////
-RenderWindowPtr Ogre2Scene::CreateRenderWindowImpl(unsigned int /*_id*/,
-    const std::string &/*_name*/)
+RenderWindowPtr Ogre2Scene::CreateRenderWindowImpl(unsigned int _id,
+    const std::string &_name)
 {
-  // TODO(anyone)
-  return RenderWindowPtr();
+  Ogre2RenderWindowPtr renderWindow(new Ogre2RenderWindow);
+  bool result = this->InitObject(renderWindow, _id, _name);
+  return (result) ? renderWindow : nullptr;
 }
 
 //////////////////////////////////////////////////
@@ -908,6 +1728,13 @@ RayQueryPtr Ogre2Scene::CreateRayQueryImpl(unsigned int _id,
 ParticleEmitterPtr Ogre2Scene::CreateParticleEmitterImpl(unsigned int _id,
     const std::string &_name)
 {
+  if (Ogre2RenderEngine::Instance()->MinimalResources())
+  {
+    ignerr << "Particle emitters are not available with the minimal "
+           << "resources" << std::endl;
+    return nullptr;
+  }
+
   Ogre2ParticleEmitterPtr visual(new Ogre2ParticleEmitter);
   bool result = this->InitObject(visual, _id, _name);
 
@@ -933,18 +1760,20 @@ bool Ogre2Scene::InitObject(Ogre2ObjectPtr _object, unsigned int _id,
 //////////////////////////////////////////////////
 void Ogre2Scene::CreateContext()
 {
-  Ogre::Root *root = Ogre2RenderEngine::Instance()->OgreRoot();
+  auto engine = Ogre2RenderEngine::Instance();
+  Ogre::Root *root = engine->OgreRoot();
 
-  Ogre::InstancingThreadedCullingMethod threadedCullingMethod =
-      Ogre::INSTANCING_CULLING_SINGLETHREAD;
-  // getNumLogicalCores() may return 0 if couldn't detect
-  const size_t numThreads = std::max<size_t>(
-      1, Ogre::PlatformInformation::getNumLogicalCores());
+  // the worker threads update the scene graph and cull the objects of each
+  // render pass, e.g. of each cubemap face of the lidars, in parallel
+  const size_t numThreads = engine->WorkerThreadCount();
 
   // See ogre doxygen documentation regarding culling methods.
   // In some cases you may still want to use single thread.
-  // if( numThreads > 1 )
-  //   threadedCullingMethod = Ogre::INSTANCING_CULLING_THREADED;
+  Ogre::InstancingThreadedCullingMethod threadedCullingMethod =
+      Ogre::INSTANCING_CULLING_SINGLETHREAD;
+  if (numThreads > 1u && engine->ThreadedCulling())
+    threadedCullingMethod = Ogre::INSTANCING_CULLING_THREADED;
+
   // Create the SceneManager, in this case a generic one
   this->ogreSceneManager = root->createSceneManager(Ogre::ST_GENERIC,
                                                     numThreads,
@@ -962,9 +1791,7 @@ void Ogre2Scene::CreateContext()
   this->ogreSceneManager->setShadowFarDistance(500.0f);
 
   // enable forward plus to support multiple lights
-  // this is required for non-shadow-casting point lights and
-  // spot lights to work
-  this->ogreSceneManager->setForwardClustered(true, 16, 8, 24, 96, 1, 500);
+  this->UpdateLightClusters();
 }
 
 //////////////////////////////////////////////////
@@ -1026,6 +1853,227 @@ bool Ogre2Scene::ShadowsDirty() const
   return this->dataPtr->shadowsDirty;
 }
 
+//////////////////////////////////////////////////
+void Ogre2Scene::SetStaticShadowsDirty()
+{
+  this->dataPtr->staticShadowsDirty = true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::UpdateStaticShadows(Ogre::CompositorWorkspace *_workspace,
+    const std::string &_shadowNodeName, uint64_t &_version)
+{
+  IGN_RENDERING_PROFILE("Ogre2Scene::UpdateStaticShadows");
+  if (!_workspace || _shadowNodeName.empty() ||
+      _version == this->dataPtr->staticShadowsVersion)
+  {
+    return;
+  }
+
+  if (!this->dataPtr->staticShadowMaps.empty())
+  {
+    Ogre::CompositorShadowNode *shadowNode =
+        _workspace->findShadowNode(_shadowNodeName);
+    if (!shadowNode)
+      return;
+
+    // fixing a light to a shadow map makes the shadow map static, its passes
+    // are then skipped until the shadow map is marked dirty
+    for (const auto &staticShadowMap : this->dataPtr->staticShadowMaps)
+    {
+      shadowNode->setLightFixedToShadowMap(staticShadowMap.first,
+          staticShadowMap.second);
+    }
+    // all static shadow maps share one atlas so they are all linked to the
+    // first one
+    shadowNode->setStaticShadowMapDirty(
+        this->dataPtr->staticShadowMaps.front().first, true);
+  }
+
+  _version = this->dataPtr->staticShadowsVersion;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::AddParticleEmitter(Ogre2ParticleEmitter *_emitter)
+{
+  auto &emitters = this->dataPtr->particleEmitters;
+  if (std::find(emitters.begin(), emitters.end(), _emitter) == emitters.end())
+    emitters.push_back(_emitter);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::RemoveParticleEmitter(Ogre2ParticleEmitter *_emitter)
+{
+  auto &emitters = this->dataPtr->particleEmitters;
+  emitters.erase(std::remove(emitters.begin(), emitters.end(), _emitter),
+      emitters.end());
+}
+
+//////////////////////////////////////////////////
+const std::vector<Ogre2ParticleEmitter *> &Ogre2Scene::ParticleEmitters()
+    const
+{
+  return this->dataPtr->particleEmitters;
+}
+
+//////////////////////////////////////////////////
+Ogre2VisualPtr Ogre2Scene::OgreVisualById(unsigned int _id) const
+{
+  return this->visuals->DerivedById(_id);
+}
+
+//////////////////////////////////////////////////
+Ogre2NodePtr Ogre2Scene::OgreNodeById(unsigned int _id) const
+{
+  Ogre2NodePtr node = this->visuals->DerivedById(_id);
+  if (!node)
+    node = this->lights->DerivedById(_id);
+  if (!node)
+    node = this->sensors->DerivedById(_id);
+  return node;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::SetParticleCullDistance(double _distance)
+{
+  this->dataPtr->particleCullDistance = std::max(0.0, _distance);
+}
+
+//////////////////////////////////////////////////
+double Ogre2Scene::ParticleCullDistance() const
+{
+  return this->dataPtr->particleCullDistance;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::SetParticleLodDistance(double _distance)
+{
+  this->dataPtr->particleLodDistance = std::max(0.0, _distance);
+}
+
+//////////////////////////////////////////////////
+double Ogre2Scene::ParticleLodDistance() const
+{
+  return this->dataPtr->particleLodDistance;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Scene::VisualBoundsTracked() const
+{
+  // Ogre2Visual reports the changes of its cached bounding boxes
+  return true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::SetOcclusionCulling(bool _enabled)
+{
+  this->dataPtr->occlusionCulling = _enabled;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Scene::OcclusionCulling() const
+{
+  return this->dataPtr->occlusionCulling;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::SetOcclusionCullingMargin(double _margin)
+{
+  this->dataPtr->occlusionCullingMargin = std::max(0.0, _margin);
+}
+
+//////////////////////////////////////////////////
+double Ogre2Scene::OcclusionCullingMargin() const
+{
+  return this->dataPtr->occlusionCullingMargin;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::AddParticleViewer(const Ogre::Camera *_camera)
+{
+  if (!_camera || this->dataPtr->particleEmitters.empty())
+    return;
+
+  if (this->dataPtr->particleCullDistance <= 0.0 &&
+      this->dataPtr->particleLodDistance <= 0.0)
+  {
+    return;
+  }
+
+  Ogre2ParticleViewer &viewer = this->dataPtr->particleViewers[_camera];
+  viewer.position = _camera->getDerivedPosition();
+  const Ogre::Plane *planes = _camera->getFrustumPlanes();
+  for (unsigned int i = 0u; i < 6u; ++i)
+    viewer.planes[i] = planes[i];
+  viewer.time = this->Time();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::UpdateParticleCulling()
+{
+  IGN_RENDERING_PROFILE("Ogre2Scene::UpdateParticleCulling");
+  double cullDistance = this->dataPtr->particleCullDistance;
+  double lodDistance = this->dataPtr->particleLodDistance;
+  auto &viewers = this->dataPtr->particleViewers;
+
+  // forget the sensors that have not been rendered recently. The scene time
+  // may also have been reset, do not keep views from the future.
+  auto now = this->Time();
+  for (auto it = viewers.begin(); it != viewers.end();)
+  {
+    if (it->second.time > now || now - it->second.time > kParticleViewerTimeout)
+      it = viewers.erase(it);
+    else
+      ++it;
+  }
+
+  for (Ogre2ParticleEmitter *emitter : this->dataPtr->particleEmitters)
+  {
+    // without any view, leave the emitters as they are
+    if (viewers.empty())
+    {
+      if (cullDistance <= 0.0)
+        emitter->SetCulled(false);
+      if (lodDistance <= 0.0)
+        emitter->SetRateScale(1.0);
+      continue;
+    }
+
+    Ogre::Vector3 center = Ogre2Conversions::Convert(emitter->WorldPosition());
+    Ogre::Real radius = static_cast<Ogre::Real>(emitter->ReachRadius());
+    double nearest = std::numeric_limits<double>::max();
+    bool inView = false;
+    for (const auto &it : viewers)
+    {
+      const Ogre2ParticleViewer &viewer = it.second;
+      double distance = std::max(0.0,
+          static_cast<double>(center.distance(viewer.position) - radius));
+      nearest = std::min(nearest, distance);
+      if (inView || (cullDistance > 0.0 && distance > cullDistance))
+        continue;
+
+      // the far plane is left to the cull distance
+      bool inside = true;
+      for (unsigned int i = 0u; i < 6u && inside; ++i)
+      {
+        if (i != Ogre::FRUSTUM_PLANE_FAR &&
+            viewer.planes[i].getDistance(center) < -radius)
+        {
+          inside = false;
+        }
+      }
+      inView = inside;
+    }
+
+    emitter->SetCulled(cullDistance > 0.0 && !inView);
+
+    double rateScale = 1.0;
+    if (lodDistance > 0.0 && nearest > lodDistance)
+      rateScale = (lodDistance * lodDistance) / (nearest * nearest);
+    emitter->SetRateScale(rateScale);
+  }
+}
+
 //////////////////////////////////////////////////
 void Ogre2Scene::SetSkyEnabled(bool _enabled)
 {
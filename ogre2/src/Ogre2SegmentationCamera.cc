@@ -0,0 +1,864 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#if (_WIN32)
+  /* Needed for std::min */
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#ifdef _MSC_VER
+#pragma warning(push, 0)
+#endif
+#include <Hlms/Unlit/OgreHlmsUnlitDatablock.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/MemoryTracker.hh"
+#include "ignition/rendering/Profiler.hh"
+#include "ignition/rendering/RenderTypes.hh"
+#include "ignition/rendering/UserDataKey.hh"
+#include "ignition/rendering/ogre2/Ogre2Includes.hh"
+#include "ignition/rendering/ogre2/Ogre2ParticleEmitter.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderTarget.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderTypes.hh"
+#include "ignition/rendering/ogre2/Ogre2Scene.hh"
+#include "ignition/rendering/ogre2/Ogre2SegmentationCamera.hh"
+#include "ignition/rendering/ogre2/Ogre2Visual.hh"
+
+#include "Ogre2GpuTimer.hh"
+#include "Ogre2ReadbackManager.hh"
+
+namespace ignition
+{
+namespace rendering
+{
+inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+//
+/// \brief Get the color a label is rendered with. 32 bit labels are split
+/// in the 4 bytes of an RGBA color, most significant first. 16 bit labels
+/// are the red channel of an L16 texture, saturated to 65535.
+/// \param[in] _label Label
+/// \param[in] _bits Label bit depth, 16 or 32
+/// \return Color encoding the label
+static Ogre::ColourValue labelColour(uint32_t _label, unsigned int _bits)
+{
+  if (_bits == 16u)
+  {
+    return Ogre::ColourValue(
+        std::min<uint32_t>(_label, 0xFFFFu) / 65535.0f, 0.0f, 0.0f, 1.0f);
+  }
+  return Ogre::ColourValue(
+      ((_label >> 24) & 0xFFu) / 255.0f,
+      ((_label >> 16) & 0xFFu) / 255.0f,
+      ((_label >> 8) & 0xFFu) / 255.0f,
+      (_label & 0xFFu) / 255.0f);
+}
+
+/// \brief Helper class switching the items to unlit datablocks encoding
+/// their labels while a segmentation camera is rendered
+class Ogre2SegmentationMaterialSwitcher : public Ogre::RenderTargetListener
+{
+  /// \brief Constructor
+  /// \param[in] _scene Scene the camera belongs to
+  /// \param[in] _name Name of the segmentation camera, unique prefix of
+  /// the datablock names
+  public: Ogre2SegmentationMaterialSwitcher(Ogre2ScenePtr _scene,
+              const std::string &_name);
+
+  /// \brief Destructor
+  public: ~Ogre2SegmentationMaterialSwitcher();
+
+  /// \brief Set what the labels identify
+  /// \param[in] _type Segmentation type
+  public: void SetSegmentationType(SegmentationType _type);
+
+  /// \brief Set the label of items without label
+  /// \param[in] _label Background label
+  public: void SetBackgroundLabel(uint32_t _label);
+
+  /// \brief Set the bit depth the labels are encoded with
+  /// \param[in] _bits 16 or 32
+  public: void SetLabelBitDepth(unsigned int _bits);
+
+  /// \brief Callback when a render target is about to be rendered
+  /// \param[in] _evt Ogre render target event containing information about
+  /// the source render target.
+  private: virtual void preRenderTargetUpdate(
+      const Ogre::RenderTargetEvent &_evt) override;
+
+  /// \brief Callback when a render target is finished being rendered
+  /// \param[in] _evt Ogre render target event containing information about
+  /// the source render target.
+  private: virtual void postRenderTargetUpdate(
+      const Ogre::RenderTargetEvent &_evt) override;
+
+  /// \brief Get the label of a visual
+  /// \param[in] _visualId Id of the visual
+  /// \return Label, the background label if the visual has none
+  private: uint32_t VisualLabel(unsigned int _visualId);
+
+  /// \brief Get the datablock of a label, creating it the first time the
+  /// label is rendered
+  /// \param[in] _label Label
+  /// \return Unlit datablock, null if it could not be created
+  private: Ogre::HlmsUnlitDatablock *LabelDatablock(uint32_t _label);
+
+  /// \brief Datablock a label is rendered with
+  private: struct LabelEntry
+  {
+    /// \brief Unlit datablock, owned by the switcher
+    Ogre::HlmsUnlitDatablock *datablock = nullptr;
+
+    /// \brief Value of traversal the last time the label was rendered
+    unsigned int traversal = 0u;
+  };
+
+  /// \brief Scene the camera belongs to
+  private: Ogre2ScenePtr scene;
+
+  /// \brief Name of the segmentation camera
+  private: const std::string name;
+
+  /// \brief What the labels identify
+  private: SegmentationType type = SEG_SEMANTIC;
+
+  /// \brief Label of items without label
+  private: uint32_t backgroundLabel = 0u;
+
+  /// \brief Label bit depth
+  private: unsigned int labelBitDepth = 32u;
+
+  /// \brief Datablocks of the labels rendered so far. They are kept until
+  /// no item is rendered with them.
+  private: std::unordered_map<uint32_t, LabelEntry> labelDatablocks;
+
+  /// \brief Labels of the visuals found in the current render. The key
+  /// is the visual's ID.
+  private: std::unordered_map<unsigned int, uint32_t> visualLabels;
+
+  /// \brief Original hlms datablocks of the sub items swapped for the
+  /// current render
+  private: std::vector<std::pair<Ogre::SubItem *, Ogre::HlmsDatablock *>>
+      datablocks;
+
+  /// \brief Number of times the camera has been rendered. Used to find
+  /// labels that are no longer rendered
+  private: unsigned int traversal = 0u;
+};
+}
+}
+}
+
+/// \internal
+/// \brief Private data for the Ogre2SegmentationCamera class
+class ignition::rendering::Ogre2SegmentationCameraPrivate
+{
+  /// \brief Buffer the labels are read back to
+  public: unsigned char *readBuffer = nullptr;
+
+  /// \brief Outgoing 32 bit labels, used by newSegmentationFrame event
+  public: uint32_t *labelImage = nullptr;
+
+  /// \brief Compositor workspace definition
+  public: std::string ogreCompositorWorkspaceDef;
+
+  /// \brief Compositor node definition
+  public: std::string ogreCompositorNodeDef;
+
+  /// \brief Compositor workspace rendering the labels
+  public: Ogre::CompositorWorkspace *ogreCompositorWorkspace = nullptr;
+
+  /// \brief Clear pass of the workspace definition, filling the image
+  /// with the background label
+  public: Ogre::CompositorPassClearDef *clearPassDef = nullptr;
+
+  /// \brief Texture the labels are rendered to
+  public: Ogre::TexturePtr ogreLabelTexture;
+
+  /// \brief Dummy render texture
+  public: RenderTexturePtr renderTexture;
+
+  /// \brief Label bit depth of the texture
+  public: unsigned int labelBitDepth = 32u;
+
+  /// \brief Event used to signal 32 bit labels
+  public: common::EventT<void(const uint32_t *, unsigned int,
+      unsigned int, unsigned int, const std::string &)>
+      newSegmentationFrame;
+
+  /// \brief Event used to signal labels at their bit depth
+  public: common::EventT<void(const unsigned char *, unsigned int,
+      unsigned int, unsigned int, const std::string &)>
+      newRawSegmentationFrame;
+
+  /// \brief Switches the items to their label datablocks
+  public: std::unique_ptr<Ogre2SegmentationMaterialSwitcher>
+      materialSwitcher;
+
+  /// \brief Listener timing the compositor passes of the camera
+  public: std::unique_ptr<Ogre2GpuTimerListener> gpuTimerListener;
+
+  /// \brief Id of this camera in the readback manager. Zero if
+  /// asynchronous readback is disabled
+  public: unsigned int readbackClient = 0u;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+Ogre2SegmentationMaterialSwitcher::Ogre2SegmentationMaterialSwitcher(
+    Ogre2ScenePtr _scene, const std::string &_name)
+  : scene(_scene), name(_name)
+{
+}
+
+//////////////////////////////////////////////////
+Ogre2SegmentationMaterialSwitcher::~Ogre2SegmentationMaterialSwitcher()
+{
+  // the hlms is gone if the engine was shut down first
+  Ogre::Root *root = Ogre::Root::getSingletonPtr();
+  if (!root)
+    return;
+  for (auto &entry : this->labelDatablocks)
+  {
+    if (entry.second.datablock)
+    {
+      entry.second.datablock->getCreator()->destroyDatablock(
+          entry.second.datablock->getName());
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2SegmentationMaterialSwitcher::SetSegmentationType(
+    SegmentationType _type)
+{
+  this->type = _type;
+}
+
+//////////////////////////////////////////////////
+void Ogre2SegmentationMaterialSwitcher::SetBackgroundLabel(uint32_t _label)
+{
+  this->backgroundLabel = _label;
+}
+
+//////////////////////////////////////////////////
+void Ogre2SegmentationMaterialSwitcher::SetLabelBitDepth(unsigned int _bits)
+{
+  this->labelBitDepth = _bits;
+}
+
+//////////////////////////////////////////////////
+uint32_t Ogre2SegmentationMaterialSwitcher::VisualLabel(
+    unsigned int _visualId)
+{
+  // the items of a visual share its label, so it is only looked up once
+  // per render
+  auto inserted = this->visualLabels.emplace(_visualId,
+      this->backgroundLabel);
+  uint32_t &label = inserted.first->second;
+  if (!inserted.second)
+    return label;
+
+  VisualPtr visual = this->scene->OgreVisualById(_visualId);
+  if (!visual)
+    return label;
+
+  if (this->type == SEG_INSTANCE)
+  {
+    // the instance is the top level visual, below the root visual
+    VisualPtr root = this->scene->RootVisual();
+    VisualPtr parent = std::dynamic_pointer_cast<Visual>(visual->Parent());
+    while (parent && parent != root)
+    {
+      visual = parent;
+      parent = std::dynamic_pointer_cast<Visual>(visual->Parent());
+    }
+    label = visual->Id();
+    return label;
+  }
+
+  // the label is set on the visual or on one of its ancestors. Negative
+  // labels are ignored
+  static const UserDataKey labelKey("label");
+  while (visual)
+  {
+    const int *value = std::get_if<int>(&visual->UserData(labelKey));
+    if (value)
+    {
+      if (*value >= 0)
+        label = static_cast<uint32_t>(*value);
+      return label;
+    }
+    visual = std::dynamic_pointer_cast<Visual>(visual->Parent());
+  }
+  return label;
+}
+
+//////////////////////////////////////////////////
+Ogre::HlmsUnlitDatablock *Ogre2SegmentationMaterialSwitcher::LabelDatablock(
+    uint32_t _label)
+{
+  LabelEntry &entry = this->labelDatablocks[_label];
+  entry.traversal = this->traversal;
+  if (entry.datablock)
+    return entry.datablock;
+
+  Ogre::HlmsManager *hlmsManager =
+      Ogre2RenderEngine::Instance()->OgreRoot()->getHlmsManager();
+  Ogre::HlmsUnlit *hlmsUnlit = static_cast<Ogre::HlmsUnlit *>(
+      hlmsManager->getHlms(Ogre::HLMS_UNLIT));
+  if (!hlmsUnlit)
+  {
+    ignerr << "Ogre HLMS UNLIT not ready. Unable to render labels of "
+           << "segmentation camera [" << this->name << "]" << std::endl;
+    return nullptr;
+  }
+
+  // opaque, so that the alpha channel holds the lowest byte of the label
+  std::string datablockName = this->name + "::Label" +
+      std::to_string(_label);
+  entry.datablock = static_cast<Ogre::HlmsUnlitDatablock *>(
+      hlmsUnlit->createDatablock(datablockName, datablockName,
+      Ogre::HlmsMacroblock(), Ogre::HlmsBlendblock(), Ogre::HlmsParamVec()));
+  entry.datablock->setUseColour(true);
+  entry.datablock->setColour(labelColour(_label, this->labelBitDepth));
+  return entry.datablock;
+}
+
+//////////////////////////////////////////////////
+void Ogre2SegmentationMaterialSwitcher::preRenderTargetUpdate(
+    const Ogre::RenderTargetEvent & /*_evt*/)
+{
+  IGN_RENDERING_PROFILE("Ogre2SegmentationMaterialSwitcher::preRender");
+  this->datablocks.clear();
+  this->visualLabels.clear();
+  ++this->traversal;
+
+  auto itor = this->scene->OgreSceneManager()->getMovableObjectIterator(
+      Ogre::ItemFactory::FACTORY_TYPE_NAME);
+  while (itor.hasMoreElements())
+  {
+    Ogre::Item *item = static_cast<Ogre::Item *>(itor.getNext());
+
+    // the visual id is set when the item is attached to a visual. Other
+    // items are background
+    uint32_t label = this->backgroundLabel;
+    Ogre::Any userAny = item->getUserObjectBindings().getUserAny();
+    if (!userAny.isEmpty() && userAny.getType() == typeid(unsigned int))
+      label = this->VisualLabel(Ogre::any_cast<unsigned int>(userAny));
+
+    Ogre::HlmsUnlitDatablock *datablock = this->LabelDatablock(label);
+    if (!datablock)
+      continue;
+    for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
+    {
+      Ogre::SubItem *subItem = item->getSubItem(i);
+      this->datablocks.emplace_back(subItem, subItem->getDatablock());
+      subItem->setDatablock(datablock);
+    }
+  }
+
+  // destroy the datablocks of labels no item has anymore. None of the sub
+  // items refer to them since they were restored after the last render
+  for (auto it = this->labelDatablocks.begin();
+      it != this->labelDatablocks.end();)
+  {
+    if (it->second.traversal != this->traversal)
+    {
+      if (it->second.datablock)
+      {
+        it->second.datablock->getCreator()->destroyDatablock(
+            it->second.datablock->getName());
+      }
+      it = this->labelDatablocks.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2SegmentationMaterialSwitcher::postRenderTargetUpdate(
+    const Ogre::RenderTargetEvent & /*_evt*/)
+{
+  // restore the hlms datablocks of the items
+  for (auto &subItemDatablock : this->datablocks)
+    subItemDatablock.first->setDatablock(subItemDatablock.second);
+  this->datablocks.clear();
+}
+
+//////////////////////////////////////////////////
+Ogre2SegmentationCamera::Ogre2SegmentationCamera()
+  : dataPtr(new Ogre2SegmentationCameraPrivate())
+{
+}
+
+//////////////////////////////////////////////////
+Ogre2SegmentationCamera::~Ogre2SegmentationCamera()
+{
+  this->Destroy();
+}
+
+//////////////////////////////////////////////////
+void Ogre2SegmentationCamera::Init()
+{
+  BaseSegmentationCamera::Init();
+
+  // create internal camera
+  this->CreateCamera();
+
+  // create dummy render texture
+  this->CreateRenderTexture();
+
+  this->Reset();
+}
+
+//////////////////////////////////////////////////
+void Ogre2SegmentationCamera::Destroy()
+{
+  // the queued frames refer to the events of this sensor
+  this->FlushFrames();
+
+  this->SetAsyncReadback(false);
+
+  if (this->dataPtr->readBuffer)
+  {
+    MemoryTracker::Untrack(this->dataPtr->readBuffer);
+    delete [] this->dataPtr->readBuffer;
+    this->dataPtr->readBuffer = nullptr;
+  }
+
+  if (this->dataPtr->labelImage)
+  {
+    MemoryTracker::Untrack(this->dataPtr->labelImage);
+    delete [] this->dataPtr->labelImage;
+    this->dataPtr->labelImage = nullptr;
+  }
+
+  if (!this->ogreCamera)
+    return;
+
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
+
+  // remove the workspace, texture and datablocks
+  if (this->dataPtr->ogreCompositorWorkspace)
+  {
+    ogreCompMgr->removeWorkspace(this->dataPtr->ogreCompositorWorkspace);
+    this->dataPtr->ogreCompositorWorkspace = nullptr;
+  }
+
+  if (!this->dataPtr->ogreCompositorWorkspaceDef.empty())
+  {
+    ogreCompMgr->removeWorkspaceDefinition(
+        this->dataPtr->ogreCompositorWorkspaceDef);
+    ogreCompMgr->removeNodeDefinition(this->dataPtr->ogreCompositorNodeDef);
+    this->dataPtr->ogreCompositorWorkspaceDef.clear();
+    this->dataPtr->clearPassDef = nullptr;
+  }
+
+  if (this->dataPtr->ogreLabelTexture)
+  {
+    Ogre::TextureManager::getSingleton().remove(
+        this->dataPtr->ogreLabelTexture->getName());
+    this->dataPtr->ogreLabelTexture.reset();
+  }
+
+  this->dataPtr->materialSwitcher.reset();
+
+  Ogre::SceneManager *ogreSceneManager = this->scene->OgreSceneManager();
+  if (ogreSceneManager == nullptr)
+  {
+    ignerr << "Scene manager cannot be obtained" << std::endl;
+    return;
+  }
+
+  if (ogreSceneManager->findCameraNoThrow(this->name) != nullptr)
+    ogreSceneManager->destroyCamera(this->ogreCamera);
+  this->ogreCamera = nullptr;
+}
+
+//////////////////////////////////////////////////
+void Ogre2SegmentationCamera::CreateCamera()
+{
+  // create ogre camera object
+  Ogre::SceneManager *ogreSceneManager = this->scene->OgreSceneManager();
+  if (ogreSceneManager == nullptr)
+  {
+    ignerr << "Scene manager cannot be obtained" << std::endl;
+    return;
+  }
+
+  this->ogreCamera = ogreSceneManager->createCamera(this->name);
+  if (this->ogreCamera == nullptr)
+  {
+    ignerr << "Ogre camera cannot be created" << std::endl;
+    return;
+  }
+
+  // by default, ogre2 cameras are attached to root scene node
+  this->ogreCamera->detachFromParent();
+  this->ogreNode->attachObject(this->ogreCamera);
+
+  // rotate to Gazebo coordinate system
+  this->ogreCamera->yaw(Ogre::Degree(-90.0));
+  this->ogreCamera->roll(Ogre::Degree(-90.0));
+  this->ogreCamera->setFixedYawAxis(false);
+
+  this->ogreCamera->setAutoAspectRatio(true);
+  this->ogreCamera->setProjectionType(Ogre::PT_PERSPECTIVE);
+  this->ogreCamera->setCustomProjectionMatrix(false);
+}
+
+/////////////////////////////////////////////////
+void Ogre2SegmentationCamera::CreateRenderTexture()
+{
+  RenderTexturePtr base = this->scene->CreateRenderTexture();
+  this->dataPtr->renderTexture =
+      std::dynamic_pointer_cast<Ogre2RenderTexture>(base);
+  this->dataPtr->renderTexture->SetWidth(1);
+  this->dataPtr->renderTexture->SetHeight(1);
+}
+
+//////////////////////////////////////////////////
+void Ogre2SegmentationCamera::CreateSegmentationTexture()
+{
+  // set aspect ratio and fov
+  double vfov = 2.0 * atan(tan(this->HFOV().Radian() / 2.0) / this->aspect);
+  this->ogreCamera->setAspectRatio(this->aspect);
+  this->ogreCamera->setFOVy(Ogre::Radian(vfov));
+  this->ogreCamera->setNearClipDistance(this->NearClipPlane());
+  this->ogreCamera->setFarClipDistance(this->FarClipPlane());
+
+  this->dataPtr->labelBitDepth = this->labelBitDepth;
+  Ogre::PixelFormat ogrePF = this->labelBitDepth == 16u ?
+      Ogre::PF_L16 : Ogre::PF_R8G8B8A8;
+
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
+
+  // The compositor workspace definition is equivalent to the following
+  // ogre compositor script:
+  // compositor_node SegmentationCamera
+  // {
+  //   in 0 rt_input
+  //   target rt_input
+  //   {
+  //     pass clear
+  //     {
+  //       colour_value <background label>
+  //     }
+  //     pass render_scene
+  //     {
+  //     }
+  //   }
+  //   out 0 rt_input
+  // }
+  std::string wsDefName = "SegmentationCameraWorkspace_" + this->Name();
+  this->dataPtr->ogreCompositorWorkspaceDef = wsDefName;
+  if (!ogreCompMgr->hasWorkspaceDefinition(wsDefName))
+  {
+    std::string nodeDefName = wsDefName + "/Node";
+    this->dataPtr->ogreCompositorNodeDef = nodeDefName;
+    Ogre::CompositorNodeDef *nodeDef =
+        ogreCompMgr->addNodeDefinition(nodeDefName);
+    nodeDef->addTextureSourceName("rt_input", 0,
+        Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+
+    nodeDef->setNumTargetPass(1);
+    Ogre::CompositorTargetDef *inputTargetDef =
+        nodeDef->addTargetPass("rt_input");
+    inputTargetDef->setNumPasses(2);
+    {
+      // clear pass, its color is updated when the background label changes
+      this->dataPtr->clearPassDef =
+          static_cast<Ogre::CompositorPassClearDef *>(
+          inputTargetDef->addPass(Ogre::PASS_CLEAR));
+      this->dataPtr->clearPassDef->mColourValue =
+          labelColour(this->backgroundLabel, this->labelBitDepth);
+
+      // scene pass. The items are unlit, so neither shadows nor particles
+      // are rendered
+      Ogre::CompositorPassSceneDef *passScene =
+          static_cast<Ogre::CompositorPassSceneDef *>(
+          inputTargetDef->addPass(Ogre::PASS_SCENE));
+      passScene->mVisibilityMask = IGN_VISIBILITY_ALL &
+          ~Ogre2ParticleEmitter::kParticleVisibilityFlags;
+    }
+    nodeDef->mapOutputChannel(0, "rt_input");
+    Ogre::CompositorWorkspaceDef *workDef =
+        ogreCompMgr->addWorkspaceDefinition(wsDefName);
+    workDef->connectExternal(0, nodeDef->getName(), 0);
+  }
+
+  // the labels must not be filtered, gamma corrected or antialiased
+  this->dataPtr->ogreLabelTexture =
+    Ogre::TextureManager::getSingleton().createManual(
+    this->Name() + "_segmentation", "General", Ogre::TEX_TYPE_2D,
+    this->ImageWidth(), this->ImageHeight(), 1, 0,
+    ogrePF, Ogre::TU_RENDERTARGET,
+    0, false, 0, Ogre::BLANKSTRING, false, true);
+
+  Ogre::RenderTarget *rt =
+    this->dataPtr->ogreLabelTexture->getBuffer()->getRenderTarget();
+
+  this->dataPtr->materialSwitcher.reset(
+      new Ogre2SegmentationMaterialSwitcher(this->scene, this->Name()));
+  this->dataPtr->materialSwitcher->SetLabelBitDepth(this->labelBitDepth);
+  rt->addListener(this->dataPtr->materialSwitcher.get());
+
+  this->dataPtr->ogreCompositorWorkspace =
+      ogreCompMgr->addWorkspace(this->scene->OgreSceneManager(),
+      rt, this->ogreCamera, wsDefName, false);
+
+  if (!this->dataPtr->gpuTimerListener)
+  {
+    this->dataPtr->gpuTimerListener.reset(new Ogre2GpuTimerListener(
+        this->gpuTimerClient, "segmentation"));
+  }
+  this->dataPtr->ogreCompositorWorkspace->setListener(
+      this->dataPtr->gpuTimerListener.get());
+}
+
+//////////////////////////////////////////////////
+void Ogre2SegmentationCamera::Render()
+{
+  IGN_RENDERING_PROFILE("Ogre2SegmentationCamera::Render");
+  this->BeginFrameStats();
+
+  auto engine = Ogre2RenderEngine::Instance();
+  if (engine->RenderBatchActive())
+  {
+    engine->AddToRenderBatch(this->shared_from_this(),
+        this->dataPtr->ogreCompositorWorkspace);
+    return;
+  }
+
+  engine->RenderWorkspaces({this->dataPtr->ogreCompositorWorkspace});
+}
+
+//////////////////////////////////////////////////
+void Ogre2SegmentationCamera::PreRender()
+{
+  IGN_RENDERING_PROFILE("Ogre2SegmentationCamera::PreRender");
+  if (!this->dataPtr->ogreLabelTexture)
+    this->CreateSegmentationTexture();
+
+  if (this->labelBitDepth != this->dataPtr->labelBitDepth)
+  {
+    ignwarn << "The label bit depth of segmentation camera ["
+            << this->Name() << "] can not change once it has been rendered. "
+            << "Labels stay " << this->dataPtr->labelBitDepth << " bits"
+            << std::endl;
+    this->labelBitDepth = this->dataPtr->labelBitDepth;
+  }
+
+  // the definition is read by the clear pass on every render
+  if (this->dataPtr->clearPassDef)
+  {
+    this->dataPtr->clearPassDef->mColourValue =
+        labelColour(this->backgroundLabel, this->labelBitDepth);
+  }
+  this->dataPtr->materialSwitcher->SetSegmentationType(this->type);
+  this->dataPtr->materialSwitcher->SetBackgroundLabel(this->backgroundLabel);
+
+  this->ogreCamera->setLodBias(this->RenderLodBias());
+}
+
+//////////////////////////////////////////////////
+void Ogre2SegmentationCamera::PostRender()
+{
+  IGN_RENDERING_PROFILE("Ogre2SegmentationCamera::PostRender");
+  // data is read back once the render batch has been rendered
+  auto engine = Ogre2RenderEngine::Instance();
+  if (engine->RenderBatchActive())
+  {
+    engine->DeferPostRender(this->shared_from_this());
+    return;
+  }
+
+  if (this->dataPtr->newSegmentationFrame.ConnectionCount() <= 0u &&
+      this->dataPtr->newRawSegmentationFrame.ConnectionCount() <= 0u &&
+      this->newSensorFrame.ConnectionCount() <= 0u)
+  {
+    return;
+  }
+
+  unsigned int width = this->ImageWidth();
+  unsigned int height = this->ImageHeight();
+  size_t len = static_cast<size_t>(width) * height;
+  bool shortLabels = this->dataPtr->labelBitDepth == 16u;
+
+  // 32 bit labels are read as bytes in memory order, whatever the
+  // endianness of the texture format
+  Ogre::PixelFormat readFormat = shortLabels ?
+      Ogre::PF_L16 : Ogre::PF_BYTE_RGBA;
+  size_t size = Ogre::PixelUtil::getMemorySize(width, height, 1, readFormat);
+
+  if (!this->dataPtr->readBuffer)
+  {
+    this->dataPtr->readBuffer = new unsigned char[size];
+    MemoryTracker::Track(MC_SENSOR_BUFFER, this->dataPtr->readBuffer, size);
+  }
+  if (!this->dataPtr->labelImage)
+  {
+    this->dataPtr->labelImage = new uint32_t[len];
+    MemoryTracker::Track(MC_SENSOR_BUFFER, this->dataPtr->labelImage,
+        len * sizeof(uint32_t));
+  }
+
+  auto readback = Ogre2ReadbackManager::Instance();
+  if (this->dataPtr->readbackClient)
+  {
+    // queue a copy of the frame that has just been rendered and retrieve a
+    // previous one so the transfer overlaps with the next render
+    if (!readback->Request(this->dataPtr->readbackClient,
+        this->dataPtr->ogreLabelTexture.get(), readFormat))
+    {
+      ignwarn << "Asynchronous readback failed for segmentation camera ["
+              << this->Name() << "], falling back to blocking readback"
+              << std::endl;
+      this->SetAsyncReadback(false);
+    }
+    else if (!readback->Retrieve(this->dataPtr->readbackClient,
+        this->dataPtr->readBuffer, size))
+    {
+      // no frame available yet
+      return;
+    }
+  }
+
+  if (!this->dataPtr->readbackClient)
+  {
+    Ogre::PixelBox dstBox(width, height, 1, readFormat,
+        this->dataPtr->readBuffer);
+    readback->Read(
+        this->dataPtr->ogreLabelTexture->getBuffer()->getRenderTarget(),
+        dstBox);
+  }
+  this->AddReadbackBytes(size);
+
+  if (shortLabels)
+  {
+    // subscribers to raw frames get the readback data as is
+    this->DispatchFrame(this->dataPtr->newRawSegmentationFrame,
+        this->dataPtr->readBuffer, size, width, height, 1, "L16");
+
+    if (this->dataPtr->newSegmentationFrame.ConnectionCount() <= 0u)
+      return;
+
+    const uint16_t *labels =
+        reinterpret_cast<const uint16_t *>(this->dataPtr->readBuffer);
+    std::copy(labels, labels + len, this->dataPtr->labelImage);
+
+    // sensor frame subscribers already got the data as read back
+    this->DispatchFrame(this->dataPtr->newSegmentationFrame,
+        this->dataPtr->labelImage, len, width, height, 1, "L32", false);
+    return;
+  }
+
+  // decode the labels, most significant byte first
+  const unsigned char *bytes = this->dataPtr->readBuffer;
+  for (size_t i = 0; i < len; ++i, bytes += 4)
+  {
+    this->dataPtr->labelImage[i] = (static_cast<uint32_t>(bytes[0]) << 24) |
+        (static_cast<uint32_t>(bytes[1]) << 16) |
+        (static_cast<uint32_t>(bytes[2]) << 8) |
+        static_cast<uint32_t>(bytes[3]);
+  }
+
+  this->DispatchFrame(this->dataPtr->newSegmentationFrame,
+      this->dataPtr->labelImage, len, width, height, 1, "L32");
+  this->DispatchFrame(this->dataPtr->newRawSegmentationFrame,
+      reinterpret_cast<const unsigned char *>(this->dataPtr->labelImage),
+      len * sizeof(uint32_t), width, height, 1, "L32", false);
+}
+
+//////////////////////////////////////////////////
+void Ogre2SegmentationCamera::SetAsyncReadback(bool _enabled)
+{
+  auto readback = Ogre2ReadbackManager::Instance();
+  if (!_enabled)
+  {
+    readback->DestroyClient(this->dataPtr->readbackClient);
+    this->dataPtr->readbackClient = 0u;
+    return;
+  }
+
+  if (this->dataPtr->readbackClient)
+    return;
+
+  this->dataPtr->readbackClient = readback->CreateClient();
+  if (!this->dataPtr->readbackClient)
+  {
+    ignwarn << "Asynchronous readback is not supported by the current "
+            << "render system. Segmentation camera [" << this->Name()
+            << "] will use blocking readback" << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+bool Ogre2SegmentationCamera::AsyncReadback() const
+{
+  return this->dataPtr->readbackClient != 0u;
+}
+
+//////////////////////////////////////////////////
+common::ConnectionPtr Ogre2SegmentationCamera::ConnectNewSegmentationFrame(
+    std::function<void(const uint32_t *, unsigned int, unsigned int,
+      unsigned int, const std::string &)> _subscriber)
+{
+  return this->dataPtr->newSegmentationFrame.Connect(_subscriber);
+}
+
+//////////////////////////////////////////////////
+common::ConnectionPtr
+    Ogre2SegmentationCamera::ConnectNewRawSegmentationFrame(
+    std::function<void(const unsigned char *, unsigned int, unsigned int,
+      unsigned int, const std::string &)> _subscriber)
+{
+  return this->dataPtr->newRawSegmentationFrame.Connect(_subscriber);
+}
+
+//////////////////////////////////////////////////
+RenderTargetPtr Ogre2SegmentationCamera::RenderTarget() const
+{
+  return this->dataPtr->renderTexture;
+}
@@ -15,7 +15,11 @@
  *
 */
 
+#include <algorithm>
 #include <memory>
+#include <set>
+#include <string>
+#include <vector>
 #include <ignition/math/Color.hh>
 
 #include "ignition/common/Console.hh"
@@ -26,6 +30,8 @@
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
 #include "ignition/rendering/ogre2/Ogre2SelectionBuffer.hh"
 
+#include "Ogre2ReadbackManager.hh"
+
 #ifdef _MSC_VER
   #pragma warning(push, 0)
 #endif
@@ -47,8 +53,61 @@
 using namespace ignition;
 using namespace rendering;
 
+/// \brief Offscreen target the selection buffer can be rendered into
+struct Ogre2SelectionTarget
+{
+  /// \brief Ogre texture
+  Ogre::TexturePtr texture;
+
+  /// \brief Render target of the texture
+  Ogre::RenderTexture *renderTexture = nullptr;
+
+  /// \brief Compositor workspace rendering into renderTexture
+  Ogre::CompositorWorkspace *workspace = nullptr;
+
+  /// \brief Content of the last render, in PF_R8G8B8 format
+  std::vector<uint8_t> buffer;
+
+  /// \brief Width in pixels
+  unsigned int width = 0u;
+
+  /// \brief Height in pixels
+  unsigned int height = 0u;
+};
+
 class ignition::rendering::Ogre2SelectionBufferPrivate
 {
+  /// \brief Create an offscreen target, replacing any existing one
+  /// \param[in, out] _target Target to create
+  /// \param[in] _name Unique name of the target texture
+  /// \param[in] _width Width in pixels
+  /// \param[in] _height Height in pixels
+  public: void CreateTarget(Ogre2SelectionTarget &_target,
+      const std::string &_name, unsigned int _width, unsigned int _height);
+
+  /// \brief Destroy an offscreen target
+  /// \param[in, out] _target Target to destroy
+  public: void DeleteTarget(Ogre2SelectionTarget &_target);
+
+  /// \brief Render the selection buffer into an offscreen target and read
+  /// back its content
+  /// \param[in, out] _target Target to render
+  public: void RenderTarget(Ogre2SelectionTarget &_target);
+
+  /// \brief Get the unique color of a pixel of an offscreen target
+  /// \param[in] _target Target to read from
+  /// \param[in] _x X coordinate in pixels
+  /// \param[in] _y Y coordinate in pixels
+  /// \return Color as returned by math::Color::AsRGBA
+  public: static unsigned int ColorAt(const Ogre2SelectionTarget &_target,
+      unsigned int _x, unsigned int _y);
+
+  /// \brief Compute a hash of everything in the scene that affects the
+  /// content of the selection buffer: the set of items, their visibility
+  /// and their world transforms. Much cheaper than a selection render.
+  /// \return Hash of the scene
+  public: size_t SceneHash() const;
+
   /// \brief This is a material listener and a RenderTargetListener.
   /// The material switcher is applied to only the selection camera
   /// and not applied globally to all targets. The class associates a
@@ -84,8 +143,149 @@ class ignition::rendering::Ogre2SelectionBufferPrivate
 
   /// \brief Ogre pixel box that contains description of the data buffer
   public: Ogre::PixelBox *pixelBox = nullptr;
+
+  /// \brief Viewport sized target rendered by UpdateFrame
+  public: Ogre2SelectionTarget frame;
+
+  /// \brief True if a frame has been rendered
+  public: bool frameRendered = false;
+
+  /// \brief Camera position when the last frame was rendered
+  public: Ogre::Vector3 framePosition;
+
+  /// \brief Camera orientation when the last frame was rendered
+  public: Ogre::Quaternion frameOrientation;
+
+  /// \brief Camera projection matrix when the last frame was rendered
+  public: Ogre::Matrix4 frameProjection;
+
+  /// \brief Scene hash when the last frame was rendered
+  public: size_t frameSceneHash = 0u;
+
+  /// \brief Target rendered by OnSelectionRegion, sized to the last
+  /// requested region
+  public: Ogre2SelectionTarget region;
 };
 
+/////////////////////////////////////////////////
+void Ogre2SelectionBufferPrivate::CreateTarget(Ogre2SelectionTarget &_target,
+    const std::string &_name, unsigned int _width, unsigned int _height)
+{
+  this->DeleteTarget(_target);
+
+  _target.texture = Ogre::TextureManager::getSingleton().createManual(
+      _name, Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
+      Ogre::TEX_TYPE_2D, _width, _height, 0, Ogre::PF_R8G8B8,
+      Ogre::TU_RENDERTARGET);
+
+  _target.renderTexture = _target.texture->getBuffer()->getRenderTarget();
+  _target.renderTexture->addListener(this->materialSwitcher.get());
+
+  // the workspace definition is shared with the 1x1 selection buffer
+  auto engine = Ogre2RenderEngine::Instance();
+  Ogre::CompositorManager2 *ogreCompMgr =
+      engine->OgreRoot()->getCompositorManager2();
+  const Ogre::String workspaceName = "SelectionBufferWorkspace" +
+      this->camera->getName();
+  _target.workspace = ogreCompMgr->addWorkspace(this->sceneMgr,
+      _target.renderTexture, this->selectionCamera, workspaceName, false);
+
+  // set visibility mask to see only items that are selectable
+  auto nodeSeq = _target.workspace->getNodeSequence();
+  auto pass = nodeSeq[0]->_getPasses()[1]->getDefinition();
+  auto scenePass = dynamic_cast<const Ogre::CompositorPassSceneDef *>(pass);
+  const_cast<Ogre::CompositorPassSceneDef *>(scenePass)->mVisibilityMask =
+      IGN_VISIBILITY_SELECTABLE;
+
+  _target.buffer.assign(
+      Ogre::PixelUtil::getMemorySize(_width, _height, 1, Ogre::PF_R8G8B8), 0u);
+  _target.width = _width;
+  _target.height = _height;
+}
+
+/////////////////////////////////////////////////
+size_t Ogre2SelectionBufferPrivate::SceneHash() const
+{
+  size_t seed = 0u;
+  auto combine = [&seed](size_t _hash)
+  {
+    seed ^= _hash + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  };
+
+  auto itor = this->sceneMgr->getMovableObjectIterator(
+      Ogre::ItemFactory::FACTORY_TYPE_NAME);
+  while (itor.hasMoreElements())
+  {
+    Ogre::MovableObject *object = itor.getNext();
+    combine(std::hash<const void *>()(object));
+    if (!object->isAttached() || !object->getVisible())
+      continue;
+
+    combine(std::hash<uint32_t>()(object->getVisibilityFlags()));
+    const Ogre::Matrix4 &transform =
+        object->getParentNode()->_getFullTransform();
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      for (unsigned int j = 0; j < 4; ++j)
+        combine(std::hash<Ogre::Real>()(transform[i][j]));
+    }
+  }
+  return seed;
+}
+
+/////////////////////////////////////////////////
+void Ogre2SelectionBufferPrivate::DeleteTarget(Ogre2SelectionTarget &_target)
+{
+  if (_target.workspace)
+  {
+    auto engine = Ogre2RenderEngine::Instance();
+    Ogre::CompositorManager2 *ogreCompMgr =
+        engine->OgreRoot()->getCompositorManager2();
+    ogreCompMgr->removeWorkspace(_target.workspace);
+    _target.workspace = nullptr;
+  }
+
+  if (!_target.texture.isNull())
+  {
+    auto &manager = Ogre::TextureManager::getSingleton();
+    manager.unload(_target.texture->getName());
+    manager.remove(_target.texture->getName());
+    _target.texture.setNull();
+  }
+
+  _target.renderTexture = nullptr;
+  _target.buffer.clear();
+  _target.width = 0u;
+  _target.height = 0u;
+}
+
+/////////////////////////////////////////////////
+void Ogre2SelectionBufferPrivate::RenderTarget(Ogre2SelectionTarget &_target)
+{
+  Ogre2RenderEngine::Instance()->RenderWorkspaces({_target.workspace});
+
+  Ogre::PixelBox pixelBox(_target.width, _target.height, 1, Ogre::PF_R8G8B8,
+      _target.buffer.data());
+  Ogre2ReadbackManager::Instance()->Read(_target.renderTexture, pixelBox);
+}
+
+/////////////////////////////////////////////////
+unsigned int Ogre2SelectionBufferPrivate::ColorAt(
+    const Ogre2SelectionTarget &_target, unsigned int _x, unsigned int _y)
+{
+  // decode the pixel the same way as OnSelectionClick
+  const uint8_t *pixel = _target.buffer.data() +
+      (static_cast<size_t>(_y) * _target.width + _x) * 3u;
+  ignition::math::Color::BGRA color = static_cast<uint32_t>(pixel[0]) |
+      (static_cast<uint32_t>(pixel[1]) << 8) |
+      (static_cast<uint32_t>(pixel[2]) << 16);
+  ignition::math::Color cv;
+  cv.SetFromARGB(color);
+  cv.A(1.0);
+  return cv.AsRGBA();
+}
+
+
 /////////////////////////////////////////////////
 Ogre2SelectionBuffer::Ogre2SelectionBuffer(const std::string &_cameraName,
     Ogre2ScenePtr _scene): dataPtr(new Ogre2SelectionBufferPrivate)
@@ -113,6 +313,8 @@ Ogre2SelectionBuffer::Ogre2SelectionBuffer(const std::string &_cameraName,
 /////////////////////////////////////////////////
 Ogre2SelectionBuffer::~Ogre2SelectionBuffer()
 {
+  this->dataPtr->DeleteTarget(this->dataPtr->region);
+  this->dataPtr->DeleteTarget(this->dataPtr->frame);
   this->DeleteRTTBuffer();
 
   // remove selection buffer camera
@@ -125,16 +327,112 @@ void Ogre2SelectionBuffer::Update()
   if (!this->dataPtr->renderTexture)
     return;
 
-  this->dataPtr->materialSwitcher->Reset();
-
   // manual update
-  this->dataPtr->ogreCompositorWorkspace->setEnabled(true);
-  auto engine = Ogre2RenderEngine::Instance();
-  engine->OgreRoot()->renderOneFrame();
-  this->dataPtr->ogreCompositorWorkspace->setEnabled(false);
+  Ogre2RenderEngine::Instance()->RenderWorkspaces(
+      {this->dataPtr->ogreCompositorWorkspace});
 
-  this->dataPtr->renderTexture->copyContentsToMemory(*this->dataPtr->pixelBox,
-      Ogre::RenderTarget::FB_FRONT);
+  Ogre2ReadbackManager::Instance()->Read(this->dataPtr->renderTexture,
+      *this->dataPtr->pixelBox);
+}
+
+/////////////////////////////////////////////////
+void Ogre2SelectionBuffer::UpdateFrame()
+{
+  if (!this->dataPtr->camera || !this->dataPtr->selectionCamera)
+    return;
+
+  Ogre::Viewport *vp = this->dataPtr->camera->getLastViewport();
+  if (!vp || !vp->getTarget())
+    return;
+
+  const unsigned int width = vp->getTarget()->getWidth();
+  const unsigned int height = vp->getTarget()->getHeight();
+  if (width == 0u || height == 0u)
+    return;
+
+  Ogre2SelectionTarget &frame = this->dataPtr->frame;
+  if (!frame.renderTexture || width != frame.width || height != frame.height)
+  {
+    this->dataPtr->frameRendered = false;
+    this->dataPtr->CreateTarget(frame,
+        "SelectionFrameTex" + this->dataPtr->camera->getName(),
+        width, height);
+  }
+
+  // skip the render if neither the view nor the scene changed
+  size_t sceneHash = this->dataPtr->SceneHash();
+  if (this->FrameValid() && sceneHash == this->dataPtr->frameSceneHash)
+    return;
+  this->dataPtr->frameSceneHash = sceneHash;
+
+  // render from the camera's current view
+  this->dataPtr->framePosition = this->dataPtr->camera->getDerivedPosition();
+  this->dataPtr->frameOrientation =
+      this->dataPtr->camera->getDerivedOrientation();
+  this->dataPtr->frameProjection =
+      this->dataPtr->camera->getProjectionMatrix();
+  this->dataPtr->selectionCamera->setCustomProjectionMatrix(true,
+      this->dataPtr->frameProjection);
+  this->dataPtr->selectionCamera->setPosition(this->dataPtr->framePosition);
+  this->dataPtr->selectionCamera->setOrientation(
+      this->dataPtr->frameOrientation);
+
+  this->dataPtr->RenderTarget(frame);
+  this->dataPtr->frameRendered = true;
+}
+
+/////////////////////////////////////////////////
+bool Ogre2SelectionBuffer::FrameValid() const
+{
+  if (!this->dataPtr->frameRendered || !this->dataPtr->camera)
+    return false;
+
+  Ogre::Viewport *vp = this->dataPtr->camera->getLastViewport();
+  if (!vp || !vp->getTarget())
+    return false;
+
+  return vp->getTarget()->getWidth() == this->dataPtr->frame.width &&
+      vp->getTarget()->getHeight() == this->dataPtr->frame.height &&
+      this->dataPtr->camera->getDerivedPosition() ==
+      this->dataPtr->framePosition &&
+      this->dataPtr->camera->getDerivedOrientation() ==
+      this->dataPtr->frameOrientation &&
+      this->dataPtr->camera->getProjectionMatrix() ==
+      this->dataPtr->frameProjection;
+}
+
+/////////////////////////////////////////////////
+unsigned int Ogre2SelectionBuffer::FrameVisualIdAt(const int _x,
+    const int _y) const
+{
+  if (!this->dataPtr->frameRendered || _x < 0 || _y < 0 ||
+      _x >= static_cast<int>(this->dataPtr->frame.width) ||
+      _y >= static_cast<int>(this->dataPtr->frame.height))
+  {
+    return 0u;
+  }
+
+  // colors are never reused while the material switcher keeps its
+  // assignments, so pixels of items destroyed since the frame was rendered
+  // are not found
+  const auto &colorDict = this->dataPtr->materialSwitcher->colorDict;
+  auto it = colorDict.find(
+      Ogre2SelectionBufferPrivate::ColorAt(this->dataPtr->frame, _x, _y));
+  if (it == colorDict.end())
+    return 0u;
+  return it->second.visualId;
+}
+
+/////////////////////////////////////////////////
+unsigned int Ogre2SelectionBuffer::FrameWidth() const
+{
+  return this->dataPtr->frame.width;
+}
+
+/////////////////////////////////////////////////
+unsigned int Ogre2SelectionBuffer::FrameHeight() const
+{
+  return this->dataPtr->frame.height;
 }
 
 /////////////////////////////////////////////////
@@ -287,3 +585,94 @@ Ogre::Item *Ogre2SelectionBuffer::OnSelectionClick(const int _x, const int _y)
       return dynamic_cast<Ogre::Item *>(collection[0]);
   }
 }
+
+/////////////////////////////////////////////////
+std::vector<unsigned int> Ogre2SelectionBuffer::OnSelectionRegion(
+    const int _x, const int _y, const unsigned int _width,
+    const unsigned int _height)
+{
+  std::vector<unsigned int> ids;
+  if (!this->dataPtr->camera || !this->dataPtr->selectionCamera)
+    return ids;
+
+  Ogre::Viewport *vp = this->dataPtr->camera->getLastViewport();
+  if (!vp)
+    return ids;
+
+  Ogre::RenderTarget *rt = vp->getTarget();
+  if (!rt)
+    return ids;
+
+  // clip the region to the viewport
+  const int targetWidth = static_cast<int>(rt->getWidth());
+  const int targetHeight = static_cast<int>(rt->getHeight());
+  int x1 = std::max(_x, 0);
+  int y1 = std::max(_y, 0);
+  int x2 = std::min(_x + static_cast<int>(_width), targetWidth);
+  int y2 = std::min(_y + static_cast<int>(_height), targetHeight);
+  if (x1 >= x2 || y1 >= y2)
+    return ids;
+
+  const unsigned int width = static_cast<unsigned int>(x2 - x1);
+  const unsigned int height = static_cast<unsigned int>(y2 - y1);
+  Ogre2SelectionTarget &region = this->dataPtr->region;
+  if (!region.renderTexture || width != region.width ||
+      height != region.height)
+  {
+    this->dataPtr->CreateTarget(region,
+        "SelectionRegionTex" + this->dataPtr->camera->getName(),
+        width, height);
+  }
+
+  // crop the camera projection to the region, as in OnSelectionClick
+  float left = static_cast<float>(x1) / targetWidth - 0.5f;
+  float top = static_cast<float>(y1) / targetHeight - 0.5f;
+  float right = static_cast<float>(x2) / targetWidth - 0.5f;
+  float bottom = static_cast<float>(y2) / targetHeight - 0.5f;
+  Ogre::Matrix4 scaleMatrix = Ogre::Matrix4::IDENTITY;
+  Ogre::Matrix4 transMatrix = Ogre::Matrix4::IDENTITY;
+  scaleMatrix[0][0] = 1.0 / (right - left);
+  scaleMatrix[1][1] = 1.0 / (bottom - top);
+  transMatrix[0][3] -= left + right;
+  transMatrix[1][3] += top + bottom;
+  this->dataPtr->selectionCamera->setCustomProjectionMatrix(true,
+      scaleMatrix * transMatrix * this->dataPtr->camera->getProjectionMatrix());
+  this->dataPtr->selectionCamera->setPosition(
+      this->dataPtr->camera->getDerivedPosition());
+  this->dataPtr->selectionCamera->setOrientation(
+      this->dataPtr->camera->getDerivedOrientation());
+
+  this->dataPtr->RenderTarget(region);
+
+  // collect the unique colors. Neighboring pixels usually share a color so
+  // only look up color changes
+  std::set<unsigned int> colors;
+  unsigned int lastColor = 0u;
+  bool hasLast = false;
+  for (unsigned int j = 0; j < height; ++j)
+  {
+    for (unsigned int i = 0; i < width; ++i)
+    {
+      unsigned int color =
+          Ogre2SelectionBufferPrivate::ColorAt(region, i, j);
+      if (hasLast && color == lastColor)
+        continue;
+      colors.insert(color);
+      lastColor = color;
+      hasLast = true;
+    }
+  }
+
+  const auto &colorDict = this->dataPtr->materialSwitcher->colorDict;
+  std::set<unsigned int> unique;
+  for (auto color : colors)
+  {
+    auto it = colorDict.find(color);
+    if (it != colorDict.end() && it->second.visualId != 0u &&
+        unique.insert(it->second.visualId).second)
+    {
+      ids.push_back(it->second.visualId);
+    }
+  }
+  return ids;
+}
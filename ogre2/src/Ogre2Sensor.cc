@@ -16,15 +16,49 @@
  */
 #include "ignition/rendering/ogre2/Ogre2Sensor.hh"
 
+#include "Ogre2GpuTimer.hh"
+#include "Ogre2RenderStats.hh"
+
 using namespace ignition;
 using namespace rendering;
 
 //////////////////////////////////////////////////
 Ogre2Sensor::Ogre2Sensor()
 {
+  this->gpuTimerClient = Ogre2GpuTimer::Instance()->CreateClient();
 }
 
 //////////////////////////////////////////////////
 Ogre2Sensor::~Ogre2Sensor()
 {
+  Ogre2GpuTimer::Instance()->DestroyClient(this->gpuTimerClient);
+  Ogre2RenderStats::Instance()->DestroyClient(this->gpuTimerClient);
+}
+
+//////////////////////////////////////////////////
+std::map<std::string, double> Ogre2Sensor::GpuTimes() const
+{
+  return Ogre2GpuTimer::Instance()->Times(this->gpuTimerClient);
+}
+
+//////////////////////////////////////////////////
+rendering::FrameStats Ogre2Sensor::LastFrameStats() const
+{
+  rendering::FrameStats stats =
+      Ogre2RenderStats::Instance()->Stats(this->gpuTimerClient);
+  for (const auto &time : this->GpuTimes())
+    stats.gpuTime += time.second;
+  return stats;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Sensor::BeginFrameStats()
+{
+  Ogre2RenderStats::Instance()->BeginFrame(this->gpuTimerClient);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Sensor::AddReadbackBytes(uint64_t _bytes) const
+{
+  Ogre2RenderStats::Instance()->AddReadback(this->gpuTimerClient, _bytes);
 }
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "Ogre2SensorVisibilityListener.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+Ogre2SensorVisibilityListener::Ogre2SensorVisibilityListener(
+    const Sensor *_sensor)
+  : sensor(_sensor)
+{
+}
+
+//////////////////////////////////////////////////
+void Ogre2SensorVisibilityListener::passPreExecute(
+    Ogre::CompositorPass *_pass)
+{
+  if (_pass->getType() != Ogre::PASS_SCENE)
+  {
+    // the scene passes are done, the other sensors see the occluded items
+    if (this->culler)
+      this->culler->Restore();
+    return;
+  }
+
+  if (this->culler && this->scene->OcclusionCulling())
+  {
+    this->culler->Hide(this->scene->OgreSceneManager(),
+        this->scene->OcclusionCullingMargin());
+  }
+
+  Ogre::CompositorPassScene *scenePass =
+      static_cast<Ogre::CompositorPassScene *>(_pass);
+  Ogre::Viewport *vp = scenePass->getViewport();
+
+  // same as Ogre2RenderTarget, the reserved visibility flags are not
+  // altered
+  uint32_t mask = this->sensor->VisibilityMask() |
+      ~Ogre::VisibilityFlags::RESERVED_VISIBILITY_FLAGS;
+  vp->_setVisibilityMask(mask & vp->getVisibilityMask(),
+      vp->getLightVisibilityMask());
+}
+
+//////////////////////////////////////////////////
+void Ogre2SensorVisibilityListener::SetOcclusionCuller(
+    Ogre2OcclusionCuller *_culler, Ogre2Scene *_scene)
+{
+  if (this->culler)
+    this->culler->Restore();
+  this->culler = _culler;
+  this->scene = _scene;
+}
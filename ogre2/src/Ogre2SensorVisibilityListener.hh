@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2SENSORVISIBILITYLISTENER_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2SENSORVISIBILITYLISTENER_HH_
+
+#include "ignition/rendering/Sensor.hh"
+#include "ignition/rendering/ogre2/Ogre2Includes.hh"
+#include "ignition/rendering/ogre2/Ogre2Scene.hh"
+
+#include "Ogre2OcclusionCuller.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Workspace listener restricting the scene passes of a sensor
+    /// to the visuals matching its visibility mask. The mask of each scene
+    /// pass is combined with the mask of the sensor when the pass executes,
+    /// so passes that only draw particles or laser retro items keep doing
+    /// so, and visuals whose visibility flags are not in the mask of the
+    /// sensor are culled before they are drawn. The listener can also hide
+    /// the items found occluded by an occlusion culler during the scene
+    /// passes, and show them again at the first pass that is not a scene
+    /// pass.
+    class Ogre2SensorVisibilityListener :
+        public Ogre::CompositorWorkspaceListener
+    {
+      /// \brief Constructor
+      /// \param[in] _sensor Sensor whose visibility mask is applied. It
+      /// must outlive the workspaces the listener is set on.
+      public: explicit Ogre2SensorVisibilityListener(const Sensor *_sensor);
+
+      /// \brief Destructor
+      public: virtual ~Ogre2SensorVisibilityListener() = default;
+
+      // Documentation inherited.
+      public: virtual void passPreExecute(Ogre::CompositorPass *_pass)
+          override;
+
+      /// \brief Set the occlusion culler hiding items during the scene
+      /// passes
+      /// \param[in] _culler Occlusion culler, null to disable. It must
+      /// outlive the workspaces the listener is set on.
+      /// \param[in] _scene Scene of the culled items
+      public: void SetOcclusionCuller(Ogre2OcclusionCuller *_culler,
+          Ogre2Scene *_scene);
+
+      /// \brief Sensor whose visibility mask is applied
+      private: const Sensor *sensor = nullptr;
+
+      /// \brief Occlusion culler hiding items during the scene passes
+      private: Ogre2OcclusionCuller *culler = nullptr;
+
+      /// \brief Scene of the culled items
+      private: Ogre2Scene *scene = nullptr;
+    };
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,263 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <sstream>
+#include <string>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/RenderPassSystem.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+#include "ignition/rendering/ogre2/Ogre2ShaderPass.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <Compositor/OgreCompositorManager2.h>
+#include <Compositor/OgreCompositorNodeDef.h>
+#include <Compositor/Pass/PassQuad/OgreCompositorPassQuadDef.h>
+#include <OgreHighLevelGpuProgramManager.h>
+#include <OgreMaterial.h>
+#include <OgreMaterialManager.h>
+#include <OgrePass.h>
+#include <OgreRoot.h>
+#include <OgreTechnique.h>
+#include <OgreTextureUnitState.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+/// \brief Kernel used until one is set, it copies the input
+static const char kPassThroughKernel[] =
+    "vec4 kernel(vec2 uv)\n"
+    "{\n"
+    "  return texture(RT, uv);\n"
+    "}\n";
+
+/// \brief Private data for the Ogre2ShaderPass class
+class ignition::rendering::Ogre2ShaderPassPrivate
+{
+  /// \brief Material of the full screen quad drawing the kernel
+  public: Ogre::Material *material = nullptr;
+
+  /// \brief Name of the compositor node definition, used as a prefix of
+  /// the names of the programs
+  public: std::string name;
+
+  /// \brief Number of kernels compiled
+  public: unsigned int programCount = 0u;
+
+  /// \brief True if all the uniforms must be set, after a new kernel was
+  /// compiled
+  public: bool paramsDirty = true;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+Ogre2ShaderPass::Ogre2ShaderPass()
+  : dataPtr(std::make_unique<Ogre2ShaderPassPrivate>())
+{
+}
+
+//////////////////////////////////////////////////
+Ogre2ShaderPass::~Ogre2ShaderPass()
+{
+}
+
+//////////////////////////////////////////////////
+void Ogre2ShaderPass::PreRender()
+{
+  if (!this->dataPtr->material)
+    return;
+
+  if (!this->enabled)
+    return;
+
+  if (this->kernelDirty)
+    this->CompileKernel();
+
+  if (!this->dataPtr->paramsDirty && !this->kernelParams->IsDirty())
+    return;
+
+  Ogre::Pass *pass = this->dataPtr->material->getTechnique(0)->getPass(0);
+  Ogre::GpuProgramParametersSharedPtr psParams =
+      pass->getFragmentProgramParameters();
+  // uniforms not used by the kernel are optimized out by the compiler
+  psParams->setIgnoreMissingParams(true);
+  for (const auto &nameParam : *this->kernelParams)
+  {
+    if (ShaderParam::PARAM_FLOAT == nameParam.second.Type())
+    {
+      float value;
+      nameParam.second.Value(&value);
+      psParams->setNamedConstant(nameParam.first, value);
+    }
+    else if (ShaderParam::PARAM_INT == nameParam.second.Type())
+    {
+      int value;
+      nameParam.second.Value(&value);
+      psParams->setNamedConstant(nameParam.first, value);
+    }
+    else if (ShaderParam::PARAM_FLOAT_BUFFER == nameParam.second.Type())
+    {
+      std::shared_ptr<void> buffer;
+      nameParam.second.Buffer(buffer);
+      psParams->setNamedConstant(nameParam.first,
+          reinterpret_cast<float *>(buffer.get()), nameParam.second.Count(),
+          1u);
+    }
+    else if (ShaderParam::PARAM_INT_BUFFER == nameParam.second.Type())
+    {
+      std::shared_ptr<void> buffer;
+      nameParam.second.Buffer(buffer);
+      psParams->setNamedConstant(nameParam.first,
+          reinterpret_cast<int *>(buffer.get()), nameParam.second.Count(),
+          1u);
+    }
+  }
+  this->kernelParams->ClearDirty();
+  this->dataPtr->paramsDirty = false;
+}
+
+//////////////////////////////////////////////////
+void Ogre2ShaderPass::CreateRenderPass()
+{
+  static int shaderNodeCounter = 0;
+
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
+
+  if (!this->ogreCompositorNodeDefName.empty() &&
+      ogreCompMgr->hasNodeDefinition(this->ogreCompositorNodeDefName))
+    return;
+
+  std::string nodeDefName = "ShaderPassNode_" +
+      std::to_string(shaderNodeCounter++);
+  this->dataPtr->name = nodeDefName;
+
+  // full screen quad material, set up like the GaussianNoise material
+  // defined in script. The vertex program only forwards the uvs.
+  Ogre::MaterialPtr ogreMat = Ogre::MaterialManager::getSingleton().create(
+      nodeDefName, Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+  Ogre::Pass *pass = ogreMat->getTechnique(0)->getPass(0);
+  pass->setDepthCheckEnabled(false);
+  pass->setDepthWriteEnabled(false);
+  pass->setCullingMode(Ogre::CULL_NONE);
+  pass->setVertexProgram("GaussianNoiseVS");
+  Ogre::TextureUnitState *texUnit = pass->createTextureUnitState();
+  texUnit->setTextureAddressingMode(Ogre::TextureUnitState::TAM_CLAMP);
+  texUnit->setTextureFiltering(Ogre::TFO_TRILINEAR);
+  this->dataPtr->material = ogreMat.get();
+  this->CompileKernel();
+  ogreMat->load();
+
+  // We need to programmatically create the compositor because we need to
+  // configure it to use the material created above. The node is the same
+  // as the one of Ogre2GaussianNoisePass: the result is drawn to rt_output
+  // and the render textures are swapped for the next pass.
+  this->ogreCompositorNodeDefName = nodeDefName;
+
+  Ogre::CompositorNodeDef *nodeDef =
+      ogreCompMgr->addNodeDefinition(nodeDefName);
+
+  // Input texture
+  nodeDef->addTextureSourceName("rt_input", 0,
+      Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+  nodeDef->addTextureSourceName("rt_output", 1,
+      Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+
+  // rt_input target
+  nodeDef->setNumTargetPass(1);
+  Ogre::CompositorTargetDef *inputTargetDef =
+      nodeDef->addTargetPass("rt_output");
+  inputTargetDef->setNumPasses(1);
+  {
+    // quad pass
+    Ogre::CompositorPassQuadDef *passQuad =
+        static_cast<Ogre::CompositorPassQuadDef *>(
+        inputTargetDef->addPass(Ogre::PASS_QUAD));
+    passQuad->mMaterialName = nodeDefName;
+    passQuad->addQuadTextureSource(0, "rt_input", 0);
+  }
+  nodeDef->mapOutputChannel(0, "rt_output");
+  nodeDef->mapOutputChannel(1, "rt_input");
+
+  // set the uniforms before the first frame is drawn
+  this->PreRender();
+}
+
+//////////////////////////////////////////////////
+void Ogre2ShaderPass::CompileKernel()
+{
+  this->kernelDirty = false;
+  if (!this->dataPtr->material)
+    return;
+
+  auto compile = [this](const std::string &_kernel)
+  {
+    std::stringstream source;
+    source << "#version 330\n"
+           << "uniform sampler2D RT;\n"
+           << "in block\n"
+           << "{\n"
+           << "  vec2 uv0;\n"
+           << "} inPs;\n"
+           << "out vec4 fragColor;\n"
+           << _kernel << "\n"
+           << "void main()\n"
+           << "{\n"
+           << "  fragColor = kernel(inPs.uv0.xy);\n"
+           << "}\n";
+
+    // every kernel gets a new program. The previous ones are kept as the
+    // render system may still reference them in its linked programs.
+    Ogre::HighLevelGpuProgramPtr program =
+        Ogre::HighLevelGpuProgramManager::getSingleton().createProgram(
+        this->dataPtr->name + "_FS" +
+        std::to_string(this->dataPtr->programCount++),
+        Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
+        "glsl", Ogre::GPT_FRAGMENT_PROGRAM);
+    program->setSource(source.str());
+    program->load();
+    if (program->hasCompileError() || !program->isSupported())
+      return Ogre::HighLevelGpuProgramPtr();
+    return program;
+  };
+
+  std::string kernel = this->kernel.empty() ? kPassThroughKernel :
+      this->kernel;
+  Ogre::HighLevelGpuProgramPtr program = compile(kernel);
+  if (!program)
+  {
+    ignerr << "Unable to compile the kernel of shader pass ["
+           << this->dataPtr->name << "], copying its input instead"
+           << std::endl;
+    program = compile(kPassThroughKernel);
+    if (!program)
+      return;
+  }
+
+  Ogre::Pass *pass = this->dataPtr->material->getTechnique(0)->getPass(0);
+  pass->setFragmentProgram(program->getName());
+  pass->getFragmentProgramParameters()->setNamedConstant("RT", 0);
+  this->dataPtr->paramsDirty = true;
+}
+
+IGN_RENDERING_REGISTER_RENDER_PASS(Ogre2ShaderPass, ShaderPass)
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <functional>
+#include <sstream>
+#include <string>
+
+#include "Ogre2SharedDefinitions.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+std::string Ogre2SharedDefinitions::Acquire(const std::string &_prefix,
+    const std::string &_config, bool &_created)
+{
+  std::ostringstream base;
+  base << _prefix << "_Shared_" << std::hex
+       << std::hash<std::string>()(_config);
+
+  // configurations with colliding hashes get a suffix
+  for (unsigned int i = 0u; ; ++i)
+  {
+    std::string name = base.str();
+    if (i > 0u)
+      name += "_" + std::to_string(i);
+
+    auto it = this->entries.find(name);
+    if (it == this->entries.end())
+    {
+      Entry &entry = this->entries[name];
+      entry.config = _config;
+      entry.count = 1u;
+      _created = true;
+      return name;
+    }
+    if (it->second.config == _config)
+    {
+      ++it->second.count;
+      _created = false;
+      return name;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+bool Ogre2SharedDefinitions::Release(const std::string &_name)
+{
+  auto it = this->entries.find(_name);
+  if (it == this->entries.end())
+    return false;
+
+  if (--it->second.count > 0u)
+    return false;
+  this->entries.erase(it);
+  return true;
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2SharedDefinitions::Count(const std::string &_name) const
+{
+  auto it = this->entries.find(_name);
+  return it == this->entries.end() ? 0u : it->second.count;
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2SHAREDDEFINITIONS_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2SHAREDDEFINITIONS_HH_
+
+#include <map>
+#include <string>
+
+#include <ignition/common/SingletonT.hh>
+
+#include "ignition/rendering/config.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Reference counted names of the compositor definitions and
+    /// material clones that sensors with the same configuration can share.
+    /// A sensor describes everything its definitions and materials depend
+    /// on in a configuration string, and gets the same name as all other
+    /// sensors with that configuration. Only the first sensor creates the
+    /// definitions and materials, and only the last one removes them.
+    /// Textures and workspace instances stay per sensor.
+    class Ogre2SharedDefinitions :
+      public common::SingletonT<Ogre2SharedDefinitions>
+    {
+      /// \brief Constructor
+      private: Ogre2SharedDefinitions() = default;
+
+      /// \brief Get a reference to the shared definitions of a
+      /// configuration
+      /// \param[in] _prefix Prefix of the name, e.g. "DepthCamera"
+      /// \param[in] _config Configuration the definitions are built from
+      /// \param[out] _created True if this is the first reference, in
+      /// which case the caller must create the definitions
+      /// \return Name to create or look up the definitions with
+      public: std::string Acquire(const std::string &_prefix,
+          const std::string &_config, bool &_created);
+
+      /// \brief Release a reference obtained with Acquire
+      /// \param[in] _name Name returned by Acquire
+      /// \return True if this was the last reference, in which case the
+      /// caller must remove the definitions
+      public: bool Release(const std::string &_name);
+
+      /// \brief Get the number of references to shared definitions
+      /// \param[in] _name Name returned by Acquire
+      /// \return Number of references, 0 if the name is unknown
+      public: unsigned int Count(const std::string &_name) const;
+
+      /// \brief Shared definitions of a configuration
+      private: struct Entry
+      {
+        /// \brief Configuration the definitions are built from
+        std::string config;
+
+        /// \brief Number of references
+        unsigned int count = 0u;
+      };
+
+      /// \brief Shared definitions, by name
+      private: std::map<std::string, Entry> entries;
+
+      /// \brief Make the singleton class a friend
+      private: friend class common::SingletonT<Ogre2SharedDefinitions>;
+    };
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,317 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/math/Helpers.hh>
+
+#include "ignition/rendering/ogre2/Ogre2Material.hh"
+#include "ignition/rendering/ogre2/Ogre2ParticleEmitter.hh"
+#include "ignition/rendering/ogre2/Ogre2Scene.hh"
+#include "ignition/rendering/ogre2/Ogre2Text.hh"
+
+#include "Ogre2TextBatch.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreItem.h>
+#include <OgreMesh2.h>
+#include <OgreMeshManager2.h>
+#include <OgreSceneManager.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+/// \brief Name of the empty mesh shared by the anchors of all texts
+static const char kTextAnchorMeshName[] = "ign_text_anchor";
+
+/// \brief Private data for the Ogre2Text class
+class ignition::rendering::Ogre2TextPrivate
+{
+  /// \brief Text materal
+  public: Ogre2MaterialPtr material;
+
+  /// \brief Empty ogre item attached to the parent visual. It gives the
+  /// position and visibility of the text to its batch.
+  public: Ogre::Item *anchor = nullptr;
+
+  /// \brief Batch drawing the glyphs of the text
+  public: std::shared_ptr<Ogre2TextBatch> batch;
+
+  /// \brief Id of the text in its batch
+  public: unsigned int labelId = 0u;
+
+  /// \brief Font of the batch
+  public: std::string batchFont;
+
+  /// \brief On top setting of the batch
+  public: bool batchOnTop = false;
+
+  /// \brief Bounding box of the text in its own frame
+  public: math::AxisAlignedBox aabb{math::Vector3d::Zero,
+      math::Vector3d::Zero};
+};
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+Ogre2Text::Ogre2Text()
+    : dataPtr(new Ogre2TextPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+Ogre2Text::~Ogre2Text()
+{
+  // the batch may outlive the text, do not leave it a dangling anchor
+  if (this->dataPtr->batch)
+    this->dataPtr->batch->RemoveLabel(this->dataPtr->labelId);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Text::Init()
+{
+  Ogre::MeshPtr mesh = Ogre::MeshManager::getSingleton().getByName(
+      kTextAnchorMeshName);
+  if (mesh.isNull())
+  {
+    mesh = Ogre::MeshManager::getSingleton().createManual(
+        kTextAnchorMeshName,
+        Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    mesh->_setBounds(Ogre::Aabb::BOX_ZERO, false);
+  }
+
+  Ogre::SceneManager *sceneManager = this->scene->OgreSceneManager();
+  this->dataPtr->anchor = sceneManager->createItem(mesh, Ogre::SCENE_DYNAMIC);
+  this->dataPtr->anchor->setCastShadows(false);
+  this->dataPtr->anchor->setVisibilityFlags(IGN_VISIBILITY_ALL
+      & ~Ogre2ParticleEmitter::kParticleVisibilityFlags);
+
+  this->textDirty = true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Text::PreRender()
+{
+  BaseText::PreRender();
+
+  if (this->textDirty)
+  {
+    this->UpdateGlyphs();
+    this->textDirty = false;
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2Text::Destroy()
+{
+  if (!this->dataPtr->anchor)
+    return;
+
+  // Remove this object from parent
+  BaseText::Destroy();
+
+  if (this->dataPtr->batch)
+  {
+    this->dataPtr->batch->RemoveLabel(this->dataPtr->labelId);
+    this->dataPtr->batch.reset();
+  }
+
+  this->scene->OgreSceneManager()->destroyItem(this->dataPtr->anchor);
+  this->dataPtr->anchor = nullptr;
+}
+
+//////////////////////////////////////////////////
+Ogre::MovableObject *Ogre2Text::OgreObject() const
+{
+  return this->dataPtr->anchor;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Text::SetMaterial(MaterialPtr _material, bool _unique)
+{
+  _material = (_unique) ? _material->Clone() : _material;
+
+  Ogre2MaterialPtr derived =
+      std::dynamic_pointer_cast<Ogre2Material>(_material);
+
+  if (!derived)
+  {
+    ignerr << "Cannot assign material created by another render-engine"
+        << std::endl;
+
+    return;
+  }
+
+  this->SetMaterialImpl(derived);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Text::SetMaterialImpl(Ogre2MaterialPtr _material)
+{
+  // only colors are support for now
+  this->SetColor(_material->Diffuse());
+  this->dataPtr->material = _material;
+}
+
+//////////////////////////////////////////////////
+MaterialPtr Ogre2Text::Material() const
+{
+  return this->dataPtr->material;
+}
+
+//////////////////////////////////////////////////
+ignition::math::AxisAlignedBox Ogre2Text::AABB() const
+{
+  return this->dataPtr->aabb;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Text::UpdateGlyphs()
+{
+  if (!this->dataPtr->anchor)
+    return;
+
+  // move to the batch of the font if the font or the on top setting changed
+  if (!this->dataPtr->batch || this->dataPtr->batchFont != this->fontName ||
+      this->dataPtr->batchOnTop != this->onTop)
+  {
+    if (this->dataPtr->batch)
+      this->dataPtr->batch->RemoveLabel(this->dataPtr->labelId);
+
+    this->dataPtr->batch = Ogre2TextBatch::Instance(
+        this->scene->OgreSceneManager(), this->fontName, this->onTop);
+    this->dataPtr->batchFont = this->fontName;
+    this->dataPtr->batchOnTop = this->onTop;
+    if (!this->dataPtr->batch)
+      return;
+
+    this->dataPtr->labelId =
+        this->dataPtr->batch->AddLabel(this->dataPtr->anchor);
+  }
+
+  // lay out the glyphs the way OgreText does: in units of half a character
+  // height, left to right and top to bottom, with non left alignments
+  // centered
+  Ogre::FontPtr font = this->dataPtr->batch->Font();
+  float lineHeight = this->charHeight * 2.0f;
+  float spaceWidth = this->spaceWidth;
+  if (math::equal(spaceWidth, 0.0f))
+    spaceWidth = font->getGlyphAspectRatio('A') * lineHeight;
+
+  float top = 0.0f;
+  if (this->verticalAlign == TextVerticalAlign::TOP)
+  {
+    // Raise the first line of the caption
+    top += this->charHeight;
+    for (char c : this->text)
+    {
+      if (c == '\n')
+        top += lineHeight;
+    }
+  }
+
+  std::vector<Ogre2TextBatch::Vertex> vertices;
+  vertices.reserve(this->text.size() * 6u);
+  math::Vector3d min = math::Vector3d::Zero;
+  math::Vector3d max = math::Vector3d::Zero;
+  bool first = true;
+
+  float left = 0.0f;
+  float offset = 0.0f;
+  bool newLine = true;
+  for (size_t i = 0u; i < this->text.size(); ++i)
+  {
+    if (newLine)
+    {
+      float len = 0.0f;
+      for (size_t j = i; j < this->text.size() && this->text[j] != '\n'; ++j)
+      {
+        Ogre::Font::CodePoint character =
+            static_cast<unsigned char>(this->text[j]);
+        if (character == ' ')
+          len += spaceWidth;
+        else
+          len += font->getGlyphAspectRatio(character) * lineHeight;
+      }
+      offset = (this->horizontalAlign == TextHorizontalAlign::LEFT) ?
+          0.0f : -len / 2.0f;
+      newLine = false;
+    }
+
+    Ogre::Font::CodePoint character =
+        static_cast<unsigned char>(this->text[i]);
+    if (character == '\n')
+    {
+      left = 0.0f;
+      top -= lineHeight;
+      newLine = true;
+      continue;
+    }
+    else if (character == ' ')
+    {
+      left += spaceWidth;
+      continue;
+    }
+
+    float width = font->getGlyphAspectRatio(character) * lineHeight;
+    const Ogre::Font::UVRect &uvRect = font->getGlyphTexCoords(character);
+
+    float x0 = left + offset;
+    float x1 = x0 + width;
+    float y0 = top;
+    float y1 = top - lineHeight;
+    left += width;
+
+    // the quads are drawn at half the size of the layout, in world units
+    Ogre2TextBatch::Vertex topLeft{x0 * 0.5f, y0 * 0.5f,
+        uvRect.left, uvRect.top};
+    Ogre2TextBatch::Vertex bottomLeft{x0 * 0.5f, y1 * 0.5f,
+        uvRect.left, uvRect.bottom};
+    Ogre2TextBatch::Vertex topRight{x1 * 0.5f, y0 * 0.5f,
+        uvRect.right, uvRect.top};
+    Ogre2TextBatch::Vertex bottomRight{x1 * 0.5f, y1 * 0.5f,
+        uvRect.right, uvRect.bottom};
+    vertices.push_back(topLeft);
+    vertices.push_back(bottomLeft);
+    vertices.push_back(topRight);
+    vertices.push_back(topRight);
+    vertices.push_back(bottomLeft);
+    vertices.push_back(bottomRight);
+
+    if (first)
+    {
+      min.Set(x0, y1, 0.0);
+      max.Set(x1, y0, 0.0);
+      first = false;
+    }
+    else
+    {
+      min.Min(math::Vector3d(x0, y1, 0.0));
+      max.Max(math::Vector3d(x1, y0, 0.0));
+    }
+  }
+  this->dataPtr->aabb = math::AxisAlignedBox(min, max);
+
+  this->dataPtr->batch->SetLabel(this->dataPtr->labelId, std::move(vertices),
+      this->color, this->baseline);
+}
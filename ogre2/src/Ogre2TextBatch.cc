@@ -0,0 +1,373 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/RenderTypes.hh"
+#include "ignition/rendering/ogre2/Ogre2ParticleEmitter.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+
+#include "Ogre2TextBatch.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreCamera.h>
+#include <OgreHlms.h>
+#include <OgreHlmsDatablock.h>
+#include <OgreItem.h>
+#include <OgreMesh2.h>
+#include <OgreMeshManager2.h>
+#include <OgreRoot.h>
+#include <OgreSceneManager.h>
+#include <OgreSceneNode.h>
+#include <OgreSubMesh2.h>
+#include <Overlay/OgreFontManager.h>
+#include <Vao/OgreVaoManager.h>
+#include <Vao/OgreVertexArrayObject.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+/// \brief Number of floats per vertex: position, color and texture
+/// coordinates
+static const unsigned int kTextVertexSize = 9u;
+
+using namespace ignition;
+using namespace rendering;
+
+std::map<Ogre2TextBatch::Key, std::weak_ptr<Ogre2TextBatch>>
+    Ogre2TextBatch::batches;
+
+//////////////////////////////////////////////////
+Ogre2TextBatch::Ogre2TextBatch(Ogre::SceneManager *_sceneManager,
+    Ogre::FontPtr _font, bool _onTop)
+  : sceneManager(_sceneManager), font(_font)
+{
+  static unsigned int textBatchId = 0u;
+  std::string name = "text_batch_" + std::to_string(textBatchId++);
+
+  // the font datablock samples the glyph atlas and blends the glyphs, copy
+  // it so that the depth settings can differ between batches
+  Ogre::HlmsDatablock *fontDatablock = this->font->getHlmsDatablock();
+  if (fontDatablock)
+  {
+    this->datablock = fontDatablock->clone(name);
+    Ogre::HlmsMacroblock macroblock(*this->datablock->getMacroblock());
+    macroblock.mDepthWrite = false;
+    macroblock.mDepthCheck = !_onTop;
+    macroblock.mCullMode = Ogre::CULL_NONE;
+    this->datablock->setMacroblock(macroblock);
+  }
+
+  this->mesh = Ogre::MeshManager::getSingleton().createManual(name,
+      Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+  this->mesh->createSubMesh();
+}
+
+//////////////////////////////////////////////////
+Ogre2TextBatch::~Ogre2TextBatch()
+{
+  this->DestroyBuffer();
+
+  if (!this->mesh.isNull())
+  {
+    Ogre::MeshManager::getSingleton().remove(this->mesh->getHandle());
+    this->mesh.setNull();
+  }
+
+  if (this->datablock)
+  {
+    this->datablock->getCreator()->destroyDatablock(
+        this->datablock->getName());
+    this->datablock = nullptr;
+  }
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<Ogre2TextBatch> Ogre2TextBatch::Instance(
+    Ogre::SceneManager *_sceneManager, const std::string &_font, bool _onTop)
+{
+  Key key(_sceneManager, _font, _onTop);
+  auto it = batches.find(key);
+  if (it != batches.end())
+  {
+    std::shared_ptr<Ogre2TextBatch> batch = it->second.lock();
+    if (batch)
+      return batch;
+    batches.erase(it);
+  }
+
+  Ogre::FontPtr font = Ogre::FontManager::getSingleton().getByName(_font,
+      Ogre::ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME);
+  if (font.isNull())
+  {
+    ignerr << "Font [" << _font << "] not found" << std::endl;
+    return std::shared_ptr<Ogre2TextBatch>();
+  }
+  font->load();
+
+  std::shared_ptr<Ogre2TextBatch> batch(
+      new Ogre2TextBatch(_sceneManager, font, _onTop));
+  batches[key] = batch;
+  return batch;
+}
+
+//////////////////////////////////////////////////
+void Ogre2TextBatch::UpdateAll(Ogre::SceneManager *_sceneManager,
+    const Ogre::Camera *_camera)
+{
+  if (!_camera || batches.empty())
+    return;
+
+  auto engine = Ogre2RenderEngine::Instance();
+  unsigned long frame = engine->OgreRoot()->getNextFrameNumber();
+  Ogre::Quaternion orientation = _camera->getDerivedOrientation();
+  Ogre::Vector3 right = orientation * Ogre::Vector3::UNIT_X;
+  Ogre::Vector3 up = orientation * Ogre::Vector3::UNIT_Y;
+
+  for (auto &it : batches)
+  {
+    if (std::get<0>(it.first) != _sceneManager)
+      continue;
+
+    std::shared_ptr<Ogre2TextBatch> batch = it.second.lock();
+    if (!batch || batch->updateFrame == frame)
+      continue;
+
+    // the vertex buffer is persistently mapped and can only be written once
+    // per frame
+    batch->updateFrame = frame;
+    batch->Update(right, up);
+  }
+}
+
+//////////////////////////////////////////////////
+Ogre::FontPtr Ogre2TextBatch::Font() const
+{
+  return this->font;
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2TextBatch::AddLabel(const Ogre::MovableObject *_anchor)
+{
+  unsigned int id = this->nextId++;
+  this->labels[id].anchor = _anchor;
+  this->dirty = true;
+  return id;
+}
+
+//////////////////////////////////////////////////
+void Ogre2TextBatch::RemoveLabel(unsigned int _id)
+{
+  if (this->labels.erase(_id) > 0u)
+    this->dirty = true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2TextBatch::SetLabel(unsigned int _id,
+    std::vector<Vertex> &&_vertices, const math::Color &_color,
+    float _baseline)
+{
+  auto it = this->labels.find(_id);
+  if (it == this->labels.end())
+    return;
+
+  it->second.vertices = std::move(_vertices);
+  it->second.color = _color;
+  it->second.baseline = _baseline;
+  this->dirty = true;
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2TextBatch::LabelCount() const
+{
+  return static_cast<unsigned int>(this->labels.size());
+}
+
+//////////////////////////////////////////////////
+void Ogre2TextBatch::Update(const Ogre::Vector3 &_right,
+    const Ogre::Vector3 &_up)
+{
+  // the quads only need to be rebuilt if a label changed, moved, was shown
+  // or hidden, or if the camera turned
+  bool changed = this->dirty || _right != this->right || _up != this->up;
+  unsigned int vertexCount = 0u;
+  for (auto &it : this->labels)
+  {
+    Label &label = it.second;
+    bool visible = label.anchor && label.anchor->isVisible() &&
+        label.anchor->getParentNode();
+    Ogre::Vector3 position = visible ?
+        label.anchor->getParentNode()->_getDerivedPositionUpdated() +
+        Ogre::Vector3::UNIT_Z * label.baseline : label.position;
+    if (visible != label.visible || position != label.position)
+    {
+      label.visible = visible;
+      label.position = position;
+      changed = true;
+    }
+    if (visible)
+      vertexCount += static_cast<unsigned int>(label.vertices.size());
+  }
+
+  if (!changed)
+    return;
+
+  this->dirty = false;
+  this->right = _right;
+  this->up = _up;
+
+  if (vertexCount == 0u)
+  {
+    if (this->item)
+      this->item->setVisible(false);
+    return;
+  }
+
+  if (vertexCount > this->capacity)
+  {
+    unsigned int newCapacity = std::max(this->capacity, 64u);
+    while (newCapacity < vertexCount)
+      newCapacity <<= 1;
+    this->CreateBuffer(newCapacity);
+  }
+  if (!this->vertexBuffer)
+    return;
+
+  // billboard the quads of every visible label in cpu memory, then copy the
+  // result to the buffer in one go
+  Ogre::Aabb bbox;
+  float *dst = this->staging.data();
+  for (auto &it : this->labels)
+  {
+    Label &label = it.second;
+    if (!label.visible)
+      continue;
+
+    for (const auto &v : label.vertices)
+    {
+      Ogre::Vector3 p = label.position + _right * v.x + _up * v.y;
+      bbox.merge(p);
+      *dst++ = p.x;
+      *dst++ = p.y;
+      *dst++ = p.z;
+      *dst++ = label.color.R();
+      *dst++ = label.color.G();
+      *dst++ = label.color.B();
+      *dst++ = label.color.A();
+      *dst++ = v.u;
+      *dst++ = v.v;
+    }
+  }
+
+  float * RESTRICT_ALIAS vertices = reinterpret_cast<float * RESTRICT_ALIAS>(
+      this->vertexBuffer->map(0, vertexCount));
+  memcpy(vertices, this->staging.data(),
+      static_cast<size_t>(vertexCount) * kTextVertexSize * sizeof(float));
+  this->vertexBuffer->unmap(Ogre::UO_KEEP_PERSISTENT);
+
+  this->vao->setPrimitiveRange(0, vertexCount);
+
+  // the item is attached to the root node, so its local bounds are the world
+  // bounds of the labels
+  this->mesh->_setBounds(bbox, false);
+  this->item->setLocalAabb(bbox);
+  this->item->setVisible(true);
+}
+
+//////////////////////////////////////////////////
+void Ogre2TextBatch::CreateBuffer(unsigned int _capacity)
+{
+  this->DestroyBuffer();
+
+  Ogre::VaoManager *vaoManager =
+      this->sceneManager->getDestinationRenderSystem()->getVaoManager();
+  if (!vaoManager)
+    return;
+
+  Ogre::VertexElement2Vec vertexElements;
+  vertexElements.push_back(
+      Ogre::VertexElement2(Ogre::VET_FLOAT3, Ogre::VES_POSITION));
+  vertexElements.push_back(
+      Ogre::VertexElement2(Ogre::VET_FLOAT4, Ogre::VES_DIFFUSE));
+  vertexElements.push_back(
+      Ogre::VertexElement2(Ogre::VET_FLOAT2, Ogre::VES_TEXTURE_COORDINATES));
+
+  this->staging.assign(static_cast<size_t>(_capacity) * kTextVertexSize, 0.0f);
+  this->vertexBuffer = vaoManager->createVertexBuffer(vertexElements,
+      _capacity, Ogre::BT_DYNAMIC_PERSISTENT, this->staging.data(), false);
+  this->capacity = _capacity;
+
+  Ogre::VertexBufferPackedVec vertexBuffers;
+  vertexBuffers.push_back(this->vertexBuffer);
+  this->vao = vaoManager->createVertexArrayObject(vertexBuffers, nullptr,
+      Ogre::OT_TRIANGLE_LIST);
+
+  Ogre::SubMesh *subMesh = this->mesh->getSubMesh(0);
+  subMesh->mVao[Ogre::VpNormal].push_back(this->vao);
+  subMesh->mVao[Ogre::VpShadow].push_back(this->vao);
+
+  this->item = this->sceneManager->createItem(this->mesh,
+      Ogre::SCENE_DYNAMIC);
+  this->item->setCastShadows(false);
+  this->item->setVisibilityFlags(IGN_VISIBILITY_ALL
+      & ~Ogre2ParticleEmitter::kParticleVisibilityFlags);
+  if (this->datablock)
+    this->item->setDatablock(this->datablock);
+  this->sceneManager->getRootSceneNode(Ogre::SCENE_DYNAMIC)->attachObject(
+      this->item);
+}
+
+//////////////////////////////////////////////////
+void Ogre2TextBatch::DestroyBuffer()
+{
+  if (this->item)
+  {
+    this->sceneManager->destroyItem(this->item);
+    this->item = nullptr;
+  }
+
+  Ogre::VaoManager *vaoManager =
+      this->sceneManager->getDestinationRenderSystem()->getVaoManager();
+  if (vaoManager)
+  {
+    if (this->vao)
+      vaoManager->destroyVertexArrayObject(this->vao);
+    if (this->vertexBuffer)
+      vaoManager->destroyVertexBuffer(this->vertexBuffer);
+  }
+  this->vao = nullptr;
+  this->vertexBuffer = nullptr;
+  this->capacity = 0u;
+  this->staging.clear();
+
+  if (!this->mesh.isNull() && this->mesh->getNumSubMeshes() > 0u)
+  {
+    // the vertex array object is destroyed above, do not let the submesh
+    // destroy it again
+    Ogre::SubMesh *subMesh = this->mesh->getSubMesh(0);
+    subMesh->mVao[Ogre::VpNormal].clear();
+    subMesh->mVao[Ogre::VpShadow].clear();
+  }
+}
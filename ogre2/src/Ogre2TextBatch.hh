@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2TEXTBATCH_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2TEXTBATCH_HH_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <ignition/math/Color.hh>
+
+#include "ignition/rendering/ogre2/Ogre2Includes.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <Overlay/OgreFont.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Draws the text labels of a scene that share a font and the
+    /// same on top setting with a single ogre item. All the glyphs of a font
+    /// are in its texture atlas, so the quads of every label are packed in
+    /// one vertex buffer and drawn with one draw call. The quads of a label
+    /// are laid out in label space when the label changes, and are
+    /// billboarded towards the camera by Update, once per frame. The vertex
+    /// buffer is only written when a label, its position or the camera
+    /// orientation changed.
+    class Ogre2TextBatch
+    {
+      /// \brief Corner of a glyph quad, in label space
+      public: struct Vertex
+      {
+        /// \brief Position along the right axis of the camera
+        float x;
+
+        /// \brief Position along the up axis of the camera
+        float y;
+
+        /// \brief Texture coordinates in the font atlas
+        float u;
+
+        /// \brief Texture coordinates in the font atlas
+        float v;
+      };
+
+      /// \brief Constructor
+      /// \param[in] _sceneManager Scene manager to draw the labels in
+      /// \param[in] _font Loaded font
+      /// \param[in] _onTop True to draw the labels over other objects
+      private: Ogre2TextBatch(Ogre::SceneManager *_sceneManager,
+          Ogre::FontPtr _font, bool _onTop);
+
+      /// \brief Destructor
+      public: ~Ogre2TextBatch();
+
+      /// \brief Get the batch of a font, creating it if needed. Batches are
+      /// shared by all the labels using them and are destroyed with the last
+      /// one.
+      /// \param[in] _sceneManager Scene manager to draw the labels in
+      /// \param[in] _font Name of the font
+      /// \param[in] _onTop True to draw the labels over other objects
+      /// \return The batch or null if the font could not be loaded
+      public: static std::shared_ptr<Ogre2TextBatch> Instance(
+          Ogre::SceneManager *_sceneManager, const std::string &_font,
+          bool _onTop);
+
+      /// \brief Billboard the labels of all the batches of a scene manager
+      /// towards a camera and upload their quads. Only the first call of a
+      /// frame has an effect, so the labels face the first camera rendered
+      /// in a frame.
+      /// \param[in] _sceneManager Scene manager of the camera
+      /// \param[in] _camera Camera about to be rendered
+      public: static void UpdateAll(Ogre::SceneManager *_sceneManager,
+          const Ogre::Camera *_camera);
+
+      /// \brief Get the font of the batch
+      /// \return Font used to lay out the labels
+      public: Ogre::FontPtr Font() const;
+
+      /// \brief Add a label to the batch
+      /// \param[in] _anchor Object giving the world position and the
+      /// visibility of the label
+      /// \return Id of the label in the batch
+      public: unsigned int AddLabel(const Ogre::MovableObject *_anchor);
+
+      /// \brief Remove a label from the batch
+      /// \param[in] _id Id of the label
+      public: void RemoveLabel(unsigned int _id);
+
+      /// \brief Set the glyph quads of a label, 6 vertices per glyph
+      /// \param[in] _id Id of the label
+      /// \param[in] _vertices Glyph quads in label space
+      /// \param[in] _color Color of the label
+      /// \param[in] _baseline Height of the label above its anchor, along
+      /// the world z axis
+      public: void SetLabel(unsigned int _id, std::vector<Vertex> &&_vertices,
+          const math::Color &_color, float _baseline);
+
+      /// \brief Get the number of labels in the batch
+      /// \return Number of labels
+      public: unsigned int LabelCount() const;
+
+      /// \brief Billboard the labels towards a camera and upload their quads
+      /// if anything changed since the last update
+      /// \param[in] _right Right axis of the camera in world space
+      /// \param[in] _up Up axis of the camera in world space
+      private: void Update(const Ogre::Vector3 &_right,
+          const Ogre::Vector3 &_up);
+
+      /// \brief Create the item and the vertex buffer of the batch
+      /// \param[in] _capacity Number of vertices of the buffer
+      private: void CreateBuffer(unsigned int _capacity);
+
+      /// \brief Destroy the item and the vertex buffer of the batch
+      private: void DestroyBuffer();
+
+      /// \brief Label of the batch
+      private: struct Label
+      {
+        /// \brief Object giving the position and visibility of the label
+        const Ogre::MovableObject *anchor = nullptr;
+
+        /// \brief Glyph quads in label space
+        std::vector<Vertex> vertices;
+
+        /// \brief Color of the label
+        math::Color color;
+
+        /// \brief Height of the label above its anchor
+        float baseline = 0.0f;
+
+        /// \brief Position of the label in the last update
+        Ogre::Vector3 position = Ogre::Vector3::ZERO;
+
+        /// \brief Visibility of the label in the last update
+        bool visible = false;
+      };
+
+      /// \brief Key of a batch: scene manager, font name and on top setting
+      private: using Key = std::tuple<Ogre::SceneManager *, std::string, bool>;
+
+      /// \brief All the batches in use
+      private: static std::map<Key, std::weak_ptr<Ogre2TextBatch>> batches;
+
+      /// \brief Scene manager the labels are drawn in
+      private: Ogre::SceneManager *sceneManager = nullptr;
+
+      /// \brief Font of the labels
+      private: Ogre::FontPtr font;
+
+      /// \brief Datablock of the batch, a copy of the font datablock
+      private: Ogre::HlmsDatablock *datablock = nullptr;
+
+      /// \brief Mesh of the batch
+      private: Ogre::MeshPtr mesh;
+
+      /// \brief Item drawing the batch
+      private: Ogre::Item *item = nullptr;
+
+      /// \brief Vertex buffer of the glyph quads
+      private: Ogre::VertexBufferPacked *vertexBuffer = nullptr;
+
+      /// \brief Vertex array object of the glyph quads
+      private: Ogre::VertexArrayObject *vao = nullptr;
+
+      /// \brief Number of vertices of the vertex buffer
+      private: unsigned int capacity = 0u;
+
+      /// \brief Vertices staged in cpu memory before being copied to the
+      /// persistently mapped vertex buffer
+      private: std::vector<float> staging;
+
+      /// \brief Labels of the batch, by id
+      private: std::map<unsigned int, Label> labels;
+
+      /// \brief Id of the next label added
+      private: unsigned int nextId = 0u;
+
+      /// \brief True if labels were added, removed or changed since the last
+      /// update
+      private: bool dirty = true;
+
+      /// \brief Frame of the last update
+      private: unsigned long updateFrame = 0u;
+
+      /// \brief Camera axes in the last update
+      private: Ogre::Vector3 right = Ogre::Vector3::ZERO;
+
+      /// \brief Camera axes in the last update
+      private: Ogre::Vector3 up = Ogre::Vector3::ZERO;
+    };
+    }
+  }
+}
+#endif
@@ -0,0 +1,820 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/StringUtils.hh>
+#include <ignition/common/Util.hh>
+
+#include "ignition/rendering/EnvironmentMapFilter.hh"
+#include "ignition/rendering/MemoryTracker.hh"
+#include "ignition/rendering/Profiler.hh"
+#include "ignition/rendering/TextureCompressor.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+
+#include "Ogre2TextureStreamer.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreHlmsManager.h>
+#include <OgreResourceGroupManager.h>
+#include <OgreRoot.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Roughness added at each level of a prefiltered environment map,
+/// the ogre pbs shaders sample the level 12 times the roughness
+static const double kEnvironmentMapRoughnessStep = 1.0 / 12.0;
+
+/// \brief Header of a prefiltered environment map in the cache, followed by
+/// the spherical harmonics of the irradiance and the texel data
+struct EnvironmentMapHeader
+{
+  /// \brief File format identifier
+  char magic[4];
+
+  /// \brief Width of the faces in texels
+  uint32_t size;
+
+  /// \brief Number of levels, including the faces
+  uint32_t mipCount;
+};
+
+//////////////////////////////////////////////////
+/// \brief Read the content of a file
+/// \param[in] _file Path of the file
+/// \return Content, empty if the file can not be read
+static std::vector<char> readFile(const std::string &_file)
+{
+  std::ifstream file(_file, std::ios::in | std::ios::binary);
+  return std::vector<char>((std::istreambuf_iterator<char>(file)),
+      std::istreambuf_iterator<char>());
+}
+
+//////////////////////////////////////////////////
+/// \brief Decode an image file loaded in memory
+/// \param[in] _buffer Content of the file
+/// \param[in] _ext Extension of the file
+/// \param[out] _image Decoded image
+/// \return True on success
+static bool loadImage(std::vector<char> &_buffer, const std::string &_ext,
+    Ogre::Image &_image)
+{
+  try
+  {
+    Ogre::DataStreamPtr stream(OGRE_NEW Ogre::MemoryDataStream(
+        _buffer.data(), _buffer.size(), false, true));
+    _image.load(stream, _ext);
+  }
+  catch(Ogre::Exception &)
+  {
+    return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Write a file of the texture cache. The content is written to a
+/// temporary file first so other processes never read a partially written
+/// file.
+/// \param[in] _dir Directory of the cache
+/// \param[in] _file Path of the file
+/// \param[in] _content Content of the file
+static void writeCacheFile(const std::string &_dir, const std::string &_file,
+    const std::vector<char> &_content)
+{
+  if (!common::isDirectory(_dir) && !common::createDirectories(_dir))
+    return;
+
+  std::string tmpFile = _file + "." + std::to_string(
+      std::chrono::system_clock::now().time_since_epoch().count()) + ".tmp";
+  std::ofstream file(tmpFile, std::ios::out | std::ios::binary);
+  file.write(_content.data(), _content.size());
+  file.close();
+  if (!file || std::rename(tmpFile.c_str(), _file.c_str()) != 0)
+  {
+    ignwarn << "Unable to write texture cache file [" << _file << "]"
+            << std::endl;
+    std::remove(tmpFile.c_str());
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Create the ogre image of a prefiltered environment map
+/// \param[in] _data Faces, each followed by its mipmaps
+/// \param[in] _size Width of the faces in texels
+/// \param[in] _mipCount Number of levels, including the faces
+/// \param[out] _image Cubemap image owning a copy of the data
+static void environmentMapImage(const std::vector<unsigned char> &_data,
+    unsigned int _size, unsigned int _mipCount, Ogre::Image &_image)
+{
+  Ogre::uchar *buffer = OGRE_ALLOC_T(Ogre::uchar, _data.size(),
+      Ogre::MEMCATEGORY_GENERAL);
+  std::memcpy(buffer, _data.data(), _data.size());
+  _image.loadDynamicImage(buffer, _size, _size, 1u, Ogre::PF_BYTE_RGBA, true,
+      6u, _mipCount - 1u);
+}
+
+//////////////////////////////////////////////////
+Ogre2TextureStreamer::~Ogre2TextureStreamer()
+{
+  for (auto &task : this->tasks)
+    task.future.wait();
+}
+
+//////////////////////////////////////////////////
+void Ogre2TextureStreamer::SetEnabled(bool _enabled)
+{
+  this->enabled = _enabled;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2TextureStreamer::Enabled() const
+{
+  return this->enabled;
+}
+
+//////////////////////////////////////////////////
+void Ogre2TextureStreamer::SetUploadBudget(size_t _bytes)
+{
+  this->uploadBudget = _bytes;
+}
+
+//////////////////////////////////////////////////
+size_t Ogre2TextureStreamer::UploadBudget() const
+{
+  return this->uploadBudget;
+}
+
+//////////////////////////////////////////////////
+void Ogre2TextureStreamer::SetCompressionEnabled(bool _enabled)
+{
+  this->compressionEnabled = _enabled;
+  if (_enabled)
+    this->InitCacheDir();
+}
+
+//////////////////////////////////////////////////
+bool Ogre2TextureStreamer::CompressionEnabled() const
+{
+  return this->compressionEnabled;
+}
+
+//////////////////////////////////////////////////
+void Ogre2TextureStreamer::SetEnvironmentMapPrefilteringEnabled(bool _enabled)
+{
+  this->prefilteringEnabled = _enabled;
+  if (_enabled)
+    this->InitCacheDir();
+}
+
+//////////////////////////////////////////////////
+bool Ogre2TextureStreamer::EnvironmentMapPrefilteringEnabled() const
+{
+  return this->prefilteringEnabled;
+}
+
+//////////////////////////////////////////////////
+void Ogre2TextureStreamer::InitCacheDir()
+{
+  if (!this->cacheDir.empty())
+    return;
+  std::string home;
+  ignition::common::env(IGN_HOMEDIR, home);
+  this->cacheDir = common::joinPaths(home, ".ignition",
+      "rendering", "ogre2_texture_cache");
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2TextureStreamer::ResourceName(const std::string &_texture)
+{
+  auto it = this->resources.find(_texture);
+  if (it != this->resources.end())
+    return it->second.name;
+
+  // FIXME(anyone) need to keep baseName = _texture for all meshes. Refer to
+  // https://github.com/ignitionrobotics/ign-rendering/issues/139
+  // for more details
+  Resource resource;
+  resource.name = _texture;
+  resource.isFile = common::isFile(_texture);
+  if (resource.isFile)
+  {
+    resource.name = common::basename(_texture);
+    size_t idx = _texture.rfind(resource.name);
+    if (idx != std::string::npos)
+    {
+      std::string dirPath = _texture.substr(0, idx);
+      if (!dirPath.empty() &&
+          !Ogre::ResourceGroupManager::getSingleton().resourceLocationExists(
+          dirPath))
+      {
+        Ogre::ResourceGroupManager::getSingleton().addResourceLocation(
+            dirPath, "FileSystem", "General");
+      }
+    }
+  }
+
+  // temp workaround check if the model is a OBJ file
+  {
+    size_t idx = _texture.rfind("meshes");
+    if (idx != std::string::npos)
+    {
+      std::string objFile =
+        common::joinPaths(_texture.substr(0, idx), "meshes", "model.obj");
+      if (common::isFile(objFile))
+        resource.name = _texture;
+    }
+  }
+
+  this->resources[_texture] = resource;
+  return resource.name;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2TextureStreamer::Stream(const std::string &_texture,
+    Ogre::HlmsTextureManager::TextureMapType _mapType,
+    const Callback &_callback,
+    Ogre::HlmsTextureManager::TextureLocation &_placeholder)
+{
+  // prefiltered environment maps are loaded synchronously by Load
+  if (!this->enabled || this->Prefiltered(_mapType))
+    return false;
+
+  Ogre::HlmsTextureManager *textureManager = this->TextureManager();
+  if (!textureManager)
+    return false;
+
+  std::string name = this->ResourceName(_texture);
+  const Resource &resource = this->resources[_texture];
+  if (!resource.isFile)
+    return false;
+
+  // share the decode of a texture that is already being streamed
+  for (auto &task : this->tasks)
+  {
+    if (task.name == name)
+    {
+      task.callbacks.push_back(_callback);
+      _placeholder = this->Placeholder(task.mapType);
+      return true;
+    }
+  }
+
+  // already uploaded
+  if (textureManager->findResourceNameFromAlias(name))
+    return false;
+
+  Task task;
+  task.name = name;
+  task.mapType = _mapType;
+  task.image = std::make_shared<Ogre::Image>();
+  task.callbacks.push_back(_callback);
+
+  auto image = task.image;
+  std::string path = _texture;
+  std::string dir = this->Compressed(_mapType) ? this->cacheDir : "";
+  task.future = std::async(std::launch::async, [image, path, dir]()
+  {
+    return Ogre2TextureStreamer::Decode(path, dir, *image);
+  }).share();
+
+  this->tasks.push_back(task);
+  _placeholder = this->Placeholder(_mapType);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2TextureStreamer::Load(const std::string &_texture,
+    Ogre::HlmsTextureManager::TextureMapType _mapType,
+    Ogre::HlmsTextureManager::TextureLocation &_location)
+{
+  bool prefiltered = this->Prefiltered(_mapType);
+  if (!prefiltered && !this->Compressed(_mapType))
+    return false;
+
+  Ogre::HlmsTextureManager *textureManager = this->TextureManager();
+  if (!textureManager)
+    return false;
+
+  std::string name = this->ResourceName(_texture);
+  if (!this->resources[_texture].isFile ||
+      textureManager->findResourceNameFromAlias(name))
+  {
+    return false;
+  }
+
+  Ogre::Image image;
+  if (prefiltered)
+  {
+    std::vector<math::Vector3d> sh;
+    if (!DecodeEnvironmentMap(_texture, this->cacheDir, image, sh))
+      return false;
+    this->irradiance[name] = sh;
+  }
+  else if (!Decode(_texture, this->cacheDir, image))
+  {
+    return false;
+  }
+
+  _location = textureManager->createOrRetrieveTexture(name, name, _mapType,
+      &image);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2TextureStreamer::CreateEnvironmentMap(const std::string &_name,
+    const Ogre::Image &_cubemap,
+    Ogre::HlmsTextureManager::TextureLocation &_location)
+{
+  Ogre::HlmsTextureManager *textureManager = this->TextureManager();
+  if (!textureManager)
+    return false;
+
+  std::vector<unsigned char> data;
+  unsigned int size = 0u;
+  unsigned int mipCount = 0u;
+  std::vector<math::Vector3d> sh;
+  if (!PrefilterEnvironmentMap(_cubemap, data, size, mipCount, sh))
+    return false;
+
+  if (textureManager->findResourceNameFromAlias(_name))
+    textureManager->destroyTexture(_name);
+
+  Ogre::Image image;
+  environmentMapImage(data, size, mipCount, image);
+  _location = textureManager->createOrRetrieveTexture(_name, _name,
+      Ogre::HlmsTextureManager::TEXTURE_TYPE_ENV_MAP, &image);
+  this->irradiance[_name] = sh;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2TextureStreamer::EnvironmentIrradiance(const std::string &_texture,
+    std::vector<math::Vector3d> &_sh) const
+{
+  auto resource = this->resources.find(_texture);
+  auto it = this->irradiance.find(resource != this->resources.end() ?
+      resource->second.name : _texture);
+  if (it == this->irradiance.end())
+    return false;
+  _sh = it->second;
+  return true;
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<Ogre2TextureStreamer::Usage> Ogre2TextureStreamer::Track(
+    const std::string &_name,
+    const Ogre::HlmsTextureManager::TextureLocation &_location)
+{
+  auto it = this->usages.find(_name);
+  if (it != this->usages.end())
+    return it->second;
+
+  auto usage = std::make_shared<Usage>();
+  usage->name = _name;
+  usage->lastFrame = this->frame;
+
+  // size of one slice of the texture array, with all its mipmaps
+  if (!_location.texture.isNull())
+  {
+    Ogre::Texture *texture = _location.texture.get();
+    for (size_t mip = 0; mip <= texture->getNumMipmaps(); ++mip)
+    {
+      usage->bytes += Ogre::PixelUtil::getMemorySize(
+          std::max<Ogre::uint32>(1u, texture->getWidth() >> mip),
+          std::max<Ogre::uint32>(1u, texture->getHeight() >> mip), 1u,
+          texture->getFormat());
+    }
+  }
+
+  this->residentMemory += usage->bytes;
+  this->usages[_name] = usage;
+  MemoryTracker::Track(MC_TEXTURE, usage.get(), usage->bytes);
+  return usage;
+}
+
+//////////////////////////////////////////////////
+uint64_t Ogre2TextureStreamer::Frame() const
+{
+  return this->frame;
+}
+
+//////////////////////////////////////////////////
+void Ogre2TextureStreamer::SetMemoryBudget(size_t _bytes)
+{
+  this->memoryBudget = _bytes;
+}
+
+//////////////////////////////////////////////////
+size_t Ogre2TextureStreamer::MemoryBudget() const
+{
+  return this->memoryBudget;
+}
+
+//////////////////////////////////////////////////
+size_t Ogre2TextureStreamer::ResidentMemory() const
+{
+  return this->residentMemory;
+}
+
+//////////////////////////////////////////////////
+size_t Ogre2TextureStreamer::EvictedMemory() const
+{
+  return this->evictedMemory;
+}
+
+//////////////////////////////////////////////////
+void Ogre2TextureStreamer::Update()
+{
+  IGN_RENDERING_PROFILE("Ogre2TextureStreamer::Update");
+  ++this->frame;
+  this->Evict();
+
+  if (this->tasks.empty())
+    return;
+
+  Ogre::HlmsTextureManager *textureManager = this->TextureManager();
+  if (!textureManager)
+    return;
+
+  size_t uploaded = 0u;
+  auto it = this->tasks.begin();
+  while (it != this->tasks.end() && uploaded < this->uploadBudget)
+  {
+    if (it->future.wait_for(std::chrono::seconds(0)) !=
+        std::future_status::ready)
+    {
+      ++it;
+      continue;
+    }
+
+    Ogre::HlmsTextureManager::TextureLocation location;
+    if (it->future.get())
+    {
+      uploaded += it->image->getSize();
+      location = textureManager->createOrRetrieveTexture(it->name, it->name,
+          it->mapType, it->image.get());
+    }
+    else
+    {
+      // let ogre find and decode the texture, as if it was not streamed
+      ignwarn << "Unable to decode texture [" << it->name << "] "
+              << "on a worker thread, loading it synchronously" << std::endl;
+      location = textureManager->createOrRetrieveTexture(it->name,
+          it->mapType);
+    }
+
+    // callbacks may stream more textures, which are appended to the list
+    std::vector<Callback> callbacks = std::move(it->callbacks);
+    it = this->tasks.erase(it);
+    for (auto &callback : callbacks)
+      callback(location);
+  }
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2TextureStreamer::PendingCount() const
+{
+  return static_cast<unsigned int>(this->tasks.size());
+}
+
+//////////////////////////////////////////////////
+void Ogre2TextureStreamer::Reset()
+{
+  for (auto &task : this->tasks)
+    task.future.wait();
+  this->tasks.clear();
+  this->resources.clear();
+  this->placeholders.clear();
+  this->irradiance.clear();
+  for (auto &usage : this->usages)
+    MemoryTracker::Untrack(usage.second.get());
+  this->usages.clear();
+  this->residentMemory = 0u;
+}
+
+//////////////////////////////////////////////////
+void Ogre2TextureStreamer::Evict()
+{
+  if (this->memoryBudget == 0u || this->residentMemory <= this->memoryBudget)
+    return;
+
+  Ogre::HlmsTextureManager *textureManager = this->TextureManager();
+  if (!textureManager)
+    return;
+
+  // textures still bound to a material can not be evicted, since ogre
+  // datablocks reference the texture array slices directly
+  std::vector<std::shared_ptr<Usage>> unused;
+  for (auto &usage : this->usages)
+  {
+    if (usage.second.use_count() == 1)
+      unused.push_back(usage.second);
+  }
+  std::sort(unused.begin(), unused.end(),
+      [](const std::shared_ptr<Usage> &_a, const std::shared_ptr<Usage> &_b)
+      {
+        return _a->lastFrame < _b->lastFrame;
+      });
+
+  for (auto &usage : unused)
+  {
+    if (this->residentMemory <= this->memoryBudget)
+      break;
+    textureManager->destroyTexture(usage->name);
+    MemoryTracker::Untrack(usage.get());
+    this->residentMemory -= usage->bytes;
+    this->evictedMemory += usage->bytes;
+    this->usages.erase(usage->name);
+  }
+}
+
+//////////////////////////////////////////////////
+Ogre::HlmsTextureManager::TextureLocation Ogre2TextureStreamer::Placeholder(
+    Ogre::HlmsTextureManager::TextureMapType _mapType)
+{
+  auto it = this->placeholders.find(static_cast<int>(_mapType));
+  if (it != this->placeholders.end())
+    return it->second;
+
+  // flat normals for normal maps, opaque white for everything else so the
+  // material parameters are used as is
+  const unsigned int size = 4u;
+  Ogre::uint8 color[4] = {255u, 255u, 255u, 255u};
+  if (_mapType == Ogre::HlmsTextureManager::TEXTURE_TYPE_NORMALS)
+  {
+    color[0] = 128u;
+    color[1] = 128u;
+  }
+
+  Ogre::uchar *data = OGRE_ALLOC_T(Ogre::uchar, size * size * 4u,
+      Ogre::MEMCATEGORY_GENERAL);
+  for (unsigned int i = 0; i < size * size; ++i)
+  {
+    for (unsigned int c = 0; c < 4u; ++c)
+      data[i * 4u + c] = color[c];
+  }
+  Ogre::Image image;
+  image.loadDynamicImage(data, size, size, 1u, Ogre::PF_R8G8B8A8, true);
+
+  std::string name = "ign_texture_placeholder_" +
+      std::to_string(static_cast<int>(_mapType));
+  Ogre::HlmsTextureManager::TextureLocation location =
+      this->TextureManager()->createOrRetrieveTexture(name, name, _mapType,
+      &image);
+  this->placeholders[static_cast<int>(_mapType)] = location;
+  return location;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2TextureStreamer::Decode(const std::string &_path,
+    const std::string &_cacheDir, Ogre::Image &_image)
+{
+  std::vector<char> buffer = readFile(_path);
+  if (buffer.empty())
+    return false;
+
+  std::string ext;
+  size_t idx = _path.rfind('.');
+  if (idx != std::string::npos)
+    ext = common::lowercase(_path.substr(idx + 1));
+
+  // already compressed textures are uploaded as is
+  if (_cacheDir.empty() || ext == "dds" || ext == "ktx" || ext == "pkm")
+    return loadImage(buffer, ext, _image);
+
+  // bump the version whenever the compression changes
+  std::string key = "v1::" + common::sha1<std::string>(
+      std::string(buffer.begin(), buffer.end()));
+  std::string cacheFile = common::joinPaths(_cacheDir,
+      common::sha1<std::string>(key) + ".dds");
+  if (common::isFile(cacheFile))
+  {
+    std::vector<char> cached = readFile(cacheFile);
+    if (!cached.empty() && loadImage(cached, "dds", _image))
+      return true;
+  }
+
+  if (!loadImage(buffer, ext, _image))
+    return false;
+
+  unsigned int width = static_cast<unsigned int>(_image.getWidth());
+  unsigned int height = static_cast<unsigned int>(_image.getHeight());
+  std::vector<unsigned char> rgba(width * height * 4u);
+  try
+  {
+    Ogre::PixelBox dst(width, height, 1u, Ogre::PF_BYTE_RGBA, rgba.data());
+    Ogre::PixelUtil::bulkPixelConversion(_image.getPixelBox(), dst);
+  }
+  catch(Ogre::Exception &)
+  {
+    // keep the uncompressed image
+    return true;
+  }
+
+  TextureCompression format =
+      TextureCompressor::HasAlpha(rgba.data(), width, height) ?
+      TC_BC3 : TC_BC1;
+  std::vector<unsigned char> dds =
+      TextureCompressor::CompressDds(rgba.data(), width, height, format);
+  std::vector<char> compressed(dds.begin(), dds.end());
+
+  writeCacheFile(_cacheDir, cacheFile, compressed);
+
+  // keep the uncompressed image if ogre can not read the result
+  Ogre::Image image;
+  if (loadImage(compressed, "dds", image))
+    _image = image;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2TextureStreamer::DecodeEnvironmentMap(const std::string &_path,
+    const std::string &_cacheDir, Ogre::Image &_image,
+    std::vector<math::Vector3d> &_sh)
+{
+  std::vector<char> buffer = readFile(_path);
+  if (buffer.empty())
+    return false;
+
+  // bump the version whenever the filtering changes
+  std::string key = "ibl-v1::" + common::sha1<std::string>(
+      std::string(buffer.begin(), buffer.end()));
+  std::string cacheFile = common::joinPaths(_cacheDir,
+      common::sha1<std::string>(key) + ".ibl");
+
+  std::vector<unsigned char> data;
+  unsigned int size = 0u;
+  unsigned int mipCount = 0u;
+  const size_t shBytes = 27u * sizeof(double);
+  std::vector<char> cached = readFile(cacheFile);
+  EnvironmentMapHeader header;
+  if (cached.size() > sizeof(header) + shBytes)
+  {
+    std::memcpy(&header, cached.data(), sizeof(header));
+    size_t faceBytes = 0u;
+    for (unsigned int level = 0u; level < header.mipCount; ++level)
+    {
+      size_t levelSize = std::max(1u, header.size >> level);
+      faceBytes += levelSize * levelSize * 4u;
+    }
+    if (std::memcmp(header.magic, "IBL1", 4u) == 0 && header.size > 0u &&
+        header.mipCount > 0u &&
+        cached.size() == sizeof(header) + shBytes + faceBytes * 6u)
+    {
+      double coefficients[27];
+      std::memcpy(coefficients, cached.data() + sizeof(header), shBytes);
+      _sh.clear();
+      for (unsigned int i = 0u; i < 9u; ++i)
+      {
+        _sh.push_back(math::Vector3d(coefficients[i * 3u],
+            coefficients[i * 3u + 1u], coefficients[i * 3u + 2u]));
+      }
+      const char *texels = cached.data() + sizeof(header) + shBytes;
+      data.assign(texels, texels + faceBytes * 6u);
+      environmentMapImage(data, header.size, header.mipCount, _image);
+      return true;
+    }
+  }
+
+  std::string ext;
+  size_t idx = _path.rfind('.');
+  if (idx != std::string::npos)
+    ext = common::lowercase(_path.substr(idx + 1));
+  Ogre::Image cubemap;
+  if (!loadImage(buffer, ext, cubemap) ||
+      !PrefilterEnvironmentMap(cubemap, data, size, mipCount, _sh))
+  {
+    return false;
+  }
+
+  std::memcpy(header.magic, "IBL1", 4u);
+  header.size = size;
+  header.mipCount = mipCount;
+  std::vector<char> content(sizeof(header) + shBytes + data.size());
+  std::memcpy(content.data(), &header, sizeof(header));
+  for (unsigned int i = 0u; i < 9u; ++i)
+  {
+    double rgb[3] = {_sh[i].X(), _sh[i].Y(), _sh[i].Z()};
+    std::memcpy(content.data() + sizeof(header) + i * sizeof(rgb), rgb,
+        sizeof(rgb));
+  }
+  std::memcpy(content.data() + sizeof(header) + shBytes, data.data(),
+      data.size());
+  writeCacheFile(_cacheDir, cacheFile, content);
+
+  environmentMapImage(data, size, mipCount, _image);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2TextureStreamer::PrefilterEnvironmentMap(
+    const Ogre::Image &_cubemap, std::vector<unsigned char> &_data,
+    unsigned int &_size, unsigned int &_mipCount,
+    std::vector<math::Vector3d> &_sh)
+{
+  IGN_RENDERING_PROFILE("Ogre2TextureStreamer::PrefilterEnvironmentMap");
+  unsigned int size = static_cast<unsigned int>(_cubemap.getWidth());
+  if (_cubemap.getNumFaces() != 6u || size == 0u ||
+      _cubemap.getHeight() != size)
+  {
+    return false;
+  }
+
+  // compressed cubemaps can not be converted
+  std::vector<float> faces(6u * size * size * 4u);
+  try
+  {
+    for (unsigned int f = 0u; f < 6u; ++f)
+    {
+      Ogre::PixelBox dst(size, size, 1u, Ogre::PF_FLOAT32_RGBA,
+          faces.data() + f * size * size * 4u);
+      Ogre::PixelUtil::bulkPixelConversion(_cubemap.getPixelBox(f, 0u),
+          dst);
+    }
+  }
+  catch(Ogre::Exception &)
+  {
+    return false;
+  }
+
+  _size = size;
+  _mipCount = EnvironmentMapFilter::MipCount(size);
+  _sh = EnvironmentMapFilter::IrradianceSh(faces.data(), size);
+  std::vector<std::vector<float>> levels =
+      EnvironmentMapFilter::PrefilterSpecular(faces.data(), size, _mipCount,
+      kEnvironmentMapRoughnessStep);
+
+  // ogre images store each face followed by its mipmaps
+  _data.clear();
+  for (unsigned int f = 0u; f < 6u; ++f)
+  {
+    for (unsigned int level = 0u; level < _mipCount; ++level)
+    {
+      size_t levelSize = std::max(1u, size >> level);
+      size_t count = levelSize * levelSize * 4u;
+      const float *texels = levels[level].data() + f * count;
+      for (size_t i = 0u; i < count; ++i)
+      {
+        float value = std::min(1.0f, std::max(0.0f, texels[i]));
+        _data.push_back(static_cast<unsigned char>(value * 255.0f + 0.5f));
+      }
+    }
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2TextureStreamer::Prefiltered(
+    Ogre::HlmsTextureManager::TextureMapType _mapType) const
+{
+  return this->prefilteringEnabled &&
+      _mapType == Ogre::HlmsTextureManager::TEXTURE_TYPE_ENV_MAP;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2TextureStreamer::Compressed(
+    Ogre::HlmsTextureManager::TextureMapType _mapType) const
+{
+  return this->compressionEnabled &&
+      _mapType == Ogre::HlmsTextureManager::TEXTURE_TYPE_DIFFUSE;
+}
+
+//////////////////////////////////////////////////
+Ogre::HlmsTextureManager *Ogre2TextureStreamer::TextureManager()
+{
+  Ogre::Root *root = Ogre2RenderEngine::Instance()->OgreRoot();
+  if (!root || !root->getHlmsManager())
+    return nullptr;
+  return root->getHlmsManager()->getTextureManager();
+}
@@ -0,0 +1,379 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2TEXTURESTREAMER_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2TEXTURESTREAMER_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ignition/common/SingletonT.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "ignition/rendering/ogre2/Ogre2Includes.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreHlmsTextureManager.h>
+#include <OgreImage.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Loads the textures of ogre2 materials. Texture names are
+    /// resolved to ogre resource names once and the directories of texture
+    /// files are registered as resource locations the first time they are
+    /// seen. When streaming is enabled, texture files are decoded on worker
+    /// threads while a small placeholder texture is bound in their place.
+    /// Decoded textures are uploaded by Update, called once per frame, up
+    /// to a budget of bytes per frame. When compression is enabled, diffuse
+    /// texture files are compressed to BC1 or BC3 the first time they are
+    /// loaded and the result is cached on disk, in
+    /// ~/.ignition/rendering/ogre2_texture_cache. When environment map
+    /// prefiltering is enabled, cubemap environment maps are convolved with
+    /// EnvironmentMapFilter into a specular mip chain and the spherical
+    /// harmonics of their irradiance, cached in the same directory. Textures
+    /// bound to
+    /// materials are tracked, so that textures no material uses any more
+    /// can be evicted, least recently used first, once a memory budget is
+    /// exceeded.
+    class Ogre2TextureStreamer :
+      public common::SingletonT<Ogre2TextureStreamer>
+    {
+      /// \brief Callback invoked once a streamed texture has been uploaded
+      public: using Callback = std::function<void(
+          const Ogre::HlmsTextureManager::TextureLocation &)>;
+
+      /// \brief Usage of a texture bound to materials. Materials hold a
+      /// reference to the usage of each of their textures.
+      public: struct Usage
+      {
+        /// \brief Ogre resource name of the texture
+        std::string name;
+
+        /// \brief Estimated size of the texture in video memory, in bytes
+        size_t bytes = 0u;
+
+        /// \brief Last frame a material using the texture was rendered
+        uint64_t lastFrame = 0u;
+      };
+
+      /// \brief Constructor
+      private: Ogre2TextureStreamer() = default;
+
+      /// \brief Destructor
+      public: ~Ogre2TextureStreamer();
+
+      /// \brief Enable or disable texture streaming. Textures requested
+      /// while streaming is disabled are loaded synchronously.
+      /// \param[in] _enabled True to enable streaming
+      public: void SetEnabled(bool _enabled);
+
+      /// \brief Get whether texture streaming is enabled
+      /// \return True if enabled
+      public: bool Enabled() const;
+
+      /// \brief Set the number of bytes of decoded textures uploaded per
+      /// frame. At least one texture is uploaded per frame, whatever its
+      /// size.
+      /// \param[in] _bytes Upload budget in bytes
+      public: void SetUploadBudget(size_t _bytes);
+
+      /// \brief Get the number of bytes of decoded textures uploaded per
+      /// frame
+      /// \return Upload budget in bytes
+      public: size_t UploadBudget() const;
+
+      /// \brief Enable or disable the compression of diffuse textures.
+      /// Textures that are already compressed, e.g. DDS files, are loaded as
+      /// is.
+      /// \param[in] _enabled True to enable compression
+      public: void SetCompressionEnabled(bool _enabled);
+
+      /// \brief Get whether the compression of diffuse textures is enabled
+      /// \return True if enabled
+      public: bool CompressionEnabled() const;
+
+      /// \brief Enable or disable the prefiltering of cubemap environment
+      /// maps. Prefiltered environment maps are loaded synchronously.
+      /// Compressed cubemaps, which can not be decoded, are loaded as is.
+      /// \param[in] _enabled True to enable prefiltering
+      public: void SetEnvironmentMapPrefilteringEnabled(bool _enabled);
+
+      /// \brief Get whether the prefiltering of environment maps is enabled
+      /// \return True if enabled
+      public: bool EnvironmentMapPrefilteringEnabled() const;
+
+      /// \brief Get the ogre resource name of a texture. If the texture is
+      /// a file, its directory is added to the ogre resource locations.
+      /// The result is cached, so the file system is only queried the first
+      /// time a texture is seen.
+      /// \param[in] _texture Texture file path or resource name
+      /// \return Resource name of the texture
+      public: std::string ResourceName(const std::string &_texture);
+
+      /// \brief Stream a texture. The texture file is decoded on a worker
+      /// thread and the callback is invoked by Update once it is uploaded.
+      /// Requests for a texture that is already being streamed share the
+      /// same decode.
+      /// \param[in] _texture Texture file path or resource name
+      /// \param[in] _mapType Type of texture map
+      /// \param[in] _callback Callback invoked with the uploaded texture
+      /// \param[out] _placeholder Placeholder texture to bind until the
+      /// callback is invoked
+      /// \return False if the texture is not streamed, e.g. streaming is
+      /// disabled, the texture is not a file or it is already loaded. The
+      /// texture should then be loaded synchronously.
+      public: bool Stream(const std::string &_texture,
+          Ogre::HlmsTextureManager::TextureMapType _mapType,
+          const Callback &_callback,
+          Ogre::HlmsTextureManager::TextureLocation &_placeholder);
+
+      /// \brief Synchronously load a texture that needs to be compressed or
+      /// prefiltered.
+      /// \param[in] _texture Texture file path or resource name
+      /// \param[in] _mapType Type of texture map
+      /// \param[out] _location Loaded texture
+      /// \return False if the texture is not compressed or prefiltered, e.g.
+      /// both are disabled, the texture is not a file or it is already
+      /// loaded. The texture should then be loaded by ogre.
+      public: bool Load(const std::string &_texture,
+          Ogre::HlmsTextureManager::TextureMapType _mapType,
+          Ogre::HlmsTextureManager::TextureLocation &_location);
+
+      /// \brief Prefilter a cubemap, e.g. rendered by a reflection probe, and
+      /// load it as an environment map, replacing any texture of the same
+      /// name. Materials already using that texture need to set it again.
+      /// \param[in] _name Ogre resource name of the environment map
+      /// \param[in] _cubemap Cubemap with 6 square faces
+      /// \param[out] _location Loaded texture
+      /// \return True on success
+      public: bool CreateEnvironmentMap(const std::string &_name,
+          const Ogre::Image &_cubemap,
+          Ogre::HlmsTextureManager::TextureLocation &_location);
+
+      /// \brief Get the irradiance of a prefiltered environment map
+      /// \param[in] _texture Texture file path or resource name
+      /// \param[out] _sh Spherical harmonics of the irradiance, see
+      /// EnvironmentMapFilter::IrradianceSh
+      /// \return False if the environment map has not been prefiltered
+      public: bool EnvironmentIrradiance(const std::string &_texture,
+          std::vector<math::Vector3d> &_sh) const;
+
+      /// \brief Start tracking the usage of a texture bound to a material
+      /// \param[in] _name Ogre resource name of the texture
+      /// \param[in] _location Texture bound to the material
+      /// \return Usage of the texture, shared by all materials using it
+      public: std::shared_ptr<Usage> Track(const std::string &_name,
+          const Ogre::HlmsTextureManager::TextureLocation &_location);
+
+      /// \brief Get the number of times Update has been called, used to
+      /// stamp the usage of textures
+      /// \return Current frame
+      public: uint64_t Frame() const;
+
+      /// \brief Set the texture memory budget. Textures that are no longer
+      /// used by any material are evicted by Update, least recently used
+      /// first, while the resident textures exceed the budget.
+      /// \param[in] _bytes Budget in bytes, 0 for no budget
+      public: void SetMemoryBudget(size_t _bytes);
+
+      /// \brief Get the texture memory budget
+      /// \return Budget in bytes, 0 if there is no budget
+      public: size_t MemoryBudget() const;
+
+      /// \brief Get the estimated video memory used by the tracked textures
+      /// \return Resident texture memory in bytes
+      public: size_t ResidentMemory() const;
+
+      /// \brief Get the total size of the textures evicted so far
+      /// \return Evicted texture memory in bytes
+      public: size_t EvictedMemory() const;
+
+      /// \brief Upload decoded textures, up to the upload budget, invoke
+      /// their callbacks and evict unused textures if the memory budget is
+      /// exceeded
+      public: void Update();
+
+      /// \brief Get the number of textures that have not been uploaded yet
+      /// \return Number of pending textures
+      public: unsigned int PendingCount() const;
+
+      /// \brief Wait for all decodes to finish and discard pending textures,
+      /// placeholders and cached resource names. Must be called before the
+      /// ogre root is destroyed.
+      public: void Reset();
+
+      /// \brief Get the placeholder texture of a type of texture map,
+      /// creating it if needed
+      /// \param[in] _mapType Type of texture map
+      /// \return Placeholder texture
+      private: Ogre::HlmsTextureManager::TextureLocation Placeholder(
+          Ogre::HlmsTextureManager::TextureMapType _mapType);
+
+      /// \brief Decode a texture file. Safe to call from worker threads.
+      /// \param[in] _path Path of texture file
+      /// \param[in] _cacheDir Directory of compressed textures, textures
+      /// are not compressed if empty
+      /// \param[out] _image Decoded image
+      /// \return True on success
+      private: static bool Decode(const std::string &_path,
+          const std::string &_cacheDir, Ogre::Image &_image);
+
+      /// \brief Decode a cubemap environment map file and prefilter it,
+      /// reading and writing the result from and to the cache. Safe to call
+      /// from worker threads.
+      /// \param[in] _path Path of the cubemap file
+      /// \param[in] _cacheDir Directory of prefiltered environment maps
+      /// \param[out] _image Prefiltered cubemap, with its mipmaps
+      /// \param[out] _sh Spherical harmonics of the irradiance
+      /// \return False if the file is not a cubemap that can be decoded
+      private: static bool DecodeEnvironmentMap(const std::string &_path,
+          const std::string &_cacheDir, Ogre::Image &_image,
+          std::vector<math::Vector3d> &_sh);
+
+      /// \brief Prefilter a cubemap
+      /// \param[in] _cubemap Cubemap with 6 square faces
+      /// \param[out] _data Faces of the result, each followed by its
+      /// mipmaps, 4 bytes per texel in R, G, B, A order
+      /// \param[out] _size Width of the faces in texels
+      /// \param[out] _mipCount Number of levels, including the faces
+      /// \param[out] _sh Spherical harmonics of the irradiance
+      /// \return False if the cubemap can not be decoded
+      private: static bool PrefilterEnvironmentMap(const Ogre::Image &_cubemap,
+          std::vector<unsigned char> &_data, unsigned int &_size,
+          unsigned int &_mipCount, std::vector<math::Vector3d> &_sh);
+
+      /// \brief Check if a type of texture map is prefiltered
+      /// \param[in] _mapType Type of texture map
+      /// \return True if textures of this type are prefiltered
+      private: bool Prefiltered(
+          Ogre::HlmsTextureManager::TextureMapType _mapType) const;
+
+      /// \brief Set the directory of cached textures if it is not set yet
+      private: void InitCacheDir();
+
+      /// \brief Check if a type of texture map is compressed
+      /// \param[in] _mapType Type of texture map
+      /// \return True if textures of this type are compressed
+      private: bool Compressed(
+          Ogre::HlmsTextureManager::TextureMapType _mapType) const;
+
+      /// \brief Evict unused textures until the resident textures fit in
+      /// the memory budget
+      private: void Evict();
+
+      /// \brief Get the ogre texture manager
+      /// \return Texture manager, null if the engine is not loaded
+      private: static Ogre::HlmsTextureManager *TextureManager();
+
+      /// \brief A resolved texture name
+      private: struct Resource
+      {
+        /// \brief Ogre resource name
+        std::string name;
+
+        /// \brief True if the texture is a file
+        bool isFile = false;
+      };
+
+      /// \brief A texture being streamed
+      private: struct Task
+      {
+        /// \brief Ogre resource name of the texture
+        std::string name;
+
+        /// \brief Type of texture map
+        Ogre::HlmsTextureManager::TextureMapType mapType;
+
+        /// \brief Decoded image, only valid once the future is ready
+        std::shared_ptr<Ogre::Image> image;
+
+        /// \brief Result of the decode, true on success
+        std::shared_future<bool> future;
+
+        /// \brief Callbacks to invoke once the texture is uploaded
+        std::vector<Callback> callbacks;
+      };
+
+      /// \brief True if streaming is enabled
+      private: bool enabled = false;
+
+      /// \brief True if the compression of diffuse textures is enabled
+      private: bool compressionEnabled = false;
+
+      /// \brief True if the prefiltering of environment maps is enabled
+      private: bool prefilteringEnabled = false;
+
+      /// \brief Directory of compressed textures and prefiltered
+      /// environment maps
+      private: std::string cacheDir;
+
+      /// \brief Irradiance of prefiltered environment maps, indexed by
+      /// resource name
+      private: std::map<std::string, std::vector<math::Vector3d>> irradiance;
+
+      /// \brief Upload budget in bytes per frame
+      private: size_t uploadBudget = 32u * 1024u * 1024u;
+
+      /// \brief Textures being streamed, in request order
+      private: std::list<Task> tasks;
+
+      /// \brief Resolved texture names, indexed by texture
+      private: std::unordered_map<std::string, Resource> resources;
+
+      /// \brief Placeholder textures, indexed by type of texture map
+      private: std::map<int, Ogre::HlmsTextureManager::TextureLocation>
+          placeholders;
+
+      /// \brief Usage of tracked textures, indexed by resource name
+      private: std::map<std::string, std::shared_ptr<Usage>> usages;
+
+      /// \brief Current frame
+      private: uint64_t frame = 0u;
+
+      /// \brief Texture memory budget in bytes, 0 for no budget
+      private: size_t memoryBudget = 0u;
+
+      /// \brief Estimated video memory of tracked textures in bytes
+      private: size_t residentMemory = 0u;
+
+      /// \brief Total size of evicted textures in bytes
+      private: size_t evictedMemory = 0u;
+
+      /// \brief Make the singleton class a friend
+      private: friend class common::SingletonT<Ogre2TextureStreamer>;
+    };
+    }
+  }
+}
+
+#endif
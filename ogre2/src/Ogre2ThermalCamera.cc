@@ -26,7 +26,10 @@
 #include <math.h>
 
 #include <algorithm>
+#include <iomanip>
 #include <limits>
+#include <memory>
+#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <variant>
@@ -44,6 +47,8 @@
 #include <ignition/common/Filesystem.hh>
 #include <ignition/math/Helpers.hh>
 
+#include "ignition/rendering/MemoryTracker.hh"
+#include "ignition/rendering/Profiler.hh"
 #include "ignition/rendering/RenderTypes.hh"
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
 #include "ignition/rendering/ogre2/Ogre2Includes.hh"
@@ -57,6 +62,10 @@
 #include "ignition/rendering/ogre2/Ogre2ThermalCamera.hh"
 #include "ignition/rendering/ogre2/Ogre2Visual.hh"
 
+#include "Ogre2GpuTimer.hh"
+#include "Ogre2ReadbackManager.hh"
+#include "Ogre2SharedDefinitions.hh"
+
 namespace ignition
 {
 namespace rendering
@@ -74,7 +83,7 @@ class Ogre2ThermalCameraMaterialSwitcher : public Ogre::RenderTargetListener
               const std::string & _name);
 
   /// \brief destructor
-  public: ~Ogre2ThermalCameraMaterialSwitcher() = default;
+  public: ~Ogre2ThermalCameraMaterialSwitcher();
 
   /// \brief Set image format
   /// \param[in] _format Image format
@@ -96,6 +105,96 @@ class Ogre2ThermalCameraMaterialSwitcher : public Ogre::RenderTargetListener
   private: virtual void postRenderTargetUpdate(
       const Ogre::RenderTargetEvent &_evt) override;
 
+  /// \brief How an item is rendered by the thermal camera
+  private: enum class ItemKind
+  {
+    /// \brief Item with a uniform temperature
+    HEAT_SOURCE,
+
+    /// \brief Item with a heat signature texture
+    HEAT_SIGNATURE,
+
+    /// \brief Item without temperature, its color is converted to a
+    /// temperature in the shaders
+    BACKGROUND
+  };
+
+  /// \brief Thermal properties of an item derived from the user data of
+  /// its visual. They are cached so the user data only needs to be decoded
+  /// when it changes.
+  private: struct ItemState
+  {
+    /// \brief Visual the item belongs to
+    std::weak_ptr<Ogre2Visual> visual;
+
+    /// \brief Id of the visual the item belongs to
+    unsigned int visualId = 0u;
+
+    /// \brief User data version of the visual when the state was updated
+    unsigned int userDataVersion = 0u;
+
+    /// \brief How the item is rendered
+    ItemKind kind = ItemKind::BACKGROUND;
+
+    /// \brief Normalized temperature of a heat source
+    float color = 0.0f;
+
+    /// \brief Material of a heat signature, shared by all the items of
+    /// the visual
+    Ogre::MaterialPtr heatSignatureMaterial;
+
+    /// \brief Material of the first geometry of a background item
+    MaterialPtr backgroundMaterial;
+
+    /// \brief Unlit datablock of backgroundMaterial
+    Ogre::HlmsUnlitDatablock *backgroundDatablock = nullptr;
+
+    /// \brief Value of traversal the last time the item was rendered
+    unsigned int traversal = 0u;
+  };
+
+  /// \brief Heat signature material of a visual
+  private: struct HeatSignature
+  {
+    /// \brief Visual the material was created for
+    std::weak_ptr<Ogre2Visual> visual;
+
+    /// \brief User data version of the visual when the material was
+    /// created
+    unsigned int userDataVersion = 0u;
+
+    /// \brief Heat signature material
+    Ogre::MaterialPtr material;
+  };
+
+  /// \brief Update the cached thermal properties of an item from the user
+  /// data of its visual
+  /// \param[in] _visualId Id of the visual the item belongs to
+  /// \param[in,out] _state State to update
+  /// \return The visual the item belongs to, null if not found
+  private: Ogre2VisualPtr UpdateItemState(unsigned int _visualId,
+      ItemState &_state);
+
+  /// \brief Get the heat signature material of a visual, creating it if
+  /// the visual has none or its user data changed since it was created
+  /// \param[in] _visual Visual to get the material of
+  /// \param[in] _texture Heat signature texture
+  /// \return Heat signature material
+  private: Ogre::MaterialPtr HeatSignatureMaterial(
+      const Ogre2VisualPtr &_visual, const std::string &_texture);
+
+  /// \brief Create the heat signature material of a visual
+  /// \param[in] _visual Visual to create the material for
+  /// \param[in] _texture Heat signature texture
+  /// \return Heat signature material
+  private: Ogre::MaterialPtr CreateHeatSignatureMaterial(
+      const Ogre2VisualPtr &_visual, const std::string &_texture);
+
+  /// \brief Remove a heat signature material from the material manager
+  /// \param[in] _material Material to remove
+  private: static void RemoveHeatSignatureMaterial(
+      const Ogre::MaterialPtr &_material);
+
   /// \brief Scene manager
   private: Ogre2ScenePtr scene = nullptr;
 
@@ -103,15 +202,14 @@ class Ogre2ThermalCameraMaterialSwitcher : public Ogre::RenderTargetListener
   private: Ogre::MaterialPtr heatSourceMaterial;
 
   /// \brief Pointer to the "base" heat signature material.
-  /// All renderable items with a heat signature texture use their own
-  /// copy of this base material, with the item's specific heat
+  /// All visuals with a heat signature texture use their own
+  /// copy of this base material, with the visual's specific heat
   /// signature texture applied to it
   private: Ogre::MaterialPtr baseHeatSigMaterial;
 
-  /// \brief A map of all items that have a heat signature material.
-  /// The key is the item's ID, and the value is the heat signature
-  /// for that item.
-  private: std::unordered_map<Ogre::IdType, Ogre::MaterialPtr>
+  /// \brief Heat signature materials of the visuals. The key is the
+  /// visual's ID.
+  private: std::unordered_map<unsigned int, HeatSignature>
             heatSignatureMaterials;
 
   /// \brief The name of the thermal camera sensor
@@ -129,6 +227,14 @@ class Ogre2ThermalCameraMaterialSwitcher : public Ogre::RenderTargetListener
   private: std::unordered_map<Ogre::SubItem *, Ogre::HlmsDatablock *>
       datablockMap;
 
+  /// \brief Cached thermal properties of all items rendered so far.
+  /// The key is the item's ID.
+  private: std::unordered_map<Ogre::IdType, ItemState> itemStates;
+
+  /// \brief Number of times the thermal camera has been rendered. Used to
+  /// find items that no longer exist
+  private: unsigned int traversal = 0u;
+
   /// \brief linear temperature resolution. Defaults to 10mK
   private: double resolution = 0.01;
 
@@ -159,6 +265,11 @@ class ignition::rendering::Ogre2ThermalCameraPrivate
   /// \brief minimum value used for data outside sensor range
   public: uint16_t dataMinVal = 0u;
 
+  /// \brief Name of the compositor definitions and material shared with
+  /// the thermal cameras of the same configuration, empty if they are not
+  /// created yet
+  public: std::string sharedDefinitions;
+
   /// \brief 1st pass compositor workspace definition
   public: std::string ogreCompositorWorkspaceDef;
 
@@ -182,10 +293,18 @@ class ignition::rendering::Ogre2ThermalCameraPrivate
               unsigned int, unsigned int, unsigned int,
               const std::string &)> newThermalFrame;
 
+  /// \brief Event used to signal thermal image data in the image format
+  public: ignition::common::EventT<void(const unsigned char *,
+              unsigned int, unsigned int, unsigned int,
+              const std::string &)> newRawThermalFrame;
+
   /// \brief Pointer to material switcher
   public: std::unique_ptr<Ogre2ThermalCameraMaterialSwitcher>
       thermalMaterialSwitcher = nullptr;
 
+  /// \brief Listener timing the compositor passes of the camera
+  public: std::unique_ptr<Ogre2GpuTimerListener> gpuTimerListener;
+
   /// \brief Add variation to temperature values based on object rgb values
   /// This only affects objects that are not heat sources
   /// TODO(anyone) add API for setting this value?
@@ -193,6 +312,10 @@ class ignition::rendering::Ogre2ThermalCameraPrivate
 
   /// \brief bit depth of each pixel
   public: unsigned int bitDepth = 16u;
+
+  /// \brief Id of this camera in the readback manager. Zero if
+  /// asynchronous readback is disabled
+  public: unsigned int readbackClient = 0u;
 };
 
 using namespace ignition;
@@ -217,6 +340,16 @@ Ogre2ThermalCameraMaterialSwitcher::Ogre2ThermalCameraMaterialSwitcher(
   this->ogreCamera = this->scene->OgreSceneManager()->findCamera(this->name);
 }
 
+//////////////////////////////////////////////////
+Ogre2ThermalCameraMaterialSwitcher::~Ogre2ThermalCameraMaterialSwitcher()
+{
+  for (auto &it : this->heatSignatureMaterials)
+  {
+    if (it.second.material)
+      RemoveHeatSignatureMaterial(it.second.material);
+  }
+}
+
 //////////////////////////////////////////////////
 void Ogre2ThermalCameraMaterialSwitcher::SetFormat(PixelFormat _format)
 {
@@ -229,6 +362,141 @@ void Ogre2ThermalCameraMaterialSwitcher::SetLinearResolution(double _resolution)
 {
   this->resolution = _resolution;
 }
+//////////////////////////////////////////////////
+Ogre2VisualPtr Ogre2ThermalCameraMaterialSwitcher::UpdateItemState(
+    unsigned int _visualId, ItemState &_state)
+{
+  Ogre2VisualPtr ogreVisual = this->scene->OgreVisualById(_visualId);
+  _state.visual = ogreVisual;
+  _state.visualId = _visualId;
+  _state.kind = ItemKind::BACKGROUND;
+  _state.heatSignatureMaterial.reset();
+  if (!ogreVisual)
+    return ogreVisual;
+  _state.userDataVersion = ogreVisual->UserDataVersion();
+
+  // get temperature
+  static const UserDataKey temperatureKey("temperature");
+  const Variant &tempAny = ogreVisual->UserData(temperatureKey);
+  const float *tempFloat = std::get_if<float>(&tempAny);
+  const double *tempDouble = std::get_if<double>(&tempAny);
+  if (tempFloat || tempDouble)
+  {
+    float temp = tempFloat ? *tempFloat : static_cast<float>(*tempDouble);
+
+    // if a non-positive temperature was given, clamp it to 0
+    if (temp < 0.0)
+    {
+      temp = 0.0;
+      ignwarn << "Unable to set negatve temperature for: "
+          << ogreVisual->Name() << ". Value cannot be lower than absolute "
+          << "zero. Clamping temperature to 0 degrees Kelvin."
+          << std::endl;
+    }
+
+    // normalize temperature value
+    _state.kind = ItemKind::HEAT_SOURCE;
+    _state.color = (temp / this->resolution) / ((1 << bitDepth) - 1.0);
+  }
+  // get heat signature and the corresponding min/max temperature values
+  else if (auto heatSignature = std::get_if<std::string>(&tempAny))
+  {
+    _state.heatSignatureMaterial =
+        this->HeatSignatureMaterial(ogreVisual, *heatSignature);
+    _state.kind = ItemKind::HEAT_SIGNATURE;
+  }
+  return ogreVisual;
+}
+
+//////////////////////////////////////////////////
+Ogre::MaterialPtr Ogre2ThermalCameraMaterialSwitcher::HeatSignatureMaterial(
+    const Ogre2VisualPtr &_visual, const std::string &_texture)
+{
+  // the items of a visual share its material. It is only created again if
+  // the user data of the visual changed since, e.g. the texture or the
+  // temperature range
+  auto inserted = this->heatSignatureMaterials.emplace(_visual->Id(),
+      HeatSignature());
+  HeatSignature &heatSignature = inserted.first->second;
+  if (!inserted.second && heatSignature.material &&
+      heatSignature.visual.lock() == _visual &&
+      heatSignature.userDataVersion == _visual->UserDataVersion())
+  {
+    return heatSignature.material;
+  }
+
+  if (heatSignature.material)
+    RemoveHeatSignatureMaterial(heatSignature.material);
+  heatSignature.visual = _visual;
+  heatSignature.userDataVersion = _visual->UserDataVersion();
+  heatSignature.material = this->CreateHeatSignatureMaterial(_visual,
+      _texture);
+  return heatSignature.material;
+}
+
+//////////////////////////////////////////////////
+Ogre::MaterialPtr
+    Ogre2ThermalCameraMaterialSwitcher::CreateHeatSignatureMaterial(
+    const Ogre2VisualPtr &_visual, const std::string &_texture)
+{
+  // make sure the texture is in ogre's resource path
+  auto engine = Ogre2RenderEngine::Instance();
+  engine->AddResourcePath(_texture);
+
+  // create a material for this visual, now that the texture has been
+  // searched for. We must clone the base heat signature material since
+  // different visuals may use different textures. We also append the
+  // visual's ID to the end of the new material name to ensure new
+  // material uniqueness in case two visuals use the same heat signature
+  // texture, but have different temperature ranges
+  std::string baseName = common::basename(_texture);
+  auto heatSignatureMaterial = this->baseHeatSigMaterial->clone(
+      this->name + "_" + baseName + "_" +
+      Ogre::StringConverter::toString(_visual->Id()));
+  auto textureUnitStatePtr = heatSignatureMaterial->
+    getTechnique(0)->getPass(0)->getTextureUnitState(0);
+  Ogre::String textureName = baseName;
+  textureUnitStatePtr->setTextureName(textureName);
+
+  // set temperature range for the heat signature
+  static const UserDataKey minTempKey("minTemp");
+  static const UserDataKey maxTempKey("maxTemp");
+  const Variant &minTempVariant = _visual->UserData(minTempKey);
+  const Variant &maxTempVariant = _visual->UserData(maxTempKey);
+  auto minTemperature = std::get_if<float>(&minTempVariant);
+  auto maxTemperature = std::get_if<float>(&maxTempVariant);
+  if (minTemperature && maxTemperature)
+  {
+    // make sure the temperature range is between [min, max] kelvin
+    // for the given pixel format and camera resolution
+    float maxTemp = ((1 << bitDepth) - 1.0) * this->resolution;
+    Ogre::GpuProgramParametersSharedPtr params =
+      heatSignatureMaterial->getTechnique(0)->getPass(0)->
+      getFragmentProgramParameters();
+    params->setNamedConstant("minTemp",
+        std::max(static_cast<float>(*minTemperature), 0.0f));
+    params->setNamedConstant("maxTemp",
+        std::min(static_cast<float>(*maxTemperature), maxTemp));
+    params->setNamedConstant("bitDepth",
+        static_cast<int>(this->bitDepth));
+    params->setNamedConstant("resolution",
+        static_cast<float>(this->resolution));
+  }
+  heatSignatureMaterial->load();
+  return heatSignatureMaterial;
+}
+
+//////////////////////////////////////////////////
+void Ogre2ThermalCameraMaterialSwitcher::RemoveHeatSignatureMaterial(
+    const Ogre::MaterialPtr &_material)
+{
+  // the material manager is gone if the engine was shut down first
+  Ogre::MaterialManager *materialManager =
+      Ogre::MaterialManager::getSingletonPtr();
+  if (materialManager)
+    materialManager->remove(_material->getHandle());
+}
+
 //////////////////////////////////////////////////
 void Ogre2ThermalCameraMaterialSwitcher::preRenderTargetUpdate(
     const Ogre::RenderTargetEvent & /*_evt*/)
@@ -237,186 +505,135 @@ void Ogre2ThermalCameraMaterialSwitcher::preRenderTargetUpdate(
   // Note: keep an eye out for performance impact on switching materials
   // on the fly. We are not doing this often so should be ok.
   this->datablockMap.clear();
+  ++this->traversal;
+  size_t itemCount = 0u;
   auto itor = this->scene->OgreSceneManager()->getMovableObjectIterator(
       Ogre::ItemFactory::FACTORY_TYPE_NAME);
   while (itor.hasMoreElements())
   {
     Ogre::MovableObject *object = itor.peekNext();
     Ogre::Item *item = static_cast<Ogre::Item *>(object);
+    itor.moveNext();
+    ++itemCount;
 
-    const std::string tempKey = "temperature";
     // get visual
     Ogre::Any userAny = item->getUserObjectBindings().getUserAny();
-    if (!userAny.isEmpty() && userAny.getType() == typeid(unsigned int))
+    if (userAny.isEmpty() || userAny.getType() != typeid(unsigned int))
+      continue;
+    unsigned int visualId = Ogre::any_cast<unsigned int>(userAny);
+
+    // only decode the visual's user data if the item is new, the item
+    // moved to another visual or the user data changed since last time
+    auto inserted = this->itemStates.emplace(item->getId(), ItemState());
+    ItemState &state = inserted.first->second;
+    state.traversal = this->traversal;
+    Ogre2VisualPtr ogreVisual = state.visual.lock();
+    if (inserted.second || !ogreVisual || state.visualId != visualId ||
+        state.userDataVersion != ogreVisual->UserDataVersion())
     {
-      VisualPtr result;
-      try
-      {
-        result = this->scene->VisualById(Ogre::any_cast<unsigned int>(userAny));
-      }
-      catch(Ogre::Exception &e)
-      {
-        ignerr << "Ogre Error:" << e.getFullDescription() << "\n";
-      }
-      Ogre2VisualPtr ogreVisual =
-          std::dynamic_pointer_cast<Ogre2Visual>(result);
+      ogreVisual = this->UpdateItemState(visualId, state);
+    }
+    if (!ogreVisual)
+      continue;
 
-      // get temperature
-      Variant tempAny = ogreVisual->UserData(tempKey);
-      if (tempAny.index() != 0 && !std::holds_alternative<std::string>(tempAny))
+    if (state.kind == ItemKind::HEAT_SOURCE)
+    {
+      for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
       {
-        float temp = -1.0;
-        bool foundTemp = true;
-        try
-        {
-          temp = std::get<float>(tempAny);
-        }
-        catch(...)
-        {
-          try
-          {
-            temp = std::get<double>(tempAny);
-          }
-          catch(...)
-          {
-            try
-            {
-              temp = std::get<int>(tempAny);
-            }
-            catch(std::bad_variant_access &e)
-            {
-              ignerr << "Error casting user data: " << e.what() << "\n";
-              temp = -1.0;
-              foundTemp = false;
-            }
-          }
-        }
+        Ogre::SubItem *subItem = item->getSubItem(i);
 
-        // if a non-positive temperature was given, clamp it to 0
-        if (foundTemp && temp < 0.0)
-        {
-          temp = 0.0;
-          ignwarn << "Unable to set negatve temperature for: "
-              << ogreVisual->Name() << ". Value cannot be lower than absolute "
-              << "zero. Clamping temperature to 0 degrees Kelvin."
-              << std::endl;
-        }
-        for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
-        {
-          Ogre::SubItem *subItem = item->getSubItem(i);
+        // set g, b, a to 0. This will be used by shaders to determine
+        // if particular fragment is a heat source or not
+        // see media/materials/programs/thermal_camera_fs.glsl
+        subItem->setCustomParameter(this->customParamIdx,
+            Ogre::Vector4(state.color, 0, 0, 0.0));
+        Ogre::HlmsDatablock *datablock = subItem->getDatablock();
+        this->datablockMap[subItem] = datablock;
 
-          // normalize temperature value
-          float color = (temp / this->resolution) / ((1 << bitDepth) - 1.0);
+        subItem->setMaterial(this->heatSourceMaterial);
+      }
+    }
+    else if (state.kind == ItemKind::HEAT_SIGNATURE)
+    {
+      const Ogre::MaterialPtr &heatSignatureMaterial =
+          state.heatSignatureMaterial;
+      for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
+      {
+        Ogre::SubItem *subItem = item->getSubItem(i);
 
-          // set g, b, a to 0. This will be used by shaders to determine
-          // if particular fragment is a heat source or not
-          // see media/materials/programs/thermal_camera_fs.glsl
-          subItem->setCustomParameter(this->customParamIdx,
-              Ogre::Vector4(color, 0, 0, 0.0));
-          Ogre::HlmsDatablock *datablock = subItem->getDatablock();
-          this->datablockMap[subItem] = datablock;
+        Ogre::HlmsDatablock *datablock = subItem->getDatablock();
+        this->datablockMap[subItem] = datablock;
 
-          subItem->setMaterial(this->heatSourceMaterial);
-        }
+        subItem->setMaterial(heatSignatureMaterial);
       }
-      // get heat signature and the corresponding min/max temperature values
-      else if (auto heatSignature = std::get_if<std::string>(&tempAny))
+    }
+    // background objects
+    else
+    {
+      Ogre::Aabb aabb = item->getWorldAabbUpdated();
+      Ogre::AxisAlignedBox box = Ogre::AxisAlignedBox(aabb.getMinimum(),
+          aabb.getMaximum());
+
+      // we will be converting rgb values to temperature values in shaders
+      // but we want to make sure the object rgb values are not affected by
+      // lighting, so disable lighting
+      // Also check if objects are within camera view
+      if (ogreVisual->GeometryCount() > 0u &&
+          this->ogreCamera->isVisible(box))
       {
-        // if this is the first time rendering the heat signature,
-        // we need to make sure that the texture is loaded and applied to
-        // the heat signature material before loading the material
-        if (this->heatSignatureMaterials.find(item->getId()) ==
-            this->heatSignatureMaterials.end())
+        auto geom = ogreVisual->GeometryByIndex(0);
+        MaterialPtr mat = geom ? geom->Material() : nullptr;
+
+        // only cast the material again if the geometry switched to another
+        // one. Material is a virtual base, so the cast can not be static.
+        if (mat != state.backgroundMaterial)
         {
-          // make sure the texture is in ogre's resource path
-          const auto &texture = *heatSignature;
-          auto engine = Ogre2RenderEngine::Instance();
-          engine->AddResourcePath(texture);
-
-          // create a material for this item, now that the texture has been
-          // searched for. We must clone the base heat signature material since
-          // different items may use different textures. We also append the
-          // item's ID to the end of the new material name to ensure new
-          // material uniqueness in case two items use the same heat signature
-          // texture, but have different temperature ranges
-          std::string baseName = common::basename(texture);
-          auto heatSignatureMaterial = this->baseHeatSigMaterial->clone(
-              this->name + "_" + baseName + "_" +
-              Ogre::StringConverter::toString(item->getId()));
-          auto textureUnitStatePtr = heatSignatureMaterial->
-            getTechnique(0)->getPass(0)->getTextureUnitState(0);
-          Ogre::String textureName = baseName;
-          textureUnitStatePtr->setTextureName(textureName);
-
-          // set temperature range for the heat signature
-          auto minTempVariant = ogreVisual->UserData("minTemp");
-          auto maxTempVariant = ogreVisual->UserData("maxTemp");
-          auto minTemperature = std::get_if<float>(&minTempVariant);
-          auto maxTemperature = std::get_if<float>(&maxTempVariant);
-          if (minTemperature && maxTemperature)
+          Ogre2Material *ogreMat = dynamic_cast<Ogre2Material *>(mat.get());
+          state.backgroundMaterial = mat;
+          state.backgroundDatablock =
+              ogreMat ? ogreMat->UnlitDatablock() : nullptr;
+        }
+        Ogre::HlmsUnlitDatablock *unlit = state.backgroundDatablock;
+        if (unlit)
+        {
+          for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
           {
-            // make sure the temperature range is between [min, max] kelvin
-            // for the given pixel format and camera resolution
-            float maxTemp = ((1 << bitDepth) - 1.0) * this->resolution;
-            Ogre::GpuProgramParametersSharedPtr params =
-              heatSignatureMaterial->getTechnique(0)->getPass(0)->
-              getFragmentProgramParameters();
-            params->setNamedConstant("minTemp",
-                std::max(static_cast<float>(*minTemperature), 0.0f));
-            params->setNamedConstant("maxTemp",
-                std::min(static_cast<float>(*maxTemperature), maxTemp));
-            params->setNamedConstant("bitDepth",
-                static_cast<int>(this->bitDepth));
-            params->setNamedConstant("resolution",
-                static_cast<float>(this->resolution));
+            Ogre::SubItem *subItem = item->getSubItem(i);
+            Ogre::HlmsDatablock *datablock = subItem->getDatablock();
+            this->datablockMap[subItem] = datablock;
+            subItem->setDatablock(unlit);
           }
-          heatSignatureMaterial->load();
-          this->heatSignatureMaterials[item->getId()] = heatSignatureMaterial;
         }
+      }
+    }
+  }
 
-        for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
-        {
-          Ogre::SubItem *subItem = item->getSubItem(i);
-
-          Ogre::HlmsDatablock *datablock = subItem->getDatablock();
-          this->datablockMap[subItem] = datablock;
+  // drop the state of items that have been destroyed
+  if (itemCount < this->itemStates.size())
+  {
+    for (auto it = this->itemStates.begin(); it != this->itemStates.end();)
+    {
+      if (it->second.traversal != this->traversal)
+        it = this->itemStates.erase(it);
+      else
+        ++it;
+    }
 
-          subItem->setMaterial(this->heatSignatureMaterials[item->getId()]);
-        }
+    // and the heat signature materials of visuals that have been destroyed
+    for (auto it = this->heatSignatureMaterials.begin();
+        it != this->heatSignatureMaterials.end();)
+    {
+      if (it->second.visual.expired())
+      {
+        if (it->second.material)
+          RemoveHeatSignatureMaterial(it->second.material);
+        it = this->heatSignatureMaterials.erase(it);
       }
-      // background objects
       else
       {
-        Ogre::Aabb aabb = item->getWorldAabbUpdated();
-        Ogre::AxisAlignedBox box = Ogre::AxisAlignedBox(aabb.getMinimum(),
-            aabb.getMaximum());
-
-        // we will be converting rgb values to temperature values in shaders
-        // but we want to make sure the object rgb values are not affected by
-        // lighting, so disable lighting
-        // Also check if objects are within camera view
-        if (ogreVisual->GeometryCount() > 0u &&
-            this->ogreCamera->isVisible(box))
-        {
-          auto geom = ogreVisual->GeometryByIndex(0);
-          if (geom)
-          {
-            MaterialPtr mat = geom->Material();
-            Ogre2MaterialPtr ogreMat =
-                std::dynamic_pointer_cast<Ogre2Material>(mat);
-            Ogre::HlmsUnlitDatablock *unlit = ogreMat->UnlitDatablock();
-            for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
-            {
-              Ogre::SubItem *subItem = item->getSubItem(i);
-              Ogre::HlmsDatablock *datablock = subItem->getDatablock();
-              this->datablockMap[subItem] = datablock;
-              subItem->setDatablock(unlit);
-            }
-          }
-        }
+        ++it;
       }
     }
-    itor.moveNext();
   }
 }
 
@@ -462,14 +679,21 @@ void Ogre2ThermalCamera::Init()
 //////////////////////////////////////////////////
 void Ogre2ThermalCamera::Destroy()
 {
+  // the queued frames refer to the events of this sensor
+  this->FlushFrames();
+
+  this->SetAsyncReadback(false);
+
   if (this->dataPtr->thermalBuffer)
   {
+    MemoryTracker::Untrack(this->dataPtr->thermalBuffer);
     delete [] this->dataPtr->thermalBuffer;
     this->dataPtr->thermalBuffer = nullptr;
   }
 
   if (this->dataPtr->thermalImage)
   {
+    MemoryTracker::Untrack(this->dataPtr->thermalImage);
     delete [] this->dataPtr->thermalImage;
     this->dataPtr->thermalImage = nullptr;
   }
@@ -493,19 +717,23 @@ void Ogre2ThermalCamera::Destroy()
         this->dataPtr->ogreCompositorWorkspace);
   }
 
-  if (this->dataPtr->thermalMaterial)
-  {
-    Ogre::MaterialManager::getSingleton().remove(
-        this->dataPtr->thermalMaterial->getName());
-  }
-
-  if (!this->dataPtr->ogreCompositorWorkspaceDef.empty())
+  // the definitions and the material are removed with the last thermal
+  // camera sharing them
+  if (!this->dataPtr->sharedDefinitions.empty() &&
+      Ogre2SharedDefinitions::Instance()->Release(
+      this->dataPtr->sharedDefinitions))
   {
+    if (this->dataPtr->thermalMaterial)
+    {
+      Ogre::MaterialManager::getSingleton().remove(
+          this->dataPtr->thermalMaterial->getName());
+    }
     ogreCompMgr->removeWorkspaceDefinition(
         this->dataPtr->ogreCompositorWorkspaceDef);
     ogreCompMgr->removeNodeDefinition(
         this->dataPtr->ogreCompositorNodeDef);
   }
+  this->dataPtr->sharedDefinitions.clear();
 
   Ogre::SceneManager *ogreSceneManager;
   ogreSceneManager = this->scene->OgreSceneManager();
@@ -575,20 +803,6 @@ void Ogre2ThermalCamera::CreateThermalTexture()
   this->ogreCamera->setAspectRatio(this->aspect);
   this->ogreCamera->setFOVy(Ogre::Radian(vfov));
 
-  // Load thermal material
-  // The ThermalCamera material is defined in script (thermal_camera.material).
-  // We need to clone it since we are going to modify its uniform variables
-  std::string matThermalName = "ThermalCamera";
-  Ogre::MaterialPtr matThermal =
-      Ogre::MaterialManager::getSingleton().getByName(matThermalName);
-  this->dataPtr->thermalMaterial = matThermal->clone(
-      this->Name() + "_" + matThermalName);
-  this->dataPtr->thermalMaterial->load();
-  Ogre::Pass *pass =
-      this->dataPtr->thermalMaterial->getTechnique(0)->getPass(0);
-  Ogre::GpuProgramParametersSharedPtr psParams =
-      pass->getFragmentProgramParameters();
-
   // Configure camera behaviour.
   double nearPlane = this->NearClipPlane();
   double farPlane = this->FarClipPlane();
@@ -611,6 +825,41 @@ void Ogre2ThermalCamera::CreateThermalTexture()
   PixelFormat format = this->ImageFormat();
   this->dataPtr->bitDepth = 8u * PixelUtil::BytesPerChannel(format);
 
+  // Thermal cameras with the same configuration share the compositor
+  // definitions and the material, only the texture and the workspace are
+  // created per camera.
+  std::ostringstream config;
+  config << std::setprecision(17) << nearPlane << " " << farPlane << " "
+         << this->maxTemp << " " << this->minTemp << " " << this->resolution
+         << " " << this->ambient << " " << this->ambientRange << " "
+         << this->heatSourceTempRange << " " << this->dataPtr->rgbToTemp
+         << " " << this->dataPtr->bitDepth << " " << ogrePF;
+  bool created = false;
+  this->dataPtr->sharedDefinitions = Ogre2SharedDefinitions::Instance()->
+      Acquire("ThermalCameraWorkspace", config.str(), created);
+
+  // Load thermal material
+  // The ThermalCamera material is defined in script (thermal_camera.material).
+  // We need to clone it since we are going to modify its uniform variables
+  std::string matThermalName = "ThermalCamera";
+  std::string thermalMaterialName =
+      this->dataPtr->sharedDefinitions + "_" + matThermalName;
+  Ogre::MaterialManager &matManager = Ogre::MaterialManager::getSingleton();
+  if (created)
+  {
+    Ogre::MaterialPtr matThermal = matManager.getByName(matThermalName);
+    this->dataPtr->thermalMaterial = matThermal->clone(thermalMaterialName);
+  }
+  else
+  {
+    this->dataPtr->thermalMaterial = matManager.getByName(thermalMaterialName);
+  }
+  this->dataPtr->thermalMaterial->load();
+  Ogre::Pass *pass =
+      this->dataPtr->thermalMaterial->getTechnique(0)->getPass(0);
+  Ogre::GpuProgramParametersSharedPtr psParams =
+      pass->getFragmentProgramParameters();
+
   // Set the uniform variables (thermal_camera_fs.glsl).
   // The projectParams is used to linearize thermal buffer data
   // The other params are used to clamp the range output
@@ -684,12 +933,12 @@ void Ogre2ThermalCamera::CreateThermalTexture()
   //   }
   //   out 0 rt_input
   // }
-  std::string wsDefName = "ThermalCameraWorkspace_" + this->Name();
+  std::string wsDefName = this->dataPtr->sharedDefinitions;
+  std::string nodeDefName = wsDefName + "/Node";
   this->dataPtr->ogreCompositorWorkspaceDef = wsDefName;
+  this->dataPtr->ogreCompositorNodeDef = nodeDefName;
   if (!ogreCompMgr->hasWorkspaceDefinition(wsDefName))
   {
-    std::string nodeDefName = wsDefName + "/Node";
-    this->dataPtr->ogreCompositorNodeDef = nodeDefName;
     Ogre::CompositorNodeDef *nodeDef =
         ogreCompMgr->addNodeDefinition(nodeDefName);
     // Input texture
@@ -803,6 +1052,14 @@ void Ogre2ThermalCamera::CreateThermalTexture()
       ogreCompMgr->addWorkspace(this->scene->OgreSceneManager(),
       rt, this->ogreCamera, wsDefName, false);
 
+  if (!this->dataPtr->gpuTimerListener)
+  {
+    this->dataPtr->gpuTimerListener.reset(new Ogre2GpuTimerListener(
+        this->gpuTimerClient, "thermal"));
+  }
+  this->dataPtr->ogreCompositorWorkspace->setListener(
+      this->dataPtr->gpuTimerListener.get());
+
   // add thermal material swticher to render target listener
   // so we can switch to use heat material when the camera is being udpated
   Ogre::CompositorNode *node =
@@ -826,25 +1083,50 @@ void Ogre2ThermalCamera::CreateThermalTexture()
 //////////////////////////////////////////////////
 void Ogre2ThermalCamera::Render()
 {
-  // update the compositors
-  this->dataPtr->ogreCompositorWorkspace->setEnabled(true);
+  IGN_RENDERING_PROFILE("Ogre2ThermalCamera::Render");
+  this->BeginFrameStats();
+  this->scene->AddParticleViewer(this->ogreCamera);
+
   auto engine = Ogre2RenderEngine::Instance();
-  engine->OgreRoot()->renderOneFrame();
-  this->dataPtr->ogreCompositorWorkspace->setEnabled(false);
+  if (engine->RenderBatchActive())
+  {
+    engine->AddToRenderBatch(this->shared_from_this(),
+        this->dataPtr->ogreCompositorWorkspace);
+    return;
+  }
+
+  // update the compositors
+  engine->RenderWorkspaces({this->dataPtr->ogreCompositorWorkspace});
 }
 
 //////////////////////////////////////////////////
 void Ogre2ThermalCamera::PreRender()
 {
+  IGN_RENDERING_PROFILE("Ogre2ThermalCamera::PreRender");
   if (!this->dataPtr->ogreThermalTexture)
     this->CreateThermalTexture();
+
+  this->ogreCamera->setLodBias(this->RenderLodBias());
 }
 
 //////////////////////////////////////////////////
 void Ogre2ThermalCamera::PostRender()
 {
-  if (this->dataPtr->newThermalFrame.ConnectionCount() <= 0u)
+  IGN_RENDERING_PROFILE("Ogre2ThermalCamera::PostRender");
+  // data is read back once the render batch has been rendered
+  auto engine = Ogre2RenderEngine::Instance();
+  if (engine->RenderBatchActive())
+  {
+    engine->DeferPostRender(this->shared_from_this());
     return;
+  }
+
+  if (this->dataPtr->newThermalFrame.ConnectionCount() <= 0u &&
+      this->dataPtr->newRawThermalFrame.ConnectionCount() <= 0u &&
+      this->newSensorFrame.ConnectionCount() <= 0u)
+  {
+    return;
+  }
 
   unsigned int width = this->ImageWidth();
   unsigned int height = this->ImageHeight();
@@ -859,34 +1141,63 @@ void Ogre2ThermalCamera::PostRender()
   {
     this->dataPtr->thermalBuffer =
         new unsigned char[len * channelCount * bytesPerChannel];
+    MemoryTracker::Track(MC_SENSOR_BUFFER, this->dataPtr->thermalBuffer,
+        len * channelCount * bytesPerChannel);
   }
   Ogre::PixelBox dstBox(width, height,
         1, imageFormat, this->dataPtr->thermalBuffer);
 
-  // blit data from gpu to cpu
-  auto rt = this->dataPtr->ogreThermalTexture->getBuffer()->getRenderTarget();
-  rt->copyContentsToMemory(dstBox, Ogre::RenderTarget::FB_FRONT);
+  auto readback = Ogre2ReadbackManager::Instance();
+  if (this->dataPtr->readbackClient)
+  {
+    // queue a copy of the frame that has just been rendered and retrieve a
+    // previous one so the transfer overlaps with the next render
+    if (!readback->Request(this->dataPtr->readbackClient,
+        this->dataPtr->ogreThermalTexture.get(), imageFormat))
+    {
+      ignwarn << "Asynchronous readback failed for thermal camera ["
+              << this->Name() << "], falling back to blocking readback"
+              << std::endl;
+      this->SetAsyncReadback(false);
+    }
+    else if (!readback->Retrieve(this->dataPtr->readbackClient,
+        this->dataPtr->thermalBuffer,
+        len * channelCount * bytesPerChannel))
+    {
+      // no frame available yet
+      return;
+    }
+  }
+
+  if (!this->dataPtr->readbackClient)
+  {
+    readback->Read(
+        this->dataPtr->ogreThermalTexture->getBuffer()->getRenderTarget(),
+        dstBox);
+  }
+  this->AddReadbackBytes(dstBox.getConsecutiveSize());
+
+  // subscribers to raw frames get the readback data as is
+  this->DispatchFrame(this->dataPtr->newRawThermalFrame,
+      this->dataPtr->thermalBuffer, len * channelCount * bytesPerChannel,
+      width, height, 1, PixelUtil::Name(format));
+
+  if (this->dataPtr->newThermalFrame.ConnectionCount() <= 0u)
+    return;
 
   if (!this->dataPtr->thermalImage)
   {
     this->dataPtr->thermalImage = new uint16_t[len];
+    MemoryTracker::Track(MC_SENSOR_BUFFER, this->dataPtr->thermalImage,
+        len * sizeof(uint16_t));
   }
 
   if (format == PF_L8)
   {
-    // workaround for populating a 16bit image buffer with 8bit data
-    // \todo(anyone) add a new ConnectNewThermalFrame function that accepts
-    // a generic unsigned char array instead of uint16_t so we can do a direct
-    // memcpy of the data
-    for (unsigned int i = 0u; i < height; ++i)
-    {
-      for (unsigned int j = 0u; j < width; ++j)
-      {
-        unsigned int idx = (i * width) + j;
-        this->dataPtr->thermalImage[idx] = static_cast<uint16_t>(
-            this->dataPtr->thermalBuffer[idx]);
-      }
-    }
+    // populate the 16bit image buffer with 8bit data. Subscribers of
+    // ConnectNewRawThermalFrame skip this conversion
+    PixelUtil::Convert(this->dataPtr->thermalBuffer, PF_L8,
+        this->dataPtr->thermalImage, PF_L16, len);
   }
   else
   {
@@ -895,9 +1206,10 @@ void Ogre2ThermalCamera::PostRender()
         height * width * channelCount * bytesPerChannel);
   }
 
-  this->dataPtr->newThermalFrame(
-      this->dataPtr->thermalImage, width, height, 1,
-      PixelUtil::Name(format));
+  // sensor frame subscribers already got the data as read back
+  this->DispatchFrame(this->dataPtr->newThermalFrame,
+      this->dataPtr->thermalImage, len, width, height, 1,
+      PixelUtil::Name(format), false);
 
   // Uncomment to debug thermal output
   // std::cout << "wxh: " << width << " x " << height << std::endl;
@@ -911,6 +1223,35 @@ void Ogre2ThermalCamera::PostRender()
   // }
 }
 
+//////////////////////////////////////////////////
+void Ogre2ThermalCamera::SetAsyncReadback(bool _enabled)
+{
+  auto readback = Ogre2ReadbackManager::Instance();
+  if (!_enabled)
+  {
+    readback->DestroyClient(this->dataPtr->readbackClient);
+    this->dataPtr->readbackClient = 0u;
+    return;
+  }
+
+  if (this->dataPtr->readbackClient)
+    return;
+
+  this->dataPtr->readbackClient = readback->CreateClient();
+  if (!this->dataPtr->readbackClient)
+  {
+    ignwarn << "Asynchronous readback is not supported by the current "
+            << "render system. Thermal camera [" << this->Name() << "] will "
+            << "use blocking readback" << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+bool Ogre2ThermalCamera::AsyncReadback() const
+{
+  return this->dataPtr->readbackClient != 0u;
+}
+
 //////////////////////////////////////////////////
 common::ConnectionPtr Ogre2ThermalCamera::ConnectNewThermalFrame(
     std::function<void(const uint16_t *, unsigned int, unsigned int,
@@ -919,6 +1260,14 @@ common::ConnectionPtr Ogre2ThermalCamera::ConnectNewThermalFrame(
   return this->dataPtr->newThermalFrame.Connect(_subscriber);
 }
 
+//////////////////////////////////////////////////
+common::ConnectionPtr Ogre2ThermalCamera::ConnectNewRawThermalFrame(
+    std::function<void(const unsigned char *, unsigned int, unsigned int,
+      unsigned int, const std::string &)>  _subscriber)
+{
+  return this->dataPtr->newRawThermalFrame.Connect(_subscriber);
+}
+
 //////////////////////////////////////////////////
 RenderTargetPtr Ogre2ThermalCamera::RenderTarget() const
 {
@@ -15,12 +15,17 @@
  *
  */
 
+#include <map>
+#include <utility>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
 #include "ignition/rendering/ogre2/Ogre2Geometry.hh"
 #include "ignition/rendering/ogre2/Ogre2ParticleEmitter.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderTypes.hh"
+#include "ignition/rendering/ogre2/Ogre2Scene.hh"
 #include "ignition/rendering/ogre2/Ogre2Storage.hh"
 #include "ignition/rendering/ogre2/Ogre2Visual.hh"
 #include "ignition/rendering/ogre2/Ogre2WireBox.hh"
@@ -32,6 +37,21 @@ using namespace rendering;
 /// \brief Private data for the Ogre2Visual class
 class ignition::rendering::Ogre2VisualPrivate
 {
+  /// \brief Cached bounding box in the world frame
+  public: math::AxisAlignedBox worldBounds;
+
+  /// \brief Cached bounding box in the frame of the visual
+  public: math::AxisAlignedBox localBounds;
+
+  /// \brief True if the cached world bounding box is stale
+  public: bool worldBoundsDirty = true;
+
+  /// \brief True if the cached local bounding box is stale
+  public: bool localBoundsDirty = true;
+
+  /// \brief Child nodes translating the ogre objects of geometries with
+  /// an offset, indexed by ogre object
+  public: std::map<Ogre::MovableObject *, Ogre::SceneNode *> offsetNodes;
 };
 
 //////////////////////////////////////////////////
@@ -49,6 +69,8 @@ Ogre2Visual::~Ogre2Visual()
 void Ogre2Visual::SetVisible(bool _visible)
 {
   this->ogreNode->setVisible(_visible);
+  this->SetStaticShadowsDirty();
+  this->SetBoundsDirty();
 }
 
 //////////////////////////////////////////////////
@@ -64,6 +86,54 @@ void Ogre2Visual::SetVisibilityFlags(uint32_t _flags)
     this->ogreNode->getAttachedObject(i)->setVisibilityFlags(_flags
       & ~Ogre2ParticleEmitter::kParticleVisibilityFlags);
   }
+  for (auto &offsetNode : this->dataPtr->offsetNodes)
+  {
+    offsetNode.first->setVisibilityFlags(_flags
+      & ~Ogre2ParticleEmitter::kParticleVisibilityFlags);
+  }
+
+  // gui objects are left out of the bounding boxes
+  this->SetBoundsDirty();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Visual::SetStatic(bool _static)
+{
+  if (_static == this->isStatic)
+    return;
+
+  BaseVisual::SetStatic(_static);
+  this->scene->SetStaticShadowsDirty();
+
+  // the transforms and bounds of static nodes and of their objects are
+  // only updated by the scene manager when they are flagged dirty
+  if (!this->ogreNode)
+    return;
+  if (_static)
+  {
+    this->ogreNode->setStatic(true);
+    for (auto &offsetNode : this->dataPtr->offsetNodes)
+      offsetNode.second->setStatic(true);
+    this->SetStaticNodeDirty();
+  }
+  else
+  {
+    for (auto &offsetNode : this->dataPtr->offsetNodes)
+      offsetNode.second->setStatic(false);
+    this->ogreNode->setStatic(false);
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2Visual::Destroy()
+{
+  this->SetStaticShadowsDirty();
+
+  // drop the visual from the spatial index of the scene
+  if (this->scene)
+    this->scene->SetVisualBoundsDirty(this->Id());
+
+  BaseVisual::Destroy();
 }
 
 //////////////////////////////////////////////////
@@ -108,7 +178,24 @@ bool Ogre2Visual::AttachGeometry(GeometryPtr _geometry)
       & ~Ogre2ParticleEmitter::kParticleVisibilityFlags);
 
   derived->SetParent(this->SharedThis());
-  this->ogreNode->attachObject(ogreObj);
+  // objects must be in the same memory mode as the node they attach to
+  ogreObj->setStatic(this->isStatic);
+  math::Vector3d offset = derived->OgreObjectOffset();
+  if (offset == math::Vector3d::Zero)
+  {
+    this->ogreNode->attachObject(ogreObj);
+  }
+  else
+  {
+    Ogre::SceneNode *offsetNode = this->ogreNode->createChildSceneNode(
+        this->isStatic ? Ogre::SCENE_STATIC : Ogre::SCENE_DYNAMIC);
+    offsetNode->setPosition(Ogre2Conversions::Convert(offset));
+    offsetNode->attachObject(ogreObj);
+    this->dataPtr->offsetNodes[ogreObj] = offsetNode;
+  }
+  this->SetStaticShadowsDirty();
+  this->SetStaticNodeDirty();
+  this->SetBoundsDirty();
 
   return true;
 }
@@ -127,25 +214,110 @@ bool Ogre2Visual::DetachGeometry(GeometryPtr _geometry)
     return false;
   }
 
-  this->ogreNode->detachObject(derived->OgreObject());
+  Ogre::MovableObject *ogreObj = derived->OgreObject();
+  auto offsetNode = this->dataPtr->offsetNodes.find(ogreObj);
+  if (offsetNode != this->dataPtr->offsetNodes.end())
+  {
+    offsetNode->second->detachObject(ogreObj);
+    this->scene->OgreSceneManager()->destroySceneNode(offsetNode->second);
+    this->dataPtr->offsetNodes.erase(offsetNode);
+  }
+  else
+  {
+    this->ogreNode->detachObject(ogreObj);
+  }
+  ogreObj->setStatic(false);
   derived->SetParent(nullptr);
+  this->SetStaticShadowsDirty();
+  this->SetStaticNodeDirty();
+  this->SetBoundsDirty();
   return true;
 }
 
 //////////////////////////////////////////////////
 ignition::math::AxisAlignedBox Ogre2Visual::LocalBoundingBox() const
 {
-  ignition::math::AxisAlignedBox box;
-  this->BoundsHelper(box, true /* local frame */);
-  return box;
+  if (this->dataPtr->localBoundsDirty)
+  {
+    ignition::math::AxisAlignedBox box;
+    this->BoundsHelper(box, true /* local frame */);
+    this->dataPtr->localBounds = box;
+    this->dataPtr->localBoundsDirty = false;
+  }
+  return this->dataPtr->localBounds;
 }
 
 //////////////////////////////////////////////////
 ignition::math::AxisAlignedBox Ogre2Visual::BoundingBox() const
 {
-  ignition::math::AxisAlignedBox box;
-  this->BoundsHelper(box, false /* world frame */);
-  return box;
+  if (this->dataPtr->worldBoundsDirty)
+  {
+    ignition::math::AxisAlignedBox box;
+    this->BoundsHelper(box, false /* world frame */);
+    this->dataPtr->worldBounds = box;
+    this->dataPtr->worldBoundsDirty = false;
+  }
+  return this->dataPtr->worldBounds;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Visual::SetBoundsDirty()
+{
+  this->SetSubtreeBoundsDirty(true);
+  this->SetAncestorBoundsDirty();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Visual::SetSubtreeBoundsDirty(bool _local)
+{
+  this->SetWorldBoundsDirty();
+  if (_local)
+    this->dataPtr->localBoundsDirty = true;
+
+  auto childNodes = std::dynamic_pointer_cast<Ogre2NodeStore>(this->Children());
+  if (!childNodes)
+    return;
+
+  for (auto it = childNodes->Begin(); it != childNodes->End(); ++it)
+  {
+    Ogre2VisualPtr visual = std::dynamic_pointer_cast<Ogre2Visual>(it->second);
+    if (visual)
+      visual->SetSubtreeBoundsDirty(_local);
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2Visual::SetAncestorBoundsDirty()
+{
+  // a clean ancestor may have dirty descendants, so the whole chain is
+  // walked
+  for (NodePtr node = this->Parent(); node; node = node->Parent())
+  {
+    Ogre2VisualPtr visual = std::dynamic_pointer_cast<Ogre2Visual>(node);
+    if (visual)
+    {
+      visual->SetWorldBoundsDirty();
+      visual->dataPtr->localBoundsDirty = true;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2Visual::SetWorldBoundsDirty()
+{
+  // the spatial index of the scene queries the bounding box again, which
+  // cleans the flag, so it only needs to know when the flag is first set
+  if (!this->dataPtr->worldBoundsDirty && this->scene)
+    this->scene->SetVisualBoundsDirty(this->Id());
+  this->dataPtr->worldBoundsDirty = true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Visual::SetPoseBoundsDirty()
+{
+  // the local boxes of the subtree are relative to the moved visual
+  this->SetSubtreeBoundsDirty(false);
+  this->SetAncestorBoundsDirty();
 }
 
 //////////////////////////////////////////////////
@@ -161,9 +333,22 @@ void Ogre2Visual::BoundsHelper(ignition::math::AxisAlignedBox &_box,
 {
   ignition::math::Vector3d scale = this->WorldScale();
 
+  // objects attached to the node of the visual and to its offset nodes
+  std::vector<std::pair<Ogre::MovableObject *, Ogre::Vector3>> objects;
   for (size_t i = 0; i < this->ogreNode->numAttachedObjects(); i++)
   {
-    Ogre::MovableObject *obj = this->ogreNode->getAttachedObject(i);
+    objects.emplace_back(this->ogreNode->getAttachedObject(i),
+        Ogre::Vector3::ZERO);
+  }
+  for (const auto &offsetNode : this->dataPtr->offsetNodes)
+  {
+    objects.emplace_back(offsetNode.first,
+        offsetNode.second->getPosition());
+  }
+
+  for (const auto &object : objects)
+  {
+    Ogre::MovableObject *obj = object.first;
 
     if (obj->isVisible() && obj->getVisibilityFlags() != IGN_VISIBILITY_GUI)
     {
@@ -181,8 +366,8 @@ void Ogre2Visual::BoundsHelper(ignition::math::AxisAlignedBox &_box,
       }
       else
       {
-        Ogre::Vector3 ogreMin = bb.getMinimum();
-        Ogre::Vector3 ogreMax = bb.getMaximum();
+        Ogre::Vector3 ogreMin = bb.getMinimum() + object.second;
+        Ogre::Vector3 ogreMax = bb.getMaximum() + object.second;
 
         // Get ogre bounding boxes and size to object's scale
         min = scale * ignition::math::Vector3d(ogreMin.x, ogreMin.y, ogreMin.z);
@@ -233,6 +418,93 @@ void Ogre2Visual::Init()
   this->geometries = Ogre2GeometryStorePtr(new Ogre2GeometryStore);
 }
 
+//////////////////////////////////////////////////
+void Ogre2Visual::SetRawLocalPosition(const math::Vector3d &_position)
+{
+  Ogre2Node::SetRawLocalPosition(_position);
+  this->SetStaticShadowsDirty();
+  this->SetStaticNodeDirty();
+  this->SetPoseBoundsDirty();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Visual::SetRawLocalRotation(const math::Quaterniond &_rotation)
+{
+  Ogre2Node::SetRawLocalRotation(_rotation);
+  this->SetStaticShadowsDirty();
+  this->SetStaticNodeDirty();
+  this->SetPoseBoundsDirty();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Visual::SetLocalScaleImpl(const math::Vector3d &_scale)
+{
+  Ogre2Node::SetLocalScaleImpl(_scale);
+  this->SetStaticNodeDirty();
+  this->SetBoundsDirty();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Visual::SetInheritScale(bool _inherit)
+{
+  Ogre2Node::SetInheritScale(_inherit);
+  this->SetStaticNodeDirty();
+  this->SetBoundsDirty();
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Visual::AttachChild(NodePtr _child)
+{
+  if (!Ogre2Node::AttachChild(_child))
+    return false;
+
+  // the child is now in the frame of this visual
+  Ogre2VisualPtr visual = std::dynamic_pointer_cast<Ogre2Visual>(_child);
+  if (visual)
+  {
+    visual->SetSubtreeBoundsDirty(true);
+    visual->SetStaticNodeDirty();
+  }
+  this->SetBoundsDirty();
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Visual::DetachChild(NodePtr _child)
+{
+  if (!Ogre2Node::DetachChild(_child))
+    return false;
+
+  Ogre2VisualPtr visual = std::dynamic_pointer_cast<Ogre2Visual>(_child);
+  if (visual)
+    visual->SetSubtreeBoundsDirty(true);
+  this->SetBoundsDirty();
+  return true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Visual::SetStaticShadowsDirty()
+{
+  if (this->isStatic && this->scene)
+    this->scene->SetStaticShadowsDirty();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Visual::SetStaticNodeDirty()
+{
+  if (!this->isStatic || !this->ogreNode || !this->scene)
+    return;
+
+  // the static nodes from this depth level down are updated in the next
+  // frame, together with the bounds of the objects attached to this node
+  Ogre::SceneManager *sceneManager = this->scene->OgreSceneManager();
+  sceneManager->notifyStaticDirty(this->ogreNode);
+  for (unsigned int i = 0; i < this->ogreNode->numAttachedObjects(); ++i)
+    sceneManager->notifyStaticAabbDirty(this->ogreNode->getAttachedObject(i));
+  for (auto &offsetNode : this->dataPtr->offsetNodes)
+    sceneManager->notifyStaticAabbDirty(offsetNode.first);
+}
+
 //////////////////////////////////////////////////
 Ogre2VisualPtr Ogre2Visual::SharedThis()
 {
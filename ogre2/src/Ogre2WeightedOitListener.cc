@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "Ogre2WeightedOitListener.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+void Ogre2WeightedOitListener::SetActiveCamera(const Ogre::Camera *_camera)
+{
+  this->activeCamera = _camera;
+}
+
+//////////////////////////////////////////////////
+const Ogre::Camera *Ogre2WeightedOitListener::ActiveCamera() const
+{
+  return this->activeCamera;
+}
+
+//////////////////////////////////////////////////
+void Ogre2WeightedOitListener::preparePassHash(
+    const Ogre::CompositorShadowNode *, bool _casterPass, bool,
+    Ogre::SceneManager *_sceneManager, Ogre::Hlms *_hlms)
+{
+  // the shadow maps of the pass are drawn with the same camera
+  if (_casterPass || !this->activeCamera ||
+      _sceneManager->getCameraInProgress() != this->activeCamera)
+  {
+    return;
+  }
+
+  // read by media/Hlms/Pbs/GLSL/PixelShader_ps.glsl
+  _hlms->_setProperty("ign_weighted_oit", 1);
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2WEIGHTEDOITLISTENER_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2WEIGHTEDOITLISTENER_HH_
+
+#include <ignition/common/SingletonT.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/ogre2/Ogre2Includes.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreHlmsListener.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Hlms listener of the pbs materials selecting the shaders
+    /// that draw weighted blended order independent transparency. During
+    /// the scene pass of the active camera the pixel shaders write two more
+    /// color attachments: transparent materials accumulate their weighted
+    /// premultiplied color, their weight and their optical depth there, and
+    /// only attenuate the opaque color, while opaque materials reset them.
+    /// The blend block of the transparent materials, one and one minus
+    /// source alpha, both accumulates and attenuates depending on the alpha
+    /// written to each attachment, so the materials are not changed and the
+    /// other passes draw them as before.
+    class Ogre2WeightedOitListener :
+      public Ogre::HlmsListener,
+      public common::SingletonT<Ogre2WeightedOitListener>
+    {
+      /// \brief Constructor
+      private: Ogre2WeightedOitListener() = default;
+
+      /// \brief Destructor
+      public: virtual ~Ogre2WeightedOitListener() = default;
+
+      /// \brief Set the camera whose scene passes draw order independent
+      /// transparency, set by the render targets before each scene pass
+      /// \param[in] _camera Ogre camera, null if none
+      public: void SetActiveCamera(const Ogre::Camera *_camera);
+
+      /// \brief Get the camera whose scene passes draw order independent
+      /// transparency
+      /// \return Ogre camera, null if none
+      public: const Ogre::Camera *ActiveCamera() const;
+
+      // Documentation inherited.
+      public: virtual void preparePassHash(
+          const Ogre::CompositorShadowNode *_shadowNode, bool _casterPass,
+          bool _dualParaboloid, Ogre::SceneManager *_sceneManager,
+          Ogre::Hlms *_hlms) override;
+
+      /// \brief Camera whose scene passes draw order independent
+      /// transparency
+      private: const Ogre::Camera *activeCamera = nullptr;
+
+      /// \brief Needed by common::SingletonT
+      private: friend class common::SingletonT<Ogre2WeightedOitListener>;
+    };
+    }
+  }
+}
+
+#endif
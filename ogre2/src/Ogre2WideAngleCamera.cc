@@ -0,0 +1,834 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#if (_WIN32)
+  /* Needed for std::min */
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/math/Helpers.hh>
+#include <ignition/math/Vector2.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "ignition/rendering/MemoryTracker.hh"
+#include "ignition/rendering/Profiler.hh"
+#include "ignition/rendering/RenderTypes.hh"
+#include "ignition/rendering/ogre2/Ogre2Conversions.hh"
+#include "ignition/rendering/ogre2/Ogre2Includes.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderTarget.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderTypes.hh"
+#include "ignition/rendering/ogre2/Ogre2Scene.hh"
+#include "ignition/rendering/ogre2/Ogre2WideAngleCamera.hh"
+
+#include "Ogre2GpuTimer.hh"
+#include "Ogre2ReadbackManager.hh"
+
+/// \internal
+/// \brief Private data for the Ogre2WideAngleCamera class
+class ignition::rendering::Ogre2WideAngleCameraPrivate
+{
+  /// \brief Image buffer the images are read back to
+  public: unsigned char *imageBuffer = nullptr;
+
+  /// \brief Compositor workspace definition
+  public: std::string ogreCompositorWorkspaceDef;
+
+  /// \brief Compositor node definition
+  public: std::string ogreCompositorNodeDef;
+
+  /// \brief Compositor workspace rendering the cubemap faces and the image
+  public: Ogre::CompositorWorkspace *ogreCompositorWorkspace = nullptr;
+
+  /// \brief Listener timing the compositor passes of the camera
+  public: std::unique_ptr<Ogre2GpuTimerListener> gpuTimerListener;
+
+  /// \brief Cameras rendering the cubemap faces. Only the faces seen by
+  /// the image are created.
+  public: Ogre::Camera *cubeCam[6] = {nullptr, nullptr, nullptr, nullptr,
+      nullptr, nullptr};
+
+  /// \brief Cubemap faces seen by the image
+  public: std::set<unsigned int> cubeFaceIdx;
+
+  /// \brief Texture packed with the cubemap face and uv coordinates sampled
+  /// by each pixel of the image
+  public: Ogre::TexturePtr sampleTexture;
+
+  /// \brief Texture the image is rendered to
+  public: Ogre::TexturePtr ogreImageTexture;
+
+  /// \brief Dummy render texture
+  public: RenderTexturePtr renderTexture;
+
+  /// \brief Material resampling the cubemap faces
+  public: Ogre::MaterialPtr material;
+
+  /// \brief Shadow node of the scene passes
+  public: std::string shadowNodeName;
+
+  /// \brief Event used to signal new images
+  public: common::EventT<void(const unsigned char *, unsigned int,
+      unsigned int, unsigned int, const std::string &)> newWideAngleFrame;
+
+  /// \brief Id of this camera in the readback manager. Zero if
+  /// asynchronous readback is disabled
+  public: unsigned int readbackClient = 0u;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Get the distance to the image center in focal lengths of a ray
+/// at an angle from the optical axis
+/// \param[in] _projection Mapping function
+/// \param[in] _theta Angle between the ray and the optical axis
+/// \return Distance to the image center divided by the focal length
+static double mapping(WideAngleProjection _projection, double _theta)
+{
+  switch (_projection)
+  {
+    case WAP_EQUISOLID_ANGLE:
+      return 2.0 * std::sin(_theta * 0.5);
+    case WAP_STEREOGRAPHIC:
+      return 2.0 * std::tan(_theta * 0.5);
+    case WAP_ORTHOGRAPHIC:
+      return std::sin(_theta);
+    case WAP_GNOMONIC:
+      return std::tan(_theta);
+    case WAP_EQUIDISTANT:
+    default:
+      return _theta;
+  }
+}
+
+/// \brief Get the angle from the optical axis of the ray of a pixel, the
+/// inverse of mapping
+/// \param[in] _projection Mapping function
+/// \param[in] _r Distance to the image center divided by the focal length
+/// \param[out] _theta Angle between the ray and the optical axis
+/// \return False if no ray is projected at that distance
+static bool inverseMapping(WideAngleProjection _projection, double _r,
+    double &_theta)
+{
+  switch (_projection)
+  {
+    case WAP_EQUISOLID_ANGLE:
+      if (_r > 2.0)
+        return false;
+      _theta = 2.0 * std::asin(_r * 0.5);
+      break;
+    case WAP_STEREOGRAPHIC:
+      _theta = 2.0 * std::atan(_r * 0.5);
+      break;
+    case WAP_ORTHOGRAPHIC:
+      if (_r > 1.0)
+        return false;
+      _theta = std::asin(_r);
+      break;
+    case WAP_GNOMONIC:
+      _theta = std::atan(_r);
+      break;
+    case WAP_EQUIDISTANT:
+    default:
+      _theta = _r;
+      break;
+  }
+  return _theta <= IGN_PI;
+}
+
+/// \brief Get the cubemap face and uv coordinates sampled by a direction,
+/// with the same cubemap layout as Ogre2GpuRays
+/// \param[in] _v Direction in a standard Y up cubemap frame
+/// \param[out] _faceIndex Cubemap face index
+/// \return uv coordinates on the face
+static math::Vector2d sampleCubemap(const math::Vector3d &_v,
+    unsigned int &_faceIndex)
+{
+  math::Vector3d vAbs = _v.Abs();
+  double ma;
+  math::Vector2d uv;
+  if (vAbs.Z() >= vAbs.X() && vAbs.Z() >= vAbs.Y())
+  {
+    _faceIndex = _v.Z() < 0.0 ? 5u : 4u;
+    ma = 0.5 / vAbs.Z();
+    uv = math::Vector2d(_v.Z() < 0.0 ? -_v.X() : _v.X(), -_v.Y());
+  }
+  else if (vAbs.Y() >= vAbs.X())
+  {
+    _faceIndex = _v.Y() < 0.0 ? 3u : 2u;
+    ma = 0.5 / vAbs.Y();
+    uv = math::Vector2d(_v.X(), _v.Y() < 0.0 ? -_v.Z() : _v.Z());
+  }
+  else
+  {
+    _faceIndex = _v.X() < 0.0 ? 1u : 0u;
+    ma = 0.5 / vAbs.X();
+    uv = math::Vector2d(_v.X() < 0.0 ? _v.Z() : -_v.Z(), -_v.Y());
+  }
+  return uv * ma + 0.5;
+}
+
+//////////////////////////////////////////////////
+Ogre2WideAngleCamera::Ogre2WideAngleCamera()
+  : dataPtr(new Ogre2WideAngleCameraPrivate())
+{
+}
+
+//////////////////////////////////////////////////
+Ogre2WideAngleCamera::~Ogre2WideAngleCamera()
+{
+  this->Destroy();
+}
+
+//////////////////////////////////////////////////
+void Ogre2WideAngleCamera::Init()
+{
+  BaseWideAngleCamera::Init();
+
+  // create internal camera
+  this->CreateCamera();
+
+  // create dummy render texture
+  this->CreateRenderTexture();
+
+  this->Reset();
+}
+
+//////////////////////////////////////////////////
+void Ogre2WideAngleCamera::Destroy()
+{
+  // the queued frames refer to the events of this sensor
+  this->FlushFrames();
+
+  this->SetAsyncReadback(false);
+
+  if (this->dataPtr->imageBuffer)
+  {
+    MemoryTracker::Untrack(this->dataPtr->imageBuffer);
+    delete [] this->dataPtr->imageBuffer;
+    this->dataPtr->imageBuffer = nullptr;
+  }
+
+  if (!this->ogreCamera)
+    return;
+
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
+
+  // remove the workspace, textures and material
+  if (this->dataPtr->ogreCompositorWorkspace)
+  {
+    ogreCompMgr->removeWorkspace(this->dataPtr->ogreCompositorWorkspace);
+    this->dataPtr->ogreCompositorWorkspace = nullptr;
+  }
+
+  if (!this->dataPtr->ogreCompositorWorkspaceDef.empty())
+  {
+    ogreCompMgr->removeWorkspaceDefinition(
+        this->dataPtr->ogreCompositorWorkspaceDef);
+    ogreCompMgr->removeNodeDefinition(this->dataPtr->ogreCompositorNodeDef);
+    this->dataPtr->ogreCompositorWorkspaceDef.clear();
+  }
+
+  if (this->dataPtr->ogreImageTexture)
+  {
+    Ogre::TextureManager::getSingleton().remove(
+        this->dataPtr->ogreImageTexture->getName());
+    this->dataPtr->ogreImageTexture.reset();
+  }
+
+  if (this->dataPtr->sampleTexture)
+  {
+    Ogre::TextureManager::getSingleton().remove(
+        this->dataPtr->sampleTexture->getName());
+    this->dataPtr->sampleTexture.reset();
+  }
+
+  if (this->dataPtr->material)
+  {
+    Ogre::MaterialManager::getSingleton().remove(
+        this->dataPtr->material->getName());
+    this->dataPtr->material.reset();
+  }
+
+  Ogre::SceneManager *ogreSceneManager = this->scene->OgreSceneManager();
+  if (ogreSceneManager == nullptr)
+  {
+    ignerr << "Scene manager cannot be obtained" << std::endl;
+    return;
+  }
+
+  for (auto &cam : this->dataPtr->cubeCam)
+  {
+    if (cam)
+    {
+      ogreSceneManager->destroyCamera(cam);
+      cam = nullptr;
+    }
+  }
+  this->dataPtr->cubeFaceIdx.clear();
+
+  if (ogreSceneManager->findCameraNoThrow(this->name) != nullptr)
+    ogreSceneManager->destroyCamera(this->ogreCamera);
+  this->ogreCamera = nullptr;
+}
+
+//////////////////////////////////////////////////
+void Ogre2WideAngleCamera::CreateCamera()
+{
+  // create ogre camera object
+  Ogre::SceneManager *ogreSceneManager = this->scene->OgreSceneManager();
+  if (ogreSceneManager == nullptr)
+  {
+    ignerr << "Scene manager cannot be obtained" << std::endl;
+    return;
+  }
+
+  this->ogreCamera = ogreSceneManager->createCamera(this->name);
+  if (this->ogreCamera == nullptr)
+  {
+    ignerr << "Ogre camera cannot be created" << std::endl;
+    return;
+  }
+
+  // by default, ogre2 cameras are attached to root scene node
+  this->ogreCamera->detachFromParent();
+  this->ogreNode->attachObject(this->ogreCamera);
+
+  // rotate to Gazebo coordinate system
+  this->ogreCamera->yaw(Ogre::Degree(-90.0));
+  this->ogreCamera->roll(Ogre::Degree(-90.0));
+  this->ogreCamera->setFixedYawAxis(false);
+}
+
+/////////////////////////////////////////////////
+void Ogre2WideAngleCamera::CreateRenderTexture()
+{
+  RenderTexturePtr base = this->scene->CreateRenderTexture();
+  this->dataPtr->renderTexture =
+      std::dynamic_pointer_cast<Ogre2RenderTexture>(base);
+  this->dataPtr->renderTexture->SetWidth(1);
+  this->dataPtr->renderTexture->SetHeight(1);
+}
+
+/////////////////////////////////////////////////////////
+void Ogre2WideAngleCamera::CreateWideAngleTexture()
+{
+  // only 8 bit rgb images are supported for now
+  this->SetImageFormat(PF_R8G8B8);
+  const unsigned int width = this->ImageWidth();
+  const unsigned int height = this->ImageHeight();
+
+  // mapping functions that diverge are limited to a field of view a bit
+  // narrower than their pole
+  double halfFov = this->HFOV().Radian() * 0.5;
+  double maxHalfFov = IGN_PI;
+  if (this->projection == WAP_ORTHOGRAPHIC)
+    maxHalfFov = IGN_PI * 0.5;
+  else if (this->projection == WAP_GNOMONIC)
+    maxHalfFov = IGN_PI * 0.5 * 0.99;
+  else if (this->projection == WAP_STEREOGRAPHIC)
+    maxHalfFov = IGN_PI * 0.99;
+  if (halfFov > maxHalfFov || halfFov <= 0.0)
+  {
+    halfFov = std::clamp(halfFov, 0.01, maxHalfFov);
+    ignwarn << "The horizontal field of view of wide angle camera ["
+            << this->Name() << "] is out of the range of its projection. "
+            << "Using " << halfFov * 2.0 << " rad instead." << std::endl;
+  }
+
+  // focal length in pixels, so the left and right edges of the image are
+  // at half the field of view
+  double focal = width * 0.5 / mapping(this->projection, halfFov);
+
+  // All mapping functions have a unit slope at the center, where one pixel
+  // covers 1 / focal rad, so faces of 90 deg are given as many pixels.
+  unsigned int faceSize = this->cubeFaceSize;
+  if (faceSize == 0u)
+  {
+    unsigned int v = static_cast<unsigned int>(focal * IGN_PI * 0.5);
+    // round to next highest power of 2
+    // https://graphics.stanford.edu/~seander/bithacks.html#RoundUpPowerOf2
+    v--;
+    v |= v >> 1;
+    v |= v >> 2;
+    v |= v >> 4;
+    v |= v >> 8;
+    v |= v >> 16;
+    v++;
+    faceSize = std::clamp(v, 16u, 2048u);
+  }
+
+  // pack the info that tells the shader how to sample from the cubemap
+  // faces. Each pixel packs the following data:
+  //   R: u coordinate on the cubemap face
+  //   G: v coordinate on the cubemap face
+  //   B: cubemap face index, negative for pixels out of the field of view
+  std::vector<float> data(static_cast<size_t>(width) * height * 3u);
+  this->dataPtr->cubeFaceIdx.clear();
+  for (unsigned int i = 0u; i < height; ++i)
+  {
+    double py = i + 0.5 - height * 0.5;
+    for (unsigned int j = 0u; j < width; ++j)
+    {
+      double px = j + 0.5 - width * 0.5;
+      double r = std::sqrt(px * px + py * py);
+      size_t idx = (static_cast<size_t>(i) * width + j) * 3u;
+      double theta = 0.0;
+      if (!inverseMapping(this->projection, r / focal, theta))
+      {
+        data[idx] = 0.0f;
+        data[idx + 1u] = 0.0f;
+        data[idx + 2u] = -1.0f;
+        continue;
+      }
+
+      // ray in the sensor frame: x forward, y left, z up. The image x goes
+      // right and its y goes down.
+      math::Vector3d ray(1.0, 0.0, 0.0);
+      if (r > 0.0)
+      {
+        double s = std::sin(theta) / r;
+        ray.Set(std::cos(theta), -px * s, -py * s);
+      }
+      // sample from a standard Y up cubemap
+      math::Vector3d dir(-ray.Y(), ray.Z(), ray.X());
+      unsigned int faceIdx;
+      math::Vector2d uv = sampleCubemap(dir, faceIdx);
+      this->dataPtr->cubeFaceIdx.insert(faceIdx);
+      data[idx] = static_cast<float>(uv.X());
+      data[idx + 1u] = static_cast<float>(uv.Y());
+      data[idx + 2u] = static_cast<float>(faceIdx);
+    }
+  }
+
+  this->dataPtr->sampleTexture =
+      Ogre::TextureManager::getSingleton().createManual(
+      this->Name() + "_sample", "General", Ogre::TEX_TYPE_2D,
+      width, height, 0, Ogre::PF_FLOAT32_RGB);
+  Ogre::v1::HardwarePixelBufferSharedPtr pixelBuffer =
+      this->dataPtr->sampleTexture->getBuffer();
+  pixelBuffer->lock(Ogre::v1::HardwareBuffer::HBL_NORMAL);
+  const Ogre::PixelBox &pixelBox = pixelBuffer->getCurrentLock();
+  float *pDest = static_cast<float *>(pixelBox.data);
+  for (unsigned int i = 0; i < height; ++i)
+  {
+    std::copy(data.begin() + i * width * 3u,
+        data.begin() + (i + 1u) * width * 3u,
+        pDest + i * pixelBox.rowPitch * 3u);
+  }
+  pixelBuffer->unlock();
+
+  // The WideAngleCamera material is defined in script
+  // (wide_angle_camera.material). We need to clone it since we are going
+  // to modify its texture unit states.
+  std::string matName = "WideAngleCamera";
+  Ogre::MaterialPtr mat =
+      Ogre::MaterialManager::getSingleton().getByName(matName);
+  if (!mat)
+  {
+    ignerr << "Wide angle camera material not found: '" << matName << "'"
+           << std::endl;
+    return;
+  }
+  this->dataPtr->material = mat->clone(this->Name() + "_" + matName);
+  this->dataPtr->material->load();
+  Ogre::Pass *pass = this->dataPtr->material->getTechnique(0)->getPass(0);
+  // The texture unit index (0) must match the one specified in the script
+  pass->getTextureUnitState(0)->setTexture(this->dataPtr->sampleTexture);
+
+  // create the cameras of the faces, oriented like the ones of
+  // Ogre2GpuRays
+  Ogre::SceneManager *ogreSceneManager = this->scene->OgreSceneManager();
+  for (auto i : this->dataPtr->cubeFaceIdx)
+  {
+    Ogre::Camera *cam = ogreSceneManager->createCamera(
+        this->Name() + "_env" + std::to_string(i));
+    cam->detachFromParent();
+    this->ogreNode->attachObject(cam);
+    cam->setFOVy(Ogre::Degree(90));
+    cam->setAspectRatio(1);
+    cam->setNearClipDistance(this->NearClipPlane());
+    cam->setFarClipDistance(this->FarClipPlane());
+    cam->setFixedYawAxis(false);
+    cam->yaw(Ogre::Degree(-90));
+    cam->roll(Ogre::Degree(-90));
+
+    // orient camera to create cubemap
+    if (i == 0)
+      cam->yaw(Ogre::Degree(-90));
+    else if (i == 1)
+      cam->yaw(Ogre::Degree(90));
+    else if (i == 2)
+      cam->pitch(Ogre::Degree(90));
+    else if (i == 3)
+      cam->pitch(Ogre::Degree(-90));
+    else if (i == 5)
+      cam->yaw(Ogre::Degree(180));
+    this->dataPtr->cubeCam[i] = cam;
+  }
+
+  // We need to programmatically create the compositor because the scene
+  // passes use the cameras of the faces. The compositor workspace
+  // definition is equivalent to the following ogre compositor script,
+  // with a face texture and target for each face seen by the image:
+  // compositor_node WideAngleCamera
+  // {
+  //   in 0 rt_input
+  //   texture face0 <face size> <face size> PF_R8G8B8 gamma
+  //   ...
+  //   target face0
+  //   {
+  //     pass clear
+  //     {
+  //       colour_value <background color>
+  //     }
+  //     pass render_scene
+  //     {
+  //       camera <name>_env0
+  //     }
+  //   }
+  //   ...
+  //   target rt_input
+  //   {
+  //     pass clear
+  //     {
+  //       colour_value 0.0 0.0 0.0 1.0
+  //     }
+  //     pass render_quad
+  //     {
+  //       material WideAngleCamera // Use copy instead of original
+  //       input 1 face0
+  //       ...
+  //     }
+  //   }
+  //   out 0 rt_input
+  // }
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
+
+  std::string wsDefName = "WideAngleCameraWorkspace_" + this->Name();
+  this->dataPtr->ogreCompositorWorkspaceDef = wsDefName;
+  std::string nodeDefName = wsDefName + "/Node";
+  this->dataPtr->ogreCompositorNodeDef = nodeDefName;
+  this->dataPtr->shadowNodeName = this->scene->ShadowNodeName();
+  if (!ogreCompMgr->hasWorkspaceDefinition(wsDefName))
+  {
+    Ogre::CompositorNodeDef *nodeDef =
+        ogreCompMgr->addNodeDefinition(nodeDefName);
+    // Input texture
+    nodeDef->addTextureSourceName("rt_input", 0,
+        Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+
+    for (auto i : this->dataPtr->cubeFaceIdx)
+    {
+      Ogre::TextureDefinitionBase::TextureDefinition *faceTexDef =
+          nodeDef->addTextureDefinition("face" + std::to_string(i));
+      faceTexDef->textureType = Ogre::TEX_TYPE_2D;
+      faceTexDef->width = faceSize;
+      faceTexDef->height = faceSize;
+      faceTexDef->depth = 1;
+      faceTexDef->numMipmaps = 0;
+      faceTexDef->formatList = {Ogre::PF_R8G8B8};
+      faceTexDef->fsaa = 0;
+      faceTexDef->uav = false;
+      faceTexDef->automipmaps = false;
+      faceTexDef->hwGammaWrite = Ogre::TextureDefinitionBase::BoolTrue;
+      faceTexDef->depthBufferId = Ogre::DepthBuffer::POOL_DEFAULT;
+      faceTexDef->depthBufferFormat = Ogre::PF_D32_FLOAT;
+      faceTexDef->fsaaExplicitResolve = false;
+    }
+
+    nodeDef->setNumTargetPass(this->dataPtr->cubeFaceIdx.size() + 1u);
+    for (auto i : this->dataPtr->cubeFaceIdx)
+    {
+      Ogre::CompositorTargetDef *faceTargetDef =
+          nodeDef->addTargetPass("face" + std::to_string(i));
+      faceTargetDef->setNumPasses(2);
+      {
+        // clear pass
+        Ogre::CompositorPassClearDef *passClear =
+            static_cast<Ogre::CompositorPassClearDef *>(
+            faceTargetDef->addPass(Ogre::PASS_CLEAR));
+        passClear->mColourValue =
+            Ogre2Conversions::Convert(this->scene->BackgroundColor());
+        // scene pass, seen by the camera of the face
+        Ogre::CompositorPassSceneDef *passScene =
+            static_cast<Ogre::CompositorPassSceneDef *>(
+            faceTargetDef->addPass(Ogre::PASS_SCENE));
+        passScene->mCameraName = this->dataPtr->cubeCam[i]->getName();
+        passScene->mVisibilityMask = this->visibilityMask;
+        if (!this->dataPtr->shadowNodeName.empty())
+          passScene->mShadowNode = this->dataPtr->shadowNodeName;
+      }
+    }
+
+    // rt_input target - resamples the faces
+    Ogre::CompositorTargetDef *inputTargetDef =
+        nodeDef->addTargetPass("rt_input");
+    inputTargetDef->setNumPasses(2);
+    {
+      // clear pass
+      Ogre::CompositorPassClearDef *passClear =
+          static_cast<Ogre::CompositorPassClearDef *>(
+          inputTargetDef->addPass(Ogre::PASS_CLEAR));
+      passClear->mColourValue = Ogre::ColourValue::Black;
+      // quad pass
+      Ogre::CompositorPassQuadDef *passQuad =
+          static_cast<Ogre::CompositorPassQuadDef *>(
+          inputTargetDef->addPass(Ogre::PASS_QUAD));
+      passQuad->mMaterialName = this->dataPtr->material->getName();
+      // texture unit indices need to match how the texture units are
+      // defined in the wide_angle_camera.material script
+      for (auto i : this->dataPtr->cubeFaceIdx)
+        passQuad->addQuadTextureSource(1u + i, "face" + std::to_string(i), 0);
+    }
+    nodeDef->mapOutputChannel(0, "rt_input");
+    Ogre::CompositorWorkspaceDef *workDef =
+        ogreCompMgr->addWorkspaceDefinition(wsDefName);
+    workDef->connectExternal(0, nodeDef->getName(), 0);
+  }
+  Ogre::CompositorWorkspaceDef *wsDef =
+      ogreCompMgr->getWorkspaceDefinition(wsDefName);
+  if (!wsDef)
+  {
+    ignerr << "Unable to add workspace definition [" << wsDefName << "] "
+           << " for " << this->Name();
+  }
+
+  // create render texture the image is drawn to
+  this->dataPtr->ogreImageTexture =
+      Ogre::TextureManager::getSingleton().createManual(
+      this->Name() + "_wide_angle", "General", Ogre::TEX_TYPE_2D,
+      width, height, 0, Ogre::PF_R8G8B8, Ogre::TU_RENDERTARGET, 0, true);
+
+  Ogre::RenderTarget *rt =
+      this->dataPtr->ogreImageTexture->getBuffer()->getRenderTarget();
+
+  // create compositor workspace
+  this->dataPtr->ogreCompositorWorkspace =
+      ogreCompMgr->addWorkspace(this->scene->OgreSceneManager(),
+      rt, this->ogreCamera, wsDefName, false);
+
+  if (!this->dataPtr->gpuTimerListener)
+  {
+    this->dataPtr->gpuTimerListener.reset(new Ogre2GpuTimerListener(
+        this->gpuTimerClient, "wide angle"));
+  }
+  this->dataPtr->ogreCompositorWorkspace->setListener(
+      this->dataPtr->gpuTimerListener.get());
+}
+
+//////////////////////////////////////////////////
+void Ogre2WideAngleCamera::Render()
+{
+  IGN_RENDERING_PROFILE("Ogre2WideAngleCamera::Render");
+  this->BeginFrameStats();
+  for (auto cam : this->dataPtr->cubeCam)
+  {
+    if (cam)
+      this->scene->AddParticleViewer(cam);
+  }
+
+  auto engine = Ogre2RenderEngine::Instance();
+  if (engine->RenderBatchActive())
+  {
+    engine->AddToRenderBatch(this->shared_from_this(),
+        this->dataPtr->ogreCompositorWorkspace);
+    return;
+  }
+
+  // all faces and the resampling quad are rendered in one frame
+  engine->RenderWorkspaces({this->dataPtr->ogreCompositorWorkspace});
+}
+
+//////////////////////////////////////////////////
+void Ogre2WideAngleCamera::PreRender()
+{
+  IGN_RENDERING_PROFILE("Ogre2WideAngleCamera::PreRender");
+  if (!this->dataPtr->ogreImageTexture)
+    this->CreateWideAngleTexture();
+
+  // follow the shadow node of the scene when the lights change
+  std::string shadowNodeName = this->scene->ShadowNodeName();
+  if (shadowNodeName != this->dataPtr->shadowNodeName &&
+      this->dataPtr->ogreCompositorWorkspace)
+  {
+    this->dataPtr->shadowNodeName = shadowNodeName;
+    for (auto i : this->dataPtr->cubeFaceIdx)
+    {
+      this->scene->ApplyShadowNode(this->dataPtr->ogreCompositorNodeDef,
+          "face" + std::to_string(i), shadowNodeName);
+    }
+    this->dataPtr->ogreCompositorWorkspace->recreateAllNodes();
+  }
+
+  for (auto cam : this->dataPtr->cubeCam)
+  {
+    if (cam)
+      cam->setLodBias(this->RenderLodBias());
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2WideAngleCamera::PostRender()
+{
+  IGN_RENDERING_PROFILE("Ogre2WideAngleCamera::PostRender");
+  // data is read back once the render batch has been rendered
+  auto engine = Ogre2RenderEngine::Instance();
+  if (engine->RenderBatchActive())
+  {
+    engine->DeferPostRender(this->shared_from_this());
+    return;
+  }
+
+  if (this->dataPtr->newWideAngleFrame.ConnectionCount() <= 0u &&
+      this->newSensorFrame.ConnectionCount() <= 0u)
+  {
+    return;
+  }
+
+  unsigned int width = this->ImageWidth();
+  unsigned int height = this->ImageHeight();
+  PixelFormat format = this->ImageFormat();
+  Ogre::PixelFormat imageFormat = Ogre2Conversions::Convert(format);
+  unsigned int channelCount = PixelUtil::ChannelCount(format);
+  size_t size = static_cast<size_t>(width) * height * channelCount;
+
+  if (!this->dataPtr->imageBuffer)
+  {
+    this->dataPtr->imageBuffer = new unsigned char[size];
+    MemoryTracker::Track(MC_SENSOR_BUFFER, this->dataPtr->imageBuffer, size);
+  }
+
+  auto readback = Ogre2ReadbackManager::Instance();
+  if (this->dataPtr->readbackClient)
+  {
+    // queue a copy of the frame that has just been rendered and retrieve a
+    // previous one so the transfer overlaps with the next render
+    if (!readback->Request(this->dataPtr->readbackClient,
+        this->dataPtr->ogreImageTexture.get(), imageFormat))
+    {
+      ignwarn << "Asynchronous readback failed for wide angle camera ["
+              << this->Name() << "], falling back to blocking readback"
+              << std::endl;
+      this->SetAsyncReadback(false);
+    }
+    else if (!readback->Retrieve(this->dataPtr->readbackClient,
+        this->dataPtr->imageBuffer, size))
+    {
+      // no frame available yet
+      return;
+    }
+  }
+
+  if (!this->dataPtr->readbackClient)
+  {
+    Ogre::PixelBox dstBox(width, height, 1, imageFormat,
+        this->dataPtr->imageBuffer);
+    readback->Read(
+        this->dataPtr->ogreImageTexture->getBuffer()->getRenderTarget(),
+        dstBox);
+  }
+  this->AddReadbackBytes(size);
+
+  this->DispatchFrame(this->dataPtr->newWideAngleFrame,
+      this->dataPtr->imageBuffer, size, width, height, channelCount,
+      PixelUtil::Name(format));
+}
+
+//////////////////////////////////////////////////
+void Ogre2WideAngleCamera::Copy(Image &_image) const
+{
+  if (!this->dataPtr->ogreImageTexture)
+    return;
+
+  if (_image.Width() != this->ImageWidth() ||
+      _image.Height() != this->ImageHeight())
+  {
+    ignerr << "Invalid image dimensions" << std::endl;
+    return;
+  }
+
+  Ogre::PixelFormat imageFormat = Ogre2Conversions::Convert(_image.Format());
+  Ogre::PixelBox dstBox(_image.Width(), _image.Height(), 1, imageFormat,
+      _image.Data());
+  dstBox.rowPitch =
+      _image.RowStride() / PixelUtil::BytesPerPixel(_image.Format());
+  Ogre2ReadbackManager::Instance()->Read(
+      this->dataPtr->ogreImageTexture->getBuffer()->getRenderTarget(),
+      dstBox);
+  this->AddReadbackBytes(_image.MemorySize());
+}
+
+//////////////////////////////////////////////////
+void Ogre2WideAngleCamera::SetAsyncReadback(bool _enabled)
+{
+  auto readback = Ogre2ReadbackManager::Instance();
+  if (!_enabled)
+  {
+    readback->DestroyClient(this->dataPtr->readbackClient);
+    this->dataPtr->readbackClient = 0u;
+    return;
+  }
+
+  if (this->dataPtr->readbackClient)
+    return;
+
+  this->dataPtr->readbackClient = readback->CreateClient();
+  if (!this->dataPtr->readbackClient)
+  {
+    ignwarn << "Asynchronous readback is not supported by the current "
+            << "render system. Wide angle camera [" << this->Name()
+            << "] will use blocking readback" << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+bool Ogre2WideAngleCamera::AsyncReadback() const
+{
+  return this->dataPtr->readbackClient != 0u;
+}
+
+//////////////////////////////////////////////////
+common::ConnectionPtr Ogre2WideAngleCamera::ConnectNewWideAngleFrame(
+    std::function<void(const unsigned char *, unsigned int, unsigned int,
+      unsigned int, const std::string &)> _subscriber)
+{
+  return this->dataPtr->newWideAngleFrame.Connect(_subscriber);
+}
+
+//////////////////////////////////////////////////
+RenderTargetPtr Ogre2WideAngleCamera::RenderTarget() const
+{
+  return this->dataPtr->renderTexture;
+}
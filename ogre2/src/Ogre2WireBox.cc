@@ -15,12 +15,19 @@
  *
 */
 
+#include <string>
+#include <vector>
+
 #include <ignition/common/Console.hh>
+#include <ignition/common/Mesh.hh>
+#include <ignition/common/MeshManager.hh>
+#include <ignition/common/SubMesh.hh>
 
 #include "ignition/rendering/ogre2/Ogre2WireBox.hh"
 #include "ignition/rendering/ogre2/Ogre2Material.hh"
+#include "ignition/rendering/ogre2/Ogre2Mesh.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
-#include "ignition/rendering/ogre2/Ogre2DynamicRenderable.hh"
+#include "ignition/rendering/ogre2/Ogre2Visual.hh"
 
 using namespace ignition;
 using namespace rendering;
@@ -30,8 +37,9 @@ class ignition::rendering::Ogre2WireBoxPrivate
   /// \brief Wirebox material
   public: Ogre2MaterialPtr material;
 
-  /// \brief Ogre renderable used to render the wirebox.
-  public: std::shared_ptr<Ogre2DynamicRenderable> wireBox = nullptr;
+  /// \brief Mesh used to render the wirebox. Its line list is shared by
+  /// all the wireboxes with the same box
+  public: Ogre2MeshPtr wireBox = nullptr;
 };
 
 //////////////////////////////////////////////////
@@ -58,7 +66,10 @@ void Ogre2WireBox::PreRender()
 //////////////////////////////////////////////////
 Ogre::MovableObject *Ogre2WireBox::OgreObject() const
 {
-  return this->dataPtr->wireBox->OgreObject();
+  if (this->dataPtr->wireBox)
+    return this->dataPtr->wireBox->OgreObject();
+  else
+    return nullptr;
 }
 
 //////////////////////////////////////////////////
@@ -67,72 +78,139 @@ void Ogre2WireBox::Init()
   this->Create();
 }
 
+//////////////////////////////////////////////////
+void Ogre2WireBox::Destroy()
+{
+  BaseWireBox::Destroy();
+
+  if (this->dataPtr->wireBox)
+  {
+    this->dataPtr->wireBox->Destroy();
+    this->dataPtr->wireBox.reset();
+  }
+  this->dataPtr->material.reset();
+}
+
 //////////////////////////////////////////////////
 void Ogre2WireBox::Create()
 {
-  if (!this->dataPtr->wireBox)
+  ignition::math::Vector3d max = this->box.Max();
+  ignition::math::Vector3d min = this->box.Min();
+
+  common::MeshManager *meshMgr = common::MeshManager::Instance();
+  std::string wireBoxMeshName = "wire_box_mesh";
+  for (const auto &v : {min, max})
   {
-    this->dataPtr->wireBox.reset(new Ogre2DynamicRenderable(this->scene));
+    wireBoxMeshName += "_" + std::to_string(v.X())
+        + "_" + std::to_string(v.Y())
+        + "_" + std::to_string(v.Z());
   }
 
-  // Clear any previous data from the wirebox
-  this->dataPtr->wireBox->Clear();
-  this->dataPtr->wireBox->Update();
+  // Create new mesh if needed
+  if (!meshMgr->HasMesh(wireBoxMeshName))
+    this->CreateMesh(wireBoxMeshName);
 
-  this->dataPtr->wireBox->SetOperationType(MarkerType::MT_LINE_LIST);
+  MeshDescriptor meshDescriptor;
+  meshDescriptor.mesh = meshMgr->MeshByName(wireBoxMeshName);
+  if (meshDescriptor.mesh == nullptr)
+  {
+    ignerr << "Wire box mesh is unavailable in the Mesh Manager"
+           << std::endl;
+    return;
+  }
 
+  auto visual = std::dynamic_pointer_cast<Ogre2Visual>(this->Parent());
+
+  // clear geom if needed
+  if (this->dataPtr->wireBox)
+  {
+    if (visual)
+    {
+      visual->RemoveGeometry(
+          std::dynamic_pointer_cast<Geometry>(shared_from_this()));
+    }
+    this->dataPtr->wireBox->Destroy();
+  }
+  this->dataPtr->wireBox = std::dynamic_pointer_cast<Ogre2Mesh>(
+      this->Scene()->CreateMesh(meshDescriptor));
+  if (this->dataPtr->wireBox && this->dataPtr->material)
+    this->dataPtr->wireBox->SetMaterial(this->dataPtr->material, false);
+  if (visual)
+  {
+    visual->AddGeometry(
+        std::dynamic_pointer_cast<Geometry>(shared_from_this()));
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2WireBox::CreateMesh(const std::string &_name)
+{
   ignition::math::Vector3d max = this->box.Max();
   ignition::math::Vector3d min = this->box.Min();
 
+  std::vector<math::Vector3d> points;
+
   // line 0
-  this->dataPtr->wireBox->AddPoint({min.X(), min.Y(), min.Z()});
-  this->dataPtr->wireBox->AddPoint({max.X(), min.Y(), min.Z()});
+  points.push_back({min.X(), min.Y(), min.Z()});
+  points.push_back({max.X(), min.Y(), min.Z()});
 
   // line 1
-  this->dataPtr->wireBox->AddPoint({min.X(), min.Y(), min.Z()});
-  this->dataPtr->wireBox->AddPoint({min.X(), min.Y(), max.Z()});
+  points.push_back({min.X(), min.Y(), min.Z()});
+  points.push_back({min.X(), min.Y(), max.Z()});
 
   // line 2
-  this->dataPtr->wireBox->AddPoint({min.X(), min.Y(), min.Z()});
-  this->dataPtr->wireBox->AddPoint({min.X(), max.Y(), min.Z()});
+  points.push_back({min.X(), min.Y(), min.Z()});
+  points.push_back({min.X(), max.Y(), min.Z()});
 
   // line 3
-  this->dataPtr->wireBox->AddPoint({min.X(), max.Y(), min.Z()});
-  this->dataPtr->wireBox->AddPoint({min.X(), max.Y(), max.Z()});
+  points.push_back({min.X(), max.Y(), min.Z()});
+  points.push_back({min.X(), max.Y(), max.Z()});
 
   // line 4
-  this->dataPtr->wireBox->AddPoint({min.X(), max.Y(), min.Z()});
-  this->dataPtr->wireBox->AddPoint({max.X(), max.Y(), min.Z()});
+  points.push_back({min.X(), max.Y(), min.Z()});
+  points.push_back({max.X(), max.Y(), min.Z()});
 
   // line 5
-  this->dataPtr->wireBox->AddPoint({max.X(), min.Y(), min.Z()});
-  this->dataPtr->wireBox->AddPoint({max.X(), min.Y(), max.Z()});
+  points.push_back({max.X(), min.Y(), min.Z()});
+  points.push_back({max.X(), min.Y(), max.Z()});
 
   // line 6
-  this->dataPtr->wireBox->AddPoint({max.X(), min.Y(), min.Z()});
-  this->dataPtr->wireBox->AddPoint({max.X(), max.Y(), min.Z()});
+  points.push_back({max.X(), min.Y(), min.Z()});
+  points.push_back({max.X(), max.Y(), min.Z()});
 
   // line 7
-  this->dataPtr->wireBox->AddPoint({min.X(), max.Y(), max.Z()});
-  this->dataPtr->wireBox->AddPoint({max.X(), max.Y(), max.Z()});
+  points.push_back({min.X(), max.Y(), max.Z()});
+  points.push_back({max.X(), max.Y(), max.Z()});
 
   // line 8
-  this->dataPtr->wireBox->AddPoint({min.X(), max.Y(), max.Z()});
-  this->dataPtr->wireBox->AddPoint({min.X(), min.Y(), max.Z()});
+  points.push_back({min.X(), max.Y(), max.Z()});
+  points.push_back({min.X(), min.Y(), max.Z()});
 
   // line 9
-  this->dataPtr->wireBox->AddPoint({max.X(), max.Y(), min.Z()});
-  this->dataPtr->wireBox->AddPoint({max.X(), max.Y(), max.Z()});
+  points.push_back({max.X(), max.Y(), min.Z()});
+  points.push_back({max.X(), max.Y(), max.Z()});
 
   // line 10
-  this->dataPtr->wireBox->AddPoint({max.X(), min.Y(), max.Z()});
-  this->dataPtr->wireBox->AddPoint({max.X(), max.Y(), max.Z()});
+  points.push_back({max.X(), min.Y(), max.Z()});
+  points.push_back({max.X(), max.Y(), max.Z()});
 
   // line 11
-  this->dataPtr->wireBox->AddPoint({min.X(), min.Y(), max.Z()});
-  this->dataPtr->wireBox->AddPoint({max.X(), min.Y(), max.Z()});
+  points.push_back({min.X(), min.Y(), max.Z()});
+  points.push_back({max.X(), min.Y(), max.Z()});
+
+  common::SubMesh subMesh;
+  subMesh.SetPrimitiveType(common::SubMesh::LINES);
+  for (const auto &p : points)
+  {
+    subMesh.AddIndex(subMesh.VertexCount());
+    subMesh.AddVertex(p);
+    subMesh.AddNormal(math::Vector3d::UnitZ);
+  }
 
-  this->dataPtr->wireBox->Update();
+  common::Mesh *mesh = new common::Mesh();
+  mesh->SetName(_name);
+  mesh->AddSubMesh(subMesh);
+  common::MeshManager::Instance()->AddMesh(mesh);
 }
 
 //////////////////////////////////////////////////
@@ -151,8 +229,9 @@ void Ogre2WireBox::SetMaterial(MaterialPtr _material, bool _unique)
     return;
   }
 
-  // Set material for the underlying dynamic renderable
-  this->dataPtr->wireBox->SetMaterial(_material, false);
+  // Set material for the underlying mesh
+  if (this->dataPtr->wireBox)
+    this->dataPtr->wireBox->SetMaterial(_material, false);
   this->SetMaterialImpl(derived);
 }
 
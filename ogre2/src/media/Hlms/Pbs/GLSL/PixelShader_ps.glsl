@@ -12,6 +12,10 @@ layout(std140) uniform;
 	@property( !hlms_shadowcaster )
 		@property( !hlms_prepass )
 			layout(location = FRAG_COLOR, index = 0) out vec4 outColour;
+			@property( ign_weighted_oit )
+				layout(location = 1) out vec4 outOitAccum;
+				layout(location = 2) out vec4 outOitWeight;
+			@end
 		@end @property( hlms_prepass )
 			layout(location = 0) out vec4 outNormals;
 			layout(location = 1) out vec2 outShadowRoughness;
@@ -521,6 +525,25 @@ void main()
 		@property( debug_pssm_splits )
 			outColour.xyz = mix( outColour.xyz, debugPssmSplit.xyz, 0.2f );
 		@end
+
+		@property( ign_weighted_oit )
+			// Weighted blended order independent transparency, see
+			// Ogre2WeightedOitListener. Written with the blend block of the
+			// materials: alpha 0 accumulates, alpha a attenuates.
+			@property( transparent_mode )
+				float oitAlpha = outColour.w;
+				float oitDepth = 1.0 - gl_FragCoord.z * 0.9;
+				float oitWeight = clamp( pow( min( 1.0, oitAlpha * 10.0 ) + 0.01, 3.0 ) *
+						1e8 * oitDepth * oitDepth * oitDepth, 1e-2, 3e3 );
+				outOitAccum = vec4( outColour.xyz * oitWeight, 0.0 );
+				outOitWeight = vec4( oitAlpha * oitWeight,
+						-log( max( 1.0 - oitAlpha, 1e-4 ) ), 0.0, 0.0 );
+				outColour = vec4( 0.0, 0.0, 0.0, oitAlpha );
+			@end @property( !transparent_mode )
+				outOitAccum = vec4( 0.0, 0.0, 0.0, 0.0 );
+				outOitWeight = vec4( 0.0, 0.0, 0.0, 0.0 );
+			@end
+		@end
 	@end @property( hlms_prepass )
 		outNormals			= vec4( nNormal * 0.5 + 0.5, 1.0 );
 		@property( hlms_pssm_splits )
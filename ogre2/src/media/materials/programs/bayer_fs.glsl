@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version 330
+
+// Draws the Bayer mosaic of a rendered image to a single channel target, so
+// that cameras with a Bayer format read back one byte per pixel. Each pixel
+// keeps the channel of the input selected by its position in the 2x2
+// pattern.
+
+// The input texture, which is set up by the Ogre Compositor infrastructure.
+uniform sampler2D RT;
+
+// Channel kept by each pixel of the 2x2 pattern, in row major order:
+// 0 for red, 1 for green and 2 for blue
+uniform vec4 channels;
+
+in block
+{
+  vec2 uv0;
+} inPs;
+
+out vec4 fragColor;
+
+void main()
+{
+  // the output and the input have the same size
+  ivec2 pixel = ivec2(gl_FragCoord.xy);
+  vec3 color = texelFetch(RT, pixel, 0).rgb;
+  int index = (pixel.y % 2) * 2 + pixel.x % 2;
+  float value = color[int(channels[index])];
+
+  // the input is an sRGB texture, sampled as linear values, while the
+  // single channel output is not. Encode the value the way it is stored in
+  // the input so that the mosaic matches the RGB image.
+  if (value <= 0.0031308)
+    value = value * 12.92;
+  else
+    value = 1.055 * pow(value, 1.0 / 2.4) - 0.055;
+
+  fragColor = vec4(value, value, value, 1.0);
+}
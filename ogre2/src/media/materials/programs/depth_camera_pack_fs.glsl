@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version 330
+
+// Packs the depth of the final depth camera output into a single 16 bit
+// channel, so that cameras with a compact image format read back two bytes
+// per pixel instead of four or sixteen.
+
+// The final output of the depth camera, x being the depth
+uniform sampler2D inputTexture;
+
+uniform vec4 texResolution;
+
+// 1 to write millimeters to an unsigned normalized 16 bit target, 0 to
+// write meters to a half float target
+uniform float millimeters;
+
+in block
+{
+  vec2 uv0;
+} inPs;
+
+out vec4 fragColor;
+
+void main()
+{
+  float depth =
+      texelFetch(inputTexture, ivec2(inPs.uv0 * texResolution.xy), 0).x;
+
+  if (millimeters > 0.5)
+  {
+    // as PixelUtil::Convert does, depths that are not finite or do not fit
+    // in 16 bits are set to 0, the invalid value of 16 bit depth images.
+    // The target rounds to the nearest millimeter.
+    float mm = depth * 1000.0;
+    depth = (mm >= 0.0 && mm <= 65535.0) ? mm / 65535.0 : 0.0;
+  }
+
+  fragColor = vec4(depth, 0.0, 0.0, 1.0);
+}
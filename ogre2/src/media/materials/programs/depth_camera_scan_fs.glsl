@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version 330
+
+// Reduces the xyz + rgba points of a depth camera to a laser scan: the
+// output texel of each column is the smallest range in the horizontal
+// plane of the camera of the points of a band of rows, +inf if none of
+// them is valid.
+
+in block
+{
+  vec2 uv0;
+} inPs;
+
+// xyz + rgba points of the depth camera
+uniform sampler2D inputTexture;
+
+// xy: size of the input texture
+uniform vec4 texResolution;
+
+// first row of the band and number of rows
+uniform float firstRow;
+uniform float rowCount;
+
+// points closer or farther than the clip planes are out of range
+uniform float near;
+uniform float far;
+
+out vec4 fragColor;
+
+void main()
+{
+  float tolerance = 1e-6;
+  int column = int(inPs.uv0.x * texResolution.x);
+  int first = int(firstRow);
+  int last = min(first + int(rowCount), int(texResolution.y));
+
+  float range = uintBitsToFloat(0x7F800000u);
+  for (int row = first; row < last; ++row)
+  {
+    vec3 point = texelFetch(inputTexture, ivec2(column, row), 0).xyz;
+    if (any(isinf(point)) || any(isnan(point)) ||
+        point.x > far - tolerance || point.x < near + tolerance)
+    {
+      continue;
+    }
+    range = min(range, length(point.xy));
+  }
+
+  fragColor = vec4(range, 0.0, 0.0, 1.0);
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version 330
+
+// Reduces the xyz + rgba points of a depth camera to one point per tile of
+// tileSize x tileSize pixels: the centroid of the valid points of the tile,
+// with the color of the first of them. Tiles without valid points output
+// +inf coordinates.
+
+in block
+{
+  vec2 uv0;
+} inPs;
+
+// xyz + rgba points of the depth camera
+uniform sampler2D inputTexture;
+
+// xy: size of the input texture, zw: size of the output texture
+uniform vec4 texResolution;
+
+// width and height of a tile in pixels
+uniform float tileSize;
+
+// points closer or farther than the clip planes are out of range
+uniform float near;
+uniform float far;
+
+out vec4 fragColor;
+
+void main()
+{
+  float tolerance = 1e-6;
+  int size = int(tileSize);
+  ivec2 tile = ivec2(inPs.uv0 * texResolution.zw);
+  ivec2 first = tile * size;
+  ivec2 last = min(first + ivec2(size), ivec2(texResolution.xy));
+
+  vec3 sum = vec3(0.0);
+  float count = 0.0;
+  // texelFetch keeps the bits of the packed color
+  float color = 0.0;
+  for (int y = first.y; y < last.y; ++y)
+  {
+    for (int x = first.x; x < last.x; ++x)
+    {
+      vec4 p = texelFetch(inputTexture, ivec2(x, y), 0);
+      if (any(isinf(p.xyz)) || any(isnan(p.xyz)) ||
+          p.x > far - tolerance || p.x < near + tolerance)
+      {
+        continue;
+      }
+      if (count == 0.0)
+        color = p.w;
+      sum += p.xyz;
+      count += 1.0;
+    }
+  }
+
+  if (count == 0.0)
+    fragColor = vec4(vec3(uintBitsToFloat(0x7F800000u)), 0.0);
+  else
+    fragColor = vec4(sum / count, color);
+}
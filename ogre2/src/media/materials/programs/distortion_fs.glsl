@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version 330
+
+// Lens distortion: the source uv of each pixel is looked up in a remap
+// texture computed by Ogre2DistortionPass. Pixels out of the field of view
+// of the camera are black.
+
+uniform sampler2D RT;
+uniform sampler2D distortionMap;
+
+in block
+{
+  vec2 uv0;
+} inPs;
+
+out vec4 fragColor;
+
+void main()
+{
+  vec2 uv = texture(distortionMap, inPs.uv0.xy).xy;
+  if (uv.x < 0.0 || uv.y < 0.0 || uv.x > 1.0 || uv.y > 1.0)
+    fragColor = vec4(0.0, 0.0, 0.0, 1.0);
+  else
+    fragColor = texture(RT, uv);
+}
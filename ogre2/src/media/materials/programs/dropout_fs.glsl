@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version 330
+
+// Randomly drops pixels of a rendered image, dropped pixels are black.
+// The random numbers are drawn the same way as in gaussian_noise_fs.glsl:
+// from the CPU-supplied offset, or from the Philox counter based generator
+// when the pass is seeded.
+
+uniform sampler2D RT;
+
+// Probability of a pixel to be dropped
+uniform float probability;
+// Random value sampled on the CPU, offset of the pseudo-random sampler
+uniform float offset;
+// Seed of the counter based generator, 0 to use the offset instead
+uniform int seed;
+// Frame number, counter of the counter based generator
+uniform int frame;
+
+in block
+{
+  vec2 uv0;
+} inPs;
+
+out vec4 fragColor;
+
+float rand(vec2 co)
+{
+  return fract(sin(dot(co.xy, vec2(12.9898,78.233))) * 43758.5453);
+}
+
+uvec2 mulhilo(uint a, uint b)
+{
+  uint a0 = a & 0xFFFFu;
+  uint a1 = a >> 16u;
+  uint b0 = b & 0xFFFFu;
+  uint b1 = b >> 16u;
+  uint t = a1 * b0 + ((a0 * b0) >> 16u);
+  uint w = (t & 0xFFFFu) + a0 * b1;
+  return uvec2(a1 * b1 + (t >> 16u) + (w >> 16u), a * b);
+}
+
+uvec2 philox(uvec2 ctr, uint key)
+{
+  for (int i = 0; i < 10; ++i)
+  {
+    uvec2 hilo = mulhilo(0xD256D193u, ctr.x);
+    ctr = uvec2(hilo.x ^ key ^ ctr.y, hilo.y);
+    key += 0x9E3779B9u;
+  }
+  return ctr;
+}
+
+void main()
+{
+  float u;
+  if (seed != 0)
+  {
+    // the key is offset so that a noise pass with the same seed draws
+    // independent numbers
+    uvec2 pixel = uvec2(gl_FragCoord.xy);
+    uvec2 r = philox(uvec2(pixel.x | (pixel.y << 16u), uint(frame)),
+        uint(seed) + 0x68E31DA4u);
+    u = float(r.x >> 8u) / 16777216.0;
+  }
+  else
+  {
+    u = rand(inPs.uv0.xy + vec2(offset, offset));
+  }
+
+  if (u < probability)
+    fragColor = vec4(0.0, 0.0, 0.0, 1.0);
+  else
+    fragColor = texture(RT, inPs.uv0.xy);
+}
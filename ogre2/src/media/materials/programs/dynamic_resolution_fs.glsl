@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version 330
+
+// Upscales the region of a render texture the scene was drawn to with
+// dynamic resolution to the whole output, with bilinear filtering.
+
+uniform sampler2D RT;
+
+// xy: size of the region relative to the texture size, zw: largest uv
+// sampled, half a texel inside the region so that the texels around it
+// are not blended in
+uniform vec4 uvScale;
+
+in block
+{
+  vec2 uv0;
+} inPs;
+
+out vec4 fragColor;
+
+void main()
+{
+  vec2 uv = min(inPs.uv0.xy * uvScale.xy, uvScale.zw);
+  fragColor = texture(RT, uv);
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version 330
+
+// Fast approximate anti-aliasing, after FXAA 3.11 by Timothy Lottes.
+// Pixels on an edge are detected from the contrast of the luma around
+// them. The edge is followed in both directions to find its ends, and the
+// pixel is blended with its neighbour across the edge by how close it is
+// to the nearest end. Isolated pixels are blended with their neighbours
+// to remove sub-pixel aliasing. The texture is sampled with bilinear
+// filtering.
+
+uniform sampler2D RT;
+
+// Amount of sub-pixel aliasing removed, in [0, 1]
+uniform float subpixelQuality;
+// Contrast of an edge, relative to the brightest pixel around it
+uniform float edgeThreshold;
+// Smallest contrast of an edge
+uniform float edgeThresholdMin;
+
+in block
+{
+  vec2 uv0;
+} inPs;
+
+out vec4 fragColor;
+
+// Steps, in texels, of the search of the ends of an edge
+const int kSearchSteps = 10;
+const float kSearchStep[kSearchSteps] = float[kSearchSteps](
+    1.0, 1.0, 1.0, 1.0, 1.5, 2.0, 2.0, 2.0, 4.0, 8.0);
+
+// Perceptual luma of a linear color
+float luma(vec3 rgb)
+{
+  return sqrt(dot(rgb, vec3(0.299, 0.587, 0.114)));
+}
+
+void main()
+{
+  vec2 texel = 1.0 / vec2(textureSize(RT, 0));
+  vec2 uv = inPs.uv0.xy;
+  vec4 color = texture(RT, uv);
+
+  float lumaM = luma(color.rgb);
+  float lumaN = luma(textureOffset(RT, uv, ivec2(0, -1)).rgb);
+  float lumaS = luma(textureOffset(RT, uv, ivec2(0, 1)).rgb);
+  float lumaW = luma(textureOffset(RT, uv, ivec2(-1, 0)).rgb);
+  float lumaE = luma(textureOffset(RT, uv, ivec2(1, 0)).rgb);
+
+  // skip the pixels that are not on an edge
+  float lumaMin = min(lumaM, min(min(lumaN, lumaS), min(lumaW, lumaE)));
+  float lumaMax = max(lumaM, max(max(lumaN, lumaS), max(lumaW, lumaE)));
+  float range = lumaMax - lumaMin;
+  if (range < max(edgeThresholdMin, lumaMax * edgeThreshold))
+  {
+    fragColor = color;
+    return;
+  }
+
+  float lumaNW = luma(textureOffset(RT, uv, ivec2(-1, -1)).rgb);
+  float lumaNE = luma(textureOffset(RT, uv, ivec2(1, -1)).rgb);
+  float lumaSW = luma(textureOffset(RT, uv, ivec2(-1, 1)).rgb);
+  float lumaSE = luma(textureOffset(RT, uv, ivec2(1, 1)).rgb);
+
+  float lumaNS = lumaN + lumaS;
+  float lumaWE = lumaW + lumaE;
+  float lumaNWNE = lumaNW + lumaNE;
+  float lumaSWSE = lumaSW + lumaSE;
+  float lumaNWSW = lumaNW + lumaSW;
+  float lumaNESE = lumaNE + lumaSE;
+
+  // direction of the edge
+  float edgeHorizontal = abs(-2.0 * lumaW + lumaNWSW) +
+      2.0 * abs(-2.0 * lumaM + lumaNS) + abs(-2.0 * lumaE + lumaNESE);
+  float edgeVertical = abs(-2.0 * lumaN + lumaNWNE) +
+      2.0 * abs(-2.0 * lumaM + lumaWE) + abs(-2.0 * lumaS + lumaSWSE);
+  bool horizontal = edgeHorizontal >= edgeVertical;
+
+  // side of the edge with the steepest gradient
+  float luma1 = horizontal ? lumaN : lumaW;
+  float luma2 = horizontal ? lumaS : lumaE;
+  float gradient1 = luma1 - lumaM;
+  float gradient2 = luma2 - lumaM;
+  bool steepest1 = abs(gradient1) >= abs(gradient2);
+  float gradientScaled = 0.25 * max(abs(gradient1), abs(gradient2));
+
+  float stepLength = horizontal ? texel.y : texel.x;
+  float lumaLocalAverage = 0.5 * (luma2 + lumaM);
+  if (steepest1)
+  {
+    stepLength = -stepLength;
+    lumaLocalAverage = 0.5 * (luma1 + lumaM);
+  }
+
+  // search the ends of the edge, half a texel towards its steepest side
+  vec2 edgeUv = uv;
+  if (horizontal)
+    edgeUv.y += 0.5 * stepLength;
+  else
+    edgeUv.x += 0.5 * stepLength;
+  vec2 offset = horizontal ? vec2(texel.x, 0.0) : vec2(0.0, texel.y);
+
+  vec2 uv1 = edgeUv - offset;
+  vec2 uv2 = edgeUv + offset;
+  float lumaEnd1 = luma(texture(RT, uv1).rgb) - lumaLocalAverage;
+  float lumaEnd2 = luma(texture(RT, uv2).rgb) - lumaLocalAverage;
+  bool reached1 = abs(lumaEnd1) >= gradientScaled;
+  bool reached2 = abs(lumaEnd2) >= gradientScaled;
+  for (int i = 1; i < kSearchSteps && !(reached1 && reached2); ++i)
+  {
+    if (!reached1)
+    {
+      uv1 -= offset * kSearchStep[i];
+      lumaEnd1 = luma(texture(RT, uv1).rgb) - lumaLocalAverage;
+      reached1 = abs(lumaEnd1) >= gradientScaled;
+    }
+    if (!reached2)
+    {
+      uv2 += offset * kSearchStep[i];
+      lumaEnd2 = luma(texture(RT, uv2).rgb) - lumaLocalAverage;
+      reached2 = abs(lumaEnd2) >= gradientScaled;
+    }
+  }
+
+  // blend with the neighbour across the edge by the distance to the
+  // nearest end, if the luma varies towards that end as it does at the
+  // pixel
+  float distance1 = horizontal ? (uv.x - uv1.x) : (uv.y - uv1.y);
+  float distance2 = horizontal ? (uv2.x - uv.x) : (uv2.y - uv.y);
+  bool nearest1 = distance1 < distance2;
+  float pixelOffset = 0.5 - min(distance1, distance2) /
+      (distance1 + distance2);
+  bool lumaMSmaller = lumaM < lumaLocalAverage;
+  bool correctVariation =
+      ((nearest1 ? lumaEnd1 : lumaEnd2) < 0.0) != lumaMSmaller;
+  float finalOffset = correctVariation ? pixelOffset : 0.0;
+
+  // sub-pixel aliasing
+  float lumaAverage = (1.0 / 12.0) *
+      (2.0 * (lumaNS + lumaWE) + lumaNWSW + lumaNESE);
+  float subpixel = clamp(abs(lumaAverage - lumaM) / range, 0.0, 1.0);
+  subpixel = (-2.0 * subpixel + 3.0) * subpixel * subpixel;
+  finalOffset = max(finalOffset, subpixel * subpixel * subpixelQuality);
+
+  vec2 finalUv = uv;
+  if (horizontal)
+    finalUv.y += finalOffset * stepLength;
+  else
+    finalUv.x += finalOffset * stepLength;
+  fragColor = vec4(texture(RT, finalUv).rgb, color.a);
+}
@@ -31,6 +31,10 @@ uniform vec3 offsets;
 uniform float mean;
 // Standard deviation of the Gaussian distribution that we want to sample from.
 uniform float stddev;
+// Seed of the counter based noise, 0 to use the offsets instead
+uniform int seed;
+// Frame number, counter of the counter based noise
+uniform int frame;
 
 
 // input params from vertex shader
@@ -104,6 +108,46 @@ vec4 unpack(float color)
   return vec4(r/255.0, g/255.0, b/255.0, a/255.0);
 }
 
+// Counter based random numbers, used instead of the CPU-supplied offsets
+// when the pass is seeded. The noise of a pixel then only depends on the
+// seed, the frame number and the pixel coordinates, which makes it
+// reproducible. This is the Philox 2x32 generator with 10 rounds from
+// "Parallel random numbers: as easy as 1, 2, 3" (Salmon et al., 2011).
+uvec2 mulhilo(uint a, uint b)
+{
+  // 32 x 32 bit multiplication with a 64 bit result, umulExtended() needs
+  // GLSL 4.00
+  uint a0 = a & 0xFFFFu;
+  uint a1 = a >> 16u;
+  uint b0 = b & 0xFFFFu;
+  uint b1 = b >> 16u;
+  uint t = a1 * b0 + ((a0 * b0) >> 16u);
+  uint w = (t & 0xFFFFu) + a0 * b1;
+  return uvec2(a1 * b1 + (t >> 16u) + (w >> 16u), a * b);
+}
+
+uvec2 philox(uvec2 ctr, uint key)
+{
+  for (int i = 0; i < 10; ++i)
+  {
+    uvec2 hilo = mulhilo(0xD256D193u, ctr.x);
+    ctr = uvec2(hilo.x ^ key ^ ctr.y, hilo.y);
+    key += 0x9E3779B9u;
+  }
+  return ctr;
+}
+
+float seededGaussrand()
+{
+  uvec2 pixel = uvec2(gl_FragCoord.xy);
+  uvec2 r = philox(uvec2(pixel.x | (pixel.y << 16u), uint(frame)),
+      uint(seed));
+  // uniform values in (0, 1] and [0, 1) from the upper 24 bits
+  float U = (float(r.x >> 8u) + 1.0) / 16777216.0;
+  float V = float(r.y >> 8u) / 16777216.0;
+  return sqrt(-2.0 * log(U)) * cos(2.0 * PI * V) * stddev + mean;
+}
+
 void main()
 {
   // Add the sampled noise to the input x, y, z, rgba values
@@ -112,7 +156,8 @@ void main()
   vec4 p = texture(RT, inPs.uv0.xy);
 
   // gaussian noise
-  float z = gaussrand(inPs.uv0.xy).x;
+  float z = (seed != 0) ? seededGaussrand() :
+      gaussrand(inPs.uv0.xy).x;
 
   // apply noise to xyz
   vec3 xyz =  p.xyz + vec3(z, z, z);
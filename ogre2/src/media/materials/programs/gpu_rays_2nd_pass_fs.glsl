@@ -52,8 +52,107 @@ uniform sampler2D tex4;
 // cube face 5 -x
 uniform sampler2D tex5;
 
+// Scale of the range and retro values written to unsigned normalized 16 bit
+// targets, i.e. 1 / (resolution * 65535). Zero to write the values as is to
+// float targets.
+uniform vec2 packScale;
+
+// Clip planes and range of the readings beyond them, see
+// gpu_rays_1st_pass_fs.glsl
+uniform float near;
+uniform float far;
+uniform float rangeMin;
+uniform float rangeMax;
+
+// Gaussian range noise and dropout set from the GaussianNoisePass and
+// DropoutPass of the sensor. The random numbers are drawn as in
+// gaussian_noise_fs.glsl and dropout_fs.glsl: from CPU-supplied offsets, or
+// from the Philox counter based generator when the passes are seeded.
+uniform float noiseMean;
+uniform float noiseStddev;
+uniform vec3 noiseOffsets;
+uniform int noiseSeed;
+uniform float dropout;
+uniform float dropoutOffset;
+uniform int dropoutSeed;
+uniform int frame;
+
 out vec4 fragColor;
 
+#define PI 3.14159265358979323846264
+
+float rand(vec2 co)
+{
+  float r = fract(sin(dot(co.xy, vec2(12.9898,78.233))) * 43758.5453);
+  return (r == 0.0) ? 0.000000000001 : r;
+}
+
+uvec2 mulhilo(uint a, uint b)
+{
+  uint a0 = a & 0xFFFFu;
+  uint a1 = a >> 16u;
+  uint b0 = b & 0xFFFFu;
+  uint b1 = b >> 16u;
+  uint t = a1 * b0 + ((a0 * b0) >> 16u);
+  uint w = (t & 0xFFFFu) + a0 * b1;
+  return uvec2(a1 * b1 + (t >> 16u) + (w >> 16u), a * b);
+}
+
+uvec2 philox(uvec2 ctr, uint key)
+{
+  for (int i = 0; i < 10; ++i)
+  {
+    uvec2 hilo = mulhilo(0xD256D193u, ctr.x);
+    ctr = uvec2(hilo.x ^ key ^ ctr.y, hilo.y);
+    key += 0x9E3779B9u;
+  }
+  return ctr;
+}
+
+// Sample the Gaussian range noise of this ray
+float rangeNoise()
+{
+  float z;
+  if (noiseSeed != 0)
+  {
+    uvec2 pixel = uvec2(gl_FragCoord.xy);
+    uvec2 r = philox(uvec2(pixel.x | (pixel.y << 16u), uint(frame)),
+        uint(noiseSeed));
+    float U = (float(r.x >> 8u) + 1.0) / 16777216.0;
+    float V = float(r.y >> 8u) / 16777216.0;
+    z = sqrt(-2.0 * log(U)) * cos(2.0 * PI * V);
+  }
+  else
+  {
+    float U = rand(inPs.uv0 + vec2(noiseOffsets.x));
+    float V = rand(inPs.uv0 + vec2(noiseOffsets.y));
+    float R = rand(inPs.uv0 + vec2(noiseOffsets.z));
+    z = sqrt(-2.0 * log(U)) *
+        ((R < 0.5) ? sin(2.0 * PI * V) : cos(2.0 * PI * V));
+  }
+  return z * noiseStddev + noiseMean;
+}
+
+// Check if this ray is dropped
+bool dropped()
+{
+  float u;
+  if (dropoutSeed != 0)
+  {
+    // same key offset as dropout_fs.glsl
+    uvec2 pixel = uvec2(gl_FragCoord.xy);
+    uvec2 r = philox(uvec2(pixel.x | (pixel.y << 16u), uint(frame)),
+        uint(dropoutSeed) + 0x68E31DA4u);
+    u = float(r.x >> 8u) / 16777216.0;
+  }
+  else
+  {
+    u = fract(sin(dot(inPs.uv0 + vec2(dropoutOffset),
+        vec2(12.9898,78.233))) * 43758.5453);
+  }
+  return u < dropout;
+}
+
 vec2 getRange(vec2 uv, sampler2D tex)
 {
   vec2 range = texture(tex, uv).xy;
@@ -90,6 +189,24 @@ void main()
   float range = d.x;
   float retro = d.y;
 
+  // noise is only applied to hits, and noisy ranges stay within the clip
+  // planes. Dropped rays return no hit.
+  if ((noiseStddev > 0.0 || noiseMean != 0.0) && range > rangeMin &&
+      range < rangeMax)
+    range = clamp(range + rangeNoise(), near, far);
+  if (dropout > 0.0 && dropped())
+  {
+    range = rangeMax;
+    retro = 0.0;
+  }
+
+  // fixed point packing, values that do not fit saturate
+  if (packScale.x > 0.0)
+  {
+    range = clamp(range * packScale.x, 0.0, 1.0);
+    retro = clamp(retro * packScale.y, 0.0, 1.0);
+  }
+
   fragColor = vec4(range, retro, 0, 1.0);
   return;
 }
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version 330
+
+// Draws a level of an image pyramid from the previous, twice as large,
+// level. The output texel covers 2x2 texels of the input. The box filter
+// averages them with one bilinear tap at the corner they share. The
+// gaussian filter weights the 4x4 texels around it with the separable
+// [1 3 3 1] / 8 binomial kernel, with four bilinear taps 0.75 texels from
+// the shared corner.
+
+uniform sampler2D RT;
+
+// xy: size of a texel of the input, zw: unused
+uniform vec4 texelSize;
+
+// 0 for the box filter, 1 for the gaussian filter
+uniform float gaussian;
+
+in block
+{
+  vec2 uv0;
+} inPs;
+
+out vec4 fragColor;
+
+void main()
+{
+  if (gaussian < 0.5)
+  {
+    fragColor = texture(RT, inPs.uv0.xy);
+    return;
+  }
+
+  vec2 d = 0.75 * texelSize.xy;
+  fragColor = 0.25 * (texture(RT, inPs.uv0.xy + vec2(-d.x, -d.y)) +
+      texture(RT, inPs.uv0.xy + vec2(d.x, -d.y)) +
+      texture(RT, inPs.uv0.xy + vec2(-d.x, d.y)) +
+      texture(RT, inPs.uv0.xy + vec2(d.x, d.y)));
+}
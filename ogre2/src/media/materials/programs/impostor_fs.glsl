@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version 330
+
+in block
+{
+  vec2 uv0;
+} inPs;
+
+uniform sampler2D atlas;
+
+out vec4 fragColor;
+
+void main()
+{
+  // the views are cleared to transparent around the mesh
+  vec4 color = texture(atlas, inPs.uv0);
+  if (color.a < 0.5)
+    discard;
+  fragColor = vec4(color.rgb, 1.0);
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version 330
+
+in vec4 vertex;
+in vec2 uv0;
+
+uniform mat4 worldViewProj;
+uniform vec3 cameraPosition;
+uniform vec3 center;
+uniform float radius;
+uniform float gridSize;
+
+out gl_PerVertex
+{
+  vec4 gl_Position;
+};
+
+out block
+{
+  vec2 uv0;
+} outVs;
+
+vec2 signNotZero(vec2 v)
+{
+  return vec2(v.x < 0.0 ? -1.0 : 1.0, v.y < 0.0 ? -1.0 : 1.0);
+}
+
+void main()
+{
+  // cell of the atlas rendered from the closest direction to the camera,
+  // the directions being laid out with an octahedral mapping
+  vec3 dir = normalize(cameraPosition - center);
+  vec2 oct = dir.xy / (abs(dir.x) + abs(dir.y) + abs(dir.z));
+  if (dir.z < 0.0)
+    oct = (1.0 - abs(oct.yx)) * signNotZero(oct);
+  vec2 cell = clamp(floor((oct * 0.5 + 0.5) * gridSize), 0.0, gridSize - 1.0);
+
+  // direction and axes of the orthographic camera that rendered the cell,
+  // see Ogre2MeshFactory
+  vec2 f = (cell + 0.5) / gridSize * 2.0 - 1.0;
+  vec3 bakeDir = vec3(f, 1.0 - abs(f.x) - abs(f.y));
+  if (bakeDir.z < 0.0)
+    bakeDir.xy = (1.0 - abs(f.yx)) * signNotZero(f);
+  bakeDir = normalize(bakeDir);
+  vec3 up = abs(bakeDir.z) > 0.99 ? vec3(1.0, 0.0, 0.0) : vec3(0.0, 0.0, 1.0);
+  vec3 right = normalize(cross(up, bakeDir));
+  up = cross(bakeDir, right);
+
+  // spread the corners, all at the center of the mesh, to cover the view
+  vec3 pos = center +
+      (right * (uv0.x * 2.0 - 1.0) + up * (1.0 - uv0.y * 2.0)) * radius;
+  gl_Position = worldViewProj * vec4(pos, 1.0);
+  outVs.uv0 = (cell + uv0) / gridSize;
+}
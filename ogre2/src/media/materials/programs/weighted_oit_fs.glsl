@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version 330
+
+// Composite the transparent materials accumulated with weighted blended
+// order independent transparency over the opaque scene, see
+// Ogre2WeightedOitListener. The textures are the attachments of the
+// texture the scene is drawn to, at the same pixels as the target.
+
+// Opaque color attenuated by the transparent materials, alpha is 1 where
+// opaque materials were drawn and the coverage of the transparent
+// materials elsewhere
+uniform sampler2D opaqueTexture;
+// Sum of the weighted premultiplied colors of the transparent materials
+uniform sampler2D accumTexture;
+// Sum of the weights in r and of the optical depths in g
+uniform sampler2D weightTexture;
+// Color the target is cleared to, shown where nothing is drawn
+uniform vec4 backgroundColor;
+
+out vec4 fragColor;
+
+void main()
+{
+  ivec2 pixel = ivec2(gl_FragCoord.xy);
+  vec4 opaque = texelFetch(opaqueTexture, pixel, 0);
+  vec3 accum = texelFetch(accumTexture, pixel, 0).rgb;
+  vec2 weight = texelFetch(weightTexture, pixel, 0).rg;
+
+  float coverage = 1.0 - exp(-weight.g);
+  vec3 average = accum / max(weight.r, 1e-5);
+  float background = 1.0 - opaque.a;
+
+  fragColor.rgb = opaque.rgb + backgroundColor.rgb * background +
+      average * coverage;
+  fragColor.a = opaque.a + backgroundColor.a * background;
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version 330
+
+// Wide angle camera: each pixel samples the cubemap face and uv coordinates
+// packed in a texture computed by Ogre2WideAngleCamera. Pixels out of the
+// field of view of the projection have a negative face index and are black.
+
+uniform sampler2D sampleTex;
+uniform sampler2D tex0;
+uniform sampler2D tex1;
+uniform sampler2D tex2;
+uniform sampler2D tex3;
+uniform sampler2D tex4;
+uniform sampler2D tex5;
+
+in block
+{
+  vec2 uv0;
+} inPs;
+
+out vec4 fragColor;
+
+void main()
+{
+  vec3 data = texture(sampleTex, inPs.uv0.xy).xyz;
+  int faceIdx = int(data.z + 0.5);
+  vec2 uv = data.xy;
+
+  if (data.z < 0.0)
+    fragColor = vec4(0.0, 0.0, 0.0, 1.0);
+  else if (faceIdx == 0)
+    fragColor = texture(tex0, uv);
+  else if (faceIdx == 1)
+    fragColor = texture(tex1, uv);
+  else if (faceIdx == 2)
+    fragColor = texture(tex2, uv);
+  else if (faceIdx == 3)
+    fragColor = texture(tex3, uv);
+  else if (faceIdx == 4)
+    fragColor = texture(tex4, uv);
+  else
+    fragColor = texture(tex5, uv);
+}
@@ -45,6 +45,35 @@ namespace ignition
 
       public: virtual void Render();
 
+      /// \brief Set whether to accumulate samples across frames. While the
+      /// camera and the scene do not change, each frame traces new samples
+      /// at jittered positions in the pixels and the image is the average
+      /// of all the frames since the last change.
+      /// \param[in] _enable True to accumulate samples across frames
+      /// \sa OptixScene::MarkChanged
+      public: void SetAccumulation(bool _enable);
+
+      /// \brief Get whether samples are accumulated across frames
+      /// \return True if samples are accumulated
+      public: bool Accumulation() const;
+
+      /// \brief Get the number of frames averaged in the current image
+      /// \return Number of frames accumulated since the last change
+      public: unsigned int AccumulatedFrameCount() const;
+
+      /// \brief Restart the accumulation on the next frame, e.g. after a
+      /// change the scene does not detect
+      public: void ResetAccumulation();
+
+      /// \brief Set whether to run the OptiX AI denoiser on the accumulated
+      /// image. This requires OptiX 5 or later and accumulation to be on.
+      /// \param[in] _enable True to denoise the image
+      public: void SetDenoise(bool _enable);
+
+      /// \brief Get whether the image is denoised
+      /// \return True if the image is denoised
+      public: bool Denoise() const;
+
       protected: virtual RenderTargetPtr RenderTarget() const;
 
       protected: virtual void WriteCameraToDevice();
@@ -66,12 +95,61 @@ namespace ignition
 
       protected: virtual void CreateErrorProgram();
 
+      /// \brief Create the programs accumulating and resolving the samples
+      protected: virtual void CreateAccumulateProgram();
+
+      /// \brief Resize the accumulation buffers to the image size
+      /// \return True if the buffers were resized
+      protected: bool ResizeAccumulation();
+
+      /// \brief Accumulate the samples traced in this frame, and denoise
+      /// the average if requested
+      protected: void Accumulate();
+
       protected: optix::Program optixRenderProgram;
 
       protected: optix::Program optixClearProgram;
 
       protected: optix::Program optixErrorProgram;
 
+      /// \brief Program adding the samples of a frame to the sum
+      protected: optix::Program optixAccumulateProgram;
+
+      /// \brief Program copying the denoised image to the render texture
+      protected: optix::Program optixResolveProgram;
+
+      /// \brief Sum of the samples of the accumulated frames
+      protected: optix::Buffer optixAccumBuffer;
+
+      /// \brief Average of the accumulated frames, input of the denoiser
+      protected: optix::Buffer optixAverageBuffer;
+
+      /// \brief Output of the denoiser
+      protected: optix::Buffer optixDenoisedBuffer;
+
+#if OPTIX_VERSION >= 50000
+      /// \brief OptiX AI denoiser stage
+      protected: optix::PostprocessingStage optixDenoiser;
+
+      /// \brief Accumulate, denoise and resolve launches
+      protected: optix::CommandList optixDenoiseCommands;
+#endif
+
+      /// \brief True to accumulate samples across frames
+      protected: bool accumulation = false;
+
+      /// \brief True to denoise the accumulated image
+      protected: bool denoise = false;
+
+      /// \brief True if the denoise command list must be rebuilt
+      protected: bool denoiseDirty = true;
+
+      /// \brief Number of frames accumulated since the last change
+      protected: unsigned int accumulatedFrames = 0u;
+
+      /// \brief Change count of the scene when the accumulation started
+      protected: unsigned int sceneChangeCount = 0u;
+
       protected: OptixRenderTexturePtr renderTexture;
 
       protected: bool cameraDirty;
@@ -80,12 +158,22 @@ namespace ignition
 
       protected: unsigned int clearId;
 
+      /// \brief Entry point of the program accumulating the samples
+      protected: unsigned int accumulateId = 0u;
+
+      /// \brief Entry point of the program resolving the denoised image
+      protected: unsigned int resolveId = 0u;
+
       private: static const std::string PTX_BASE_NAME;
 
       private: static const std::string PTX_RENDER_FUNCTION;
 
       private: static const std::string PTX_CLEAR_FUNCTION;
 
+      private: static const std::string PTX_ACCUMULATE_FUNCTION;
+
+      private: static const std::string PTX_RESOLVE_FUNCTION;
+
       private: friend class OptixScene;
     };
     }
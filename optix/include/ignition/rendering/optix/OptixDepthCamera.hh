@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OPTIX_OPTIXDEPTHCAMERA_HH_
+#define IGNITION_RENDERING_OPTIX_OPTIXDEPTHCAMERA_HH_
+
+#include <string>
+#include <vector>
+
+#include <ignition/common/Event.hh>
+
+#include "ignition/rendering/base/BaseDepthCamera.hh"
+#include "ignition/rendering/optix/OptixIncludes.hh"
+#include "ignition/rendering/optix/OptixRenderTypes.hh"
+#include "ignition/rendering/optix/OptixSensor.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Optix implementation of the depth camera. One ray is traced
+    /// per pixel against the root group of the scene, so the depth camera
+    /// shares the acceleration structures built for the other cameras and
+    /// gpu rays of the scene. The depth and the point cloud have the layout
+    /// and the out of range values of the ogre2 depth camera. The color of
+    /// the point cloud is only traced while it has subscribers.
+    class IGNITION_RENDERING_OPTIX_VISIBLE OptixDepthCamera :
+      public BaseDepthCamera<OptixSensor>
+    {
+      /// \brief Constructor
+      protected: OptixDepthCamera();
+
+      /// \brief Destructor
+      public: virtual ~OptixDepthCamera();
+
+      // Documentation inherited.
+      public: virtual void Init() override;
+
+      // Documentation inherited.
+      public: virtual void CreateDepthTexture() override;
+
+      // Documentation inherited.
+      public: virtual void SetHFOV(const math::Angle &_angle) override;
+
+      // Documentation inherited.
+      public: virtual void PreRender() override;
+
+      // Documentation inherited.
+      public: virtual void Render() override;
+
+      // Documentation inherited.
+      public: virtual void PostRender() override;
+
+      // Documentation inherited.
+      public: virtual const float *DepthData() const override;
+
+      // Documentation inherited.
+      public: virtual ignition::common::ConnectionPtr ConnectNewDepthFrame(
+          std::function<void(const float *, unsigned int, unsigned int,
+          unsigned int, const std::string &)>  _subscriber) override;
+
+      // Documentation inherited.
+      public: virtual ignition::common::ConnectionPtr ConnectNewRgbPointCloud(
+          std::function<void(const float *, unsigned int, unsigned int,
+          unsigned int, const std::string &)>  _subscriber) override;
+
+      // Documentation inherited.
+      protected: virtual RenderTargetPtr RenderTarget() const override;
+
+      // Documentation inherited.
+      protected: virtual void WritePoseToDeviceImpl() override;
+
+      /// \brief Resize the device buffers to the image size
+      protected: virtual void ResizeBuffers();
+
+      /// \brief Program tracing the rays of the pixels
+      protected: optix::Program optixDepthProgram;
+
+      /// \brief Depth of each pixel
+      protected: optix::Buffer optixDepthBuffer;
+
+      /// \brief Point and packed color of each pixel
+      protected: optix::Buffer optixPointCloudBuffer;
+
+      /// \brief Render texture holding the image size, the data is written
+      /// to the buffers of the depth camera
+      protected: OptixRenderTexturePtr renderTexture;
+
+      /// \brief Event triggered when a new depth frame is available
+      protected: common::EventT<void(const float *, unsigned int,
+                 unsigned int, unsigned int, const std::string &)>
+                 newDepthFrame;
+
+      /// \brief Event triggered when a new point cloud is available
+      protected: common::EventT<void(const float *, unsigned int,
+                 unsigned int, unsigned int, const std::string &)>
+                 newRgbPointCloud;
+
+      /// \brief Depth data of the last frame
+      protected: std::vector<float> depthImage;
+
+      /// \brief Point cloud data of the last frame
+      protected: std::vector<float> pointCloudImage;
+
+      /// \brief Width of the device buffers
+      protected: unsigned int bufferWidth = 0u;
+
+      /// \brief Height of the device buffers
+      protected: unsigned int bufferHeight = 0u;
+
+      /// \brief True if the colors were traced in the last frame
+      protected: bool pointCloud = false;
+
+      /// \brief Entry point of the depth program
+      protected: unsigned int depthId = 0u;
+
+      private: static const std::string PTX_BASE_NAME;
+
+      private: static const std::string PTX_DEPTH_FUNCTION;
+
+      private: friend class OptixScene;
+    };
+    }
+  }
+}
+#endif
@@ -44,6 +44,10 @@ namespace ignition
 
       protected: virtual void SetScale(math::Vector3d _scale);
 
+      /// \brief Set the laser retro returned to the gpu rays sensors
+      /// \param[in] _retro Laser retro, normalized to [0, 1]
+      protected: virtual void SetRetro(float _retro);
+
       protected: OptixVisualPtr parent;
 
       private: friend class OptixVisual;
@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OPTIX_OPTIXGPURAYS_HH_
+#define IGNITION_RENDERING_OPTIX_OPTIXGPURAYS_HH_
+
+#include <string>
+#include <vector>
+
+#include <ignition/common/Event.hh>
+
+#include "ignition/rendering/base/BaseGpuRays.hh"
+#include "ignition/rendering/optix/OptixIncludes.hh"
+#include "ignition/rendering/optix/OptixRenderTypes.hh"
+#include "ignition/rendering/optix/OptixSensor.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Optix implementation of the gpu rays sensor. Unlike the ogre
+    /// implementations, which render a cubemap and sample it, one ray is
+    /// traced per beam, in the direction given by the horizontal and
+    /// vertical angles of the beam. The range and the laser retro of each
+    /// beam are written to a device buffer, in the layout of the ogre2 gpu
+    /// rays data. The sensor can also report several returns per beam,
+    /// each return being the next surface hit by the beam.
+    class IGNITION_RENDERING_OPTIX_VISIBLE OptixGpuRays :
+      public BaseGpuRays<OptixSensor>
+    {
+      /// \brief Constructor
+      protected: OptixGpuRays();
+
+      /// \brief Destructor
+      public: virtual ~OptixGpuRays();
+
+      // Documentation inherited.
+      public: virtual void Init() override;
+
+      // Documentation inherited.
+      public: virtual void PreRender() override;
+
+      // Documentation inherited.
+      public: virtual void Render() override;
+
+      // Documentation inherited.
+      public: virtual void PostRender() override;
+
+      // Documentation inherited.
+      public: virtual const float *Data() const override;
+
+      // Documentation inherited.
+      public: virtual void Copy(float *_data) override;
+
+      // Documentation inherited.
+      public: virtual common::ConnectionPtr ConnectNewGpuRaysFrame(
+                  std::function<void(const float *_frame, unsigned int _width,
+                  unsigned int _height, unsigned int _channels,
+                  const std::string &_format)> _subscriber) override;
+
+      /// \brief Set the number of returns reported per beam. The first
+      /// return is the closest surface, the following ones are the next
+      /// surfaces hit by the beam. Beams with fewer surfaces report the
+      /// maximum range for the missing returns. Defaults to 1.
+      /// \param[in] _count Number of returns, at least 1
+      public: void SetReturnCount(unsigned int _count);
+
+      /// \brief Get the number of returns reported per beam
+      /// \return Number of returns
+      public: unsigned int ReturnCount() const;
+
+      /// \brief Get the data of one of the returns of the last frame, in
+      /// the layout of Data(). Data() and the new frame event give the
+      /// first return.
+      /// \param[in] _index Index of the return
+      /// \return Data of the return, null if the index is out of range or
+      /// no frame was rendered yet
+      public: const float *ReturnData(unsigned int _index) const;
+
+      // Documentation inherited.
+      public: virtual RenderTargetPtr RenderTarget() const override;
+
+      /// \brief Create the ray generation program and its buffers
+      protected: virtual void CreateRangeProgram();
+
+      /// \brief Write the ray angles to the device when they changed
+      protected: virtual void WriteAnglesToDevice();
+
+      // Documentation inherited.
+      protected: virtual void WritePoseToDeviceImpl() override;
+
+      /// \brief Get the number of beams per row of the data
+      /// \return Number of horizontal beams
+      protected: unsigned int DataWidth() const;
+
+      /// \brief Get the number of rows of the data
+      /// \return Number of vertical beams
+      protected: unsigned int DataHeight() const;
+
+      /// \brief Program tracing the rays of the beams
+      protected: optix::Program optixRangeProgram;
+
+      /// \brief Sines and cosines of the horizontal angles
+      protected: optix::Buffer optixHAngleBuffer;
+
+      /// \brief Sines and cosines of the vertical angles
+      protected: optix::Buffer optixVAngleBuffer;
+
+      /// \brief Range, retro and an unused channel of each beam and return
+      protected: optix::Buffer optixRangeBuffer;
+
+      /// \brief Dummy render texture
+      protected: OptixRenderTexturePtr renderTexture;
+
+      /// \brief Event triggered when a new frame is available
+      protected: common::EventT<void(const float *, unsigned int,
+                 unsigned int, unsigned int, const std::string &)>
+                 newGpuRaysFrame;
+
+      /// \brief Data of the last frame, the returns one after the other
+      protected: std::vector<float> gpuRaysScan;
+
+      /// \brief Angles the angle buffers were computed for
+      protected: std::vector<double> angleKey;
+
+      /// \brief Number of horizontal beams of the range buffer
+      protected: unsigned int bufferWidth = 0u;
+
+      /// \brief Number of vertical beams of the range buffer
+      protected: unsigned int bufferHeight = 0u;
+
+      /// \brief Number of returns of the range buffer
+      protected: unsigned int bufferReturnCount = 0u;
+
+      /// \brief Number of returns per beam
+      protected: unsigned int returnCount = 1u;
+
+      /// \brief Number of returns of the data of the last frame
+      protected: unsigned int scanReturnCount = 0u;
+
+      /// \brief Entry point of the range program
+      protected: unsigned int rangeId = 0u;
+
+      private: static const std::string PTX_BASE_NAME;
+
+      private: static const std::string PTX_RANGE_FUNCTION;
+
+      private: friend class OptixScene;
+    };
+    }
+  }
+}
+#endif
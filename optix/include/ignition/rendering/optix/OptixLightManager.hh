@@ -53,14 +53,24 @@ namespace ignition
 
       protected: virtual void WriteSpotBuffer();
 
+      /// \brief Upload the lights of a type if they changed since the last
+      /// upload. The buffer grows by doubling its capacity, and the number
+      /// of lights is written to a context variable.
+      /// \param[in] _buffer Buffer of the lights
+      /// \param[in] _data Lights of this frame
+      /// \param[in,out] _written Lights of the last upload
+      /// \param[in] _countName Name of the variable holding the number of
+      /// lights
       protected: template <class T>
                  void WriteBuffer(optix::Buffer _buffer,
-                     const std::vector<T> &_data);
+                     const std::vector<T> &_data, std::vector<T> &_written,
+                     const std::string &_countName);
 
       private: void CreateBuffers();
 
       private: template <class T>
-               optix::Buffer CreateBuffer(const std::string &_name);
+               optix::Buffer CreateBuffer(const std::string &_name,
+                   const std::string &_countName);
 
       protected: OptixScenePtr scene;
 
@@ -70,6 +80,15 @@ namespace ignition
 
       protected: std::vector<OptixSpotLightData> spotData;
 
+      /// \brief Directional lights of the last upload
+      protected: std::vector<OptixDirectionalLightData> writtenDirectionalData;
+
+      /// \brief Point lights of the last upload
+      protected: std::vector<OptixPointLightData> writtenPointData;
+
+      /// \brief Spot lights of the last upload
+      protected: std::vector<OptixSpotLightData> writtenSpotData;
+
       protected: optix::Buffer directionalBuffer;
 
       protected: optix::Buffer pointBuffer;
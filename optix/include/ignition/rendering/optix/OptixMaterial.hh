@@ -141,6 +141,9 @@ namespace ignition
 
       private: static const std::string PTX_ANY_HIT_FUNC;
 
+      /// \brief Closest hit program of the rays of the gpu rays sensors
+      private: static const std::string PTX_RANGE_CLOSEST_HIT_FUNC;
+
       private: friend class OptixScene;
     };
     }
@@ -43,6 +43,18 @@ namespace ignition
 
       public: virtual optix::Acceleration OptixAccel() const;
 
+      /// \brief Set the OptiX builder of the acceleration of the mesh, e.g.
+      /// "Trbvh", the default which builds fast, or "Sbvh" which traces
+      /// faster but builds slowly. The acceleration is shared by all meshes
+      /// created from the same mesh descriptor, so this applies to all of
+      /// them.
+      /// \param[in] _builder Name of the OptiX acceleration builder
+      public: void SetAccelBuilder(const std::string &_builder);
+
+      /// \brief Get the OptiX builder of the acceleration of the mesh
+      /// \return Name of the OptiX acceleration builder
+      public: std::string AccelBuilder() const;
+
       protected: virtual SubMeshStorePtr SubMeshes() const;
 
       protected: OptixSubMeshStorePtr subMeshes;
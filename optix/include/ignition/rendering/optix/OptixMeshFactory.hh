@@ -19,6 +19,7 @@
 
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <ignition/common/Mesh.hh>
 
 #include "ignition/rendering/MeshDescriptor.hh"
@@ -32,6 +33,21 @@ namespace ignition
   {
     inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
     //
+    /// \brief Device data shared by the mesh geometries of a scene
+    class IGNITION_RENDERING_OPTIX_VISIBLE OptixMeshGeometryCache
+    {
+      /// \brief Vertex, normal, texture coordinate and index buffers, keyed
+      /// by their format, size and a hash of their content, so that
+      /// submeshes with the same data share them
+      public: std::unordered_map<std::string, optix::Buffer> buffers;
+
+      /// \brief Intersection program of all the mesh geometries
+      public: optix::Program intersectProgram;
+
+      /// \brief Bounding box program of all the mesh geometries
+      public: optix::Program boundsProgram;
+    };
+
     class IGNITION_RENDERING_OPTIX_VISIBLE OptixSubMeshStoreFactory
     {
       // cppcheck-suppress noExplicitConstructor
@@ -49,6 +65,9 @@ namespace ignition
 
       protected: std::map<std::string, optix::Geometry> geometries;
 
+      /// \brief Device data shared by the geometries
+      protected: OptixMeshGeometryCache geometryCache;
+
       protected: OptixScenePtr scene;
     };
 
@@ -63,6 +82,26 @@ namespace ignition
 
       protected: virtual OptixMeshPtr Create(OptixSubMeshStorePtr _subMeshes);
 
+      /// \brief Create a mesh using an existing acceleration. The
+      /// acceleration must have been built over the same geometries, in the
+      /// same order, which lets meshes loaded many times be instanced by
+      /// their transforms instead of building an acceleration each.
+      /// \param[in] _subMeshes Submeshes of the mesh
+      /// \param[in] _accel Acceleration of the geometries of the submeshes
+      /// \return The created mesh
+      protected: virtual OptixMeshPtr Create(OptixSubMeshStorePtr _subMeshes,
+                     optix::Acceleration _accel);
+
+      /// \brief Get the acceleration shared by the meshes created from a
+      /// mesh descriptor, creating it on first use
+      /// \param[in] _desc Mesh descriptor
+      /// \return The shared acceleration
+      protected: virtual optix::Acceleration Accel(
+                     const MeshDescriptor &_desc);
+
+      /// \brief Accelerations shared by the meshes with the same geometries
+      protected: std::map<std::string, optix::Acceleration> accels;
+
       protected: OptixSubMeshStoreFactory subMeshStoreFactory;
 
       protected: OptixScenePtr scene;
@@ -73,6 +112,15 @@ namespace ignition
       public: OptixMeshGeometryFactory(OptixScenePtr _scene,
                   const common::SubMesh &_subMesh);
 
+      /// \brief Constructor of a factory reusing the buffers and programs
+      /// of other geometries
+      /// \param[in] _scene Scene of the geometry
+      /// \param[in] _subMesh Submesh to create the geometry of
+      /// \param[in] _cache Device data shared by the geometries
+      public: OptixMeshGeometryFactory(OptixScenePtr _scene,
+                  const common::SubMesh &_subMesh,
+                  OptixMeshGeometryCache &_cache);
+
       public: virtual ~OptixMeshGeometryFactory();
 
       public: virtual optix::Geometry Create();
@@ -87,11 +135,25 @@ namespace ignition
 
       protected: virtual optix::Buffer CreateIndexBuffer();
 
+      /// \brief Create a buffer, or reuse a cached buffer with the same
+      /// content
+      /// \param[in] _format Format of the elements
+      /// \param[in] _data Elements to copy to the buffer
+      /// \param[in] _elementSize Size of an element in bytes
+      /// \param[in] _count Number of elements
+      /// \return The buffer
+      protected: optix::Buffer CreateBuffer(RTformat _format,
+                     const void *_data, size_t _elementSize,
+                     unsigned int _count);
+
       protected: OptixScenePtr scene;
 
       protected: const common::SubMesh &subMesh;
 
       protected: optix::Geometry optixGeometry;
+
+      /// \brief Device data shared by the geometries, null if not shared
+      protected: OptixMeshGeometryCache *cache = nullptr;
     };
     }
   }
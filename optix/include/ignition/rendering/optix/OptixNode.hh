@@ -67,6 +67,16 @@ namespace ignition
 
       protected: virtual void SetParent(OptixNodePtr _parent);
 
+      /// \brief Mark the acceleration of the children of this node, and of
+      /// its ancestors, to be updated before the next launch. Transform
+      /// only changes refit the existing acceleration, while structural
+      /// changes rebuild it.
+      /// \param[in] _rebuild True if children were added or removed
+      protected: void MarkAccelDirty(bool _rebuild);
+
+      /// \brief Update the acceleration if it was marked dirty
+      protected: void WriteAccelToDevice();
+
       protected: virtual void Init() override;
 
       protected: virtual NodeStorePtr Children() const override;
@@ -83,6 +93,12 @@ namespace ignition
 
       protected: optix::Acceleration optixAccel;
 
+      /// \brief True if the acceleration must be updated
+      protected: bool accelDirty = true;
+
+      /// \brief True if the acceleration must be rebuilt, not refitted
+      protected: bool accelRebuild = true;
+
       protected: math::Pose3d pose;
 
       protected: bool poseDirty;
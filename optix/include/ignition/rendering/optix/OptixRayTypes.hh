@@ -32,7 +32,8 @@ namespace ignition
   {
     RT_RADIANCE = 0,
     RT_SHADOW   = 1,
-    RT_COUNT    = 2,
+    RT_RANGE    = 2,
+    RT_COUNT    = 3,
   } OptixRayType;
 
   struct OptixRadianceRayData
@@ -49,6 +50,14 @@ namespace ignition
     float3 attenuation;
   };
 
+  struct OptixRangeRayData
+  {
+    // cppcheck-suppress unusedStructMember
+    float distance;
+    // cppcheck-suppress unusedStructMember
+    float retro;
+  };
+
 #ifndef __CUDA_ARCH__
   }
   }
@@ -65,12 +65,24 @@ namespace ignition
 
       public: std::string PtxFile(const std::string& _fileBase) const;
 
+      /// \brief Get the CUDA device the scenes render on
+      /// \return Index of the device, -1 if optix picks the devices
+      public: int Device() const;
+
       protected: virtual ScenePtr CreateSceneImpl(unsigned int _id,
                   const std::string &_name);
 
       protected: virtual SceneStorePtr Scenes() const;
 
-      // Documentation Inherited
+      /// \brief Engine implementation of Load function.
+      /// \param[in] _params Parameters to be passed to the render engine.
+      /// Currently accepts the following parameters and values:
+      /// "device" : Index of the CUDA device to render on, among the
+      ///            devices visible to the process. By default optix uses
+      ///            all the compatible devices.
+      /// "rtx"    : "1" (default) to trace rays with the ray tracing cores
+      ///            of the GPU when it has them, "0" to use the compute
+      ///            path. Requires OptiX 5.1 or later.
       protected: virtual bool LoadImpl(
           const std::map<std::string, std::string> &_params) override;
 
@@ -78,6 +90,9 @@ namespace ignition
 
       private: OptixSceneStorePtr scenes;
 
+      /// \brief CUDA device the scenes render on, -1 for all devices
+      private: int device = -1;
+
       private: static const std::string PTX_PREFIX;
 
       private: static const std::string PTX_SUFFIX;
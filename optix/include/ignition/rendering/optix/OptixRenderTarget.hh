@@ -35,12 +35,22 @@ namespace ignition
 
       public: virtual ~OptixRenderTarget();
 
+      /// \brief Copy the rendered image, converting its colors to 8 bits.
+      /// The conversion runs on the device when the render target supports
+      /// it, so that only the 8 bit image is read back, and on the host
+      /// otherwise.
+      /// \param[out] _image Image to copy the rendered image to
       public: virtual void Copy(Image &_image) const;
 
       public: virtual optix::Buffer OptixBuffer() const = 0;
 
       protected: unsigned int MemorySize() const;
 
+      /// \brief Convert the colors to 8 bits on the device and copy them.
+      /// \param[out] _image Image to copy the rendered image to
+      /// \return False if the device conversion is not available
+      protected: virtual bool CopyQuantized(Image &_image) const;
+
       protected: float *hostData;
     };
 
@@ -55,10 +65,25 @@ namespace ignition
 
       public: virtual optix::Buffer OptixBuffer() const;
 
+      // Documentation inherited.
+      protected: virtual bool CopyQuantized(Image &_image) const override;
+
       protected: virtual void RebuildImpl();
 
+      /// \brief Create the program converting the colors to 8 bits
+      protected: void CreateQuantizeProgram();
+
       protected: optix::Buffer optixBuffer;
 
+      /// \brief Buffer of the colors converted to 8 bits on the device
+      protected: optix::Buffer quantizedBuffer;
+
+      /// \brief Program converting the colors to 8 bits
+      protected: optix::Program quantizeProgram;
+
+      /// \brief Entry point of the program converting the colors
+      protected: unsigned int quantizeId = 0u;
+
       protected: virtual void Init();
 
       private: friend class OptixScene;
@@ -31,8 +31,10 @@ namespace ignition
     class OptixCamera;
     class OptixCone;
     class OptixCylinder;
+    class OptixDepthCamera;
     class OptixDirectionalLight;
     class OptixGeometry;
+    class OptixGpuRays;
     class OptixGrid;
     class OptixJointVisual;
     class OptixLight;
@@ -48,6 +50,7 @@ namespace ignition
     class OptixSensor;
     class OptixSphere;
     class OptixSpotLight;
+    class OptixTextureFactory;
     class OptixSubMesh;
     class OptixVisual;
     class OptixRenderTarget;
@@ -70,8 +73,10 @@ namespace ignition
     typedef shared_ptr<OptixCamera>               OptixCameraPtr;
     typedef shared_ptr<OptixCone>                 OptixConePtr;
     typedef shared_ptr<OptixCylinder>             OptixCylinderPtr;
+    typedef shared_ptr<OptixDepthCamera>          OptixDepthCameraPtr;
     typedef shared_ptr<OptixDirectionalLight>     OptixDirectionalLightPtr;
     typedef shared_ptr<OptixGeometry>             OptixGeometryPtr;
+    typedef shared_ptr<OptixGpuRays>              OptixGpuRaysPtr;
     typedef shared_ptr<OptixGrid>                 OptixGridPtr;
     typedef shared_ptr<OptixJointVisual>          OptixJointVisualPtr;
     typedef shared_ptr<OptixLight>                OptixLightPtr;
@@ -86,6 +91,7 @@ namespace ignition
     typedef shared_ptr<OptixSensor>               OptixSensorPtr;
     typedef shared_ptr<OptixSphere>               OptixSpherePtr;
     typedef shared_ptr<OptixSpotLight>            OptixSpotLightPtr;
+    typedef shared_ptr<OptixTextureFactory>       OptixTextureFactoryPtr;
     typedef shared_ptr<OptixSubMesh>              OptixSubMeshPtr;
     typedef shared_ptr<OptixVisual>               OptixVisualPtr;
     typedef shared_ptr<OptixSceneStore>           OptixSceneStorePtr;
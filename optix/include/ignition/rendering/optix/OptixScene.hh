@@ -59,6 +59,9 @@ namespace ignition
 
       public: virtual void PreRender();
 
+      // Documentation inherited.
+      public: virtual void SetIncrementalPreRender(bool _enabled) override;
+
       public: virtual void Clear();
 
       public: virtual void Destroy();
@@ -67,9 +70,23 @@ namespace ignition
 
       public: virtual optix::Context OptixContext() const;
 
+      /// \brief Get the factory creating the shared texture samplers of
+      /// the materials of the scene
+      /// \return The texture factory
+      public: virtual OptixTextureFactoryPtr TextureFactory() const;
+
       public: virtual optix::Program CreateOptixProgram(
                   const std::string &_fileBase, const std::string &_function);
 
+      /// \brief Notify the scene that what it renders changed, e.g. a pose,
+      /// a geometry or a material. Cameras accumulating samples across
+      /// frames restart when this happens.
+      public: virtual void MarkChanged();
+
+      /// \brief Get the number of times the scene changed
+      /// \return Counter incremented by MarkChanged
+      public: virtual unsigned int ChangeCount() const;
+
       protected: virtual bool LoadImpl();
 
       protected: virtual bool InitImpl();
@@ -90,6 +107,10 @@ namespace ignition
       protected: virtual DepthCameraPtr CreateDepthCameraImpl(unsigned int _id,
                      const std::string &_name) override;
 
+      // Documentation inherited
+      protected: virtual GpuRaysPtr CreateGpuRaysImpl(unsigned int _id,
+                     const std::string &_name) override;
+
       protected: virtual VisualPtr CreateVisualImpl(unsigned int _id,
                      const std::string &_name);
 
@@ -158,6 +179,9 @@ namespace ignition
 
       private: void CreateMeshFactory();
 
+      /// \brief Create the texture factory
+      private: void CreateTextureFactory();
+
       private: void CreateStores();
 
       private: OptixScenePtr SharedThis();
@@ -168,6 +192,9 @@ namespace ignition
 
       protected: OptixMeshFactoryPtr meshFactory;
 
+      /// \brief Factory creating the shared texture samplers
+      protected: OptixTextureFactoryPtr textureFactory;
+
       protected: OptixLightStorePtr lights;
 
       protected: OptixSensorStorePtr sensors;
@@ -194,6 +221,9 @@ namespace ignition
 
       protected: math::Color ambientLight;
 
+      /// \brief Number of times the scene changed
+      protected: unsigned int changeCount = 0u;
+
       private: friend class OptixRenderEngine;
     };
     }
@@ -18,6 +18,7 @@
 #define IGNITION_RENDERING_OPTIX_OPTIXTEXTUREFACTORY_HH_
 
 #include <string>
+#include <unordered_map>
 #include "ignition/rendering/optix/OptixRenderTypes.hh"
 #include "ignition/rendering/optix/OptixIncludes.hh"
 #include "ignition/rendering/optix/Export.hh"
@@ -28,16 +29,31 @@ namespace ignition
   {
     inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
     //
+    /// \brief Creates the texture samplers of the materials. Samplers are
+    /// cached by filename, so materials using the same image share one
+    /// buffer and one sampler, and the image is only loaded once.
     class IGNITION_RENDERING_OPTIX_VISIBLE OptixTextureFactory
     {
       public: explicit OptixTextureFactory(OptixScenePtr _scene);
 
       public: virtual ~OptixTextureFactory();
 
+      /// \brief Get the sampler of an image, loading it on first use. The
+      /// sampler is shared, release it with Destroy instead of destroying
+      /// it.
+      /// \param[in] _filename Path to the image
+      /// \return Sampler of the image
       public: optix::TextureSampler Create(const std::string &_filename);
 
+      /// \brief Get the sampler of an empty texture, shared the same way
+      /// \return Sampler of an empty texture
       public: optix::TextureSampler Create();
 
+      /// \brief Release a sampler created by this factory. It is destroyed
+      /// once no material uses it anymore.
+      /// \param[in] _sampler Sampler to release
+      public: void Destroy(optix::TextureSampler _sampler);
+
       protected: optix::Buffer CreateBuffer(const std::string &_filename);
 
       protected: optix::Buffer CreateBuffer();
@@ -45,6 +61,19 @@ namespace ignition
       protected: optix::TextureSampler CreateSampler(optix::Buffer _buffer);
 
       protected: OptixScenePtr scene;
+
+      /// \brief A cached sampler and its number of users
+      protected: struct CachedSampler
+      {
+        /// \brief The shared sampler
+        optix::TextureSampler sampler;
+
+        /// \brief Number of Create calls not yet released
+        unsigned int count;
+      };
+
+      /// \brief Samplers by filename, the empty texture has an empty name
+      protected: std::unordered_map<std::string, CachedSampler> samplers;
     };
     }
   }
@@ -48,12 +48,25 @@ namespace ignition
 
       protected: virtual void Init();
 
+      /// \brief Write the laser_retro user data to the geometries
+      private: void WriteRetroToDevice();
+
       private: void CreateStorage();
 
       private: OptixVisualPtr SharedThis();
 
       protected: OptixGeometryStorePtr geometries;
 
+      /// \brief World scale last written to the geometries
+      protected: math::Vector3d geometryScale = math::Vector3d::Zero;
+
+      /// \brief User data version when the laser retro was last written to
+      /// the geometries
+      protected: unsigned int retroVersion = 0u;
+
+      /// \brief True if the laser retro must be written to the geometries
+      protected: bool retroDirty = true;
+
       private: friend class OptixScene;
     };
     }
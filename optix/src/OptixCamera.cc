@@ -16,6 +16,7 @@
  */
 #include "ignition/rendering/optix/OptixCamera.hh"
 
+#include <ignition/common/Console.hh>
 #include <ignition/math/Matrix3.hh>
 #include "ignition/rendering/optix/OptixIncludes.hh"
 #include "ignition/rendering/optix/OptixRenderTarget.hh"
@@ -32,6 +33,28 @@ const std::string OptixCamera::PTX_RENDER_FUNCTION("Render");
 
 const std::string OptixCamera::PTX_CLEAR_FUNCTION("Clear");
 
+const std::string OptixCamera::PTX_ACCUMULATE_FUNCTION("Accumulate");
+
+const std::string OptixCamera::PTX_RESOLVE_FUNCTION("Resolve");
+
+//////////////////////////////////////////////////
+/// \brief Get an element of the Halton low discrepancy sequence
+/// \param[in] _index Index of the element
+/// \param[in] _base Base of the sequence
+/// \return Element in [0, 1)
+static float Halton(unsigned int _index, unsigned int _base)
+{
+  float result = 0;
+  float fraction = 1;
+  while (_index > 0)
+  {
+    fraction /= _base;
+    result += fraction * (_index % _base);
+    _index /= _base;
+  }
+  return result;
+}
+
 //////////////////////////////////////////////////
 OptixCamera::OptixCamera() :
   optixRenderProgram(nullptr),
@@ -82,8 +105,136 @@ void OptixCamera::Render()
   unsigned int width = this->ImageWidth();
   unsigned int height = this->ImageHeight();
   optix::Context optixContext = this->scene->OptixContext();
+
+  if (this->accumulation)
+  {
+    // restart when anything changed since the last frame
+    unsigned int changeCount = this->scene->ChangeCount();
+    if (this->ResizeAccumulation() || changeCount != this->sceneChangeCount)
+    {
+      this->accumulatedFrames = 0u;
+      this->sceneChangeCount = changeCount;
+    }
+
+    // the first frame samples the pixel centers, like without accumulation
+    float jitterX = 0;
+    float jitterY = 0;
+    if (this->accumulatedFrames > 0u)
+    {
+      jitterX = Halton(this->accumulatedFrames, 2) - 0.5f;
+      jitterY = Halton(this->accumulatedFrames, 3) - 0.5f;
+    }
+    this->optixRenderProgram["jitter"]->setFloat(jitterX, jitterY);
+    this->optixAccumulateProgram["frame"]->setUint(this->accumulatedFrames);
+  }
+
   optixContext->launch(this->clearId, width, height);
   optixContext->launch(this->traceId, width, height);
+
+  if (this->accumulation)
+  {
+    this->Accumulate();
+    ++this->accumulatedFrames;
+  }
+}
+
+//////////////////////////////////////////////////
+void OptixCamera::SetAccumulation(bool _enable)
+{
+  if (this->accumulation == _enable)
+    return;
+
+  this->accumulation = _enable;
+  this->accumulatedFrames = 0u;
+  if (!_enable)
+    this->optixRenderProgram["jitter"]->setFloat(0, 0);
+}
+
+//////////////////////////////////////////////////
+bool OptixCamera::Accumulation() const
+{
+  return this->accumulation;
+}
+
+//////////////////////////////////////////////////
+unsigned int OptixCamera::AccumulatedFrameCount() const
+{
+  return this->accumulatedFrames;
+}
+
+//////////////////////////////////////////////////
+void OptixCamera::ResetAccumulation()
+{
+  this->accumulatedFrames = 0u;
+}
+
+//////////////////////////////////////////////////
+void OptixCamera::SetDenoise(bool _enable)
+{
+#if OPTIX_VERSION >= 50000
+  this->denoise = _enable;
+  this->denoiseDirty = true;
+#else
+  if (_enable)
+  {
+    ignwarn << "The denoiser requires OptiX 5 or later" << std::endl;
+  }
+#endif
+}
+
+//////////////////////////////////////////////////
+bool OptixCamera::Denoise() const
+{
+  return this->denoise;
+}
+
+//////////////////////////////////////////////////
+bool OptixCamera::ResizeAccumulation()
+{
+  RTsize width, height;
+  this->optixAccumBuffer->getSize(width, height);
+  if (width == this->ImageWidth() && height == this->ImageHeight())
+    return false;
+
+  this->optixAccumBuffer->setSize(this->ImageWidth(), this->ImageHeight());
+  this->optixAverageBuffer->setSize(this->ImageWidth(), this->ImageHeight());
+  this->optixDenoisedBuffer->setSize(this->ImageWidth(), this->ImageHeight());
+  this->denoiseDirty = true;
+  return true;
+}
+
+//////////////////////////////////////////////////
+void OptixCamera::Accumulate()
+{
+  unsigned int width = this->ImageWidth();
+  unsigned int height = this->ImageHeight();
+  optix::Context optixContext = this->scene->OptixContext();
+
+#if OPTIX_VERSION >= 50000
+  if (this->denoise)
+  {
+    if (this->denoiseDirty)
+    {
+      if (this->optixDenoiseCommands.get())
+        this->optixDenoiseCommands->destroy();
+
+      this->optixDenoiseCommands = optixContext->createCommandList();
+      this->optixDenoiseCommands->appendLaunch(this->accumulateId,
+          width, height);
+      this->optixDenoiseCommands->appendPostprocessingStage(
+          this->optixDenoiser, width, height);
+      this->optixDenoiseCommands->appendLaunch(this->resolveId,
+          width, height);
+      this->optixDenoiseCommands->finalize();
+      this->denoiseDirty = false;
+    }
+
+    this->optixDenoiseCommands->execute();
+    return;
+  }
+#endif
+
+  optixContext->launch(this->accumulateId, width, height);
 }
 
 //////////////////////////////////////////////////
@@ -106,6 +257,7 @@ void OptixCamera::WriteCameraToDevice()
 void OptixCamera::WriteCameraToDeviceImpl()
 {
   this->optixRenderProgram["aa"]->setUint(this->AntiAliasing() + 1u);
+  this->accumulatedFrames = 0u;
 }
 
 //////////////////////////////////////////////////
@@ -141,6 +293,7 @@ void OptixCamera::Init()
   this->CreateRenderProgram();
   this->CreateClearProgram();
   this->CreateErrorProgram();
+  this->CreateAccumulateProgram();
   this->Reset();
 }
 
@@ -176,6 +329,7 @@ void OptixCamera::CreateRenderProgram()
 
   optix::Buffer optixBuffer = this->renderTexture->OptixBuffer();
   this->optixRenderProgram["buffer"]->setBuffer(optixBuffer);
+  this->optixRenderProgram["jitter"]->setFloat(0, 0);
 }
 
 //////////////////////////////////////////////////
@@ -205,3 +359,45 @@ void OptixCamera::CreateErrorProgram()
   this->optixErrorProgram["buffer"]->setBuffer(optixBuffer);
   optixContext->setExceptionProgram(this->traceId, this->optixErrorProgram);
 }
+
+//////////////////////////////////////////////////
+void OptixCamera::CreateAccumulateProgram()
+{
+  optix::Context optixContext = this->scene->OptixContext();
+  this->optixAccumBuffer = optixContext->createBuffer(
+      RT_BUFFER_INPUT_OUTPUT, RT_FORMAT_FLOAT4, 0, 0);
+  this->optixAverageBuffer = optixContext->createBuffer(
+      RT_BUFFER_INPUT_OUTPUT, RT_FORMAT_FLOAT4, 0, 0);
+  this->optixDenoisedBuffer = optixContext->createBuffer(
+      RT_BUFFER_OUTPUT, RT_FORMAT_FLOAT4, 0, 0);
+
+  optix::Buffer optixBuffer = this->renderTexture->OptixBuffer();
+
+  this->optixAccumulateProgram =
+      this->scene->CreateOptixProgram(PTX_BASE_NAME, PTX_ACCUMULATE_FUNCTION);
+  optixContext->setRayGenerationProgram(this->accumulateId,
+      this->optixAccumulateProgram);
+  this->optixAccumulateProgram["buffer"]->setBuffer(optixBuffer);
+  this->optixAccumulateProgram["accumBuffer"]->setBuffer(
+      this->optixAccumBuffer);
+  this->optixAccumulateProgram["averageBuffer"]->setBuffer(
+      this->optixAverageBuffer);
+  this->optixAccumulateProgram["frame"]->setUint(0u);
+
+  this->optixResolveProgram =
+      this->scene->CreateOptixProgram(PTX_BASE_NAME, PTX_RESOLVE_FUNCTION);
+  optixContext->setRayGenerationProgram(this->resolveId,
+      this->optixResolveProgram);
+  this->optixResolveProgram["buffer"]->setBuffer(optixBuffer);
+  this->optixResolveProgram["denoisedBuffer"]->setBuffer(
+      this->optixDenoisedBuffer);
+
+#if OPTIX_VERSION >= 50000
+  this->optixDenoiser =
+      optixContext->createBuiltinPostProcessingStage("DLDenoiser");
+  this->optixDenoiser->declareVariable("input_buffer")->set(
+      this->optixAverageBuffer);
+  this->optixDenoiser->declareVariable("output_buffer")->set(
+      this->optixDenoisedBuffer);
+#endif
+}
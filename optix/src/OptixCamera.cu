@@ -24,8 +24,15 @@ rtDeclareVariable(float3,   u, , );
 rtDeclareVariable(float3,   v, , );
 rtDeclareVariable(float3,   w, , );
 rtDeclareVariable(uint,    aa, , );
+rtDeclareVariable(float2, jitter, , );
 rtBuffer<float3, 2> buffer;
 
+// accumulation variables
+rtDeclareVariable(uint, frame, , );
+rtBuffer<float4, 2> accumBuffer;
+rtBuffer<float4, 2> averageBuffer;
+rtBuffer<float4, 2> denoisedBuffer;
+
 // current ray variables
 rtDeclareVariable(uint2, launchIndex, rtLaunchIndex, );
 rtDeclareVariable(uint2, launchDim, rtLaunchDim, );
@@ -83,7 +90,7 @@ static __inline__ __device__ void AddColor(const Context &_context,
 
 static __inline__ __device__ void TraceRay(const Context &_context)
 {
-  float2 offset = make_float2(_context.subpixel) / aa;
+  float2 offset = (make_float2(_context.subpixel) + jitter) / aa;
 
   // get image plane intersect point
   float2 pixel = make_float2(launchIndex) + offset;
@@ -124,7 +131,7 @@ static __inline__ __device__ void RenderAA()
 static __inline__ __device__ void RenderNoAA()
 {
   // get image plane intersect point
-  float2 pixel = make_float2(launchIndex) + 0.5;
+  float2 pixel = make_float2(launchIndex) + 0.5 + jitter;
   float2 size  = make_float2(launchDim);
   float2 ratio = pixel / size - 0.5;
 
@@ -159,3 +166,21 @@ RT_PROGRAM void Clear()
 {
   buffer[launchIndex] = make_float3(0);
 }
+
+RT_PROGRAM void Accumulate()
+{
+  // restart the sum on the first frame
+  float4 sum = make_float4(buffer[launchIndex], 1);
+  if (frame > 0)
+    sum += accumBuffer[launchIndex];
+
+  accumBuffer[launchIndex] = sum;
+  float3 average = make_float3(sum) / sum.w;
+  averageBuffer[launchIndex] = make_float4(average, 1);
+  buffer[launchIndex] = average;
+}
+
+RT_PROGRAM void Resolve()
+{
+  buffer[launchIndex] = make_float3(denoisedBuffer[launchIndex]);
+}
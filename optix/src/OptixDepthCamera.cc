@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cmath>
+#include <cstring>
+
+#include <ignition/common/Console.hh>
+#include <ignition/math/Matrix3.hh>
+
+#include "ignition/rendering/optix/OptixDepthCamera.hh"
+#include "ignition/rendering/optix/OptixRenderTarget.hh"
+#include "ignition/rendering/optix/OptixScene.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+
+const std::string OptixDepthCamera::PTX_BASE_NAME("OptixDepthCamera");
+
+const std::string OptixDepthCamera::PTX_DEPTH_FUNCTION("Depth");
+
+//////////////////////////////////////////////////
+OptixDepthCamera::OptixDepthCamera()
+{
+}
+
+//////////////////////////////////////////////////
+OptixDepthCamera::~OptixDepthCamera()
+{
+  // the queued frames refer to the events of this camera
+  this->FlushFrames();
+}
+
+//////////////////////////////////////////////////
+void OptixDepthCamera::Init()
+{
+  BaseDepthCamera::Init();
+
+  RenderTexturePtr base = this->scene->CreateRenderTexture();
+  this->renderTexture = std::dynamic_pointer_cast<OptixRenderTexture>(base);
+  this->renderTexture->SetFormat(PF_FLOAT32_R);
+
+  optix::Context optixContext = this->scene->OptixContext();
+  this->optixDepthBuffer = optixContext->createBuffer(
+      RT_BUFFER_OUTPUT, RT_FORMAT_FLOAT, 0, 0);
+  this->optixPointCloudBuffer = optixContext->createBuffer(
+      RT_BUFFER_OUTPUT, RT_FORMAT_FLOAT4, 0, 0);
+
+  this->optixDepthProgram =
+      this->scene->CreateOptixProgram(PTX_BASE_NAME, PTX_DEPTH_FUNCTION);
+  optixContext->setRayGenerationProgram(this->depthId,
+      this->optixDepthProgram);
+  this->optixDepthProgram["depthBuffer"]->setBuffer(this->optixDepthBuffer);
+  this->optixDepthProgram["pointCloudBuffer"]->setBuffer(
+      this->optixPointCloudBuffer);
+  this->optixDepthProgram["pointCloud"]->setUint(0u);
+
+  this->Reset();
+}
+
+//////////////////////////////////////////////////
+void OptixDepthCamera::CreateDepthTexture()
+{
+  this->ResizeBuffers();
+}
+
+//////////////////////////////////////////////////
+void OptixDepthCamera::ResizeBuffers()
+{
+  unsigned int width = this->ImageWidth();
+  unsigned int height = this->ImageHeight();
+  if (width == this->bufferWidth && height == this->bufferHeight)
+    return;
+
+  this->optixDepthBuffer->setSize(width, height);
+  this->bufferWidth = width;
+  this->bufferHeight = height;
+
+  // the point cloud buffer is only allocated once it has subscribers
+  if (this->pointCloud)
+    this->optixPointCloudBuffer->setSize(width, height);
+
+  // the image plane vectors depend on the aspect ratio
+  this->poseDirty = true;
+}
+
+//////////////////////////////////////////////////
+void OptixDepthCamera::SetHFOV(const math::Angle &_angle)
+{
+  BaseDepthCamera::SetHFOV(_angle);
+  this->poseDirty = true;
+}
+
+//////////////////////////////////////////////////
+void OptixDepthCamera::WritePoseToDeviceImpl()
+{
+  BaseDepthCamera::WritePoseToDeviceImpl();
+
+  math::Pose3d worldPose = this->WorldPose();
+  math::Vector3d pos = worldPose.Pos();
+  math::Matrix3d rot(worldPose.Rot());
+
+  // same image plane as OptixCamera
+  float3 eye = make_float3(pos.X(), pos.Y(), pos.Z());
+  float3   x = make_float3(rot(0, 0), rot(1, 0), rot(2, 0));
+  float3   y = make_float3(rot(0, 1), rot(1, 1), rot(2, 1));
+  float3   z = make_float3(rot(0, 2), rot(1, 2), rot(2, 2));
+  float3   u = -y;
+  float3   v = -z;
+  float3   w = x;
+
+  if (this->ImageWidth() > 0u)
+    v *= static_cast<float>(this->ImageHeight()) / this->ImageWidth();
+  w *= 1 / (2 * tan(this->HFOV().Radian() / 2));
+
+  this->optixDepthProgram["eye"]->setFloat(eye);
+  this->optixDepthProgram["u"]->setFloat(u);
+  this->optixDepthProgram["v"]->setFloat(v);
+  this->optixDepthProgram["w"]->setFloat(w);
+  this->optixDepthProgram["axisX"]->setFloat(x);
+  this->optixDepthProgram["axisY"]->setFloat(y);
+  this->optixDepthProgram["axisZ"]->setFloat(z);
+}
+
+//////////////////////////////////////////////////
+void OptixDepthCamera::PreRender()
+{
+  // colors are only traced for point cloud subscribers
+  bool pointCloud = this->newRgbPointCloud.ConnectionCount() > 0u;
+  if (pointCloud != this->pointCloud)
+  {
+    this->pointCloud = pointCloud;
+    this->optixDepthProgram["pointCloud"]->setUint(pointCloud ? 1u : 0u);
+    this->optixPointCloudBuffer->setSize(
+        pointCloud ? this->bufferWidth : 0u,
+        pointCloud ? this->bufferHeight : 0u);
+  }
+
+  // resized first since the pose written below depends on the image size
+  this->ResizeBuffers();
+  BaseDepthCamera::PreRender();
+
+  this->optixDepthProgram["nearClip"]->setFloat(
+      static_cast<float>(this->NearClipPlane()));
+  this->optixDepthProgram["farClip"]->setFloat(
+      static_cast<float>(this->FarClipPlane()));
+}
+
+//////////////////////////////////////////////////
+void OptixDepthCamera::Render()
+{
+  if (this->bufferWidth == 0u || this->bufferHeight == 0u)
+    return;
+
+  optix::Context optixContext = this->scene->OptixContext();
+  optixContext->launch(this->depthId, this->bufferWidth, this->bufferHeight);
+}
+
+//////////////////////////////////////////////////
+void OptixDepthCamera::PostRender()
+{
+  unsigned int width = this->bufferWidth;
+  unsigned int height = this->bufferHeight;
+  size_t len = static_cast<size_t>(width) * height;
+  if (len == 0u)
+    return;
+
+  this->depthImage.resize(len);
+  const float *depth =
+      static_cast<const float *>(this->optixDepthBuffer->map());
+  std::memcpy(this->depthImage.data(), depth, len * sizeof(float));
+  this->optixDepthBuffer->unmap();
+
+  this->DispatchFrame(this->newDepthFrame, this->depthImage.data(), len,
+      width, height, 1, "FLOAT32");
+
+  if (!this->pointCloud)
+    return;
+
+  const unsigned int channelCount = 4u;
+  this->pointCloudImage.resize(len * channelCount);
+  const float *points =
+      static_cast<const float *>(this->optixPointCloudBuffer->map());
+  std::memcpy(this->pointCloudImage.data(), points,
+      this->pointCloudImage.size() * sizeof(float));
+  this->optixPointCloudBuffer->unmap();
+
+  this->DispatchFrame(this->newRgbPointCloud, this->pointCloudImage.data(),
+      len * channelCount, width, height, channelCount, "PF_FLOAT32_RGBA");
+}
+
+//////////////////////////////////////////////////
+const float *OptixDepthCamera::DepthData() const
+{
+  if (this->depthImage.empty())
+    return nullptr;
+  return this->depthImage.data();
+}
+
+//////////////////////////////////////////////////
+ignition::common::ConnectionPtr OptixDepthCamera::ConnectNewDepthFrame(
+    std::function<void(const float *, unsigned int, unsigned int,
+    unsigned int, const std::string &)>  _subscriber)
+{
+  return this->newDepthFrame.Connect(_subscriber);
+}
+
+//////////////////////////////////////////////////
+ignition::common::ConnectionPtr OptixDepthCamera::ConnectNewRgbPointCloud(
+    std::function<void(const float *, unsigned int, unsigned int,
+    unsigned int, const std::string &)>  _subscriber)
+{
+  return this->newRgbPointCloud.Connect(_subscriber);
+}
+
+//////////////////////////////////////////////////
+RenderTargetPtr OptixDepthCamera::RenderTarget() const
+{
+  return this->renderTexture;
+}
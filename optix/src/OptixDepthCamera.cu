@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <optix.h>
+#include <optix_math.h>
+#include <ignition/rendering/optix/OptixRayTypes.hh>
+
+// camera variables
+rtDeclareVariable(float3, eye, , );
+rtDeclareVariable(float3,   u, , );
+rtDeclareVariable(float3,   v, , );
+rtDeclareVariable(float3,   w, , );
+rtDeclareVariable(float3, axisX, , );
+rtDeclareVariable(float3, axisY, , );
+rtDeclareVariable(float3, axisZ, , );
+rtDeclareVariable(float, nearClip, , );
+rtDeclareVariable(float, farClip, , );
+rtDeclareVariable(uint, pointCloud, , );
+
+// depth of each pixel
+rtBuffer<float, 2> depthBuffer;
+
+// x, y, z in the camera frame and packed rgba of each pixel
+rtBuffer<float4, 2> pointCloudBuffer;
+
+// current ray variables
+rtDeclareVariable(uint2, launchIndex, rtLaunchIndex, );
+rtDeclareVariable(uint2, launchDim, rtLaunchDim, );
+
+// scene variables
+rtDeclareVariable(rtObject, rootGroup, , );
+rtDeclareVariable(float, sceneEpsilon, , );
+
+static __device__ __inline__ unsigned int ToByte(float _value)
+{
+  return static_cast<unsigned int>(255 * fminf(fmaxf(_value, 0.0f), 1.0f));
+}
+
+RT_PROGRAM void Depth()
+{
+  // get image plane intersect point
+  float2 pixel = make_float2(launchIndex) + 0.5;
+  float2 size  = make_float2(launchDim);
+  float2 ratio = pixel / size - 0.5;
+  float3 direction = normalize(ratio.x * u + ratio.y * v + w);
+
+  // only the distance is needed, so the cheap range ray type is traced
+  OptixRangeRayData rangeData;
+  rangeData.distance = -1;
+  rangeData.retro = 0;
+  optix::Ray ray(eye, direction, RT_RANGE, sceneEpsilon);
+  rtTrace(rootGroup, ray, rangeData);
+
+  float3 point = rangeData.distance * make_float3(dot(direction, axisX),
+      dot(direction, axisY), dot(direction, axisZ));
+
+  // same values as the ogre2 depth camera outside of the clip planes
+  if (rangeData.distance < 0 || point.x > farClip)
+    point = make_float3(__int_as_float(0x7f800000));
+  else if (point.x < nearClip)
+    point = make_float3(-__int_as_float(0x7f800000));
+
+  depthBuffer[launchIndex] = point.x;
+
+  if (!pointCloud)
+    return;
+
+  OptixRadianceRayData radianceData;
+  radianceData.color = make_float3(0, 0, 0);
+  radianceData.importance = 1;
+  radianceData.depth = 0;
+  ray.ray_type = RT_RADIANCE;
+  rtTrace(rootGroup, ray, radianceData);
+
+  unsigned int rgba = (ToByte(radianceData.color.x) << 24) |
+      (ToByte(radianceData.color.y) << 16) |
+      (ToByte(radianceData.color.z) << 8) | 255u;
+  pointCloudBuffer[launchIndex] = make_float4(point, __uint_as_float(rgba));
+}
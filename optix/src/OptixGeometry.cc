@@ -63,3 +63,16 @@ void OptixGeometry::SetScale(math::Vector3d _scale)
     optixGeomInstance["scale"]->setFloat(_scale.X(), _scale.Y(), _scale.Z());
   }
 }
+
+//////////////////////////////////////////////////
+void OptixGeometry::SetRetro(float _retro)
+{
+  optix::GeometryGroup optixGeomGroup = this->OptixGeometryGroup();
+  unsigned int count = optixGeomGroup->getChildCount();
+
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    optix::GeometryInstance optixGeomInstance = optixGeomGroup->getChild(i);
+    optixGeomInstance["retro"]->setFloat(_retro);
+  }
+}
@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <ignition/common/Console.hh>
+#include <ignition/math/Matrix3.hh>
+
+#include "ignition/rendering/optix/OptixGpuRays.hh"
+#include "ignition/rendering/optix/OptixRenderTarget.hh"
+#include "ignition/rendering/optix/OptixScene.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+
+const std::string OptixGpuRays::PTX_BASE_NAME("OptixGpuRays");
+
+const std::string OptixGpuRays::PTX_RANGE_FUNCTION("Range");
+
+//////////////////////////////////////////////////
+OptixGpuRays::OptixGpuRays()
+{
+  // r = depth, g = retro, b = n/a
+  this->channels = 3u;
+}
+
+//////////////////////////////////////////////////
+OptixGpuRays::~OptixGpuRays()
+{
+  // the queued frames refer to the event of this sensor
+  this->FlushFrames();
+}
+
+//////////////////////////////////////////////////
+void OptixGpuRays::Init()
+{
+  BaseGpuRays::Init();
+
+  // dummy render texture, the ranges are written to a buffer of their own
+  RenderTexturePtr base = this->scene->CreateRenderTexture();
+  this->renderTexture = std::dynamic_pointer_cast<OptixRenderTexture>(base);
+  this->renderTexture->SetWidth(1);
+  this->renderTexture->SetHeight(1);
+
+  this->CreateRangeProgram();
+}
+
+//////////////////////////////////////////////////
+void OptixGpuRays::CreateRangeProgram()
+{
+  optix::Context optixContext = this->scene->OptixContext();
+
+  this->optixHAngleBuffer = optixContext->createBuffer(
+      RT_BUFFER_INPUT, RT_FORMAT_FLOAT2, 0);
+  this->optixVAngleBuffer = optixContext->createBuffer(
+      RT_BUFFER_INPUT, RT_FORMAT_FLOAT2, 0);
+  this->optixRangeBuffer = optixContext->createBuffer(
+      RT_BUFFER_OUTPUT, RT_FORMAT_FLOAT3, 0, 0);
+
+  this->optixRangeProgram =
+      this->scene->CreateOptixProgram(PTX_BASE_NAME, PTX_RANGE_FUNCTION);
+  optixContext->setRayGenerationProgram(this->rangeId,
+      this->optixRangeProgram);
+
+  this->optixRangeProgram["hAngles"]->setBuffer(this->optixHAngleBuffer);
+  this->optixRangeProgram["vAngles"]->setBuffer(this->optixVAngleBuffer);
+  this->optixRangeProgram["rangeBuffer"]->setBuffer(this->optixRangeBuffer);
+}
+
+//////////////////////////////////////////////////
+unsigned int OptixGpuRays::DataWidth() const
+{
+  return static_cast<unsigned int>(std::max(this->RangeCount(), 1));
+}
+
+//////////////////////////////////////////////////
+unsigned int OptixGpuRays::DataHeight() const
+{
+  return static_cast<unsigned int>(std::max(this->VerticalRangeCount(), 1));
+}
+
+//////////////////////////////////////////////////
+void OptixGpuRays::WriteAnglesToDevice()
+{
+  double min = this->AngleMin().Radian();
+  double max = this->AngleMax().Radian();
+  double vmin = this->VerticalAngleMin().Radian();
+  double vmax = this->VerticalAngleMax().Radian();
+  unsigned int width = this->DataWidth();
+  unsigned int height = this->DataHeight();
+
+  std::vector<double> key = {min, max, vmin, vmax};
+  if (key == this->angleKey && width == this->bufferWidth &&
+      height == this->bufferHeight &&
+      this->returnCount == this->bufferReturnCount)
+  {
+    return;
+  }
+  this->angleKey = key;
+
+  // same rays as the sample texture of Ogre2GpuRays
+  double hStep = 0.0;
+  if (width > 1)
+    hStep = (max-min) / static_cast<double>(width-1);
+  double vStep = 0.0;
+  if (height > 1)
+    vStep = (vmax-vmin) / static_cast<double>(height-1);
+
+  this->optixHAngleBuffer->setSize(width);
+  float *hData = static_cast<float *>(this->optixHAngleBuffer->map());
+  for (unsigned int j = 0; j < width; ++j)
+  {
+    double h = min + j * hStep;
+    hData[j * 2] = static_cast<float>(std::sin(h));
+    hData[j * 2 + 1] = static_cast<float>(std::cos(h));
+  }
+  this->optixHAngleBuffer->unmap();
+
+  this->optixVAngleBuffer->setSize(height);
+  float *vData = static_cast<float *>(this->optixVAngleBuffer->map());
+  for (unsigned int i = 0; i < height; ++i)
+  {
+    double v = vmin + i * vStep;
+    vData[i * 2] = static_cast<float>(std::sin(v));
+    vData[i * 2 + 1] = static_cast<float>(std::cos(v));
+  }
+  this->optixVAngleBuffer->unmap();
+
+  this->optixRangeBuffer->setSize(width, height * this->returnCount);
+  this->optixRangeProgram["returnCount"]->setUint(this->returnCount);
+  this->bufferWidth = width;
+  this->bufferHeight = height;
+  this->bufferReturnCount = this->returnCount;
+}
+
+//////////////////////////////////////////////////
+void OptixGpuRays::WritePoseToDeviceImpl()
+{
+  BaseGpuRays::WritePoseToDeviceImpl();
+
+  math::Pose3d worldPose = this->WorldPose();
+  math::Vector3d pos = worldPose.Pos();
+  math::Matrix3d rot(worldPose.Rot());
+
+  this->optixRangeProgram["origin"]->setFloat(pos.X(), pos.Y(), pos.Z());
+  this->optixRangeProgram["axisX"]->setFloat(
+      rot(0, 0), rot(1, 0), rot(2, 0));
+  this->optixRangeProgram["axisY"]->setFloat(
+      rot(0, 1), rot(1, 1), rot(2, 1));
+  this->optixRangeProgram["axisZ"]->setFloat(
+      rot(0, 2), rot(1, 2), rot(2, 2));
+}
+
+//////////////////////////////////////////////////
+void OptixGpuRays::PreRender()
+{
+  BaseGpuRays::PreRender();
+  this->WriteAnglesToDevice();
+
+  // the clip planes and the clamping values are public and may change at
+  // any time, they are cheap to write every frame
+  this->optixRangeProgram["nearClip"]->setFloat(
+      static_cast<float>(this->NearClipPlane()));
+  this->optixRangeProgram["farClip"]->setFloat(
+      static_cast<float>(this->FarClipPlane()));
+  this->optixRangeProgram["minValue"]->setFloat(this->dataMinVal);
+  this->optixRangeProgram["maxValue"]->setFloat(this->dataMaxVal);
+}
+
+//////////////////////////////////////////////////
+void OptixGpuRays::Render()
+{
+  optix::Context optixContext = this->scene->OptixContext();
+  optixContext->launch(this->rangeId, this->bufferWidth, this->bufferHeight);
+}
+
+//////////////////////////////////////////////////
+void OptixGpuRays::PostRender()
+{
+  // the buffer has the size of the last launch, whatever was set since
+  size_t len = static_cast<size_t>(this->bufferWidth) * this->bufferHeight *
+      this->Channels();
+
+  this->gpuRaysScan.resize(len * this->bufferReturnCount);
+  const float *data =
+      static_cast<const float *>(this->optixRangeBuffer->map());
+  std::memcpy(this->gpuRaysScan.data(), data,
+      this->gpuRaysScan.size() * sizeof(float));
+  this->optixRangeBuffer->unmap();
+  this->scanReturnCount = this->bufferReturnCount;
+
+  this->DispatchFrame(this->newGpuRaysFrame, this->gpuRaysScan.data(),
+      len, this->bufferWidth, this->bufferHeight, this->Channels(),
+      "PF_FLOAT32_RGB");
+}
+
+//////////////////////////////////////////////////
+const float *OptixGpuRays::Data() const
+{
+  return this->ReturnData(0u);
+}
+
+//////////////////////////////////////////////////
+void OptixGpuRays::Copy(float *_dataDest)
+{
+  const float *data = this->Data();
+  if (!data)
+    return;
+
+  size_t len = static_cast<size_t>(this->bufferWidth) * this->bufferHeight *
+      this->Channels();
+  std::memcpy(_dataDest, data, len * sizeof(float));
+}
+
+//////////////////////////////////////////////////
+void OptixGpuRays::SetReturnCount(unsigned int _count)
+{
+  if (_count == 0u)
+  {
+    ignerr << "Gpu rays [" << this->Name() << "] need at least one return"
+           << std::endl;
+    return;
+  }
+  this->returnCount = _count;
+}
+
+//////////////////////////////////////////////////
+unsigned int OptixGpuRays::ReturnCount() const
+{
+  return this->returnCount;
+}
+
+//////////////////////////////////////////////////
+const float *OptixGpuRays::ReturnData(unsigned int _index) const
+{
+  if (_index >= this->scanReturnCount)
+    return nullptr;
+
+  size_t len = this->gpuRaysScan.size() / this->scanReturnCount;
+  return this->gpuRaysScan.data() + _index * len;
+}
+
+//////////////////////////////////////////////////
+ignition::common::ConnectionPtr OptixGpuRays::ConnectNewGpuRaysFrame(
+    std::function<void(const float *_frame, unsigned int _width,
+    unsigned int _height, unsigned int _channels,
+    const std::string &/*_format*/)> _subscriber)
+{
+  return this->newGpuRaysFrame.Connect(_subscriber);
+}
+
+//////////////////////////////////////////////////
+RenderTargetPtr OptixGpuRays::RenderTarget() const
+{
+  return this->renderTexture;
+}
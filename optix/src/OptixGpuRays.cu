@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <optix.h>
+#include <optix_math.h>
+#include <ignition/rendering/optix/OptixRayTypes.hh>
+
+// sensor variables
+rtDeclareVariable(float3, origin, , );
+rtDeclareVariable(float3, axisX, , );
+rtDeclareVariable(float3, axisY, , );
+rtDeclareVariable(float3, axisZ, , );
+rtDeclareVariable(float, nearClip, , );
+rtDeclareVariable(float, farClip, , );
+rtDeclareVariable(float, minValue, , );
+rtDeclareVariable(float, maxValue, , );
+rtDeclareVariable(uint, returnCount, , );
+
+// sines and cosines of the ray angles, one per column and row
+rtBuffer<float2, 1> hAngles;
+rtBuffer<float2, 1> vAngles;
+
+// (range, retro, 0) of each ray, the returns are stacked vertically
+rtBuffer<float3, 2> rangeBuffer;
+
+// current ray variables
+rtDeclareVariable(uint2, launchIndex, rtLaunchIndex, );
+rtDeclareVariable(uint2, launchDim, rtLaunchDim, );
+
+// scene variables
+rtDeclareVariable(rtObject, rootGroup, , );
+rtDeclareVariable(float, sceneEpsilon, , );
+
+RT_PROGRAM void Range()
+{
+  // the direction of a ray in the sensor frame is
+  // (cos(v)cos(h), cos(v)sin(h), sin(v))
+  float2 h = hAngles[launchIndex.x];
+  float2 v = vAngles[launchIndex.y];
+  float3 dir = v.y * h.y * axisX + v.y * h.x * axisY + v.x * axisZ;
+
+  // each return continues the ray past the previous hit, so the distances
+  // are still measured from the sensor
+  float tmin = 0;
+  uint k = 0;
+  for (; k < returnCount; ++k)
+  {
+    OptixRangeRayData data;
+    data.distance = -1;
+    data.retro = 0;
+    optix::Ray ray(origin, dir, RT_RANGE, tmin);
+    rtTrace(rootGroup, ray, data);
+
+    uint2 index = make_uint2(launchIndex.x, launchIndex.y + k * launchDim.y);
+    if (data.distance < 0 || data.distance > farClip)
+    {
+      rangeBuffer[index] = make_float3(maxValue, 0, 0);
+      break;
+    }
+
+    float range = (data.distance < nearClip) ? minValue : data.distance;
+    rangeBuffer[index] = make_float3(range, data.retro, 0);
+    tmin = data.distance + sceneEpsilon;
+  }
+
+  // no further returns past a miss
+  for (++k; k < returnCount; ++k)
+  {
+    uint2 index = make_uint2(launchIndex.x, launchIndex.y + k * launchDim.y);
+    rangeBuffer[index] = make_float3(maxValue, 0, 0);
+  }
+}
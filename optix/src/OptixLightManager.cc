@@ -16,6 +16,9 @@
  */
 #include "ignition/rendering/optix/OptixLightManager.hh"
 
+#include <algorithm>
+#include <cstring>
+
 #include "ignition/rendering/optix/OptixLight.hh"
 #include "ignition/rendering/optix/OptixScene.hh"
 #include "ignition/rendering/optix/OptixVisual.hh"
@@ -73,50 +76,78 @@ void OptixLightManager::Clear()
 void OptixLightManager::WriteDirectionalBuffer()
 {
   this->WriteBuffer<OptixDirectionalLightData>(this->directionalBuffer,
-      this->directionalData);
+      this->directionalData, this->writtenDirectionalData,
+      "directionalLightCount");
 }
 
 //////////////////////////////////////////////////
 void OptixLightManager::WritePointBuffer()
 {
-  this->WriteBuffer<OptixPointLightData>(this->pointBuffer, this->pointData);
+  this->WriteBuffer<OptixPointLightData>(this->pointBuffer, this->pointData,
+      this->writtenPointData, "pointLightCount");
 }
 
 //////////////////////////////////////////////////
 void OptixLightManager::WriteSpotBuffer()
 {
-  this->WriteBuffer<OptixSpotLightData>(this->spotBuffer, this->spotData);
+  this->WriteBuffer<OptixSpotLightData>(this->spotBuffer, this->spotData,
+      this->writtenSpotData, "spotLightCount");
 }
 
 //////////////////////////////////////////////////
 template <class T>
 void OptixLightManager::WriteBuffer(optix::Buffer _buffer,
-    const std::vector<T> &_data)
+    const std::vector<T> &_data, std::vector<T> &_written,
+    const std::string &_countName)
 {
-  _buffer->setSize(_data.size());
+  // lights are gathered every frame, only upload them when they changed
   unsigned int memSize = sizeof(T) * _data.size();
-  std::memcpy(_buffer->map(), &_data[0], memSize);
-  _buffer->unmap();
+  if (_data.size() == _written.size() &&
+      (_data.empty() || std::memcmp(&_data[0], &_written[0], memSize) == 0))
+  {
+    return;
+  }
+
+  RTsize capacity;
+  _buffer->getSize(capacity);
+  if (_data.size() > capacity)
+    _buffer->setSize(std::max<RTsize>(_data.size(), capacity * 2));
+
+  if (!_data.empty())
+  {
+    std::memcpy(_buffer->map(), &_data[0], memSize);
+    _buffer->unmap();
+  }
+
+  optix::Context optixContext = this->scene->OptixContext();
+  optixContext[_countName]->setUint(static_cast<unsigned int>(_data.size()));
+  _written = _data;
+  this->scene->MarkChanged();
 }
 
 //////////////////////////////////////////////////
 void OptixLightManager::CreateBuffers()
 {
-  this->directionalBuffer =
-      this->CreateBuffer<OptixDirectionalLightData>("directionalLights");
+  this->directionalBuffer = this->CreateBuffer<OptixDirectionalLightData>(
+      "directionalLights", "directionalLightCount");
 
-  this->pointBuffer = this->CreateBuffer<OptixPointLightData>("pointLights");
-  this->spotBuffer = this->CreateBuffer<OptixSpotLightData>("spotLights");
+  this->pointBuffer = this->CreateBuffer<OptixPointLightData>("pointLights",
+      "pointLightCount");
+  this->spotBuffer = this->CreateBuffer<OptixSpotLightData>("spotLights",
+      "spotLightCount");
 }
 
 //////////////////////////////////////////////////
 template <class T>
-optix::Buffer OptixLightManager::CreateBuffer(const std::string &_name)
+optix::Buffer OptixLightManager::CreateBuffer(const std::string &_name,
+    const std::string &_countName)
 {
   optix::Context optixContext = this->scene->OptixContext();
   optix::Buffer buffer = optixContext->createBuffer(RT_BUFFER_INPUT);
   optixContext[_name]->setBuffer(buffer);
+  optixContext[_countName]->setUint(0u);
   buffer->setFormat(RT_FORMAT_USER);
   buffer->setElementSize(sizeof(T));
+  buffer->setSize(0);
   return buffer;
 }
@@ -32,6 +32,9 @@ const std::string OptixMaterial::PTX_CLOSEST_HIT_FUNC("ClosestHit");
 
 const std::string OptixMaterial::PTX_ANY_HIT_FUNC("AnyHit");
 
+const std::string OptixMaterial::PTX_RANGE_CLOSEST_HIT_FUNC(
+    "RangeClosestHit");
+
 //////////////////////////////////////////////////
 OptixMaterial::OptixMaterial() :
   optixMaterial(nullptr),
@@ -274,19 +277,19 @@ void OptixMaterial::Destroy()
 {
   if (this->optixTexture)
   {
-    this->optixTexture->destroy();
+    this->scene->TextureFactory()->Destroy(this->optixTexture);
     this->optixTexture = 0;
   }
 
   if (this->optixNormalMap)
   {
-    this->optixNormalMap->destroy();
+    this->scene->TextureFactory()->Destroy(this->optixNormalMap);
     this->optixNormalMap = 0;
   }
 
   if (this->optixEmptyTexture)
   {
-    this->optixEmptyTexture->destroy();
+    this->scene->TextureFactory()->Destroy(this->optixEmptyTexture);
     this->optixEmptyTexture = 0;
   }
 
@@ -312,6 +315,7 @@ void OptixMaterial::WriteColorToDevice()
   {
     this->WriteColorToDeviceImpl();
     this->colorDirty = false;
+    this->scene->MarkChanged();
   }
 }
 
@@ -322,6 +326,7 @@ void OptixMaterial::WriteTextureToDevice()
   {
     this->WriteTextureToDeviceImpl();
     this->textureDirty = false;
+    this->scene->MarkChanged();
   }
 }
 
@@ -332,6 +337,7 @@ void OptixMaterial::WriteNormalMapToDevice()
   {
     this->WriteNormalMapToDeviceImpl();
     this->normalMapDirty = false;
+    this->scene->MarkChanged();
   }
 }
 
@@ -361,7 +367,7 @@ void OptixMaterial::WriteTextureToDeviceImpl()
 {
   if (this->optixTexture)
   {
-    this->optixTexture->destroy();
+    this->scene->TextureFactory()->Destroy(this->optixTexture);
     this->optixTexture = 0;
   }
 
@@ -372,8 +378,8 @@ void OptixMaterial::WriteTextureToDeviceImpl()
   }
   else
   {
-    OptixTextureFactory texFactory(this->scene);
-    this->optixTexture = texFactory.Create(this->textureName);
+    this->optixTexture =
+        this->scene->TextureFactory()->Create(this->textureName);
     this->optixMaterial["texSampler"]->setTextureSampler(this->optixTexture);
   }
 }
@@ -383,7 +389,7 @@ void OptixMaterial::WriteNormalMapToDeviceImpl()
 {
   if (this->optixNormalMap)
   {
-    this->optixNormalMap->destroy();
+    this->scene->TextureFactory()->Destroy(this->optixNormalMap);
     this->optixNormalMap = 0;
   }
 
@@ -394,8 +400,8 @@ void OptixMaterial::WriteNormalMapToDeviceImpl()
   }
   else
   {
-    OptixTextureFactory texFactory(this->scene);
-    this->optixNormalMap = texFactory.Create(this->normalMapName);
+    this->optixNormalMap =
+        this->scene->TextureFactory()->Create(this->normalMapName);
     this->optixMaterial["normSampler"]->setTextureSampler(this->optixNormalMap);
   }
 }
@@ -412,12 +418,15 @@ void OptixMaterial::Init()
   optix::Program anyHitProgram =
       this->scene->CreateOptixProgram(PTX_FILE_BASE, PTX_ANY_HIT_FUNC);
 
+  optix::Program rangeClosestHitProgram = this->scene->CreateOptixProgram(
+      PTX_FILE_BASE, PTX_RANGE_CLOSEST_HIT_FUNC);
+
   this->optixMaterial = optixContext->createMaterial();
   optixMaterial->setClosestHitProgram(RT_RADIANCE, closestHitProgram);
   optixMaterial->setAnyHitProgram(RT_SHADOW, anyHitProgram);
+  optixMaterial->setClosestHitProgram(RT_RANGE, rangeClosestHitProgram);
 
-  OptixTextureFactory texFactory(this->scene);
-  this->optixEmptyTexture = texFactory.Create();
+  this->optixEmptyTexture = this->scene->TextureFactory()->Create();
   this->optixMaterial["texSampler"]->setTextureSampler(this->optixEmptyTexture);
 
   this->Reset();
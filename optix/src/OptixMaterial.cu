@@ -29,6 +29,8 @@ rtDeclareVariable(float, sceneEpsilon, , );
 rtDeclareVariable(rtObject, rootGroup, , );
 rtBuffer<OptixDirectionalLightData> directionalLights;
 rtBuffer<OptixPointLightData> pointLights;
+rtDeclareVariable(uint, directionalLightCount, , );
+rtDeclareVariable(uint, pointLightCount, , );
 rtTextureSampler<float4, 2> texSampler;
 rtTextureSampler<float4, 2> normSampler;
 rtDeclareVariable(bool, normWorldSpace, , );
@@ -43,10 +45,14 @@ rtDeclareVariable(uint, lightingEnabled, , );
 rtDeclareVariable(uint, castShadows, , );
 rtDeclareVariable(uint, receiveShadows, , );
 
+// geometry variables
+rtDeclareVariable(float, retro, , );
+
 // ray variables
 rtDeclareVariable(optix::Ray, ray, rtCurrentRay, );
 rtDeclareVariable(OptixRadianceRayData, radianceData, rtPayload, );
 rtDeclareVariable(OptixShadowRayData, shadowData, rtPayload, );
+rtDeclareVariable(OptixRangeRayData, rangeData, rtPayload, );
 
 // intersect variables
 rtDeclareVariable(float, hitDist, rtIntersectionDistance, );
@@ -177,7 +183,7 @@ RT_PROGRAM void ClosestHit()
   }
 
   // TODO: clean up
-  for (int i = 0; i < directionalLights.size() && lightingEnabled; ++i)
+  for (int i = 0; i < directionalLightCount && lightingEnabled; ++i)
   {
     OptixDirectionalLightData light = directionalLights[i];
     float3 l = normalize(-light.direction);
@@ -224,7 +230,7 @@ RT_PROGRAM void ClosestHit()
     }
   }
 
-  for (int i = 0; i < pointLights.size() && lightingEnabled; ++i)
+  for (int i = 0; i < pointLightCount && lightingEnabled; ++i)
   {
     OptixPointLightData light = pointLights[i];
     float3 l = normalize(light.common.position - hitPoint);
@@ -281,3 +287,9 @@ RT_PROGRAM void ClosestHit()
   radianceData.color = (1 - transparency) * finalColor +
       (transparency * result * beerAtten);
 }
+
+RT_PROGRAM void RangeClosestHit()
+{
+  rangeData.distance = hitDist;
+  rangeData.retro = retro;
+}
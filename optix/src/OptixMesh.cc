@@ -49,6 +49,22 @@ optix::Acceleration OptixMesh::OptixAccel() const
   return this->optixAccel;
 }
 
+//////////////////////////////////////////////////
+void OptixMesh::SetAccelBuilder(const std::string &_builder)
+{
+  if (_builder == this->AccelBuilder())
+    return;
+
+  this->optixAccel->setBuilder(_builder);
+  this->optixAccel->markDirty();
+}
+
+//////////////////////////////////////////////////
+std::string OptixMesh::AccelBuilder() const
+{
+  return this->optixAccel->getBuilder();
+}
+
 //////////////////////////////////////////////////
 SubMeshStorePtr OptixMesh::SubMeshes() const
 {
@@ -16,7 +16,11 @@
  */
 #include "ignition/rendering/optix/OptixMeshFactory.hh"
 
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
 #include <sstream>
+#include <vector>
 #include <ignition/common/Mesh.hh>
 #include <ignition/common/SubMesh.hh>
 #include "ignition/rendering/optix/OptixMesh.hh"
@@ -25,6 +29,23 @@
 using namespace ignition;
 using namespace rendering;
 
+//////////////////////////////////////////////////
+/// \brief Hash bytes with 64 bit FNV-1a
+/// \param[in] _data Bytes to hash
+/// \param[in] _size Number of bytes
+/// \return Hash of the bytes
+static uint64_t Hash(const void *_data, size_t _size)
+{
+  const unsigned char *bytes = static_cast<const unsigned char *>(_data);
+  uint64_t hash = 14695981039346656037ull;
+  for (size_t i = 0; i < _size; ++i)
+  {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
 //////////////////////////////////////////////////
 // OptixMeshFactory
 //////////////////////////////////////////////////
@@ -52,25 +73,30 @@ OptixMeshPtr OptixMeshFactory::Create(const MeshDescriptor &_desc)
     return nullptr;
   }
 
-  return this->Create(subMeshStore);
+  return this->Create(subMeshStore, this->Accel(normDesc));
 }
 
 //////////////////////////////////////////////////
 OptixMeshPtr OptixMeshFactory::Create(OptixSubMeshStorePtr _subMeshes)
+{
+  optix::Context optixContext = this->scene->OptixContext();
+  // optixContext->createAcceleration("TriangleKdTree", "KdTree");
+  // optixContext->createAcceleration("MedianBvh", "Bvh");
+  // optixContext->createAcceleration("Sbvh", "Bvh");
+  optix::Acceleration accel = optixContext->createAcceleration("Trbvh", "Bvh");
+  accel->markDirty();
+  return this->Create(_subMeshes, accel);
+}
+
+//////////////////////////////////////////////////
+OptixMeshPtr OptixMeshFactory::Create(OptixSubMeshStorePtr _subMeshes,
+    optix::Acceleration _accel)
 {
   optix::Context optixContext = this->scene->OptixContext();
 
   OptixMeshPtr mesh(new OptixMesh);
   mesh->optixGeomGroup = optixContext->createGeometryGroup();
-  // mesh->optixAccel =
-  //    optixContext->createAcceleration("TriangleKdTree", "KdTree");
-  // mesh->optixAccel =
-  //    optixContext->createAcceleration("MedianBvh", "Bvh");
-  // mesh->optixAccel =
-  //    optixContext->createAcceleration("Lbvh", "Bvh");
-  mesh->optixAccel = optixContext->createAcceleration("Sbvh", "Bvh");
-  mesh->optixAccel->markDirty();
-
+  mesh->optixAccel = _accel;
   mesh->optixGeomGroup->setAcceleration(mesh->optixAccel);
   mesh->subMeshes = _subMeshes;
 
@@ -85,6 +111,34 @@ OptixMeshPtr OptixMeshFactory::Create(OptixSubMeshStorePtr _subMeshes)
   return mesh;
 }
 
+//////////////////////////////////////////////////
+optix::Acceleration OptixMeshFactory::Accel(const MeshDescriptor &_desc)
+{
+  // meshes without a name can not be told apart
+  optix::Context optixContext = this->scene->OptixContext();
+  if (_desc.meshName.empty())
+  {
+    optix::Acceleration accel =
+        optixContext->createAcceleration("Trbvh", "Bvh");
+    accel->markDirty();
+    return accel;
+  }
+
+  // same key as the geometries of the submeshes, which are shared the same
+  // way
+  const std::string tail = (_desc.centerSubMesh) ? "_centered" : "_original";
+  const std::string key = _desc.meshName + "::" + _desc.subMeshName + tail;
+
+  auto iter = this->accels.find(key);
+  if (iter != this->accels.end())
+    return iter->second;
+
+  optix::Acceleration accel = optixContext->createAcceleration("Trbvh", "Bvh");
+  accel->markDirty();
+  this->accels[key] = accel;
+  return accel;
+}
+
 //////////////////////////////////////////////////
 // OptixSubMeshStoreFactory
 //////////////////////////////////////////////////
@@ -160,7 +214,8 @@ optix::Geometry OptixSubMeshStoreFactory::Geometry(
   auto subMesh = _desc.mesh->SubMeshByIndex(_subMeshIndex).lock();
   if (iter == this->geometries.end() && subMesh)
   {
-    OptixMeshGeometryFactory factory(this->scene, *subMesh.get());
+    OptixMeshGeometryFactory factory(this->scene, *subMesh.get(),
+        this->geometryCache);
     this->geometries[keyName] = factory.Create();
     iter = this->geometries.find(keyName);
   }
@@ -191,6 +246,16 @@ OptixMeshGeometryFactory::OptixMeshGeometryFactory(OptixScenePtr _scene,
 {
 }
 
+//////////////////////////////////////////////////
+OptixMeshGeometryFactory::OptixMeshGeometryFactory(OptixScenePtr _scene,
+    const common::SubMesh &_subMesh, OptixMeshGeometryCache &_cache) :
+  scene(_scene),
+  subMesh(_subMesh),
+  optixGeometry(nullptr),
+  cache(&_cache)
+{
+}
+
 //////////////////////////////////////////////////
 OptixMeshGeometryFactory::~OptixMeshGeometryFactory()
 {
@@ -213,9 +278,24 @@ void OptixMeshGeometryFactory::CreateGeometry()
   optix::Context optixContext = this->scene->OptixContext();
   this->optixGeometry = optixContext->createGeometry();
 
+  // the programs are the same for all meshes
   optix::Program intersectProgram, boundsProgram;
-  intersectProgram = this->scene->CreateOptixProgram("OptixMesh", "Intersect");
-  boundsProgram = this->scene->CreateOptixProgram("OptixMesh", "Bounds");
+  if (this->cache && this->cache->intersectProgram.get())
+  {
+    intersectProgram = this->cache->intersectProgram;
+    boundsProgram = this->cache->boundsProgram;
+  }
+  else
+  {
+    intersectProgram =
+        this->scene->CreateOptixProgram("OptixMesh", "Intersect");
+    boundsProgram = this->scene->CreateOptixProgram("OptixMesh", "Bounds");
+    if (this->cache)
+    {
+      this->cache->intersectProgram = intersectProgram;
+      this->cache->boundsProgram = boundsProgram;
+    }
+  }
 
   this->optixGeometry->setIntersectionProgram(intersectProgram);
   this->optixGeometry->setBoundingBoxProgram(boundsProgram);
@@ -233,120 +313,112 @@ void OptixMeshGeometryFactory::CreateGeometry()
 //////////////////////////////////////////////////
 optix::Buffer OptixMeshGeometryFactory::CreateVertexBuffer()
 {
-  // create new buffer
-  optix::Context optixContext = this->scene->OptixContext();
-  optix::Buffer buffer = optixContext->createBuffer(RT_BUFFER_INPUT);
-  buffer->setFormat(RT_FORMAT_FLOAT3);
-
-  // update buffer size
   unsigned int count = this->subMesh.VertexCount();
-  buffer->setSize(count);
-
-  // create host buffer from device buffer
-  float3 *array = static_cast<float3 *>(buffer->map());
+  std::vector<float3> array(count);
 
   // add each vertex to array
   for (unsigned int i = 0; i < count; ++i)
   {
-    // copy vertex to host buffer
     const math::Vector3d &vertex = this->subMesh.Vertex(i);
     array[i].x = vertex.X();
     array[i].y = vertex.Y();
     array[i].z = vertex.Z();
   }
 
-  // copy host buffer to device
-  buffer->unmap();
-  return buffer;
+  return this->CreateBuffer(RT_FORMAT_FLOAT3, array.data(), sizeof(float3),
+      count);
 }
 
 //////////////////////////////////////////////////
 optix::Buffer OptixMeshGeometryFactory::CreateNormalBuffer()
 {
-  // create new buffer
-  optix::Context optixContext = this->scene->OptixContext();
-  optix::Buffer buffer = optixContext->createBuffer(RT_BUFFER_INPUT);
-  buffer->setFormat(RT_FORMAT_FLOAT3);
-
-  // update buffer size
   unsigned int count = this->subMesh.NormalCount();
-  buffer->setSize(count);
+  std::vector<float3> array(count);
 
-  // create host buffer from device buffer
-  float3 *array = static_cast<float3 *>(buffer->map());
-
-  // add each vertex to array
+  // add each normal to array
   for (unsigned int i = 0; i < count; ++i)
   {
-    // copy normal to host buffer
     const math::Vector3d &normal = this->subMesh.Normal(i);
     array[i].x = normal.X();
     array[i].y = normal.Y();
     array[i].z = normal.Z();
   }
 
-  // copy host buffer to device
-  buffer->unmap();
-  return buffer;
+  return this->CreateBuffer(RT_FORMAT_FLOAT3, array.data(), sizeof(float3),
+      count);
 }
 
 //////////////////////////////////////////////////
 optix::Buffer OptixMeshGeometryFactory::CreateTexCoordBuffer()
 {
-  // create new buffer
-  optix::Context optixContext = this->scene->OptixContext();
-  optix::Buffer buffer = optixContext->createBuffer(RT_BUFFER_INPUT);
-  buffer->setFormat(RT_FORMAT_FLOAT2);
-
-  // update buffer size
   unsigned int count = this->subMesh.TexCoordCount();
-  buffer->setSize(count);
-
-  // create host buffer from device buffer
-  float2 *array = static_cast<float2 *>(buffer->map());
+  std::vector<float2> array(count);
 
   // add each texcoord to array
   for (unsigned int i = 0; i < count; ++i)
   {
-    // copy texcoord to host buffer
     const math::Vector2d &texcoord = this->subMesh.TexCoord(i);
     array[i].x = texcoord.X();
     array[i].y = texcoord.Y();
   }
 
-  // copy host buffer to device
-  buffer->unmap();
-  return buffer;
+  return this->CreateBuffer(RT_FORMAT_FLOAT2, array.data(), sizeof(float2),
+      count);
 }
 
 //////////////////////////////////////////////////
 optix::Buffer OptixMeshGeometryFactory::CreateIndexBuffer()
 {
-  // create new buffer
-  optix::Context optixContext = this->scene->OptixContext();
-  optix::Buffer buffer = optixContext->createBuffer(RT_BUFFER_INPUT);
-  buffer->setFormat(RT_FORMAT_INT3);
-
   // TODO: handle quads
 
-  // update buffer size
   unsigned int count = this->subMesh.IndexCount() / 3;
-  buffer->setSize(count);
-
-  // create host buffer from device buffer
-  int3 *array = static_cast<int3 *>(buffer->map());
+  std::vector<int3> array(count);
   int index = 0;
 
   // add each index to array
   for (unsigned int i = 0; i < count; ++i)
   {
-    // copy vertex to host buffer
     array[i].x = this->subMesh.Index(index++);
     array[i].y = this->subMesh.Index(index++);
     array[i].z = this->subMesh.Index(index++);
   }
 
+  return this->CreateBuffer(RT_FORMAT_INT3, array.data(), sizeof(int3),
+      count);
+}
+
+//////////////////////////////////////////////////
+optix::Buffer OptixMeshGeometryFactory::CreateBuffer(RTformat _format,
+    const void *_data, size_t _elementSize, unsigned int _count)
+{
+  size_t size = _elementSize * _count;
+
+  // reuse a buffer with the same content
+  std::string key;
+  if (this->cache)
+  {
+    std::ostringstream ss;
+    ss << _format << ":" << _count << ":" << std::hex << Hash(_data, size);
+    key = ss.str();
+    auto iter = this->cache->buffers.find(key);
+    if (iter != this->cache->buffers.end())
+      return iter->second;
+  }
+
+  // create new buffer
+  optix::Context optixContext = this->scene->OptixContext();
+  optix::Buffer buffer = optixContext->createBuffer(RT_BUFFER_INPUT);
+  buffer->setFormat(_format);
+  buffer->setSize(_count);
+
   // copy host buffer to device
-  buffer->unmap();
+  if (size > 0)
+  {
+    std::memcpy(buffer->map(), _data, size);
+    buffer->unmap();
+  }
+
+  if (this->cache)
+    this->cache->buffers[key] = buffer;
   return buffer;
 }
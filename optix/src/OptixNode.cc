@@ -52,7 +52,33 @@ void OptixNode::PreRender()
 {
   BaseNode::PreRender();
   this->WritePoseToDevice();
+  this->WriteAccelToDevice();
+}
+
+//////////////////////////////////////////////////
+void OptixNode::MarkAccelDirty(bool _rebuild)
+{
+  this->accelRebuild = this->accelRebuild || _rebuild;
+
+  // the ancestors of a dirty node are already dirty
+  if (this->accelDirty)
+    return;
+
+  this->accelDirty = true;
+  if (this->parent)
+    this->parent->MarkAccelDirty(false);
+}
+
+//////////////////////////////////////////////////
+void OptixNode::WriteAccelToDevice()
+{
+  if (!this->accelDirty)
+    return;
+
+  this->optixAccel->setProperty("refit", this->accelRebuild ? "0" : "1");
   this->optixAccel->markDirty();
+  this->accelDirty = false;
+  this->accelRebuild = false;
 }
 
 //////////////////////////////////////////////////
@@ -72,6 +98,10 @@ void OptixNode::SetRawLocalPose(const math::Pose3d &_pose)
 {
   this->pose = _pose;
   this->poseDirty = true;
+
+  // only the bounds of this node in the parent changed
+  if (this->parent)
+    this->parent->MarkAccelDirty(false);
 }
 
 //////////////////////////////////////////////////
@@ -81,6 +111,7 @@ void OptixNode::WritePoseToDevice()
   {
     this->WritePoseToDeviceImpl();
     this->poseDirty = false;
+    this->scene->MarkChanged();
   }
 }
 
@@ -131,7 +162,9 @@ void OptixNode::Init()
   this->optixTransform = optixContext->createTransform();
   // this->optixAccel = optixContext->createAcceleration("MedianBvh", "Bvh");
   // this->optixAccel = optixContext->createAcceleration("Lbvh", "Bvh");
-  this->optixAccel = optixContext->createAcceleration("Sbvh", "Bvh");
+  // children are mostly transforms which move, Trbvh builds fast and can
+  // be refitted
+  this->optixAccel = optixContext->createAcceleration("Trbvh", "Bvh");
   this->optixGroup = optixContext->createGroup();
   this->optixGroup->setAcceleration(this->optixAccel);
   this->optixTransform->setChild(this->optixGroup);
@@ -159,7 +192,8 @@ bool OptixNode::AttachChild(NodePtr _child)
   derived->SetParent(this->SharedThis());
   optix::Transform childTransform = derived->OptixTransform();
   this->optixGroup->addChild(childTransform);
-  this->optixAccel->markDirty();
+  this->MarkAccelDirty(true);
+  this->scene->MarkChanged();
   return true;
 }
 
@@ -174,7 +208,8 @@ bool OptixNode::DetachChild(NodePtr _child)
   }
 
   this->optixGroup->removeChild(derived->OptixTransform());
-  this->optixAccel->markDirty();
+  this->MarkAccelDirty(true);
+  this->scene->MarkChanged();
   return true;
 }
 
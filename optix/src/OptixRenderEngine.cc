@@ -15,8 +15,13 @@
  *
  */
 
+#include <map>
+#include <sstream>
+#include <string>
 #include <vector>
 
+#include <ignition/common/Console.hh>
+
 #include <ignition/plugin/Register.hh>
 
 #include "ignition/rendering/RenderEngineManager.hh"
@@ -104,6 +109,12 @@ std::string OptixRenderEngine::PtxFile(const std::string& _fileBase) const
   return file;
 }
 
+//////////////////////////////////////////////////
+int OptixRenderEngine::Device() const
+{
+  return this->device;
+}
+
 //////////////////////////////////////////////////
 ScenePtr OptixRenderEngine::CreateSceneImpl(unsigned int _id,
     const std::string &_name)
@@ -121,8 +132,49 @@ SceneStorePtr OptixRenderEngine::Scenes() const
 
 //////////////////////////////////////////////////
 bool OptixRenderEngine::LoadImpl(
-    const std::map<std::string, std::string> &/*_params*/)
+    const std::map<std::string, std::string> &_params)
 {
+  auto it = _params.find("device");
+  if (it != _params.end())
+  {
+    int value = -1;
+    if (!(std::istringstream(it->second) >> value) || value < 0)
+    {
+      ignerr << "Invalid device [" << it->second << "]" << std::endl;
+      return false;
+    }
+
+    unsigned int count = optix::ContextObj::getDeviceCount();
+    if (static_cast<unsigned int>(value) >= count)
+    {
+      ignerr << "CUDA device [" << value << "] not found, there are ["
+             << count << "] devices" << std::endl;
+      return false;
+    }
+    this->device = value;
+  }
+
+  // the execution mode must be chosen before the first context is created
+  bool rtx = true;
+  it = _params.find("rtx");
+  if (it != _params.end())
+    rtx = it->second != "0";
+
+#if OPTIX_VERSION >= 50100
+  int rtxValue = rtx ? 1 : 0;
+  if (rtGlobalSetAttribute(RT_GLOBAL_ATTRIBUTE_ENABLE_RTX, sizeof(rtxValue),
+      &rtxValue) != RT_SUCCESS)
+  {
+    ignwarn << "Failed to set the RTX execution mode of optix" << std::endl;
+  }
+#else
+  if (rtx)
+  {
+    igndbg << "The RTX execution mode requires OptiX 5.1 or later"
+           << std::endl;
+  }
+#endif
+
   return true;
 }
 
@@ -50,24 +50,39 @@ void OptixRenderTarget::Copy(Image &_image) const
     return;
   }
 
-  float3 *deviceData = static_cast<float3 *>(this->OptixBuffer()->map());
+  // the rows below are written as RGB
+  if (PixelUtil::IsBayer(_image.Format()))
+  {
+    ignerr << "Bayer images are not supported by the optix render engine"
+           << std::endl;
+    return;
+  }
+
+  if (this->CopyQuantized(_image))
+    return;
+
+  // rows are converted separately since the image rows may be padded
+  const float *deviceData =
+      static_cast<const float *>(this->OptixBuffer()->map());
   unsigned char *imageData = _image.Data<unsigned char>();
-  unsigned int count = this->width * this->height;
-  unsigned int index = 0;
+  unsigned int stride = _image.RowStride();
+  unsigned int rowSize = this->width * 3;
 
-  for (unsigned int i = 0; i < count; ++i)
+  for (unsigned int y = 0; y < this->height; ++y)
   {
-    imageData[index++] =
-        (unsigned char)fminf(fmaxf(255 * deviceData[i].x, 0), 255);
-    imageData[index++] =
-        (unsigned char)fminf(fmaxf(255 * deviceData[i].y, 0), 255);
-    imageData[index++] =
-        (unsigned char)fminf(fmaxf(255 * deviceData[i].z, 0), 255);
+    PixelUtil::Convert(deviceData + y * rowSize, PF_FLOAT32_RGB,
+        imageData + y * stride, PF_R8G8B8, this->width);
   }
 
   this->OptixBuffer()->unmap();
 }
 
+//////////////////////////////////////////////////
+bool OptixRenderTarget::CopyQuantized(Image &/*_image*/) const
+{
+  return false;
+}
+
 //////////////////////////////////////////////////
 unsigned int OptixRenderTarget::MemorySize() const
 {
@@ -98,6 +113,37 @@ optix::Buffer OptixRenderTexture::OptixBuffer() const
   return this->optixBuffer;
 }
 
+//////////////////////////////////////////////////
+bool OptixRenderTexture::CopyQuantized(Image &_image) const
+{
+  if (this->quantizeProgram.get() == nullptr)
+    return false;
+
+  optix::Context optixContext = this->scene->OptixContext();
+  optixContext->launch(this->quantizeId, this->width, this->height);
+
+  // only the 8 bit colors are read back, the alpha channel is dropped
+  const unsigned char *deviceData =
+      static_cast<const unsigned char *>(this->quantizedBuffer->map());
+  unsigned char *imageData = _image.Data<unsigned char>();
+  unsigned int stride = _image.RowStride();
+
+  for (unsigned int y = 0; y < this->height; ++y)
+  {
+    const unsigned char *src = deviceData + y * this->width * 4;
+    unsigned char *dst = imageData + y * stride;
+    for (unsigned int x = 0; x < this->width; ++x, src += 4, dst += 3)
+    {
+      dst[0] = src[0];
+      dst[1] = src[1];
+      dst[2] = src[2];
+    }
+  }
+
+  this->quantizedBuffer->unmap();
+  return true;
+}
+
 //////////////////////////////////////////////////
 void OptixRenderTexture::RebuildImpl()
 {
@@ -108,6 +154,7 @@ void OptixRenderTexture::RebuildImpl()
   this->hostData = new float[count];
 
   this->optixBuffer->setSize(this->width, this->height);
+  this->quantizedBuffer->setSize(this->width, this->height);
 }
 
 //////////////////////////////////////////////////
@@ -118,6 +165,32 @@ void OptixRenderTexture::Init()
   this->optixBuffer = optixContext->createBuffer(RT_BUFFER_OUTPUT);
   // this->optixBuffer->setFormat(RT_FORMAT_UNSIGNED_BYTE3);
   this->optixBuffer->setFormat(RT_FORMAT_FLOAT3);
+  this->quantizedBuffer = optixContext->createBuffer(RT_BUFFER_OUTPUT);
+  this->quantizedBuffer->setFormat(RT_FORMAT_UNSIGNED_BYTE4);
+  this->CreateQuantizeProgram();
+}
+
+//////////////////////////////////////////////////
+void OptixRenderTexture::CreateQuantizeProgram()
+{
+  try
+  {
+    this->quantizeProgram =
+        this->scene->CreateOptixProgram("OptixRenderTarget", "Quantize");
+  }
+  catch (optix::Exception &_e)
+  {
+    ignwarn << "Unable to create the program converting colors on the "
+            << "device, they will be converted on the host: "
+            << _e.getErrorString() << std::endl;
+    return;
+  }
+
+  optix::Context optixContext = this->scene->OptixContext();
+  optixContext->setRayGenerationProgram(this->quantizeId,
+      this->quantizeProgram);
+  this->quantizeProgram["buffer"]->setBuffer(this->optixBuffer);
+  this->quantizeProgram["quantizedBuffer"]->setBuffer(this->quantizedBuffer);
 }
 
 //////////////////////////////////////////////////
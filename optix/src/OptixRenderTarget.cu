@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <optix.h>
+#include <optix_math.h>
+
+rtDeclareVariable(uint2, launchIndex, rtLaunchIndex, );
+rtBuffer<float3, 2> buffer;
+rtBuffer<uchar4, 2> quantizedBuffer;
+
+static __inline__ __device__ unsigned char ToByte(float _value)
+{
+  return (unsigned char)fminf(fmaxf(255 * _value, 0), 255);
+}
+
+RT_PROGRAM void Quantize()
+{
+  float3 color = buffer[launchIndex];
+  quantizedBuffer[launchIndex] = make_uchar4(ToByte(color.x),
+      ToByte(color.y), ToByte(color.z), 255);
+}
@@ -21,7 +21,9 @@
 #include "ignition/rendering/optix/OptixCamera.hh"
 #include "ignition/rendering/optix/OptixCone.hh"
 #include "ignition/rendering/optix/OptixCylinder.hh"
+#include "ignition/rendering/optix/OptixDepthCamera.hh"
 #include "ignition/rendering/optix/OptixGeometry.hh"
+#include "ignition/rendering/optix/OptixGpuRays.hh"
 #include "ignition/rendering/optix/OptixGrid.hh"
 #include "ignition/rendering/optix/OptixLightManager.hh"
 #include "ignition/rendering/optix/OptixMeshFactory.hh"
@@ -31,6 +33,7 @@
 #include "ignition/rendering/optix/OptixScene.hh"
 #include "ignition/rendering/optix/OptixSphere.hh"
 #include "ignition/rendering/optix/OptixStorage.hh"
+#include "ignition/rendering/optix/OptixTextureFactory.hh"
 #include "ignition/rendering/optix/OptixVisual.hh"
 
 using namespace ignition;
@@ -99,6 +102,7 @@ void OptixScene::SetBackgroundColor(const math::Color &_color)
   this->backgroundColor = _color;
   this->optixMissProgram["color"]->setFloat(
       _color.R(), _color.G(), _color.B());
+  this->MarkChanged();
 }
 
 //////////////////////////////////////////////////
@@ -123,11 +127,26 @@ void OptixScene::RemoveGradientBackgroundColor()
 //////////////////////////////////////////////////
 void OptixScene::PreRender()
 {
+  // scene changes have already been flushed in this frame
+  if (this->FramePreRendered())
+    return;
+
+  this->ApplyCommands();
   this->lightManager->Clear();
   BaseScene::PreRender();
   this->lightManager->PreRender();
 }
 
+//////////////////////////////////////////////////
+void OptixScene::SetIncrementalPreRender(bool _enabled)
+{
+  // the light manager is rebuilt from a full traversal of the scene
+  if (_enabled)
+  {
+    ignwarn << "Incremental PreRender not supported for Optix" << std::endl;
+  }
+}
+
 //////////////////////////////////////////////////
 void OptixScene::Clear()
 {
@@ -150,6 +169,12 @@ optix::Context OptixScene::OptixContext() const
   return this->optixContext;
 }
 
+//////////////////////////////////////////////////
+OptixTextureFactoryPtr OptixScene::TextureFactory() const
+{
+  return this->textureFactory;
+}
+
 //////////////////////////////////////////////////
 optix::Program OptixScene::CreateOptixProgram(const std::string &_fileBase,
     const std::string &_function)
@@ -158,6 +183,18 @@ optix::Program OptixScene::CreateOptixProgram(const std::string &_fileBase,
   return this->optixContext->createProgramFromPTXFile(fileName, _function);
 }
 
+//////////////////////////////////////////////////
+void OptixScene::MarkChanged()
+{
+  ++this->changeCount;
+}
+
+//////////////////////////////////////////////////
+unsigned int OptixScene::ChangeCount() const
+{
+  return this->changeCount;
+}
+
 //////////////////////////////////////////////////
 bool OptixScene::LoadImpl()
 {
@@ -171,6 +208,7 @@ bool OptixScene::InitImpl()
   this->CreateRootVisual();
   this->CreateLightManager();
   this->CreateMeshFactory();
+  this->CreateTextureFactory();
   this->CreateStores();
   return true;
 }
@@ -233,19 +271,33 @@ CameraPtr OptixScene::CreateCameraImpl(unsigned int _id,
   OptixCameraPtr camera(new OptixCamera);
   camera->traceId = this->NextEntryId();
   camera->clearId = this->NextEntryId();
+  camera->accumulateId = this->NextEntryId();
+  camera->resolveId = this->NextEntryId();
   bool result = this->InitObject(camera, _id, _name);
   return (result) ? camera : nullptr;
 }
 
 //////////////////////////////////////////////////
-DepthCameraPtr OptixScene::CreateDepthCameraImpl(unsigned int /*_id*/,
-    const std::string &/*_name*/)
+DepthCameraPtr OptixScene::CreateDepthCameraImpl(unsigned int _id,
+    const std::string &_name)
 {
-  // TODO(anyone)
-  return DepthCameraPtr();
+  OptixDepthCameraPtr camera(new OptixDepthCamera);
+  camera->depthId = this->NextEntryId();
+  bool result = this->InitObject(camera, _id, _name);
+  return (result) ? camera : nullptr;
 }
 
 
+//////////////////////////////////////////////////
+GpuRaysPtr OptixScene::CreateGpuRaysImpl(unsigned int _id,
+    const std::string &_name)
+{
+  OptixGpuRaysPtr gpuRays(new OptixGpuRays);
+  gpuRays->rangeId = this->NextEntryId();
+  bool result = this->InitObject(gpuRays, _id, _name);
+  return (result) ? gpuRays : nullptr;
+}
+
 //////////////////////////////////////////////////
 VisualPtr OptixScene::CreateVisualImpl(unsigned int _id,
     const std::string &_name)
@@ -397,6 +449,7 @@ RenderTexturePtr OptixScene::CreateRenderTextureImpl(
     unsigned int _id, const std::string &_name)
 {
   OptixRenderTexturePtr renderTexture(new OptixRenderTexture);
+  renderTexture->quantizeId = this->NextEntryId();
   bool result = this->InitObject(renderTexture, _id, _name);
   return (result) ? renderTexture : nullptr;
 }
@@ -406,6 +459,7 @@ RenderWindowPtr OptixScene::CreateRenderWindowImpl(
     unsigned int _id, const std::string &_name)
 {
   OptixRenderWindowPtr renderWindow(new OptixRenderWindow);
+  renderWindow->quantizeId = this->NextEntryId();
   bool result = this->InitObject(renderWindow, _id, _name);
   return (result) ? renderWindow: nullptr;
 }
@@ -447,6 +501,11 @@ void OptixScene::CreateContext()
 {
   this->optixContext = optix::Context::create();
 
+  // restrict the context to the device selected when loading the engine
+  int device = OptixRenderEngine::Instance()->Device();
+  if (device >= 0)
+    this->optixContext->setDevices(&device, &device + 1);
+
   // TODO: set dynamically
   // this->optixContext->setStackSize(65536);
   // TODO: set dynamically
@@ -462,6 +521,9 @@ void OptixScene::CreateContext()
   this->optixContext["maxRefractionDepth"]->setInt(3);
   this->optixContext["importanceCutoff"]->setFloat(0.01);
 
+  // laser retro of the geometries without laser_retro user data
+  this->optixContext["retro"]->setFloat(0);
+
   // TODO: remove after testing
   this->optixContext->setPrintEnabled(true);
   this->optixContext->setPrintBufferSize(4096);
@@ -513,6 +575,14 @@ void OptixScene::CreateMeshFactory()
   this->meshFactory = OptixMeshFactoryPtr(new OptixMeshFactory(sharedThis));
 }
 
+//////////////////////////////////////////////////
+void OptixScene::CreateTextureFactory()
+{
+  OptixScenePtr sharedThis = this->SharedThis();
+  this->textureFactory =
+      OptixTextureFactoryPtr(new OptixTextureFactory(sharedThis));
+}
+
 //////////////////////////////////////////////////
 void OptixScene::CreateStores()
 {
@@ -24,8 +24,7 @@
 using namespace ignition;
 using namespace rendering;
 
-// TODO: clone texture sampler, reuse texture buffers
-
+//////////////////////////////////////////////////
 OptixTextureFactory::OptixTextureFactory(OptixScenePtr _scene) :
   scene(_scene)
 {
@@ -39,15 +38,56 @@ OptixTextureFactory::~OptixTextureFactory()
 //////////////////////////////////////////////////
 optix::TextureSampler OptixTextureFactory::Create(const std::string &_filename)
 {
-  optix::Buffer buffer = this->CreateBuffer(_filename);
-  return this->CreateSampler(buffer);
+  if (_filename.empty())
+  {
+    ignerr << "Cannot load texture from empty filename" << std::endl;
+    return this->Create();
+  }
+
+  auto iter = this->samplers.find(_filename);
+  if (iter == this->samplers.end())
+  {
+    optix::Buffer buffer = this->CreateBuffer(_filename);
+    iter = this->samplers.insert(
+        {_filename, {this->CreateSampler(buffer), 0u}}).first;
+  }
+
+  ++iter->second.count;
+  return iter->second.sampler;
 }
 
 //////////////////////////////////////////////////
 optix::TextureSampler OptixTextureFactory::Create()
 {
-  optix::Buffer buffer = this->CreateBuffer();
-  return this->CreateSampler(buffer);
+  auto iter = this->samplers.find(std::string());
+  if (iter == this->samplers.end())
+  {
+    optix::Buffer buffer = this->CreateBuffer();
+    iter = this->samplers.insert(
+        {std::string(), {this->CreateSampler(buffer), 0u}}).first;
+  }
+
+  ++iter->second.count;
+  return iter->second.sampler;
+}
+
+//////////////////////////////////////////////////
+void OptixTextureFactory::Destroy(optix::TextureSampler _sampler)
+{
+  for (auto iter = this->samplers.begin(); iter != this->samplers.end();
+      ++iter)
+  {
+    if (iter->second.sampler.get() != _sampler.get())
+      continue;
+
+    if (--iter->second.count == 0u)
+    {
+      iter->second.sampler->getBuffer(0, 0)->destroy();
+      iter->second.sampler->destroy();
+      this->samplers.erase(iter);
+    }
+    return;
+  }
 }
 
 //////////////////////////////////////////////////
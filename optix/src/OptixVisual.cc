@@ -15,10 +15,14 @@
  *
  */
 
+#include <algorithm>
+#include <variant>
+
 #include <ignition/common/Console.hh>
 
 #include "ignition/rendering/optix/OptixVisual.hh"
 #include "ignition/rendering/optix/OptixConversions.hh"
+#include "ignition/rendering/optix/OptixScene.hh"
 #include "ignition/rendering/optix/OptixStorage.hh"
 
 using namespace ignition;
@@ -50,15 +54,50 @@ optix::Acceleration OptixVisual::OptixAccel() const
 //////////////////////////////////////////////////
 void OptixVisual::PreRender()
 {
+  // only write the scale when it changed, as it changes the bounds of the
+  // geometries. This is done first so that the acceleration is updated in
+  // this frame.
+  math::Vector3d worldScale = this->WorldScale();
+  if (worldScale != this->geometryScale)
+  {
+    for (unsigned int i = 0; i < this->GeometryCount(); ++i)
+    {
+      OptixGeometryPtr geometry = this->geometries->DerivedByIndex(i);
+      geometry->SetScale(worldScale);
+    }
+    this->geometryScale = worldScale;
+    this->MarkAccelDirty(false);
+  }
+
+  if (this->retroDirty || this->retroVersion != this->UserDataVersion())
+    this->WriteRetroToDevice();
+
   BaseVisual::PreRender();
+}
 
-  // TODO: optimize this funtionality
-  math::Vector3d worldScale = this->WorldScale();
+//////////////////////////////////////////////////
+void OptixVisual::WriteRetroToDevice()
+{
+  this->retroVersion = this->UserDataVersion();
+  this->retroDirty = false;
+
+  static const UserDataKey laserRetroKey("laser_retro");
+  const Variant &userData = this->UserData(laserRetroKey);
+  float retroValue = 0;
+  if (auto value = std::get_if<float>(&userData))
+    retroValue = *value;
+  else if (auto value = std::get_if<double>(&userData))
+    retroValue = static_cast<float>(*value);
+  else if (auto value = std::get_if<int>(&userData))
+    retroValue = static_cast<float>(*value);
+
+  // limit laser retro value to 2000 (as in gazebo)
+  retroValue = std::min(std::max(retroValue, 0.0f), 2000.0f) / 2000.0f;
 
   for (unsigned int i = 0; i < this->GeometryCount(); ++i)
   {
     OptixGeometryPtr geometry = this->geometries->DerivedByIndex(i);
-    geometry->SetScale(worldScale);
+    geometry->SetRetro(retroValue);
   }
 }
 
@@ -85,7 +124,10 @@ bool OptixVisual::AttachGeometry(GeometryPtr _geometry)
   derived->SetParent(this->SharedThis());
   optix::GeometryGroup childGeomGroup = derived->OptixGeometryGroup();
   this->optixGroup->addChild(childGeomGroup);
-  this->optixAccel->markDirty();
+  this->MarkAccelDirty(true);
+  this->geometryScale = math::Vector3d::Zero;
+  this->retroDirty = true;
+  this->scene->MarkChanged();
   return true;
 }
 
@@ -104,7 +146,8 @@ bool OptixVisual::DetachGeometry(GeometryPtr _geometry)
   }
 
   this->optixGroup->removeChild(derived->OptixGeometryGroup());
-  this->optixAccel->markDirty();
+  this->MarkAccelDirty(true);
+  this->scene->MarkChanged();
   return true;
 }
 
@@ -0,0 +1,556 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ignition/rendering/AabbTree.hh"
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// \brief Private data class for AabbTree
+class ignition::rendering::AabbTreePrivate
+{
+  /// \brief Index of no node
+  public: static const int kNull = -1;
+
+  /// \brief A node of the hierarchy
+  public: struct Node
+  {
+    /// \brief Minimum corner of the enlarged bounds of the node
+    math::Vector3d min;
+
+    /// \brief Maximum corner of the enlarged bounds of the node
+    math::Vector3d max;
+
+    /// \brief Box of a leaf, as given to Update
+    math::AxisAlignedBox box;
+
+    /// \brief Parent node, or next free node for unused nodes
+    int parent = kNull;
+
+    /// \brief First child, kNull for leaves
+    int child1 = kNull;
+
+    /// \brief Second child, kNull for leaves
+    int child2 = kNull;
+
+    /// \brief Height of the subtree, 0 for leaves, -1 for unused nodes
+    int height = -1;
+
+    /// \brief Id of the box of a leaf
+    unsigned int id = 0u;
+
+    /// \brief Check if the node is a leaf
+    /// \return True if the node is a leaf
+    bool IsLeaf() const
+    {
+      return this->child1 == kNull;
+    }
+  };
+
+  /// \brief Get a node from the free list, growing the pool if needed
+  /// \return Index of the node
+  public: int AllocateNode();
+
+  /// \brief Return a node to the free list
+  /// \param[in] _node Index of the node
+  public: void FreeNode(int _node);
+
+  /// \brief Insert a leaf in the hierarchy
+  /// \param[in] _leaf Index of the leaf, with its bounds set
+  public: void InsertLeaf(int _leaf);
+
+  /// \brief Remove a leaf from the hierarchy, the node is not freed
+  /// \param[in] _leaf Index of the leaf
+  public: void RemoveLeaf(int _leaf);
+
+  /// \brief Rebalance and refit the ancestors of a node
+  /// \param[in] _node First node to refit
+  public: void Refit(int _node);
+
+  /// \brief Rotate a node to balance its subtree
+  /// \param[in] _node Index of the node
+  /// \return Index of the new root of the subtree
+  public: int Balance(int _node);
+
+  /// \brief Set the bounds and height of a node from its children
+  /// \param[in] _node Index of the node
+  public: void Merge(int _node);
+
+  /// \brief Surface area of the union of two bounds, up to a factor 2
+  /// \param[in] _min1 Minimum corner of the first bounds
+  /// \param[in] _max1 Maximum corner of the first bounds
+  /// \param[in] _min2 Minimum corner of the second bounds
+  /// \param[in] _max2 Maximum corner of the second bounds
+  /// \return Surface area of the union
+  public: static double Area(const math::Vector3d &_min1,
+      const math::Vector3d &_max1, const math::Vector3d &_min2,
+      const math::Vector3d &_max2);
+
+  /// \brief Collect the ids of the leaves accepted by a test, skipping the
+  /// subtrees whose bounds are rejected
+  /// \param[in] _nodeTest Test of the enlarged bounds of a node
+  /// \param[in] _boxTest Test of the box of a leaf
+  /// \return Ids of the accepted leaves
+  public: template <typename N, typename B>
+      std::vector<unsigned int> Query(N _nodeTest, B _boxTest) const;
+
+  /// \brief Distance boxes are enlarged by in the hierarchy
+  public: double margin = 0.1;
+
+  /// \brief Pool of nodes
+  public: std::vector<Node> nodes;
+
+  /// \brief Root of the hierarchy
+  public: int root = kNull;
+
+  /// \brief First node of the free list
+  public: int freeList = kNull;
+
+  /// \brief Leaf of each id
+  public: std::unordered_map<unsigned int, int> leaves;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+int AabbTreePrivate::AllocateNode()
+{
+  if (this->freeList == kNull)
+  {
+    this->nodes.emplace_back();
+    this->nodes.back().height = 0;
+    return static_cast<int>(this->nodes.size()) - 1;
+  }
+
+  int node = this->freeList;
+  this->freeList = this->nodes[node].parent;
+  this->nodes[node] = Node();
+  this->nodes[node].height = 0;
+  return node;
+}
+
+//////////////////////////////////////////////////
+void AabbTreePrivate::FreeNode(int _node)
+{
+  this->nodes[_node].parent = this->freeList;
+  this->nodes[_node].height = -1;
+  this->freeList = _node;
+}
+
+//////////////////////////////////////////////////
+double AabbTreePrivate::Area(const math::Vector3d &_min1,
+    const math::Vector3d &_max1, const math::Vector3d &_min2,
+    const math::Vector3d &_max2)
+{
+  double x = std::max(_max1.X(), _max2.X()) - std::min(_min1.X(), _min2.X());
+  double y = std::max(_max1.Y(), _max2.Y()) - std::min(_min1.Y(), _min2.Y());
+  double z = std::max(_max1.Z(), _max2.Z()) - std::min(_min1.Z(), _min2.Z());
+  return x * y + y * z + z * x;
+}
+
+//////////////////////////////////////////////////
+void AabbTreePrivate::Merge(int _node)
+{
+  Node &node = this->nodes[_node];
+  const Node &child1 = this->nodes[node.child1];
+  const Node &child2 = this->nodes[node.child2];
+  node.min = math::Vector3d(
+      std::min(child1.min.X(), child2.min.X()),
+      std::min(child1.min.Y(), child2.min.Y()),
+      std::min(child1.min.Z(), child2.min.Z()));
+  node.max = math::Vector3d(
+      std::max(child1.max.X(), child2.max.X()),
+      std::max(child1.max.Y(), child2.max.Y()),
+      std::max(child1.max.Z(), child2.max.Z()));
+  node.height = 1 + std::max(child1.height, child2.height);
+}
+
+//////////////////////////////////////////////////
+void AabbTreePrivate::InsertLeaf(int _leaf)
+{
+  if (this->root == kNull)
+  {
+    this->root = _leaf;
+    this->nodes[_leaf].parent = kNull;
+    return;
+  }
+
+  // descend towards the sibling that grows the surface area of the
+  // hierarchy the least
+  const math::Vector3d leafMin = this->nodes[_leaf].min;
+  const math::Vector3d leafMax = this->nodes[_leaf].max;
+  int index = this->root;
+  while (!this->nodes[index].IsLeaf())
+  {
+    const Node &node = this->nodes[index];
+    double area = Area(node.min, node.max, node.min, node.max);
+    double combinedArea = Area(node.min, node.max, leafMin, leafMax);
+
+    // cost of making a new parent for this node and the leaf, and minimum
+    // cost of pushing the leaf further down
+    double cost = 2.0 * combinedArea;
+    double inheritanceCost = 2.0 * (combinedArea - area);
+
+    double childCost[2];
+    int children[2] = {node.child1, node.child2};
+    for (int i = 0; i < 2; ++i)
+    {
+      const Node &child = this->nodes[children[i]];
+      double childArea = Area(child.min, child.max, leafMin, leafMax);
+      if (!child.IsLeaf())
+        childArea -= Area(child.min, child.max, child.min, child.max);
+      childCost[i] = childArea + inheritanceCost;
+    }
+
+    if (cost < childCost[0] && cost < childCost[1])
+      break;
+
+    index = childCost[0] < childCost[1] ? children[0] : children[1];
+  }
+
+  // new parent of the sibling and the leaf
+  int sibling = index;
+  int oldParent = this->nodes[sibling].parent;
+  int newParent = this->AllocateNode();
+  this->nodes[newParent].parent = oldParent;
+  this->nodes[newParent].child1 = sibling;
+  this->nodes[newParent].child2 = _leaf;
+  this->nodes[sibling].parent = newParent;
+  this->nodes[_leaf].parent = newParent;
+
+  if (oldParent == kNull)
+    this->root = newParent;
+  else if (this->nodes[oldParent].child1 == sibling)
+    this->nodes[oldParent].child1 = newParent;
+  else
+    this->nodes[oldParent].child2 = newParent;
+
+  this->Refit(newParent);
+}
+
+//////////////////////////////////////////////////
+void AabbTreePrivate::RemoveLeaf(int _leaf)
+{
+  if (_leaf == this->root)
+  {
+    this->root = kNull;
+    return;
+  }
+
+  int parent = this->nodes[_leaf].parent;
+  int grandParent = this->nodes[parent].parent;
+  int sibling = this->nodes[parent].child1 == _leaf ?
+      this->nodes[parent].child2 : this->nodes[parent].child1;
+
+  // the sibling takes the place of the parent
+  this->nodes[sibling].parent = grandParent;
+  this->FreeNode(parent);
+  if (grandParent == kNull)
+  {
+    this->root = sibling;
+    return;
+  }
+
+  if (this->nodes[grandParent].child1 == parent)
+    this->nodes[grandParent].child1 = sibling;
+  else
+    this->nodes[grandParent].child2 = sibling;
+  this->Refit(grandParent);
+}
+
+//////////////////////////////////////////////////
+void AabbTreePrivate::Refit(int _node)
+{
+  int index = _node;
+  while (index != kNull)
+  {
+    index = this->Balance(index);
+    this->Merge(index);
+    index = this->nodes[index].parent;
+  }
+}
+
+//////////////////////////////////////////////////
+int AabbTreePrivate::Balance(int _node)
+{
+  // a is the node, b and c its children. The taller child is rotated up if
+  // the heights of the children differ by more than one.
+  int a = _node;
+  if (this->nodes[a].IsLeaf() || this->nodes[a].height < 2)
+    return a;
+
+  int b = this->nodes[a].child1;
+  int c = this->nodes[a].child2;
+  int balance = this->nodes[c].height - this->nodes[b].height;
+  if (balance >= -1 && balance <= 1)
+    return a;
+
+  // up is the child rotated up, other the child that stays below a
+  int up = balance > 1 ? c : b;
+  int other = balance > 1 ? b : c;
+  int f = this->nodes[up].child1;
+  int g = this->nodes[up].child2;
+
+  // up replaces a
+  int parent = this->nodes[a].parent;
+  this->nodes[up].parent = parent;
+  this->nodes[a].parent = up;
+  if (parent == kNull)
+    this->root = up;
+  else if (this->nodes[parent].child1 == a)
+    this->nodes[parent].child1 = up;
+  else
+    this->nodes[parent].child2 = up;
+
+  // the taller grandchild stays below up, the other one moves below a
+  int keep = this->nodes[f].height > this->nodes[g].height ? f : g;
+  int move = keep == f ? g : f;
+  this->nodes[up].child1 = a;
+  this->nodes[up].child2 = keep;
+  this->nodes[a].child1 = other;
+  this->nodes[a].child2 = move;
+  this->nodes[move].parent = a;
+  this->nodes[other].parent = a;
+
+  this->Merge(a);
+  this->Merge(up);
+  return up;
+}
+
+//////////////////////////////////////////////////
+template <typename N, typename B>
+std::vector<unsigned int> AabbTreePrivate::Query(N _nodeTest,
+    B _boxTest) const
+{
+  std::vector<unsigned int> result;
+  if (this->root == kNull)
+    return result;
+
+  std::vector<int> stack;
+  stack.push_back(this->root);
+  while (!stack.empty())
+  {
+    const Node &node = this->nodes[stack.back()];
+    stack.pop_back();
+
+    if (!_nodeTest(node.min, node.max))
+      continue;
+
+    if (node.IsLeaf())
+    {
+      if (_boxTest(node.box))
+        result.push_back(node.id);
+    }
+    else
+    {
+      stack.push_back(node.child1);
+      stack.push_back(node.child2);
+    }
+  }
+  return result;
+}
+
+//////////////////////////////////////////////////
+AabbTree::AabbTree(double _margin)
+  : dataPtr(new AabbTreePrivate)
+{
+  this->dataPtr->margin = std::max(0.0, _margin);
+}
+
+//////////////////////////////////////////////////
+AabbTree::~AabbTree()
+{
+}
+
+//////////////////////////////////////////////////
+bool AabbTree::Update(unsigned int _id, const math::AxisAlignedBox &_box)
+{
+  const math::Vector3d &min = _box.Min();
+  const math::Vector3d &max = _box.Max();
+  if (!(min.X() <= max.X() && min.Y() <= max.Y() && min.Z() <= max.Z()) ||
+      !min.IsFinite() || !max.IsFinite())
+  {
+    return false;
+  }
+
+  const double margin = this->dataPtr->margin;
+  const math::Vector3d enlarge(margin, margin, margin);
+
+  auto it = this->dataPtr->leaves.find(_id);
+  int leaf;
+  if (it != this->dataPtr->leaves.end())
+  {
+    leaf = it->second;
+    AabbTreePrivate::Node &node = this->dataPtr->nodes[leaf];
+    node.box = _box;
+
+    // keep the leaf where it is while its enlarged bounds contain the box
+    // and are not too large for it, e.g. after the box shrank
+    const math::Vector3d outer = enlarge * 4.0;
+    if (node.min.X() <= min.X() && node.min.Y() <= min.Y() &&
+        node.min.Z() <= min.Z() && node.max.X() >= max.X() &&
+        node.max.Y() >= max.Y() && node.max.Z() >= max.Z() &&
+        node.min.X() >= min.X() - outer.X() &&
+        node.min.Y() >= min.Y() - outer.Y() &&
+        node.min.Z() >= min.Z() - outer.Z() &&
+        node.max.X() <= max.X() + outer.X() &&
+        node.max.Y() <= max.Y() + outer.Y() &&
+        node.max.Z() <= max.Z() + outer.Z())
+    {
+      return false;
+    }
+
+    this->dataPtr->RemoveLeaf(leaf);
+  }
+  else
+  {
+    leaf = this->dataPtr->AllocateNode();
+    this->dataPtr->nodes[leaf].id = _id;
+    this->dataPtr->nodes[leaf].box = _box;
+    this->dataPtr->leaves[_id] = leaf;
+  }
+
+  this->dataPtr->nodes[leaf].min = min - enlarge;
+  this->dataPtr->nodes[leaf].max = max + enlarge;
+  this->dataPtr->InsertLeaf(leaf);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool AabbTree::Remove(unsigned int _id)
+{
+  auto it = this->dataPtr->leaves.find(_id);
+  if (it == this->dataPtr->leaves.end())
+    return false;
+
+  this->dataPtr->RemoveLeaf(it->second);
+  this->dataPtr->FreeNode(it->second);
+  this->dataPtr->leaves.erase(it);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void AabbTree::Clear()
+{
+  this->dataPtr->nodes.clear();
+  this->dataPtr->leaves.clear();
+  this->dataPtr->root = AabbTreePrivate::kNull;
+  this->dataPtr->freeList = AabbTreePrivate::kNull;
+}
+
+//////////////////////////////////////////////////
+bool AabbTree::Contains(unsigned int _id) const
+{
+  return this->dataPtr->leaves.find(_id) != this->dataPtr->leaves.end();
+}
+
+//////////////////////////////////////////////////
+math::AxisAlignedBox AabbTree::Box(unsigned int _id) const
+{
+  auto it = this->dataPtr->leaves.find(_id);
+  if (it == this->dataPtr->leaves.end())
+    return math::AxisAlignedBox();
+  return this->dataPtr->nodes[it->second].box;
+}
+
+//////////////////////////////////////////////////
+unsigned int AabbTree::Size() const
+{
+  return static_cast<unsigned int>(this->dataPtr->leaves.size());
+}
+
+//////////////////////////////////////////////////
+std::vector<unsigned int> AabbTree::Ids() const
+{
+  std::vector<unsigned int> ids;
+  ids.reserve(this->dataPtr->leaves.size());
+  for (const auto &leaf : this->dataPtr->leaves)
+    ids.push_back(leaf.first);
+  return ids;
+}
+
+//////////////////////////////////////////////////
+unsigned int AabbTree::Height() const
+{
+  if (this->dataPtr->root == AabbTreePrivate::kNull)
+    return 0u;
+  return static_cast<unsigned int>(
+      this->dataPtr->nodes[this->dataPtr->root].height) + 1u;
+}
+
+//////////////////////////////////////////////////
+std::vector<unsigned int> AabbTree::QueryBox(
+    const math::AxisAlignedBox &_box) const
+{
+  const math::Vector3d &min = _box.Min();
+  const math::Vector3d &max = _box.Max();
+  auto overlaps = [&](const math::Vector3d &_min, const math::Vector3d &_max)
+  {
+    return _min.X() <= max.X() && _max.X() >= min.X() &&
+        _min.Y() <= max.Y() && _max.Y() >= min.Y() &&
+        _min.Z() <= max.Z() && _max.Z() >= min.Z();
+  };
+
+  return this->dataPtr->Query(overlaps,
+      [&](const math::AxisAlignedBox &_b)
+      {
+        return overlaps(_b.Min(), _b.Max());
+      });
+}
+
+//////////////////////////////////////////////////
+std::vector<unsigned int> AabbTree::QuerySphere(
+    const math::Vector3d &_center, double _radius) const
+{
+  const double radius2 = _radius * _radius;
+  auto overlaps = [&](const math::Vector3d &_min, const math::Vector3d &_max)
+  {
+    // distance from the center to the closest point of the bounds
+    math::Vector3d closest(
+        std::max(_min.X(), std::min(_center.X(), _max.X())),
+        std::max(_min.Y(), std::min(_center.Y(), _max.Y())),
+        std::max(_min.Z(), std::min(_center.Z(), _max.Z())));
+    return (closest - _center).SquaredLength() <= radius2;
+  };
+
+  if (_radius < 0.0)
+    return std::vector<unsigned int>();
+
+  return this->dataPtr->Query(overlaps,
+      [&](const math::AxisAlignedBox &_b)
+      {
+        return overlaps(_b.Min(), _b.Max());
+      });
+}
+
+//////////////////////////////////////////////////
+std::vector<unsigned int> AabbTree::QueryFrustum(
+    const math::Frustum &_frustum) const
+{
+  return this->dataPtr->Query(
+      [&](const math::Vector3d &_min, const math::Vector3d &_max)
+      {
+        return _frustum.Contains(math::AxisAlignedBox(_min, _max));
+      },
+      [&](const math::AxisAlignedBox &_b)
+      {
+        return _frustum.Contains(_b);
+      });
+}
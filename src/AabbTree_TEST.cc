@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/AabbTree.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(AabbTreeTest, Empty)
+{
+  AabbTree tree;
+  EXPECT_EQ(0u, tree.Size());
+  EXPECT_EQ(0u, tree.Height());
+  EXPECT_FALSE(tree.Contains(1u));
+  EXPECT_FALSE(tree.Remove(1u));
+  EXPECT_TRUE(tree.QueryBox(math::AxisAlignedBox(
+      math::Vector3d(-1, -1, -1), math::Vector3d(1, 1, 1))).empty());
+
+  // empty boxes are rejected
+  EXPECT_FALSE(tree.Update(1u, math::AxisAlignedBox()));
+  EXPECT_FALSE(tree.Contains(1u));
+}
+
+/////////////////////////////////////////////////
+TEST(AabbTreeTest, UpdateRemove)
+{
+  AabbTree tree(0.1);
+  math::AxisAlignedBox box(math::Vector3d(0, 0, 0), math::Vector3d(1, 1, 1));
+  EXPECT_TRUE(tree.Update(3u, box));
+  EXPECT_TRUE(tree.Contains(3u));
+  EXPECT_EQ(1u, tree.Size());
+  EXPECT_EQ(1u, tree.Height());
+  EXPECT_EQ(box.Min(), tree.Box(3u).Min());
+  EXPECT_EQ(box.Max(), tree.Box(3u).Max());
+
+  // small moves stay in the enlarged box of the leaf
+  math::AxisAlignedBox moved(math::Vector3d(0.05, 0, 0),
+      math::Vector3d(1.05, 1, 1));
+  EXPECT_FALSE(tree.Update(3u, moved));
+  EXPECT_EQ(moved.Min(), tree.Box(3u).Min());
+
+  // larger ones move the leaf
+  math::AxisAlignedBox far(math::Vector3d(10, 0, 0),
+      math::Vector3d(11, 1, 1));
+  EXPECT_TRUE(tree.Update(3u, far));
+  EXPECT_EQ(1u, tree.Size());
+
+  math::AxisAlignedBox query(math::Vector3d(-1, -1, -1),
+      math::Vector3d(2, 2, 2));
+  EXPECT_TRUE(tree.QueryBox(query).empty());
+
+  EXPECT_TRUE(tree.Remove(3u));
+  EXPECT_FALSE(tree.Contains(3u));
+  EXPECT_EQ(0u, tree.Size());
+}
+
+/////////////////////////////////////////////////
+TEST(AabbTreeTest, Queries)
+{
+  // unit boxes on a 20 x 20 x 20 grid, two units apart
+  AabbTree tree;
+  const unsigned int size = 20u;
+  for (unsigned int i = 0; i < size; ++i)
+  {
+    for (unsigned int j = 0; j < size; ++j)
+    {
+      for (unsigned int k = 0; k < size; ++k)
+      {
+        math::Vector3d min(i * 2.0, j * 2.0, k * 2.0);
+        tree.Update((i * size + j) * size + k,
+            math::AxisAlignedBox(min, min + math::Vector3d(1, 1, 1)));
+      }
+    }
+  }
+  EXPECT_EQ(size * size * size, tree.Size());
+
+  // balanced, the leaves are not much deeper than log2(8000) = 13
+  EXPECT_LT(tree.Height(), 30u);
+
+  // the box covers the boxes of indices 1 and 2 along each axis
+  std::vector<unsigned int> ids = tree.QueryBox(math::AxisAlignedBox(
+      math::Vector3d(2.5, 2.5, 2.5), math::Vector3d(4.5, 4.5, 4.5)));
+  EXPECT_EQ(8u, ids.size());
+  for (auto id : ids)
+  {
+    unsigned int i = id / (size * size);
+    unsigned int j = (id / size) % size;
+    unsigned int k = id % size;
+    EXPECT_TRUE(i >= 1u && i <= 2u);
+    EXPECT_TRUE(j >= 1u && j <= 2u);
+    EXPECT_TRUE(k >= 1u && k <= 2u);
+  }
+
+  // the sphere only reaches the box of the corner
+  ids = tree.QuerySphere(math::Vector3d(-1, -1, -1), 1.8);
+  ASSERT_EQ(1u, ids.size());
+  EXPECT_EQ(0u, ids[0]);
+
+  ids = tree.QuerySphere(math::Vector3d(-1, -1, -1), 1.0);
+  EXPECT_TRUE(ids.empty());
+
+  // removing half of the boxes
+  for (unsigned int id = 0; id < size * size * size; id += 2u)
+    EXPECT_TRUE(tree.Remove(id));
+  EXPECT_EQ(size * size * size / 2u, tree.Size());
+  ids = tree.QueryBox(math::AxisAlignedBox(
+      math::Vector3d(-1, -1, -1), math::Vector3d(100, 100, 100)));
+  EXPECT_EQ(size * size * size / 2u, ids.size());
+  for (auto id : ids)
+    EXPECT_EQ(1u, id % 2u);
+
+  tree.Clear();
+  EXPECT_EQ(0u, tree.Size());
+  EXPECT_EQ(0u, tree.Height());
+}
+
+/////////////////////////////////////////////////
+TEST(AabbTreeTest, Frustum)
+{
+  AabbTree tree;
+  tree.Update(1u, math::AxisAlignedBox(math::Vector3d(4, -0.5, -0.5),
+      math::Vector3d(5, 0.5, 0.5)));
+  tree.Update(2u, math::AxisAlignedBox(math::Vector3d(-5, -0.5, -0.5),
+      math::Vector3d(-4, 0.5, 0.5)));
+
+  // looking along +x from the origin
+  math::Frustum frustum(0.1, 10, math::Angle(IGN_PI * 0.5), 1.0,
+      math::Pose3d::Zero);
+  std::vector<unsigned int> ids = tree.QueryFrustum(frustum);
+  ASSERT_EQ(1u, ids.size());
+  EXPECT_EQ(1u, ids[0]);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
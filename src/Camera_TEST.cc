@@ -17,15 +17,22 @@
 
 #include <gtest/gtest.h>
 
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+
 #include <ignition/common/Console.hh>
 
 #include "test_config.h"  // NOLINT(build/include)
 #include "ignition/rendering/Camera.hh"
 #include "ignition/rendering/GaussianNoisePass.hh"
+#include "ignition/rendering/GpuFrameEncoder.hh"
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/RenderingIface.hh"
 #include "ignition/rendering/RenderPassSystem.hh"
 #include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
 
 using namespace ignition;
 using namespace rendering;
@@ -47,6 +54,71 @@ class CameraTest : public testing::Test,
 
   /// \brief Test setting visibility mask
   public: void VisibilityMask(const std::string &_renderEngine);
+
+  /// \brief Test the GPU times of the camera passes
+  public: void GpuTimes(const std::string &_renderEngine);
+
+  /// \brief Test the statistics of the camera frames
+  public: void LastFrameStats(const std::string &_renderEngine);
+
+  /// \brief Test dynamic resolution
+  public: void DynamicResolution(const std::string &_renderEngine);
+
+  /// \brief Test order independent transparency
+  public: void OrderIndependentTransparency(
+      const std::string &_renderEngine);
+
+  /// \brief Test streaming frames to a frame encoder
+  public: void FrameEncoder(const std::string &_renderEngine);
+
+  /// \brief Test copying regions of the image
+  public: void CopyRegion(const std::string &_renderEngine);
+
+  /// \brief Test rendering only when the camera or the scene changed
+  public: void OnDemandRendering(const std::string &_renderEngine);
+};
+
+/// \brief Frame encoder emitting one packet per frame
+class MockFrameEncoder : public GpuFrameEncoder
+{
+  // Documentation inherited.
+  public: bool RegisterTexture(unsigned int _textureId, unsigned int,
+      unsigned int, PixelFormat) override
+  {
+    this->textureId = _textureId;
+    ++this->registerCount;
+    return true;
+  }
+
+  // Documentation inherited.
+  public: bool EncodeFrame(uint64_t _frame) override
+  {
+    EncodedPacket packet;
+    packet.data = &this->byte;
+    packet.size = 1u;
+    packet.frame = _frame;
+    packet.keyFrame = _frame == 0u;
+    this->EmitPacket(packet);
+    return true;
+  }
+
+  // Documentation inherited.
+  public: void UnregisterTexture() override
+  {
+    ++this->unregisterCount;
+  }
+
+  /// \brief Registered texture
+  public: unsigned int textureId = 0u;
+
+  /// \brief Number of calls to RegisterTexture
+  public: unsigned int registerCount = 0u;
+
+  /// \brief Number of calls to UnregisterTexture
+  public: unsigned int unregisterCount = 0u;
+
+  /// \brief Content of the packets
+  private: unsigned char byte = 0u;
 };
 
 /////////////////////////////////////////////////
@@ -91,6 +163,38 @@ void CameraTest::ViewProjectionMatrix(const std::string &_renderEngine)
 
   EXPECT_NE(projMatrix, camera->ProjectionMatrix());
 
+  // level of detail bias
+  EXPECT_DOUBLE_EQ(1.0, camera->LodBias());
+  camera->SetLodBias(0.25);
+  EXPECT_DOUBLE_EQ(0.25, camera->LodBias());
+  camera->SetLodBias(-1.0);
+  EXPECT_DOUBLE_EQ(0.25, camera->LodBias());
+
+  // impostors
+  EXPECT_TRUE(camera->ImpostorsEnabled());
+  camera->SetImpostorsEnabled(false);
+  EXPECT_FALSE(camera->ImpostorsEnabled());
+  EXPECT_DOUBLE_EQ(0.25, camera->LodBias());
+  camera->SetImpostorsEnabled(true);
+  EXPECT_TRUE(camera->ImpostorsEnabled());
+
+  // shadows
+  EXPECT_TRUE(camera->ShadowsEnabled());
+  camera->SetShadowsEnabled(false);
+  EXPECT_FALSE(camera->ShadowsEnabled());
+  camera->SetShadowsEnabled(true);
+  EXPECT_TRUE(camera->ShadowsEnabled());
+
+  EXPECT_EQ(0u, camera->ShadowMapSize());
+  camera->SetShadowMapSize(512u);
+  EXPECT_EQ(512u, camera->ShadowMapSize());
+  camera->SetShadowMapSize(500u);
+  EXPECT_EQ(512u, camera->ShadowMapSize());
+  camera->SetShadowMapSize(8192u);
+  EXPECT_EQ(512u, camera->ShadowMapSize());
+  camera->SetShadowMapSize(0u);
+  EXPECT_EQ(0u, camera->ShadowMapSize());
+
   // view matrix
   math::Matrix4d viewMatrix = camera->ViewMatrix();
   EXPECT_EQ(math::Vector3d::Zero, camera->LocalPosition());
@@ -314,6 +418,251 @@ void CameraTest::VisibilityMask(const std::string &_renderEngine)
   rendering::unloadEngine(engine->Name());
 }
 
+/////////////////////////////////////////////////
+void CameraTest::GpuTimes(const std::string &_renderEngine)
+{
+  // create and populate scene
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(64u);
+  camera->SetImageHeight(64u);
+  scene->RootVisual()->AddChild(camera);
+
+  // disabled by default, nothing is timed
+  EXPECT_FALSE(engine->GpuTimingEnabled());
+  camera->Update();
+  EXPECT_TRUE(camera->GpuTimes().empty());
+  EXPECT_TRUE(engine->SetGpuTimingEnabled(false));
+
+  if (!engine->SetGpuTimingEnabled(true))
+  {
+    EXPECT_FALSE(engine->GpuTimingEnabled());
+    igndbg << "GPU timing not supported by engine '" << _renderEngine
+           << "'" << std::endl;
+    engine->DestroyScene(scene);
+    rendering::unloadEngine(engine->Name());
+    return;
+  }
+  EXPECT_TRUE(engine->GpuTimingEnabled());
+
+  // the times lag a few frames behind
+  for (unsigned int i = 0u; i < 10u; ++i)
+    camera->Update();
+
+  std::map<std::string, double> times = camera->GpuTimes();
+  ASSERT_FALSE(times.empty());
+  EXPECT_NE(times.end(), times.find("scene"));
+  for (const auto &time : times)
+    EXPECT_LE(0.0, time.second) << time.first;
+
+  // disabling discards the times
+  EXPECT_TRUE(engine->SetGpuTimingEnabled(false));
+  EXPECT_FALSE(engine->GpuTimingEnabled());
+  EXPECT_TRUE(camera->GpuTimes().empty());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void CameraTest::LastFrameStats(const std::string &_renderEngine)
+{
+  // create and populate scene
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(64u);
+  camera->SetImageHeight(64u);
+  camera->SetLocalPosition(-2.0, 0.0, 0.0);
+  scene->RootVisual()->AddChild(camera);
+
+  VisualPtr box = scene->CreateVisual();
+  ASSERT_NE(nullptr, box);
+  box->AddGeometry(scene->CreateBox());
+  scene->RootVisual()->AddChild(box);
+
+  // nothing is counted before the first frame
+  rendering::FrameStats stats = camera->LastFrameStats();
+  EXPECT_EQ(0u, stats.drawCalls);
+  EXPECT_EQ(0u, stats.triangles);
+  EXPECT_EQ(0u, stats.readbackBytes);
+  EXPECT_DOUBLE_EQ(0.0, stats.gpuTime);
+
+  // a frame lasts until the next one begins
+  camera->Update();
+  camera->Update();
+  stats = camera->LastFrameStats();
+  EXPECT_LE(0.0, stats.cpuTime);
+
+  // only ogre2 reports the counters of its render system
+  if (_renderEngine == "ogre2")
+  {
+    EXPECT_LT(0u, stats.drawCalls);
+    EXPECT_LE(12u, stats.triangles);
+  }
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void CameraTest::DynamicResolution(const std::string &_renderEngine)
+{
+  // create and populate scene
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(64u);
+  camera->SetImageHeight(48u);
+  scene->RootVisual()->AddChild(camera);
+
+  // defaults
+  EXPECT_FALSE(camera->DynamicResolutionEnabled());
+  EXPECT_DOUBLE_EQ(16.0, camera->TargetGpuTime());
+  EXPECT_DOUBLE_EQ(0.5, camera->MinResolutionScale());
+  EXPECT_DOUBLE_EQ(1.0, camera->MaxResolutionScale());
+  EXPECT_DOUBLE_EQ(1.0, camera->ResolutionScale());
+
+  // invalid values are ignored
+  camera->SetTargetGpuTime(8.0);
+  camera->SetTargetGpuTime(0.0);
+  EXPECT_DOUBLE_EQ(8.0, camera->TargetGpuTime());
+  camera->SetResolutionScaleRange(0.25, 0.8);
+  camera->SetResolutionScaleRange(0.0, 1.0);
+  camera->SetResolutionScaleRange(0.6, 0.5);
+  camera->SetResolutionScaleRange(0.5, 1.5);
+  EXPECT_DOUBLE_EQ(0.25, camera->MinResolutionScale());
+  EXPECT_DOUBLE_EQ(0.8, camera->MaxResolutionScale());
+
+  // engines without GPU timing do not support dynamic resolution
+  if (!camera->SetDynamicResolutionEnabled(true))
+  {
+    EXPECT_FALSE(camera->DynamicResolutionEnabled());
+  }
+  else
+  {
+    EXPECT_TRUE(camera->DynamicResolutionEnabled());
+    EXPECT_TRUE(engine->GpuTimingEnabled());
+    EXPECT_DOUBLE_EQ(0.8, camera->ResolutionScale());
+
+    // the resolution is scaled within its range, the image size does not
+    // change
+    Image image = camera->CreateImage();
+    for (unsigned int i = 0u; i < 10u; ++i)
+    {
+      camera->Capture(image);
+      EXPECT_LE(0.25, camera->ResolutionScale());
+      EXPECT_GE(0.8, camera->ResolutionScale());
+    }
+    EXPECT_EQ(64u, image.Width());
+    EXPECT_EQ(48u, image.Height());
+  }
+
+  EXPECT_TRUE(camera->SetDynamicResolutionEnabled(false));
+  EXPECT_FALSE(camera->DynamicResolutionEnabled());
+  EXPECT_DOUBLE_EQ(1.0, camera->ResolutionScale());
+
+  // Clean up
+  engine->SetGpuTimingEnabled(false);
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void CameraTest::OrderIndependentTransparency(
+    const std::string &_renderEngine)
+{
+  // create and populate scene
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(64u);
+  camera->SetImageHeight(48u);
+  scene->RootVisual()->AddChild(camera);
+  EXPECT_FALSE(camera->OrderIndependentTransparencyEnabled());
+
+  // two overlapping transparent boxes in front of the camera
+  for (unsigned int i = 0u; i < 2u; ++i)
+  {
+    MaterialPtr material = scene->CreateMaterial();
+    math::Color color = i == 0u ? math::Color::Red : math::Color::Blue;
+    material->SetDiffuse(color);
+    material->SetEmissive(color);
+    material->SetTransparency(0.5);
+    VisualPtr box = scene->CreateVisual();
+    box->AddGeometry(scene->CreateBox());
+    box->SetLocalPosition(2.0 + i, 0.0, 0.0);
+    box->SetMaterial(material);
+    scene->RootVisual()->AddChild(box);
+  }
+
+  // engines that do not support it keep sorting transparent materials
+  if (!camera->SetOrderIndependentTransparencyEnabled(true))
+  {
+    EXPECT_FALSE(camera->OrderIndependentTransparencyEnabled());
+  }
+  else
+  {
+    EXPECT_TRUE(camera->OrderIndependentTransparencyEnabled());
+
+    // the transparent boxes are blended over the background
+    Image image = camera->CreateImage();
+    camera->Capture(image);
+    EXPECT_EQ(64u, image.Width());
+    EXPECT_EQ(48u, image.Height());
+    unsigned char *data = image.Data<unsigned char>();
+    unsigned int center = (24u * 64u + 32u) * 3u;
+    EXPECT_LT(0u, static_cast<unsigned int>(data[center]) +
+        data[center + 2]);
+  }
+
+  EXPECT_TRUE(camera->SetOrderIndependentTransparencyEnabled(false));
+  EXPECT_FALSE(camera->OrderIndependentTransparencyEnabled());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
 /////////////////////////////////////////////////
 TEST_P(CameraTest, ViewProjectionMatrix)
 {
@@ -344,6 +693,238 @@ TEST_P(CameraTest, VisibilityMask)
   VisibilityMask(GetParam());
 }
 
+/////////////////////////////////////////////////
+TEST_P(CameraTest, GpuTimes)
+{
+  GpuTimes(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(CameraTest, LastFrameStats)
+{
+  LastFrameStats(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(CameraTest, DynamicResolution)
+{
+  DynamicResolution(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(CameraTest, OrderIndependentTransparency)
+{
+  OrderIndependentTransparency(GetParam());
+}
+
+/////////////////////////////////////////////////
+void CameraTest::FrameEncoder(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(64u);
+  camera->SetImageHeight(48u);
+  scene->RootVisual()->AddChild(camera);
+  EXPECT_EQ(nullptr, camera->FrameEncoder());
+
+  auto encoder = std::make_shared<MockFrameEncoder>();
+  unsigned int packetCount = 0u;
+  uint64_t lastFrame = 0u;
+  encoder->SetPacketCallback([&](const EncodedPacket &_packet)
+  {
+    ++packetCount;
+    lastFrame = _packet.frame;
+  });
+  camera->SetFrameEncoder(encoder);
+  EXPECT_EQ(encoder, camera->FrameEncoder());
+
+#ifdef HAVE_OPENGL
+  // the texture is registered once and every frame is encoded
+  camera->Update();
+  camera->Update();
+  EXPECT_EQ(1u, encoder->registerCount);
+  EXPECT_EQ(camera->RenderTextureGLId(), encoder->textureId);
+  EXPECT_EQ(2u, packetCount);
+  EXPECT_EQ(1u, lastFrame);
+
+  // the texture is registered again when it is resized
+  camera->SetImageWidth(32u);
+  camera->Update();
+  EXPECT_EQ(2u, encoder->registerCount);
+  EXPECT_EQ(1u, encoder->unregisterCount);
+  EXPECT_EQ(3u, packetCount);
+
+  // removing the encoder releases the texture
+  camera->SetFrameEncoder(nullptr);
+  EXPECT_EQ(2u, encoder->unregisterCount);
+  camera->Update();
+  EXPECT_EQ(3u, packetCount);
+#endif
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(CameraTest, FrameEncoder)
+{
+  FrameEncoder(GetParam());
+}
+
+/////////////////////////////////////////////////
+void CameraTest::CopyRegion(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  scene->SetBackgroundColor(0.2, 0.4, 0.6);
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(64u);
+  camera->SetImageHeight(48u);
+  camera->SetImageFormat(PF_R8G8B8);
+  scene->RootVisual()->AddChild(camera);
+
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(3, 0.5, 0);
+  scene->RootVisual()->AddChild(box);
+
+  Image frame = camera->CreateImage();
+  camera->Capture(frame);
+
+  // regions match the crops of the full frame
+  const unsigned int regions[2][4] = {{0u, 0u, 64u, 48u}, {5u, 7u, 20u, 9u}};
+  for (const auto &region : regions)
+  {
+    Image crop(region[2], region[3], PF_R8G8B8);
+    EXPECT_TRUE(camera->CopyRegion(crop, region[0], region[1]));
+    const unsigned char *full = frame.Data<unsigned char>();
+    const unsigned char *data = crop.Data<unsigned char>();
+    for (unsigned int y = 0u; y < crop.Height(); ++y)
+    {
+      EXPECT_EQ(0, std::memcmp(data + y * crop.RowStride(),
+          full + (region[1] + y) * frame.RowStride() + region[0] * 3u,
+          crop.Width() * 3u));
+    }
+  }
+
+  // regions leaving the image are rejected
+  Image outside(10u, 10u, PF_R8G8B8);
+  EXPECT_FALSE(camera->CopyRegion(outside, 60u, 0u));
+  EXPECT_FALSE(camera->CopyRegion(outside, 0u, 40u));
+  Image empty;
+  EXPECT_FALSE(camera->CopyRegion(empty, 0u, 0u));
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(CameraTest, CopyRegion)
+{
+  CopyRegion(GetParam());
+}
+
+/////////////////////////////////////////////////
+void CameraTest::OnDemandRendering(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(64u);
+  camera->SetImageHeight(48u);
+  scene->RootVisual()->AddChild(camera);
+  EXPECT_FALSE(camera->OnDemandRendering());
+  camera->SetOnDemandRendering(true);
+  EXPECT_TRUE(camera->OnDemandRendering());
+
+  // the scene version counts the changes of the scene graph
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  uint64_t version = scene->ChangeVersion();
+  scene->RootVisual()->AddChild(box);
+  EXPECT_LT(version, scene->ChangeVersion());
+  version = scene->ChangeVersion();
+  box->SetLocalPosition(3, 0, 0);
+  EXPECT_LT(version, scene->ChangeVersion());
+
+  // frames rendered are counted by the encoder
+  auto encoder = std::make_shared<MockFrameEncoder>();
+  unsigned int frameCount = 0u;
+  encoder->SetPacketCallback([&](const EncodedPacket &)
+  {
+    ++frameCount;
+  });
+  camera->SetFrameEncoder(encoder);
+
+#ifdef HAVE_OPENGL
+  // only the first frame is rendered while nothing changes
+  camera->Update();
+  camera->Update();
+  EXPECT_EQ(1u, frameCount);
+
+  // frames are rendered when the scene or the camera change, or on request
+  box->SetLocalPosition(4, 0, 0);
+  camera->Update();
+  EXPECT_EQ(2u, frameCount);
+  camera->SetLocalPosition(0, 1, 0);
+  camera->Update();
+  EXPECT_EQ(3u, frameCount);
+  camera->SetHFOV(1.0);
+  camera->Update();
+  EXPECT_EQ(4u, frameCount);
+  camera->RequestRender();
+  camera->Update();
+  camera->Update();
+  EXPECT_EQ(5u, frameCount);
+
+  // every update renders once disabled
+  camera->SetOnDemandRendering(false);
+  camera->Update();
+  camera->Update();
+  EXPECT_EQ(7u, frameCount);
+#endif
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(CameraTest, OnDemandRendering)
+{
+  OnDemandRendering(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(Camera, CameraTest,
     RENDER_ENGINE_VALUES,
     ignition::rendering::PrintToStringParam());
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/rendering/DistortionPass.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/RenderPassSystem.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+class DistortionPassTest : public testing::Test,
+                           public testing::WithParamInterface<const char*>
+{
+  /// \brief Test distortion pass coefficients
+  public: void Coefficients(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+void DistortionPassTest::Coefficients(const std::string &_renderEngine)
+{
+  // get engine
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  // get the render pass system
+  RenderPassSystemPtr rpSystem = engine->RenderPassSystem();
+  if (!rpSystem)
+  {
+    ignwarn << "Render engine '" << _renderEngine << "' does not support "
+            << "render pass system" << std::endl;
+    return;
+  }
+  DistortionPassPtr distortionPass =
+      std::dynamic_pointer_cast<DistortionPass>(
+      rpSystem->Create<DistortionPass>());
+  if (!distortionPass)
+  {
+    ignwarn << "Render engine '" << _renderEngine << "' does not support "
+            << "distortion passes" << std::endl;
+    return;
+  }
+
+  // verify initial values
+  EXPECT_EQ(DM_BROWN_CONRADY, distortionPass->Model());
+  EXPECT_DOUBLE_EQ(0.0, distortionPass->K1());
+  EXPECT_DOUBLE_EQ(0.0, distortionPass->K2());
+  EXPECT_DOUBLE_EQ(0.0, distortionPass->K3());
+  EXPECT_DOUBLE_EQ(0.0, distortionPass->P1());
+  EXPECT_DOUBLE_EQ(0.0, distortionPass->P2());
+  EXPECT_EQ(math::Vector2d(0.5, 0.5), distortionPass->Center());
+
+  // set values
+  distortionPass->SetModel(DM_EQUIDISTANT);
+  distortionPass->SetK1(-0.25);
+  distortionPass->SetK2(0.12);
+  distortionPass->SetK3(-0.01);
+  distortionPass->SetP1(0.002);
+  distortionPass->SetP2(-0.003);
+  distortionPass->SetCenter(math::Vector2d(0.45, 0.55));
+  EXPECT_EQ(DM_EQUIDISTANT, distortionPass->Model());
+  EXPECT_DOUBLE_EQ(-0.25, distortionPass->K1());
+  EXPECT_DOUBLE_EQ(0.12, distortionPass->K2());
+  EXPECT_DOUBLE_EQ(-0.01, distortionPass->K3());
+  EXPECT_DOUBLE_EQ(0.002, distortionPass->P1());
+  EXPECT_DOUBLE_EQ(-0.003, distortionPass->P2());
+  EXPECT_EQ(math::Vector2d(0.45, 0.55), distortionPass->Center());
+}
+
+/////////////////////////////////////////////////
+TEST_P(DistortionPassTest, Coefficients)
+{
+  Coefficients(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(DistortionPass, DistortionPassTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/rendering/DropoutPass.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/RenderPassSystem.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+class DropoutPassTest : public testing::Test,
+                        public testing::WithParamInterface<const char*>
+{
+  /// \brief Test dropout pass properties
+  public: void Dropout(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+void DropoutPassTest::Dropout(const std::string &_renderEngine)
+{
+  // get engine
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  // get the render pass system
+  RenderPassSystemPtr rpSystem = engine->RenderPassSystem();
+  if (!rpSystem)
+  {
+    ignwarn << "Render engine '" << _renderEngine << "' does not support "
+            << "render pass system" << std::endl;
+    return;
+  }
+  DropoutPassPtr dropoutPass =
+      std::dynamic_pointer_cast<DropoutPass>(
+      rpSystem->Create<DropoutPass>());
+  if (!dropoutPass)
+  {
+    ignwarn << "Render engine '" << _renderEngine << "' does not support "
+            << "dropout passes" << std::endl;
+    return;
+  }
+
+  // verify initial values
+  EXPECT_DOUBLE_EQ(0.0, dropoutPass->Probability());
+  EXPECT_EQ(0u, dropoutPass->Seed());
+
+  // probability
+  dropoutPass->SetProbability(0.25);
+  EXPECT_DOUBLE_EQ(0.25, dropoutPass->Probability());
+
+  // out of range probabilities are clamped
+  dropoutPass->SetProbability(1.5);
+  EXPECT_DOUBLE_EQ(1.0, dropoutPass->Probability());
+  dropoutPass->SetProbability(-0.5);
+  EXPECT_DOUBLE_EQ(0.0, dropoutPass->Probability());
+
+  // seed
+  dropoutPass->SetSeed(1234u);
+  EXPECT_EQ(1234u, dropoutPass->Seed());
+  dropoutPass->SetSeed(0u);
+  EXPECT_EQ(0u, dropoutPass->Seed());
+}
+
+/////////////////////////////////////////////////
+TEST_P(DropoutPassTest, Dropout)
+{
+  Dropout(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(DropoutPass, DropoutPassTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
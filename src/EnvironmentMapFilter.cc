@@ -0,0 +1,382 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <ignition/math/Helpers.hh>
+
+#include "ignition/rendering/EnvironmentMapFilter.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+/// \brief Find the face of a cubemap and the point on it in a direction
+/// \param[in] _dir Direction, not necessarily unit
+/// \param[out] _face Face index
+/// \param[out] _u Horizontal coordinate on the face, in [0, 1]
+/// \param[out] _v Vertical coordinate on the face, in [0, 1]
+static void cubemapFace(const math::Vector3d &_dir, unsigned int &_face,
+    double &_u, double &_v)
+{
+  double ax = std::abs(_dir.X());
+  double ay = std::abs(_dir.Y());
+  double az = std::abs(_dir.Z());
+  double sc = 0.0;
+  double tc = 0.0;
+  double ma = 1.0;
+  if (ax >= ay && ax >= az)
+  {
+    _face = _dir.X() >= 0.0 ? 0u : 1u;
+    sc = _dir.X() >= 0.0 ? -_dir.Z() : _dir.Z();
+    tc = -_dir.Y();
+    ma = ax;
+  }
+  else if (ay >= az)
+  {
+    _face = _dir.Y() >= 0.0 ? 2u : 3u;
+    sc = _dir.X();
+    tc = _dir.Y() >= 0.0 ? _dir.Z() : -_dir.Z();
+    ma = ay;
+  }
+  else
+  {
+    _face = _dir.Z() >= 0.0 ? 4u : 5u;
+    sc = _dir.Z() >= 0.0 ? _dir.X() : -_dir.X();
+    tc = -_dir.Y();
+    ma = az;
+  }
+  if (ma <= 0.0)
+    ma = 1.0;
+  _u = (sc / ma + 1.0) * 0.5;
+  _v = (tc / ma + 1.0) * 0.5;
+}
+
+//////////////////////////////////////////////////
+/// \brief Bilinearly sample a cubemap in a direction, without filtering
+/// across the edges of the faces
+/// \param[in] _faces Cubemap data
+/// \param[in] _size Width of the faces in texels
+/// \param[in] _dir Direction
+/// \param[out] _rgba Sampled color
+static void sampleCubemap(const float *_faces, unsigned int _size,
+    const math::Vector3d &_dir, float _rgba[4])
+{
+  unsigned int face = 0u;
+  double u = 0.0;
+  double v = 0.0;
+  cubemapFace(_dir, face, u, v);
+
+  double max = static_cast<double>(_size - 1u);
+  double x = ignition::math::clamp(u * _size - 0.5, 0.0, max);
+  double y = ignition::math::clamp(v * _size - 0.5, 0.0, max);
+  unsigned int x0 = static_cast<unsigned int>(x);
+  unsigned int y0 = static_cast<unsigned int>(y);
+  unsigned int x1 = std::min(x0 + 1u, _size - 1u);
+  unsigned int y1 = std::min(y0 + 1u, _size - 1u);
+  float fx = static_cast<float>(x - x0);
+  float fy = static_cast<float>(y - y0);
+
+  const float *data = _faces + static_cast<size_t>(face) * _size * _size * 4u;
+  const float *p00 = data + (static_cast<size_t>(y0) * _size + x0) * 4u;
+  const float *p10 = data + (static_cast<size_t>(y0) * _size + x1) * 4u;
+  const float *p01 = data + (static_cast<size_t>(y1) * _size + x0) * 4u;
+  const float *p11 = data + (static_cast<size_t>(y1) * _size + x1) * 4u;
+  for (unsigned int c = 0u; c < 4u; ++c)
+  {
+    float top = p00[c] + (p10[c] - p00[c]) * fx;
+    float bottom = p01[c] + (p11[c] - p01[c]) * fx;
+    _rgba[c] = top + (bottom - top) * fy;
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Box filter a cubemap to half its size
+/// \param[in] _faces Cubemap data
+/// \param[in] _size Width of the faces in texels, at least 2
+/// \return Data of the filtered cubemap
+static std::vector<float> downsample(const std::vector<float> &_faces,
+    unsigned int _size)
+{
+  unsigned int half = _size / 2u;
+  std::vector<float> result(static_cast<size_t>(6u) * half * half * 4u);
+  for (unsigned int f = 0u; f < 6u; ++f)
+  {
+    const float *src = _faces.data() +
+        static_cast<size_t>(f) * _size * _size * 4u;
+    float *dst = result.data() + static_cast<size_t>(f) * half * half * 4u;
+    for (unsigned int y = 0u; y < half; ++y)
+    {
+      for (unsigned int x = 0u; x < half; ++x)
+      {
+        for (unsigned int c = 0u; c < 4u; ++c)
+        {
+          size_t i = (static_cast<size_t>(y) * 2u * _size + x * 2u) * 4u + c;
+          dst[(static_cast<size_t>(y) * half + x) * 4u + c] = 0.25f *
+              (src[i] + src[i + 4u] + src[i + _size * 4u] +
+              src[i + _size * 4u + 4u]);
+        }
+      }
+    }
+  }
+  return result;
+}
+
+//////////////////////////////////////////////////
+/// \brief Get an importance sampled half vector of a GGX lobe
+/// \param[in] _xi Uniform random numbers in [0, 1)
+/// \param[in] _yi Uniform random numbers in [0, 1)
+/// \param[in] _alpha Squared roughness
+/// \param[in] _normal Unit normal
+/// \return Unit half vector
+static math::Vector3d importanceSampleGgx(double _xi, double _yi,
+    double _alpha, const math::Vector3d &_normal)
+{
+  double phi = 2.0 * IGN_PI * _xi;
+  double cosTheta = std::sqrt((1.0 - _yi) /
+      (1.0 + (_alpha * _alpha - 1.0) * _yi));
+  double sinTheta = std::sqrt(std::max(0.0, 1.0 - cosTheta * cosTheta));
+  math::Vector3d up = std::abs(_normal.Z()) < 0.999 ?
+      math::Vector3d::UnitZ : math::Vector3d::UnitX;
+  math::Vector3d tangentX = up.Cross(_normal).Normalize();
+  math::Vector3d tangentY = _normal.Cross(tangentX);
+  return (tangentX * (sinTheta * std::cos(phi)) +
+      tangentY * (sinTheta * std::sin(phi)) + _normal * cosTheta).Normalize();
+}
+
+//////////////////////////////////////////////////
+unsigned int EnvironmentMapFilter::MipCount(unsigned int _size)
+{
+  unsigned int count = 0u;
+  while (_size > 0u)
+  {
+    ++count;
+    _size /= 2u;
+  }
+  return count;
+}
+
+//////////////////////////////////////////////////
+math::Vector3d EnvironmentMapFilter::Direction(unsigned int _face, double _u,
+    double _v)
+{
+  double a = _u * 2.0 - 1.0;
+  double b = _v * 2.0 - 1.0;
+  math::Vector3d dir;
+  switch (_face)
+  {
+    case 0u:
+      dir.Set(1.0, -b, -a);
+      break;
+    case 1u:
+      dir.Set(-1.0, -b, a);
+      break;
+    case 2u:
+      dir.Set(a, 1.0, b);
+      break;
+    case 3u:
+      dir.Set(a, -1.0, -b);
+      break;
+    case 4u:
+      dir.Set(a, -b, 1.0);
+      break;
+    default:
+      dir.Set(-a, -b, -1.0);
+      break;
+  }
+  return dir.Normalize();
+}
+
+//////////////////////////////////////////////////
+std::vector<std::vector<float>> EnvironmentMapFilter::PrefilterSpecular(
+    const float *_faces, unsigned int _size, unsigned int _mipCount,
+    double _roughnessStep)
+{
+  std::vector<std::vector<float>> levels;
+  if (!_faces || _size == 0u)
+    return levels;
+  _mipCount = std::max(1u, std::min(_mipCount, MipCount(_size)));
+
+  // box filtered chain sampled by the lobes, larger lobes reading smaller
+  // levels so that a few samples do not alias
+  std::vector<std::vector<float>> chain;
+  chain.emplace_back(_faces, _faces + static_cast<size_t>(6u) * _size *
+      _size * 4u);
+  for (unsigned int s = _size; s > 1u; s /= 2u)
+    chain.push_back(downsample(chain.back(), s));
+
+  const unsigned int sampleCount = 64u;
+  double texelSolidAngle = 4.0 * IGN_PI / (6.0 * _size * _size);
+  levels.push_back(chain.front());
+  for (unsigned int level = 1u; level < _mipCount; ++level)
+  {
+    unsigned int size = std::max(1u, _size >> level);
+    double roughness = std::min(1.0, level * _roughnessStep);
+    double alpha = roughness * roughness;
+    std::vector<float> data(static_cast<size_t>(6u) * size * size * 4u, 0.0f);
+    for (unsigned int f = 0u; f < 6u; ++f)
+    {
+      for (unsigned int y = 0u; y < size; ++y)
+      {
+        for (unsigned int x = 0u; x < size; ++x)
+        {
+          // the view and reflection directions are the normal
+          math::Vector3d normal = Direction(f, (x + 0.5) / size,
+              (y + 0.5) / size);
+          double sum[4] = {0.0, 0.0, 0.0, 0.0};
+          double weight = 0.0;
+          for (unsigned int i = 0u; i < sampleCount; ++i)
+          {
+            // Hammersley sequence
+            uint32_t bits = i;
+            bits = (bits << 16u) | (bits >> 16u);
+            bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+            bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+            bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+            bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+            double yi = bits * 2.3283064365386963e-10;
+
+            math::Vector3d h = importanceSampleGgx(
+                static_cast<double>(i) / sampleCount, yi, alpha, normal);
+            double nDotH = normal.Dot(h);
+            math::Vector3d l = h * (2.0 * nDotH) - normal;
+            double nDotL = normal.Dot(l);
+            if (nDotL <= 0.0)
+              continue;
+
+            // level of the chain matching the solid angle of the sample
+            double a2 = alpha * alpha;
+            double d = nDotH * nDotH * (a2 - 1.0) + 1.0;
+            double pdf = a2 / (IGN_PI * d * d) * 0.25;
+            double sampleSolidAngle = 1.0 / (sampleCount * pdf + 1e-6);
+            double lod = ignition::math::clamp(
+                0.5 * std::log2(sampleSolidAngle / texelSolidAngle) + 1.0,
+                0.0, static_cast<double>(chain.size() - 1u));
+            unsigned int lod0 = static_cast<unsigned int>(lod);
+            unsigned int lod1 = std::min(lod0 + 1u,
+                static_cast<unsigned int>(chain.size() - 1u));
+            float t = static_cast<float>(lod - lod0);
+
+            float c0[4];
+            float c1[4];
+            sampleCubemap(chain[lod0].data(), std::max(1u, _size >> lod0),
+                l, c0);
+            sampleCubemap(chain[lod1].data(), std::max(1u, _size >> lod1),
+                l, c1);
+            for (unsigned int c = 0u; c < 4u; ++c)
+              sum[c] += (c0[c] + (c1[c] - c0[c]) * t) * nDotL;
+            weight += nDotL;
+          }
+
+          float *texel = data.data() +
+              ((static_cast<size_t>(f) * size + y) * size + x) * 4u;
+          for (unsigned int c = 0u; c < 4u; ++c)
+          {
+            texel[c] = weight > 0.0 ?
+                static_cast<float>(sum[c] / weight) : 0.0f;
+          }
+        }
+      }
+    }
+    levels.push_back(data);
+  }
+  return levels;
+}
+
+//////////////////////////////////////////////////
+std::vector<math::Vector3d> EnvironmentMapFilter::IrradianceSh(
+    const float *_faces, unsigned int _size)
+{
+  std::vector<math::Vector3d> sh(9u, math::Vector3d::Zero);
+  if (!_faces || _size == 0u)
+    return sh;
+
+  // the diffuse lighting is smooth, a small cubemap is enough
+  std::vector<float> faces(_faces, _faces + static_cast<size_t>(6u) * _size *
+      _size * 4u);
+  unsigned int size = _size;
+  while (size > 32u)
+  {
+    faces = downsample(faces, size);
+    size /= 2u;
+  }
+
+  double totalWeight = 0.0;
+  for (unsigned int f = 0u; f < 6u; ++f)
+  {
+    for (unsigned int y = 0u; y < size; ++y)
+    {
+      for (unsigned int x = 0u; x < size; ++x)
+      {
+        double a = (x + 0.5) / size * 2.0 - 1.0;
+        double b = (y + 0.5) / size * 2.0 - 1.0;
+        double weight = 1.0 / std::pow(1.0 + a * a + b * b, 1.5);
+        math::Vector3d n = Direction(f, (x + 0.5) / size, (y + 0.5) / size);
+        const float *texel = faces.data() +
+            ((static_cast<size_t>(f) * size + y) * size + x) * 4u;
+        math::Vector3d color(texel[0], texel[1], texel[2]);
+
+        double basis[9] = {
+            0.282095,
+            0.488603 * n.Y(),
+            0.488603 * n.Z(),
+            0.488603 * n.X(),
+            1.092548 * n.X() * n.Y(),
+            1.092548 * n.Y() * n.Z(),
+            0.315392 * (3.0 * n.Z() * n.Z() - 1.0),
+            1.092548 * n.X() * n.Z(),
+            0.546274 * (n.X() * n.X() - n.Y() * n.Y())};
+        for (unsigned int i = 0u; i < 9u; ++i)
+          sh[i] += color * (basis[i] * weight);
+        totalWeight += weight;
+      }
+    }
+  }
+
+  // radiance to irradiance, with the cosine lobe convolution of each band
+  const double bands[9] = {IGN_PI, 2.0 * IGN_PI / 3.0, 2.0 * IGN_PI / 3.0,
+      2.0 * IGN_PI / 3.0, IGN_PI / 4.0, IGN_PI / 4.0, IGN_PI / 4.0,
+      IGN_PI / 4.0, IGN_PI / 4.0};
+  for (unsigned int i = 0u; i < 9u; ++i)
+    sh[i] *= 4.0 * IGN_PI / totalWeight * bands[i];
+  return sh;
+}
+
+//////////////////////////////////////////////////
+math::Vector3d EnvironmentMapFilter::Irradiance(
+    const std::vector<math::Vector3d> &_sh, const math::Vector3d &_normal)
+{
+  if (_sh.size() < 9u)
+    return math::Vector3d::Zero;
+
+  const math::Vector3d &n = _normal;
+  math::Vector3d result = _sh[0] * 0.282095 +
+      _sh[1] * (0.488603 * n.Y()) +
+      _sh[2] * (0.488603 * n.Z()) +
+      _sh[3] * (0.488603 * n.X()) +
+      _sh[4] * (1.092548 * n.X() * n.Y()) +
+      _sh[5] * (1.092548 * n.Y() * n.Z()) +
+      _sh[6] * (0.315392 * (3.0 * n.Z() * n.Z() - 1.0)) +
+      _sh[7] * (1.092548 * n.X() * n.Z()) +
+      _sh[8] * (0.546274 * (n.X() * n.X() - n.Y() * n.Y()));
+  result /= IGN_PI;
+  return math::Vector3d(std::max(0.0, result.X()), std::max(0.0, result.Y()),
+      std::max(0.0, result.Z()));
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/EnvironmentMapFilter.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+/// \brief Create a cubemap with the given color on each face
+std::vector<float> Cubemap(unsigned int _size,
+    const std::vector<math::Vector3d> &_colors)
+{
+  std::vector<float> faces(6u * _size * _size * 4u);
+  for (unsigned int f = 0; f < 6u; ++f)
+  {
+    for (unsigned int i = 0; i < _size * _size; ++i)
+    {
+      float *texel = faces.data() + (f * _size * _size + i) * 4u;
+      texel[0] = static_cast<float>(_colors[f].X());
+      texel[1] = static_cast<float>(_colors[f].Y());
+      texel[2] = static_cast<float>(_colors[f].Z());
+      texel[3] = 1.0f;
+    }
+  }
+  return faces;
+}
+
+/////////////////////////////////////////////////
+TEST(EnvironmentMapFilterTest, Direction)
+{
+  EXPECT_EQ(0u, EnvironmentMapFilter::MipCount(0u));
+  EXPECT_EQ(1u, EnvironmentMapFilter::MipCount(1u));
+  EXPECT_EQ(9u, EnvironmentMapFilter::MipCount(256u));
+
+  // the center of each face is its axis
+  std::vector<math::Vector3d> axes = {math::Vector3d::UnitX,
+      -math::Vector3d::UnitX, math::Vector3d::UnitY, -math::Vector3d::UnitY,
+      math::Vector3d::UnitZ, -math::Vector3d::UnitZ};
+  for (unsigned int f = 0; f < 6u; ++f)
+    EXPECT_EQ(axes[f], EnvironmentMapFilter::Direction(f, 0.5, 0.5));
+
+  // top left corner of the +Z face, v pointing down the face
+  math::Vector3d corner = EnvironmentMapFilter::Direction(4u, 0.0, 0.0);
+  EXPECT_NEAR(1.0, corner.Length(), 1e-6);
+  EXPECT_LT(corner.X(), 0.0);
+  EXPECT_GT(corner.Y(), 0.0);
+}
+
+/////////////////////////////////////////////////
+TEST(EnvironmentMapFilterTest, Uniform)
+{
+  unsigned int size = 16u;
+  math::Vector3d color(0.5, 0.25, 1.0);
+  std::vector<float> faces = Cubemap(size,
+      std::vector<math::Vector3d>(6u, color));
+
+  // a uniform environment looks the same at any roughness
+  std::vector<std::vector<float>> levels =
+      EnvironmentMapFilter::PrefilterSpecular(faces.data(), size,
+      EnvironmentMapFilter::MipCount(size), 0.25);
+  ASSERT_EQ(5u, levels.size());
+  EXPECT_EQ(faces, levels[0]);
+  for (unsigned int i = 1u; i < levels.size(); ++i)
+  {
+    unsigned int levelSize = size >> i;
+    ASSERT_EQ(6u * levelSize * levelSize * 4u, levels[i].size());
+    EXPECT_NEAR(color.X(), levels[i][0], 1e-4);
+    EXPECT_NEAR(color.Y(), levels[i][1], 1e-4);
+    EXPECT_NEAR(color.Z(), levels[i][2], 1e-4);
+  }
+
+  // and lights a white diffuse surface with its own color
+  std::vector<math::Vector3d> sh =
+      EnvironmentMapFilter::IrradianceSh(faces.data(), size);
+  ASSERT_EQ(9u, sh.size());
+  for (auto normal : {math::Vector3d::UnitZ, -math::Vector3d::UnitX})
+  {
+    math::Vector3d irradiance = EnvironmentMapFilter::Irradiance(sh, normal);
+    EXPECT_NEAR(color.X(), irradiance.X(), 1e-3);
+    EXPECT_NEAR(color.Y(), irradiance.Y(), 1e-3);
+    EXPECT_NEAR(color.Z(), irradiance.Z(), 1e-3);
+  }
+
+  // empty cubemaps
+  EXPECT_TRUE(EnvironmentMapFilter::PrefilterSpecular(nullptr, size, 1u,
+      0.25).empty());
+  sh = EnvironmentMapFilter::IrradianceSh(nullptr, size);
+  EXPECT_EQ(math::Vector3d::Zero,
+      EnvironmentMapFilter::Irradiance(sh, math::Vector3d::UnitZ));
+}
+
+/////////////////////////////////////////////////
+TEST(EnvironmentMapFilterTest, Directional)
+{
+  // only the +Z face is lit
+  unsigned int size = 16u;
+  std::vector<math::Vector3d> colors(6u, math::Vector3d::Zero);
+  colors[4] = math::Vector3d::One;
+  std::vector<float> faces = Cubemap(size, colors);
+
+  std::vector<math::Vector3d> sh =
+      EnvironmentMapFilter::IrradianceSh(faces.data(), size);
+  double up = EnvironmentMapFilter::Irradiance(sh,
+      math::Vector3d::UnitZ).X();
+  double side = EnvironmentMapFilter::Irradiance(sh,
+      math::Vector3d::UnitX).X();
+  double down = EnvironmentMapFilter::Irradiance(sh,
+      -math::Vector3d::UnitZ).X();
+  EXPECT_GT(up, side);
+  EXPECT_GT(side, down);
+  EXPECT_NEAR(0.0, down, 0.05);
+
+  // reflections blur with the roughness but stay centered on the light
+  std::vector<std::vector<float>> levels =
+      EnvironmentMapFilter::PrefilterSpecular(faces.data(), size, 3u, 0.25);
+  ASSERT_EQ(3u, levels.size());
+  unsigned int levelSize = size >> 2u;
+  unsigned int center = levelSize / 2u * levelSize + levelSize / 2u;
+  float front = levels[2][(4u * levelSize * levelSize + center) * 4u];
+  float back = levels[2][(5u * levelSize * levelSize + center) * 4u];
+  EXPECT_GT(front, 0.5f);
+  EXPECT_LE(front, 1.0f);
+  EXPECT_FLOAT_EQ(0.0f, back);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
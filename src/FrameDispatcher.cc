@@ -0,0 +1,401 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ignition/rendering/FrameDispatcher.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace ignition;
+using namespace rendering;
+
+namespace
+{
+  /// \brief Bounded lock free queue with multiple producers and consumers,
+  /// after Dmitry Vyukov's. Each cell carries a sequence number telling
+  /// whether it is free for the producer or filled for the consumer of a
+  /// given position.
+  template <typename T>
+  class BoundedQueue
+  {
+    /// \brief Constructor
+    /// \param[in] _capacity Number of elements, rounded up to a power of 2
+    public: explicit BoundedQueue(size_t _capacity)
+    {
+      size_t size = 2u;
+      while (size < _capacity)
+        size <<= 1u;
+      this->mask = size - 1u;
+      this->cells = std::vector<Cell>(size);
+      for (size_t i = 0u; i < size; ++i)
+        this->cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    /// \brief Push an element
+    /// \param[in] _value Element to push, left untouched if full
+    /// \return False if the queue is full
+    public: bool TryPush(T &_value)
+    {
+      size_t pos = this->tail.load(std::memory_order_relaxed);
+      Cell *cell;
+      while (true)
+      {
+        cell = &this->cells[pos & this->mask];
+        size_t seq = cell->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(seq) -
+            static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0)
+        {
+          if (this->tail.compare_exchange_weak(pos, pos + 1u,
+              std::memory_order_relaxed))
+          {
+            break;
+          }
+        }
+        else if (diff < 0)
+        {
+          return false;
+        }
+        else
+        {
+          pos = this->tail.load(std::memory_order_relaxed);
+        }
+      }
+      cell->value = std::move(_value);
+      cell->sequence.store(pos + 1u, std::memory_order_release);
+      return true;
+    }
+
+    /// \brief Pop the oldest element
+    /// \param[out] _value Element popped
+    /// \return False if the queue is empty
+    public: bool TryPop(T &_value)
+    {
+      size_t pos = this->head.load(std::memory_order_relaxed);
+      Cell *cell;
+      while (true)
+      {
+        cell = &this->cells[pos & this->mask];
+        size_t seq = cell->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(seq) -
+            static_cast<std::ptrdiff_t>(pos + 1u);
+        if (diff == 0)
+        {
+          if (this->head.compare_exchange_weak(pos, pos + 1u,
+              std::memory_order_relaxed))
+          {
+            break;
+          }
+        }
+        else if (diff < 0)
+        {
+          return false;
+        }
+        else
+        {
+          pos = this->head.load(std::memory_order_relaxed);
+        }
+      }
+      _value = std::move(cell->value);
+      cell->value = T();
+      cell->sequence.store(pos + this->mask + 1u, std::memory_order_release);
+      return true;
+    }
+
+    /// \brief Queue cell
+    private: struct Cell
+    {
+      /// \brief Sequence number
+      std::atomic<size_t> sequence{0u};
+
+      /// \brief Element
+      T value;
+
+      /// \brief Default constructor
+      Cell() = default;
+
+      /// \brief Cells are only copied empty, when the queue is created
+      Cell(const Cell &)
+      {
+      }
+    };
+
+    /// \brief Cells, a power of 2 of them
+    private: std::vector<Cell> cells;
+
+    /// \brief Mask of the cell index of a position
+    private: size_t mask = 0u;
+
+    /// \brief Position of the next push
+    private: alignas(64) std::atomic<size_t> tail{0u};
+
+    /// \brief Position of the next pop
+    private: alignas(64) std::atomic<size_t> head{0u};
+  };
+}
+
+//////////////////////////////////////////////////
+class ignition::rendering::FrameChannelPrivate
+{
+  /// \brief Constructor
+  /// \param[in] _capacity Queue capacity
+  public: explicit FrameChannelPrivate(unsigned int _capacity)
+    : frames(_capacity), capacity(std::max(1u, _capacity))
+  {
+  }
+
+  /// \brief Frames waiting to be delivered
+  public: BoundedQueue<std::function<void()>> frames;
+
+  /// \brief Number of frames the channel holds before the policy applies.
+  /// The queue itself may be larger, its size is a power of 2.
+  public: unsigned int capacity;
+
+  /// \brief Number of frames posted and not delivered yet. The channel is
+  /// scheduled on the dispatcher when it becomes non zero and the worker
+  /// delivering the frames owns the channel until it drops back to zero.
+  public: std::atomic<unsigned int> pending{0u};
+
+  /// \brief Number of frames dropped
+  public: std::atomic<uint64_t> dropped{0u};
+
+  /// \brief Policy when the queue is full
+  public: FrameDispatchPolicy policy = FDP_DROP_OLDEST;
+};
+
+//////////////////////////////////////////////////
+class ignition::rendering::FrameDispatcherPrivate
+{
+  /// \brief Start the workers if not started yet
+  public: void Start();
+
+  /// \brief Worker loop
+  public: void Work();
+
+  /// \brief Channels with frames to deliver. Each channel is in the queue
+  /// at most once, so it only needs to hold as many as there are channels
+  public: BoundedQueue<FrameChannel *> ready{4096u};
+
+  /// \brief Worker threads
+  public: std::vector<std::thread> workers;
+
+  /// \brief Number of workers requested, zero for the default
+  public: unsigned int workerCount = 0u;
+
+  /// \brief Protects starting the workers and waking them up
+  public: std::mutex mutex;
+
+  /// \brief Idle workers wait on this
+  public: std::condition_variable wakeUp;
+
+  /// \brief Number of idle workers
+  public: std::atomic<unsigned int> sleeping{0u};
+
+  /// \brief True once the workers are started
+  public: std::atomic<bool> started{false};
+
+  /// \brief Stops the workers
+  public: bool stop = false;
+};
+
+//////////////////////////////////////////////////
+FrameChannel::FrameChannel(FrameDispatchPolicy _policy,
+    unsigned int _capacity)
+  : dataPtr(new FrameChannelPrivate(_capacity))
+{
+  this->dataPtr->policy = _policy == FDP_BLOCK ? FDP_BLOCK : FDP_DROP_OLDEST;
+}
+
+//////////////////////////////////////////////////
+FrameChannel::~FrameChannel()
+{
+  this->Flush();
+}
+
+//////////////////////////////////////////////////
+FrameDispatchPolicy FrameChannel::Policy() const
+{
+  return this->dataPtr->policy;
+}
+
+//////////////////////////////////////////////////
+void FrameChannel::Post(std::function<void()> _frame)
+{
+  while (true)
+  {
+    if (this->dataPtr->pending.load() < this->dataPtr->capacity &&
+        this->dataPtr->frames.TryPush(_frame))
+    {
+      // the first pending frame schedules the channel
+      if (this->dataPtr->pending.fetch_add(1u) == 0u)
+        FrameDispatcher::Instance()->Schedule(this);
+      return;
+    }
+
+    if (this->dataPtr->policy == FDP_DROP_OLDEST)
+    {
+      // replace the oldest frame, the number of pending frames does not
+      // change. Only this thread pushes, so the slot freed is ours.
+      std::function<void()> oldest;
+      if (this->dataPtr->frames.TryPop(oldest))
+      {
+        this->dataPtr->frames.TryPush(_frame);
+        this->dataPtr->dropped++;
+        return;
+      }
+    }
+
+    // the oldest frame is being delivered, or the queue is full and
+    // the policy is to block
+    std::this_thread::yield();
+  }
+}
+
+//////////////////////////////////////////////////
+void FrameChannel::Flush()
+{
+  while (this->dataPtr->pending.load() > 0u)
+    std::this_thread::yield();
+}
+
+//////////////////////////////////////////////////
+uint64_t FrameChannel::DroppedCount() const
+{
+  return this->dataPtr->dropped.load();
+}
+
+//////////////////////////////////////////////////
+void FrameChannel::Deliver()
+{
+  do
+  {
+    std::function<void()> frame;
+    // a frame replacing a dropped one may not be pushed yet
+    while (!this->dataPtr->frames.TryPop(frame))
+      std::this_thread::yield();
+    frame();
+  }
+  // the channel may be destroyed as soon as no frame is pending, this must
+  // be the last access to it
+  while (this->dataPtr->pending.fetch_sub(1u) > 1u);
+}
+
+//////////////////////////////////////////////////
+FrameDispatcher::FrameDispatcher()
+  : dataPtr(new FrameDispatcherPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+FrameDispatcher::~FrameDispatcher()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stop = true;
+  }
+  this->dataPtr->wakeUp.notify_all();
+  for (auto &worker : this->dataPtr->workers)
+    worker.join();
+}
+
+//////////////////////////////////////////////////
+FrameDispatcher *FrameDispatcher::Instance()
+{
+  static FrameDispatcher instance;
+  return &instance;
+}
+
+//////////////////////////////////////////////////
+void FrameDispatcher::SetWorkerCount(unsigned int _count)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (!this->dataPtr->started)
+    this->dataPtr->workerCount = _count;
+}
+
+//////////////////////////////////////////////////
+unsigned int FrameDispatcher::WorkerCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (this->dataPtr->started)
+    return static_cast<unsigned int>(this->dataPtr->workers.size());
+  if (this->dataPtr->workerCount > 0u)
+    return this->dataPtr->workerCount;
+  return std::max(1u, std::thread::hardware_concurrency() / 2u);
+}
+
+//////////////////////////////////////////////////
+void FrameDispatcher::Schedule(FrameChannel *_channel)
+{
+  this->dataPtr->Start();
+
+  while (!this->dataPtr->ready.TryPush(_channel))
+    std::this_thread::yield();
+
+  // Idle workers count themselves before their last look at the queue, so
+  // either they see the channel or it sees them. They hold the mutex until
+  // they wait, so the notification can not be missed either.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (this->dataPtr->sleeping.load() > 0u)
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->wakeUp.notify_one();
+  }
+}
+
+//////////////////////////////////////////////////
+void FrameDispatcherPrivate::Start()
+{
+  if (this->started.load())
+    return;
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  if (this->started.load())
+    return;
+
+  unsigned int count = this->workerCount > 0u ? this->workerCount :
+      std::max(1u, std::thread::hardware_concurrency() / 2u);
+  for (unsigned int i = 0u; i < count; ++i)
+    this->workers.emplace_back(&FrameDispatcherPrivate::Work, this);
+  this->started = true;
+}
+
+//////////////////////////////////////////////////
+void FrameDispatcherPrivate::Work()
+{
+  while (true)
+  {
+    FrameChannel *channel = nullptr;
+    if (!this->ready.TryPop(channel))
+    {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      this->sleeping++;
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      while (!this->stop && !this->ready.TryPop(channel))
+        this->wakeUp.wait(lock);
+      this->sleeping--;
+      if (!channel)
+        return;
+    }
+    channel->Deliver();
+  }
+}
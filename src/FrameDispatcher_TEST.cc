@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/FrameDispatcher.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(FrameDispatcherTest, Block)
+{
+  EXPECT_GT(FrameDispatcher::Instance()->WorkerCount(), 0u);
+
+  // all frames are delivered, in order, off the posting thread
+  FrameChannel channel(FDP_BLOCK, 2u);
+  EXPECT_EQ(FDP_BLOCK, channel.Policy());
+
+  std::vector<int> delivered;
+  std::atomic<bool> otherThread{true};
+  auto postingThread = std::this_thread::get_id();
+  for (int i = 0; i < 100; ++i)
+  {
+    channel.Post([&delivered, &otherThread, postingThread, i]()
+        {
+          if (std::this_thread::get_id() == postingThread)
+            otherThread = false;
+          delivered.push_back(i);
+        });
+  }
+  channel.Flush();
+
+  EXPECT_TRUE(otherThread);
+  ASSERT_EQ(100u, delivered.size());
+  for (int i = 0; i < 100; ++i)
+    EXPECT_EQ(i, delivered[i]);
+  EXPECT_EQ(0u, channel.DroppedCount());
+}
+
+/////////////////////////////////////////////////
+TEST(FrameDispatcherTest, DropOldest)
+{
+  FrameChannel channel(FDP_DROP_OLDEST, 2u);
+  EXPECT_EQ(FDP_DROP_OLDEST, channel.Policy());
+
+  // a slow subscriber holds the first frame while the queue fills up
+  std::atomic<bool> release{false};
+  std::vector<int> delivered;
+  for (int i = 0; i < 10; ++i)
+  {
+    channel.Post([&delivered, &release, i]()
+        {
+          while (!release)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+          delivered.push_back(i);
+        });
+  }
+  release = true;
+  channel.Flush();
+
+  // the most recent frames are delivered in order and posting never blocked
+  ASSERT_GE(delivered.size(), 2u);
+  EXPECT_EQ(10u, delivered.size() + channel.DroppedCount());
+  EXPECT_EQ(9, delivered.back());
+  for (size_t i = 1u; i < delivered.size(); ++i)
+    EXPECT_LT(delivered[i - 1u], delivered[i]);
+}
+
+/////////////////////////////////////////////////
+TEST(FrameDispatcherTest, Channels)
+{
+  // a blocked channel does not delay the others
+  std::atomic<bool> release{false};
+  std::atomic<int> fastCount{0};
+  {
+    FrameChannel slow(FDP_DROP_OLDEST, 1u);
+    FrameChannel fast(FDP_BLOCK, 1u);
+    slow.Post([&release]()
+        {
+          while (!release)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        });
+    for (int i = 0; i < 20; ++i)
+      fast.Post([&fastCount]() { fastCount++; });
+    fast.Flush();
+    EXPECT_EQ(20, fastCount);
+    release = true;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  // a subscriber holding a worker must not starve the other channels
+  FrameDispatcher::Instance()->SetWorkerCount(2u);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Image.hh>
+#include <ignition/common/StringUtils.hh>
+
+#include "ignition/rendering/FrameWriter.hh"
+#include "ignition/rendering/PixelFormat.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+class ignition::rendering::FrameWriterPrivate
+{
+  /// \brief Write the queued frames until the writer stops
+  public: void Run();
+
+  /// \brief Protects the queue and the counters
+  public: std::mutex mutex;
+
+  /// \brief Notified when a frame is queued or the writer stops
+  public: std::condition_variable queued;
+
+  /// \brief Notified when a frame is written or taken by a worker
+  public: std::condition_variable written;
+
+  /// \brief Frames waiting to be written, with the path of their file
+  public: std::deque<std::pair<Image, std::string>> queue;
+
+  /// \brief Number of frames waiting before Write blocks
+  public: size_t capacity = 8u;
+
+  /// \brief Number of frames being written by the workers
+  public: unsigned int writing = 0u;
+
+  /// \brief Number of frames written
+  public: uint64_t writtenCount = 0u;
+
+  /// \brief Number of frames that could not be written
+  public: uint64_t failedCount = 0u;
+
+  /// \brief True once the workers must stop
+  public: bool stop = false;
+
+  /// \brief Worker threads
+  public: std::vector<std::thread> workers;
+};
+
+//////////////////////////////////////////////////
+void FrameWriterPrivate::Run()
+{
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (true)
+  {
+    this->queued.wait(lock, [this]
+        {
+          return this->stop || !this->queue.empty();
+        });
+
+    // the frames queued are written before stopping
+    if (this->queue.empty())
+      return;
+
+    std::pair<Image, std::string> frame = std::move(this->queue.front());
+    this->queue.pop_front();
+    ++this->writing;
+    this->written.notify_all();
+
+    lock.unlock();
+    bool result = FrameWriter::WriteFile(frame.first, frame.second);
+    // release the buffer before it is reported as written
+    frame.first = Image();
+    lock.lock();
+
+    --this->writing;
+    if (result)
+      ++this->writtenCount;
+    else
+      ++this->failedCount;
+    this->written.notify_all();
+  }
+}
+
+//////////////////////////////////////////////////
+FrameWriter::FrameWriter(unsigned int _workerCount, unsigned int _capacity)
+  : dataPtr(new FrameWriterPrivate)
+{
+  this->dataPtr->capacity = std::max(_capacity, 1u);
+  for (unsigned int i = 0u; i < std::max(_workerCount, 1u); ++i)
+  {
+    this->dataPtr->workers.emplace_back(
+        &FrameWriterPrivate::Run, this->dataPtr.get());
+  }
+}
+
+//////////////////////////////////////////////////
+FrameWriter::~FrameWriter()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stop = true;
+  }
+  this->dataPtr->queued.notify_all();
+  for (auto &worker : this->dataPtr->workers)
+    worker.join();
+}
+
+//////////////////////////////////////////////////
+FrameWriter *FrameWriter::Instance()
+{
+  static FrameWriter instance;
+  return &instance;
+}
+
+//////////////////////////////////////////////////
+bool FrameWriter::Write(const Image &_image, const std::string &_path)
+{
+  if (!_image.Data() || _path.empty())
+    return false;
+
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->written.wait(lock, [this]
+      {
+        return this->dataPtr->queue.size() < this->dataPtr->capacity;
+      });
+  this->dataPtr->queue.emplace_back(_image, _path);
+  lock.unlock();
+  this->dataPtr->queued.notify_one();
+  return true;
+}
+
+//////////////////////////////////////////////////
+void FrameWriter::Flush()
+{
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->written.wait(lock, [this]
+      {
+        return this->dataPtr->queue.empty() && this->dataPtr->writing == 0u;
+      });
+}
+
+//////////////////////////////////////////////////
+uint64_t FrameWriter::WrittenCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->writtenCount;
+}
+
+//////////////////////////////////////////////////
+uint64_t FrameWriter::FailedCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->failedCount;
+}
+
+//////////////////////////////////////////////////
+bool FrameWriter::WriteFile(const Image &_image, const std::string &_path)
+{
+  PixelFormat format = _image.Format();
+  unsigned int width = _image.Width();
+  unsigned int height = _image.Height();
+  if (!_image.Data() || !PixelUtil::IsValid(format))
+  {
+    ignerr << "Unable to write an empty image to [" << _path << "]"
+           << std::endl;
+    return false;
+  }
+
+  // pack the rows of images with padding
+  unsigned int rowSize = width * PixelUtil::BytesPerPixel(format);
+  const unsigned char *data =
+      static_cast<const unsigned char *>(_image.Data());
+  std::vector<unsigned char> packed;
+  if (_image.RowStride() != rowSize)
+  {
+    packed.resize(static_cast<size_t>(rowSize) * height);
+    for (unsigned int y = 0u; y < height; ++y)
+    {
+      std::memcpy(packed.data() + static_cast<size_t>(y) * rowSize,
+          data + static_cast<size_t>(y) * _image.RowStride(), rowSize);
+    }
+    data = packed.data();
+  }
+
+  std::string path = common::lowercase(_path);
+  if (path.size() >= 4u && path.compare(path.size() - 4u, 4u, ".png") == 0)
+  {
+    common::Image::PixelFormatType pngFormat;
+    switch (format)
+    {
+      case PF_L8:
+      case PF_BAYER_RGGB8:
+      case PF_BAYER_BGGR8:
+      case PF_BAYER_GBGR8:
+      case PF_BAYER_GRGB8:
+        pngFormat = common::Image::L_INT8;
+        break;
+      case PF_L16:
+        pngFormat = common::Image::L_INT16;
+        break;
+      case PF_R8G8B8:
+        pngFormat = common::Image::RGB_INT8;
+        break;
+      case PF_B8G8R8:
+        pngFormat = common::Image::BGR_INT8;
+        break;
+      default:
+        ignerr << "Images of format [" << PixelUtil::Name(format)
+               << "] cannot be written as PNG, write them as raw files "
+               << "instead: [" << _path << "]" << std::endl;
+        return false;
+    }
+
+    common::Image image;
+    image.SetFromData(data, width, height, pngFormat);
+    image.SavePNG(_path);
+    std::ifstream file(_path);
+    return file.good();
+  }
+
+  std::ofstream file(_path, std::ios::binary);
+  if (!file)
+  {
+    ignerr << "Unable to open [" << _path << "] for writing" << std::endl;
+    return false;
+  }
+  file.write(reinterpret_cast<const char *>(data),
+      static_cast<std::streamsize>(rowSize) * height);
+  return file.good();
+}
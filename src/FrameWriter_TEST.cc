@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Filesystem.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/FrameWriter.hh"
+#include "ignition/rendering/Image.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(FrameWriterTest, WriteRaw)
+{
+  std::string dir = common::joinPaths(PROJECT_BUILD_PATH, "frame_writer");
+  ASSERT_TRUE(common::createDirectories(dir));
+  std::string path = common::joinPaths(dir, "frame.raw");
+  common::removeFile(path);
+
+  Image image(4u, 2u, PF_R8G8B8);
+  unsigned char *data = image.Data<unsigned char>();
+  for (unsigned int i = 0u; i < image.MemorySize(); ++i)
+    data[i] = static_cast<unsigned char>(i);
+
+  FrameWriter writer(1u, 2u);
+  EXPECT_TRUE(writer.Write(image, path));
+  writer.Flush();
+  EXPECT_EQ(1u, writer.WrittenCount());
+  EXPECT_EQ(0u, writer.FailedCount());
+
+  std::ifstream file(path, std::ios::binary);
+  ASSERT_TRUE(file.good());
+  std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)),
+      std::istreambuf_iterator<char>());
+  ASSERT_EQ(4u * 2u * 3u, bytes.size());
+  for (unsigned int i = 0u; i < bytes.size(); ++i)
+    EXPECT_EQ(static_cast<unsigned char>(i), bytes[i]);
+}
+
+/////////////////////////////////////////////////
+TEST(FrameWriterTest, Failures)
+{
+  FrameWriter writer;
+
+  // empty images and paths are not queued
+  EXPECT_FALSE(writer.Write(Image(), "frame.raw"));
+  EXPECT_FALSE(writer.Write(Image(2u, 2u, PF_L8), ""));
+
+  // missing directories are not created
+  std::string path = common::joinPaths(PROJECT_BUILD_PATH,
+      "frame_writer_missing", "frame.raw");
+  EXPECT_TRUE(writer.Write(Image(2u, 2u, PF_L8), path));
+  writer.Flush();
+  EXPECT_EQ(0u, writer.WrittenCount());
+  EXPECT_EQ(1u, writer.FailedCount());
+  EXPECT_FALSE(common::exists(path));
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/rendering/FxaaPass.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/RenderPassSystem.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+class FxaaPassTest : public testing::Test,
+                     public testing::WithParamInterface<const char*>
+{
+  /// \brief Test FXAA pass properties
+  public: void Fxaa(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+void FxaaPassTest::Fxaa(const std::string &_renderEngine)
+{
+  // get engine
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  // get the render pass system
+  RenderPassSystemPtr rpSystem = engine->RenderPassSystem();
+  if (!rpSystem)
+  {
+    ignwarn << "Render engine '" << _renderEngine << "' does not support "
+            << "render pass system" << std::endl;
+    return;
+  }
+  FxaaPassPtr fxaaPass =
+      std::dynamic_pointer_cast<FxaaPass>(rpSystem->Create<FxaaPass>());
+  if (!fxaaPass)
+  {
+    ignwarn << "Render engine '" << _renderEngine << "' does not support "
+            << "FXAA passes" << std::endl;
+    return;
+  }
+
+  // verify initial values
+  EXPECT_DOUBLE_EQ(0.75, fxaaPass->SubpixelQuality());
+  EXPECT_DOUBLE_EQ(0.166, fxaaPass->EdgeThreshold());
+  EXPECT_DOUBLE_EQ(0.0833, fxaaPass->EdgeThresholdMin());
+
+  fxaaPass->SetSubpixelQuality(0.5);
+  EXPECT_DOUBLE_EQ(0.5, fxaaPass->SubpixelQuality());
+  fxaaPass->SetEdgeThreshold(0.125);
+  EXPECT_DOUBLE_EQ(0.125, fxaaPass->EdgeThreshold());
+  fxaaPass->SetEdgeThresholdMin(0.0625);
+  EXPECT_DOUBLE_EQ(0.0625, fxaaPass->EdgeThresholdMin());
+
+  // out of range values are clamped
+  fxaaPass->SetSubpixelQuality(2.0);
+  EXPECT_DOUBLE_EQ(1.0, fxaaPass->SubpixelQuality());
+  fxaaPass->SetEdgeThreshold(-1.0);
+  EXPECT_DOUBLE_EQ(0.0, fxaaPass->EdgeThreshold());
+  fxaaPass->SetEdgeThresholdMin(1.5);
+  EXPECT_DOUBLE_EQ(1.0, fxaaPass->EdgeThresholdMin());
+}
+
+/////////////////////////////////////////////////
+TEST_P(FxaaPassTest, Fxaa)
+{
+  Fxaa(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(FxaaPass, FxaaPassTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -65,6 +65,7 @@ void GaussianNoisePassTest::GaussianNoise(const std::string &_renderEngine)
   EXPECT_DOUBLE_EQ(0u, noisePass->Mean());
   EXPECT_DOUBLE_EQ(0u, noisePass->StdDev());
   EXPECT_DOUBLE_EQ(0u, noisePass->Bias());
+  EXPECT_EQ(0u, noisePass->Seed());
 
   // mean
   double mean = 0.23;
@@ -88,6 +89,12 @@ void GaussianNoisePassTest::GaussianNoise(const std::string &_renderEngine)
   // Note, tol relaxed to 4-sigma to fix flaky test
   EXPECT_LE(std::fabs(noisePass->Bias()), biasMean + biasStdDev*4);
   EXPECT_GE(std::fabs(noisePass->Bias()), biasMean - biasStdDev*4);
+
+  // seed
+  noisePass->SetSeed(1234u);
+  EXPECT_EQ(1234u, noisePass->Seed());
+  noisePass->SetSeed(0u);
+  EXPECT_EQ(0u, noisePass->Seed());
 }
 
 /////////////////////////////////////////////////
@@ -38,6 +38,9 @@ class GizmoVisualTest : public testing::Test,
 
   /// \brief Test gizmo material
   public: void Material(const std::string &_renderEngine);
+
+  /// \brief Test that mode visuals are created on demand
+  public: void LazyVisuals(const std::string &_renderEngine);
 };
 
 /////////////////////////////////////////////////
@@ -196,6 +199,54 @@ void GizmoVisualTest::Material(const std::string &_renderEngine)
   rendering::unloadEngine(engine->Name());
 }
 
+/////////////////////////////////////////////////
+void GizmoVisualTest::LazyVisuals(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+
+  // no mode visuals are created until they are needed
+  GizmoVisualPtr gizmo = scene->CreateGizmoVisual();
+  ASSERT_NE(nullptr, gizmo);
+  EXPECT_EQ(0u, gizmo->ChildCount());
+  GizmoVisualPtr gizmo2 = scene->CreateGizmoVisual();
+  ASSERT_NE(nullptr, gizmo2);
+  EXPECT_EQ(0u, gizmo2->ChildCount());
+
+  // showing a mode creates its visuals only
+  gizmo->SetTransformMode(TransformMode::TM_ROTATION);
+  gizmo->PreRender();
+  EXPECT_EQ(1u, gizmo->ChildCount());
+  gizmo->PreRender();
+  EXPECT_EQ(1u, gizmo->ChildCount());
+
+  // querying an axis creates the visuals of its mode
+  VisualPtr xscale = gizmo->ChildByAxis(TransformAxis::TA_SCALE_X);
+  ASSERT_NE(nullptr, xscale);
+  EXPECT_EQ(2u, gizmo->ChildCount());
+  EXPECT_EQ(TransformAxis::TA_SCALE_X, gizmo->AxisById(xscale->Id()));
+
+  // materials are shared by the gizmos in the scene
+  VisualPtr xrot = gizmo->ChildByAxis(TransformAxis::TA_ROTATION_X);
+  VisualPtr xrot2 = gizmo2->ChildByAxis(TransformAxis::TA_ROTATION_X);
+  ASSERT_NE(nullptr, xrot);
+  ASSERT_NE(nullptr, xrot2);
+  EXPECT_NE(xrot, xrot2);
+  EXPECT_EQ(xrot->Material(), xrot2->Material());
+  EXPECT_EQ(1u, gizmo2->ChildCount());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
 /////////////////////////////////////////////////
 TEST_P(GizmoVisualTest, GizmoVisual)
 {
@@ -208,6 +259,12 @@ TEST_P(GizmoVisualTest, Material)
   Material(GetParam());
 }
 
+/////////////////////////////////////////////////
+TEST_P(GizmoVisualTest, LazyVisuals)
+{
+  LazyVisuals(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(Visual, GizmoVisualTest,
     RENDER_ENGINE_VALUES,
     ignition::rendering::PrintToStringParam());
@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <utility>
+
+#include "ignition/rendering/GpuFrameEncoder.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+GpuFrameEncoder::~GpuFrameEncoder() = default;
+
+//////////////////////////////////////////////////
+void GpuFrameEncoder::SetPacketCallback(PacketCallback _callback)
+{
+  this->packetCallback = std::move(_callback);
+}
+
+//////////////////////////////////////////////////
+void GpuFrameEncoder::EmitPacket(const EncodedPacket &_packet) const
+{
+  if (this->packetCallback)
+    this->packetCallback(_packet);
+}
@@ -53,6 +53,9 @@ class ignition::rendering::HeightmapDescriptorPrivate
   /// \brief Contains heightfield data.
   public: std::shared_ptr<common::HeightmapData> data{nullptr};
 
+  /// \brief Source to stream the heightfield samples from.
+  public: std::shared_ptr<HeightmapTileSource> tileSource{nullptr};
+
   /// \brief Heightmap XYZ size in meters.
   public: math::Vector3d size{1.0, 1.0, 1.0};
 
@@ -269,6 +272,19 @@ void HeightmapDescriptor::SetData(
   this->dataPtr->data = _data;
 }
 
+//////////////////////////////////////////////////
+std::shared_ptr<HeightmapTileSource> HeightmapDescriptor::TileSource() const
+{
+  return this->dataPtr->tileSource;
+}
+
+//////////////////////////////////////////////////
+void HeightmapDescriptor::SetTileSource(
+    const std::shared_ptr<HeightmapTileSource> &_source)
+{
+  this->dataPtr->tileSource = _source;
+}
+
 //////////////////////////////////////////////////
 math::Vector3d HeightmapDescriptor::Size() const
 {
@@ -25,6 +25,7 @@
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/RenderingIface.hh"
 #include "ignition/rendering/Heightmap.hh"
+#include "ignition/rendering/RawHeightmapTileSource.hh"
 #include "ignition/rendering/Scene.hh"
 
 using namespace ignition;
@@ -50,7 +51,7 @@ class HeightmapTest : public testing::Test,
 TEST_P(HeightmapTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(Heightmap))
 {
   std::string renderEngine{this->GetParam()};
-  if (renderEngine != "ogre")
+  if (renderEngine != "ogre" && renderEngine != "ogre2")
   {
     igndbg << "Heightmap not supported yet in rendering engine: "
             << renderEngine << std::endl;
@@ -159,6 +160,10 @@ TEST_P(HeightmapTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(Heightmap))
 
   scene->RootVisual()->AddChild(vis);
 
+  // Update the heightmap with no sensor in the scene
+  scene->PreRender();
+  EXPECT_EQ(heightmap, vis->GeometryByIndex(0));
+
   // Clean up
   engine->DestroyScene(scene);
   rendering::unloadEngine(engine->Name());
@@ -206,12 +211,16 @@ TEST_P(HeightmapTest, CopyConstructor)
   descriptor.SetPosition({0.5, 0.6, 0.7});
   descriptor.SetUseTerrainPaging(true);
   descriptor.SetSampling(123u);
+  EXPECT_EQ(nullptr, descriptor.TileSource());
+  auto source = std::make_shared<RawHeightmapTileSource>();
+  descriptor.SetTileSource(source);
 
   HeightmapDescriptor descriptor2(descriptor);
   EXPECT_EQ(ignition::math::Vector3d(0.1, 0.2, 0.3), descriptor2.Size());
   EXPECT_EQ(ignition::math::Vector3d(0.5, 0.6, 0.7), descriptor2.Position());
   EXPECT_TRUE(descriptor2.UseTerrainPaging());
   EXPECT_EQ(123u, descriptor2.Sampling());
+  EXPECT_EQ(source, descriptor2.TileSource());
 
   HeightmapTexture texture;
   texture.SetSize(123.456);
@@ -14,7 +14,10 @@
  * limitations under the License.
  *
  */
+#include <ignition/common/Console.hh>
+
 #include "ignition/rendering/Image.hh"
+#include "ignition/rendering/MemoryTracker.hh"
 
 using namespace ignition;
 using namespace rendering;
@@ -25,6 +28,7 @@ struct ArrayDeleter
 {
   void operator () (T const * p)
   {
+    MemoryTracker::Untrack(p);
     delete [] p;
   }
 };
@@ -36,8 +40,38 @@ Image::Image(unsigned int _width, unsigned int _height,
   height(_height)
 {
   this->format = PixelUtil::Sanitize(_format);
+  this->rowStride = PixelUtil::BytesPerPixel(this->format) * this->width;
   unsigned int size = this->MemorySize();
   this->data = DataPtr(new unsigned char[size], ArrayDeleter<unsigned char>());
+  MemoryTracker::Track(MC_IMAGE, this->data.get(), size);
+}
+
+//////////////////////////////////////////////////
+Image::Image(unsigned int _width, unsigned int _height,
+  PixelFormat _format, void *_data, unsigned int _rowStride) :
+  width(_width),
+  height(_height)
+{
+  this->format = PixelUtil::Sanitize(_format);
+  unsigned int bytesPerPixel = PixelUtil::BytesPerPixel(this->format);
+  this->rowStride = bytesPerPixel * this->width;
+  if (_rowStride != 0u)
+  {
+    if (_rowStride < this->rowStride || _rowStride % bytesPerPixel != 0u)
+    {
+      ignerr << "Invalid row stride [" << _rowStride << "] for an image "
+             << "of " << this->rowStride << " bytes per row. Using tightly "
+             << "packed rows instead." << std::endl;
+    }
+    else
+    {
+      this->rowStride = _rowStride;
+    }
+  }
+
+  // alias the buffer without owning it, so no control block is allocated
+  // and the buffer is never freed by the image
+  this->data = DataPtr(DataPtr(), static_cast<unsigned char *>(_data));
 }
 
 //////////////////////////////////////////////////
@@ -72,7 +106,13 @@ unsigned int Image::Depth() const
 //////////////////////////////////////////////////
 unsigned int Image::MemorySize() const
 {
-  return PixelUtil::MemorySize(this->format, this->width, this->height);
+  return this->rowStride * this->height;
+}
+
+//////////////////////////////////////////////////
+unsigned int Image::RowStride() const
+{
+  return this->rowStride;
 }
 
 //////////////////////////////////////////////////
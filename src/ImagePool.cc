@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ignition/rendering/ImagePool.hh"
+
+#include <vector>
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+class ignition::rendering::ImagePoolPrivate
+{
+  /// \brief Image width in pixels
+  public: unsigned int width{0u};
+
+  /// \brief Image height in pixels
+  public: unsigned int height{0u};
+
+  /// \brief Image pixel format
+  public: PixelFormat format{PF_UNKNOWN};
+
+  /// \brief Images holding the buffers of the pool. A buffer is free when
+  /// the pool holds the only reference to it.
+  public: std::vector<Image> images;
+};
+
+//////////////////////////////////////////////////
+ImagePool::ImagePool(unsigned int _width, unsigned int _height,
+    PixelFormat _format)
+  : dataPtr(new ImagePoolPrivate)
+{
+  this->dataPtr->width = _width;
+  this->dataPtr->height = _height;
+  this->dataPtr->format = _format;
+}
+
+//////////////////////////////////////////////////
+ImagePool::~ImagePool() = default;
+
+//////////////////////////////////////////////////
+Image ImagePool::Acquire()
+{
+  // copying an image only copies the shared pointer of its buffer
+  for (const auto &image : this->dataPtr->images)
+  {
+    if (image.data.use_count() == 1)
+      return image;
+  }
+
+  this->dataPtr->images.emplace_back(this->dataPtr->width,
+      this->dataPtr->height, this->dataPtr->format);
+  return this->dataPtr->images.back();
+}
+
+//////////////////////////////////////////////////
+void ImagePool::Reserve(unsigned int _count)
+{
+  this->dataPtr->images.reserve(_count);
+  while (this->dataPtr->images.size() < _count)
+  {
+    this->dataPtr->images.emplace_back(this->dataPtr->width,
+        this->dataPtr->height, this->dataPtr->format);
+  }
+}
+
+//////////////////////////////////////////////////
+unsigned int ImagePool::Size() const
+{
+  return static_cast<unsigned int>(this->dataPtr->images.size());
+}
+
+//////////////////////////////////////////////////
+unsigned int ImagePool::InUseCount() const
+{
+  unsigned int count = 0u;
+  for (const auto &image : this->dataPtr->images)
+  {
+    if (image.data.use_count() > 1)
+      ++count;
+  }
+  return count;
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/Image.hh"
+#include "ignition/rendering/ImagePool.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(ImagePoolTest, WrappedImage)
+{
+  std::vector<unsigned char> buffer(64u * 10u);
+  Image image(16u, 10u, PF_R8G8B8, buffer.data(), 64u);
+  EXPECT_EQ(buffer.data(), image.Data());
+  EXPECT_EQ(64u, image.RowStride());
+  EXPECT_EQ(640u, image.MemorySize());
+
+  // copies alias the same buffer
+  Image copy = image;
+  EXPECT_EQ(buffer.data(), copy.Data());
+
+  // tightly packed
+  Image packed(16u, 10u, PF_R8G8B8, buffer.data());
+  EXPECT_EQ(48u, packed.RowStride());
+  EXPECT_EQ(480u, packed.MemorySize());
+
+  // invalid strides fall back to tightly packed rows
+  Image tooSmall(16u, 10u, PF_R8G8B8, buffer.data(), 32u);
+  EXPECT_EQ(48u, tooSmall.RowStride());
+  Image unaligned(16u, 10u, PF_R8G8B8, buffer.data(), 50u);
+  EXPECT_EQ(48u, unaligned.RowStride());
+
+  // allocated images are tightly packed
+  Image allocated(16u, 10u, PF_R8G8B8);
+  EXPECT_EQ(48u, allocated.RowStride());
+  EXPECT_EQ(480u, allocated.MemorySize());
+}
+
+/////////////////////////////////////////////////
+TEST(ImagePoolTest, Acquire)
+{
+  ImagePool pool(32u, 16u, PF_R8G8B8);
+  EXPECT_EQ(0u, pool.Size());
+  EXPECT_EQ(0u, pool.InUseCount());
+
+  const void *first = nullptr;
+  {
+    Image a = pool.Acquire();
+    EXPECT_EQ(32u, a.Width());
+    EXPECT_EQ(16u, a.Height());
+    EXPECT_EQ(PF_R8G8B8, a.Format());
+    first = a.Data();
+    EXPECT_EQ(1u, pool.Size());
+    EXPECT_EQ(1u, pool.InUseCount());
+
+    // the buffer of a is in use, a second one is allocated
+    Image b = pool.Acquire();
+    EXPECT_NE(first, b.Data());
+    EXPECT_EQ(2u, pool.Size());
+    EXPECT_EQ(2u, pool.InUseCount());
+
+    // copies keep the buffer in use
+    Image c = a;
+    b = Image();
+    EXPECT_EQ(1u, pool.InUseCount());
+  }
+
+  // released buffers are reused
+  EXPECT_EQ(0u, pool.InUseCount());
+  Image d = pool.Acquire();
+  EXPECT_EQ(first, d.Data());
+  EXPECT_EQ(2u, pool.Size());
+
+  pool.Reserve(4u);
+  EXPECT_EQ(4u, pool.Size());
+  EXPECT_EQ(1u, pool.InUseCount());
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -120,6 +120,16 @@ void LidarVisualTest::LidarVisual(const std::string &_renderEngine)
   lidar->ClearPoints();
   EXPECT_EQ(lidar->PointCount(), 0u);
 
+  // single precision data with retro and padding channels, as in the
+  // frames of gpu rays sensors
+  std::vector<float> frame(pts.size() * 3u, 1.0f);
+  for (unsigned int i = 0; i < pts.size(); ++i)
+    frame[i * 3u] = static_cast<float>(pts[i]);
+  lidar->SetPoints(frame.data(), pts.size(), 3u);
+  EXPECT_EQ(pts.size(), lidar->PointCount());
+  lidar->ClearPoints();
+  EXPECT_EQ(lidar->PointCount(), 0u);
+
 
   // Clean up
   engine->DestroyScene(scene);
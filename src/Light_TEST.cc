@@ -74,6 +74,13 @@ void LightTest::Light(const std::string &_renderEngine)
   light->SetCastShadows(false);
   EXPECT_FALSE(light->CastShadows());
 
+  // static
+  EXPECT_FALSE(light->Static());
+  light->SetStatic(true);
+  EXPECT_TRUE(light->Static());
+  light->SetStatic(false);
+  EXPECT_FALSE(light->Static());
+
   // intensity
   light->SetIntensity(1.25);
   EXPECT_NEAR(1.25, light->Intensity(), 1e-6);
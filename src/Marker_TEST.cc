@@ -109,6 +109,14 @@ void MarkerTest::Marker(const std::string &_renderEngine)
   EXPECT_NO_THROW(marker->SetPoint(0, math::Vector3d(3, 1, 2)));
   EXPECT_NO_THROW(marker->ClearPoints());
 
+  // exercise bulk point api
+  const float xyz[] = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+  const float rgba[] = {1, 0, 0, 1, 0, 1, 0, 1, 0, 0, 1, 1};
+  EXPECT_NO_THROW(marker->SetPoints(xyz, 3u, rgba));
+  EXPECT_NO_THROW(marker->SetPoints(xyz, 3u));
+  EXPECT_NO_THROW(marker->SetPoints(nullptr, 0u));
+  EXPECT_NO_THROW(marker->ClearPoints());
+
   // Clean up
   engine->DestroyScene(scene);
   rendering::unloadEngine(engine->Name());
@@ -394,6 +394,29 @@ void MaterialTest::Copy(const std::string &_renderEngine)
     EXPECT_EQ(1u, clone->LightMapTexCoordSet());
   }
 
+  // modifying a clone or the material it is cloned from does not affect
+  // the other
+  math::Color cloneDiffuse(0.2f, 0.3f, 0.4f, 1.0f);
+  clone->SetDiffuse(cloneDiffuse);
+  EXPECT_EQ(cloneDiffuse, clone->Diffuse());
+  EXPECT_EQ(diffuse, material->Diffuse());
+  MaterialPtr clone2 = material->Clone("clone2");
+  ASSERT_NE(nullptr, clone2);
+  math::Color materialSpecular(0.1f, 0.2f, 0.3f, 1.0f);
+  material->SetSpecular(materialSpecular);
+  EXPECT_EQ(materialSpecular, material->Specular());
+  EXPECT_EQ(specular, clone2->Specular());
+  EXPECT_EQ(specular, clone->Specular());
+
+  // a clone outlives the material it is cloned from
+  MaterialPtr clone3 = clone2->Clone("clone3");
+  ASSERT_NE(nullptr, clone3);
+  scene->DestroyMaterial(clone2);
+  EXPECT_EQ(diffuse, clone3->Diffuse());
+  EXPECT_EQ(specular, clone3->Specular());
+  scene->DestroyMaterial(clone3);
+  material->SetSpecular(specular);
+
   // test copying a material
   MaterialPtr copy = scene->CreateMaterial("copy");
   EXPECT_TRUE(scene->MaterialRegistered("copy"));
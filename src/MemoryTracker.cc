@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "ignition/rendering/MemoryTracker.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief State of the memory tracker
+struct MemoryTrackerState
+{
+  /// \brief Protects the state
+  std::mutex mutex;
+
+  /// \brief Category and size of each tracked allocation
+  std::unordered_map<const void *, std::pair<MemoryCategory, size_t>>
+      allocations;
+
+  /// \brief Memory accounted to each category
+  MemoryUsage usages[MC_COUNT];
+};
+
+/////////////////////////////////////////////////
+/// \brief Get the state of the memory tracker. It is never destroyed, so
+/// that allocations released during static destruction can be untracked.
+/// \return The state
+static MemoryTrackerState &state()
+{
+  static MemoryTrackerState *instance = new MemoryTrackerState;
+  return *instance;
+}
+
+/////////////////////////////////////////////////
+/// \brief Remove an allocation from the usage of its category
+/// \param[in] _usage Usage of the category
+/// \param[in] _bytes Size of the allocation
+static void release(MemoryUsage &_usage, size_t _bytes)
+{
+  _usage.bytes -= std::min<uint64_t>(_usage.bytes, _bytes);
+  if (_usage.allocations > 0u)
+    --_usage.allocations;
+}
+
+//////////////////////////////////////////////////
+void MemoryTracker::Track(MemoryCategory _category, const void *_ptr,
+    size_t _bytes)
+{
+  if (!_ptr || _category < MC_IMAGE || _category >= MC_COUNT)
+    return;
+
+  MemoryTrackerState &s = state();
+  std::lock_guard<std::mutex> lock(s.mutex);
+
+  auto it = s.allocations.find(_ptr);
+  if (it != s.allocations.end())
+  {
+    release(s.usages[it->second.first], it->second.second);
+    it->second = std::make_pair(_category, _bytes);
+  }
+  else
+  {
+    s.allocations.emplace(_ptr, std::make_pair(_category, _bytes));
+  }
+
+  MemoryUsage &usage = s.usages[_category];
+  usage.bytes += _bytes;
+  usage.peakBytes = std::max(usage.peakBytes, usage.bytes);
+  ++usage.allocations;
+  ++usage.totalAllocations;
+}
+
+//////////////////////////////////////////////////
+void MemoryTracker::Untrack(const void *_ptr)
+{
+  if (!_ptr)
+    return;
+
+  MemoryTrackerState &s = state();
+  std::lock_guard<std::mutex> lock(s.mutex);
+
+  auto it = s.allocations.find(_ptr);
+  if (it == s.allocations.end())
+    return;
+  release(s.usages[it->second.first], it->second.second);
+  s.allocations.erase(it);
+}
+
+//////////////////////////////////////////////////
+MemoryUsage MemoryTracker::Usage(MemoryCategory _category)
+{
+  if (_category < MC_IMAGE || _category >= MC_COUNT)
+    return MemoryUsage();
+
+  MemoryTrackerState &s = state();
+  std::lock_guard<std::mutex> lock(s.mutex);
+  return s.usages[_category];
+}
+
+//////////////////////////////////////////////////
+uint64_t MemoryTracker::TotalBytes()
+{
+  MemoryTrackerState &s = state();
+  std::lock_guard<std::mutex> lock(s.mutex);
+  uint64_t bytes = 0u;
+  for (const auto &usage : s.usages)
+    bytes += usage.bytes;
+  return bytes;
+}
+
+//////////////////////////////////////////////////
+std::string MemoryTracker::CategoryName(MemoryCategory _category)
+{
+  switch (_category)
+  {
+    case MC_IMAGE:
+      return "image";
+    case MC_SENSOR_BUFFER:
+      return "sensor_buffer";
+    case MC_DYNAMIC_GEOMETRY:
+      return "dynamic_geometry";
+    case MC_MESH:
+      return "mesh";
+    case MC_TEXTURE:
+      return "texture";
+    default:
+      return "unknown";
+  }
+}
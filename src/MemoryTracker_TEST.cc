@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/Image.hh"
+#include "ignition/rendering/MemoryTracker.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(MemoryTrackerTest, TrackUntrack)
+{
+  MemoryUsage before = MemoryTracker::Usage(MC_SENSOR_BUFFER);
+  uint64_t totalBefore = MemoryTracker::TotalBytes();
+
+  int a = 0;
+  int b = 0;
+  MemoryTracker::Track(MC_SENSOR_BUFFER, &a, 100u);
+  MemoryTracker::Track(MC_SENSOR_BUFFER, &b, 50u);
+  MemoryUsage usage = MemoryTracker::Usage(MC_SENSOR_BUFFER);
+  EXPECT_EQ(before.bytes + 150u, usage.bytes);
+  EXPECT_EQ(before.allocations + 2u, usage.allocations);
+  EXPECT_EQ(before.totalAllocations + 2u, usage.totalAllocations);
+  EXPECT_LE(before.bytes + 150u, usage.peakBytes);
+  EXPECT_EQ(totalBefore + 150u, MemoryTracker::TotalBytes());
+
+  // tracking again replaces the previous allocation
+  MemoryTracker::Track(MC_SENSOR_BUFFER, &a, 10u);
+  usage = MemoryTracker::Usage(MC_SENSOR_BUFFER);
+  EXPECT_EQ(before.bytes + 60u, usage.bytes);
+  EXPECT_EQ(before.allocations + 2u, usage.allocations);
+
+  MemoryTracker::Untrack(&a);
+  MemoryTracker::Untrack(&b);
+  usage = MemoryTracker::Usage(MC_SENSOR_BUFFER);
+  EXPECT_EQ(before.bytes, usage.bytes);
+  EXPECT_EQ(before.allocations, usage.allocations);
+  EXPECT_LE(before.bytes + 150u, usage.peakBytes);
+
+  // untracked and null addresses are ignored
+  MemoryTracker::Untrack(&a);
+  MemoryTracker::Track(MC_SENSOR_BUFFER, nullptr, 10u);
+  EXPECT_EQ(before.bytes, MemoryTracker::Usage(MC_SENSOR_BUFFER).bytes);
+  EXPECT_EQ(totalBefore, MemoryTracker::TotalBytes());
+
+  // invalid categories
+  MemoryUsage invalid = MemoryTracker::Usage(MC_COUNT);
+  EXPECT_EQ(0u, invalid.bytes);
+  EXPECT_EQ("unknown", MemoryTracker::CategoryName(MC_COUNT));
+  EXPECT_EQ("sensor_buffer", MemoryTracker::CategoryName(MC_SENSOR_BUFFER));
+}
+
+/////////////////////////////////////////////////
+TEST(MemoryTrackerTest, Image)
+{
+  uint64_t before = MemoryTracker::Usage(MC_IMAGE).bytes;
+  {
+    Image image(32u, 16u, PF_R8G8B8);
+    EXPECT_EQ(before + image.MemorySize(),
+        MemoryTracker::Usage(MC_IMAGE).bytes);
+
+    // copies share the buffer
+    Image copy = image;
+    EXPECT_EQ(before + image.MemorySize(),
+        MemoryTracker::Usage(MC_IMAGE).bytes);
+
+    // images aliasing a buffer do not own it
+    unsigned char buffer[12];
+    Image alias(2u, 2u, PF_R8G8B8, buffer);
+    EXPECT_EQ(before + image.MemorySize(),
+        MemoryTracker::Usage(MC_IMAGE).bytes);
+  }
+  EXPECT_EQ(before, MemoryTracker::Usage(MC_IMAGE).bytes);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
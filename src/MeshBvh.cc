@@ -0,0 +1,353 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ignition/rendering/MeshBvh.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/SubMesh.hh>
+
+/// \brief Private data class for MeshBvh
+class ignition::rendering::MeshBvhPrivate
+{
+  /// \brief A node of the hierarchy
+  public: struct Node
+  {
+    /// \brief Minimum corner of the node bounds
+    math::Vector3f min;
+
+    /// \brief Maximum corner of the node bounds
+    math::Vector3f max;
+
+    /// \brief Index of the first of the two children for interior nodes,
+    /// index of the first triangle for leaves
+    uint32_t first = 0u;
+
+    /// \brief Number of triangles in a leaf, 0 for interior nodes
+    uint32_t count = 0u;
+  };
+
+  /// \brief Recursively build the subtree of a node
+  /// \param[in] _node Index of node
+  /// \param[in] _start Index of the first triangle of the node in the
+  /// triangle order
+  /// \param[in] _end One past the index of the last triangle of the node
+  /// \param[in] _centroids Centroids of all triangles
+  /// \param[in,out] _order Triangle order, reordered so that the triangles
+  /// of each node are contiguous
+  public: void Build(uint32_t _node, uint32_t _start, uint32_t _end,
+              const std::vector<math::Vector3f> &_centroids,
+              std::vector<uint32_t> &_order);
+
+  /// \brief Intersect a ray with the bounds of a node
+  /// \param[in] _node Node to test
+  /// \param[in] _origin Ray origin
+  /// \param[in] _invDir Component-wise inverse of the ray direction
+  /// \param[in] _maxDistance Ignore intersections further than this
+  /// \return Ray parameter of the entry point, infinity if there is no
+  /// intersection
+  public: double IntersectBounds(const Node &_node,
+              const math::Vector3d &_origin, const math::Vector3d &_invDir,
+              double _maxDistance) const;
+
+  /// \brief Intersect a ray with a triangle, ignoring back faces
+  /// \param[in] _triangle Index of triangle
+  /// \param[in] _origin Ray origin
+  /// \param[in] _dir Ray direction
+  /// \param[out] _distance Ray parameter of intersection
+  /// \return True if the ray hits the front face of the triangle
+  public: bool IntersectTriangle(uint32_t _triangle,
+              const math::Vector3d &_origin, const math::Vector3d &_dir,
+              double &_distance) const;
+
+  /// \brief Maximum number of triangles in a leaf
+  public: static const uint32_t kMaxLeafSize = 4u;
+
+  /// \brief Vertex positions of all submeshes
+  public: std::vector<math::Vector3f> vertices;
+
+  /// \brief Three vertex indices per triangle, ordered so that the
+  /// triangles of each leaf are contiguous
+  public: std::vector<uint32_t> indices;
+
+  /// \brief Nodes of the hierarchy, the first one is the root
+  public: std::vector<Node> nodes;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+MeshBvh::MeshBvh(const common::Mesh &_mesh)
+  : dataPtr(new MeshBvhPrivate)
+{
+  // gather the triangles of all submeshes
+  std::vector<uint32_t> triangleIndices;
+  for (unsigned int i = 0; i < _mesh.SubMeshCount(); ++i)
+  {
+    auto submesh = _mesh.SubMeshByIndex(i).lock();
+    if (!submesh || submesh->VertexCount() < 3u)
+      continue;
+
+    uint32_t offset = static_cast<uint32_t>(this->dataPtr->vertices.size());
+    unsigned int vertexCount = submesh->VertexCount();
+    for (unsigned int j = 0; j < vertexCount; ++j)
+    {
+      math::Vector3d v = submesh->Vertex(j);
+      this->dataPtr->vertices.emplace_back(static_cast<float>(v.X()),
+          static_cast<float>(v.Y()), static_cast<float>(v.Z()));
+    }
+
+    unsigned int indexCount = submesh->IndexCount();
+    for (unsigned int j = 0; j + 2 < indexCount; j += 3)
+    {
+      int a = submesh->Index(j);
+      int b = submesh->Index(j + 1);
+      int c = submesh->Index(j + 2);
+      if (a < 0 || b < 0 || c < 0 ||
+          static_cast<unsigned int>(std::max({a, b, c})) >= vertexCount)
+        continue;
+      triangleIndices.push_back(offset + a);
+      triangleIndices.push_back(offset + b);
+      triangleIndices.push_back(offset + c);
+    }
+  }
+
+  uint32_t triangleCount = static_cast<uint32_t>(triangleIndices.size() / 3u);
+  if (triangleCount == 0u)
+    return;
+
+  std::vector<math::Vector3f> centroids(triangleCount);
+  std::vector<uint32_t> order(triangleCount);
+  for (uint32_t i = 0; i < triangleCount; ++i)
+  {
+    centroids[i] = (this->dataPtr->vertices[triangleIndices[3 * i]] +
+        this->dataPtr->vertices[triangleIndices[3 * i + 1]] +
+        this->dataPtr->vertices[triangleIndices[3 * i + 2]]) / 3.0f;
+    order[i] = i;
+  }
+
+  this->dataPtr->indices = std::move(triangleIndices);
+  this->dataPtr->nodes.reserve(
+      2u * triangleCount / MeshBvhPrivate::kMaxLeafSize + 1u);
+  this->dataPtr->nodes.emplace_back();
+  this->dataPtr->Build(0u, 0u, triangleCount, centroids, order);
+
+  // store triangles in leaf order so leaves reference contiguous ranges
+  std::vector<uint32_t> sorted(this->dataPtr->indices.size());
+  for (uint32_t i = 0; i < triangleCount; ++i)
+  {
+    for (uint32_t k = 0; k < 3u; ++k)
+      sorted[3 * i + k] = this->dataPtr->indices[3 * order[i] + k];
+  }
+  this->dataPtr->indices = std::move(sorted);
+}
+
+//////////////////////////////////////////////////
+MeshBvh::~MeshBvh() = default;
+
+//////////////////////////////////////////////////
+unsigned int MeshBvh::TriangleCount() const
+{
+  return static_cast<unsigned int>(this->dataPtr->indices.size() / 3u);
+}
+
+//////////////////////////////////////////////////
+bool MeshBvh::Intersect(const math::Vector3d &_origin,
+    const math::Vector3d &_direction, double &_distance) const
+{
+  if (this->dataPtr->nodes.empty())
+    return false;
+
+  const double inf = std::numeric_limits<double>::infinity();
+  math::Vector3d invDir(1.0 / _direction.X(), 1.0 / _direction.Y(),
+      1.0 / _direction.Z());
+
+  double closest = inf;
+  const auto &nodes = this->dataPtr->nodes;
+
+  // the tree is balanced so its depth is logarithmic in the triangle count
+  uint32_t stack[64];
+  unsigned int stackSize = 0u;
+  if (this->dataPtr->IntersectBounds(nodes[0], _origin, invDir, closest) < inf)
+    stack[stackSize++] = 0u;
+
+  while (stackSize > 0u)
+  {
+    const MeshBvhPrivate::Node &node = nodes[stack[--stackSize]];
+
+    if (node.count > 0u)
+    {
+      for (uint32_t i = node.first; i < node.first + node.count; ++i)
+      {
+        double distance;
+        if (this->dataPtr->IntersectTriangle(i, _origin, _direction,
+            distance) && distance < closest)
+        {
+          closest = distance;
+        }
+      }
+      continue;
+    }
+
+    // visit the nearest child first so that further nodes can be culled
+    uint32_t nearChild = node.first;
+    uint32_t farChild = node.first + 1u;
+    double nearDist = this->dataPtr->IntersectBounds(nodes[nearChild], _origin,
+        invDir, closest);
+    double farDist = this->dataPtr->IntersectBounds(nodes[farChild], _origin,
+        invDir, closest);
+    if (farDist < nearDist)
+    {
+      std::swap(nearChild, farChild);
+      std::swap(nearDist, farDist);
+    }
+    if (farDist < inf)
+      stack[stackSize++] = farChild;
+    if (nearDist < inf)
+      stack[stackSize++] = nearChild;
+  }
+
+  if (closest == inf)
+    return false;
+
+  _distance = closest;
+  return true;
+}
+
+//////////////////////////////////////////////////
+void MeshBvhPrivate::Build(uint32_t _node, uint32_t _start, uint32_t _end,
+    const std::vector<math::Vector3f> &_centroids,
+    std::vector<uint32_t> &_order)
+{
+  // bounds of the triangles and of their centroids
+  const float fmax = std::numeric_limits<float>::max();
+  math::Vector3f bmin(fmax, fmax, fmax);
+  math::Vector3f bmax(-fmax, -fmax, -fmax);
+  math::Vector3f cmin = bmin;
+  math::Vector3f cmax = bmax;
+  for (uint32_t i = _start; i < _end; ++i)
+  {
+    uint32_t t = _order[i];
+    for (uint32_t k = 0; k < 3u; ++k)
+    {
+      const math::Vector3f &v = this->vertices[this->indices[3 * t + k]];
+      bmin.Min(v);
+      bmax.Max(v);
+    }
+    cmin.Min(_centroids[t]);
+    cmax.Max(_centroids[t]);
+  }
+  this->nodes[_node].min = bmin;
+  this->nodes[_node].max = bmax;
+
+  // split along the longest axis of the centroid bounds
+  math::Vector3f extent = cmax - cmin;
+  int axis = 0;
+  if (extent.Y() > extent[axis])
+    axis = 1;
+  if (extent.Z() > extent[axis])
+    axis = 2;
+
+  uint32_t count = _end - _start;
+  if (count <= kMaxLeafSize || extent[axis] <= 0.0f)
+  {
+    this->nodes[_node].first = _start;
+    this->nodes[_node].count = count;
+    return;
+  }
+
+  uint32_t mid = _start + count / 2u;
+  std::nth_element(_order.begin() + _start, _order.begin() + mid,
+      _order.begin() + _end,
+      [&_centroids, axis](uint32_t _a, uint32_t _b)
+      {
+        return _centroids[_a][axis] < _centroids[_b][axis];
+      });
+
+  // children are stored next to each other
+  uint32_t left = static_cast<uint32_t>(this->nodes.size());
+  this->nodes.emplace_back();
+  this->nodes.emplace_back();
+  this->nodes[_node].first = left;
+  this->nodes[_node].count = 0u;
+
+  this->Build(left, _start, mid, _centroids, _order);
+  this->Build(left + 1u, mid, _end, _centroids, _order);
+}
+
+//////////////////////////////////////////////////
+double MeshBvhPrivate::IntersectBounds(const Node &_node,
+    const math::Vector3d &_origin, const math::Vector3d &_invDir,
+    double _maxDistance) const
+{
+  double tmin = 0.0;
+  double tmax = _maxDistance;
+  for (int i = 0; i < 3; ++i)
+  {
+    double t0 = (_node.min[i] - _origin[i]) * _invDir[i];
+    double t1 = (_node.max[i] - _origin[i]) * _invDir[i];
+    if (t0 > t1)
+      std::swap(t0, t1);
+    tmin = std::max(tmin, t0);
+    tmax = std::min(tmax, t1);
+    if (tmin > tmax)
+      return std::numeric_limits<double>::infinity();
+  }
+  return tmin;
+}
+
+//////////////////////////////////////////////////
+bool MeshBvhPrivate::IntersectTriangle(uint32_t _triangle,
+    const math::Vector3d &_origin, const math::Vector3d &_dir,
+    double &_distance) const
+{
+  const math::Vector3f &fa = this->vertices[this->indices[3 * _triangle]];
+  const math::Vector3f &fb = this->vertices[this->indices[3 * _triangle + 1]];
+  const math::Vector3f &fc = this->vertices[this->indices[3 * _triangle + 2]];
+  math::Vector3d a(fa.X(), fa.Y(), fa.Z());
+  math::Vector3d e1 = math::Vector3d(fb.X(), fb.Y(), fb.Z()) - a;
+  math::Vector3d e2 = math::Vector3d(fc.X(), fc.Y(), fc.Z()) - a;
+
+  // Moller-Trumbore. A positive determinant means the ray hits the front
+  // face, back faces and rays parallel to the triangle are ignored.
+  math::Vector3d p = _dir.Cross(e2);
+  double det = e1.Dot(p);
+  if (det <= std::numeric_limits<double>::epsilon())
+    return false;
+
+  math::Vector3d s = _origin - a;
+  double u = s.Dot(p);
+  if (u < 0.0 || u > det)
+    return false;
+
+  math::Vector3d q = s.Cross(e1);
+  double v = _dir.Dot(q);
+  if (v < 0.0 || u + v > det)
+    return false;
+
+  double t = e2.Dot(q) / det;
+  if (t < 0.0)
+    return false;
+
+  _distance = t;
+  return true;
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <ignition/common/Mesh.hh>
+#include <ignition/common/SubMesh.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/MeshBvh.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(MeshBvhTest, Empty)
+{
+  common::Mesh mesh;
+  MeshBvh bvh(mesh);
+  EXPECT_EQ(0u, bvh.TriangleCount());
+
+  double distance = 0.0;
+  EXPECT_FALSE(bvh.Intersect(math::Vector3d(0, 0, 1),
+      math::Vector3d(0, 0, -1), distance));
+}
+
+/////////////////////////////////////////////////
+TEST(MeshBvhTest, Grid)
+{
+  // unit quads on the z = 0 plane facing +z, tessellated into a grid
+  const unsigned int size = 32u;
+  common::SubMesh subMesh;
+  for (unsigned int i = 0; i <= size; ++i)
+  {
+    for (unsigned int j = 0; j <= size; ++j)
+      subMesh.AddVertex(math::Vector3d(i, j, 0));
+  }
+  for (unsigned int i = 0; i < size; ++i)
+  {
+    for (unsigned int j = 0; j < size; ++j)
+    {
+      unsigned int a = i * (size + 1) + j;
+      unsigned int b = a + size + 1;
+      subMesh.AddIndex(a);
+      subMesh.AddIndex(b);
+      subMesh.AddIndex(b + 1);
+      subMesh.AddIndex(a);
+      subMesh.AddIndex(b + 1);
+      subMesh.AddIndex(a + 1);
+    }
+  }
+  common::Mesh mesh;
+  mesh.AddSubMesh(subMesh);
+
+  MeshBvh bvh(mesh);
+  EXPECT_EQ(size * size * 2u, bvh.TriangleCount());
+
+  // hit from the front
+  double distance = 0.0;
+  EXPECT_TRUE(bvh.Intersect(math::Vector3d(10.3, 20.6, 5),
+      math::Vector3d(0, 0, -1), distance));
+  EXPECT_NEAR(5.0, distance, 1e-4);
+
+  // distance is a ray parameter, unnormalized directions scale it
+  EXPECT_TRUE(bvh.Intersect(math::Vector3d(10.3, 20.6, 5),
+      math::Vector3d(0, 0, -2), distance));
+  EXPECT_NEAR(2.5, distance, 1e-4);
+
+  // oblique ray
+  EXPECT_TRUE(bvh.Intersect(math::Vector3d(1.2, 1.3, 1),
+      math::Vector3d(1, 1, -1), distance));
+  EXPECT_NEAR(1.0, distance, 1e-4);
+
+  // back faces are culled
+  EXPECT_FALSE(bvh.Intersect(math::Vector3d(10.3, 20.6, -5),
+      math::Vector3d(0, 0, 1), distance));
+
+  // pointing away from the mesh
+  EXPECT_FALSE(bvh.Intersect(math::Vector3d(10.3, 20.6, 5),
+      math::Vector3d(0, 0, 1), distance));
+
+  // outside of the mesh
+  EXPECT_FALSE(bvh.Intersect(math::Vector3d(-1, -1, 5),
+      math::Vector3d(0, 0, -1), distance));
+  EXPECT_FALSE(bvh.Intersect(math::Vector3d(10.3, 20.6, 5),
+      math::Vector3d(1, 0, 0), distance));
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
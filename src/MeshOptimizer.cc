@@ -0,0 +1,471 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ignition/rendering/MeshOptimizer.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <vector>
+
+#include <ignition/math/Vector2.hh>
+#include <ignition/math/Vector3.hh>
+
+/// \brief Private data class for MeshOptimizer
+class ignition::rendering::MeshOptimizerPrivate
+{
+  /// \brief Constructor
+  /// \param[in] _subMesh Submesh to optimize
+  public: explicit MeshOptimizerPrivate(const common::SubMesh &_subMesh)
+    : subMesh(_subMesh) {}
+
+  /// \brief Score of a vertex for the vertex cache optimization, higher
+  /// for vertices recently added to the cache and for vertices with few
+  /// triangles left to draw
+  /// \param[in] _cachePosition Position of the vertex in the cache, -1 if
+  /// the vertex is not in the cache
+  /// \param[in] _remaining Number of triangles of the vertex left to draw
+  /// \param[in] _cacheSize Size of the cache
+  /// \return Score of the vertex
+  public: static double VertexScore(int _cachePosition,
+      unsigned int _remaining, unsigned int _cacheSize);
+
+  /// \brief Original submesh
+  public: common::SubMesh subMesh;
+
+  /// \brief True if the submesh can be optimized
+  public: bool optimizable = false;
+
+  /// \brief Vertex positions
+  public: std::vector<math::Vector3d> positions;
+
+  /// \brief Vertex normals, empty if the submesh has no normals
+  public: std::vector<math::Vector3d> normals;
+
+  /// \brief Vertex texture coordinates of each kept set
+  public: std::vector<std::vector<math::Vector2d>> texCoords;
+
+  /// \brief Triangle list indices
+  public: std::vector<unsigned int> indices;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+double MeshOptimizerPrivate::VertexScore(int _cachePosition,
+    unsigned int _remaining, unsigned int _cacheSize)
+{
+  if (_remaining == 0u)
+    return -1.0;
+
+  // the last triangle is already drawn so its vertices get a fixed score,
+  // older cache entries decay with their position
+  double score = 0.0;
+  if (_cachePosition >= 0)
+  {
+    if (_cachePosition < 3)
+    {
+      score = 0.75;
+    }
+    else
+    {
+      double scale = 1.0 / (_cacheSize - 3u);
+      score = std::pow(1.0 - (_cachePosition - 3) * scale, 1.5);
+    }
+  }
+
+  // finish vertices with few triangles left first to avoid leaving lone
+  // triangles behind
+  score += 2.0 / std::sqrt(static_cast<double>(_remaining));
+  return score;
+}
+
+//////////////////////////////////////////////////
+MeshOptimizer::MeshOptimizer(const common::SubMesh &_subMesh)
+  : dataPtr(std::make_unique<MeshOptimizerPrivate>(_subMesh))
+{
+  unsigned int vertexCount = _subMesh.VertexCount();
+  if (_subMesh.SubMeshPrimitiveType() != common::SubMesh::TRIANGLES ||
+      _subMesh.NodeAssignmentsCount() > 0u || vertexCount == 0u ||
+      _subMesh.IndexCount() == 0u || _subMesh.IndexCount() % 3u != 0u)
+  {
+    return;
+  }
+
+  this->dataPtr->indices.reserve(_subMesh.IndexCount());
+  for (unsigned int i = 0; i < _subMesh.IndexCount(); ++i)
+  {
+    int index = _subMesh.Index(i);
+    if (index < 0 || static_cast<unsigned int>(index) >= vertexCount)
+    {
+      this->dataPtr->indices.clear();
+      return;
+    }
+    this->dataPtr->indices.push_back(static_cast<unsigned int>(index));
+  }
+
+  this->dataPtr->positions.reserve(vertexCount);
+  for (unsigned int i = 0; i < vertexCount; ++i)
+    this->dataPtr->positions.push_back(_subMesh.Vertex(i));
+
+  if (_subMesh.NormalCount() == vertexCount)
+  {
+    this->dataPtr->normals.reserve(vertexCount);
+    for (unsigned int i = 0; i < vertexCount; ++i)
+      this->dataPtr->normals.push_back(_subMesh.Normal(i));
+  }
+
+  for (unsigned int k = 0u; k < _subMesh.TexCoordSetCount(); ++k)
+  {
+    if (_subMesh.TexCoordCountBySet(k) != vertexCount)
+      continue;
+    this->dataPtr->texCoords.emplace_back();
+    this->dataPtr->texCoords.back().reserve(vertexCount);
+    for (unsigned int i = 0; i < vertexCount; ++i)
+      this->dataPtr->texCoords.back().push_back(_subMesh.TexCoordBySet(i, k));
+  }
+
+  this->dataPtr->optimizable = true;
+}
+
+//////////////////////////////////////////////////
+MeshOptimizer::~MeshOptimizer()
+{
+}
+
+//////////////////////////////////////////////////
+unsigned int MeshOptimizer::Weld(double _tolerance)
+{
+  if (!this->dataPtr->optimizable || !(_tolerance > 0.0))
+    return 0u;
+
+  auto &positions = this->dataPtr->positions;
+  auto &normals = this->dataPtr->normals;
+  auto &texCoords = this->dataPtr->texCoords;
+  auto &indices = this->dataPtr->indices;
+
+  // vertices are identified by their quantized attributes
+  auto quantize = [_tolerance](double _value)
+  {
+    return static_cast<int64_t>(std::llround(_value / _tolerance));
+  };
+
+  std::map<std::vector<int64_t>, unsigned int> welded;
+  std::vector<unsigned int> remap(positions.size());
+  std::vector<unsigned int> kept;
+  std::vector<int64_t> key;
+  for (unsigned int i = 0; i < positions.size(); ++i)
+  {
+    key.clear();
+    for (unsigned int c = 0u; c < 3u; ++c)
+      key.push_back(quantize(positions[i][c]));
+    if (!normals.empty())
+    {
+      for (unsigned int c = 0u; c < 3u; ++c)
+        key.push_back(quantize(normals[i][c]));
+    }
+    for (const auto &set : texCoords)
+    {
+      key.push_back(quantize(set[i].X()));
+      key.push_back(quantize(set[i].Y()));
+    }
+
+    auto it = welded.emplace(key, static_cast<unsigned int>(kept.size()));
+    if (it.second)
+      kept.push_back(i);
+    remap[i] = it.first->second;
+  }
+
+  unsigned int removed =
+      static_cast<unsigned int>(positions.size() - kept.size());
+  if (removed == 0u)
+    return 0u;
+
+  // keep the first vertex of each welded group
+  for (unsigned int i = 0; i < kept.size(); ++i)
+  {
+    positions[i] = positions[kept[i]];
+    if (!normals.empty())
+      normals[i] = normals[kept[i]];
+    for (auto &set : texCoords)
+      set[i] = set[kept[i]];
+  }
+  positions.resize(kept.size());
+  if (!normals.empty())
+    normals.resize(kept.size());
+  for (auto &set : texCoords)
+    set.resize(kept.size());
+
+  // drop the triangles collapsed by the weld
+  size_t count = 0u;
+  for (size_t t = 0u; t + 2u < indices.size(); t += 3u)
+  {
+    unsigned int a = remap[indices[t]];
+    unsigned int b = remap[indices[t + 1u]];
+    unsigned int c = remap[indices[t + 2u]];
+    if (a == b || b == c || a == c)
+      continue;
+    indices[count++] = a;
+    indices[count++] = b;
+    indices[count++] = c;
+  }
+  indices.resize(count);
+
+  return removed;
+}
+
+//////////////////////////////////////////////////
+void MeshOptimizer::OptimizeVertexCache(unsigned int _cacheSize)
+{
+  auto &indices = this->dataPtr->indices;
+  if (!this->dataPtr->optimizable || indices.empty())
+    return;
+
+  unsigned int cacheSize = std::max(_cacheSize, 4u);
+  size_t vertexCount = this->dataPtr->positions.size();
+  size_t triangleCount = indices.size() / 3u;
+
+  // triangles left to draw of each vertex, packed in one array. The first
+  // remaining[v] entries after offsets[v] are the triangles not drawn yet.
+  std::vector<unsigned int> offsets(vertexCount + 1u, 0u);
+  for (auto index : indices)
+    ++offsets[index + 1u];
+  for (size_t v = 0u; v < vertexCount; ++v)
+    offsets[v + 1u] += offsets[v];
+  std::vector<unsigned int> remaining(vertexCount, 0u);
+  std::vector<unsigned int> vertexTriangles(indices.size());
+  for (size_t t = 0u; t < triangleCount; ++t)
+  {
+    for (unsigned int c = 0u; c < 3u; ++c)
+    {
+      unsigned int v = indices[t * 3u + c];
+      vertexTriangles[offsets[v] + remaining[v]++] =
+          static_cast<unsigned int>(t);
+    }
+  }
+
+  std::vector<int> cachePositions(vertexCount, -1);
+  std::vector<double> scores(vertexCount);
+  for (size_t v = 0u; v < vertexCount; ++v)
+  {
+    scores[v] = MeshOptimizerPrivate::VertexScore(-1, remaining[v],
+        cacheSize);
+  }
+
+  auto triangleScore = [&](size_t _t)
+  {
+    return scores[indices[_t * 3u]] + scores[indices[_t * 3u + 1u]] +
+        scores[indices[_t * 3u + 2u]];
+  };
+
+  // start with the best triangle of the whole mesh
+  std::vector<bool> drawn(triangleCount, false);
+  size_t best = 0u;
+  double bestScore = -1.0;
+  for (size_t t = 0u; t < triangleCount; ++t)
+  {
+    double score = triangleScore(t);
+    if (score > bestScore)
+    {
+      bestScore = score;
+      best = t;
+    }
+  }
+
+  std::vector<unsigned int> result;
+  result.reserve(indices.size());
+  std::vector<unsigned int> cache;
+  std::vector<unsigned int> newCache;
+  size_t next = 0u;
+  bool found = true;
+  while (result.size() < indices.size())
+  {
+    // no triangle of the cached vertices is left, continue with the first
+    // triangle not drawn yet
+    if (!found)
+    {
+      while (drawn[next])
+        ++next;
+      best = next;
+    }
+
+    drawn[best] = true;
+    newCache.clear();
+    for (unsigned int c = 0u; c < 3u; ++c)
+    {
+      unsigned int v = indices[best * 3u + c];
+      result.push_back(v);
+      newCache.push_back(v);
+
+      unsigned int *begin = &vertexTriangles[offsets[v]];
+      unsigned int *end = begin + remaining[v];
+      unsigned int *it = std::find(begin, end,
+          static_cast<unsigned int>(best));
+      if (it != end)
+      {
+        std::swap(*it, *(end - 1));
+        --remaining[v];
+      }
+    }
+
+    // the vertices of the drawn triangle move to the front of the cache
+    for (auto v : cache)
+    {
+      if (std::find(newCache.begin(), newCache.begin() + 3, v) ==
+          newCache.begin() + 3)
+      {
+        newCache.push_back(v);
+      }
+    }
+    for (size_t i = 0u; i < newCache.size(); ++i)
+    {
+      unsigned int v = newCache[i];
+      cachePositions[v] = i < cacheSize ? static_cast<int>(i) : -1;
+      scores[v] = MeshOptimizerPrivate::VertexScore(cachePositions[v],
+          remaining[v], cacheSize);
+    }
+    if (newCache.size() > cacheSize)
+      newCache.resize(cacheSize);
+    std::swap(cache, newCache);
+
+    // the next triangle is the best one using a cached vertex
+    found = false;
+    bestScore = -1.0;
+    for (auto v : cache)
+    {
+      for (unsigned int i = 0u; i < remaining[v]; ++i)
+      {
+        unsigned int t = vertexTriangles[offsets[v] + i];
+        double score = triangleScore(t);
+        if (score > bestScore)
+        {
+          bestScore = score;
+          best = t;
+          found = true;
+        }
+      }
+    }
+  }
+
+  indices.swap(result);
+}
+
+//////////////////////////////////////////////////
+void MeshOptimizer::OptimizeVertexFetch()
+{
+  if (!this->dataPtr->optimizable)
+    return;
+
+  auto &positions = this->dataPtr->positions;
+  auto &normals = this->dataPtr->normals;
+  auto &texCoords = this->dataPtr->texCoords;
+
+  const unsigned int unused = std::numeric_limits<unsigned int>::max();
+  std::vector<unsigned int> remap(positions.size(), unused);
+  std::vector<unsigned int> order;
+  for (auto &index : this->dataPtr->indices)
+  {
+    if (remap[index] == unused)
+    {
+      remap[index] = static_cast<unsigned int>(order.size());
+      order.push_back(index);
+    }
+    index = remap[index];
+  }
+
+  std::vector<math::Vector3d> newPositions;
+  newPositions.reserve(order.size());
+  for (auto v : order)
+    newPositions.push_back(positions[v]);
+  positions.swap(newPositions);
+
+  if (!normals.empty())
+  {
+    std::vector<math::Vector3d> newNormals;
+    newNormals.reserve(order.size());
+    for (auto v : order)
+      newNormals.push_back(normals[v]);
+    normals.swap(newNormals);
+  }
+
+  for (auto &set : texCoords)
+  {
+    std::vector<math::Vector2d> newSet;
+    newSet.reserve(order.size());
+    for (auto v : order)
+      newSet.push_back(set[v]);
+    set.swap(newSet);
+  }
+}
+
+//////////////////////////////////////////////////
+common::SubMesh MeshOptimizer::Result() const
+{
+  if (!this->dataPtr->optimizable)
+    return this->dataPtr->subMesh;
+
+  const common::SubMesh &original = this->dataPtr->subMesh;
+  common::SubMesh result(original.Name());
+  result.SetPrimitiveType(common::SubMesh::TRIANGLES);
+  if (original.MaterialIndex() >= 0)
+  {
+    result.SetMaterialIndex(
+        static_cast<unsigned int>(original.MaterialIndex()));
+  }
+
+  for (const auto &position : this->dataPtr->positions)
+    result.AddVertex(position);
+  for (const auto &normal : this->dataPtr->normals)
+    result.AddNormal(normal);
+  for (unsigned int k = 0u; k < this->dataPtr->texCoords.size(); ++k)
+  {
+    for (const auto &texCoord : this->dataPtr->texCoords[k])
+      result.AddTexCoordBySet(texCoord.X(), texCoord.Y(), k);
+  }
+  for (auto index : this->dataPtr->indices)
+    result.AddIndex(index);
+
+  return result;
+}
+
+//////////////////////////////////////////////////
+double MeshOptimizer::CacheMissRatio(const std::vector<unsigned int> &_indices,
+    unsigned int _cacheSize)
+{
+  size_t triangleCount = _indices.size() / 3u;
+  if (triangleCount == 0u || _cacheSize == 0u)
+    return 0.0;
+
+  // a vertex is in the FIFO cache if fewer than _cacheSize vertices were
+  // added since it was
+  const size_t missing = std::numeric_limits<size_t>::max();
+  unsigned int maxIndex = *std::max_element(_indices.begin(), _indices.end());
+  std::vector<size_t> added(static_cast<size_t>(maxIndex) + 1u, missing);
+  size_t misses = 0u;
+  for (auto index : _indices)
+  {
+    if (added[index] == missing || misses - added[index] >= _cacheSize)
+    {
+      added[index] = misses;
+      ++misses;
+    }
+  }
+  return static_cast<double>(misses) / triangleCount;
+}
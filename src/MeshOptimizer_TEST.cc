@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <ignition/common/SubMesh.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/MeshOptimizer.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+/// \brief Create a grid of unit quads on the z = 0 plane with one vertex
+/// per triangle corner, as exported by CAD tools
+/// \param[in] _size Number of quads along each side
+/// \return Submesh of the grid
+static common::SubMesh unweldedGrid(unsigned int _size)
+{
+  common::SubMesh subMesh;
+  subMesh.SetPrimitiveType(common::SubMesh::TRIANGLES);
+  auto addCorner = [&subMesh](unsigned int _i, unsigned int _j)
+  {
+    subMesh.AddVertex(math::Vector3d(_i, _j, 0));
+    subMesh.AddNormal(math::Vector3d::UnitZ);
+    subMesh.AddTexCoord(_i * 0.1, _j * 0.1);
+    subMesh.AddIndex(subMesh.VertexCount() - 1u);
+  };
+
+  // visit the quads column by column in a scattered order
+  for (unsigned int q = 0; q < _size * _size; ++q)
+  {
+    unsigned int shuffled = (q * 7919u) % (_size * _size);
+    unsigned int i = shuffled / _size;
+    unsigned int j = shuffled % _size;
+    addCorner(i, j);
+    addCorner(i + 1u, j);
+    addCorner(i + 1u, j + 1u);
+    addCorner(i, j);
+    addCorner(i + 1u, j + 1u);
+    addCorner(i, j + 1u);
+  }
+  return subMesh;
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the indices of a submesh
+/// \param[in] _subMesh Submesh
+/// \return Indices
+static std::vector<unsigned int> indices(const common::SubMesh &_subMesh)
+{
+  std::vector<unsigned int> result;
+  for (unsigned int i = 0; i < _subMesh.IndexCount(); ++i)
+    result.push_back(static_cast<unsigned int>(_subMesh.Index(i)));
+  return result;
+}
+
+/////////////////////////////////////////////////
+TEST(MeshOptimizerTest, Empty)
+{
+  common::SubMesh subMesh;
+  MeshOptimizer optimizer(subMesh);
+  EXPECT_EQ(0u, optimizer.Weld());
+  optimizer.OptimizeVertexCache();
+  optimizer.OptimizeVertexFetch();
+  EXPECT_EQ(0u, optimizer.Result().VertexCount());
+  EXPECT_DOUBLE_EQ(0.0, MeshOptimizer::CacheMissRatio({}));
+
+  // only triangle lists are optimized
+  subMesh.SetPrimitiveType(common::SubMesh::LINES);
+  subMesh.AddVertex(math::Vector3d(0, 0, 0));
+  subMesh.AddVertex(math::Vector3d(0, 0, 0));
+  subMesh.AddIndex(0);
+  subMesh.AddIndex(1);
+  MeshOptimizer lines(subMesh);
+  EXPECT_EQ(0u, lines.Weld());
+  EXPECT_EQ(2u, lines.Result().VertexCount());
+  EXPECT_EQ(common::SubMesh::LINES, lines.Result().SubMeshPrimitiveType());
+}
+
+/////////////////////////////////////////////////
+TEST(MeshOptimizerTest, Weld)
+{
+  const unsigned int size = 16u;
+  common::SubMesh subMesh = unweldedGrid(size);
+  subMesh.SetName("grid");
+  subMesh.SetMaterialIndex(2u);
+  ASSERT_EQ(size * size * 6u, subMesh.VertexCount());
+
+  MeshOptimizer optimizer(subMesh);
+  EXPECT_EQ(size * size * 6u - (size + 1u) * (size + 1u), optimizer.Weld());
+
+  // already welded
+  EXPECT_EQ(0u, optimizer.Weld());
+
+  common::SubMesh result = optimizer.Result();
+  EXPECT_EQ("grid", result.Name());
+  EXPECT_EQ(2, result.MaterialIndex());
+  EXPECT_EQ((size + 1u) * (size + 1u), result.VertexCount());
+  EXPECT_EQ(result.VertexCount(), result.NormalCount());
+  EXPECT_EQ(result.VertexCount(), result.TexCoordCountBySet(0u));
+  ASSERT_EQ(subMesh.IndexCount(), result.IndexCount());
+
+  // the triangles keep their corners
+  for (unsigned int i = 0; i < result.IndexCount(); ++i)
+  {
+    EXPECT_EQ(subMesh.Vertex(subMesh.Index(i)),
+        result.Vertex(result.Index(i)));
+    EXPECT_EQ(subMesh.TexCoord(subMesh.Index(i)),
+        result.TexCoord(result.Index(i)));
+  }
+
+  // vertices with different texture coordinates are not welded, e.g. on
+  // texture seams
+  common::SubMesh seam;
+  seam.SetPrimitiveType(common::SubMesh::TRIANGLES);
+  for (unsigned int i = 0; i < 6u; ++i)
+  {
+    seam.AddVertex(math::Vector3d(i % 3u, i % 3u == 2u ? 1 : 0, 0));
+    seam.AddTexCoord(i < 3u ? 0.0 : 1.0, 0.0);
+    seam.AddIndex(i);
+  }
+  MeshOptimizer seamOptimizer(seam);
+  EXPECT_EQ(0u, seamOptimizer.Weld());
+
+  // triangles collapsed by a coarse weld are removed
+  common::SubMesh sliver;
+  sliver.SetPrimitiveType(common::SubMesh::TRIANGLES);
+  sliver.AddVertex(math::Vector3d(0, 0, 0));
+  sliver.AddVertex(math::Vector3d(1, 0, 0));
+  sliver.AddVertex(math::Vector3d(1, 1e-4, 0));
+  sliver.AddIndex(0);
+  sliver.AddIndex(1);
+  sliver.AddIndex(2);
+  MeshOptimizer sliverOptimizer(sliver);
+  EXPECT_EQ(1u, sliverOptimizer.Weld(0.01));
+  EXPECT_EQ(0u, sliverOptimizer.Result().IndexCount());
+}
+
+/////////////////////////////////////////////////
+TEST(MeshOptimizerTest, VertexCache)
+{
+  const unsigned int size = 32u;
+  common::SubMesh subMesh = unweldedGrid(size);
+  MeshOptimizer optimizer(subMesh);
+  optimizer.Weld();
+  double welded = MeshOptimizer::CacheMissRatio(indices(optimizer.Result()));
+
+  // the scattered quads hardly reuse any cached vertex
+  EXPECT_LT(1.5, welded);
+
+  optimizer.OptimizeVertexCache();
+  common::SubMesh result = optimizer.Result();
+  double optimized = MeshOptimizer::CacheMissRatio(indices(result));
+  EXPECT_GT(welded, optimized);
+  EXPECT_GT(0.8, optimized);
+
+  // every triangle is still drawn once
+  EXPECT_EQ(subMesh.IndexCount(), result.IndexCount());
+  std::vector<unsigned int> count(result.VertexCount(), 0u);
+  for (auto index : indices(result))
+    ++count[index];
+  common::SubMesh reference = unweldedGrid(size);
+  MeshOptimizer referenceOptimizer(reference);
+  referenceOptimizer.Weld();
+  std::vector<unsigned int> referenceCount(result.VertexCount(), 0u);
+  for (auto index : indices(referenceOptimizer.Result()))
+    ++referenceCount[index];
+  EXPECT_EQ(referenceCount, count);
+}
+
+/////////////////////////////////////////////////
+TEST(MeshOptimizerTest, VertexFetch)
+{
+  common::SubMesh subMesh;
+  subMesh.SetPrimitiveType(common::SubMesh::TRIANGLES);
+  for (unsigned int i = 0; i < 5u; ++i)
+    subMesh.AddVertex(math::Vector3d(i, i * i, 0));
+  // vertex 1 is not used
+  for (unsigned int index : {4u, 2u, 0u, 0u, 2u, 3u})
+    subMesh.AddIndex(index);
+
+  MeshOptimizer optimizer(subMesh);
+  optimizer.OptimizeVertexFetch();
+  common::SubMesh result = optimizer.Result();
+  ASSERT_EQ(4u, result.VertexCount());
+  EXPECT_EQ((std::vector<unsigned int>{0u, 1u, 2u, 2u, 1u, 3u}),
+      indices(result));
+  EXPECT_EQ(subMesh.Vertex(4u), result.Vertex(0u));
+  EXPECT_EQ(subMesh.Vertex(2u), result.Vertex(1u));
+  EXPECT_EQ(subMesh.Vertex(0u), result.Vertex(2u));
+  EXPECT_EQ(subMesh.Vertex(3u), result.Vertex(3u));
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,416 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ignition/rendering/MeshSimplifier.hh"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+
+/// \brief Private data class for MeshSimplifier
+class ignition::rendering::MeshSimplifierPrivate
+{
+  /// \brief Symmetric 4x4 error quadric of a set of planes, stored as its
+  /// upper triangle
+  public: struct Quadric
+  {
+    /// \brief Add the quadric of a plane
+    /// \param[in] _normal Unit normal of the plane
+    /// \param[in] _d Offset of the plane, so that _normal.Dot(p) + _d = 0
+    /// \param[in] _weight Weight of the plane
+    void AddPlane(const math::Vector3d &_normal, double _d, double _weight)
+    {
+      const double a = _normal.X();
+      const double b = _normal.Y();
+      const double c = _normal.Z();
+      q[0] += _weight * a * a;
+      q[1] += _weight * a * b;
+      q[2] += _weight * a * c;
+      q[3] += _weight * a * _d;
+      q[4] += _weight * b * b;
+      q[5] += _weight * b * c;
+      q[6] += _weight * b * _d;
+      q[7] += _weight * c * c;
+      q[8] += _weight * c * _d;
+      q[9] += _weight * _d * _d;
+    }
+
+    /// \brief Add another quadric to this one
+    /// \param[in] _other Quadric to add
+    void Add(const Quadric &_other)
+    {
+      for (unsigned int i = 0u; i < q.size(); ++i)
+        q[i] += _other.q[i];
+    }
+
+    /// \brief Evaluate the squared distance error at a point
+    /// \param[in] _p Point
+    /// \return Error
+    double Error(const math::Vector3d &_p) const
+    {
+      const double x = _p.X();
+      const double y = _p.Y();
+      const double z = _p.Z();
+      return q[0] * x * x + 2.0 * q[1] * x * y + 2.0 * q[2] * x * z
+          + 2.0 * q[3] * x + q[4] * y * y + 2.0 * q[5] * y * z
+          + 2.0 * q[6] * y + q[7] * z * z + 2.0 * q[8] * z + q[9];
+    }
+
+    /// \brief Quadric coefficients
+    std::array<double, 10> q{};
+  };
+
+  /// \brief A candidate edge collapse
+  public: struct Collapse
+  {
+    /// \brief Error introduced by the collapse
+    double cost;
+
+    /// \brief Position removed by the collapse
+    uint32_t from;
+
+    /// \brief Position kept by the collapse
+    uint32_t to;
+
+    /// \brief Version of the removed position when the collapse was queued
+    uint32_t fromVersion;
+
+    /// \brief Version of the kept position when the collapse was queued
+    uint32_t toVersion;
+
+    /// \brief Order the priority queue by lowest cost first
+    bool operator<(const Collapse &_other) const
+    {
+      return cost > _other.cost;
+    }
+  };
+
+  /// \brief Get the normal of a triangle, scaled by twice its area
+  /// \param[in] _a First corner
+  /// \param[in] _b Second corner
+  /// \param[in] _c Third corner
+  /// \return Normal scaled by twice the triangle area
+  public: static math::Vector3d Normal(const math::Vector3d &_a,
+      const math::Vector3d &_b, const math::Vector3d &_c)
+  {
+    return (_b - _a).Cross(_c - _a);
+  }
+
+  /// \brief True if the submesh is a triangle list
+  public: bool valid = false;
+
+  /// \brief Unique positions of the submesh vertices
+  public: std::vector<math::Vector3d> positions;
+
+  /// \brief Index of the position of each vertex
+  public: std::vector<uint32_t> vertexPositions;
+
+  /// \brief A vertex at each position, used when a position is collapsed
+  /// onto it
+  public: std::vector<uint32_t> positionVertices;
+
+  /// \brief Vertex indices of the triangles
+  public: std::vector<std::array<uint32_t, 3>> triangles;
+
+  /// \brief Error quadric of each position
+  public: std::vector<Quadric> quadrics;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+MeshSimplifier::MeshSimplifier(const common::SubMesh &_subMesh)
+  : dataPtr(std::make_unique<MeshSimplifierPrivate>())
+{
+  if (_subMesh.SubMeshPrimitiveType() != common::SubMesh::TRIANGLES ||
+      _subMesh.IndexCount() % 3u != 0u)
+  {
+    return;
+  }
+  this->dataPtr->valid = true;
+
+  // weld vertices with the same position so that collapses are not stopped
+  // by texture or normal seams
+  std::map<std::array<double, 3>, uint32_t> positionIndex;
+  this->dataPtr->vertexPositions.resize(_subMesh.VertexCount());
+  for (unsigned int i = 0u; i < _subMesh.VertexCount(); ++i)
+  {
+    const math::Vector3d &v = _subMesh.Vertex(i);
+    auto it = positionIndex.emplace(std::array<double, 3>{v.X(), v.Y(), v.Z()},
+        static_cast<uint32_t>(this->dataPtr->positions.size()));
+    if (it.second)
+    {
+      this->dataPtr->positions.push_back(v);
+      this->dataPtr->positionVertices.push_back(i);
+    }
+    this->dataPtr->vertexPositions[i] = it.first->second;
+  }
+
+  this->dataPtr->triangles.reserve(_subMesh.IndexCount() / 3u);
+  for (unsigned int i = 0u; i + 2u < _subMesh.IndexCount(); i += 3u)
+  {
+    std::array<uint32_t, 3> t{
+        static_cast<uint32_t>(_subMesh.Index(i)),
+        static_cast<uint32_t>(_subMesh.Index(i + 1u)),
+        static_cast<uint32_t>(_subMesh.Index(i + 2u))};
+    if (t[0] >= _subMesh.VertexCount() || t[1] >= _subMesh.VertexCount() ||
+        t[2] >= _subMesh.VertexCount())
+    {
+      continue;
+    }
+    this->dataPtr->triangles.push_back(t);
+  }
+
+  // area weighted plane quadrics of the triangles, and count the triangles
+  // of each edge to find the boundaries
+  this->dataPtr->quadrics.resize(this->dataPtr->positions.size());
+  std::map<std::pair<uint32_t, uint32_t>, unsigned int> edgeCount;
+  for (const auto &t : this->dataPtr->triangles)
+  {
+    std::array<uint32_t, 3> p;
+    for (unsigned int k = 0u; k < 3u; ++k)
+      p[k] = this->dataPtr->vertexPositions[t[k]];
+
+    math::Vector3d n = MeshSimplifierPrivate::Normal(
+        this->dataPtr->positions[p[0]], this->dataPtr->positions[p[1]],
+        this->dataPtr->positions[p[2]]);
+    double area = n.Length() * 0.5;
+    if (area <= 0.0)
+      continue;
+    n /= area * 2.0;
+    double d = -n.Dot(this->dataPtr->positions[p[0]]);
+    for (unsigned int k = 0u; k < 3u; ++k)
+      this->dataPtr->quadrics[p[k]].AddPlane(n, d, area);
+
+    for (unsigned int k = 0u; k < 3u; ++k)
+    {
+      uint32_t a = p[k];
+      uint32_t b = p[(k + 1u) % 3u];
+      ++edgeCount[std::make_pair(std::min(a, b), std::max(a, b))];
+    }
+  }
+
+  // keep open boundaries in place with planes perpendicular to the
+  // triangles along the boundary edges
+  const double boundaryWeight = 1000.0;
+  for (const auto &t : this->dataPtr->triangles)
+  {
+    std::array<uint32_t, 3> p;
+    for (unsigned int k = 0u; k < 3u; ++k)
+      p[k] = this->dataPtr->vertexPositions[t[k]];
+
+    math::Vector3d n = MeshSimplifierPrivate::Normal(
+        this->dataPtr->positions[p[0]], this->dataPtr->positions[p[1]],
+        this->dataPtr->positions[p[2]]);
+    if (n.Length() <= 0.0)
+      continue;
+    n.Normalize();
+
+    for (unsigned int k = 0u; k < 3u; ++k)
+    {
+      uint32_t a = p[k];
+      uint32_t b = p[(k + 1u) % 3u];
+      if (a == b ||
+          edgeCount[std::make_pair(std::min(a, b), std::max(a, b))] != 1u)
+      {
+        continue;
+      }
+      math::Vector3d edge =
+          this->dataPtr->positions[b] - this->dataPtr->positions[a];
+      math::Vector3d edgeNormal = edge.Cross(n);
+      double length = edgeNormal.Length();
+      if (length <= 0.0)
+        continue;
+      edgeNormal /= length;
+      double d = -edgeNormal.Dot(this->dataPtr->positions[a]);
+      double weight = boundaryWeight * edge.SquaredLength();
+      this->dataPtr->quadrics[a].AddPlane(edgeNormal, d, weight);
+      this->dataPtr->quadrics[b].AddPlane(edgeNormal, d, weight);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+MeshSimplifier::~MeshSimplifier()
+{
+}
+
+/////////////////////////////////////////////////
+unsigned int MeshSimplifier::TriangleCount() const
+{
+  return static_cast<unsigned int>(this->dataPtr->triangles.size());
+}
+
+/////////////////////////////////////////////////
+std::vector<unsigned int> MeshSimplifier::Simplify(double _ratio) const
+{
+  std::vector<unsigned int> result;
+  if (!this->dataPtr->valid)
+    return result;
+
+  const auto &positions = this->dataPtr->positions;
+  const auto &vertexPositions = this->dataPtr->vertexPositions;
+  const auto &positionVertices = this->dataPtr->positionVertices;
+
+  std::vector<std::array<uint32_t, 3>> triangles = this->dataPtr->triangles;
+  std::vector<MeshSimplifierPrivate::Quadric> quadrics =
+      this->dataPtr->quadrics;
+  std::vector<bool> triangleAlive(triangles.size(), true);
+  std::vector<bool> positionAlive(positions.size(), true);
+  std::vector<uint32_t> versions(positions.size(), 0u);
+
+  // triangles around each position
+  std::vector<std::vector<uint32_t>> positionTriangles(positions.size());
+  for (uint32_t i = 0u; i < triangles.size(); ++i)
+  {
+    for (auto v : triangles[i])
+      positionTriangles[vertexPositions[v]].push_back(i);
+  }
+
+  size_t aliveCount = triangles.size();
+  size_t target = static_cast<size_t>(std::ceil(
+      std::max(0.0, std::min(1.0, _ratio)) * triangles.size()));
+
+  std::priority_queue<MeshSimplifierPrivate::Collapse> queue;
+  auto push = [&](uint32_t _a, uint32_t _b)
+  {
+    MeshSimplifierPrivate::Quadric q = quadrics[_a];
+    q.Add(quadrics[_b]);
+    double costAB = q.Error(positions[_b]);
+    double costBA = q.Error(positions[_a]);
+    if (costAB <= costBA)
+      queue.push({costAB, _a, _b, versions[_a], versions[_b]});
+    else
+      queue.push({costBA, _b, _a, versions[_b], versions[_a]});
+  };
+
+  for (const auto &t : triangles)
+  {
+    for (unsigned int k = 0u; k < 3u; ++k)
+    {
+      uint32_t a = vertexPositions[t[k]];
+      uint32_t b = vertexPositions[t[(k + 1u) % 3u]];
+      if (a < b)
+        push(a, b);
+      else if (b < a)
+        push(b, a);
+    }
+  }
+
+  while (aliveCount > target && !queue.empty())
+  {
+    MeshSimplifierPrivate::Collapse c = queue.top();
+    queue.pop();
+    if (!positionAlive[c.from] || !positionAlive[c.to] ||
+        versions[c.from] != c.fromVersion || versions[c.to] != c.toVersion)
+    {
+      continue;
+    }
+
+    // moving the removed position must not flip any remaining triangle
+    bool flips = false;
+    for (auto i : positionTriangles[c.from])
+    {
+      if (!triangleAlive[i])
+        continue;
+      std::array<uint32_t, 3> p;
+      bool removed = false;
+      for (unsigned int k = 0u; k < 3u; ++k)
+      {
+        p[k] = vertexPositions[triangles[i][k]];
+        removed = removed || p[k] == c.to;
+      }
+      if (removed)
+        continue;
+
+      math::Vector3d before = MeshSimplifierPrivate::Normal(
+          positions[p[0]], positions[p[1]], positions[p[2]]);
+      for (auto &k : p)
+      {
+        if (k == c.from)
+          k = c.to;
+      }
+      math::Vector3d after = MeshSimplifierPrivate::Normal(
+          positions[p[0]], positions[p[1]], positions[p[2]]);
+      if (before.Dot(after) <= 0.0)
+      {
+        flips = true;
+        break;
+      }
+    }
+    if (flips)
+      continue;
+
+    // collapse, removing the triangles that share the edge
+    for (auto i : positionTriangles[c.from])
+    {
+      if (!triangleAlive[i])
+        continue;
+      bool removed = false;
+      for (auto v : triangles[i])
+        removed = removed || vertexPositions[v] == c.to;
+      if (removed)
+      {
+        triangleAlive[i] = false;
+        --aliveCount;
+        continue;
+      }
+      for (auto &v : triangles[i])
+      {
+        if (vertexPositions[v] == c.from)
+          v = positionVertices[c.to];
+      }
+      positionTriangles[c.to].push_back(i);
+    }
+    positionAlive[c.from] = false;
+    positionTriangles[c.from].clear();
+    quadrics[c.to].Add(quadrics[c.from]);
+    ++versions[c.to];
+
+    // drop removed triangles and queue the edges around the kept position
+    auto &around = positionTriangles[c.to];
+    around.erase(std::remove_if(around.begin(), around.end(),
+        [&](uint32_t _i) {return !triangleAlive[_i];}), around.end());
+    for (auto i : around)
+    {
+      for (auto v : triangles[i])
+      {
+        uint32_t p = vertexPositions[v];
+        if (p != c.to)
+          push(c.to, p);
+      }
+    }
+  }
+
+  result.reserve(aliveCount * 3u);
+  for (uint32_t i = 0u; i < triangles.size(); ++i)
+  {
+    if (!triangleAlive[i])
+      continue;
+    for (auto v : triangles[i])
+      result.push_back(v);
+  }
+  return result;
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include <ignition/common/SubMesh.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/MeshSimplifier.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(MeshSimplifierTest, Empty)
+{
+  common::SubMesh subMesh;
+  MeshSimplifier simplifier(subMesh);
+  EXPECT_EQ(0u, simplifier.TriangleCount());
+  EXPECT_TRUE(simplifier.Simplify(0.5).empty());
+
+  // only triangle lists are simplified
+  subMesh.SetPrimitiveType(common::SubMesh::LINES);
+  subMesh.AddVertex(math::Vector3d(0, 0, 0));
+  subMesh.AddVertex(math::Vector3d(1, 0, 0));
+  subMesh.AddIndex(0);
+  subMesh.AddIndex(1);
+  MeshSimplifier lines(subMesh);
+  EXPECT_TRUE(lines.Simplify(0.5).empty());
+}
+
+/////////////////////////////////////////////////
+TEST(MeshSimplifierTest, Grid)
+{
+  // unit quads on the z = 0 plane facing +z, tessellated into a grid
+  const unsigned int size = 32u;
+  common::SubMesh subMesh;
+  for (unsigned int i = 0; i <= size; ++i)
+  {
+    for (unsigned int j = 0; j <= size; ++j)
+      subMesh.AddVertex(math::Vector3d(i, j, 0));
+  }
+  for (unsigned int i = 0; i < size; ++i)
+  {
+    for (unsigned int j = 0; j < size; ++j)
+    {
+      unsigned int a = i * (size + 1) + j;
+      unsigned int b = a + size + 1;
+      subMesh.AddIndex(a);
+      subMesh.AddIndex(b);
+      subMesh.AddIndex(b + 1);
+      subMesh.AddIndex(a);
+      subMesh.AddIndex(b + 1);
+      subMesh.AddIndex(a + 1);
+    }
+  }
+
+  MeshSimplifier simplifier(subMesh);
+  EXPECT_EQ(size * size * 2u, simplifier.TriangleCount());
+
+  // nothing to remove
+  EXPECT_EQ(size * size * 6u, simplifier.Simplify(1.0).size());
+
+  for (double ratio : {0.5, 0.25, 0.05})
+  {
+    std::vector<unsigned int> indices = simplifier.Simplify(ratio);
+    ASSERT_FALSE(indices.empty());
+    ASSERT_EQ(0u, indices.size() % 3u);
+    EXPECT_LE(indices.size() / 3u,
+        static_cast<size_t>(std::ceil(ratio * size * size * 2u)));
+
+    // the simplified triangles still cover the grid and face +z
+    double area = 0.0;
+    for (unsigned int i = 0; i < indices.size(); i += 3u)
+    {
+      ASSERT_LT(indices[i], subMesh.VertexCount());
+      ASSERT_LT(indices[i + 1], subMesh.VertexCount());
+      ASSERT_LT(indices[i + 2], subMesh.VertexCount());
+      math::Vector3d a = subMesh.Vertex(indices[i]);
+      math::Vector3d b = subMesh.Vertex(indices[i + 1]);
+      math::Vector3d c = subMesh.Vertex(indices[i + 2]);
+      math::Vector3d n = (b - a).Cross(c - a);
+      EXPECT_GE(n.Z(), 0.0);
+      area += n.Z() * 0.5;
+    }
+    EXPECT_NEAR(size * size, area, 1e-6);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -17,11 +17,14 @@
 
 #include <gtest/gtest.h>
 #include <string>
+#include <vector>
 
 #include <ignition/common/Console.hh>
+#include <ignition/common/Mesh.hh>
 #include <ignition/common/MeshManager.hh>
 #include <ignition/common/Skeleton.hh>
 #include <ignition/common/SkeletonAnimation.hh>
+#include <ignition/common/SubMesh.hh>
 
 #include "test_config.h"  // NOLINT(build/include)
 #include "ignition/rendering/Camera.hh"
@@ -29,6 +32,7 @@
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/RenderingIface.hh"
 #include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
 
 using namespace ignition;
 using namespace rendering;
@@ -42,6 +46,12 @@ class MeshTest : public testing::Test,
   /// \brief Test mesh skeleton animation API
   public: void MeshSkeletonAnimation(const std::string &_renderEngine);
 
+  /// \brief Test setting the skeleton bone transforms by index
+  public: void MeshSkeletonBoneTransforms(const std::string &_renderEngine);
+
+  /// \brief Test centering a submesh of a mesh also used uncentered
+  public: void CenterSubMesh(const std::string &_renderEngine);
+
   public: const std::string TEST_MEDIA_PATH =
         common::joinPaths(std::string(PROJECT_SOURCE_PATH),
         "test", "media", "meshes");
@@ -202,6 +212,163 @@ TEST_P(MeshTest, MeshSkeletonAnimation)
   MeshSkeletonAnimation(GetParam());
 }
 
+/////////////////////////////////////////////////
+void MeshTest::MeshSkeletonBoneTransforms(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+
+  // meshes with no skeleton have no bones
+  MeshDescriptor boxDescriptor("unit_box");
+  MeshPtr boxMesh = scene->CreateMesh(boxDescriptor);
+  ASSERT_TRUE(boxMesh != nullptr);
+  EXPECT_EQ(0u, boxMesh->SkeletonBoneCount());
+  EXPECT_TRUE(boxMesh->SkeletonBoneNames().empty());
+  math::Matrix4f identity = math::Matrix4f::Identity;
+  EXPECT_NO_THROW(boxMesh->SetSkeletonBoneTransforms(&identity, 1u));
+
+  MeshDescriptor descriptor;
+  descriptor.meshName = common::joinPaths(TEST_MEDIA_PATH, "walk.dae");
+  common::MeshManager *meshManager = common::MeshManager::Instance();
+  descriptor.mesh = meshManager->Load(descriptor.meshName);
+  MeshPtr mesh = scene->CreateMesh(descriptor);
+  ASSERT_TRUE(mesh != nullptr);
+  MeshPtr mesh2 = scene->CreateMesh(descriptor);
+  ASSERT_TRUE(mesh2 != nullptr);
+
+  // bone names match the names of the local transforms
+  std::vector<std::string> names = mesh->SkeletonBoneNames();
+  auto localTfs = mesh->SkeletonLocalTransforms();
+  ASSERT_FALSE(names.empty());
+  EXPECT_EQ(names.size(), mesh->SkeletonBoneCount());
+  EXPECT_EQ(localTfs.size(), names.size());
+  for (const auto &name : names)
+    EXPECT_EQ(1u, localTfs.count(name));
+
+  // set the bones by index
+  unsigned int count = mesh->SkeletonBoneCount();
+  std::vector<math::Matrix4f> tfs(count, math::Matrix4f::Identity);
+  for (unsigned int i = 0; i < count; ++i)
+    tfs[i].SetTranslation(math::Vector3f(i, 0, 0));
+  mesh->SetSkeletonBoneTransforms(tfs.data(), count);
+  localTfs = mesh->SkeletonLocalTransforms();
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    EXPECT_NEAR(i, localTfs[names[i]].Translation().X(), 1e-5);
+    EXPECT_NEAR(0.0, localTfs[names[i]].Translation().Y(), 1e-5);
+  }
+
+  // set the bones of both meshes at once
+  std::vector<math::Matrix4f> batch(2u * count, math::Matrix4f::Identity);
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    batch[i].SetTranslation(math::Vector3f(0, i, 0));
+    batch[count + i].SetTranslation(math::Vector3f(0, 0, i));
+  }
+  scene->SetSkeletonBoneTransforms({mesh, mesh2}, batch);
+  localTfs = mesh->SkeletonLocalTransforms();
+  auto localTfs2 = mesh2->SkeletonLocalTransforms();
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    EXPECT_NEAR(i, localTfs[names[i]].Translation().Y(), 1e-5);
+    EXPECT_NEAR(i, localTfs2[names[i]].Translation().Z(), 1e-5);
+  }
+
+  // transforms that do not match the bones are rejected
+  batch.pop_back();
+  scene->SetSkeletonBoneTransforms({mesh, mesh2}, batch);
+  localTfs = mesh->SkeletonLocalTransforms();
+  for (unsigned int i = 0; i < count; ++i)
+    EXPECT_NEAR(i, localTfs[names[i]].Translation().Y(), 1e-5);
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(MeshTest, MeshSkeletonBoneTransforms)
+{
+  MeshSkeletonBoneTransforms(GetParam());
+}
+
+/////////////////////////////////////////////////
+void MeshTest::CenterSubMesh(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+
+  // a triangle away from the origin of the mesh
+  const std::string meshName = "center_submesh_test";
+  common::MeshManager *meshManager = common::MeshManager::Instance();
+  if (!meshManager->HasMesh(meshName))
+  {
+    common::SubMesh subMesh;
+    subMesh.SetName("triangle");
+    subMesh.SetPrimitiveType(common::SubMesh::TRIANGLES);
+    subMesh.AddVertex(math::Vector3d(2, 0, 0));
+    subMesh.AddVertex(math::Vector3d(3, 0, 0));
+    subMesh.AddVertex(math::Vector3d(2, 1, 0));
+    for (unsigned int i = 0; i < 3u; ++i)
+    {
+      subMesh.AddNormal(math::Vector3d::UnitZ);
+      subMesh.AddIndex(i);
+    }
+    common::Mesh *commonMesh = new common::Mesh();
+    commonMesh->SetName(meshName);
+    commonMesh->AddSubMesh(subMesh);
+    meshManager->AddMesh(commonMesh);
+  }
+
+  MeshDescriptor descriptor(meshName);
+  descriptor.subMeshName = "triangle";
+  VisualPtr original = scene->CreateVisual();
+  ASSERT_TRUE(original != nullptr);
+  original->AddGeometry(scene->CreateMesh(descriptor));
+
+  descriptor.centerSubMesh = true;
+  VisualPtr centered = scene->CreateVisual();
+  ASSERT_TRUE(centered != nullptr);
+  centered->AddGeometry(scene->CreateMesh(descriptor));
+  ASSERT_EQ(1u, original->GeometryCount());
+  ASSERT_EQ(1u, centered->GeometryCount());
+
+  // both meshes keep their own placement
+  math::Vector3d originalCenter = original->LocalBoundingBox().Center();
+  math::Vector3d centeredCenter = centered->LocalBoundingBox().Center();
+  EXPECT_NEAR(2.5, originalCenter.X(), 1e-5);
+  EXPECT_NEAR(0.5, originalCenter.Y(), 1e-5);
+  EXPECT_NEAR(0.0, centeredCenter.X(), 1e-5);
+  EXPECT_NEAR(0.0, centeredCenter.Y(), 1e-5);
+  EXPECT_NEAR(1.0, centered->LocalBoundingBox().Size().X(), 1e-5);
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(MeshTest, CenterSubMesh)
+{
+  CenterSubMesh(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(Mesh, MeshTest,
     RENDER_ENGINE_VALUES,
     ignition::rendering::PrintToStringParam());
@@ -36,6 +36,9 @@ class NodeTest : public testing::Test,
 {
   /// \brief Test visual material
   public: void Pose(const std::string &_renderEngine);
+
+  /// \brief Test world pose of nested nodes after changes up the tree
+  public: void WorldPoseHierarchy(const std::string &_renderEngine);
 };
 
 /////////////////////////////////////////////////
@@ -124,12 +127,73 @@ void NodeTest::Pose(const std::string &_renderEngine)
   rendering::unloadEngine(engine->Name());
 }
 
+/////////////////////////////////////////////////
+void NodeTest::WorldPoseHierarchy(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+
+  VisualPtr parent = scene->CreateVisual();
+  VisualPtr child = scene->CreateVisual();
+  VisualPtr grandchild = scene->CreateVisual();
+  ASSERT_NE(nullptr, parent);
+  ASSERT_NE(nullptr, child);
+  ASSERT_NE(nullptr, grandchild);
+  scene->RootVisual()->AddChild(parent);
+  parent->AddChild(child);
+  child->AddChild(grandchild);
+
+  child->SetLocalPosition(1, 0, 0);
+  grandchild->SetLocalPosition(0, 1, 0);
+  EXPECT_EQ(math::Vector3d(1, 1, 0), grandchild->WorldPosition());
+
+  // moving an ancestor moves descendants
+  parent->SetLocalPosition(0, 0, 2);
+  EXPECT_EQ(math::Vector3d(1, 1, 2), grandchild->WorldPosition());
+  EXPECT_EQ(math::Vector3d(1, 0, 2), child->WorldPosition());
+
+  parent->SetWorldRotation(math::Quaterniond(0, 0, IGN_PI));
+  EXPECT_EQ(math::Pose3d(-1, -1, 2, 0, 0, IGN_PI), grandchild->WorldPose());
+
+  // changing the origin of an ancestor moves descendants
+  parent->SetWorldRotation(math::Quaterniond::Identity);
+  parent->SetOrigin(0, 0, 1);
+  EXPECT_EQ(math::Vector3d(1, 1, 3), grandchild->WorldPosition());
+  parent->SetLocalPosition(0, 0, 2);
+  EXPECT_EQ(math::Vector3d(1, 1, 2), grandchild->WorldPosition());
+  parent->SetOrigin(0, 0, 0);
+  EXPECT_EQ(math::Vector3d(1, 1, 1), grandchild->WorldPosition());
+
+  // reparenting
+  parent->RemoveChild(child);
+  EXPECT_EQ(math::Vector3d(1, 1, 0), grandchild->WorldPosition());
+  parent->AddChild(child);
+  EXPECT_EQ(math::Vector3d(1, 1, 1), grandchild->WorldPosition());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
 /////////////////////////////////////////////////
 TEST_P(NodeTest, Pose)
 {
   Pose(GetParam());
 }
 
+/////////////////////////////////////////////////
+TEST_P(NodeTest, WorldPoseHierarchy)
+{
+  WorldPoseHierarchy(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(Node, NodeTest,
     RENDER_ENGINE_VALUES,
     ignition::rendering::PrintToStringParam());
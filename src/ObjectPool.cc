@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ignition/rendering/ObjectPool.hh"
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Private data for the MemoryPool class
+class ignition::rendering::MemoryPoolPrivate
+{
+  /// \brief Free block, linked to the next free block
+  public: struct FreeBlock
+  {
+    /// \brief Next free block
+    FreeBlock *next;
+  };
+
+  /// \brief Protects the pool
+  public: mutable std::mutex mutex;
+
+  /// \brief Size of the blocks
+  public: size_t blockSize = 0u;
+
+  /// \brief Number of blocks per chunk
+  public: size_t blocksPerChunk = 0u;
+
+  /// \brief Chunks of blocks
+  public: std::vector<void *> chunks;
+
+  /// \brief First free block
+  public: FreeBlock *freeList = nullptr;
+
+  /// \brief Number of blocks in use
+  public: size_t usedCount = 0u;
+};
+
+//////////////////////////////////////////////////
+MemoryPool::MemoryPool(size_t _blockSize, size_t _blocksPerChunk)
+  : dataPtr(new MemoryPoolPrivate)
+{
+  const size_t align = alignof(std::max_align_t);
+  size_t blockSize = std::max(_blockSize,
+      sizeof(MemoryPoolPrivate::FreeBlock));
+  this->dataPtr->blockSize = (blockSize + align - 1u) / align * align;
+  this->dataPtr->blocksPerChunk = std::max<size_t>(_blocksPerChunk, 1u);
+}
+
+//////////////////////////////////////////////////
+MemoryPool::~MemoryPool()
+{
+  for (void *chunk : this->dataPtr->chunks)
+    ::operator delete(chunk);
+}
+
+//////////////////////////////////////////////////
+void *MemoryPool::Allocate()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (!this->dataPtr->freeList)
+  {
+    // carve a new chunk, its blocks are pushed so the first one is on top
+    size_t count = this->dataPtr->blocksPerChunk;
+    auto chunk = static_cast<char *>(
+        ::operator new(count * this->dataPtr->blockSize));
+    this->dataPtr->chunks.push_back(chunk);
+    for (size_t i = count; i > 0u; --i)
+    {
+      auto block = reinterpret_cast<MemoryPoolPrivate::FreeBlock *>(
+          chunk + (i - 1u) * this->dataPtr->blockSize);
+      block->next = this->dataPtr->freeList;
+      this->dataPtr->freeList = block;
+    }
+  }
+
+  MemoryPoolPrivate::FreeBlock *block = this->dataPtr->freeList;
+  this->dataPtr->freeList = block->next;
+  ++this->dataPtr->usedCount;
+  return block;
+}
+
+//////////////////////////////////////////////////
+void MemoryPool::Deallocate(void *_block)
+{
+  if (!_block)
+    return;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto block = static_cast<MemoryPoolPrivate::FreeBlock *>(_block);
+  block->next = this->dataPtr->freeList;
+  this->dataPtr->freeList = block;
+  --this->dataPtr->usedCount;
+}
+
+//////////////////////////////////////////////////
+size_t MemoryPool::BlockSize() const
+{
+  return this->dataPtr->blockSize;
+}
+
+//////////////////////////////////////////////////
+size_t MemoryPool::UsedCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->usedCount;
+}
+
+//////////////////////////////////////////////////
+size_t MemoryPool::Capacity() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->chunks.size() * this->dataPtr->blocksPerChunk;
+}
+
+//////////////////////////////////////////////////
+MemoryPool &MemoryPool::ForSize(size_t _size)
+{
+  // never destroyed, pooled objects may be released during static
+  // destruction
+  static std::mutex *mutex = new std::mutex;
+  static auto *pools = new std::unordered_map<size_t, MemoryPool *>;
+
+  const size_t align = alignof(std::max_align_t);
+  size_t size = (std::max<size_t>(_size, 1u) + align - 1u) / align * align;
+
+  std::lock_guard<std::mutex> lock(*mutex);
+  MemoryPool *&pool = (*pools)[size];
+  if (!pool)
+    pool = new MemoryPool(size);
+  return *pool;
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/ObjectPool.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Object counting its instances, with a protected constructor
+class PooledObject
+{
+  /// \brief Constructor
+  /// \param[in] _name Name of the object
+  protected: explicit PooledObject(const std::string &_name)
+    : name(_name)
+  {
+    ++instances;
+  }
+
+  /// \brief Destructor
+  public: virtual ~PooledObject()
+  {
+    --instances;
+  }
+
+  /// \brief Create a pooled object
+  /// \param[in] _name Name of the object
+  /// \return The object
+  public: static std::shared_ptr<PooledObject> Create(
+              const std::string &_name)
+  {
+    return SharePooled(new (AllocatePooled<PooledObject>())
+        PooledObject(_name));
+  }
+
+  /// \brief Name of the object
+  public: std::string name;
+
+  /// \brief Number of objects alive
+  public: static int instances;
+};
+
+int PooledObject::instances = 0;
+
+/////////////////////////////////////////////////
+TEST(ObjectPoolTest, MemoryPool)
+{
+  MemoryPool pool(3u, 4u);
+  EXPECT_EQ(alignof(std::max_align_t), pool.BlockSize());
+  EXPECT_EQ(0u, pool.Capacity());
+
+  // blocks are distinct and aligned
+  std::set<void *> blocks;
+  for (int i = 0; i < 10; ++i)
+  {
+    void *block = pool.Allocate();
+    ASSERT_NE(nullptr, block);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(block) %
+        alignof(std::max_align_t));
+    blocks.insert(block);
+  }
+  EXPECT_EQ(10u, blocks.size());
+  EXPECT_EQ(10u, pool.UsedCount());
+  EXPECT_EQ(12u, pool.Capacity());
+
+  // returned blocks are reused before new chunks are allocated
+  for (void *block : blocks)
+    pool.Deallocate(block);
+  pool.Deallocate(nullptr);
+  EXPECT_EQ(0u, pool.UsedCount());
+  for (int i = 0; i < 10; ++i)
+    EXPECT_NE(blocks.end(), blocks.find(pool.Allocate()));
+  EXPECT_EQ(12u, pool.Capacity());
+
+  // the pool grows by a chunk when it runs out of blocks
+  for (int i = 0; i < 3; ++i)
+    pool.Allocate();
+  EXPECT_EQ(13u, pool.UsedCount());
+  EXPECT_EQ(16u, pool.Capacity());
+
+  // shared pools are per size
+  EXPECT_EQ(&MemoryPool::ForSize(100u), &MemoryPool::ForSize(100u));
+  EXPECT_NE(&MemoryPool::ForSize(100u), &MemoryPool::ForSize(500u));
+  EXPECT_LE(500u, MemoryPool::ForSize(500u).BlockSize());
+}
+
+/////////////////////////////////////////////////
+TEST(ObjectPoolTest, SharePooled)
+{
+  MemoryPool &pool = PoolAllocator<PooledObject>::Pool();
+  size_t used = pool.UsedCount();
+
+  std::vector<std::shared_ptr<PooledObject>> objects;
+  for (int i = 0; i < 100; ++i)
+    objects.push_back(PooledObject::Create(std::to_string(i)));
+  EXPECT_EQ(100, PooledObject::instances);
+  EXPECT_EQ(used + 100u, pool.UsedCount());
+  EXPECT_EQ("42", objects[42]->name);
+
+  // objects are destroyed and their memory recycled with the last reference
+  std::shared_ptr<PooledObject> kept = objects[7];
+  objects.clear();
+  EXPECT_EQ(1, PooledObject::instances);
+  EXPECT_EQ(used + 1u, pool.UsedCount());
+  EXPECT_EQ("7", kept->name);
+
+  size_t capacity = pool.Capacity();
+  for (int i = 0; i < 99; ++i)
+    objects.push_back(PooledObject::Create(std::to_string(i)));
+  EXPECT_EQ(capacity, pool.Capacity());
+
+  objects.clear();
+  kept.reset();
+  EXPECT_EQ(0, PooledObject::instances);
+  EXPECT_EQ(used, pool.UsedCount());
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
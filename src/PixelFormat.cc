@@ -15,6 +15,20 @@
  *
  */
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define IGN_RENDERING_PIXEL_SSE2
+#endif
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#define IGN_RENDERING_PIXEL_NEON
+#endif
+
 #include <ignition/common/Console.hh>
 
 #include "ignition/rendering/PixelFormat.hh"
@@ -22,6 +36,361 @@
 using namespace ignition;
 using namespace rendering;
 
+// The pixel conversions below use the widest instruction set the library is
+// compiled for. Each vector loop leaves the remaining pixels to the scalar
+// loop following it, which also defines the expected results.
+
+//////////////////////////////////////////////////
+/// \brief Swap the first and third channels of 8-bit RGB pixels
+/// \param[in] _src Source pixels
+/// \param[out] _dst Destination pixels, may be _src
+/// \param[in] _count Number of pixels
+static void swapRedBlue(const uint8_t *_src, uint8_t *_dst,
+    unsigned int _count)
+{
+  unsigned int i = 0u;
+#if defined(__SSSE3__)
+  // 5 pixels per iteration. The 16th byte is left as is, it is the first
+  // byte of the next pixel, so that the loop also works in place.
+  const __m128i mask = _mm_setr_epi8(
+      2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15);
+  for (; i + 6u <= _count; i += 5u)
+  {
+    __m128i v = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(_src + i * 3u));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(_dst + i * 3u),
+        _mm_shuffle_epi8(v, mask));
+  }
+#elif defined(IGN_RENDERING_PIXEL_NEON)
+  for (; i + 16u <= _count; i += 16u)
+  {
+    uint8x16x3_t v = vld3q_u8(_src + i * 3u);
+    uint8x16_t red = v.val[0];
+    v.val[0] = v.val[2];
+    v.val[2] = red;
+    vst3q_u8(_dst + i * 3u, v);
+  }
+#endif
+  for (; i < _count; ++i)
+  {
+    uint8_t red = _src[i * 3u];
+    _dst[i * 3u] = _src[i * 3u + 2u];
+    _dst[i * 3u + 1u] = _src[i * 3u + 1u];
+    _dst[i * 3u + 2u] = red;
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Widen 8-bit values to 16 bits
+/// \param[in] _src Source values
+/// \param[out] _dst Destination values
+/// \param[in] _count Number of values
+static void widenL8(const uint8_t *_src, uint16_t *_dst, unsigned int _count)
+{
+  unsigned int i = 0u;
+#if defined(__AVX2__)
+  for (; i + 16u <= _count; i += 16u)
+  {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(_src + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(_dst + i),
+        _mm256_cvtepu8_epi16(v));
+  }
+#elif defined(IGN_RENDERING_PIXEL_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 16u <= _count; i += 16u)
+  {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(_src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(_dst + i),
+        _mm_unpacklo_epi8(v, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(_dst + i + 8u),
+        _mm_unpackhi_epi8(v, zero));
+  }
+#elif defined(IGN_RENDERING_PIXEL_NEON)
+  for (; i + 16u <= _count; i += 16u)
+  {
+    uint8x16_t v = vld1q_u8(_src + i);
+    vst1q_u16(_dst + i, vmovl_u8(vget_low_u8(v)));
+    vst1q_u16(_dst + i + 8u, vmovl_u8(vget_high_u8(v)));
+  }
+#endif
+  for (; i < _count; ++i)
+    _dst[i] = _src[i];
+}
+
+//////////////////////////////////////////////////
+/// \brief Drop the alpha channel of float RGBA pixels
+/// \param[in] _src Source pixels
+/// \param[out] _dst Destination pixels
+/// \param[in] _count Number of pixels
+static void dropAlpha(const float *_src, float *_dst, unsigned int _count)
+{
+  unsigned int i = 0u;
+#if defined(IGN_RENDERING_PIXEL_SSE2)
+  // the alpha written past each pixel is overwritten by the next pixel
+  for (; i + 1u < _count; ++i)
+    _mm_storeu_ps(_dst + i * 3u, _mm_loadu_ps(_src + i * 4u));
+#elif defined(IGN_RENDERING_PIXEL_NEON)
+  for (; i + 4u <= _count; i += 4u)
+  {
+    float32x4x4_t v = vld4q_f32(_src + i * 4u);
+    float32x4x3_t rgb = {{v.val[0], v.val[1], v.val[2]}};
+    vst3q_f32(_dst + i * 3u, rgb);
+  }
+#endif
+  for (; i < _count; ++i)
+  {
+    _dst[i * 3u] = _src[i * 4u];
+    _dst[i * 3u + 1u] = _src[i * 4u + 1u];
+    _dst[i * 3u + 2u] = _src[i * 4u + 2u];
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Keep the first channel of float RGBA pixels
+/// \param[in] _src Source pixels
+/// \param[out] _dst Destination values
+/// \param[in] _count Number of pixels
+static void firstChannel(const float *_src, float *_dst, unsigned int _count)
+{
+  unsigned int i = 0u;
+#if defined(IGN_RENDERING_PIXEL_SSE2)
+  for (; i + 4u <= _count; i += 4u)
+  {
+    const float *src = _src + i * 4u;
+    __m128 ab = _mm_unpacklo_ps(_mm_loadu_ps(src), _mm_loadu_ps(src + 4u));
+    __m128 cd = _mm_unpacklo_ps(_mm_loadu_ps(src + 8u),
+        _mm_loadu_ps(src + 12u));
+    _mm_storeu_ps(_dst + i, _mm_movelh_ps(ab, cd));
+  }
+#elif defined(IGN_RENDERING_PIXEL_NEON)
+  for (; i + 4u <= _count; i += 4u)
+    vst1q_f32(_dst + i, vld4q_f32(_src + i * 4u).val[0]);
+#endif
+  for (; i < _count; ++i)
+    _dst[i] = _src[i * 4u];
+}
+
+//////////////////////////////////////////////////
+/// \brief Quantize float values in [0, 1] to 8 bits, truncating. Values
+/// out of range are clamped, NaN values are set to 0.
+/// \param[in] _src Source values
+/// \param[out] _dst Destination values
+/// \param[in] _count Number of values
+static void quantizeFloats(const float *_src, uint8_t *_dst,
+    unsigned int _count)
+{
+  unsigned int i = 0u;
+#if defined(__AVX2__)
+  const __m256 scale = _mm256_set1_ps(255.0f);
+  const __m256 zero = _mm256_setzero_ps();
+  // undo the interleaving of the 128-bit lanes by the packs
+  const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  for (; i + 32u <= _count; i += 32u)
+  {
+    __m256i v[4];
+    for (unsigned int k = 0u; k < 4u; ++k)
+    {
+      __m256 f = _mm256_mul_ps(_mm256_loadu_ps(_src + i + k * 8u), scale);
+      f = _mm256_min_ps(_mm256_max_ps(f, zero), scale);
+      v[k] = _mm256_cvttps_epi32(f);
+    }
+    __m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(v[0], v[1]),
+        _mm256_packs_epi32(v[2], v[3]));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(_dst + i),
+        _mm256_permutevar8x32_epi32(packed, order));
+  }
+#elif defined(IGN_RENDERING_PIXEL_SSE2)
+  const __m128 scale = _mm_set1_ps(255.0f);
+  const __m128 zero = _mm_setzero_ps();
+  for (; i + 16u <= _count; i += 16u)
+  {
+    __m128i v[4];
+    for (unsigned int k = 0u; k < 4u; ++k)
+    {
+      __m128 f = _mm_mul_ps(_mm_loadu_ps(_src + i + k * 4u), scale);
+      f = _mm_min_ps(_mm_max_ps(f, zero), scale);
+      v[k] = _mm_cvttps_epi32(f);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(_dst + i),
+        _mm_packus_epi16(_mm_packs_epi32(v[0], v[1]),
+        _mm_packs_epi32(v[2], v[3])));
+  }
+#elif defined(IGN_RENDERING_PIXEL_NEON)
+  // the conversion saturates negative values and sets NaN values to 0
+  const float32x4_t scale = vdupq_n_f32(255.0f);
+  for (; i + 16u <= _count; i += 16u)
+  {
+    uint16x4_t v[4];
+    for (unsigned int k = 0u; k < 4u; ++k)
+    {
+      float32x4_t f = vminq_f32(
+          vmulq_f32(vld1q_f32(_src + i + k * 4u), scale), scale);
+      v[k] = vqmovn_u32(vcvtq_u32_f32(f));
+    }
+    vst1q_u8(_dst + i, vcombine_u8(
+        vqmovn_u16(vcombine_u16(v[0], v[1])),
+        vqmovn_u16(vcombine_u16(v[2], v[3]))));
+  }
+#endif
+  for (; i < _count; ++i)
+  {
+    float f = 255.0f * _src[i];
+    _dst[i] = static_cast<uint8_t>(f > 0.0f ? std::min(f, 255.0f) : 0.0f);
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Convert depths in meters to 16-bit millimeters, rounding to the
+/// nearest millimeter. Depths that are not finite or out of range are set
+/// to 0.
+/// \param[in] _src Source depths
+/// \param[out] _dst Destination depths
+/// \param[in] _count Number of depths
+static void depthToMillimeters(const float *_src, uint16_t *_dst,
+    unsigned int _count)
+{
+  unsigned int i = 0u;
+#if defined(__AVX2__)
+  const __m256 scale = _mm256_set1_ps(1000.0f);
+  const __m256 half = _mm256_set1_ps(0.5f);
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 maxValue = _mm256_set1_ps(65535.0f);
+  for (; i + 16u <= _count; i += 16u)
+  {
+    __m256i v[2];
+    for (unsigned int k = 0u; k < 2u; ++k)
+    {
+      __m256 mm = _mm256_mul_ps(_mm256_loadu_ps(_src + i + k * 8u), scale);
+      __m256 valid = _mm256_and_ps(_mm256_cmp_ps(mm, zero, _CMP_GE_OQ),
+          _mm256_cmp_ps(mm, maxValue, _CMP_LE_OQ));
+      mm = _mm256_and_ps(_mm256_add_ps(mm, half), valid);
+      v[k] = _mm256_cvttps_epi32(mm);
+    }
+    // packus interleaves the 128-bit lanes
+    __m256i packed = _mm256_permute4x64_epi64(
+        _mm256_packus_epi32(v[0], v[1]), 0xD8);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(_dst + i), packed);
+  }
+#elif defined(IGN_RENDERING_PIXEL_SSE2)
+  const __m128 scale = _mm_set1_ps(1000.0f);
+  const __m128 half = _mm_set1_ps(0.5f);
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 maxValue = _mm_set1_ps(65535.0f);
+  // SSE2 only packs signed values, the range is shifted around the pack
+  const __m128i offset32 = _mm_set1_epi32(32768);
+  const __m128i offset16 = _mm_set1_epi16(static_cast<int16_t>(0x8000));
+  for (; i + 8u <= _count; i += 8u)
+  {
+    __m128i v[2];
+    for (unsigned int k = 0u; k < 2u; ++k)
+    {
+      __m128 mm = _mm_mul_ps(_mm_loadu_ps(_src + i + k * 4u), scale);
+      __m128 valid = _mm_and_ps(_mm_cmpge_ps(mm, zero),
+          _mm_cmple_ps(mm, maxValue));
+      mm = _mm_and_ps(_mm_add_ps(mm, half), valid);
+      v[k] = _mm_sub_epi32(_mm_cvttps_epi32(mm), offset32);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(_dst + i),
+        _mm_xor_si128(_mm_packs_epi32(v[0], v[1]), offset16));
+  }
+#elif defined(IGN_RENDERING_PIXEL_NEON)
+  const float32x4_t scale = vdupq_n_f32(1000.0f);
+  const float32x4_t half = vdupq_n_f32(0.5f);
+  const float32x4_t zero = vdupq_n_f32(0.0f);
+  const float32x4_t maxValue = vdupq_n_f32(65535.0f);
+  for (; i + 4u <= _count; i += 4u)
+  {
+    float32x4_t mm = vmulq_f32(vld1q_f32(_src + i), scale);
+    uint32x4_t valid = vandq_u32(vcgeq_f32(mm, zero),
+        vcleq_f32(mm, maxValue));
+    uint32x4_t v = vandq_u32(vcvtq_u32_f32(vaddq_f32(mm, half)), valid);
+    vst1_u16(_dst + i, vmovn_u32(v));
+  }
+#endif
+  for (; i < _count; ++i)
+  {
+    float mm = _src[i] * 1000.0f;
+    _dst[i] = (mm >= 0.0f && mm <= 65535.0f) ?
+        static_cast<uint16_t>(mm + 0.5f) : 0u;
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Convert floats to half floats, rounding to the nearest even
+/// half float. Values too large for half floats become infinities.
+/// \param[in] _src Source floats
+/// \param[out] _dst Destination half floats
+/// \param[in] _count Number of values
+static void floatsToHalves(const float *_src, uint16_t *_dst,
+    unsigned int _count)
+{
+  for (unsigned int i = 0u; i < _count; ++i)
+  {
+    uint32_t bits;
+    std::memcpy(&bits, &_src[i], sizeof(bits));
+    uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+    uint32_t magnitude = bits & 0x7FFFFFFFu;
+    if (magnitude >= 0x7F800000u)
+    {
+      // infinity, or NaN kept quiet
+      _dst[i] = sign | (magnitude > 0x7F800000u ? 0x7E00u : 0x7C00u);
+    }
+    else if (magnitude >= 0x477FF000u)
+    {
+      // 65520 and above round to infinity
+      _dst[i] = sign | 0x7C00u;
+    }
+    else if (magnitude < 0x38800000u)
+    {
+      // subnormal half float, the scaling by 2^24 is exact
+      float value;
+      std::memcpy(&value, &magnitude, sizeof(value));
+      _dst[i] = sign |
+          static_cast<uint16_t>(std::nearbyint(value * 16777216.0f));
+    }
+    else
+    {
+      // rebias the exponent and round the mantissa to nearest even
+      magnitude -= 0x38000000u;
+      magnitude += 0x0FFFu + ((magnitude >> 13) & 1u);
+      _dst[i] = sign | static_cast<uint16_t>(magnitude >> 13);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Convert half floats to floats, which is exact
+/// \param[in] _src Source half floats
+/// \param[out] _dst Destination floats
+/// \param[in] _count Number of values
+static void halvesToFloats(const uint16_t *_src, float *_dst,
+    unsigned int _count)
+{
+  for (unsigned int i = 0u; i < _count; ++i)
+  {
+    uint32_t sign = static_cast<uint32_t>(_src[i] & 0x8000u) << 16;
+    uint32_t exponent = (_src[i] >> 10) & 0x1Fu;
+    uint32_t mantissa = _src[i] & 0x03FFu;
+    uint32_t bits;
+    if (exponent == 0u)
+    {
+      // zero or subnormal, a multiple of 2^-24
+      float value = mantissa * 5.9604644775390625e-8f;
+      std::memcpy(&bits, &value, sizeof(bits));
+      bits |= sign;
+    }
+    else if (exponent == 0x1Fu)
+    {
+      bits = sign | 0x7F800000u | (mantissa << 13);
+    }
+    else
+    {
+      bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+    }
+    std::memcpy(&_dst[i], &bits, sizeof(bits));
+  }
+}
+
 //////////////////////////////////////////////////
 const char *PixelUtil::names[PF_COUNT] =
     {
@@ -36,7 +405,8 @@ const char *PixelUtil::names[PF_COUNT] =
       "FLOAT32_R",
       "FLOAT32_RGBA",
       "FLOAT32_RGB",
-      "L16"
+      "L16",
+      "FLOAT16_R"
     };
 
 //////////////////////////////////////////////////
@@ -51,13 +421,13 @@ const unsigned char PixelUtil::channelCounts[PF_COUNT] =
       // B8G8R8
       3,
       // BAYER_RGGB8
-      4,
+      1,
       // BAYER_BGGR8
-      4,
+      1,
       // BAYER_GBGR8
-      4,
+      1,
       // BAYER_GRGB8
-      4,
+      1,
       // PF_FLOAT32_R
       1,
       // PF_FLOAT32_RGBA
@@ -65,6 +435,8 @@ const unsigned char PixelUtil::channelCounts[PF_COUNT] =
       // PF_FLOAT32_RGB
       3,
       // PF_L16
+      1,
+      // PF_FLOAT16_R
       1
     };
 
@@ -95,6 +467,8 @@ const unsigned char PixelUtil::channelByteCounts[PF_COUNT] =
       4,
       // PF_L16
       2,
+      // PF_FLOAT16_R
+      2
     };
 
 //////////////////////////////////////////////////
@@ -103,6 +477,13 @@ bool PixelUtil::IsValid(PixelFormat _format)
   return _format > 0 && _format < PF_COUNT;
 }
 
+//////////////////////////////////////////////////
+bool PixelUtil::IsBayer(PixelFormat _format)
+{
+  return _format == PF_BAYER_RGGB8 || _format == PF_BAYER_BGGR8 ||
+      _format == PF_BAYER_GBGR8 || _format == PF_BAYER_GRGB8;
+}
+
 //////////////////////////////////////////////////
 PixelFormat PixelUtil::Sanitize(PixelFormat _format)
 {
@@ -172,3 +553,65 @@ PixelFormat PixelUtil::Enum(const std::string &_name)
   // no match found
   return PF_UNKNOWN;
 }
+
+//////////////////////////////////////////////////
+bool PixelUtil::Convert(const void *_src, PixelFormat _srcFormat,
+    void *_dst, PixelFormat _dstFormat, unsigned int _count)
+{
+  if ((!_src || !_dst) && _count > 0u)
+  {
+    ignerr << "Unable to convert null pixels" << std::endl;
+    return false;
+  }
+
+  if (_srcFormat == _dstFormat && PixelUtil::IsValid(_srcFormat))
+  {
+    std::memmove(_dst, _src, PixelUtil::MemorySize(_srcFormat, _count, 1u));
+    return true;
+  }
+
+  const uint8_t *srcBytes = static_cast<const uint8_t *>(_src);
+  const float *srcFloats = static_cast<const float *>(_src);
+  if ((_srcFormat == PF_R8G8B8 && _dstFormat == PF_B8G8R8) ||
+      (_srcFormat == PF_B8G8R8 && _dstFormat == PF_R8G8B8))
+  {
+    swapRedBlue(srcBytes, static_cast<uint8_t *>(_dst), _count);
+  }
+  else if (_srcFormat == PF_L8 && _dstFormat == PF_L16)
+  {
+    widenL8(srcBytes, static_cast<uint16_t *>(_dst), _count);
+  }
+  else if (_srcFormat == PF_FLOAT32_RGBA && _dstFormat == PF_FLOAT32_RGB)
+  {
+    dropAlpha(srcFloats, static_cast<float *>(_dst), _count);
+  }
+  else if (_srcFormat == PF_FLOAT32_RGBA && _dstFormat == PF_FLOAT32_R)
+  {
+    firstChannel(srcFloats, static_cast<float *>(_dst), _count);
+  }
+  else if (_srcFormat == PF_FLOAT32_RGB && _dstFormat == PF_R8G8B8)
+  {
+    quantizeFloats(srcFloats, static_cast<uint8_t *>(_dst), _count * 3u);
+  }
+  else if (_srcFormat == PF_FLOAT32_R && _dstFormat == PF_L16)
+  {
+    depthToMillimeters(srcFloats, static_cast<uint16_t *>(_dst), _count);
+  }
+  else if (_srcFormat == PF_FLOAT32_R && _dstFormat == PF_FLOAT16_R)
+  {
+    floatsToHalves(srcFloats, static_cast<uint16_t *>(_dst), _count);
+  }
+  else if (_srcFormat == PF_FLOAT16_R && _dstFormat == PF_FLOAT32_R)
+  {
+    halvesToFloats(static_cast<const uint16_t *>(_src),
+        static_cast<float *>(_dst), _count);
+  }
+  else
+  {
+    ignerr << "Unsupported pixel conversion from "
+           << PixelUtil::Name(_srcFormat) << " to "
+           << PixelUtil::Name(_dstFormat) << std::endl;
+    return false;
+  }
+  return true;
+}
@@ -17,6 +17,11 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
 #include "test_config.h"  // NOLINT(build/include)
 
 #include "ignition/rendering/PixelFormat.hh"
@@ -51,6 +56,149 @@ TEST(PixelFormatTest, PixelUtil)
   EXPECT_EQ(2u, PixelUtil::BytesPerPixel(format));
   EXPECT_EQ(2u, PixelUtil::BytesPerChannel(format));
   EXPECT_EQ(2048u, PixelUtil::MemorySize(format, 32, 32));
+
+  format = PF_FLOAT16_R;
+  EXPECT_EQ(2u, PixelUtil::BytesPerPixel(format));
+  EXPECT_EQ(2u, PixelUtil::BytesPerChannel(format));
+  EXPECT_EQ("FLOAT16_R", PixelUtil::Name(format));
+  EXPECT_EQ(format, PixelUtil::Enum("FLOAT16_R"));
+
+  format = PF_BAYER_RGGB8;
+  EXPECT_TRUE(PixelUtil::IsBayer(format));
+  EXPECT_EQ(1u, PixelUtil::BytesPerPixel(format));
+  EXPECT_EQ(1u, PixelUtil::BytesPerChannel(format));
+  EXPECT_EQ(1024u, PixelUtil::MemorySize(format, 32, 32));
+  EXPECT_TRUE(PixelUtil::IsBayer(PF_BAYER_BGGR8));
+  EXPECT_TRUE(PixelUtil::IsBayer(PF_BAYER_GBGR8));
+  EXPECT_TRUE(PixelUtil::IsBayer(PF_BAYER_GRGB8));
+  EXPECT_FALSE(PixelUtil::IsBayer(PF_R8G8B8));
+  EXPECT_FALSE(PixelUtil::IsBayer(PF_L8));
+}
+
+/////////////////////////////////////////////////
+TEST(PixelFormatTest, Convert)
+{
+  // pixel counts not multiple of the vector widths exercise the scalar tails
+  const unsigned int count = 37u;
+
+  std::vector<uint8_t> rgb(count * 3u);
+  for (unsigned int i = 0u; i < rgb.size(); ++i)
+    rgb[i] = static_cast<uint8_t>(i * 7u);
+
+  // BGR swap, also in place
+  std::vector<uint8_t> bgr(count * 3u);
+  EXPECT_TRUE(PixelUtil::Convert(rgb.data(), PF_R8G8B8, bgr.data(),
+      PF_B8G8R8, count));
+  for (unsigned int i = 0u; i < count; ++i)
+  {
+    EXPECT_EQ(rgb[i * 3u + 2u], bgr[i * 3u]);
+    EXPECT_EQ(rgb[i * 3u + 1u], bgr[i * 3u + 1u]);
+    EXPECT_EQ(rgb[i * 3u], bgr[i * 3u + 2u]);
+  }
+  std::vector<uint8_t> swapped = bgr;
+  EXPECT_TRUE(PixelUtil::Convert(swapped.data(), PF_B8G8R8, swapped.data(),
+      PF_R8G8B8, count));
+  EXPECT_EQ(rgb, swapped);
+
+  // 8-bit to 16-bit
+  std::vector<uint16_t> l16(count);
+  EXPECT_TRUE(PixelUtil::Convert(rgb.data(), PF_L8, l16.data(), PF_L16,
+      count));
+  for (unsigned int i = 0u; i < count; ++i)
+    EXPECT_EQ(rgb[i], l16[i]);
+
+  // RGBA to RGB and to the first channel
+  std::vector<float> rgba(count * 4u);
+  for (unsigned int i = 0u; i < rgba.size(); ++i)
+    rgba[i] = i * 0.5f;
+  std::vector<float> rgbFloat(count * 3u);
+  std::vector<float> first(count);
+  EXPECT_TRUE(PixelUtil::Convert(rgba.data(), PF_FLOAT32_RGBA,
+      rgbFloat.data(), PF_FLOAT32_RGB, count));
+  EXPECT_TRUE(PixelUtil::Convert(rgba.data(), PF_FLOAT32_RGBA,
+      first.data(), PF_FLOAT32_R, count));
+  for (unsigned int i = 0u; i < count; ++i)
+  {
+    EXPECT_FLOAT_EQ(rgba[i * 4u], rgbFloat[i * 3u]);
+    EXPECT_FLOAT_EQ(rgba[i * 4u + 1u], rgbFloat[i * 3u + 1u]);
+    EXPECT_FLOAT_EQ(rgba[i * 4u + 2u], rgbFloat[i * 3u + 2u]);
+    EXPECT_FLOAT_EQ(rgba[i * 4u], first[i]);
+  }
+
+  // float RGB to 8-bit RGB, clamped and truncated
+  for (unsigned int i = 0u; i < rgbFloat.size(); ++i)
+    rgbFloat[i] = i * 0.01f - 0.2f;
+  rgbFloat[5] = std::numeric_limits<float>::quiet_NaN();
+  std::vector<uint8_t> quantized(count * 3u);
+  EXPECT_TRUE(PixelUtil::Convert(rgbFloat.data(), PF_FLOAT32_RGB,
+      quantized.data(), PF_R8G8B8, count));
+  for (unsigned int i = 0u; i < quantized.size(); ++i)
+  {
+    float value = 255.0f * rgbFloat[i];
+    uint8_t expected = 0u;
+    if (value > 255.0f)
+      expected = 255u;
+    else if (value > 0.0f)
+      expected = static_cast<uint8_t>(value);
+    EXPECT_EQ(expected, quantized[i]) << i;
+  }
+
+  // depth in meters to millimeters, invalid values set to 0
+  std::vector<float> depth(count);
+  for (unsigned int i = 0u; i < count; ++i)
+    depth[i] = i * 0.9f - 3.0f;
+  depth[0] = std::numeric_limits<float>::infinity();
+  depth[1] = std::numeric_limits<float>::quiet_NaN();
+  depth[2] = 65.534f;
+  depth[3] = 1.2346f;
+  std::vector<uint16_t> millimeters(count);
+  EXPECT_TRUE(PixelUtil::Convert(depth.data(), PF_FLOAT32_R,
+      millimeters.data(), PF_L16, count));
+  EXPECT_EQ(0u, millimeters[0]);
+  EXPECT_EQ(0u, millimeters[1]);
+  EXPECT_EQ(65534u, millimeters[2]);
+  EXPECT_EQ(1235u, millimeters[3]);
+  for (unsigned int i = 4u; i < count; ++i)
+  {
+    float mm = depth[i] * 1000.0f;
+    uint16_t expected = mm >= 0.0f && mm <= 65535.0f ?
+        static_cast<uint16_t>(mm + 0.5f) : 0u;
+    EXPECT_EQ(expected, millimeters[i]) << i;
+  }
+
+  // depth to half floats and back
+  std::vector<uint16_t> halves(count);
+  std::vector<float> widened(count);
+  depth[2] = 70000.0f;
+  depth[3] = 1.0f / 65536.0f;
+  EXPECT_TRUE(PixelUtil::Convert(depth.data(), PF_FLOAT32_R,
+      halves.data(), PF_FLOAT16_R, count));
+  EXPECT_EQ(0x7C00u, halves[0]);
+  EXPECT_EQ(0x7C00u, halves[2]);
+  EXPECT_EQ(0x0100u, halves[3]);
+  EXPECT_TRUE(PixelUtil::Convert(halves.data(), PF_FLOAT16_R,
+      widened.data(), PF_FLOAT32_R, count));
+  EXPECT_TRUE(std::isinf(widened[0]));
+  EXPECT_TRUE(std::isnan(widened[1]));
+  EXPECT_TRUE(std::isinf(widened[2]));
+  EXPECT_FLOAT_EQ(depth[3], widened[3]);
+  for (unsigned int i = 4u; i < count; ++i)
+  {
+    // 11 significant bits
+    EXPECT_NEAR(depth[i], widened[i], std::abs(depth[i]) / 2048.0f) << i;
+  }
+
+  // copies between identical formats
+  std::vector<uint8_t> copy(count * 3u);
+  EXPECT_TRUE(PixelUtil::Convert(rgb.data(), PF_R8G8B8, copy.data(),
+      PF_R8G8B8, count));
+  EXPECT_EQ(rgb, copy);
+
+  // unsupported conversions and null pixels
+  EXPECT_FALSE(PixelUtil::Convert(rgb.data(), PF_R8G8B8, l16.data(),
+      PF_L16, count));
+  EXPECT_FALSE(PixelUtil::Convert(nullptr, PF_L8, l16.data(), PF_L16,
+      count));
 }
 
 int main(int argc, char **argv)
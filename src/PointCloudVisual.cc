@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cstdint>
+#include <cstring>
+
+#include "ignition/rendering/PointCloudVisual.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+/// \brief Convert a half precision float to single precision
+/// \param[in] _half Bits of the half precision float
+/// \return Single precision value
+static float HalfToFloat(uint16_t _half)
+{
+  uint32_t sign = static_cast<uint32_t>(_half & 0x8000u) << 16;
+  uint32_t exponent = (_half >> 10) & 0x1fu;
+  uint32_t mantissa = _half & 0x3ffu;
+
+  uint32_t bits;
+  if (exponent == 0u)
+  {
+    if (mantissa == 0u)
+    {
+      bits = sign;
+    }
+    else
+    {
+      // subnormal, normalize it
+      exponent = 127u - 15u + 1u;
+      while (!(mantissa & 0x400u))
+      {
+        mantissa <<= 1;
+        --exponent;
+      }
+      mantissa &= 0x3ffu;
+      bits = sign | (exponent << 23) | (mantissa << 13);
+    }
+  }
+  else if (exponent == 0x1fu)
+  {
+    // infinity or nan
+    bits = sign | 0x7f800000u | (mantissa << 13);
+  }
+  else
+  {
+    bits = sign | ((exponent + 127u - 15u) << 23) | (mantissa << 13);
+  }
+
+  float result;
+  std::memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+//////////////////////////////////////////////////
+PointCloudVisual::PointCloudVisual()
+{
+}
+
+//////////////////////////////////////////////////
+PointCloudVisual::~PointCloudVisual()
+{
+}
+
+//////////////////////////////////////////////////
+unsigned int PointCloudVisual::PointSize(PointCloudFormat _format)
+{
+  switch (_format)
+  {
+    case PCF_XYZ_FLOAT16:
+      return 3u * sizeof(uint16_t);
+    case PCF_XYZ_FLOAT32:
+    default:
+      return 3u * sizeof(float);
+  }
+}
+
+//////////////////////////////////////////////////
+bool PointCloudVisual::DecodePoints(const void *_data, unsigned int _count,
+    PointCloudFormat _format, unsigned int _stride, float *_xyz)
+{
+  if (_count == 0u)
+    return true;
+
+  unsigned int pointSize = PointSize(_format);
+  if (_stride == 0u)
+    _stride = pointSize;
+
+  if (!_data || !_xyz || _stride < pointSize)
+    return false;
+
+  const unsigned char *src = static_cast<const unsigned char *>(_data);
+  switch (_format)
+  {
+    case PCF_XYZ_FLOAT16:
+    {
+      for (unsigned int i = 0u; i < _count; ++i)
+      {
+        uint16_t half[3];
+        std::memcpy(half, src + static_cast<size_t>(i) * _stride,
+            sizeof(half));
+        _xyz[i * 3u] = HalfToFloat(half[0]);
+        _xyz[i * 3u + 1u] = HalfToFloat(half[1]);
+        _xyz[i * 3u + 2u] = HalfToFloat(half[2]);
+      }
+      break;
+    }
+    case PCF_XYZ_FLOAT32:
+    default:
+    {
+      if (_stride == pointSize)
+      {
+        std::memcpy(_xyz, src, static_cast<size_t>(_count) * pointSize);
+        break;
+      }
+      for (unsigned int i = 0u; i < _count; ++i)
+      {
+        std::memcpy(_xyz + i * 3u, src + static_cast<size_t>(i) * _stride,
+            pointSize);
+      }
+      break;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/rendering/PointCloudVisual.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+class PointCloudVisualTest : public testing::Test,
+                   public testing::WithParamInterface<const char *>
+{
+  public: void PointCloudVisual(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+TEST(PointCloudDecodeTest, Decode)
+{
+  EXPECT_EQ(12u, PointCloudVisual::PointSize(PCF_XYZ_FLOAT32));
+  EXPECT_EQ(6u, PointCloudVisual::PointSize(PCF_XYZ_FLOAT16));
+
+  // packed floats
+  std::vector<float> xyz{1.0f, 2.0f, 3.0f, -4.0f, 5.5f, 0.25f};
+  std::vector<float> result(6u);
+  EXPECT_TRUE(PointCloudVisual::DecodePoints(xyz.data(), 2u,
+      PCF_XYZ_FLOAT32, 0u, result.data()));
+  EXPECT_EQ(xyz, result);
+
+  // floats with a color after each point
+  std::vector<float> xyzrgba{1.0f, 2.0f, 3.0f, 0.1f, 0.2f, 0.3f, 0.4f,
+                             -4.0f, 5.5f, 0.25f, 0.1f, 0.2f, 0.3f, 0.4f};
+  result.assign(6u, 0.0f);
+  EXPECT_TRUE(PointCloudVisual::DecodePoints(xyzrgba.data(), 2u,
+      PCF_XYZ_FLOAT32, 7u * sizeof(float), result.data()));
+  EXPECT_EQ(xyz, result);
+
+  // half floats: 1, 2, 3, -4, 5.5, 0.25 and the smallest subnormal
+  std::vector<uint16_t> half{0x3c00, 0x4000, 0x4200, 0xc400, 0x4580, 0x3400,
+                             0x0001, 0x0000, 0x8000};
+  result.assign(9u, 0.0f);
+  EXPECT_TRUE(PointCloudVisual::DecodePoints(half.data(), 3u,
+      PCF_XYZ_FLOAT16, 0u, result.data()));
+  for (unsigned int i = 0; i < 6u; ++i)
+    EXPECT_FLOAT_EQ(xyz[i], result[i]);
+  EXPECT_FLOAT_EQ(5.9604645e-08f, result[6]);
+  EXPECT_FLOAT_EQ(0.0f, result[7]);
+  EXPECT_FLOAT_EQ(0.0f, result[8]);
+
+  // invalid data
+  EXPECT_TRUE(PointCloudVisual::DecodePoints(nullptr, 0u, PCF_XYZ_FLOAT32,
+      0u, result.data()));
+  EXPECT_FALSE(PointCloudVisual::DecodePoints(nullptr, 2u, PCF_XYZ_FLOAT32,
+      0u, result.data()));
+  EXPECT_FALSE(PointCloudVisual::DecodePoints(xyz.data(), 2u,
+      PCF_XYZ_FLOAT32, 4u, result.data()));
+}
+
+/////////////////////////////////////////////////
+void PointCloudVisualTest::PointCloudVisual(const std::string &_renderEngine)
+{
+  if (_renderEngine != "ogre2")
+  {
+    igndbg << "PointCloudVisual not supported yet in rendering engine: "
+            << _renderEngine << std::endl;
+    return;
+  }
+
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+           << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  VisualPtr root = scene->RootVisual();
+
+  PointCloudVisualPtr cloud = scene->CreatePointCloudVisual();
+  ASSERT_NE(nullptr, cloud);
+  root->AddChild(cloud);
+  EXPECT_EQ(1u, root->ChildCount());
+
+  // check API
+  cloud->SetChunkSize(1000u);
+  EXPECT_EQ(1024u, cloud->ChunkSize());
+  cloud->SetChunkSize(1u);
+  EXPECT_EQ(256u, cloud->ChunkSize());
+
+  cloud->SetUploadBudget(512u);
+  EXPECT_EQ(512u, cloud->UploadBudget());
+  cloud->SetLodLevels(2u);
+  EXPECT_EQ(2u, cloud->LodLevels());
+  cloud->SetPointSpacing(0.01);
+  EXPECT_DOUBLE_EQ(0.01, cloud->PointSpacing());
+  cloud->SetPointSpacing(-1.0);
+  EXPECT_DOUBLE_EQ(0.01, cloud->PointSpacing());
+
+  // 1000 points in 4 chunks
+  std::vector<float> xyz(1000u * 3u);
+  for (unsigned int i = 0; i < 1000u; ++i)
+  {
+    xyz[i * 3u] = static_cast<float>(i);
+    xyz[i * 3u + 1u] = 1.0f;
+    xyz[i * 3u + 2u] = -1.0f;
+  }
+  cloud->SetPoints(xyz.data(), 1000u);
+  EXPECT_EQ(1000u, cloud->PointCount());
+  EXPECT_EQ(4u, cloud->ChunkCount());
+  EXPECT_EQ(4u, cloud->PendingChunkCount());
+  EXPECT_EQ(math::Vector3d(999, 1, -1), cloud->Point(999u));
+  EXPECT_EQ(math::Vector3d(math::INF_D, math::INF_D, math::INF_D),
+      cloud->Point(1000u));
+
+  // uploads are limited by the budget, but at least one chunk per frame
+  cloud->Update();
+  EXPECT_EQ(2u, cloud->PendingChunkCount());
+  cloud->SetUploadBudget(0u);
+  cloud->Update();
+  EXPECT_EQ(1u, cloud->PendingChunkCount());
+  cloud->SetUploadBudget(1000000u);
+  cloud->Update();
+  EXPECT_EQ(0u, cloud->PendingChunkCount());
+
+  // updating points only uploads the chunks they are in
+  std::vector<float> update{5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f};
+  cloud->UpdatePoints(255u, update.data(), 2u);
+  EXPECT_EQ(2u, cloud->PendingChunkCount());
+  EXPECT_EQ(math::Vector3d(8, 9, 10), cloud->Point(256u));
+  cloud->Update();
+  EXPECT_EQ(0u, cloud->PendingChunkCount());
+
+  // appending points
+  cloud->UpdatePoints(1000u, update.data(), 2u);
+  EXPECT_EQ(1002u, cloud->PointCount());
+  EXPECT_EQ(1u, cloud->PendingChunkCount());
+
+  // offset past the end is rejected
+  cloud->UpdatePoints(2000u, update.data(), 2u);
+  EXPECT_EQ(1002u, cloud->PointCount());
+  cloud->Update();
+
+  cloud->ClearPoints();
+  EXPECT_EQ(0u, cloud->PointCount());
+  EXPECT_EQ(0u, cloud->ChunkCount());
+  cloud->Update();
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(PointCloudVisualTest, PointCloudVisual)
+{
+  PointCloudVisual(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(PointCloudVisual, PointCloudVisualTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cmath>
+
+#include <ignition/math/Helpers.hh>
+
+#include "ignition/rendering/PoseArrayVisual.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Number of sides of the shaft and head of an arrow
+static const unsigned int kArrowSides = 8u;
+
+//////////////////////////////////////////////////
+PoseArrayVisual::PoseArrayVisual()
+{
+}
+
+//////////////////////////////////////////////////
+PoseArrayVisual::~PoseArrayVisual()
+{
+}
+
+//////////////////////////////////////////////////
+unsigned int PoseArrayVisual::ArrowVertexCount()
+{
+  // two triangles per side of the shaft, one per side of the head and one
+  // per side of the base of the head
+  return kArrowSides * 4u * 3u;
+}
+
+//////////////////////////////////////////////////
+void PoseArrayVisual::AppendArrow(const math::Pose3d &_pose,
+    double _length, std::vector<float> &_xyz)
+{
+  // same proportions as ArrowVisual: the shaft is two thirds of the arrow
+  // and half as wide as the head
+  const double shaftLength = _length * 2.0 / 3.0;
+  const double shaftRadius = _length / 30.0;
+  const double headRadius = _length / 15.0;
+
+  auto append = [&](const math::Vector3d &_v)
+  {
+    math::Vector3d v = _pose.Pos() + _pose.Rot().RotateVector(_v);
+    _xyz.push_back(static_cast<float>(v.X()));
+    _xyz.push_back(static_cast<float>(v.Y()));
+    _xyz.push_back(static_cast<float>(v.Z()));
+  };
+
+  _xyz.reserve(_xyz.size() + ArrowVertexCount() * 3u);
+  const math::Vector3d tip(0, 0, _length);
+  const math::Vector3d headCenter(0, 0, shaftLength);
+  for (unsigned int i = 0; i < kArrowSides; ++i)
+  {
+    double a0 = 2.0 * IGN_PI * i / kArrowSides;
+    double a1 = 2.0 * IGN_PI * (i + 1u) / kArrowSides;
+    math::Vector3d d0(std::cos(a0), std::sin(a0), 0);
+    math::Vector3d d1(std::cos(a1), std::sin(a1), 0);
+
+    // shaft side, counter clockwise seen from outside
+    math::Vector3d b0 = d0 * shaftRadius;
+    math::Vector3d b1 = d1 * shaftRadius;
+    math::Vector3d t0 = b0 + headCenter;
+    math::Vector3d t1 = b1 + headCenter;
+    append(b0);
+    append(b1);
+    append(t1);
+    append(b0);
+    append(t1);
+    append(t0);
+
+    // head side
+    math::Vector3d h0 = d0 * headRadius + headCenter;
+    math::Vector3d h1 = d1 * headRadius + headCenter;
+    append(h0);
+    append(h1);
+    append(tip);
+
+    // base of the head, facing down
+    append(headCenter);
+    append(h1);
+    append(h0);
+  }
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/math/Helpers.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/rendering/Marker.hh"
+#include "ignition/rendering/PoseArrayVisual.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+class PoseArrayVisualTest : public testing::Test,
+                   public testing::WithParamInterface<const char *>
+{
+  public: void PoseArrayVisual(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+TEST(PoseArrayArrowTest, AppendArrow)
+{
+  std::vector<float> xyz{1.0f, 2.0f, 3.0f};
+  PoseArrayVisual::AppendArrow(math::Pose3d::Zero, 3.0, xyz);
+  ASSERT_EQ(3u + PoseArrayVisual::ArrowVertexCount() * 3u, xyz.size());
+
+  // existing vertices are kept
+  EXPECT_FLOAT_EQ(1.0f, xyz[0]);
+  EXPECT_FLOAT_EQ(2.0f, xyz[1]);
+  EXPECT_FLOAT_EQ(3.0f, xyz[2]);
+
+  // the arrow points along z, as wide as a fifteenth of its length
+  math::Vector3d min(math::INF_D, math::INF_D, math::INF_D);
+  math::Vector3d max = -min;
+  for (size_t i = 3u; i < xyz.size(); i += 3u)
+  {
+    math::Vector3d v(xyz[i], xyz[i + 1u], xyz[i + 2u]);
+    min.Min(v);
+    max.Max(v);
+  }
+  EXPECT_NEAR(0.0, min.Z(), 1e-6);
+  EXPECT_NEAR(3.0, max.Z(), 1e-6);
+  EXPECT_NEAR(0.2, max.X(), 1e-6);
+  EXPECT_NEAR(-0.2, min.X(), 1e-6);
+
+  // arrows are moved to the pose, and rotated with it
+  xyz.clear();
+  math::Pose3d pose(1, 2, 3, 0, IGN_PI / 2, 0);
+  PoseArrayVisual::AppendArrow(pose, 1.0, xyz);
+  ASSERT_EQ(PoseArrayVisual::ArrowVertexCount() * 3u, xyz.size());
+  double maxX = -math::INF_D;
+  for (size_t i = 0u; i < xyz.size(); i += 3u)
+  {
+    maxX = std::max(maxX, static_cast<double>(xyz[i]));
+    EXPECT_NEAR(3.0, xyz[i + 2u], 1.0 / 15.0 + 1e-6);
+  }
+  EXPECT_NEAR(2.0, maxX, 1e-6);
+}
+
+/////////////////////////////////////////////////
+void PoseArrayVisualTest::PoseArrayVisual(const std::string &_renderEngine)
+{
+  if (_renderEngine != "ogre" && _renderEngine != "ogre2")
+  {
+    igndbg << "PoseArrayVisual not supported yet in rendering engine: "
+            << _renderEngine << std::endl;
+    return;
+  }
+
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+           << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  VisualPtr root = scene->RootVisual();
+
+  PoseArrayVisualPtr visual = scene->CreatePoseArrayVisual();
+  ASSERT_NE(nullptr, visual);
+  root->AddChild(visual);
+
+  // one geometry per axis, whatever the number of poses
+  EXPECT_EQ(3u, visual->GeometryCount());
+  EXPECT_TRUE(visual->Poses().empty());
+  EXPECT_DOUBLE_EQ(1.0, visual->AxisLength());
+  EXPECT_FALSE(visual->ArrowsOnly());
+
+  std::vector<math::Pose3d> poses;
+  for (unsigned int i = 0; i < 100u; ++i)
+    poses.push_back(math::Pose3d(i, 0, 0, 0, 0, i * 0.1));
+  visual->SetPoses(poses);
+  EXPECT_EQ(poses, visual->Poses());
+  visual->SetAxisLength(0.5);
+  EXPECT_DOUBLE_EQ(0.5, visual->AxisLength());
+  EXPECT_NO_THROW(scene->PreRender());
+  EXPECT_EQ(3u, visual->GeometryCount());
+
+  for (unsigned int i = 0; i < 3u; ++i)
+  {
+    MarkerPtr marker =
+        std::dynamic_pointer_cast<Marker>(visual->GeometryByIndex(i));
+    ASSERT_NE(nullptr, marker);
+    EXPECT_EQ(MT_TRIANGLE_LIST, marker->Type());
+  }
+
+  visual->SetArrowsOnly(true);
+  EXPECT_TRUE(visual->ArrowsOnly());
+  EXPECT_NO_THROW(scene->PreRender());
+
+  visual->SetPoses({});
+  EXPECT_TRUE(visual->Poses().empty());
+  EXPECT_NO_THROW(scene->PreRender());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(PoseArrayVisualTest, PoseArrayVisual)
+{
+  PoseArrayVisual(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(PoseArrayVisual, PoseArrayVisualTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
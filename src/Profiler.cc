@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <atomic>
+
+#include "ignition/rendering/Profiler.hh"
+
+namespace ignition
+{
+namespace rendering
+{
+inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+//
+namespace
+{
+  /// \brief Hooks called by the zones. Set while nothing renders, read
+  /// from any thread rendering or dispatching frames.
+  std::atomic<ProfilerBeginHook> gBeginHook{nullptr};
+  std::atomic<ProfilerEndHook> gEndHook{nullptr};
+  std::atomic<void *> gUserData{nullptr};
+}
+
+//////////////////////////////////////////////////
+void setProfilerHooks(ProfilerBeginHook _begin, ProfilerEndHook _end,
+    void *_userData)
+{
+  // a zone needs both hooks, or its end would be lost
+  if (!_begin || !_end)
+  {
+    _begin = nullptr;
+    _end = nullptr;
+    _userData = nullptr;
+  }
+
+  gUserData = _userData;
+  gEndHook = _end;
+  gBeginHook = _begin;
+}
+
+//////////////////////////////////////////////////
+bool profilerZonesEnabled()
+{
+#ifdef IGN_RENDERING_PROFILER_ENABLE
+  return true;
+#else
+  return false;
+#endif
+}
+
+//////////////////////////////////////////////////
+void beginProfilerZone(const char *_name)
+{
+  ProfilerBeginHook hook = gBeginHook;
+  if (hook)
+    hook(_name, gUserData);
+}
+
+//////////////////////////////////////////////////
+void endProfilerZone()
+{
+  ProfilerEndHook hook = gEndHook;
+  if (hook)
+    hook(gUserData);
+}
+}
+}
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/Profiler.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Zones begun and not ended yet, in order
+static std::vector<std::string> gOpenZones;
+
+/// \brief Names of the zones that ended, in order
+static std::vector<std::string> gEndedZones;
+
+/////////////////////////////////////////////////
+void BeginHook(const char *_name, void *_userData)
+{
+  EXPECT_EQ(&gOpenZones, _userData);
+  gOpenZones.push_back(_name);
+}
+
+/////////////////////////////////////////////////
+void EndHook(void *_userData)
+{
+  EXPECT_EQ(&gOpenZones, _userData);
+  ASSERT_FALSE(gOpenZones.empty());
+  gEndedZones.push_back(gOpenZones.back());
+  gOpenZones.pop_back();
+}
+
+/////////////////////////////////////////////////
+TEST(ProfilerTest, Zones)
+{
+#ifdef IGN_RENDERING_PROFILER_ENABLE
+  EXPECT_TRUE(profilerZonesEnabled());
+#else
+  EXPECT_FALSE(profilerZonesEnabled());
+#endif
+
+  // no hooks, nothing is called
+  {
+    ProfilerZone zone("none");
+  }
+  EXPECT_TRUE(gEndedZones.empty());
+
+  // zones nest
+  setProfilerHooks(&BeginHook, &EndHook, &gOpenZones);
+  {
+    ProfilerZone outer("outer");
+    {
+      ProfilerZone inner("inner");
+      ASSERT_EQ(2u, gOpenZones.size());
+      EXPECT_EQ("inner", gOpenZones.back());
+    }
+  }
+  EXPECT_TRUE(gOpenZones.empty());
+  ASSERT_EQ(2u, gEndedZones.size());
+  EXPECT_EQ("inner", gEndedZones[0]);
+  EXPECT_EQ("outer", gEndedZones[1]);
+
+  // the macro only calls the hooks when the zones are compiled in
+  {
+    IGN_RENDERING_PROFILE("macro");
+  }
+  EXPECT_EQ(profilerZonesEnabled() ? 3u : 2u, gEndedZones.size());
+
+  // hooks are removed unless both are given
+  setProfilerHooks(&BeginHook, nullptr);
+  {
+    ProfilerZone zone("removed");
+  }
+  EXPECT_TRUE(gOpenZones.empty());
+  EXPECT_EQ(profilerZonesEnabled() ? 3u : 2u, gEndedZones.size());
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ignition/rendering/RawHeightmapTileSource.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/math/Helpers.hh>
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+class ignition::rendering::RawHeightmapTileSourcePrivate
+{
+  /// \brief Heightmap file
+  public: mutable std::ifstream file;
+
+  /// \brief Protects the file, heights are read from background threads
+  public: mutable std::mutex mutex;
+
+  /// \brief Number of samples along a side
+  public: unsigned int sampleCount{0u};
+};
+
+//////////////////////////////////////////////////
+RawHeightmapTileSource::RawHeightmapTileSource()
+  : dataPtr(new RawHeightmapTileSourcePrivate)
+{
+}
+
+//////////////////////////////////////////////////
+RawHeightmapTileSource::~RawHeightmapTileSource() = default;
+
+//////////////////////////////////////////////////
+bool RawHeightmapTileSource::Load(const std::string &_filename,
+    unsigned int _sampleCount)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->file.close();
+  this->dataPtr->sampleCount = 0u;
+
+  if (_sampleCount < 2u || !math::isPowerOfTwo(_sampleCount - 1u))
+  {
+    ignerr << "Raw heightmap must have 2^n+1 samples along a side, got ["
+           << _sampleCount << "]" << std::endl;
+    return false;
+  }
+
+  this->dataPtr->file.open(_filename, std::ios::in | std::ios::binary);
+  if (!this->dataPtr->file.is_open())
+  {
+    ignerr << "Unable to open raw heightmap [" << _filename << "]"
+           << std::endl;
+    return false;
+  }
+
+  this->dataPtr->file.seekg(0, std::ios::end);
+  std::streamoff size = this->dataPtr->file.tellg();
+  std::streamoff expected = static_cast<std::streamoff>(_sampleCount) *
+      _sampleCount * static_cast<std::streamoff>(sizeof(float));
+  if (size != expected)
+  {
+    ignerr << "Raw heightmap [" << _filename << "] has " << size
+           << " bytes, expected " << expected << std::endl;
+    this->dataPtr->file.close();
+    return false;
+  }
+
+  this->dataPtr->sampleCount = _sampleCount;
+  return true;
+}
+
+//////////////////////////////////////////////////
+unsigned int RawHeightmapTileSource::SampleCount() const
+{
+  return this->dataPtr->sampleCount;
+}
+
+//////////////////////////////////////////////////
+bool RawHeightmapTileSource::Heights(int _x, int _y, unsigned int _stride,
+    unsigned int _count, std::vector<float> &_heights) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  int last = static_cast<int>(this->dataPtr->sampleCount) - 1;
+  if (last < 0 || _stride == 0u)
+    return false;
+
+  auto clamp = [last](int _v)
+  {
+    return std::max(0, std::min(_v, last));
+  };
+
+  std::ifstream &file = this->dataPtr->file;
+  file.clear();
+  _heights.resize(static_cast<size_t>(_count) * _count);
+  int stride = static_cast<int>(_stride);
+  std::vector<float> row;
+  for (unsigned int j = 0u; j < _count; ++j)
+  {
+    std::streamoff rowStart = static_cast<std::streamoff>(
+        clamp(_y + static_cast<int>(j) * stride)) * (last + 1);
+    float *dst = _heights.data() + static_cast<size_t>(j) * _count;
+
+    // contiguous samples are read with one read per row
+    if (_stride == 1u)
+    {
+      int x0 = clamp(_x);
+      int x1 = clamp(_x + static_cast<int>(_count) - 1);
+      row.resize(static_cast<size_t>(x1 - x0 + 1));
+      file.seekg((rowStart + x0) * static_cast<std::streamoff>(sizeof(float)));
+      file.read(reinterpret_cast<char *>(row.data()),
+          static_cast<std::streamsize>(row.size() * sizeof(float)));
+      for (unsigned int i = 0u; i < _count; ++i)
+        dst[i] = row[clamp(_x + static_cast<int>(i)) - x0];
+    }
+    else
+    {
+      for (unsigned int i = 0u; i < _count; ++i)
+      {
+        int x = clamp(_x + static_cast<int>(i) * stride);
+        file.seekg((rowStart + x) * static_cast<std::streamoff>(sizeof(float)));
+        file.read(reinterpret_cast<char *>(dst + i), sizeof(float));
+      }
+    }
+
+    if (!file)
+    {
+      ignerr << "Failed to read raw heightmap samples" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Filesystem.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/RawHeightmapTileSource.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(RawHeightmapTileSourceTest, Heights)
+{
+  // 5x5 samples, the height of a sample is 10 * y + x
+  const unsigned int count = 5u;
+  std::vector<float> heights;
+  for (unsigned int y = 0u; y < count; ++y)
+  {
+    for (unsigned int x = 0u; x < count; ++x)
+      heights.push_back(static_cast<float>(10u * y + x));
+  }
+
+  std::string filename = common::joinPaths(PROJECT_BUILD_PATH,
+      "raw_heightmap_tile_source_test.raw");
+  {
+    std::ofstream file(filename, std::ios::out | std::ios::binary);
+    file.write(reinterpret_cast<const char *>(heights.data()),
+        static_cast<std::streamsize>(heights.size() * sizeof(float)));
+  }
+
+  RawHeightmapTileSource source;
+  EXPECT_EQ(0u, source.SampleCount());
+  std::vector<float> result;
+  EXPECT_FALSE(source.Heights(0, 0, 1u, 2u, result));
+
+  // invalid sizes
+  EXPECT_FALSE(source.Load(filename, 4u));
+  EXPECT_FALSE(source.Load(filename, 9u));
+  EXPECT_FALSE(source.Load(filename + ".missing", 5u));
+
+  ASSERT_TRUE(source.Load(filename, count));
+  EXPECT_EQ(count, source.SampleCount());
+
+  // contiguous samples
+  ASSERT_TRUE(source.Heights(1, 2, 1u, 2u, result));
+  ASSERT_EQ(4u, result.size());
+  EXPECT_FLOAT_EQ(21.0f, result[0]);
+  EXPECT_FLOAT_EQ(22.0f, result[1]);
+  EXPECT_FLOAT_EQ(31.0f, result[2]);
+  EXPECT_FLOAT_EQ(32.0f, result[3]);
+
+  // every other sample, clamped to the edges
+  ASSERT_TRUE(source.Heights(-2, -2, 2u, 4u, result));
+  ASSERT_EQ(16u, result.size());
+  EXPECT_FLOAT_EQ(0.0f, result[0]);
+  EXPECT_FLOAT_EQ(0.0f, result[1]);
+  EXPECT_FLOAT_EQ(2.0f, result[2]);
+  EXPECT_FLOAT_EQ(4.0f, result[3]);
+  EXPECT_FLOAT_EQ(0.0f, result[4]);
+  EXPECT_FLOAT_EQ(22.0f, result[10]);
+  EXPECT_FLOAT_EQ(44.0f, result[15]);
+
+  // contiguous samples past the edge
+  ASSERT_TRUE(source.Heights(3, 4, 1u, 3u, result));
+  EXPECT_FLOAT_EQ(43.0f, result[0]);
+  EXPECT_FLOAT_EQ(44.0f, result[1]);
+  EXPECT_FLOAT_EQ(44.0f, result[2]);
+  EXPECT_FLOAT_EQ(44.0f, result[8]);
+
+  EXPECT_FALSE(source.Heights(0, 0, 0u, 2u, result));
+
+  std::remove(filename.c_str());
+}
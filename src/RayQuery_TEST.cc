@@ -17,6 +17,9 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 
 #include "test_config.h"  // NOLINT(build/include)
@@ -26,6 +29,7 @@
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/RenderingIface.hh"
 #include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
 
 using namespace ignition;
 using namespace rendering;
@@ -35,6 +39,9 @@ class RayQueryTest : public testing::Test,
 {
   /// \brief Test ray query basic API
   public: void RayQuery(const std::string &_renderEngine);
+
+  /// \brief Test batched ray queries
+  public: void RayQueries(const std::string &_renderEngine);
 };
 
 /////////////////////////////////////////////////
@@ -105,12 +112,118 @@ void RayQueryTest::RayQuery(const std::string &_renderEngine)
   rendering::unloadEngine(engine->Name());
 }
 
+/////////////////////////////////////////////////
+void RayQueryTest::RayQueries(const std::string &_renderEngine)
+{
+  if (_renderEngine == "optix")
+  {
+    igndbg << "RayQuery not supported yet in rendering engine: "
+            << _renderEngine << std::endl;
+    return;
+  }
+
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  VisualPtr root = scene->RootVisual();
+
+  // unit box in front of the ray origins
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  box->SetWorldPosition(5.0, 0.0, 0.0);
+  root->AddChild(box);
+
+  // render once so that the scene graph is up to date
+  CameraPtr camera = scene->CreateCamera("camera");
+  root->AddChild(camera);
+  camera->Update();
+
+  RayQueryPtr rayQuery = scene->CreateRayQuery();
+  ASSERT_NE(nullptr, rayQuery);
+
+  // mismatched number of origins and directions
+  std::vector<math::Vector3d> origins(2u, math::Vector3d::Zero);
+  std::vector<math::Vector3d> directions(1u, math::Vector3d::UnitX);
+  EXPECT_TRUE(rayQuery->ClosestPoints(origins, directions).empty());
+
+  // empty batch
+  origins.clear();
+  directions.clear();
+  EXPECT_TRUE(rayQuery->ClosestPoints(origins, directions).empty());
+
+  // rays along x, spread across y. Only those with |y| < 0.5 hit the box
+  for (int i = -4; i <= 4; ++i)
+  {
+    origins.push_back(math::Vector3d(0.0, i * 0.2, 0.0));
+    directions.push_back(math::Vector3d::UnitX);
+  }
+  // ray pointing away from the box
+  origins.push_back(math::Vector3d::Zero);
+  directions.push_back(-math::Vector3d::UnitX);
+
+  rayQuery->SetOrigin(math::Vector3d(1, 2, 3));
+  rayQuery->SetDirection(math::Vector3d::UnitZ);
+  std::vector<RayQueryResult> results =
+      rayQuery->ClosestPoints(origins, directions);
+  ASSERT_EQ(origins.size(), results.size());
+
+  // the query's own ray is unchanged
+  EXPECT_EQ(math::Vector3d(1, 2, 3), rayQuery->Origin());
+  EXPECT_EQ(math::Vector3d::UnitZ, rayQuery->Direction());
+
+  for (unsigned int i = 0; i < results.size(); ++i)
+  {
+    bool expectHit = directions[i] == math::Vector3d::UnitX &&
+        std::abs(origins[i].Y()) < 0.5;
+    EXPECT_EQ(expectHit, static_cast<bool>(results[i])) << i;
+    if (!expectHit)
+      continue;
+    EXPECT_NEAR(4.5, results[i].distance, 1e-4);
+    EXPECT_TRUE(results[i].point.Equal(
+        math::Vector3d(4.5, origins[i].Y(), 0.0), 1e-4));
+    EXPECT_EQ(box->Id(), results[i].objectId);
+
+    // consistent with a single query
+    rayQuery->SetOrigin(origins[i]);
+    rayQuery->SetDirection(directions[i]);
+    RayQueryResult result = rayQuery->ClosestPoint();
+    EXPECT_NEAR(result.distance, results[i].distance, 1e-4);
+    EXPECT_EQ(result.objectId, results[i].objectId);
+  }
+
+  // large batch, evaluated in parallel
+  const unsigned int count = 10000u;
+  origins.assign(count, math::Vector3d::Zero);
+  directions.assign(count, math::Vector3d::UnitX);
+  for (unsigned int i = 0; i < count; ++i)
+    origins[i].Z() = (i % 2 == 0) ? 0.0 : 1.0;
+  results = rayQuery->ClosestPoints(origins, directions);
+  ASSERT_EQ(count, results.size());
+  for (unsigned int i = 0; i < count; ++i)
+    EXPECT_EQ(i % 2 == 0, static_cast<bool>(results[i])) << i;
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
 /////////////////////////////////////////////////
 TEST_P(RayQueryTest, RayQuery)
 {
   RayQuery(GetParam());
 }
 
+/////////////////////////////////////////////////
+TEST_P(RayQueryTest, RayQueries)
+{
+  RayQueries(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(RayQuery, RayQueryTest,
     RENDER_ENGINE_VALUES,
     ignition::rendering::PrintToStringParam());
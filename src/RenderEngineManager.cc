@@ -15,6 +15,8 @@
  *
  */
 
+#include <chrono>
+#include <future>
 #include <map>
 #include <mutex>
 
@@ -55,6 +57,14 @@ class ignition::rendering::RenderEngineManagerPrivate
       const std::map<std::string, std::string> &_params,
       const std::string &_path);
 
+  /// \brief Get a pointer to the render engine, loading its plugin if
+  /// needed, without loading the engine itself.
+  /// \param[in] _info Name and pointer of the engine
+  /// \param[in] _path Another search path for rendering engine plugin.
+  /// \return The engine, null if its plugin could not be loaded
+  public: RenderEngine *EnginePlugin(EngineInfo _info,
+      const std::string &_path);
+
   /// \brief Unload the given render engine from an EngineMap iterator.
   /// The engine will remain registered and can be loaded again later.
   /// \param[in] _iter EngineMap iterator
@@ -103,6 +113,14 @@ class ignition::rendering::RenderEngineManagerPrivate
 
   /// \brief Mutex to protect the engines map.
   public: std::recursive_mutex enginesMutex;
+
+  /// \brief Engines preloaded by name. Declared after the plugin loader so
+  /// that pending preloads complete before the plugins are unloaded.
+  public: std::map<std::string, std::shared_future<RenderEngine *>> preloads;
+
+  /// \brief Parameters of the preloaded engines by name
+  public: std::map<std::string, std::map<std::string, std::string>>
+      preloadParams;
 };
 
 using namespace ignition;
@@ -214,9 +232,44 @@ RenderEngine *RenderEngineManager::Engine(const std::string &_name,
     info.engine = iter->second;
   }
 
+  auto paramsIt = this->dataPtr->preloadParams.find(_name);
+  if (_params.empty() && paramsIt != this->dataPtr->preloadParams.end())
+    return this->dataPtr->Engine(info, paramsIt->second, _path);
+
   return this->dataPtr->Engine(info, _params, _path);
 }
 
+//////////////////////////////////////////////////
+std::shared_future<RenderEngine *> RenderEngineManager::PreloadEngine(
+    const std::string &_name,
+    const std::map<std::string, std::string> &_params,
+    const std::string &_path)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->enginesMutex);
+  auto it = this->dataPtr->preloads.find(_name);
+  if (it != this->dataPtr->preloads.end())
+    return it->second;
+
+  // the worker holds the engines mutex while loading the plugin, so calls
+  // made in the meantime wait for it, and load the plugin themselves if
+  // they run first
+  RenderEngineManagerPrivate *dataPtr = this->dataPtr.get();
+  std::shared_future<RenderEngine *> future = std::async(std::launch::async,
+      [dataPtr, _name, _path]()
+  {
+    std::lock_guard<std::recursive_mutex> workerLock(dataPtr->enginesMutex);
+    EngineInfo info{_name, nullptr};
+    auto iter = dataPtr->engines.find(_name);
+    if (iter != dataPtr->engines.end())
+      info.engine = iter->second;
+    return dataPtr->EnginePlugin(info, _path);
+  }).share();
+
+  this->dataPtr->preloads[_name] = future;
+  this->dataPtr->preloadParams[_name] = _params;
+  return future;
+}
+
 //////////////////////////////////////////////////
 RenderEngine *RenderEngineManager::EngineAt(unsigned int _index,
     const std::map<std::string, std::string> &_params,
@@ -355,6 +408,23 @@ void RenderEngineManager::SetPluginPaths(const std::list<std::string> &_paths)
 RenderEngine *RenderEngineManagerPrivate::Engine(EngineInfo _info,
     const std::map<std::string, std::string> &_params,
     const std::string &_path)
+{
+  RenderEngine *engine = this->EnginePlugin(_info, _path);
+  if (!engine)
+    return nullptr;
+
+  if (!engine->IsInitialized())
+  {
+    engine->Load(_params);
+    engine->Init();
+  }
+
+  return engine;
+}
+
+//////////////////////////////////////////////////
+RenderEngine *RenderEngineManagerPrivate::EnginePlugin(EngineInfo _info,
+    const std::string &_path)
 {
   RenderEngine *engine = _info.engine;
 
@@ -378,15 +448,6 @@ RenderEngine *RenderEngineManagerPrivate::Engine(EngineInfo _info,
     }
   }
 
-  if (!engine)
-    return nullptr;
-
-  if (!engine->IsInitialized())
-  {
-    engine->Load(_params);
-    engine->Init();
-  }
-
   return engine;
 }
 
@@ -398,6 +459,22 @@ bool RenderEngineManagerPrivate::UnloadEngine(EngineIter _iter)
   if (!engine)
     return false;
 
+  // forget the preloads of the engine, their futures would point to the
+  // unloaded engine
+  for (auto it = this->preloads.begin(); it != this->preloads.end();)
+  {
+    if (it->second.wait_for(std::chrono::seconds(0)) ==
+        std::future_status::ready && it->second.get() == engine)
+    {
+      this->preloadParams.erase(it->first);
+      it = this->preloads.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+
   engine->Destroy();
 
   return this->UnloadEnginePlugin(_iter->first);
@@ -23,6 +23,7 @@
 
 #include "ignition/rendering/Camera.hh"
 #include "ignition/rendering/GaussianNoisePass.hh"
+#include "ignition/rendering/Image.hh"
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/RenderingIface.hh"
 #include "ignition/rendering/RenderPassSystem.hh"
@@ -43,6 +44,9 @@ class RenderTargetTest : public testing::Test,
 
   /// \brief test adding and removing render passes
   public: void AddRemoveRenderPass(const std::string &_renderEngine);
+
+  /// \brief test rendering after the target is resized
+  public: void Resize(const std::string &_renderEngine);
 };
 
 /////////////////////////////////////////////////
@@ -122,6 +126,21 @@ void RenderTargetTest::RenderWindow(const std::string &_renderEngine)
   EXPECT_EQ(480u, renderWindow->Height());
   EXPECT_EQ(math::Color::Red, renderWindow->BackgroundColor());
 
+  // presentation options
+  EXPECT_EQ(WPM_FIFO, renderWindow->PresentMode());
+  renderWindow->SetPresentMode(WPM_IMMEDIATE);
+  EXPECT_EQ(WPM_IMMEDIATE, renderWindow->PresentMode());
+  EXPECT_EQ(0u, renderWindow->MaxFramesInFlight());
+  renderWindow->SetMaxFramesInFlight(1u);
+  EXPECT_EQ(1u, renderWindow->MaxFramesInFlight());
+
+  // no frame was presented yet
+  renderWindow->SetFrameTimestamp(std::chrono::steady_clock::now());
+  EXPECT_EQ(std::chrono::steady_clock::duration::zero(),
+      renderWindow->LastPresentLatency());
+  EXPECT_EQ(std::chrono::steady_clock::time_point(),
+      renderWindow->LastPresentTime());
+
   // Clean up
   engine->DestroyScene(scene);
   rendering::unloadEngine(engine->Name());
@@ -185,6 +204,60 @@ void RenderTargetTest::AddRemoveRenderPass(const std::string &_renderEngine)
   rendering::unloadEngine(engine->Name());
 }
 
+/////////////////////////////////////////////////
+void RenderTargetTest::Resize(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  scene->SetBackgroundColor(0.0, 0.0, 1.0);
+
+  CameraPtr camera = scene->CreateCamera("camera");
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageFormat(PF_R8G8B8);
+  scene->RootVisual()->AddChild(camera);
+
+  // the render pass chain is rebuilt with the target
+  RenderPassSystemPtr rpSystem = engine->RenderPassSystem();
+  if (rpSystem)
+  {
+    RenderPassPtr pass = rpSystem->Create<GaussianNoisePass>();
+    GaussianNoisePassPtr noisePass =
+        std::dynamic_pointer_cast<GaussianNoisePass>(pass);
+    noisePass->SetMean(0.0);
+    noisePass->SetStdDev(0.0);
+    camera->AddRenderPass(pass);
+  }
+
+  // switch between sizes, going back to sizes used before
+  const unsigned int sizes[][2] =
+      {{64u, 48u}, {32u, 24u}, {64u, 48u}, {80u, 60u}, {32u, 24u}};
+  for (const auto &size : sizes)
+  {
+    camera->SetImageWidth(size[0]);
+    camera->SetImageHeight(size[1]);
+    Image image = camera->CreateImage();
+    camera->Capture(image);
+    EXPECT_EQ(size[0], image.Width());
+    EXPECT_EQ(size[1], image.Height());
+
+    // the whole image shows the background
+    const unsigned char *data = image.Data<unsigned char>();
+    unsigned int last = (size[0] * size[1] - 1u) * 3u;
+    EXPECT_LT(data[0], data[2]);
+    EXPECT_LT(data[last], data[last + 2u]);
+  }
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
 /////////////////////////////////////////////////
 TEST_P(RenderTargetTest, RenderTexture)
 {
@@ -203,6 +276,12 @@ TEST_P(RenderTargetTest, AddRemoveRenderPass)
   AddRemoveRenderPass(GetParam());
 }
 
+/////////////////////////////////////////////////
+TEST_P(RenderTargetTest, Resize)
+{
+  Resize(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(RenderTarget, RenderTargetTest,
     RENDER_ENGINE_VALUES,
     ignition::rendering::PrintToStringParam());
@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ignition/rendering/RenderThread.hh"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/Profiler.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Private data for the RenderThread class
+class ignition::rendering::RenderThreadPrivate
+{
+  /// \brief Run the tasks until stopped
+  public: void Run();
+
+  /// \brief Render a frame
+  /// \param[in] _commands Mutations of the frame
+  public: void RenderFrame(std::vector<std::function<void()>> &_commands);
+
+  /// \brief Protects the tasks, the frame state and the callback
+  public: std::mutex mutex;
+
+  /// \brief Notified when a task is queued or the thread is stopped
+  public: std::condition_variable taskCondition;
+
+  /// \brief Notified when a task or a frame completes
+  public: std::condition_variable doneCondition;
+
+  /// \brief Tasks to run on the render thread, including frames
+  public: std::deque<std::function<void()>> tasks;
+
+  /// \brief Number of tasks completed
+  public: uint64_t tasksDone = 0u;
+
+  /// \brief Number of tasks queued since the start
+  public: uint64_t tasksQueued = 0u;
+
+  /// \brief True while a submitted frame has not completed
+  public: bool frameInFlight = false;
+
+  /// \brief True to stop the thread once the tasks are done
+  public: bool stop = false;
+
+  /// \brief Frame callback
+  public: std::function<void()> frameCallback;
+
+  /// \brief Protects the back buffer
+  public: std::mutex recordMutex;
+
+  /// \brief Mutations recorded for the next frame
+  public: std::vector<std::function<void()>> backBuffer;
+
+  /// \brief Number of frames submitted
+  public: uint64_t framesSubmitted = 0u;
+
+  /// \brief Number of frames completed
+  public: std::atomic<uint64_t> framesDone{0u};
+
+  /// \brief The render thread
+  public: std::thread thread;
+};
+
+//////////////////////////////////////////////////
+void RenderThreadPrivate::Run()
+{
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (true)
+  {
+    this->taskCondition.wait(lock, [this]()
+        {
+          return this->stop || !this->tasks.empty();
+        });
+    if (this->tasks.empty())
+      break;
+
+    std::function<void()> task = std::move(this->tasks.front());
+    this->tasks.pop_front();
+    lock.unlock();
+    task();
+    task = nullptr;
+    lock.lock();
+    ++this->tasksDone;
+    this->doneCondition.notify_all();
+  }
+}
+
+//////////////////////////////////////////////////
+void RenderThreadPrivate::RenderFrame(
+    std::vector<std::function<void()>> &_commands)
+{
+  IGN_RENDERING_PROFILE("RenderThread::RenderFrame");
+  for (auto &command : _commands)
+    command();
+  _commands.clear();
+
+  std::function<void()> callback;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    callback = this->frameCallback;
+  }
+  if (callback)
+    callback();
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->framesDone++;
+  this->frameInFlight = false;
+  this->doneCondition.notify_all();
+}
+
+//////////////////////////////////////////////////
+RenderThread::RenderThread()
+  : dataPtr(new RenderThreadPrivate)
+{
+  this->dataPtr->thread = std::thread(&RenderThreadPrivate::Run,
+      this->dataPtr.get());
+}
+
+//////////////////////////////////////////////////
+RenderThread::~RenderThread()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stop = true;
+  }
+  this->dataPtr->taskCondition.notify_all();
+  if (this->dataPtr->thread.joinable())
+    this->dataPtr->thread.join();
+}
+
+//////////////////////////////////////////////////
+void RenderThread::Execute(const std::function<void()> &_task)
+{
+  if (!_task)
+    return;
+
+  if (this->IsRenderThread())
+  {
+    _task();
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->tasks.push_back(_task);
+  uint64_t id = ++this->dataPtr->tasksQueued;
+  this->dataPtr->taskCondition.notify_one();
+  this->dataPtr->doneCondition.wait(lock, [this, id]()
+      {
+        return this->dataPtr->tasksDone >= id;
+      });
+}
+
+//////////////////////////////////////////////////
+void RenderThread::SetFrameCallback(std::function<void()> _callback)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->frameCallback = std::move(_callback);
+}
+
+//////////////////////////////////////////////////
+void RenderThread::Record(std::function<void()> _command)
+{
+  if (!_command)
+    return;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->recordMutex);
+  this->dataPtr->backBuffer.push_back(std::move(_command));
+}
+
+//////////////////////////////////////////////////
+uint64_t RenderThread::SubmitFrame()
+{
+  IGN_RENDERING_PROFILE("RenderThread::SubmitFrame");
+  if (this->IsRenderThread())
+  {
+    ignerr << "Frames can not be submitted from the render thread"
+           << std::endl;
+    return 0u;
+  }
+
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+
+  // the front buffer is free once the previous frame completes
+  this->dataPtr->doneCondition.wait(lock, [this]()
+      {
+        return !this->dataPtr->frameInFlight;
+      });
+
+  auto commands = std::make_shared<std::vector<std::function<void()>>>();
+  {
+    std::lock_guard<std::mutex> recordLock(this->dataPtr->recordMutex);
+    commands->swap(this->dataPtr->backBuffer);
+  }
+
+  this->dataPtr->frameInFlight = true;
+  RenderThreadPrivate *data = this->dataPtr.get();
+  this->dataPtr->tasks.push_back([data, commands]()
+      {
+        data->RenderFrame(*commands);
+      });
+  ++this->dataPtr->tasksQueued;
+  this->dataPtr->taskCondition.notify_one();
+  return ++this->dataPtr->framesSubmitted;
+}
+
+//////////////////////////////////////////////////
+void RenderThread::WaitForFrame()
+{
+  // the frame in flight is the one calling
+  if (this->IsRenderThread())
+    return;
+
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->doneCondition.wait(lock, [this]()
+      {
+        return !this->dataPtr->frameInFlight;
+      });
+}
+
+//////////////////////////////////////////////////
+uint64_t RenderThread::FrameCount() const
+{
+  return this->dataPtr->framesDone.load();
+}
+
+//////////////////////////////////////////////////
+bool RenderThread::IsRenderThread() const
+{
+  return std::this_thread::get_id() == this->dataPtr->thread.get_id();
+}
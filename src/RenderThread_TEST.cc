@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/RenderThread.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(RenderThreadTest, Execute)
+{
+  RenderThread renderThread;
+  EXPECT_FALSE(renderThread.IsRenderThread());
+
+  // tasks run on the render thread and are waited for
+  bool onRenderThread = false;
+  renderThread.Execute([&]()
+      {
+        onRenderThread = renderThread.IsRenderThread();
+
+        // nested tasks run directly
+        renderThread.Execute([&]()
+            {
+              EXPECT_TRUE(renderThread.IsRenderThread());
+            });
+      });
+  EXPECT_TRUE(onRenderThread);
+  EXPECT_EQ(0u, renderThread.FrameCount());
+}
+
+/////////////////////////////////////////////////
+TEST(RenderThreadTest, Frames)
+{
+  RenderThread renderThread;
+
+  // state owned by the render thread
+  int position = 0;
+  std::vector<int> rendered;
+  std::atomic<bool> onRenderThread{true};
+  renderThread.SetFrameCallback([&]()
+      {
+        if (!renderThread.IsRenderThread())
+          onRenderThread = false;
+        rendered.push_back(position);
+      });
+
+  // each frame renders the mutations submitted with it, while the next
+  // frame is being recorded
+  const int frameCount = 100;
+  for (int i = 1; i <= frameCount; ++i)
+  {
+    renderThread.Record([&position, i]() { position = i; });
+    EXPECT_EQ(static_cast<uint64_t>(i), renderThread.SubmitFrame());
+    EXPECT_GE(renderThread.FrameCount(), static_cast<uint64_t>(i - 1));
+  }
+  renderThread.WaitForFrame();
+
+  EXPECT_TRUE(onRenderThread);
+  EXPECT_EQ(static_cast<uint64_t>(frameCount), renderThread.FrameCount());
+  ASSERT_EQ(static_cast<size_t>(frameCount), rendered.size());
+  for (int i = 0; i < frameCount; ++i)
+    EXPECT_EQ(i + 1, rendered[i]);
+
+  // frames without mutations render the same state
+  renderThread.SubmitFrame();
+  renderThread.WaitForFrame();
+  EXPECT_EQ(frameCount, rendered.back());
+
+  // frames can not be submitted from the render thread
+  renderThread.Execute([&]()
+      {
+        EXPECT_EQ(0u, renderThread.SubmitFrame());
+      });
+  EXPECT_EQ(static_cast<uint64_t>(frameCount + 1),
+      renderThread.FrameCount());
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
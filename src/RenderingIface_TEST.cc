@@ -23,6 +23,7 @@
 
 #include "ignition/rendering/config.hh"
 #include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderEngineManager.hh"
 #include "ignition/rendering/RenderingIface.hh"
 
 using namespace ignition;
@@ -104,6 +105,49 @@ TEST(RenderingIfaceTest, GetEngine)
   EXPECT_EQ(nullptr, engine(1000000));
 }
 
+/////////////////////////////////////////////////
+TEST(RenderingIfaceTest, PreloadEngine)
+{
+  common::Console::SetVerbosity(4);
+
+  RenderEngineManager *manager = RenderEngineManager::Instance();
+
+  // non-existent engine
+  auto invalid = manager->PreloadEngine("no_such_engine");
+  ASSERT_TRUE(invalid.valid());
+  EXPECT_EQ(nullptr, invalid.get());
+
+  unsigned int count = defaultEnginesForTest();
+  if (count == 0)
+    return;
+
+  std::string name;
+#if HAVE_OGRE2
+  name = "ogre2";
+#elif HAVE_OGRE
+  name = "ogre";
+#else
+  name = "optix";
+#endif
+
+  // the plugin is loaded but not the engine
+  auto future = manager->PreloadEngine(name, {},
+      IGN_RENDERING_TEST_PLUGIN_PATH);
+  ASSERT_TRUE(future.valid());
+  RenderEngine *preloaded = future.get();
+  ASSERT_NE(nullptr, preloaded);
+  EXPECT_FALSE(preloaded->IsInitialized());
+  EXPECT_EQ(preloaded, manager->PreloadEngine(name).get());
+
+  RenderEngine *eng = engine(name);
+  EXPECT_EQ(preloaded, eng);
+  ASSERT_NE(nullptr, eng);
+  EXPECT_TRUE(eng->IsInitialized());
+
+  rendering::unloadEngine(eng->Name());
+  EXPECT_FALSE(isEngineLoaded(name));
+}
+
 /////////////////////////////////////////////////
 TEST(RenderingIfaceTest, RegisterEngine)
 {
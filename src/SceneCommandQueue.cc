@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ignition/rendering/SceneCommandQueue.hh"
+
+#include <atomic>
+#include <utility>
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Private data for the SceneCommandQueue class. The queue is a
+/// linked list after Dmitry Vyukov's intrusive MPSC queue: producers swap
+/// the head with their node then link the previous head to it, the
+/// consumer follows the links from the tail, a node whose command was
+/// already taken.
+class ignition::rendering::SceneCommandQueuePrivate
+{
+  /// \brief Node of the list
+  public: struct Node
+  {
+    /// \brief Next node, null until the producer links it
+    std::atomic<Node *> next{nullptr};
+
+    /// \brief Command of the node
+    std::function<void()> command;
+  };
+
+  /// \brief Take the oldest command
+  /// \param[out] _command Command taken
+  /// \return False if the queue is empty, or if the producer of the
+  /// oldest node has not linked it yet
+  public: bool Pop(std::function<void()> &_command)
+  {
+    Node *next = this->tail->next.load(std::memory_order_acquire);
+    if (!next)
+      return false;
+    _command = std::move(next->command);
+    next->command = nullptr;
+    delete this->tail;
+    this->tail = next;
+    this->size.fetch_sub(1u, std::memory_order_relaxed);
+    return true;
+  }
+
+  /// \brief Last node pushed, swapped by the producers
+  public: std::atomic<Node *> head{nullptr};
+
+  /// \brief Node before the oldest command, only used by the consumer
+  public: Node *tail = nullptr;
+
+  /// \brief Number of commands queued
+  public: std::atomic<size_t> size{0u};
+};
+
+//////////////////////////////////////////////////
+SceneCommandQueue::SceneCommandQueue()
+  : dataPtr(new SceneCommandQueuePrivate)
+{
+  auto stub = new SceneCommandQueuePrivate::Node;
+  this->dataPtr->head.store(stub, std::memory_order_relaxed);
+  this->dataPtr->tail = stub;
+}
+
+//////////////////////////////////////////////////
+SceneCommandQueue::~SceneCommandQueue()
+{
+  this->Clear();
+  delete this->dataPtr->tail;
+}
+
+//////////////////////////////////////////////////
+void SceneCommandQueue::Push(std::function<void()> _command)
+{
+  if (!_command)
+    return;
+
+  auto node = new SceneCommandQueuePrivate::Node;
+  node->command = std::move(_command);
+  this->dataPtr->size.fetch_add(1u, std::memory_order_relaxed);
+  SceneCommandQueuePrivate::Node *prev =
+      this->dataPtr->head.exchange(node, std::memory_order_acq_rel);
+  prev->next.store(node, std::memory_order_release);
+}
+
+//////////////////////////////////////////////////
+size_t SceneCommandQueue::Execute()
+{
+  // only execute the commands pushed before this call, so that commands
+  // pushing commands do not run forever
+  SceneCommandQueuePrivate::Node *last =
+      this->dataPtr->head.load(std::memory_order_acquire);
+
+  size_t count = 0u;
+  std::function<void()> command;
+  while (this->dataPtr->tail != last && this->dataPtr->Pop(command))
+  {
+    command();
+    command = nullptr;
+    ++count;
+  }
+  return count;
+}
+
+//////////////////////////////////////////////////
+void SceneCommandQueue::Clear()
+{
+  std::function<void()> command;
+  while (this->dataPtr->Pop(command))
+    command = nullptr;
+}
+
+//////////////////////////////////////////////////
+size_t SceneCommandQueue::Size() const
+{
+  return this->dataPtr->size.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/SceneCommandQueue.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(SceneCommandQueueTest, Order)
+{
+  SceneCommandQueue queue;
+  EXPECT_EQ(0u, queue.Size());
+  EXPECT_EQ(0u, queue.Execute());
+
+  std::vector<int> executed;
+  for (int i = 0; i < 10; ++i)
+    queue.Push([&executed, i]() { executed.push_back(i); });
+  queue.Push(nullptr);
+  EXPECT_EQ(10u, queue.Size());
+
+  EXPECT_EQ(10u, queue.Execute());
+  EXPECT_EQ(0u, queue.Size());
+  ASSERT_EQ(10u, executed.size());
+  for (int i = 0; i < 10; ++i)
+    EXPECT_EQ(i, executed[i]);
+
+  // commands pushed by commands are left for the next call
+  int count = 0;
+  std::function<void()> command = [&]()
+      {
+        ++count;
+        queue.Push(command);
+      };
+  queue.Push(command);
+  EXPECT_EQ(1u, queue.Execute());
+  EXPECT_EQ(1u, queue.Execute());
+  EXPECT_EQ(2, count);
+  EXPECT_EQ(1u, queue.Size());
+
+  // cleared commands are released without being executed
+  auto resource = std::make_shared<int>(0);
+  queue.Push([resource]() { ++*resource; });
+  EXPECT_EQ(2, resource.use_count());
+  queue.Clear();
+  EXPECT_EQ(0u, queue.Size());
+  EXPECT_EQ(1, resource.use_count());
+  EXPECT_EQ(0u, queue.Execute());
+  EXPECT_EQ(2, count);
+}
+
+/////////////////////////////////////////////////
+TEST(SceneCommandQueueTest, Producers)
+{
+  SceneCommandQueue queue;
+
+  // commands of each producer are executed in order while they are pushed
+  const int producerCount = 4;
+  const int commandCount = 10000;
+  std::vector<int> last(producerCount, -1);
+  std::vector<bool> ordered(producerCount, true);
+  std::vector<std::thread> producers;
+  for (int p = 0; p < producerCount; ++p)
+  {
+    producers.emplace_back([&, p]()
+        {
+          for (int i = 0; i < commandCount; ++i)
+          {
+            queue.Push([&, p, i]()
+                {
+                  if (last[p] != i - 1)
+                    ordered[p] = false;
+                  last[p] = i;
+                });
+          }
+        });
+  }
+
+  size_t executed = 0u;
+  while (executed < static_cast<size_t>(producerCount * commandCount))
+    executed += queue.Execute();
+  for (auto &producer : producers)
+    producer.join();
+
+  EXPECT_EQ(static_cast<size_t>(producerCount * commandCount), executed);
+  EXPECT_EQ(0u, queue.Execute());
+  for (int p = 0; p < producerCount; ++p)
+  {
+    EXPECT_TRUE(ordered[p]);
+    EXPECT_EQ(commandCount - 1, last[p]);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
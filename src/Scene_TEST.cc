@@ -16,14 +16,26 @@
 */
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include <ignition/common/Console.hh>
+#include <ignition/math/Helpers.hh>
 
 #include "test_config.h"  // NOLINT(build/include)
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/Capsule.hh"
+#include "ignition/rendering/Light.hh"
+#include "ignition/rendering/Material.hh"
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/RenderTarget.hh"
 #include "ignition/rendering/RenderingIface.hh"
 #include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
+#include "ignition/rendering/base/BaseObject.hh"
 
 using namespace ignition;
 using namespace rendering;
@@ -60,6 +72,42 @@ class SceneTest : public testing::Test,
 
   /// \brief Test enablng sky
   public: void Sky(const std::string &_renderEngine);
+
+  /// \brief Test scene frame begin and end
+  public: void Frame(const std::string &_renderEngine);
+
+  /// \brief Test setting world poses of many nodes at once
+  public: void WorldPoses(const std::string &_renderEngine);
+
+  /// \brief Test destroying lists of visuals and materials
+  public: void DestroyBatch(const std::string &_renderEngine);
+
+  /// \brief Test precompiling the shaders of a scene
+  public: void PrecompileShaders(const std::string &_renderEngine);
+
+  /// \brief Test sharing materials with the same parameters
+  public: void SharedMaterials(const std::string &_renderEngine);
+
+  /// \brief Test querying visuals by box, sphere and frustum
+  public: void SpatialQueries(const std::string &_renderEngine);
+
+  /// \brief Test the memory statistics of the scene resources
+  public: void ResourceMemoryStats(const std::string &_renderEngine);
+
+  /// \brief Test applying commands queued from other threads
+  public: void Commands(const std::string &_renderEngine);
+
+  /// \brief Test traversing the scene graph on multiple threads
+  public: void ParallelPreRender(const std::string &_renderEngine);
+
+  /// \brief Test preparing only the changed objects for rendering
+  public: void IncrementalPreRender(const std::string &_renderEngine);
+
+  /// \brief Test merging static meshes into batches
+  public: void StaticGeometry(const std::string &_renderEngine);
+
+  /// \brief Test destroying the objects over several steps
+  public: void IncrementalClear(const std::string &_renderEngine);
 };
 
 /////////////////////////////////////////////////
@@ -772,6 +820,603 @@ void SceneTest::Sky(const std::string &_renderEngine)
   rendering::unloadEngine(engine->Name());
 }
 
+/////////////////////////////////////////////////
+/// \brief Object counting its PreRender calls. It flags itself as dirty
+/// each time it is prepared so that every incremental PreRender of the
+/// scene prepares it again.
+class PreRenderCounter : public BaseObject
+{
+  /// \brief Constructor
+  /// \param[in] _scene Scene preparing the object
+  public: explicit PreRenderCounter(ScenePtr _scene)
+          : scene(_scene)
+  {
+  }
+
+  // Documentation inherited
+  public: ScenePtr Scene() const override
+  {
+    return this->scene.lock();
+  }
+
+  // Documentation inherited
+  public: void PreRender() override
+  {
+    ++this->count;
+    ScenePtr s = this->Scene();
+    if (s)
+      s->MarkPreRenderDirty(this->shared_from_this());
+  }
+
+  /// \brief Number of PreRender calls
+  public: unsigned int count = 0u;
+
+  /// \brief Scene preparing the object
+  private: std::weak_ptr<rendering::Scene> scene;
+};
+
+/////////////////////////////////////////////////
+void SceneTest::Frame(const std::string &_renderEngine)
+{
+  auto engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine << "' is not supported" << std::endl;
+    return;
+  }
+
+  auto scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  EXPECT_FALSE(scene->FrameActive());
+  scene->PreRender();
+  EXPECT_FALSE(scene->FrameActive());
+
+  scene->BeginFrame();
+  EXPECT_TRUE(scene->FrameActive());
+
+  // repeated calls within a frame should be safe
+  VisualPtr visual = scene->CreateVisual();
+  ASSERT_NE(nullptr, visual);
+  scene->RootVisual()->AddChild(visual);
+  scene->PreRender();
+  scene->PreRender();
+  EXPECT_TRUE(scene->FrameActive());
+
+  scene->EndFrame();
+  EXPECT_FALSE(scene->FrameActive());
+  scene->PreRender();
+
+  // a new frame flushes changes again
+  scene->BeginFrame();
+  visual->SetLocalPosition(1.0, 2.0, 3.0);
+  scene->PreRender();
+  EXPECT_EQ(math::Vector3d(1.0, 2.0, 3.0), visual->WorldPosition());
+  scene->EndFrame();
+
+  // without a frame every PreRender prepares the scene
+  scene->SetIncrementalPreRender(true);
+  scene->PreRender();
+  auto counter = std::make_shared<PreRenderCounter>(scene);
+  scene->MarkPreRenderDirty(counter);
+  scene->PreRender();
+  EXPECT_EQ(1u, counter->count);
+  scene->PreRender();
+  EXPECT_EQ(2u, counter->count);
+
+  // within a frame the scene is only prepared once
+  for (unsigned int i = 1u; i <= 3u; ++i)
+  {
+    scene->BeginFrame();
+    scene->PreRender();
+    scene->PreRender();
+    scene->PreRender();
+    EXPECT_EQ(2u + i, counter->count);
+    scene->EndFrame();
+  }
+
+  // a frame without PreRender does not prepare the scene
+  scene->BeginFrame();
+  scene->EndFrame();
+  EXPECT_EQ(5u, counter->count);
+  scene->SetIncrementalPreRender(false);
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void SceneTest::WorldPoses(const std::string &_renderEngine)
+{
+  auto engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine << "' is not supported" << std::endl;
+    return;
+  }
+
+  auto scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  VisualPtr root = scene->RootVisual();
+  VisualPtr a = scene->CreateVisual("a");
+  VisualPtr b = scene->CreateVisual("b");
+  VisualPtr child = scene->CreateVisual("child");
+  ASSERT_NE(nullptr, a);
+  ASSERT_NE(nullptr, b);
+  ASSERT_NE(nullptr, child);
+  root->AddChild(a);
+  root->AddChild(b);
+  a->AddChild(child);
+  b->SetOrigin(0.0, 0.0, 1.0);
+
+  math::Pose3d poseA(1, 2, 3, 0, 0, 1.57);
+  math::Pose3d poseB(-1, 0, 4, 0.2, 0, 0);
+  math::Pose3d poseChild(5, 6, 7, 0, 0.3, 0);
+  scene->SetWorldPoses({a->Id(), b->Id(), child->Id()},
+      {poseA, poseB, poseChild});
+  EXPECT_EQ(poseA, a->WorldPose());
+  EXPECT_EQ(poseB, b->WorldPose());
+  EXPECT_EQ(poseChild, child->WorldPose());
+
+  // mismatched input is ignored
+  scene->SetWorldPoses({a->Id(), b->Id()}, {math::Pose3d::Zero});
+  EXPECT_EQ(poseA, a->WorldPose());
+  EXPECT_EQ(poseB, b->WorldPose());
+
+  // unknown ids are skipped
+  scene->SetWorldPoses({12345u, a->Id()}, {poseB, poseChild});
+  EXPECT_EQ(poseChild, a->WorldPose());
+
+  // pose changes are counted by the scene version
+  uint64_t version = scene->ChangeVersion();
+  scene->SetWorldPoses({a->Id()}, {poseA});
+  EXPECT_LT(version, scene->ChangeVersion());
+
+  // ids given more than once are set in order
+  scene->SetWorldPoses({a->Id(), a->Id()}, {poseB, poseChild});
+  EXPECT_EQ(poseChild, a->WorldPose());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void SceneTest::DestroyBatch(const std::string &_renderEngine)
+{
+  auto engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine << "' is not supported" << std::endl;
+    return;
+  }
+
+  auto scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  // materials
+  std::vector<MaterialPtr> materials;
+  for (unsigned int i = 0; i < 10u; ++i)
+    materials.push_back(scene->CreateMaterial("mat" + std::to_string(i)));
+  scene->DestroyMaterials({materials[0], materials[3], nullptr});
+  EXPECT_FALSE(scene->MaterialRegistered("mat0"));
+  EXPECT_TRUE(scene->MaterialRegistered("mat1"));
+  EXPECT_FALSE(scene->MaterialRegistered("mat3"));
+  scene->DestroyMaterials();
+  for (unsigned int i = 0; i < 10u; ++i)
+    EXPECT_FALSE(scene->MaterialRegistered("mat" + std::to_string(i)));
+
+  // visuals, non recursive
+  VisualPtr parent = scene->CreateVisual("parent");
+  VisualPtr child = scene->CreateVisual("child");
+  VisualPtr other = scene->CreateVisual("other");
+  parent->AddChild(child);
+  scene->DestroyVisuals({parent, other});
+  EXPECT_FALSE(scene->HasVisualName("parent"));
+  EXPECT_FALSE(scene->HasVisualName("other"));
+  EXPECT_TRUE(scene->HasVisualName("child"));
+  scene->DestroyVisual(child);
+
+  // visuals, recursive and containing a descendant of another visual
+  parent = scene->CreateVisual("parent");
+  child = scene->CreateVisual("child");
+  VisualPtr grandchild = scene->CreateVisual("grandchild");
+  parent->AddChild(child);
+  child->AddChild(grandchild);
+  other = scene->CreateVisual("other");
+  scene->DestroyVisuals({parent, grandchild, other}, true);
+  EXPECT_FALSE(scene->HasVisualName("parent"));
+  EXPECT_FALSE(scene->HasVisualName("child"));
+  EXPECT_FALSE(scene->HasVisualName("grandchild"));
+  EXPECT_FALSE(scene->HasVisualName("other"));
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void SceneTest::PrecompileShaders(const std::string &_renderEngine)
+{
+  auto engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine << "' is not supported" << std::endl;
+    return;
+  }
+
+  auto scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  // lit box and an unused transparent material
+  MaterialPtr red = scene->CreateMaterial("red");
+  red->SetDiffuse(1.0, 0.0, 0.0);
+  MaterialPtr glass = scene->CreateMaterial("glass");
+  glass->SetTransparency(0.5);
+
+  VisualPtr visual = scene->CreateVisual("box");
+  visual->AddGeometry(scene->CreateBox());
+  visual->SetMaterial(red);
+  visual->SetLocalPosition(5, 0, 0);
+  scene->RootVisual()->AddChild(visual);
+
+  DirectionalLightPtr light = scene->CreateDirectionalLight();
+  scene->RootVisual()->AddChild(light);
+
+  unsigned int visualCount = scene->VisualCount();
+  unsigned int sensorCount = scene->SensorCount();
+
+  scene->PrecompileShaders();
+
+  // the temporary camera and visual are removed
+  EXPECT_EQ(visualCount, scene->VisualCount());
+  EXPECT_EQ(sensorCount, scene->SensorCount());
+  EXPECT_TRUE(scene->MaterialRegistered("red"));
+  EXPECT_TRUE(scene->MaterialRegistered("glass"));
+  EXPECT_TRUE(scene->HasVisualName("box"));
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void SceneTest::SharedMaterials(const std::string &_renderEngine)
+{
+  auto engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine << "' is not supported" << std::endl;
+    return;
+  }
+
+  auto scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  EXPECT_EQ(nullptr, scene->SharedMaterial(nullptr));
+
+  MaterialPtr red = scene->CreateMaterial("red");
+  red->SetDiffuse(1.0, 0.0, 0.0);
+  MaterialPtr red2 = scene->CreateMaterial("red2");
+  red2->SetDiffuse(1.0, 0.0, 0.0);
+  MaterialPtr blue = scene->CreateMaterial("blue");
+  blue->SetDiffuse(0.0, 0.0, 1.0);
+
+  // materials with the same parameters are shared
+  EXPECT_EQ(red, scene->SharedMaterial(red));
+  EXPECT_EQ(red, scene->SharedMaterial(red2));
+  EXPECT_EQ(red, scene->SharedMaterial(red));
+  EXPECT_EQ(blue, scene->SharedMaterial(blue));
+
+  // destroying a shared material removes it from the shared materials
+  scene->DestroyMaterial(red);
+  EXPECT_FALSE(scene->MaterialRegistered("red"));
+  EXPECT_EQ(red2, scene->SharedMaterial(red2));
+  EXPECT_EQ(blue, scene->SharedMaterial(blue));
+
+  scene->DestroyMaterials();
+  MaterialPtr blue2 = scene->CreateMaterial("blue2");
+  blue2->SetDiffuse(0.0, 0.0, 1.0);
+  EXPECT_EQ(blue2, scene->SharedMaterial(blue2));
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void SceneTest::SpatialQueries(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+           << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  VisualPtr root = scene->RootVisual();
+
+  // empty scene, the root visual is never reported
+  math::AxisAlignedBox all(math::Vector3d(-100, -100, -100),
+      math::Vector3d(100, 100, 100));
+  EXPECT_TRUE(scene->VisualsInBox(all).empty());
+
+  // unit boxes along the x axis, 2 m apart
+  std::vector<VisualPtr> visuals;
+  for (unsigned int i = 0; i < 5; ++i)
+  {
+    VisualPtr visual = scene->CreateVisual();
+    visual->AddGeometry(scene->CreateBox());
+    visual->SetLocalPosition(i * 2.0, 0, 0);
+    root->AddChild(visual);
+    visuals.push_back(visual);
+  }
+
+  // visuals without geometry have no bounds
+  VisualPtr empty = scene->CreateVisual();
+  root->AddChild(empty);
+
+  EXPECT_EQ(5u, scene->VisualsInBox(all).size());
+
+  std::vector<VisualPtr> result = scene->VisualsInBox(
+      math::AxisAlignedBox(math::Vector3d(1.9, -1, -1),
+      math::Vector3d(4.1, 1, 1)));
+  ASSERT_EQ(2u, result.size());
+  EXPECT_NE(result.end(),
+      std::find(result.begin(), result.end(), visuals[1]));
+  EXPECT_NE(result.end(),
+      std::find(result.begin(), result.end(), visuals[2]));
+
+  result = scene->VisualsInSphere(math::Vector3d(8, 0, 0), 1.0);
+  ASSERT_EQ(1u, result.size());
+  EXPECT_EQ(visuals[4], result[0]);
+  EXPECT_TRUE(scene->VisualsInSphere(math::Vector3d(0, 5, 0), 1.0).empty());
+
+  // frustum looking down the x axis from behind the first box
+  math::Frustum frustum(0.1, 3.0, IGN_DTOR(60), 1.0,
+      math::Pose3d(-1, 0, 0, 0, 0, 0));
+  result = scene->VisualsInFrustum(frustum);
+  ASSERT_EQ(2u, result.size());
+  EXPECT_NE(result.end(),
+      std::find(result.begin(), result.end(), visuals[0]));
+  EXPECT_NE(result.end(),
+      std::find(result.begin(), result.end(), visuals[1]));
+
+  // moving a visual updates the queries
+  visuals[4]->SetLocalPosition(0, 10, 0);
+  EXPECT_TRUE(scene->VisualsInSphere(math::Vector3d(8, 0, 0), 1.0).empty());
+  result = scene->VisualsInSphere(math::Vector3d(0, 10, 0), 1.0);
+  ASSERT_EQ(1u, result.size());
+  EXPECT_EQ(visuals[4], result[0]);
+
+  // destroyed visuals are no longer reported
+  scene->DestroyVisual(visuals[0]);
+  result = scene->VisualsInFrustum(frustum);
+  ASSERT_EQ(1u, result.size());
+  EXPECT_EQ(visuals[1], result[0]);
+  EXPECT_EQ(4u, scene->VisualsInBox(all).size());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void SceneTest::Commands(const std::string &_renderEngine)
+{
+  auto engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine << "' is not supported" << std::endl;
+    return;
+  }
+
+  auto scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  VisualPtr root = scene->RootVisual();
+  std::vector<VisualPtr> visuals;
+  for (unsigned int i = 0; i < 4u; ++i)
+  {
+    VisualPtr visual = scene->CreateVisual();
+    ASSERT_NE(nullptr, visual);
+    root->AddChild(visual);
+    visuals.push_back(visual);
+  }
+
+  // each thread moves its visual along x, the last command wins
+  std::vector<std::thread> threads;
+  for (unsigned int i = 0; i < visuals.size(); ++i)
+  {
+    threads.emplace_back([scene, visual = visuals[i]]()
+        {
+          for (int j = 1; j <= 100; ++j)
+          {
+            scene->EnqueueCommand([visual, j]()
+                {
+                  visual->SetWorldPosition(j, 0, 0);
+                });
+          }
+        });
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  // nothing is applied until the render thread flushes the scene
+  for (auto &visual : visuals)
+    EXPECT_EQ(math::Vector3d::Zero, visual->WorldPosition());
+
+  scene->PreRender();
+  for (auto &visual : visuals)
+    EXPECT_EQ(math::Vector3d(100, 0, 0), visual->WorldPosition());
+  EXPECT_EQ(0u, scene->ApplyCommands());
+
+  // commands are applied once per frame
+  scene->BeginFrame();
+  scene->PreRender();
+  scene->EnqueueCommand([&]()
+      {
+        visuals[0]->SetWorldPosition(0, 1, 0);
+      });
+  scene->PreRender();
+  EXPECT_EQ(math::Vector3d(100, 0, 0), visuals[0]->WorldPosition());
+  scene->EndFrame();
+  EXPECT_EQ(1u, scene->ApplyCommands());
+  EXPECT_EQ(math::Vector3d(0, 1, 0), visuals[0]->WorldPosition());
+
+  // queued commands are discarded with the objects of the scene
+  scene->EnqueueCommand([&]()
+      {
+        visuals[0]->SetWorldPosition(0, 0, 1);
+      });
+  visuals.clear();
+  scene->Clear();
+  EXPECT_EQ(0u, scene->ApplyCommands());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void SceneTest::ParallelPreRender(const std::string &_renderEngine)
+{
+  auto engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine << "' is not supported" << std::endl;
+    return;
+  }
+
+  auto scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  EXPECT_EQ(1u, scene->PreRenderThreadCount());
+  scene->SetPreRenderThreadCount(0u);
+  EXPECT_LE(1u, scene->PreRenderThreadCount());
+  scene->SetPreRenderThreadCount(4u);
+  EXPECT_EQ(4u, scene->PreRenderThreadCount());
+
+  // a few chains of nodes, each link offset along x, enough to be
+  // traversed in parallel
+  VisualPtr root = scene->RootVisual();
+  std::vector<VisualPtr> tips;
+  const unsigned int chainCount = 10u;
+  const unsigned int chainLength = 1000u;
+  for (unsigned int c = 0; c < chainCount; ++c)
+  {
+    VisualPtr parent = root;
+    for (unsigned int i = 0; i < chainLength; ++i)
+    {
+      VisualPtr visual = scene->CreateVisual();
+      ASSERT_NE(nullptr, visual);
+      if (i == 0u)
+        visual->SetLocalPosition(0.0, c, 0.0);
+      else
+        visual->SetLocalPosition(1.0, 0.0, 0.0);
+      if (i % 100u == 0u)
+        visual->AddGeometry(scene->CreateBox());
+      parent->AddChild(visual);
+      parent = visual;
+    }
+    tips.push_back(parent);
+  }
+
+  scene->PreRender();
+  for (unsigned int c = 0; c < chainCount; ++c)
+  {
+    EXPECT_EQ(math::Vector3d(chainLength - 1.0, c, 0.0),
+        tips[c]->WorldPosition());
+  }
+
+  // changes are flushed again
+  root->SetLocalPosition(0.0, 0.0, 2.0);
+  scene->PreRender();
+  EXPECT_EQ(math::Vector3d(chainLength - 1.0, 0.0, 2.0),
+      tips[0]->WorldPosition());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void SceneTest::IncrementalPreRender(const std::string &_renderEngine)
+{
+  auto engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine << "' is not supported" << std::endl;
+    return;
+  }
+
+  auto scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  EXPECT_FALSE(scene->IncrementalPreRender());
+  scene->SetIncrementalPreRender(true);
+
+  // optix rebuilds its lights from a full traversal of the scene
+  if (_renderEngine == "optix")
+  {
+    EXPECT_FALSE(scene->IncrementalPreRender());
+    engine->DestroyScene(scene);
+    rendering::unloadEngine(engine->Name());
+    return;
+  }
+  EXPECT_TRUE(scene->IncrementalPreRender());
+
+  VisualPtr root = scene->RootVisual();
+  VisualPtr parent = scene->CreateVisual();
+  ASSERT_NE(nullptr, parent);
+  root->AddChild(parent);
+  CapsulePtr capsule = scene->CreateCapsule();
+  ASSERT_NE(nullptr, capsule);
+  parent->AddGeometry(capsule);
+
+  // the first frame traverses the whole scene graph
+  scene->PreRender();
+
+  // changed objects are prepared in the next frame
+  capsule->SetRadius(0.2);
+  parent->SetLocalPosition(1.0, 0.0, 0.0);
+  scene->PreRender();
+  EXPECT_DOUBLE_EQ(0.2, capsule->Radius());
+  EXPECT_EQ(math::Vector3d(1.0, 0.0, 0.0), parent->WorldPosition());
+
+  // subtrees added to the scene are prepared
+  VisualPtr child = scene->CreateVisual();
+  ASSERT_NE(nullptr, child);
+  child->SetLocalPosition(0.0, 1.0, 0.0);
+  child->AddGeometry(scene->CreateBox());
+  parent->AddChild(child);
+  scene->PreRender();
+  EXPECT_EQ(math::Vector3d(1.0, 1.0, 0.0), child->WorldPosition());
+
+  // objects destroyed after being changed are skipped
+  child->SetLocalPosition(0.0, 2.0, 0.0);
+  scene->DestroyVisual(child);
+  child.reset();
+  scene->PreRender();
+
+  // the scene graph is traversed again once disabled
+  scene->SetIncrementalPreRender(false);
+  EXPECT_FALSE(scene->IncrementalPreRender());
+  scene->MarkPreRenderDirty(parent);
+  parent->SetLocalPosition(2.0, 0.0, 0.0);
+  scene->PreRender();
+  EXPECT_EQ(math::Vector3d(2.0, 0.0, 0.0), parent->WorldPosition());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
 /////////////////////////////////////////////////
 TEST_P(SceneTest, Scene)
 {
@@ -802,6 +1447,161 @@ TEST_P(SceneTest, NodeCycle)
   NodeCycle(GetParam());
 }
 
+/////////////////////////////////////////////////
+void SceneTest::ResourceMemoryStats(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+           << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(64u);
+  camera->SetImageHeight(64u);
+  scene->RootVisual()->AddChild(camera);
+
+  VisualPtr box = scene->CreateVisual();
+  ASSERT_NE(nullptr, box);
+  box->AddGeometry(scene->CreateBox());
+  scene->RootVisual()->AddChild(box);
+  camera->Update();
+
+  // only ogre2 reports the memory of its resources
+  MemoryStats stats = scene->ResourceMemoryStats();
+  if (_renderEngine == "ogre2")
+  {
+    EXPECT_LT(0u, stats.meshBytes);
+    EXPECT_LE(64u * 64u, stats.renderTargetBytes);
+  }
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void SceneTest::StaticGeometry(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+           << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  MaterialPtr material = scene->CreateMaterial();
+  ASSERT_NE(nullptr, material);
+
+  // two static boxes sharing a material and one dynamic box
+  std::vector<VisualPtr> visuals;
+  for (unsigned int i = 0; i < 3u; ++i)
+  {
+    VisualPtr visual = scene->CreateVisual();
+    ASSERT_NE(nullptr, visual);
+    visual->AddGeometry(scene->CreateBox());
+    visual->SetMaterial(material, false);
+    visual->SetLocalPosition(i * 2.0, 0, 0);
+    scene->RootVisual()->AddChild(visual);
+    visuals.push_back(visual);
+  }
+  visuals[0]->SetStatic(true);
+  visuals[1]->SetStatic(true);
+
+  // only the meshes of the static visuals are baked
+  EXPECT_EQ(2u, scene->BakeStaticGeometry(visuals));
+  EXPECT_EQ(0u, visuals[0]->GeometryCount());
+  EXPECT_EQ(0u, visuals[1]->GeometryCount());
+  EXPECT_EQ(1u, visuals[2]->GeometryCount());
+
+  // nothing left to bake
+  EXPECT_EQ(0u, scene->BakeStaticGeometry(visuals));
+
+  // clearing gives the meshes back to their visuals
+  scene->ClearStaticGeometry();
+  EXPECT_EQ(1u, visuals[0]->GeometryCount());
+  EXPECT_EQ(1u, visuals[1]->GeometryCount());
+  EXPECT_EQ(1u, visuals[2]->GeometryCount());
+
+  // baking again after clearing
+  EXPECT_EQ(2u, scene->BakeStaticGeometry(visuals));
+  scene->ClearStaticGeometry();
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void SceneTest::IncrementalClear(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+           << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  VisualPtr root = scene->RootVisual();
+
+  // nothing to tear down
+  EXPECT_FALSE(scene->Clearing());
+  EXPECT_TRUE(scene->ClearStep(std::chrono::milliseconds(0)));
+
+  for (unsigned int i = 0u; i < 10u; ++i)
+  {
+    VisualPtr visual = scene->CreateVisual();
+    ASSERT_NE(nullptr, visual);
+    visual->AddGeometry(scene->CreateBox());
+    visual->SetMaterial(
+        scene->CreateMaterial("material" + std::to_string(i)), false);
+    root->AddChild(visual);
+  }
+  root->AddChild(scene->CreateDirectionalLight());
+  EXPECT_EQ(10u, scene->VisualCount());
+  EXPECT_EQ(11u, root->ChildCount());
+
+  // the scene graph is emptied right away
+  scene->BeginClear();
+  EXPECT_TRUE(scene->Clearing());
+  EXPECT_EQ(0u, root->ChildCount());
+
+  // one object is destroyed per step with no budget
+  unsigned int steps = 1u;
+  while (!scene->ClearStep(std::chrono::milliseconds(0)) && steps < 100u)
+    ++steps;
+  EXPECT_LT(10u, steps);
+  EXPECT_GT(100u, steps);
+  EXPECT_FALSE(scene->Clearing());
+  EXPECT_EQ(0u, scene->VisualCount());
+  EXPECT_EQ(0u, scene->LightCount());
+  EXPECT_FALSE(scene->MaterialRegistered("material0"));
+
+  // objects can be created again
+  VisualPtr visual = scene->CreateVisual();
+  ASSERT_NE(nullptr, visual);
+  visual->AddGeometry(scene->CreateBox());
+  root->AddChild(visual);
+  EXPECT_EQ(1u, scene->VisualCount());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
 /////////////////////////////////////////////////
 TEST_P(SceneTest, Materials)
 {
@@ -826,6 +1626,78 @@ TEST_P(SceneTest, Sky)
   Sky(GetParam());
 }
 
+/////////////////////////////////////////////////
+TEST_P(SceneTest, Frame)
+{
+  Frame(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneTest, WorldPoses)
+{
+  WorldPoses(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneTest, DestroyBatch)
+{
+  DestroyBatch(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneTest, PrecompileShaders)
+{
+  PrecompileShaders(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneTest, SharedMaterials)
+{
+  SharedMaterials(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneTest, SpatialQueries)
+{
+  SpatialQueries(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneTest, ResourceMemoryStats)
+{
+  ResourceMemoryStats(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneTest, Commands)
+{
+  Commands(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneTest, ParallelPreRender)
+{
+  ParallelPreRender(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneTest, IncrementalPreRender)
+{
+  IncrementalPreRender(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneTest, StaticGeometry)
+{
+  StaticGeometry(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneTest, IncrementalClear)
+{
+  IncrementalClear(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(Scene, SceneTest,
     RENDER_ENGINE_VALUES,
     ignition::rendering::PrintToStringParam());
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/SegmentationCamera.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+class SegmentationCameraTest : public testing::Test,
+                               public testing::WithParamInterface<const char *>
+{
+  /// \brief Test basic api
+  public: void SegmentationCamera(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+void SegmentationCameraTest::SegmentationCamera(
+    const std::string &_renderEngine)
+{
+  // create and populate scene
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  SegmentationCameraPtr camera(scene->CreateSegmentationCamera());
+  if (!camera)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' doesn't support segmentation cameras" << std::endl;
+    engine->DestroyScene(scene);
+    rendering::unloadEngine(engine->Name());
+    return;
+  }
+
+  // defaults
+  EXPECT_EQ(SEG_SEMANTIC, camera->Type());
+  EXPECT_EQ(32u, camera->LabelBitDepth());
+  EXPECT_EQ(0u, camera->BackgroundLabel());
+
+  camera->SetSegmentationType(SEG_INSTANCE);
+  EXPECT_EQ(SEG_INSTANCE, camera->Type());
+
+  camera->SetLabelBitDepth(16u);
+  EXPECT_EQ(16u, camera->LabelBitDepth());
+
+  // unsupported bit depths are ignored
+  camera->SetLabelBitDepth(8u);
+  EXPECT_EQ(16u, camera->LabelBitDepth());
+
+  camera->SetBackgroundLabel(255u);
+  EXPECT_EQ(255u, camera->BackgroundLabel());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SegmentationCameraTest, SegmentationCamera)
+{
+  SegmentationCamera(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(SegmentationCamera, SegmentationCameraTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ignition/rendering/SensorFrame.hh"
+
+#include <atomic>
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+class ignition::rendering::SensorFramePoolPrivate
+{
+  /// \brief Frames of the pool. A frame is free when the pool holds the
+  /// only reference to it.
+  public: std::vector<SensorFramePtr> frames;
+};
+
+//////////////////////////////////////////////////
+const void *SensorFrame::Data() const
+{
+  return this->data.data();
+}
+
+//////////////////////////////////////////////////
+void *SensorFrame::Data()
+{
+  return this->data.data();
+}
+
+//////////////////////////////////////////////////
+size_t SensorFrame::Size() const
+{
+  return this->data.size();
+}
+
+//////////////////////////////////////////////////
+unsigned int SensorFrame::Width() const
+{
+  return this->width;
+}
+
+//////////////////////////////////////////////////
+unsigned int SensorFrame::Height() const
+{
+  return this->height;
+}
+
+//////////////////////////////////////////////////
+unsigned int SensorFrame::Channels() const
+{
+  return this->channels;
+}
+
+//////////////////////////////////////////////////
+const std::string &SensorFrame::Format() const
+{
+  return this->format;
+}
+
+//////////////////////////////////////////////////
+void SensorFrame::SetDescription(unsigned int _width, unsigned int _height,
+    unsigned int _channels, const std::string &_format)
+{
+  this->width = _width;
+  this->height = _height;
+  this->channels = _channels;
+  // reuses the string storage when the format does not change
+  this->format = _format;
+}
+
+//////////////////////////////////////////////////
+void SensorFrame::Resize(size_t _size)
+{
+  this->data.resize(_size);
+}
+
+//////////////////////////////////////////////////
+SensorFramePool::SensorFramePool()
+  : dataPtr(new SensorFramePoolPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+SensorFramePool::~SensorFramePool() = default;
+
+//////////////////////////////////////////////////
+SensorFramePtr SensorFramePool::Acquire(size_t _size)
+{
+  for (auto &frame : this->dataPtr->frames)
+  {
+    if (frame.use_count() == 1)
+    {
+      // the last subscriber was done reading the frame when it released it
+      std::atomic_thread_fence(std::memory_order_acquire);
+      frame->Resize(_size);
+      return frame;
+    }
+  }
+
+  this->dataPtr->frames.push_back(std::make_shared<SensorFrame>());
+  this->dataPtr->frames.back()->Resize(_size);
+  return this->dataPtr->frames.back();
+}
+
+//////////////////////////////////////////////////
+unsigned int SensorFramePool::Size() const
+{
+  return static_cast<unsigned int>(this->dataPtr->frames.size());
+}
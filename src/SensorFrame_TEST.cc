@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/SensorFrame.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(SensorFrameTest, Description)
+{
+  SensorFrame frame;
+  EXPECT_EQ(0u, frame.Size());
+  EXPECT_EQ(0u, frame.Width());
+  EXPECT_EQ(0u, frame.Height());
+  EXPECT_EQ(0u, frame.Channels());
+  EXPECT_TRUE(frame.Format().empty());
+
+  frame.Resize(4u * 3u * sizeof(float));
+  frame.SetDescription(4u, 3u, 1u, "FLOAT32");
+  EXPECT_EQ(48u, frame.Size());
+  EXPECT_EQ(4u, frame.Width());
+  EXPECT_EQ(3u, frame.Height());
+  EXPECT_EQ(1u, frame.Channels());
+  EXPECT_EQ("FLOAT32", frame.Format());
+
+  frame.Data<float>()[11] = 2.5f;
+  const SensorFrame &constFrame = frame;
+  EXPECT_FLOAT_EQ(2.5f, constFrame.Data<float>()[11]);
+}
+
+/////////////////////////////////////////////////
+TEST(SensorFrameTest, Pool)
+{
+  SensorFramePool pool;
+  EXPECT_EQ(0u, pool.Size());
+
+  SensorFramePtr a = pool.Acquire(16u);
+  ASSERT_NE(nullptr, a);
+  EXPECT_EQ(16u, a->Size());
+  EXPECT_EQ(1u, pool.Size());
+
+  // a is held by a subscriber, another frame is allocated
+  ConstSensorFramePtr held = a;
+  a.reset();
+  SensorFramePtr b = pool.Acquire(8u);
+  EXPECT_NE(held, b);
+  EXPECT_EQ(8u, b->Size());
+  EXPECT_EQ(2u, pool.Size());
+
+  // frames are reused once every reference is released
+  const void *data = held->Data();
+  held.reset();
+  b.reset();
+  SensorFramePtr c = pool.Acquire(16u);
+  SensorFramePtr d = pool.Acquire(16u);
+  EXPECT_EQ(2u, pool.Size());
+  EXPECT_TRUE(c->Data() == data || d->Data() == data);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,375 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ignition/rendering/SensorScheduler.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <numeric>
+#include <set>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/Scene.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Schedule of a sensor
+struct ScheduledSensor
+{
+  /// \brief Sensor, not kept alive by the scheduler
+  std::weak_ptr<Camera> sensor;
+
+  /// \brief Address of the sensor, to find it once it is destroyed
+  const Camera *key = nullptr;
+
+  /// \brief Update rate in Hz
+  double rate = 0.0;
+
+  /// \brief Relative cost of a render
+  double cost = 1.0;
+
+  /// \brief Ticks between two renders
+  int64_t period = 1;
+
+  /// \brief Tick, modulo the period, at which the sensor is rendered
+  int64_t phase = 0;
+
+  /// \brief Next tick at which the sensor is due, -1 until the first
+  /// update
+  int64_t nextDue = -1;
+};
+
+/// \brief Private data for the SensorScheduler class
+class ignition::rendering::SensorSchedulerPrivate
+{
+  /// \brief Choose the period and phase of a sensor, given the sensors
+  /// scheduled before it
+  /// \param[in] _index Index of the sensor in the schedules
+  public: void Place(size_t _index);
+
+  /// \brief Get the tick of a time
+  /// \param[in] _time Time
+  /// \return Index of the tick containing the time
+  public: int64_t Tick(std::chrono::steady_clock::duration _time) const;
+
+  /// \brief Find the schedule of a sensor
+  /// \param[in] _sensor Sensor
+  /// \return Index of the schedule, or the number of schedules if the
+  /// sensor is not scheduled
+  public: size_t Find(const Camera *_sensor) const;
+
+  /// \brief Period of the ticks
+  public: std::chrono::steady_clock::duration tickPeriod =
+      std::chrono::milliseconds(1);
+
+  /// \brief Schedules, in the order the sensors were added
+  public: std::vector<ScheduledSensor> schedules;
+};
+
+/// \brief Largest number of phases tried when placing a sensor
+static const int64_t kMaxPhaseCandidates = 64;
+
+/// \brief Largest horizon, in periods of the slowest sensor, over which
+/// the collisions of a phase are counted
+static const int64_t kMaxHorizonPeriods = 16;
+
+/// \brief Largest horizon, in periods of the sensor placed, over which the
+/// collisions of a phase are counted
+static const int64_t kMaxHorizonRenders = 1024;
+
+//////////////////////////////////////////////////
+/// \brief Get the first tick no earlier than a tick at which a sensor is
+/// due
+/// \param[in] _tick Tick
+/// \param[in] _schedule Schedule of the sensor
+/// \return First tick t >= _tick with (t - phase) a multiple of the period
+static int64_t alignTick(int64_t _tick, const ScheduledSensor &_schedule)
+{
+  int64_t offset = (_tick - _schedule.phase) % _schedule.period;
+  if (offset < 0)
+    offset += _schedule.period;
+  return offset == 0 ? _tick : _tick + _schedule.period - offset;
+}
+
+//////////////////////////////////////////////////
+void SensorSchedulerPrivate::Place(size_t _index)
+{
+  ScheduledSensor &placed = this->schedules[_index];
+
+  double ticks = (1.0 / placed.rate) /
+      std::chrono::duration<double>(this->tickPeriod).count();
+  placed.period = std::max<int64_t>(1,
+      static_cast<int64_t>(std::llround(std::min(ticks, 1e9))));
+  placed.nextDue = -1;
+
+  // collisions repeat every lcm of the periods, bounded to keep placing
+  // sensors of unrelated rates cheap
+  int64_t maxPeriod = placed.period;
+  for (size_t i = 0; i < _index; ++i)
+    maxPeriod = std::max(maxPeriod, this->schedules[i].period);
+  int64_t limit = std::min(kMaxHorizonPeriods * maxPeriod,
+      kMaxHorizonRenders * placed.period);
+  int64_t horizon = placed.period;
+  for (size_t i = 0; i < _index && horizon < limit; ++i)
+  {
+    int64_t period = this->schedules[i].period;
+    int64_t factor = period / std::gcd(horizon, period);
+    horizon = horizon > limit / factor ? limit : horizon * factor;
+  }
+  horizon = std::min(horizon, limit);
+
+  // try phases spread over the period and keep the cheapest, the first
+  // one on ties
+  int64_t candidates = std::min(placed.period, kMaxPhaseCandidates);
+  int64_t bestPhase = 0;
+  double bestCost = -1.0;
+  for (int64_t c = 0; c < candidates; ++c)
+  {
+    int64_t phase = c * placed.period / candidates;
+    double cost = 0.0;
+    for (int64_t t = phase; t < horizon; t += placed.period)
+    {
+      for (size_t i = 0; i < _index; ++i)
+      {
+        const ScheduledSensor &other = this->schedules[i];
+        if ((t - other.phase) % other.period == 0)
+          cost += other.cost;
+      }
+    }
+    if (bestCost < 0.0 || cost < bestCost)
+    {
+      bestCost = cost;
+      bestPhase = phase;
+    }
+  }
+  placed.phase = bestPhase;
+}
+
+//////////////////////////////////////////////////
+int64_t SensorSchedulerPrivate::Tick(
+    std::chrono::steady_clock::duration _time) const
+{
+  if (_time.count() < 0)
+    return 0;
+  return static_cast<int64_t>(_time / this->tickPeriod);
+}
+
+//////////////////////////////////////////////////
+size_t SensorSchedulerPrivate::Find(const Camera *_sensor) const
+{
+  for (size_t i = 0; i < this->schedules.size(); ++i)
+  {
+    if (this->schedules[i].key == _sensor)
+      return i;
+  }
+  return this->schedules.size();
+}
+
+//////////////////////////////////////////////////
+SensorScheduler::SensorScheduler()
+  : dataPtr(new SensorSchedulerPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+SensorScheduler::~SensorScheduler()
+{
+}
+
+//////////////////////////////////////////////////
+void SensorScheduler::SetTickPeriod(
+    std::chrono::steady_clock::duration _period)
+{
+  if (_period.count() <= 0)
+  {
+    ignerr << "Tick period of the sensor scheduler must be positive"
+           << std::endl;
+    return;
+  }
+  this->dataPtr->tickPeriod = _period;
+  for (size_t i = 0; i < this->dataPtr->schedules.size(); ++i)
+    this->dataPtr->Place(i);
+}
+
+//////////////////////////////////////////////////
+std::chrono::steady_clock::duration SensorScheduler::TickPeriod() const
+{
+  return this->dataPtr->tickPeriod;
+}
+
+//////////////////////////////////////////////////
+bool SensorScheduler::AddSensor(const CameraPtr &_sensor, double _rate,
+    double _cost)
+{
+  if (!_sensor)
+  {
+    ignerr << "Unable to schedule a null sensor" << std::endl;
+    return false;
+  }
+  if (!std::isfinite(_rate) || _rate <= 0.0)
+  {
+    ignerr << "Unable to schedule sensor '" << _sensor->Name()
+           << "', its rate must be positive: " << _rate << std::endl;
+    return false;
+  }
+  if (!std::isfinite(_cost) || _cost < 0.0)
+  {
+    ignerr << "Unable to schedule sensor '" << _sensor->Name()
+           << "', its cost must not be negative: " << _cost << std::endl;
+    return false;
+  }
+
+  // a sensor scheduled again is placed again, after the others
+  size_t index = this->dataPtr->Find(_sensor.get());
+  if (index < this->dataPtr->schedules.size())
+  {
+    this->dataPtr->schedules.erase(
+        this->dataPtr->schedules.begin() + index);
+  }
+
+  ScheduledSensor schedule;
+  schedule.sensor = _sensor;
+  schedule.key = _sensor.get();
+  schedule.rate = _rate;
+  schedule.cost = _cost;
+  this->dataPtr->schedules.push_back(schedule);
+  this->dataPtr->Place(this->dataPtr->schedules.size() - 1u);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool SensorScheduler::RemoveSensor(const CameraPtr &_sensor)
+{
+  size_t index = this->dataPtr->Find(_sensor.get());
+  if (!_sensor || index >= this->dataPtr->schedules.size())
+    return false;
+  this->dataPtr->schedules.erase(this->dataPtr->schedules.begin() + index);
+  return true;
+}
+
+//////////////////////////////////////////////////
+unsigned int SensorScheduler::SensorCount() const
+{
+  return static_cast<unsigned int>(this->dataPtr->schedules.size());
+}
+
+//////////////////////////////////////////////////
+unsigned int SensorScheduler::Phase(const CameraPtr &_sensor) const
+{
+  size_t index = this->dataPtr->Find(_sensor.get());
+  if (!_sensor || index >= this->dataPtr->schedules.size())
+    return 0u;
+  return static_cast<unsigned int>(this->dataPtr->schedules[index].phase);
+}
+
+//////////////////////////////////////////////////
+unsigned int SensorScheduler::Period(const CameraPtr &_sensor) const
+{
+  size_t index = this->dataPtr->Find(_sensor.get());
+  if (!_sensor || index >= this->dataPtr->schedules.size())
+    return 0u;
+  return static_cast<unsigned int>(this->dataPtr->schedules[index].period);
+}
+
+//////////////////////////////////////////////////
+std::vector<CameraPtr> SensorScheduler::DueSensors(
+    std::chrono::steady_clock::duration _time)
+{
+  std::vector<CameraPtr> due;
+  int64_t now = this->dataPtr->Tick(_time);
+
+  auto &schedules = this->dataPtr->schedules;
+  for (auto it = schedules.begin(); it != schedules.end();)
+  {
+    CameraPtr sensor = it->sensor.lock();
+    if (!sensor)
+    {
+      it = schedules.erase(it);
+      continue;
+    }
+
+    if (it->nextDue < 0)
+      it->nextDue = alignTick(now, *it);
+
+    if (now >= it->nextDue)
+    {
+      due.push_back(sensor);
+      // skip the ticks missed, keeping the phase
+      it->nextDue = alignTick(now + 1, *it);
+    }
+    ++it;
+  }
+  return due;
+}
+
+//////////////////////////////////////////////////
+unsigned int SensorScheduler::Update(
+    std::chrono::steady_clock::duration _time)
+{
+  std::vector<CameraPtr> due = this->DueSensors(_time);
+
+  // group the sensors by engine, keeping their order
+  std::vector<RenderEngine *> engines;
+  std::map<RenderEngine *, std::vector<CameraPtr>> sensors;
+  for (const auto &sensor : due)
+  {
+    ScenePtr scene = sensor->Scene();
+    if (!scene || !scene->Engine())
+    {
+      ignerr << "Unable to render sensor '" << sensor->Name()
+             << "', it has no scene" << std::endl;
+      continue;
+    }
+    RenderEngine *engine = scene->Engine();
+    if (sensors.find(engine) == sensors.end())
+      engines.push_back(engine);
+    sensors[engine].push_back(sensor);
+  }
+
+  unsigned int rendered = 0u;
+  for (auto engine : engines)
+  {
+    bool batch = !engine->RenderBatchActive();
+    if (batch)
+      engine->BeginRenderBatch();
+
+    std::set<Scene *> prepared;
+    for (const auto &sensor : sensors[engine])
+    {
+      ScenePtr scene = sensor->Scene();
+      if (prepared.insert(scene.get()).second)
+        scene->PreRender();
+    }
+
+    for (const auto &sensor : sensors[engine])
+    {
+      sensor->Render();
+      sensor->PostRender();
+      ++rendered;
+    }
+
+    if (batch)
+      engine->EndRenderBatch();
+  }
+  return rendered;
+}
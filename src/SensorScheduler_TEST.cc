@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/SensorScheduler.hh"
+
+using namespace ignition;
+using namespace rendering;
+using namespace std::chrono_literals;
+
+class SensorSchedulerTest : public testing::Test,
+                            public testing::WithParamInterface<const char*>
+{
+  /// \brief Test the phases and periods of the sensors
+  public: void Phases(const std::string &_renderEngine);
+
+  /// \brief Test the sensors due and their batched render
+  public: void Update(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+void SensorSchedulerTest::Phases(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  CameraPtr camera1 = scene->CreateCamera("camera1");
+  CameraPtr camera2 = scene->CreateCamera("camera2");
+  CameraPtr camera3 = scene->CreateCamera("camera3");
+  ASSERT_NE(nullptr, camera3);
+
+  SensorScheduler scheduler;
+  EXPECT_EQ(std::chrono::steady_clock::duration(1ms),
+      scheduler.TickPeriod());
+  EXPECT_EQ(0u, scheduler.SensorCount());
+
+  // invalid sensors and rates
+  EXPECT_FALSE(scheduler.AddSensor(nullptr, 10.0));
+  EXPECT_FALSE(scheduler.AddSensor(camera1, 0.0));
+  EXPECT_FALSE(scheduler.AddSensor(camera1, -1.0));
+  EXPECT_FALSE(scheduler.AddSensor(camera1, 10.0, -1.0));
+  EXPECT_EQ(0u, scheduler.SensorCount());
+  EXPECT_EQ(0u, scheduler.Period(camera1));
+
+  // sensors of the same rate are staggered
+  scheduler.SetTickPeriod(10ms);
+  EXPECT_TRUE(scheduler.AddSensor(camera1, 25.0));
+  EXPECT_TRUE(scheduler.AddSensor(camera2, 25.0));
+  EXPECT_EQ(2u, scheduler.SensorCount());
+  EXPECT_EQ(4u, scheduler.Period(camera1));
+  EXPECT_EQ(4u, scheduler.Period(camera2));
+  EXPECT_EQ(0u, scheduler.Phase(camera1));
+  EXPECT_NE(scheduler.Phase(camera1), scheduler.Phase(camera2));
+
+  // a slower sensor avoids the ticks of the others
+  EXPECT_TRUE(scheduler.AddSensor(camera3, 12.5));
+  EXPECT_EQ(8u, scheduler.Period(camera3));
+  unsigned int phase3 = scheduler.Phase(camera3) % 4u;
+  EXPECT_NE(scheduler.Phase(camera1), phase3);
+  EXPECT_NE(scheduler.Phase(camera2), phase3);
+
+  // changing the tick period places the sensors again
+  scheduler.SetTickPeriod(20ms);
+  EXPECT_EQ(2u, scheduler.Period(camera1));
+  EXPECT_EQ(4u, scheduler.Period(camera3));
+  scheduler.SetTickPeriod(0ms);
+  EXPECT_EQ(std::chrono::steady_clock::duration(20ms),
+      scheduler.TickPeriod());
+
+  EXPECT_TRUE(scheduler.RemoveSensor(camera2));
+  EXPECT_FALSE(scheduler.RemoveSensor(camera2));
+  EXPECT_EQ(2u, scheduler.SensorCount());
+
+  // sensors destroyed are removed
+  scene->DestroySensor(camera3);
+  camera3.reset();
+  scheduler.DueSensors(0ms);
+  EXPECT_EQ(1u, scheduler.SensorCount());
+
+  // Clean up
+  engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+void SensorSchedulerTest::Update(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  CameraPtr camera1 = scene->CreateCamera("camera1");
+  CameraPtr camera2 = scene->CreateCamera("camera2");
+  ASSERT_NE(nullptr, camera2);
+  camera1->SetImageWidth(32u);
+  camera1->SetImageHeight(32u);
+  camera2->SetImageWidth(32u);
+  camera2->SetImageHeight(32u);
+
+  SensorScheduler scheduler;
+  scheduler.SetTickPeriod(10ms);
+  EXPECT_TRUE(scheduler.AddSensor(camera1, 50.0));
+  EXPECT_TRUE(scheduler.AddSensor(camera2, 50.0));
+  EXPECT_EQ(0u, scheduler.Phase(camera1));
+  EXPECT_EQ(1u, scheduler.Phase(camera2));
+
+  // the sensors render on alternate ticks
+  unsigned int rendered1 = 0u;
+  unsigned int rendered2 = 0u;
+  for (int tick = 0; tick < 10; ++tick)
+  {
+    std::vector<CameraPtr> due = scheduler.DueSensors(tick * 10ms);
+    ASSERT_EQ(1u, due.size());
+    if (due[0] == camera1)
+      ++rendered1;
+    else if (due[0] == camera2)
+      ++rendered2;
+  }
+  EXPECT_EQ(5u, rendered1);
+  EXPECT_EQ(5u, rendered2);
+
+  // a sensor is due once per tick
+  EXPECT_TRUE(scheduler.DueSensors(90ms).empty());
+
+  // sensors due after missed ticks are rendered once, together
+  EXPECT_EQ(2u, scheduler.Update(150ms));
+  EXPECT_FALSE(engine->RenderBatchActive());
+  EXPECT_EQ(1u, scheduler.Update(160ms));
+  EXPECT_EQ(0u, scheduler.Update(165ms));
+
+  // an active batch is left to the caller
+  engine->BeginRenderBatch();
+  EXPECT_EQ(1u, scheduler.Update(170ms));
+  if (_renderEngine == "ogre2")
+    EXPECT_TRUE(engine->RenderBatchActive());
+  engine->EndRenderBatch();
+  EXPECT_FALSE(engine->RenderBatchActive());
+
+  // Clean up
+  engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+TEST_P(SensorSchedulerTest, Phases)
+{
+  Phases(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SensorSchedulerTest, Update)
+{
+  Update(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(SensorScheduler, SensorSchedulerTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/RenderPassSystem.hh"
+#include "ignition/rendering/ShaderParams.hh"
+#include "ignition/rendering/ShaderPass.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+class ShaderPassTest : public testing::Test,
+                       public testing::WithParamInterface<const char*>
+{
+  /// \brief Test shader pass kernel and params
+  public: void Kernel(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+void ShaderPassTest::Kernel(const std::string &_renderEngine)
+{
+  // get engine
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  // get the render pass system
+  RenderPassSystemPtr rpSystem = engine->RenderPassSystem();
+  if (!rpSystem)
+  {
+    ignwarn << "Render engine '" << _renderEngine << "' does not support "
+            << "render pass system" << std::endl;
+    return;
+  }
+  ShaderPassPtr shaderPass = std::dynamic_pointer_cast<ShaderPass>(
+      rpSystem->Create<ShaderPass>());
+  if (!shaderPass)
+  {
+    ignwarn << "Render engine '" << _renderEngine << "' does not support "
+            << "shader passes" << std::endl;
+    return;
+  }
+
+  // verify initial values
+  EXPECT_TRUE(shaderPass->Kernel().empty());
+  ASSERT_NE(nullptr, shaderPass->KernelParams());
+  EXPECT_TRUE(shaderPass->KernelParams()->begin() ==
+      shaderPass->KernelParams()->end());
+
+  // kernel
+  std::string kernel =
+      "uniform float gain;\n"
+      "vec4 kernel(vec2 uv)\n"
+      "{\n"
+      "  return texture(RT, uv) * gain;\n"
+      "}\n";
+  shaderPass->SetKernel(kernel);
+  EXPECT_EQ(kernel, shaderPass->Kernel());
+
+  // params
+  (*shaderPass->KernelParams())["gain"] = 0.5f;
+  float gain = 0.0f;
+  EXPECT_TRUE((*shaderPass->KernelParams())["gain"].Value(&gain));
+  EXPECT_FLOAT_EQ(0.5f, gain);
+}
+
+/////////////////////////////////////////////////
+TEST_P(ShaderPassTest, Kernel)
+{
+  Kernel(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(ShaderPass, ShaderPassTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
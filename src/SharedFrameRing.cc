@@ -0,0 +1,468 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/Image.hh"
+#include "ignition/rendering/SharedFrameRing.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Identifies the shared memory of a ring
+static const uint32_t kSharedFrameRingMagic = 0x49524652u;
+
+/// \brief Version of the layout of the shared memory
+static const uint32_t kSharedFrameRingVersion = 1u;
+
+/// \brief Alignment of the headers and frames in the shared memory
+static const size_t kSharedFrameRingAlignment = 64u;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+    "shared frame rings need lock free 64 bit atomics");
+
+/// \brief Header at the start of the shared memory of a ring
+struct alignas(64) SharedRingHeader
+{
+  /// \brief kSharedFrameRingMagic once the ring is initialized
+  std::atomic<uint32_t> magic;
+
+  /// \brief kSharedFrameRingVersion
+  uint32_t version;
+
+  /// \brief Number of slots
+  uint32_t slotCount;
+
+  /// \brief Maximum number of bytes of a frame
+  uint64_t slotSize;
+
+  /// \brief Number of frames written
+  std::atomic<uint64_t> writeCount;
+};
+
+/// \brief Header of a slot, followed by the frame data
+struct alignas(64) SharedSlotHeader
+{
+  /// \brief 2 * sequence + 1 while the frame of the given sequence number
+  /// is written, 2 * sequence + 2 once it is written
+  std::atomic<uint64_t> state;
+
+  /// \brief Frame width in pixels
+  uint32_t width;
+
+  /// \brief Frame height in pixels
+  uint32_t height;
+
+  /// \brief Number of channels per pixel
+  uint32_t channels;
+
+  /// \brief PixelFormat of the frame
+  uint32_t format;
+
+  /// \brief Number of bytes of the frame
+  uint64_t size;
+};
+
+/// \brief Private data for the SharedFrameRing class
+class ignition::rendering::SharedFrameRingPrivate
+{
+  /// \brief Get the header of a slot
+  /// \param[in] _sequence Sequence number of a frame in the slot
+  /// \return Slot header
+  public: SharedSlotHeader *Slot(uint64_t _sequence) const
+  {
+    size_t index = static_cast<size_t>(_sequence % this->header->slotCount);
+    return reinterpret_cast<SharedSlotHeader *>(
+        this->memory + sizeof(SharedRingHeader) + index * this->stride);
+  }
+
+  /// \brief Start writing the next frame
+  /// \param[in] _info Description of the frame
+  /// \param[out] _sequence Sequence number of the frame
+  /// \return Slot data to write the frame to
+  public: unsigned char *BeginWrite(const SharedFrameInfo &_info,
+      uint64_t &_sequence);
+
+  /// \brief Publish a frame
+  /// \param[in] _sequence Sequence number returned by BeginWrite
+  public: void EndWrite(uint64_t _sequence);
+
+  /// \brief Unmap the ring
+  public: void Close();
+
+  /// \brief Mapped shared memory
+  public: unsigned char *memory = nullptr;
+
+  /// \brief Header of the ring, at the start of memory
+  public: SharedRingHeader *header = nullptr;
+
+  /// \brief Size of the mapping
+  public: size_t mappedSize = 0u;
+
+  /// \brief Bytes between the start of two slots
+  public: size_t stride = 0u;
+
+  /// \brief Name of the ring
+  public: std::string name;
+
+  /// \brief True if the ring was created by this object
+  public: bool producer = false;
+};
+
+/////////////////////////////////////////////////
+/// \brief Round a size up to the alignment of the ring
+/// \param[in] _size Size in bytes
+/// \return Aligned size
+static size_t alignSize(size_t _size)
+{
+  return (_size + kSharedFrameRingAlignment - 1u) /
+      kSharedFrameRingAlignment * kSharedFrameRingAlignment;
+}
+
+//////////////////////////////////////////////////
+unsigned char *SharedFrameRingPrivate::BeginWrite(
+    const SharedFrameInfo &_info, uint64_t &_sequence)
+{
+  if (!this->producer)
+  {
+    ignerr << "Only the producer of shared frame ring [" << this->name
+           << "] can write frames" << std::endl;
+    return nullptr;
+  }
+  if (_info.size > this->header->slotSize)
+  {
+    ignerr << "Frame of " << _info.size << " bytes does not fit in the "
+           << this->header->slotSize << " bytes slots of shared frame ring ["
+           << this->name << "]" << std::endl;
+    return nullptr;
+  }
+
+  _sequence = this->header->writeCount.load(std::memory_order_relaxed);
+  SharedSlotHeader *slot = this->Slot(_sequence);
+  slot->state.store(2u * _sequence + 1u, std::memory_order_relaxed);
+  // readers must see the slot as being written before the data changes
+  std::atomic_thread_fence(std::memory_order_release);
+  slot->width = _info.width;
+  slot->height = _info.height;
+  slot->channels = _info.channels;
+  slot->format = static_cast<uint32_t>(_info.format);
+  slot->size = _info.size;
+  return reinterpret_cast<unsigned char *>(slot) + sizeof(SharedSlotHeader);
+}
+
+//////////////////////////////////////////////////
+void SharedFrameRingPrivate::EndWrite(uint64_t _sequence)
+{
+  this->Slot(_sequence)->state.store(2u * _sequence + 2u,
+      std::memory_order_release);
+  this->header->writeCount.store(_sequence + 1u, std::memory_order_release);
+}
+
+//////////////////////////////////////////////////
+void SharedFrameRingPrivate::Close()
+{
+#ifndef _WIN32
+  if (this->memory)
+    munmap(this->memory, this->mappedSize);
+  if (this->producer)
+    shm_unlink(this->name.c_str());
+#endif
+  this->memory = nullptr;
+  this->header = nullptr;
+  this->mappedSize = 0u;
+  this->stride = 0u;
+  this->producer = false;
+}
+
+//////////////////////////////////////////////////
+SharedFrameRing::SharedFrameRing()
+  : dataPtr(new SharedFrameRingPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+SharedFrameRing::~SharedFrameRing()
+{
+  this->dataPtr->Close();
+}
+
+//////////////////////////////////////////////////
+bool SharedFrameRing::Create(const std::string &_name,
+    unsigned int _slotCount, size_t _slotSize)
+{
+#ifdef _WIN32
+  ignerr << "Shared frame rings are not supported on Windows" << std::endl;
+  return false;
+#else
+  if (_name.empty() || _slotCount < 2u || _slotSize == 0u)
+  {
+    ignerr << "Shared frame ring [" << _name << "] needs a name, at least "
+           << "two slots and a slot size" << std::endl;
+    return false;
+  }
+  this->dataPtr->Close();
+
+  size_t stride = sizeof(SharedSlotHeader) + alignSize(_slotSize);
+  size_t size = sizeof(SharedRingHeader) + stride * _slotCount;
+
+  // replace the ring left by a producer that did not exit cleanly
+  shm_unlink(_name.c_str());
+  int fd = shm_open(_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0)
+  {
+    ignerr << "Unable to create shared memory [" << _name << "]: "
+           << std::strerror(errno) << std::endl;
+    return false;
+  }
+  if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+  {
+    ignerr << "Unable to allocate " << size << " bytes of shared memory ["
+           << _name << "]: " << std::strerror(errno) << std::endl;
+    close(fd);
+    shm_unlink(_name.c_str());
+    return false;
+  }
+  void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+      fd, 0);
+  close(fd);
+  if (memory == MAP_FAILED)
+  {
+    ignerr << "Unable to map shared memory [" << _name << "]: "
+           << std::strerror(errno) << std::endl;
+    shm_unlink(_name.c_str());
+    return false;
+  }
+
+  // the memory is zero filled, so every slot starts unwritten
+  this->dataPtr->memory = static_cast<unsigned char *>(memory);
+  this->dataPtr->header = static_cast<SharedRingHeader *>(memory);
+  this->dataPtr->mappedSize = size;
+  this->dataPtr->stride = stride;
+  this->dataPtr->name = _name;
+  this->dataPtr->producer = true;
+
+  SharedRingHeader *header = this->dataPtr->header;
+  header->version = kSharedFrameRingVersion;
+  header->slotCount = _slotCount;
+  header->slotSize = _slotSize;
+  header->writeCount.store(0u, std::memory_order_relaxed);
+  header->magic.store(kSharedFrameRingMagic, std::memory_order_release);
+  return true;
+#endif
+}
+
+//////////////////////////////////////////////////
+bool SharedFrameRing::Open(const std::string &_name)
+{
+#ifdef _WIN32
+  ignerr << "Shared frame rings are not supported on Windows" << std::endl;
+  return false;
+#else
+  this->dataPtr->Close();
+
+  int fd = shm_open(_name.c_str(), O_RDWR, 0600);
+  if (fd < 0)
+  {
+    ignerr << "Unable to open shared memory [" << _name << "]: "
+           << std::strerror(errno) << std::endl;
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) < sizeof(SharedRingHeader))
+  {
+    ignerr << "Shared memory [" << _name << "] is not a shared frame ring"
+           << std::endl;
+    close(fd);
+    return false;
+  }
+  size_t size = static_cast<size_t>(st.st_size);
+  void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+      fd, 0);
+  close(fd);
+  if (memory == MAP_FAILED)
+  {
+    ignerr << "Unable to map shared memory [" << _name << "]: "
+           << std::strerror(errno) << std::endl;
+    return false;
+  }
+
+  SharedRingHeader *header = static_cast<SharedRingHeader *>(memory);
+  size_t stride = sizeof(SharedSlotHeader) + alignSize(header->slotSize);
+  if (header->magic.load(std::memory_order_acquire) !=
+      kSharedFrameRingMagic || header->version != kSharedFrameRingVersion ||
+      header->slotCount < 2u ||
+      sizeof(SharedRingHeader) + stride * header->slotCount > size)
+  {
+    ignerr << "Shared memory [" << _name << "] is not a shared frame ring "
+           << "of version " << kSharedFrameRingVersion << std::endl;
+    munmap(memory, size);
+    return false;
+  }
+
+  this->dataPtr->memory = static_cast<unsigned char *>(memory);
+  this->dataPtr->header = header;
+  this->dataPtr->mappedSize = size;
+  this->dataPtr->stride = stride;
+  this->dataPtr->name = _name;
+  this->dataPtr->producer = false;
+  return true;
+#endif
+}
+
+//////////////////////////////////////////////////
+bool SharedFrameRing::Valid() const
+{
+  return this->dataPtr->header != nullptr;
+}
+
+//////////////////////////////////////////////////
+unsigned int SharedFrameRing::SlotCount() const
+{
+  return this->dataPtr->header ? this->dataPtr->header->slotCount : 0u;
+}
+
+//////////////////////////////////////////////////
+size_t SharedFrameRing::SlotSize() const
+{
+  return this->dataPtr->header ?
+      static_cast<size_t>(this->dataPtr->header->slotSize) : 0u;
+}
+
+//////////////////////////////////////////////////
+bool SharedFrameRing::Write(const void *_data, const SharedFrameInfo &_info)
+{
+  if (!this->dataPtr->header || (!_data && _info.size > 0u))
+    return false;
+
+  uint64_t sequence = 0u;
+  unsigned char *dst = this->dataPtr->BeginWrite(_info, sequence);
+  if (!dst)
+    return false;
+  std::memcpy(dst, _data, _info.size);
+  this->dataPtr->EndWrite(sequence);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool SharedFrameRing::WriteCameraFrame(const Camera &_camera)
+{
+  if (!this->dataPtr->header)
+    return false;
+
+  SharedFrameInfo info;
+  info.width = _camera.ImageWidth();
+  info.height = _camera.ImageHeight();
+  info.format = _camera.ImageFormat();
+  info.channels = PixelUtil::ChannelCount(info.format);
+  info.size = _camera.ImageMemorySize();
+
+  uint64_t sequence = 0u;
+  unsigned char *dst = this->dataPtr->BeginWrite(info, sequence);
+  if (!dst)
+    return false;
+
+  // the camera reads its frame back straight into the slot
+  Image image(info.width, info.height, info.format, dst);
+  _camera.Copy(image);
+  this->dataPtr->EndWrite(sequence);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool SharedFrameRing::WriteFloatFrame(const float *_data,
+    unsigned int _width, unsigned int _height, unsigned int _channels)
+{
+  SharedFrameInfo info;
+  info.width = _width;
+  info.height = _height;
+  info.channels = _channels;
+  info.format = _channels == 1u ? PF_FLOAT32_R :
+      (_channels == 3u ? PF_FLOAT32_RGB :
+      (_channels == 4u ? PF_FLOAT32_RGBA : PF_UNKNOWN));
+  info.size = static_cast<size_t>(_width) * _height * _channels *
+      sizeof(float);
+  return this->Write(_data, info);
+}
+
+//////////////////////////////////////////////////
+uint64_t SharedFrameRing::WriteCount() const
+{
+  if (!this->dataPtr->header)
+    return 0u;
+  return this->dataPtr->header->writeCount.load(std::memory_order_acquire);
+}
+
+//////////////////////////////////////////////////
+const void *SharedFrameRing::FrameData(uint64_t _sequence,
+    SharedFrameInfo &_info) const
+{
+  if (!this->FrameValid(_sequence))
+    return nullptr;
+
+  const SharedSlotHeader *slot = this->dataPtr->Slot(_sequence);
+  _info.sequence = _sequence;
+  _info.width = slot->width;
+  _info.height = slot->height;
+  _info.channels = slot->channels;
+  _info.format = static_cast<PixelFormat>(slot->format);
+  _info.size = static_cast<size_t>(slot->size);
+  if (_info.size > this->dataPtr->header->slotSize)
+    return nullptr;
+  return reinterpret_cast<const unsigned char *>(slot) +
+      sizeof(SharedSlotHeader);
+}
+
+//////////////////////////////////////////////////
+bool SharedFrameRing::FrameValid(uint64_t _sequence) const
+{
+  if (!this->dataPtr->header)
+    return false;
+
+  // order the reads of the frame before the check of its slot
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return this->dataPtr->Slot(_sequence)->state.load(
+      std::memory_order_acquire) == 2u * _sequence + 2u;
+}
+
+//////////////////////////////////////////////////
+bool SharedFrameRing::Read(uint64_t _sequence, SharedFrameInfo &_info,
+    void *_data, size_t _size) const
+{
+  SharedFrameInfo info;
+  const void *src = this->FrameData(_sequence, info);
+  if (!src || info.size > _size)
+    return false;
+
+  std::memcpy(_data, src, info.size);
+  if (!this->FrameValid(_sequence))
+    return false;
+  _info = info;
+  return true;
+}
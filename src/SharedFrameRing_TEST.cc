@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <ignition/utilities/ExtraTestMacros.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/SharedFrameRing.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(SharedFrameRingTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(WriteRead))
+{
+  std::string name = "/ign_rendering_shared_frame_ring_test";
+  SharedFrameRing producer;
+  EXPECT_FALSE(producer.Valid());
+  EXPECT_FALSE(producer.Create(name, 1u, 64u));
+  ASSERT_TRUE(producer.Create(name, 2u, 64u));
+  EXPECT_TRUE(producer.Valid());
+  EXPECT_EQ(0u, producer.WriteCount());
+
+  SharedFrameRing consumer;
+  ASSERT_TRUE(consumer.Open(name));
+  EXPECT_EQ(2u, consumer.SlotCount());
+  EXPECT_EQ(64u, consumer.SlotSize());
+
+  // nothing is written yet
+  SharedFrameInfo info;
+  std::vector<float> frame(8u);
+  EXPECT_FALSE(consumer.Read(0u, info, frame.data(),
+      frame.size() * sizeof(float)));
+
+  for (unsigned int i = 0u; i < 3u; ++i)
+  {
+    std::vector<float> data(8u, static_cast<float>(i));
+    EXPECT_TRUE(producer.WriteFloatFrame(data.data(), 4u, 2u, 1u));
+  }
+  EXPECT_EQ(3u, consumer.WriteCount());
+
+  // the latest frame is read back
+  ASSERT_TRUE(consumer.Read(2u, info, frame.data(),
+      frame.size() * sizeof(float)));
+  EXPECT_EQ(2u, info.sequence);
+  EXPECT_EQ(4u, info.width);
+  EXPECT_EQ(2u, info.height);
+  EXPECT_EQ(1u, info.channels);
+  EXPECT_EQ(PF_FLOAT32_R, info.format);
+  EXPECT_EQ(8u * sizeof(float), info.size);
+  for (float value : frame)
+    EXPECT_FLOAT_EQ(2.0f, value);
+
+  // in place access to the previous frame
+  const float *data =
+      static_cast<const float *>(consumer.FrameData(1u, info));
+  ASSERT_NE(nullptr, data);
+  EXPECT_FLOAT_EQ(1.0f, data[0]);
+  EXPECT_TRUE(consumer.FrameValid(1u));
+
+  // the first frame is overwritten
+  EXPECT_FALSE(consumer.FrameValid(0u));
+  EXPECT_EQ(nullptr, consumer.FrameData(0u, info));
+
+  // buffers too small, frames too large and consumer writes fail
+  EXPECT_FALSE(consumer.Read(2u, info, frame.data(), sizeof(float)));
+  std::vector<float> large(32u);
+  EXPECT_FALSE(producer.WriteFloatFrame(large.data(), 32u, 1u, 1u));
+  EXPECT_FALSE(consumer.WriteFloatFrame(frame.data(), 4u, 2u, 1u));
+  EXPECT_EQ(3u, producer.WriteCount());
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
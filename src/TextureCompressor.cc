@@ -0,0 +1,494 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+#include "ignition/rendering/TextureCompressor.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+/// \brief Get the number of bytes of a compressed 4x4 block
+/// \param[in] _format Compression format
+/// \return Size of block in bytes
+static size_t BlockSize(TextureCompression _format)
+{
+  return _format == TC_BC1 ? 8u : 16u;
+}
+
+//////////////////////////////////////////////////
+/// \brief Quantize a color to 5:6:5 bits
+/// \param[in] _color RGB color
+/// \return Packed color
+static uint16_t PackColor(const float _color[3])
+{
+  auto quantize = [](float _value, int _max)
+  {
+    int v = static_cast<int>(_value * _max / 255.0f + 0.5f);
+    return static_cast<uint16_t>(std::min(std::max(v, 0), _max));
+  };
+  return static_cast<uint16_t>((quantize(_color[0], 31) << 11) |
+      (quantize(_color[1], 63) << 5) | quantize(_color[2], 31));
+}
+
+//////////////////////////////////////////////////
+/// \brief Expand a 5:6:5 color to 8 bits per channel
+/// \param[in] _packed Packed color
+/// \param[out] _color RGB color
+static void UnpackColor(uint16_t _packed, int _color[3])
+{
+  int r = (_packed >> 11) & 31;
+  int g = (_packed >> 5) & 63;
+  int b = _packed & 31;
+  _color[0] = (r << 3) | (r >> 2);
+  _color[1] = (g << 2) | (g >> 4);
+  _color[2] = (b << 3) | (b >> 2);
+}
+
+//////////////////////////////////////////////////
+/// \brief Compress the colors of a 4x4 block in 4 color mode. End points
+/// are picked along the principal axis of the colors of the block.
+/// \param[in] _block 16 RGBA pixels
+/// \param[out] _out 8 bytes of compressed block
+static void CompressColorBlock(const unsigned char *_block,
+    unsigned char *_out)
+{
+  float mean[3] = {0.0f, 0.0f, 0.0f};
+  for (unsigned int i = 0; i < 16u; ++i)
+  {
+    for (unsigned int c = 0; c < 3u; ++c)
+      mean[c] += _block[i * 4u + c] / 16.0f;
+  }
+
+  float cov[6] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+  for (unsigned int i = 0; i < 16u; ++i)
+  {
+    float r = _block[i * 4u] - mean[0];
+    float g = _block[i * 4u + 1u] - mean[1];
+    float b = _block[i * 4u + 2u] - mean[2];
+    cov[0] += r * r;
+    cov[1] += r * g;
+    cov[2] += r * b;
+    cov[3] += g * g;
+    cov[4] += g * b;
+    cov[5] += b * b;
+  }
+
+  // power iteration for the principal axis, starting from the covariance
+  // column of the channel with the largest variance
+  float axis[3] = {cov[0], cov[1], cov[2]};
+  if (cov[3] > cov[0] && cov[3] >= cov[5])
+  {
+    axis[0] = cov[1];
+    axis[1] = cov[3];
+    axis[2] = cov[4];
+  }
+  else if (cov[5] > cov[0] && cov[5] > cov[3])
+  {
+    axis[0] = cov[2];
+    axis[1] = cov[4];
+    axis[2] = cov[5];
+  }
+  for (unsigned int iter = 0; iter < 8u; ++iter)
+  {
+    float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+    float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+    float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+    float len = std::max(std::max(std::abs(x), std::abs(y)), std::abs(z));
+    if (len <= 0.0f)
+      break;
+    axis[0] = x / len;
+    axis[1] = y / len;
+    axis[2] = z / len;
+  }
+
+  float minProj = std::numeric_limits<float>::max();
+  float maxProj = -std::numeric_limits<float>::max();
+  for (unsigned int i = 0; i < 16u; ++i)
+  {
+    float proj = 0.0f;
+    for (unsigned int c = 0; c < 3u; ++c)
+      proj += (_block[i * 4u + c] - mean[c]) * axis[c];
+    minProj = std::min(minProj, proj);
+    maxProj = std::max(maxProj, proj);
+  }
+
+  // end points on the axis, inset slightly to reduce the quantization error
+  float len2 = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+  float inset = (maxProj - minProj) / 16.0f;
+  float maxColor[3];
+  float minColor[3];
+  for (unsigned int c = 0; c < 3u; ++c)
+  {
+    float dir = len2 > 0.0f ? axis[c] / len2 : 0.0f;
+    maxColor[c] = mean[c] + (maxProj - inset) * dir;
+    minColor[c] = mean[c] + (minProj + inset) * dir;
+  }
+
+  uint16_t c0 = PackColor(maxColor);
+  uint16_t c1 = PackColor(minColor);
+  if (c0 < c1)
+    std::swap(c0, c1);
+
+  uint32_t indices = 0u;
+  if (c0 != c1)
+  {
+    int palette[4][3];
+    UnpackColor(c0, palette[0]);
+    UnpackColor(c1, palette[1]);
+    for (unsigned int c = 0; c < 3u; ++c)
+    {
+      palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+      palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+
+    for (unsigned int i = 0; i < 16u; ++i)
+    {
+      uint32_t best = 0u;
+      int bestDist = std::numeric_limits<int>::max();
+      for (uint32_t p = 0; p < 4u; ++p)
+      {
+        int dist = 0;
+        for (unsigned int c = 0; c < 3u; ++c)
+        {
+          int d = _block[i * 4u + c] - palette[p][c];
+          dist += d * d;
+        }
+        if (dist < bestDist)
+        {
+          bestDist = dist;
+          best = p;
+        }
+      }
+      indices |= best << (2u * i);
+    }
+  }
+
+  _out[0] = static_cast<unsigned char>(c0 & 0xFF);
+  _out[1] = static_cast<unsigned char>(c0 >> 8);
+  _out[2] = static_cast<unsigned char>(c1 & 0xFF);
+  _out[3] = static_cast<unsigned char>(c1 >> 8);
+  for (unsigned int i = 0; i < 4u; ++i)
+    _out[4u + i] = static_cast<unsigned char>((indices >> (8u * i)) & 0xFF);
+}
+
+//////////////////////////////////////////////////
+/// \brief Compress the alpha of a 4x4 block in 8 value mode
+/// \param[in] _block 16 RGBA pixels
+/// \param[out] _out 8 bytes of compressed block
+static void CompressAlphaBlock(const unsigned char *_block,
+    unsigned char *_out)
+{
+  int a0 = 0;
+  int a1 = 255;
+  for (unsigned int i = 0; i < 16u; ++i)
+  {
+    a0 = std::max(a0, static_cast<int>(_block[i * 4u + 3u]));
+    a1 = std::min(a1, static_cast<int>(_block[i * 4u + 3u]));
+  }
+
+  uint64_t indices = 0u;
+  if (a0 != a1)
+  {
+    int palette[8];
+    palette[0] = a0;
+    palette[1] = a1;
+    for (int p = 1; p < 7; ++p)
+      palette[p + 1] = ((7 - p) * a0 + p * a1) / 7;
+
+    for (unsigned int i = 0; i < 16u; ++i)
+    {
+      uint64_t best = 0u;
+      int bestDist = std::numeric_limits<int>::max();
+      for (uint64_t p = 0; p < 8u; ++p)
+      {
+        int dist = std::abs(_block[i * 4u + 3u] - palette[p]);
+        if (dist < bestDist)
+        {
+          bestDist = dist;
+          best = p;
+        }
+      }
+      indices |= best << (3u * i);
+    }
+  }
+
+  _out[0] = static_cast<unsigned char>(a0);
+  _out[1] = static_cast<unsigned char>(a1);
+  for (unsigned int i = 0; i < 6u; ++i)
+    _out[2u + i] = static_cast<unsigned char>((indices >> (8u * i)) & 0xFF);
+}
+
+//////////////////////////////////////////////////
+/// \brief Scale an image down to half its size with a box filter
+/// \param[in] _rgba Image data
+/// \param[in] _width Width of image in pixels
+/// \param[in] _height Height of image in pixels
+/// \return Image data of the next mipmap
+static std::vector<unsigned char> HalfSize(
+    const std::vector<unsigned char> &_rgba, unsigned int _width,
+    unsigned int _height)
+{
+  unsigned int width = std::max(1u, _width / 2u);
+  unsigned int height = std::max(1u, _height / 2u);
+  std::vector<unsigned char> result(width * height * 4u);
+  for (unsigned int y = 0; y < height; ++y)
+  {
+    unsigned int y0 = std::min(y * 2u, _height - 1u);
+    unsigned int y1 = std::min(y * 2u + 1u, _height - 1u);
+    for (unsigned int x = 0; x < width; ++x)
+    {
+      unsigned int x0 = std::min(x * 2u, _width - 1u);
+      unsigned int x1 = std::min(x * 2u + 1u, _width - 1u);
+      for (unsigned int c = 0; c < 4u; ++c)
+      {
+        unsigned int sum = _rgba[(y0 * _width + x0) * 4u + c] +
+            _rgba[(y0 * _width + x1) * 4u + c] +
+            _rgba[(y1 * _width + x0) * 4u + c] +
+            _rgba[(y1 * _width + x1) * 4u + c];
+        result[(y * width + x) * 4u + c] =
+            static_cast<unsigned char>((sum + 2u) / 4u);
+      }
+    }
+  }
+  return result;
+}
+
+//////////////////////////////////////////////////
+size_t TextureCompressor::CompressedSize(unsigned int _width,
+    unsigned int _height, TextureCompression _format)
+{
+  size_t blocksX = (_width + 3u) / 4u;
+  size_t blocksY = (_height + 3u) / 4u;
+  return blocksX * blocksY * BlockSize(_format);
+}
+
+//////////////////////////////////////////////////
+std::vector<unsigned char> TextureCompressor::Compress(
+    const unsigned char *_rgba, unsigned int _width, unsigned int _height,
+    TextureCompression _format)
+{
+  std::vector<unsigned char> result;
+  if (!_rgba || _width == 0u || _height == 0u)
+    return result;
+
+  result.resize(CompressedSize(_width, _height, _format));
+  size_t blockSize = BlockSize(_format);
+  unsigned int blocksX = (_width + 3u) / 4u;
+  unsigned int blocksY = (_height + 3u) / 4u;
+  unsigned char block[64];
+  for (unsigned int by = 0; by < blocksY; ++by)
+  {
+    for (unsigned int bx = 0; bx < blocksX; ++bx)
+    {
+      for (unsigned int y = 0; y < 4u; ++y)
+      {
+        unsigned int py = std::min(by * 4u + y, _height - 1u);
+        for (unsigned int x = 0; x < 4u; ++x)
+        {
+          unsigned int px = std::min(bx * 4u + x, _width - 1u);
+          std::copy(_rgba + (py * _width + px) * 4u,
+              _rgba + (py * _width + px) * 4u + 4u, block + (y * 4u + x) * 4u);
+        }
+      }
+
+      unsigned char *out = result.data() + (by * blocksX + bx) * blockSize;
+      if (_format == TC_BC3)
+      {
+        CompressAlphaBlock(block, out);
+        out += 8u;
+      }
+      CompressColorBlock(block, out);
+    }
+  }
+  return result;
+}
+
+//////////////////////////////////////////////////
+std::vector<unsigned char> TextureCompressor::Decompress(
+    const unsigned char *_data, unsigned int _width, unsigned int _height,
+    TextureCompression _format)
+{
+  std::vector<unsigned char> result;
+  if (!_data || _width == 0u || _height == 0u)
+    return result;
+
+  result.resize(_width * _height * 4u);
+  size_t blockSize = BlockSize(_format);
+  unsigned int blocksX = (_width + 3u) / 4u;
+  unsigned int blocksY = (_height + 3u) / 4u;
+  for (unsigned int by = 0; by < blocksY; ++by)
+  {
+    for (unsigned int bx = 0; bx < blocksX; ++bx)
+    {
+      const unsigned char *in = _data + (by * blocksX + bx) * blockSize;
+
+      int alpha[8];
+      uint64_t alphaIndices = 0u;
+      if (_format == TC_BC3)
+      {
+        alpha[0] = in[0];
+        alpha[1] = in[1];
+        if (alpha[0] > alpha[1])
+        {
+          for (int p = 1; p < 7; ++p)
+            alpha[p + 1] = ((7 - p) * alpha[0] + p * alpha[1]) / 7;
+        }
+        else
+        {
+          for (int p = 1; p < 5; ++p)
+            alpha[p + 1] = ((5 - p) * alpha[0] + p * alpha[1]) / 5;
+          alpha[6] = 0;
+          alpha[7] = 255;
+        }
+        for (unsigned int i = 0; i < 6u; ++i)
+          alphaIndices |= static_cast<uint64_t>(in[2u + i]) << (8u * i);
+        in += 8u;
+      }
+
+      uint16_t c0 = static_cast<uint16_t>(in[0] | (in[1] << 8));
+      uint16_t c1 = static_cast<uint16_t>(in[2] | (in[3] << 8));
+      int palette[4][4];
+      UnpackColor(c0, palette[0]);
+      UnpackColor(c1, palette[1]);
+      palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 255;
+      for (unsigned int c = 0; c < 3u; ++c)
+      {
+        if (c0 > c1 || _format == TC_BC3)
+        {
+          palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+          palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+        else
+        {
+          palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+          palette[3][c] = 0;
+        }
+      }
+      if (c0 <= c1 && _format == TC_BC1)
+        palette[3][3] = 0;
+
+      uint32_t indices = static_cast<uint32_t>(in[4]) |
+          (static_cast<uint32_t>(in[5]) << 8) |
+          (static_cast<uint32_t>(in[6]) << 16) |
+          (static_cast<uint32_t>(in[7]) << 24);
+
+      for (unsigned int y = 0; y < 4u; ++y)
+      {
+        unsigned int py = by * 4u + y;
+        if (py >= _height)
+          break;
+        for (unsigned int x = 0; x < 4u; ++x)
+        {
+          unsigned int px = bx * 4u + x;
+          if (px >= _width)
+            break;
+          unsigned int i = y * 4u + x;
+          const int *color = palette[(indices >> (2u * i)) & 3u];
+          unsigned char *out = result.data() + (py * _width + px) * 4u;
+          for (unsigned int c = 0; c < 4u; ++c)
+            out[c] = static_cast<unsigned char>(color[c]);
+          if (_format == TC_BC3)
+          {
+            out[3] = static_cast<unsigned char>(
+                alpha[(alphaIndices >> (3u * i)) & 7u]);
+          }
+        }
+      }
+    }
+  }
+  return result;
+}
+
+//////////////////////////////////////////////////
+bool TextureCompressor::HasAlpha(const unsigned char *_rgba,
+    unsigned int _width, unsigned int _height)
+{
+  if (!_rgba)
+    return false;
+
+  size_t count = static_cast<size_t>(_width) * _height;
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (_rgba[i * 4u + 3u] != 255u)
+      return true;
+  }
+  return false;
+}
+
+//////////////////////////////////////////////////
+std::vector<unsigned char> TextureCompressor::CompressDds(
+    const unsigned char *_rgba, unsigned int _width, unsigned int _height,
+    TextureCompression _format)
+{
+  std::vector<unsigned char> result;
+  if (!_rgba || _width == 0u || _height == 0u)
+    return result;
+
+  unsigned int mipCount = 1u;
+  while ((std::max(_width, _height) >> mipCount) > 0u)
+    ++mipCount;
+
+  auto write = [&result](uint32_t _value)
+  {
+    for (unsigned int i = 0; i < 4u; ++i)
+      result.push_back(static_cast<unsigned char>((_value >> (8u * i)) & 0xFF));
+  };
+
+  // DDS header, see the DDS_HEADER and DDS_PIXELFORMAT structures
+  write(0x20534444u);  // "DDS "
+  write(124u);
+  write(0x1u | 0x2u | 0x4u | 0x1000u | 0x20000u | 0x80000u);
+  write(_height);
+  write(_width);
+  write(static_cast<uint32_t>(CompressedSize(_width, _height, _format)));
+  write(0u);
+  write(mipCount);
+  for (unsigned int i = 0; i < 11u; ++i)
+    write(0u);
+  write(32u);
+  write(0x4u);
+  write(_format == TC_BC1 ? 0x31545844u : 0x35545844u);  // "DXT1", "DXT5"
+  for (unsigned int i = 0; i < 5u; ++i)
+    write(0u);
+  write(0x1000u | 0x8u | 0x400000u);
+  for (unsigned int i = 0; i < 4u; ++i)
+    write(0u);
+
+  std::vector<unsigned char> level(_rgba, _rgba + _width * _height * 4u);
+  unsigned int width = _width;
+  unsigned int height = _height;
+  for (unsigned int i = 0; i < mipCount; ++i)
+  {
+    std::vector<unsigned char> blocks =
+        Compress(level.data(), width, height, _format);
+    result.insert(result.end(), blocks.begin(), blocks.end());
+    if (i + 1u < mipCount)
+    {
+      level = HalfSize(level, width, height);
+      width = std::max(1u, width / 2u);
+      height = std::max(1u, height / 2u);
+    }
+  }
+  return result;
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/TextureCompressor.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+/// \brief Create a test image with smooth gradients and an alpha ramp
+std::vector<unsigned char> GradientImage(unsigned int _width,
+    unsigned int _height)
+{
+  std::vector<unsigned char> image(_width * _height * 4u);
+  for (unsigned int y = 0; y < _height; ++y)
+  {
+    for (unsigned int x = 0; x < _width; ++x)
+    {
+      unsigned char *pixel = image.data() + (y * _width + x) * 4u;
+      pixel[0] = static_cast<unsigned char>(x * 255u / (_width - 1u));
+      pixel[1] = static_cast<unsigned char>(y * 255u / (_height - 1u));
+      pixel[2] = static_cast<unsigned char>(255u - pixel[0]);
+      pixel[3] = static_cast<unsigned char>((x + y) * 255u /
+          (_width + _height - 2u));
+    }
+  }
+  return image;
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the largest per channel difference between two images
+int MaxError(const std::vector<unsigned char> &_a,
+    const std::vector<unsigned char> &_b, unsigned int _channels)
+{
+  int error = 0;
+  for (unsigned int i = 0; i < _a.size(); ++i)
+  {
+    if (i % 4u < _channels)
+      error = std::max(error, std::abs(_a[i] - _b[i]));
+  }
+  return error;
+}
+
+/////////////////////////////////////////////////
+TEST(TextureCompressorTest, Empty)
+{
+  EXPECT_TRUE(TextureCompressor::Compress(nullptr, 4u, 4u, TC_BC1).empty());
+  std::vector<unsigned char> image(64u, 255u);
+  EXPECT_TRUE(TextureCompressor::Compress(image.data(), 0u, 4u,
+      TC_BC1).empty());
+  EXPECT_TRUE(TextureCompressor::CompressDds(image.data(), 4u, 0u,
+      TC_BC3).empty());
+  EXPECT_FALSE(TextureCompressor::HasAlpha(image.data(), 4u, 4u));
+}
+
+/////////////////////////////////////////////////
+TEST(TextureCompressorTest, Size)
+{
+  EXPECT_EQ(8u, TextureCompressor::CompressedSize(4u, 4u, TC_BC1));
+  EXPECT_EQ(16u, TextureCompressor::CompressedSize(4u, 4u, TC_BC3));
+  EXPECT_EQ(8u, TextureCompressor::CompressedSize(1u, 1u, TC_BC1));
+  EXPECT_EQ(2u * 3u * 16u, TextureCompressor::CompressedSize(5u, 9u, TC_BC3));
+}
+
+/////////////////////////////////////////////////
+TEST(TextureCompressorTest, Solid)
+{
+  // solid colors are exact up to the 5:6:5 quantization
+  std::vector<unsigned char> image(16u * 4u);
+  for (unsigned int i = 0; i < 16u; ++i)
+  {
+    image[i * 4u] = 255u;
+    image[i * 4u + 1u] = 0u;
+    image[i * 4u + 2u] = 0u;
+    image[i * 4u + 3u] = 128u;
+  }
+  EXPECT_TRUE(TextureCompressor::HasAlpha(image.data(), 4u, 4u));
+
+  std::vector<unsigned char> blocks =
+      TextureCompressor::Compress(image.data(), 4u, 4u, TC_BC3);
+  ASSERT_EQ(16u, blocks.size());
+  std::vector<unsigned char> result =
+      TextureCompressor::Decompress(blocks.data(), 4u, 4u, TC_BC3);
+  ASSERT_EQ(image.size(), result.size());
+  EXPECT_EQ(0, MaxError(image, result, 4u));
+}
+
+/////////////////////////////////////////////////
+TEST(TextureCompressorTest, Gradient)
+{
+  // odd size to test padding of the last blocks
+  const unsigned int width = 37u;
+  const unsigned int height = 21u;
+  std::vector<unsigned char> image = GradientImage(width, height);
+
+  std::vector<unsigned char> bc1 =
+      TextureCompressor::Compress(image.data(), width, height, TC_BC1);
+  ASSERT_EQ(TextureCompressor::CompressedSize(width, height, TC_BC1),
+      bc1.size());
+  std::vector<unsigned char> result =
+      TextureCompressor::Decompress(bc1.data(), width, height, TC_BC1);
+  ASSERT_EQ(image.size(), result.size());
+  EXPECT_LE(MaxError(image, result, 3u), 16);
+
+  std::vector<unsigned char> bc3 =
+      TextureCompressor::Compress(image.data(), width, height, TC_BC3);
+  ASSERT_EQ(TextureCompressor::CompressedSize(width, height, TC_BC3),
+      bc3.size());
+  result = TextureCompressor::Decompress(bc3.data(), width, height, TC_BC3);
+  ASSERT_EQ(image.size(), result.size());
+  EXPECT_LE(MaxError(image, result, 4u), 16);
+}
+
+/////////////////////////////////////////////////
+TEST(TextureCompressorTest, Dds)
+{
+  const unsigned int width = 16u;
+  const unsigned int height = 4u;
+  std::vector<unsigned char> image = GradientImage(width, height);
+  std::vector<unsigned char> dds =
+      TextureCompressor::CompressDds(image.data(), width, height, TC_BC1);
+
+  // header and 5 levels: 16x4, 8x2, 4x1, 2x1, 1x1
+  size_t expected = 128u + 4u * 8u + 2u * 8u + 3u * 8u;
+  ASSERT_EQ(expected, dds.size());
+  EXPECT_EQ('D', dds[0]);
+  EXPECT_EQ('D', dds[1]);
+  EXPECT_EQ('S', dds[2]);
+  EXPECT_EQ(' ', dds[3]);
+  EXPECT_EQ(5u, dds[28]);
+  EXPECT_EQ('D', dds[84]);
+  EXPECT_EQ('X', dds[85]);
+  EXPECT_EQ('T', dds[86]);
+  EXPECT_EQ('1', dds[87]);
+
+  // first level matches a plain compression of the image
+  std::vector<unsigned char> blocks =
+      TextureCompressor::Compress(image.data(), width, height, TC_BC1);
+  EXPECT_TRUE(std::equal(blocks.begin(), blocks.end(), dds.begin() + 128));
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
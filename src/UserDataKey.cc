@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ignition/rendering/UserDataKey.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Names interned by the user data keys
+struct UserDataKeyRegistry
+{
+  /// \brief Protects the registry
+  std::mutex mutex;
+
+  /// \brief Id of each interned name
+  std::unordered_map<std::string, unsigned int> ids;
+
+  /// \brief Interned names, indexed by id
+  std::vector<std::string> names;
+};
+
+/////////////////////////////////////////////////
+/// \brief Get the registry of the interned names. It is never destroyed, so
+/// that keys can be used during static destruction.
+/// \return The registry
+static UserDataKeyRegistry &registry()
+{
+  static UserDataKeyRegistry *instance = new UserDataKeyRegistry;
+  return *instance;
+}
+
+//////////////////////////////////////////////////
+UserDataKey::UserDataKey(const std::string &_name)
+{
+  UserDataKeyRegistry &r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  auto inserted = r.ids.emplace(_name,
+      static_cast<unsigned int>(r.names.size()));
+  if (inserted.second)
+    r.names.push_back(_name);
+  this->id = inserted.first->second;
+}
+
+//////////////////////////////////////////////////
+UserDataKey UserDataKey::Find(const std::string &_name)
+{
+  UserDataKey key;
+  UserDataKeyRegistry &r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  auto it = r.ids.find(_name);
+  if (it != r.ids.end())
+    key.id = it->second;
+  return key;
+}
+
+//////////////////////////////////////////////////
+UserDataKey UserDataKey::FromId(unsigned int _id)
+{
+  UserDataKey key;
+  UserDataKeyRegistry &r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  if (_id < r.names.size())
+    key.id = _id;
+  return key;
+}
+
+//////////////////////////////////////////////////
+unsigned int UserDataKey::Id() const
+{
+  return this->id;
+}
+
+//////////////////////////////////////////////////
+std::string UserDataKey::Name() const
+{
+  UserDataKeyRegistry &r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  if (this->id < r.names.size())
+    return r.names[this->id];
+  return std::string();
+}
+
+//////////////////////////////////////////////////
+bool UserDataKey::Valid() const
+{
+  return this->id != kInvalidId;
+}
+
+//////////////////////////////////////////////////
+bool UserDataKey::operator==(const UserDataKey &_other) const
+{
+  return this->id == _other.id;
+}
+
+//////////////////////////////////////////////////
+bool UserDataKey::operator!=(const UserDataKey &_other) const
+{
+  return this->id != _other.id;
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/UserDataKey.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(UserDataKeyTest, Intern)
+{
+  // default keys are invalid
+  UserDataKey invalid;
+  EXPECT_FALSE(invalid.Valid());
+  EXPECT_EQ(UserDataKey::kInvalidId, invalid.Id());
+  EXPECT_TRUE(invalid.Name().empty());
+
+  // names not interned yet are not found
+  EXPECT_FALSE(UserDataKey::Find("user_data_key_test").Valid());
+
+  // the same name is interned once
+  UserDataKey key("user_data_key_test");
+  EXPECT_TRUE(key.Valid());
+  EXPECT_EQ("user_data_key_test", key.Name());
+  EXPECT_EQ(key, UserDataKey("user_data_key_test"));
+  EXPECT_EQ(key, UserDataKey::Find("user_data_key_test"));
+  EXPECT_EQ(key, UserDataKey::FromId(key.Id()));
+
+  // different names get different ids
+  UserDataKey other("user_data_key_test_other");
+  EXPECT_NE(key, other);
+  EXPECT_NE(key.Id(), other.Id());
+
+  // unknown ids are invalid
+  EXPECT_FALSE(UserDataKey::FromId(UserDataKey::kInvalidId).Valid());
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -20,6 +20,8 @@
 #include <X11/Xresource.h>
 #endif
 
+#include <cmath>
+
 #include "ignition/rendering/Utils.hh"
 
 namespace ignition
@@ -155,6 +157,82 @@ ignition::math::AxisAlignedBox transformAxisAlignedBox(
   }
   return ignition::math::AxisAlignedBox(min, max);
 }
+
+/////////////////////////////////////////////////
+/// \brief Check if a point of a cloud is finite
+/// \param[in] _p Point, 3 floats
+/// \return True if all the coordinates are finite
+static bool finitePoint(const float *_p)
+{
+  return std::isfinite(_p[0]) && std::isfinite(_p[1]) &&
+      std::isfinite(_p[2]);
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the difference between the neighbours of a point along one
+/// axis of a cloud, falling back to one sided differences at the borders
+/// and next to invalid points.
+/// \param[in] _p The point
+/// \param[in] _prev Previous neighbour, null if there is none
+/// \param[in] _next Next neighbour, null if there is none
+/// \param[out] _d Difference, 3 floats
+/// \return False if no neighbour is finite
+static bool pointDifference(const float *_p, const float *_prev,
+    const float *_next, float *_d)
+{
+  const float *a = (_prev && finitePoint(_prev)) ? _prev : _p;
+  const float *b = (_next && finitePoint(_next)) ? _next : _p;
+  if (a == b)
+    return false;
+  for (unsigned int i = 0; i < 3u; ++i)
+    _d[i] = b[i] - a[i];
+  return true;
+}
+
+/////////////////////////////////////////////////
+void computePointCloudNormals(const float *_points, unsigned int _width,
+    unsigned int _height, unsigned int _channels, float *_normals)
+{
+  if (!_points || !_normals || _channels < 3u)
+    return;
+
+  for (unsigned int y = 0; y < _height; ++y)
+  {
+    for (unsigned int x = 0; x < _width; ++x)
+    {
+      unsigned int index = y * _width + x;
+      const float *p = &_points[index * _channels];
+      float *n = &_normals[index * 3];
+      n[0] = n[1] = n[2] = 0.0f;
+      if (!finitePoint(p))
+        continue;
+
+      const float *left = x > 0u ? p - _channels : nullptr;
+      const float *right = x + 1u < _width ? p + _channels : nullptr;
+      const float *up = y > 0u ? p - _width * _channels : nullptr;
+      const float *down = y + 1u < _height ? p + _width * _channels : nullptr;
+
+      float dx[3];
+      float dy[3];
+      if (!pointDifference(p, left, right, dx) ||
+          !pointDifference(p, up, down, dy))
+        continue;
+
+      float c[3] = {dx[1] * dy[2] - dx[2] * dy[1],
+                    dx[2] * dy[0] - dx[0] * dy[2],
+                    dx[0] * dy[1] - dx[1] * dy[0]};
+      float length = std::sqrt(c[0] * c[0] + c[1] * c[1] + c[2] * c[2]);
+      if (length <= 0.0f || !std::isfinite(length))
+        continue;
+
+      // face the origin of the cloud, i.e. the camera
+      if (c[0] * p[0] + c[1] * p[1] + c[2] * p[2] > 0.0f)
+        length = -length;
+      for (unsigned int i = 0; i < 3u; ++i)
+        n[i] = c[i] / length;
+    }
+  }
+}
 }
 }
 }
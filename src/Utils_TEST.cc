@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/Utils.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(UtilsTest, PointCloudNormals)
+{
+  // a 3x3 plane facing the origin at x = 2, with an extra channel
+  const unsigned int width = 3u;
+  const unsigned int height = 3u;
+  const unsigned int channels = 4u;
+  std::vector<float> points(width * height * channels, 0.0f);
+  for (unsigned int y = 0; y < height; ++y)
+  {
+    for (unsigned int x = 0; x < width; ++x)
+    {
+      float *p = &points[(y * width + x) * channels];
+      p[0] = 2.0f;
+      p[1] = static_cast<float>(x);
+      p[2] = static_cast<float>(y);
+    }
+  }
+  // invalid point in a corner
+  points[0] = std::numeric_limits<float>::infinity();
+
+  std::vector<float> normals(width * height * 3u, 1.0f);
+  computePointCloudNormals(points.data(), width, height, channels,
+      normals.data());
+
+  // the invalid point has no normal
+  EXPECT_FLOAT_EQ(0.0f, normals[0]);
+  EXPECT_FLOAT_EQ(0.0f, normals[1]);
+  EXPECT_FLOAT_EQ(0.0f, normals[2]);
+
+  // all the other normals face the origin
+  for (unsigned int i = 1u; i < width * height; ++i)
+  {
+    EXPECT_FLOAT_EQ(-1.0f, normals[i * 3]);
+    EXPECT_NEAR(0.0f, normals[i * 3 + 1], 1e-6);
+    EXPECT_NEAR(0.0f, normals[i * 3 + 2], 1e-6);
+  }
+
+  // a single point has no neighbours
+  float normal[3] = {1.0f, 1.0f, 1.0f};
+  computePointCloudNormals(&points[4], 1u, 1u, channels, normal);
+  EXPECT_FLOAT_EQ(0.0f, normal[0]);
+  EXPECT_FLOAT_EQ(0.0f, normal[1]);
+  EXPECT_FLOAT_EQ(0.0f, normal[2]);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
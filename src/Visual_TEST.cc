@@ -17,6 +17,7 @@
 
 #include <gtest/gtest.h>
 #include <string>
+#include <vector>
 
 #include <ignition/common/Console.hh>
 #include <ignition/math/AxisAlignedBox.hh>
@@ -55,6 +56,15 @@ class VisualTest : public testing::Test,
 
   /// \brief Test getting setting bounding boxes
   public: void BoundingBox(const std::string &_renderEngine);
+
+  /// \brief Test overriding the materials of a visual hierarchy
+  public: void MaterialOverride(const std::string &_renderEngine);
+
+  /// \brief Test cloning a visual hierarchy
+  public: void Clone(const std::string &_renderEngine);
+
+  /// \brief Test visiting children, geometries and visuals
+  public: void ForEach(const std::string &_renderEngine);
 };
 
 /////////////////////////////////////////////////
@@ -354,6 +364,29 @@ void VisualTest::UserData(const std::string &_renderEngine)
     igndbg << res << std::endl;
   }, std::bad_variant_access);
 
+  // interned keys share the data of the string keys
+  UserDataKey doubleDataKey(doubleKey);
+  EXPECT_DOUBLE_EQ(doubleValue,
+      std::get<double>(visual->UserData(doubleDataKey)));
+  visual->SetUserData(doubleDataKey, 2.5);
+  EXPECT_DOUBLE_EQ(2.5, std::get<double>(visual->UserData(doubleKey)));
+
+  // keys without data return an empty variant
+  UserDataKey missingKey("missing");
+  EXPECT_EQ(0u, visual->UserData(missingKey).index());
+  EXPECT_EQ(0u, visual->UserData("missing").index());
+  EXPECT_EQ(0u, visual->UserData(UserDataKey()).index());
+
+  // invalid keys are ignored
+  visual->SetUserData(UserDataKey(), 1);
+
+  // clones copy the data
+  VisualPtr clone = visual->Clone("clone", scene->RootVisual());
+  ASSERT_NE(nullptr, clone);
+  EXPECT_EQ(stringValue,
+      std::get<std::string>(clone->UserData(UserDataKey(stringKey))));
+  EXPECT_DOUBLE_EQ(2.5, std::get<double>(clone->UserData(doubleDataKey)));
+
   // Clean up
   engine->DestroyScene(scene);
   rendering::unloadEngine(engine->Name());
@@ -496,6 +529,19 @@ void VisualTest::VisibilityFlags(const std::string &_renderEngine)
   EXPECT_EQ(0x01000000u, visual->VisibilityFlags());
   EXPECT_EQ(0x00000010u, visual2->VisibilityFlags());
 
+  // static visuals
+  EXPECT_FALSE(visual->Static());
+  visual->SetStatic(true);
+  EXPECT_TRUE(visual->Static());
+  EXPECT_FALSE(visual2->Static());
+
+  // static visuals can still be moved
+  visual->SetLocalPosition(1.0, 2.0, 3.0);
+  EXPECT_EQ(math::Vector3d(1.0, 2.0, 3.0), visual->LocalPosition());
+  EXPECT_EQ(math::Vector3d(1.0, 2.0, 3.0), visual->WorldPosition());
+  visual->SetStatic(false);
+  EXPECT_FALSE(visual->Static());
+
   // Clean up
   engine->DestroyScene(scene);
   rendering::unloadEngine(engine->Name());
@@ -537,6 +583,28 @@ void VisualTest::BoundingBox(const std::string &_renderEngine)
   EXPECT_EQ(ignition::math::Vector3d(0.5, 1.5, 2.5), boundingBox.Min());
   EXPECT_EQ(ignition::math::Vector3d(1.5, 2.5, 3.5), boundingBox.Max());
 
+  // bounding boxes follow the pose of the visual
+  visual->SetWorldPosition(2.0, 2.0, 3.0);
+  boundingBox = visual->BoundingBox();
+  EXPECT_EQ(ignition::math::Vector3d(1.5, 1.5, 2.5), boundingBox.Min());
+  EXPECT_EQ(ignition::math::Vector3d(2.5, 2.5, 3.5), boundingBox.Max());
+
+  // and the pose of its children
+  VisualPtr child = scene->CreateVisual();
+  ASSERT_NE(nullptr, child);
+  child->AddGeometry(scene->CreateBox());
+  visual->AddChild(child);
+  child->SetLocalPosition(0.0, 0.0, 1.0);
+
+  localBoundingBox = visual->LocalBoundingBox();
+  EXPECT_EQ(ignition::math::Vector3d(-0.5, -0.5, -0.5), localBoundingBox.Min());
+  EXPECT_EQ(ignition::math::Vector3d(0.5, 0.5, 1.5), localBoundingBox.Max());
+
+  child->SetLocalPosition(0.0, 0.0, 2.0);
+  localBoundingBox = visual->LocalBoundingBox();
+  EXPECT_EQ(ignition::math::Vector3d(-0.5, -0.5, -0.5), localBoundingBox.Min());
+  EXPECT_EQ(ignition::math::Vector3d(0.5, 0.5, 2.5), localBoundingBox.Max());
+
   // Clean up
   engine->DestroyScene(scene);
   rendering::unloadEngine(engine->Name());
@@ -549,6 +617,230 @@ TEST_P(VisualTest, BoundingBox)
 }
 
 
+/////////////////////////////////////////////////
+void VisualTest::MaterialOverride(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+
+  // parent and child visuals with a cloned material each
+  VisualPtr visual = scene->CreateVisual();
+  ASSERT_NE(nullptr, visual);
+  GeometryPtr box = scene->CreateBox();
+  visual->AddGeometry(box);
+  VisualPtr child = scene->CreateVisual();
+  ASSERT_NE(nullptr, child);
+  GeometryPtr childBox = scene->CreateBox();
+  child->AddGeometry(childBox);
+  visual->AddChild(child);
+
+  MaterialPtr material = scene->CreateMaterial();
+  material->SetDiffuse(1.0, 0.0, 0.0);
+  visual->SetMaterial(material, true);
+  MaterialPtr boxMat = box->Material();
+  MaterialPtr childBoxMat = childBox->Material();
+  ASSERT_NE(nullptr, boxMat);
+  ASSERT_NE(nullptr, childBoxMat);
+  EXPECT_EQ(nullptr, visual->MaterialOverride());
+  EXPECT_EQ(nullptr, box->MaterialOverride());
+
+  // the override is shared by the hierarchy, the materials are kept
+  MaterialPtr highlight = scene->CreateMaterial();
+  highlight->SetDiffuse(0.0, 1.0, 0.0);
+  visual->SetMaterialOverride(highlight);
+  EXPECT_EQ(highlight, visual->MaterialOverride());
+  EXPECT_EQ(highlight, child->MaterialOverride());
+  EXPECT_EQ(highlight, box->MaterialOverride());
+  EXPECT_EQ(highlight, childBox->MaterialOverride());
+  EXPECT_EQ(boxMat, box->Material());
+  EXPECT_EQ(childBoxMat, childBox->Material());
+  EXPECT_TRUE(scene->MaterialRegistered(boxMat->Name()));
+
+  // geometries added while the override is set use it
+  GeometryPtr sphere = scene->CreateSphere();
+  visual->AddGeometry(sphere);
+  EXPECT_EQ(highlight, sphere->MaterialOverride());
+  visual->RemoveGeometry(sphere);
+  EXPECT_EQ(nullptr, sphere->MaterialOverride());
+
+  // clearing the override restores the materials without cloning them
+  visual->SetMaterialOverride(nullptr);
+  EXPECT_EQ(nullptr, visual->MaterialOverride());
+  EXPECT_EQ(nullptr, childBox->MaterialOverride());
+  EXPECT_EQ(boxMat, box->Material());
+  EXPECT_EQ(childBoxMat, childBox->Material());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(VisualTest, MaterialOverride)
+{
+  MaterialOverride(GetParam());
+}
+
+/////////////////////////////////////////////////
+void VisualTest::Clone(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+
+  // visual with a box and a child visual with a sphere
+  VisualPtr visual = scene->CreateVisual("visual");
+  ASSERT_NE(nullptr, visual);
+  visual->AddGeometry(scene->CreateBox());
+  visual->SetLocalScale(2, 2, 2);
+  visual->SetLocalPose(math::Pose3d(1, 2, 3, 0, 0, 1.57));
+  visual->SetUserData("key", 5);
+  VisualPtr child = scene->CreateVisual();
+  ASSERT_NE(nullptr, child);
+  child->AddGeometry(scene->CreateSphere());
+  child->SetLocalPosition(0, 0, 1);
+  visual->AddChild(child);
+
+  MaterialPtr material = scene->CreateMaterial();
+  visual->SetMaterial(material, true);
+  MaterialPtr boxMat = visual->GeometryByIndex(0u)->Material();
+  ASSERT_NE(nullptr, boxMat);
+
+  // deep copy with materials of its own
+  VisualPtr root = scene->RootVisual();
+  VisualPtr copy = visual->Clone("copy", root);
+  ASSERT_NE(nullptr, copy);
+  EXPECT_EQ("copy", copy->Name());
+  EXPECT_NE(visual, copy);
+  EXPECT_EQ(root, copy->Parent());
+  EXPECT_TRUE(visual->LocalPose().Pos().Equal(copy->LocalPose().Pos(),
+      1e-5));
+  EXPECT_TRUE(visual->LocalPose().Rot().Equal(copy->LocalPose().Rot(),
+      1e-5));
+  EXPECT_EQ(visual->LocalScale(), copy->LocalScale());
+  EXPECT_EQ(5, std::get<int>(copy->UserData("key")));
+  ASSERT_EQ(1u, copy->GeometryCount());
+  GeometryPtr boxCopy = copy->GeometryByIndex(0u);
+  EXPECT_NE(visual->GeometryByIndex(0u), boxCopy);
+  ASSERT_NE(nullptr, boxCopy->Material());
+  EXPECT_NE(boxMat, boxCopy->Material());
+
+  ASSERT_EQ(1u, copy->ChildCount());
+  VisualPtr childCopy =
+      std::dynamic_pointer_cast<Visual>(copy->ChildByIndex(0u));
+  ASSERT_NE(nullptr, childCopy);
+  EXPECT_NE(child, childCopy);
+  EXPECT_EQ(child->LocalPosition(), childCopy->LocalPosition());
+  EXPECT_EQ(1u, childCopy->GeometryCount());
+
+  // copy sharing the materials, left unattached
+  VisualPtr shared = visual->Clone("", nullptr, true);
+  ASSERT_NE(nullptr, shared);
+  EXPECT_NE("", shared->Name());
+  EXPECT_EQ(nullptr, shared->Parent());
+  ASSERT_EQ(1u, shared->GeometryCount());
+  EXPECT_EQ(boxMat, shared->GeometryByIndex(0u)->Material());
+
+  // names must be unique
+  EXPECT_EQ(nullptr, visual->Clone("copy", root));
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(VisualTest, Clone)
+{
+  Clone(GetParam());
+}
+
+/////////////////////////////////////////////////
+void VisualTest::ForEach(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene_for_each");
+
+  VisualPtr visual = scene->CreateVisual("parent");
+  ASSERT_NE(nullptr, visual);
+  VisualPtr child1 = scene->CreateVisual("child1");
+  VisualPtr child2 = scene->CreateVisual("child2");
+  visual->AddChild(child1);
+  visual->AddChild(child2);
+  GeometryPtr box = scene->CreateBox();
+  GeometryPtr sphere = scene->CreateSphere();
+  visual->AddGeometry(box);
+  visual->AddGeometry(sphere);
+
+  // children are visited in index order
+  std::vector<unsigned int> ids;
+  visual->ForEachChild([&ids](Node &_child)
+      {
+        ids.push_back(_child.Id());
+      });
+  ASSERT_EQ(visual->ChildCount(), ids.size());
+  for (unsigned int i = 0; i < ids.size(); ++i)
+    EXPECT_EQ(visual->ChildByIndex(i)->Id(), ids[i]);
+
+  // geometries are visited in index order
+  ids.clear();
+  visual->ForEachGeometry([&ids](rendering::Geometry &_geometry)
+      {
+        ids.push_back(_geometry.Id());
+      });
+  ASSERT_EQ(visual->GeometryCount(), ids.size());
+  for (unsigned int i = 0; i < ids.size(); ++i)
+    EXPECT_EQ(visual->GeometryByIndex(i)->Id(), ids[i]);
+
+  // visuals of the scene are visited in index order
+  ids.clear();
+  scene->ForEachVisual([&ids](Visual &_visual)
+      {
+        ids.push_back(_visual.Id());
+      });
+  ASSERT_EQ(scene->VisualCount(), ids.size());
+  for (unsigned int i = 0; i < ids.size(); ++i)
+    EXPECT_EQ(scene->VisualByIndex(i)->Id(), ids[i]);
+
+  // nodes without children are not visited
+  unsigned int count = 0u;
+  child1->ForEachChild([&count](Node &)
+      {
+        ++count;
+      });
+  EXPECT_EQ(0u, count);
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(VisualTest, ForEach)
+{
+  ForEach(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(Visual, VisualTest,
     RENDER_ENGINE_VALUES,
     ignition::rendering::PrintToStringParam());
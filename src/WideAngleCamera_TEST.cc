@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/WideAngleCamera.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+class WideAngleCameraTest : public testing::Test,
+                            public testing::WithParamInterface<const char *>
+{
+  /// \brief Test basic api
+  public: void WideAngleCamera(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+void WideAngleCameraTest::WideAngleCamera(const std::string &_renderEngine)
+{
+  // create and populate scene
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  WideAngleCameraPtr camera(scene->CreateWideAngleCamera());
+  if (!camera)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' doesn't support wide angle cameras" << std::endl;
+    engine->DestroyScene(scene);
+    rendering::unloadEngine(engine->Name());
+    return;
+  }
+
+  // defaults
+  EXPECT_EQ(WAP_EQUIDISTANT, camera->Projection());
+  EXPECT_EQ(0u, camera->CubeFaceSize());
+
+  camera->SetProjection(WAP_STEREOGRAPHIC);
+  EXPECT_EQ(WAP_STEREOGRAPHIC, camera->Projection());
+
+  camera->SetCubeFaceSize(256u);
+  EXPECT_EQ(256u, camera->CubeFaceSize());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(WideAngleCameraTest, WideAngleCamera)
+{
+  WideAngleCamera(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(WideAngleCamera, WideAngleCameraTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
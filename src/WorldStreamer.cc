@@ -0,0 +1,310 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <deque>
+#include <future>
+#include <list>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/Mesh.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
+#include "ignition/rendering/WorldStreamer.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Visual of a sector waiting to be added to the scene
+struct PendingSectorVisual
+{
+  /// \brief Description of the visual
+  SectorVisualDescriptor desc;
+
+  /// \brief Preparation of the mesh of the visual
+  std::shared_future<bool> prepared;
+};
+
+/// \brief Sector of a world streamer
+struct StreamedSector
+{
+  /// \brief Name of the sector
+  std::string name;
+
+  /// \brief State of the sector
+  SectorState state = SS_LOADING;
+
+  /// \brief Visual holding the visuals of the sector
+  VisualPtr root;
+
+  /// \brief Visuals not added to the scene yet, in order
+  std::deque<PendingSectorVisual> pending;
+
+  /// \brief Visuals added to the scene
+  std::vector<VisualPtr> visuals;
+};
+
+//////////////////////////////////////////////////
+class ignition::rendering::WorldStreamerPrivate
+{
+  /// \brief Find a sector
+  /// \param[in] _name Name of the sector
+  /// \return Iterator to the sector, end if not found
+  public: std::list<StreamedSector>::iterator Find(const std::string &_name)
+  {
+    return std::find_if(this->sectors.begin(), this->sectors.end(),
+        [&_name](const StreamedSector &_sector)
+        {
+          return _sector.name == _name;
+        });
+  }
+
+  /// \brief Add a visual of a sector to the scene
+  /// \param[in] _sector Sector of the visual
+  /// \param[in] _pending Visual to add
+  public: void Commit(StreamedSector &_sector,
+      const PendingSectorVisual &_pending);
+
+  /// \brief Scene the sectors are streamed into
+  public: ScenePtr scene;
+
+  /// \brief Sectors loaded or being loaded or unloaded, in request order
+  public: std::list<StreamedSector> sectors;
+
+  /// \brief Time Update may spend adding and removing visuals
+  public: std::chrono::steady_clock::duration budget =
+      std::chrono::milliseconds(2);
+};
+
+//////////////////////////////////////////////////
+void WorldStreamerPrivate::Commit(StreamedSector &_sector,
+    const PendingSectorVisual &_pending)
+{
+  const SectorVisualDescriptor &desc = _pending.desc;
+  bool hasMesh = desc.mesh.mesh || !desc.mesh.meshName.empty();
+  if (hasMesh && !_pending.prepared.get())
+  {
+    ignerr << "Unable to prepare the mesh of a visual of sector ["
+           << _sector.name << "]" << std::endl;
+    return;
+  }
+
+  VisualPtr visual = desc.name.empty() ?
+      this->scene->CreateVisual() : this->scene->CreateVisual(desc.name);
+  if (!visual)
+  {
+    ignerr << "Unable to create visual [" << desc.name << "] of sector ["
+           << _sector.name << "]" << std::endl;
+    return;
+  }
+
+  if (hasMesh)
+  {
+    MeshPtr mesh = this->scene->CreateMesh(desc.mesh);
+    if (!mesh)
+    {
+      ignerr << "Unable to create the mesh of visual [" << visual->Name()
+             << "] of sector [" << _sector.name << "]" << std::endl;
+      this->scene->DestroyVisual(visual);
+      return;
+    }
+    visual->AddGeometry(mesh);
+  }
+
+  if (desc.material)
+    visual->SetMaterial(desc.material, false);
+  visual->SetLocalPose(desc.pose);
+  visual->SetLocalScale(desc.scale);
+  visual->SetStatic(desc.isStatic);
+  _sector.root->AddChild(visual);
+  _sector.visuals.push_back(visual);
+}
+
+//////////////////////////////////////////////////
+WorldStreamer::WorldStreamer(ScenePtr _scene)
+  : dataPtr(new WorldStreamerPrivate)
+{
+  this->dataPtr->scene = _scene;
+}
+
+//////////////////////////////////////////////////
+WorldStreamer::~WorldStreamer() = default;
+
+//////////////////////////////////////////////////
+bool WorldStreamer::LoadSector(const std::string &_name,
+    const std::vector<SectorVisualDescriptor> &_visuals,
+    const math::Pose3d &_pose)
+{
+  if (!this->dataPtr->scene)
+    return false;
+
+  if (this->dataPtr->Find(_name) != this->dataPtr->sectors.end())
+  {
+    ignerr << "Sector [" << _name << "] is already loaded or being unloaded"
+           << std::endl;
+    return false;
+  }
+
+  VisualPtr root = this->dataPtr->scene->CreateVisual();
+  if (!root)
+    return false;
+  root->SetLocalPose(_pose);
+  this->dataPtr->scene->RootVisual()->AddChild(root);
+
+  StreamedSector sector;
+  sector.name = _name;
+  sector.root = root;
+
+  // start preparing all the meshes of the sector in the background
+  for (const auto &desc : _visuals)
+  {
+    PendingSectorVisual pending;
+    pending.desc = desc;
+    if (desc.mesh.mesh || !desc.mesh.meshName.empty())
+      pending.prepared = this->dataPtr->scene->PrepareMesh(desc.mesh);
+    sector.pending.push_back(pending);
+  }
+  if (sector.pending.empty())
+    sector.state = SS_LOADED;
+
+  this->dataPtr->sectors.push_back(std::move(sector));
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool WorldStreamer::UnloadSector(const std::string &_name)
+{
+  auto it = this->dataPtr->Find(_name);
+  if (it == this->dataPtr->sectors.end())
+    return false;
+
+  // the meshes prepared for the visuals discarded are left to the scene
+  it->pending.clear();
+  it->state = SS_UNLOADING;
+  return true;
+}
+
+//////////////////////////////////////////////////
+SectorState WorldStreamer::State(const std::string &_name) const
+{
+  auto it = this->dataPtr->Find(_name);
+  return it == this->dataPtr->sectors.end() ? SS_UNLOADED : it->state;
+}
+
+//////////////////////////////////////////////////
+VisualPtr WorldStreamer::SectorVisual(const std::string &_name) const
+{
+  auto it = this->dataPtr->Find(_name);
+  return it == this->dataPtr->sectors.end() ? VisualPtr() : it->root;
+}
+
+//////////////////////////////////////////////////
+void WorldStreamer::SetFrameBudget(
+    const std::chrono::steady_clock::duration &_budget)
+{
+  this->dataPtr->budget = _budget;
+}
+
+//////////////////////////////////////////////////
+std::chrono::steady_clock::duration WorldStreamer::FrameBudget() const
+{
+  return this->dataPtr->budget;
+}
+
+//////////////////////////////////////////////////
+unsigned int WorldStreamer::Update()
+{
+  auto start = std::chrono::steady_clock::now();
+  unsigned int count = 0u;
+  auto spent = [&]()
+  {
+    return count > 0u &&
+        std::chrono::steady_clock::now() - start >= this->dataPtr->budget;
+  };
+
+  ScenePtr scene = this->dataPtr->scene;
+  if (!scene)
+    return 0u;
+
+  // unload first to release memory before loading more
+  for (auto it = this->dataPtr->sectors.begin();
+       it != this->dataPtr->sectors.end() && !spent();)
+  {
+    if (it->state != SS_UNLOADING)
+    {
+      ++it;
+      continue;
+    }
+
+    while (!it->visuals.empty() && !spent())
+    {
+      scene->DestroyVisual(it->visuals.back(), true);
+      it->visuals.pop_back();
+      ++count;
+    }
+
+    if (!it->visuals.empty())
+      break;
+
+    scene->DestroyVisual(it->root);
+    it = this->dataPtr->sectors.erase(it);
+  }
+
+  for (auto &sector : this->dataPtr->sectors)
+  {
+    if (spent())
+      break;
+    if (sector.state != SS_LOADING)
+      continue;
+
+    // visuals are added in order, a sector waits for the mesh of its next
+    // visual while the other sectors go on
+    while (!sector.pending.empty() && !spent())
+    {
+      const PendingSectorVisual &pending = sector.pending.front();
+      if (pending.prepared.valid() &&
+          pending.prepared.wait_for(std::chrono::seconds(0)) !=
+          std::future_status::ready)
+      {
+        break;
+      }
+      this->dataPtr->Commit(sector, pending);
+      sector.pending.pop_front();
+      ++count;
+    }
+
+    if (sector.pending.empty())
+      sector.state = SS_LOADED;
+  }
+
+  return count;
+}
+
+//////////////////////////////////////////////////
+bool WorldStreamer::Idle() const
+{
+  for (const auto &sector : this->dataPtr->sectors)
+  {
+    if (sector.state == SS_LOADING || sector.state == SS_UNLOADING)
+      return false;
+  }
+  return true;
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
+#include "ignition/rendering/WorldStreamer.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+class WorldStreamerTest : public testing::Test,
+                          public testing::WithParamInterface<const char *>
+{
+  /// \brief Test loading and unloading sectors
+  public: void Sectors(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+/// \brief Update a streamer until it is idle
+/// \param[in] _streamer Streamer to update
+/// \return Number of visuals added or removed
+static unsigned int updateUntilIdle(WorldStreamer &_streamer)
+{
+  unsigned int count = 0u;
+  for (unsigned int i = 0u; i < 1000u && !_streamer.Idle(); ++i)
+  {
+    count += _streamer.Update();
+    // the meshes are prepared in the background
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return count;
+}
+
+/////////////////////////////////////////////////
+void WorldStreamerTest::Sectors(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+           << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  unsigned int visualCount = scene->VisualCount();
+
+  std::vector<SectorVisualDescriptor> visuals(3u);
+  for (unsigned int i = 0u; i < visuals.size(); ++i)
+  {
+    visuals[i].mesh = MeshDescriptor("unit_box");
+    visuals[i].pose = math::Pose3d(i, 0, 0, 0, 0, 0);
+    visuals[i].isStatic = true;
+  }
+  // a visual without geometry
+  visuals.push_back(SectorVisualDescriptor());
+  visuals.back().name = "empty";
+
+  WorldStreamer streamer(scene);
+  EXPECT_TRUE(streamer.Idle());
+  EXPECT_EQ(SS_UNLOADED, streamer.State("a"));
+  EXPECT_EQ(nullptr, streamer.SectorVisual("a"));
+
+  math::Pose3d pose(10, 20, 0, 0, 0, 0);
+  EXPECT_TRUE(streamer.LoadSector("a", visuals, pose));
+  EXPECT_FALSE(streamer.LoadSector("a", visuals));
+  EXPECT_EQ(SS_LOADING, streamer.State("a"));
+  EXPECT_FALSE(streamer.Idle());
+  VisualPtr root = streamer.SectorVisual("a");
+  ASSERT_NE(nullptr, root);
+  EXPECT_EQ(pose, root->WorldPose());
+  EXPECT_EQ(0u, root->ChildCount());
+
+  // one visual is added per update with no budget
+  streamer.SetFrameBudget(std::chrono::steady_clock::duration::zero());
+  EXPECT_EQ(std::chrono::steady_clock::duration::zero(),
+      streamer.FrameBudget());
+  EXPECT_EQ(4u, updateUntilIdle(streamer));
+  EXPECT_EQ(SS_LOADED, streamer.State("a"));
+  ASSERT_EQ(4u, root->ChildCount());
+  EXPECT_TRUE(scene->HasVisualName("empty"));
+  VisualPtr box = std::dynamic_pointer_cast<Visual>(root->ChildByIndex(1u));
+  ASSERT_NE(nullptr, box);
+  EXPECT_EQ(1u, box->GeometryCount());
+  EXPECT_EQ(math::Vector3d(11, 20, 0), box->WorldPosition());
+  EXPECT_TRUE(box->Static());
+
+  // unloading a sector while it is loading discards the visuals not added
+  EXPECT_TRUE(streamer.LoadSector("b", visuals));
+  streamer.SetFrameBudget(std::chrono::seconds(1));
+  EXPECT_TRUE(streamer.UnloadSector("b"));
+  EXPECT_EQ(SS_UNLOADING, streamer.State("b"));
+  EXPECT_FALSE(streamer.LoadSector("b", visuals));
+  EXPECT_EQ(0u, updateUntilIdle(streamer));
+  EXPECT_EQ(SS_UNLOADED, streamer.State("b"));
+
+  EXPECT_TRUE(streamer.UnloadSector("a"));
+  EXPECT_FALSE(streamer.UnloadSector("c"));
+  EXPECT_EQ(4u, updateUntilIdle(streamer));
+  EXPECT_EQ(SS_UNLOADED, streamer.State("a"));
+  EXPECT_EQ(nullptr, streamer.SectorVisual("a"));
+  EXPECT_FALSE(scene->HasVisualName("empty"));
+  EXPECT_EQ(visualCount, scene->VisualCount());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(WorldStreamerTest, Sectors)
+{
+  Sectors(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(WorldStreamer, WorldStreamerTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -14,11 +14,15 @@
  * limitations under the License.
  *
  */
+#include "ignition/rendering/Scene.hh"
 #include "ignition/rendering/base/BaseObject.hh"
 
 using namespace ignition;
 using namespace rendering;
 
+/// \brief True while the scene commits a parallel traversal on this thread
+static thread_local bool shallowPreRender = false;
+
 //////////////////////////////////////////////////
 BaseObject::BaseObject()
 {
@@ -60,6 +64,38 @@ void BaseObject::Destroy()
   // do nothing
 }
 
+//////////////////////////////////////////////////
+bool BaseObject::ShallowPreRender()
+{
+  return shallowPreRender;
+}
+
+//////////////////////////////////////////////////
+void BaseObject::SetShallowPreRender(bool _shallow)
+{
+  shallowPreRender = _shallow;
+}
+
+//////////////////////////////////////////////////
+void BaseObject::MarkPreRenderDirty(bool _subtree)
+{
+  ScenePtr scene = this->Scene();
+  if (!scene)
+    return;
+
+  // the change is still counted by the scene version
+  if (!scene->IncrementalPreRender())
+  {
+    scene->MarkPreRenderDirty(nullptr);
+    return;
+  }
+
+  // objects not owned by a shared pointer yet are prepared when added
+  ObjectPtr object = this->weak_from_this().lock();
+  if (object)
+    scene->MarkPreRenderDirty(object, _subtree);
+}
+
 //////////////////////////////////////////////////
 // TODO(anyone): make pure virtual
 void BaseObject::Load()
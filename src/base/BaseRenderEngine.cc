@@ -274,3 +274,37 @@ RenderPassSystemPtr BaseRenderEngine::RenderPassSystem() const
   }
   return this->renderPassSystem;
 }
+
+//////////////////////////////////////////////////
+bool BaseRenderEngine::SetGpuTimingEnabled(bool _enabled)
+{
+  if (!_enabled)
+    return true;
+
+  ignwarn << "GPU timing not supported by the " << this->Name()
+          << " render engine" << std::endl;
+  return false;
+}
+
+//////////////////////////////////////////////////
+bool BaseRenderEngine::GpuTimingEnabled() const
+{
+  return false;
+}
+
+//////////////////////////////////////////////////
+void BaseRenderEngine::BeginRenderBatch()
+{
+  // sensors are rendered when they are updated
+}
+
+//////////////////////////////////////////////////
+void BaseRenderEngine::EndRenderBatch()
+{
+}
+
+//////////////////////////////////////////////////
+bool BaseRenderEngine::RenderBatchActive() const
+{
+  return false;
+}
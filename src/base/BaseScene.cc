@@ -15,13 +15,29 @@
  *
  */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <set>
 #include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 #include <ignition/math/Helpers.hh>
 
 #include <ignition/common/Console.hh>
 #include <ignition/common/Mesh.hh>
 #include <ignition/common/MeshManager.hh>
+#include <ignition/common/SubMesh.hh>
 
 #include "ignition/common/Time.hh"
 
@@ -29,18 +45,29 @@
 #include "ignition/rendering/AxisVisual.hh"
 #include "ignition/rendering/LidarVisual.hh"
 #include "ignition/rendering/LightVisual.hh"
+#include "ignition/rendering/Material.hh"
+#include "ignition/rendering/Mesh.hh"
 #include "ignition/rendering/Camera.hh"
 #include "ignition/rendering/Capsule.hh"
 #include "ignition/rendering/DepthCamera.hh"
+#include "ignition/rendering/Geometry.hh"
 #include "ignition/rendering/GizmoVisual.hh"
 #include "ignition/rendering/GpuRays.hh"
 #include "ignition/rendering/Grid.hh"
 #include "ignition/rendering/ParticleEmitter.hh"
+#include "ignition/rendering/PointCloudVisual.hh"
+#include "ignition/rendering/PoseArrayVisual.hh"
+#include "ignition/rendering/Profiler.hh"
 #include "ignition/rendering/RayQuery.hh"
 #include "ignition/rendering/RenderTarget.hh"
+#include "ignition/rendering/SegmentationCamera.hh"
+#include "ignition/rendering/Sensor.hh"
+#include "ignition/rendering/ShaderParams.hh"
 #include "ignition/rendering/Text.hh"
 #include "ignition/rendering/ThermalCamera.hh"
 #include "ignition/rendering/Visual.hh"
+#include "ignition/rendering/WideAngleCamera.hh"
+#include "ignition/rendering/base/BaseObject.hh"
 #include "ignition/rendering/base/BaseStorage.hh"
 #include "ignition/rendering/base/BaseScene.hh"
 
@@ -52,6 +79,88 @@ using namespace rendering;
 # pragma GCC diagnostic push
 # pragma GCC diagnostic ignored "-Wdeprecated-declarations"
 #endif
+//////////////////////////////////////////////////
+/// \brief Counter used to generate unique names for the meshes of the
+/// static geometry batches
+static std::atomic<unsigned int> staticBatchCounter(0u);
+
+//////////////////////////////////////////////////
+/// \brief Get the submeshes of the common mesh a mesh was created from, in
+/// the order of the submeshes of the mesh
+/// \param[in] _mesh Mesh
+/// \param[out] _subMeshes One submesh per submesh of the mesh
+/// \param[out] _offset Translation applied to the submeshes when the mesh
+/// was created, non zero if the descriptor centers the submesh
+/// \return True if there is one common submesh per submesh of the mesh
+static bool descriptorSubMeshes(const Mesh &_mesh,
+    std::vector<std::shared_ptr<common::SubMesh>> &_subMeshes,
+    math::Vector3d &_offset)
+{
+  const MeshDescriptor &desc = _mesh.Descriptor();
+  _offset = math::Vector3d::Zero;
+  if (!desc.mesh)
+    return false;
+
+  if (!desc.subMeshName.empty())
+  {
+    auto subMesh = desc.mesh->SubMeshByName(desc.subMeshName).lock();
+    if (!subMesh || _mesh.SubMeshCount() != 1u)
+      return false;
+    if (desc.centerSubMesh)
+      _offset = -(subMesh->Min() + subMesh->Max()) * 0.5;
+    _subMeshes = {subMesh};
+    return true;
+  }
+
+  // render engines may leave the submeshes without vertices out
+  std::vector<std::shared_ptr<common::SubMesh>> all;
+  std::vector<std::shared_ptr<common::SubMesh>> nonEmpty;
+  for (unsigned int i = 0; i < desc.mesh->SubMeshCount(); ++i)
+  {
+    auto subMesh = desc.mesh->SubMeshByIndex(i).lock();
+    if (!subMesh)
+      return false;
+    all.push_back(subMesh);
+    if (subMesh->VertexCount() > 0u)
+      nonEmpty.push_back(subMesh);
+  }
+  if (all.size() == _mesh.SubMeshCount())
+    _subMeshes = all;
+  else if (nonEmpty.size() == _mesh.SubMeshCount())
+    _subMeshes = nonEmpty;
+  else
+    return false;
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Get a string holding all the parameters of a material that
+/// affect how it is rendered
+/// \param[in] _material Material
+/// \return Parameters of the material
+static std::string MaterialContentKey(const MaterialPtr &_material)
+{
+  std::stringstream key;
+  key << std::setprecision(std::numeric_limits<double>::max_digits10)
+      << _material->Type() << "|" << _material->ShaderType() << "|"
+      << _material->LightingEnabled() << _material->DepthCheckEnabled()
+      << _material->DepthWriteEnabled() << _material->TextureAlphaEnabled()
+      << _material->TwoSidedEnabled() << _material->CastShadows()
+      << _material->ReceiveShadows() << _material->ReflectionEnabled() << "|"
+      << _material->Ambient() << "|" << _material->Diffuse() << "|"
+      << _material->Specular() << "|" << _material->Emissive() << "|"
+      << _material->Shininess() << "|" << _material->Transparency() << "|"
+      << _material->AlphaThreshold() << "|" << _material->Reflectivity() << "|"
+      << _material->RenderOrder() << "|" << _material->Roughness() << "|"
+      << _material->Metalness() << "|"
+      << _material->Texture() << "|" << _material->NormalMap() << "|"
+      << _material->RoughnessMap() << "|" << _material->MetalnessMap() << "|"
+      << _material->EnvironmentMap() << "|" << _material->EmissiveMap() << "|"
+      << _material->LightMap() << "|" << _material->LightMapTexCoordSet() << "|"
+      << _material->VertexShader() << "|" << _material->FragmentShader();
+  return key.str();
+}
+
 //////////////////////////////////////////////////
 BaseScene::BaseScene(unsigned int _id, const std::string &_name) :
   id(_id),
@@ -209,6 +318,7 @@ void BaseScene::SetBackgroundColor(double _r, double _g, double _b, double _a)
 void BaseScene::SetBackgroundColor(const math::Color &_color)
 {
   this->backgroundColor = _color;
+  ++this->changeVersion;
 }
 
 //////////////////////////////////////////////////
@@ -229,6 +339,7 @@ void BaseScene::SetGradientBackgroundColor(
 {
   this->gradientBackgroundColor = _colors;
   this->isGradientBackgroundColor = true;
+  ++this->changeVersion;
 }
 
 //////////////////////////////////////////////////
@@ -237,6 +348,7 @@ void BaseScene::RemoveGradientBackgroundColor()
   this->gradientBackgroundColor = {math::Color::Black, math::Color::Black,
       math::Color::Black, math::Color::Black};
   this->isGradientBackgroundColor = false;
+  ++this->changeVersion;
 }
 
 //////////////////////////////////////////////////
@@ -249,6 +361,7 @@ MaterialPtr BaseScene::BackgroundMaterial() const
 void BaseScene::SetBackgroundMaterial(MaterialPtr _material)
 {
   this->backgroundMaterial = _material;
+  ++this->changeVersion;
 }
 
 //////////////////////////////////////////////////
@@ -556,6 +669,13 @@ VisualPtr BaseScene::VisualByIndex(unsigned int _index) const
   return this->Visuals()->GetByIndex(_index);
 }
 
+//////////////////////////////////////////////////
+void BaseScene::ForEachVisual(
+    const std::function<void(Visual &)> &_func) const
+{
+  this->Visuals()->ForEach(_func);
+}
+
 //////////////////////////////////////////////////
 void BaseScene::DestroyVisual(VisualPtr _visual, bool _recursive)
 {
@@ -593,6 +713,31 @@ void BaseScene::DestroyVisuals()
   this->Visuals()->DestroyAll();
 }
 
+//////////////////////////////////////////////////
+void BaseScene::DestroyVisuals(const std::vector<VisualPtr> &_visuals,
+    bool _recursive)
+{
+  // share the set of visited nodes so each node is only visited once
+  std::set<unsigned int> nodeIds;
+  for (auto &visual : _visuals)
+  {
+    if (!visual)
+      continue;
+
+    if (_recursive)
+    {
+      // skip visuals already destroyed as a descendant of an earlier one
+      if (nodeIds.find(visual->Id()) != nodeIds.end())
+        continue;
+      this->DestroyNodeRecursive(visual, nodeIds);
+    }
+    else
+    {
+      this->Visuals()->Destroy(visual);
+    }
+  }
+}
+
 //////////////////////////////////////////////////
 bool BaseScene::MaterialRegistered(const std::string &_name) const
 {
@@ -616,12 +761,20 @@ void BaseScene::RegisterMaterial(const std::string &_name,
 //////////////////////////////////////////////////
 void BaseScene::UnregisterMaterial(const std::string &_name)
 {
+  auto shared = this->sharedMaterialKeys.find(_name);
+  if (shared != this->sharedMaterialKeys.end())
+  {
+    this->sharedMaterials.erase(shared->second);
+    this->sharedMaterialKeys.erase(shared);
+  }
   this->Materials()->Remove(_name);
 }
 
 //////////////////////////////////////////////////
 void BaseScene::UnregisterMaterials()
 {
+  this->sharedMaterials.clear();
+  this->sharedMaterialKeys.clear();
   this->Materials()->RemoveAll();
 }
 
@@ -639,12 +792,48 @@ void BaseScene::DestroyMaterial(MaterialPtr _material)
 //////////////////////////////////////////////////
 void BaseScene::DestroyMaterials()
 {
-  for (unsigned int i = 0; i < this->Materials()->Size(); ++i)
+  this->sharedMaterials.clear();
+  this->sharedMaterialKeys.clear();
+  this->Materials()->DestroyAll();
+}
+
+//////////////////////////////////////////////////
+void BaseScene::DestroyMaterials(const std::vector<MaterialPtr> &_materials)
+{
+  for (auto &material : _materials)
+    this->DestroyMaterial(material);
+}
+
+//////////////////////////////////////////////////
+MaterialPtr BaseScene::SharedMaterial(MaterialPtr _material)
+{
+  if (!_material)
+    return _material;
+
+  // custom shader parameters are not part of the key
+  ShaderParamsPtr vertexParams = _material->VertexShaderParams();
+  ShaderParamsPtr fragmentParams = _material->FragmentShaderParams();
+  if ((vertexParams && vertexParams->begin() != vertexParams->end()) ||
+      (fragmentParams && fragmentParams->begin() != fragmentParams->end()))
   {
-    auto m = this->Materials()->GetByIndex(i);
-    m->Destroy();
+    return _material;
   }
-  this->UnregisterMaterials();
+
+  std::string key = MaterialContentKey(_material);
+  auto it = this->sharedMaterials.find(key);
+  if (it != this->sharedMaterials.end())
+    return it->second;
+
+  // only materials managed by the scene can be shared, so that destroying
+  // them also removes them from the shared materials
+  if (this->Material(_material->Name()) != _material)
+    this->RegisterMaterial(_material->Name(), _material);
+  if (this->Material(_material->Name()) != _material)
+    return _material;
+
+  this->sharedMaterials[key] = _material;
+  this->sharedMaterialKeys[_material->Name()] = key;
+  return _material;
 }
 
 //////////////////////////////////////////////////
@@ -811,6 +1000,63 @@ ThermalCameraPtr BaseScene::CreateThermalCamera(const unsigned int _id,
   return (result) ? camera : nullptr;
 }
 
+//////////////////////////////////////////////////
+WideAngleCameraPtr BaseScene::CreateWideAngleCamera()
+{
+  unsigned int objId = this->CreateObjectId();
+  return this->CreateWideAngleCamera(objId);
+}
+//////////////////////////////////////////////////
+WideAngleCameraPtr BaseScene::CreateWideAngleCamera(const unsigned int _id)
+{
+  std::string objName = this->CreateObjectName(_id, "WideAngleCamera");
+  return this->CreateWideAngleCamera(_id, objName);
+}
+//////////////////////////////////////////////////
+WideAngleCameraPtr BaseScene::CreateWideAngleCamera(const std::string &_name)
+{
+  unsigned int objId = this->CreateObjectId();
+  return this->CreateWideAngleCamera(objId, _name);
+}
+//////////////////////////////////////////////////
+WideAngleCameraPtr BaseScene::CreateWideAngleCamera(const unsigned int _id,
+    const std::string &_name)
+{
+  WideAngleCameraPtr camera = this->CreateWideAngleCameraImpl(_id, _name);
+  bool result = this->RegisterSensor(camera);
+  return (result) ? camera : nullptr;
+}
+
+//////////////////////////////////////////////////
+SegmentationCameraPtr BaseScene::CreateSegmentationCamera()
+{
+  unsigned int objId = this->CreateObjectId();
+  return this->CreateSegmentationCamera(objId);
+}
+//////////////////////////////////////////////////
+SegmentationCameraPtr BaseScene::CreateSegmentationCamera(
+    const unsigned int _id)
+{
+  std::string objName = this->CreateObjectName(_id, "SegmentationCamera");
+  return this->CreateSegmentationCamera(_id, objName);
+}
+//////////////////////////////////////////////////
+SegmentationCameraPtr BaseScene::CreateSegmentationCamera(
+    const std::string &_name)
+{
+  unsigned int objId = this->CreateObjectId();
+  return this->CreateSegmentationCamera(objId, _name);
+}
+//////////////////////////////////////////////////
+SegmentationCameraPtr BaseScene::CreateSegmentationCamera(
+    const unsigned int _id, const std::string &_name)
+{
+  SegmentationCameraPtr camera =
+      this->CreateSegmentationCameraImpl(_id, _name);
+  bool result = this->RegisterSensor(camera);
+  return (result) ? camera : nullptr;
+}
+
 //////////////////////////////////////////////////
 GpuRaysPtr BaseScene::CreateGpuRays()
 {
@@ -1048,7 +1294,91 @@ MeshPtr BaseScene::CreateMesh(const MeshDescriptor &_desc)
 
   unsigned int objId = this->CreateObjectId();
   std::string objName = this->CreateObjectName(objId, "Mesh-" + meshName);
-  return this->CreateMeshImpl(objId, objName, _desc);
+  MeshPtr mesh = this->CreateMeshImpl(objId, objName, _desc);
+  if (mesh)
+    mesh->SetDescriptor(_desc);
+  return mesh;
+}
+
+//////////////////////////////////////////////////
+std::shared_future<bool> BaseScene::PrepareMesh(const MeshDescriptor &_desc)
+{
+  // nothing is prepared in the background, the mesh is loaded by CreateMesh
+  std::promise<bool> prepared;
+  prepared.set_value(_desc.mesh || !_desc.meshName.empty());
+  return prepared.get_future().share();
+}
+
+//////////////////////////////////////////////////
+MeshPtr BaseScene::CloneMesh(const Mesh &_mesh, bool _shareMaterials)
+{
+  const MeshDescriptor &desc = _mesh.Descriptor();
+  std::string meshName = (desc.mesh) ? desc.mesh->Name() : desc.meshName;
+
+  unsigned int objId = this->CreateObjectId();
+  std::string objName = this->CreateObjectName(objId, "Mesh-" + meshName);
+  MeshPtr mesh = this->CloneMeshImpl(objId, objName, _mesh);
+  if (!mesh)
+    return nullptr;
+  mesh->SetDescriptor(desc);
+
+  // a material set on the whole mesh is set on the copy the same way, so
+  // that the copy reports it too and clones it only once
+  MaterialPtr meshMaterial = _mesh.Material();
+  unsigned int count = std::min(mesh->SubMeshCount(), _mesh.SubMeshCount());
+  bool sameMaterial = (meshMaterial != nullptr);
+  for (unsigned int i = 0; i < count && sameMaterial; ++i)
+    sameMaterial = _mesh.SubMeshByIndex(i)->Material() == meshMaterial;
+
+  if (sameMaterial)
+  {
+    mesh->SetMaterial(meshMaterial, !_shareMaterials);
+    return mesh;
+  }
+  if (_shareMaterials)
+    return mesh;
+
+  // submeshes sharing a material share its copy as well
+  std::map<MaterialPtr, MaterialPtr> clones;
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    MaterialPtr material = _mesh.SubMeshByIndex(i)->Material();
+    if (!material)
+      continue;
+    MaterialPtr &clone = clones[material];
+    if (!clone)
+      clone = material->Clone();
+    mesh->SubMeshByIndex(i)->SetMaterial(clone, false);
+  }
+  return mesh;
+}
+
+//////////////////////////////////////////////////
+MeshPtr BaseScene::CloneMeshImpl(unsigned int _id, const std::string &_name,
+    const Mesh &_mesh)
+{
+  const MeshDescriptor &desc = _mesh.Descriptor();
+  if (!desc.mesh && desc.meshName.empty())
+  {
+    ignerr << "Mesh [" << _mesh.Name() << "] was not created from a "
+           << "descriptor and can not be cloned" << std::endl;
+    return nullptr;
+  }
+
+  MeshPtr mesh = this->CreateMeshImpl(_id, _name, desc);
+  if (!mesh)
+    return nullptr;
+
+  // reference the materials of the mesh, the copies made for the new mesh
+  // are released
+  unsigned int count = std::min(mesh->SubMeshCount(), _mesh.SubMeshCount());
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    MaterialPtr material = _mesh.SubMeshByIndex(i)->Material();
+    if (material)
+      mesh->SubMeshByIndex(i)->SetMaterial(material, false);
+  }
+  return mesh;
 }
 
 //////////////////////////////////////////////////
@@ -1105,6 +1435,68 @@ LidarVisualPtr BaseScene::CreateLidarVisual(unsigned int _id,
   return (result) ? lidar : nullptr;
 }
 
+//////////////////////////////////////////////////
+PointCloudVisualPtr BaseScene::CreatePointCloudVisual()
+{
+  unsigned int objId = this->CreateObjectId();
+  return this->CreatePointCloudVisual(objId);
+}
+
+//////////////////////////////////////////////////
+PointCloudVisualPtr BaseScene::CreatePointCloudVisual(unsigned int _id)
+{
+  const std::string objName = this->CreateObjectName(_id, "PointCloudVisual");
+  return this->CreatePointCloudVisual(_id, objName);
+}
+
+//////////////////////////////////////////////////
+PointCloudVisualPtr BaseScene::CreatePointCloudVisual(
+    const std::string &_name)
+{
+  unsigned int objId = this->CreateObjectId();
+  return this->CreatePointCloudVisual(objId, _name);
+}
+
+//////////////////////////////////////////////////
+PointCloudVisualPtr BaseScene::CreatePointCloudVisual(unsigned int _id,
+    const std::string &_name)
+{
+  PointCloudVisualPtr cloud = this->CreatePointCloudVisualImpl(_id, _name);
+  bool result = this->RegisterVisual(cloud);
+  return (result) ? cloud : nullptr;
+}
+
+//////////////////////////////////////////////////
+PoseArrayVisualPtr BaseScene::CreatePoseArrayVisual()
+{
+  unsigned int objId = this->CreateObjectId();
+  return this->CreatePoseArrayVisual(objId);
+}
+
+//////////////////////////////////////////////////
+PoseArrayVisualPtr BaseScene::CreatePoseArrayVisual(unsigned int _id)
+{
+  const std::string objName = this->CreateObjectName(_id, "PoseArrayVisual");
+  return this->CreatePoseArrayVisual(_id, objName);
+}
+
+//////////////////////////////////////////////////
+PoseArrayVisualPtr BaseScene::CreatePoseArrayVisual(
+    const std::string &_name)
+{
+  unsigned int objId = this->CreateObjectId();
+  return this->CreatePoseArrayVisual(objId, _name);
+}
+
+//////////////////////////////////////////////////
+PoseArrayVisualPtr BaseScene::CreatePoseArrayVisual(unsigned int _id,
+    const std::string &_name)
+{
+  PoseArrayVisualPtr visual = this->CreatePoseArrayVisualImpl(_id, _name);
+  bool result = this->RegisterVisual(visual);
+  return (result) ? visual : nullptr;
+}
+
 //////////////////////////////////////////////////
 WireBoxPtr BaseScene::CreateWireBox()
 {
@@ -1229,18 +1621,717 @@ bool BaseScene::SkyEnabled() const
 }
 
 
+//////////////////////////////////////////////////
+/// \brief Append the geometries of a node, if it is a visual
+/// \param[in] _node Node
+/// \param[out] _objects List to append the geometries to
+static void appendGeometries(const NodePtr &_node,
+    std::vector<ObjectPtr> &_objects)
+{
+  VisualPtr visual = std::dynamic_pointer_cast<Visual>(_node);
+  if (!visual)
+    return;
+  for (unsigned int i = 0; i < visual->GeometryCount(); ++i)
+    _objects.push_back(visual->GeometryByIndex(i));
+}
+
+//////////////////////////////////////////////////
+/// \brief Collect the objects of a subtree in the order a serial
+/// PreRender visits them, and update the cached world poses of its nodes.
+/// Only the thread collecting a subtree accesses its nodes.
+/// \param[in] _node Root of the subtree, its parent world pose must be up
+/// to date
+/// \param[out] _objects List to append the objects to
+static void collectSubtree(const NodePtr &_node,
+    std::vector<ObjectPtr> &_objects)
+{
+  _node->WorldPose();
+  _objects.push_back(_node);
+  for (unsigned int i = 0; i < _node->ChildCount(); ++i)
+    collectSubtree(_node->ChildByIndex(i), _objects);
+  appendGeometries(_node, _objects);
+}
+
 //////////////////////////////////////////////////
 void BaseScene::PreRender()
 {
-  this->RootVisual()->PreRender();
+  IGN_RENDERING_PROFILE("BaseScene::PreRender");
+  if (this->FramePreRendered())
+    return;
+
+  this->ApplyCommands();
+
+  if (this->incrementalPreRender && this->preRenderTraversed)
+  {
+    this->IncrementalPreRenderImpl();
+  }
+  else
+  {
+    // the traversal prepares every object flagged so far
+    this->dirtyObjects.clear();
+
+    // only traverse in parallel when there are enough nodes to make up for
+    // the cost of starting the threads
+    const unsigned int minNodesPerThread = 2048u;
+    unsigned int threadCount = std::min(this->PreRenderThreadCount(),
+        this->NodeCount() / minNodesPerThread);
+    if (threadCount > 1u)
+      this->ParallelPreRender(threadCount);
+    else
+      this->RootVisual()->PreRender();
+    this->preRenderTraversed = true;
+  }
+
+  if (this->frameActive)
+    this->framePreRendered = true;
+}
+
+//////////////////////////////////////////////////
+void BaseScene::ParallelPreRender(unsigned int _threadCount)
+{
+  IGN_RENDERING_PROFILE("BaseScene::ParallelPreRender");
+
+  // split the scene graph into enough subtrees for the threads to balance
+  // their work. The nodes above the subtrees are collected here.
+  std::vector<ObjectPtr> head;
+  std::vector<NodePtr> subtrees{this->RootVisual()};
+  const size_t minSubtrees = 4u * _threadCount;
+  const int maxSplitDepth = 4;
+  for (int depth = 0; depth < maxSplitDepth && !subtrees.empty() &&
+      subtrees.size() < minSubtrees; ++depth)
+  {
+    std::vector<NodePtr> children;
+    for (auto &node : subtrees)
+    {
+      node->WorldPose();
+      head.push_back(node);
+      for (unsigned int i = 0; i < node->ChildCount(); ++i)
+        children.push_back(node->ChildByIndex(i));
+      appendGeometries(node, head);
+    }
+    subtrees.swap(children);
+  }
+
+  // threads take the next subtree left until there is none
+  std::vector<std::vector<ObjectPtr>> objects(subtrees.size());
+  std::atomic<size_t> next{0u};
+  auto collect = [&]()
+  {
+    for (size_t i = next++; i < subtrees.size(); i = next++)
+      collectSubtree(subtrees[i], objects[i]);
+  };
+  std::vector<std::thread> threads;
+  size_t threadCount = std::min<size_t>(_threadCount, subtrees.size());
+  for (size_t t = 1u; t < threadCount; ++t)
+    threads.emplace_back(collect);
+  collect();
+  for (auto &thread : threads)
+    thread.join();
+
+  // render engine calls are serialized, each object only prepares itself
+  // since its children and geometries were collected
+  BaseObject::SetShallowPreRender(true);
+  for (auto &object : head)
+    object->PreRender();
+  for (auto &subtree : objects)
+  {
+    for (auto &object : subtree)
+      object->PreRender();
+  }
+  BaseObject::SetShallowPreRender(false);
+}
+
+//////////////////////////////////////////////////
+void BaseScene::IncrementalPreRenderImpl()
+{
+  IGN_RENDERING_PROFILE("BaseScene::IncrementalPreRender");
+
+  // objects flagging themselves while being prepared, e.g. to be prepared
+  // every frame, are left for the next PreRender
+  auto dirty = std::move(this->dirtyObjects);
+  this->dirtyObjects.clear();
+
+  for (auto &item : dirty)
+  {
+    ObjectPtr object = item.second.first.lock();
+    if (!object)
+      continue;
+
+    // skip the nodes and geometries that left the scene graph, as the
+    // traversal would
+    NodePtr node = std::dynamic_pointer_cast<Node>(object);
+    if (node && !node->HasParent() && node != this->RootVisual())
+      continue;
+    GeometryPtr geometry = std::dynamic_pointer_cast<Geometry>(object);
+    if (geometry && !geometry->HasParent())
+      continue;
+
+    BaseObject::SetShallowPreRender(!item.second.second);
+    object->PreRender();
+  }
+
+  // sensors render targets are prepared by the traversal
+  BaseObject::SetShallowPreRender(true);
+  for (unsigned int i = 0; i < this->SensorCount(); ++i)
+    this->SensorByIndex(i)->PreRender();
+  BaseObject::SetShallowPreRender(false);
+}
+
+//////////////////////////////////////////////////
+void BaseScene::SetIncrementalPreRender(bool _enabled)
+{
+  if (_enabled && !this->incrementalPreRender)
+    this->preRenderTraversed = false;
+  this->incrementalPreRender = _enabled;
+  if (!_enabled)
+    this->dirtyObjects.clear();
+}
+
+//////////////////////////////////////////////////
+bool BaseScene::IncrementalPreRender() const
+{
+  return this->incrementalPreRender;
+}
+
+//////////////////////////////////////////////////
+void BaseScene::MarkPreRenderDirty(ObjectPtr _object, bool _subtree)
+{
+  ++this->changeVersion;
+  if (!this->incrementalPreRender || !_object)
+    return;
+
+  auto &item = this->dirtyObjects[_object.get()];
+  if (item.first.expired())
+  {
+    item.first = _object;
+    item.second = _subtree;
+  }
+  else
+  {
+    item.second = item.second || _subtree;
+  }
+}
+
+//////////////////////////////////////////////////
+uint64_t BaseScene::ChangeVersion() const
+{
+  return this->changeVersion;
+}
+
+//////////////////////////////////////////////////
+void BaseScene::SetPreRenderThreadCount(unsigned int _count)
+{
+  this->preRenderThreadCount = (_count > 0u) ? _count :
+      std::max(1u, std::thread::hardware_concurrency());
+}
+
+//////////////////////////////////////////////////
+unsigned int BaseScene::PreRenderThreadCount() const
+{
+  return this->preRenderThreadCount;
+}
+
+//////////////////////////////////////////////////
+void BaseScene::EnqueueCommand(std::function<void()> _command)
+{
+  this->commands.Push(std::move(_command));
+}
+
+//////////////////////////////////////////////////
+size_t BaseScene::ApplyCommands()
+{
+  IGN_RENDERING_PROFILE("BaseScene::ApplyCommands");
+  return this->commands.Execute();
+}
+
+//////////////////////////////////////////////////
+void BaseScene::BeginFrame()
+{
+  this->frameActive = true;
+  this->framePreRendered = false;
+}
+
+//////////////////////////////////////////////////
+void BaseScene::EndFrame()
+{
+  this->frameActive = false;
+  this->framePreRendered = false;
+}
+
+//////////////////////////////////////////////////
+bool BaseScene::FrameActive() const
+{
+  return this->frameActive;
+}
+
+//////////////////////////////////////////////////
+void BaseScene::SetWorldPoses(const std::vector<unsigned int> &_ids,
+    const std::vector<math::Pose3d> &_poses)
+{
+  if (!this->ValidateWorldPoses(_ids, _poses))
+    return;
+
+  for (unsigned int i = 0; i < _ids.size(); ++i)
+  {
+    NodePtr node = this->NodeById(_ids[i]);
+    if (node)
+      node->SetWorldPose(_poses[i]);
+  }
+}
+
+//////////////////////////////////////////////////
+void BaseScene::SetSkeletonBoneTransforms(const std::vector<MeshPtr> &_meshes,
+    const std::vector<math::Matrix4f> &_tfs)
+{
+  std::vector<unsigned int> counts;
+  counts.reserve(_meshes.size());
+  size_t total = 0u;
+  for (const auto &mesh : _meshes)
+  {
+    counts.push_back(mesh ? mesh->SkeletonBoneCount() : 0u);
+    total += counts.back();
+  }
+
+  if (total != _tfs.size())
+  {
+    ignerr << "Unable to set skeleton bone transforms: " << _tfs.size()
+           << " transforms given for " << total << " bones" << std::endl;
+    return;
+  }
+
+  size_t offset = 0u;
+  for (unsigned int i = 0; i < _meshes.size(); ++i)
+  {
+    if (counts[i] > 0u)
+      _meshes[i]->SetSkeletonBoneTransforms(&_tfs[offset], counts[i]);
+    offset += counts[i];
+  }
+}
+
+//////////////////////////////////////////////////
+rendering::MemoryStats BaseScene::ResourceMemoryStats() const
+{
+  return rendering::MemoryStats();
+}
+
+//////////////////////////////////////////////////
+void BaseScene::PrecompileShaders()
+{
+  CameraPtr camera = this->CreateCamera();
+  if (!camera)
+  {
+    ignerr << "Unable to create camera to precompile shaders" << std::endl;
+    return;
+  }
+
+  // a small image is enough, only the shaders matter
+  math::AxisAlignedBox box = this->RootVisual()->BoundingBox();
+  math::Vector3d center = math::Vector3d::Zero;
+  double farClip = 1000.0;
+  if (box.Min().IsFinite() && box.Max().IsFinite())
+  {
+    center = box.Center();
+    farClip = std::max(farClip, box.Size().Length() * 2.0);
+  }
+  camera->SetImageWidth(64u);
+  camera->SetImageHeight(64u);
+  camera->SetAspectRatio(1.0);
+  camera->SetHFOV(IGN_PI * 0.5);
+  camera->SetFarClipPlane(farClip);
+  this->RootVisual()->AddChild(camera);
+  camera->SetWorldPosition(center);
+
+  // look along +x, -x, +y, -y, +z and -z. There is no occlusion culling so
+  // every visual within the far clip plane is drawn by one of the views
+  const std::vector<math::Quaterniond> views = {
+      math::Quaterniond(0, 0, 0),
+      math::Quaterniond(0, 0, IGN_PI),
+      math::Quaterniond(0, 0, IGN_PI * 0.5),
+      math::Quaterniond(0, 0, -IGN_PI * 0.5),
+      math::Quaterniond(0, -IGN_PI * 0.5, 0),
+      math::Quaterniond(0, IGN_PI * 0.5, 0)};
+  for (const auto &view : views)
+  {
+    camera->SetWorldRotation(view);
+    camera->Update();
+  }
+
+  // render materials that may not be assigned to any visual yet. Materials
+  // with the same textures and render states use the same shaders, render
+  // one of each
+  VisualPtr visual = this->CreateVisual();
+  GeometryPtr geometry = this->CreateBox();
+  if (visual && geometry)
+  {
+    visual->AddGeometry(geometry);
+    this->RootVisual()->AddChild(visual);
+    camera->SetWorldRotation(math::Quaterniond::Identity);
+    visual->SetWorldPosition(center + math::Vector3d(2.0, 0.0, 0.0));
+
+    std::set<std::string> features;
+    MaterialMapPtr materials = this->Materials();
+    for (unsigned int i = 0; i < materials->Size(); ++i)
+    {
+      MaterialPtr material = materials->GetByIndex(i);
+      if (!material)
+        continue;
+
+      std::stringstream key;
+      key << material->Type() << material->ShaderType()
+          << material->LightingEnabled() << material->HasTexture()
+          << material->HasNormalMap() << material->HasRoughnessMap()
+          << material->HasMetalnessMap() << material->HasEnvironmentMap()
+          << material->HasEmissiveMap() << material->HasLightMap()
+          << material->TextureAlphaEnabled() << material->TwoSidedEnabled()
+          << (material->Transparency() > 0.0) << material->DepthCheckEnabled()
+          << material->DepthWriteEnabled() << material->CastShadows()
+          << material->ReceiveShadows() << material->ReflectionEnabled()
+          << material->VertexShader() << material->FragmentShader();
+      if (!features.insert(key.str()).second)
+        continue;
+
+      visual->SetMaterial(material, false);
+      camera->Update();
+    }
+  }
+
+  if (visual)
+    this->DestroyVisual(visual);
+  this->DestroySensor(camera);
+}
+
+//////////////////////////////////////////////////
+unsigned int BaseScene::BakeStaticGeometry(
+    const std::vector<VisualPtr> &_visuals, double _cellSize)
+{
+  std::vector<std::pair<MeshPtr, math::Matrix4d>> meshes;
+  std::vector<VisualPtr> owners;
+  std::set<const Geometry *> collected;
+  std::function<void(const VisualPtr &)> collect =
+      [&](const VisualPtr &_visual)
+  {
+    // batches of a previous call are already merged
+    if (std::find(this->staticBatches.begin(), this->staticBatches.end(),
+        _visual) != this->staticBatches.end())
+      return;
+
+    math::Matrix4d scale = math::Matrix4d::Identity;
+    scale.Scale(_visual->WorldScale());
+    math::Matrix4d tf = math::Matrix4d(_visual->WorldPose()) * scale;
+    for (unsigned int i = 0; i < _visual->GeometryCount(); ++i)
+    {
+      MeshPtr mesh = std::dynamic_pointer_cast<Mesh>(
+          _visual->GeometryByIndex(i));
+      if (!mesh || mesh->HasSkeleton() || !collected.insert(mesh.get()).second)
+        continue;
+      meshes.emplace_back(mesh, tf);
+      owners.push_back(_visual);
+    }
+    for (unsigned int i = 0; i < _visual->ChildCount(); ++i)
+    {
+      VisualPtr child =
+          std::dynamic_pointer_cast<Visual>(_visual->ChildByIndex(i));
+      if (child)
+        collect(child);
+    }
+  };
+
+  for (const auto &visual : _visuals)
+  {
+    if (!visual)
+      continue;
+    if (!visual->Static())
+    {
+      ignwarn << "Visual [" << visual->Name() << "] is not static, its "
+              << "meshes are not merged" << std::endl;
+      continue;
+    }
+    collect(visual);
+  }
+  if (meshes.empty())
+    return 0u;
+
+  double cellSize = std::isfinite(_cellSize) ? std::max(0.0, _cellSize) : 0.0;
+  std::vector<bool> baked = this->BakeStaticMeshesImpl(meshes, cellSize);
+
+  // the merged meshes are drawn by the batches from now on
+  unsigned int count = 0u;
+  for (size_t i = 0u; i < meshes.size() && i < baked.size(); ++i)
+  {
+    if (!baked[i])
+      continue;
+    owners[i]->RemoveGeometry(meshes[i].first);
+    this->bakedMeshes.emplace_back(owners[i], meshes[i].first);
+    ++count;
+  }
+  return count;
+}
+
+//////////////////////////////////////////////////
+void BaseScene::ClearStaticGeometry()
+{
+  this->ClearStaticMeshesImpl();
+
+  for (auto &baked : this->bakedMeshes)
+  {
+    // the visual may have been destroyed since
+    if (this->HasVisual(baked.first))
+      baked.first->AddGeometry(baked.second);
+    else
+      baked.second->Destroy();
+  }
+  this->bakedMeshes.clear();
+}
+
+//////////////////////////////////////////////////
+std::vector<bool> BaseScene::BakeStaticMeshesImpl(
+    const std::vector<std::pair<MeshPtr, math::Matrix4d>> &_meshes,
+    double _cellSize)
+{
+  // triangles of the same material, visibility flags and vertex
+  // attributes in the same cell are merged into one submesh
+  using CellKey = std::tuple<int64_t, int64_t, int64_t, uint32_t>;
+  using GroupKey = std::tuple<const Material *, bool, bool>;
+  struct Group
+  {
+    MaterialPtr material;
+    common::SubMesh subMesh;
+  };
+  std::map<CellKey, std::map<GroupKey, Group>> cells;
+
+  std::vector<bool> baked(_meshes.size(), false);
+  for (size_t m = 0u; m < _meshes.size(); ++m)
+  {
+    const MeshPtr &mesh = _meshes[m].first;
+    const math::Matrix4d &tf = _meshes[m].second;
+
+    std::vector<std::shared_ptr<common::SubMesh>> subMeshes;
+    math::Vector3d offset;
+    if (!descriptorSubMeshes(*mesh, subMeshes, offset))
+      continue;
+
+    // only meshes made of indexed triangles with materials are merged
+    std::vector<MaterialPtr> materials;
+    for (unsigned int i = 0; i < subMeshes.size(); ++i)
+    {
+      SubMeshPtr subMesh = mesh->SubMeshByIndex(i);
+      MaterialPtr material = subMesh->MaterialOverride() ?
+          subMesh->MaterialOverride() : subMesh->Material();
+      if (!material ||
+          subMeshes[i]->SubMeshPrimitive() != common::SubMesh::TRIANGLES ||
+          subMeshes[i]->IndexCount() == 0u)
+      {
+        break;
+      }
+      materials.push_back(material);
+    }
+    if (materials.size() != subMeshes.size())
+      continue;
+
+    VisualPtr parent = mesh->Parent();
+    uint32_t flags = parent ? parent->VisibilityFlags() : IGN_VISIBILITY_ALL;
+
+    // normals are transformed by the inverse transpose
+    math::Matrix4d normalTf = tf;
+    normalTf.SetTranslation(math::Vector3d::Zero);
+    normalTf = normalTf.Inverse().Transposed();
+
+    for (size_t i = 0u; i < subMeshes.size(); ++i)
+    {
+      const common::SubMesh &src = *subMeshes[i];
+      CellKey cellKey(0, 0, 0, flags);
+      if (_cellSize > 0.0)
+      {
+        math::Vector3d center =
+            tf * ((src.Min() + src.Max()) * 0.5 + offset);
+        cellKey = CellKey(
+            static_cast<int64_t>(std::floor(center.X() / _cellSize)),
+            static_cast<int64_t>(std::floor(center.Y() / _cellSize)),
+            static_cast<int64_t>(std::floor(center.Z() / _cellSize)),
+            flags);
+      }
+
+      bool hasNormals = src.NormalCount() == src.VertexCount();
+      bool hasTexCoords = src.TexCoordCount() == src.VertexCount();
+      Group &group = cells[cellKey][GroupKey(materials[i].get(),
+          hasNormals, hasTexCoords)];
+      group.material = materials[i];
+      group.subMesh.SetPrimitiveType(common::SubMesh::TRIANGLES);
+
+      unsigned int base = group.subMesh.VertexCount();
+      for (unsigned int v = 0; v < src.VertexCount(); ++v)
+      {
+        group.subMesh.AddVertex(tf * (src.Vertex(v) + offset));
+        if (hasNormals)
+          group.subMesh.AddNormal((normalTf * src.Normal(v)).Normalized());
+        if (hasTexCoords)
+          group.subMesh.AddTexCoord(src.TexCoord(v));
+      }
+      for (unsigned int k = 0; k < src.IndexCount(); ++k)
+        group.subMesh.AddIndex(base + static_cast<unsigned int>(src.Index(k)));
+    }
+    baked[m] = true;
+  }
+
+  // one mesh per cell, with one submesh per group
+  size_t firstBatch = this->staticBatches.size();
+  for (auto &cell : cells)
+  {
+    auto batchMesh = std::make_shared<common::Mesh>();
+    batchMesh->SetName("StaticGeometry::" + this->name + "::" +
+        std::to_string(staticBatchCounter++));
+    std::vector<MaterialPtr> materials;
+    for (auto &group : cell.second)
+    {
+      batchMesh->AddSubMesh(group.second.subMesh);
+      materials.push_back(group.second.material);
+    }
+
+    MeshPtr geometry = this->CreateMesh(batchMesh.get());
+    VisualPtr visual = this->CreateVisual();
+    if (!geometry || !visual)
+    {
+      ignerr << "Unable to create static geometry batch" << std::endl;
+      if (visual)
+        this->DestroyVisual(visual);
+      // the meshes are left in their visuals
+      for (size_t i = firstBatch; i < this->staticBatches.size(); ++i)
+        this->DestroyVisual(this->staticBatches[i]);
+      this->staticBatches.resize(firstBatch);
+      this->staticBatchMeshes.resize(firstBatch);
+      return std::vector<bool>(_meshes.size(), false);
+    }
+    for (unsigned int i = 0;
+        i < geometry->SubMeshCount() && i < materials.size(); ++i)
+    {
+      geometry->SubMeshByIndex(i)->SetMaterial(materials[i], false);
+    }
+    visual->AddGeometry(geometry);
+    visual->SetVisibilityFlags(std::get<3>(cell.first));
+    visual->SetStatic(true);
+    this->RootVisual()->AddChild(visual);
+    this->staticBatches.push_back(visual);
+    this->staticBatchMeshes.push_back(batchMesh);
+  }
+  return baked;
+}
+
+//////////////////////////////////////////////////
+void BaseScene::ClearStaticMeshesImpl()
+{
+  for (auto &visual : this->staticBatches)
+  {
+    if (this->HasVisual(visual))
+      this->DestroyVisual(visual);
+  }
+  this->staticBatches.clear();
+  this->staticBatchMeshes.clear();
+}
+
+//////////////////////////////////////////////////
+bool BaseScene::ValidateWorldPoses(const std::vector<unsigned int> &_ids,
+    const std::vector<math::Pose3d> &_poses) const
+{
+  if (_ids.size() != _poses.size())
+  {
+    ignerr << "Unable to set world poses: got " << _ids.size()
+           << " node ids but " << _poses.size() << " poses" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool BaseScene::FramePreRendered() const
+{
+  return this->frameActive && this->framePreRendered;
 }
 
 //////////////////////////////////////////////////
 void BaseScene::Clear()
 {
+  this->ClearStaticGeometry();
+
+  // queued commands may refer to the objects destroyed
+  this->commands.Clear();
+  this->dirtyObjects.clear();
   this->nodes->DestroyAll();
   this->DestroyMaterials();
   this->nextObjectId = ignition::math::MAX_UI16;
+
+  // the ids of the visuals are reused
+  this->visualTree.Clear();
+  this->dirtyVisualBounds.clear();
+  this->visualTreeBuilt = false;
+  this->clearing = false;
+}
+
+//////////////////////////////////////////////////
+void BaseScene::BeginClear()
+{
+  if (this->clearing)
+    return;
+
+  this->ClearStaticGeometry();
+
+  // queued commands may refer to the objects destroyed
+  this->commands.Clear();
+  this->dirtyObjects.clear();
+  this->sharedMaterials.clear();
+  this->sharedMaterialKeys.clear();
+
+  // the detached objects are no longer rendered while they are destroyed
+  VisualPtr root = this->RootVisual();
+  if (root)
+    root->RemoveChildren();
+
+  this->clearing = true;
+}
+
+//////////////////////////////////////////////////
+bool BaseScene::ClearStep(const std::chrono::steady_clock::duration &_budget)
+{
+  if (!this->clearing)
+    return true;
+
+  auto start = std::chrono::steady_clock::now();
+  bool destroyed = false;
+  auto spent = [&]()
+  {
+    return destroyed && std::chrono::steady_clock::now() - start >= _budget;
+  };
+
+  // nodes first, since they refer to the materials
+  while (this->nodes->Size() > 0u)
+  {
+    if (spent())
+      return false;
+    NodePtr node = this->nodes->GetByIndex(this->nodes->Size() - 1u);
+    this->nodes->Destroy(node);
+    destroyed = true;
+  }
+
+  MaterialMapPtr materials = this->Materials();
+  while (materials->Size() > 0u)
+  {
+    if (spent())
+      return false;
+    this->DestroyMaterial(materials->GetByIndex(materials->Size() - 1u));
+    destroyed = true;
+  }
+
+  this->nextObjectId = ignition::math::MAX_UI16;
+  this->visualTree.Clear();
+  this->dirtyVisualBounds.clear();
+  this->visualTreeBuilt = false;
+  this->clearing = false;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool BaseScene::Clearing() const
+{
+  return this->clearing;
 }
 
 //////////////////////////////////////////////////
@@ -1262,10 +2353,13 @@ unsigned int BaseScene::CreateObjectId()
 std::string BaseScene::CreateObjectName(unsigned int _id,
     const std::string &_prefix)
 {
-  std::stringstream ss;
-  ss << this->name << "::" << _prefix;
-  ss << "(" << std::to_string(_id) << ")";
-  return ss.str();
+  // formatted without a stream since every Create call goes through here
+  std::string id = std::to_string(_id);
+  std::string objName;
+  objName.reserve(this->name.size() + _prefix.size() + id.size() + 4u);
+  objName.append(this->name).append("::").append(_prefix);
+  objName.append(1u, '(').append(id).append(1u, ')');
+  return objName;
 }
 
 //////////////////////////////////////////////////
@@ -1283,7 +2377,110 @@ bool BaseScene::RegisterSensor(SensorPtr _sensor)
 //////////////////////////////////////////////////
 bool BaseScene::RegisterVisual(VisualPtr _visual)
 {
-  return (_visual) ? this->Visuals()->Add(_visual) : false;
+  if (!_visual || !this->Visuals()->Add(_visual))
+    return false;
+
+  this->dirtyVisualBounds.insert(_visual->Id());
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool BaseScene::VisualBoundsTracked() const
+{
+  return false;
+}
+
+//////////////////////////////////////////////////
+void BaseScene::SetVisualBoundsDirty(unsigned int _id)
+{
+  this->dirtyVisualBounds.insert(_id);
+}
+
+//////////////////////////////////////////////////
+void BaseScene::UpdateVisualTree()
+{
+  VisualPtr root = this->RootVisual();
+  auto update = [&](unsigned int _id, const VisualPtr &_visual)
+  {
+    math::AxisAlignedBox box;
+    if (_visual && _visual != root)
+      box = _visual->BoundingBox();
+
+    // visuals without geometry have an empty box and are never reported
+    const math::Vector3d &min = box.Min();
+    const math::Vector3d &max = box.Max();
+    if (min.X() <= max.X() && min.Y() <= max.Y() && min.Z() <= max.Z() &&
+        min.IsFinite() && max.IsFinite())
+    {
+      this->visualTree.Update(_id, box);
+    }
+    else
+    {
+      this->visualTree.Remove(_id);
+    }
+  };
+
+  if (this->VisualBoundsTracked() && this->visualTreeBuilt)
+  {
+    for (auto id : this->dirtyVisualBounds)
+      update(id, this->VisualById(id));
+    this->dirtyVisualBounds.clear();
+    return;
+  }
+
+  // every visual is checked, and the destroyed ones are dropped
+  this->dirtyVisualBounds.clear();
+  VisualStorePtr visuals = this->Visuals();
+  for (unsigned int i = 0; i < visuals->Size(); ++i)
+  {
+    VisualPtr visual = visuals->GetByIndex(i);
+    update(visual->Id(), visual);
+  }
+  for (auto id : this->visualTree.Ids())
+  {
+    if (!visuals->ContainsId(id))
+      this->visualTree.Remove(id);
+  }
+  this->visualTreeBuilt = true;
+}
+
+//////////////////////////////////////////////////
+std::vector<VisualPtr> BaseScene::VisualsById(
+    const std::vector<unsigned int> &_ids)
+{
+  std::vector<VisualPtr> result;
+  result.reserve(_ids.size());
+  for (auto id : _ids)
+  {
+    VisualPtr visual = this->VisualById(id);
+    if (visual)
+      result.push_back(visual);
+  }
+  return result;
+}
+
+//////////////////////////////////////////////////
+std::vector<VisualPtr> BaseScene::VisualsInBox(
+    const math::AxisAlignedBox &_box)
+{
+  this->UpdateVisualTree();
+  return this->VisualsById(this->visualTree.QueryBox(_box));
+}
+
+//////////////////////////////////////////////////
+std::vector<VisualPtr> BaseScene::VisualsInSphere(
+    const math::Vector3d &_center, double _radius)
+{
+  this->UpdateVisualTree();
+  return this->VisualsById(this->visualTree.QuerySphere(_center, _radius));
+}
+
+//////////////////////////////////////////////////
+std::vector<VisualPtr> BaseScene::VisualsInFrustum(
+    const math::Frustum &_frustum)
+{
+  this->UpdateVisualTree();
+  return this->VisualsById(this->visualTree.QueryFrustum(_frustum));
 }
 
 //////////////////////////////////////////////////
@@ -17,11 +17,18 @@
 
 #include <gtest/gtest.h>
 
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
 #include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
 
 #include "test_config.h"  // NOLINT(build/include)
 
 #include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/ImagePool.hh"
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/RenderingIface.hh"
 #include "ignition/rendering/Scene.hh"
@@ -49,6 +56,15 @@ class CameraTest: public testing::Test,
 
   // Test and verify camera select function method using Selection Buffer
   public: void VisualAt(const std::string &_renderEngine);
+
+  // Test and verify camera region selection using Selection Buffer
+  public: void VisualsInRegion(const std::string &_renderEngine);
+
+  // Test capturing images to user buffers with padded rows
+  public: void CaptureToBuffer(const std::string &_renderEngine);
+
+  // Test recording the rendered frames, inside and outside render batches
+  public: void Recording(const std::string &_renderEngine);
 };
 
 /////////////////////////////////////////////////
@@ -531,6 +547,253 @@ void CameraTest::Visibility(const std::string &_renderEngine)
   rendering::unloadEngine(engine->Name());
 }
 
+/////////////////////////////////////////////////
+void CameraTest::VisualsInRegion(const std::string &_renderEngine)
+{
+  if (_renderEngine != "ogre" && _renderEngine != "ogre2")
+  {
+    igndbg << "VisualsInRegion not supported yet in rendering engine: "
+            << _renderEngine << std::endl;
+    return;
+  }
+
+  // create and populate scene
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+
+  VisualPtr root = scene->RootVisual();
+
+  // create box visual
+  VisualPtr box = scene->CreateVisual("box");
+  ASSERT_TRUE(box != nullptr);
+  box->AddGeometry(scene->CreateBox());
+  box->SetOrigin(0.0, 0.7, 0.0);
+  box->SetLocalPosition(2, 0, 0);
+  root->AddChild(box);
+
+  // create sphere visual
+  VisualPtr sphere = scene->CreateVisual("sphere");
+  ASSERT_TRUE(sphere != nullptr);
+  sphere->AddGeometry(scene->CreateSphere());
+  sphere->SetOrigin(0.0, -0.7, 0.0);
+  sphere->SetLocalPosition(2, 0, 0);
+  root->AddChild(sphere);
+
+  // create camera
+  CameraPtr camera = scene->CreateCamera("camera");
+  ASSERT_TRUE(camera != nullptr);
+  camera->SetLocalPosition(0.0, 0.0, 0.0);
+  camera->SetLocalRotation(0.0, 0.0, 0.0);
+  camera->SetImageWidth(800);
+  camera->SetImageHeight(600);
+  camera->SetAspectRatio(1.333);
+  camera->SetHFOV(IGN_PI / 2);
+  root->AddChild(camera);
+
+  // render a few frames
+  for (auto i = 0; i < 30; ++i)
+  {
+    camera->Update();
+  }
+
+  // whole image, both visuals are found once
+  auto visuals = camera->VisualsInRegion(math::Vector2i(0, 0),
+      math::Vector2i(camera->ImageWidth(), camera->ImageHeight()));
+  ASSERT_EQ(2u, visuals.size());
+  EXPECT_NE(visuals[0], visuals[1]);
+  for (auto &vis : visuals)
+    EXPECT_TRUE(vis == box || vis == sphere);
+
+  // left half, only the sphere
+  visuals = camera->VisualsInRegion(math::Vector2i(0, 0),
+      math::Vector2i(camera->ImageWidth() / 2 - 50, camera->ImageHeight()));
+  ASSERT_EQ(1u, visuals.size());
+  EXPECT_EQ(sphere, visuals[0]);
+
+  // right half, only the box
+  visuals = camera->VisualsInRegion(
+      math::Vector2i(camera->ImageWidth() / 2 + 50, 0),
+      math::Vector2i(camera->ImageWidth(), camera->ImageHeight()));
+  ASSERT_EQ(1u, visuals.size());
+  EXPECT_EQ(box, visuals[0]);
+
+  // empty corner of the image
+  visuals = camera->VisualsInRegion(math::Vector2i(0, 0),
+      math::Vector2i(50, 50));
+  EXPECT_TRUE(visuals.empty());
+
+  // empty and out of image regions
+  EXPECT_TRUE(camera->VisualsInRegion(math::Vector2i(100, 100),
+      math::Vector2i(100, 200)).empty());
+  EXPECT_TRUE(camera->VisualsInRegion(math::Vector2i(1000, 1000),
+      math::Vector2i(1100, 1100)).empty());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void CameraTest::CaptureToBuffer(const std::string &_renderEngine)
+{
+  // create and populate scene
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+  scene->SetBackgroundColor(0, 0, 1);
+  scene->SetAmbientLight(1, 1, 1);
+
+  VisualPtr root = scene->RootVisual();
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_TRUE(camera != nullptr);
+  camera->SetWorldPosition(-1, 0, 0);
+  camera->SetImageWidth(30u);
+  camera->SetImageHeight(20u);
+  camera->SetImageFormat(PF_R8G8B8);
+  root->AddChild(camera);
+
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  box->SetWorldPosition(0.5, 0.0, 0.0);
+  MaterialPtr green = scene->CreateMaterial();
+  green->SetAmbient(0.0, 1.0, 0.0);
+  green->SetDiffuse(0.0, 1.0, 0.0);
+  box->SetMaterial(green);
+  root->AddChild(box);
+
+  Image image = camera->CreateImage();
+  camera->Capture(image);
+
+  // rows padded to 128 bytes, as some capture hardware requires
+  unsigned int width = camera->ImageWidth();
+  unsigned int height = camera->ImageHeight();
+  unsigned int step = width * 3u;
+  unsigned int stride = 128u;
+  const unsigned char padding = 0x7f;
+  std::vector<unsigned char> buffer(stride * height, padding);
+  camera->Capture(buffer.data(), stride);
+
+  unsigned char *data = image.Data<unsigned char>();
+  for (unsigned int i = 0; i < height; ++i)
+  {
+    for (unsigned int j = 0; j < step; ++j)
+      EXPECT_EQ(data[i * step + j], buffer[i * stride + j]);
+    // padding is left untouched
+    for (unsigned int j = step; j < stride; ++j)
+      EXPECT_EQ(padding, buffer[i * stride + j]);
+  }
+
+  // images from the pool reuse their buffers once released
+  ImagePool pool(width, height, camera->ImageFormat());
+  for (unsigned int k = 0; k < 3; ++k)
+  {
+    Image pooled = pool.Acquire();
+    camera->Capture(pooled);
+    EXPECT_EQ(data[0], pooled.Data<unsigned char>()[0]);
+  }
+  EXPECT_EQ(1u, pool.Size());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+/// \brief Read the first pixel of a raw R8G8B8 frame
+/// \param[in] _path Path of the frame
+/// \param[in] _size Expected size of the frame in bytes
+/// \return Bytes of the first pixel, empty if the frame is not valid
+static std::vector<unsigned char> firstPixel(const std::string &_path,
+    unsigned int _size)
+{
+  std::ifstream file(_path, std::ios::binary);
+  std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)),
+      std::istreambuf_iterator<char>());
+  if (bytes.size() != _size)
+    return {};
+  return {bytes[0], bytes[1], bytes[2]};
+}
+
+/////////////////////////////////////////////////
+void CameraTest::Recording(const std::string &_renderEngine)
+{
+  // create and populate scene
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+  scene->SetBackgroundColor(0, 0, 1);
+
+  VisualPtr root = scene->RootVisual();
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_TRUE(camera != nullptr);
+  camera->SetImageWidth(16u);
+  camera->SetImageHeight(8u);
+  camera->SetImageFormat(PF_R8G8B8);
+  root->AddChild(camera);
+
+  std::string dir = common::joinPaths(PROJECT_BUILD_PATH,
+      "camera_recording_" + _renderEngine);
+  common::removeAll(dir);
+  ASSERT_TRUE(camera->StartRecording(dir, "raw"));
+  EXPECT_TRUE(camera->Recording());
+
+  // outside a batch the frame is written right after rendering
+  camera->Update();
+
+  // inside a batch the frame is written once the batch is rendered, so the
+  // red frame is recorded instead of the previous blue one
+  scene->SetBackgroundColor(1, 0, 0);
+  engine->BeginRenderBatch();
+  camera->Update();
+  engine->EndRenderBatch();
+
+  camera->StopRecording();
+  EXPECT_FALSE(camera->Recording());
+
+  unsigned int size = 16u * 8u * 3u;
+  std::vector<unsigned char> blue =
+      firstPixel(common::joinPaths(dir, "frame_000000.raw"), size);
+  ASSERT_EQ(3u, blue.size());
+  EXPECT_GT(blue[2], blue[0]);
+
+  std::vector<unsigned char> red =
+      firstPixel(common::joinPaths(dir, "frame_000001.raw"), size);
+  ASSERT_EQ(3u, red.size());
+  EXPECT_GT(red[0], red[2]);
+
+  // no more frames are written once stopped
+  camera->Update();
+  EXPECT_FALSE(common::exists(common::joinPaths(dir, "frame_000002.raw")));
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
 /////////////////////////////////////////////////
 TEST_P(CameraTest, Track)
 {
@@ -555,6 +818,24 @@ TEST_P(CameraTest, VisualAt)
   VisualAt(GetParam());
 }
 
+/////////////////////////////////////////////////
+TEST_P(CameraTest, VisualsInRegion)
+{
+  VisualsInRegion(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(CameraTest, CaptureToBuffer)
+{
+  CaptureToBuffer(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(CameraTest, Recording)
+{
+  Recording(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(Camera, CameraTest,
     RENDER_ENGINE_VALUES,
     ignition::rendering::PrintToStringParam());
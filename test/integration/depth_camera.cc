@@ -17,6 +17,9 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 #include <ignition/common/Filesystem.hh>
 #include <ignition/common/Event.hh>
@@ -25,6 +28,7 @@
 
 #include "ignition/rendering/DepthCamera.hh"
 #include "ignition/rendering/ParticleEmitter.hh"
+#include "ignition/rendering/PixelFormat.hh"
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/RenderingIface.hh"
 #include "ignition/rendering/Scene.hh"
@@ -66,6 +70,12 @@ class DepthCameraTest: public testing::Test,
   // Compare depth camera image before and after adding particles
   // in the scene
   public: void DepthCameraParticles(const std::string &_renderEngine);
+
+  // Check the raw depth of cameras with compact image formats
+  public: void DepthCameraPackedFormats(const std::string &_renderEngine);
+
+  // Check the color frames of depth cameras
+  public: void DepthCameraRgbFrame(const std::string &_renderEngine);
 };
 
 void DepthCameraTest::DepthCameraBoxes(
@@ -766,6 +776,231 @@ void DepthCameraTest::DepthCameraParticles(
   ignition::rendering::unloadEngine(engine->Name());
 }
 
+void DepthCameraTest::DepthCameraPackedFormats(
+    const std::string &_renderEngine)
+{
+  unsigned int imgWidth = 64u;
+  unsigned int imgHeight = 64u;
+  ignition::math::Vector3d boxPosition(1.8, 0.0, 0.0);
+
+  // Optix is not supported
+  if (_renderEngine.compare("optix") == 0)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' doesn't support depth cameras" << std::endl;
+    return;
+  }
+
+  auto *engine = ignition::rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ignition::rendering::ScenePtr scene = engine->CreateScene("scene");
+  ignition::rendering::VisualPtr root = scene->RootVisual();
+
+  ignition::rendering::VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(boxPosition);
+  root->AddChild(box);
+
+  auto createCamera = [&](const std::string &_name,
+      ignition::rendering::PixelFormat _format)
+  {
+    auto depthCamera = scene->CreateDepthCamera(_name);
+    depthCamera->SetImageWidth(imgWidth);
+    depthCamera->SetImageHeight(imgHeight);
+    depthCamera->SetFarClipPlane(10.0);
+    depthCamera->SetNearClipPlane(0.15);
+    depthCamera->SetAspectRatio(1.0);
+    depthCamera->SetHFOV(1.05);
+    depthCamera->SetImageFormat(_format);
+    root->AddChild(depthCamera);
+    return depthCamera;
+  };
+
+  unsigned int mid = imgHeight / 2u * imgWidth + imgWidth / 2u;
+  double expectedDepth = boxPosition.X() - 0.5;
+
+  // 16 bit depth in millimeters, only the packed depth is read back
+  {
+    auto depthCamera = createCamera("DepthCameraL16",
+        ignition::rendering::PF_L16);
+    std::vector<uint16_t> millimeters(imgWidth * imgHeight);
+    std::string format;
+    unsigned int frames = 0u;
+    ignition::common::ConnectionPtr connection =
+        depthCamera->ConnectNewRawDepthFrame(
+        [&](const unsigned char *_data, unsigned int _width,
+            unsigned int _height, unsigned int _channels,
+            const std::string &_format)
+        {
+          EXPECT_EQ(1u, _channels);
+          memcpy(millimeters.data(), _data,
+              _width * _height * sizeof(uint16_t));
+          format = _format;
+          ++frames;
+        });
+    if (!connection)
+    {
+      igndbg << "Engine '" << _renderEngine
+             << "' doesn't support raw depth frames" << std::endl;
+      engine->DestroyScene(scene);
+      ignition::rendering::unloadEngine(engine->Name());
+      return;
+    }
+
+    depthCamera->Update();
+    EXPECT_EQ(1u, frames);
+    EXPECT_EQ("L16", format);
+    EXPECT_NEAR(expectedDepth * 1000.0, millimeters[mid], 1.0);
+    // the rays at the left and right edges miss the box
+    EXPECT_EQ(0u, millimeters[mid - imgWidth / 2u]);
+    EXPECT_EQ(0u, millimeters[mid + imgWidth / 2u - 1u]);
+  }
+
+  // half float depth in meters, matching the float depth
+  {
+    auto depthCamera = createCamera("DepthCameraFloat16",
+        ignition::rendering::PF_FLOAT16_R);
+    std::vector<uint16_t> halves(imgWidth * imgHeight);
+    std::vector<float> depth(imgWidth * imgHeight);
+    std::string format;
+    ignition::common::ConnectionPtr connection =
+        depthCamera->ConnectNewRawDepthFrame(
+        [&](const unsigned char *_data, unsigned int _width,
+            unsigned int _height, unsigned int, const std::string &_format)
+        {
+          memcpy(halves.data(), _data, _width * _height * sizeof(uint16_t));
+          format = _format;
+        });
+    ignition::common::ConnectionPtr connection2 =
+        depthCamera->ConnectNewDepthFrame(
+        std::bind(&::OnNewDepthFrame, depth.data(),
+          std::placeholders::_1, std::placeholders::_2, std::placeholders::_3,
+          std::placeholders::_4, std::placeholders::_5));
+
+    // with and without float depth subscribers
+    for (unsigned int i = 0u; i < 2u; ++i)
+    {
+      depthCamera->Update();
+      EXPECT_EQ("FLOAT16_R", format);
+      std::vector<float> widened(halves.size());
+      EXPECT_TRUE(ignition::rendering::PixelUtil::Convert(halves.data(),
+          ignition::rendering::PF_FLOAT16_R, widened.data(),
+          ignition::rendering::PF_FLOAT32_R, widened.size()));
+      EXPECT_NEAR(expectedDepth, widened[mid], 2e-3);
+      EXPECT_NEAR(depth[mid], widened[mid], 2e-3);
+      connection2.reset();
+    }
+  }
+
+  engine->DestroyScene(scene);
+  ignition::rendering::unloadEngine(engine->Name());
+}
+
+//////////////////////////////////////////////////
+void DepthCameraTest::DepthCameraRgbFrame(
+    const std::string &_renderEngine)
+{
+  unsigned int imgWidth = 64u;
+  unsigned int imgHeight = 64u;
+
+  // Optix is not supported
+  if (_renderEngine.compare("optix") == 0)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' doesn't support depth cameras" << std::endl;
+    return;
+  }
+
+  auto *engine = ignition::rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  // blue box in front of a red background
+  ignition::rendering::ScenePtr scene = engine->CreateScene("scene");
+  scene->SetBackgroundColor(1.0, 0.0, 0.0);
+  scene->SetAmbientLight(1.0, 1.0, 1.0);
+  ignition::rendering::VisualPtr root = scene->RootVisual();
+
+  ignition::rendering::MaterialPtr blue = scene->CreateMaterial();
+  blue->SetAmbient(0.0, 0.0, 1.0);
+  blue->SetDiffuse(0.0, 0.0, 1.0);
+  blue->SetSpecular(0.0, 0.0, 1.0);
+
+  ignition::rendering::VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(1.8, 0.0, 0.0);
+  box->SetMaterial(blue);
+  root->AddChild(box);
+
+  auto depthCamera = scene->CreateDepthCamera("DepthCamera");
+  depthCamera->SetImageWidth(imgWidth);
+  depthCamera->SetImageHeight(imgHeight);
+  depthCamera->SetFarClipPlane(10.0);
+  depthCamera->SetNearClipPlane(0.15);
+  depthCamera->SetAspectRatio(1.0);
+  depthCamera->SetHFOV(1.05);
+  depthCamera->CreateDepthTexture();
+  root->AddChild(depthCamera);
+
+  std::vector<unsigned char> rgb;
+  std::string format;
+  unsigned int frames = 0u;
+  ignition::common::ConnectionPtr connection =
+      depthCamera->ConnectNewRgbFrame(
+      [&](const unsigned char *_image, unsigned int _width,
+          unsigned int _height, unsigned int _depth,
+          const std::string &_format)
+      {
+        EXPECT_EQ(imgWidth, _width);
+        EXPECT_EQ(imgHeight, _height);
+        EXPECT_EQ(3u, _depth);
+        rgb.assign(_image, _image + _width * _height * _depth);
+        format = _format;
+        ++frames;
+      });
+
+  // only ogre2 outputs the color frames
+  if (_renderEngine != "ogre2")
+  {
+    EXPECT_EQ(nullptr, connection);
+    engine->DestroyScene(scene);
+    ignition::rendering::unloadEngine(engine->Name());
+    return;
+  }
+  ASSERT_NE(nullptr, connection);
+
+  depthCamera->Update();
+  EXPECT_EQ(1u, frames);
+  EXPECT_EQ("PF_R8G8B8", format);
+  ASSERT_EQ(imgWidth * imgHeight * 3u, rgb.size());
+
+  // the box is in the middle and the background on the sides
+  unsigned int mid = (imgHeight / 2u * imgWidth + imgWidth / 2u) * 3u;
+  unsigned int left = imgHeight / 2u * imgWidth * 3u;
+  EXPECT_GT(rgb[mid + 2], rgb[mid]);
+  EXPECT_GT(rgb[mid + 2], rgb[mid + 1]);
+  EXPECT_GT(rgb[left], rgb[left + 1]);
+  EXPECT_GT(rgb[left], rgb[left + 2]);
+
+  // a new frame is emitted each update
+  depthCamera->Update();
+  EXPECT_EQ(2u, frames);
+
+  connection.reset();
+  engine->DestroyScene(scene);
+  ignition::rendering::unloadEngine(engine->Name());
+}
+
 TEST_P(DepthCameraTest, DepthCameraBoxes)
 {
   DepthCameraBoxes(GetParam());
@@ -776,6 +1011,16 @@ TEST_P(DepthCameraTest, DepthCameraParticles)
   DepthCameraParticles(GetParam());
 }
 
+TEST_P(DepthCameraTest, DepthCameraPackedFormats)
+{
+  DepthCameraPackedFormats(GetParam());
+}
+
+TEST_P(DepthCameraTest, DepthCameraRgbFrame)
+{
+  DepthCameraRgbFrame(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(DepthCamera, DepthCameraTest,
     RENDER_ENGINE_VALUES, ignition::rendering::PrintToStringParam());
 
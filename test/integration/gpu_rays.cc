@@ -17,16 +17,24 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <string>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 #include <ignition/common/Image.hh>
 #include <ignition/common/Filesystem.hh>
 
 #include "test_config.h"  // NOLINT(build/include)
 
+#include "ignition/rendering/DistortionPass.hh"
+#include "ignition/rendering/DropoutPass.hh"
+#include "ignition/rendering/GaussianNoisePass.hh"
 #include "ignition/rendering/GpuRays.hh"
 #include "ignition/rendering/ParticleEmitter.hh"
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/RenderPassSystem.hh"
 #include "ignition/rendering/Scene.hh"
 
 #define LASER_TOL 2e-4
@@ -64,19 +72,15 @@ class GpuRaysTest: public testing::Test,
 
   // Test detection of particles
   public: void RaysParticles(const std::string &_renderEngine);
+
+  // Test range noise and dropout render passes
+  public: void RaysNoise(const std::string &_renderEngine);
 };
 
 /////////////////////////////////////////////////
 /// \brief Test GPU rays configuraions
 void GpuRaysTest::Configure(const std::string &_renderEngine)
 {
-  if (_renderEngine == "optix")
-  {
-    igndbg << "GpuRays not supported yet in rendering engine: "
-            << _renderEngine << std::endl;
-    return;
-  }
-
   // create and populate scene
   RenderEngine *engine = rendering::engine(_renderEngine);
   if (!engine)
@@ -167,13 +171,6 @@ void GpuRaysTest::RaysUnitBox(const std::string &_renderEngine)
   return;
 #endif
 
-  if (_renderEngine == "optix")
-  {
-    igndbg << "GpuRays not supported yet in rendering engine: "
-            << _renderEngine << std::endl;
-    return;
-  }
-
   // Test GPU rays with 3 boxes in the world.
   // First GPU rays at identity orientation, second at 90 degree roll
   // First place 2 of 3 boxes within range and verify range values.
@@ -352,13 +349,6 @@ void GpuRaysTest::LaserVertical(const std::string &_renderEngine)
   return;
 #endif
 
-  if (_renderEngine == "optix")
-  {
-    igndbg << "GpuRays not supported yet in rendering engine: "
-            << _renderEngine << std::endl;
-    return;
-  }
-
   // Test a rays that has a vertical range component.
   // Place a box within range and verify range values,
   // then move the box out of range and verify range values
@@ -690,6 +680,143 @@ void GpuRaysTest::RaysParticles(const std::string &_renderEngine)
   engine->DestroyScene(scene);
   rendering::unloadEngine(engine->Name());
 }
+/////////////////////////////////////////////////
+/// \brief Test GPU rays range noise and dropout
+void GpuRaysTest::RaysNoise(const std::string &_renderEngine)
+{
+#ifdef __APPLE__
+  std::cerr << "Skipping test for apple, see issue #35." << std::endl;
+  return;
+#endif
+
+  if (_renderEngine != "ogre2")
+  {
+    igndbg << "GpuRays noise passes are not supported yet in rendering "
+           << "engine: " << _renderEngine << std::endl;
+    return;
+  }
+
+  const double hMinAngle = -IGN_PI / 2.0;
+  const double hMaxAngle = IGN_PI / 2.0;
+  const double minRange = 0.1;
+  const double maxRange = 10.0;
+  const int hRayCount = 320;
+  const double stdDev = 0.05;
+
+  // create and populate scene
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  RenderPassSystemPtr rpSystem = engine->RenderPassSystem();
+  ASSERT_NE(nullptr, rpSystem);
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+  VisualPtr root = scene->RootVisual();
+
+  // a wall in front of the sensors, to the sides rays do not hit anything
+  VisualPtr wall = scene->CreateVisual("wall");
+  wall->AddGeometry(scene->CreateBox());
+  wall->SetLocalScale(1.0, 4.0, 1.0);
+  wall->SetWorldPosition(3.0, 0.0, 0.5);
+  root->AddChild(wall);
+
+  // clean sensor, two sensors with the same seeded noise and one dropping
+  // all rays
+  GpuRaysPtr sensors[4];
+  for (unsigned int i = 0u; i < 4u; ++i)
+  {
+    sensors[i] = scene->CreateGpuRays("gpu_rays_" + std::to_string(i));
+    sensors[i]->SetWorldPosition(0.0, 0.0, 0.1);
+    sensors[i]->SetNearClipPlane(minRange);
+    sensors[i]->SetFarClipPlane(maxRange);
+    sensors[i]->SetAngleMin(hMinAngle);
+    sensors[i]->SetAngleMax(hMaxAngle);
+    sensors[i]->SetRayCount(hRayCount);
+    sensors[i]->SetVerticalRayCount(1);
+    root->AddChild(sensors[i]);
+  }
+
+  for (unsigned int i = 1u; i < 3u; ++i)
+  {
+    GaussianNoisePassPtr noisePass =
+        std::dynamic_pointer_cast<GaussianNoisePass>(
+        rpSystem->Create<GaussianNoisePass>());
+    ASSERT_NE(nullptr, noisePass);
+    noisePass->SetStdDev(stdDev);
+    noisePass->SetSeed(7u);
+    sensors[i]->AddRenderPass(noisePass);
+    EXPECT_EQ(1u, sensors[i]->RenderPassCount());
+  }
+
+  DropoutPassPtr dropoutPass = std::dynamic_pointer_cast<DropoutPass>(
+      rpSystem->Create<DropoutPass>());
+  ASSERT_NE(nullptr, dropoutPass);
+  dropoutPass->SetProbability(1.0);
+  sensors[3]->AddRenderPass(dropoutPass);
+  EXPECT_EQ(1u, sensors[3]->RenderPassCount());
+  EXPECT_EQ(dropoutPass, sensors[3]->RenderPassByIndex(0u));
+
+  // other passes and a second pass of the same type are rejected
+  sensors[3]->AddRenderPass(rpSystem->Create<DistortionPass>());
+  sensors[3]->AddRenderPass(rpSystem->Create<DropoutPass>());
+  EXPECT_EQ(1u, sensors[3]->RenderPassCount());
+
+  unsigned int channels = sensors[0]->Channels();
+  std::vector<float> scans[4];
+  for (unsigned int i = 0u; i < 4u; ++i)
+  {
+    scans[i].resize(hRayCount * channels);
+    sensors[i]->Update();
+    sensors[i]->Copy(scans[i].data());
+  }
+
+  unsigned int hits = 0u;
+  double deviation = 0.0;
+  for (int i = 0; i < hRayCount; ++i)
+  {
+    float clean = scans[0][i * channels];
+    float noisy = scans[1][i * channels];
+
+    // seeded noise is reproducible
+    EXPECT_FLOAT_EQ(noisy, scans[2][i * channels]);
+
+    // noise is only applied to hits
+    if (std::isinf(clean))
+    {
+      EXPECT_TRUE(std::isinf(noisy));
+    }
+    else
+    {
+      EXPECT_NEAR(clean, noisy, stdDev * 6.0);
+      deviation += std::fabs(clean - noisy);
+      ++hits;
+    }
+
+    // all rays are dropped
+    EXPECT_DOUBLE_EQ(ignition::math::INF_D, scans[3][i * channels]);
+    EXPECT_DOUBLE_EQ(0.0, scans[3][i * channels + 1]);
+  }
+  EXPECT_GT(hits, 0u);
+  EXPECT_GT(deviation / hits, LASER_TOL);
+
+  // the readings are clean again without the dropout pass
+  sensors[3]->RemoveRenderPass(dropoutPass);
+  EXPECT_EQ(0u, sensors[3]->RenderPassCount());
+  sensors[3]->Update();
+  sensors[3]->Copy(scans[3].data());
+  int mid = static_cast<int>(hRayCount / 2) * channels;
+  EXPECT_NEAR(scans[0][mid], scans[3][mid], LASER_TOL);
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
 /////////////////////////////////////////////////
 TEST_P(GpuRaysTest, Configure)
 {
@@ -714,6 +841,12 @@ TEST_P(GpuRaysTest, RaysParticles)
   RaysParticles(GetParam());
 }
 
+/////////////////////////////////////////////////
+TEST_P(GpuRaysTest, RaysNoise)
+{
+  RaysNoise(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(GpuRays, GpuRaysTest,
     RENDER_ENGINE_VALUES,
     ignition::rendering::PrintToStringParam());
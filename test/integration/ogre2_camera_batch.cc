@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/Image.hh"
+#include "ignition/rendering/PixelFormat.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/ogre2/Ogre2CameraBatch.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+class Ogre2CameraBatchTest: public testing::Test,
+                            public testing::WithParamInterface<const char *>
+{
+  // Test the layout of the images captured by a camera batch
+  public: void TileLayout(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+/// \brief Create a camera rendering RGB images
+/// \param[in] _scene Scene to create the camera in
+/// \param[in] _name Name of the camera
+/// \param[in] _width Image width
+/// \param[in] _height Image height
+/// \return The camera
+CameraPtr CreateCamera(ScenePtr _scene, const std::string &_name,
+    unsigned int _width, unsigned int _height)
+{
+  CameraPtr camera = _scene->CreateCamera(_name);
+  if (!camera)
+    return camera;
+  camera->SetImageWidth(_width);
+  camera->SetImageHeight(_height);
+  camera->SetImageFormat(PF_R8G8B8);
+  camera->SetAspectRatio(static_cast<double>(_width) / _height);
+  camera->SetHFOV(IGN_PI / 2);
+  _scene->RootVisual()->AddChild(camera);
+  return camera;
+}
+
+/////////////////////////////////////////////////
+void Ogre2CameraBatchTest::TileLayout(const std::string &_renderEngine)
+{
+  if (_renderEngine != "ogre2")
+  {
+    igndbg << "Camera batches not supported yet in rendering engine: "
+           << _renderEngine << std::endl;
+    return;
+  }
+
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  // cameras of two scenes with different backgrounds
+  ScenePtr red = engine->CreateScene("red");
+  ScenePtr blue = engine->CreateScene("blue");
+  ASSERT_TRUE(red != nullptr);
+  ASSERT_TRUE(blue != nullptr);
+  red->SetBackgroundColor(1.0, 0.0, 0.0);
+  blue->SetBackgroundColor(0.0, 0.0, 1.0);
+
+  const unsigned int width = 20u;
+  const unsigned int height = 10u;
+  std::vector<CameraPtr> cameras;
+  cameras.push_back(CreateCamera(red, "red_1", width, height));
+  cameras.push_back(CreateCamera(blue, "blue_1", width, height));
+  cameras.push_back(CreateCamera(red, "red_2", width, height));
+
+  Ogre2CameraBatch batch;
+  EXPECT_EQ(0u, batch.CameraCount());
+  EXPECT_EQ(0u, batch.MemorySize());
+  for (auto &camera : cameras)
+  {
+    ASSERT_TRUE(camera != nullptr);
+    EXPECT_TRUE(batch.AddCamera(camera));
+  }
+
+  // cameras of another size or format are rejected
+  CameraPtr other = CreateCamera(red, "other", width * 2u, height);
+  EXPECT_FALSE(batch.AddCamera(other));
+  other->SetImageWidth(width);
+  other->SetImageFormat(PF_L8);
+  EXPECT_FALSE(batch.AddCamera(other));
+
+  ASSERT_EQ(3u, batch.CameraCount());
+  for (unsigned int i = 0u; i < cameras.size(); ++i)
+    EXPECT_EQ(cameras[i], batch.CameraByIndex(i));
+  EXPECT_EQ(nullptr, batch.CameraByIndex(3u));
+
+  size_t imageSize = width * height * 3u;
+  ASSERT_EQ(imageSize * cameras.size(), batch.MemorySize());
+  std::vector<unsigned char> data(batch.MemorySize(), 0u);
+  ASSERT_TRUE(batch.Capture(data.data()));
+
+  // each tile is the image of a camera, in the order they were added
+  for (unsigned int i = 0u; i < cameras.size(); ++i)
+  {
+    const unsigned char *tile = data.data() + i * imageSize;
+    bool isRed = (i != 1u);
+    for (size_t p = 0u; p < width * height; ++p)
+    {
+      const unsigned char *pixel = tile + p * 3u;
+      if (isRed)
+        EXPECT_GT(pixel[0], pixel[2]) << "camera " << i;
+      else
+        EXPECT_LT(pixel[0], pixel[2]) << "camera " << i;
+    }
+
+    // the tile matches the image the camera renders alone
+    Image image = cameras[i]->CreateImage();
+    cameras[i]->Capture(image);
+    EXPECT_EQ(0, memcmp(tile, image.Data<unsigned char>(), imageSize))
+        << "camera " << i;
+  }
+
+  batch.Clear();
+  EXPECT_EQ(0u, batch.CameraCount());
+  EXPECT_EQ(0u, batch.MemorySize());
+
+  engine->DestroyScene(red);
+  engine->DestroyScene(blue);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(Ogre2CameraBatchTest, TileLayout)
+{
+  TileLayout(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(Ogre2CameraBatch, Ogre2CameraBatchTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
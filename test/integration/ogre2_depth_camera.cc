@@ -0,0 +1,280 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/ogre2/Ogre2DepthCamera.hh"
+
+#define DEPTH_TOL 1e-4
+
+using namespace ignition;
+using namespace rendering;
+
+class Ogre2DepthCameraTest: public testing::Test,
+                            public testing::WithParamInterface<const char *>
+{
+  // Test the depth texture and disabling the CPU readback
+  public: void CpuReadback(const std::string &_renderEngine);
+
+  // Test the laser scans and voxel clouds reduced on the GPU
+  public: void Reductions(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+/// \brief Create an ogre2 depth camera at the origin looking along the x
+/// axis
+/// \param[in] _scene Scene to create the camera in
+/// \param[in] _width Image width
+/// \param[in] _height Image height
+/// \return The depth camera, null if it is not an ogre2 depth camera
+Ogre2DepthCameraPtr CreateDepthCamera(ScenePtr _scene, unsigned int _width,
+    unsigned int _height)
+{
+  Ogre2DepthCameraPtr camera = std::dynamic_pointer_cast<Ogre2DepthCamera>(
+      _scene->CreateDepthCamera());
+  if (!camera)
+    return camera;
+  camera->SetImageWidth(_width);
+  camera->SetImageHeight(_height);
+  camera->SetNearClipPlane(0.15);
+  camera->SetFarClipPlane(10.0);
+  camera->SetAspectRatio(static_cast<double>(_width) / _height);
+  camera->SetHFOV(1.05);
+  camera->CreateDepthTexture();
+  _scene->RootVisual()->AddChild(camera);
+  return camera;
+}
+
+/////////////////////////////////////////////////
+void Ogre2DepthCameraTest::CpuReadback(const std::string &_renderEngine)
+{
+  if (_renderEngine != "ogre2")
+  {
+    igndbg << "CpuReadback not supported yet in rendering engine: "
+           << _renderEngine << std::endl;
+    return;
+  }
+
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(2.0, 0.0, 0.0);
+  scene->RootVisual()->AddChild(box);
+
+  const unsigned int width = 64u;
+  const unsigned int height = 48u;
+  Ogre2DepthCameraPtr camera = CreateDepthCamera(scene, width, height);
+  ASSERT_TRUE(camera != nullptr);
+  EXPECT_TRUE(camera->CpuReadback());
+
+  unsigned int depthCount = 0u;
+  unsigned int pointCloudCount = 0u;
+  common::ConnectionPtr c1 = camera->ConnectNewDepthFrame(
+      [&](const float *, unsigned int, unsigned int, unsigned int,
+          const std::string &)
+      {
+        ++depthCount;
+      });
+  common::ConnectionPtr c2 = camera->ConnectNewRgbPointCloud(
+      [&](const float *, unsigned int, unsigned int, unsigned int,
+          const std::string &)
+      {
+        ++pointCloudCount;
+      });
+
+  camera->Update();
+  EXPECT_NE(0u, camera->RenderTextureGLId());
+  EXPECT_EQ(1u, depthCount);
+  EXPECT_EQ(1u, pointCloudCount);
+  unsigned int mid = height / 2u * width + width / 2u;
+  ASSERT_NE(nullptr, camera->DepthData());
+  EXPECT_NEAR(1.5, camera->DepthData()[mid], DEPTH_TOL);
+
+  // without readback the last frame is kept and no frame is emitted
+  camera->SetCpuReadback(false);
+  EXPECT_FALSE(camera->CpuReadback());
+  box->SetLocalPosition(3.0, 0.0, 0.0);
+  camera->Update();
+  EXPECT_EQ(1u, depthCount);
+  EXPECT_EQ(1u, pointCloudCount);
+  EXPECT_NEAR(1.5, camera->DepthData()[mid], DEPTH_TOL);
+  EXPECT_NE(0u, camera->RenderTextureGLId());
+
+  // the new depth is read back once readback is enabled again
+  camera->SetCpuReadback(true);
+  camera->Update();
+  EXPECT_EQ(2u, depthCount);
+  EXPECT_EQ(2u, pointCloudCount);
+  EXPECT_NEAR(2.5, camera->DepthData()[mid], DEPTH_TOL);
+
+  c1.reset();
+  c2.reset();
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void Ogre2DepthCameraTest::Reductions(const std::string &_renderEngine)
+{
+  if (_renderEngine != "ogre2")
+  {
+    igndbg << "Point cloud reductions not supported yet in rendering "
+           << "engine: " << _renderEngine << std::endl;
+    return;
+  }
+
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+
+  // the face of the box seen by the camera is the plane x = 1.5
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(2.0, 0.0, 0.0);
+  scene->RootVisual()->AddChild(box);
+
+  const unsigned int width = 64u;
+  const unsigned int height = 48u;
+  Ogre2DepthCameraPtr camera = CreateDepthCamera(scene, width, height);
+  ASSERT_TRUE(camera != nullptr);
+
+  // the reductions are computed without the full point cloud readback
+  camera->SetCpuReadback(false);
+  camera->SetLaserScanRows(height / 2u - 4u, 8u);
+  camera->SetVoxelCloud(0.25, 4u);
+
+  std::vector<float> scan;
+  std::string scanFormat;
+  common::ConnectionPtr c1 = camera->ConnectNewLaserScan(
+      [&](const float *_data, unsigned int _width, unsigned int _height,
+          unsigned int _channels, const std::string &_format)
+      {
+        EXPECT_EQ(1u, _height);
+        EXPECT_EQ(1u, _channels);
+        scan.assign(_data, _data + _width);
+        scanFormat = _format;
+      });
+
+  std::vector<float> voxels;
+  std::string voxelFormat;
+  common::ConnectionPtr c2 = camera->ConnectNewVoxelCloud(
+      [&](const float *_data, unsigned int _width, unsigned int _height,
+          unsigned int _channels, const std::string &_format)
+      {
+        EXPECT_EQ(1u, _height);
+        EXPECT_EQ(4u, _channels);
+        voxels.assign(_data, _data + _width * _channels);
+        voxelFormat = _format;
+      });
+
+  camera->Update();
+
+  // one range per column, the box in the middle and nothing on the sides
+  EXPECT_EQ("PF_FLOAT32_R", scanFormat);
+  ASSERT_EQ(width, scan.size());
+  EXPECT_NEAR(1.5, scan[width / 2u], 1e-3);
+  EXPECT_FLOAT_EQ(math::INF_F, scan.front());
+  EXPECT_FLOAT_EQ(math::INF_F, scan.back());
+  for (unsigned int i = 0u; i < width; ++i)
+  {
+    if (std::isfinite(scan[i]))
+      EXPECT_GE(scan[i], 1.5 - 1e-3);
+  }
+
+  // a few points per voxel of the face of the box
+  EXPECT_EQ("PF_FLOAT32_RGBA", voxelFormat);
+  size_t pointCount = voxels.size() / 4u;
+  EXPECT_GT(pointCount, 0u);
+  EXPECT_LT(pointCount, width * height / 16u);
+  for (size_t i = 0u; i < pointCount; ++i)
+  {
+    const float *p = &voxels[i * 4u];
+    EXPECT_NEAR(1.5, p[0], 1e-3);
+    EXPECT_LE(std::abs(p[1]), 0.5 + 1e-3);
+    EXPECT_LE(std::abs(p[2]), 0.5 + 1e-3);
+  }
+
+  // the scan follows the box
+  box->SetLocalPosition(3.0, 0.0, 0.0);
+  camera->Update();
+  ASSERT_EQ(width, scan.size());
+  EXPECT_NEAR(2.5, scan[width / 2u], 1e-3);
+
+  // disabled reductions are not emitted anymore
+  scan.clear();
+  voxels.clear();
+  camera->SetLaserScanRows(0u, 0u);
+  camera->SetVoxelCloud(0.0);
+  camera->Update();
+  EXPECT_TRUE(scan.empty());
+  EXPECT_TRUE(voxels.empty());
+
+  c1.reset();
+  c2.reset();
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(Ogre2DepthCameraTest, CpuReadback)
+{
+  CpuReadback(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(Ogre2DepthCameraTest, Reductions)
+{
+  Reductions(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(Ogre2DepthCamera, Ogre2DepthCameraTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,355 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/math/Vector2.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/ogre2/Ogre2GpuRays.hh"
+
+#define LASER_TOL 2e-4
+
+using namespace ignition;
+using namespace rendering;
+
+class Ogre2GpuRaysTest: public testing::Test,
+                        public testing::WithParamInterface<const char *>
+{
+  // Test the range texture and disabling the CPU readback
+  public: void CpuReadback(const std::string &_renderEngine);
+
+  // Test explicit per reading angle tables
+  public: void RayAngles(const std::string &_renderEngine);
+
+  // Test rolling azimuth sector updates
+  public: void Sectors(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+/// \brief Create ogre2 gpu rays at the origin looking along the x axis
+/// \param[in] _scene Scene to create the sensor in
+/// \param[in] _rayCount Number of horizontal rays
+/// \param[in] _verticalRayCount Number of vertical rays
+/// \return The gpu rays, null if they are not ogre2 gpu rays
+Ogre2GpuRaysPtr CreateGpuRays(ScenePtr _scene, unsigned int _rayCount,
+    unsigned int _verticalRayCount = 1u)
+{
+  Ogre2GpuRaysPtr gpuRays = std::dynamic_pointer_cast<Ogre2GpuRays>(
+      _scene->CreateGpuRays());
+  if (!gpuRays)
+    return gpuRays;
+  gpuRays->SetNearClipPlane(0.1);
+  gpuRays->SetFarClipPlane(10.0);
+  gpuRays->SetAngleMin(-0.5);
+  gpuRays->SetAngleMax(0.5);
+  gpuRays->SetRayCount(_rayCount);
+  gpuRays->SetVerticalRayCount(_verticalRayCount);
+  if (_verticalRayCount > 1u)
+  {
+    gpuRays->SetVerticalAngleMin(-0.2);
+    gpuRays->SetVerticalAngleMax(0.2);
+  }
+  _scene->RootVisual()->AddChild(gpuRays);
+  return gpuRays;
+}
+
+/////////////////////////////////////////////////
+void Ogre2GpuRaysTest::CpuReadback(const std::string &_renderEngine)
+{
+  if (_renderEngine != "ogre2")
+  {
+    igndbg << "CpuReadback not supported yet in rendering engine: "
+           << _renderEngine << std::endl;
+    return;
+  }
+
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(2.0, 0.0, 0.0);
+  scene->RootVisual()->AddChild(box);
+
+  const unsigned int rayCount = 33u;
+  Ogre2GpuRaysPtr gpuRays = CreateGpuRays(scene, rayCount);
+  ASSERT_TRUE(gpuRays != nullptr);
+  EXPECT_TRUE(gpuRays->CpuReadback());
+
+  unsigned int frameCount = 0u;
+  common::ConnectionPtr c = gpuRays->ConnectNewGpuRaysFrame(
+      [&](const float *, unsigned int, unsigned int, unsigned int,
+          const std::string &)
+      {
+        ++frameCount;
+      });
+
+  // the range texture exists once the sensor is rendered
+  EXPECT_EQ(0u, gpuRays->RenderTextureGLId());
+  gpuRays->Update();
+  EXPECT_NE(0u, gpuRays->RenderTextureGLId());
+  EXPECT_EQ(1u, frameCount);
+  unsigned int mid = rayCount / 2u * gpuRays->Channels();
+  EXPECT_NEAR(1.5, gpuRays->Data()[mid], LASER_TOL);
+
+  // without readback the last frame is kept and no frame is emitted
+  gpuRays->SetCpuReadback(false);
+  EXPECT_FALSE(gpuRays->CpuReadback());
+  box->SetLocalPosition(3.0, 0.0, 0.0);
+  gpuRays->Update();
+  EXPECT_EQ(1u, frameCount);
+  EXPECT_NEAR(1.5, gpuRays->Data()[mid], LASER_TOL);
+  EXPECT_NE(0u, gpuRays->RenderTextureGLId());
+
+  // the new range is read back once readback is enabled again
+  gpuRays->SetCpuReadback(true);
+  gpuRays->Update();
+  EXPECT_EQ(2u, frameCount);
+  EXPECT_NEAR(2.5, gpuRays->Data()[mid], LASER_TOL);
+
+  c.reset();
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void Ogre2GpuRaysTest::RayAngles(const std::string &_renderEngine)
+{
+  if (_renderEngine != "ogre2")
+  {
+    igndbg << "RayAngles not supported yet in rendering engine: "
+           << _renderEngine << std::endl;
+    return;
+  }
+
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+
+  // one box in front of the sensors and one on their left, out of the
+  // evenly spaced field of view
+  VisualPtr front = scene->CreateVisual();
+  front->AddGeometry(scene->CreateBox());
+  front->SetLocalPosition(2.0, 0.0, 0.0);
+  scene->RootVisual()->AddChild(front);
+  VisualPtr left = scene->CreateVisual();
+  left->AddGeometry(scene->CreateBox());
+  left->SetLocalPosition(0.0, 2.0, 0.0);
+  scene->RootVisual()->AddChild(left);
+
+  const unsigned int rayCount = 3u;
+  Ogre2GpuRaysPtr gpuRays = CreateGpuRays(scene, rayCount);
+  ASSERT_TRUE(gpuRays != nullptr);
+  EXPECT_TRUE(gpuRays->RayAngles().empty());
+
+  // the readings look ahead, left and right
+  std::vector<math::Vector2d> angles = {
+      {0.0, 0.0}, {IGN_PI * 0.5, 0.0}, {-IGN_PI * 0.5, 0.0}};
+  gpuRays->SetRayAngles(angles);
+  EXPECT_EQ(angles, gpuRays->RayAngles());
+
+  gpuRays->Update();
+  unsigned int channels = gpuRays->Channels();
+  const float *data = gpuRays->Data();
+  EXPECT_NEAR(1.5, data[0], LASER_TOL);
+  EXPECT_NEAR(1.5, data[channels], LASER_TOL);
+  EXPECT_DOUBLE_EQ(math::INF_D, data[2u * channels]);
+
+  // the table cannot change once the sensor is rendered
+  gpuRays->SetRayAngles({});
+  EXPECT_EQ(angles, gpuRays->RayAngles());
+
+  // a table of the wrong size is dropped for evenly spaced readings
+  Ogre2GpuRaysPtr wrongSize = CreateGpuRays(scene, rayCount);
+  ASSERT_TRUE(wrongSize != nullptr);
+  wrongSize->SetRayAngles({{IGN_PI * 0.5, 0.0}, {IGN_PI * 0.5, 0.0}});
+  EXPECT_EQ(2u, wrongSize->RayAngles().size());
+  wrongSize->Update();
+  EXPECT_TRUE(wrongSize->RayAngles().empty());
+  data = wrongSize->Data();
+  EXPECT_DOUBLE_EQ(math::INF_D, data[0]);
+  EXPECT_NEAR(1.5, data[channels], LASER_TOL);
+  EXPECT_DOUBLE_EQ(math::INF_D, data[2u * channels]);
+
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void Ogre2GpuRaysTest::Sectors(const std::string &_renderEngine)
+{
+  if (_renderEngine != "ogre2")
+  {
+    igndbg << "Sectors not supported yet in rendering engine: "
+           << _renderEngine << std::endl;
+    return;
+  }
+
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+
+  // box behind the sensor
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(-2.0, 0.0, 0.0);
+  scene->RootVisual()->AddChild(box);
+
+  // 360 degrees in 4 sectors of about 90 degrees, the first columns look
+  // backwards
+  const unsigned int rayCount = 41u;
+  const unsigned int sectorCount = 4u;
+  Ogre2GpuRaysPtr gpuRays = CreateGpuRays(scene, rayCount);
+  ASSERT_TRUE(gpuRays != nullptr);
+  gpuRays->SetAngleMin(-IGN_PI);
+  gpuRays->SetAngleMax(IGN_PI);
+  EXPECT_EQ(1u, gpuRays->SectorCount());
+  gpuRays->SetSectorCount(0u);
+  EXPECT_EQ(1u, gpuRays->SectorCount());
+  gpuRays->SetSectorCount(sectorCount);
+  EXPECT_EQ(sectorCount, gpuRays->SectorCount());
+
+  // sectors are consecutive ranges of columns covering all readings
+  unsigned int next = 0u;
+  for (unsigned int i = 0u; i < sectorCount; ++i)
+  {
+    unsigned int first = 0u;
+    unsigned int count = 0u;
+    gpuRays->SectorColumns(i, first, count);
+    EXPECT_EQ(next, first);
+    EXPECT_GE(count, rayCount / sectorCount);
+    EXPECT_LE(count, rayCount / sectorCount + 1u);
+    next = first + count;
+  }
+  EXPECT_EQ(rayCount, next);
+  unsigned int first = 0u;
+  unsigned int count = 1u;
+  gpuRays->SectorColumns(sectorCount, first, count);
+  EXPECT_EQ(0u, count);
+
+  unsigned int channels = gpuRays->Channels();
+  std::vector<unsigned int> sectors;
+  common::ConnectionPtr c = gpuRays->ConnectNewGpuRaysSector(
+      [&](const float *_frame, unsigned int _sector, unsigned int _first,
+          unsigned int _width, unsigned int _height, unsigned int _channels)
+      {
+        unsigned int f = 0u;
+        unsigned int n = 0u;
+        gpuRays->SectorColumns(_sector, f, n);
+        EXPECT_EQ(f, _first);
+        EXPECT_EQ(n, _width);
+        EXPECT_EQ(1u, _height);
+        EXPECT_EQ(channels, _channels);
+        // the sector readings are the columns of the full frame
+        EXPECT_FLOAT_EQ(gpuRays->Data()[_first * channels], _frame[0]);
+        sectors.push_back(_sector);
+      });
+
+  // all faces are rendered on the first update
+  gpuRays->Update();
+  EXPECT_NEAR(1.5, gpuRays->Data()[0], LASER_TOL);
+  EXPECT_NEAR(1.5, gpuRays->Data()[(rayCount - 1u) * channels], LASER_TOL);
+
+  // the back faces are only rendered again with the last sector, until
+  // then the backward readings keep their last value
+  box->SetLocalPosition(-3.0, 0.0, 0.0);
+  gpuRays->Update();
+  gpuRays->Update();
+  EXPECT_NEAR(1.5, gpuRays->Data()[0], LASER_TOL);
+  gpuRays->Update();
+  EXPECT_NEAR(2.5, gpuRays->Data()[0], LASER_TOL);
+  EXPECT_NEAR(2.5, gpuRays->Data()[(rayCount - 1u) * channels], LASER_TOL);
+
+  // the sectors are rendered in turn
+  gpuRays->Update();
+  std::vector<unsigned int> expected = {0u, 1u, 2u, 3u, 0u};
+  EXPECT_EQ(expected, sectors);
+
+  // the count cannot change once the sensor is rendered
+  gpuRays->SetSectorCount(2u);
+  EXPECT_EQ(sectorCount, gpuRays->SectorCount());
+
+  // the count is clamped to the number of columns
+  Ogre2GpuRaysPtr narrow = CreateGpuRays(scene, 3u);
+  ASSERT_TRUE(narrow != nullptr);
+  narrow->SetSectorCount(10u);
+  narrow->Update();
+  EXPECT_EQ(3u, narrow->SectorCount());
+
+  c.reset();
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(Ogre2GpuRaysTest, CpuReadback)
+{
+  CpuReadback(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(Ogre2GpuRaysTest, RayAngles)
+{
+  RayAngles(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(Ogre2GpuRaysTest, Sectors)
+{
+  Sectors(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(Ogre2GpuRays, Ogre2GpuRaysTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/PixelFormat.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/ogre2/Ogre2ImagePyramid.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+class Ogre2ImagePyramidTest: public testing::Test,
+                             public testing::WithParamInterface<const char *>
+{
+  // Test the sizes and content of the levels of an image pyramid
+  public: void Levels(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+void Ogre2ImagePyramidTest::Levels(const std::string &_renderEngine)
+{
+  if (_renderEngine != "ogre2")
+  {
+    igndbg << "Image pyramids not supported yet in rendering engine: "
+           << _renderEngine << std::endl;
+    return;
+  }
+
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  // blue box in the middle of a red background
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+  scene->SetBackgroundColor(1.0, 0.0, 0.0);
+  scene->SetAmbientLight(1.0, 1.0, 1.0);
+
+  MaterialPtr blue = scene->CreateMaterial();
+  blue->SetAmbient(0.0, 0.0, 1.0);
+  blue->SetDiffuse(0.0, 0.0, 1.0);
+
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(1.5, 0.0, 0.0);
+  box->SetMaterial(blue);
+  scene->RootVisual()->AddChild(box);
+
+  const unsigned int width = 64u;
+  const unsigned int height = 40u;
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_TRUE(camera != nullptr);
+  camera->SetImageWidth(width);
+  camera->SetImageHeight(height);
+  camera->SetImageFormat(PF_R8G8B8);
+  camera->SetAspectRatio(static_cast<double>(width) / height);
+  camera->SetHFOV(IGN_PI / 2);
+  scene->RootVisual()->AddChild(camera);
+
+  Ogre2ImagePyramid pyramid;
+  EXPECT_EQ(nullptr, pyramid.Camera());
+  EXPECT_EQ(0u, pyramid.LevelCount());
+  EXPECT_FALSE(pyramid.SetCamera(camera, 0u));
+
+  // each level is half the size of the previous one, rounded down
+  ASSERT_TRUE(pyramid.SetCamera(camera, 3u, OPF_GAUSSIAN));
+  EXPECT_EQ(camera, pyramid.Camera());
+  EXPECT_EQ(OPF_GAUSSIAN, pyramid.Filter());
+  ASSERT_EQ(3u, pyramid.LevelCount());
+  EXPECT_EQ(32u, pyramid.LevelWidth(0u));
+  EXPECT_EQ(20u, pyramid.LevelHeight(0u));
+  EXPECT_EQ(16u, pyramid.LevelWidth(1u));
+  EXPECT_EQ(10u, pyramid.LevelHeight(1u));
+  EXPECT_EQ(8u, pyramid.LevelWidth(2u));
+  EXPECT_EQ(5u, pyramid.LevelHeight(2u));
+  EXPECT_EQ(0u, pyramid.LevelWidth(3u));
+  EXPECT_EQ(0u, pyramid.LevelHeight(3u));
+
+  // levels are packed one after the other
+  EXPECT_EQ(0u, pyramid.LevelOffset(0u));
+  EXPECT_EQ(32u * 20u * 3u, pyramid.LevelOffset(1u));
+  EXPECT_EQ((32u * 20u + 16u * 10u) * 3u, pyramid.LevelOffset(2u));
+  EXPECT_EQ((32u * 20u + 16u * 10u + 8u * 5u) * 3u, pyramid.MemorySize());
+  EXPECT_EQ(pyramid.MemorySize(), pyramid.LevelOffset(3u));
+
+  // the levels keep the layout of the image
+  camera->Update();
+  std::vector<unsigned char> data(pyramid.MemorySize(), 0u);
+  ASSERT_TRUE(pyramid.Capture(data.data()));
+  for (unsigned int i = 0u; i < pyramid.LevelCount(); ++i)
+  {
+    unsigned int w = pyramid.LevelWidth(i);
+    unsigned int h = pyramid.LevelHeight(i);
+    const unsigned char *level = data.data() + pyramid.LevelOffset(i);
+    const unsigned char *center = level + (h / 2u * w + w / 2u) * 3u;
+    const unsigned char *corner = level;
+    EXPECT_GT(center[2], center[0]) << "level " << i;
+    EXPECT_GT(corner[0], corner[2]) << "level " << i;
+  }
+
+  // levels smaller than one pixel are dropped
+  ASSERT_TRUE(pyramid.SetCamera(camera, 10u));
+  EXPECT_EQ(OPF_BOX, pyramid.Filter());
+  ASSERT_EQ(5u, pyramid.LevelCount());
+  EXPECT_EQ(2u, pyramid.LevelWidth(4u));
+  EXPECT_EQ(1u, pyramid.LevelHeight(4u));
+  data.assign(pyramid.MemorySize(), 0u);
+  EXPECT_TRUE(pyramid.Capture(data.data()));
+
+  // a camera too small for a single level is rejected
+  CameraPtr tiny = scene->CreateCamera();
+  tiny->SetImageWidth(1u);
+  tiny->SetImageHeight(1u);
+  scene->RootVisual()->AddChild(tiny);
+  EXPECT_FALSE(pyramid.SetCamera(tiny, 1u));
+  EXPECT_EQ(nullptr, pyramid.Camera());
+
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(Ogre2ImagePyramidTest, Levels)
+{
+  Levels(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(Ogre2ImagePyramid, Ogre2ImagePyramidTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
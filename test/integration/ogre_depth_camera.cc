@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/ogre/OgreDepthCamera.hh"
+
+#define DEPTH_TOL 1e-4
+
+using namespace ignition;
+using namespace rendering;
+
+class OgreDepthCameraTest: public testing::Test,
+                           public testing::WithParamInterface<const char *>
+{
+  // Test the asynchronous readback of the depth data
+  public: void AsyncReadback(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+void OgreDepthCameraTest::AsyncReadback(const std::string &_renderEngine)
+{
+  if (_renderEngine != "ogre")
+  {
+    igndbg << "AsyncReadback not supported yet in rendering engine: "
+           << _renderEngine << std::endl;
+    return;
+  }
+
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(2.0, 0.0, 0.0);
+  scene->RootVisual()->AddChild(box);
+
+  const unsigned int width = 64u;
+  const unsigned int height = 48u;
+  OgreDepthCameraPtr camera = std::dynamic_pointer_cast<OgreDepthCamera>(
+      scene->CreateDepthCamera());
+  ASSERT_TRUE(camera != nullptr);
+  camera->SetImageWidth(width);
+  camera->SetImageHeight(height);
+  camera->SetNearClipPlane(0.15);
+  camera->SetFarClipPlane(10.0);
+  camera->SetAspectRatio(static_cast<double>(width) / height);
+  camera->SetHFOV(1.05);
+  camera->CreateDepthTexture();
+  scene->RootVisual()->AddChild(camera);
+
+  unsigned int mid = height / 2u * width + width / 2u;
+  std::vector<float> depths;
+  common::ConnectionPtr c = camera->ConnectNewDepthFrame(
+      [&](const float *_data, unsigned int, unsigned int, unsigned int,
+          const std::string &)
+      {
+        depths.push_back(_data[mid]);
+      });
+
+  EXPECT_FALSE(camera->AsyncReadback());
+  camera->SetAsyncReadback(true);
+  if (!camera->AsyncReadback())
+  {
+    igndbg << "Asynchronous readback is not supported by the render system"
+           << std::endl;
+    c.reset();
+    engine->DestroyScene(scene);
+    rendering::unloadEngine(engine->Name());
+    return;
+  }
+
+  // the first frame is only emitted once its copy has completed during
+  // later updates
+  camera->Update();
+  EXPECT_TRUE(depths.empty());
+  box->SetLocalPosition(3.0, 0.0, 0.0);
+
+  // frames are emitted in order, with the depth of the frame they were
+  // rendered in, and no later than the maximum number in flight
+  const unsigned int updateCount = 4u;
+  for (unsigned int i = 0u; i < updateCount; ++i)
+    camera->Update();
+  ASSERT_FALSE(depths.empty());
+  EXPECT_LE(depths.size(), updateCount);
+  EXPECT_NEAR(1.5, depths.front(), DEPTH_TOL);
+  for (size_t i = 1u; i < depths.size(); ++i)
+    EXPECT_NEAR(2.5, depths[i], DEPTH_TOL);
+
+  // blocking readback emits the frame of the update
+  camera->SetAsyncReadback(false);
+  EXPECT_FALSE(camera->AsyncReadback());
+  box->SetLocalPosition(4.0, 0.0, 0.0);
+  size_t count = depths.size();
+  camera->Update();
+  ASSERT_EQ(count + 1u, depths.size());
+  EXPECT_NEAR(3.5, depths.back(), DEPTH_TOL);
+  EXPECT_NEAR(3.5, camera->DepthData()[mid], DEPTH_TOL);
+
+  c.reset();
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(OgreDepthCameraTest, AsyncReadback)
+{
+  AsyncReadback(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(OgreDepthCamera, OgreDepthCameraTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
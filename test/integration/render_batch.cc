@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/DepthCamera.hh"
+#include "ignition/rendering/GpuRays.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+
+#define DEPTH_TOL 1e-4
+#define LASER_TOL 2e-4
+
+using namespace ignition;
+using namespace rendering;
+
+class RenderBatchTest: public testing::Test,
+                       public testing::WithParamInterface<const char *>
+{
+  // Test rendering several sensors in one render batch
+  public: void Sensors(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+/// \brief Create a depth camera looking along the x axis
+/// \param[in] _scene Scene to create the camera in
+/// \param[in] _name Name of the camera
+/// \return The depth camera
+DepthCameraPtr CreateDepthCamera(ScenePtr _scene, const std::string &_name)
+{
+  DepthCameraPtr camera = _scene->CreateDepthCamera(_name);
+  if (!camera)
+    return camera;
+  camera->SetImageWidth(64u);
+  camera->SetImageHeight(64u);
+  camera->SetNearClipPlane(0.15);
+  camera->SetFarClipPlane(10.0);
+  camera->SetAspectRatio(1.0);
+  camera->SetHFOV(1.05);
+  camera->CreateDepthTexture();
+  _scene->RootVisual()->AddChild(camera);
+  return camera;
+}
+
+/////////////////////////////////////////////////
+void RenderBatchTest::Sensors(const std::string &_renderEngine)
+{
+  // only ogre2 defers the rendering of sensors to the end of a batch
+  if (_renderEngine != "ogre2")
+  {
+    igndbg << "Engine '" << _renderEngine
+           << "' doesn't support render batches" << std::endl;
+    return;
+  }
+
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+  VisualPtr root = scene->RootVisual();
+
+  // unit box in front of the sensors
+  math::Vector3d boxPosition(2.0, 0.0, 0.0);
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(boxPosition);
+  root->AddChild(box);
+  double expectedRange = boxPosition.X() - 0.5;
+
+  DepthCameraPtr depth1 = CreateDepthCamera(scene, "depth_camera_1");
+  DepthCameraPtr depth2 = CreateDepthCamera(scene, "depth_camera_2");
+  ASSERT_TRUE(depth1 != nullptr);
+  ASSERT_TRUE(depth2 != nullptr);
+
+  const unsigned int rayCount = 33u;
+  GpuRaysPtr gpuRays = scene->CreateGpuRays("gpu_rays");
+  ASSERT_TRUE(gpuRays != nullptr);
+  gpuRays->SetNearClipPlane(0.1);
+  gpuRays->SetFarClipPlane(10.0);
+  gpuRays->SetAngleMin(-0.5);
+  gpuRays->SetAngleMax(0.5);
+  gpuRays->SetRayCount(rayCount);
+  gpuRays->SetVerticalRayCount(1);
+  root->AddChild(gpuRays);
+
+  unsigned int depth1Count = 0u;
+  unsigned int depth2Count = 0u;
+  unsigned int raysCount = 0u;
+  std::vector<float> depth1Data;
+  std::vector<float> depth2Data;
+  std::vector<float> raysData;
+  auto store = [](std::vector<float> &_dst, unsigned int &_count,
+      const float *_src, unsigned int _size)
+  {
+    _dst.assign(_src, _src + _size);
+    ++_count;
+  };
+
+  common::ConnectionPtr c1 = depth1->ConnectNewDepthFrame(
+      [&](const float *_data, unsigned int _w, unsigned int _h,
+          unsigned int _c, const std::string &)
+      {
+        store(depth1Data, depth1Count, _data, _w * _h * _c);
+      });
+  common::ConnectionPtr c2 = depth2->ConnectNewDepthFrame(
+      [&](const float *_data, unsigned int _w, unsigned int _h,
+          unsigned int _c, const std::string &)
+      {
+        store(depth2Data, depth2Count, _data, _w * _h * _c);
+      });
+  common::ConnectionPtr c3 = gpuRays->ConnectNewGpuRaysFrame(
+      [&](const float *_data, unsigned int _w, unsigned int _h,
+          unsigned int _c, const std::string &)
+      {
+        store(raysData, raysCount, _data, _w * _h * _c);
+      });
+
+  // the sensors only emit their frames once the batch is rendered
+  EXPECT_FALSE(engine->RenderBatchActive());
+  engine->BeginRenderBatch();
+  EXPECT_TRUE(engine->RenderBatchActive());
+  depth1->Update();
+  depth2->Update();
+  gpuRays->Update();
+  // updating a sensor again in the same batch does not render it twice
+  depth1->Update();
+  EXPECT_EQ(0u, depth1Count);
+  EXPECT_EQ(0u, depth2Count);
+  EXPECT_EQ(0u, raysCount);
+
+  engine->EndRenderBatch();
+  EXPECT_FALSE(engine->RenderBatchActive());
+  EXPECT_EQ(1u, depth1Count);
+  EXPECT_EQ(1u, depth2Count);
+  EXPECT_EQ(1u, raysCount);
+
+  // all the sensors see the box in the middle of their frame
+  unsigned int mid = 32u * 64u + 32u;
+  ASSERT_EQ(64u * 64u, depth1Data.size());
+  ASSERT_EQ(64u * 64u, depth2Data.size());
+  EXPECT_NEAR(expectedRange, depth1Data[mid], DEPTH_TOL);
+  EXPECT_NEAR(expectedRange, depth2Data[mid], DEPTH_TOL);
+  ASSERT_EQ(rayCount * gpuRays->Channels(), raysData.size());
+  EXPECT_NEAR(expectedRange, raysData[rayCount / 2 * gpuRays->Channels()],
+      LASER_TOL);
+
+  // a sensor destroyed before the batch ends is skipped
+  engine->BeginRenderBatch();
+  depth1->Update();
+  depth2->Update();
+  c2.reset();
+  scene->DestroySensor(depth2);
+  depth2.reset();
+  engine->EndRenderBatch();
+  EXPECT_EQ(2u, depth1Count);
+  EXPECT_EQ(1u, depth2Count);
+
+  // the batch is empty again, so the next one renders nothing
+  engine->BeginRenderBatch();
+  engine->EndRenderBatch();
+  EXPECT_EQ(2u, depth1Count);
+  EXPECT_EQ(1u, raysCount);
+
+  c1.reset();
+  c3.reset();
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(RenderBatchTest, Sensors)
+{
+  Sensors(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(RenderBatch, RenderBatchTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -17,6 +17,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #include <ignition/common/Console.hh>
 #include <ignition/common/Image.hh>
 
@@ -24,6 +26,7 @@
 
 #include "ignition/rendering/Camera.hh"
 #include "ignition/rendering/DepthCamera.hh"
+#include "ignition/rendering/DistortionPass.hh"
 #include "ignition/rendering/GaussianNoisePass.hh"
 #include "ignition/rendering/Image.hh"
 #include "ignition/rendering/PixelFormat.hh"
@@ -31,6 +34,8 @@
 #include "ignition/rendering/RenderingIface.hh"
 #include "ignition/rendering/RenderPassSystem.hh"
 #include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/ShaderParams.hh"
+#include "ignition/rendering/ShaderPass.hh"
 
 #define DOUBLE_TOL 1e-6
 unsigned int g_pointCloudCounter = 0;
@@ -56,6 +61,15 @@ class RenderPassTest: public testing::Test,
 
   // Test and verify Gaussian noise pass is applied to a depth camera
   public: void DepthGaussianNoise(const std::string &_renderEngine);
+
+  // Test chaining and disabling several Gaussian noise passes
+  public: void GaussianNoiseChain(const std::string &_renderEngine);
+
+  // Test and verify a shader pass kernel is applied to a camera
+  public: void ShaderKernel(const std::string &_renderEngine);
+
+  // Test and verify lens distortion is applied to the camera image
+  public: void Distortion(const std::string &_renderEngine);
 };
 
 /////////////////////////////////////////////////
@@ -399,6 +413,253 @@ void RenderPassTest::DepthGaussianNoise(const std::string &_renderEngine)
   ignition::rendering::unloadEngine(engine->Name());
 }
 
+/////////////////////////////////////////////////
+void RenderPassTest::GaussianNoiseChain(const std::string &_renderEngine)
+{
+  // create and populate scene
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  // add resources in build dir
+  engine->AddResourcePath(
+      common::joinPaths(std::string(PROJECT_BUILD_PATH), "src"));
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+  scene->SetAmbientLight(0.3, 0.3, 0.3);
+
+  VisualPtr root = scene->RootVisual();
+
+  // create  camera
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_TRUE(camera != nullptr);
+  camera->SetImageWidth(100);
+  camera->SetImageHeight(100);
+  root->AddChild(camera);
+
+  // create directional light
+  DirectionalLightPtr light = scene->CreateDirectionalLight();
+  light->SetDirection(0.0, 0.0, -1);
+  light->SetDiffuseColor(0.5, 0.5, 0.5);
+  light->SetSpecularColor(0.5, 0.5, 0.5);
+  root->AddChild(light);
+
+  // create box
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(1.0, 0.0, 0.5);
+  root->AddChild(box);
+
+  // capture original image with box (no noise)
+  Image image = camera->CreateImage();
+  camera->Capture(image);
+
+  RenderPassSystemPtr rpSystem = engine->RenderPassSystem();
+  if (!rpSystem)
+  {
+    ignwarn << "Engine '" << _renderEngine << "' does not support "
+            << "render pass  system" << std::endl;
+    return;
+  }
+
+  // consecutive noise passes, which the engine may draw in a single pass
+  std::vector<GaussianNoisePassPtr> noisePasses;
+  for (unsigned int i = 0u; i < 3u; ++i)
+  {
+    GaussianNoisePassPtr noisePass =
+        std::dynamic_pointer_cast<GaussianNoisePass>(
+        rpSystem->Create<GaussianNoisePass>());
+    ASSERT_NE(nullptr, noisePass);
+    noisePass->SetMean(0.1);
+    noisePass->SetStdDev(0.01);
+    camera->AddRenderPass(noisePass);
+    noisePasses.push_back(noisePass);
+  }
+
+  auto imageDiff = [&]()
+  {
+    Image imageNoise = camera->CreateImage();
+    camera->Capture(imageNoise);
+
+    unsigned int diffSum = 0;
+    unsigned char *data = image.Data<unsigned char>();
+    unsigned char *dataNoise = imageNoise.Data<unsigned char>();
+    unsigned int channelCount =
+        PixelUtil::ChannelCount(camera->ImageFormat());
+    unsigned int size =
+        camera->ImageWidth() * camera->ImageHeight() * channelCount;
+    for (unsigned int i = 0; i < size; ++i)
+      diffSum += std::abs(static_cast<int>(data[i]) - dataNoise[i]);
+    return diffSum;
+  };
+
+  // all passes enabled
+  EXPECT_NE(0u, imageDiff());
+
+  // disabling a pass in the middle of the chain keeps the others
+  noisePasses[1]->SetEnabled(false);
+  EXPECT_NE(0u, imageDiff());
+
+  // no noise once all of them are disabled
+  noisePasses[0]->SetEnabled(false);
+  noisePasses[2]->SetEnabled(false);
+  EXPECT_EQ(0u, imageDiff());
+
+  // enabled again
+  noisePasses[0]->SetEnabled(true);
+  noisePasses[1]->SetEnabled(true);
+  EXPECT_NE(0u, imageDiff());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void RenderPassTest::ShaderKernel(const std::string &_renderEngine)
+{
+  // create and populate scene
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  // add resources in build dir
+  engine->AddResourcePath(
+      common::joinPaths(std::string(PROJECT_BUILD_PATH), "src"));
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+
+  VisualPtr root = scene->RootVisual();
+
+  // create  camera
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_TRUE(camera != nullptr);
+  camera->SetImageWidth(100);
+  camera->SetImageHeight(100);
+  root->AddChild(camera);
+
+  RenderPassSystemPtr rpSystem = engine->RenderPassSystem();
+  ShaderPassPtr shaderPass;
+  if (rpSystem)
+  {
+    shaderPass = std::dynamic_pointer_cast<ShaderPass>(
+        rpSystem->Create<ShaderPass>());
+  }
+  if (!shaderPass)
+  {
+    ignwarn << "Engine '" << _renderEngine << "' does not support "
+            << "shader passes" << std::endl;
+    return;
+  }
+
+  // a kernel drawing a uniform color
+  shaderPass->SetKernel(
+      "uniform float red;\n"
+      "vec4 kernel(vec2 uv)\n"
+      "{\n"
+      "  return vec4(red, 0.0, 0.0, 1.0);\n"
+      "}\n");
+  (*shaderPass->KernelParams())["red"] = 1.0f;
+  camera->AddRenderPass(shaderPass);
+
+  Image image = camera->CreateImage();
+  camera->Capture(image);
+
+  unsigned char *data = image.Data<unsigned char>();
+  unsigned int channelCount = PixelUtil::ChannelCount(camera->ImageFormat());
+  unsigned int size =
+      camera->ImageWidth() * camera->ImageHeight() * channelCount;
+  for (unsigned int i = 0; i < size; i += channelCount)
+  {
+    EXPECT_EQ(255u, data[i]);
+    EXPECT_EQ(0u, data[i + 1]);
+    EXPECT_EQ(0u, data[i + 2]);
+  }
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void RenderPassTest::Distortion(const std::string &_renderEngine)
+{
+  // create and populate scene
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  // add resources in build dir
+  engine->AddResourcePath(
+      common::joinPaths(std::string(PROJECT_BUILD_PATH), "src"));
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+  scene->SetBackgroundColor(1.0, 1.0, 1.0);
+
+  VisualPtr root = scene->RootVisual();
+
+  // create  camera
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_TRUE(camera != nullptr);
+  camera->SetImageWidth(100);
+  camera->SetImageHeight(100);
+  root->AddChild(camera);
+
+  RenderPassSystemPtr rpSystem = engine->RenderPassSystem();
+  DistortionPassPtr distortionPass;
+  if (rpSystem)
+  {
+    distortionPass = std::dynamic_pointer_cast<DistortionPass>(
+        rpSystem->Create<DistortionPass>());
+  }
+  if (!distortionPass)
+  {
+    ignwarn << "Engine '" << _renderEngine << "' does not support "
+            << "distortion passes" << std::endl;
+    return;
+  }
+
+  // barrel distortion: the corners of the distorted image are out of the
+  // field of view of the camera
+  distortionPass->SetK1(-0.5);
+  camera->AddRenderPass(distortionPass);
+
+  Image image = camera->CreateImage();
+  camera->Capture(image);
+
+  unsigned char *data = image.Data<unsigned char>();
+  unsigned int channelCount = PixelUtil::ChannelCount(camera->ImageFormat());
+  unsigned int step = camera->ImageWidth() * channelCount;
+  unsigned int center = camera->ImageHeight() / 2u * step +
+      camera->ImageWidth() / 2u * channelCount;
+  for (unsigned int c = 0; c < 3u; ++c)
+  {
+    // corner
+    EXPECT_EQ(0u, data[c]);
+    // center, unchanged
+    EXPECT_EQ(255u, data[center + c]);
+  }
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
 /////////////////////////////////////////////////
 TEST_P(RenderPassTest, GaussianNoise)
 {
@@ -411,6 +672,24 @@ TEST_P(RenderPassTest, DepthGaussianNoise)
   DepthGaussianNoise(GetParam());
 }
 
+/////////////////////////////////////////////////
+TEST_P(RenderPassTest, GaussianNoiseChain)
+{
+  GaussianNoiseChain(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(RenderPassTest, ShaderKernel)
+{
+  ShaderKernel(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(RenderPassTest, Distortion)
+{
+  Distortion(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(GaussianNoise, RenderPassTest,
     RENDER_ENGINE_VALUES,
     ignition::rendering::PrintToStringParam());
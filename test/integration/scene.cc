@@ -17,11 +17,15 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 
 #include "test_config.h"  // NOLINT(build/include)
 
 #include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/PixelFormat.hh"
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/RenderingIface.hh"
 #include "ignition/rendering/Scene.hh"
@@ -39,6 +43,9 @@ class SceneTest: public testing::Test,
 
   // Test and verify camera tracking
   public: void VisualAt(const std::string &_renderEngine);
+
+  // Test several independent scenes sharing the meshes of the engine
+  public: void MultipleScenes(const std::string &_renderEngine);
 };
 
 /////////////////////////////////////////////////
@@ -220,6 +227,81 @@ void SceneTest::VisualAt(const std::string &_renderEngine)
   rendering::unloadEngine(engine->Name());
 }
 
+/////////////////////////////////////////////////
+void SceneTest::MultipleScenes(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  // populate a scene with a box in front of a camera
+  auto createWorld = [&](const std::string &_name) -> CameraPtr
+  {
+    ScenePtr scene = engine->CreateScene(_name);
+    if (!scene)
+      return CameraPtr();
+    scene->SetBackgroundColor(0.0, 0.0, 0.0);
+    scene->SetAmbientLight(1.0, 1.0, 1.0);
+
+    VisualPtr root = scene->RootVisual();
+    VisualPtr box = scene->CreateVisual();
+    box->AddGeometry(scene->CreateBox());
+    box->SetLocalPosition(0.0, 0.0, 0.0);
+    root->AddChild(box);
+
+    CameraPtr camera = scene->CreateCamera();
+    camera->SetLocalPosition(-2.0, 0.0, 0.0);
+    camera->SetImageWidth(64);
+    camera->SetImageHeight(64);
+    camera->SetHFOV(IGN_PI / 2);
+    root->AddChild(camera);
+    return camera;
+  };
+
+  // the box is drawn over the background at the center of the image
+  auto boxVisible = [](CameraPtr _camera) -> bool
+  {
+    Image image = _camera->CreateImage();
+    _camera->Capture(image);
+    unsigned int bpp = PixelUtil::BytesPerPixel(_camera->ImageFormat());
+    unsigned int idx = (_camera->ImageHeight() / 2u * _camera->ImageWidth() +
+        _camera->ImageWidth() / 2u) * bpp;
+    unsigned char *data = image.Data<unsigned char>();
+    return data[idx] > 0u || data[idx + 1] > 0u || data[idx + 2] > 0u;
+  };
+
+  CameraPtr camera1 = createWorld("world1");
+  CameraPtr camera2 = createWorld("world2");
+  ASSERT_NE(nullptr, camera1);
+  ASSERT_NE(nullptr, camera2);
+  EXPECT_NE(camera1->Scene(), camera2->Scene());
+  EXPECT_EQ(2u, engine->SceneCount());
+
+  EXPECT_TRUE(boxVisible(camera1));
+  EXPECT_TRUE(boxVisible(camera2));
+
+  // destroying a world must not affect the meshes and materials of the
+  // others
+  engine->DestroyScene(camera1->Scene());
+  camera1.reset();
+  EXPECT_EQ(1u, engine->SceneCount());
+  EXPECT_TRUE(boxVisible(camera2));
+
+  // a new world reuses the meshes left by the previous ones
+  CameraPtr camera3 = createWorld("world3");
+  ASSERT_NE(nullptr, camera3);
+  EXPECT_TRUE(boxVisible(camera3));
+  EXPECT_TRUE(boxVisible(camera2));
+
+  // Clean up
+  engine->DestroyScenes();
+  rendering::unloadEngine(engine->Name());
+}
+
 /////////////////////////////////////////////////
 TEST_P(SceneTest, AddRemoveVisuals)
 {
@@ -232,6 +314,12 @@ TEST_P(SceneTest, VisualAt)
   VisualAt(GetParam());
 }
 
+/////////////////////////////////////////////////
+TEST_P(SceneTest, MultipleScenes)
+{
+  MultipleScenes(GetParam());
+}
+
 // It doesn't suppot optix just yet
 INSTANTIATE_TEST_CASE_P(Scene, SceneTest,
     RENDER_ENGINE_VALUES,
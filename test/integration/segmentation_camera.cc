@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Event.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/SegmentationCamera.hh"
+
+unsigned int g_segmentationCounter = 0;
+
+//////////////////////////////////////////////////
+void OnNewSegmentationFrame(std::vector<uint32_t> *_labelsDest,
+                  const uint32_t *_labels,
+                  unsigned int _width, unsigned int _height,
+                  unsigned int _channels,
+                  const std::string &_format)
+{
+  EXPECT_EQ("L32", _format);
+  EXPECT_EQ(1u, _channels);
+
+  _labelsDest->assign(_labels, _labels + _width * _height);
+  g_segmentationCounter++;
+}
+
+//////////////////////////////////////////////////
+void OnNewRawSegmentationFrame(std::vector<uint16_t> *_labelsDest,
+                  const unsigned char *_labels,
+                  unsigned int _width, unsigned int _height,
+                  unsigned int _channels,
+                  const std::string &_format)
+{
+  EXPECT_EQ("L16", _format);
+  EXPECT_EQ(1u, _channels);
+
+  _labelsDest->resize(_width * _height);
+  memcpy(_labelsDest->data(), _labels, _width * _height * sizeof(uint16_t));
+}
+
+//////////////////////////////////////////////////
+class SegmentationCameraTest: public testing::Test,
+  public testing::WithParamInterface<const char *>
+{
+  // Render labeled boxes in front of a segmentation camera
+  public: void SegmentationCameraBoxes(const std::string &_renderEngine);
+
+  // Documentation inherited
+  protected: void SetUp() override
+  {
+    ignition::common::Console::SetVerbosity(4);
+  }
+};
+
+//////////////////////////////////////////////////
+void SegmentationCameraTest::SegmentationCameraBoxes(
+    const std::string &_renderEngine)
+{
+  unsigned int imgWidth = 50u;
+  unsigned int imgHeight = 50u;
+
+  // Only ogre2 supports segmentation cameras
+  if (_renderEngine.compare("ogre2") != 0)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' doesn't support segmentation cameras" << std::endl;
+    return;
+  }
+
+  // Setup ign-rendering with an empty scene
+  auto *engine = ignition::rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ignition::rendering::ScenePtr scene = engine->CreateScene("scene");
+  ignition::rendering::VisualPtr root = scene->RootVisual();
+
+  // model on the left, labeled on its top level visual
+  ignition::rendering::VisualPtr model = scene->CreateVisual();
+  model->SetLocalPosition(2.0, 0.5, 0.0);
+  model->SetUserData("label", 70000);
+  root->AddChild(model);
+  ignition::rendering::VisualPtr link = scene->CreateVisual();
+  link->AddGeometry(scene->CreateBox());
+  link->SetLocalScale(0.5, 0.5, 0.5);
+  model->AddChild(link);
+
+  // unlabeled box on the right
+  ignition::rendering::VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(2.0, -0.5, 0.0);
+  box->SetLocalScale(0.5, 0.5, 0.5);
+  root->AddChild(box);
+  {
+    auto camera = scene->CreateSegmentationCamera("SegmentationCamera");
+    ASSERT_NE(nullptr, camera);
+    camera->SetImageWidth(imgWidth);
+    camera->SetImageHeight(imgHeight);
+    camera->SetAspectRatio(1.0);
+    camera->SetHFOV(IGN_PI / 2.0);
+    camera->SetNearClipPlane(0.1);
+    camera->SetFarClipPlane(10.0);
+    camera->SetBackgroundLabel(3u);
+    root->AddChild(camera);
+
+    std::vector<uint32_t> labels;
+    g_segmentationCounter = 0u;
+    ignition::common::ConnectionPtr connection =
+      camera->ConnectNewSegmentationFrame(
+          std::bind(&::OnNewSegmentationFrame, &labels,
+            std::placeholders::_1, std::placeholders::_2,
+            std::placeholders::_3, std::placeholders::_4,
+            std::placeholders::_5));
+    EXPECT_NE(nullptr, connection);
+
+    camera->Update();
+    EXPECT_EQ(1u, g_segmentationCounter);
+    ASSERT_EQ(imgWidth * imgHeight, labels.size());
+
+    unsigned int row = (imgHeight / 2u) * imgWidth;
+    unsigned int left = row + imgWidth / 4u;
+    unsigned int right = row + imgWidth * 3u / 4u;
+    unsigned int corner = 0u;
+
+    // semantic labels, inherited from the model. Unlabeled objects and
+    // the background have the background label
+    EXPECT_EQ(70000u, labels[left]);
+    EXPECT_EQ(3u, labels[right]);
+    EXPECT_EQ(3u, labels[corner]);
+
+    // instance labels are the ids of the top level visuals
+    camera->SetSegmentationType(ignition::rendering::SEG_INSTANCE);
+    camera->Update();
+    EXPECT_EQ(2u, g_segmentationCounter);
+    EXPECT_EQ(model->Id(), labels[left]);
+    EXPECT_EQ(box->Id(), labels[right]);
+    EXPECT_EQ(3u, labels[corner]);
+
+    // Clean up
+    connection.reset();
+  }
+
+  {
+    // 16 bit labels saturate
+    auto camera = scene->CreateSegmentationCamera("SegmentationCamera16");
+    ASSERT_NE(nullptr, camera);
+    camera->SetImageWidth(imgWidth);
+    camera->SetImageHeight(imgHeight);
+    camera->SetAspectRatio(1.0);
+    camera->SetHFOV(IGN_PI / 2.0);
+    camera->SetLabelBitDepth(16u);
+    root->AddChild(camera);
+
+    std::vector<uint16_t> labels;
+    ignition::common::ConnectionPtr connection =
+      camera->ConnectNewRawSegmentationFrame(
+          std::bind(&::OnNewRawSegmentationFrame, &labels,
+            std::placeholders::_1, std::placeholders::_2,
+            std::placeholders::_3, std::placeholders::_4,
+            std::placeholders::_5));
+    EXPECT_NE(nullptr, connection);
+
+    camera->Update();
+    ASSERT_EQ(imgWidth * imgHeight, labels.size());
+
+    unsigned int row = (imgHeight / 2u) * imgWidth;
+    EXPECT_EQ(65535u, labels[row + imgWidth / 4u]);
+    EXPECT_EQ(0u, labels[row + imgWidth * 3u / 4u]);
+
+    // Clean up
+    connection.reset();
+  }
+
+  engine->DestroyScene(scene);
+  ignition::rendering::unloadEngine(engine->Name());
+}
+
+//////////////////////////////////////////////////
+TEST_P(SegmentationCameraTest, SegmentationCameraBoxes)
+{
+  SegmentationCameraBoxes(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(SegmentationCamera, SegmentationCameraTest,
+    RENDER_ENGINE_VALUES, ignition::rendering::PrintToStringParam());
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -53,6 +53,19 @@ void OnNewThermalFrame(uint16_t *_scanDest, const uint16_t *_scan,
   memcpy(_scanDest, _scan, size * sizeof(u));
 }
 
+//////////////////////////////////////////////////
+void OnNewRawThermalFrame(unsigned char *_scanDest,
+                  const unsigned char *_scan,
+                  unsigned int _width, unsigned int _height,
+                  unsigned int _channels,
+                  const std::string &_format)
+{
+  EXPECT_EQ("L8", _format);
+  EXPECT_EQ(1u, _channels);
+
+  memcpy(_scanDest, _scan, _width * _height * _channels);
+}
+
 //////////////////////////////////////////////////
 class ThermalCameraTest: public testing::Test,
   public testing::WithParamInterface<const char *>
@@ -381,8 +394,7 @@ void ThermalCameraTest::ThermalCameraBoxes8Bit(
     scene->RootVisual()->AddChild(thermalCamera);
 
     // Set a callback on the camera sensor to get a thermal camera frame
-    // todo(anyone) change this to uint8_t when thermal cameras supports a
-    // ConnectNewThermalFrame event that provides this format
+    // widened to 16 bits
     uint16_t *thermalData = new uint16_t[imgHeight * imgWidth];
     ignition::common::ConnectionPtr connection =
       thermalCamera->ConnectNewThermalFrame(
@@ -391,9 +403,22 @@ void ThermalCameraTest::ThermalCameraBoxes8Bit(
             std::placeholders::_4, std::placeholders::_5));
     EXPECT_NE(nullptr, connection);
 
+    // and the 8 bit frame as read back
+    unsigned char *rawThermalData = new unsigned char[imgHeight * imgWidth];
+    ignition::common::ConnectionPtr rawConnection =
+      thermalCamera->ConnectNewRawThermalFrame(
+          std::bind(&::OnNewRawThermalFrame, rawThermalData,
+            std::placeholders::_1, std::placeholders::_2, std::placeholders::_3,
+            std::placeholders::_4, std::placeholders::_5));
+    EXPECT_NE(nullptr, rawConnection);
+
     // Update once to create image
     thermalCamera->Update();
 
+    // both events deliver the same values
+    for (int i = 0; i < imgHeight * imgWidth; ++i)
+      EXPECT_EQ(thermalData[i], rawThermalData[i]);
+
     // thermal image indices
     int midWidth = static_cast<int>(thermalCamera->ImageWidth() * 0.5);
     int midHeight = static_cast<int>(thermalCamera->ImageHeight() * 0.5);
@@ -447,7 +472,9 @@ void ThermalCameraTest::ThermalCameraBoxes8Bit(
 
     // Clean up
     connection.reset();
+    rawConnection.reset();
     delete [] thermalData;
+    delete [] rawThermalData;
   }
 
   engine->DestroyScene(scene);
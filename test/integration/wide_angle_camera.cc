@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Event.hh>
+
+#include <ignition/math/Color.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/PixelFormat.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/WideAngleCamera.hh"
+
+unsigned int g_wideAngleCounter = 0;
+
+//////////////////////////////////////////////////
+void OnNewWideAngleFrame(unsigned char *_imageDest,
+                  const unsigned char *_image,
+                  unsigned int _width, unsigned int _height,
+                  unsigned int _channels,
+                  const std::string &_format)
+{
+  EXPECT_EQ("PF_R8G8B8", _format);
+  EXPECT_EQ(64u, _width);
+  EXPECT_EQ(64u, _height);
+  EXPECT_EQ(3u, _channels);
+
+  memcpy(_imageDest, _image, _width * _height * _channels);
+  g_wideAngleCounter++;
+}
+
+//////////////////////////////////////////////////
+class WideAngleCameraTest: public testing::Test,
+  public testing::WithParamInterface<const char *>
+{
+  // Render a box in front of a fisheye camera
+  public: void WideAngleCameraBox(const std::string &_renderEngine);
+
+  // Documentation inherited
+  protected: void SetUp() override
+  {
+    ignition::common::Console::SetVerbosity(4);
+  }
+};
+
+//////////////////////////////////////////////////
+void WideAngleCameraTest::WideAngleCameraBox(
+    const std::string &_renderEngine)
+{
+  unsigned int imgWidth = 64u;
+  unsigned int imgHeight = 64u;
+  unsigned int channelCount = 3u;
+
+  // Only ogre2 supports wide angle cameras
+  if (_renderEngine.compare("ogre2") != 0)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' doesn't support wide angle cameras" << std::endl;
+    return;
+  }
+
+  // Setup ign-rendering with an empty scene
+  auto *engine = ignition::rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ignition::rendering::ScenePtr scene = engine->CreateScene("scene");
+
+  // red background
+  scene->SetBackgroundColor(1.0, 0.0, 0.0);
+  scene->SetAmbientLight(1.0, 1.0, 1.0);
+  ignition::rendering::VisualPtr root = scene->RootVisual();
+
+  // create box visual in front of the camera
+  ignition::rendering::VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(2.0, 0.0, 0.0);
+  ignition::rendering::MaterialPtr material = scene->CreateMaterial();
+  material->SetAmbient(0.0, 0.0, 1.0);
+  material->SetDiffuse(0.0, 0.0, 1.0);
+  box->SetMaterial(material);
+  root->AddChild(box);
+  {
+    // orthographic fisheye seeing the half space in front of it: the
+    // corners of the image are out of its field of view
+    auto camera = scene->CreateWideAngleCamera("WideAngleCamera");
+    ASSERT_NE(nullptr, camera);
+    camera->SetImageWidth(imgWidth);
+    camera->SetImageHeight(imgHeight);
+    camera->SetAspectRatio(1.0);
+    camera->SetHFOV(IGN_PI);
+    camera->SetNearClipPlane(0.1);
+    camera->SetFarClipPlane(10.0);
+    camera->SetProjection(ignition::rendering::WAP_ORTHOGRAPHIC);
+    EXPECT_EQ(ignition::rendering::WAP_ORTHOGRAPHIC, camera->Projection());
+    root->AddChild(camera);
+
+    unsigned char *data = new unsigned char[imgWidth * imgHeight *
+        channelCount];
+    g_wideAngleCounter = 0u;
+    ignition::common::ConnectionPtr connection =
+      camera->ConnectNewWideAngleFrame(
+          std::bind(&::OnNewWideAngleFrame, data,
+            std::placeholders::_1, std::placeholders::_2,
+            std::placeholders::_3, std::placeholders::_4,
+            std::placeholders::_5));
+    EXPECT_NE(nullptr, connection);
+
+    camera->Update();
+    EXPECT_EQ(1u, g_wideAngleCounter);
+
+    unsigned int step = imgWidth * channelCount;
+    unsigned int mid = (imgHeight / 2u) * step + (imgWidth / 2u) * channelCount;
+    unsigned int left = (imgHeight / 2u) * step + channelCount;
+    unsigned int corner = 0u;
+
+    // box in the center
+    EXPECT_GT(data[mid + 2], data[mid]);
+
+    // background on the side, seen through the cubemap faces on the left
+    EXPECT_EQ(255u, data[left]);
+    EXPECT_EQ(0u, data[left + 1]);
+    EXPECT_EQ(0u, data[left + 2]);
+
+    // out of the field of view
+    EXPECT_EQ(0u, data[corner]);
+    EXPECT_EQ(0u, data[corner + 1]);
+    EXPECT_EQ(0u, data[corner + 2]);
+
+    // the image can also be copied
+    ignition::rendering::Image image = camera->CreateImage();
+    camera->Copy(image);
+    unsigned char *imageData = image.Data<unsigned char>();
+    EXPECT_EQ(data[mid], imageData[mid]);
+    EXPECT_EQ(data[mid + 2], imageData[mid + 2]);
+
+    // Clean up
+    connection.reset();
+    delete [] data;
+  }
+
+  engine->DestroyScene(scene);
+  ignition::rendering::unloadEngine(engine->Name());
+}
+
+//////////////////////////////////////////////////
+TEST_P(WideAngleCameraTest, WideAngleCameraBox)
+{
+  WideAngleCameraBox(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(WideAngleCamera, WideAngleCameraTest,
+    RENDER_ENGINE_VALUES, ignition::rendering::PrintToStringParam());
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,497 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// test_config.h uses gtest for its instantiation helpers
+#include <gtest/gtest.h>
+#include <benchmark/benchmark.h>
+
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/ColladaLoader.hh>
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Mesh.hh>
+#include <ignition/math/Helpers.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/DepthCamera.hh"
+#include "ignition/rendering/GpuRays.hh"
+#include "ignition/rendering/Image.hh"
+#include "ignition/rendering/Material.hh"
+#include "ignition/rendering/MeshDescriptor.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/ThermalCamera.hh"
+#include "ignition/rendering/Visual.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+// The benchmarks of each render engine available are registered at
+// runtime, named <benchmark>/<engine>/<arguments>. Run the "benchmarks"
+// target to write the results to test_results/PERFORMANCE_benchmarks.json,
+// or run PERFORMANCE_benchmarks with the usual Google Benchmark flags.
+// Set RENDER_ENGINE_VALUES to select the engines, as for the tests.
+
+/// \brief Name of the scene created by each benchmark
+static const char kSceneName[] = "benchmark";
+
+/// \brief Standard image resolutions of the sensor benchmarks
+static const std::vector<std::vector<int64_t>> kResolutions{
+    {320, 240}, {640, 480}, {1280, 720}, {1920, 1080}};
+
+/////////////////////////////////////////////////
+/// \brief Populate a scene with a ground plane and boxes in front of the
+/// sensors, so that they have something to render
+/// \param[in] _scene Scene to populate
+static void populateScene(ScenePtr _scene)
+{
+  VisualPtr root = _scene->RootVisual();
+
+  DirectionalLightPtr light = _scene->CreateDirectionalLight();
+  light->SetDirection(0.5, 0.5, -1.0);
+  root->AddChild(light);
+
+  VisualPtr ground = _scene->CreateVisual();
+  ground->AddGeometry(_scene->CreatePlane());
+  ground->SetLocalScale(100.0, 100.0, 1.0);
+  root->AddChild(ground);
+
+  for (int i = 0; i < 10; ++i)
+  {
+    VisualPtr box = _scene->CreateVisual();
+    box->AddGeometry(_scene->CreateBox());
+    box->SetLocalPosition(3.0 + i, -4.5 + i, 0.5);
+    root->AddChild(box);
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Create a scene with the given number of box visuals
+/// \param[in] _engine Render engine
+/// \param[in] _count Number of visuals
+/// \param[out] _ids Ids of the visuals, null to ignore them
+/// \return The new scene
+static ScenePtr createVisuals(RenderEngine *_engine, int64_t _count,
+    std::vector<unsigned int> *_ids = nullptr)
+{
+  ScenePtr scene = _engine->CreateScene(kSceneName);
+  VisualPtr root = scene->RootVisual();
+  for (int64_t i = 0; i < _count; ++i)
+  {
+    VisualPtr visual = scene->CreateVisual();
+    visual->AddGeometry(scene->CreateBox());
+    visual->SetLocalPosition(static_cast<double>(i % 100),
+        static_cast<double>((i / 100) % 100), static_cast<double>(i / 10000));
+    root->AddChild(visual);
+    if (_ids)
+      _ids->push_back(visual->Id());
+  }
+  return scene;
+}
+
+/////////////////////////////////////////////////
+/// \brief Create and destroy a scene of box visuals
+/// \param[in] _state Benchmark state, the argument is the number of visuals
+/// \param[in] _engine Render engine
+static void sceneCreateDestroy(benchmark::State &_state,
+    RenderEngine *_engine)
+{
+  for (auto _ : _state)
+  {
+    ScenePtr scene = createVisuals(_engine, _state.range(0));
+    _engine->DestroyScene(scene);
+  }
+  _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+}
+
+/////////////////////////////////////////////////
+/// \brief Destroy a scene of box visuals, the creation is not timed
+/// \param[in] _state Benchmark state, the argument is the number of visuals
+/// \param[in] _engine Render engine
+static void sceneDestroy(benchmark::State &_state, RenderEngine *_engine)
+{
+  for (auto _ : _state)
+  {
+    _state.PauseTiming();
+    ScenePtr scene = createVisuals(_engine, _state.range(0));
+    _state.ResumeTiming();
+    _engine->DestroyScene(scene);
+  }
+  _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+}
+
+/////////////////////////////////////////////////
+/// \brief Spawn then despawn debris, visuals with a box and a material, in
+/// a scene that persists between batches
+/// \param[in] _state Benchmark state, the argument is the number of debris
+/// per batch
+/// \param[in] _engine Render engine
+static void spawnDespawn(benchmark::State &_state, RenderEngine *_engine)
+{
+  ScenePtr scene = _engine->CreateScene(kSceneName);
+  VisualPtr root = scene->RootVisual();
+  MaterialPtr material = scene->CreateMaterial();
+  material->SetDiffuse(1.0, 0.5, 0.0);
+  std::vector<VisualPtr> debris;
+  debris.reserve(static_cast<size_t>(_state.range(0)));
+  for (auto _ : _state)
+  {
+    for (int64_t i = 0; i < _state.range(0); ++i)
+    {
+      VisualPtr visual = scene->CreateVisual();
+      visual->AddGeometry(scene->CreateBox());
+      // each debris gets its own copy of the material
+      visual->SetMaterial(material);
+      root->AddChild(visual);
+      debris.push_back(visual);
+    }
+    for (auto &visual : debris)
+      scene->DestroyVisual(visual, true);
+    debris.clear();
+  }
+  _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+  _engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+/// \brief Update the world poses of all the visuals of a scene
+/// \param[in] _state Benchmark state, the argument is the number of visuals
+/// \param[in] _engine Render engine
+static void poseUpdate(benchmark::State &_state, RenderEngine *_engine)
+{
+  std::vector<unsigned int> ids;
+  ScenePtr scene = createVisuals(_engine, _state.range(0), &ids);
+  std::vector<math::Pose3d> poses(ids.size());
+
+  double z = 0.0;
+  for (auto _ : _state)
+  {
+    z += 0.01;
+    for (size_t i = 0; i < poses.size(); ++i)
+      poses[i].Set(static_cast<double>(i % 100), 0.0, z, 0.0, 0.0, z);
+    scene->SetWorldPoses(ids, poses);
+  }
+  _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+  _engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+/// \brief Path to the skinned mesh of the test media
+/// \return Absolute path to the mesh
+static std::string meshPath()
+{
+  return common::joinPaths(PROJECT_SOURCE_PATH, "test", "media", "meshes",
+      "walk.dae");
+}
+
+/////////////////////////////////////////////////
+/// \brief Parse a mesh file, without going through the cache of the
+/// common mesh manager
+/// \param[in] _state Benchmark state
+static void meshImport(benchmark::State &_state)
+{
+  const std::string path = meshPath();
+  for (auto _ : _state)
+  {
+    common::ColladaLoader loader;
+    std::unique_ptr<common::Mesh> mesh(loader.Load(path));
+    if (!mesh)
+    {
+      _state.SkipWithError(("Unable to load " + path).c_str());
+      return;
+    }
+    benchmark::DoNotOptimize(mesh->VertexCount());
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Create the render engine mesh of a parsed mesh file
+/// \param[in] _state Benchmark state
+/// \param[in] _engine Render engine
+static void meshCreate(benchmark::State &_state, RenderEngine *_engine)
+{
+  const std::string path = meshPath();
+  common::ColladaLoader loader;
+  std::unique_ptr<common::Mesh> commonMesh(loader.Load(path));
+  if (!commonMesh)
+  {
+    _state.SkipWithError(("Unable to load " + path).c_str());
+    return;
+  }
+
+  ScenePtr scene = _engine->CreateScene(kSceneName);
+  const std::string baseName = commonMesh->Name();
+  unsigned int count = 0u;
+  for (auto _ : _state)
+  {
+    // a new name each time, since the engines cache meshes by name
+    _state.PauseTiming();
+    commonMesh->SetName(baseName + "_" + std::to_string(count++));
+    MeshDescriptor descriptor(commonMesh.get());
+    _state.ResumeTiming();
+
+    MeshPtr mesh = scene->CreateMesh(descriptor);
+    if (!mesh)
+    {
+      _state.SkipWithError("Unable to create mesh");
+      break;
+    }
+    mesh->Destroy();
+  }
+  _engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+/// \brief Render frames of a sensor and report the frame rate
+/// \param[in] _state Benchmark state
+/// \param[in] _sensor Sensor to update, already attached to its scene
+static void renderFrames(benchmark::State &_state, CameraPtr _sensor)
+{
+  // the first frame compiles the shaders
+  _sensor->Update();
+  for (auto _ : _state)
+    _sensor->Update();
+  _state.counters["fps"] = benchmark::Counter(
+      static_cast<double>(_state.iterations()), benchmark::Counter::kIsRate);
+}
+
+/////////////////////////////////////////////////
+/// \brief Render color camera frames
+/// \param[in] _state Benchmark state, the arguments are the resolution
+/// \param[in] _engine Render engine
+static void cameraFrames(benchmark::State &_state, RenderEngine *_engine)
+{
+  ScenePtr scene = _engine->CreateScene(kSceneName);
+  populateScene(scene);
+
+  CameraPtr camera = scene->CreateCamera();
+  camera->SetImageWidth(static_cast<unsigned int>(_state.range(0)));
+  camera->SetImageHeight(static_cast<unsigned int>(_state.range(1)));
+  camera->SetLocalPosition(0.0, 0.0, 1.0);
+  scene->RootVisual()->AddChild(camera);
+
+  renderFrames(_state, camera);
+  _engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+/// \brief Render depth camera frames, including their readback
+/// \param[in] _state Benchmark state, the arguments are the resolution
+/// \param[in] _engine Render engine
+static void depthCameraFrames(benchmark::State &_state,
+    RenderEngine *_engine)
+{
+  ScenePtr scene = _engine->CreateScene(kSceneName);
+  populateScene(scene);
+
+  DepthCameraPtr camera = scene->CreateDepthCamera();
+  if (!camera)
+  {
+    _state.SkipWithError("Depth camera not supported");
+    _engine->DestroyScene(scene);
+    return;
+  }
+  camera->SetImageWidth(static_cast<unsigned int>(_state.range(0)));
+  camera->SetImageHeight(static_cast<unsigned int>(_state.range(1)));
+  camera->SetNearClipPlane(0.1);
+  camera->SetFarClipPlane(20.0);
+  camera->SetLocalPosition(0.0, 0.0, 1.0);
+  camera->CreateDepthTexture();
+  scene->RootVisual()->AddChild(camera);
+
+  renderFrames(_state, camera);
+  _engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+/// \brief Render thermal camera frames, including their readback
+/// \param[in] _state Benchmark state, the arguments are the resolution
+/// \param[in] _engine Render engine
+static void thermalCameraFrames(benchmark::State &_state,
+    RenderEngine *_engine)
+{
+  ScenePtr scene = _engine->CreateScene(kSceneName);
+  populateScene(scene);
+
+  ThermalCameraPtr camera = scene->CreateThermalCamera();
+  if (!camera)
+  {
+    _state.SkipWithError("Thermal camera not supported");
+    _engine->DestroyScene(scene);
+    return;
+  }
+  camera->SetImageWidth(static_cast<unsigned int>(_state.range(0)));
+  camera->SetImageHeight(static_cast<unsigned int>(_state.range(1)));
+  camera->SetNearClipPlane(0.1);
+  camera->SetFarClipPlane(20.0);
+  camera->SetLocalPosition(0.0, 0.0, 1.0);
+  scene->RootVisual()->AddChild(camera);
+
+  renderFrames(_state, camera);
+  _engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+/// \brief Render GPU rays frames, including their readback
+/// \param[in] _state Benchmark state, the arguments are the horizontal
+/// and vertical ray counts
+/// \param[in] _engine Render engine
+static void gpuRaysFrames(benchmark::State &_state, RenderEngine *_engine)
+{
+  ScenePtr scene = _engine->CreateScene(kSceneName);
+  populateScene(scene);
+
+  GpuRaysPtr gpuRays = scene->CreateGpuRays();
+  if (!gpuRays)
+  {
+    _state.SkipWithError("GPU rays not supported");
+    _engine->DestroyScene(scene);
+    return;
+  }
+  gpuRays->SetNearClipPlane(0.1);
+  gpuRays->SetFarClipPlane(20.0);
+  gpuRays->SetAngleMin(-IGN_PI);
+  gpuRays->SetAngleMax(IGN_PI);
+  gpuRays->SetRayCount(static_cast<int>(_state.range(0)));
+  gpuRays->SetVerticalRayCount(static_cast<int>(_state.range(1)));
+  gpuRays->SetVerticalAngleMin(-IGN_PI / 12.0);
+  gpuRays->SetVerticalAngleMax(IGN_PI / 12.0);
+  gpuRays->SetLocalPosition(0.0, 0.0, 1.0);
+  scene->RootVisual()->AddChild(gpuRays);
+
+  renderFrames(_state, gpuRays);
+  _engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+/// \brief Time the readback of a rendered color camera frame to an image
+/// \param[in] _state Benchmark state, the arguments are the resolution
+/// \param[in] _engine Render engine
+static void cameraReadback(benchmark::State &_state, RenderEngine *_engine)
+{
+  ScenePtr scene = _engine->CreateScene(kSceneName);
+  populateScene(scene);
+
+  CameraPtr camera = scene->CreateCamera();
+  camera->SetImageWidth(static_cast<unsigned int>(_state.range(0)));
+  camera->SetImageHeight(static_cast<unsigned int>(_state.range(1)));
+  camera->SetLocalPosition(0.0, 0.0, 1.0);
+  scene->RootVisual()->AddChild(camera);
+
+  Image image = camera->CreateImage();
+  camera->Update();
+  for (auto _ : _state)
+  {
+    _state.PauseTiming();
+    camera->Render();
+    _state.ResumeTiming();
+    camera->Copy(image);
+  }
+  _state.SetBytesProcessed(_state.iterations() *
+      static_cast<int64_t>(image.MemorySize()));
+  _engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+/// \brief Register the benchmarks of a render engine
+/// \param[in] _name Render engine name
+/// \param[in] _engine Render engine
+static void registerBenchmarks(const std::string &_name,
+    RenderEngine *_engine)
+{
+  auto name = [&_name](const std::string &_benchmark)
+  {
+    return _benchmark + "/" + _name;
+  };
+
+  for (const auto &benchmarkFn : {
+      std::make_pair("SceneCreateDestroy", &sceneCreateDestroy),
+      std::make_pair("SceneDestroy", &sceneDestroy),
+      std::make_pair("SpawnDespawn", &spawnDespawn),
+      std::make_pair("PoseUpdate", &poseUpdate)})
+  {
+    benchmark::RegisterBenchmark(name(benchmarkFn.first).c_str(),
+        benchmarkFn.second, _engine)
+        ->Arg(1000)->Arg(10000)->Arg(100000)
+        ->Unit(benchmark::kMillisecond);
+  }
+
+  benchmark::RegisterBenchmark(name("MeshCreate").c_str(), &meshCreate,
+      _engine)->Unit(benchmark::kMillisecond);
+
+  for (const auto &benchmarkFn : {
+      std::make_pair("CameraFrames", &cameraFrames),
+      std::make_pair("DepthCameraFrames", &depthCameraFrames),
+      std::make_pair("ThermalCameraFrames", &thermalCameraFrames),
+      std::make_pair("CameraReadback", &cameraReadback)})
+  {
+    benchmark::RegisterBenchmark(name(benchmarkFn.first).c_str(),
+        benchmarkFn.second, _engine)
+        ->Args(kResolutions[0])->Args(kResolutions[1])
+        ->Args(kResolutions[2])->Args(kResolutions[3])
+        ->ArgNames({"width", "height"})
+        ->Unit(benchmark::kMillisecond);
+  }
+
+  benchmark::RegisterBenchmark(name("GpuRaysFrames").c_str(),
+      &gpuRaysFrames, _engine)
+      ->Args({640, 16})->Args({1024, 32})->Args({2048, 64})
+      ->ArgNames({"rays", "vertical_rays"})
+      ->Unit(benchmark::kMillisecond);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+
+  // find the engine plugins of the build tree
+  rendering::setPluginPaths({IGN_RENDERING_TEST_PLUGIN_PATH});
+
+  benchmark::RegisterBenchmark("MeshImport", &meshImport)
+      ->Unit(benchmark::kMillisecond);
+
+  std::list<std::string> loaded;
+  for (const char *value : rendering::TestValues())
+  {
+    std::string name(value);
+    RenderEngine *engine = rendering::engine(name);
+    if (!engine)
+    {
+      igndbg << "Engine '" << name << "' is not supported" << std::endl;
+      continue;
+    }
+    registerBenchmarks(name, engine);
+    loaded.push_back(name);
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+
+  for (const auto &name : loaded)
+    rendering::unloadEngine(name);
+  return 0;
+}
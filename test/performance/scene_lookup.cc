@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Time the hashed id, name and index lookups of the scene against
+/// the lookups of the name ordered map that used to store the visuals:
+/// a linear scan by id, a tree search by name and std::advance by index.
+class SceneLookupTest: public testing::Test,
+                       public testing::WithParamInterface<const char *>
+{
+  /// \brief Time lookups in a scene with the given number of visuals
+  /// \param[in] _renderEngine Render engine name
+  /// \param[in] _count Number of visuals to create
+  public: void Lookup(const std::string &_renderEngine, unsigned int _count);
+};
+
+/////////////////////////////////////////////////
+void SceneLookupTest::Lookup(const std::string &_renderEngine,
+    unsigned int _count)
+{
+  auto engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine << "' is not supported" << std::endl;
+    return;
+  }
+
+  auto scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  // the visuals are also stored as they were before the hashed lookups
+  std::map<std::string, VisualPtr> previous;
+  std::vector<unsigned int> ids;
+  std::vector<std::string> names;
+  ids.reserve(_count);
+  names.reserve(_count);
+  for (unsigned int i = 0; i < _count; ++i)
+  {
+    VisualPtr visual = scene->CreateVisual("visual_" + std::to_string(i));
+    ASSERT_NE(nullptr, visual);
+    scene->RootVisual()->AddChild(visual);
+    ids.push_back(visual->Id());
+    names.push_back(visual->Name());
+    previous[visual->Name()] = visual;
+  }
+  ASSERT_EQ(_count, scene->VisualCount());
+
+  // spread the lookups evenly over the scene
+  const unsigned int lookups = 1000u;
+  const unsigned int stride = _count / lookups;
+
+  using Clock = std::chrono::steady_clock;
+  auto elapsed = [](const Clock::time_point &_start)
+  {
+    return std::chrono::duration<double, std::milli>(
+        Clock::now() - _start).count();
+  };
+
+  // by id
+  auto start = Clock::now();
+  for (unsigned int i = 0; i < lookups; ++i)
+  {
+    unsigned int id = ids[i * stride];
+    VisualPtr visual = scene->VisualById(id);
+    ASSERT_NE(nullptr, visual);
+    EXPECT_EQ(id, visual->Id());
+  }
+  double idTime = elapsed(start);
+
+  start = Clock::now();
+  for (unsigned int i = 0; i < lookups; ++i)
+  {
+    unsigned int id = ids[i * stride];
+    auto iter = std::find_if(previous.begin(), previous.end(),
+        [id](const std::pair<const std::string, VisualPtr> &_item)
+        {
+          return _item.second->Id() == id;
+        });
+    ASSERT_TRUE(iter != previous.end());
+  }
+  double previousIdTime = elapsed(start);
+
+  // by name
+  start = Clock::now();
+  for (unsigned int i = 0; i < lookups; ++i)
+  {
+    const std::string &name = names[i * stride];
+    VisualPtr visual = scene->VisualByName(name);
+    ASSERT_NE(nullptr, visual);
+    EXPECT_EQ(name, visual->Name());
+  }
+  double nameTime = elapsed(start);
+
+  start = Clock::now();
+  for (unsigned int i = 0; i < lookups; ++i)
+  {
+    auto iter = previous.find(names[i * stride]);
+    ASSERT_TRUE(iter != previous.end());
+  }
+  double previousNameTime = elapsed(start);
+
+  // by index
+  start = Clock::now();
+  for (unsigned int i = 0; i < lookups; ++i)
+  {
+    VisualPtr visual = scene->VisualByIndex(i * stride);
+    ASSERT_NE(nullptr, visual);
+  }
+  double indexTime = elapsed(start);
+
+  start = Clock::now();
+  for (unsigned int i = 0; i < lookups; ++i)
+  {
+    auto iter = previous.begin();
+    std::advance(iter, i * stride);
+    ASSERT_TRUE(iter->second != nullptr);
+  }
+  double previousIndexTime = elapsed(start);
+
+  std::cout << "[" << _renderEngine << "] " << _count << " visuals, "
+            << lookups << " lookups (hashed / previous map):" << std::endl
+            << "  by id    " << idTime << " ms / " << previousIdTime
+            << " ms" << std::endl
+            << "  by name  " << nameTime << " ms / " << previousNameTime
+            << " ms" << std::endl
+            << "  by index " << indexTime << " ms / " << previousIndexTime
+            << " ms" << std::endl;
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneLookupTest, Lookup10k)
+{
+  Lookup(GetParam(), 10000u);
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneLookupTest, Lookup50k)
+{
+  Lookup(GetParam(), 50000u);
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneLookupTest, Lookup100k)
+{
+  Lookup(GetParam(), 100000u);
+}
+
+INSTANTIATE_TEST_CASE_P(SceneLookup, SceneLookupTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
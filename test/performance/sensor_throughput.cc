@@ -0,0 +1,383 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Util.hh>
+#include <ignition/math/Helpers.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/DepthCamera.hh"
+#include "ignition/rendering/GpuRays.hh"
+#include "ignition/rendering/Light.hh"
+#include "ignition/rendering/Material.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief End-to-end sensor harness. Cameras, depth cameras and lidars
+/// are updated in turn on a fixed tick in a scene like those of the
+/// integration tests, and the per-sensor latency, aggregate frame rate
+/// and CPU / GPU utilization are reported. The setup is read from the
+/// environment:
+/// SENSOR_THROUGHPUT_CAMERAS: number of cameras, 4 by default
+/// SENSOR_THROUGHPUT_DEPTH_CAMERAS: number of depth cameras, 2 by default
+/// SENSOR_THROUGHPUT_LIDARS: number of lidars, 2 by default
+/// SENSOR_THROUGHPUT_RATE: tick rate in Hz, 30 by default
+/// SENSOR_THROUGHPUT_TICKS: number of ticks measured, 300 by default
+class SensorThroughputTest: public testing::Test,
+                            public testing::WithParamInterface<const char *>
+{
+  /// \brief Run the harness
+  /// \param[in] _renderEngine Render engine name
+  public: void Throughput(const std::string &_renderEngine);
+};
+
+/// \brief Latency samples of a sensor
+struct SensorSamples
+{
+  /// \brief Sensor updated
+  CameraPtr sensor;
+
+  /// \brief Type of sensor, for the report
+  std::string type;
+
+  /// \brief Wall time in milliseconds of each update, readback included
+  std::vector<double> latencies;
+
+  /// \brief Sum of the GPU times in milliseconds of the updates
+  double gpuTime = 0.0;
+};
+
+/////////////////////////////////////////////////
+/// \brief Get an unsigned integer from the environment
+/// \param[in] _name Name of the environment variable
+/// \param[in] _default Value if the variable is not set or invalid
+/// \return Value
+static unsigned int envValue(const std::string &_name,
+    unsigned int _default)
+{
+  std::string str;
+  if (!common::env(_name, str) || str.empty())
+    return _default;
+  try
+  {
+    return static_cast<unsigned int>(std::stoul(str));
+  }
+  catch (...)
+  {
+    ignwarn << "Invalid value [" << str << "] of " << _name
+            << ", using " << _default << std::endl;
+    return _default;
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Get a percentile of samples
+/// \param[in] _samples Samples, sorted in increasing order
+/// \param[in] _percentile Percentile, in [0, 1]
+/// \return Value of the percentile, nearest rank
+static double percentile(const std::vector<double> &_samples,
+    double _percentile)
+{
+  if (_samples.empty())
+    return 0.0;
+  size_t rank = static_cast<size_t>(
+      std::ceil(_percentile * static_cast<double>(_samples.size())));
+  return _samples[std::min(_samples.size(), std::max<size_t>(rank, 1u)) - 1u];
+}
+
+/////////////////////////////////////////////////
+/// \brief Populate a scene with a ground plane, a grid of boxes, spheres
+/// and cylinders and two lights, as done by the integration tests
+/// \param[in] _scene Scene to populate
+static void populateScene(ScenePtr _scene)
+{
+  _scene->SetAmbientLight(0.3, 0.3, 0.3);
+  _scene->SetBackgroundColor(0.2, 0.2, 0.2);
+  VisualPtr root = _scene->RootVisual();
+
+  DirectionalLightPtr sun = _scene->CreateDirectionalLight();
+  sun->SetDirection(-0.5, 0.5, -1.0);
+  sun->SetDiffuseColor(0.8, 0.8, 0.8);
+  sun->SetCastShadows(true);
+  root->AddChild(sun);
+
+  PointLightPtr lamp = _scene->CreatePointLight();
+  lamp->SetLocalPosition(0.0, 0.0, 4.0);
+  lamp->SetDiffuseColor(0.5, 0.5, 0.5);
+  lamp->SetAttenuationRange(20.0);
+  root->AddChild(lamp);
+
+  MaterialPtr gray = _scene->CreateMaterial();
+  gray->SetDiffuse(0.7, 0.7, 0.7);
+  VisualPtr ground = _scene->CreateVisual();
+  ground->AddGeometry(_scene->CreatePlane());
+  ground->SetLocalScale(50.0, 50.0, 1.0);
+  ground->SetMaterial(gray);
+  root->AddChild(ground);
+
+  MaterialPtr colors[3];
+  for (int i = 0; i < 3; ++i)
+  {
+    colors[i] = _scene->CreateMaterial();
+    colors[i]->SetDiffuse(i == 0 ? 1.0 : 0.1, i == 1 ? 1.0 : 0.1,
+        i == 2 ? 1.0 : 0.1);
+  }
+
+  // objects all around the sensors at the origin
+  for (int x = -5; x <= 5; ++x)
+  {
+    for (int y = -5; y <= 5; ++y)
+    {
+      if (std::abs(x) < 2 && std::abs(y) < 2)
+        continue;
+      int kind = (x + y + 10) % 3;
+      VisualPtr visual = _scene->CreateVisual();
+      if (kind == 0)
+        visual->AddGeometry(_scene->CreateBox());
+      else if (kind == 1)
+        visual->AddGeometry(_scene->CreateSphere());
+      else
+        visual->AddGeometry(_scene->CreateCylinder());
+      visual->SetLocalPosition(x * 2.0, y * 2.0, 0.5);
+      visual->SetMaterial(colors[kind]);
+      root->AddChild(visual);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+void SensorThroughputTest::Throughput(const std::string &_renderEngine)
+{
+  auto engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine << "' is not supported" << std::endl;
+    return;
+  }
+
+  const unsigned int cameraCount =
+      envValue("SENSOR_THROUGHPUT_CAMERAS", 4u);
+  const unsigned int depthCameraCount =
+      envValue("SENSOR_THROUGHPUT_DEPTH_CAMERAS", 2u);
+  const unsigned int lidarCount = envValue("SENSOR_THROUGHPUT_LIDARS", 2u);
+  const unsigned int rate =
+      std::max(envValue("SENSOR_THROUGHPUT_RATE", 30u), 1u);
+  const unsigned int ticks =
+      std::max(envValue("SENSOR_THROUGHPUT_TICKS", 300u), 1u);
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  populateScene(scene);
+  VisualPtr root = scene->RootVisual();
+
+  // the sensors look in evenly spread directions from the origin
+  std::vector<SensorSamples> samples;
+  const unsigned int sensorCount =
+      cameraCount + depthCameraCount + lidarCount;
+  auto yaw = [&samples, sensorCount]()
+  {
+    return 2.0 * IGN_PI * samples.size() / std::max(sensorCount, 1u);
+  };
+
+  for (unsigned int i = 0; i < cameraCount; ++i)
+  {
+    CameraPtr camera = scene->CreateCamera();
+    ASSERT_NE(nullptr, camera);
+    camera->SetImageWidth(640u);
+    camera->SetImageHeight(480u);
+    camera->SetAntiAliasing(4u);
+    camera->SetLocalPose(math::Pose3d(0, 0, 1.0, 0, 0, yaw()));
+    root->AddChild(camera);
+    SensorSamples sensorSamples;
+    sensorSamples.sensor = camera;
+    sensorSamples.type = "camera";
+    samples.push_back(sensorSamples);
+  }
+
+  for (unsigned int i = 0; i < depthCameraCount; ++i)
+  {
+    DepthCameraPtr depthCamera = scene->CreateDepthCamera();
+    if (!depthCamera)
+    {
+      igndbg << "Engine '" << _renderEngine
+             << "' doesn't support depth cameras" << std::endl;
+      break;
+    }
+    depthCamera->SetImageWidth(640u);
+    depthCamera->SetImageHeight(480u);
+    depthCamera->SetNearClipPlane(0.1);
+    depthCamera->SetFarClipPlane(20.0);
+    depthCamera->SetLocalPose(math::Pose3d(0, 0, 1.0, 0, 0, yaw()));
+    depthCamera->CreateDepthTexture();
+    root->AddChild(depthCamera);
+    SensorSamples sensorSamples;
+    sensorSamples.sensor = depthCamera;
+    sensorSamples.type = "depth";
+    samples.push_back(sensorSamples);
+  }
+
+  for (unsigned int i = 0; i < lidarCount; ++i)
+  {
+    GpuRaysPtr lidar = scene->CreateGpuRays();
+    if (!lidar)
+    {
+      igndbg << "Engine '" << _renderEngine
+             << "' doesn't support gpu rays" << std::endl;
+      break;
+    }
+    lidar->SetNearClipPlane(0.1);
+    lidar->SetFarClipPlane(30.0);
+    lidar->SetAngleMin(-IGN_PI);
+    lidar->SetAngleMax(IGN_PI);
+    lidar->SetRayCount(1024);
+    lidar->SetVerticalRayCount(16);
+    lidar->SetVerticalAngleMin(-IGN_PI / 12.0);
+    lidar->SetVerticalAngleMax(IGN_PI / 12.0);
+    lidar->SetLocalPose(math::Pose3d(0, 0, 1.0, 0, 0, yaw()));
+    root->AddChild(lidar);
+    SensorSamples sensorSamples;
+    sensorSamples.sensor = lidar;
+    sensorSamples.type = "lidar";
+    samples.push_back(sensorSamples);
+  }
+
+  if (samples.empty())
+  {
+    engine->DestroyScene(scene);
+    rendering::unloadEngine(engine->Name());
+    return;
+  }
+
+  bool gpuTiming = engine->SetGpuTimingEnabled(true);
+
+  // the first updates compile the shaders and allocate the targets
+  for (auto &sensorSamples : samples)
+    sensorSamples.sensor->Update();
+
+  using Clock = std::chrono::steady_clock;
+  const auto period = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(1.0 / rate));
+  unsigned int missedTicks = 0u;
+
+  const std::clock_t cpuStart = std::clock();
+  const auto start = Clock::now();
+  auto nextTick = start;
+  for (unsigned int tick = 0; tick < ticks; ++tick)
+  {
+    for (auto &sensorSamples : samples)
+    {
+      auto updateStart = Clock::now();
+      sensorSamples.sensor->Update();
+      sensorSamples.latencies.push_back(std::chrono::duration<double,
+          std::milli>(Clock::now() - updateStart).count());
+      sensorSamples.gpuTime += sensorSamples.sensor->LastFrameStats().gpuTime;
+    }
+
+    nextTick += period;
+    auto now = Clock::now();
+    if (now > nextTick)
+    {
+      // the tick overran, skip the ticks missed instead of catching up
+      ++missedTicks;
+      nextTick = now;
+    }
+    else
+    {
+      std::this_thread::sleep_until(nextTick);
+    }
+  }
+  const double wallTime =
+      std::chrono::duration<double>(Clock::now() - start).count();
+  const double cpuTime =
+      static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+  // report
+  std::cout << "[" << _renderEngine << "] " << cameraCount << " cameras, "
+            << depthCameraCount << " depth cameras, " << lidarCount
+            << " lidars, " << ticks << " ticks at " << rate << " Hz"
+            << std::endl;
+  std::cout << std::fixed << std::setprecision(3);
+
+  double gpuTime = 0.0;
+  size_t frames = 0u;
+  for (auto &sensorSamples : samples)
+  {
+    std::vector<double> &latencies = sensorSamples.latencies;
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << "  " << std::setw(6) << sensorSamples.type << " "
+              << sensorSamples.sensor->Name() << ": p50 "
+              << percentile(latencies, 0.5) << " ms, p99 "
+              << percentile(latencies, 0.99) << " ms, max "
+              << latencies.back() << " ms" << std::endl;
+    gpuTime += sensorSamples.gpuTime;
+    frames += latencies.size();
+
+    EXPECT_EQ(ticks, latencies.size());
+  }
+
+  std::cout << "  aggregate: " << frames / wallTime << " frames/s, "
+            << missedTicks << " ticks missed" << std::endl;
+  std::cout << "  utilization: CPU " << 100.0 * cpuTime / wallTime << " %";
+  if (gpuTiming)
+    std::cout << ", GPU " << 0.1 * gpuTime / wallTime << " %";
+  else
+    std::cout << ", GPU n/a (GPU timing not supported)";
+  std::cout << std::endl;
+  std::cout.unsetf(std::ios_base::floatfield);
+
+  engine->SetGpuTimingEnabled(false);
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SensorThroughputTest, Throughput)
+{
+  Throughput(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(SensorThroughput, SensorThroughputTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}